@@ -0,0 +1,140 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#include "okapi/api/chassis/model/skidSteerModel.hpp"
+#include "okapi/api/control/async/asyncMotionProfileController.hpp"
+#include "okapi/api/control/util/profileGenerator.hpp"
+#include "okapi/api/odometry/odomMath.hpp"
+#include "okapi/api/odometry/twoEncoderOdometry.hpp"
+#include "test/tests/api/implMocks.hpp"
+#include "test/tests/api/simulatedDevices.hpp"
+#include <benchmark/benchmark.h>
+#include <cmath>
+#include <vector>
+
+using namespace okapi;
+
+namespace {
+std::shared_ptr<SkidSteerModel> makeModel() {
+  auto leftMotor = std::make_shared<MockMotor>();
+  auto rightMotor = std::make_shared<MockMotor>();
+  return std::make_shared<SkidSteerModel>(leftMotor,
+                                          rightMotor,
+                                          leftMotor->getEncoder(),
+                                          rightMotor->getEncoder(),
+                                          200,
+                                          v5MotorMaxVoltage);
+}
+
+/**
+ * Exposes the odometry math so it can be timed without the sensor reads around it.
+ */
+class BenchTwoEncoderOdometry : public TwoEncoderOdometry {
+  public:
+  using TwoEncoderOdometry::odomMathStep;
+  using TwoEncoderOdometry::TwoEncoderOdometry;
+};
+
+const PathfinderLimits benchLimits{1.0, 2.0, 10.0};
+} // namespace
+
+static void BM_TwoEncoderOdometryOdomMathStep(benchmark::State &state) {
+  BenchTwoEncoderOdometry odom(
+    createConstantTimeUtil(10_ms), makeModel(), ChassisScales({{4_in, 11.5_in}, imev5GreenTPR}));
+  odom.setIntegration(static_cast<OdomIntegration>(state.range(0)));
+
+  // A gentle arc, so the math takes its curved branch
+  const std::valarray<std::int32_t> tickDiff{12, 10};
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(odom.odomMathStep(tickDiff, 10_ms));
+  }
+}
+BENCHMARK(BM_TwoEncoderOdometryOdomMathStep)
+  ->Arg(static_cast<int>(OdomIntegration::ARC))
+  ->Arg(static_cast<int>(OdomIntegration::EXPONENTIAL_MAP));
+
+static void BM_OdomMathDistancesAndAnglesToPoints(benchmark::State &state) {
+  // About as many points as a pure pursuit lookahead search looks at each tick
+  std::vector<Point> points;
+  for (int i = 0; i < 64; i++) {
+    points.push_back({i * 5_cm, std::sin(i * 0.1) * 1_m});
+  }
+
+  std::vector<QLength> distances(points.size());
+  std::vector<QAngle> angles(points.size());
+  const OdomState pose{1_m, 0.5_m, 30_deg};
+  for (auto _ : state) {
+    OdomMath::computeDistancesAndAnglesToPoints(
+      points.data(), points.size(), pose, distances.data(), angles.data());
+    benchmark::DoNotOptimize(distances.data());
+    benchmark::DoNotOptimize(angles.data());
+  }
+}
+BENCHMARK(BM_OdomMathDistancesAndAnglesToPoints);
+
+static void BM_SkidSteerModelDriveVector(benchmark::State &state) {
+  auto model = makeModel();
+
+  double forward = -1;
+  for (auto _ : state) {
+    model->driveVector(forward, 0.5);
+    forward = forward >= 1 ? -1 : forward + 0.01;
+  }
+}
+BENCHMARK(BM_SkidSteerModelDriveVector);
+
+static void BM_ProfileGeneratorGenerate(benchmark::State &state) {
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(ProfileGenerator::generate(
+      {{0_ft, 0_ft, 0_deg}, {3_ft, 2_ft, 45_deg}, {6_ft, 0_ft, 0_deg}}, benchLimits, 11.5_in));
+  }
+}
+BENCHMARK(BM_ProfileGeneratorGenerate)->Unit(benchmark::kMillisecond);
+
+static void BM_AsyncMotionProfileControllerGeneratePath(benchmark::State &state) {
+  AsyncMotionProfileController controller(createTimeUtil(),
+                                          benchLimits,
+                                          makeModel(),
+                                          {{4_in, 11.5_in}, imev5GreenTPR},
+                                          AbstractMotor::gearset::green);
+
+  for (auto _ : state) {
+    controller.generatePath({{0_ft, 0_ft, 0_deg}, {3_ft, 2_ft, 45_deg}, {6_ft, 0_ft, 0_deg}},
+                            "bench");
+    // Removing the path is part of the loop so every iteration stores a new path
+    controller.removePath("bench");
+  }
+}
+BENCHMARK(BM_AsyncMotionProfileControllerGeneratePath)->Unit(benchmark::kMillisecond);
+
+static void BM_SimulatedDriveOdometry(benchmark::State &state) {
+  SimWorld world;
+  auto drive =
+    std::make_shared<SimSkidSteerDrive>(AbstractMotor::gearset::green, 4_in, 11.5_in, 7_kg);
+  world.addDevice(drive);
+
+  auto leftMotor = drive->getLeftMotor();
+  auto rightMotor = drive->getRightMotor();
+  TwoEncoderOdometry odom(world.createTimeUtil(),
+                          std::make_shared<SkidSteerModel>(leftMotor,
+                                                           rightMotor,
+                                                           leftMotor->getEncoder(),
+                                                           rightMotor->getEncoder(),
+                                                           200,
+                                                           v5MotorMaxVoltage),
+                          ChassisScales({{4_in, 11.5_in}, imev5GreenTPR}));
+  leftMotor->moveVelocity(150);
+  rightMotor->moveVelocity(100);
+
+  // One iteration is one odometry period of robot time, physics included
+  for (auto _ : state) {
+    world.advance(10_ms);
+    odom.step();
+  }
+
+  state.counters["robotSecondsPerSecond"] =
+    benchmark::Counter(state.iterations() * 0.01, benchmark::Counter::kIsRate);
+}
+BENCHMARK(BM_SimulatedDriveOdometry);
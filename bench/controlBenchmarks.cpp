@@ -0,0 +1,264 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#include "okapi/api/control/iterative/iterativePosPidController.hpp"
+#include "okapi/api/control/util/batchFlywheelSimulator.hpp"
+#include "okapi/api/control/util/flywheelSimulator.hpp"
+#include "okapi/api/filter/alphaBetaFilter.hpp"
+#include "okapi/api/filter/averageFilter.hpp"
+#include "okapi/api/filter/biquadFilter.hpp"
+#include "okapi/api/filter/composableFilter.hpp"
+#include "okapi/api/filter/demaBank.hpp"
+#include "okapi/api/filter/demaFilter.hpp"
+#include "okapi/api/filter/ekfFilter.hpp"
+#include "okapi/api/filter/emaBank.hpp"
+#include "okapi/api/filter/emaFilter.hpp"
+#include "okapi/api/filter/leastSquaresVelMath.hpp"
+#include "okapi/api/filter/medianFilter.hpp"
+#include "okapi/api/filter/passthroughFilter.hpp"
+#include "okapi/api/filter/velMath.hpp"
+#include "okapi/api/util/batchMath.hpp"
+#include "okapi/api/util/logCapture.hpp"
+#include "okapi/api/util/logging.hpp"
+#include "test/tests/api/implMocks.hpp"
+#include <array>
+#include <benchmark/benchmark.h>
+#include <memory>
+#include <vector>
+
+using namespace okapi;
+
+namespace {
+/**
+ * A reading which changes every step, so no filter or controller can settle into a fixed point.
+ */
+double nextReading(std::int64_t &icounter) {
+  return static_cast<double>((icounter++ % 1000) - 500);
+}
+} // namespace
+
+static void BM_IterativePosPIDControllerStep(benchmark::State &state) {
+  IterativePosPIDController controller({0.004, 0.0001, 0.0002, 0.0001},
+                                       createConstantTimeUtil(10_ms));
+  controller.setTarget(250);
+
+  std::int64_t counter = 0;
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(controller.step(nextReading(counter)));
+  }
+}
+BENCHMARK(BM_IterativePosPIDControllerStep);
+
+static void BM_VelMathStep(benchmark::State &state) {
+  VelMath velMath(imev5GreenTPR,
+                  std::make_unique<AverageFilter<2>>(),
+                  10_ms,
+                  std::make_unique<ConstantMockTimer>(10_ms));
+
+  std::int64_t counter = 0;
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(velMath.step(nextReading(counter)));
+  }
+}
+BENCHMARK(BM_VelMathStep);
+
+static void BM_LeastSquaresVelMathStep(benchmark::State &state) {
+  LeastSquaresVelMath velMath(imev5GreenTPR,
+                              static_cast<std::size_t>(state.range(0)),
+                              10_ms,
+                              std::make_unique<ConstantMockTimer>(10_ms));
+
+  std::int64_t counter = 0;
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(velMath.step(nextReading(counter)));
+  }
+}
+BENCHMARK(BM_LeastSquaresVelMathStep)->Arg(5)->Arg(15);
+
+template <typename FilterType> static void BM_FilterFilter(benchmark::State &state) {
+  FilterType filter;
+
+  std::int64_t counter = 0;
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(filter.filter(nextReading(counter)));
+  }
+}
+
+struct BenchEmaFilter : EmaFilter {
+  BenchEmaFilter() : EmaFilter(0.2) {
+  }
+};
+
+struct BenchDemaFilter : DemaFilter {
+  BenchDemaFilter() : DemaFilter(0.2, 0.05) {
+  }
+};
+
+struct BenchBiquadFilter : BiquadFilter {
+  BenchBiquadFilter() : BiquadFilter(BiquadFilter::butterworthLowPass(2, 10_Hz, 100_Hz)) {
+  }
+};
+
+struct BenchAlphaBetaFilter : AlphaBetaFilter {
+  BenchAlphaBetaFilter() : AlphaBetaFilter(0.5, 0.2, 10_ms) {
+  }
+};
+
+struct BenchComposableFilter : ComposableFilter {
+  BenchComposableFilter()
+    : ComposableFilter({std::make_shared<MedianFilter<5>>(), std::make_shared<EmaFilter>(0.2)}) {
+  }
+};
+
+BENCHMARK_TEMPLATE(BM_FilterFilter, PassthroughFilter);
+BENCHMARK_TEMPLATE(BM_FilterFilter, AverageFilter<2>);
+BENCHMARK_TEMPLATE(BM_FilterFilter, AverageFilter<16>);
+BENCHMARK_TEMPLATE(BM_FilterFilter, MedianFilter<5>);
+BENCHMARK_TEMPLATE(BM_FilterFilter, MedianFilter<15>);
+BENCHMARK_TEMPLATE(BM_FilterFilter, BenchEmaFilter);
+BENCHMARK_TEMPLATE(BM_FilterFilter, BenchDemaFilter);
+BENCHMARK_TEMPLATE(BM_FilterFilter, EKFFilter);
+BENCHMARK_TEMPLATE(BM_FilterFilter, BenchBiquadFilter);
+BENCHMARK_TEMPLATE(BM_FilterFilter, BenchAlphaBetaFilter);
+BENCHMARK_TEMPLATE(BM_FilterFilter, BenchComposableFilter);
+
+constexpr std::size_t benchChannels = 16;
+
+static void BM_EmaFilterPerChannel(benchmark::State &state) {
+  std::vector<std::unique_ptr<Filter>> filters;
+  for (std::size_t i = 0; i < benchChannels; i++) {
+    filters.push_back(std::make_unique<EmaFilter>(0.2));
+  }
+
+  std::int64_t counter = 0;
+  std::array<double, benchChannels> out;
+  for (auto _ : state) {
+    const double reading = nextReading(counter);
+    for (std::size_t i = 0; i < benchChannels; i++) {
+      out[i] = filters[i]->filter(reading + i);
+    }
+    benchmark::DoNotOptimize(out);
+  }
+}
+BENCHMARK(BM_EmaFilterPerChannel);
+
+static void BM_EmaBank(benchmark::State &state) {
+  EmaBank<benchChannels> bank(0.2);
+
+  std::int64_t counter = 0;
+  std::array<double, benchChannels> in;
+  for (auto _ : state) {
+    const double reading = nextReading(counter);
+    for (std::size_t i = 0; i < benchChannels; i++) {
+      in[i] = reading + i;
+    }
+    benchmark::DoNotOptimize(bank.filter(in));
+  }
+}
+BENCHMARK(BM_EmaBank);
+
+static void BM_EmaBankFloat(benchmark::State &state) {
+  EmaBank<benchChannels, float> bank(0.2f);
+
+  std::int64_t counter = 0;
+  std::array<float, benchChannels> in;
+  for (auto _ : state) {
+    const double reading = nextReading(counter);
+    for (std::size_t i = 0; i < benchChannels; i++) {
+      in[i] = static_cast<float>(reading + i);
+    }
+    benchmark::DoNotOptimize(bank.filter(in));
+  }
+}
+BENCHMARK(BM_EmaBankFloat);
+
+static void BM_BatchMathIntegratePoses(benchmark::State &state) {
+  std::array<float, benchChannels> x{}, y{}, forward{}, right{}, deltaTheta{};
+  std::array<float, benchChannels> cosTheta, sinTheta;
+  cosTheta.fill(1);
+  sinTheta.fill(0);
+  for (std::size_t i = 0; i < benchChannels; i++) {
+    forward[i] = 0.01f;
+    right[i] = 0.001f * i;
+    deltaTheta[i] = 0.002f * i;
+  }
+
+  for (auto _ : state) {
+    BatchMath::integratePoses(x.data(),
+                              y.data(),
+                              cosTheta.data(),
+                              sinTheta.data(),
+                              forward.data(),
+                              right.data(),
+                              deltaTheta.data(),
+                              benchChannels);
+    benchmark::DoNotOptimize(x);
+    benchmark::DoNotOptimize(y);
+  }
+}
+BENCHMARK(BM_BatchMathIntegratePoses);
+
+static void BM_DemaBank(benchmark::State &state) {
+  DemaBank<benchChannels> bank(0.2, 0.05);
+
+  std::int64_t counter = 0;
+  std::array<double, benchChannels> in;
+  for (auto _ : state) {
+    const double reading = nextReading(counter);
+    for (std::size_t i = 0; i < benchChannels; i++) {
+      in[i] = reading + i;
+    }
+    benchmark::DoNotOptimize(bank.filter(in));
+  }
+}
+BENCHMARK(BM_DemaBank);
+
+static void BM_FlywheelSimulatorStepMany(benchmark::State &state) {
+  std::vector<FlywheelSimulator> sims(static_cast<std::size_t>(state.range(0)));
+  for (auto &sim : sims) {
+    sim.setTorque(0.3);
+  }
+
+  for (auto _ : state) {
+    for (auto &sim : sims) {
+      benchmark::DoNotOptimize(sim.step());
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_FlywheelSimulatorStepMany)->Arg(64)->Arg(1024);
+
+static void BM_BatchFlywheelSimulatorStep(benchmark::State &state) {
+  BatchFlywheelSimulator<> batch;
+  for (std::int64_t i = 0; i < state.range(0); i++) {
+    batch.setTorque(batch.add(), 0.3);
+  }
+
+  for (auto _ : state) {
+    batch.step();
+    benchmark::DoNotOptimize(batch.getAngles().data());
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_BatchFlywheelSimulatorStep)->Arg(64)->Arg(1024);
+
+static void BM_LogDebugFToCapture(benchmark::State &state) {
+  auto capture = std::make_shared<LogCapture>();
+  auto logger = std::make_shared<Logger>(
+    std::make_unique<ConstantMockTimer>(10_ms), capture, Logger::LogLevel::debug);
+
+  std::int64_t counter = 0;
+  for (auto _ : state) {
+    LOG_DEBUG_F("error %f, output %f", nextReading(counter), 0.5);
+
+    // Empty the capture outside of the timing so statements are never dropped
+    if (counter % LogCapture::defaultCapacity == 0) {
+      state.PauseTiming();
+      capture->clear();
+      state.ResumeTiming();
+    }
+  }
+}
+BENCHMARK(BM_LogDebugFToCapture);
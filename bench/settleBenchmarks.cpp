@@ -0,0 +1,269 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#include "okapi/api/chassis/controller/chassisControllerIntegrated.hpp"
+#include "okapi/api/chassis/controller/chassisControllerPid.hpp"
+#include "okapi/api/chassis/controller/defaultOdomChassisController.hpp"
+#include "okapi/api/chassis/model/skidSteerModel.hpp"
+#include "okapi/api/odometry/twoEncoderOdometry.hpp"
+#include "okapi/api/util/taskProfiler.hpp"
+#include "test/tests/api/simulatedDevices.hpp"
+#include "test/tests/api/virtualClock.hpp"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <benchmark/benchmark.h>
+#include <cmath>
+#include <functional>
+#include <thread>
+
+using namespace okapi;
+
+namespace {
+enum class Chassis { pid, integrated, odomPid };
+
+const ChassisScales benchScales({4_in, 11.5_in}, imev5GreenTPR);
+
+/**
+ * A chassis controller driving a simulated skid steer drive on a virtual clock, so a move takes
+ * only as long as the host needs to run it and its timing is the same on every run.
+ */
+class SettleRig {
+  public:
+  explicit SettleRig(const Chassis ichassis) {
+    world.addDevice(drive);
+    clock.addListener([this](const QTime inow) {
+      world.advanceTo(inow);
+      const auto pose = drive->getPose();
+      maxX = std::max(maxX, pose.x.convert(inch));
+      maxTheta = std::max(maxTheta, pose.theta.convert(degree));
+    });
+
+    // Hold the clock until the move starts, so every task starts at the same time on every run
+    hold->delayUntil(0_ms);
+
+    const auto timeUtil = clock.createTimeUtil();
+    auto left = drive->getLeftMotor();
+    auto right = drive->getRightMotor();
+    auto model = std::make_shared<SkidSteerModel>(
+      left, right, left->getEncoder(), right->getEncoder(), 200, v5MotorMaxVoltage);
+
+    if (ichassis == Chassis::integrated) {
+      auto integrated = std::make_shared<ChassisControllerIntegrated>(
+        timeUtil,
+        model,
+        std::make_unique<AsyncPosIntegratedController>(
+          left, AbstractMotor::gearset::green, 200, timeUtil),
+        std::make_unique<AsyncPosIntegratedController>(
+          right, AbstractMotor::gearset::green, 200, timeUtil),
+        AbstractMotor::gearset::green,
+        benchScales);
+      integrated->startThread();
+      controller = integrated;
+      waitForTasks(1);
+      return;
+    }
+
+    auto pid = std::make_shared<ChassisControllerPID>(
+      timeUtil,
+      model,
+      std::make_unique<IterativePosPIDController>(0.003, 0, 0.00007, 0, timeUtil),
+      std::make_unique<IterativePosPIDController>(0.003, 0, 0.00007, 0, timeUtil),
+      std::make_unique<IterativePosPIDController>(0.001, 0, 0, 0, timeUtil),
+      AbstractMotor::gearset::green,
+      benchScales);
+    pid->startThread();
+    controller = pid;
+
+    if (ichassis == Chassis::odomPid) {
+      odomController = std::make_shared<DefaultOdomChassisController>(
+        timeUtil, std::make_shared<TwoEncoderOdometry>(timeUtil, model, benchScales), pid);
+      odomController->startOdomThread();
+      waitForTasks(2);
+      return;
+    }
+
+    waitForTasks(1);
+  }
+
+  /**
+   * Runs a move to completion, or stops it once it takes longer than the timeout of robot time.
+   * Must only be called once.
+   *
+   * @param imove The move, which blocks until the chassis controller settles.
+   * @return The robot time from the start of the move until it settled.
+   */
+  QTime run(const std::function<void()> &imove) {
+    TaskProfiler::resetStats();
+    const QTime start = clock.now();
+
+    // The watchdog doesn't join the clock, so it can stop a move which never settles
+    std::atomic_bool done{false};
+    std::thread watchdog([&]() {
+      while (!done.load(std::memory_order_acquire)) {
+        if (clock.now() - start > timeout) {
+          timedOut = true;
+          controller->stop();
+          return;
+        }
+        std::this_thread::sleep_for(std::chrono::microseconds(100));
+      }
+    });
+
+    // The move waits on its own rates while this task still holds the clock, so the clock can't
+    // move between the steps of a move
+    imove();
+    const QTime settleTime = clock.now() - start;
+
+    done.store(true, std::memory_order_release);
+    watchdog.join();
+    hold->reset();
+
+    std::array<TaskProfileStats, TaskProfiler::maxProfiles> stats;
+    const std::size_t count = TaskProfiler::getStats(stats);
+    std::uint64_t busyMicros = 0;
+    std::uint64_t loops = 0;
+    for (std::size_t i = 0; i < count; i++) {
+      busyMicros += stats[i].busyMicros;
+      loops += stats[i].loops;
+    }
+    cpuPerTick = loops == 0 ? 0 : static_cast<double>(busyMicros) / loops;
+
+    return settleTime;
+  }
+
+  /**
+   * The longest a move may take.
+   */
+  static constexpr QTime timeout = 15_s;
+
+  // The clock must outlive the controllers, so it is declared first
+  VirtualClock clock;
+  std::unique_ptr<AbstractRate> hold = clock.createTimeUtil().getRate();
+  SimWorld world;
+  std::shared_ptr<SimSkidSteerDrive> drive =
+    std::make_shared<SimSkidSteerDrive>(AbstractMotor::gearset::green, 4_in, 11.5_in, 7_kg);
+  std::shared_ptr<ChassisController> controller;
+  std::shared_ptr<DefaultOdomChassisController> odomController;
+
+  double maxX{0};     // in
+  double maxTheta{0}; // deg
+  std::atomic_bool timedOut{false};
+  double cpuPerTick{0}; // us
+
+  protected:
+  /**
+   * Waits for the controller tasks to join the clock, which this task holds.
+   */
+  void waitForTasks(const std::size_t icount) {
+    while (clock.getTaskCount() < icount + 1) {
+      std::this_thread::sleep_for(std::chrono::microseconds(100));
+    }
+  }
+};
+
+/**
+ * The time to settle, the overshoot, and the host time per tick of the controller tasks, summed
+ * over the iterations of a benchmark.
+ */
+struct SettleTotals {
+  void add(const SettleRig &irig, const QTime &isettleTime, const double iovershoot) {
+    settleMs += isettleTime.convert(millisecond);
+    overshoot += std::max(iovershoot, 0.0);
+    cpuUsPerTick += irig.cpuPerTick;
+    timedOut += irig.timedOut ? 1 : 0;
+  }
+
+  void report(benchmark::State &state) const {
+    state.counters["settleMs"] = benchmark::Counter(settleMs, benchmark::Counter::kAvgIterations);
+    state.counters["overshoot"] =
+      benchmark::Counter(overshoot, benchmark::Counter::kAvgIterations);
+    state.counters["cpuUsPerTick"] =
+      benchmark::Counter(cpuUsPerTick, benchmark::Counter::kAvgIterations);
+    state.counters["timedOut"] = benchmark::Counter(timedOut, benchmark::Counter::kAvgIterations);
+  }
+
+  double settleMs{0};
+  double overshoot{0};
+  double cpuUsPerTick{0};
+  double timedOut{0};
+};
+
+ChassisController &moveController(SettleRig &irig) {
+  if (irig.odomController) {
+    return *irig.odomController;
+  }
+  return *irig.controller;
+}
+} // namespace
+
+/**
+ * Drives straight. The overshoot is in inches.
+ */
+static void BM_SettleMoveDistance(benchmark::State &state) {
+  const QLength distance = state.range(1) * inch;
+  SettleTotals totals;
+  for (auto _ : state) {
+    SettleRig rig(static_cast<Chassis>(state.range(0)));
+    const QTime settleTime = rig.run([&]() { moveController(rig).moveDistance(distance); });
+    totals.add(rig, settleTime, rig.maxX - distance.convert(inch));
+  }
+  totals.report(state);
+}
+BENCHMARK(BM_SettleMoveDistance)
+  ->ArgNames({"chassis", "inches"})
+  ->ArgsProduct({{static_cast<int>(Chassis::pid),
+                  static_cast<int>(Chassis::integrated),
+                  static_cast<int>(Chassis::odomPid)},
+                 {24, 48}})
+  ->Unit(benchmark::kMillisecond);
+
+/**
+ * Turns in place. The overshoot is in degrees.
+ */
+static void BM_SettleTurnAngle(benchmark::State &state) {
+  const QAngle angle = state.range(1) * degree;
+  SettleTotals totals;
+  for (auto _ : state) {
+    SettleRig rig(static_cast<Chassis>(state.range(0)));
+    const QTime settleTime = rig.run([&]() { moveController(rig).turnAngle(angle); });
+    totals.add(rig, settleTime, rig.maxTheta - angle.convert(degree));
+  }
+  totals.report(state);
+}
+BENCHMARK(BM_SettleTurnAngle)
+  ->ArgNames({"chassis", "degrees"})
+  ->ArgsProduct({{static_cast<int>(Chassis::pid),
+                  static_cast<int>(Chassis::integrated),
+                  static_cast<int>(Chassis::odomPid)},
+                 {90, 180}})
+  ->Unit(benchmark::kMillisecond);
+
+/**
+ * Drives around a square of points with odometry. The overshoot is the distance from the start,
+ * where the square ends, in inches.
+ */
+static void BM_SettleDriveToPointGrid(benchmark::State &state) {
+  const QLength side = state.range(0) * inch;
+  SettleTotals totals;
+  for (auto _ : state) {
+    SettleRig rig(Chassis::odomPid);
+    const QTime settleTime = rig.run([&]() {
+      rig.odomController->driveToPoint({side, 0_in});
+      rig.odomController->driveToPoint({side, side});
+      rig.odomController->driveToPoint({0_in, side});
+      rig.odomController->driveToPoint({0_in, 0_in});
+    });
+
+    const auto pose = rig.drive->getPose();
+    totals.add(rig, settleTime, std::hypot(pose.x.convert(inch), pose.y.convert(inch)));
+  }
+  totals.report(state);
+}
+BENCHMARK(BM_SettleDriveToPointGrid)
+  ->ArgNames({"side"})
+  ->Arg(24)
+  ->Arg(48)
+  ->Unit(benchmark::kMillisecond);
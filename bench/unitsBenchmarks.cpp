@@ -0,0 +1,55 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#include "okapi/api/units/QAngle.hpp"
+#include "okapi/api/units/QAngularSpeed.hpp"
+#include "okapi/api/units/QLength.hpp"
+#include "okapi/api/units/QSpeed.hpp"
+#include "okapi/api/units/QTime.hpp"
+#include <benchmark/benchmark.h>
+
+using namespace okapi;
+
+static void BM_RQuantityAddSubtract(benchmark::State &state) {
+  QLength a = 1_in;
+  QLength b = 2_cm;
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(a);
+    benchmark::DoNotOptimize(b);
+    a = a + b - 1_mm;
+    benchmark::DoNotOptimize(a);
+  }
+}
+BENCHMARK(BM_RQuantityAddSubtract);
+
+static void BM_RQuantityMultiplyDivide(benchmark::State &state) {
+  QLength distance = 3_ft;
+  QTime time = 20_ms;
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(distance);
+    benchmark::DoNotOptimize(time);
+    const QSpeed speed = distance / time;
+    benchmark::DoNotOptimize(speed * time);
+  }
+}
+BENCHMARK(BM_RQuantityMultiplyDivide);
+
+static void BM_RQuantityConvert(benchmark::State &state) {
+  QAngularSpeed speed = 200_rpm;
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(speed);
+    benchmark::DoNotOptimize(speed.convert(degree / second));
+  }
+}
+BENCHMARK(BM_RQuantityConvert);
+
+static void BM_RQuantityTrig(benchmark::State &state) {
+  QAngle angle = 30_deg;
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(angle);
+    benchmark::DoNotOptimize(sin(angle) * 1_in + cos(angle) * 1_in);
+  }
+}
+BENCHMARK(BM_RQuantityTrig);
@@ -2,7 +2,10 @@ ARCHTUPLE=arm-none-eabi-
 DEVICE=VEX EDR V5
 
 MFLAGS=-mcpu=cortex-a9 -mfpu=neon-fp16 -mfloat-abi=softfp -Os -g
-CPPFLAGS=-D_POSIX_THREADS -D_UNIX98_THREAD_MUTEX_ATTRIBUTES
+# The most verbose log level compiled in: 4 = debug, 3 = info, 2 = warn, 1 = error, 0 = off. Log
+# statements which are more verbose are removed at compile time.
+OKAPI_COMPILED_LOG_LEVEL?=4
+CPPFLAGS=-D_POSIX_THREADS -D_UNIX98_THREAD_MUTEX_ATTRIBUTES -DOKAPI_COMPILED_LOG_LEVEL=$(OKAPI_COMPILED_LOG_LEVEL)
 GCCFLAGS=-ffunction-sections -fdata-sections -fdiagnostics-color -funwind-tables
 
 WARNFLAGS+=-Wno-psabi
@@ -38,68 +38,152 @@
 #include "okapi/api/chassis/controller/chassisControllerIntegrated.hpp"
 #include "okapi/api/chassis/controller/chassisControllerPid.hpp"
 #include "okapi/api/chassis/controller/chassisScales.hpp"
+#include "okapi/api/chassis/controller/chassisScalesCalibrator.hpp"
+#include "okapi/api/chassis/controller/slipDetector.hpp"
 #include "okapi/api/chassis/controller/defaultOdomChassisController.hpp"
+#include "okapi/api/chassis/controller/moveMonitor.hpp"
 #include "okapi/api/chassis/controller/odomChassisController.hpp"
 #include "okapi/api/chassis/model/hDriveModel.hpp"
 #include "okapi/api/chassis/model/readOnlyChassisModel.hpp"
 #include "okapi/api/chassis/model/skidSteerModel.hpp"
+#include "okapi/api/chassis/model/slewRateChassisModel.hpp"
 #include "okapi/api/chassis/model/threeEncoderSkidSteerModel.hpp"
 #include "okapi/api/chassis/model/threeEncoderXDriveModel.hpp"
+#include "okapi/api/chassis/model/voltageCompensator.hpp"
 #include "okapi/api/chassis/model/xDriveModel.hpp"
 #include "okapi/impl/chassis/controller/chassisControllerBuilder.hpp"
 
+#include "okapi/api/control/async/asyncHolonomicProfileController.hpp"
+#include "okapi/api/control/async/asyncMultiAxisProfileController.hpp"
 #include "okapi/api/control/async/asyncLinearMotionProfileController.hpp"
 #include "okapi/api/control/async/asyncMotionProfileController.hpp"
 #include "okapi/api/control/async/asyncPosIntegratedController.hpp"
 #include "okapi/api/control/async/asyncPosPidController.hpp"
+#include "okapi/api/control/async/asyncPurePursuitController.hpp"
+#include "okapi/api/control/async/asyncVelBangBangController.hpp"
 #include "okapi/api/control/async/asyncVelIntegratedController.hpp"
 #include "okapi/api/control/async/asyncVelPidController.hpp"
+#include "okapi/api/control/async/asyncVelTbhController.hpp"
 #include "okapi/api/control/async/asyncWrapper.hpp"
+#include "okapi/api/control/async/cascadePositionController.hpp"
 #include "okapi/api/control/controllerInput.hpp"
+#include "okapi/api/control/velocityControllerInput.hpp"
 #include "okapi/api/control/controllerOutput.hpp"
+#include "okapi/api/control/iterative/iterativeBangBangController.hpp"
 #include "okapi/api/control/iterative/iterativeMotorVelocityController.hpp"
 #include "okapi/api/control/iterative/iterativePosPidController.hpp"
+#include "okapi/api/control/iterative/iterativeTbhController.hpp"
 #include "okapi/api/control/iterative/iterativeVelPidController.hpp"
+#include "okapi/api/control/iterative/pidBank.hpp"
+#include "okapi/api/control/iterative/staticPid.hpp"
 #include "okapi/api/control/util/controllerRunner.hpp"
+#include "okapi/api/control/util/routineExecutor.hpp"
+#include "okapi/api/control/util/controlScheduler.hpp"
+#include "okapi/api/control/util/diffDriveMpc.hpp"
+#include "okapi/api/control/util/coprocessorClient.hpp"
+#include "okapi/api/control/util/batchFlywheelSimulator.hpp"
+#include "okapi/api/control/util/flywheelReadyDetector.hpp"
 #include "okapi/api/control/util/flywheelSimulator.hpp"
+#include "okapi/api/control/util/loopTimingRecorder.hpp"
+#include "okapi/api/control/util/stepProfiler.hpp"
+#include "okapi/api/control/util/motorFeedforward.hpp"
+#include "okapi/api/control/util/incrementalPathGenerator.hpp"
+#include "okapi/api/control/util/integratedSettleTracker.hpp"
+#include "okapi/api/control/util/pathAnalyzer.hpp"
+#include "okapi/api/control/util/pathBinaryFormat.hpp"
+#include "okapi/api/control/util/pathPool.hpp"
+#include "okapi/api/control/util/pathStreamReader.hpp"
+#include "okapi/api/control/util/pathTrackingRecorder.hpp"
 #include "okapi/api/control/util/pidTuner.hpp"
+#include "okapi/api/control/util/profileGenerator.hpp"
+#include "okapi/api/control/util/profileResampler.hpp"
+#include "okapi/api/control/util/profileRetimer.hpp"
+#include "okapi/api/control/util/relayTuner.hpp"
 #include "okapi/api/control/util/settledUtil.hpp"
+#include "okapi/api/control/util/sharedControllerState.hpp"
+#include "okapi/api/control/util/trapezoidProfile.hpp"
+#include "okapi/api/control/util/visionAlignController.hpp"
 #include "okapi/impl/control/async/asyncMotionProfileControllerBuilder.hpp"
 #include "okapi/impl/control/async/asyncPosControllerBuilder.hpp"
 #include "okapi/impl/control/async/asyncVelControllerBuilder.hpp"
 #include "okapi/impl/control/iterative/iterativeControllerFactory.hpp"
 #include "okapi/impl/control/util/controllerRunnerFactory.hpp"
 #include "okapi/impl/control/util/pidTunerFactory.hpp"
+#include "okapi/impl/control/util/relayTunerFactory.hpp"
 
+#include "okapi/api/odometry/fieldMap.hpp"
+#include "okapi/api/odometry/holonomicOdometry.hpp"
+#include "okapi/api/odometry/imuFusedOdometry.hpp"
+#include "okapi/api/odometry/kalmanOdometry.hpp"
+#include "okapi/api/odometry/odomIntegration.hpp"
 #include "okapi/api/odometry/odomMath.hpp"
 #include "okapi/api/odometry/odometry.hpp"
+#include "okapi/api/odometry/poseHistory.hpp"
+#include "okapi/api/odometry/sharedOdomState.hpp"
 #include "okapi/api/odometry/threeEncoderOdometry.hpp"
+#include "okapi/api/odometry/trackingWheelOdometry.hpp"
+#include "okapi/api/odometry/wallCorrectedOdometry.hpp"
 
+#include "okapi/api/device/abstractPingSensor.hpp"
+#include "okapi/api/device/abstractSerialPort.hpp"
+#include "okapi/api/device/controllerDisplayService.hpp"
+#include "okapi/api/device/dashboardService.hpp"
+#include "okapi/api/device/pingScheduler.hpp"
+#include "okapi/api/device/sensorSamplingService.hpp"
+#include "okapi/api/device/visionSamplingService.hpp"
+#include "okapi/api/device/motor/motorCurrentController.hpp"
+#include "okapi/api/device/motor/motorHealthMonitor.hpp"
+#include "okapi/api/device/motor/motorLinearizer.hpp"
+#include "okapi/api/device/motor/motorWriteCoalescer.hpp"
+#include "okapi/api/device/motor/motorLoadBalancer.hpp"
+#include "okapi/api/device/motor/motorPowerBudget.hpp"
 #include "okapi/api/device/rotarysensor/continuousRotarySensor.hpp"
+#include "okapi/api/device/rotarysensor/driftCompensatedGyro.hpp"
+#include "okapi/api/device/rotarysensor/imuGroup.hpp"
+#include "okapi/api/device/rotarysensor/potentiometerCalibration.hpp"
 #include "okapi/api/device/rotarysensor/rotarySensor.hpp"
+#include "okapi/api/device/rotarysensor/rotarySensorGroup.hpp"
 #include "okapi/impl/device/adiUltrasonic.hpp"
+#include "okapi/impl/device/battery.hpp"
 #include "okapi/impl/device/button/adiButton.hpp"
 #include "okapi/impl/device/button/controllerButton.hpp"
+#include "okapi/impl/device/button/controllerButtonEventService.hpp"
 #include "okapi/impl/device/controller.hpp"
+#include "okapi/impl/device/controllerScreen.hpp"
+#include "okapi/impl/device/dashboard.hpp"
 #include "okapi/impl/device/distanceSensor.hpp"
 #include "okapi/impl/device/motor/adiMotor.hpp"
 #include "okapi/impl/device/motor/motor.hpp"
 #include "okapi/impl/device/motor/motorGroup.hpp"
 #include "okapi/impl/device/opticalSensor.hpp"
+#include "okapi/impl/device/sampledDistanceSensor.hpp"
+#include "okapi/impl/device/sampledOpticalSensor.hpp"
+#include "okapi/impl/device/serialPort.hpp"
 #include "okapi/impl/device/rotarysensor/IMU.hpp"
 #include "okapi/impl/device/rotarysensor/adiEncoder.hpp"
 #include "okapi/impl/device/rotarysensor/adiGyro.hpp"
 #include "okapi/impl/device/rotarysensor/integratedEncoder.hpp"
 #include "okapi/impl/device/rotarysensor/potentiometer.hpp"
 #include "okapi/impl/device/rotarysensor/rotationSensor.hpp"
+#include "okapi/impl/device/rotarysensor/rotationSensorGroup.hpp"
+#include "okapi/impl/device/visionSensor.hpp"
 
+#include "okapi/api/filter/alphaBetaFilter.hpp"
+#include "okapi/api/filter/alphaBetaVelMath.hpp"
 #include "okapi/api/filter/averageFilter.hpp"
+#include "okapi/api/filter/biquadFilter.hpp"
 #include "okapi/api/filter/composableFilter.hpp"
+#include "okapi/api/filter/demaBank.hpp"
 #include "okapi/api/filter/demaFilter.hpp"
 #include "okapi/api/filter/ekfFilter.hpp"
+#include "okapi/api/filter/emaBank.hpp"
 #include "okapi/api/filter/emaFilter.hpp"
 #include "okapi/api/filter/filter.hpp"
+#include "okapi/api/filter/filterBank.hpp"
+#include "okapi/api/filter/filterChain.hpp"
 #include "okapi/api/filter/filteredControllerInput.hpp"
+#include "okapi/api/filter/kalmanFilter.hpp"
+#include "okapi/api/filter/leastSquaresVelMath.hpp"
 #include "okapi/api/filter/medianFilter.hpp"
 #include "okapi/api/filter/passthroughFilter.hpp"
 #include "okapi/api/filter/velMath.hpp"
@@ -125,10 +209,26 @@
 
 #include "okapi/api/util/abstractRate.hpp"
 #include "okapi/api/util/abstractTimer.hpp"
+#include "okapi/api/util/allocationGuard.hpp"
+#include "okapi/api/util/batchMath.hpp"
+#include "okapi/api/util/fastTrig.hpp"
+#include "okapi/api/util/flightRecorder.hpp"
+#include "okapi/api/util/hostThreadPool.hpp"
+#include "okapi/api/util/inputRecorder.hpp"
+#include "okapi/api/util/inputReplayer.hpp"
+#include "okapi/api/util/joystickCurve.hpp"
 #include "okapi/api/util/mathUtil.hpp"
+#include "okapi/api/util/matrix.hpp"
+#include "okapi/api/util/resourceUsage.hpp"
+#include "okapi/api/util/serialLink.hpp"
 #include "okapi/api/util/supplier.hpp"
+#include "okapi/api/util/taskProfiler.hpp"
+#include "okapi/api/util/telemetryLogger.hpp"
+#include "okapi/api/util/telemetryStream.hpp"
 #include "okapi/api/util/timeUtil.hpp"
 #include "okapi/impl/util/configurableTimeUtilFactory.hpp"
+#include "okapi/impl/util/hybridRate.hpp"
+#include "okapi/impl/util/microsTimer.hpp"
 #include "okapi/impl/util/rate.hpp"
 #include "okapi/impl/util/timeUtilFactory.hpp"
 #include "okapi/impl/util/timer.hpp"
@@ -6,6 +6,7 @@
 #pragma once
 
 #include "okapi/api/chassis/controller/chassisScales.hpp"
+#include "okapi/api/chassis/controller/moveMonitor.hpp"
 #include "okapi/api/chassis/model/chassisModel.hpp"
 #include "okapi/api/device/motor/abstractMotor.hpp"
 #include "okapi/api/units/QAngle.hpp"
@@ -102,6 +103,16 @@ class ChassisController {
    */
   virtual void waitUntilSettled() = 0;
 
+  /**
+   * Gets how the last movement ended, such as whether it stalled or timed out instead of settling.
+   * Controllers which don't watch for stalls or timeouts always report `MoveResult::settled`.
+   *
+   * @return How the last movement ended.
+   */
+  virtual MoveResult getLastMoveResult() const {
+    return MoveResult::settled;
+  }
+
   /**
    * Interrupts the current movement to stop the robot.
    */
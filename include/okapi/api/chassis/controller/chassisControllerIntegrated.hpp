@@ -7,8 +7,13 @@
 
 #include "okapi/api/chassis/controller/chassisController.hpp"
 #include "okapi/api/control/async/asyncPosIntegratedController.hpp"
+#include "okapi/api/control/util/pathfinderUtil.hpp"
+#include "okapi/api/control/util/trapezoidProfile.hpp"
+#include "okapi/api/device/rotarysensor/continuousRotarySensor.hpp"
+#include "okapi/api/units/QSpeed.hpp"
 #include "okapi/api/util/logging.hpp"
 #include "okapi/api/util/timeUtil.hpp"
+#include <atomic>
 
 namespace okapi {
 class ChassisControllerIntegrated : public ChassisController {
@@ -35,6 +40,11 @@ class ChassisControllerIntegrated : public ChassisController {
     const ChassisScales &iscales = ChassisScales({1, 1}, imev5GreenTPR),
     std::shared_ptr<Logger> ilogger = Logger::getDefaultLogger());
 
+  ChassisControllerIntegrated(const ChassisControllerIntegrated &) = delete;
+  ChassisControllerIntegrated &operator=(const ChassisControllerIntegrated &) = delete;
+
+  ~ChassisControllerIntegrated() override;
+
   /**
    * Drives the robot straight for a distance (using closed-loop control).
    *
@@ -133,6 +143,99 @@ class ChassisControllerIntegrated : public ChassisController {
    */
   void waitUntilSettled() override;
 
+  /**
+   * Makes `moveDistance` and `turnAngle` follow a trapezoidal profile generated on the brain
+   * instead of the motors' own profile. Every period, the internal thread sends each side the
+   * velocity of the profile, and once the profile is done the motors hold the target with their
+   * position control. The timing of a movement no longer depends on the motors. The limits are for
+   * the chassis for moves and for each wheel for turns, and must be reachable under the max
+   * velocity. Starts the internal thread if it is not running. Throws a `std::invalid_argument` if
+   * the max velocity or max acceleration is not positive or the period is shorter than `1_ms`.
+   *
+   * @param ilimits The max velocity in m/s and acceleration in m/s^2. The jerk is not used.
+   * @param iperiod The time between velocity setpoints. `5_ms` to `10_ms` suits the V5 motors.
+   */
+  void setProfileLimits(const PathfinderLimits &ilimits, QTime iperiod = 10_ms);
+
+  /**
+   * Makes `moveDistance` and `turnAngle` send the motors a position target again.
+   */
+  void clearProfileLimits();
+
+  /**
+   * Corrects the heading of the robot during `moveDistance` using a heading sensor, such as an IMU.
+   * The motors still run the movement with their own position control, but every period the
+   * internal thread slows down the side which is ahead in proportion to how far the heading has
+   * drifted since the movement started, by lowering the velocity of its profile. Starts the
+   * internal thread if it is not running. Throws a `std::invalid_argument` if the gain is
+   * negative.
+   *
+   * @param isensor The heading sensor. Must read the heading in degrees, increasing clockwise.
+   * Pass `nullptr` to turn the correction off.
+   * @param ikP The fraction of the max velocity to take off the side which is ahead per degree of
+   * drift.
+   */
+  void setHeadingCorrection(std::shared_ptr<ContinuousRotarySensor> isensor, double ikP = 0.05);
+
+  /**
+   * Starts the internal thread which streams the velocity of profiled movements (see
+   * `setProfileLimits`) and corrects the heading (see `setHeadingCorrection`). While it runs, it
+   * also reads the motors once per tick to decide when a movement is done, so waiting for a
+   * movement doesn't read them and ends as soon as the motors stop at the target. This method is
+   * called by the ChassisControllerBuilder when the builder is given profile limits or a heading
+   * sensor.
+   *
+   * @param ipriority The priority of the task.
+   * @param istackDepth The stack depth of the task in words.
+   */
+  void startThread(std::uint32_t ipriority = TASK_PRIORITY_DEFAULT,
+                   std::uint16_t istackDepth = TASK_STACK_DEPTH_DEFAULT);
+
+  /**
+   * Starts the internal thread on the first movement instead of now, so a controller which isn't
+   * used until later doesn't run a task until then.
+   *
+   * @param ipriority The priority of the task.
+   * @param istackDepth The stack depth of the task in words.
+   */
+  void startThreadLazily(std::uint32_t ipriority = TASK_PRIORITY_DEFAULT,
+                         std::uint16_t istackDepth = TASK_STACK_DEPTH_DEFAULT);
+
+  /**
+   * Returns the underlying thread handle.
+   *
+   * @return The underlying thread handle, or `nullptr` if the thread is not running.
+   */
+  CrossplatformThread *getThread() const;
+
+  /**
+   * Sets how long a movement may take before `waitUntilSettled` ends it. A movement which times
+   * out stops the drive and reports `MoveResult::timedOut` (see `getLastMoveResult`). The motors
+   * run the movement on their own, so it is only checked while waiting.
+   *
+   * @param itimeout The timeout, or zero for no timeout.
+   */
+  void setMoveTimeout(QTime itimeout);
+
+  /**
+   * Makes `waitUntilSettled` end a movement once the robot stops making progress before it
+   * settles, such as when it drives into a wall. A movement which stalls stops the drive and
+   * reports `MoveResult::stalled` (see `getLastMoveResult`). Use a stall time longer than the
+   * settle time of the motors, since the robot also slows down near the target.
+   *
+   * @param iminSpeed The min speed of the wheels.
+   * @param istallTime How long the wheels must move slower than the min speed. Zero turns stall
+   * detection off.
+   */
+  void setStallDetection(QSpeed iminSpeed, QTime istallTime);
+
+  /**
+   * Gets how the last movement ended. It is `MoveResult::settled` while a movement is running.
+   *
+   * @return How the last movement ended.
+   */
+  MoveResult getLastMoveResult() const override;
+
   /**
    * Interrupts the current movement to stop the robot.
    */
@@ -180,5 +283,79 @@ class ChassisControllerIntegrated : public ChassisController {
   int lastTarget;
   ChassisScales scales;
   AbstractMotor::GearsetRatioPair gearsetRatioPair;
+  std::unique_ptr<AbstractTimer> moveTimer;
+  // Made once so waiting for a move does not allocate
+  std::unique_ptr<AbstractRate> waitRate;
+  MoveMonitor moveMonitor{};
+  // Where the motors were when the movement started
+  double leftMoveStart{0};
+  double rightMoveStart{0};
+  MoveResult lastMoveResult{MoveResult::settled};
+
+  std::atomic_bool dtorCalled{false};
+  CrossplatformThread *task{nullptr};
+  // Whether the first movement starts the thread, and the task it starts
+  bool lazyStart{false};
+  std::uint32_t lazyPriority{TASK_PRIORITY_DEFAULT};
+  std::uint16_t lazyStackDepth{TASK_STACK_DEPTH_DEFAULT};
+
+  // This must be locked when accessing the profile limits, the profile of the movement, or the
+  // heading correction
+  CrossplatformMutex profileMutex;
+  double maxProfileVelocity{0};     // motor ticks per second
+  double maxProfileAcceleration{0}; // motor ticks per second^2
+  QTime profilePeriod{10_ms};
+  std::unique_ptr<TrapezoidProfile> moveProfile{nullptr};
+  std::unique_ptr<AbstractTimer> profileTimer;
+  QTime profileStart{0_ms};
+  double rightProfileSign{1};
+  // Whether the motors are following a profile instead of holding their targets
+  std::atomic_bool profileRunning{false};
+  std::shared_ptr<ContinuousRotarySensor> headingSensor{nullptr};
+  double headingGain{0};
+  double headingStart{0};     // degrees
+  double headingDirection{0}; // 1 for forward and -1 for backward moves, 0 if not correcting
+  double leftTrim{1};
+  double rightTrim{1};
+  std::int32_t leftTrimmedVelocity{0};  // rpm
+  std::int32_t rightTrimmedVelocity{0}; // rpm
+
+  static void trampoline(void *context);
+  void loop();
+
+  /**
+   * Starts a movement, along a profile if there are profile limits.
+   *
+   * @param itarget The target of the left side, relative to where it is, in motor ticks.
+   * @param irightSign The direction the right side moves relative to the left side.
+   */
+  void startMovement(double itarget, double irightSign);
+
+  /**
+   * Sends each side the velocity of the profile, or hands the movement to the position
+   * controllers once the profile is done.
+   */
+  void stepProfile();
+
+  /**
+   * Reads the heading sensor and works out how much to slow down each side. Trims the velocity of
+   * the motors' own profiles when the movement is not profiled on the brain.
+   */
+  void stepHeadingCorrection();
+
+  /**
+   * Drops the profile and the heading correction of the current movement.
+   */
+  void clearMoveProfile();
+
+  /**
+   * Starts watching a new movement for a stall or a timeout.
+   */
+  void startMoveMonitor();
+
+  /**
+   * @return How far the motors have turned since the movement started, in motor ticks.
+   */
+  double getMoveTravel() const;
 };
 } // namespace okapi
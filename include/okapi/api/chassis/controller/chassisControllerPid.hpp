@@ -6,17 +6,75 @@
 #pragma once
 
 #include "okapi/api/chassis/controller/chassisController.hpp"
+#include "okapi/api/chassis/model/hDriveModel.hpp"
 #include "okapi/api/control/iterative/iterativePosPidController.hpp"
+#include "okapi/api/control/util/controlScheduler.hpp"
+#include "okapi/api/control/util/motorFeedforward.hpp"
+#include "okapi/api/control/util/pathfinderUtil.hpp"
+#include "okapi/api/control/util/trapezoidProfile.hpp"
+#include "okapi/api/device/rotarysensor/continuousRotarySensor.hpp"
+#include "okapi/api/units/QAcceleration.hpp"
+#include "okapi/api/units/QSpeed.hpp"
 #include "okapi/api/util/abstractRate.hpp"
 #include "okapi/api/util/logging.hpp"
+#include "okapi/api/util/telemetryStream.hpp"
 #include "okapi/api/util/timeUtil.hpp"
 #include <atomic>
+#include <deque>
+#include <limits>
 #include <memory>
 #include <tuple>
 
 namespace okapi {
+/**
+ * A move or a turn to queue on a ChassisControllerPID (see `ChassisControllerPID::enqueue`).
+ */
+struct ChassisCommand {
+  enum class Type { move, turn };
+
+  /**
+   * When a command is done and the next one can start.
+   */
+  enum class Settle {
+    tight,      ///< Once the controllers settle, like `waitUntilSettled`.
+    loose,      ///< As soon as the error is inside the loose tolerance (see
+                ///< `ChassisControllerPID::setLooseSettleTolerance`).
+    exitOnCross ///< As soon as the robot reaches the target, without stopping there.
+  };
+
+  Type type;
+  QLength distance{0_m};
+  QAngle angle{0_deg};
+  Settle settle{Settle::tight};
+
+  /**
+   * How long the command may take, or zero to use the controller's timeout (see
+   * `ChassisControllerPID::setMoveTimeout`).
+   */
+  QTime timeout{0_ms};
+
+  /**
+   * @return A command which drives straight for a distance, like `moveDistance`.
+   */
+  static ChassisCommand
+  move(QLength idistance, Settle isettle = Settle::tight, QTime itimeout = 0_ms);
+
+  /**
+   * @return A command which turns in place by an angle, like `turnAngle`.
+   */
+  static ChassisCommand turn(QAngle iangle, Settle isettle = Settle::tight, QTime itimeout = 0_ms);
+};
+
 class ChassisControllerPID : public ChassisController {
   public:
+  /**
+   * The shape of the profile the targets of moves and turns follow (see `setProfileLimits`).
+   */
+  enum class ProfileShape {
+    trapezoid, ///< The acceleration jumps between zero and the max acceleration
+    sCurve     ///< The acceleration ramps up and down at the max jerk
+  };
+
   /**
    * ChassisController using PID control. Puts the motors into encoder count units. Throws a
    * `std::invalid_argument` exception if the gear ratio is zero.
@@ -127,6 +185,68 @@ class ChassisControllerPID : public ChassisController {
    */
   void turnRawAsync(double idegTarget) override;
 
+  /**
+   * Strafes the robot sideways for a distance (using closed-loop control) while holding its
+   * heading. Needs a strafe controller (see `setStrafeController`).
+   *
+   * ```cpp
+   * // Strafe 6 inches to the right
+   * chassis->strafeDistance(6_in);
+   * ```
+   *
+   * @param itarget distance to strafe, positive to the right
+   */
+  void strafeDistance(QLength itarget);
+
+  /**
+   * Sets the target distance for the robot to strafe sideways (using closed-loop control). Needs a
+   * strafe controller (see `setStrafeController`).
+   *
+   * @param itarget distance to strafe, positive to the right
+   */
+  void strafeDistanceAsync(QLength itarget);
+
+  /**
+   * Drives the robot forward and strafes it sideways at once, so it moves diagonally in one motion
+   * (using closed-loop control). The forward distance follows the distance profile, if there is
+   * one, and the strafe distance jumps to its target. Needs a strafe controller (see
+   * `setStrafeController`).
+   *
+   * ```cpp
+   * // Drive 12 inches forward and 6 inches to the left
+   * chassis->moveVector(12_in, -6_in);
+   * ```
+   *
+   * @param iforward distance to travel forward
+   * @param istrafe distance to strafe, positive to the right
+   */
+  void moveVector(QLength iforward, QLength istrafe);
+
+  /**
+   * Sets the target distances for the robot to drive forward and strafe sideways at once (using
+   * closed-loop control). Needs a strafe controller (see `setStrafeController`).
+   *
+   * @param iforward distance to travel forward
+   * @param istrafe distance to strafe, positive to the right
+   */
+  void moveVectorAsync(QLength iforward, QLength istrafe);
+
+  /**
+   * Closes the loop on the middle wheel of an H-drive, so the controller can strafe (see
+   * `strafeDistance` and `moveVector`). The strafe controller reads the middle sensor of the model
+   * and drives the middle motor; its target is in ticks of the middle sensor, using the middle
+   * scale and the gear ratio. Throws a `std::invalid_argument` if the model is not an
+   * `HDriveModel`. Set the controller while the chassis is not moving.
+   *
+   * @param icontroller The strafe controller, or `nullptr` to remove it.
+   */
+  void setStrafeController(std::unique_ptr<IterativePosPIDController> icontroller);
+
+  /**
+   * @return Whether the controller can strafe.
+   */
+  bool hasStrafeController() const;
+
   /**
    * Sets whether turns should be mirrored.
    *
@@ -135,14 +255,94 @@ class ChassisControllerPID : public ChassisController {
   void setTurnsMirrored(bool ishouldMirror) override;
 
   /**
-   * Checks whether the internal controllers are currently settled.
+   * Adds to a chain of commands returned by `enqueue`.
+   */
+  class CommandChain {
+    public:
+    explicit CommandChain(ChassisControllerPID &icontroller);
+
+    /**
+     * Queues a command to run once the ones before it settle.
+     *
+     * @param icommand The command.
+     * @return This chain.
+     */
+    CommandChain &then(const ChassisCommand &icommand);
+
+    protected:
+    ChassisControllerPID &controller;
+  };
+
+  /**
+   * Queues a command to run once the current movement and the commands queued before it settle.
+   * The controller task starts each command on the step its previous one settles, so there is no
+   * wait for the calling task to notice and send the next one. Calling `moveDistanceAsync`,
+   * `turnAngleAsync`, or `stop` clears the queue.
+   *
+   * ```cpp
+   * chassis->enqueue(ChassisCommand::move(24_in))
+   *   .then(ChassisCommand::turn(90_deg))
+   *   .then(ChassisCommand::move(12_in));
+   * chassis->waitUntilSettled();
+   * ```
+   *
+   * @param icommand The command.
+   * @return A chain to queue more commands on.
+   */
+  CommandChain enqueue(const ChassisCommand &icommand);
+
+  /**
+   * @return The number of queued commands which have not started yet.
+   */
+  std::size_t getQueueSize() const;
+
+  /**
+   * Sets how close a command with `ChassisCommand::Settle::loose` must get to its target before the
+   * next command starts. Unlike a tight settle, the error does not have to stay there and the robot
+   * does not have to slow down. The drive is never stopped between queued commands, so the robot
+   * carries its speed into the next one.
+   *
+   * @param idistance The largest distance error of a move.
+   * @param iangle The largest angle error of a turn.
+   */
+  void setLooseSettleTolerance(QLength idistance, QAngle iangle);
+
+  /**
+   * Sets how long a movement may take before it ends. A movement which times out stops the drive
+   * and reports `MoveResult::timedOut` (see `getLastMoveResult`), and `waitUntilSettled` returns.
+   *
+   * @param itimeout The timeout, or zero for no timeout.
+   */
+  void setMoveTimeout(QTime itimeout);
+
+  /**
+   * Ends a movement once the robot stops making progress before it settles, such as when it drives
+   * into a wall. A movement which stalls stops the drive and reports `MoveResult::stalled` (see
+   * `getLastMoveResult`), and `waitUntilSettled` returns. Use a stall time longer than the settle
+   * time of the controllers, since the robot also slows down near the target.
+   *
+   * @param iminSpeed The min speed of the wheels.
+   * @param istallTime How long the wheels must move slower than the min speed. Zero turns stall
+   * detection off.
+   */
+  void setStallDetection(QSpeed iminSpeed, QTime istallTime);
+
+  /**
+   * Gets how the last movement ended. It is `MoveResult::settled` while a movement is running.
+   *
+   * @return How the last movement ended.
+   */
+  MoveResult getLastMoveResult() const override;
+
+  /**
+   * Checks whether the internal controllers are currently settled and no queued commands are left.
    *
    * @return Whether this ChassisController is settled.
    */
   bool isSettled() override;
 
   /**
-   * Delays until the currently executing movement completes.
+   * Delays until the currently executing movement and any queued commands complete.
    */
   void waitUntilSettled() override;
 
@@ -187,11 +387,104 @@ class ChassisControllerPID : public ChassisController {
              IterativePosPIDController::Gains>
   getGains() const;
 
+  /**
+   * Sets how the integral of every controller is kept from winding up while the output is
+   * saturated (see `IterativePosPIDController::setAntiWindup`). Distance moves usually start
+   * saturated, so this mostly affects how far they overshoot.
+   *
+   * @param istrategy The strategy to use.
+   * @param itrackingGain The tracking gain used by back-calculation.
+   */
+  void setAntiWindup(IterativePosPIDController::antiWindup istrategy, double itrackingGain = 1);
+
+  /**
+   * Makes `moveDistance` follow a trapezoidal profile instead of jumping to the target. Every step,
+   * the distance controller's target moves along the profile and the feedforward gives the output
+   * for the velocity and acceleration of the profile, so the distance controller only has to
+   * correct what the feedforward misses. The output is a fraction of the max velocity in velocity
+   * mode and of the max voltage in voltage mode (see `setVelocityMode`). Throws a
+   * `std::invalid_argument` if the max velocity or max acceleration is not positive.
+   *
+   * @param ifeedforward The feedforward, with gains per m/s and per m/s^2 of the chassis.
+   * @param imaxVelocity The max velocity of the profile.
+   * @param imaxAcceleration The max acceleration of the profile.
+   */
+  void setDistanceProfile(const MotorFeedforward &ifeedforward,
+                          const QSpeed &imaxVelocity,
+                          const QAcceleration &imaxAcceleration);
+
+  /**
+   * Makes `moveDistance` jump to the target again, without a feedforward.
+   */
+  void clearDistanceProfile();
+
+  /**
+   * Makes `moveDistance` and `turnAngle` follow a profile instead of jumping to the target, so
+   * the controllers don't saturate and overshoot on long moves. Every step, the target of the
+   * distance or turn controller moves along the profile. The limits are for the chassis for moves
+   * and for each wheel for turns. Any feedforward set on the controllers (see
+   * `IterativePosPIDController::setFeedforward`) is given the velocity and acceleration of the
+   * profile. Throws a `std::invalid_argument` if the max velocity or max acceleration is not
+   * positive, or if the max jerk of an S-curve is not positive.
+   *
+   * @param ilimits The max velocity in m/s, acceleration in m/s^2, and jerk in m/s^3.
+   * @param ishape The shape of the profile. The jerk is only used by an S-curve.
+   */
+  void setProfileLimits(const PathfinderLimits &ilimits,
+                        ProfileShape ishape = ProfileShape::trapezoid);
+
+  /**
+   * Makes `moveDistance` and `turnAngle` jump to the target again. Leaves any feedforward alone.
+   */
+  void clearProfileLimits();
+
+  /**
+   * Feeds the turn and angle controllers from a heading sensor, such as an IMU, instead of the
+   * difference between the encoders, so wheel slip does not throw off turns or the heading held
+   * during moves. The turn and angle controllers then work in degrees of heading, so their gains
+   * must be retuned; they can usually be more aggressive. Profiled turns are converted to degrees
+   * using the turn scale. Set the sensor while the chassis is not moving.
+   *
+   * @param isensor The heading sensor. Must read the heading in degrees, increasing clockwise.
+   * Pass `nullptr` to go back to the encoders.
+   */
+  void setHeadingSensor(std::shared_ptr<ContinuousRotarySensor> isensor);
+
+  /**
+   * @return The heading sensor, or `nullptr` if turns use the encoders.
+   */
+  std::shared_ptr<ContinuousRotarySensor> getHeadingSensor() const;
+
   /**
    * Starts the internal thread. This method is called by the ChassisControllerBuilder when making a
    * new instance of this class.
+   *
+   * @param ipriority The priority of the task.
+   * @param istackDepth The stack depth of the task in words.
+   */
+  void startThread(std::uint32_t ipriority = TASK_PRIORITY_DEFAULT,
+                   std::uint16_t istackDepth = TASK_STACK_DEPTH_DEFAULT);
+
+  /**
+   * Starts the internal thread on the first movement instead of now, so a controller which isn't
+   * used until later, like one built in `initialize` for autonomous, doesn't run a task until then.
+   * This is called by the ChassisControllerBuilder instead of `startThread` when it is built with
+   * `withLazyThreadStart`.
+   *
+   * @param ipriority The priority of the task.
+   * @param istackDepth The stack depth of the task in words.
    */
-  void startThread();
+  void startThreadLazily(std::uint32_t ipriority = TASK_PRIORITY_DEFAULT,
+                         std::uint16_t istackDepth = TASK_STACK_DEPTH_DEFAULT);
+
+  /**
+   * Steps the controller from a shared scheduler in its controllers phase instead of starting an
+   * internal thread, so it reads odometry stepped in the same tick. This should not be called by
+   * normal users, and not together with `startThread`.
+   *
+   * @param ischeduler The scheduler to step the controller from.
+   */
+  void startScheduled(const std::shared_ptr<ControlScheduler> &ischeduler);
 
   /**
    * Returns the underlying thread handle.
@@ -228,6 +521,16 @@ class ChassisControllerPID : public ChassisController {
    */
   ChassisModel &model() override;
 
+  /**
+   * Streams the errors and outputs of the distance, turn, and angle controllers as signals named
+   * `<iname>.distanceError`, `<iname>.distanceOutput`, and so on. The signals are removed when this
+   * controller is destroyed.
+   *
+   * @param istream The stream to add the signals to.
+   * @param iname The prefix of the signal names.
+   */
+  void addTelemetry(const std::shared_ptr<TelemetryStream> &istream, const std::string &iname);
+
   protected:
   std::shared_ptr<Logger> logger;
   bool normalTurns{true};
@@ -236,6 +539,9 @@ class ChassisControllerPID : public ChassisController {
   std::unique_ptr<IterativePosPIDController> distancePid;
   std::unique_ptr<IterativePosPIDController> turnPid;
   std::unique_ptr<IterativePosPIDController> anglePid;
+  // Both null unless the controller can strafe
+  std::unique_ptr<IterativePosPIDController> strafePid{nullptr};
+  std::shared_ptr<HDriveModel> hDriveModel{nullptr};
   ChassisScales scales;
   AbstractMotor::GearsetRatioPair gearsetRatioPair;
   bool velocityMode{true};
@@ -243,11 +549,148 @@ class ChassisControllerPID : public ChassisController {
   std::atomic_bool doneLoopingSeen{true};
   std::atomic_bool newMovement{false};
   std::atomic_bool dtorCalled{false};
+  // Whether the current move also strafes
+  std::atomic_bool strafing{false};
   QTime threadSleepTime{10_ms};
 
+  /**
+   * The limits of the profile of a move or a turn, in motor ticks. A max velocity of zero means the
+   * target jumps instead.
+   */
+  struct ProfileLimits {
+    double maxVelocity{0};
+    double maxAcceleration{0};
+    double maxJerk{std::numeric_limits<double>::infinity()};
+  };
+
+  // This must be locked when accessing the profile limits, the profile of the move, or the heading
+  // sensor
+  mutable CrossplatformMutex profileMutex;
+  ProfileLimits distanceLimits{};
+  ProfileLimits turnLimits{};
+  std::unique_ptr<TrapezoidProfile> moveProfile{nullptr};
+  std::atomic_bool moveProfileDone{true};
+  std::unique_ptr<AbstractTimer> profileTimer;
+  std::shared_ptr<ContinuousRotarySensor> headingSensor{nullptr};
+
+  // Made once so waitUntilSettled does not allocate. Only the task waiting to settle uses it.
+  std::unique_ptr<AbstractRate> waitRate;
+
+  // This must be locked when accessing the command queue. Lock it before the profileMutex.
+  mutable CrossplatformMutex queueMutex;
+  std::deque<ChassisCommand> commandQueue{};
+  // Whether the controller task starts the next queued command once the current movement settles
+  std::atomic_bool queueRunning{false};
+  // How the current movement decides it is done. Direct moves and turns settle tightly.
+  ChassisCommand::Settle currentSettle{ChassisCommand::Settle::tight};
+  QLength looseDistanceTolerance{1_in};
+  QAngle looseAngleTolerance{3_deg};
+  QTime moveTimeout{0_ms};
+  // The timeout of the queued command which started the current movement, or zero for none
+  QTime commandTimeout{0_ms};
+
+  // Locked by the profileMutex
+  MoveMonitor moveMonitor{};
+  // Whether the current movement stalled or timed out
+  std::atomic_bool moveEnded{false};
+  std::atomic<MoveResult> lastMoveResult{MoveResult::settled};
+  // Declared last so the signals are removed before anything they read is destroyed
+  TelemetryRegistration telemetry;
+
   static void trampoline(void *context);
   void loop();
 
+  /**
+   * Starts measuring movements from the current sensor values. Called once before the first step.
+   */
+  void beginStepping();
+
+  /**
+   * Steps the current movement once. Called by the task or the scheduler every
+   * `threadSleepTime`.
+   */
+  void step();
+
+  /**
+   * Gives the controller the target of a new move, either all at once or along a profile. Must be
+   * called with the profileMutex locked.
+   *
+   * @param icontroller The distance or turn controller.
+   * @param ilimits The limits of the profile.
+   * @param itarget The target in motor ticks.
+   */
+  void startMoveProfile(IterativePosPIDController &icontroller,
+                        const ProfileLimits &ilimits,
+                        double itarget);
+
+  /**
+   * Moves the controller's target along the profile of the current move, if there is one.
+   *
+   * @param icontroller The controller of the current move.
+   * @param itime The time since the move started.
+   */
+  void stepMoveProfile(IterativePosPIDController &icontroller, const QTime &itime);
+
+  /**
+   * Starts the thread if it was started lazily and this is the first movement.
+   */
+  void startLazyThread();
+
+  /**
+   * Starts a move without touching the command queue.
+   *
+   * @param itarget The distance to travel forward.
+   * @param istrafe The distance to strafe, which needs a strafe controller. Zero doesn't strafe.
+   */
+  void startMoveDistance(QLength itarget, QLength istrafe = 0_m);
+
+  /**
+   * Drives the middle wheel with the strafe controller's output.
+   */
+  void driveStrafe(double ioutput);
+
+  /**
+   * Starts a turn without touching the command queue.
+   */
+  void startTurnAngle(QAngle idegTarget);
+
+  /**
+   * Starts a queued command without touching the command queue.
+   */
+  void startCommand(const ChassisCommand &icommand);
+
+  /**
+   * Starts the next queued command, or stops running the queue if it is empty. Called by the
+   * controller task once the current movement settles.
+   */
+  void startNextQueuedCommand();
+
+  /**
+   * Starts watching a new movement for a stall or a timeout.
+   */
+  void resetMoveMonitor();
+
+  /**
+   * Ends the current movement early and stops the drive.
+   */
+  void endMovement(MoveResult iresult);
+
+  /**
+   * Empties the command queue.
+   */
+  void clearQueue();
+
+  /**
+   * @return Whether the controllers of the current movement are settled, ignoring the queue.
+   */
+  bool isMovementSettled();
+
+  /**
+   * @return Whether the current movement is done by the settle of the command which started it,
+   * ignoring the queue.
+   */
+  bool isCommandDone();
+
   /**
    * Wait for the distance setup (distancePid and anglePid) to settle.
    *
@@ -262,6 +705,11 @@ class ChassisControllerPID : public ChassisController {
    */
   bool waitForAngleSettled();
 
+  /**
+   * @return Whether the strafe controller is settled, or true if the current move doesn't strafe.
+   */
+  bool isStrafeSettled();
+
   /**
    * Stops all the controllers and the ChassisModel.
    */
@@ -270,6 +718,20 @@ class ChassisControllerPID : public ChassisController {
   typedef enum { distance, angle, none } modeType;
   modeType mode{none};
 
+  // The state of the movement being stepped. Only step() uses it.
+  std::valarray<std::int32_t> encStartVals{};
+  std::valarray<std::int32_t> encVals{};
+  std::shared_ptr<ContinuousRotarySensor> stepHeading{nullptr};
+  double headingStart{0};
+  modeType pastMode{none};
+  QTime moveStart{0_ms};
+
   CrossplatformThread *task{nullptr};
+  // Whether the first movement starts the thread, and the task it starts
+  bool lazyStart{false};
+  std::uint32_t lazyPriority{TASK_PRIORITY_DEFAULT};
+  std::uint16_t lazyStackDepth{TASK_STACK_DEPTH_DEFAULT};
+  std::shared_ptr<ControlScheduler> scheduler{nullptr};
+  std::size_t schedulerLoopId{0};
 };
 } // namespace okapi
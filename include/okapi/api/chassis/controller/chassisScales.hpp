@@ -5,6 +5,7 @@
  */
 #pragma once
 
+#include "okapi/api/device/motor/abstractMotor.hpp"
 #include "okapi/api/units/QAngle.hpp"
 #include "okapi/api/units/QLength.hpp"
 #include "okapi/api/units/RQuantity.hpp"
@@ -82,6 +83,25 @@ class ChassisScales {
   double middle;
   double tpr;
 
+  // Derived from the scales above by computeDerivedScales(), so hot loops multiply instead of
+  // dividing or converting units every step
+  double metersPerTick;
+  double middleMetersPerTick;
+  double inverseWheelTrack; // Per meter
+  double wheelRpmPerMps;
+
+  /**
+   * Recomputes the derived scales. The constructors call this; call it again after changing any of
+   * the scales by hand.
+   */
+  void computeDerivedScales();
+
+  /**
+   * @param ipair The gearset and gear ratio of the drive motors.
+   * @return The motor speed in rpm which drives a wheel at one meter per second.
+   */
+  double getMotorRpmPerMps(const AbstractMotor::GearsetRatioPair &ipair) const;
+
   protected:
   static void validateInputSize(std::size_t inputSize, const std::shared_ptr<Logger> &logger);
 };
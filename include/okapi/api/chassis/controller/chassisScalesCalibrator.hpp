@@ -0,0 +1,113 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#pragma once
+
+#include "okapi/api/chassis/controller/chassisScales.hpp"
+#include "okapi/api/chassis/model/chassisModel.hpp"
+#include "okapi/api/device/rotarysensor/continuousRotarySensor.hpp"
+#include "okapi/api/units/QAngle.hpp"
+#include "okapi/api/units/QLength.hpp"
+#include "okapi/api/units/QTime.hpp"
+#include "okapi/api/util/logging.hpp"
+#include "okapi/api/util/timeUtil.hpp"
+#include <functional>
+#include <memory>
+
+namespace okapi {
+/**
+ * Measures the `ChassisScales` of a skid steer robot by driving it, instead of measuring the
+ * wheels by hand. Worn or squished wheels and scrubbing turns make the real scales differ from the
+ * dimensions on paper, which limits how accurate odometry can be.
+ *
+ * First call `measureStraight()` to find how many ticks the robot's encoders count per meter, then
+ * `measureTurn()` to find the wheel track and the distance to the middle wheel, then hand the
+ * result of `getScales()` to the `ChassisControllerBuilder`. Each maneuver stops the robot and
+ * lets it settle before reading the sensors, so overshooting doesn't spoil the measurement.
+ */
+class ChassisScalesCalibrator {
+  public:
+  /**
+   * Measures the scales of a robot.
+   *
+   * @param imodel The chassis model to drive and read the encoders from. Its readings are the
+   * left, right, and optional middle encoders, like the readings `ThreeEncoderOdometry` uses.
+   * @param iinitialScales The scales to start from. The ticks per revolution and the middle wheel
+   * diameter are kept, and any scale which is not measured is kept.
+   * @param itimeUtil The time utility which supplies the rate of the maneuvers.
+   * @param ilogger The logger this instance will log to.
+   */
+  ChassisScalesCalibrator(std::shared_ptr<ChassisModel> imodel,
+                          const ChassisScales &iinitialScales,
+                          const TimeUtil &itimeUtil,
+                          std::shared_ptr<Logger> ilogger = Logger::getDefaultLogger());
+
+  /**
+   * Drives straight towards a wall and compares the distance the encoders count with how much
+   * closer the wall got, to find the straight scale. Start with the robot square to the wall and
+   * the distance sensor pointed at it.
+   *
+   * @param idistanceToWall Reads the distance from the robot to the wall in front of it, such as
+   * from a distance sensor.
+   * @param idistance How far to drive. Longer drives give a more accurate scale.
+   * @param ispeed The speed to drive at, in [0, 1]. Slower drives slip less.
+   * @param itimeout The longest to drive for.
+   * @param isettleTime How long to wait for the robot to stop before reading the sensors.
+   * @return Whether the drive measured the scale.
+   */
+  bool measureStraight(const std::function<QLength()> &idistanceToWall,
+                       const QLength &idistance = 48_in,
+                       double ispeed = 0.3,
+                       const QTime &itimeout = 10_s,
+                       const QTime &isettleTime = 500_ms);
+
+  /**
+   * Spins the robot in place and compares the turn the encoders count with the turn the heading
+   * sensor measures, to find the wheel track and the distance to the middle wheel. Call this after
+   * `measureStraight()`, because the wheel track is found in units of the straight scale.
+   *
+   * @param iheading The heading sensor, such as an IMU, in degrees which increase as the robot
+   * turns clockwise, like the heading of odometry.
+   * @param iturns The number of full turns to spin. More turns average out the error of the
+   * heading sensor.
+   * @param ispeed The speed to spin at, in [0, 1]. Slower spins scrub less.
+   * @param itimeout The longest to spin for.
+   * @param isettleTime How long to wait for the robot to stop before reading the sensors.
+   * @return Whether the spin measured the scales.
+   */
+  bool measureTurn(const std::shared_ptr<ContinuousRotarySensor> &iheading,
+                   int iturns = 5,
+                   double ispeed = 0.3,
+                   const QTime &itimeout = 20_s,
+                   const QTime &isettleTime = 500_ms);
+
+  /**
+   * @return The measured scales, with the initial scales for anything which wasn't measured.
+   */
+  ChassisScales getScales() const;
+
+  protected:
+  std::shared_ptr<Logger> logger;
+  std::shared_ptr<ChassisModel> model;
+  TimeUtil timeUtil;
+  double tpr;
+  double straight;
+  QLength wheelTrack;
+  QLength middleWheelDistance;
+  QLength middleWheelDiameter;
+
+  /**
+   * Drives until the maneuver is done or times out, then stops and lets the robot settle.
+   *
+   * @param idrive Starts the maneuver.
+   * @param idone Returns whether the maneuver is done.
+   * @return Whether the maneuver finished before the timeout.
+   */
+  bool runManeuver(const std::function<void()> &idrive,
+                   const std::function<bool()> &idone,
+                   const QTime &itimeout,
+                   const QTime &isettleTime);
+};
+} // namespace okapi
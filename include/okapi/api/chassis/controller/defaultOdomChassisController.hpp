@@ -56,6 +56,32 @@ class DefaultOdomChassisController : public OdomChassisController {
                     bool ibackwards = false,
                     const QLength &ioffset = 0_mm) override;
 
+  /**
+   * Drives the robot to a point in the odom frame along a curve, steering toward the point from the
+   * odometry state the whole way instead of turning to face it first. The robot turns in place
+   * while the point is beside or behind it. Any motion of the input ChassisController is stopped
+   * first.
+   *
+   * @param ipoint The target point to navigate to.
+   * @param ibackwards Whether to drive to the target point backwards.
+   * @param ioffset An offset from the target point in the direction pointing towards the robot. The
+   * robot will stop this far away from the target point.
+   */
+  void driveToPointCurved(const Point &ipoint,
+                          bool ibackwards = false,
+                          const QLength &ioffset = 0_mm) override;
+
+  /**
+   * Drives the robot through points in the odom frame without stopping at any but the last one.
+   * The robot steers toward a point a lookahead distance ahead of it along the lines between the
+   * points, so it only slows down for the last point. Any motion of the input ChassisController is
+   * stopped first.
+   *
+   * @param ipoints The points to drive through, in order.
+   * @param ibackwards Whether to drive through the points backwards.
+   */
+  void driveThrough(const std::vector<Point> &ipoints, bool ibackwards = false) override;
+
   /**
    * Turns the robot to face a point in the odom frame.
    *
@@ -139,6 +165,11 @@ class DefaultOdomChassisController : public OdomChassisController {
    */
   void waitUntilSettled() override;
 
+  /**
+   * This delegates to the input ChassisController.
+   */
+  MoveResult getLastMoveResult() const override;
+
   /**
    * This delegates to the input ChassisController.
    */
@@ -177,7 +208,28 @@ class DefaultOdomChassisController : public OdomChassisController {
   protected:
   std::shared_ptr<Logger> logger;
   std::shared_ptr<ChassisController> controller;
+  // Made once so curved moves do not allocate a rate
+  std::unique_ptr<AbstractRate> moveRate;
 
   void waitForOdomTask();
+
+  /**
+   * Commands one step of driving toward a point along a curve.
+   *
+   * @param itarget The point to drive toward, in `StateMode::FRAME_TRANSFORMATION`.
+   * @param ibackwards Whether to drive backwards.
+   * @param ioffset How far from the point to stop.
+   * @param ipathLeft How far the robot has to drive after the point. If zero, the robot slows down
+   * and stops at the point.
+   * @param isettings How to drive.
+   * @param imodel The model to command.
+   * @return Whether the robot reached the point, if it is the last one.
+   */
+  bool stepCurvedMotion(const Point &itarget,
+                        bool ibackwards,
+                        const QLength &ioffset,
+                        const QLength &ipathLeft,
+                        const CurvedMotionSettings &isettings,
+                        ChassisModel &imodel);
 };
 } // namespace okapi
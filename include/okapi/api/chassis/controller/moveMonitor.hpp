@@ -0,0 +1,71 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#pragma once
+
+#include "okapi/api/units/QTime.hpp"
+#include <optional>
+
+namespace okapi {
+/**
+ * How a chassis movement ended.
+ */
+enum class MoveResult {
+  settled,  ///< The controllers settled at the target.
+  stalled,  ///< The robot stopped moving before it reached the target.
+  timedOut  ///< The movement took longer than its timeout.
+};
+
+/**
+ * Watches a movement for a stall or a timeout. The robot is stalled once it has moved slower than
+ * the min speed, on average, for the stall time. Only check the monitor while the movement has not
+ * settled, because a robot holding its target is not moving either.
+ */
+class MoveMonitor {
+  public:
+  MoveMonitor() = default;
+
+  /**
+   * Sets how long a movement may take.
+   *
+   * @param itimeout The timeout, or zero for no timeout.
+   */
+  void setTimeout(QTime itimeout);
+
+  /**
+   * Sets when the robot counts as stalled.
+   *
+   * @param iminSpeed The min speed, in units of the position per second.
+   * @param istallTime How long the robot must move slower than the min speed. Zero turns stall
+   * detection off.
+   */
+  void setStallDetection(double iminSpeed, QTime istallTime);
+
+  /**
+   * Starts watching a new movement.
+   *
+   * @param inow The time the movement starts.
+   * @param iposition How far the robot has moved.
+   */
+  void start(QTime inow, double iposition);
+
+  /**
+   * @param inow The time now.
+   * @param iposition How far the robot has moved. Only changes in it matter.
+   * @return Why the movement should end, or nothing if it should keep going.
+   */
+  std::optional<MoveResult> check(QTime inow, double iposition);
+
+  protected:
+  QTime timeout{0_ms};
+  double minSpeed{0};
+  QTime stallTime{0_ms};
+
+  QTime startTime{0_ms};
+  // The robot counts as moving again once it gets far enough from here
+  QTime anchorTime{0_ms};
+  double anchorPosition{0};
+};
+} // namespace okapi
@@ -7,6 +7,7 @@
 
 #include "okapi/api/chassis/controller/chassisController.hpp"
 #include "okapi/api/chassis/model/skidSteerModel.hpp"
+#include "okapi/api/control/util/controlScheduler.hpp"
 #include "okapi/api/coreProsAPI.hpp"
 #include "okapi/api/odometry/odometry.hpp"
 #include "okapi/api/odometry/point.hpp"
@@ -17,13 +18,14 @@
 #include <atomic>
 #include <memory>
 #include <valarray>
+#include <vector>
 
 namespace okapi {
 class OdomChassisController : public ChassisController {
   public:
   /**
-   * Odometry based chassis controller. Starts task at the default for odometry when constructed,
-   * which calls `Odometry::step` every `10ms`. The default StateMode is
+   * Odometry based chassis controller. Its odometry task calls `Odometry::step` every
+   * `defaultOdomLoopPeriod` unless another period is set. The default StateMode is
    * `StateMode::FRAME_TRANSFORMATION`.
    *
    * Moves the robot around in the odom frame. Instead of telling the robot to drive forward or
@@ -62,6 +64,32 @@ class OdomChassisController : public ChassisController {
   virtual void
   driveToPoint(const Point &ipoint, bool ibackwards = false, const QLength &ioffset = 0_mm) = 0;
 
+  /**
+   * Drives the robot to a point in the odom frame along a curve, steering toward the point from the
+   * odometry state the whole way instead of turning to face it first. This takes one motion per
+   * point instead of settling after a turn and again after a drive. The motion is tuned with
+   * `setCurvedMotionSettings`.
+   *
+   * @param ipoint The target point to navigate to.
+   * @param ibackwards Whether to drive to the target point backwards.
+   * @param ioffset An offset from the target point in the direction pointing towards the robot. The
+   * robot will stop this far away from the target point.
+   */
+  virtual void driveToPointCurved(const Point &ipoint,
+                                  bool ibackwards = false,
+                                  const QLength &ioffset = 0_mm) = 0;
+
+  /**
+   * Drives the robot through points in the odom frame without stopping at any but the last one.
+   * The robot steers toward a point `CurvedMotionSettings::lookahead` ahead of it along the lines
+   * between the points, and moves on to the next point once the current one is within the
+   * lookahead. Only the last point is driven to and stopped at, like `driveToPointCurved`.
+   *
+   * @param ipoints The points to drive through, in order.
+   * @param ibackwards Whether to drive through the points backwards.
+   */
+  virtual void driveThrough(const std::vector<Point> &ipoints, bool ibackwards = false) = 0;
+
   /**
    * Turns the robot to face a point in the odom frame.
    *
@@ -122,10 +150,87 @@ class OdomChassisController : public ChassisController {
    */
   virtual QAngle getTurnThreshold() const;
 
+  /**
+   * How `driveToPointCurved` drives.
+   */
+  struct CurvedMotionSettings {
+    /**
+     * The forward speed, as a fraction of the max velocity, per meter left to drive.
+     */
+    double distanceGain{2};
+
+    /**
+     * The turning speed, as a fraction of the max velocity, per radian between the heading and the
+     * direction to the point.
+     */
+    double angleGain{1.5};
+
+    /**
+     * The motion is done when the robot is this close to the point.
+     */
+    QLength tolerance{1_in};
+
+    /**
+     * Closer than this to the point, the robot stops steering and drives straight until it reaches
+     * or passes the point, so it doesn't circle around a point it barely missed.
+     */
+    QLength straightDistance{6_in};
+
+    /**
+     * How far ahead of the robot `driveThrough` steers toward. A longer lookahead cuts the corners
+     * at the points more, and a shorter lookahead follows the lines between them more closely.
+     */
+    QLength lookahead{12_in};
+  };
+
+  /**
+   * Sets how `driveToPointCurved` drives. Throws a std::invalid_argument if a gain or distance is
+   * not positive.
+   *
+   * @param isettings The new settings.
+   */
+  virtual void setCurvedMotionSettings(const CurvedMotionSettings &isettings);
+
+  /**
+   * @return How `driveToPointCurved` drives.
+   */
+  virtual CurvedMotionSettings getCurvedMotionSettings() const;
+
+  /**
+   * The time between odometry steps by default.
+   */
+  static constexpr QTime defaultOdomLoopPeriod = 10_ms; // NOLINT
+
+  /**
+   * Sets the time between odometry steps. A shorter period keeps the odometry accurate at higher
+   * speeds if the sensors update faster than the default period. Call this before starting the
+   * odometry. Throws a std::invalid_argument if the period is shorter than `1_ms`.
+   *
+   * @param iperiod The time between odometry steps.
+   */
+  void setOdomLoopPeriod(const QTime &iperiod);
+
+  /**
+   * @return The time between odometry steps.
+   */
+  QTime getOdomLoopPeriod() const;
+
   /**
    * Starts the internal odometry thread. This should not be called by normal users.
+   *
+   * @param ipriority The priority of the task.
+   * @param istackDepth The stack depth of the task in words.
    */
-  void startOdomThread();
+  void startOdomThread(std::uint32_t ipriority = TASK_PRIORITY_DEFAULT,
+                       std::uint16_t istackDepth = TASK_STACK_DEPTH_DEFAULT);
+
+  /**
+   * Steps the odometry from a shared scheduler instead of starting an internal odometry thread.
+   * This should not be called by normal users, and not together with `startOdomThread`.
+   *
+   * @param ischeduler The scheduler to step the odometry from.
+   */
+  void startOdomScheduled(const std::shared_ptr<ControlScheduler> &ischeduler);
 
   /**
    * @return The underlying thread handle.
@@ -142,13 +247,25 @@ class OdomChassisController : public ChassisController {
   TimeUtil timeUtil;
   QLength moveThreshold;
   QAngle turnThreshold;
+  CurvedMotionSettings curvedMotionSettings{};
   std::shared_ptr<Odometry> odom;
   CrossplatformThread *odomTask{nullptr};
+  std::shared_ptr<ControlScheduler> scheduler{nullptr};
+  std::size_t schedulerLoopId{0};
   std::atomic_bool dtorCalled{false};
   StateMode defaultStateMode{StateMode::FRAME_TRANSFORMATION};
   std::atomic_bool odomTaskRunning{false};
+  // Set once the odometry has stepped, so its state is valid. odomReadyEvent is notified then.
+  std::atomic_bool odomReady{false};
+  CrossplatformEvent odomReadyEvent;
+  QTime odomLoopPeriod{defaultOdomLoopPeriod};
 
   static void trampoline(void *context);
   void loop();
+
+  /**
+   * Steps the odometry, and wakes up tasks waiting for it after the first step.
+   */
+  void stepOdom();
 };
 } // namespace okapi
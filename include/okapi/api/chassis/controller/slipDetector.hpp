@@ -0,0 +1,173 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#pragma once
+
+#include "okapi/api/chassis/controller/chassisScales.hpp"
+#include "okapi/api/chassis/model/skidSteerModel.hpp"
+#include "okapi/api/chassis/model/slewRateChassisModel.hpp"
+#include "okapi/api/coreProsAPI.hpp"
+#include "okapi/api/units/QSpeed.hpp"
+#include "okapi/api/units/QTime.hpp"
+#include "okapi/api/util/logging.hpp"
+#include "okapi/api/util/timeUtil.hpp"
+#include <atomic>
+#include <memory>
+
+namespace okapi {
+/**
+ * Detects the drive wheels slipping by comparing how fast the drive motors turn with how fast the
+ * tracking wheels roll. Tracking wheels aren't driven, so they follow the ground; when a side's
+ * motors turn faster or slower than its tracking wheel for a while, that side is spinning its
+ * wheels or skidding. Odometry reads the tracking wheels, so it keeps its position through the
+ * slip, but the robot isn't going where the drive is commanding it.
+ *
+ * A side is slipping once the filtered difference in speed is more than the slip speed, and stops
+ * slipping once it falls below half of it. While either side slips, an optional
+ * `SlewRateChassisModel` accelerates more gently, so the robot can be driven at the limit of its
+ * traction.
+ */
+class SlipDetector {
+  public:
+  /**
+   * The difference in speed at which a side is slipping, by default.
+   */
+  static constexpr QSpeed defaultSlipSpeed = 0.2_mps; // NOLINT
+
+  /**
+   * How much of the newest difference in speed is filtered in each step.
+   */
+  static constexpr double filterGain = 0.3;
+
+  /**
+   * Compares the drive motors of a model with its tracking wheels, such as the model of a chassis
+   * controller built with both motors and sensors. Call `startThread()` to step from a task, or
+   * call `step()` from your own loop.
+   *
+   * @param imodel The model. Its first two readings are the left and right tracking wheels.
+   * @param idriveScales The scales of the drive motors, like the chassis controller's.
+   * @param igearset The gearset and gear ratio of the drive motors, like the chassis controller's.
+   * @param itrackingScales The scales of the tracking wheels, like the odometry's.
+   * @param itimeUtil The time utility which supplies the time between steps and the rate of the
+   * task.
+   * @param islipSpeed The difference in speed at which a side is slipping.
+   * @param ilogger The logger this instance will log to.
+   */
+  SlipDetector(std::shared_ptr<SkidSteerModel> imodel,
+               const ChassisScales &idriveScales,
+               const AbstractMotor::GearsetRatioPair &igearset,
+               const ChassisScales &itrackingScales,
+               const TimeUtil &itimeUtil,
+               const QSpeed &islipSpeed = defaultSlipSpeed,
+               std::shared_ptr<Logger> ilogger = Logger::getDefaultLogger());
+
+  SlipDetector(const SlipDetector &) = delete;
+  SlipDetector &operator=(const SlipDetector &) = delete;
+
+  /**
+   * Stops the task.
+   */
+  virtual ~SlipDetector();
+
+  /**
+   * Compares the distance each side's motors and tracking wheel moved since the last step. This is
+   * called by the task; call it yourself, about every 10 ms, if you don't start the task.
+   */
+  void step();
+
+  /**
+   * @return Whether either side is slipping.
+   */
+  bool isSlipping() const;
+
+  /**
+   * @return Whether the left side is slipping.
+   */
+  bool isLeftSlipping() const;
+
+  /**
+   * @return Whether the right side is slipping.
+   */
+  bool isRightSlipping() const;
+
+  /**
+   * @return How much faster the left motors move the wheels than the left tracking wheel rolls,
+   * filtered. Negative while the wheels skid.
+   */
+  QSpeed getLeftSlip() const;
+
+  /**
+   * @return How much faster the right motors move the wheels than the right tracking wheel rolls,
+   * filtered. Negative while the wheels skid.
+   */
+  QSpeed getRightSlip() const;
+
+  /**
+   * @return The number of times the robot started slipping.
+   */
+  std::uint32_t getSlipCount() const;
+
+  /**
+   * Lowers the acceleration step of a model while either side slips, and puts it back once the
+   * slip is over. Wrap the chassis controller's model in the `SlewRateChassisModel` to use this.
+   *
+   * @param imodel The model to limit, or `nullptr` to stop limiting.
+   * @param islipAccelStep The acceleration step while slipping.
+   */
+  void limitAcceleration(std::shared_ptr<SlewRateChassisModel> imodel, double islipAccelStep);
+
+  /**
+   * Starts the task.
+   *
+   * @param ipriority The priority of the task.
+   * @param istackDepth The stack depth of the task in words.
+   */
+  void startThread(std::uint32_t ipriority = TASK_PRIORITY_DEFAULT,
+                   std::uint16_t istackDepth = TASK_STACK_DEPTH_DEFAULT);
+
+  /**
+   * @return The underlying thread handle.
+   */
+  CrossplatformThread *getThread() const;
+
+  protected:
+  std::shared_ptr<Logger> logger;
+  std::shared_ptr<SkidSteerModel> model;
+  double metersPerMotorUnit;
+  double metersPerTrackingTick;
+  TimeUtil timeUtil;
+  std::unique_ptr<AbstractTimer> timer;
+  double slipSpeed;
+
+  // Only used by the stepping task
+  bool hasLast{false};
+  double lastLeftMotor{0};
+  double lastRightMotor{0};
+  ReadOnlyChassisModel::SensorValues trackingTicks{}, lastTrackingTicks{};
+
+  std::atomic<double> leftSlip{0};
+  std::atomic<double> rightSlip{0};
+  std::atomic_bool leftSlipping{false};
+  std::atomic_bool rightSlipping{false};
+  std::atomic<std::uint32_t> slipCount{0};
+
+  // Guards the limited model, its steps, and changes to whether the robot is slipping
+  CrossplatformMutex limitMutex;
+  std::shared_ptr<SlewRateChassisModel> limitedModel{nullptr};
+  double slipAccelStep{1};
+  double normalAccelStep{1};
+
+  std::atomic_bool dtorCalled{false};
+  CrossplatformThread *task{nullptr};
+
+  static void trampoline(void *context);
+  void loop();
+
+  /**
+   * Updates whether a side slips from its filtered difference in speed, with hysteresis.
+   */
+  bool updateSlipping(std::atomic_bool &islipping, double islip) const;
+};
+} // namespace okapi
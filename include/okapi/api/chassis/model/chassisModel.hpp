@@ -6,13 +6,42 @@
 #pragma once
 
 #include "okapi/api/chassis/model/readOnlyChassisModel.hpp"
+#include "okapi/api/chassis/model/voltageCompensator.hpp"
 #include "okapi/api/device/motor/abstractMotor.hpp"
+#include <algorithm>
 #include <array>
+#include <cstdint>
 #include <initializer_list>
 #include <memory>
 #include <vector>
 
 namespace okapi {
+/**
+ * The outputs of every wheel of a chassis, applied together by ChassisModel::applyCommands(). The
+ * wheels are in the order of the model's motors: `{left, right}` for a SkidSteerModel,
+ * `{left, right, middle}` for an HDriveModel, and
+ * `{topLeft, topRight, bottomRight, bottomLeft}` for an XDriveModel. Outputs past the model's
+ * wheels are ignored.
+ */
+struct WheelCommands {
+  /**
+   * How the outputs are sent to the motors.
+   */
+  enum class outputMode {
+    velocity, ///< Outputs are scaled by the maximum velocity
+    voltage   ///< Outputs are scaled by the (compensated) maximum voltage
+  };
+
+  static constexpr std::size_t maxWheels = 4;
+
+  outputMode mode{outputMode::voltage};
+
+  /**
+   * The output of each wheel in the range `[-1, 1]`.
+   */
+  std::array<double, maxWheels> outputs{};
+};
+
 /**
  * A version of the ReadOnlyChassisModel that also supports write methods, such as setting motor
  * speed. Because this class can write to motors, there can only be one owner and as such copying
@@ -161,5 +190,61 @@ class ChassisModel : public ReadOnlyChassisModel {
    * @return The maximum voltage in mV `[0-12000]`.
    */
   virtual double getMaxVoltage() const = 0;
+
+  /**
+   * Sets the compensator which scales the maximum voltage of the voltage-mode methods by the
+   * battery voltage. Pass `nullptr` to stop compensating.
+   *
+   * @param icompensator The new compensator.
+   */
+  virtual void setVoltageCompensator(std::shared_ptr<VoltageCompensator> icompensator) = 0;
+
+  /**
+   * @return The compensator which scales the maximum voltage, or `nullptr` if there is none.
+   */
+  virtual std::shared_ptr<VoltageCompensator> getVoltageCompensator() const = 0;
+
+  /**
+   * Sets the output of every wheel at once. Every output is scaled before any motor is written,
+   * so the wheels are commanded as close together as possible.
+   *
+   * @param icommands The wheel outputs.
+   */
+  virtual void applyCommands(const WheelCommands &icommands) = 0;
+
+  protected:
+  /**
+   * Scales wheel outputs and writes them to the motors in one loop.
+   *
+   * @param icommands The wheel outputs.
+   * @param imotors The motors, in wheel order.
+   * @param imaxVelocity The velocity of a full velocity output.
+   * @param imaxVoltage The voltage of a full voltage output.
+   */
+  template <std::size_t wheels>
+  static void writeWheelCommands(const WheelCommands &icommands,
+                                 const std::array<AbstractMotor *, wheels> &imotors,
+                                 const double imaxVelocity,
+                                 const double imaxVoltage) {
+    static_assert(wheels <= WheelCommands::maxWheels, "Too many wheels for WheelCommands.");
+
+    const bool isVelocity = icommands.mode == WheelCommands::outputMode::velocity;
+    const double scale = isVelocity ? imaxVelocity : imaxVoltage;
+
+    std::array<std::int16_t, wheels> outputs;
+    for (std::size_t i = 0; i < wheels; i++) {
+      outputs[i] = static_cast<std::int16_t>(std::clamp(icommands.outputs[i], -1.0, 1.0) * scale);
+    }
+
+    if (isVelocity) {
+      for (std::size_t i = 0; i < wheels; i++) {
+        imotors[i]->moveVelocity(outputs[i]);
+      }
+    } else {
+      for (std::size_t i = 0; i < wheels; i++) {
+        imotors[i]->moveVoltage(outputs[i]);
+      }
+    }
+  }
 };
 } // namespace okapi
@@ -155,6 +155,13 @@ class HDriveModel : public ChassisModel {
    */
   virtual void middle(double ispeed);
 
+  /**
+   * Power the middle motors. Uses voltage mode.
+   *
+   * @param ivoltage The motor power [-1, 1].
+   */
+  virtual void middleVoltage(double ivoltage);
+
   /**
    * Read the sensors.
    *
@@ -162,6 +169,23 @@ class HDriveModel : public ChassisModel {
    */
   std::valarray<std::int32_t> getSensorVals() const override;
 
+  /**
+   * Read the sensors into a buffer without allocating.
+   *
+   * @param ovalues The buffer to write the readings to, in the format {left, right, middle}.
+   * @return The number of readings written.
+   */
+  std::size_t getSensorVals(SensorValues &ovalues) const override;
+
+  /**
+   * Read the sensors and the times they were measured into buffers without allocating.
+   *
+   * @param ovalues The buffer to write the readings to, in the format {left, right, middle}.
+   * @param otimestamps The buffer to write the times the readings were measured to.
+   * @return The number of readings written.
+   */
+  std::size_t getSensorSamples(SensorValues &ovalues, SensorTimestamps &otimestamps) const override;
+
   /**
    * Reset the sensors to their zero point.
    */
@@ -215,6 +239,26 @@ class HDriveModel : public ChassisModel {
    */
   double getMaxVoltage() const override;
 
+  /**
+   * Sets the compensator which scales the maximum voltage of the voltage-mode methods by the
+   * battery voltage. Pass `nullptr` to stop compensating.
+   *
+   * @param icompensator The new compensator.
+   */
+  void setVoltageCompensator(std::shared_ptr<VoltageCompensator> icompensator) override;
+
+  /**
+   * @return The compensator which scales the maximum voltage, or `nullptr` if there is none.
+   */
+  std::shared_ptr<VoltageCompensator> getVoltageCompensator() const override;
+
+  /**
+   * Sets the output of every wheel at once, in the order `{left, right, middle}`.
+   *
+   * @param icommands The wheel outputs.
+   */
+  void applyCommands(const WheelCommands &icommands) override;
+
   /**
    * Returns the left side motor.
    *
@@ -237,11 +281,17 @@ class HDriveModel : public ChassisModel {
   protected:
   double maxVelocity;
   double maxVoltage;
+  std::shared_ptr<VoltageCompensator> voltageCompensator;
   std::shared_ptr<AbstractMotor> leftSideMotor;
   std::shared_ptr<AbstractMotor> rightSideMotor;
   std::shared_ptr<AbstractMotor> middleMotor;
   std::shared_ptr<ContinuousRotarySensor> leftSensor;
   std::shared_ptr<ContinuousRotarySensor> rightSensor;
   std::shared_ptr<ContinuousRotarySensor> middleSensor;
+
+  /**
+   * @return The maximum voltage scaled by the voltage compensator, if there is one.
+   */
+  double getCompensatedMaxVoltage() const;
 };
 } // namespace okapi
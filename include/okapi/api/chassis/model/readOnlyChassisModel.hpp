@@ -6,6 +6,8 @@
 #pragma once
 
 #include "okapi/api/coreProsAPI.hpp"
+#include <algorithm>
+#include <array>
 #include <valarray>
 
 namespace okapi {
@@ -16,6 +18,21 @@ namespace okapi {
  */
 class ReadOnlyChassisModel {
   public:
+  /**
+   * The most sensor readings a model returns.
+   */
+  static constexpr std::size_t maxSensorCount = 4;
+
+  /**
+   * A fixed size buffer for sensor readings.
+   */
+  using SensorValues = std::array<std::int32_t, maxSensorCount>;
+
+  /**
+   * A fixed size buffer for the times sensor readings were measured, in milliseconds.
+   */
+  using SensorTimestamps = std::array<std::uint32_t, maxSensorCount>;
+
   virtual ~ReadOnlyChassisModel() = default;
 
   /**
@@ -24,5 +41,36 @@ class ReadOnlyChassisModel {
    * @return sensor readings (format is implementation dependent)
    */
   virtual std::valarray<std::int32_t> getSensorVals() const = 0;
+
+  /**
+   * Read the sensors into a buffer without allocating. The readings are in the same format as
+   * `getSensorVals()`. Models should override this; the default implementation copies the result
+   * of `getSensorVals()`. A subclass of a model which overrides one of the ways to read the
+   * sensors must override all of them, including `getSensorSamples()`.
+   *
+   * @param ovalues The buffer to write the readings to.
+   * @return The number of readings written.
+   */
+  virtual std::size_t getSensorVals(SensorValues &ovalues) const {
+    const auto values = getSensorVals();
+    const std::size_t count = std::min(values.size(), ovalues.size());
+    std::copy(std::begin(values), std::begin(values) + count, ovalues.begin());
+    return count;
+  }
+
+  /**
+   * Read the sensors together with the time each reading was measured by its device, without
+   * allocating. The readings are in the same format as `getSensorVals()`. Sensors which don't
+   * report when they were measured have a timestamp of zero. The default implementation calls
+   * `getSensorVals(SensorValues &)` and sets every timestamp to zero.
+   *
+   * @param ovalues The buffer to write the readings to.
+   * @param otimestamps The buffer to write the times the readings were measured to.
+   * @return The number of readings written.
+   */
+  virtual std::size_t getSensorSamples(SensorValues &ovalues, SensorTimestamps &otimestamps) const {
+    otimestamps.fill(0);
+    return getSensorVals(ovalues);
+  }
 };
 } // namespace okapi
@@ -12,6 +12,60 @@
 namespace okapi {
 class SkidSteerModel : public ChassisModel {
   public:
+  /**
+   * Tuning for `cheesyDrive()`. The defaults suit most drives.
+   */
+  struct CheesyDriveConfig {
+    /**
+     * How much the turn stick is bent so small inputs turn gently, in the range (0, 1]. Higher
+     * values bend it more.
+     */
+    double wheelNonLinearity{0.5};
+
+    /**
+     * How much of the change in the turn stick is added back while turning in, so the robot
+     * starts turning sooner.
+     */
+    double negInertiaTurnScalar{2.5};
+
+    /**
+     * How much of the change in the turn stick is added back while turning out of a sharp turn, so
+     * the robot stops turning sooner.
+     */
+    double negInertiaCloseScalar{5};
+
+    /**
+     * How much of the change in the turn stick is added back while turning out of a gentle turn.
+     */
+    double negInertiaFarScalar{3};
+
+    /**
+     * The turn stick magnitude above which a turn counts as sharp.
+     */
+    double negInertiaThreshold{0.65};
+
+    /**
+     * How sharply the robot turns for a given turn stick and throttle outside of quick turn.
+     */
+    double sensitivity{0.65};
+
+    /**
+     * The throttle below which a quick turn builds up the quick stop, which is spent after the
+     * quick turn to stop the robot from spinning on.
+     */
+    double quickStopDeadband{0.5};
+
+    /**
+     * How fast the quick stop follows the turn stick, in the range (0, 1].
+     */
+    double quickStopWeight{0.1};
+
+    /**
+     * How strong the quick stop is.
+     */
+    double quickStopScalar{5};
+  };
+
   /**
    * Model for a skid steer drive (wheels parallel with robot's direction of motion). When all
    * motors are powered +100%, the robot should move forward in a straight line.
@@ -99,6 +153,39 @@ class SkidSteerModel : public ChassisModel {
    */
   void curvature(double iforwardSpeed, double icurvature, double ithreshold = 0) override;
 
+  /**
+   * Drive the robot with a curvature drive which keeps state between calls (Team 254's "Cheesy
+   * Drive"). The turn stick sets the curvature of the robot's path, so turning feels the same at
+   * any speed. Quick turn turns in place instead, for when the robot is slow or stopped. Changes
+   * of the turn stick are exaggerated so the robot responds sooner, and a quick turn leaves behind
+   * a correction which stops the robot from spinning on once it is released. Call this once per
+   * loop iteration. Does not allocate. Uses voltage mode.
+   *
+   * @param ithrottle speed in the forward direction
+   * @param iwheel turn stick, positive turns clockwise
+   * @param iquickTurn whether to turn in place
+   * @param ithreshold deadband on joystick values
+   */
+  void cheesyDrive(double ithrottle, double iwheel, bool iquickTurn, double ithreshold = 0);
+
+  /**
+   * Sets the tuning of `cheesyDrive()`.
+   *
+   * @param iconfig The new tuning.
+   */
+  void setCheesyDriveConfig(const CheesyDriveConfig &iconfig);
+
+  /**
+   * @return The tuning of `cheesyDrive()`.
+   */
+  CheesyDriveConfig getCheesyDriveConfig() const;
+
+  /**
+   * Clears the state `cheesyDrive()` keeps between calls. Call this before driving if the robot was
+   * driven by other means in between.
+   */
+  void resetCheesyDrive();
+
   /**
    * Power the left side motors. Uses velocity mode.
    *
@@ -120,6 +207,23 @@ class SkidSteerModel : public ChassisModel {
    */
   std::valarray<std::int32_t> getSensorVals() const override;
 
+  /**
+   * Read the sensors into a buffer without allocating.
+   *
+   * @param ovalues The buffer to write the readings to, in the format {left, right}.
+   * @return The number of readings written.
+   */
+  std::size_t getSensorVals(SensorValues &ovalues) const override;
+
+  /**
+   * Read the sensors and the times they were measured into buffers without allocating.
+   *
+   * @param ovalues The buffer to write the readings to, in the format {left, right}.
+   * @param otimestamps The buffer to write the times the readings were measured to.
+   * @return The number of readings written.
+   */
+  std::size_t getSensorSamples(SensorValues &ovalues, SensorTimestamps &otimestamps) const override;
+
   /**
    * Reset the sensors to their zero point.
    */
@@ -173,6 +277,26 @@ class SkidSteerModel : public ChassisModel {
    */
   double getMaxVoltage() const override;
 
+  /**
+   * Sets the compensator which scales the maximum voltage of the voltage-mode methods by the
+   * battery voltage. Pass `nullptr` to stop compensating.
+   *
+   * @param icompensator The new compensator.
+   */
+  void setVoltageCompensator(std::shared_ptr<VoltageCompensator> icompensator) override;
+
+  /**
+   * @return The compensator which scales the maximum voltage, or `nullptr` if there is none.
+   */
+  std::shared_ptr<VoltageCompensator> getVoltageCompensator() const override;
+
+  /**
+   * Sets the output of every wheel at once, in the order `{left, right}`.
+   *
+   * @param icommands The wheel outputs.
+   */
+  void applyCommands(const WheelCommands &icommands) override;
+
   /**
    * Returns the left side motor.
    *
@@ -190,9 +314,19 @@ class SkidSteerModel : public ChassisModel {
   protected:
   double maxVelocity;
   double maxVoltage;
+  std::shared_ptr<VoltageCompensator> voltageCompensator;
   std::shared_ptr<AbstractMotor> leftSideMotor;
   std::shared_ptr<AbstractMotor> rightSideMotor;
   std::shared_ptr<ContinuousRotarySensor> leftSensor;
   std::shared_ptr<ContinuousRotarySensor> rightSensor;
+  CheesyDriveConfig cheesyConfig{};
+  double cheesyOldWheel{0};
+  double cheesyNegInertiaAccumulator{0};
+  double cheesyQuickStopAccumulator{0};
+
+  /**
+   * @return The maximum voltage scaled by the voltage compensator, if there is one.
+   */
+  double getCompensatedMaxVoltage() const;
 };
 } // namespace okapi
@@ -0,0 +1,210 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#pragma once
+
+#include "okapi/api/chassis/model/chassisModel.hpp"
+#include "okapi/api/util/logging.hpp"
+#include <array>
+#include <atomic>
+#include <memory>
+
+namespace okapi {
+class SlewRateChassisModel : public ChassisModel {
+  public:
+  /**
+   * Limits how fast the output of each side of another ChassisModel can change, so sudden
+   * reversals don't trip the motors' current limits or brown out the robot. Each call to a drive
+   * method is one tick: the output of each side moves toward what was asked for by at most one
+   * step, so call them once per loop iteration. A side speeding up moves by the acceleration step
+   * and a side slowing down or reversing moves by the deceleration step, stopping at zero before it
+   * reverses. The mixing of `arcade`, `curvature`, and the drive vectors is the same as
+   * SkidSteerModel's. `applyCommands` limits each wheel instead of each side. `stop` is not
+   * limited.
+   *
+   * Throws a `std::invalid_argument` if the model is null or either step is not positive.
+   *
+   * @param imodel The model to send the limited outputs to.
+   * @param iaccelStep The largest change per tick of a side speeding up, as a fraction of the full
+   * output.
+   * @param idecelStep The largest change per tick of a side slowing down, as a fraction of the full
+   * output.
+   * @param ilogger The logger this instance will log to.
+   */
+  SlewRateChassisModel(std::shared_ptr<ChassisModel> imodel,
+                       double iaccelStep,
+                       double idecelStep,
+                       const std::shared_ptr<Logger> &ilogger = Logger::getDefaultLogger());
+
+  /**
+   * Limits how fast the output of each side of another ChassisModel can change, by the same step
+   * whether a side is speeding up or slowing down.
+   *
+   * @param imodel The model to send the limited outputs to.
+   * @param istep The largest change per tick of a side, as a fraction of the full output.
+   * @param ilogger The logger this instance will log to.
+   */
+  SlewRateChassisModel(std::shared_ptr<ChassisModel> imodel,
+                       double istep,
+                       const std::shared_ptr<Logger> &ilogger = Logger::getDefaultLogger());
+
+  /**
+   * Drive the robot forwards (using open-loop control). Uses velocity mode.
+   *
+   * @param ispeed motor power
+   */
+  void forward(double ispeed) override;
+
+  /**
+   * Drive the robot in an arc (using open-loop control). Uses velocity mode.
+   *
+   * @param iforwardSpeed speed in the forward direction
+   * @param iyaw speed around the vertical axis
+   */
+  void driveVector(double iforwardSpeed, double iyaw) override;
+
+  /**
+   * Drive the robot in an arc. Uses voltage mode.
+   *
+   * @param iforwardSpeed speed in the forward direction
+   * @param iyaw speed around the vertical axis
+   */
+  void driveVectorVoltage(double iforwardSpeed, double iyaw) override;
+
+  /**
+   * Turn the robot clockwise (using open-loop control). Uses velocity mode.
+   *
+   * @param ispeed motor power
+   */
+  void rotate(double ispeed) override;
+
+  /**
+   * Stop the robot at once and forget the limited outputs.
+   */
+  void stop() override;
+
+  /**
+   * Drive the robot with a tank drive layout. Uses voltage mode.
+   *
+   * @param ileftSpeed left side speed
+   * @param irightSpeed right side speed
+   * @param ithreshold deadband on joystick values
+   */
+  void tank(double ileftSpeed, double irightSpeed, double ithreshold = 0) override;
+
+  /**
+   * Drive the robot with an arcade drive layout. Uses voltage mode.
+   *
+   * @param iforwardSpeed speed in the forward direction
+   * @param iyaw speed around the vertical axis
+   * @param ithreshold deadband on joystick values
+   */
+  void arcade(double iforwardSpeed, double iyaw, double ithreshold = 0) override;
+
+  /**
+   * Drive the robot with a curvature drive layout. Uses voltage mode.
+   *
+   * @param iforwardSpeed speed in the forward direction
+   * @param icurvature curvature (inverse of radius) to drive in
+   * @param ithreshold deadband on joystick values
+   */
+  void curvature(double iforwardSpeed, double icurvature, double ithreshold = 0) override;
+
+  /**
+   * Power the left side motors. Uses velocity mode.
+   *
+   * @param ispeed The motor power.
+   */
+  void left(double ispeed) override;
+
+  /**
+   * Power the right side motors. Uses velocity mode.
+   *
+   * @param ispeed The motor power.
+   */
+  void right(double ispeed) override;
+
+  /**
+   * Sets the output of every wheel at once, limiting each wheel by itself.
+   *
+   * @param icommands The wheel outputs.
+   */
+  void applyCommands(const WheelCommands &icommands) override;
+
+  /**
+   * Read the sensors of the model.
+   *
+   * @return sensor readings in the format of the model
+   */
+  std::valarray<std::int32_t> getSensorVals() const override;
+
+  std::size_t getSensorVals(SensorValues &ovalues) const override;
+
+  std::size_t getSensorSamples(SensorValues &ovalues, SensorTimestamps &otimestamps) const override;
+
+  void resetSensors() override;
+
+  void setBrakeMode(AbstractMotor::brakeMode mode) override;
+
+  void setEncoderUnits(AbstractMotor::encoderUnits units) override;
+
+  void setGearing(AbstractMotor::gearset gearset) override;
+
+  void setMaxVelocity(double imaxVelocity) override;
+
+  double getMaxVelocity() const override;
+
+  void setMaxVoltage(double imaxVoltage) override;
+
+  double getMaxVoltage() const override;
+
+  void setVoltageCompensator(std::shared_ptr<VoltageCompensator> icompensator) override;
+
+  std::shared_ptr<VoltageCompensator> getVoltageCompensator() const override;
+
+  /**
+   * Sets the largest change per tick of a side speeding up. This can be called from another task,
+   * such as to accelerate more gently while the wheels slip.
+   *
+   * Throws a `std::invalid_argument` if the step is not positive.
+   *
+   * @param iaccelStep The largest change per tick, as a fraction of the full output.
+   */
+  void setAccelStep(double iaccelStep);
+
+  /**
+   * @return The largest change per tick of a side speeding up.
+   */
+  double getAccelStep() const;
+
+  /**
+   * @return The model the limited outputs are sent to.
+   */
+  std::shared_ptr<ChassisModel> getModel() const;
+
+  protected:
+  std::shared_ptr<Logger> logger;
+  std::shared_ptr<ChassisModel> model;
+  std::atomic<double> accelStep;
+  double decelStep;
+  double leftOutput{0};
+  double rightOutput{0};
+  std::array<double, WheelCommands::maxWheels> wheelOutputs{};
+
+  /**
+   * Moves an output toward its target by at most one step.
+   *
+   * @param ioutput The output now.
+   * @param itarget The output which was asked for.
+   * @return The new output.
+   */
+  double step(double ioutput, double itarget) const;
+
+  /**
+   * Limits both sides toward their targets.
+   */
+  void stepSides(double ileftTarget, double irightTarget);
+};
+} // namespace okapi
@@ -6,6 +6,7 @@
 #pragma once
 
 #include "okapi/api/chassis/model/skidSteerModel.hpp"
+#include "okapi/api/device/rotarysensor/rotarySensorGroup.hpp"
 
 namespace okapi {
 class ThreeEncoderSkidSteerModel : public SkidSteerModel {
@@ -28,6 +29,17 @@ class ThreeEncoderSkidSteerModel : public SkidSteerModel {
                              double imaxVelocity,
                              double imaxVoltage);
 
+  /**
+   * Reads the sensors through a group instead of one at a time, so the three readings are taken
+   * back to back. The group is only used to read the sensors; they are still reset one at a time.
+   *
+   * Throws a `std::invalid_argument` if the group does not have exactly three sensors.
+   *
+   * @param igroup The left, right, and middle sensors in that order, or `nullptr` to read them one
+   * at a time.
+   */
+  void setSensorGroup(std::shared_ptr<RotarySensorGroup> igroup);
+
   /**
    * Read the sensors.
    *
@@ -35,6 +47,23 @@ class ThreeEncoderSkidSteerModel : public SkidSteerModel {
    */
   std::valarray<std::int32_t> getSensorVals() const override;
 
+  /**
+   * Read the sensors into a buffer without allocating.
+   *
+   * @param ovalues The buffer to write the readings to, in the format {left, right, middle}.
+   * @return The number of readings written.
+   */
+  std::size_t getSensorVals(SensorValues &ovalues) const override;
+
+  /**
+   * Read the sensors and the times they were measured into buffers without allocating.
+   *
+   * @param ovalues The buffer to write the readings to, in the format {left, right, middle}.
+   * @param otimestamps The buffer to write the times the readings were measured to.
+   * @return The number of readings written.
+   */
+  std::size_t getSensorSamples(SensorValues &ovalues, SensorTimestamps &otimestamps) const override;
+
   /**
    * Reset the sensors to their zero point.
    */
@@ -42,5 +71,6 @@ class ThreeEncoderSkidSteerModel : public SkidSteerModel {
 
   protected:
   std::shared_ptr<ContinuousRotarySensor> middleSensor;
+  std::shared_ptr<RotarySensorGroup> sensorGroup{nullptr};
 };
 } // namespace okapi
@@ -39,6 +39,23 @@ class ThreeEncoderXDriveModel : public XDriveModel {
    */
   std::valarray<std::int32_t> getSensorVals() const override;
 
+  /**
+   * Read the sensors into a buffer without allocating.
+   *
+   * @param ovalues The buffer to write the readings to, in the format {left, right, middle}.
+   * @return The number of readings written.
+   */
+  std::size_t getSensorVals(SensorValues &ovalues) const override;
+
+  /**
+   * Read the sensors and the times they were measured into buffers without allocating.
+   *
+   * @param ovalues The buffer to write the readings to, in the format {left, right, middle}.
+   * @param otimestamps The buffer to write the times the readings were measured to.
+   * @return The number of readings written.
+   */
+  std::size_t getSensorSamples(SensorValues &ovalues, SensorTimestamps &otimestamps) const override;
+
   /**
    * Reset the sensors to their zero point.
    */
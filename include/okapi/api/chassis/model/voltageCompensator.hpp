@@ -0,0 +1,107 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#pragma once
+
+#include "okapi/api/control/controllerInput.hpp"
+#include "okapi/api/coreProsAPI.hpp"
+#include "okapi/api/units/QTime.hpp"
+#include "okapi/api/util/abstractTimer.hpp"
+#include "okapi/api/util/logging.hpp"
+#include <memory>
+
+namespace okapi {
+/**
+ * Scales voltage commands by the ratio of a nominal battery voltage to the actual battery voltage,
+ * so a voltage-mode output does the same thing on a full battery as on a sagging one. Gains tuned
+ * on one battery keep working as it drains during a match.
+ *
+ * The battery is read at most once per read period and cached, so the compensator can be used
+ * from a fast control loop. Readings which are `PROS_ERR`, not finite, or not positive are ignored
+ * and the last good reading is kept.
+ */
+class VoltageCompensator {
+  public:
+  /**
+   * The battery voltage that voltage commands are scaled to, by default, in mV.
+   */
+  static constexpr double defaultNominalVoltage = 12000;
+
+  /**
+   * The largest scale applied to a voltage command, by default.
+   */
+  static constexpr double defaultMaxScale = 1.5;
+
+  /**
+   * The time between battery readings, by default.
+   */
+  static constexpr QTime defaultReadPeriod = 100_ms; // NOLINT
+
+  /**
+   * Scales voltage commands by the ratio of a nominal battery voltage to the actual battery
+   * voltage.
+   *
+   * @param ibattery The battery voltage in mV, like the Battery.
+   * @param itimer The timer which keeps the time between battery readings.
+   * @param inominalVoltage The battery voltage in mV at which voltage commands are not scaled.
+   * This is usually the voltage the robot was tuned at.
+   * @param imaxScale The largest scale applied to a voltage command, so a bad battery reading
+   * can't make the robot jump. Must be at least `1`.
+   * @param ireadPeriod The time between battery readings.
+   * @param ilogger The logger this instance will log to.
+   */
+  VoltageCompensator(std::shared_ptr<ControllerInput<double>> ibattery,
+                     std::unique_ptr<AbstractTimer> itimer,
+                     double inominalVoltage = defaultNominalVoltage,
+                     double imaxScale = defaultMaxScale,
+                     const QTime &ireadPeriod = defaultReadPeriod,
+                     const std::shared_ptr<Logger> &ilogger = Logger::getDefaultLogger());
+
+  /**
+   * Scales a maximum voltage by the ratio of the nominal voltage to the battery voltage, reading
+   * the battery if the read period has passed. The result is capped at `v5MotorMaxVoltage`
+   * because the motors can't be commanded past it.
+   *
+   * @param imaxVoltage The maximum voltage in mV.
+   * @return The scaled maximum voltage in mV.
+   */
+  double compensate(double imaxVoltage);
+
+  /**
+   * Returns the scale applied to voltage commands, reading the battery if the read period has
+   * passed. The scale is `1` until the first good battery reading.
+   *
+   * @return The scale applied to voltage commands.
+   */
+  double getScale();
+
+  /**
+   * @return The last good battery reading in mV, or the nominal voltage before the first one.
+   */
+  double getBatteryVoltage() const;
+
+  /**
+   * @return The battery voltage in mV at which voltage commands are not scaled.
+   */
+  double getNominalVoltage() const;
+
+  protected:
+  std::shared_ptr<Logger> logger;
+  std::shared_ptr<ControllerInput<double>> battery;
+  std::unique_ptr<AbstractTimer> timer;
+  double nominalVoltage;
+  double maxScale;
+  QTime readPeriod;
+  double batteryVoltage;
+  double scale{1};
+  bool hasRead{false};
+  mutable CrossplatformMutex mutex;
+
+  /**
+   * Reads the battery if it has not been read within the read period. Call with the mutex held.
+   */
+  void update();
+};
+} // namespace okapi
@@ -158,6 +158,46 @@ class XDriveModel : public ChassisModel {
                                     QAngle iangle,
                                     double ithreshold = 0);
 
+  /**
+   * Drive the robot with a field-oriented arcade drive layout, using the heading from the last
+   * call to `updateHeading()`. Driving and autonomous corrections can share one heading this way
+   * instead of each reading the sensor and working out its sine and cosine. Uses voltage mode.
+   *
+   * @param ixSpeed forward speed -- (`+1`) forward, (`-1`) backward
+   * @param iySpeed sideways speed -- (`+1`) right, (`-1`) left
+   * @param iyaw turn speed -- (`+1`) clockwise, (`-1`) counter-clockwise
+   * @param ithreshold deadband on joystick values
+   */
+  virtual void
+  fieldOrientedXArcade(double ixSpeed, double iySpeed, double iyaw, double ithreshold = 0);
+
+  /**
+   * Sets the sensor `updateHeading()` reads the heading from, such as an IMU.
+   *
+   * @param isensor The heading sensor. Must read the heading in degrees, increasing clockwise.
+   * Pass `nullptr` to remove it.
+   */
+  void setHeadingSensor(std::shared_ptr<ContinuousRotarySensor> isensor);
+
+  /**
+   * Reads the heading sensor and caches the heading for field-oriented driving. Call this once per
+   * loop iteration. Does nothing if there is no heading sensor.
+   */
+  void updateHeading();
+
+  /**
+   * Caches the heading for field-oriented driving, such as one from odometry. Call this once per
+   * loop iteration.
+   *
+   * @param iheading The heading of the chassis, winding clockwise.
+   */
+  void updateHeading(QAngle iheading);
+
+  /**
+   * @return The heading cached by the last call to `updateHeading()`.
+   */
+  QAngle getHeading() const;
+
   /**
    * Power the left side motors. Uses velocity mode.
    *
@@ -179,6 +219,23 @@ class XDriveModel : public ChassisModel {
    */
   std::valarray<std::int32_t> getSensorVals() const override;
 
+  /**
+   * Read the sensors into a buffer without allocating.
+   *
+   * @param ovalues The buffer to write the readings to, in the format {left, right}.
+   * @return The number of readings written.
+   */
+  std::size_t getSensorVals(SensorValues &ovalues) const override;
+
+  /**
+   * Read the sensors and the times they were measured into buffers without allocating.
+   *
+   * @param ovalues The buffer to write the readings to, in the format {left, right}.
+   * @param otimestamps The buffer to write the times the readings were measured to.
+   * @return The number of readings written.
+   */
+  std::size_t getSensorSamples(SensorValues &ovalues, SensorTimestamps &otimestamps) const override;
+
   /**
    * Reset the sensors to their zero point.
    */
@@ -232,6 +289,27 @@ class XDriveModel : public ChassisModel {
    */
   double getMaxVoltage() const override;
 
+  /**
+   * Sets the compensator which scales the maximum voltage of the voltage-mode methods by the
+   * battery voltage. Pass `nullptr` to stop compensating.
+   *
+   * @param icompensator The new compensator.
+   */
+  void setVoltageCompensator(std::shared_ptr<VoltageCompensator> icompensator) override;
+
+  /**
+   * @return The compensator which scales the maximum voltage, or `nullptr` if there is none.
+   */
+  std::shared_ptr<VoltageCompensator> getVoltageCompensator() const override;
+
+  /**
+   * Sets the output of every wheel at once, in the order
+   * `{topLeft, topRight, bottomRight, bottomLeft}`.
+   *
+   * @param icommands The wheel outputs.
+   */
+  void applyCommands(const WheelCommands &icommands) override;
+
   /**
    * Returns the top left motor.
    *
@@ -263,11 +341,31 @@ class XDriveModel : public ChassisModel {
   protected:
   double maxVelocity;
   double maxVoltage;
+  std::shared_ptr<VoltageCompensator> voltageCompensator;
   std::shared_ptr<AbstractMotor> topLeftMotor;
   std::shared_ptr<AbstractMotor> topRightMotor;
   std::shared_ptr<AbstractMotor> bottomRightMotor;
   std::shared_ptr<AbstractMotor> bottomLeftMotor;
   std::shared_ptr<ContinuousRotarySensor> leftSensor;
   std::shared_ptr<ContinuousRotarySensor> rightSensor;
+  std::shared_ptr<ContinuousRotarySensor> headingSensor{nullptr};
+  QAngle heading{0_deg};
+  double headingCos{1};
+  double headingSin{0};
+
+  /**
+   * @return The maximum voltage scaled by the voltage compensator, if there is one.
+   */
+  double getCompensatedMaxVoltage() const;
+
+  /**
+   * Drives with a field-oriented arcade drive layout, given the cosine and sine of the heading.
+   */
+  void fieldOrientedXArcade(double ixSpeed,
+                            double iySpeed,
+                            double iyaw,
+                            double iheadingCos,
+                            double iheadingSin,
+                            double ithreshold);
 };
 } // namespace okapi
@@ -6,6 +6,7 @@
 #pragma once
 
 #include "okapi/api/control/closedLoopController.hpp"
+#include <cstdint>
 
 namespace okapi {
 /**
@@ -20,5 +21,13 @@ class AsyncController : public ClosedLoopController<Input, Output> {
    * implementation-dependent.
    */
   virtual void waitUntilSettled() = 0;
+
+  protected:
+  /**
+   * The longest time in milliseconds a controller which notifies waiting tasks when it settles
+   * waits between checks of whether it has settled. This is a fallback; waiting tasks are normally
+   * woken up by the notification.
+   */
+  static constexpr std::uint32_t settledWaitTimeout = 100;
 };
 } // namespace okapi
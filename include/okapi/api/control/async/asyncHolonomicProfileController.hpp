@@ -0,0 +1,327 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#pragma once
+
+#include "okapi/api/chassis/controller/chassisScales.hpp"
+#include "okapi/api/chassis/model/xDriveModel.hpp"
+#include "okapi/api/control/async/asyncPositionController.hpp"
+#include "okapi/api/control/util/pathfinderUtil.hpp"
+#include "okapi/api/control/util/trapezoidProfile.hpp"
+#include "okapi/api/device/motor/abstractMotor.hpp"
+#include "okapi/api/units/QAngularSpeed.hpp"
+#include "okapi/api/units/QSpeed.hpp"
+#include "okapi/api/util/logging.hpp"
+#include "okapi/api/util/timeUtil.hpp"
+#include <array>
+#include <atomic>
+#include <map>
+#include <vector>
+
+namespace okapi {
+class AsyncHolonomicProfileController
+  : public AsyncPositionController<std::string, PathfinderPoint> {
+  public:
+  /**
+   * The velocity of the robot, in the frame of the robot.
+   */
+  struct ChassisVelocity {
+    QSpeed forward;
+    QSpeed right;
+    QAngularSpeed yaw; // Clockwise
+  };
+
+  /**
+   * An Async Controller which generates and follows holonomic motion profiles on an x-drive. The
+   * robot translates and rotates at the same time, so it reaches a pose in one movement instead of
+   * turning, driving, and turning again. Each leg between two waypoints is a trapezoidal profile
+   * along a straight line, with the rotation spread evenly along it. The robot stops at each
+   * waypoint. The profiles are followed open-loop, so they assume the robot keeps the heading the
+   * profile planned.
+   *
+   * @param itimeUtil The TimeUtil.
+   * @param ilimits The default limits. The limits are for the wheels, so the robot moves slower
+   * when it also rotates.
+   * @param imodel The x-drive to write wheel velocities to.
+   * @param iscales The ChassisScales. The wheel track is the distance between two diagonally
+   * opposite wheels.
+   * @param ipair The gearset.
+   * @param ilogger The logger this instance will log to.
+   */
+  AsyncHolonomicProfileController(
+    const TimeUtil &itimeUtil,
+    const PathfinderLimits &ilimits,
+    const std::shared_ptr<XDriveModel> &imodel,
+    const ChassisScales &iscales,
+    const AbstractMotor::GearsetRatioPair &ipair,
+    const std::shared_ptr<Logger> &ilogger = Logger::getDefaultLogger());
+
+  AsyncHolonomicProfileController(AsyncHolonomicProfileController &&other) = delete;
+
+  AsyncHolonomicProfileController &operator=(AsyncHolonomicProfileController &&other) = delete;
+
+  ~AsyncHolonomicProfileController() override;
+
+  /**
+   * Generates a path which goes through the given waypoints and saves it internally with a key of
+   * pathId. Call `executePath()` with the same `pathId` to run it. The first waypoint is where the
+   * robot starts. The `theta` of each waypoint is the heading of the robot there, winding
+   * clockwise, instead of the exit angle of a spline. If there are fewer than two waypoints, no
+   * path is generated.
+   *
+   * @param iwaypoints The waypoints to hit on the path.
+   * @param ipathId A unique identifier to save the path with.
+   */
+  void generatePath(std::initializer_list<PathfinderPoint> iwaypoints, const std::string &ipathId);
+
+  /**
+   * Generates a path which goes through the given waypoints and saves it internally with a key of
+   * pathId. Call `executePath()` with the same pathId to run it. Throws a `std::invalid_argument`
+   * if the max velocity or max acceleration is not positive.
+   *
+   * @param iwaypoints The waypoints to hit on the path.
+   * @param ipathId A unique identifier to save the path with.
+   * @param ilimits The limits to use for this path only. The jerk is not used.
+   */
+  void generatePath(std::initializer_list<PathfinderPoint> iwaypoints,
+                    const std::string &ipathId,
+                    const PathfinderLimits &ilimits);
+
+  /**
+   * Removes a path and frees the memory it used. A path which is currently running is shared with
+   * the controller task, so it keeps running and its memory is freed when it finishes.
+   *
+   * @param ipathId A unique identifier for the path, previously passed to `generatePath()`
+   * @return `true` if the path no longer exists
+   */
+  bool removePath(const std::string &ipathId);
+
+  /**
+   * Gets the identifiers of all paths saved in this `AsyncHolonomicProfileController`.
+   *
+   * @return The identifiers of all paths
+   */
+  std::vector<std::string> getPaths();
+
+  /**
+   * Executes a path with the given ID. If there is no path matching the ID, the method will
+   * return. Any targets set while a path is being followed will be ignored.
+   *
+   * @param ipathId A unique identifier for the path, previously passed to `generatePath()`.
+   */
+  void setTarget(std::string ipathId) override;
+
+  /**
+   * Writes the value of the controller output. This method might be automatically called in another
+   * thread by the controller.
+   *
+   * This just calls `setTarget()`.
+   */
+  void controllerSet(std::string ivalue) override;
+
+  /**
+   * Gets the last set target, or the default target if none was set.
+   *
+   * @return the last target
+   */
+  std::string getTarget() override;
+
+  /**
+   * This is overridden to return the current path.
+   *
+   * @return The most recent value of the process variable.
+   */
+  std::string getProcessValue() const override;
+
+  /**
+   * Blocks the current task until the controller has settled. This controller is settled when
+   * it has finished following a path. If no path is being followed, it is settled.
+   */
+  void waitUntilSettled() override;
+
+  /**
+   * Generates a new path through the waypoints and blocks until the controller has settled. Does
+   * not save the path which was generated.
+   *
+   * @param iwaypoints The waypoints to hit on the path, starting with the current pose.
+   */
+  void moveTo(std::initializer_list<PathfinderPoint> iwaypoints);
+
+  /**
+   * Generates a new path through the waypoints and blocks until the controller has settled. Does
+   * not save the path which was generated.
+   *
+   * @param iwaypoints The waypoints to hit on the path, starting with the current pose.
+   * @param ilimits The limits to use for this path only.
+   */
+  void moveTo(std::initializer_list<PathfinderPoint> iwaypoints, const PathfinderLimits &ilimits);
+
+  /**
+   * Returns how far the pose the profile planned is from the end of the current path. Returns
+   * zero if there is no path currently being followed.
+   *
+   * @return the last error
+   */
+  PathfinderPoint getError() const override;
+
+  /**
+   * Returns whether the controller has settled at the target. Determining what settling means is
+   * implementation-dependent.
+   *
+   * If the controller is disabled, this method must return `true`.
+   *
+   * @return whether the controller is settled
+   */
+  bool isSettled() override;
+
+  /**
+   * Resets the controller's internal state so it is similar to when it was first initialized, while
+   * keeping any user-configured information. This implementation also stops movement.
+   */
+  void reset() override;
+
+  /**
+   * Changes whether the controller is off or on. Turning the controller on after it was off will
+   * NOT cause the controller to move to its last set target.
+   */
+  void flipDisable() override;
+
+  /**
+   * Sets whether the controller is off or on. Turning the controller on after it was off will
+   * NOT cause the controller to move to its last set target, unless it was reset in that time.
+   *
+   * @param iisDisabled whether the controller is disabled
+   */
+  void flipDisable(bool iisDisabled) override;
+
+  /**
+   * Returns whether the controller is currently disabled.
+   *
+   * @return whether the controller is currently disabled
+   */
+  bool isDisabled() const override;
+
+  /**
+   * This implementation does nothing because the paths are relative to where they start.
+   */
+  void tarePosition() override;
+
+  /**
+   * This implementation does nothing because the maximum velocity is configured using
+   * PathfinderLimits elsewhere.
+   *
+   * @param imaxVelocity Ignored.
+   */
+  void setMaxVelocity(std::int32_t imaxVelocity) override;
+
+  /**
+   * Starts the internal thread. This should not be called by normal users.
+   *
+   * @param ipriority The priority of the task.
+   * @param istackDepth The stack depth of the task in words.
+   */
+  void startThread(std::uint32_t ipriority = TASK_PRIORITY_DEFAULT,
+                   std::uint16_t istackDepth = TASK_STACK_DEPTH_DEFAULT);
+
+  /**
+   * Returns the underlying thread handle.
+   *
+   * @return The underlying thread handle.
+   */
+  CrossplatformThread *getThread() const;
+
+  /**
+   * Converts a chassis velocity into the velocity of each wheel along its axis, in the order top
+   * left, top right, bottom right, bottom left.
+   *
+   * @param ivelocity The velocity of the robot.
+   * @param iscales The ChassisScales. The wheel track is the distance between two diagonally
+   * opposite wheels.
+   * @return The velocity of each wheel.
+   */
+  static std::array<QSpeed, 4> toWheelVelocities(const ChassisVelocity &ivelocity,
+                                                 const ChassisScales &iscales);
+
+  protected:
+  /**
+   * A straight leg of a path, from one waypoint to the next.
+   */
+  struct Segment {
+    PathfinderPoint start;
+    PathfinderPoint delta;
+    // Runs from zero to the wheel travel of the leg, in meters
+    TrapezoidProfile profile;
+  };
+
+  /**
+   * A path follows its segments in order, stopping at the end of each one.
+   */
+  using Path = std::vector<Segment>;
+
+  std::shared_ptr<Logger> logger;
+  std::map<std::string, std::shared_ptr<const Path>> paths{};
+  PathfinderLimits limits;
+  std::shared_ptr<XDriveModel> model;
+  ChassisScales scales;
+  AbstractMotor::GearsetRatioPair pair;
+  TimeUtil timeUtil;
+  // Made once so following a path does not allocate. Only the controller task uses it.
+  std::unique_ptr<AbstractRate> pathRate;
+
+  // This must be locked when accessing the path map, the current path, or the planned pose. Paths
+  // themselves are immutable and shared, so the controller task does not need to hold it while
+  // following a path.
+  mutable CrossplatformMutex currentPathMutex;
+
+  std::string currentPath{""};
+  // Where the profile has planned the robot to be, relative to the start of the path
+  PathfinderPoint plannedPose{0_m, 0_m, 0_deg};
+  std::atomic_bool isRunning{false};
+  std::atomic_bool disabled{false};
+  std::atomic_bool dtorCalled{false};
+  // Notified when the controller settles, so waiting tasks don't need to poll
+  CrossplatformEvent settledEvent;
+  CrossplatformThread *task{nullptr};
+
+  /**
+   * The time between velocity setpoints.
+   */
+  static constexpr QTime profilePeriod = 10_ms; // NOLINT
+
+  /**
+   * The longest time in milliseconds the idle controller task sleeps before checking whether it
+   * should stop. `setTarget()` wakes the task immediately.
+   */
+  static constexpr std::uint32_t idleLoopTimeout = 100;
+
+  static void trampoline(void *context);
+  void loop();
+
+  /**
+   * Wakes the controller task so it starts following a new target.
+   */
+  void wakeTask();
+
+  /**
+   * Follows the path with the given ID if it exists.
+   *
+   * @return Whether the path existed.
+   */
+  bool executePath(const std::string &ipathId);
+
+  /**
+   * Follow the supplied path. Must follow the disabled lifecycle.
+   */
+  virtual void executeSinglePath(const Path &path, AbstractRate &rate);
+
+  /**
+   * Sends each wheel its velocity, slowing every wheel down together if one of them would go
+   * faster than the motors can.
+   *
+   * @param ivelocity The velocity of the robot.
+   */
+  void writeVelocity(const ChassisVelocity &ivelocity);
+};
+} // namespace okapi
@@ -6,6 +6,11 @@
 #pragma once
 
 #include "okapi/api/control/async/asyncPositionController.hpp"
+#include "okapi/api/control/controllerInput.hpp"
+#include "okapi/api/control/iterative/iterativePosPidController.hpp"
+#include "okapi/api/control/util/motorFeedforward.hpp"
+#include "okapi/api/control/util/pathPool.hpp"
+#include "okapi/api/control/util/pathTrackingRecorder.hpp"
 #include "okapi/api/control/util/pathfinderUtil.hpp"
 #include "okapi/api/device/motor/abstractMotor.hpp"
 #include "okapi/api/units/QAngularSpeed.hpp"
@@ -13,6 +18,7 @@
 #include "okapi/api/util/logging.hpp"
 #include "okapi/api/util/timeUtil.hpp"
 #include <atomic>
+#include <deque>
 #include <map>
 
 #include "squiggles.hpp"
@@ -75,9 +81,32 @@ class AsyncLinearMotionProfileController : public AsyncPositionController<std::s
                     const PathfinderLimits &ilimits);
 
   /**
-   * Removes a path and frees the memory it used. This function returns `true` if the path was
-   * either deleted or didn't exist in the first place. It returns `false` if the path could not be
-   * removed because it is running.
+   * Generates a path which starts and ends moving. Use this to build paths which are chained
+   * together with `setTargetSequence()`: the end velocity of one path should match the start
+   * velocity of the next.
+   *
+   * If the waypoints form a path which is impossible to achieve, an instance of
+   * `std::runtime_error` is thrown (and an error is logged) which describes the waypoints. If
+   * either velocity is negative or above the maximum velocity, an instance of
+   * `std::invalid_argument` is thrown. If there are no waypoints, no path is generated.
+   *
+   * @param iwaypoints The waypoints to hit on the path.
+   * @param ipathId A unique identifier to save the path with.
+   * @param ilimits The limits to use for this path only.
+   * @param istartVelocity The velocity at the start of the path.
+   * @param iendVelocity The velocity at the end of the path.
+   */
+  void generatePath(std::initializer_list<QLength> iwaypoints,
+                    const std::string &ipathId,
+                    const PathfinderLimits &ilimits,
+                    QSpeed istartVelocity,
+                    QSpeed iendVelocity);
+
+  /**
+   * Removes a path and frees the memory it used. A path which is currently running is shared with
+   * the controller task, so removing it only drops this controller's reference; the path keeps
+   * running and its memory is freed when it finishes. This function always returns `true` because
+   * the path no longer exists afterwards.
    *
    * @param ipathId A unique identifier for the path, previously passed to generatePath()
    * @return `true` if the path no longer exists
@@ -91,6 +120,14 @@ class AsyncLinearMotionProfileController : public AsyncPositionController<std::s
    */
   std::vector<std::string> getPaths();
 
+  /**
+   * Generated paths are stored in buffers from this pool, which reuses the buffers of removed
+   * paths. Use it to read how much memory the paths use or to free the kept buffers.
+   *
+   * @return The pool paths are stored in.
+   */
+  std::shared_ptr<PathPool> getPathPool() const;
+
   /**
    * Executes a path with the given ID. If there is no path matching the ID, the method will
    * return. Any targets set while a path is being followed will be ignored.
@@ -105,8 +142,27 @@ class AsyncLinearMotionProfileController : public AsyncPositionController<std::s
    *
    * @param ipathId A unique identifier for the path, previously passed to `generatePath()`.
    * @param ibackwards Whether to follow the profile backwards.
+   * @param ispeedScale The fraction of the generated speed to follow the profile at. The
+   * velocities are scaled and the profile is stretched in time to match, without regenerating it.
+   * Must be positive.
+   */
+  void setTarget(std::string ipathId, bool ibackwards, double ispeedScale = 1.0);
+
+  /**
+   * Executes the paths with the given IDs back to back. The output is only stopped after the last
+   * path, so paths which end moving (see `generatePath()`) flow into the next one without stopping.
+   * Paths which don't exist are skipped. A warning is logged if the end velocity of a path does not
+   * match the start velocity of the next one. Any targets set while the sequence is being followed
+   * will be ignored.
+   *
+   * @param ipathIds The path IDs in the order they should be followed.
+   * @param ibackwards Whether to follow the profiles backwards.
+   * @param ispeedScale The fraction of the generated speed to follow the profiles at. Must be
+   * positive.
    */
-  void setTarget(std::string ipathId, bool ibackwards);
+  void setTargetSequence(const std::vector<std::string> &ipathIds,
+                         bool ibackwards = false,
+                         double ispeedScale = 1.0);
 
   /**
    * Writes the value of the controller output. This method might be automatically called in another
@@ -169,7 +225,8 @@ class AsyncLinearMotionProfileController : public AsyncPositionController<std::s
 
   /**
    * Returns the last error of the controller. Does not update when disabled. Returns zero if there
-   * is no path currently being followed.
+   * is no path currently being followed. Without feedback (see `setFeedback()`), the position is
+   * assumed to follow the profile exactly.
    *
    * @return the last error
    */
@@ -229,8 +286,12 @@ class AsyncLinearMotionProfileController : public AsyncPositionController<std::s
   /**
    * Starts the internal thread. This should not be called by normal users. This method is called
    * by the AsyncControllerFactory when making a new instance of this class.
+   *
+   * @param ipriority The priority of the task.
+   * @param istackDepth The stack depth of the task in words.
    */
-  void startThread();
+  void startThread(std::uint32_t ipriority = TASK_PRIORITY_DEFAULT,
+                   std::uint16_t istackDepth = TASK_STACK_DEPTH_DEFAULT);
 
   /**
    * Returns the underlying thread handle.
@@ -240,41 +301,133 @@ class AsyncLinearMotionProfileController : public AsyncPositionController<std::s
   CrossplatformThread *getThread() const;
 
   /**
-   * Attempts to remove a path without stopping execution, then if that fails, disables the
-   * controller and removes the path.
+   * Removes a path without stopping execution. Removing a path never fails because running paths
+   * are shared with the controller task, so this is equivalent to `removePath()`.
    *
    * @param ipathId The path ID that will be removed
    */
   void forceRemovePath(const std::string &ipathId);
 
+  /**
+   * Closes the loop around the paths followed from now on, so they can be followed faster and end
+   * at the target instead of wherever the open loop commands leave the system. Each profile step,
+   * the output is set to the feedforward of the profile's velocity and acceleration plus the
+   * output of the PID controller, which moves the input toward the profile's position. After a path
+   * which ends at rest, the PID controller keeps holding the last position until it settles or
+   * the settle timeout passes, so no separate settle step is needed. `getError()` is then measured
+   * by the input instead of being read from the profile.
+   *
+   * Positions are measured relative to where the input is when each path starts. The input must
+   * read the position of the motor in degrees, like the integrated encoder of a motor, and the PID
+   * controller works in those degrees, so its gains and settled util are in them too.
+   *
+   * Pass a null input or controller to go back to following paths open loop, which is the default.
+   *
+   * @param iinput The sensor which measures the position of the motor.
+   * @param icontroller The position controller which corrects the error. It is reset at the start
+   * of every path.
+   * @param ifeedforward The output for the profile's velocity and acceleration in m/s and m/s^2.
+   * Leave all gains at zero to use the open loop velocity command.
+   * @param isettleTimeout The longest time to wait for the PID controller to settle after a path.
+   */
+  void setFeedback(const std::shared_ptr<ControllerInput<double>> &iinput,
+                   const std::shared_ptr<IterativePosPIDController> &icontroller,
+                   const MotorFeedforward &ifeedforward = {},
+                   QTime isettleTimeout = 1_s);
+
+  /**
+   * Records the velocity this controller commands next to what the motor measures at every step
+   * of every path, and writes each path's samples to a file after it is done. The left motor of
+   * the recorder is read, and its right motor should be `nullptr`. A sequence of paths is recorded
+   * as one path named after its first path, so writing the file never delays the next path. Pass
+   * `nullptr` to stop recording. The recorder takes effect from the next path.
+   *
+   * @param irecorder The recorder.
+   */
+  void setTrackingRecorder(const std::shared_ptr<PathTrackingRecorder> &irecorder);
+
   protected:
   std::shared_ptr<Logger> logger;
-  std::map<std::string, std::vector<squiggles::ProfilePoint>> paths{};
+  std::shared_ptr<PathPool> pathPool{std::make_shared<PathPool>()};
+  std::map<std::string, std::shared_ptr<const std::vector<squiggles::ProfilePoint>>> paths{};
   PathfinderLimits limits;
   std::shared_ptr<ControllerOutput<double>> output;
   QLength diameter;
   AbstractMotor::GearsetRatioPair pair;
-  double currentProfilePosition{0};
+  // The normalized motor command for a velocity of 1 m/s. The diameter and gearset can't change
+  // after construction, so this is computed once instead of on every segment.
+  double motorCommandPerMps{0};
+  // The motor degrees per meter, which converts profile positions into input readings
+  double motorDegreesPerMeter{0};
+  std::atomic<double> currentProfilePosition{0};
+
+  // The feedback used while following paths, guarded by feedbackMutex
+  mutable CrossplatformMutex feedbackMutex;
+  std::shared_ptr<ControllerInput<double>> feedbackInput{nullptr};
+  std::shared_ptr<IterativePosPIDController> feedbackController{nullptr};
+  MotorFeedforward feedforward{};
+  QTime feedbackSettleTimeout{1_s};
+  std::shared_ptr<PathTrackingRecorder> trackingRecorder{nullptr};
+  // The recorder of the path being followed. Only used by the controller task.
+  std::shared_ptr<PathTrackingRecorder> activeTrackingRecorder{nullptr};
   TimeUtil timeUtil;
+  // Made once so following a path does not allocate. Only the controller task uses it.
+  std::unique_ptr<AbstractRate> pathRate;
 
-  // This must be locked when accessing the current path
-  CrossplatformMutex currentPathMutex;
+  // This must be locked when accessing the path map. Paths themselves are immutable and shared,
+  // so the controller task does not need to hold it while following a path.
+  mutable CrossplatformMutex currentPathMutex;
 
   std::string currentPath{""};
+  // The paths to follow after the current one, guarded by currentPathMutex
+  std::deque<std::string> queuedPaths{};
   std::atomic_bool isRunning{false};
   std::atomic_int direction{1};
+  std::atomic<double> speedScale{1.0};
   std::atomic_bool disabled{false};
   std::atomic_bool dtorCalled{false};
+  // Notified when the controller settles, so waiting tasks don't need to poll
+  CrossplatformEvent settledEvent;
   CrossplatformThread *task{nullptr};
 
+  /**
+   * The longest time in milliseconds the idle controller task sleeps before checking whether it
+   * should stop. `setTarget()` wakes the task immediately.
+   */
+  static constexpr std::uint32_t idleLoopTimeout = 100;
+
+  /**
+   * The timestep of generated profiles in seconds.
+   */
+  static constexpr double DT = 0.01;
+
   static void trampoline(void *context);
   void loop();
 
+  /**
+   * Wakes the controller task so it starts following a new target.
+   */
+  void wakeTask();
+
+  /**
+   * Follows the path with the given ID if it exists.
+   *
+   * @return Whether the path existed.
+   */
+  bool executePath(const std::string &ipathId);
+
+  /**
+   * Removes the next path from the queue and makes it the current path.
+   *
+   * @return Whether there was a next path to follow.
+   */
+  bool advanceToQueuedPath();
+
   /**
    * Follow the supplied path. Must follow the disabled lifecycle.
    */
   virtual void executeSinglePath(const std::vector<squiggles::ProfilePoint> &path,
-                                 std::unique_ptr<AbstractRate> rate);
+                                 AbstractRate &rate);
 
   /**
    * Converts linear "chassis" speed to rotational motor speed.
@@ -8,18 +8,141 @@
 #include "okapi/api/chassis/controller/chassisScales.hpp"
 #include "okapi/api/chassis/model/skidSteerModel.hpp"
 #include "okapi/api/control/async/asyncPositionController.hpp"
+#include "okapi/api/control/util/coprocessorClient.hpp"
+#include "okapi/api/control/util/diffDriveMpc.hpp"
+#include "okapi/api/control/util/incrementalPathGenerator.hpp"
+#include "okapi/api/control/util/motorFeedforward.hpp"
+#include "okapi/api/control/util/pathBinaryFormat.hpp"
+#include "okapi/api/control/util/pathPool.hpp"
+#include "okapi/api/control/util/pathStreamReader.hpp"
+#include "okapi/api/control/util/pathTrackingRecorder.hpp"
 #include "okapi/api/control/util/pathfinderUtil.hpp"
+#include "okapi/api/control/util/profileGenerator.hpp"
+#include "okapi/api/control/util/profileResampler.hpp"
+#include "okapi/api/control/util/profileRetimer.hpp"
+#include "okapi/api/odometry/odometry.hpp"
+#include "okapi/api/units/QAcceleration.hpp"
 #include "okapi/api/units/QAngularSpeed.hpp"
 #include "okapi/api/units/QSpeed.hpp"
 #include "okapi/api/util/logging.hpp"
 #include "okapi/api/util/timeUtil.hpp"
+#include <array>
 #include <atomic>
+#include <cstdint>
+#include <deque>
+#include <functional>
 #include <iostream>
+#include <list>
 #include <map>
+#include <optional>
 
 #include "squiggles.hpp"
 
 namespace okapi {
+/**
+ * The lifecycle of a path submitted to `AsyncMotionProfileController::generatePathAsync()`.
+ */
+enum class PathGenerationStatus {
+  queued,     ///< Waiting for the generator task
+  generating, ///< Being generated by the generator task
+  ready,      ///< Generated and saved
+  failed      ///< Generation produced no path
+};
+
+/**
+ * An interned path ID of an `AsyncMotionProfileController`, which indexes its path table.
+ * Following a path by its handle finds it without comparing or copying strings. A path ID keeps its
+ * handle for the life of the controller, so a handle stays valid when its path is removed or
+ * replaced and refers to whatever path is later saved with the same ID. Handles are only
+ * meaningful to the controller which returned them.
+ */
+class PathHandle {
+  public:
+  /**
+   * An invalid handle, which refers to no path.
+   */
+  constexpr PathHandle() = default;
+
+  explicit constexpr PathHandle(const std::uint32_t iindex) : index(iindex) {
+  }
+
+  /**
+   * @return The index of the path in the path table.
+   */
+  constexpr std::uint32_t getIndex() const {
+    return index;
+  }
+
+  /**
+   * @return Whether this handle refers to a path ID.
+   */
+  constexpr bool isValid() const {
+    return index != invalidIndex;
+  }
+
+  constexpr bool operator==(const PathHandle &rhs) const {
+    return index == rhs.index;
+  }
+
+  constexpr bool operator!=(const PathHandle &rhs) const {
+    return index != rhs.index;
+  }
+
+  static constexpr std::uint32_t invalidIndex = UINT32_MAX;
+
+  protected:
+  std::uint32_t index{invalidIndex};
+};
+
+/**
+ * A handle to a path being generated in the background. Copies of a handle share the same status.
+ */
+class PathGenerationHandle {
+  public:
+  PathGenerationHandle(std::string ipathId,
+                       std::shared_ptr<std::atomic<PathGenerationStatus>> istatus)
+    : pathId(std::move(ipathId)), status(std::move(istatus)) {
+  }
+
+  /**
+   * @return The path ID the path will be saved with.
+   */
+  const std::string &getPathId() const {
+    return pathId;
+  }
+
+  /**
+   * @return The current status of the path.
+   */
+  PathGenerationStatus getStatus() const {
+    return status->load(std::memory_order_acquire);
+  }
+
+  /**
+   * @return Whether the generator task is finished with the path (either successfully or not).
+   */
+  bool isDone() const {
+    const auto current = getStatus();
+    return current == PathGenerationStatus::ready || current == PathGenerationStatus::failed;
+  }
+
+  protected:
+  std::string pathId;
+  std::shared_ptr<std::atomic<PathGenerationStatus>> status;
+};
+
+/**
+ * Statistics about the generated paths an `AsyncMotionProfileController` keeps in memory. See
+ * `AsyncMotionProfileController::setPathCacheBudget()`.
+ */
+struct PathCacheStats {
+  std::size_t hits{0};       ///< Paths which were in memory when they were followed
+  std::size_t misses{0};     ///< Evicted paths which had to be reloaded to be followed
+  std::size_t evictions{0};  ///< Paths which were evicted to stay within the budget
+  std::size_t bytesUsed{0};  ///< The approximate memory used by the paths in memory
+  std::size_t byteBudget{0}; ///< The memory budget, or zero if there is none
+};
+
 class AsyncMotionProfileController : public AsyncPositionController<std::string, PathfinderPoint> {
   public:
   /**
@@ -56,8 +179,10 @@ class AsyncMotionProfileController : public AsyncPositionController<std::string,
    *
    * @param iwaypoints The waypoints to hit on the path.
    * @param ipathId A unique identifier to save the path with.
+   * @return The handle of the path, or an invalid handle if no path was generated.
    */
-  void generatePath(std::initializer_list<PathfinderPoint> iwaypoints, const std::string &ipathId);
+  PathHandle generatePath(std::initializer_list<PathfinderPoint> iwaypoints,
+                          const std::string &ipathId);
 
   /**
    * Generates a path which intersects the given waypoints and saves it internally with a key of
@@ -74,15 +199,249 @@ class AsyncMotionProfileController : public AsyncPositionController<std::string,
    * @param iwaypoints The waypoints to hit on the path.
    * @param ipathId A unique identifier to save the path with.
    * @param ilimits The limits to use for this path only.
+   * @return The handle of the path, or an invalid handle if no path was generated.
+   */
+  PathHandle generatePath(std::initializer_list<PathfinderPoint> iwaypoints,
+                          const std::string &ipathId,
+                          const PathfinderLimits &ilimits);
+
+  /**
+   * Generates a path which starts and ends moving. Use this to build paths which are chained
+   * together with `setTargetSequence()`: the end velocity of one path should match the start
+   * velocity of the next.
+   *
+   * If the waypoints form a path which is impossible to achieve, an instance of
+   * `std::runtime_error` is thrown (and an error is logged) which describes the waypoints. If
+   * either velocity is negative or above the maximum velocity, an instance of
+   * `std::invalid_argument` is thrown. If there are no waypoints, no path is generated.
+   *
+   * @param iwaypoints The waypoints to hit on the path.
+   * @param ipathId A unique identifier to save the path with.
+   * @param ilimits The limits to use for this path only.
+   * @param istartVelocity The linear velocity at the start of the path.
+   * @param iendVelocity The linear velocity at the end of the path.
+   * @return The handle of the path, or an invalid handle if no path was generated.
+   */
+  PathHandle generatePath(std::initializer_list<PathfinderPoint> iwaypoints,
+                          const std::string &ipathId,
+                          const PathfinderLimits &ilimits,
+                          QSpeed istartVelocity,
+                          QSpeed iendVelocity);
+
+  /**
+   * Generates a path through waypoints which are only known at runtime, such as waypoints computed
+   * from odometry or vision. This is otherwise the same as the overload taking an initializer list.
+   *
+   * @param iwaypoints The waypoints to hit on the path.
+   * @param ipathId A unique identifier to save the path with.
+   * @return The handle of the path, or an invalid handle if no path was generated.
+   */
+  PathHandle generatePath(const std::vector<PathfinderPoint> &iwaypoints,
+                          const std::string &ipathId);
+
+  /**
+   * Generates a path through waypoints which are only known at runtime, such as waypoints computed
+   * from odometry or vision. This is otherwise the same as the overload taking an initializer list.
+   *
+   * @param iwaypoints The waypoints to hit on the path.
+   * @param ipathId A unique identifier to save the path with.
+   * @param ilimits The limits to use for this path only.
+   * @param istartVelocity The linear velocity at the start of the path.
+   * @param iendVelocity The linear velocity at the end of the path.
+   * @return The handle of the path, or an invalid handle if no path was generated.
+   */
+  PathHandle generatePath(const std::vector<PathfinderPoint> &iwaypoints,
+                          const std::string &ipathId,
+                          const PathfinderLimits &ilimits,
+                          QSpeed istartVelocity = 0_mps,
+                          QSpeed iendVelocity = 0_mps);
+
+  /**
+   * Generates a path like `generatePath()`, but remembers the spline segment between each pair of
+   * consecutive waypoints for this path ID. Generating the path again after moving, adding, or
+   * removing a waypoint only regenerates the segments next to the changed waypoints, and then
+   * re-times the whole profile. Use this to tune a path on the robot one waypoint at a time.
+   *
+   * The profile is re-timed by okapi instead of by squiggles (see `IncrementalPathGenerator`), so
+   * it does not limit jerk and can differ slightly from the profile `generatePath()` makes. The
+   * remembered segments are forgotten when the path is removed with `removePath()` or when it is
+   * generated with different limits. Do not generate the same path ID from two tasks at once.
+   *
+   * If the waypoints form a path which is impossible to achieve, an instance of
+   * `std::runtime_error` is thrown (and an error is logged). If there are fewer than two waypoints,
+   * an instance of `std::invalid_argument` is thrown.
+   *
+   * @param iwaypoints The waypoints to hit on the path.
+   * @param ipathId A unique identifier to save the path with.
+   * @return The handle of the path.
+   */
+  PathHandle generatePathIncremental(const std::vector<PathfinderPoint> &iwaypoints,
+                                     const std::string &ipathId);
+
+  /**
+   * Generates a path like `generatePath()`, but only regenerates the spline segments which changed
+   * since the last time this path ID was generated with this function. See the other overload.
+   *
+   * @param iwaypoints The waypoints to hit on the path.
+   * @param ipathId A unique identifier to save the path with.
+   * @param ilimits The limits to use for this path only.
+   * @return The handle of the path.
+   */
+  PathHandle generatePathIncremental(const std::vector<PathfinderPoint> &iwaypoints,
+                                     const std::string &ipathId,
+                                     const PathfinderLimits &ilimits);
+
+  /**
+   * Queues a path to be generated by a low-priority background task and saved with a key of
+   * pathId. This returns immediately, so path generation can overlap with executing another path.
+   * Setting a target to a path which is still being generated blocks until it is ready.
+   *
+   * @param iwaypoints The waypoints to hit on the path.
+   * @param ipathId A unique identifier to save the path with.
+   * @return A handle to check on the status of the path.
+   */
+  PathGenerationHandle generatePathAsync(std::initializer_list<PathfinderPoint> iwaypoints,
+                                         const std::string &ipathId);
+
+  /**
+   * Queues a path to be generated by a low-priority background task and saved with a key of
+   * pathId. This returns immediately, so path generation can overlap with executing another path.
+   * Setting a target to a path which is still being generated blocks until it is ready.
+   *
+   * @param iwaypoints The waypoints to hit on the path.
+   * @param ipathId A unique identifier to save the path with.
+   * @param ilimits The limits to use for this path only.
+   * @return A handle to check on the status of the path.
+   */
+  PathGenerationHandle generatePathAsync(std::initializer_list<PathfinderPoint> iwaypoints,
+                                         const std::string &ipathId,
+                                         const PathfinderLimits &ilimits);
+
+  /**
+   * Queues a path through waypoints which are only known at runtime to be generated by the
+   * background task. The waypoints are handed to the task, so pass them with `std::move()` to
+   * avoid copying them. This is otherwise the same as the overload taking an initializer list.
+   *
+   * @param iwaypoints The waypoints to hit on the path.
+   * @param ipathId A unique identifier to save the path with.
+   * @return A handle to check on the status of the path.
+   */
+  PathGenerationHandle generatePathAsync(std::vector<PathfinderPoint> iwaypoints,
+                                         const std::string &ipathId);
+
+  /**
+   * Queues a path through waypoints which are only known at runtime to be generated by the
+   * background task. The waypoints are handed to the task, so pass them with `std::move()` to
+   * avoid copying them. This is otherwise the same as the overload taking an initializer list.
+   *
+   * @param iwaypoints The waypoints to hit on the path.
+   * @param ipathId A unique identifier to save the path with.
+   * @param ilimits The limits to use for this path only.
+   * @return A handle to check on the status of the path.
+   */
+  PathGenerationHandle generatePathAsync(std::vector<PathfinderPoint> iwaypoints,
+                                         const std::string &ipathId,
+                                         const PathfinderLimits &ilimits);
+
+  /**
+   * Replans the path being followed from where the robot is now to the end of the path, without
+   * stopping. Use this to recover after the robot is bumped off the path. This needs odometry (see
+   * `setOdometry()`). The new profile starts at the pose of the robot, moving at the speed it is
+   * being driven at, and ends at the last point of the path. It is generated by the background
+   * generator task (see `generatePathAsync()`), and the controller task switches to it as soon as
+   * it is ready, skipping the part of it the robot drove while it was being generated. The saved
+   * path is not changed.
+   *
+   * If there is no odometry or no generated path is being followed, nothing is replanned and the
+   * handle is `failed`. If the path ends before the new profile is ready, the new profile is
+   * dropped.
+   *
+   * @return A handle to check on the status of the new profile, with the ID of the path.
+   */
+  PathGenerationHandle replan();
+
+  /**
+   * Replans the path being followed from where the robot is now to the end of the path, without
+   * stopping. See `replan()`.
+   *
+   * @param ilimits The limits to use for the new profile.
+   * @return A handle to check on the status of the new profile, with the ID of the path.
+   */
+  PathGenerationHandle replan(const PathfinderLimits &ilimits);
+
+  /**
+   * Blocks the current task until a path queued with `generatePathAsync()` is done generating.
+   * Returns immediately if the path is not queued.
+   *
+   * @param ipathId The path ID previously passed to `generatePathAsync()`.
    */
-  void generatePath(std::initializer_list<PathfinderPoint> iwaypoints,
-                    const std::string &ipathId,
-                    const PathfinderLimits &ilimits);
+  void waitForPath(const std::string &ipathId);
 
   /**
-   * Removes a path and frees the memory it used. This function returns true if the path was either
-   * deleted or didn't exist in the first place. It returns false if the path could not be removed
-   * because it is running.
+   * Registers a path which is stored outside of this controller, typically a `constexpr` table
+   * compiled into the program. The points are executed in place and are never copied, so they must
+   * outlive this controller. Each point is followed for one 10 ms segment. Any existing path with
+   * the same ID is replaced.
+   *
+   * @param ipathId A unique identifier to save the path with.
+   * @param ipoints The first point of the path.
+   * @param icount The number of points in the path.
+   */
+  void registerStaticPath(const std::string &ipathId,
+                          const StaticProfilePoint *ipoints,
+                          std::size_t icount);
+
+  /**
+   * Registers a path which is stored outside of this controller, typically a `constexpr` table
+   * compiled into the program. See `registerStaticPath(const std::string &, const
+   * StaticProfilePoint *, std::size_t)`.
+   *
+   * @param ipathId A unique identifier to save the path with.
+   * @param ipoints The points of the path.
+   */
+  template <std::size_t N>
+  void registerStaticPath(const std::string &ipathId, const StaticProfilePoint (&ipoints)[N]) {
+    registerStaticPath(ipathId, ipoints, N);
+  }
+
+  /**
+   * Registers a path which is stored outside of this controller, typically a `constexpr` table
+   * compiled into the program. See `registerStaticPath(const std::string &, const
+   * StaticProfilePoint *, std::size_t)`.
+   *
+   * @param ipathId A unique identifier to save the path with.
+   * @param ipoints The points of the path.
+   */
+  template <std::size_t N>
+  void registerStaticPath(const std::string &ipathId,
+                          const std::array<StaticProfilePoint, N> &ipoints) {
+    registerStaticPath(ipathId, ipoints.data(), N);
+  }
+
+  /**
+   * Registers a view of another path under its own ID. Following the view follows the base path
+   * with the view's transforms applied on top of the ones passed to `setTarget()`, so one generated
+   * path can cover every side of the field. A view shares the base path's storage, so it uses no
+   * extra memory. The base path is looked up whenever the view is followed, so it can be generated,
+   * replaced, or loaded after the view is registered. The base path may itself be a view.
+   *
+   * @param iviewId A unique identifier to save the view with.
+   * @param ibasePathId The ID of the path to follow.
+   * @param ibackwards Whether to follow the base path backwards.
+   * @param imirrored Whether to follow the base path mirrored.
+   * @param ispeedScale The fraction of the base path's speed to follow it at. Must be positive.
+   */
+  void registerPathView(const std::string &iviewId,
+                        const std::string &ibasePathId,
+                        bool ibackwards,
+                        bool imirrored,
+                        double ispeedScale = 1.0);
+
+  /**
+   * Removes a path and frees the memory it used. A path which is currently running is shared with
+   * the controller task, so removing it only drops this controller's reference; the path keeps
+   * running and its memory is freed when it finishes. This function always returns true because
+   * the path no longer exists afterwards.
    *
    * @param ipathId A unique identifier for the path, previously passed to `generatePath()`
    * @return True if the path no longer exists
@@ -90,12 +449,53 @@ class AsyncMotionProfileController : public AsyncPositionController<std::string,
   bool removePath(const std::string &ipathId);
 
   /**
-   * Gets the identifiers of all paths saved in this `AsyncMotionProfileController`.
+   * Gets the identifiers of all paths saved in this `AsyncMotionProfileController`, including path
+   * views and paths which were evicted from memory and will be reloaded when they are followed.
    *
    * @return The identifiers of all paths
    */
   std::vector<std::string> getPaths();
 
+  /**
+   * Gets the handle of a path ID, interning the ID if it has none yet. This works for every kind of
+   * path (and IDs which have no path yet), so static paths, path views, and streamed paths can be
+   * followed by handle too.
+   *
+   * @param ipathId The path ID.
+   * @return The handle of the path ID.
+   */
+  PathHandle getPathHandle(const std::string &ipathId);
+
+  /**
+   * @param ipath A handle returned by this controller.
+   * @return The path ID of the handle, or an empty string if the handle is invalid.
+   */
+  std::string getPathId(PathHandle ipath) const;
+
+  /**
+   * Limits the memory used by generated paths. When the paths in memory use more than `ibytes`,
+   * the least recently used paths are evicted until they fit. Only paths which were loaded with
+   * `loadPath()` or stored with `storePath()` or `storeBinaryPath()` can be evicted, because they
+   * are reloaded from the SD card with `loadPath()` the next time they are followed. Other paths
+   * are never evicted. Static paths do not count towards the budget.
+   *
+   * @param ibytes The memory budget in bytes, or zero for no budget (the default).
+   */
+  void setPathCacheBudget(std::size_t ibytes);
+
+  /**
+   * @return The path cache statistics.
+   */
+  PathCacheStats getPathCacheStats() const;
+
+  /**
+   * Generated and loaded paths are stored in buffers from this pool, which reuses the buffers of
+   * removed paths. Use it to read how much memory the paths use or to free the kept buffers.
+   *
+   * @return The pool paths are stored in.
+   */
+  std::shared_ptr<PathPool> getPathPool() const;
+
   /**
    * Executes a path with the given ID. If there is no path matching the ID, the method will
    * return. Any targets set while a path is being followed will be ignored.
@@ -111,8 +511,48 @@ class AsyncMotionProfileController : public AsyncPositionController<std::string,
    * @param ipathId A unique identifier for the path, previously passed to `generatePath()`.
    * @param ibackwards Whether to follow the profile backwards.
    * @param imirrored Whether to follow the profile mirrored.
+   * @param ispeedScale The fraction of the generated speed to follow the profile at. The
+   * velocities are scaled and the profile is stretched in time to match, without regenerating it.
+   * Must be positive.
+   */
+  void setTarget(std::string ipathId,
+                 bool ibackwards,
+                 bool imirrored = false,
+                 double ispeedScale = 1.0);
+
+  /**
+   * Executes the path with the given handle. This is `setTarget()` without the string lookups, so
+   * it is the cheaper way to start paths which are followed often. If there is no path for the
+   * handle, the method will return. Any targets set while a path is being followed will be ignored.
+   *
+   * @param ipath A handle returned by `generatePath()`, `loadPath()`, or `getPathHandle()`.
+   * @param ibackwards Whether to follow the profile backwards.
+   * @param imirrored Whether to follow the profile mirrored.
+   * @param ispeedScale The fraction of the generated speed to follow the profile at. Must be
+   * positive.
+   */
+  void setTarget(PathHandle ipath,
+                 bool ibackwards = false,
+                 bool imirrored = false,
+                 double ispeedScale = 1.0);
+
+  /**
+   * Executes the paths with the given IDs back to back. The chassis is only stopped after the last
+   * path, so paths which end moving (see `generatePath()`) flow into the next one without stopping.
+   * Paths which don't exist are skipped. A warning is logged if the end velocity of a path does not
+   * match the start velocity of the next one. Any targets set while the sequence is being followed
+   * will be ignored.
+   *
+   * @param ipathIds The path IDs in the order they should be followed.
+   * @param ibackwards Whether to follow the profiles backwards.
+   * @param imirrored Whether to follow the profiles mirrored.
+   * @param ispeedScale The fraction of the generated speed to follow the profiles at. Must be
+   * positive.
    */
-  void setTarget(std::string ipathId, bool ibackwards, bool imirrored = false);
+  void setTargetSequence(const std::vector<std::string> &ipathIds,
+                         bool ibackwards = false,
+                         bool imirrored = false,
+                         double ispeedScale = 1.0);
 
   /**
    * Writes the value of the controller output. This method might be automatically called in another
@@ -156,6 +596,9 @@ class AsyncMotionProfileController : public AsyncPositionController<std::string,
    * Generates a new path from the position (typically the current position) to the target and
    * blocks until the controller has settled. Does not save the path which was generated.
    *
+   * The most recently used profiles are remembered, so calling this again with the same waypoints
+   * and limits reuses the profile instead of generating it again.
+   *
    * @param iwaypoints The waypoints to hit on the path.
    * @param ilimits The limits to use for this path only.
    * @param ibackwards Whether to follow the profile backwards.
@@ -167,14 +610,170 @@ class AsyncMotionProfileController : public AsyncPositionController<std::string,
               bool imirrored = false);
 
   /**
-   * Returns the last error of the controller. Does not update when disabled. This implementation
-   * always returns zero since the robot is assumed to perfectly follow the path. Subclasses can
-   * override this to be more accurate using odometry information.
+   * Moves through waypoints which are only known at runtime, such as waypoints computed from
+   * odometry or vision. This is otherwise the same as the overload taking an initializer list.
+   *
+   * @param iwaypoints The waypoints to hit on the path.
+   * @param ibackwards Whether to follow the profile backwards.
+   * @param imirrored Whether to follow the profile mirrored.
+   */
+  void moveTo(const std::vector<PathfinderPoint> &iwaypoints,
+              bool ibackwards = false,
+              bool imirrored = false);
+
+  /**
+   * Moves through waypoints which are only known at runtime, such as waypoints computed from
+   * odometry or vision. This is otherwise the same as the overload taking an initializer list.
+   *
+   * @param iwaypoints The waypoints to hit on the path.
+   * @param ilimits The limits to use for this path only.
+   * @param ibackwards Whether to follow the profile backwards.
+   * @param imirrored Whether to follow the profile mirrored.
+   */
+  void moveTo(const std::vector<PathfinderPoint> &iwaypoints,
+              const PathfinderLimits &ilimits,
+              bool ibackwards = false,
+              bool imirrored = false);
+
+  /**
+   * Returns the last error of the controller. Does not update when disabled. Without odometry (see
+   * `setOdometry()`), this always returns zero since the robot is assumed to perfectly follow the
+   * path. With odometry, this is the pose error of the robot relative to the profile, in the
+   * robot's frame (+x is forward, +y is right).
    *
    * @return the last error
    */
   PathfinderPoint getError() const override;
 
+  /**
+   * Stores paths generated from now on with fewer points to save memory. Every `istride`-th point
+   * is kept, as well as any point where the curvature changes by more than `imaxCurvatureChange`
+   * since the last kept point. The motors are still commanded every profile timestep by
+   * interpolating between the stored points (see `setProfileInterpolation()`). Loaded paths are
+   * stored as they are.
+   *
+   * @param istride Keep every `istride`-th point. The default of one keeps every point.
+   * @param imaxCurvatureChange The curvature change (in 1/m) which forces a point to be kept.
+   */
+  void setProfileDecimation(std::size_t istride,
+                            double imaxCurvatureChange = std::numeric_limits<double>::infinity());
+
+  /**
+   * Retimes paths generated from now on to what the drive motors can deliver (see
+   * `ProfileRetimer`), so they speed up harder at low speed and go faster on straight sections
+   * than the limits allow. The limits still shape the path and its start and end velocities.
+   * Loaded paths are followed as they were saved. Pass `std::nullopt` to stop retiming, which is
+   * the default.
+   *
+   * @param iretimer The model of the drive motors, or `std::nullopt`.
+   */
+  void setProfileRetimer(const std::optional<ProfileRetimer> &iretimer);
+
+  /**
+   * Slows paths generated from now on down wherever they would need more than a centripetal
+   * acceleration, so the robot doesn't slide in sharp turns (see
+   * `ProfileRetimer::limitCentripetalAcceleration()`). The path slows down into and speeds up out
+   * of each curve at the max acceleration of its limits. Straight sections keep their velocities,
+   * so a high max velocity can be used without sliding in the turns. Loaded paths are followed as
+   * they were saved. The default of infinity does not limit the centripetal acceleration.
+   *
+   * @param imaxAccel The most centripetal acceleration of the center of the robot.
+   */
+  void setMaxCentripetalAcceleration(QAcceleration imaxAccel);
+
+  /**
+   * Sends the paths generated from now on to a coprocessor (see `CoprocessorClient`) instead of
+   * generating them on the brain. If the coprocessor does not answer with a profile, the path is
+   * generated on the brain as usual. Retiming and decimation still happen on the brain. Pass
+   * `nullptr` to generate every path on the brain, which is the default.
+   *
+   * @param icoprocessor The coprocessor, or `nullptr`.
+   */
+  void setCoprocessor(const std::shared_ptr<CoprocessorClient> &icoprocessor);
+
+  /**
+   * Sets how to interpolate between the points of a path while following it. This only affects
+   * decimated paths and command periods shorter than the profile timestep (see
+   * `setCommandPeriod()`). The default is linear.
+   *
+   * @param iinterpolation How to interpolate between points.
+   */
+  void setProfileInterpolation(ProfileInterpolation iinterpolation);
+
+  /**
+   * Sets how often the motors are commanded while following a path, independently of the timestep
+   * paths are generated with (10 ms). Between profile points, the commands are interpolated (see
+   * `setProfileInterpolation()`), so a shorter period gives smoother tracking without generating or
+   * storing more points. V5 motors accept a new command every 5 ms. Profiles without timestamps and
+   * static paths are always followed every 10 ms.
+   *
+   * @param iperiod The time between motor commands. The default is 10 ms.
+   */
+  void setCommandPeriod(const QTime &iperiod);
+
+  /**
+   * Enables closed-loop path following. While following a generated path, each profile point is
+   * corrected with a Ramsete controller using the robot pose from the odometry. The odometry is
+   * only read by this controller, so something else (typically an `OdomChassisController`) must
+   * step it. Static paths do not store poses, so they are always followed open-loop. Pass `nullptr`
+   * to go back to open-loop path following.
+   *
+   * @param iodometry The odometry to read the robot pose from.
+   * @param ib The Ramsete convergence gain in rad^2/m^2. Larger values correct errors more
+   * aggressively.
+   * @param izeta The Ramsete damping gain in [0, 1].
+   */
+  void setOdometry(const std::shared_ptr<Odometry> &iodometry,
+                   double ib = 2.0,
+                   double izeta = 0.7);
+
+  /**
+   * Corrects each profile point with a model predictive controller (see `DiffDriveMpc`) instead of
+   * Ramsete while following a generated path with odometry (see `setOdometry()`). It predicts the
+   * pose error over a short horizon and never asks a wheel for more than its max velocity, so it
+   * can keep a profile planned close to the limits of the chassis on track. Without odometry,
+   * paths are still followed open-loop.
+   *
+   * Throws a `std::invalid_argument` if the parameters are invalid (see `DiffDriveMpc`).
+   *
+   * @param iparams The weights and solver settings.
+   */
+  void setModelPredictiveControl(const DiffDriveMpcParams &iparams = {});
+
+  /**
+   * Goes back to correcting profile points with Ramsete.
+   */
+  void clearModelPredictiveControl();
+
+  /**
+   * Drives the wheels with voltages from a feedforward model of the chassis instead of velocity
+   * commands. Each wheel gets `kS * sgn(v) + kV * v + kA * a` for its velocity `v` and acceleration
+   * `a` along the path, as a fraction of the max voltage of the chassis model. With odometry (see
+   * `setOdometry()`), `v` is the velocity corrected by the Ramsete controller, so the feedback
+   * only has to correct what the feedforward misses. Pass a feedforward with all gains at zero to
+   * go back to velocity commands.
+   *
+   * @param ifeedforward The feedforward, with gains per m/s and per m/s^2.
+   */
+  void setFeedforward(const MotorFeedforward &ifeedforward);
+
+  /**
+   * @return The feedforward set with `setFeedforward()`.
+   */
+  MotorFeedforward getFeedforward() const;
+
+  /**
+   * Records the velocities this controller commands next to what the motors and odometry measure
+   * at every step of every path, and writes each path's samples to a file after it is done. Use
+   * this while tuning to see how closely the robot follows a path. A sequence of paths (see
+   * `setTargetSequence()`) is recorded as one path named after its first path, so writing the file
+   * never delays the next path. Pass `nullptr` to stop recording. The recorder takes effect from
+   * the next path.
+   *
+   * @param irecorder The recorder.
+   */
+  void setTrackingRecorder(const std::shared_ptr<PathTrackingRecorder> &irecorder);
+
   /**
    * Returns whether the controller has settled at the target. Determining what settling means is
    * implementation-dependent.
@@ -229,8 +828,12 @@ class AsyncMotionProfileController : public AsyncPositionController<std::string,
   /**
    * Starts the internal thread. This should not be called by normal users. This method is called
    * by the `AsyncMotionProfileControllerBuilder` when making a new instance of this class.
+   *
+   * @param ipriority The priority of the task.
+   * @param istackDepth The stack depth of the task in words.
    */
-  void startThread();
+  void startThread(std::uint32_t ipriority = TASK_PRIORITY_DEFAULT,
+                   std::uint16_t istackDepth = TASK_STACK_DEPTH_DEFAULT);
 
   /**
    * @return The underlying thread handle.
@@ -248,50 +851,492 @@ class AsyncMotionProfileController : public AsyncPositionController<std::string,
   void storePath(const std::string &idirectory, const std::string &ipathId);
 
   /**
-   * Loads a path from a directory on the SD card containing a path CSV file. `/usd/` is
-   * automatically prepended to `idirectory` if it is not specified.
+   * Saves a generated path to a file in the compact binary format described by
+   * `PathBinaryFormat`. Paths are stored as `<ipathId>.bin`, which `loadPath()` prefers over CSV
+   * files because it loads much faster. An SD card must be inserted into the brain and the
+   * directory must exist. `idirectory` can be prefixed with `/usd/`, but it this is not required.
+   *
+   * @param idirectory The directory to store the path file in
+   * @param ipathId The path ID of the generated path
+   * @param icompact Whether to store the path in the compact version of the format, which is about
+   * a quarter of the size and rounds values to `PathBinaryFormat::compactResolution`. Both versions
+   * are loaded the same way.
+   */
+  void storeBinaryPath(const std::string &idirectory,
+                       const std::string &ipathId,
+                       bool icompact = false);
+
+  /**
+   * Loads a path from a directory on the SD card containing a path file. A binary path file
+   * (`<ipathId>.bin`) is used if there is one, then a CSV file, then a pair of Pathfinder files.
+   * `/usd/` is automatically prepended to `idirectory` if it is not specified.
    *
    * @param idirectory The directory that the path files are stored in
    * @param ipathId The path ID that the paths are stored under (and will be loaded into)
+   * @return The handle of the path, or an invalid handle if no path could be loaded.
+   */
+  PathHandle loadPath(const std::string &idirectory, const std::string &ipathId);
+
+  /**
+   * Loads every path in the path library of a directory on the SD card (`paths.lib`, see
+   * `PathBinaryFormat` and the `pathCompiler` tool) with one file open, instead of probing for the
+   * files of each path like `loadPath()`. Any existing paths with the same IDs are replaced.
+   * Library paths can't be reloaded one at a time, so they are never evicted (see
+   * `setPathCacheBudget()`). `/usd/` is automatically prepended to `idirectory` if it is not
+   * specified.
+   *
+   * @param idirectory The directory that the path library is stored in
+   * @return The number of paths loaded. If the library is truncated, the paths before the damage
+   * are still loaded.
    */
-  void loadPath(const std::string &idirectory, const std::string &ipathId);
+  std::size_t loadPathLibrary(const std::string &idirectory);
 
   /**
-   * Attempts to remove a path without stopping execution. If that fails, disables the controller
-   * and removes the path.
+   * Queues `loadPathLibrary()` on the low-priority background task that generates paths, so the
+   * library can be loaded during `initialize()` without delaying it. Setting a target while a
+   * library is loading blocks until it is loaded.
+   *
+   * @param idirectory The directory that the path library is stored in
+   * @return A handle to check on the status of the library. Its path ID is the file path of the
+   * library, and it fails if no paths were loaded.
+   */
+  PathGenerationHandle loadPathLibraryAsync(const std::string &idirectory);
+
+  /**
+   * Registers a binary path file (`<ipathId>.bin`, see `storeBinaryPath()`) which is streamed from
+   * the SD card each time it is followed instead of being loaded into memory. The path starts
+   * moving the chassis as soon as its first points are read, while the rest of the file is read in
+   * the background, so the time before the chassis starts moving does not depend on the length of
+   * the path. The file is not opened until the path is followed. Any existing path with the same
+   * ID is replaced. `/usd/` is automatically prepended to `idirectory` if it is not specified.
+   *
+   * @param idirectory The directory that the path file is stored in
+   * @param ipathId The path ID that the path is stored under (and will be followed with)
+   */
+  void registerStreamedPath(const std::string &idirectory, const std::string &ipathId);
+
+  /**
+   * Removes a path without stopping execution. Removing a path never fails because running paths
+   * are shared with the controller task, so this is equivalent to `removePath()`.
    *
    * @param ipathId The path ID that will be removed
    */
   void forceRemovePath(const std::string &ipathId);
 
   protected:
+  struct PathGenerationJob {
+    std::vector<PathfinderPoint> waypoints;
+    std::string pathId;
+    PathfinderLimits limits;
+    std::shared_ptr<std::atomic<PathGenerationStatus>> status;
+    // Replanned profiles are handed to the controller task instead of being saved
+    bool isReplan{false};
+    QSpeed startVelocity{0_mps};
+    std::uint64_t followId{0};
+    std::size_t step{0};
+    // Library jobs load the path library in the directory given as the path ID instead
+    bool isLibrary{false};
+  };
+
+  /**
+   * What `replan()` needs to know about the path being followed. Guarded by feedbackMutex.
+   */
+  struct ReplanContext {
+    // Counts the paths followed, so a new profile only replaces the path it was planned for
+    std::uint64_t followId{0};
+    // Whether a generated path, which can be replanned, is being followed
+    bool active{false};
+    // Whether the pose and velocity below have been measured for the path being followed
+    bool hasPose{false};
+    // The pose of the robot, in the frame the path was generated in
+    squiggles::Pose robotPose{0, 0, 0};
+    // The last point of the path
+    squiggles::Pose goal{0, 0, 0};
+    // The speed along the path in m/s, without the speed scale
+    double velocity{0};
+    // The points commanded since the path started
+    std::size_t step{0};
+  };
+
+  struct PathView {
+    std::string basePathId;
+    bool backwards;
+    bool mirrored;
+    double speedScale;
+  };
+
+  struct CachedPath {
+    std::list<std::string>::iterator lruPosition;
+    std::size_t bytes;
+  };
+
   std::shared_ptr<Logger> logger;
-  std::map<std::string, std::vector<squiggles::ProfilePoint>> paths{};
+  std::shared_ptr<PathPool> pathPool{std::make_shared<PathPool>()};
+  std::map<std::string, std::shared_ptr<const std::vector<squiggles::ProfilePoint>>> paths{};
+  // The interned path IDs, indexed by handle. IDs are never removed, so references to them stay
+  // valid.
+  std::deque<std::string> pathNames{};
+  std::map<std::string, PathHandle> pathHandles{};
+  // The generated paths indexed by handle, so the controller task finds them without a string
+  // lookup. This mirrors paths.
+  std::vector<std::shared_ptr<const std::vector<squiggles::ProfilePoint>>> pathTable{};
+  std::map<std::string, std::pair<const StaticProfilePoint *, std::size_t>> staticPaths{};
+  std::map<std::string, PathView> pathViews{};
+
+  // The paths in memory ordered by when they were last used, most recent first
+  std::list<std::string> pathLru{};
+  std::map<std::string, CachedPath> pathCacheEntries{};
+  // The directories paths can be reloaded from if they are evicted
+  std::map<std::string, std::string> pathSources{};
+  // The directories of the paths which are streamed from the SD card
+  std::map<std::string, std::string> streamedPaths{};
+  PathCacheStats pathCacheStats{};
+
+  // How generated paths are decimated, guarded by currentPathMutex
+  std::size_t decimationStride{1};
+  double decimationCurvatureChange{std::numeric_limits<double>::infinity()};
+  // How generated paths are retimed, guarded by currentPathMutex
+  std::optional<ProfileRetimer> profileRetimer{};
+  // The centripetal acceleration limit of generated paths in m/s^2, guarded by currentPathMutex
+  double maxCentripetalAccel{std::numeric_limits<double>::infinity()};
+  // Where paths are generated, guarded by currentPathMutex
+  std::shared_ptr<CoprocessorClient> coprocessor{nullptr};
+  // The segments of the paths generated by generatePathIncremental(), guarded by currentPathMutex
+  std::map<std::string, std::shared_ptr<IncrementalPathGenerator>> incrementalGenerators{};
+  std::atomic<ProfileInterpolation> profileInterpolation{ProfileInterpolation::linear};
+  // The time between motor commands in seconds
+  std::atomic<double> commandPeriod{DT};
+
+  // The ID moveTo() follows its profiles under. Interned IDs are never removed, so every moveTo()
+  // reuses the same one instead of adding an ID per call.
+  static constexpr const char *moveToPathId = "__moveTo";
+  // The profiles most recently generated by moveTo(), most recent first, keyed on the waypoints,
+  // the limits, and the wheel track. Guarded by currentPathMutex.
+  static constexpr std::size_t moveToProfileCapacity = 8;
+  std::deque<std::pair<std::vector<double>,
+                       std::shared_ptr<const std::vector<squiggles::ProfilePoint>>>>
+    moveToProfiles{};
+  // The key of the last moveTo() lookup, kept so a lookup which hits does not allocate. Guarded by
+  // currentPathMutex.
+  std::vector<double> moveToKey{};
+
   PathfinderLimits limits;
   std::shared_ptr<ChassisModel> model;
   ChassisScales scales;
   AbstractMotor::GearsetRatioPair pair;
+  // The normalized motor command for a wheel velocity of 1 m/s. The scales and gearset can't
+  // change after construction, so this is computed once instead of on every segment.
+  double motorCommandPerMps{0};
   TimeUtil timeUtil;
+  // Made once so following a path does not allocate. Only the controller task uses it.
+  std::unique_ptr<AbstractRate> pathRate;
+
+  // This must be locked when accessing the odometry, the Ramsete gains, the model predictive
+  // controller, the feedforward, or the last error
+  mutable CrossplatformMutex feedbackMutex;
+  std::shared_ptr<Odometry> odometry{nullptr};
+  double ramseteB{2.0};
+  double ramseteZeta{0.7};
+  // Replaces Ramsete when set. Only the controller task steps it.
+  std::shared_ptr<DiffDriveMpc> mpc{nullptr};
+  MotorFeedforward feedforward{};
+  PathfinderPoint lastError{0_m, 0_m, 0_deg};
+  // The feedforward of the path being followed. Only used by the controller task.
+  MotorFeedforward activeFeedforward{};
+  std::shared_ptr<PathTrackingRecorder> trackingRecorder{nullptr};
+  // The recorder of the path being followed. Only used by the controller task.
+  std::shared_ptr<PathTrackingRecorder> activeTrackingRecorder{nullptr};
+  ReplanContext replanContext{};
+  // A replanned profile waiting for the controller task, with the context it was planned from
+  std::shared_ptr<const std::vector<squiggles::ProfilePoint>> replannedPath{nullptr};
+  std::uint64_t replannedFollowId{0};
+  std::size_t replannedStep{0};
+  // Set when replannedPath is ready, so the controller task only locks to take it
+  std::atomic_bool replanReady{false};
 
-  // This must be locked when accessing the current path
-  CrossplatformMutex currentPathMutex;
+  // This must be locked when accessing the path maps or the path cache. Paths themselves are
+  // immutable and shared, so the controller task does not need to hold it while following a path.
+  mutable CrossplatformMutex currentPathMutex;
 
-  std::string currentPath{""};
+  std::atomic<PathHandle> currentPath{PathHandle()};
+  // The paths to follow after the current one, guarded by currentPathMutex
+  std::deque<PathHandle> queuedPaths{};
   std::atomic_bool isRunning{false};
   std::atomic_int direction{1};
   std::atomic_bool mirrored{false};
+  std::atomic<double> speedScale{1.0};
+  // The transforms of the path being followed, including those of any path views
+  std::atomic_int activeDirection{1};
+  std::atomic_bool activeMirrored{false};
+  std::atomic<double> activeSpeedScale{1.0};
   std::atomic_bool disabled{false};
   std::atomic_bool dtorCalled{false};
+  // Notified when the controller settles, so waiting tasks don't need to poll
+  CrossplatformEvent settledEvent;
   CrossplatformThread *task{nullptr};
 
+  // This must be locked when accessing the generation queue or the pending paths
+  CrossplatformMutex generationMutex;
+  std::deque<PathGenerationJob> generationQueue{};
+  std::map<std::string, std::shared_ptr<std::atomic<PathGenerationStatus>>> pendingPaths{};
+  // The number of path libraries queued or being loaded by the generator task
+  std::size_t pendingLibraries{0};
+  CrossplatformThread *generatorTask{nullptr};
+  // Notified when a job is queued or finished, so neither the generator task nor waitForPath()
+  // needs to poll
+  CrossplatformEvent generationEvent;
+
+  /**
+   * The longest time in milliseconds the idle controller task sleeps before checking whether it
+   * should stop. `setTarget()` wakes the task immediately.
+   */
+  static constexpr std::uint32_t idleLoopTimeout = 100;
+
   static void trampoline(void *context);
   void loop();
 
+  /**
+   * Wakes the controller task so it starts following a new target.
+   */
+  void wakeTask();
+
+  /**
+   * Follows the generated or static path with the given handle if it exists.
+   *
+   * @return Whether the path existed.
+   */
+  bool executePath(PathHandle ipath);
+
+  /**
+   * Gets the handle of a path ID, interning the ID if it has none yet. currentPathMutex must be
+   * locked.
+   */
+  PathHandle internPath(const std::string &ipathId);
+
+  /**
+   * Removes a generated path from the path maps. currentPathMutex must be locked.
+   */
+  void erasePathData(const std::string &ipathId);
+
+  /**
+   * The most path views which are followed to find a base path, which stops cycles of views.
+   */
+  static constexpr std::size_t maxPathViewDepth = 8;
+
+  /**
+   * Waits for the path, and the base paths of a path view, to finish generating in the
+   * background.
+   */
+  void waitForTargetPath(const std::string &ipathId);
+
+  /**
+   * Removes the next path from the queue and makes it the current path.
+   *
+   * @return Whether there was a next path to follow.
+   */
+  bool advanceToQueuedPath();
+
+  static void generatorTrampoline(void *context);
+  void generatorLoop();
+
+  /**
+   * @return Whether the path is queued or being generated by the generator task, or a path library
+   * which might contain it is being loaded.
+   */
+  bool isPathPending(const std::string &ipathId);
+
+  /**
+   * Starts the generator task if it is not running. generationMutex must be locked.
+   */
+  void startGeneratorTask();
+
+  /**
+   * Generates a profile through the waypoints. This does not modify any controller state, so it
+   * is safe to call from the generator task.
+   *
+   * @param iwaypoints The waypoints to hit on the path.
+   * @param ilimits The limits to use for the path.
+   * @param istartVelocity The linear velocity at the start of the path.
+   * @param iendVelocity The linear velocity at the end of the path.
+   * @return The generated profile.
+   */
+  std::vector<squiggles::ProfilePoint>
+  generateProfile(const std::vector<PathfinderPoint> &iwaypoints,
+                  const PathfinderLimits &ilimits,
+                  QSpeed istartVelocity = 0_mps,
+                  QSpeed iendVelocity = 0_mps) const;
+
+  /**
+   * Retimes, limits, and decimates a generated profile as configured with `setProfileRetimer()`,
+   * `setMaxCentripetalAcceleration()`, and `setProfileDecimation()`. This does not modify any
+   * controller state.
+   *
+   * @param ipath The generated profile.
+   * @param ilimits The limits the profile was generated with.
+   * @return The profile to save.
+   */
+  std::vector<squiggles::ProfilePoint>
+  postProcessProfile(std::vector<squiggles::ProfilePoint> ipath,
+                     const PathfinderLimits &ilimits) const;
+
+  /**
+   * Saves a generated profile under the path ID, replacing any existing path with that ID.
+   */
+  void insertPath(const std::string &ipathId, std::vector<squiggles::ProfilePoint> ipath);
+
+  /**
+   * Saves a shared profile under the path ID, replacing any existing path with that ID.
+   */
+  void insertPath(const std::string &ipathId,
+                  std::shared_ptr<const std::vector<squiggles::ProfilePoint>> ipath);
+
+  /**
+   * Returns the profile through the waypoints for `moveTo()`, reusing a recently generated one if
+   * the waypoints, limits, and wheel track match.
+   */
+  std::shared_ptr<const std::vector<squiggles::ProfilePoint>>
+  getMoveToProfile(const std::vector<PathfinderPoint> &iwaypoints,
+                   const PathfinderLimits &ilimits);
+
+  /**
+   * Records that the path can be reloaded from the directory if it is evicted.
+   */
+  void setPathSource(const std::string &ipathId, const std::string &idirectory);
+
+  /**
+   * Reloads an evicted path. The default implementation calls `loadPath()`.
+   */
+  virtual void reloadPath(const std::string &idirectory, const std::string &ipathId);
+
+  /**
+   * Marks the path as the most recently used and updates its size. `currentPathMutex` must be
+   * held.
+   */
+  void touchCachedPath(const std::string &ipathId, std::size_t ibytes);
+
+  /**
+   * Forgets the cache entry for the path. `currentPathMutex` must be held.
+   */
+  void forgetCachedPath(const std::string &ipathId);
+
+  /**
+   * Evicts the least recently used reloadable paths, other than `ikeepId`, until the paths in
+   * memory fit in the budget. `currentPathMutex` must be held.
+   */
+  void evictCachedPaths(const std::string &ikeepId);
+
+  /**
+   * @return The approximate memory used by the path.
+   */
+  static std::size_t estimatePathBytes(const std::vector<squiggles::ProfilePoint> &ipath);
+
   /**
    * Follow the supplied path. Must follow the disabled lifecycle.
    */
   virtual void executeSinglePath(const std::vector<squiggles::ProfilePoint> &path,
-                                 std::unique_ptr<AbstractRate> rate);
+                                 AbstractRate &rate);
+
+  /**
+   * Opens the binary file of a streamed path. The default implementation opens
+   * `<idirectory>/<ipathId>.bin` on the SD card.
+   */
+  virtual std::unique_ptr<std::istream> openStreamedPath(const std::string &idirectory,
+                                                         const std::string &ipathId);
+
+  /**
+   * Opens the path library of a directory. The default implementation opens
+   * `<idirectory>/paths.lib` on the SD card.
+   */
+  virtual std::unique_ptr<std::istream> openPathLibrary(const std::string &idirectory);
+
+  /**
+   * Follow the path as it is read from the stream. Must follow the disabled lifecycle.
+   */
+  virtual void executeStreamedPath(PathStreamReader &ireader, AbstractRate &rate);
+
+  /**
+   * Commands the chassis to follow profile points, open-loop or with Ramsete feedback, using the
+   * direction, mirroring, and speed scale of the current path. Stops when `inextPoint` returns
+   * false or the controller is disabled.
+   *
+   * @param inextPoint Writes the next point to command and returns whether there was one.
+   * @param isegmentTime The time between points.
+   * @param rate The rate to wait between points with.
+   */
+  void followProfile(const std::function<bool(squiggles::ProfilePoint &)> &inextPoint,
+                     const QTime &isegmentTime,
+                     AbstractRate &rate);
+
+  /**
+   * Follow the supplied static path. Must follow the disabled lifecycle.
+   */
+  virtual void executeStaticPath(const StaticProfilePoint *ipoints,
+                                 std::size_t icount,
+                                 AbstractRate &rate);
+
+  /**
+   * Commands the chassis to follow the given wheel velocities, accounting for the direction and
+   * mirroring of the current path. With a feedforward (see `setFeedforward()`), the wheels are
+   * driven with the feedforward voltage instead.
+   *
+   * @param ileftVelocity The left wheel velocity in m/s.
+   * @param irightVelocity The right wheel velocity in m/s.
+   * @param ireversed The direction sign of the current path.
+   * @param imirrored Whether the current path is mirrored.
+   * @param ileftAcceleration The left wheel acceleration in m/s^2.
+   * @param irightAcceleration The right wheel acceleration in m/s^2.
+   */
+  void setWheelVelocities(double ileftVelocity,
+                          double irightVelocity,
+                          int ireversed,
+                          bool imirrored,
+                          double ileftAcceleration = 0,
+                          double irightAcceleration = 0);
+
+  /**
+   * Computes the Ramsete correction for one profile point. All poses are in the frame the path
+   * started in, with +x forward and counter-clockwise positive angles.
+   *
+   * @param idesired The pose the profile wants the robot to be at.
+   * @param idesiredVel The linear velocity of the profile in m/s.
+   * @param idesiredAngularVel The angular velocity of the profile in rad/s.
+   * @param iactual The pose of the robot.
+   * @param ib The Ramsete convergence gain.
+   * @param izeta The Ramsete damping gain.
+   * @return The corrected linear (m/s) and angular (rad/s) velocities.
+   */
+  static std::pair<double, double> computeRamseteVelocities(const squiggles::Pose &idesired,
+                                                            double idesiredVel,
+                                                            double idesiredAngularVel,
+                                                            const squiggles::Pose &iactual,
+                                                            double ib,
+                                                            double izeta);
+
+  /**
+   * @return `ipose` expressed in the frame of `iorigin`.
+   */
+  static squiggles::Pose relativePose(const squiggles::Pose &iorigin, const squiggles::Pose &ipose);
+
+  /**
+   * The inverse of `relativePose()`.
+   *
+   * @return `irelative`, which is expressed in the frame of `iorigin`, in the frame `iorigin` is
+   * expressed in.
+   */
+  static squiggles::Pose absolutePose(const squiggles::Pose &iorigin,
+                                      const squiggles::Pose &irelative);
+
+  /**
+   * Converts a pose in the frame squiggles generates paths in into a waypoint, the inverse of how
+   * `generatePath()` converts waypoints.
+   */
+  static PathfinderPoint poseToWaypoint(const squiggles::Pose &ipose);
+
+  /**
+   * Converts an odometry state in `StateMode::FRAME_TRANSFORMATION` into the frame squiggles
+   * generates paths in.
+   */
+  static squiggles::Pose odomStateToPose(const OdomState &istate);
 
   /**
    * Converts linear chassis speed to rotational motor speed.
@@ -315,12 +1360,23 @@ class AsyncMotionProfileController : public AsyncPositionController<std::string,
    */
   static std::string makeFilePath(const std::string &directory, const std::string &filename);
 
+  /**
+   * @return A reference to the generated path with the given ID, or `nullptr` if there is none.
+   */
+  std::shared_ptr<const std::vector<squiggles::ProfilePoint>>
+  getPathData(const std::string &ipathId);
+
   void internalStorePath(std::ostream &file, const std::string &ipathId);
   void internalLoadPath(std::istream &file, const std::string &ipathId);
+  bool internalStoreBinaryPath(std::ostream &file,
+                               const std::string &ipathId,
+                               bool icompact = false);
+  bool internalLoadBinaryPath(std::istream &file, const std::string &ipathId);
+  std::size_t internalLoadPathLibrary(std::istream &file, const std::string &idirectory);
   void internalLoadPathfinderPath(std::istream &leftFile,
                                   std::istream &rightFile,
                                   const std::string &ipathId);
 
-  static constexpr double DT = 0.01;
+  static constexpr double DT = ProfileGenerator::DT;
 };
 } // namespace okapi
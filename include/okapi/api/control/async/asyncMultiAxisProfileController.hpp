@@ -0,0 +1,278 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#pragma once
+
+#include "okapi/api/control/async/asyncPositionController.hpp"
+#include "okapi/api/control/controllerOutput.hpp"
+#include "okapi/api/control/util/pathfinderUtil.hpp"
+#include "okapi/api/control/util/trapezoidProfile.hpp"
+#include "okapi/api/device/motor/abstractMotor.hpp"
+#include "okapi/api/units/QLength.hpp"
+#include "okapi/api/util/logging.hpp"
+#include "okapi/api/util/timeUtil.hpp"
+#include <atomic>
+#include <map>
+#include <vector>
+
+namespace okapi {
+class AsyncMultiAxisProfileController
+  : public AsyncPositionController<std::string, std::vector<QLength>> {
+  public:
+  /**
+   * One mechanism the controller moves, such as the drive, a lift, or an intake.
+   */
+  struct Axis {
+    // The output to write velocity targets to
+    std::shared_ptr<ControllerOutput<double>> output;
+    // The effective diameter for whatever the motor spins
+    QLength diameter;
+    AbstractMotor::GearsetRatioPair pair;
+    // The limits of this mechanism. The jerk is not used.
+    PathfinderLimits limits;
+  };
+
+  /**
+   * An Async Controller which moves several mechanisms at once so they all start and arrive at
+   * the same moment. Each path moves every axis a distance. The axis which needs the longest to
+   * move its distance sets the pace, and the others are slowed down to match, so every axis
+   * follows the same trapezoidal profile scaled by its distance and stays within its own limits.
+   * Every axis is written from the one controller task in the same step, and the profiles are
+   * followed open-loop, like `AsyncLinearMotionProfileController`.
+   *
+   * Throws a `std::invalid_argument` if there are no axes, or if an axis has a gear ratio of zero
+   * or limits which are not positive.
+   *
+   * @param itimeUtil The TimeUtil.
+   * @param iaxes The mechanisms to move, in the order distances are given in.
+   * @param ilogger The logger this instance will log to.
+   */
+  AsyncMultiAxisProfileController(
+    const TimeUtil &itimeUtil,
+    std::vector<Axis> iaxes,
+    const std::shared_ptr<Logger> &ilogger = Logger::getDefaultLogger());
+
+  AsyncMultiAxisProfileController(AsyncMultiAxisProfileController &&other) = delete;
+
+  AsyncMultiAxisProfileController &operator=(AsyncMultiAxisProfileController &&other) = delete;
+
+  ~AsyncMultiAxisProfileController() override;
+
+  /**
+   * Generates a path which moves each axis the given distance from wherever it is when the path
+   * starts, and saves it internally with a key of pathId. Call `setTarget()` with the same
+   * `pathId` to run it. Throws a `std::invalid_argument` if there is not one distance per axis. If
+   * every distance is zero, no path is generated.
+   *
+   * @param idistances The distance to move each axis. Negative distances move backwards.
+   * @param ipathId A unique identifier to save the path with.
+   */
+  void generatePath(const std::vector<QLength> &idistances, const std::string &ipathId);
+
+  /**
+   * Removes a path and frees the memory it used. A path which is currently running is shared with
+   * the controller task, so it keeps running and its memory is freed when it finishes.
+   *
+   * @param ipathId A unique identifier for the path, previously passed to `generatePath()`
+   * @return `true` if the path no longer exists
+   */
+  bool removePath(const std::string &ipathId);
+
+  /**
+   * Gets the identifiers of all paths saved in this `AsyncMultiAxisProfileController`.
+   *
+   * @return The identifiers of all paths
+   */
+  std::vector<std::string> getPaths();
+
+  /**
+   * Executes a path with the given ID. If there is no path matching the ID, the method will
+   * return. Any targets set while a path is being followed will be ignored.
+   *
+   * @param ipathId A unique identifier for the path, previously passed to `generatePath()`.
+   */
+  void setTarget(std::string ipathId) override;
+
+  /**
+   * Writes the value of the controller output. This method might be automatically called in another
+   * thread by the controller.
+   *
+   * This just calls `setTarget()`.
+   */
+  void controllerSet(std::string ivalue) override;
+
+  /**
+   * Gets the last set target, or the default target if none was set.
+   *
+   * @return the last target
+   */
+  std::string getTarget() override;
+
+  /**
+   * This is overridden to return the current path.
+   *
+   * @return The most recent value of the process variable.
+   */
+  std::string getProcessValue() const override;
+
+  /**
+   * Blocks the current task until the controller has settled. This controller is settled when
+   * it has finished following a path. If no path is being followed, it is settled.
+   */
+  void waitUntilSettled() override;
+
+  /**
+   * Generates a new path which moves each axis the given distance and blocks until the controller
+   * has settled. Does not save the path which was generated.
+   *
+   * @param idistances The distance to move each axis.
+   */
+  void moveTo(const std::vector<QLength> &idistances);
+
+  /**
+   * Returns how far each axis still has to move along the current path, assuming it follows the
+   * profile exactly. Returns zeros if there is no path currently being followed.
+   *
+   * @return the last error
+   */
+  std::vector<QLength> getError() const override;
+
+  /**
+   * Returns whether the controller has settled at the target. Determining what settling means is
+   * implementation-dependent.
+   *
+   * If the controller is disabled, this method must return `true`.
+   *
+   * @return whether the controller is settled
+   */
+  bool isSettled() override;
+
+  /**
+   * Resets the controller's internal state so it is similar to when it was first initialized, while
+   * keeping any user-configured information. This implementation also stops movement.
+   */
+  void reset() override;
+
+  /**
+   * Changes whether the controller is off or on. Turning the controller on after it was off will
+   * NOT cause the controller to move to its last set target.
+   */
+  void flipDisable() override;
+
+  /**
+   * Sets whether the controller is off or on. Turning the controller on after it was off will
+   * NOT cause the controller to move to its last set target, unless it was reset in that time.
+   *
+   * @param iisDisabled whether the controller is disabled
+   */
+  void flipDisable(bool iisDisabled) override;
+
+  /**
+   * Returns whether the controller is currently disabled.
+   *
+   * @return whether the controller is currently disabled
+   */
+  bool isDisabled() const override;
+
+  /**
+   * This implementation does nothing because the paths are relative to where they start.
+   */
+  void tarePosition() override;
+
+  /**
+   * This implementation does nothing because the maximum velocity of each axis is configured
+   * using its PathfinderLimits.
+   *
+   * @param imaxVelocity Ignored.
+   */
+  void setMaxVelocity(std::int32_t imaxVelocity) override;
+
+  /**
+   * Starts the internal thread. This should not be called by normal users.
+   *
+   * @param ipriority The priority of the task.
+   * @param istackDepth The stack depth of the task in words.
+   */
+  void startThread(std::uint32_t ipriority = TASK_PRIORITY_DEFAULT,
+                   std::uint16_t istackDepth = TASK_STACK_DEPTH_DEFAULT);
+
+  /**
+   * Returns the underlying thread handle.
+   *
+   * @return The underlying thread handle.
+   */
+  CrossplatformThread *getThread() const;
+
+  protected:
+  /**
+   * A move of every axis at once. Every axis is at the same fraction of its distance at all times.
+   */
+  struct Path {
+    std::vector<QLength> distances;
+    // Runs from zero to one, the fraction of each distance moved
+    TrapezoidProfile progress;
+  };
+
+  std::shared_ptr<Logger> logger;
+  std::vector<Axis> axes;
+  // The normalized motor command of each axis for a velocity of 1 m/s, computed once instead of on
+  // every step
+  std::vector<double> motorCommandPerMps{};
+  std::map<std::string, std::shared_ptr<const Path>> paths{};
+  TimeUtil timeUtil;
+  // Made once so following a path does not allocate. Only the controller task uses it.
+  std::unique_ptr<AbstractRate> pathRate;
+
+  // This must be locked when accessing the path map or the current path. Paths themselves are
+  // immutable and shared, so the controller task does not need to hold it while following a path.
+  mutable CrossplatformMutex currentPathMutex;
+
+  std::string currentPath{""};
+  // The fraction of the current path which has been followed
+  std::atomic<double> currentProgress{0};
+  std::atomic_bool isRunning{false};
+  std::atomic_bool disabled{false};
+  std::atomic_bool dtorCalled{false};
+  // Notified when the controller settles, so waiting tasks don't need to poll
+  CrossplatformEvent settledEvent;
+  CrossplatformThread *task{nullptr};
+
+  /**
+   * The time between velocity setpoints.
+   */
+  static constexpr QTime profilePeriod = 10_ms; // NOLINT
+
+  /**
+   * The longest time in milliseconds the idle controller task sleeps before checking whether it
+   * should stop. `setTarget()` wakes the task immediately.
+   */
+  static constexpr std::uint32_t idleLoopTimeout = 100;
+
+  static void trampoline(void *context);
+  void loop();
+
+  /**
+   * Wakes the controller task so it starts following a new target.
+   */
+  void wakeTask();
+
+  /**
+   * Follows the path with the given ID if it exists.
+   *
+   * @return Whether the path existed.
+   */
+  bool executePath(const std::string &ipathId);
+
+  /**
+   * Follow the supplied path. Must follow the disabled lifecycle.
+   */
+  virtual void executeSinglePath(const Path &path, AbstractRate &rate);
+
+  /**
+   * Stops every axis.
+   */
+  void stopAxes();
+};
+} // namespace okapi
@@ -6,6 +6,7 @@
 #pragma once
 
 #include "okapi/api/control/async/asyncPositionController.hpp"
+#include "okapi/api/control/util/integratedSettleTracker.hpp"
 #include "okapi/api/device/motor/abstractMotor.hpp"
 #include "okapi/api/util/logging.hpp"
 #include "okapi/api/util/timeUtil.hpp"
@@ -57,8 +58,9 @@ class AsyncPosIntegratedController : public AsyncPositionController<double, doub
   double getError() const override;
 
   /**
-   * Returns whether the controller has settled at the target. Determining what settling means is
-   * implementation-dependent.
+   * Returns whether the controller has settled at the target. Once updateSettled() has been called,
+   * this returns what it last found without reading the motor. Until then, the controller is
+   * settled once the error has stayed small for a while.
    *
    * If the controller is disabled, this method must return true.
    *
@@ -66,6 +68,14 @@ class AsyncPosIntegratedController : public AsyncPositionController<double, doub
    */
   bool isSettled() override;
 
+  /**
+   * Reads the motor once and updates whether the movement is done: the position must be within
+   * tolerance and the motor must have stopped. Wakes the tasks in waitUntilSettled() when it is.
+   * Call this once per tick from one task, such as the task which refreshes the motor's snapshot,
+   * so the motor is read once per tick no matter how many tasks wait on the controller.
+   */
+  virtual void updateSettled();
+
   /**
    * Resets the controller's internal state so it is similar to when it was first initialized, while
    * keeping any user-configured information.
@@ -94,8 +104,8 @@ class AsyncPosIntegratedController : public AsyncPositionController<double, doub
   bool isDisabled() const override;
 
   /**
-   * Blocks the current task until the controller has settled. Determining what settling means is
-   * implementation-dependent.
+   * Blocks the current task until the controller has settled. Once updateSettled() has been
+   * called, this waits to be woken by it instead of polling the motor.
    */
   void waitUntilSettled() override;
 
@@ -119,6 +129,14 @@ class AsyncPosIntegratedController : public AsyncPositionController<double, doub
    */
   void setMaxVelocity(std::int32_t imaxVelocity) override;
 
+  /**
+   * Changes the max velocity of the movement in progress, in motor RPM [0-600]. Later targets still
+   * move at the max velocity. Does nothing while the controller is disabled.
+   *
+   * @param ivelocity The new velocity of the movement in motor RPM [0-600].
+   */
+  virtual void modifyProfiledVelocity(std::int32_t ivelocity);
+
   /**
    * Stops the motor mid-movement. Does not change the last set target.
    */
@@ -135,6 +153,9 @@ class AsyncPosIntegratedController : public AsyncPositionController<double, doub
   bool controllerIsDisabled{false};
   bool hasFirstTarget{false};
   std::unique_ptr<SettledUtil> settledUtil;
+  IntegratedSettleTracker settleTracker;
+  // Made once so waitUntilSettled does not allocate
+  std::unique_ptr<AbstractRate> waitRate;
 
   /**
    * Resumes moving after the controller is reset. Should not cause movement if the controller is
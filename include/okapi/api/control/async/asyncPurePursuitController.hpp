@@ -0,0 +1,333 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#pragma once
+
+#include "okapi/api/chassis/controller/chassisScales.hpp"
+#include "okapi/api/chassis/model/chassisModel.hpp"
+#include "okapi/api/control/async/asyncPositionController.hpp"
+#include "okapi/api/control/util/pathfinderUtil.hpp"
+#include "okapi/api/device/motor/abstractMotor.hpp"
+#include "okapi/api/odometry/odometry.hpp"
+#include "okapi/api/odometry/point.hpp"
+#include "okapi/api/units/QSpeed.hpp"
+#include "okapi/api/util/logging.hpp"
+#include "okapi/api/util/timeUtil.hpp"
+#include <atomic>
+#include <map>
+#include <vector>
+
+namespace okapi {
+class AsyncPurePursuitController : public AsyncPositionController<std::string, Point> {
+  public:
+  /**
+   * An Async Controller which follows paths of waypoints with pure pursuit. Every 10 ms it reads
+   * the pose of the robot from the odometry, finds the point on the path one lookahead distance
+   * away, and drives the chassis along the arc through that point. Because it steers from the
+   * measured pose, it corrects for drift as it goes, and following a path needs no profile to be
+   * generated.
+   *
+   * Paths are in the frame of the odometry, in `StateMode::FRAME_TRANSFORMATION`, so the first
+   * waypoint does not need to be where the robot starts. Waypoints should be closer together than
+   * the lookahead distance; see `interpolate()` to fill in a sparse path. The robot drives at the
+   * max velocity of the limits, speeding up and slowing down by the max acceleration so it stops
+   * at the end. It has settled once it is within the settle distance of the last waypoint.
+   *
+   * Throws a `std::invalid_argument` if the gear ratio is zero, the lookahead distance or the
+   * settle distance is not positive, or the max velocity or max acceleration is not positive.
+   *
+   * @param itimeUtil The TimeUtil.
+   * @param imodel The chassis to drive.
+   * @param iodometry The odometry to read the pose of the robot from.
+   * @param iscales The ChassisScales.
+   * @param ipair The gearset.
+   * @param ilimits The velocity and acceleration to drive with. The jerk is not used.
+   * @param ilookahead The distance from the robot to the point it steers toward. Longer distances
+   * follow more smoothly but cut corners.
+   * @param isettleDistance How close the robot must get to the end of the path to be done.
+   * @param ilogger The logger this instance will log to.
+   */
+  AsyncPurePursuitController(const TimeUtil &itimeUtil,
+                             const std::shared_ptr<ChassisModel> &imodel,
+                             const std::shared_ptr<Odometry> &iodometry,
+                             const ChassisScales &iscales,
+                             const AbstractMotor::GearsetRatioPair &ipair,
+                             const PathfinderLimits &ilimits,
+                             QLength ilookahead,
+                             QLength isettleDistance = 1_in,
+                             const std::shared_ptr<Logger> &ilogger = Logger::getDefaultLogger());
+
+  AsyncPurePursuitController(AsyncPurePursuitController &&other) = delete;
+
+  AsyncPurePursuitController &operator=(AsyncPurePursuitController &&other) = delete;
+
+  ~AsyncPurePursuitController() override;
+
+  /**
+   * Saves a path internally with a key of pathId. Call `setTarget()` with the same pathId to follow
+   * it. If there are fewer than two waypoints, no path is saved.
+   *
+   * @param iwaypoints The waypoints to follow, in `StateMode::FRAME_TRANSFORMATION`.
+   * @param ipathId A unique identifier to save the path with.
+   */
+  void addPath(const std::vector<Point> &iwaypoints, const std::string &ipathId);
+
+  /**
+   * Removes a path and frees the memory it used. A path which is currently running is shared with
+   * the controller task, so it keeps running and its memory is freed when it finishes.
+   *
+   * @param ipathId A unique identifier for the path, previously passed to `addPath()`
+   * @return `true` if the path no longer exists
+   */
+  bool removePath(const std::string &ipathId);
+
+  /**
+   * Gets the identifiers of all paths saved in this `AsyncPurePursuitController`.
+   *
+   * @return The identifiers of all paths
+   */
+  std::vector<std::string> getPaths();
+
+  /**
+   * Follows a path with the given ID. If there is no path matching the ID, the method will
+   * return. Any targets set while a path is being followed will be ignored.
+   *
+   * @param ipathId A unique identifier for the path, previously passed to `addPath()`.
+   */
+  void setTarget(std::string ipathId) override;
+
+  /**
+   * Writes the value of the controller output. This method might be automatically called in another
+   * thread by the controller.
+   *
+   * This just calls `setTarget()`.
+   */
+  void controllerSet(std::string ivalue) override;
+
+  /**
+   * Gets the last set target, or the default target if none was set.
+   *
+   * @return the last target
+   */
+  std::string getTarget() override;
+
+  /**
+   * This is overridden to return the current path.
+   *
+   * @return The most recent value of the process variable.
+   */
+  std::string getProcessValue() const override;
+
+  /**
+   * Blocks the current task until the controller has settled. This controller is settled when
+   * it has finished following a path. If no path is being followed, it is settled.
+   */
+  void waitUntilSettled() override;
+
+  /**
+   * Follows the waypoints and blocks until the controller has settled. Does not save the path.
+   *
+   * @param iwaypoints The waypoints to follow, in `StateMode::FRAME_TRANSFORMATION`.
+   */
+  void moveTo(const std::vector<Point> &iwaypoints);
+
+  /**
+   * Returns the offset from the robot to the end of the current path, as of the last time the
+   * controller read the odometry. Returns zero if there is no path currently being followed.
+   *
+   * @return the last error
+   */
+  Point getError() const override;
+
+  /**
+   * Returns whether the controller has settled at the target. Determining what settling means is
+   * implementation-dependent.
+   *
+   * If the controller is disabled, this method must return `true`.
+   *
+   * @return whether the controller is settled
+   */
+  bool isSettled() override;
+
+  /**
+   * Resets the controller's internal state so it is similar to when it was first initialized, while
+   * keeping any user-configured information. This implementation also stops movement.
+   */
+  void reset() override;
+
+  /**
+   * Changes whether the controller is off or on. Turning the controller on after it was off will
+   * NOT cause the controller to move to its last set target.
+   */
+  void flipDisable() override;
+
+  /**
+   * Sets whether the controller is off or on. Turning the controller on after it was off will
+   * NOT cause the controller to move to its last set target, unless it was reset in that time.
+   *
+   * @param iisDisabled whether the controller is disabled
+   */
+  void flipDisable(bool iisDisabled) override;
+
+  /**
+   * Returns whether the controller is currently disabled.
+   *
+   * @return whether the controller is currently disabled
+   */
+  bool isDisabled() const override;
+
+  /**
+   * This implementation does nothing because the paths are in the frame of the odometry.
+   */
+  void tarePosition() override;
+
+  /**
+   * This implementation does nothing because the maximum velocity is configured using
+   * PathfinderLimits elsewhere.
+   *
+   * @param imaxVelocity Ignored.
+   */
+  void setMaxVelocity(std::int32_t imaxVelocity) override;
+
+  /**
+   * Starts the internal thread. This should not be called by normal users.
+   *
+   * @param ipriority The priority of the task.
+   * @param istackDepth The stack depth of the task in words.
+   */
+  void startThread(std::uint32_t ipriority = TASK_PRIORITY_DEFAULT,
+                   std::uint16_t istackDepth = TASK_STACK_DEPTH_DEFAULT);
+
+  /**
+   * Returns the underlying thread handle.
+   *
+   * @return The underlying thread handle.
+   */
+  CrossplatformThread *getThread() const;
+
+  /**
+   * Fills in a sparse path with points along the straight lines between its waypoints, so no two
+   * points are farther apart than the spacing. Throws a `std::invalid_argument` if the spacing is
+   * not positive.
+   *
+   * @param iwaypoints The waypoints.
+   * @param ispacing The farthest apart two points may be.
+   * @return The dense path, which still goes through every waypoint.
+   */
+  static std::vector<Point> interpolate(const std::vector<Point> &iwaypoints, QLength ispacing);
+
+  protected:
+  /**
+   * The points of a path in meters, with the distance along the path to each one.
+   */
+  struct Path {
+    std::vector<double> x;
+    std::vector<double> y;
+    std::vector<double> distance;
+  };
+
+  /**
+   * How far the robot has gotten along the path it is following. Both only move forward, so each
+   * search resumes from where the last one stopped instead of scanning the whole path.
+   */
+  struct FollowState {
+    // The point on the path closest to the robot
+    std::size_t closestIndex{0};
+    // The lookahead point, as a fractional index: 2.5 is halfway between points 2 and 3
+    double lookaheadIndex{0};
+    // The speed the robot was last driven at, in meters per second
+    double speed{0};
+  };
+
+  std::shared_ptr<Logger> logger;
+  std::map<std::string, std::shared_ptr<const Path>> paths{};
+  std::shared_ptr<ChassisModel> model;
+  std::shared_ptr<Odometry> odometry;
+  ChassisScales scales;
+  AbstractMotor::GearsetRatioPair pair;
+  PathfinderLimits limits;
+  QLength lookahead;
+  QLength settleDistance;
+  TimeUtil timeUtil;
+  // Made once so following a path does not allocate. Only the controller task uses it.
+  std::unique_ptr<AbstractRate> pathRate;
+
+  // This must be locked when accessing the path map, the current path, or the error. Paths
+  // themselves are immutable and shared, so the controller task does not need to hold it while
+  // following a path.
+  mutable CrossplatformMutex currentPathMutex;
+
+  std::string currentPath{""};
+  Point error{0_m, 0_m};
+  std::atomic_bool isRunning{false};
+  std::atomic_bool disabled{false};
+  std::atomic_bool dtorCalled{false};
+  // Notified when the controller settles, so waiting tasks don't need to poll
+  CrossplatformEvent settledEvent;
+  CrossplatformThread *task{nullptr};
+
+  /**
+   * The time between reading the odometry and driving the chassis.
+   */
+  static constexpr QTime followPeriod = 10_ms; // NOLINT
+
+  /**
+   * The longest time in milliseconds the idle controller task sleeps before checking whether it
+   * should stop. `setTarget()` wakes the task immediately.
+   */
+  static constexpr std::uint32_t idleLoopTimeout = 100;
+
+  static void trampoline(void *context);
+  void loop();
+
+  /**
+   * Wakes the controller task so it starts following a new target.
+   */
+  void wakeTask();
+
+  /**
+   * Follows the path with the given ID if it exists.
+   *
+   * @return Whether the path existed.
+   */
+  bool executePath(const std::string &ipathId);
+
+  /**
+   * Follow the supplied path. Must follow the disabled lifecycle.
+   */
+  virtual void executeSinglePath(const Path &ipath, AbstractRate &rate);
+
+  /**
+   * Reads the odometry and drives the chassis toward the lookahead point for one period.
+   *
+   * @param ipath The path being followed.
+   * @param iostate How far the robot has gotten along the path, which is updated.
+   * @return Whether the robot reached the end of the path. The chassis is not driven if it did.
+   */
+  bool followStep(const Path &ipath, FollowState &iostate);
+
+  /**
+   * Moves the closest point and the lookahead point forward to where the robot is now. The
+   * lookahead point is the farthest intersection of the path with a circle of the lookahead
+   * distance around the robot, past the last lookahead point. If the robot is farther than the
+   * lookahead distance from the path, the lookahead point is the closest point instead.
+   *
+   * @param ipath The path being followed.
+   * @param ix The x position of the robot in meters.
+   * @param iy The y position of the robot in meters.
+   * @param iostate How far the robot has gotten along the path, which is updated.
+   */
+  void updateSearch(const Path &ipath, double ix, double iy, FollowState &iostate) const;
+
+  /**
+   * Drives the chassis along an arc, slowing both sides down together if one of them would go
+   * faster than the motors can.
+   *
+   * @param ispeed The speed of the center of the robot in meters per second.
+   * @param icurvature The curvature of the arc in inverse meters, positive when turning clockwise.
+   */
+  void writeArc(double ispeed, double icurvature);
+};
+} // namespace okapi
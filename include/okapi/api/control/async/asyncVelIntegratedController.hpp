@@ -118,6 +118,8 @@ class AsyncVelIntegratedController : public AsyncVelocityController<double, doub
   bool controllerIsDisabled = false;
   bool hasFirstTarget = false;
   std::unique_ptr<SettledUtil> settledUtil;
+  // Made once so waitUntilSettled does not allocate
+  std::unique_ptr<AbstractRate> waitRate;
 
   virtual void resumeMovement();
 };
@@ -0,0 +1,56 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#pragma once
+
+#include "okapi/api/control/async/asyncVelocityController.hpp"
+#include "okapi/api/control/async/asyncWrapper.hpp"
+#include "okapi/api/control/controllerInput.hpp"
+#include "okapi/api/control/controllerOutput.hpp"
+#include "okapi/api/control/iterative/iterativeTbhController.hpp"
+#include "okapi/api/util/timeUtil.hpp"
+#include <memory>
+
+namespace okapi {
+class AsyncVelTBHController : public AsyncWrapper<double, double>,
+                                 public AsyncVelocityController<double, double> {
+  public:
+  /**
+   * An async take-back-half velocity controller.
+   *
+   * @param iinput The controller input.
+   * @param ioutput The controller output.
+   * @param itimeUtil The TimeUtil.
+   * @param igains The controller gains.
+   * @param ivelMath The VelMath used for calculating velocity.
+   * @param iratio Any external gear ratio.
+   * @param ilogger The logger this instance will log to.
+   */
+  AsyncVelTBHController(const std::shared_ptr<ControllerInput<double>> &iinput,
+                        const std::shared_ptr<ControllerOutput<double>> &ioutput,
+                        const TimeUtil &itimeUtil,
+                        const IterativeTBHController::Gains &igains,
+                        std::unique_ptr<VelMath> ivelMath,
+                        double iratio = 1,
+                        const std::shared_ptr<Logger> &ilogger = Logger::getDefaultLogger());
+
+  /**
+   * Set controller gains.
+   *
+   * @param igains The new gains.
+   */
+  void setGains(const IterativeTBHController::Gains &igains);
+
+  /**
+   * Gets the current gains.
+   *
+   * @return The current gains.
+   */
+  IterativeTBHController::Gains getGains() const;
+
+  protected:
+  std::shared_ptr<IterativeTBHController> internalController;
+};
+} // namespace okapi
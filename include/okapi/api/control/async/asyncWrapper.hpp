@@ -8,12 +8,18 @@
 #include "okapi/api/control/async/asyncController.hpp"
 #include "okapi/api/control/controllerInput.hpp"
 #include "okapi/api/control/iterative/iterativeController.hpp"
+#include "okapi/api/control/util/controlScheduler.hpp"
+#include "okapi/api/control/util/loopTimingRecorder.hpp"
 #include "okapi/api/control/util/settledUtil.hpp"
+#include "okapi/api/control/util/sharedControllerState.hpp"
 #include "okapi/api/coreProsAPI.hpp"
 #include "okapi/api/util/abstractRate.hpp"
+#include "okapi/api/util/abstractTimer.hpp"
 #include "okapi/api/util/logging.hpp"
 #include "okapi/api/util/mathUtil.hpp"
 #include "okapi/api/util/supplier.hpp"
+#include "okapi/api/util/taskProfiler.hpp"
+#include "okapi/api/util/telemetryStream.hpp"
 #include <atomic>
 #include <memory>
 
@@ -29,6 +35,7 @@ class AsyncWrapper : virtual public AsyncController<Input, Output> {
    * @param ioutput controller output, written to from the `IterativeController`
    * @param icontroller the controller to use
    * @param irateSupplier used for rates used in the main loop and in `waitUntilSettled`
+   * @param itimerSupplier used for the timer which measures the time between steps
    * @param iratio Any external gear ratio.
    * @param ilogger The logger this instance will log to.
    */
@@ -36,10 +43,12 @@ class AsyncWrapper : virtual public AsyncController<Input, Output> {
                const std::shared_ptr<ControllerOutput<Output>> &ioutput,
                const std::shared_ptr<IterativeController<Input, Output>> &icontroller,
                const Supplier<std::unique_ptr<AbstractRate>> &irateSupplier,
+               const Supplier<std::unique_ptr<AbstractTimer>> &itimerSupplier,
                const double iratio = 1,
                std::shared_ptr<Logger> ilogger = Logger::getDefaultLogger())
     : logger(std::move(ilogger)),
       rateSupplier(irateSupplier),
+      loopTimer(itimerSupplier.get()),
       input(iinput),
       output(ioutput),
       controller(icontroller),
@@ -52,16 +61,20 @@ class AsyncWrapper : virtual public AsyncController<Input, Output> {
 
   ~AsyncWrapper() override {
     dtorCalled.store(true, std::memory_order_release);
+    if (scheduler) {
+      scheduler->removeLoop(schedulerLoopId);
+    }
     delete task;
   }
 
   /**
-   * Sets the target for the controller.
+   * Sets the target for the controller. Once the controller is stepped from a task, the target is
+   * posted for the next step to apply, and this never waits for the step.
    */
   void setTarget(const Input itarget) override {
     LOG_INFO("AsyncWrapper: Set target to " + std::to_string(itarget));
     hasFirstTarget = true;
-    controller->setTarget(itarget * ratio);
+    post(itarget * ratio, true);
     lastTarget = itarget;
   }
 
@@ -72,7 +85,7 @@ class AsyncWrapper : virtual public AsyncController<Input, Output> {
    * @param ivalue the controller's output
    */
   void controllerSet(const Input ivalue) override {
-    controller->controllerSet(ivalue);
+    post(ivalue, false);
   }
 
   /**
@@ -81,40 +94,59 @@ class AsyncWrapper : virtual public AsyncController<Input, Output> {
    * @return the last target
    */
   Input getTarget() override {
-    return controller->getTarget();
+    if (!isStepping()) {
+      return controller->getTarget();
+    }
+
+    Input target;
+    if (getPostedTarget(target)) {
+      return target;
+    }
+
+    return state.get().target;
   }
 
   /**
    * @return The most recent value of the process variable.
    */
   Input getProcessValue() const override {
-    return controller->getProcessValue();
+    return isStepping() ? state.get().processValue : controller->getProcessValue();
   }
 
   /**
    * Returns the last calculated output of the controller.
    */
   Output getOutput() const {
-    return controller->getOutput();
+    return isStepping() ? state.get().output : controller->getOutput();
   }
 
   /**
-   * Returns the last error of the controller. Does not update when disabled.
+   * Returns the last error of the controller. Does not update when disabled. Once the controller
+   * is stepped from a task, this is the error after the last step.
    */
   Output getError() const override {
-    return controller->getError();
+    return isStepping() ? state.get().error : controller->getError();
   }
 
   /**
    * Returns whether the controller has settled at the target. Determining what settling means is
-   * implementation-dependent.
+   * implementation-dependent. A controller stepped from a task is not settled until it has stepped
+   * towards the last target or reset posted to it.
    *
    * If the controller is disabled, this method must return true.
    *
    * @return whether the controller is settled
    */
   bool isSettled() override {
-    return isDisabled() || controller->isSettled();
+    if (isDisabled()) {
+      return true;
+    }
+
+    if (!isStepping()) {
+      return controller->isSettled();
+    }
+
+    return !isPending() && state.get().settled;
   }
 
   /**
@@ -171,7 +203,11 @@ class AsyncWrapper : virtual public AsyncController<Input, Output> {
    */
   void reset() override {
     LOG_INFO_S("AsyncWrapper: Reset");
-    controller->reset();
+    if (isStepping()) {
+      postedResetCount.fetch_add(1, std::memory_order_release);
+    } else {
+      controller->reset();
+    }
     hasFirstTarget = false;
   }
 
@@ -183,6 +219,7 @@ class AsyncWrapper : virtual public AsyncController<Input, Output> {
     LOG_INFO("AsyncWrapper: flipDisable " + std::to_string(!controller->isDisabled()));
     controller->flipDisable();
     resumeMovement();
+    settledEvent.notifyAll();
   }
 
   /**
@@ -195,6 +232,7 @@ class AsyncWrapper : virtual public AsyncController<Input, Output> {
     LOG_INFO("AsyncWrapper: flipDisable " + std::to_string(iisDisabled));
     controller->flipDisable(iisDisabled);
     resumeMovement();
+    settledEvent.notifyAll();
   }
 
   /**
@@ -213,9 +251,11 @@ class AsyncWrapper : virtual public AsyncController<Input, Output> {
   void waitUntilSettled() override {
     LOG_INFO_S("AsyncWrapper: Waiting to settle");
 
-    auto rate = rateSupplier.get();
+    // The controller task notifies settledEvent after every step. The timeout is only a fallback.
+    auto generation = settledEvent.getGeneration();
     while (!isSettled()) {
-      rate->delayUntil(motorUpdateRate);
+      settledEvent.waitFor(generation, this->settledWaitTimeout);
+      generation = settledEvent.getGeneration();
     }
 
     LOG_INFO_S("AsyncWrapper: Done waiting to settle");
@@ -224,10 +264,31 @@ class AsyncWrapper : virtual public AsyncController<Input, Output> {
   /**
    * Starts the internal thread. This should not be called by normal users. This method is called
    * by the AsyncControllerFactory when making a new instance of this class.
+   *
+   * @param ipriority The priority of the task.
+   * @param istackDepth The stack depth of the task in words.
+   */
+  void startThread(const std::uint32_t ipriority = TASK_PRIORITY_DEFAULT,
+                   const std::uint16_t istackDepth = TASK_STACK_DEPTH_DEFAULT) {
+    if (!task && !scheduler) {
+      publishState();
+      task = new CrossplatformThread(trampoline, this, "AsyncWrapper", ipriority, istackDepth);
+    }
+  }
+
+  /**
+   * Steps the controller from a shared scheduler at its sample time instead of starting an
+   * internal thread. This should not be called by normal users, and not together with
+   * `startThread`.
+   *
+   * @param ischeduler The scheduler to step the controller from.
    */
-  void startThread() {
-    if (!task) {
-      task = new CrossplatformThread(trampoline, this, "AsyncWrapper");
+  void startScheduled(const std::shared_ptr<ControlScheduler> &ischeduler) {
+    if (!task && !scheduler) {
+      publishState();
+      scheduler = ischeduler;
+      schedulerLoopId = scheduler->addLoop([this]() { runStep(true); },
+                                           [this]() { return controller->getSampleTime(); });
     }
   }
 
@@ -240,9 +301,62 @@ class AsyncWrapper : virtual public AsyncController<Input, Output> {
     return task;
   }
 
+  /**
+   * Returns the distribution of the time between the steps of the controller since it was made or
+   * the stats were last reset. A step is counted whether or not the controller is disabled.
+   *
+   * @return The loop timing stats.
+   */
+  LoopTimingStats getLoopTimingStats() const {
+    return loopTiming.getStats();
+  }
+
+  /**
+   * Forgets the loop timing recorded so far.
+   */
+  void resetLoopTimingStats() {
+    loopTiming.reset();
+  }
+
+  /**
+   * Logs the loop timing stats at the info level every `isteps` steps. This is off by default.
+   *
+   * @param isteps The number of steps between logs, or zero to turn logging off.
+   */
+  void setLoopTimingLogInterval(const std::uint32_t isteps) {
+    loopTimingLogInterval.store(isteps, std::memory_order_relaxed);
+  }
+
+  /**
+   * Streams the target, process value, error, and output of the controller after its last step as
+   * signals named `<iname>.target` and so on. The signals are removed when this controller is
+   * destroyed.
+   *
+   * @param istream The stream to add the signals to.
+   * @param iname The prefix of the signal names.
+   */
+  void addTelemetry(const std::shared_ptr<TelemetryStream> &istream, const std::string &iname) {
+    telemetry.add(istream, iname + ".target", [this]() {
+      return static_cast<double>(state.get().target);
+    });
+    telemetry.add(istream, iname + ".processValue", [this]() {
+      return static_cast<double>(state.get().processValue);
+    });
+    telemetry.add(
+      istream, iname + ".error", [this]() { return static_cast<double>(state.get().error); });
+    telemetry.add(istream, iname + ".output", [this]() {
+      return static_cast<double>(state.get().output);
+    });
+  }
+
   protected:
   std::shared_ptr<Logger> logger;
   Supplier<std::unique_ptr<AbstractRate>> rateSupplier;
+  std::unique_ptr<AbstractTimer> loopTimer;
+  LoopTimingRecorder loopTiming{"AsyncWrapper"};
+  std::atomic_uint32_t loopTimingLogInterval{0};
+  QTime lastStepTime{0_ms};
+  bool hasStepped{false};
   std::shared_ptr<ControllerInput<Input>> input;
   std::shared_ptr<ControllerOutput<Output>> output;
   std::shared_ptr<IterativeController<Input, Output>> controller;
@@ -251,6 +365,23 @@ class AsyncWrapper : virtual public AsyncController<Input, Output> {
   double ratio;
   std::atomic_bool dtorCalled{false};
   CrossplatformThread *task{nullptr};
+  std::shared_ptr<ControlScheduler> scheduler{nullptr};
+  std::size_t schedulerLoopId{0};
+  // The state after the last step, for the user task to read while the controller task steps
+  SharedControllerState<Input, Output> state;
+  // The newest target or controllerSet value, posted for the next step to apply. The sequence
+  // number is odd while it is being written, like a cell of the shared state.
+  std::atomic_uint32_t postedSequence{0};
+  std::atomic<Input> postedValue{0};
+  std::atomic_bool postedIsTarget{false};
+  std::atomic_uint32_t postedResetCount{0};
+  // The posted sequence number and resets which the published state includes
+  std::atomic_uint32_t appliedSequence{0};
+  std::atomic_uint32_t appliedResetCount{0};
+  // Notified whenever the controller might have settled, so waiting tasks don't need to poll
+  CrossplatformEvent settledEvent;
+  // Declared last so the signals are removed before anything they read is destroyed
+  TelemetryRegistration telemetry;
 
   static void trampoline(void *context) {
     if (context) {
@@ -259,14 +390,170 @@ class AsyncWrapper : virtual public AsyncController<Input, Output> {
   }
 
   void loop() {
-    auto rate = rateSupplier.get();
+    auto rate = std::make_unique<ProfiledRate>(rateSupplier.get(), "AsyncWrapper");
     while (!dtorCalled.load(std::memory_order_acquire) && !task->notifyTake(0)) {
-      if (!isDisabled()) {
-        output->controllerSet(controller->step(input->controllerGet()));
+      runStep();
+      rate->delayUntil(controller->getSampleTime());
+    }
+  }
+
+  /**
+   * Steps the controller once.
+   *
+   * @param ischeduled Whether the step comes from a scheduler, which guarantees the period, so
+   * the controller doesn't have to measure it.
+   */
+  void runStep(const bool ischeduled = false) {
+    recordLoopTiming();
+
+    const std::uint32_t resetCount = postedResetCount.load(std::memory_order_acquire);
+    if (resetCount != appliedResetCount.load(std::memory_order_relaxed)) {
+      controller->reset();
+    }
+
+    // A post which is still being written is applied by the next step
+    std::uint32_t sequence = appliedSequence.load(std::memory_order_relaxed);
+    Input value;
+    bool isTarget;
+    if (readPosted(value, isTarget, sequence)) {
+      if (isTarget) {
+        controller->setTarget(value);
+      } else {
+        controller->controllerSet(value);
       }
+    }
 
-      rate->delayUntil(controller->getSampleTime());
+    if (!isDisabled()) {
+      const Input reading = input->controllerGet();
+      output->controllerSet(ischeduled
+                              ? controller->stepFixed(reading, controller->getSampleTime())
+                              : controller->step(reading));
+    }
+
+    publishState();
+    appliedResetCount.store(resetCount, std::memory_order_release);
+    appliedSequence.store(sequence, std::memory_order_release);
+
+    if (!isDisabled()) {
+      settledEvent.notifyAll();
+    }
+  }
+
+  /**
+   * @return Whether the controller is stepped from a task, so only that task may touch it.
+   */
+  bool isStepping() const {
+    return task != nullptr || scheduler != nullptr;
+  }
+
+  /**
+   * Applies a target or controllerSet value now, or posts it for the next step to apply once the
+   * controller is stepped from a task.
+   */
+  void post(const Input ivalue, const bool iisTarget) {
+    if (!isStepping()) {
+      if (iisTarget) {
+        controller->setTarget(ivalue);
+      } else {
+        controller->controllerSet(ivalue);
+      }
+      return;
     }
+
+    const std::uint32_t sequence = postedSequence.load(std::memory_order_relaxed);
+    postedSequence.store(sequence + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+
+    postedValue.store(ivalue, std::memory_order_relaxed);
+    postedIsTarget.store(iisTarget, std::memory_order_relaxed);
+
+    postedSequence.store(sequence + 2, std::memory_order_release);
+  }
+
+  /**
+   * Reads the newest post if it is newer than a sequence number.
+   *
+   * @param ovalue The posted value is written to this.
+   * @param oisTarget Whether the value is a target is written to this.
+   * @param iosequence The sequence number to compare with. The read sequence number is written to
+   * this.
+   * @return False if there is no newer post, or it is being written.
+   */
+  bool readPosted(Input &ovalue, bool &oisTarget, std::uint32_t &iosequence) const {
+    const std::uint32_t sequence = postedSequence.load(std::memory_order_acquire);
+    if (sequence == iosequence || sequence % 2 != 0) {
+      return false;
+    }
+
+    ovalue = postedValue.load(std::memory_order_relaxed);
+    oisTarget = postedIsTarget.load(std::memory_order_relaxed);
+
+    std::atomic_thread_fence(std::memory_order_acquire);
+    if (postedSequence.load(std::memory_order_relaxed) != sequence) {
+      return false;
+    }
+
+    iosequence = sequence;
+    return true;
+  }
+
+  /**
+   * @param otarget The posted target is written to this.
+   * @return Whether a target is posted which no step has applied yet.
+   */
+  bool getPostedTarget(Input &otarget) const {
+    // A post which is being written isn't seen, so the published target is read instead
+    std::uint32_t sequence = appliedSequence.load(std::memory_order_acquire);
+    bool isTarget;
+    return readPosted(otarget, isTarget, sequence) && isTarget;
+  }
+
+  /**
+   * @return Whether a post or reset has not been applied by a step yet.
+   */
+  bool isPending() const {
+    return postedSequence.load(std::memory_order_relaxed) !=
+             appliedSequence.load(std::memory_order_acquire) ||
+           postedResetCount.load(std::memory_order_relaxed) !=
+             appliedResetCount.load(std::memory_order_acquire);
+  }
+
+  /**
+   * Publishes the state of the controller for the user task to read.
+   */
+  void publishState() {
+    ControllerState<Input, Output> newState;
+    newState.target = controller->getTarget();
+    newState.processValue = controller->getProcessValue();
+    newState.error = controller->getError();
+    newState.output = controller->getOutput();
+    newState.settled = controller->isSettled();
+    state.publish(newState);
+  }
+
+  void recordLoopTiming() {
+    const QTime now = loopTimer->millis();
+    if (hasStepped) {
+      loopTiming.record(now - lastStepTime, controller->getSampleTime());
+
+      const auto interval = loopTimingLogInterval.load(std::memory_order_relaxed);
+      if (interval != 0) {
+        const auto stats = loopTiming.getStats();
+        if (stats.sampleCount % interval == 0) {
+          LOG_INFO_F("AsyncWrapper: Loop timing samples=%u overruns=%u min=%.1fms max=%.1fms "
+                     "mean=%.2fms p99=%.1fms",
+                     stats.sampleCount,
+                     stats.overrunCount,
+                     stats.minDt.convert(millisecond),
+                     stats.maxDt.convert(millisecond),
+                     stats.meanDt.convert(millisecond),
+                     stats.p99Dt.convert(millisecond));
+        }
+      }
+    }
+
+    lastStepTime = now;
+    hasStepped = true;
   }
 
   /**
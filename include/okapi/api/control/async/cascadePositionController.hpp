@@ -0,0 +1,254 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#pragma once
+
+#include "okapi/api/control/async/asyncPositionController.hpp"
+#include "okapi/api/control/async/asyncVelocityController.hpp"
+#include "okapi/api/control/controllerOutput.hpp"
+#include "okapi/api/control/iterative/iterativePosPidController.hpp"
+#include "okapi/api/control/iterative/iterativeVelocityController.hpp"
+#include "okapi/api/control/offsettableControllerInput.hpp"
+#include "okapi/api/coreProsAPI.hpp"
+#include "okapi/api/util/logging.hpp"
+#include "okapi/api/util/timeUtil.hpp"
+#include <atomic>
+#include <memory>
+
+namespace okapi {
+/**
+ * A position controller made of two loops: an outer position PID whose output sets the target of
+ * an inner velocity controller. Both loops run in one task. The inner loop steps every inner
+ * period and the outer loop steps every whole number of inner steps closest to the outer period,
+ * so the two never drift apart and no synchronization between tasks is needed.
+ *
+ * The inner controller is either an IterativeVelocityController, like IterativeVelPIDController,
+ * which is stepped by this controller and writes to the output, or an AsyncVelocityController,
+ * like AsyncVelIntegratedController, which runs itself and only has its target set.
+ *
+ * The outer output in `[-1, 1]` is scaled by the max velocity into the inner target.
+ */
+class CascadePositionController : public AsyncPositionController<double, double> {
+  public:
+  /**
+   * The time between inner loop steps, by default.
+   */
+  static constexpr QTime defaultInnerPeriod = 5_ms; // NOLINT
+
+  /**
+   * The time between outer loop steps, by default.
+   */
+  static constexpr QTime defaultOuterPeriod = 20_ms; // NOLINT
+
+  /**
+   * A cascade with an inner loop stepped by this controller. The sample times of both controllers
+   * are set to their periods.
+   *
+   * @param iinput The position sensor. The outer loop reads it tared; the inner loop reads it
+   * untared, so its velocity does not jump when the position is tared.
+   * @param iouter The outer position controller.
+   * @param iinner The inner velocity controller.
+   * @param ioutput The output the inner controller writes to.
+   * @param imaxVelocity The inner target when the outer output is `1`, in the units of the inner
+   * controller's target.
+   * @param itimeUtil The TimeUtil which supplies the rate of the task.
+   * @param iinnerPeriod The time between inner loop steps.
+   * @param iouterPeriod The time between outer loop steps. Must be at least the inner period.
+   * @param ilogger The logger this instance will log to.
+   */
+  CascadePositionController(
+    const std::shared_ptr<ControllerInput<double>> &iinput,
+    const std::shared_ptr<IterativePosPIDController> &iouter,
+    const std::shared_ptr<IterativeVelocityController<double, double>> &iinner,
+    const std::shared_ptr<ControllerOutput<double>> &ioutput,
+    double imaxVelocity,
+    const TimeUtil &itimeUtil,
+    const QTime &iinnerPeriod = defaultInnerPeriod,
+    const QTime &iouterPeriod = defaultOuterPeriod,
+    const std::shared_ptr<Logger> &ilogger = Logger::getDefaultLogger());
+
+  /**
+   * A cascade with an inner loop which runs itself. The sample time of the outer controller is set
+   * to the outer period.
+   *
+   * @param iinput The position sensor.
+   * @param iouter The outer position controller.
+   * @param iinner The inner velocity controller.
+   * @param imaxVelocity The inner target when the outer output is `1`, in the units of the inner
+   * controller's target.
+   * @param itimeUtil The TimeUtil which supplies the rate of the task.
+   * @param iinnerPeriod The time between steps of this controller's task.
+   * @param iouterPeriod The time between outer loop steps. Must be at least the inner period.
+   * @param ilogger The logger this instance will log to.
+   */
+  CascadePositionController(
+    const std::shared_ptr<ControllerInput<double>> &iinput,
+    const std::shared_ptr<IterativePosPIDController> &iouter,
+    const std::shared_ptr<AsyncVelocityController<double, double>> &iinner,
+    double imaxVelocity,
+    const TimeUtil &itimeUtil,
+    const QTime &iinnerPeriod = defaultInnerPeriod,
+    const QTime &iouterPeriod = defaultOuterPeriod,
+    const std::shared_ptr<Logger> &ilogger = Logger::getDefaultLogger());
+
+  CascadePositionController(CascadePositionController &&other) = delete;
+
+  CascadePositionController &operator=(CascadePositionController &&other) = delete;
+
+  ~CascadePositionController() override;
+
+  /**
+   * Sets the target position of the outer loop.
+   *
+   * @param itarget The new target position.
+   */
+  void setTarget(double itarget) override;
+
+  /**
+   * Sets the target position from a value in `[-1, 1]`, scaled like
+   * IterativePosPIDController::controllerSet.
+   *
+   * @param ivalue The controller's output.
+   */
+  void controllerSet(double ivalue) override;
+
+  /**
+   * @return The target position of the outer loop.
+   */
+  double getTarget() override;
+
+  /**
+   * @return The most recent position.
+   */
+  double getProcessValue() const override;
+
+  /**
+   * @return The last position error of the outer loop.
+   */
+  double getError() const override;
+
+  /**
+   * @return Whether the outer loop has settled at the target, or `true` if the controller is
+   * disabled.
+   */
+  bool isSettled() override;
+
+  /**
+   * Resets both loops, keeping their configuration.
+   */
+  void reset() override;
+
+  /**
+   * Changes whether both loops are off or on. Turning the controller on after it was off will
+   * cause it to move to its last set target, unless it was reset in that time.
+   */
+  void flipDisable() override;
+
+  /**
+   * Sets whether both loops are off or on. Turning the controller on after it was off will cause
+   * it to move to its last set target, unless it was reset in that time.
+   *
+   * @param iisDisabled Whether the controller is disabled.
+   */
+  void flipDisable(bool iisDisabled) override;
+
+  /**
+   * @return Whether the controller is disabled.
+   */
+  bool isDisabled() const override;
+
+  /**
+   * Blocks the current task until the outer loop has settled.
+   */
+  void waitUntilSettled() override;
+
+  /**
+   * Sets the current position to be the zero position.
+   */
+  void tarePosition() override;
+
+  /**
+   * Sets the inner target when the outer output is `1`.
+   *
+   * @param imaxVelocity The new max velocity.
+   */
+  void setMaxVelocity(std::int32_t imaxVelocity) override;
+
+  /**
+   * @return The inner target the outer loop set last.
+   */
+  double getInnerTarget() const;
+
+  /**
+   * Steps the inner loop once, and the outer loop first if the outer period has passed. Called by
+   * the internal task; call it yourself instead of `startThread` to run the cascade from your own
+   * loop at the inner period.
+   */
+  void step();
+
+  /**
+   * Starts the internal thread. This should not be called by normal users.
+   *
+   * @param ipriority The priority of the task.
+   * @param istackDepth The stack depth of the task in words.
+   */
+  void startThread(std::uint32_t ipriority = TASK_PRIORITY_DEFAULT,
+                   std::uint16_t istackDepth = TASK_STACK_DEPTH_DEFAULT);
+
+  /**
+   * Returns the underlying thread handle.
+   *
+   * @return The underlying thread handle.
+   */
+  CrossplatformThread *getThread() const;
+
+  protected:
+  std::shared_ptr<Logger> logger;
+  std::shared_ptr<ControllerInput<double>> input;
+  std::shared_ptr<OffsetableControllerInput> offsettableInput;
+  std::shared_ptr<IterativePosPIDController> outer;
+  std::shared_ptr<IterativeVelocityController<double, double>> iterativeInner{nullptr};
+  std::shared_ptr<AsyncVelocityController<double, double>> asyncInner{nullptr};
+  std::shared_ptr<ControllerOutput<double>> output{nullptr};
+  std::atomic<double> maxVelocity;
+  Supplier<std::unique_ptr<AbstractRate>> rateSupplier;
+  QTime innerPeriod;
+  QTime outerPeriod;
+  std::uint32_t innerStepsPerOuterStep;
+  std::uint32_t innerStepCount{0};
+  double innerTarget{0};
+  bool innerTargetStale{false};
+  bool hasFirstTarget{false};
+  double lastTarget{0};
+  mutable CrossplatformMutex stepMutex;
+  std::atomic_bool dtorCalled{false};
+  CrossplatformThread *task{nullptr};
+  // Notified after every step, so waiting tasks don't need to poll
+  CrossplatformEvent settledEvent;
+
+  CascadePositionController(const std::shared_ptr<ControllerInput<double>> &iinput,
+                            const std::shared_ptr<IterativePosPIDController> &iouter,
+                            double imaxVelocity,
+                            const TimeUtil &itimeUtil,
+                            const QTime &iinnerPeriod,
+                            const QTime &iouterPeriod,
+                            const std::shared_ptr<Logger> &ilogger);
+
+  static void trampoline(void *context);
+
+  void loop();
+
+  /**
+   * Sets the inner target from the outer output. Call with the step mutex held.
+   */
+  void setInnerTarget(double iouterOutput);
+
+  /**
+   * Resumes moving after the controller is reset. Should not cause movement if the controller is
+   * turned off, reset, and turned back on.
+   */
+  void resumeMovement();
+};
+} // namespace okapi
@@ -6,6 +6,7 @@
 #pragma once
 
 #include "okapi/api/control/closedLoopController.hpp"
+#include "okapi/api/control/util/stepProfiler.hpp"
 #include "okapi/api/units/QTime.hpp"
 
 namespace okapi {
@@ -26,6 +27,19 @@ class IterativeController : public ClosedLoopController<Input, Output> {
    */
   virtual Output step(Input ireading) = 0;
 
+  /**
+   * Do one iteration of the controller with a time step given by the caller, for loops whose
+   * period is already guaranteed. Controllers which don't measure time themselves ignore the time
+   * step and just call `step()`.
+   *
+   * @param ireading A new measurement.
+   * @param idt The time since the last step.
+   * @return The controller output.
+   */
+  virtual Output stepFixed(Input ireading, const QTime & /*idt*/) {
+    return step(ireading);
+  }
+
   /**
    * Returns the last calculated output of the controller.
    */
@@ -75,5 +89,33 @@ class IterativeController : public ClosedLoopController<Input, Output> {
    * @return sample time
    */
   virtual QTime getSampleTime() const = 0;
+
+  /**
+   * Sets whether the controller counts its steps and times how long they take, to find which
+   * controllers use the most CPU time. Off by default.
+   *
+   * @param ienabled Whether to profile the steps.
+   */
+  void setStepProfiling(const bool ienabled) {
+    stepProfiler.setEnabled(ienabled);
+  }
+
+  /**
+   * @return The step counts and times since profiling was turned on or last reset.
+   */
+  StepProfile getStepProfile() const {
+    return stepProfiler.get();
+  }
+
+  /**
+   * Clears the step counts and times.
+   */
+  void resetStepProfile() {
+    stepProfiler.reset();
+  }
+
+  protected:
+  // Implementations start a scope at the top of step() and mark it skipped when they don't update
+  StepProfiler stepProfiler;
 };
 } // namespace okapi
@@ -7,7 +7,9 @@
  */
 #pragma once
 
+#include "okapi/api/control/controllerInput.hpp"
 #include "okapi/api/control/iterative/iterativePositionController.hpp"
+#include "okapi/api/control/util/motorFeedforward.hpp"
 #include "okapi/api/control/util/settledUtil.hpp"
 #include "okapi/api/filter/filter.hpp"
 #include "okapi/api/filter/passthroughFilter.hpp"
@@ -15,10 +17,21 @@
 #include "okapi/api/util/timeUtil.hpp"
 #include <limits>
 #include <memory>
+#include <vector>
 
 namespace okapi {
 class IterativePosPIDController : public IterativePositionController<double, double> {
   public:
+  /**
+   * How the integral is kept from winding up while the output is saturated. The integral limits
+   * (see `setIntegralLimits()`) apply with every strategy.
+   */
+  enum class antiWindup {
+    clamp,                  ///< Only the integral limits
+    conditionalIntegration, ///< Don't integrate error which would push a saturated output further
+    backCalculation ///< Bleed the integral by how far the output was clamped, at the tracking gain
+  };
+
   struct Gains {
     double kP{0};
     double kI{0};
@@ -29,6 +42,43 @@ class IterativePosPIDController : public IterativePositionController<double, dou
     bool operator!=(const Gains &rhs) const;
   };
 
+  /**
+   * A table of gains keyed on some variable, like the magnitude of the error or the height of a
+   * lift. Between two keys, each gain is interpolated linearly. Below the first key and above the
+   * last key, the gains of that key are used.
+   */
+  class GainSchedule {
+    public:
+    struct Point {
+      double key;
+      Gains gains;
+    };
+
+    /**
+     * A table of gains. Throws a std::invalid_argument if there are no points or two points have
+     * the same key.
+     *
+     * @param ipoints The points of the table, in any order.
+     * @param logger The logger this instance will log to.
+     */
+    explicit GainSchedule(std::vector<Point> ipoints,
+                          const std::shared_ptr<Logger> &logger = Logger::getDefaultLogger());
+
+    /**
+     * @param ikey The value of the variable the table is keyed on.
+     * @return The gains at the key.
+     */
+    Gains at(double ikey) const;
+
+    /**
+     * @return The points of the table, sorted by key.
+     */
+    const std::vector<Point> &getPoints() const;
+
+    protected:
+    std::vector<Point> points;
+  };
+
   /**
    * Position PID controller.
    *
@@ -72,12 +122,37 @@ class IterativePosPIDController : public IterativePositionController<double, dou
   double step(double inewReading) override;
 
   /**
-   * Sets the target for the controller.
+   * Do one iteration of the controller with a time step given by the caller instead of measured
+   * by the timer. The timer is not touched and no step is dropped, so this is deterministic, for
+   * loops whose period is already guaranteed (like a ControlScheduler) and for simulation. The
+   * integral and derivative terms are scaled by how the time step compares to the sample time.
+   * A time step of zero or less doesn't step the controller.
+   *
+   * @param inewReading new measurement
+   * @param idt The time since the last step.
+   * @return controller output
+   */
+  double stepFixed(double inewReading, const QTime &idt) override;
+
+  /**
+   * Sets the target for the controller. The target is not moving, so the feedforward (see
+   * `setFeedforward()`) adds nothing.
    *
    * @param itarget new target position
    */
   void setTarget(double itarget) override;
 
+  /**
+   * Sets a target which is moving, like a point of a motion profile. The feedforward (see
+   * `setFeedforward()`) is added to the output for the velocity and acceleration of the target, so
+   * the feedback only has to correct the error left over. Call this every step of the profile.
+   *
+   * @param itarget The new target position.
+   * @param ivelocity The velocity of the target per second.
+   * @param iacceleration The acceleration of the target per second squared.
+   */
+  void setProfiledTarget(double itarget, double ivelocity, double iacceleration = 0);
+
   /**
    * Writes the value of the controller output. This method might be automatically called in another
    * thread by the controller. The range of input values is expected to be [-1, 1].
@@ -223,6 +298,27 @@ class IterativePosPIDController : public IterativePositionController<double, dou
    */
   virtual void setIntegratorReset(bool iresetOnZero);
 
+  /**
+   * Sets how the integral is kept from winding up while the output is saturated, like during the
+   * start of a long move. Conditional integration stops integrating while the output is saturated
+   * in the direction of the error. Back-calculation instead takes the amount the output was clamped
+   * by back out of the integral every step (but never past zero), so the integral holds no more
+   * than the output needs to sit at its limit and there is little to unwind once the output leaves
+   * saturation. The default is `antiWindup::clamp`, which only uses the integral limits.
+   *
+   * Throws a `std::invalid_argument` if the tracking gain is not in `(0, 1]`.
+   *
+   * @param istrategy The strategy to use.
+   * @param itrackingGain The fraction of the clamped amount taken out of the integral per sample
+   * time when using back-calculation. `1` makes the output sit exactly at the limit.
+   */
+  virtual void setAntiWindup(antiWindup istrategy, double itrackingGain = 1);
+
+  /**
+   * @return The strategy used to keep the integral from winding up.
+   */
+  antiWindup getAntiWindup() const;
+
   /**
    * Set controller gains.
    *
@@ -237,11 +333,54 @@ class IterativePosPIDController : public IterativePositionController<double, dou
    */
   Gains getGains() const;
 
+  /**
+   * Sets the feedforward added to the output for the velocity and acceleration of a target set
+   * with `setProfiledTarget()`. The gains are in output per unit of the target per second (and per
+   * second squared).
+   *
+   * @param ifeedforward The new feedforward.
+   */
+  virtual void setFeedforward(const MotorFeedforward &ifeedforward);
+
+  /**
+   * @return The current feedforward.
+   */
+  MotorFeedforward getFeedforward() const;
+
+  /**
+   * Schedules the gains on the magnitude of the error. Every step, the gains are looked up in the
+   * table for the error of that step and replace the current gains, without resetting the
+   * integral or any other state. This overrides `setGains()` until the schedule is cleared.
+   *
+   * @param ischedule The gains for each magnitude of the error.
+   */
+  virtual void setGainSchedule(const GainSchedule &ischedule);
+
+  /**
+   * Schedules the gains on an external variable, like the height of a lift or the battery voltage.
+   * Every step, the gains are looked up in the table for the value of the input and replace the
+   * current gains, without resetting the integral or any other state. This overrides `setGains()`
+   * until the schedule is cleared.
+   *
+   * @param ischedule The gains for each value of the input.
+   * @param iinput The input the table is keyed on.
+   */
+  virtual void setGainSchedule(const GainSchedule &ischedule,
+                               std::shared_ptr<ControllerInput<double>> iinput);
+
+  /**
+   * Stops scheduling the gains. The gains of the last step are kept.
+   */
+  virtual void clearGainSchedule();
+
   protected:
   std::shared_ptr<Logger> logger;
   double kP, kI, kD, kBias;
   QTime sampleTime{10_ms};
   double target{0};
+  double targetVelocity{0};
+  double targetAcceleration{0};
+  MotorFeedforward feedforward{};
   double lastReading{0};
   double error{0};
   double lastError{0};
@@ -268,9 +407,25 @@ class IterativePosPIDController : public IterativePositionController<double, dou
   // Reset the integrated when the controller crosses 0 or not
   bool shouldResetOnCross{true};
 
+  antiWindup antiWindupStrategy{antiWindup::clamp};
+  double trackingGain{1};
+
   bool controllerIsDisabled{false};
 
   std::unique_ptr<AbstractTimer> loopDtTimer;
   std::unique_ptr<SettledUtil> settledUtil;
+
+  // The gains are looked up in the schedule every step, keyed on the input or, without an input,
+  // on the magnitude of the error
+  std::unique_ptr<GainSchedule> gainSchedule{nullptr};
+  std::shared_ptr<ControllerInput<double>> gainScheduleInput{nullptr};
+
+  /**
+   * Updates the output with a new measurement.
+   *
+   * @param inewReading new measurement
+   * @param idtRatio The time since the last step divided by the sample time.
+   */
+  void update(double inewReading, double idtRatio);
 };
 } // namespace okapi
@@ -20,6 +20,11 @@ class IterativeVelPIDController : public IterativeVelocityController<double, dou
     double kD{0};
     double kF{0};
     double kSF{0};
+    /**
+     * A feed-forward gain on the acceleration of the target. The acceleration is how fast the
+     * target changed over the last step, so leave this at zero for a target which changes in steps.
+     */
+    double kA{0};
 
     bool operator==(const Gains &rhs) const;
     bool operator!=(const Gains &rhs) const;
@@ -234,11 +239,13 @@ class IterativeVelPIDController : public IterativeVelocityController<double, dou
 
   protected:
   std::shared_ptr<Logger> logger;
-  double kP, kD, kF, kSF;
+  double kP, kD, kF, kSF, kA;
   QTime sampleTime{10_ms};
   double error{0};
   double derivative{0};
   double target{0};
+  double lastTarget{0};
+  double targetAcceleration{0};
   double outputSum{0};
   double output{0};
   double outputMax{1};
@@ -0,0 +1,545 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#pragma once
+
+#include "okapi/api/control/iterative/iterativePosPidController.hpp"
+#include "okapi/api/control/iterative/iterativePositionController.hpp"
+#include "okapi/api/util/abstractTimer.hpp"
+#include "okapi/api/util/logging.hpp"
+#include "okapi/api/util/mathUtil.hpp"
+#include "okapi/api/util/timeUtil.hpp"
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <utility>
+
+namespace okapi {
+/**
+ * Many position PID controllers which share one loop. Each axis does the same math as an
+ * IterativePosPIDController with a PassthroughFilter, but the gains and state of every axis are
+ * stored side by side in arrays, so `step()` updates every axis in one pass over contiguous memory
+ * without any virtual calls, filters, or SettledUtils. Use `axis()` to get a view of one axis which
+ * can be used anywhere an IterativePositionController can.
+ *
+ * With `T = float`, the gains and state take half the memory and the compiler can step twice as
+ * many axes per vector instruction, such as four per NEON instruction on the brain. The axis views
+ * still read and write doubles.
+ *
+ * @tparam N The number of axes.
+ * @tparam T The number type of the gains and state of the axes.
+ */
+template <std::size_t N, typename T = double> class PidBank {
+  public:
+  /**
+   * A view of one axis of a PidBank. The view refers to the bank, so the bank must outlive it.
+   */
+  class Axis : public IterativePositionController<double, double> {
+    public:
+    Axis(PidBank &ibank, const std::size_t iindex) : bank(ibank), index(iindex) {
+    }
+
+    /**
+     * Steps this axis on its own, right away. `PidBank::step()` gates the whole bank by the sample
+     * time instead, so call this once per sample time if the axes are not stepped together.
+     *
+     * @param ireading The new measurement.
+     * @return The controller output.
+     */
+    double step(const double ireading) override {
+      auto profile = stepProfiler.start();
+      bank.readings[index] = static_cast<T>(ireading);
+      bank.stepRange(index, index + 1);
+      return getOutput();
+    }
+
+    void setTarget(const double itarget) override {
+      bank.target[index] = itarget;
+    }
+
+    void controllerSet(const double ivalue) override {
+      bank.target[index] = remapRange(
+        ivalue, -1, 1, bank.controllerSetTargetMin[index], bank.controllerSetTargetMax[index]);
+    }
+
+    double getTarget() override {
+      return bank.target[index];
+    }
+
+    double getProcessValue() const override {
+      return bank.lastReading[index];
+    }
+
+    double getOutput() const override {
+      return bank.getOutput(index);
+    }
+
+    double getMaxOutput() override {
+      return bank.outputMax[index];
+    }
+
+    double getMinOutput() override {
+      return bank.outputMin[index];
+    }
+
+    double getError() const override {
+      return bank.target[index] - bank.lastReading[index];
+    }
+
+    bool isSettled() override {
+      return bank.isSettled(index);
+    }
+
+    void setSampleTime(const QTime isampleTime) override {
+      bank.setSampleTime(isampleTime);
+    }
+
+    QTime getSampleTime() const override {
+      return bank.getSampleTime();
+    }
+
+    void setOutputLimits(const double imax, const double imin) override {
+      bank.setOutputLimits(index, imax, imin);
+    }
+
+    void setControllerSetTargetLimits(double itargetMax, double itargetMin) override {
+      if (itargetMin > itargetMax) {
+        std::swap(itargetMax, itargetMin);
+      }
+
+      bank.controllerSetTargetMax[index] = itargetMax;
+      bank.controllerSetTargetMin[index] = itargetMin;
+    }
+
+    void reset() override {
+      bank.reset(index);
+    }
+
+    void flipDisable() override {
+      flipDisable(!isDisabled());
+    }
+
+    void flipDisable(const bool iisDisabled) override {
+      bank.enabled[index] = iisDisabled ? 0 : 1;
+    }
+
+    bool isDisabled() const override {
+      return bank.enabled[index] == 0;
+    }
+
+    protected:
+    PidBank &bank;
+    std::size_t index;
+  };
+
+  /**
+   * Many position PID controllers which share one loop. Every axis starts with zero gains, output
+   * limits of `[-1, 1]`, and the settling limits of the SettledUtil defaults.
+   *
+   * @param itimeUtil The TimeUtil. Only its timer is used, to gate `step()` by the sample time.
+   * @param ilogger The logger this instance will log to.
+   */
+  explicit PidBank(const TimeUtil &itimeUtil,
+                   std::shared_ptr<Logger> ilogger = Logger::getDefaultLogger())
+    : logger(std::move(ilogger)), loopDtTimer(itimeUtil.getTimer()) {
+    kP.fill(0);
+    kI.fill(0);
+    kD.fill(0);
+    kBias.fill(0);
+    readings.fill(0);
+    target.fill(0);
+    lastReading.fill(0);
+    error.fill(0);
+    lastError.fill(0);
+    integral.fill(0);
+    integralMax.fill(1);
+    integralMin.fill(-1);
+    errorSumMin.fill(0);
+    errorSumMax.fill(std::numeric_limits<T>::max());
+    output.fill(0);
+    outputMax.fill(1);
+    outputMin.fill(-1);
+    controllerSetTargetMax.fill(1);
+    controllerSetTargetMin.fill(-1);
+    resetOnCross.fill(1);
+    enabled.fill(1);
+    atTargetError.fill(50);
+    atTargetDerivative.fill(5);
+    atTargetTime.fill(250_ms);
+    settledSteps.fill(0);
+  }
+
+  /**
+   * @return The number of axes.
+   */
+  static constexpr std::size_t size() {
+    return N;
+  }
+
+  /**
+   * Returns a view of one axis. Throws a std::invalid_argument if the index is out of range.
+   *
+   * @param iindex The index of the axis.
+   * @return A view of the axis which refers to this bank.
+   */
+  Axis axis(const std::size_t iindex) {
+    checkIndex(iindex);
+    return Axis(*this, iindex);
+  }
+
+  /**
+   * Steps every enabled axis once the sample time has passed since the last step.
+   *
+   * @param ireadings The new measurement of each axis.
+   * @return The output of each axis. Disabled axes output zero.
+   */
+  const std::array<T, N> &step(const std::array<T, N> &ireadings) {
+    loopDtTimer->placeHardMark();
+    if (loopDtTimer->getDtFromHardMark() >= sampleTime) {
+      readings = ireadings;
+      stepRange(0, N);
+      loopDtTimer->clearHardMark(); // Important that we only clear if dt >= sampleTime
+    }
+
+    for (std::size_t i = 0; i < N; i++) {
+      outputs[i] = enabled[i] ? output[i] : 0;
+    }
+
+    return outputs;
+  }
+
+  /**
+   * Sets the gains of one axis, like IterativePosPIDController::setGains. Resets the integral
+   * limits to `[-1 / kI, 1 / kI]` if `kI` is not zero.
+   *
+   * @param iindex The index of the axis.
+   * @param igains The new gains.
+   */
+  void setGains(const std::size_t iindex, const IterativePosPIDController::Gains &igains) {
+    checkIndex(iindex);
+    const double sampleTimeSec = sampleTime.convert(second);
+    kP[iindex] = igains.kP;
+    kI[iindex] = igains.kI * sampleTimeSec;
+    kD[iindex] = igains.kD / sampleTimeSec;
+    kBias[iindex] = igains.kBias;
+
+    if (igains.kI != 0) {
+      setIntegralLimits(iindex, 1 / igains.kI, -1 / igains.kI);
+    }
+  }
+
+  /**
+   * @param iindex The index of the axis.
+   * @return The gains of the axis.
+   */
+  IterativePosPIDController::Gains getGains(const std::size_t iindex) const {
+    checkIndex(iindex);
+    const double sampleTimeSec = sampleTime.convert(second);
+    return {kP[iindex], kI[iindex] / sampleTimeSec, kD[iindex] * sampleTimeSec, kBias[iindex]};
+  }
+
+  /**
+   * Sets the target of one axis.
+   *
+   * @param iindex The index of the axis.
+   * @param itarget The new target.
+   */
+  void setTarget(const std::size_t iindex, const T itarget) {
+    checkIndex(iindex);
+    target[iindex] = itarget;
+  }
+
+  /**
+   * @param iindex The index of the axis.
+   * @return The target of the axis.
+   */
+  T getTarget(const std::size_t iindex) const {
+    checkIndex(iindex);
+    return target[iindex];
+  }
+
+  /**
+   * @param iindex The index of the axis.
+   * @return The last output of the axis, or zero if it is disabled.
+   */
+  T getOutput(const std::size_t iindex) const {
+    checkIndex(iindex);
+    return enabled[iindex] ? output[iindex] : 0;
+  }
+
+  /**
+   * @param iindex The index of the axis.
+   * @return The error of the axis at its last step.
+   */
+  T getError(const std::size_t iindex) const {
+    checkIndex(iindex);
+    return error[iindex];
+  }
+
+  /**
+   * Sets the output limits of one axis.
+   *
+   * @param iindex The index of the axis.
+   * @param imax The max output.
+   * @param imin The min output.
+   */
+  void setOutputLimits(const std::size_t iindex, T imax, T imin) {
+    checkIndex(iindex);
+    if (imin > imax) {
+      std::swap(imax, imin);
+    }
+
+    outputMax[iindex] = imax;
+    outputMin[iindex] = imin;
+    output[iindex] = std::clamp(output[iindex], imin, imax);
+  }
+
+  /**
+   * Sets the integral limits of one axis.
+   *
+   * @param iindex The index of the axis.
+   * @param imax The max integral value.
+   * @param imin The min integral value.
+   */
+  void setIntegralLimits(const std::size_t iindex, T imax, T imin) {
+    checkIndex(iindex);
+    if (imin > imax) {
+      std::swap(imax, imin);
+    }
+
+    integralMax[iindex] = imax;
+    integralMin[iindex] = imin;
+    integral[iindex] = std::clamp(integral[iindex], imin, imax);
+  }
+
+  /**
+   * Sets the error sum limits of one axis, like IterativePosPIDController::setErrorSumLimits.
+   *
+   * @param iindex The index of the axis.
+   * @param imax The max error value that will be summed.
+   * @param imin The min error value that will be summed.
+   */
+  void setErrorSumLimits(const std::size_t iindex, const T imax, const T imin) {
+    checkIndex(iindex);
+    errorSumMax[iindex] = imax;
+    errorSumMin[iindex] = imin;
+  }
+
+  /**
+   * Sets whether one axis resets its integral when the error crosses zero.
+   *
+   * @param iindex The index of the axis.
+   * @param iresetOnZero Whether to reset the integral.
+   */
+  void setIntegratorReset(const std::size_t iindex, const bool iresetOnZero) {
+    checkIndex(iindex);
+    resetOnCross[iindex] = iresetOnZero ? 1 : 0;
+  }
+
+  /**
+   * Sets when one axis is settled, like the parameters of a SettledUtil.
+   *
+   * @param iindex The index of the axis.
+   * @param iatTargetError The max error to be considered settled.
+   * @param iatTargetDerivative The max change in error per step to be considered settled.
+   * @param iatTargetTime How long the axis has to be within the limits to be settled.
+   */
+  void setSettleLimits(const std::size_t iindex,
+                       const T iatTargetError,
+                       const T iatTargetDerivative,
+                       const QTime &iatTargetTime) {
+    checkIndex(iindex);
+    atTargetError[iindex] = iatTargetError;
+    atTargetDerivative[iindex] = iatTargetDerivative;
+    atTargetTime[iindex] = iatTargetTime;
+  }
+
+  /**
+   * Returns whether one axis is settled: its error and change in error have been within its
+   * settling limits for longer than its settling time. Disabled axes are settled.
+   *
+   * @param iindex The index of the axis.
+   * @return Whether the axis is settled.
+   */
+  bool isSettled(const std::size_t iindex) const {
+    checkIndex(iindex);
+    if (!enabled[iindex]) {
+      return true;
+    }
+
+    if (atTargetTime[iindex] == 0_ms) {
+      return settledSteps[iindex] > 0;
+    }
+
+    // The axis has been within the limits since the first of these steps
+    return settledSteps[iindex] > 1 &&
+           sampleTime * static_cast<double>(settledSteps[iindex] - 1) > atTargetTime[iindex];
+  }
+
+  /**
+   * @return Whether every axis is settled.
+   */
+  bool isSettled() const {
+    for (std::size_t i = 0; i < N; i++) {
+      if (!isSettled(i)) {
+        return false;
+      }
+    }
+
+    return true;
+  }
+
+  /**
+   * Resets the state of one axis, like IterativePosPIDController::reset.
+   *
+   * @param iindex The index of the axis.
+   */
+  void reset(const std::size_t iindex) {
+    checkIndex(iindex);
+    error[iindex] = 0;
+    lastError[iindex] = 0;
+    lastReading[iindex] = 0;
+    integral[iindex] = 0;
+    output[iindex] = 0;
+    settledSteps[iindex] = 0;
+  }
+
+  /**
+   * Resets the state of every axis.
+   */
+  void reset() {
+    for (std::size_t i = 0; i < N; i++) {
+      reset(i);
+    }
+  }
+
+  /**
+   * Enables or disables one axis. Disabled axes are not stepped and output zero.
+   *
+   * @param iindex The index of the axis.
+   * @param iisDisabled Whether the axis should be disabled.
+   */
+  void flipDisable(const std::size_t iindex, const bool iisDisabled) {
+    checkIndex(iindex);
+    enabled[iindex] = iisDisabled ? 0 : 1;
+  }
+
+  /**
+   * Sets the time between steps of the bank and rescales the integral and derivative gains of
+   * every axis to match, like IterativePosPIDController::setSampleTime.
+   *
+   * @param isampleTime The time between steps.
+   */
+  void setSampleTime(const QTime &isampleTime) {
+    if (isampleTime > 0_ms) {
+      const double ratio = isampleTime.convert(millisecond) / sampleTime.convert(millisecond);
+      for (std::size_t i = 0; i < N; i++) {
+        kI[i] *= ratio;
+        kD[i] /= ratio;
+      }
+      sampleTime = isampleTime;
+    }
+  }
+
+  /**
+   * @return The time between steps of the bank.
+   */
+  QTime getSampleTime() const {
+    return sampleTime;
+  }
+
+  protected:
+  std::shared_ptr<Logger> logger;
+  std::unique_ptr<AbstractTimer> loopDtTimer;
+  QTime sampleTime{10_ms};
+
+  // The gains, in the form IterativePosPIDController stores them
+  std::array<T, N> kP;
+  std::array<T, N> kI;
+  std::array<T, N> kD;
+  std::array<T, N> kBias;
+
+  std::array<T, N> readings;
+  std::array<T, N> target;
+  std::array<T, N> lastReading;
+  std::array<T, N> error;
+  std::array<T, N> lastError;
+  std::array<T, N> integral;
+  std::array<T, N> integralMax;
+  std::array<T, N> integralMin;
+  std::array<T, N> errorSumMin;
+  std::array<T, N> errorSumMax;
+  std::array<T, N> output;
+  std::array<T, N> outputMax;
+  std::array<T, N> outputMin;
+  std::array<T, N> outputs{};
+  std::array<T, N> controllerSetTargetMax;
+  std::array<T, N> controllerSetTargetMin;
+
+  // Flags are stored as bytes so the step loop can blend on them
+  std::array<std::uint8_t, N> resetOnCross;
+  std::array<std::uint8_t, N> enabled;
+
+  std::array<T, N> atTargetError;
+  std::array<T, N> atTargetDerivative;
+  std::array<QTime, N> atTargetTime;
+  std::array<std::uint32_t, N> settledSteps;
+
+  /**
+   * Steps the enabled axes in `[ibegin, iend)` with their readings. The loop has no calls and
+   * every branch is a select, so the compiler can vectorize it.
+   */
+  void stepRange(const std::size_t ibegin, const std::size_t iend) {
+    for (std::size_t i = ibegin; i < iend; i++) {
+      const bool active = enabled[i] != 0;
+      const T reading = readings[i];
+      const T readingDiff = reading - lastReading[i];
+      const T newError = target[i] - reading;
+      const T absError = std::abs(newError);
+
+      // The same error sum window as IterativePosPIDController
+      const bool sumError =
+        (absError < target[i] - errorSumMin[i] && absError > target[i] - errorSumMax[i]) ||
+        (absError > target[i] + errorSumMin[i] && absError < target[i] + errorSumMax[i]);
+      T newIntegral = integral[i] + (sumError ? kI[i] * newError : T(0));
+
+      const bool crossed = std::signbit(newError) != std::signbit(lastError[i]);
+      newIntegral = (resetOnCross[i] && crossed) ? T(0) : newIntegral;
+      newIntegral = std::min(std::max(newIntegral, integralMin[i]), integralMax[i]);
+
+      // Derivative over measurement to eliminate derivative kick on setpoint change
+      const T newOutput =
+        std::min(std::max(kP[i] * newError + newIntegral - kD[i] * readingDiff + kBias[i],
+                          outputMin[i]),
+                 outputMax[i]);
+
+      const bool inWindow = std::abs(newError) <= atTargetError[i] &&
+                            std::abs(newError - lastError[i]) <= atTargetDerivative[i];
+
+      lastReading[i] = active ? reading : lastReading[i];
+      error[i] = active ? newError : error[i];
+      integral[i] = active ? newIntegral : integral[i];
+      output[i] = active ? newOutput : output[i];
+      settledSteps[i] = active ? (inWindow ? settledSteps[i] + 1 : 0) : settledSteps[i];
+      lastError[i] = active ? newError : lastError[i];
+    }
+  }
+
+  void checkIndex(const std::size_t iindex) const {
+    if (iindex >= N) {
+      std::string msg("PidBank: The axis index " + std::to_string(iindex) +
+                      " is out of range for a bank of " + std::to_string(N) + " axes.");
+      LOG_ERROR(msg);
+      throw std::invalid_argument(msg);
+    }
+  }
+};
+} // namespace okapi
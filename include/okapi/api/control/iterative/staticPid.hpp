@@ -0,0 +1,312 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#pragma once
+
+#include "okapi/api/control/iterative/iterativePosPidController.hpp"
+#include "okapi/api/filter/passthroughFilter.hpp"
+#include "okapi/api/units/QTime.hpp"
+#include "okapi/api/util/abstractTimer.hpp"
+#include <algorithm>
+#include <cmath>
+#include <memory>
+#include <utility>
+
+namespace okapi {
+/**
+ * Anti-windup for a StaticPID which only clamps the integral to its limits.
+ */
+struct ClampAntiWindup {
+  /**
+   * @param iintegral The integral before this step.
+   * @param iincrement The change in the integral this step, `kI * error`.
+   * @param ierror The error this step.
+   * @param ilastError The error last step.
+   * @param isaturated Whether the output was at one of its limits last step.
+   * @param imin The min integral.
+   * @param imax The max integral.
+   * @return The integral after this step.
+   */
+  static double integrate(const double iintegral,
+                          const double iincrement,
+                          double /*ierror*/,
+                          double /*ilastError*/,
+                          bool /*isaturated*/,
+                          const double imin,
+                          const double imax) {
+    return std::clamp(iintegral + iincrement, imin, imax);
+  }
+};
+
+/**
+ * Anti-windup for a StaticPID which clamps the integral to its limits and resets it when the error
+ * crosses zero. This is what IterativePosPIDController does by default.
+ */
+struct ResetOnCrossAntiWindup {
+  /**
+   * See ClampAntiWindup::integrate.
+   */
+  static double integrate(const double iintegral,
+                          const double iincrement,
+                          const double ierror,
+                          const double ilastError,
+                          bool /*isaturated*/,
+                          const double imin,
+                          const double imax) {
+    if (std::signbit(ierror) != std::signbit(ilastError)) {
+      return 0;
+    }
+
+    return std::clamp(iintegral + iincrement, imin, imax);
+  }
+};
+
+/**
+ * Anti-windup for a StaticPID which stops integrating while the output is saturated, unless the
+ * error would unwind the integral. Also clamps the integral to its limits.
+ */
+struct ConditionalAntiWindup {
+  /**
+   * See ClampAntiWindup::integrate.
+   */
+  static double integrate(const double iintegral,
+                          const double iincrement,
+                          double /*ierror*/,
+                          double /*ilastError*/,
+                          const bool isaturated,
+                          const double imin,
+                          const double imax) {
+    if (isaturated && std::signbit(iincrement) == std::signbit(iintegral)) {
+      return std::clamp(iintegral, imin, imax);
+    }
+
+    return std::clamp(iintegral + iincrement, imin, imax);
+  }
+};
+
+/**
+ * Timing for a StaticPID which steps every time `step()` is called. Use this when the loop already
+ * runs at the sample time, like a task with a fixed delay.
+ */
+struct UngatedPidTiming {
+  /**
+   * @param isampleTime The sample time of the controller.
+   * @return Whether the controller should step now.
+   */
+  bool shouldStep(const QTime & /*isampleTime*/) {
+    return true;
+  }
+};
+
+/**
+ * Timing for a StaticPID which only steps once the sample time has passed since the last step,
+ * like IterativePosPIDController.
+ */
+class TimerGatedPidTiming {
+  public:
+  /**
+   * @param itimer The timer which measures the time between steps.
+   */
+  explicit TimerGatedPidTiming(std::unique_ptr<AbstractTimer> itimer) : timer(std::move(itimer)) {
+  }
+
+  /**
+   * See UngatedPidTiming::shouldStep.
+   */
+  bool shouldStep(const QTime &isampleTime) {
+    timer->placeHardMark();
+    if (timer->getDtFromHardMark() >= isampleTime) {
+      timer->clearHardMark();
+      return true;
+    }
+
+    return false;
+  }
+
+  protected:
+  std::unique_ptr<AbstractTimer> timer;
+};
+
+/**
+ * A position PID controller whose derivative filter, anti-windup, and timing are template
+ * parameters instead of virtual calls and runtime flags, so the compiler can inline the whole step.
+ * It is meant for fast inner loops. It does the same math as IterativePosPIDController, without
+ * the error sum limits, settling, or the ClosedLoopController interface.
+ *
+ * @tparam DerivativeFilter The filter for the derivative, like PassthroughFilter or EmaFilter.
+ * Stored by value, so its `filter()` is called without an indirect call.
+ * @tparam AntiWindup How the integral is bounded: ClampAntiWindup, ResetOnCrossAntiWindup, or
+ * ConditionalAntiWindup.
+ * @tparam Timing When the controller steps: UngatedPidTiming or TimerGatedPidTiming.
+ */
+template <typename DerivativeFilter = PassthroughFilter,
+          typename AntiWindup = ResetOnCrossAntiWindup,
+          typename Timing = UngatedPidTiming>
+class StaticPID {
+  public:
+  /**
+   * A position PID controller. The integral limits start at `[-1 / kI, 1 / kI]` if `kI` is not
+   * zero and `[-1, 1]` otherwise. The output limits start at `[-1, 1]`.
+   *
+   * @param igains The controller gains.
+   * @param isampleTime The time between steps.
+   * @param ifilter The derivative filter.
+   * @param itiming The timing.
+   */
+  explicit StaticPID(const IterativePosPIDController::Gains &igains,
+                     const QTime &isampleTime = 10_ms,
+                     DerivativeFilter ifilter = DerivativeFilter(),
+                     Timing itiming = Timing())
+    : sampleTime(isampleTime), derivativeFilter(std::move(ifilter)), timing(std::move(itiming)) {
+    if (igains.kI != 0) {
+      setIntegralLimits(1 / igains.kI, -1 / igains.kI);
+    }
+    setGains(igains);
+  }
+
+  /**
+   * Does one iteration of the controller, if the timing says it should.
+   *
+   * @param ireading The new measurement.
+   * @return The controller output.
+   */
+  double step(const double ireading) {
+    if (!timing.shouldStep(sampleTime)) {
+      return output;
+    }
+
+    const double readingDiff = ireading - lastReading;
+    lastReading = ireading;
+    error = target - ireading;
+
+    const bool saturated = output >= outputMax || output <= outputMin;
+    integral = AntiWindup::integrate(
+      integral, kI * error, error, lastError, saturated, integralMin, integralMax);
+
+    // Derivative over measurement to eliminate derivative kick on setpoint change
+    const double derivative = derivativeFilter.filter(readingDiff);
+    output = std::clamp(kP * error + integral - kD * derivative + kBias, outputMin, outputMax);
+    lastError = error;
+    return output;
+  }
+
+  /**
+   * Sets the target.
+   *
+   * @param itarget The new target.
+   */
+  void setTarget(const double itarget) {
+    target = itarget;
+  }
+
+  /**
+   * @return The target.
+   */
+  double getTarget() const {
+    return target;
+  }
+
+  /**
+   * @return The error at the last step.
+   */
+  double getError() const {
+    return error;
+  }
+
+  /**
+   * @return The last output.
+   */
+  double getOutput() const {
+    return output;
+  }
+
+  /**
+   * Sets the gains, like IterativePosPIDController::setGains.
+   *
+   * @param igains The new gains.
+   */
+  void setGains(const IterativePosPIDController::Gains &igains) {
+    const double sampleTimeSec = sampleTime.convert(second);
+    kP = igains.kP;
+    kI = igains.kI * sampleTimeSec;
+    kD = igains.kD / sampleTimeSec;
+    kBias = igains.kBias;
+  }
+
+  /**
+   * @return The gains.
+   */
+  IterativePosPIDController::Gains getGains() const {
+    const double sampleTimeSec = sampleTime.convert(second);
+    return {kP, kI / sampleTimeSec, kD * sampleTimeSec, kBias};
+  }
+
+  /**
+   * Sets the output limits.
+   *
+   * @param imax The max output.
+   * @param imin The min output.
+   */
+  void setOutputLimits(double imax, double imin) {
+    if (imin > imax) {
+      std::swap(imax, imin);
+    }
+
+    outputMax = imax;
+    outputMin = imin;
+    output = std::clamp(output, outputMin, outputMax);
+  }
+
+  /**
+   * Sets the integral limits.
+   *
+   * @param imax The max integral.
+   * @param imin The min integral.
+   */
+  void setIntegralLimits(double imax, double imin) {
+    if (imin > imax) {
+      std::swap(imax, imin);
+    }
+
+    integralMax = imax;
+    integralMin = imin;
+    integral = std::clamp(integral, integralMin, integralMax);
+  }
+
+  /**
+   * @return The time between steps.
+   */
+  QTime getSampleTime() const {
+    return sampleTime;
+  }
+
+  /**
+   * Resets the state of the controller.
+   */
+  void reset() {
+    error = 0;
+    lastError = 0;
+    lastReading = 0;
+    integral = 0;
+    output = 0;
+  }
+
+  protected:
+  double kP{0}, kI{0}, kD{0}, kBias{0};
+  QTime sampleTime;
+  double target{0};
+  double lastReading{0};
+  double error{0};
+  double lastError{0};
+  double integral{0};
+  double integralMax{1};
+  double integralMin{-1};
+  double output{0};
+  double outputMax{1};
+  double outputMin{-1};
+  DerivativeFilter derivativeFilter;
+  Timing timing;
+};
+} // namespace okapi
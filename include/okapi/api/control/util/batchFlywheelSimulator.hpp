@@ -0,0 +1,167 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#pragma once
+
+#include "okapi/api/util/mathUtil.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <vector>
+
+namespace okapi {
+/**
+ * The torque due to gravity on a pendulum, the default external torque of FlywheelSimulator.
+ */
+struct FlywheelGravityTorque {
+  double operator()(const double iangle, const double imass, const double ilinkLen) const {
+    return (ilinkLen * std::cos(iangle)) * (imass * -1 * gravity);
+  }
+};
+
+/**
+ * Simulates many FlywheelSimulators at once. The state of every instance is kept in its own array
+ * and every instance is stepped in one branchless loop, which the compiler can vectorize, instead
+ * of through a virtual step and a `std::function` per instance. An instance follows exactly the
+ * same path as a FlywheelSimulator with the same constants and the default integrator.
+ *
+ * @tparam TorqueModel The external torque, called as `double(double angle, double mass, double
+ * linkLength)`. Use a function object so the call can be inlined; a function pointer works too,
+ * but must be given to the constructor.
+ */
+template <typename TorqueModel = FlywheelGravityTorque> class BatchFlywheelSimulator {
+  public:
+  /**
+   * @param itimestep The timestep of every instance.
+   * @param imodel The external torque.
+   */
+  explicit BatchFlywheelSimulator(const double itimestep = 0.01,
+                                  TorqueModel imodel = TorqueModel())
+    : timestep(std::max(itimestep, minTimestep)), model(imodel) {
+  }
+
+  /**
+   * Adds an instance at rest at zero angle.
+   *
+   * @return The index of the instance.
+   */
+  std::size_t add(const double imass = 0.01,
+                  const double ilinkLen = 1,
+                  const double imuStatic = 0.1,
+                  const double imuDynamic = 0.9) {
+    const double mass = std::max(imass, 0.0);
+    const double linkLen = std::max(ilinkLen, 0.0);
+    masses.push_back(mass);
+    linkLens.push_back(linkLen);
+    inertias.push_back(mass * ipow(linkLen, 2));
+    muStatics.push_back(std::max(imuStatic, 0.0));
+    muDynamics.push_back(std::max(imuDynamic, 0.0));
+    maxTorques.push_back(0.5649);
+    inputTorques.push_back(0);
+    angles.push_back(0);
+    omegas.push_back(0);
+    accels.push_back(0);
+    return angles.size() - 1;
+  }
+
+  /**
+   * Steps every instance by the timestep.
+   */
+  void step() {
+    const std::size_t count = angles.size();
+    const double timestepSquared = ipow(timestep, 2);
+
+    double *const angle = angles.data();
+    double *const omega = omegas.data();
+    double *const accel = accels.data();
+    const double *const inputTorque = inputTorques.data();
+    const double *const mass = masses.data();
+    const double *const linkLen = linkLens.data();
+    const double *const inertia = inertias.data();
+    const double *const muStatic = muStatics.data();
+    const double *const muDynamic = muDynamics.data();
+
+    for (std::size_t i = 0; i < count; i++) {
+      double torqueTotal = inputTorque[i] + model(angle[i], mass[i], linkLen[i]);
+      torqueTotal = (omega[i] == 0 && muStatic[i] > std::fabs(torqueTotal)) ? 0 : torqueTotal;
+
+      // FlywheelSimulator takes the same friction off either way the torque points
+      torqueTotal -= muDynamic[i] * omega[i];
+
+      accel[i] = torqueTotal / inertia[i];
+      double newOmega = omega[i] + accel[i] * timestepSquared;
+      double newAngle = angle[i] + newOmega * timestep;
+
+      const bool overTop = radianToDegree * newAngle > 181;
+      const bool belowBottom = radianToDegree * newAngle < -1;
+      newAngle = overTop ? pi : (belowBottom ? 0 : newAngle);
+      newOmega = (overTop || belowBottom) ? 0 : newOmega;
+
+      angle[i] = newAngle;
+      omega[i] = newOmega;
+    }
+  }
+
+  /**
+   * Sets the input torque of an instance. The input will be bounded by the max torque.
+   */
+  void setTorque(const std::size_t iindex, const double itorque) {
+    inputTorques.at(iindex) = std::fabs(itorque) <= std::fabs(maxTorques.at(iindex))
+                           ? itorque
+                           : std::copysign(maxTorques.at(iindex), itorque);
+  }
+
+  void setMaxTorque(const std::size_t iindex, const double imaxTorque) {
+    maxTorques.at(iindex) = imaxTorque;
+  }
+
+  void setAngle(const std::size_t iindex, const double iangle) {
+    angles.at(iindex) = iangle;
+  }
+
+  /**
+   * @return The number of instances.
+   */
+  std::size_t size() const {
+    return angles.size();
+  }
+
+  double getAngle(const std::size_t iindex) const {
+    return angles.at(iindex);
+  }
+
+  double getOmega(const std::size_t iindex) const {
+    return omegas.at(iindex);
+  }
+
+  double getAcceleration(const std::size_t iindex) const {
+    return accels.at(iindex);
+  }
+
+  /**
+   * @return The angle of every instance, by index.
+   */
+  const std::vector<double> &getAngles() const {
+    return angles;
+  }
+
+  protected:
+  static constexpr double minTimestep = 0.000001; // 1 us
+
+  double timestep; // sec
+  TorqueModel model;
+
+  std::vector<double> inputTorques{}; // N*m
+  std::vector<double> maxTorques{};   // N*m
+  std::vector<double> angles{};       // rad
+  std::vector<double> omegas{};       // rad / sec
+  std::vector<double> accels{};       // rad / sec^2
+  std::vector<double> masses{};       // kg
+  std::vector<double> linkLens{};     // m
+  std::vector<double> inertias{};     // moment of inertia
+  std::vector<double> muStatics{};    // N*m
+  std::vector<double> muDynamics{};   // N*m
+};
+} // namespace okapi
@@ -0,0 +1,142 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#pragma once
+
+#include "okapi/api/coreProsAPI.hpp"
+#include "okapi/api/units/QTime.hpp"
+#include "okapi/api/util/logging.hpp"
+#include "okapi/api/util/timeUtil.hpp"
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <vector>
+
+namespace okapi {
+/**
+ * Runs the loops of many controllers from one task instead of giving each controller its own task.
+ * Each loop is stepped at its own period. Loops which are due at the same time are stepped in
+ * order of their phase, then in the order they were added, and loops with the same period stay in
+ * phase with each other. Giving the sensors, odometry, controllers, and motor writes the same
+ * period makes each tick read the sensors, update the odometry, step the controllers, and write the
+ * motors in that order, so a reading reaches the motors in the same tick instead of waiting for
+ * the next step of whichever loop runs before it.
+ */
+class ControlScheduler {
+  public:
+  /**
+   * Where a loop is stepped within a tick.
+   */
+  enum class phase {
+    sensors,     ///< Reads the sensors
+    odometry,    ///< Updates the odometry from the sensors
+    controllers, ///< Steps the controllers from the odometry and the sensors
+    actuators    ///< Writes the controllers' outputs to the motors
+  };
+
+  /**
+   * The longest time the scheduler task sleeps while it has no loops.
+   */
+  static constexpr std::uint32_t idleLoopTimeout = 100;
+
+  /**
+   * Runs the loops of many controllers from one task. Call `startThread()` to start the task.
+   *
+   * @param itimeUtil The timer used to decide when each loop is due.
+   * @param ilogger The logger this instance will log to.
+   */
+  explicit ControlScheduler(const TimeUtil &itimeUtil,
+                            std::shared_ptr<Logger> ilogger = Logger::getDefaultLogger());
+
+  ControlScheduler(const ControlScheduler &) = delete;
+  ControlScheduler &operator=(const ControlScheduler &) = delete;
+
+  /**
+   * Stops the scheduler task. The loops which are still added are not stepped again.
+   */
+  ~ControlScheduler();
+
+  /**
+   * Adds a loop. It is first stepped on the next pass of the scheduler task.
+   *
+   * @param istep The function to call each time the loop is due.
+   * @param iperiod Returns the time between steps. This is read after every step so the period can
+   * change, for example when a controller's sample time is changed.
+   * @param iphase Where the loop is stepped within a tick.
+   * @return The id of the loop, used to remove it.
+   */
+  std::size_t addLoop(std::function<void()> istep,
+                      std::function<QTime()> iperiod,
+                      phase iphase = phase::controllers);
+
+  /**
+   * Removes a loop. When this returns, the loop is not being stepped and won't be stepped again.
+   * This must not be called from inside a step.
+   *
+   * @param iid The id returned by `addLoop()`.
+   */
+  void removeLoop(std::size_t iid);
+
+  /**
+   * @return The number of loops which are added.
+   */
+  std::size_t getLoopCount() const;
+
+  /**
+   * @return The number of times a loop was stepped a whole period or more after it was due. Those
+   * missed steps are skipped instead of being run back to back.
+   */
+  std::uint32_t getOverrunCount() const;
+
+  /**
+   * Starts the internal thread. This should not be called by normal users.
+   *
+   * @param ipriority The priority of the task.
+   * @param istackDepth The stack depth of the task in words.
+   */
+  void startThread(std::uint32_t ipriority = TASK_PRIORITY_DEFAULT,
+                   std::uint16_t istackDepth = TASK_STACK_DEPTH_DEFAULT);
+
+  /**
+   * Returns the underlying thread handle.
+   *
+   * @return The underlying thread handle.
+   */
+  CrossplatformThread *getThread() const;
+
+  protected:
+  struct Loop {
+    std::size_t id;
+    phase loopPhase;
+    std::function<void()> step;
+    std::function<QTime()> period;
+    QTime nextRun;
+    bool started;
+  };
+
+  std::shared_ptr<Logger> logger;
+  TimeUtil timeUtil;
+  std::unique_ptr<AbstractTimer> timer;
+  std::vector<Loop> loops{};
+  std::size_t nextId{0};
+  std::atomic_uint32_t overrunCount{0};
+  // Held while the loops are stepped so removeLoop() can't return during a step
+  mutable CrossplatformMutex loopsMutex;
+  std::atomic_bool dtorCalled{false};
+  CrossplatformThread *task{nullptr};
+
+  static void trampoline(void *context);
+  void loop();
+
+  /**
+   * Steps each loop which is due, in order of their phase and then in the order they were added.
+   *
+   * @param inow The current time.
+   * @return The time the next loop is due, or `inow` plus `idleLoopTimeout` if there are no loops.
+   */
+  QTime stepDueLoops(QTime inow);
+};
+} // namespace okapi
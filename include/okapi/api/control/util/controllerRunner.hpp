@@ -39,9 +39,8 @@ template <typename Input, typename Output> class ControllerRunner {
              std::to_string(itarget));
     icontroller.setTarget(itarget);
 
-    while (!icontroller.isSettled()) {
-      rate->delayUntil(10_ms);
-    }
+    // Async controllers wake the waiting task when they settle instead of being polled
+    icontroller.waitUntilSettled();
 
     LOG_INFO("ControllerRunner: runUntilSettled(AsyncController): Done waiting to settle");
     return icontroller.getError();
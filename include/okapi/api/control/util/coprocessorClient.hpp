@@ -0,0 +1,93 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#pragma once
+
+#include "okapi/api/control/util/pathfinderUtil.hpp"
+#include "okapi/api/odometry/odometry.hpp"
+#include "okapi/api/units/QSpeed.hpp"
+#include "okapi/api/util/logging.hpp"
+#include "okapi/api/util/serialLink.hpp"
+#include "okapi/api/util/timeUtil.hpp"
+#include <memory>
+#include <optional>
+#include <vector>
+
+#include "squiggles.hpp"
+
+namespace okapi {
+/**
+ * The messages okapi exchanges with a coprocessor over a `SerialLink`, so path generation and
+ * localization can run off the brain. The coprocessor answers the requests below and sends pose
+ * estimates whenever it has one. All values are little-endian 32-bit floats unless noted, with
+ * distances in meters, velocities in m/s, and angles in radians, in the
+ * `StateMode::FRAME_TRANSFORMATION` format.
+ *
+ * A profile request (type `generateProfileType`) is:
+ *
+ *  - The wheel track, the start velocity, and the end velocity
+ *  - The maximum velocity, acceleration, and jerk
+ *  - For each waypoint, x, y, and theta
+ *
+ * Its response is the profile in `PathBinaryFormat`, in either version.
+ *
+ * A pose estimate message (type `poseEstimateType`) is:
+ *
+ *  - 2 bytes: the age of the estimate in milliseconds, as an unsigned integer
+ *  - x, y, and theta
+ */
+class CoprocessorClient {
+  public:
+  static constexpr std::uint8_t generateProfileType = 0x10;
+  static constexpr std::uint8_t poseEstimateType = 0x20;
+
+  /**
+   * Talks to a coprocessor over a link. The link must be receiving, either from its own task (see
+   * `SerialLink::startThread()`) or by being stepped.
+   *
+   * @param ilink The link to the coprocessor.
+   * @param itimeUtil The TimeUtil used to date pose estimates.
+   * @param itimeout How long to wait for the coprocessor to answer a request.
+   * @param ilogger The logger this instance will log to.
+   */
+  CoprocessorClient(std::shared_ptr<SerialLink> ilink,
+                    const TimeUtil &itimeUtil,
+                    const QTime &itimeout = 2_s,
+                    std::shared_ptr<Logger> ilogger = Logger::getDefaultLogger());
+
+  /**
+   * Asks the coprocessor to generate a profile through the waypoints. Blocks until the profile
+   * arrives or the request times out.
+   *
+   * @param iwaypoints The waypoints to hit on the path.
+   * @param ilimits The limits to use for the path.
+   * @param iwheelTrack The distance between the left and right wheels.
+   * @param istartVelocity The linear velocity at the start of the path.
+   * @param iendVelocity The linear velocity at the end of the path.
+   * @return The profile, or `std::nullopt` if the coprocessor did not answer with a valid profile.
+   */
+  std::optional<std::vector<squiggles::ProfilePoint>>
+  generateProfile(const std::vector<PathfinderPoint> &iwaypoints,
+                  const PathfinderLimits &ilimits,
+                  const QLength &iwheelTrack,
+                  const QSpeed &istartVelocity = 0_mps,
+                  const QSpeed &iendVelocity = 0_mps);
+
+  /**
+   * Corrects an odometry with every pose estimate the coprocessor sends, using
+   * `Odometry::applyPoseEstimate()`. Pass `nullptr` to stop.
+   *
+   * @param iodometry The odometry to correct.
+   * @param iweight How much to trust each estimate, from 0 to 1.
+   */
+  void forwardPoseEstimates(const std::shared_ptr<Odometry> &iodometry, double iweight = 1);
+
+  protected:
+  std::shared_ptr<Logger> logger;
+  std::shared_ptr<SerialLink> link;
+  TimeUtil timeUtil;
+  QTime timeout;
+};
+} // namespace okapi
@@ -0,0 +1,148 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#pragma once
+
+#include "okapi/api/units/QLength.hpp"
+#include "okapi/api/units/QSpeed.hpp"
+#include "okapi/api/units/QTime.hpp"
+#include "okapi/api/util/logging.hpp"
+#include <array>
+#include <cstddef>
+#include <memory>
+#include <utility>
+
+namespace okapi {
+/**
+ * The weights and solver settings of a DiffDriveMpc.
+ */
+struct DiffDriveMpcParams {
+  /**
+   * The cost per m^2 of position error, forward and sideways.
+   */
+  double positionWeight{20};
+
+  /**
+   * The cost per rad^2 of heading error.
+   */
+  double headingWeight{2};
+
+  /**
+   * The cost per (m/s)^2 of change to a wheel velocity of the profile. Smaller values correct
+   * errors harder.
+   */
+  double controlWeight{0.1};
+
+  /**
+   * The time between steps of the prediction. The horizon is `DiffDriveMpc::horizon` of these.
+   */
+  QTime modelStep{50_ms};
+
+  /**
+   * The number of projected gradient iterations per call to `step()`.
+   */
+  std::size_t iterations{10};
+};
+
+/**
+ * A small model predictive controller which keeps a skid-steer chassis on a profile. Every step,
+ * it predicts how the pose error evolves over a fixed horizon with the differential drive model
+ * linearized around the profile, and picks the changes to the profile's wheel velocities which
+ * minimize the error and the size of the changes. Unlike Ramsete, it knows the wheels can't go
+ * faster than their max velocity, so it corrects with what is left instead of asking for speed the
+ * motors can't give, which lets profiles run closer to the limits of the chassis.
+ *
+ * The quadratic program is condensed to only the wheel velocity changes, whose limits are a box,
+ * and solved with a few projected gradient iterations warm-started from the last solution. The
+ * linearization depends on the velocity of the profile, so the program is rebuilt every step, but
+ * all of its storage is fixed-size and inside this object, so stepping never allocates.
+ */
+class DiffDriveMpc {
+  public:
+  /**
+   * The number of model steps predicted.
+   */
+  static constexpr std::size_t horizon = 10;
+
+  /**
+   * Throws a `std::invalid_argument` if the wheel track, max wheel velocity, or model step is not
+   * positive, or a weight is negative.
+   *
+   * @param iwheelTrack The distance between the left and right wheels.
+   * @param imaxWheelVelocity The fastest a wheel can go.
+   * @param iparams The weights and solver settings.
+   * @param ilogger The logger this instance will log to.
+   */
+  DiffDriveMpc(const QLength &iwheelTrack,
+               const QSpeed &imaxWheelVelocity,
+               const DiffDriveMpcParams &iparams = {},
+               const std::shared_ptr<Logger> &ilogger = Logger::getDefaultLogger());
+
+  /**
+   * Computes the wheel velocities which bring the robot back to the profile. The error is the pose
+   * the profile wants the robot at, in the frame of the robot, with +x forward and
+   * counter-clockwise positive angles.
+   *
+   * @param ixError The forward error in m.
+   * @param iyError The sideways (left) error in m.
+   * @param iheadingError The heading error in rad, in `[-pi, pi]`.
+   * @param ivelocity The linear velocity of the profile in m/s.
+   * @param iangularVelocity The angular velocity of the profile in rad/s.
+   * @return The left and right wheel velocities in m/s, within the max wheel velocity.
+   */
+  std::pair<double, double> step(double ixError,
+                                 double iyError,
+                                 double iheadingError,
+                                 double ivelocity,
+                                 double iangularVelocity);
+
+  /**
+   * Forgets the last solution, so the next step starts from following the profile unchanged. Call
+   * this before following a new profile.
+   */
+  void reset();
+
+  /**
+   * @return The weights and solver settings.
+   */
+  const DiffDriveMpcParams &getParams() const;
+
+  protected:
+  static constexpr std::size_t states = 3;
+  static constexpr std::size_t inputs = 2;
+  static constexpr std::size_t variables = inputs * horizon;
+
+  using State = std::array<double, states>;
+  using StateMatrix = std::array<State, states>;
+  // Maps the wheel velocity changes of one step to the change in the state
+  using InputMatrix = std::array<std::array<double, inputs>, states>;
+
+  std::shared_ptr<Logger> logger;
+  double wheelTrack;
+  double maxWheelVelocity;
+  DiffDriveMpcParams params;
+
+  // Ad^k Bd for k in [0, horizon), the effect of an input k steps later
+  std::array<InputMatrix, horizon> inputResponse{};
+  // Ad^(k + 1) e0 for k in [0, horizon), the error if the profile is followed unchanged
+  std::array<State, horizon> freeResponse{};
+  std::array<std::array<double, variables>, variables> hessian{};
+  std::array<double, variables> gradientOffset{};
+  std::array<double, variables> lower{};
+  std::array<double, variables> upper{};
+  // The wheel velocity changes, kept between steps to warm-start the next solve
+  std::array<double, variables> solution{};
+
+  /**
+   * Builds the condensed program for the current error and profile velocities.
+   */
+  void buildProgram(const State &ierror, double ivelocity, double iangularVelocity);
+
+  /**
+   * Runs the projected gradient iterations on the program.
+   */
+  void solve();
+};
+} // namespace okapi
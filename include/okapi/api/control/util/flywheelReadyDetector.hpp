@@ -0,0 +1,160 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#pragma once
+
+#include "okapi/api/filter/averageFilter.hpp"
+#include "okapi/api/units/QTime.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <optional>
+
+namespace okapi {
+/**
+ * Decides when a flywheel is ready to fire. `SettledUtil` only looks at the error, so it can say a
+ * flywheel is settled while its velocity is still oscillating around the target. This detector
+ * also requires the velocity to be steady: the mean error and the standard deviation of the
+ * velocity over the last `n` samples must both be small. The window is kept with running sums, so
+ * each step is constant time no matter how long the window is.
+ *
+ * It can also predict when a recovering flywheel will be back within tolerance, so the shot can be
+ * started that far ahead of time instead of after a fixed delay.
+ *
+ * @tparam n The number of samples in the window.
+ */
+template <std::size_t n> class FlywheelReadyDetector {
+  public:
+  /**
+   * @param itolerance How far the velocity may be from the target, in rpm.
+   * @param imaxStdDev The largest standard deviation of the velocity over the window, in rpm.
+   * @param isampleTime The time between calls to `step()`.
+   */
+  FlywheelReadyDetector(const double itolerance,
+                        const double imaxStdDev,
+                        const QTime isampleTime = 10_ms)
+    : tolerance(std::abs(itolerance)), maxStdDev(std::abs(imaxStdDev)), sampleTime(isampleTime) {
+  }
+
+  /**
+   * Adds a velocity sample. Changing the target clears the window.
+   *
+   * @param ivelocity The velocity, in rpm.
+   * @param itarget The target velocity, in rpm.
+   * @return Whether the flywheel is ready.
+   */
+  bool step(const double ivelocity, const double itarget) {
+    if (itarget != target) {
+      reset();
+      target = itarget;
+    }
+
+    // The window holds errors instead of velocities, which keeps the sums small so the variance
+    // does not lose precision
+    const double error = ivelocity - target;
+    if (count > 0) {
+      changes.filter(error - lastError);
+    }
+    lastError = error;
+
+    errors.filter(error);
+    squaredErrors.filter(error * error);
+    // The window of changes fills one sample after the others
+    count = std::min(count + 1, n + 1);
+
+    return isReady();
+  }
+
+  /**
+   * @return Whether the window is full, the latest velocity and the mean velocity are within
+   * tolerance of the target, and the velocity is steady.
+   */
+  bool isReady() const {
+    return count >= n && std::abs(lastError) <= tolerance &&
+           std::abs(errors.getOutput()) <= tolerance && getStdDev() <= maxStdDev;
+  }
+
+  /**
+   * Predicts when the velocity will be within tolerance of the target, by extrapolating its mean
+   * rate of change over the window. A recovering flywheel is not steady, so this does not
+   * consider the standard deviation.
+   *
+   * @return The time until the velocity is within tolerance, which is zero if it already is, or
+   * nothing if the window is not full or the velocity is not moving towards the target.
+   */
+  std::optional<QTime> getTimeUntilReady() const {
+    if (count <= n) {
+      return std::nullopt;
+    }
+
+    const double distance = std::abs(lastError) - tolerance;
+    if (distance <= 0) {
+      return 0_ms;
+    }
+
+    // The change per sample must point towards the target
+    const double change = changes.getOutput();
+    if (change == 0 || std::signbit(change) == std::signbit(lastError)) {
+      return std::nullopt;
+    }
+
+    return distance / std::abs(change) * sampleTime;
+  }
+
+  /**
+   * Returns whether the flywheel is ready, or will be back within tolerance of the target within
+   * the lead time. Use the time it takes a game element to reach the flywheel as the lead time to
+   * start feeding it while the flywheel is still recovering.
+   *
+   * @param ilead How far ahead to look.
+   * @return Whether the flywheel is or will be ready.
+   */
+  bool isReadyWithin(const QTime ilead) const {
+    if (isReady()) {
+      return true;
+    }
+
+    const auto timeUntilReady = getTimeUntilReady();
+    return timeUntilReady && *timeUntilReady <= ilead;
+  }
+
+  /**
+   * @return The mean velocity over the window, in rpm.
+   */
+  double getMean() const {
+    return target + errors.getOutput();
+  }
+
+  /**
+   * @return The standard deviation of the velocity over the window, in rpm.
+   */
+  double getStdDev() const {
+    const double mean = errors.getOutput();
+    return std::sqrt(std::max(squaredErrors.getOutput() - mean * mean, 0.0));
+  }
+
+  /**
+   * Clears the window.
+   */
+  void reset() {
+    errors = AverageFilter<n>();
+    squaredErrors = AverageFilter<n>();
+    changes = AverageFilter<n>();
+    lastError = 0;
+    count = 0;
+  }
+
+  protected:
+  double tolerance;
+  double maxStdDev;
+  QTime sampleTime;
+  double target{0};
+  double lastError{0};
+  std::size_t count{0};
+  AverageFilter<n> errors;
+  AverageFilter<n> squaredErrors;
+  AverageFilter<n> changes;
+};
+} // namespace okapi
@@ -10,15 +10,47 @@
 namespace okapi {
 class FlywheelSimulator {
   public:
+  /**
+   * How the simulator moves its state forward by a timestep.
+   */
+  enum class Integrator {
+    /**
+     * The original first-order scheme. Its velocity change is scaled by an extra timestep, so the
+     * system responds more slowly than its constants say. It is the default so anything tuned
+     * against it keeps its behavior.
+     */
+    euler,
+
+    /**
+     * Semi-implicit (symplectic) Euler. First-order, but stable over long runs at large
+     * timesteps.
+     */
+    semiImplicitEuler,
+
+    /**
+     * Classical fourth-order Runge-Kutta. Accurate at timesteps 10-100x larger than the first-order
+     * schemes need.
+     */
+    rk4
+  };
+
   /**
    * A simulator for an inverted pendulum. The center of mass of the system changes as the link
    * rotates (by default, you can set a new torque function with setExternalTorqueFunction()).
+   *
+   * @param imass the mass (kg)
+   * @param ilinkLen the link length (m)
+   * @param imuStatic the static friction (N*m)
+   * @param imuDynamic the dynamic friction (N*m)
+   * @param itimestep the timestep (sec)
+   * @param iintegrator how the state is moved forward by a timestep
    */
   explicit FlywheelSimulator(double imass = 0.01,
                              double ilinkLen = 1,
                              double imuStatic = 0.1,
                              double imuDynamic = 0.9,
-                             double itimestep = 0.01);
+                             double itimestep = 0.01,
+                             Integrator iintegrator = Integrator::euler);
 
   virtual ~FlywheelSimulator();
 
@@ -147,10 +179,16 @@ class FlywheelSimulator {
   double muDynamic;          // N*m
   double timestep;           // sec
   double I = 0;              // moment of inertia
+  Integrator integrator;
   std::function<double(double, double, double)> torqueFunc;
 
   const double minTimestep = 0.000001; // 1 us
 
   virtual double stepImpl();
+
+  /**
+   * @return The angular acceleration at a state, given the input torque.
+   */
+  double computeAcceleration(double iangle, double iomega) const;
 };
 } // namespace okapi
@@ -0,0 +1,102 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#pragma once
+
+#include "okapi/api/control/util/pathfinderUtil.hpp"
+#include "okapi/api/units/QLength.hpp"
+#include "okapi/api/units/QSpeed.hpp"
+#include "okapi/api/util/logging.hpp"
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+#include "squiggles.hpp"
+
+namespace okapi {
+/**
+ * Generates skid-steer profiles one spline segment at a time and remembers the segments, so a path
+ * which is edited one waypoint at a time only regenerates the segments next to the changed
+ * waypoints. The curves are the same as `ProfileGenerator` makes, because squiggles fits every
+ * pair of consecutive waypoints with its own spline.
+ *
+ * The segments are joined and the whole profile is re-timed to the limits of this generator: the
+ * robot speeds up and slows down at the max acceleration and slows down for curves so the outer
+ * wheel stays within the max velocity, like `squiggles::TankModel`. Re-timing is linear in the
+ * number of points, which is cheap next to generating the splines. Jerk is not limited. The points
+ * are not evenly spaced in time, so they are followed by sampling them by their times (see
+ * `ProfileResampler`).
+ *
+ * This is not thread-safe.
+ */
+class IncrementalPathGenerator {
+  public:
+  /**
+   * Throws a `std::invalid_argument` if the max velocity or acceleration is not positive.
+   *
+   * @param ilimits The limits to use for the paths.
+   * @param iwheelTrack The distance between the left and right wheels.
+   * @param ilogger The logger this instance will log to.
+   */
+  IncrementalPathGenerator(const PathfinderLimits &ilimits,
+                           const QLength &iwheelTrack,
+                           const std::shared_ptr<Logger> &ilogger = Logger::getDefaultLogger());
+
+  /**
+   * Generates a profile through the waypoints, reusing the segments between consecutive waypoints
+   * which are the same as in an earlier call. Segments which are not used by this call are
+   * forgotten.
+   *
+   * If there are fewer than two waypoints, or either velocity is negative or above the max
+   * velocity, an instance of `std::invalid_argument` is thrown. If the waypoints form a path which
+   * is impossible to achieve, an instance of `std::runtime_error` is thrown. The remembered
+   * segments are not changed if anything is thrown.
+   *
+   * NOTE: The waypoints are expected to be in the okapi::State::FRAME_TRANSFORMATION format where
+   * +x is forward, +y is right, and 0 theta is measured from the +x axis to the +y axis.
+   *
+   * @param iwaypoints The waypoints to hit on the path.
+   * @param istartVelocity The linear velocity at the start of the path.
+   * @param iendVelocity The linear velocity at the end of the path.
+   * @return The generated profile.
+   */
+  std::vector<squiggles::ProfilePoint> generate(const std::vector<PathfinderPoint> &iwaypoints,
+                                                const QSpeed &istartVelocity = 0_mps,
+                                                const QSpeed &iendVelocity = 0_mps);
+
+  /**
+   * Forgets all the remembered segments.
+   */
+  void clear();
+
+  /**
+   * @return How many segments the last call to `generate()` had to generate.
+   */
+  std::size_t getGeneratedSegmentCount() const;
+
+  /**
+   * @return The limits the paths are generated with.
+   */
+  const PathfinderLimits &getLimits() const;
+
+  protected:
+  struct Segment {
+    PathfinderPoint start;
+    PathfinderPoint end;
+    std::vector<squiggles::ProfilePoint> profile;
+  };
+
+  std::shared_ptr<Logger> logger;
+  PathfinderLimits limits;
+  QLength wheelTrack;
+  std::vector<Segment> segments{};
+  std::size_t generatedSegmentCount{0};
+
+  /**
+   * @return Whether the waypoints are exactly the same.
+   */
+  static bool isSameWaypoint(const PathfinderPoint &ia, const PathfinderPoint &ib);
+};
+} // namespace okapi
@@ -0,0 +1,85 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#pragma once
+
+#include "okapi/api/coreProsAPI.hpp"
+#include <atomic>
+#include <cstdint>
+
+namespace okapi {
+/**
+ * Decides when a motor's onboard position control has finished a movement, from readings one task
+ * takes of the motor once per tick (such as the cached telemetry of a Motor in snapshot mode), and
+ * wakes the tasks waiting for it. A movement is done once the position is within tolerance and the
+ * motor has stopped, so unlike `SettledUtil` it does not have to sit at the target for a while
+ * first, and waiting tasks don't have to read the motor themselves.
+ *
+ * Only one task may call `update()`. Any task may call the other methods.
+ */
+class IntegratedSettleTracker {
+  public:
+  /**
+   * @param iatTargetError The largest position error to be considered settled. The default is the
+   * same as SettledUtil's.
+   * @param iatTargetVelocity The largest velocity, in rpm, of a motor which is stopped.
+   * @param iupdates The number of updates in a row which must find the motor settled. The first
+   * reading after a new target can be from before the motor started moving, so this should be at
+   * least 2.
+   */
+  explicit IntegratedSettleTracker(double iatTargetError = 50,
+                                   double iatTargetVelocity = 5,
+                                   std::uint32_t iupdates = 2);
+
+  /**
+   * Adds a reading of the motor. Wakes the waiting tasks when the motor settles.
+   *
+   * @param ierror The position error.
+   * @param ivelocity The velocity in rpm.
+   * @param istopped Whether the motor says it is stopped.
+   * @return Whether the motor is settled.
+   */
+  bool update(double ierror, double ivelocity, bool istopped);
+
+  /**
+   * Starts a new movement, which is not settled until enough updates after this find it settled.
+   */
+  void reset();
+
+  /**
+   * @return Whether the motor is settled as of the last update.
+   */
+  bool isSettled() const;
+
+  /**
+   * @return Whether update() was ever called. Until then, nothing is tracking the motor.
+   */
+  bool isTracking() const;
+
+  /**
+   * @return The current generation of the settled event. Read this before checking isSettled().
+   */
+  std::uint32_t getGeneration() const;
+
+  /**
+   * Blocks until the motor settles after `igeneration` or the timeout passes. This can return
+   * early, so isSettled() must be checked again afterwards.
+   *
+   * @param igeneration The generation read before isSettled() was last checked.
+   * @param itimeout The longest time to wait in milliseconds.
+   */
+  void waitFor(std::uint32_t igeneration, std::uint32_t itimeout);
+
+  protected:
+  double atTargetError;
+  double atTargetVelocity;
+  std::uint32_t updatesToSettle;
+  // The number of updates in a row which found the motor settled. A reset from another task
+  // clears it, so an update which read the motor before the reset counts at most once.
+  std::atomic_uint32_t settledUpdates{0};
+  std::atomic_bool tracking{false};
+  CrossplatformEvent settledEvent;
+};
+} // namespace okapi
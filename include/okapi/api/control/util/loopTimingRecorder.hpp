@@ -0,0 +1,90 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#pragma once
+
+#include "okapi/api/coreProsAPI.hpp"
+#include "okapi/api/units/QTime.hpp"
+#include <array>
+#include <cstdint>
+#include <string>
+
+namespace okapi {
+/**
+ * The distribution of the time between the steps of a control loop.
+ */
+struct LoopTimingStats {
+  /**
+   * The number of times between steps which were recorded.
+   */
+  std::uint32_t sampleCount{0};
+
+  /**
+   * The number of times between steps which were longer than the loop's period.
+   */
+  std::uint32_t overrunCount{0};
+
+  QTime minDt{0_ms};
+  QTime maxDt{0_ms};
+  QTime meanDt{0_ms};
+
+  /**
+   * 99% of the times between steps were no longer than this, to the nearest millisecond.
+   */
+  QTime p99Dt{0_ms};
+
+  /**
+   * @return The stats in a form suitable for logging.
+   */
+  std::string toString() const;
+};
+
+/**
+ * Records the time between the steps of a control loop without allocating. The 99th percentile
+ * is read from a histogram with one millisecond bins, which is the resolution of the system timer.
+ */
+class LoopTimingRecorder {
+  public:
+  /**
+   * The number of histogram bins. Times between steps of this many milliseconds or longer are
+   * counted in the last bin.
+   */
+  static constexpr std::size_t histogramSize = 128;
+
+  /**
+   * @param isource The name of the loop, which overruns are recorded to the default
+   * `FlightRecorder` with. It must be a string literal.
+   */
+  explicit LoopTimingRecorder(const char *isource = "LoopTimingRecorder");
+
+  /**
+   * Records the time between two steps.
+   *
+   * @param idt The time since the previous step.
+   * @param iperiod The period the loop is meant to run at. Longer times count as overruns.
+   */
+  void record(QTime idt, QTime iperiod);
+
+  /**
+   * @return The stats of every time recorded since this was made or last reset.
+   */
+  LoopTimingStats getStats() const;
+
+  /**
+   * Forgets every time recorded so far.
+   */
+  void reset();
+
+  protected:
+  const char *source;
+  mutable CrossplatformMutex mutex;
+  std::array<std::uint32_t, histogramSize> histogram{};
+  std::uint32_t sampleCount{0};
+  std::uint32_t overrunCount{0};
+  QTime minDt{0_ms};
+  QTime maxDt{0_ms};
+  QTime totalDt{0_ms};
+};
+} // namespace okapi
@@ -0,0 +1,46 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#pragma once
+
+namespace okapi {
+/**
+ * The output a motor needs to move at a velocity and acceleration:
+ * `kS * sgn(velocity) + kV * velocity + kA * acceleration`. Adding this to a feedback controller's
+ * output gives most of what a move needs up front, so the feedback only has to correct what is
+ * left. The gains are in the output units of the controller per unit of velocity and acceleration.
+ */
+struct MotorFeedforward {
+  /**
+   * The output which overcomes static friction.
+   */
+  double kS{0};
+
+  /**
+   * The output per unit of velocity.
+   */
+  double kV{0};
+
+  /**
+   * The output per unit of acceleration.
+   */
+  double kA{0};
+
+  /**
+   * @param ivelocity The velocity to move at.
+   * @param iacceleration The acceleration to move at.
+   * @return The output needed to move at the velocity and acceleration.
+   */
+  double calculate(double ivelocity, double iacceleration = 0) const;
+
+  /**
+   * @return Whether any gain is nonzero.
+   */
+  bool isEnabled() const;
+
+  bool operator==(const MotorFeedforward &rhs) const;
+  bool operator!=(const MotorFeedforward &rhs) const;
+};
+} // namespace okapi
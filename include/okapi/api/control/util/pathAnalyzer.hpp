@@ -0,0 +1,78 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#pragma once
+
+#include "okapi/api/control/util/pathfinderUtil.hpp"
+#include "okapi/api/device/motor/abstractMotor.hpp"
+#include "okapi/api/units/QLength.hpp"
+#include <cstddef>
+#include <vector>
+
+#include "squiggles.hpp"
+
+namespace okapi {
+/**
+ * What a generated path asks of the robot. Velocities and accelerations are of the center of the
+ * robot unless noted otherwise. The usages compare the path to what it was allowed; a usage over
+ * one means the robot is asked for more than it can do, and a usage well under one means the path
+ * could be faster.
+ */
+struct PathReport {
+  std::size_t pointCount{0};    ///< The number of points in the profile
+  double duration{0};           ///< How long following the path takes, in s
+  double length{0};             ///< The distance the center of the robot drives, in m
+  double peakVelocity{0};       ///< The fastest the robot drives, in m/s
+  double peakWheelVelocity{0};  ///< The fastest either wheel drives, in m/s
+  double peakAcceleration{0};   ///< The hardest the robot speeds up or slows down, in m/s^2
+  double peakCurvature{0};      ///< The tightest turn, in 1/m
+  double wheelFreeSpeed{0};     ///< The fastest the motors can drive the wheels, in m/s
+  double velocityUsage{0};      ///< The peak velocity over the max velocity of the limits
+  double accelerationUsage{0};  ///< The peak acceleration over the max acceleration of the limits
+  double motorSpeedUsage{0};    ///< The peak wheel velocity over the wheel free speed
+
+  /**
+   * @return Whether no usage is over one, give or take `PathAnalyzer::tolerance`.
+   */
+  bool isFeasible() const;
+};
+
+/**
+ * Measures generated paths against the limits they were generated with and the motors which follow
+ * them, so paths can be checked and tuned on a computer instead of on the robot (see the
+ * `pathCompiler` tool).
+ */
+class PathAnalyzer {
+  public:
+  /**
+   * Measures a profile. Accelerations are computed from the wheel velocities of consecutive points,
+   * so they are measured the way the motors are commanded. Profiles without increasing times are
+   * measured as if their points were one profile timestep apart, like they are followed.
+   *
+   * @param ipath The profile.
+   * @param ilimits The limits the profile was generated with.
+   * @param ipair The gearset of the drive motors and the ratio from them to the wheels. The gearset
+   * must be valid and the ratio must be positive.
+   * @param iwheelDiameter The diameter of the drive wheels.
+   * @return What the profile asks of the robot.
+   */
+  static PathReport analyze(const std::vector<squiggles::ProfilePoint> &ipath,
+                            const PathfinderLimits &ilimits,
+                            const AbstractMotor::GearsetRatioPair &ipair,
+                            QLength iwheelDiameter);
+
+  /**
+   * @return The fastest the motors can drive the wheels, in m/s.
+   */
+  static double getWheelFreeSpeed(const AbstractMotor::GearsetRatioPair &ipair,
+                                  QLength iwheelDiameter);
+
+  /**
+   * How far over one a usage may be for the path to still be feasible. Generated profiles overshoot
+   * their limits slightly between points.
+   */
+  static constexpr double tolerance = 0.02;
+};
+} // namespace okapi
@@ -0,0 +1,198 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#pragma once
+
+#include <cstdint>
+#include <iostream>
+#include <optional>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "squiggles.hpp"
+
+namespace okapi {
+/**
+ * A compact, versioned binary format for generated paths. A file starts with a 16 byte header:
+ *
+ *  - 4 bytes: the magic `OKPF`
+ *  - 2 bytes: the format version
+ *  - 2 bytes: the number of wheel velocities stored per point
+ *  - 4 bytes: the number of points
+ *  - 4 bytes: reserved, always zero
+ *
+ * Next, each point is stored as a fixed-width record of 32-bit floats: time, x, y, yaw, velocity,
+ * acceleration, jerk, curvature, and then the wheel velocities. All values are little-endian, which
+ * is the native byte order of both the V5 brain and common host machines, so a whole path loads
+ * with a single buffered read.
+ *
+ * The compact version of the format (see `serializeCompact()`) stores the same fields as integer
+ * multiples of `compactResolution`. Each field is stored as the difference from a straight line
+ * through its values in the two previous points, zigzag encoded as an unsigned LEB128 varint.
+ * Profiles are smooth, so most differences fit in a single byte, and a compact file is about a
+ * quarter of the size.
+ *
+ * A path library stores many paths in one file, so they load without opening a file per path. It
+ * starts with a 12 byte header:
+ *
+ *  - 4 bytes: the magic `OKPL`
+ *  - 2 bytes: the library version
+ *  - 2 bytes: reserved, always zero
+ *  - 4 bytes: the number of paths
+ *
+ * Next, each path is stored as a 2 byte length, the path ID, and then the path in the format above.
+ */
+class PathBinaryFormat {
+  public:
+  /**
+   * The current version of the format.
+   */
+  static constexpr std::uint16_t version = 1;
+
+  /**
+   * The version of the compact format.
+   */
+  static constexpr std::uint16_t compactVersion = 2;
+
+  /**
+   * The resolution of the values stored in the compact format.
+   */
+  static constexpr double compactResolution = 1e-4;
+
+  /**
+   * The size of the header in bytes.
+   */
+  static constexpr std::size_t headerSize = 16;
+
+  /**
+   * The number of floats stored per point before the wheel velocities.
+   */
+  static constexpr std::size_t fixedFieldsPerPoint = 8;
+
+  /**
+   * The most wheel velocities a point may have. Paths with more are not written, and headers with
+   * more are rejected as corrupt.
+   */
+  static constexpr std::uint16_t maxWheelCount = 8;
+
+  /**
+   * The layout of the points in a path file.
+   */
+  struct Header {
+    std::uint16_t wheelCount;
+    std::uint32_t pointCount;
+    bool compact{false};
+    // The fields of the last two points read from a compact file, as multiples of the resolution
+    std::uint32_t pointsRead{0};
+    std::vector<std::int64_t> history{};
+  };
+
+  /**
+   * Writes a path to a binary stream.
+   *
+   * @param ostream The stream to write to. This should be opened in binary mode.
+   * @param ipath The path to write.
+   * @return Whether the path was written successfully.
+   */
+  static bool serialize(std::ostream &ostream, const std::vector<squiggles::ProfilePoint> &ipath);
+
+  /**
+   * Writes a path to a binary stream in the compact format. Values are rounded to
+   * `compactResolution`, so nothing is written if a value is not finite or too large to store.
+   *
+   * @param ostream The stream to write to. This should be opened in binary mode.
+   * @param ipath The path to write.
+   * @return Whether the path was written successfully.
+   */
+  static bool serializeCompact(std::ostream &ostream,
+                               const std::vector<squiggles::ProfilePoint> &ipath);
+
+  /**
+   * Reads a path in either format from a binary stream.
+   *
+   * @param istream The stream to read from. This should be opened in binary mode.
+   * @return The path, or nothing if the stream does not contain a valid path of a supported
+   * version. A header which claims more points than the rest of the stream can hold is not valid.
+   */
+  static std::optional<std::vector<squiggles::ProfilePoint>> deserialize(std::istream &istream);
+
+  /**
+   * Reads the header of a path from a binary stream. Together with `readPoints()`, this reads a
+   * path a few points at a time.
+   *
+   * @param istream The stream to read from. This should be opened in binary mode.
+   * @return The header, or nothing if the stream does not start with a valid header of a supported
+   * version.
+   */
+  static std::optional<Header> readHeader(std::istream &istream);
+
+  /**
+   * Reads the next points of a path from a binary stream positioned after the header or after
+   * the points read previously.
+   *
+   * @param istream The stream to read from.
+   * @param iheader The header of the path. It keeps track of the previous points of compact paths,
+   * so the same header must be passed each time.
+   * @param icount The number of points to read.
+   * @param opoints The points are appended to this.
+   * @return Whether all `icount` points were read.
+   */
+  static bool readPoints(std::istream &istream,
+                         Header &iheader,
+                         std::size_t icount,
+                         std::vector<squiggles::ProfilePoint> &opoints);
+
+  /**
+   * The current version of the library format.
+   */
+  static constexpr std::uint16_t libraryVersion = 1;
+
+  /**
+   * The size of the library header in bytes.
+   */
+  static constexpr std::size_t libraryHeaderSize = 12;
+
+  /**
+   * The name of the path library file in a directory of paths.
+   */
+  static constexpr const char *libraryFileName = "paths.lib";
+
+  /**
+   * Writes paths to a binary stream as a path library.
+   *
+   * @param ostream The stream to write to. This should be opened in binary mode.
+   * @param ipaths The path IDs and paths to write. The IDs can be at most 65535 bytes long.
+   * @param icompact Whether to write the paths in the compact format.
+   * @return Whether the library was written successfully.
+   */
+  static bool
+  serializeLibrary(std::ostream &ostream,
+                   const std::vector<std::pair<std::string, std::vector<squiggles::ProfilePoint>>>
+                     &ipaths,
+                   bool icompact = false);
+
+  /**
+   * Reads the header of a path library from a binary stream. Follow it with `readLibraryEntry()`
+   * once per path.
+   *
+   * @param istream The stream to read from. This should be opened in binary mode.
+   * @return The number of paths in the library, or nothing if the stream does not start with a
+   * valid library header of a supported version.
+   */
+  static std::optional<std::uint32_t> readLibraryHeader(std::istream &istream);
+
+  /**
+   * Reads the next path of a path library from a binary stream positioned after the library header
+   * or after the paths read previously.
+   *
+   * @param istream The stream to read from.
+   * @return The path ID and the path, or nothing if the entry is invalid. The rest of the library
+   * can't be read after an invalid entry.
+   */
+  static std::optional<std::pair<std::string, std::vector<squiggles::ProfilePoint>>>
+  readLibraryEntry(std::istream &istream);
+};
+} // namespace okapi
@@ -0,0 +1,110 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#pragma once
+
+#include "okapi/api/coreProsAPI.hpp"
+#include "okapi/api/util/resourceUsage.hpp"
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+#include "squiggles.hpp"
+
+namespace okapi {
+/**
+ * The memory used by the paths of a PathPool. Byte counts are approximate. They include the
+ * memory of each point's wheel velocities.
+ */
+struct PathPoolStats {
+  std::size_t pathsInUse{0};     ///< Stored paths which are still referenced
+  std::size_t bytesInUse{0};     ///< The memory of the stored paths which are still referenced
+  std::size_t peakBytesInUse{0}; ///< The most memory the referenced paths have used at once
+  std::size_t wastedBytes{0};    ///< Memory of referenced paths past their last point
+  std::size_t pooledPaths{0};    ///< Buffers of freed paths which are kept to be reused
+  std::size_t pooledBytes{0};    ///< The memory of the kept buffers
+  std::size_t reuses{0};         ///< Paths which were stored in a kept buffer
+  std::size_t allocations{0};    ///< Paths which needed a new buffer
+
+  /**
+   * @return The fraction of the memory held by the pool which holds no points, from `0` to `1`.
+   */
+  double getFragmentation() const;
+};
+
+/**
+ * Keeps the buffers of freed motion profile paths so the next paths are stored in them instead of
+ * in new memory. Generating and removing paths over and over, like `moveTo()` does, otherwise
+ * scatters differently sized path buffers and their per-point wheel velocities across the heap.
+ *
+ * A buffer is reused when it has at least as many points as the new path. The points are copied
+ * over the old ones, so their wheel velocity buffers are reused too. A path which no kept buffer
+ * can hold keeps the buffer it was generated in. When a stored path is no longer referenced, its
+ * buffer returns to the pool, or is freed if the pool is full.
+ *
+ * Make the pool with `std::make_shared`. The stored paths may outlive it. The memory of the stored
+ * paths and the kept buffers is counted toward `HeapSubsystem::paths`.
+ */
+class PathPool : public std::enable_shared_from_this<PathPool> {
+  public:
+  using Path = std::vector<squiggles::ProfilePoint>;
+
+  /**
+   * @param imaxPooledPaths The most freed buffers to keep.
+   */
+  explicit PathPool(std::size_t imaxPooledPaths = 4);
+
+  PathPool(const PathPool &) = delete;
+  PathPool &operator=(const PathPool &) = delete;
+
+  ~PathPool();
+
+  /**
+   * Stores a path. Its buffer returns to the pool once the last reference to it is dropped.
+   *
+   * @param ipath The path.
+   * @return The stored path.
+   */
+  std::shared_ptr<const Path> store(Path ipath);
+
+  /**
+   * Frees every kept buffer at once. Stored paths are not affected.
+   */
+  void release();
+
+  /**
+   * Sets the most freed buffers to keep, freeing kept buffers over the new limit.
+   *
+   * @param imaxPooledPaths The most freed buffers to keep.
+   */
+  void setMaxPooledPaths(std::size_t imaxPooledPaths);
+
+  /**
+   * @return The memory used by the paths of this pool.
+   */
+  PathPoolStats getStats() const;
+
+  /**
+   * @return The approximate memory used by the path, including its unused capacity.
+   */
+  static std::size_t estimatePathBytes(const Path &ipath);
+
+  protected:
+  mutable CrossplatformMutex mutex;
+  std::size_t maxPooledPaths;
+  std::vector<std::unique_ptr<Path>> pooled{};
+  PathPoolStats stats{};
+
+  /**
+   * Takes back the buffer of a path which is no longer referenced.
+   */
+  void recycle(Path *ipath);
+
+  /**
+   * @return The approximate memory of the buffer past the last point.
+   */
+  static std::size_t estimateWastedBytes(const Path &ipath);
+};
+} // namespace okapi
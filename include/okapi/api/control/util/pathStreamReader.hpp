@@ -0,0 +1,107 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#pragma once
+
+#include "okapi/api/control/util/pathBinaryFormat.hpp"
+#include "okapi/api/coreProsAPI.hpp"
+#include "okapi/api/util/timeUtil.hpp"
+#include <array>
+#include <atomic>
+#include <iostream>
+#include <memory>
+#include <vector>
+
+#include "squiggles.hpp"
+
+namespace okapi {
+/**
+ * Reads a path in the `PathBinaryFormat` a chunk at a time so it can be followed before the whole
+ * file is read. The header and the first chunk are read when the reader is constructed. After
+ * that, a background task fills one buffer while the points in the other buffer are consumed, so
+ * the time it takes before the first point is available does not depend on the length of the
+ * path.
+ */
+class PathStreamReader {
+  public:
+  /**
+   * The number of points read into each buffer by default, which is one second of a path generated
+   * every 10 ms.
+   */
+  static constexpr std::size_t defaultChunkSize = 100;
+
+  /**
+   * Starts reading a path from a stream.
+   *
+   * @param istream The stream to read from. This should be opened in binary mode.
+   * @param itimeUtil The rates used to wait for a buffer to be read or consumed.
+   * @param ichunkSize The number of points read into each buffer.
+   */
+  PathStreamReader(std::unique_ptr<std::istream> istream,
+                   const TimeUtil &itimeUtil,
+                   std::size_t ichunkSize = defaultChunkSize);
+
+  PathStreamReader(const PathStreamReader &) = delete;
+  PathStreamReader &operator=(const PathStreamReader &) = delete;
+
+  /**
+   * Stops reading the path.
+   */
+  ~PathStreamReader();
+
+  /**
+   * @return Whether the stream starts with a valid header of a supported version.
+   */
+  bool isValid() const;
+
+  /**
+   * @return The number of points in the path, or zero if the stream is not valid.
+   */
+  std::size_t getPointCount() const;
+
+  /**
+   * Gets the next point of the path, waiting for the background task to read it if necessary.
+   *
+   * @param opoint The point is written to this.
+   * @return False when there are no more points, either because the end of the path was reached or
+   * because the stream could not be read.
+   */
+  bool next(squiggles::ProfilePoint &opoint);
+
+  protected:
+  std::unique_ptr<std::istream> stream;
+  TimeUtil timeUtil;
+  std::size_t chunkSize;
+  PathBinaryFormat::Header header{0, 0};
+  bool valid{false};
+
+  // The consumer owns buffers[frontBuffer]. The background task owns the other buffer while
+  // backBufferFull is false and gives it to the consumer by setting it.
+  std::array<std::vector<squiggles::ProfilePoint>, 2> buffers{};
+  std::size_t frontBuffer{0};
+  std::size_t frontPosition{0};
+  std::size_t pointsConsumed{0};
+  std::atomic_bool backBufferFull{false};
+
+  // Only accessed by the background task once it has started
+  std::size_t pointsRead{0};
+
+  // Set by the background task when it stops reading, either at the end of the path or because
+  // the stream could not be read
+  std::atomic_bool readerDone{false};
+  std::atomic_bool stopReading{false};
+  CrossplatformThread *task{nullptr};
+
+  static void trampoline(void *context);
+  void readLoop();
+
+  /**
+   * Reads the next chunk of points into the buffer.
+   *
+   * @return Whether the points were read.
+   */
+  bool readChunk(std::vector<squiggles::ProfilePoint> &obuffer);
+};
+} // namespace okapi
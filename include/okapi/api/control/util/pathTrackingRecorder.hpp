@@ -0,0 +1,147 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#pragma once
+
+#include "okapi/api/coreProsAPI.hpp"
+#include "okapi/api/device/motor/abstractMotor.hpp"
+#include "okapi/api/odometry/odometry.hpp"
+#include "okapi/api/util/abstractTimer.hpp"
+#include "okapi/api/util/logging.hpp"
+#include "okapi/api/util/timeUtil.hpp"
+#include <cstddef>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace okapi {
+/**
+ * What was commanded and what happened at one step of a path. Values which were not measured are
+ * NaN.
+ */
+struct PathTrackingSample {
+  double time;           ///< The time since the path started, in s
+  double leftCommanded;  ///< The velocity commanded to the left motors, in motor rpm
+  double rightCommanded; ///< The velocity commanded to the right motors, in motor rpm
+  double leftActual;     ///< The actual velocity of the left motor, in motor rpm
+  double rightActual;    ///< The actual velocity of the right motor, in motor rpm
+  double x;              ///< The x position from odometry, in m
+  double y;              ///< The y position from odometry, in m
+  double theta;          ///< The heading from odometry, in degrees
+};
+
+/**
+ * Records the velocities a motion profile controller commands next to the velocities the motors
+ * actually reach and the pose from odometry, so a path can be compared to how the robot followed
+ * it (see `AsyncMotionProfileController::setTrackingRecorder()` and
+ * `AsyncLinearMotionProfileController::setTrackingRecorder()`).
+ *
+ * The samples go into a buffer which is allocated once, so recording does not allocate. Samples
+ * after the buffer is full are dropped. When the path is done, the samples are written to a CSV
+ * file named after the path, which takes a while on the SD card but happens after the robot has
+ * stopped following the path.
+ */
+class PathTrackingRecorder {
+  public:
+  /**
+   * The number of samples kept by default, which is 15 seconds of a path at 10 ms per step.
+   */
+  static constexpr std::size_t defaultCapacity = 1500;
+
+  /**
+   * @param itimeUtil The TimeUtil used to time the samples.
+   * @param ileftMotor The motor to read the actual velocity of the left side from.
+   * @param irightMotor The motor to read the actual velocity of the right side from, or `nullptr`
+   * for a controller which drives one side, like `AsyncLinearMotionProfileController`.
+   * @param iodometry The odometry to read the pose from, or `nullptr` to not record the pose.
+   * @param icapacity The most samples kept for one path.
+   * @param idirectory The directory to write the files to, e.g. `/usd/tracking`. If this is empty,
+   * no files are written and the samples can only be read with `getSamples()`.
+   * @param ilogger The logger this instance will log to.
+   */
+  PathTrackingRecorder(const TimeUtil &itimeUtil,
+                       std::shared_ptr<AbstractMotor> ileftMotor,
+                       std::shared_ptr<AbstractMotor> irightMotor,
+                       std::shared_ptr<Odometry> iodometry = nullptr,
+                       std::size_t icapacity = defaultCapacity,
+                       std::string idirectory = "/usd",
+                       const std::shared_ptr<Logger> &ilogger = Logger::getDefaultLogger());
+
+  virtual ~PathTrackingRecorder() = default;
+
+  /**
+   * Forgets the samples of the last path and starts timing a new one. This is called by the
+   * controller.
+   *
+   * @param ipathId The ID of the path, used for the name of its file.
+   */
+  void beginPath(const std::string &ipathId);
+
+  /**
+   * Records one step of the path. This reads the actual velocities and the pose. This is called by
+   * the controller.
+   *
+   * @param ileftCommanded The velocity commanded to the left motors, in motor rpm.
+   * @param irightCommanded The velocity commanded to the right motors, in motor rpm.
+   */
+  void record(double ileftCommanded, double irightCommanded);
+
+  /**
+   * Writes the samples of the path to `<directory>/<path ID>.csv`. This is called by the controller
+   * when the path is done. Nothing is written if there are no samples or no directory.
+   *
+   * @return Whether a file was written.
+   */
+  bool endPath();
+
+  /**
+   * Writes the samples of the last path as CSV with a header line.
+   *
+   * @param ostream The stream to write to.
+   */
+  void write(std::ostream &ostream) const;
+
+  /**
+   * @return The samples of the last path.
+   */
+  std::vector<PathTrackingSample> getSamples() const;
+
+  /**
+   * @return The number of samples of the last path which did not fit in the buffer.
+   */
+  std::size_t getDroppedCount() const;
+
+  /**
+   * @return The ID of the last path.
+   */
+  std::string getPathId() const;
+
+  protected:
+  std::shared_ptr<Logger> logger;
+  std::unique_ptr<AbstractTimer> timer;
+  std::shared_ptr<AbstractMotor> leftMotor;
+  std::shared_ptr<AbstractMotor> rightMotor;
+  std::shared_ptr<Odometry> odometry;
+  std::string directory;
+  std::size_t capacity;
+
+  // Guards everything below
+  mutable CrossplatformMutex mutex;
+  std::vector<PathTrackingSample> samples{};
+  std::size_t droppedCount{0};
+  std::string pathId{};
+  QTime startTime{0_ms};
+
+  /**
+   * Opens the file to write the samples of a path to. The default implementation opens an
+   * `std::ofstream`.
+   *
+   * @param ifileName The name of the file.
+   * @return The stream to write to.
+   */
+  virtual std::unique_ptr<std::ostream> openOutput(const std::string &ifileName);
+};
+} // namespace okapi
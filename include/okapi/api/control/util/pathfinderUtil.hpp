@@ -20,4 +20,13 @@ struct PathfinderLimits {
   double maxAccel; // Maximum robot acceleration in m/s/s
   double maxJerk;  // Maximum robot jerk in m/s/s/s
 };
+
+/**
+ * One segment of a path generated offline. This is trivially copyable so tables of these can be
+ * `constexpr` and live in read-only memory.
+ */
+struct StaticProfilePoint {
+  double leftVelocity;  // Left wheel velocity in m/s
+  double rightVelocity; // Right wheel velocity in m/s
+};
 } // namespace okapi
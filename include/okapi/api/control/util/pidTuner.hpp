@@ -11,6 +11,8 @@
 #include "okapi/api/units/QTime.hpp"
 #include "okapi/api/util/logging.hpp"
 #include "okapi/api/util/timeUtil.hpp"
+#include <atomic>
+#include <functional>
 #include <memory>
 #include <vector>
 
@@ -21,6 +23,24 @@ class PIDTuner {
     double kP, kI, kD;
   };
 
+  /**
+   * A simulated copy of the system being tuned, such as one built around a FlywheelSimulator.
+   */
+  struct Simulator {
+    std::shared_ptr<ControllerInput<double>> input;
+    std::shared_ptr<ControllerOutput<double>> output;
+
+    /**
+     * Moves the simulation forward in time.
+     */
+    std::function<void(QTime idt)> step;
+  };
+
+  /**
+   * Makes a new simulator in its starting state.
+   */
+  using SimulatorFactory = std::function<Simulator()>;
+
   PIDTuner(const std::shared_ptr<ControllerInput<double>> &iinput,
            const std::shared_ptr<ControllerOutput<double>> &ioutput,
            const TimeUtil &itimeUtil,
@@ -42,8 +62,48 @@ class PIDTuner {
 
   virtual Output autotune();
 
+  /**
+   * Tests the particles against simulators instead of the live system. Every particle gets a new
+   * simulator, which is stepped as fast as the host allows instead of in real time, so the input
+   * and output given to the constructor are not used and may be null. On the host, the particles
+   * of an iteration are tested at the same time across up to `inumThreads` threads of the shared
+   * HostThreadPool, so more threads than the host has cores are never used. On the brain, they are
+   * tested one at a time.
+   *
+   * @param ifactory Makes a simulator per particle. This is only called from the thread
+   * `autotune()` is called from.
+   * @param inumThreads The number of threads to test particles on.
+   * @param iatTargetError The settling error, as for SettledUtil.
+   * @param iatTargetDerivative The settling error derivative, as for SettledUtil.
+   * @param iatTargetTime The settling time, as for SettledUtil.
+   */
+  virtual void setSimulator(SimulatorFactory ifactory,
+                            std::size_t inumThreads = 1,
+                            double iatTargetError = 50,
+                            double iatTargetDerivative = 5,
+                            QTime iatTargetTime = 250_ms);
+
+  /**
+   * Sets how much of their velocity the particles keep between iterations. The inertia moves
+   * linearly from the first value on the first iteration to the last value on the last one, so the
+   * swarm explores early and then closes in on the best gains. Use the same value twice for a
+   * constant inertia.
+   *
+   * @param iinertiaStart The inertia on the first iteration.
+   * @param iinertiaEnd The inertia on the last iteration.
+   */
+  virtual void setInertiaSchedule(double iinertiaStart, double iinertiaEnd);
+
+  /**
+   * Sets when the swarm counts as collapsed. Tuning stops early once every particle is within
+   * this fraction of each gain's range of every other particle, since more iterations would test
+   * nearly the same gains again. Use 0 to always run every iteration.
+   *
+   * @param itolerance The spread of the swarm, as a fraction of each gain's range.
+   */
+  virtual void setConvergenceTolerance(double itolerance);
+
   protected:
-  static constexpr double inertia = 0.5;   // Particle inertia
   static constexpr double confSelf = 1.1;  // Self confidence
   static constexpr double confSwarm = 1.2; // Particle swarm confidence
   static constexpr int increment = 5;
@@ -59,6 +119,26 @@ class PIDTuner {
     double bestError;
   };
 
+  /**
+   * One test of a particle against a simulator.
+   */
+  struct Trial {
+    const ParticleSet *particle;
+    std::int32_t target;
+    double cutoff;
+    Simulator simulator;
+    double error;
+  };
+
+  /**
+   * The trials of one iteration, shared by the threads which run them.
+   */
+  struct TrialQueue {
+    const PIDTuner *tuner;
+    std::vector<Trial> *trials;
+    std::atomic_size_t next{0};
+  };
+
   std::shared_ptr<Logger> logger;
   TimeUtil timeUtil;
   std::shared_ptr<ControllerInput<double>> input;
@@ -76,5 +156,61 @@ class PIDTuner {
   const std::size_t numParticles;
   const double kSettle;
   const double kITAE;
+
+  SimulatorFactory simulatorFactory{};
+  std::size_t numThreads{1};
+  double atTargetError{50};
+  double atTargetDerivative{5};
+  QTime atTargetTime{250_ms};
+  double inertiaStart{0.9};
+  double inertiaEnd{0.4};
+  double convergenceTolerance{0.01};
+
+  /**
+   * Runs the test controller on a system until it settles or times out.
+   *
+   * @param iparticle The gains to test.
+   * @param itarget The target relative to where the system starts.
+   * @param itimeUtil The time utility of the test controller.
+   * @param iinput The system's input.
+   * @param ioutput The system's output.
+   * @param iwait Waits for the next loop, by sleeping or by stepping a simulator.
+   * @param icutoff The test stops early once the fitness passes this, since the particle can no
+   * longer beat it.
+   * @return The fitness of the particle, where less is better, or infinity if the test was cut
+   * off.
+   */
+  double testParticle(const ParticleSet &iparticle,
+                      std::int32_t itarget,
+                      double icutoff,
+                      const TimeUtil &itimeUtil,
+                      ControllerInput<double> &iinput,
+                      ControllerOutput<double> &ioutput,
+                      const std::function<void()> &iwait) const;
+
+  /**
+   * Tests every trial against its simulator, across the tuner's threads.
+   */
+  void runTrials(std::vector<Trial> &itrials) const;
+
+  /**
+   * Tests one trial against its simulator.
+   */
+  void runTrial(Trial &itrial) const;
+
+  /**
+   * @return The inertia of the particles on an iteration.
+   */
+  double getInertia(std::size_t iiteration) const;
+
+  /**
+   * @return Whether the swarm collapsed within the convergence tolerance.
+   */
+  bool hasConverged(const std::vector<ParticleSet> &iparticles) const;
+
+  /**
+   * Runs trials from a TrialQueue until there are none left.
+   */
+  static void trampoline(void *context);
 };
 } // namespace okapi
@@ -0,0 +1,49 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#pragma once
+
+#include "okapi/api/control/util/pathfinderUtil.hpp"
+#include "okapi/api/units/QSpeed.hpp"
+#include <vector>
+
+#include "squiggles.hpp"
+
+namespace okapi {
+/**
+ * Generates skid-steer profiles with the same `squiggles::SplineGenerator` configuration as
+ * `AsyncMotionProfileController`, so paths generated offline match paths generated on the robot.
+ */
+class ProfileGenerator {
+  public:
+  /**
+   * The timestep of generated profiles in seconds.
+   */
+  static constexpr double DT = 0.01;
+
+  /**
+   * Generates a profile through the waypoints.
+   *
+   * If the waypoints form a path which is impossible to achieve, an instance of
+   * `std::runtime_error` is thrown.
+   *
+   * NOTE: The waypoints are expected to be in the okapi::State::FRAME_TRANSFORMATION format where
+   * +x is forward, +y is right, and 0 theta is measured from the +x axis to the +y axis.
+   *
+   * @param iwaypoints The waypoints to hit on the path.
+   * @param ilimits The limits to use for the path.
+   * @param iwheelTrack The distance between the left and right wheels.
+   * @param istartVelocity The linear velocity at the start of the path.
+   * @param iendVelocity The linear velocity at the end of the path.
+   * @return The generated profile.
+   */
+  static std::vector<squiggles::ProfilePoint>
+  generate(const std::vector<PathfinderPoint> &iwaypoints,
+           const PathfinderLimits &ilimits,
+           const QLength &iwheelTrack,
+           const QSpeed &istartVelocity = 0_mps,
+           const QSpeed &iendVelocity = 0_mps);
+};
+} // namespace okapi
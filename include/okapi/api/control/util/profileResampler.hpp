@@ -0,0 +1,72 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#pragma once
+
+#include <cstddef>
+#include <limits>
+#include <vector>
+
+#include "squiggles.hpp"
+
+namespace okapi {
+/**
+ * How to compute the values between two stored profile points.
+ */
+enum class ProfileInterpolation {
+  linear, ///< Straight lines between points
+  cubic   ///< Cubic Hermite splines through the velocities, which follow accelerations smoothly
+};
+
+/**
+ * Utilities for storing profiles with fewer points than they were generated with and for sampling
+ * profiles at arbitrary times. Points are located by their `time`, so the stored points do not
+ * need to be evenly spaced.
+ */
+class ProfileResampler {
+  public:
+  /**
+   * Removes points from a profile. Every `istride`-th point is kept, as well as any point whose
+   * curvature differs from the last kept point by more than `imaxCurvatureChange`, so tight turns
+   * keep more points than straight lines. The first and last points are always kept.
+   *
+   * @param ipath The profile.
+   * @param istride Keep every `istride`-th point. A stride of one keeps every point.
+   * @param imaxCurvatureChange The curvature change (in 1/m) which forces a point to be kept.
+   * @return The decimated profile.
+   */
+  static std::vector<squiggles::ProfilePoint>
+  decimate(const std::vector<squiggles::ProfilePoint> &ipath,
+           std::size_t istride,
+           double imaxCurvatureChange = std::numeric_limits<double>::infinity());
+
+  /**
+   * @return Whether the times of the points are strictly increasing, which is required to sample
+   * the profile.
+   */
+  static bool hasIncreasingTimes(const std::vector<squiggles::ProfilePoint> &ipath);
+
+  /**
+   * Computes the profile at a time. Sampling exactly at the time of a stored point returns that
+   * point. Times outside of the profile are clamped to its ends.
+   *
+   * @param ipath The profile. This must not be empty and must have increasing times.
+   * @param itime The time to sample at, in seconds.
+   * @param isegment The index of the point to start searching from. This is updated to the point
+   * before `itime`, so sampling forwards through the profile does not search it from the start.
+   * @param iinterpolation How to interpolate between points.
+   * @return The profile at `itime`.
+   */
+  static squiggles::ProfilePoint sample(const std::vector<squiggles::ProfilePoint> &ipath,
+                                        double itime,
+                                        std::size_t &isegment,
+                                        ProfileInterpolation iinterpolation);
+
+  /**
+   * The tolerance in seconds used when comparing sample times to point times.
+   */
+  static constexpr double timeEpsilon = 1e-5;
+};
+} // namespace okapi
@@ -0,0 +1,154 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#pragma once
+
+#include "okapi/api/chassis/controller/chassisScales.hpp"
+#include "okapi/api/device/motor/abstractMotor.hpp"
+#include "okapi/api/units/QMass.hpp"
+#include "okapi/api/util/logging.hpp"
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include "squiggles.hpp"
+
+namespace okapi {
+/**
+ * Changes the speeds along a skid-steer profile to what the drive motors can deliver, instead of
+ * the one max velocity and acceleration of `PathfinderLimits`. The path itself is not changed.
+ *
+ * Each motor is modeled as a DC motor whose torque drops linearly from its stall torque to zero at
+ * its free speed. The robot's mass is split evenly between the two sides, and the wheel velocities
+ * follow the curvature like in `squiggles::TankModel`. So the robot accelerates harder at low
+ * speed than near its top speed, drives at nearly the free speed of the wheels on straight
+ * sections, and slows down for curves so the outer wheels stay within their free speed. Friction
+ * and jerk are not modeled.
+ *
+ * The retimed points are not evenly spaced in time, so they are followed by sampling them by their
+ * times (see `ProfileResampler`).
+ */
+class ProfileRetimer {
+  public:
+  /**
+   * Throws a `std::invalid_argument` if the gearset is invalid, the ratio or mass is not positive,
+   * there are no motors, or the voltage fraction is not in `(0, 1]`.
+   *
+   * @param ipair The gearset of the drive motors and the ratio from them to the wheels.
+   * @param iscales The ChassisScales, for the wheel diameter and wheel track.
+   * @param imass The mass of the robot.
+   * @param imotorsPerSide The number of motors driving each side.
+   * @param ivoltageFraction The fraction of the max voltage the profile may need. The rest is left
+   * for feedback to correct with.
+   * @param ilogger The logger this instance will log to.
+   */
+  ProfileRetimer(const AbstractMotor::GearsetRatioPair &ipair,
+                 const ChassisScales &iscales,
+                 QMass imass,
+                 std::size_t imotorsPerSide = 2,
+                 double ivoltageFraction = 0.9,
+                 const std::shared_ptr<Logger> &ilogger = Logger::getDefaultLogger());
+
+  /**
+   * Re-times a profile as fast as the motors allow, starting and ending at the velocities of its
+   * first and last points (as far as the motors allow). Points in the same place as the one before
+   * them are dropped. The velocities, accelerations, wheel velocities, and times are replaced, the
+   * poses and curvatures are kept. The first point keeps its time.
+   *
+   * @param ipath The profile.
+   * @return The retimed profile.
+   */
+  std::vector<squiggles::ProfilePoint>
+  retime(const std::vector<squiggles::ProfilePoint> &ipath) const;
+
+  /**
+   * Re-times a profile as fast as the given limits allow, like `retime()` does with the limits of
+   * the motors.
+   *
+   * @param ipath The profile.
+   * @param ihalfTrack Half the wheel track in m, for the wheel velocities.
+   * @param imaxVelocity The fastest the center of the robot can go on a curvature, in m/s.
+   * @param imaxAcceleration The fastest the center of the robot can speed up at a velocity and
+   * curvature, in m/s^2.
+   * @param imaxDeceleration The fastest the center of the robot can slow down on a curvature, in
+   * m/s^2.
+   * @return The retimed profile.
+   */
+  static std::vector<squiggles::ProfilePoint>
+  retime(const std::vector<squiggles::ProfilePoint> &ipath,
+         double ihalfTrack,
+         const std::function<double(double)> &imaxVelocity,
+         const std::function<double(double, double)> &imaxAcceleration,
+         const std::function<double(double)> &imaxDeceleration);
+
+  /**
+   * Slows a profile down wherever it would need more than a centripetal acceleration, so the robot
+   * doesn't slide in sharp turns. The velocity on a curvature `k` is capped at
+   * `sqrt(imaxCentripetalAccel / |k|)`, and the profile slows down into and speeds up out of
+   * each curve at `imaxAccel`. Everywhere else it keeps its velocities, so straight sections stay
+   * at full speed. A profile which is within the limit everywhere is returned as it is. Jerk is not
+   * limited where the profile changes.
+   *
+   * @param ipath The profile.
+   * @param ihalfTrack Half the wheel track in m, for the wheel velocities.
+   * @param imaxCentripetalAccel The most centripetal acceleration of the center of the robot, in
+   * m/s^2.
+   * @param imaxAccel The acceleration to slow down and speed up with, in m/s^2.
+   * @return The limited profile.
+   */
+  static std::vector<squiggles::ProfilePoint>
+  limitCentripetalAcceleration(const std::vector<squiggles::ProfilePoint> &ipath,
+                               double ihalfTrack,
+                               double imaxCentripetalAccel,
+                               double imaxAccel);
+
+  /**
+   * @param icurvature The curvature of the path in 1/m.
+   * @return The fastest the center of the robot can go on the curvature, in m/s.
+   */
+  double getMaxVelocity(double icurvature) const;
+
+  /**
+   * @param ivelocity The velocity of the center of the robot in m/s.
+   * @param icurvature The curvature of the path in 1/m.
+   * @return The fastest the center of the robot can speed up, in m/s^2. This is zero at
+   * `getMaxVelocity()`.
+   */
+  double getMaxAcceleration(double ivelocity, double icurvature) const;
+
+  /**
+   * @param icurvature The curvature of the path in 1/m.
+   * @return The fastest the center of the robot can slow down, in m/s^2.
+   */
+  double getMaxDeceleration(double icurvature) const;
+
+  protected:
+  std::shared_ptr<Logger> logger;
+  // The speed of a wheel at the voltage fraction with no load, in m/s
+  double wheelFreeSpeed;
+  // The force of the motors of one side on the ground at the voltage fraction when stalled, in N
+  double sideStallForce;
+  double halfTrack;
+  double sideMass;
+
+  /**
+   * Re-times a profile like `retime()`, with a velocity limit for each point instead of for each
+   * curvature.
+   */
+  static std::vector<squiggles::ProfilePoint>
+  retimePoints(const std::vector<squiggles::ProfilePoint> &ipath,
+               double ihalfTrack,
+               const std::function<double(const squiggles::ProfilePoint &)> &imaxVelocity,
+               const std::function<double(double, double)> &imaxAcceleration,
+               const std::function<double(double)> &imaxDeceleration);
+
+  /**
+   * @return How much faster than the center of the robot each side goes on the curvature.
+   */
+  std::pair<double, double> getSideFactors(double icurvature) const;
+};
+} // namespace okapi
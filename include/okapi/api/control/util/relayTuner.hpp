@@ -0,0 +1,106 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#pragma once
+
+#include "okapi/api/control/controllerInput.hpp"
+#include "okapi/api/control/controllerOutput.hpp"
+#include "okapi/api/units/QTime.hpp"
+#include "okapi/api/util/logging.hpp"
+#include "okapi/api/util/timeUtil.hpp"
+#include <memory>
+
+namespace okapi {
+/**
+ * Tunes a PID controller with a relay feedback test (Astrom and Hagglund). The output is switched
+ * between two levels around the goal, which makes the system oscillate at its ultimate period.
+ * The size of the oscillation gives the ultimate gain, and a tuning rule turns the two into gains.
+ * A test only takes a few oscillations, where PIDTuner takes many full trials.
+ */
+class RelayTuner {
+  public:
+  /**
+   * How the ultimate gain and period are turned into gains.
+   */
+  enum class Rule {
+    zieglerNichols, ///< Fast, with some overshoot.
+    tyreusLuyben    ///< Slower, with less overshoot and more robustness.
+  };
+
+  struct Output {
+    double kP, kI, kD;
+
+    /**
+     * The proportional gain at which the system oscillates, or zero if the test failed.
+     */
+    double ultimateGain;
+
+    /**
+     * The period of the oscillation, or zero if the test failed.
+     */
+    QTime ultimatePeriod;
+  };
+
+  /**
+   * Tunes a PID controller with a relay feedback test. The gains suit an
+   * IterativePosPIDController whose input is `iinput` and whose output is `ioutput`.
+   *
+   * @param iinput The system's input.
+   * @param ioutput The system's output.
+   * @param itimeUtil The time utility which supplies the timer and rate of the test.
+   * @param igoal The goal to oscillate around, relative to where the system starts.
+   * @param irelayAmplitude The output on either side of the relay, in the range (0, 1]. Use the
+   * largest value which keeps the oscillation safe.
+   * @param ihysteresis How far past the goal the input must go before the relay switches. Use a
+   * little more than the sensor noise.
+   * @param inumCycles The number of oscillations to measure, after the first one.
+   * @param itimeout The longest the test may run.
+   * @param ilogger The logger this instance will log to.
+   */
+  RelayTuner(const std::shared_ptr<ControllerInput<double>> &iinput,
+             const std::shared_ptr<ControllerOutput<double>> &ioutput,
+             const TimeUtil &itimeUtil,
+             double igoal,
+             double irelayAmplitude = 1,
+             double ihysteresis = 0,
+             std::size_t inumCycles = 3,
+             QTime itimeout = 10_s,
+             const std::shared_ptr<Logger> &ilogger = Logger::getDefaultLogger());
+
+  virtual ~RelayTuner();
+
+  /**
+   * Runs the relay test, then stops the output.
+   *
+   * @param irule The tuning rule.
+   * @return The gains, or zeros if the system did not oscillate before the timeout.
+   */
+  virtual Output autotune(Rule irule = Rule::zieglerNichols);
+
+  /**
+   * Turns an ultimate gain and period into gains.
+   *
+   * @param iultimateGain The proportional gain at which the system oscillates.
+   * @param iultimatePeriod The period of the oscillation.
+   * @param irule The tuning rule.
+   * @return The gains.
+   */
+  static Output computeGains(double iultimateGain, QTime iultimatePeriod, Rule irule);
+
+  protected:
+  static constexpr QTime loopDelta = 10_ms; // NOLINT
+
+  std::shared_ptr<Logger> logger;
+  TimeUtil timeUtil;
+  std::shared_ptr<ControllerInput<double>> input;
+  std::shared_ptr<ControllerOutput<double>> output;
+
+  const double goal;
+  const double relayAmplitude;
+  const double hysteresis;
+  const std::size_t numCycles;
+  const QTime timeout;
+};
+} // namespace okapi
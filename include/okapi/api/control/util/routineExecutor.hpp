@@ -0,0 +1,181 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#pragma once
+
+#include "okapi/api/units/QTime.hpp"
+#include "okapi/api/util/abstractRate.hpp"
+#include "okapi/api/util/abstractTimer.hpp"
+#include "okapi/api/util/logging.hpp"
+#include "okapi/api/util/timeUtil.hpp"
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <utility>
+#include <vector>
+
+namespace okapi {
+/**
+ * A sequence of steps, like the actions of an autonomous routine. Each step starts an action and
+ * then waits, without blocking, until the action is done. Run routines with a RoutineExecutor.
+ *
+ * ```cpp
+ * auto routine = Routine()
+ *   .thenSettle([=]() { chassis->moveDistanceAsync(2_ft); }, chassis)
+ *   .thenSettle([=]() { lift->setTarget(200); }, lift)
+ *   .thenDelay(250_ms);
+ * ```
+ */
+class Routine {
+  public:
+  /**
+   * Returns whether the step is done, given the time since it started.
+   */
+  using DoneCheck = std::function<bool(QTime ielapsed)>;
+
+  /**
+   * Adds a step which runs an action and is done right away.
+   *
+   * @param iaction The action.
+   * @return This routine.
+   */
+  Routine &then(std::function<void()> iaction);
+
+  /**
+   * Adds a step which starts an action and waits until it is done.
+   *
+   * @param istart Starts the action. May be empty to only wait.
+   * @param iisDone Returns whether the action is done, given the time since it started.
+   * @return This routine.
+   */
+  Routine &thenWait(std::function<void()> istart, DoneCheck iisDone);
+
+  /**
+   * Adds a step which waits for a time.
+   *
+   * @param itime The time to wait.
+   * @return This routine.
+   */
+  Routine &thenDelay(QTime itime);
+
+  /**
+   * Adds a step which starts a movement of a controller and waits until the controller has
+   * settled, like calling `waitUntilSettled()` after it. Works with the async controllers and the
+   * chassis controllers.
+   *
+   * @param istart Starts the movement, like `moveDistanceAsync` or `setTarget`.
+   * @param icontroller The controller to wait for.
+   * @param itimeout The longest time to wait, or zero to wait until the controller settles.
+   * @return This routine.
+   */
+  template <typename T>
+  Routine &thenSettle(std::function<void()> istart,
+                      std::shared_ptr<T> icontroller,
+                      const QTime itimeout = 0_ms) {
+    return thenWait(std::move(istart),
+                    [controller = std::move(icontroller), itimeout](QTime ielapsed) {
+                      return (itimeout > 0_ms && ielapsed >= itimeout) || controller->isSettled();
+                    });
+  }
+
+  /**
+   * @return The number of steps.
+   */
+  std::size_t getStepCount() const;
+
+  protected:
+  friend class RoutineExecutor;
+
+  struct Step {
+    std::function<void()> start;
+    DoneCheck isDone;
+  };
+
+  std::vector<Step> steps{};
+};
+
+/**
+ * Runs any number of routines at once from one task. Each call to `step()` starts the next step of
+ * every routine whose current step is done, so a routine which moves the chassis and a routine
+ * which moves a lift run at the same time without a task for each of them. Steps which are done
+ * right away run back to back in the same call.
+ *
+ * This must only be used from one task. Routines may be added from inside a step; they start on
+ * the next call to `step()`.
+ */
+class RoutineExecutor {
+  public:
+  /**
+   * @param itimeUtil The time utility which supplies the timer of the steps and the rate of
+   * `run()`.
+   * @param ilogger The logger this instance will log to.
+   */
+  explicit RoutineExecutor(const TimeUtil &itimeUtil,
+                           std::shared_ptr<Logger> ilogger = Logger::getDefaultLogger());
+
+  /**
+   * Adds a routine. Its first step starts on the next call to `step()`.
+   *
+   * @param iroutine The routine.
+   * @return The id of the routine, used to check on it or cancel it.
+   */
+  std::size_t add(Routine iroutine);
+
+  /**
+   * Stops running a routine. The action of its current step is not stopped.
+   *
+   * @param iid The id returned by `add()`.
+   */
+  void cancel(std::size_t iid);
+
+  /**
+   * @param iid The id returned by `add()`.
+   * @return Whether the routine has run all its steps or was cancelled.
+   */
+  bool isDone(std::size_t iid) const;
+
+  /**
+   * @return The number of routines which are not done.
+   */
+  std::size_t getRunningCount() const;
+
+  /**
+   * Advances every routine as far as it can go without waiting.
+   *
+   * @return Whether any routine is not done.
+   */
+  bool step();
+
+  /**
+   * Steps the routines every period until they are all done. This blocks the calling task.
+   *
+   * @param iperiod The time between steps.
+   */
+  void run(QTime iperiod = 10_ms);
+
+  protected:
+  struct Running {
+    std::size_t id;
+    Routine routine;
+    std::size_t stepIndex{0};
+    bool started{false};
+    QTime stepStart{0_ms};
+  };
+
+  std::shared_ptr<Logger> logger;
+  std::unique_ptr<AbstractTimer> timer;
+  std::unique_ptr<AbstractRate> rate;
+  std::vector<Running> running{};
+  std::vector<Running> added{};
+  std::size_t nextId{0};
+
+  /**
+   * Advances one routine as far as it can go without waiting.
+   *
+   * @return Whether the routine is done.
+   */
+  bool advance(Running &iroutine);
+};
+} // namespace okapi
@@ -0,0 +1,93 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+
+namespace okapi {
+template <typename Input, typename Output> struct ControllerState {
+  Input target{0};
+  Input processValue{0};
+  Output error{0};
+  Output output{0};
+  bool settled{false};
+};
+
+/**
+ * The state of an iterative controller, published by the task which steps it for other tasks to
+ * read. Reads never see a state which is partly written, and never make the stepping task wait.
+ *
+ * The newest write is in `cells[writeCount % 2]`, so a read only has to retry if the stepping
+ * task finishes a write and starts another while it reads.
+ */
+template <typename Input, typename Output> class SharedControllerState {
+  public:
+  /**
+   * Publishes the state. Must only be called by the stepping task, or by the task which owns the
+   * controller before the stepping task starts.
+   *
+   * @param istate The state of the controller after a step.
+   */
+  void publish(const ControllerState<Input, Output> &istate) {
+    const std::uint32_t count = writeCount.load(std::memory_order_relaxed) + 1;
+    Cell &cell = cells[count % 2];
+
+    const std::uint32_t sequence = cell.sequence.load(std::memory_order_relaxed);
+    cell.sequence.store(sequence + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+
+    cell.target.store(istate.target, std::memory_order_relaxed);
+    cell.processValue.store(istate.processValue, std::memory_order_relaxed);
+    cell.error.store(istate.error, std::memory_order_relaxed);
+    cell.output.store(istate.output, std::memory_order_relaxed);
+    cell.settled.store(istate.settled, std::memory_order_relaxed);
+
+    cell.sequence.store(sequence + 2, std::memory_order_release);
+    writeCount.store(count, std::memory_order_release);
+  }
+
+  /**
+   * @return The state last published. Can be called from any task.
+   */
+  ControllerState<Input, Output> get() const {
+    while (true) {
+      const Cell &cell = cells[writeCount.load(std::memory_order_acquire) % 2];
+
+      const std::uint32_t sequence = cell.sequence.load(std::memory_order_acquire);
+      if (sequence % 2 != 0) {
+        continue;
+      }
+
+      ControllerState<Input, Output> state;
+      state.target = cell.target.load(std::memory_order_relaxed);
+      state.processValue = cell.processValue.load(std::memory_order_relaxed);
+      state.error = cell.error.load(std::memory_order_relaxed);
+      state.output = cell.output.load(std::memory_order_relaxed);
+      state.settled = cell.settled.load(std::memory_order_relaxed);
+
+      std::atomic_thread_fence(std::memory_order_acquire);
+      if (cell.sequence.load(std::memory_order_relaxed) == sequence) {
+        return state;
+      }
+    }
+  }
+
+  protected:
+  // A cell's sequence number is odd while it is being written
+  struct Cell {
+    std::atomic_uint32_t sequence{0};
+    std::atomic<Input> target{0};
+    std::atomic<Input> processValue{0};
+    std::atomic<Output> error{0};
+    std::atomic<Output> output{0};
+    std::atomic_bool settled{false};
+  };
+
+  Cell cells[2]{};
+  std::atomic_uint32_t writeCount{0};
+};
+} // namespace okapi
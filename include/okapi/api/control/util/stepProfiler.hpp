@@ -0,0 +1,129 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <string>
+
+namespace okapi {
+/**
+ * How often a controller was stepped and how long its steps took.
+ */
+struct StepProfile {
+  /**
+   * The number of times the controller was stepped.
+   */
+  std::uint32_t stepCount{0};
+
+  /**
+   * The number of steps which returned without updating because less than the sample time had
+   * passed since the last update.
+   */
+  std::uint32_t skippedCount{0};
+
+  /**
+   * The total time spent in the steps, including skipped ones, in microseconds.
+   */
+  std::uint64_t totalStepMicros{0};
+
+  /**
+   * The longest step, in microseconds.
+   */
+  std::uint32_t maxStepMicros{0};
+
+  /**
+   * @return The mean time of a step in microseconds, or `0` if there were no steps.
+   */
+  double meanStepMicros() const;
+
+  /**
+   * @return The profile formatted for a log line.
+   */
+  std::string toString() const;
+};
+
+/**
+ * Counts the steps of a controller and times them. Profiling is off by default and then costs one
+ * load per step. The counters are only written by the task which steps the controller, so they
+ * can be read from any task.
+ */
+class StepProfiler {
+  public:
+  /**
+   * Times one step from its construction to its destruction.
+   */
+  class Scope {
+    public:
+    /**
+     * @param iprofiler The profiler to record to, or `nullptr` to record nothing.
+     */
+    explicit Scope(StepProfiler *iprofiler);
+
+    Scope(const Scope &) = delete;
+    Scope &operator=(const Scope &) = delete;
+
+    ~Scope();
+
+    /**
+     * Marks the step as skipped because less than the sample time had passed.
+     */
+    void skip();
+
+    protected:
+    StepProfiler *profiler;
+    std::uint64_t start{0};
+    bool skipped{false};
+  };
+
+  StepProfiler() = default;
+
+  /**
+   * Copies the profile and whether profiling is on.
+   */
+  StepProfiler(const StepProfiler &iother);
+
+  StepProfiler &operator=(const StepProfiler &iother);
+
+  /**
+   * Starts timing a step. Keep the returned scope alive until the step returns.
+   *
+   * @return The scope of the step.
+   */
+  Scope start();
+
+  /**
+   * Sets whether steps are counted and timed.
+   *
+   * @param ienabled Whether steps are counted and timed.
+   */
+  void setEnabled(bool ienabled);
+
+  /**
+   * @return Whether steps are counted and timed.
+   */
+  bool isEnabled() const;
+
+  /**
+   * @return The profile of the steps since profiling started or was last reset.
+   */
+  StepProfile get() const;
+
+  /**
+   * Clears the profile.
+   */
+  void reset();
+
+  protected:
+  std::atomic_bool enabled{false};
+  std::atomic_uint32_t stepCount{0};
+  std::atomic_uint32_t skippedCount{0};
+  std::atomic_uint64_t totalStepMicros{0};
+  std::atomic_uint32_t maxStepMicros{0};
+
+  void record(std::uint64_t iduration, bool iskipped);
+};
+} // namespace okapi
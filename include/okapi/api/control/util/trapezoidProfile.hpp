@@ -0,0 +1,84 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#pragma once
+
+#include "okapi/api/units/QTime.hpp"
+#include "okapi/api/util/logging.hpp"
+#include <limits>
+#include <memory>
+
+namespace okapi {
+/**
+ * A one-dimensional move which starts and ends at rest. It accelerates at the max acceleration up
+ * to the max velocity, cruises, and decelerates to stop at the distance. Short moves never reach
+ * the max velocity. The units of the distance, velocity, acceleration, and jerk only have to agree
+ * with each other.
+ *
+ * With a max jerk, the acceleration ramps up and down instead of jumping, so the acceleration
+ * follows a trapezoid and the velocity follows an S-curve.
+ */
+class TrapezoidProfile {
+  public:
+  /**
+   * Where the move is at some time.
+   */
+  struct State {
+    double position{0};
+    double velocity{0};
+    double acceleration{0};
+  };
+
+  /**
+   * A move from zero to the distance. Throws a std::invalid_argument if the max velocity, max
+   * acceleration, or max jerk is not positive.
+   *
+   * @param idistance The distance to move. Negative distances move backwards.
+   * @param imaxVelocity The max velocity per second.
+   * @param imaxAcceleration The max acceleration per second squared.
+   * @param imaxJerk The max jerk per second cubed. Infinite jerk lets the acceleration jump.
+   * @param ilogger The logger this instance will log to.
+   */
+  TrapezoidProfile(double idistance,
+                   double imaxVelocity,
+                   double imaxAcceleration,
+                   double imaxJerk = std::numeric_limits<double>::infinity(),
+                   const std::shared_ptr<Logger> &ilogger = Logger::getDefaultLogger());
+
+  /**
+   * @param itime The time since the start of the move.
+   * @return Where the move is at the time. Before the start it is at zero and after the end it is
+   * at the distance, at rest.
+   */
+  State sample(const QTime &itime) const;
+
+  /**
+   * @return How long the move takes.
+   */
+  QTime getDuration() const;
+
+  protected:
+  std::shared_ptr<Logger> logger;
+  double direction;
+  double distance;
+  double jerk;
+  double acceleration;
+  double peakVelocity;
+  double jerkTime{0};
+  double accelTime{0};
+  double cruiseTime{0};
+
+  /**
+   * @param itime The time since the start of the move, up to the end of the acceleration.
+   * @return Where the move is while it accelerates, forwards.
+   */
+  State sampleAcceleration(double itime) const;
+
+  /**
+   * @return How long the move takes to reach the peak velocity, in seconds.
+   */
+  double rampTime() const;
+};
+} // namespace okapi
@@ -0,0 +1,111 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#pragma once
+
+#include "okapi/api/control/iterative/iterativePosPidController.hpp"
+#include "okapi/api/device/visionSamplingService.hpp"
+#include "okapi/api/odometry/odometry.hpp"
+#include "okapi/api/units/QAngle.hpp"
+#include "okapi/api/util/logging.hpp"
+#include "okapi/api/util/timeUtil.hpp"
+#include <memory>
+
+namespace okapi {
+/**
+ * Turns the robot to face an object seen by a vision sensor. Aiming straight at the offset in the
+ * image overshoots, because the image is old by the time it is read and the robot has turned
+ * since. Instead, each new frame is turned into a field-relative heading using the odometry state
+ * at the time the image was captured, and the robot is turned to that heading using the current
+ * odometry state. Between frames the error keeps following the odometry, so the aim converges in
+ * fewer iterations.
+ *
+ * Headings use the convention of `OdomState::theta`, and objects to the right of the center of the
+ * image are clockwise of the robot.
+ */
+class VisionAlignController {
+  public:
+  /**
+   * The horizontal field of view of the V5 vision sensor.
+   */
+  static constexpr double defaultFieldOfView = 61;
+
+  /**
+   * The width of an image from the V5 vision sensor in pixels.
+   */
+  static constexpr double defaultImageWidth = 316;
+
+  /**
+   * @param ivision The vision sensor. Its coordinates must be measured from the center of the
+   * image.
+   * @param iodometry The odometry, which must record its history.
+   * @param isignature The signature of the object to face.
+   * @param igains The gains of the controller which turns the robot, on the heading error in
+   * degrees.
+   * @param itimeUtil The time utility of the controller which turns the robot.
+   * @param ifieldOfView The horizontal field of view of the vision sensor.
+   * @param iimageWidth The width of an image in pixels.
+   * @param ilogger The logger this instance will log to.
+   */
+  VisionAlignController(std::shared_ptr<VisionSamplingService> ivision,
+                        std::shared_ptr<Odometry> iodometry,
+                        std::uint16_t isignature,
+                        const IterativePosPIDController::Gains &igains,
+                        const TimeUtil &itimeUtil,
+                        QAngle ifieldOfView = defaultFieldOfView * degree,
+                        double iimageWidth = defaultImageWidth,
+                        std::shared_ptr<Logger> ilogger = Logger::getDefaultLogger());
+
+  /**
+   * Takes the latest frame if it is new, and steps the controller which turns the robot.
+   *
+   * @return The turn output in the range [-1, 1], positive to turn clockwise. Zero until the object
+   * is seen.
+   */
+  double step();
+
+  /**
+   * @return Whether the object was seen since the last reset.
+   */
+  bool hasTarget() const;
+
+  /**
+   * @return The heading which faces the object, as of the latest frame which saw it.
+   */
+  QAngle getTargetHeading() const;
+
+  /**
+   * @return The angle the robot still has to turn to face the object, positive clockwise.
+   */
+  QAngle getError() const;
+
+  /**
+   * @return Whether the robot faces the object.
+   */
+  bool isSettled();
+
+  /**
+   * Forgets the object and resets the controller which turns the robot.
+   */
+  void reset();
+
+  protected:
+  std::shared_ptr<Logger> logger;
+  std::shared_ptr<VisionSamplingService> vision;
+  std::shared_ptr<Odometry> odometry;
+  std::uint16_t signature;
+  std::unique_ptr<IterativePosPIDController> controller;
+  double focalLength;
+
+  bool targetSeen{false};
+  QAngle targetHeading{0_deg};
+  std::uint32_t lastFrameCount{0};
+
+  /**
+   * Updates the target heading from the latest frame if it is new and saw the object.
+   */
+  void takeFrame();
+};
+} // namespace okapi
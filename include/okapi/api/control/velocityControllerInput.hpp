@@ -0,0 +1,48 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#pragma once
+
+#include "okapi/api/control/controllerInput.hpp"
+#include "okapi/api/device/rotarysensor/continuousRotarySensor.hpp"
+#include "okapi/api/util/logging.hpp"
+#include <memory>
+
+namespace okapi {
+class VelocityControllerInput : public ControllerInput<double> {
+  public:
+  /**
+   * A ControllerInput which reads the velocity a sensor measured, so a controller can control
+   * velocity without running a VelMath over the position of the sensor. Use it as the input of a
+   * position controller to control velocity with no differencing lag.
+   *
+   * ```cpp
+   * // Degrees per second to rpm
+   * auto input = std::make_shared<VelocityControllerInput>(
+   *   std::make_shared<RotationSensor>(1), 1.0 / 6);
+   * ```
+   *
+   * @param isensor The sensor to read. It must measure its velocity.
+   * @param iscale The number the velocity of the sensor is multiplied by.
+   * @param ilogger The logger this instance will log to.
+   */
+  explicit VelocityControllerInput(std::shared_ptr<ContinuousRotarySensor> isensor,
+                                   double iscale = 1,
+                                   const std::shared_ptr<Logger> &ilogger =
+                                     Logger::getDefaultLogger());
+
+  /**
+   * Get the velocity of the sensor for use in a control loop. This method might be automatically
+   * called in another thread by the controller.
+   *
+   * @return the velocity of the sensor times the scale, or `PROS_ERR_F` on a failure.
+   */
+  double controllerGet() override;
+
+  protected:
+  std::shared_ptr<ContinuousRotarySensor> sensor;
+  double scale;
+};
+} // namespace okapi
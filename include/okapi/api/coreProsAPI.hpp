@@ -5,6 +5,8 @@
  */
 #pragma once
 
+#include <array>
+#include <atomic>
 #include <cmath>
 #include <cstdbool>
 #include <cstddef>
@@ -12,19 +14,39 @@
 #include <cstdio>
 #include <cstdlib>
 #include <functional>
+#include <mutex>
 #include <sstream>
 
 #ifdef THREADS_STD
 #include <thread>
 #define CROSSPLATFORM_THREAD_T std::thread
 
-#include <mutex>
 #define CROSSPLATFORM_MUTEX_T std::mutex
+
+#include <chrono>
+#include <condition_variable>
+
+// Mirror the PROS task priorities and stack depths so task configuration compiles on the host
+#define TASK_PRIORITY_MAX 16
+#define TASK_PRIORITY_MIN 1
+#define TASK_PRIORITY_DEFAULT 8
+#define TASK_STACK_DEPTH_DEFAULT 0x2000
+#define TASK_STACK_DEPTH_MIN 0x200
 #else
 #include "api.h"
 #include "pros/apix.h"
 #define CROSSPLATFORM_THREAD_T pros::task_t
 #define CROSSPLATFORM_MUTEX_T pros::Mutex
+
+// The microsecond timer of the brain. PROS's own micros() is built on it, but this kernel does not
+// expose micros().
+extern "C" std::uint64_t vexSystemHighResTimeGet(void);
+
+// The least free stack space a task has had, in words. The vendored headers do not declare it, so
+// both the FreeRTOS name and the PROS name are referenced weakly; a kernel which exports neither
+// leaves the high-water mark unknown instead of failing to link.
+extern "C" std::uint32_t uxTaskGetStackHighWaterMark(pros::task_t) __attribute__((weak));
+extern "C" std::uint16_t task_get_stack_high_water_mark(pros::task_t) __attribute__((weak));
 #endif
 
 #define NOT_INITIALIZE_TASK                                                                        \
@@ -33,28 +55,145 @@
 #define NOT_COMP_INITIALIZE_TASK                                                                   \
   (strcmp(pros::c::task_get_name(pros::c::task_get_current()), "User Comp. Init. (PROS)") != 0)
 
+/**
+ * Whether CrossplatformMutex counts how often it had to wait. The count is only touched when a
+ * lock is contended, so it costs nothing on the fast path. Set it with a `-D`, e.g.
+ * `-DOKAPI_MUTEX_CONTENTION_STATS=0`, to leave the counters out.
+ */
+#ifndef OKAPI_MUTEX_CONTENTION_STATS
+#define OKAPI_MUTEX_CONTENTION_STATS 1
+#endif
+
+class CrossplatformMutex {
+  public:
+  CrossplatformMutex() = default;
+
+  /**
+   * Takes the mutex, blocking until it is free. On the brain, the waiting task sleeps until the
+   * mutex is given instead of waking up to poll it, and a lower-priority holder inherits the
+   * priority of the waiting task until it gives the mutex.
+   */
+  void lock() {
+#ifdef THREADS_STD
+    if (!mutex.try_lock()) {
+      countContention();
+      mutex.lock();
+    }
+#else
+    // PROS mutexes are FreeRTOS mutexes, which have priority inheritance
+    if (!mutex.take(0)) {
+      countContention();
+      while (!mutex.take(TIMEOUT_MAX)) {
+      }
+    }
+#endif
+  }
+
+  /**
+   * Takes the mutex if it is free.
+   *
+   * @return Whether the mutex was taken.
+   */
+  bool try_lock() {
+#ifdef THREADS_STD
+    return mutex.try_lock();
+#else
+    return mutex.take(0);
+#endif
+  }
+
+  void unlock() {
+#ifdef THREADS_STD
+    mutex.unlock();
+#else
+    mutex.give();
+#endif
+  }
+
+  /**
+   * @return The number of times `lock()` found the mutex taken and had to wait for it. Always zero
+   * when `OKAPI_MUTEX_CONTENTION_STATS` is zero.
+   */
+  std::uint32_t getContentionCount() const {
+#if OKAPI_MUTEX_CONTENTION_STATS
+    return contentions.load(std::memory_order_relaxed);
+#else
+    return 0;
+#endif
+  }
+
+  /**
+   * Clears the count of `getContentionCount()`.
+   */
+  void resetContentionCount() {
+#if OKAPI_MUTEX_CONTENTION_STATS
+    contentions.store(0, std::memory_order_relaxed);
+#endif
+  }
+
+  protected:
+  CROSSPLATFORM_MUTEX_T mutex;
+#if OKAPI_MUTEX_CONTENTION_STATS
+  std::atomic<std::uint32_t> contentions{0};
+#endif
+
+  void countContention() {
+#if OKAPI_MUTEX_CONTENTION_STATS
+    contentions.fetch_add(1, std::memory_order_relaxed);
+#endif
+  }
+};
+
+/**
+ * The stack of a task started by a CrossplatformThread.
+ */
+struct CrossplatformThreadStats {
+  char name[32]{};             ///< The name of the task, cut short if it is longer
+  std::uint16_t stackDepth{0}; ///< The stack depth the task was started with, in words
+  /**
+   * The least free stack space the task has had, in words, or -1 if it is not known. It is never
+   * known on the host.
+   */
+  std::int32_t stackHighWaterMark{-1};
+};
+
 class CrossplatformThread {
   public:
+  /**
+   * The most tasks whose stacks are tracked at once. Tasks started past this limit run normally but
+   * are not reported by `getStats()`.
+   */
+  static constexpr std::size_t maxTrackedThreads = 32;
+
 #ifdef THREADS_STD
   CrossplatformThread(void (*ptr)(void *),
                       void *params,
-                      const char *const = "OkapiLibCrossplatformTask")
+                      const char *const name = "OkapiLibCrossplatformTask",
+                      const std::uint32_t = TASK_PRIORITY_DEFAULT,
+                      const std::uint16_t istackDepth = TASK_STACK_DEPTH_DEFAULT)
 #else
   CrossplatformThread(void (*ptr)(void *),
                       void *params,
-                      const char *const name = "OkapiLibCrossplatformTask")
+                      const char *const name = "OkapiLibCrossplatformTask",
+                      const std::uint32_t ipriority = TASK_PRIORITY_DEFAULT,
+                      const std::uint16_t istackDepth = TASK_STACK_DEPTH_DEFAULT)
 #endif
-    :
+    : stackDepth(istackDepth),
 #ifdef THREADS_STD
-      thread(ptr, params)
+      thread([this, ptr, params]() {
+        current = this;
+        ptr(params);
+      })
 #else
-      thread(
-        pros::c::task_create(ptr, params, TASK_PRIORITY_DEFAULT, TASK_STACK_DEPTH_DEFAULT, name))
+      thread(pros::c::task_create(ptr, params, ipriority, istackDepth, name))
 #endif
   {
+    std::snprintf(trackedName, sizeof(trackedName), "%s", name ? name : "");
+    track();
   }
 
   ~CrossplatformThread() {
+    untrack();
 #ifdef THREADS_STD
     thread.join();
 #else
@@ -82,50 +221,265 @@ class CrossplatformThread {
   }
 #endif
 
+  /**
+   * The notification value `notify()` sets. Other notifications, like the one sent by
+   * `notifyWhenDeleting()`, increment the value instead, so they can be told apart from it.
+   */
+  static constexpr std::uint32_t wakeNotification = 1u << 31;
+
+  /**
+   * Wakes this task if it is blocked in `notifyTake()`.
+   */
 #ifdef THREADS_STD
-  std::uint32_t notifyTake(const std::uint32_t) {
-    return 0;
+  void notify() {
+    {
+      std::scoped_lock lock(notificationMutex);
+      notificationValue |= wakeNotification;
+    }
+    notificationCondition.notify_all();
   }
 #else
-  std::uint32_t notifyTake(const std::uint32_t itimeout) {
+  void notify() {
+    pros::c::task_notify_ext(thread, wakeNotification, pros::E_NOTIFY_ACTION_BITS, nullptr);
+  }
+#endif
+
+  /**
+   * Waits for a notification to the calling task and clears it.
+   *
+   * @param itimeout The longest time to wait in milliseconds.
+   * @return The notification value, or zero if there was no notification.
+   */
+#ifdef THREADS_STD
+  static std::uint32_t notifyTake(const std::uint32_t itimeout) {
+    CrossplatformThread *self = current;
+    if (!self) {
+      return 0;
+    }
+
+    std::unique_lock lock(self->notificationMutex);
+    self->notificationCondition.wait_for(lock, std::chrono::milliseconds(itimeout), [&]() {
+      return self->notificationValue != 0;
+    });
+    const std::uint32_t value = self->notificationValue;
+    self->notificationValue = 0;
+    return value;
+  }
+#else
+  static std::uint32_t notifyTake(const std::uint32_t itimeout) {
     return pros::c::task_notify_take(true, itimeout);
   }
 #endif
 
   static std::string getName() {
+    return std::string(getNameCString());
+  }
+
+  /**
+   * Gets the name of the calling task without allocating, so it can be used in hot paths like log
+   * statements. On the host, the name is formatted once per thread and cached.
+   *
+   * @return The name of the calling task. It is valid for as long as the task runs.
+   */
+  static const char *getNameCString() {
 #ifdef THREADS_STD
-    std::ostringstream ss;
-    ss << std::this_thread::get_id();
-    return ss.str();
+    if (cachedName[0] == '\0') {
+      std::ostringstream ss;
+      ss << std::this_thread::get_id();
+      std::snprintf(cachedName, sizeof(cachedName), "%s", ss.str().c_str());
+    }
+    return cachedName;
 #else
-    return std::string(pros::c::task_get_name(NULL));
+    return pros::c::task_get_name(NULL);
 #endif
   }
 
+  /**
+   * Gets the stack of every tracked task okapi started which is still running. Use the
+   * high-water marks to size the stack depths of the tasks.
+   *
+   * @param ostats The stacks are written here.
+   * @return The number of tracked tasks.
+   */
+  static std::size_t getStats(std::array<CrossplatformThreadStats, maxTrackedThreads> &ostats) {
+    Registry &registry = getRegistry();
+    std::scoped_lock lock(registry.mutex);
+
+    std::size_t count = 0;
+    for (const CrossplatformThread *tracked : registry.threads) {
+      if (tracked) {
+        CrossplatformThreadStats &stats = ostats[count++];
+        std::snprintf(stats.name, sizeof(stats.name), "%s", tracked->trackedName);
+        stats.stackDepth = tracked->stackDepth;
+        stats.stackHighWaterMark = tracked->getStackHighWaterMark();
+      }
+    }
+    return count;
+  }
+
+  protected:
+  struct Registry {
+    CrossplatformMutex mutex;
+    std::array<CrossplatformThread *, maxTrackedThreads> threads{};
+  };
+
+  static Registry &getRegistry() {
+    static Registry registry;
+    return registry;
+  }
+
+  void track() {
+    Registry &registry = getRegistry();
+    std::scoped_lock lock(registry.mutex);
+    for (auto &slot : registry.threads) {
+      if (!slot) {
+        slot = this;
+        return;
+      }
+    }
+  }
+
+  void untrack() {
+    Registry &registry = getRegistry();
+    std::scoped_lock lock(registry.mutex);
+    for (auto &slot : registry.threads) {
+      if (slot == this) {
+        slot = nullptr;
+        return;
+      }
+    }
+  }
+
+  std::int32_t getStackHighWaterMark() const {
+#ifdef THREADS_STD
+    return -1;
+#else
+    if (pros::c::task_get_state(thread) == pros::E_TASK_STATE_DELETED) {
+      return -1;
+    } else if (&task_get_stack_high_water_mark) {
+      return task_get_stack_high_water_mark(thread);
+    } else if (&uxTaskGetStackHighWaterMark) {
+      return static_cast<std::int32_t>(uxTaskGetStackHighWaterMark(thread));
+    }
+    return -1;
+#endif
+  }
+
+  public:
+  char trackedName[32]{};
+  std::uint16_t stackDepth;
+
+#ifdef THREADS_STD
+  // The thread is started last, so these must be declared before it
+  static inline thread_local CrossplatformThread *current{nullptr};
+  static inline thread_local char cachedName[32]{};
+  std::mutex notificationMutex;
+  std::condition_variable notificationCondition;
+  std::uint32_t notificationValue{0};
+#endif
+
   CROSSPLATFORM_THREAD_T thread;
 };
 
-class CrossplatformMutex {
+/**
+ * A monotonic clock with microsecond resolution, for measuring how long code takes to run.
+ */
+class CrossplatformClock {
   public:
-  CrossplatformMutex() = default;
+  /**
+   * @return The time in microseconds since an arbitrary start.
+   */
+  static std::uint64_t micros() {
+#ifdef THREADS_STD
+    return static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::microseconds>(
+                                        std::chrono::steady_clock::now().time_since_epoch())
+                                        .count());
+#else
+    return vexSystemHighResTimeGet();
+#endif
+  }
+};
 
-  void lock() {
+/**
+ * Wakes up tasks waiting for something to happen, like a controller settling. Each notification
+ * starts a new generation; waiters pass the generation they last saw so a notification which
+ * arrives before they start waiting is not missed.
+ */
+class CrossplatformEvent {
+  public:
 #ifdef THREADS_STD
-    mutex.lock();
+  CrossplatformEvent() = default;
 #else
-    while (!mutex.take(1)) {
+  CrossplatformEvent() : semaphore(pros::c::sem_binary_create()) {
+  }
+
+  ~CrossplatformEvent() {
+    pros::c::sem_delete(semaphore);
+  }
+#endif
+
+  CrossplatformEvent(const CrossplatformEvent &) = delete;
+  CrossplatformEvent &operator=(const CrossplatformEvent &) = delete;
+
+  /**
+   * @return The current generation. Read this before checking the condition being waited for.
+   */
+  std::uint32_t getGeneration() const {
+    return generation.load();
+  }
+
+  /**
+   * Wakes up every waiting task.
+   */
+  void notifyAll() {
+#ifdef THREADS_STD
+    {
+      std::scoped_lock lock(mutex);
+      generation++;
+    }
+    condition.notify_all();
+#else
+    generation++;
+    if (waiters.load() > 0) {
+      pros::c::sem_post(semaphore);
     }
 #endif
   }
 
-  void unlock() {
+  /**
+   * Blocks until there is a notification after `igeneration` or the timeout passes. This can
+   * return early, so the condition being waited for must be checked again afterwards.
+   *
+   * @param igeneration The generation read before the condition was last checked.
+   * @param itimeout The longest time to wait in milliseconds.
+   */
+  void waitFor(const std::uint32_t igeneration, const std::uint32_t itimeout) {
 #ifdef THREADS_STD
-    mutex.unlock();
+    std::unique_lock lock(mutex);
+    condition.wait_for(lock, std::chrono::milliseconds(itimeout), [&]() {
+      return generation.load() != igeneration;
+    });
 #else
-    mutex.give();
+    waiters++;
+    if (generation.load() == igeneration) {
+      pros::c::sem_wait(semaphore, itimeout);
+    }
+    waiters--;
+
+    // A binary semaphore only wakes one task, so pass the notification on to the next waiter
+    if (generation.load() != igeneration && waiters.load() > 0) {
+      pros::c::sem_post(semaphore);
+    }
 #endif
   }
 
   protected:
-  CROSSPLATFORM_MUTEX_T mutex;
+  std::atomic<std::uint32_t> generation{0};
+#ifdef THREADS_STD
+  std::mutex mutex;
+  std::condition_variable condition;
+#else
+  std::atomic<std::uint32_t> waiters{0};
+  pros::c::sem_t semaphore;
+#endif
 };
@@ -0,0 +1,35 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#pragma once
+
+#include "okapi/api/control/controllerInput.hpp"
+#include <cstdint>
+
+namespace okapi {
+/**
+ * A sensor which measures distance by pinging and listening for the echo, and which pings on its
+ * own while it is enabled. Sensors like this hear each other's pings, so a PingScheduler enables
+ * one at a time.
+ */
+class AbstractPingSensor : public ControllerInput<double> {
+  public:
+  virtual ~AbstractPingSensor();
+
+  /**
+   * Start pinging.
+   *
+   * @return `1` on success, `PROS_ERR` on fail
+   */
+  virtual std::int32_t startPinging() = 0;
+
+  /**
+   * Stop pinging.
+   *
+   * @return `1` on success, `PROS_ERR` on fail
+   */
+  virtual std::int32_t stopPinging() = 0;
+};
+} // namespace okapi
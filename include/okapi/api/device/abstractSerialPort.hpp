@@ -0,0 +1,38 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace okapi {
+/**
+ * A byte stream to another device, like a smart port configured as a generic serial port.
+ */
+class AbstractSerialPort {
+  public:
+  virtual ~AbstractSerialPort();
+
+  /**
+   * Reads the bytes which have already arrived, without blocking.
+   *
+   * @param obuffer The buffer to read into.
+   * @param ilength The most bytes to read.
+   * @return The number of bytes read, which is zero if none have arrived or the read failed.
+   */
+  virtual std::size_t read(std::uint8_t *obuffer, std::size_t ilength) = 0;
+
+  /**
+   * Queues bytes to be sent, without blocking.
+   *
+   * @param ibuffer The bytes to send.
+   * @param ilength The number of bytes to send.
+   * @return The number of bytes queued, which is less than `ilength` if the transmit buffer is full
+   * and zero if the write failed.
+   */
+  virtual std::size_t write(const std::uint8_t *ibuffer, std::size_t ilength) = 0;
+};
+} // namespace okapi
@@ -0,0 +1,180 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#pragma once
+
+#include "okapi/api/coreProsAPI.hpp"
+#include "okapi/api/units/QTime.hpp"
+#include "okapi/api/util/logging.hpp"
+#include "okapi/api/util/timeUtil.hpp"
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <vector>
+
+namespace okapi {
+/**
+ * A press or release of a button seen by a ButtonEventService.
+ */
+struct ButtonEvent {
+  /**
+   * The id of the button, which is its bit in the sampled button states.
+   */
+  std::uint8_t button{0};
+
+  /**
+   * True if the button was pressed, false if it was released.
+   */
+  bool pressed{false};
+
+  /**
+   * The time the edge was sampled.
+   */
+  QTime time{0_ms};
+};
+
+/**
+ * Samples the state of up to 32 buttons together once per sample period, from its own task, and
+ * turns their presses and releases into events. The events are queued for the user to `poll()`
+ * and passed to callbacks, so a tap between two polls of the user's loop is not lost, and every
+ * button is read once per sample instead of once per check.
+ */
+class ButtonEventService {
+  public:
+  /**
+   * Reads the state of every button at once, one bit per button with a set bit meaning pressed.
+   */
+  using Sampler = std::function<std::uint32_t()>;
+
+  using Callback = std::function<void(const ButtonEvent &ievent)>;
+
+  /**
+   * The button id which makes a callback get the events of every button.
+   */
+  static constexpr std::uint8_t anyButton = 0xFF;
+
+  /**
+   * The time between samples, by default.
+   */
+  static constexpr QTime defaultSamplePeriod = 10_ms; // NOLINT
+
+  /**
+   * The number of events the queue holds, by default.
+   */
+  static constexpr std::size_t defaultQueueCapacity = 32;
+
+  /**
+   * Samples buttons together and turns their presses and releases into events. Call
+   * `startThread()` to start sampling from a task, or call `step()` from your own loop.
+   *
+   * @param isampler The function which reads the state of every button.
+   * @param itimeUtil The time utility which supplies the timer of the events and the rate of the
+   * sampling task.
+   * @param isamplePeriod The time between samples.
+   * @param iqueueCapacity The number of events the queue holds. Events are dropped while the queue
+   * is full.
+   * @param ilogger The logger this instance will log to.
+   */
+  ButtonEventService(Sampler isampler,
+                     const TimeUtil &itimeUtil,
+                     const QTime &isamplePeriod = defaultSamplePeriod,
+                     std::size_t iqueueCapacity = defaultQueueCapacity,
+                     std::shared_ptr<Logger> ilogger = Logger::getDefaultLogger());
+
+  ButtonEventService(const ButtonEventService &) = delete;
+  ButtonEventService &operator=(const ButtonEventService &) = delete;
+
+  /**
+   * Stops the sampling task.
+   */
+  virtual ~ButtonEventService();
+
+  /**
+   * Samples every button once, queues an event for each button which changed, and calls the
+   * callbacks of those events. This is called by the sampling task; call it yourself if you don't
+   * start the task. The first sample only records the states of the buttons.
+   */
+  void step();
+
+  /**
+   * Takes the oldest queued event.
+   *
+   * @param oevent The event, if there was one.
+   * @return Whether there was an event.
+   */
+  bool poll(ButtonEvent &oevent);
+
+  /**
+   * Adds a function called for each event of a button. Callbacks are called from the task which
+   * samples, so they should be quick. Callbacks do not take events from the queue.
+   *
+   * @param ibutton The id of the button, or `anyButton` for every button.
+   * @param icallback The function to call.
+   */
+  void addCallback(std::uint8_t ibutton, Callback icallback);
+
+  /**
+   * @param ibutton The id of the button.
+   * @return Whether the button was pressed in the last sample.
+   */
+  bool isPressed(std::uint8_t ibutton) const;
+
+  /**
+   * @return The state of every button in the last sample.
+   */
+  std::uint32_t getStates() const;
+
+  /**
+   * @return The number of events which were dropped because the queue was full.
+   */
+  std::uint32_t getDroppedCount() const;
+
+  /**
+   * Starts the internal thread. This should not be called by normal users.
+   *
+   * @param ipriority The priority of the task.
+   * @param istackDepth The stack depth of the task in words.
+   */
+  void startThread(std::uint32_t ipriority = TASK_PRIORITY_DEFAULT,
+                   std::uint16_t istackDepth = TASK_STACK_DEPTH_DEFAULT);
+
+  /**
+   * Returns the underlying thread handle.
+   *
+   * @return The underlying thread handle.
+   */
+  CrossplatformThread *getThread() const;
+
+  protected:
+  struct ButtonCallback {
+    std::uint8_t button;
+    Callback callback;
+  };
+
+  std::shared_ptr<Logger> logger;
+  Sampler sampler;
+  TimeUtil timeUtil;
+  std::unique_ptr<AbstractTimer> timer;
+  QTime samplePeriod;
+
+  std::atomic_uint32_t states{0};
+  bool hasSampled{false};
+
+  // A ring of queueCapacity events, guarded by mutex
+  std::vector<ButtonEvent> queue;
+  std::size_t queueHead{0};
+  std::size_t queueSize{0};
+  std::vector<ButtonCallback> callbacks{};
+  mutable CrossplatformMutex mutex;
+
+  std::atomic_uint32_t droppedCount{0};
+  std::atomic_bool dtorCalled{false};
+  CrossplatformThread *task{nullptr};
+
+  static void trampoline(void *context);
+  void loop();
+};
+} // namespace okapi
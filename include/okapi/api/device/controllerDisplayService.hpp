@@ -0,0 +1,169 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#pragma once
+
+#include "okapi/api/coreProsAPI.hpp"
+#include "okapi/api/units/QTime.hpp"
+#include "okapi/api/util/logging.hpp"
+#include "okapi/api/util/timeUtil.hpp"
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+
+namespace okapi {
+/**
+ * Buffers the text and rumble written to a controller screen and sends them at the rate the
+ * controller accepts. Writes only change the desired contents of the screen; the task sends one
+ * write per period, either the pending rumble or the changed columns of one line, so writes are
+ * never dropped by the controller and a loop can redraw the screen every iteration for free.
+ */
+class ControllerDisplayService {
+  public:
+  /**
+   * Writes text to the screen at a line and column. Returns whether the write was accepted.
+   */
+  using TextWriter =
+    std::function<bool(std::uint8_t iline, std::uint8_t icol, const std::string &itext)>;
+
+  /**
+   * Sends a rumble pattern. Returns whether the write was accepted.
+   */
+  using RumbleWriter = std::function<bool(const std::string &ipattern)>;
+
+  static constexpr std::uint8_t lines = 3;
+  static constexpr std::uint8_t columns = 15;
+
+  /**
+   * The time between writes, by default. The controller drops writes which arrive faster.
+   */
+  static constexpr QTime defaultWritePeriod = 50_ms; // NOLINT
+
+  /**
+   * Buffers writes to a controller screen. Call `startThread()` to send them from a task, or call
+   * `step()` from your own loop once per write period. The whole screen is sent on the first
+   * writes, which clears whatever was on it before.
+   *
+   * @param itextWriter The function which writes text to the screen.
+   * @param irumbleWriter The function which sends a rumble pattern.
+   * @param itimeUtil The time utility which supplies the rate of the writing task.
+   * @param iwritePeriod The time between writes.
+   * @param ilogger The logger this instance will log to.
+   */
+  ControllerDisplayService(TextWriter itextWriter,
+                           RumbleWriter irumbleWriter,
+                           const TimeUtil &itimeUtil,
+                           const QTime &iwritePeriod = defaultWritePeriod,
+                           std::shared_ptr<Logger> ilogger = Logger::getDefaultLogger());
+
+  ControllerDisplayService(const ControllerDisplayService &) = delete;
+  ControllerDisplayService &operator=(const ControllerDisplayService &) = delete;
+
+  /**
+   * Stops the writing task.
+   */
+  virtual ~ControllerDisplayService();
+
+  /**
+   * Puts text on the screen at a line and column. Text past the end of the line is cut off, and
+   * writes to a line which does not exist are ignored.
+   *
+   * @param iline The line in the range [0, 2].
+   * @param icol The column in the range [0, 14].
+   * @param itext The text.
+   */
+  void setText(std::uint8_t iline, std::uint8_t icol, const std::string &itext);
+
+  /**
+   * Blanks a line of the screen.
+   *
+   * @param iline The line in the range [0, 2].
+   */
+  void clearLine(std::uint8_t iline);
+
+  /**
+   * Blanks every line of the screen.
+   */
+  void clear();
+
+  /**
+   * Rumbles the controller. A pattern which was not sent yet is replaced. The rumble is sent
+   * before any text.
+   *
+   * @param ipattern A string of '.', '-', and ' ', up to 8 characters long.
+   */
+  void rumble(const std::string &ipattern);
+
+  /**
+   * @param iline The line in the range [0, 2].
+   * @return The text the line will show once it is sent.
+   */
+  std::string getText(std::uint8_t iline) const;
+
+  /**
+   * @return Whether everything written was sent.
+   */
+  bool isSynced() const;
+
+  /**
+   * Forgets what the screen shows, so the whole screen is sent again. Use this if the screen was
+   * written to by something else, or the controller was reconnected.
+   */
+  void invalidate();
+
+  /**
+   * Sends the pending rumble, or else the changed columns of the next line which changed. This is
+   * called by the writing task; call it yourself, once per write period, if you don't start the
+   * task.
+   *
+   * @return Whether anything was sent.
+   */
+  bool step();
+
+  /**
+   * Starts the internal thread. This should not be called by normal users.
+   *
+   * @param ipriority The priority of the task.
+   * @param istackDepth The stack depth of the task in words.
+   */
+  void startThread(std::uint32_t ipriority = TASK_PRIORITY_DEFAULT,
+                   std::uint16_t istackDepth = TASK_STACK_DEPTH_DEFAULT);
+
+  /**
+   * Returns the underlying thread handle.
+   *
+   * @return The underlying thread handle.
+   */
+  CrossplatformThread *getThread() const;
+
+  protected:
+  using Line = std::array<char, columns>;
+
+  // A character the screen never shows, so a line holding it is always sent
+  static constexpr char unknownChar = '\0';
+
+  std::shared_ptr<Logger> logger;
+  TextWriter textWriter;
+  RumbleWriter rumbleWriter;
+  TimeUtil timeUtil;
+  QTime writePeriod;
+
+  // Guarded by mutex
+  std::array<Line, lines> desired{};
+  std::array<Line, lines> sent{};
+  std::string pendingRumble{};
+  std::uint8_t nextLine{0};
+  mutable CrossplatformMutex mutex;
+
+  std::atomic_bool dtorCalled{false};
+  CrossplatformThread *task{nullptr};
+
+  static void trampoline(void *context);
+  void loop();
+};
+} // namespace okapi
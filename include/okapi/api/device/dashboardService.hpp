@@ -0,0 +1,208 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#pragma once
+
+#include "okapi/api/control/closedLoopController.hpp"
+#include "okapi/api/coreProsAPI.hpp"
+#include "okapi/api/device/motor/abstractMotor.hpp"
+#include "okapi/api/odometry/odometry.hpp"
+#include "okapi/api/units/QTime.hpp"
+#include "okapi/api/util/logging.hpp"
+#include "okapi/api/util/timeUtil.hpp"
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <optional>
+#include <string>
+#include <vector>
+
+namespace okapi {
+/**
+ * A grid of live values, like the pose of the robot or the error of a controller, shown on a
+ * screen. A low-priority task reads every field once per refresh period and only rewrites the cells
+ * whose text changed, so an unchanged screen costs nothing to redraw. Fields are read from the
+ * dashboard task, so their sources must be safe to call from another task and must not block, like
+ * the sources of a `TelemetryStream`. The dashboard never locks anything the control tasks use.
+ */
+class DashboardService {
+  public:
+  /**
+   * Rewrites the text of a cell.
+   */
+  using CellWriter = std::function<void(std::size_t icell, const std::string &itext)>;
+
+  /**
+   * The most fields shown at once.
+   */
+  static constexpr std::size_t maxCells = 18;
+
+  /**
+   * The time between refreshes, by default.
+   */
+  static constexpr QTime defaultRefreshPeriod = 100_ms; // NOLINT
+
+  /**
+   * The shortest time between refreshes. Shorter periods are raised to this, because redrawing the
+   * screen faster takes time from the control tasks without being readable.
+   */
+  static constexpr QTime minRefreshPeriod = 50_ms; // NOLINT
+
+  /**
+   * Shows fields through a cell writer. Call `startThread()` to refresh them from a task, or call
+   * `step()` from your own loop.
+   *
+   * @param icellWriter The function which rewrites the text of a cell.
+   * @param itimeUtil The time utility which supplies the rate of the refresh task.
+   * @param irefreshPeriod The time between refreshes, at least `minRefreshPeriod`.
+   * @param ilogger The logger this instance will log to.
+   */
+  DashboardService(CellWriter icellWriter,
+                   const TimeUtil &itimeUtil,
+                   const QTime &irefreshPeriod = defaultRefreshPeriod,
+                   std::shared_ptr<Logger> ilogger = Logger::getDefaultLogger());
+
+  DashboardService(const DashboardService &) = delete;
+  DashboardService &operator=(const DashboardService &) = delete;
+
+  /**
+   * Stops the refresh task.
+   */
+  virtual ~DashboardService();
+
+  /**
+   * Adds a field shown as `<label>: <text>`.
+   *
+   * @param ilabel The label, or an empty string to show only the text.
+   * @param isource Reads the current text.
+   * @return Whether the field was added, which fails once there are `maxCells` fields.
+   */
+  bool addField(const std::string &ilabel, std::function<std::string()> isource);
+
+  /**
+   * Adds a field showing a number.
+   *
+   * @param ilabel The label.
+   * @param isource Reads the current value.
+   * @param iprecision The number of digits after the decimal point.
+   * @return Whether the field was added, which fails once there are `maxCells` fields.
+   */
+  bool addValue(const std::string &ilabel, std::function<double()> isource, int iprecision = 2);
+
+  /**
+   * Adds fields showing the x and y position in inches and the heading in degrees.
+   *
+   * @param iodometry The odometry. Its state must be readable without blocking, like the state of
+   * every odometry okapi makes.
+   * @return Whether the fields were added.
+   */
+  bool addOdometry(const std::shared_ptr<Odometry> &iodometry);
+
+  /**
+   * Adds a field showing the error of a controller.
+   *
+   * @param ilabel The label.
+   * @param icontroller The controller.
+   * @return Whether the field was added.
+   */
+  bool addError(const std::string &ilabel,
+                const std::shared_ptr<ClosedLoopController<double, double>> &icontroller);
+
+  /**
+   * Adds a field showing the temperature of a motor in degrees Celsius.
+   *
+   * @param ilabel The label.
+   * @param imotor The motor.
+   * @return Whether the field was added.
+   */
+  bool addTemperature(const std::string &ilabel, const std::shared_ptr<AbstractMotor> &imotor);
+
+  /**
+   * Adds fields showing the busiest tasks measured by the `TaskProfiler`, with how much of their
+   * time they spend running their loop and their longest loop body.
+   *
+   * @param icount The number of tasks to show.
+   * @return Whether the fields were added.
+   */
+  bool addTaskLoad(std::size_t icount = 3);
+
+  /**
+   * @return The number of fields.
+   */
+  std::size_t getFieldCount() const;
+
+  /**
+   * @param icell The index of the cell.
+   * @return The text the cell shows, or an empty string if it has not been written.
+   */
+  std::string getText(std::size_t icell) const;
+
+  /**
+   * Forgets what the cells show, so every cell is written again on the next refresh. Use this if
+   * the screen was drawn over by something else.
+   */
+  void invalidate();
+
+  /**
+   * Reads every field and rewrites the cells whose text changed. This is called by the refresh
+   * task; call it yourself, once per refresh period, if you don't start the task.
+   *
+   * @return The number of cells rewritten.
+   */
+  std::size_t step();
+
+  /**
+   * Starts the refresh task.
+   *
+   * @param ipriority The priority of the task. This should be lower than the control tasks.
+   * @param istackDepth The stack depth of the task in words.
+   */
+  void startThread(std::uint32_t ipriority = TASK_PRIORITY_MIN,
+                   std::uint16_t istackDepth = TASK_STACK_DEPTH_DEFAULT);
+
+  /**
+   * @return The underlying thread handle.
+   */
+  CrossplatformThread *getThread() const;
+
+  protected:
+  struct Field {
+    std::string label;
+    std::function<std::string()> source;
+  };
+
+  std::shared_ptr<Logger> logger;
+  CellWriter cellWriter;
+  TimeUtil timeUtil;
+  QTime refreshPeriod;
+
+  // Only this service and the tasks adding fields lock fieldMutex
+  std::vector<Field> fields{};
+  mutable CrossplatformMutex fieldMutex;
+
+  // What each cell shows, or nothing if it is unknown. Guarded by shownMutex.
+  std::array<std::optional<std::string>, maxCells> shown{};
+  mutable CrossplatformMutex shownMutex;
+
+  std::atomic_bool dtorCalled{false};
+  CrossplatformThread *task{nullptr};
+
+  static void trampoline(void *context);
+  void loop();
+
+  /**
+   * Stops the refresh task. A subclass whose cell writer uses its own members calls this from its
+   * destructor, so the task is stopped before those members are destroyed.
+   */
+  void stopThread();
+
+  /**
+   * Formats a number with a fixed number of digits after the decimal point.
+   */
+  static std::string formatValue(double ivalue, int iprecision);
+};
+} // namespace okapi
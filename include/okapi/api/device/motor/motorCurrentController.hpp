@@ -0,0 +1,164 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#pragma once
+
+#include "okapi/api/control/controllerOutput.hpp"
+#include "okapi/api/coreProsAPI.hpp"
+#include "okapi/api/device/motor/abstractMotor.hpp"
+#include "okapi/api/units/QTime.hpp"
+#include "okapi/api/util/logging.hpp"
+#include "okapi/api/util/timeUtil.hpp"
+#include <atomic>
+#include <cstdint>
+#include <memory>
+
+namespace okapi {
+/**
+ * The electrical constants of a motor, used to work out the voltage which makes it draw a current.
+ */
+struct MotorCurrentModel {
+  /**
+   * The current in mA the motor draws when stalled at `maxVoltage`.
+   */
+  double stallCurrent{2500};
+
+  /**
+   * The largest voltage in mV the motor can be given.
+   */
+  double maxVoltage{12000};
+};
+
+/**
+ * The gains of the loop a MotorCurrentController corrects the feedforward with.
+ */
+struct MotorCurrentGains {
+  /**
+   * The voltage in mV added per mA of error.
+   */
+  double kP{1};
+
+  /**
+   * The voltage in mV added per mA of error per second.
+   */
+  double kI{50};
+};
+
+/**
+ * Controls the current a motor draws, and so the torque it applies, instead of its voltage,
+ * velocity, or position. The motor is given the voltage a DC motor needs to draw the target
+ * current at its present velocity, `I * R + kE * velocity`, and a PI loop on the motor's current
+ * draw corrects what the model gets wrong. This lets a clamp or an intake push as hard as it is
+ * allowed to and hold there when it stalls, instead of running at full voltage into its current
+ * and thermal limits.
+ *
+ * The motor only reports the magnitude of its current draw, so the loop controls the magnitude and
+ * the sign of the target sets the direction. Call `startThread()` to run the loop from its own
+ * task, or call `step()` from your own loop.
+ */
+class MotorCurrentController : public ControllerOutput<double> {
+  public:
+  /**
+   * The time between steps of the loop, by default. The motor updates its current draw every 10 ms.
+   */
+  static constexpr QTime defaultLoopPeriod = 10_ms; // NOLINT
+
+  /**
+   * Controls the current a motor draws. The current limit of the motor is set to `imaxCurrent` so
+   * the motor enforces it between steps too.
+   *
+   * Throws a `std::invalid_argument` if the maximum current, the loop period, or a constant of the
+   * model is not positive.
+   *
+   * @param imotor The motor to control.
+   * @param itimeUtil The time utility which supplies the rate of the loop task.
+   * @param imaxCurrent The largest current in mA the motor may be asked to draw.
+   * @param imodel The electrical constants of the motor.
+   * @param igains The gains of the correcting loop.
+   * @param iloopPeriod The time between steps of the loop task.
+   * @param ilogger The logger this instance will log to.
+   */
+  MotorCurrentController(std::shared_ptr<AbstractMotor> imotor,
+                         const TimeUtil &itimeUtil,
+                         std::int32_t imaxCurrent = 2500,
+                         const MotorCurrentModel &imodel = {},
+                         const MotorCurrentGains &igains = {},
+                         const QTime &iloopPeriod = defaultLoopPeriod,
+                         std::shared_ptr<Logger> ilogger = Logger::getDefaultLogger());
+
+  MotorCurrentController(const MotorCurrentController &) = delete;
+  MotorCurrentController &operator=(const MotorCurrentController &) = delete;
+
+  /**
+   * Stops the loop task and the motor.
+   */
+  virtual ~MotorCurrentController();
+
+  /**
+   * Sets the current the motor should draw. It is clamped to the maximum current. Zero stops the
+   * motor.
+   *
+   * @param icurrent The current in mA. Negative currents push the other way.
+   */
+  void setTarget(std::int32_t icurrent);
+
+  /**
+   * @return The current in mA the motor should draw.
+   */
+  std::int32_t getTarget() const;
+
+  /**
+   * @return The largest current in mA the motor may be asked to draw.
+   */
+  std::int32_t getMaxCurrent() const;
+
+  /**
+   * Sets the current the motor should draw as a fraction of the maximum current.
+   *
+   * @param ivalue The fraction of the maximum current, in `[-1, 1]`.
+   */
+  void controllerSet(double ivalue) override;
+
+  /**
+   * Reads the motor and writes the voltage which makes it draw the target current. This is called
+   * by the loop task; call it yourself once per loop period if you don't start the task.
+   */
+  void step();
+
+  /**
+   * Starts the internal thread. This should not be called by normal users.
+   *
+   * @param ipriority The priority of the task.
+   * @param istackDepth The stack depth of the task in words.
+   */
+  void startThread(std::uint32_t ipriority = TASK_PRIORITY_DEFAULT,
+                   std::uint16_t istackDepth = TASK_STACK_DEPTH_DEFAULT);
+
+  /**
+   * Returns the underlying thread handle.
+   *
+   * @return The underlying thread handle.
+   */
+  CrossplatformThread *getThread() const;
+
+  protected:
+  std::shared_ptr<AbstractMotor> motor;
+  TimeUtil timeUtil;
+  std::int32_t maxCurrent;
+  MotorCurrentModel model;
+  MotorCurrentGains gains;
+  QTime loopPeriod;
+  std::shared_ptr<Logger> logger;
+  std::atomic_int32_t target{0};
+  // Only the task which calls step() uses the loop's state
+  double integral{0};
+  std::int32_t lastTarget{0};
+  std::atomic_bool dtorCalled{false};
+  CrossplatformThread *task{nullptr};
+
+  static void trampoline(void *context);
+  void loop();
+};
+} // namespace okapi
@@ -0,0 +1,218 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#pragma once
+
+#include "okapi/api/coreProsAPI.hpp"
+#include "okapi/api/device/motor/abstractMotor.hpp"
+#include "okapi/api/units/QTime.hpp"
+#include "okapi/api/util/logging.hpp"
+#include "okapi/api/util/timeUtil.hpp"
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <vector>
+
+namespace okapi {
+/**
+ * The thresholds a MotorHealthMonitor watches a motor against.
+ */
+struct MotorHealthLimits {
+  /**
+   * The temperature in degrees Celsius above which the motor is too hot. The V5 motor starts
+   * limiting its own power at 55 C.
+   */
+  double maxTemperature{50};
+
+  /**
+   * How far below `maxTemperature` the motor has to cool before it is not too hot anymore.
+   */
+  double temperatureHysteresis{5};
+
+  /**
+   * The current draw in mA above which the motor draws too much current.
+   */
+  std::int32_t maxCurrentDraw{2500};
+
+  /**
+   * The current limit in mA set on the motor while it is too hot. The limit the motor had before
+   * is set again once it cools. Zero leaves the current limit alone.
+   */
+  std::int32_t hotCurrentLimit{0};
+};
+
+/**
+ * The rolling statistics of a motor watched by a MotorHealthMonitor.
+ */
+struct MotorHealthStats {
+  double temperature{0};
+  double meanTemperature{0};
+  double peakTemperature{0};
+  std::int32_t currentDraw{0};
+  double meanCurrentDraw{0};
+  std::int32_t peakCurrentDraw{0};
+  std::uint32_t faults{0};
+  bool isOverTemp{false};
+  bool isOverCurrent{false};
+  bool isTooHot{false};
+  bool isDrawingTooMuchCurrent{false};
+  std::uint32_t sampleCount{0};
+  std::uint32_t failedSampleCount{0};
+};
+
+/**
+ * Samples the temperature, current draw, over-temperature and over-current flags, and faults of a
+ * set of motors at a low rate from its own task, so user code doesn't have to poll them from the
+ * main loop. It keeps rolling statistics of each motor and calls a callback when a motor crosses a
+ * threshold, and can lower the current limit of a motor while it is too hot.
+ */
+class MotorHealthMonitor {
+  public:
+  /**
+   * The things the monitor reports to its callback.
+   */
+  enum class event {
+    tooHot,                  ///< The temperature rose above the maximum temperature
+    cooledDown,              ///< The temperature fell below the maximum minus the hysteresis
+    drawingTooMuchCurrent,   ///< The current draw rose above the maximum current draw
+    currentDrawNormal,       ///< The current draw fell back to the maximum current draw or below
+    overTemp,                ///< The motor set its over-temperature flag
+    overCurrent,             ///< The motor set its over-current flag
+    newFaults                ///< The motor reported a fault it did not report on the last sample
+  };
+
+  using Callback =
+    std::function<void(std::size_t imotor, event ievent, const MotorHealthStats &istats)>;
+
+  /**
+   * The time between samples, by default.
+   */
+  static constexpr QTime defaultSamplePeriod = 100_ms; // NOLINT
+
+  /**
+   * The weight of each new sample in the mean temperature and current draw.
+   */
+  static constexpr double meanWeight = 0.1;
+
+  /**
+   * Samples the health of a set of motors. Call `startThread()` to start sampling from a task, or
+   * call `step()` from your own loop.
+   *
+   * @param itimeUtil The time utility which supplies the rate of the sampling task.
+   * @param isamplePeriod The time between samples.
+   * @param ilogger The logger this instance will log to.
+   */
+  explicit MotorHealthMonitor(const TimeUtil &itimeUtil,
+                              const QTime &isamplePeriod = defaultSamplePeriod,
+                              std::shared_ptr<Logger> ilogger = Logger::getDefaultLogger());
+
+  MotorHealthMonitor(const MotorHealthMonitor &) = delete;
+  MotorHealthMonitor &operator=(const MotorHealthMonitor &) = delete;
+
+  /**
+   * Stops the sampling task.
+   */
+  ~MotorHealthMonitor();
+
+  /**
+   * Adds a motor to watch.
+   *
+   * @param imotor The motor.
+   * @param ilimits The thresholds to watch the motor against.
+   * @return The index of the motor, passed to the callback and used to get its statistics.
+   */
+  std::size_t addMotor(std::shared_ptr<AbstractMotor> imotor, const MotorHealthLimits &ilimits);
+
+  /**
+   * Adds a motor to watch against the default thresholds.
+   *
+   * @param imotor The motor.
+   * @return The index of the motor, passed to the callback and used to get its statistics.
+   */
+  std::size_t addMotor(std::shared_ptr<AbstractMotor> imotor);
+
+  /**
+   * Sets the function called when a motor crosses a threshold. It is called from the task which
+   * samples, after the sample, so it should be quick and must not call `addMotor()`.
+   *
+   * @param icallback The function to call, or an empty function to stop reporting.
+   */
+  void setCallback(Callback icallback);
+
+  /**
+   * Samples every motor once. This is called by the sampling task; call it yourself if you don't
+   * start the task.
+   */
+  void step();
+
+  /**
+   * @param imotor The index returned by `addMotor()`.
+   * @return The statistics of the motor.
+   */
+  MotorHealthStats getStats(std::size_t imotor) const;
+
+  /**
+   * Clears the statistics of every motor. The thresholds are checked from scratch on the next
+   * sample.
+   */
+  void resetStats();
+
+  /**
+   * @return The number of motors watched.
+   */
+  std::size_t getMotorCount() const;
+
+  /**
+   * Starts the internal thread. This should not be called by normal users.
+   *
+   * @param ipriority The priority of the task.
+   * @param istackDepth The stack depth of the task in words.
+   */
+  void startThread(std::uint32_t ipriority = TASK_PRIORITY_DEFAULT,
+                   std::uint16_t istackDepth = TASK_STACK_DEPTH_DEFAULT);
+
+  /**
+   * Returns the underlying thread handle.
+   *
+   * @return The underlying thread handle.
+   */
+  CrossplatformThread *getThread() const;
+
+  protected:
+  struct WatchedMotor {
+    std::shared_ptr<AbstractMotor> motor;
+    MotorHealthLimits limits;
+    MotorHealthStats stats;
+    std::int32_t normalCurrentLimit;
+  };
+
+  struct PendingEvent {
+    std::size_t motor;
+    event type;
+    MotorHealthStats stats;
+  };
+
+  std::shared_ptr<Logger> logger;
+  TimeUtil timeUtil;
+  QTime samplePeriod;
+  std::vector<WatchedMotor> motors{};
+  Callback callback{};
+  mutable CrossplatformMutex mutex;
+  std::atomic_bool dtorCalled{false};
+  CrossplatformThread *task{nullptr};
+
+  static void trampoline(void *context);
+  void loop();
+
+  /**
+   * Samples one motor and records the thresholds it crossed. Call with the mutex held.
+   *
+   * @param iindex The index of the motor.
+   * @param oevents The events to report.
+   */
+  void sample(std::size_t iindex, std::vector<PendingEvent> &oevents);
+};
+} // namespace okapi
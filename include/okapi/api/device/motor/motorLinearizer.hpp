@@ -0,0 +1,114 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#pragma once
+
+#include "okapi/api/device/rotarysensor/rotarySensor.hpp"
+#include "okapi/api/units/QTime.hpp"
+#include "okapi/api/util/logging.hpp"
+#include "okapi/api/util/timeUtil.hpp"
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <cstdlib>
+#include <functional>
+#include <memory>
+#include <utility>
+#include <vector>
+
+namespace okapi {
+/**
+ * Maps a command to the PWM value which makes a legacy motor run at that fraction of its top
+ * speed. The motor controller of a 393 motor barely moves it for small PWM values and saturates
+ * well before full PWM, so a linear mapping gives a dead zone and a flat top which a PID
+ * controller sees as a nonlinear plant. The map is a table with one entry per PWM magnitude and is
+ * the same for both directions.
+ */
+class MotorLinearizer {
+  public:
+  /**
+   * The largest PWM magnitude of a legacy motor.
+   */
+  static constexpr std::int32_t maxPwm = 127;
+
+  /**
+   * The PWM magnitude to send for each command magnitude, from `0` to `maxPwm`.
+   */
+  using Table = std::array<std::uint8_t, maxPwm + 1>;
+
+  /**
+   * A map which sends each command unchanged.
+   */
+  MotorLinearizer();
+
+  /**
+   * A map from a table, for example one printed by `getTable()` after a calibration.
+   *
+   * @param itable The PWM magnitude to send for each command magnitude.
+   */
+  explicit MotorLinearizer(const Table &itable);
+
+  /**
+   * Builds the map from measurements of the speed of the motor at some PWM values. The speed
+   * between measurements is interpolated, and a speed lower than at a smaller PWM value is raised
+   * to it, so the response is never taken to go down.
+   *
+   * Throws a `std::invalid_argument` if there is no measurement with a nonzero speed.
+   *
+   * @param iresponse Pairs of a PWM magnitude, in `[0, maxPwm]`, and the speed of the motor at it,
+   * in any units.
+   * @param ilogger The logger this instance will log to.
+   */
+  static MotorLinearizer
+  fromResponse(std::vector<std::pair<std::int32_t, double>> iresponse,
+               const std::shared_ptr<Logger> &ilogger = Logger::getDefaultLogger());
+
+  /**
+   * Measures the response of a motor and builds the map from it. The motor is run in one
+   * direction at PWM values `istep` apart, and its speed at each is measured with a sensor on it
+   * after it settles. The motor is stopped afterwards. This blocks for about
+   * `(maxPwm / istep + 2) * (isettleTime + isampleTime)`, so run it with the robot free to move,
+   * for example with the wheels off the ground.
+   *
+   * Throws a `std::invalid_argument` if the motor did not move.
+   *
+   * @param ipwmWriter Sends a raw PWM value to the motor, without any map applied.
+   * @param isensor A sensor which measures the position of the motor.
+   * @param itimeUtil The TimeUtil used to wait.
+   * @param istep The PWM difference between measurements.
+   * @param isettleTime The time the motor is given to reach a steady speed.
+   * @param isampleTime The time the speed is measured over.
+   * @param ilogger The logger this instance will log to.
+   * @return The map.
+   */
+  static MotorLinearizer
+  calibrate(const std::function<void(std::int8_t)> &ipwmWriter,
+            const std::shared_ptr<RotarySensor> &isensor,
+            const TimeUtil &itimeUtil,
+            std::int32_t istep = 8,
+            QTime isettleTime = 500_ms,
+            QTime isampleTime = 250_ms,
+            const std::shared_ptr<Logger> &ilogger = Logger::getDefaultLogger());
+
+  /**
+   * Maps a command. Commands past `maxPwm` are clamped.
+   *
+   * @param icommand The command in the range `[-127, 127]`.
+   * @return The PWM value to send in the range `[-127, 127]`.
+   */
+  std::int8_t operator()(const std::int32_t icommand) const {
+    const auto entry = table[static_cast<std::size_t>(std::min(std::abs(icommand), maxPwm))];
+    return static_cast<std::int8_t>(icommand < 0 ? -entry : entry);
+  }
+
+  /**
+   * @return The PWM magnitude sent for each command magnitude.
+   */
+  const Table &getTable() const;
+
+  protected:
+  Table table{};
+};
+} // namespace okapi
@@ -0,0 +1,142 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#pragma once
+
+#include "okapi/api/device/motor/abstractMotor.hpp"
+#include "okapi/api/units/QTime.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace okapi {
+/**
+ * The settings of a MotorLoadBalancer.
+ */
+struct MotorLoadBalancerParams {
+  /**
+   * How fast the trims move, in mV of trim per mA of imbalance per second.
+   */
+  double gain{2};
+
+  /**
+   * The largest trim in mV. This bounds how differently two motors can be driven.
+   */
+  double maxTrim{1500};
+
+  /**
+   * How far in rpm a motor's velocity may be from the median velocity of the group before it is
+   * left out of the balancing, for example because it is unplugged or its gears slip.
+   */
+  double slipVelocity{30};
+
+  /**
+   * The mean current in mA below which the load is too light to balance. The trims are held while
+   * the current is below this.
+   */
+  double minCurrent{200};
+};
+
+/**
+ * Trims the voltage of each motor in a group of mechanically linked motors so they share the load
+ * evenly. Motors which are built or worn slightly differently draw different currents for the
+ * same voltage, so the motor which draws the most heats up first and the group is throttled when
+ * the other motors still have margin. Each step, every motor's trim moves towards drawing the mean
+ * current of the group, and the trims are kept centered on zero, so the group as a whole is driven
+ * as hard as it was asked to be.
+ */
+class MotorLoadBalancer {
+  public:
+  /**
+   * One reading of a motor. A reading which failed is `OKAPI_PROS_ERR` or infinite.
+   */
+  struct Reading {
+    double velocity{0};    // rpm
+    double currentDraw{0}; // mA
+  };
+
+  /**
+   * @param imotorCount The number of motors in the group.
+   * @param iparams The settings.
+   */
+  explicit MotorLoadBalancer(std::size_t imotorCount, const MotorLoadBalancerParams &iparams = {});
+
+  /**
+   * Moves the trims towards sharing the load evenly. Motors whose reading failed or which move
+   * differently from the rest of the group get no trim.
+   *
+   * @param ireadings One reading of each motor.
+   * @param idt The time since the last update. Longer times are capped so a gap between updates
+   * does not make the trims jump.
+   */
+  void update(const std::vector<Reading> &ireadings, QTime idt);
+
+  /**
+   * Applies a motor's trim to a voltage. The trim pushes in the direction of the voltage, so a
+   * positive trim makes the motor work harder in either direction.
+   *
+   * @param imotor The index of the motor.
+   * @param ivoltage The voltage the group is driven with, in mV.
+   * @return The voltage for the motor, in `[-12000, 12000]`.
+   */
+  std::int16_t apply(std::size_t imotor, std::int16_t ivoltage) const;
+
+  /**
+   * Reads every motor, updates the trims, and drives each motor with the voltage plus its trim.
+   *
+   * @param imotors The motors of the group, in the order of the trims.
+   * @param ivoltage The voltage the group is driven with, in mV.
+   * @param idt The time since the last update.
+   * @return 1 if every command succeeded, otherwise the error of the last one which failed.
+   */
+  std::int32_t moveVoltage(const std::vector<std::shared_ptr<AbstractMotor>> &imotors,
+                           std::int16_t ivoltage,
+                           QTime idt);
+
+  /**
+   * Drives each motor at the velocity untrimmed. The velocity loop of each motor holds its
+   * velocity until the next command, and a voltage trim would only last until that loop
+   * overrode it, so the load is balanced only by voltage commands. The trims are kept for the
+   * next voltage command.
+   *
+   * @param imotors The motors of the group.
+   * @param ivelocity The velocity the group is driven at.
+   * @return 1 if every command succeeded, otherwise the error of the last one which failed.
+   */
+  static std::int32_t moveVelocity(const std::vector<std::shared_ptr<AbstractMotor>> &imotors,
+                                   std::int16_t ivelocity);
+
+  /**
+   * @param imotor The index of the motor.
+   * @return The trim of the motor in mV.
+   */
+  double getTrim(std::size_t imotor) const;
+
+  /**
+   * Clears every trim.
+   */
+  void reset();
+
+  /**
+   * @return The settings.
+   */
+  const MotorLoadBalancerParams &getParams() const;
+
+  protected:
+  MotorLoadBalancerParams params;
+  std::vector<double> trims;
+  std::vector<bool> balanced;
+  // Holds the velocities while the median is found, so an update does not allocate
+  std::vector<double> scratch;
+  // Holds the readings of the motors in moveVoltage(), so a command does not allocate
+  std::vector<Reading> readings;
+
+  /**
+   * The longest time one update integrates over.
+   */
+  static constexpr QTime maxDt = 100_ms; // NOLINT
+};
+} // namespace okapi
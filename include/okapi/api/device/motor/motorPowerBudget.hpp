@@ -0,0 +1,270 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#pragma once
+
+#include "okapi/api/coreProsAPI.hpp"
+#include "okapi/api/device/motor/abstractMotor.hpp"
+#include "okapi/api/units/QTime.hpp"
+#include "okapi/api/util/abstractTimer.hpp"
+#include "okapi/api/util/logging.hpp"
+#include "okapi/api/util/timeUtil.hpp"
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace okapi {
+/**
+ * A first order thermal model of a motor. The winding heats up with the power lost in it and cools
+ * towards the ambient temperature, so at a constant current it settles at
+ * `ambientTemperature + current^2 * windingResistance * thermalResistance`. The defaults are rough
+ * values for a V5 motor; fit them to your robot by logging the temperature under a known load.
+ */
+struct MotorThermalModel {
+  /**
+   * The temperature of the air around the motor in degrees Celsius.
+   */
+  double ambientTemperature{25};
+
+  /**
+   * The temperature in degrees Celsius at which the motor starts limiting its own power. The V5
+   * motor halves its power at 55 C.
+   */
+  double throttleTemperature{55};
+
+  /**
+   * The resistance of the winding in ohms. The power lost in it is the current squared times this.
+   */
+  double windingResistance{4.8};
+
+  /**
+   * How far the motor heats up above the ambient temperature per watt lost, once settled, in
+   * degrees Celsius per watt.
+   */
+  double thermalResistance{5};
+
+  /**
+   * The time constant of the heating and cooling.
+   */
+  QTime timeConstant{300_s};
+
+  /**
+   * The step between the temperatures the motor reports in degrees Celsius. The V5 motor reports
+   * its temperature in steps of 5 C, so between steps the model tracks it. Zero trusts every
+   * reading as it is.
+   */
+  double temperatureResolution{5};
+};
+
+/**
+ * A group of motors which share a current limit, such as the drivetrain or an intake.
+ */
+struct PowerBudgetSubsystem {
+  /**
+   * How strongly the subsystem competes for current when the motors ask for more than the budget.
+   * A subsystem with twice the weight is cut back half as much.
+   */
+  double weight{1};
+
+  /**
+   * The current limit in mA each motor keeps however tight the budget is.
+   */
+  std::int32_t minCurrentLimit{500};
+
+  /**
+   * The current limit in mA each motor gets when there is enough budget.
+   */
+  std::int32_t maxCurrentLimit{2500};
+};
+
+/**
+ * The state of a motor managed by a MotorPowerBudget.
+ */
+struct MotorPowerStats {
+  double temperature{0};          // The temperature the motor reported, in C
+  double estimatedTemperature{0}; // The temperature the model estimates, in C
+  double meanCurrentDraw{0};      // mA
+  double power{0};                // W
+  double sustainableCurrent{0};   // The current the motor can hold until the match ends, in mA
+  std::int32_t currentLimit{0};   // The current limit set on the motor, in mA
+  QTime timeToThrottle{0_ms};     // How long the motor lasts at its mean current draw
+};
+
+/**
+ * Moves current limits between subsystems so the robot performs as well at the end of a match as
+ * at the start. From its own task it reads the temperature, current draw, and power of every
+ * motor, estimates the temperature of each winding with a thermal model, and works out the highest
+ * current each motor can draw for the rest of the match without reaching its throttle temperature.
+ * Each motor's current limit is capped at that current, so a motor which has worked hard is eased
+ * off before it throttles instead of after. When the limits of all the motors add up to more than
+ * the total budget, the subsystems are cut back by their weights.
+ *
+ * The budget owns the current limits of its motors, so don't also give them a `hotCurrentLimit` in
+ * a MotorHealthMonitor.
+ */
+class MotorPowerBudget {
+  public:
+  /**
+   * The time between samples, by default.
+   */
+  static constexpr QTime defaultSamplePeriod = 100_ms; // NOLINT
+
+  /**
+   * The shortest horizon a motor is budgeted for, so the limits don't jump up as the match ends.
+   */
+  static constexpr QTime minHorizon = 10_s; // NOLINT
+
+  /**
+   * The weight of each new sample in the mean current draw.
+   */
+  static constexpr double meanWeight = 0.1;
+
+  /**
+   * Budgets the current of a set of subsystems. Call `startThread()` to sample from a task, or call
+   * `step()` from your own loop.
+   *
+   * @param itimeUtil The time utility which supplies the timer and the rate of the sampling task.
+   * @param itotalCurrent The most current in mA the current limits of all the motors add up to.
+   * @param imatchLength The length of the match, counted from `startMatch()`.
+   * @param imodel The thermal model of the motors.
+   * @param isamplePeriod The time between samples.
+   * @param ilogger The logger this instance will log to.
+   */
+  explicit MotorPowerBudget(const TimeUtil &itimeUtil,
+                            std::int32_t itotalCurrent = 20000,
+                            const QTime &imatchLength = 105_s,
+                            const MotorThermalModel &imodel = {},
+                            const QTime &isamplePeriod = defaultSamplePeriod,
+                            std::shared_ptr<Logger> ilogger = Logger::getDefaultLogger());
+
+  MotorPowerBudget(const MotorPowerBudget &) = delete;
+  MotorPowerBudget &operator=(const MotorPowerBudget &) = delete;
+
+  /**
+   * Stops the sampling task.
+   */
+  ~MotorPowerBudget();
+
+  /**
+   * Adds a subsystem to budget. Throws a `std::invalid_argument` if the weight is not positive or
+   * the current limits are out of order.
+   *
+   * @param imotors The motors of the subsystem.
+   * @param isubsystem How the subsystem is budgeted.
+   * @return The index of the subsystem.
+   */
+  std::size_t addSubsystem(const std::vector<std::shared_ptr<AbstractMotor>> &imotors,
+                           const PowerBudgetSubsystem &isubsystem = {});
+
+  /**
+   * Starts counting down the match. The motors are budgeted to last until it ends.
+   */
+  void startMatch();
+
+  /**
+   * Samples every motor and sets the current limits once. This is called by the sampling task;
+   * call it yourself if you don't start the task.
+   */
+  void step();
+
+  /**
+   * @param isubsystem The index returned by `addSubsystem()`.
+   * @param imotor The index of the motor in the subsystem.
+   * @return The state of the motor.
+   */
+  MotorPowerStats getMotorStats(std::size_t isubsystem, std::size_t imotor) const;
+
+  /**
+   * @param isubsystem The index returned by `addSubsystem()`.
+   * @return How long until the first motor of the subsystem throttles at the current it has been
+   * drawing.
+   */
+  QTime getTimeToThrottle(std::size_t isubsystem) const;
+
+  /**
+   * @param isubsystem The index returned by `addSubsystem()`.
+   * @return The power the motors of the subsystem draw, in W.
+   */
+  double getPower(std::size_t isubsystem) const;
+
+  /**
+   * @return The number of subsystems.
+   */
+  std::size_t getSubsystemCount() const;
+
+  /**
+   * Starts the internal thread. This should not be called by normal users.
+   *
+   * @param ipriority The priority of the task.
+   * @param istackDepth The stack depth of the task in words.
+   */
+  void startThread(std::uint32_t ipriority = TASK_PRIORITY_DEFAULT,
+                   std::uint16_t istackDepth = TASK_STACK_DEPTH_DEFAULT);
+
+  /**
+   * Returns the underlying thread handle.
+   *
+   * @return The underlying thread handle.
+   */
+  CrossplatformThread *getThread() const;
+
+  protected:
+  struct BudgetedMotor {
+    std::shared_ptr<AbstractMotor> motor;
+    MotorPowerStats stats;
+    bool sampled{false};
+    std::int32_t target{0}; // The limit before the budget is shared out
+  };
+
+  struct Subsystem {
+    std::vector<BudgetedMotor> motors;
+    PowerBudgetSubsystem params;
+  };
+
+  std::shared_ptr<Logger> logger;
+  TimeUtil timeUtil;
+  std::unique_ptr<AbstractTimer> timer;
+  std::int32_t totalCurrent;
+  QTime matchLength;
+  MotorThermalModel model;
+  QTime samplePeriod;
+  QTime matchStart{0_ms};
+  QTime lastSample{0_ms};
+  bool hasSampled{false};
+  bool overBudgetLogged{false};
+  std::vector<Subsystem> subsystems{};
+  mutable CrossplatformMutex mutex;
+  std::atomic_bool dtorCalled{false};
+  CrossplatformThread *task{nullptr};
+
+  static void trampoline(void *context);
+  void loop();
+
+  /**
+   * Samples one motor and updates its thermal estimate. Call with the mutex held.
+   *
+   * @param imotor The motor.
+   * @param idt The time since the last sample in seconds.
+   * @param ihorizon The time left in the match in seconds.
+   * @param isubsystem How the motor's subsystem is budgeted.
+   */
+  void sample(BudgetedMotor &imotor,
+              double idt,
+              double ihorizon,
+              const PowerBudgetSubsystem &isubsystem);
+
+  /**
+   * Shares the total budget between the subsystems and sets the current limits. Call with the
+   * mutex held.
+   */
+  void allocate();
+
+  /**
+   * @return How long a motor lasts at a current before it reaches the throttle temperature.
+   */
+  QTime predictTimeToThrottle(double iestimatedTemperature, double icurrent) const;
+};
+} // namespace okapi
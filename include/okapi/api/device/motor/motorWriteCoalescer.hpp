@@ -0,0 +1,83 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#pragma once
+
+#include "okapi/api/units/QTime.hpp"
+#include <cstdint>
+
+namespace okapi {
+/**
+ * Decides whether a motor command needs to be sent, so a drive loop which sends the same command
+ * every iteration only talks to the motor when the command changes. A repeated command is still
+ * sent once every refresh period, in case the motor missed or dropped the last write. Coalescing
+ * is disabled until enabled with `setEnabled()`, in which case every command is sent.
+ */
+class MotorWriteCoalescer {
+  public:
+  /**
+   * The kind of command the value is for.
+   */
+  enum class command {
+    none,     ///< No command has been sent
+    velocity, ///< A velocity command
+    voltage   ///< A voltage command
+  };
+
+  /**
+   * @param irefreshPeriod The longest time a repeated command is skipped for.
+   */
+  explicit MotorWriteCoalescer(QTime irefreshPeriod = 100_ms);
+
+  /**
+   * Returns whether a command has to be sent to the motor, and remembers it as the last write if
+   * it does. The command does not have to be sent if it is the same as the last write and the
+   * last write was less than the refresh period ago.
+   *
+   * @param icommand The kind of command.
+   * @param ivalue The command value.
+   * @param inow The current time.
+   * @return Whether the command has to be sent.
+   */
+  bool shouldWrite(command icommand, std::int32_t ivalue, QTime inow);
+
+  /**
+   * Forgets the last write, so the next command is always sent. Call this when the motor is
+   * commanded some other way or a write fails.
+   */
+  void invalidate();
+
+  /**
+   * Sets whether repeated commands are skipped.
+   *
+   * @param ienabled Whether to skip repeated commands.
+   */
+  void setEnabled(bool ienabled);
+
+  /**
+   * @return Whether repeated commands are skipped.
+   */
+  bool isEnabled() const;
+
+  /**
+   * Sets the longest time a repeated command is skipped for.
+   *
+   * @param irefreshPeriod The refresh period.
+   */
+  void setRefreshPeriod(QTime irefreshPeriod);
+
+  /**
+   * @return The longest time a repeated command is skipped for.
+   */
+  QTime getRefreshPeriod() const;
+
+  protected:
+  QTime refreshPeriod;
+  bool enabled{false};
+  command lastCommand{command::none};
+  std::int32_t lastValue{0};
+  QTime lastWriteTime{0_ms};
+};
+} // namespace okapi
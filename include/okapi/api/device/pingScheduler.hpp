@@ -0,0 +1,125 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#pragma once
+
+#include "okapi/api/coreProsAPI.hpp"
+#include "okapi/api/device/abstractPingSensor.hpp"
+#include "okapi/api/units/QTime.hpp"
+#include "okapi/api/util/logging.hpp"
+#include "okapi/api/util/timeUtil.hpp"
+#include <atomic>
+#include <memory>
+#include <vector>
+
+namespace okapi {
+/**
+ * Takes turns between ping sensors so only one pings at a time and none hears another's echo.
+ * Each turn lasts one slot: the scheduler reads the sensor whose turn ended, caches the reading,
+ * stops that sensor, and starts the next one. Reading the cache never waits on a sensor.
+ *
+ * ```cpp
+ * auto left = std::make_shared<ADIUltrasonic>('A', 'B', std::make_unique<MedianFilter<3>>());
+ * auto right = std::make_shared<ADIUltrasonic>('C', 'D', std::make_unique<MedianFilter<3>>());
+ * PingScheduler pings(TimeUtilFactory::createDefault());
+ * const auto leftIndex = pings.addSensor(left);
+ * const auto rightIndex = pings.addSensor(right);
+ * pings.startThread();
+ * ```
+ */
+class PingScheduler {
+  public:
+  /**
+   * The length of a turn, by default. This is long enough for an ultrasonic to ping and hear the
+   * echo from the end of its range.
+   */
+  static constexpr QTime defaultSlotPeriod = 50_ms; // NOLINT
+
+  /**
+   * Takes turns between ping sensors. Call `startThread()` to take turns from a task, or call
+   * `step()` from your own loop once per slot.
+   *
+   * @param itimeUtil The time utility which supplies the rate of the scheduling task.
+   * @param islotPeriod The length of a turn.
+   * @param ilogger The logger this instance will log to.
+   */
+  explicit PingScheduler(const TimeUtil &itimeUtil,
+                         const QTime &islotPeriod = defaultSlotPeriod,
+                         std::shared_ptr<Logger> ilogger = Logger::getDefaultLogger());
+
+  PingScheduler(const PingScheduler &) = delete;
+  PingScheduler &operator=(const PingScheduler &) = delete;
+
+  /**
+   * Stops the scheduling task.
+   */
+  ~PingScheduler();
+
+  /**
+   * Adds a sensor to take turns with. The sensor is stopped until its turn.
+   *
+   * @param isensor The sensor. Its `controllerGet()` is read once at the end of each of its turns,
+   * so give it the filter its readings should go through.
+   * @return The index of the sensor, used to get its reading.
+   */
+  std::size_t addSensor(std::shared_ptr<AbstractPingSensor> isensor);
+
+  /**
+   * Ends the current turn and starts the next one. This is called by the scheduling task; call it
+   * yourself, once per slot, if you don't start the task.
+   */
+  void step();
+
+  /**
+   * @param isensor The index returned by `addSensor()`.
+   * @return The reading from the last turn of the sensor, or `PROS_ERR` if it did not have a turn
+   * yet.
+   */
+  double get(std::size_t isensor) const;
+
+  /**
+   * @return The number of sensors taking turns.
+   */
+  std::size_t getSensorCount() const;
+
+  /**
+   * Starts the internal thread. This should not be called by normal users.
+   *
+   * @param ipriority The priority of the task.
+   * @param istackDepth The stack depth of the task in words.
+   */
+  void startThread(std::uint32_t ipriority = TASK_PRIORITY_DEFAULT,
+                   std::uint16_t istackDepth = TASK_STACK_DEPTH_DEFAULT);
+
+  /**
+   * Returns the underlying thread handle.
+   *
+   * @return The underlying thread handle.
+   */
+  CrossplatformThread *getThread() const;
+
+  protected:
+  struct ScheduledSensor {
+    std::shared_ptr<AbstractPingSensor> sensor;
+    double reading;
+  };
+
+  std::shared_ptr<Logger> logger;
+  TimeUtil timeUtil;
+  QTime slotPeriod;
+
+  // Guarded by mutex
+  std::vector<ScheduledSensor> sensors{};
+  std::size_t active{0};
+  bool isPinging{false};
+  mutable CrossplatformMutex mutex;
+
+  std::atomic_bool dtorCalled{false};
+  CrossplatformThread *task{nullptr};
+
+  static void trampoline(void *context);
+  void loop();
+};
+} // namespace okapi
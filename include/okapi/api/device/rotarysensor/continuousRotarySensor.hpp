@@ -16,5 +16,32 @@ class ContinuousRotarySensor : public RotarySensor {
    * @return `1` on success, `PROS_ERR` on fail
    */
   virtual std::int32_t reset() = 0;
+
+  /**
+   * Get the current sensor value and the time the device measured it. Sensors which don't report
+   * when they were measured set the timestamp to zero.
+   *
+   * @param otimestamp Set to the time the value was measured in milliseconds since the program
+   * started, or zero if the sensor doesn't report it.
+   * @return the current sensor value, or `PROS_ERR` on a failure.
+   */
+  virtual double getTimestamped(std::uint32_t &otimestamp) const {
+    otimestamp = 0;
+    return get();
+  }
+
+  /**
+   * Get the velocity the device measured, in the units of `get()` per second. This has none of the
+   * lag of differencing and filtering the position in software, like a VelMath does. Sensors which
+   * don't measure their velocity return `PROS_ERR_F`; see `measuresVelocity()`.
+   *
+   * @return the current velocity, or `PROS_ERR_F` on a failure.
+   */
+  virtual double getVelocity() const;
+
+  /**
+   * @return whether `getVelocity()` reads a velocity the device measured.
+   */
+  virtual bool measuresVelocity() const;
 };
 } // namespace okapi
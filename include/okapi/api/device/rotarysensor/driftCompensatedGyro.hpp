@@ -0,0 +1,165 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#pragma once
+
+#include "okapi/api/coreProsAPI.hpp"
+#include "okapi/api/device/rotarysensor/continuousRotarySensor.hpp"
+#include "okapi/api/units/QTime.hpp"
+#include "okapi/api/util/logging.hpp"
+#include "okapi/api/util/timeUtil.hpp"
+#include <atomic>
+#include <functional>
+#include <memory>
+
+namespace okapi {
+/**
+ * Removes the drift of a gyro by estimating its bias, the rate it reads while it is still, and
+ * subtracting the heading the bias adds up to. The bias is first estimated over the calibration
+ * time, from a task, so the program does not have to wait for it. After that, it is estimated
+ * again over every stretch of the calibration time the robot stays still, so the estimate follows
+ * the bias as the gyro warms up. The corrected heading is kept in an atomic, so reading it never
+ * waits on the gyro or the task.
+ *
+ * The robot must be still during the first calibration. If it moves, the calibration starts over.
+ *
+ * ```cpp
+ * auto gyro = std::make_shared<DriftCompensatedGyro>(std::make_shared<ADIGyro>('A'),
+ *                                                    TimeUtilFactory::createDefault());
+ * gyro->startThread();
+ * ```
+ */
+class DriftCompensatedGyro : public ContinuousRotarySensor {
+  public:
+  /**
+   * The time between samples of the gyro.
+   */
+  static constexpr QTime samplePeriod = 10_ms; // NOLINT
+
+  /**
+   * The time the rate of the gyro is measured over to decide whether the robot is still.
+   */
+  static constexpr QTime stillCheckPeriod = 100_ms; // NOLINT
+
+  /**
+   * How far each estimate after the first moves the bias toward what was measured.
+   */
+  static constexpr double biasUpdateGain = 0.25;
+
+  /**
+   * Compensates the drift of a gyro. Call `startThread()` to sample it from a task, or call
+   * `step()` every `samplePeriod` from your own loop.
+   *
+   * @param igyro The gyro.
+   * @param itimeUtil The time utility which supplies the timer of the samples and the rate of the
+   * sampling task.
+   * @param icalibrationTime The time the bias is estimated over.
+   * @param istillRate The robot is taken to be still while the rate of the gyro, less the bias, is
+   * at most this, in units of the gyro per second. An ADIGyro reads tenths of a degree, so the
+   * default is 2 degrees per second for it.
+   * @param ilogger The logger this instance will log to.
+   */
+  DriftCompensatedGyro(std::shared_ptr<ContinuousRotarySensor> igyro,
+                       const TimeUtil &itimeUtil,
+                       const QTime &icalibrationTime = 2_s,
+                       double istillRate = 20,
+                       std::shared_ptr<Logger> ilogger = Logger::getDefaultLogger());
+
+  DriftCompensatedGyro(const DriftCompensatedGyro &) = delete;
+  DriftCompensatedGyro &operator=(const DriftCompensatedGyro &) = delete;
+
+  /**
+   * Stops the sampling task.
+   */
+  ~DriftCompensatedGyro() override;
+
+  /**
+   * Decides whether the robot is still with a function instead of with the rate of the gyro, for
+   * example by checking that the drive encoders are not moving. This is more reliable, because
+   * the gyro cannot tell a slow turn from drift. The function is called from the sampling task.
+   *
+   * @param iisStill Returns whether the robot is still, or `nullptr` to use the rate of the gyro.
+   */
+  void setStillSupplier(std::function<bool()> iisStill);
+
+  /**
+   * Reads the gyro once, updates the estimate of the bias, and publishes the corrected heading.
+   * This is called by the sampling task; call it yourself if you don't start the task.
+   */
+  void step();
+
+  /**
+   * @return The corrected heading, or `PROS_ERR` if the gyro was not read yet.
+   */
+  double get() const override;
+
+  /**
+   * Resets the gyro and the corrected heading to zero. The estimate of the bias is kept.
+   *
+   * @return The result of resetting the gyro.
+   */
+  std::int32_t reset() override;
+
+  /**
+   * Get the corrected heading for use in a control loop. This never reads the gyro.
+   *
+   * @return The same as [get](@ref okapi::DriftCompensatedGyro::get).
+   */
+  double controllerGet() override;
+
+  /**
+   * @return The estimated bias, in units of the gyro per second.
+   */
+  double getBias() const;
+
+  /**
+   * @return Whether the first estimate of the bias is done. The heading is not corrected before.
+   */
+  bool isCalibrated() const;
+
+  /**
+   * Starts the sampling task.
+   *
+   * @param ipriority The priority of the task.
+   * @param istackDepth The stack depth of the task in words.
+   */
+  void startThread(std::uint32_t ipriority = TASK_PRIORITY_DEFAULT,
+                   std::uint16_t istackDepth = TASK_STACK_DEPTH_DEFAULT);
+
+  /**
+   * @return The underlying thread handle.
+   */
+  CrossplatformThread *getThread() const;
+
+  protected:
+  std::shared_ptr<Logger> logger;
+  std::shared_ptr<ContinuousRotarySensor> gyro;
+  TimeUtil timeUtil;
+  std::unique_ptr<AbstractTimer> timer;
+  QTime calibrationTime;
+  double stillRate;
+
+  // Only used with the mutex held
+  CrossplatformMutex mutex;
+  std::function<bool()> isStill{nullptr};
+  bool started{false};
+  QTime lastTime{0_ms};
+  double correction{0};
+  QTime checkTime{0_ms};
+  double checkReading{0};
+  QTime windowTime{0_ms};
+  double windowReading{0};
+
+  std::atomic<double> value;
+  std::atomic<double> bias{0};
+  std::atomic_bool calibrated{false};
+
+  std::atomic_bool dtorCalled{false};
+  CrossplatformThread *task{nullptr};
+
+  static void trampoline(void *context);
+  void loop();
+};
+} // namespace okapi
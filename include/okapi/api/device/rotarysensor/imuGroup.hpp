@@ -0,0 +1,64 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#pragma once
+
+#include "okapi/api/device/rotarysensor/continuousRotarySensor.hpp"
+#include "okapi/api/util/logging.hpp"
+#include <memory>
+#include <vector>
+
+namespace okapi {
+class ImuGroup : public ContinuousRotarySensor {
+  public:
+  /**
+   * Averages the headings of several inertial sensors. The drift of separate sensors is mostly
+   * independent, so the average drifts less than any one of them. Sensors which fail to read are
+   * left out of the average.
+   *
+   * ```cpp
+   * auto imus = ImuGroup({std::make_shared<IMU>(1), std::make_shared<IMU>(2)});
+   * ```
+   *
+   * @param iimus The sensors. Each must read its heading in degrees in the range [-180, 180], like
+   * `IMU` does. There must be at least one.
+   * @param ilogger The logger this instance will log to.
+   */
+  explicit ImuGroup(std::vector<std::shared_ptr<ContinuousRotarySensor>> iimus,
+                    const std::shared_ptr<Logger> &ilogger = Logger::getDefaultLogger());
+
+  /**
+   * Get the average heading of the sensors. The headings are averaged as angles, so headings on
+   * either side of 180 degrees average to 180 degrees.
+   *
+   * @return The average heading in degrees in the range [-180, 180], or `PROS_ERR` if no sensor
+   * could be read.
+   */
+  double get() const override;
+
+  /**
+   * Reset every sensor to zero.
+   *
+   * @return `1`, or `PROS_ERR` if any sensor failed to reset.
+   */
+  std::int32_t reset() override;
+
+  /**
+   * Get the sensor value for use in a control loop. This method might be automatically called in
+   * another thread by the controller.
+   *
+   * @return The same as [get](@ref okapi::ImuGroup::get).
+   */
+  double controllerGet() override;
+
+  /**
+   * @return The number of sensors in the group.
+   */
+  std::size_t size() const;
+
+  protected:
+  std::vector<std::shared_ptr<ContinuousRotarySensor>> imus;
+};
+} // namespace okapi
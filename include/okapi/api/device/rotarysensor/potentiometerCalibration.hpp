@@ -0,0 +1,63 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#pragma once
+
+#include "okapi/api/util/logging.hpp"
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <memory>
+#include <utility>
+#include <vector>
+
+namespace okapi {
+/**
+ * Maps the raw reading of a potentiometer to the angle of the mechanism it measures, through
+ * readings taken at known angles. The angle between those readings is interpolated linearly, and
+ * past the first and last ones it follows the nearest two. The map is computed once for every
+ * reading the ADI can give, so mapping a reading is one table lookup.
+ *
+ * ```cpp
+ * // The arm reads 310 when down, 1850 when level, and 3020 at the top
+ * auto calibration = std::make_shared<PotentiometerCalibration>(
+ *   std::vector<std::pair<std::int32_t, double>>{{310, -30}, {1850, 0}, {3020, 60}});
+ * ```
+ */
+class PotentiometerCalibration {
+  public:
+  /**
+   * The largest raw reading of an ADI analog port.
+   */
+  static constexpr std::int32_t maxRaw = 4095;
+
+  /**
+   * Computes the map from readings taken at known angles.
+   *
+   * Throws a `std::invalid_argument` if there are not at least two points with different raw
+   * readings.
+   *
+   * @param ipoints Pairs of a raw reading and the angle of the mechanism at it, in any units and
+   * in any order. Of points with the same raw reading, only the first is used.
+   * @param ilogger The logger this instance will log to.
+   */
+  explicit PotentiometerCalibration(
+    std::vector<std::pair<std::int32_t, double>> ipoints,
+    const std::shared_ptr<Logger> &ilogger = Logger::getDefaultLogger());
+
+  /**
+   * Maps a raw reading. Readings outside `[0, maxRaw]` are clamped.
+   *
+   * @param iraw The raw reading.
+   * @return The angle of the mechanism.
+   */
+  double operator()(const std::int32_t iraw) const {
+    return table[static_cast<std::size_t>(std::clamp(iraw, 0, maxRaw))];
+  }
+
+  protected:
+  std::array<float, maxRaw + 1> table{};
+};
+} // namespace okapi
@@ -0,0 +1,47 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#pragma once
+
+#include "okapi/api/device/rotarysensor/continuousRotarySensor.hpp"
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace okapi {
+/**
+ * Several sensors read together, back to back, so their readings are as close in time as the
+ * sensors allow. Odometry reads its tracking wheels through a group when its chassis model has
+ * one. This reads each sensor through `getTimestamped()`; subclasses for one kind of sensor read
+ * the devices directly instead.
+ */
+class RotarySensorGroup {
+  public:
+  /**
+   * @param isensors The sensors, in the order they are read in.
+   */
+  explicit RotarySensorGroup(std::vector<std::shared_ptr<ContinuousRotarySensor>> isensors);
+
+  virtual ~RotarySensorGroup();
+
+  /**
+   * Reads every sensor, back to back.
+   *
+   * @param ovalues The readings are written here, one per sensor in order.
+   * @param otimestamps The times the readings were measured are written here, like
+   * `ContinuousRotarySensor::getTimestamped()` writes them.
+   * @return The number of readings written, which is `size()`.
+   */
+  virtual std::size_t read(double *ovalues, std::uint32_t *otimestamps) const;
+
+  /**
+   * @return The number of sensors.
+   */
+  std::size_t size() const;
+
+  protected:
+  std::vector<std::shared_ptr<ContinuousRotarySensor>> sensors;
+};
+} // namespace okapi
@@ -0,0 +1,154 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#pragma once
+
+#include "okapi/api/control/controllerInput.hpp"
+#include "okapi/api/control/util/controlScheduler.hpp"
+#include "okapi/api/coreProsAPI.hpp"
+#include "okapi/api/filter/filter.hpp"
+#include "okapi/api/units/QTime.hpp"
+#include "okapi/api/util/logging.hpp"
+#include "okapi/api/util/timeUtil.hpp"
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <memory>
+
+namespace okapi {
+/**
+ * One reading of a sensor taken by a SensorSamplingService.
+ */
+struct SensorSample {
+  /**
+   * The value the sensor read, or `PROS_ERR` if the read failed.
+   */
+  double value{0};
+
+  /**
+   * How much the sensor trusts the value. Sensors which don't report a confidence use 1.
+   */
+  double confidence{1};
+};
+
+/**
+ * Reads a sensor from its own task at the rate the sensor updates, drops readings which failed or
+ * which the sensor has too little confidence in, and runs the rest through a filter. The latest
+ * filtered value is kept in an atomic, so reading it never waits on the sensor or the task.
+ */
+class SensorSamplingService : public ControllerInput<double> {
+  public:
+  /**
+   * Reads the sensor once.
+   */
+  using Sampler = std::function<SensorSample()>;
+
+  /**
+   * Samples a sensor and filters its readings. Call `startThread()` to start sampling from a task,
+   * or call `step()` from your own loop.
+   *
+   * @param isampler The function which reads the sensor.
+   * @param ifilter The filter the accepted readings are run through, such as a MedianFilter to
+   * reject outliers. Use a ComposableFilter to run several filters.
+   * @param iminConfidence Readings with a confidence below this are dropped.
+   * @param itimeUtil The time utility which supplies the timer of the samples and the rate of the
+   * sampling task.
+   * @param isamplePeriod The time between samples.
+   * @param ilogger The logger this instance will log to.
+   */
+  SensorSamplingService(Sampler isampler,
+                        std::unique_ptr<Filter> ifilter,
+                        double iminConfidence,
+                        const TimeUtil &itimeUtil,
+                        const QTime &isamplePeriod,
+                        std::shared_ptr<Logger> ilogger = Logger::getDefaultLogger());
+
+  SensorSamplingService(const SensorSamplingService &) = delete;
+  SensorSamplingService &operator=(const SensorSamplingService &) = delete;
+
+  /**
+   * Stops the sampling task.
+   */
+  virtual ~SensorSamplingService();
+
+  /**
+   * Reads the sensor once and, if the reading is accepted, filters it and publishes the result.
+   * This is called by the sampling task; call it yourself if you don't start the task.
+   *
+   * @return Whether the reading was accepted.
+   */
+  bool step();
+
+  /**
+   * @return The latest filtered value, or `PROS_ERR` if no reading was accepted yet.
+   */
+  double get() const;
+
+  /**
+   * Get the latest filtered value for use in a control loop. This never reads the sensor.
+   *
+   * @return The same as [get](@ref okapi::SensorSamplingService::get).
+   */
+  double controllerGet() override;
+
+  /**
+   * @return The time the latest accepted reading was taken, or zero if none was accepted yet.
+   */
+  QTime getLastSampleTime() const;
+
+  /**
+   * @return The number of readings which were dropped because they failed or had too little
+   * confidence.
+   */
+  std::uint32_t getRejectedCount() const;
+
+  /**
+   * Starts the internal thread. This should not be called by normal users.
+   *
+   * @param ipriority The priority of the task.
+   * @param istackDepth The stack depth of the task in words.
+   */
+  void startThread(std::uint32_t ipriority = TASK_PRIORITY_DEFAULT,
+                   std::uint16_t istackDepth = TASK_STACK_DEPTH_DEFAULT);
+
+  /**
+   * Samples the sensor from a shared scheduler in its sensors phase instead of starting an internal
+   * thread, so the controllers stepped in the same tick read the new value. This should not be
+   * called by normal users, and not together with `startThread`.
+   *
+   * @param ischeduler The scheduler to sample the sensor from.
+   */
+  void startScheduled(const std::shared_ptr<ControlScheduler> &ischeduler);
+
+  /**
+   * Returns the underlying thread handle.
+   *
+   * @return The underlying thread handle.
+   */
+  CrossplatformThread *getThread() const;
+
+  protected:
+  std::shared_ptr<Logger> logger;
+  Sampler sampler;
+  std::unique_ptr<Filter> filter;
+  double minConfidence;
+  TimeUtil timeUtil;
+  std::unique_ptr<AbstractTimer> timer;
+  QTime samplePeriod;
+
+  // The filter is only used by step(), so only the published results need to be atomic
+  std::atomic<double> value;
+  std::atomic_uint32_t lastSampleTime{0};
+  std::atomic_uint32_t rejectedCount{0};
+
+  std::atomic_bool dtorCalled{false};
+  CrossplatformThread *task{nullptr};
+  std::shared_ptr<ControlScheduler> scheduler{nullptr};
+  std::size_t schedulerLoopId{0};
+
+  static void trampoline(void *context);
+  void loop();
+};
+} // namespace okapi
@@ -0,0 +1,165 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#pragma once
+
+#include "okapi/api/coreProsAPI.hpp"
+#include "okapi/api/units/QTime.hpp"
+#include "okapi/api/util/logging.hpp"
+#include "okapi/api/util/timeUtil.hpp"
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+
+namespace okapi {
+/**
+ * An object seen by a vision sensor. Coordinates are in pixels from the center of the image, with
+ * x to the right and y down.
+ */
+struct VisionObject {
+  std::uint16_t signature{0};
+  std::int16_t x{0};
+  std::int16_t y{0};
+  std::uint16_t width{0};
+  std::uint16_t height{0};
+};
+
+/**
+ * The objects seen in one read of a vision sensor, largest first.
+ */
+struct VisionFrame {
+  static constexpr std::size_t maxObjects = 8;
+
+  /**
+   * When the image was captured, in the time base of `Timer::millis`. This is the time of the read
+   * minus the latency of the sensor.
+   */
+  QTime time{0_ms};
+
+  std::uint8_t count{0};
+  std::array<VisionObject, maxObjects> objects{};
+
+  /**
+   * @param isignature The signature to look for.
+   * @return The largest object with the signature, or nullptr if there is none.
+   */
+  const VisionObject *findLargest(std::uint16_t isignature) const;
+};
+
+/**
+ * Reads a vision sensor from its own task and keeps the latest frame in a double buffer. Reading
+ * the frame never waits on the sensor or the task, and never sees a frame which is partly written.
+ */
+class VisionSamplingService {
+  public:
+  /**
+   * Reads the sensor once.
+   *
+   * @param oobjects The objects are written to this, largest first.
+   * @param imaxCount The most objects to write.
+   * @return The number of objects written, or `PROS_ERR` if the read failed.
+   */
+  using Sampler = std::function<std::int32_t(VisionObject *oobjects, std::size_t imaxCount)>;
+
+  /**
+   * Samples a vision sensor. Call `startThread()` to start sampling from a task, or call `step()`
+   * from your own loop.
+   *
+   * @param isampler The function which reads the sensor.
+   * @param itimeUtil The time utility which supplies the timer of the frames and the rate of the
+   * sampling task.
+   * @param isamplePeriod The time between samples.
+   * @param ilatency The time between when an image is captured and when it can be read.
+   * @param ilogger The logger this instance will log to.
+   */
+  VisionSamplingService(Sampler isampler,
+                        const TimeUtil &itimeUtil,
+                        const QTime &isamplePeriod,
+                        const QTime &ilatency,
+                        std::shared_ptr<Logger> ilogger = Logger::getDefaultLogger());
+
+  VisionSamplingService(const VisionSamplingService &) = delete;
+  VisionSamplingService &operator=(const VisionSamplingService &) = delete;
+
+  /**
+   * Stops the sampling task.
+   */
+  virtual ~VisionSamplingService();
+
+  /**
+   * Reads the sensor once and, if the read worked, publishes the frame. This is called by the
+   * sampling task; call it yourself if you don't start the task.
+   *
+   * @return Whether the read worked.
+   */
+  bool step();
+
+  /**
+   * Can be called from any task.
+   *
+   * @return The latest frame, or an empty frame if no read worked yet.
+   */
+  VisionFrame getFrame() const;
+
+  /**
+   * @return The number of frames which were published. A frame is new if this changed.
+   */
+  std::uint32_t getFrameCount() const;
+
+  /**
+   * @return The number of reads which failed.
+   */
+  std::uint32_t getFailedCount() const;
+
+  /**
+   * Starts the internal thread. This should not be called by normal users.
+   *
+   * @param ipriority The priority of the task.
+   * @param istackDepth The stack depth of the task in words.
+   */
+  void startThread(std::uint32_t ipriority = TASK_PRIORITY_DEFAULT,
+                   std::uint16_t istackDepth = TASK_STACK_DEPTH_DEFAULT);
+
+  /**
+   * Returns the underlying thread handle.
+   *
+   * @return The underlying thread handle.
+   */
+  CrossplatformThread *getThread() const;
+
+  protected:
+  std::shared_ptr<Logger> logger;
+  Sampler sampler;
+  TimeUtil timeUtil;
+  std::unique_ptr<AbstractTimer> timer;
+  QTime samplePeriod;
+  QTime latency;
+
+  // One writer and many readers. The newest frame is in `cells[frameCount % 2]`, so a read only
+  // has to retry if the sampling task finishes a frame and starts another while it reads. Each
+  // object is packed into two atomic words so reading a cell is not a data race.
+  struct Cell {
+    std::atomic_uint32_t sequence{0};
+    std::atomic_uint32_t time{0};
+    std::atomic_uint8_t count{0};
+    std::array<std::atomic_uint64_t, VisionFrame::maxObjects * 2> words{};
+  };
+
+  Cell cells[2]{};
+  std::atomic_uint32_t frameCount{0};
+  std::atomic_uint32_t failedCount{0};
+
+  std::atomic_bool dtorCalled{false};
+  CrossplatformThread *task{nullptr};
+
+  void publish(const VisionFrame &iframe);
+
+  static void trampoline(void *context);
+  void loop();
+};
+} // namespace okapi
@@ -0,0 +1,106 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#pragma once
+
+#include "okapi/api/filter/filter.hpp"
+#include "okapi/api/units/QTime.hpp"
+
+namespace okapi {
+/**
+ * A tracking filter which estimates position and velocity together from position readings. Each
+ * reading, the filter predicts the position from its estimates, then corrects the position by
+ * `alpha` and the velocity by `beta` times the prediction error. With a nonzero `gamma` it also
+ * tracks acceleration (an alpha-beta-gamma filter), so it follows a steadily accelerating
+ * mechanism without lag.
+ *
+ * This is a steady state Kalman filter for a constant velocity (or acceleration) model, in a few
+ * multiplies and three numbers of state. Larger gains track faster, smaller gains reject more
+ * noise. The first reading initializes the position, so there is no startup transient.
+ */
+class AlphaBetaFilter : public Filter {
+  public:
+  /**
+   * An alpha-beta filter, or an alpha-beta-gamma filter if `igamma` is not zero. Throws a
+   * `std::invalid_argument` if the gains are outside the filter's stable region (`alpha` in
+   * `(0, 1]`, `beta` and `gamma` not negative, and `4 - 2 alpha - beta` positive) or the time
+   * between readings is not positive.
+   *
+   * @param ialpha The position gain.
+   * @param ibeta The velocity gain.
+   * @param idt The time between readings when they are given to `filter(double)`.
+   * @param igamma The acceleration gain.
+   */
+  AlphaBetaFilter(double ialpha, double ibeta, QTime idt, double igamma = 0);
+
+  /**
+   * Filters a position reading taken the nominal time after the last one.
+   *
+   * @param ireading A new position measurement.
+   * @return The position estimate.
+   */
+  double filter(double ireading) override;
+
+  /**
+   * Filters a position reading taken a given time after the last one.
+   *
+   * @param ireading A new position measurement.
+   * @param idt The time since the last reading.
+   * @return The position estimate.
+   */
+  virtual double filter(double ireading, QTime idt);
+
+  /**
+   * @return The position estimate.
+   */
+  double getOutput() const override;
+
+  /**
+   * Filters readings in order, as if by calling `filter()` on each of them.
+   *
+   * @param iinput The readings, oldest first.
+   * @param ooutput The filtered results, one per reading. May be the same buffer as the input.
+   * @param icount The number of readings.
+   */
+  void filterBatch(const double *iinput, double *ooutput, std::size_t icount) override;
+
+  /**
+   * @return The velocity estimate in position units per second.
+   */
+  double getVelocity() const;
+
+  /**
+   * @return The acceleration estimate in position units per second squared. Always zero unless
+   * gamma is not zero.
+   */
+  double getAcceleration() const;
+
+  /**
+   * Sets the filter gains. Throws like the constructor.
+   *
+   * @param ialpha The position gain.
+   * @param ibeta The velocity gain.
+   * @param igamma The acceleration gain.
+   */
+  virtual void setGains(double ialpha, double ibeta, double igamma = 0);
+
+  /**
+   * Clears the estimates. The next reading initializes the position again.
+   */
+  void reset();
+
+  protected:
+  double alpha;
+  double beta;
+  double gamma;
+  double nominalDt;
+  double position{0};
+  double velocity{0};
+  double acceleration{0};
+  bool initialized{false};
+
+  static void checkGains(double ialpha, double ibeta, double igamma);
+};
+} // namespace okapi
@@ -0,0 +1,57 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#pragma once
+
+#include "okapi/api/filter/alphaBetaFilter.hpp"
+#include "okapi/api/filter/velMath.hpp"
+
+namespace okapi {
+/**
+ * A VelMath which tracks the position with an AlphaBetaFilter and reads the velocity, and the
+ * acceleration if gamma is not zero, from the filter's estimates. This replaces differencing the
+ * position and smoothing the result with an EmaFilter, with less lag for the same noise rejection.
+ * The filter is given the measured time between samples.
+ */
+class AlphaBetaVelMath : public VelMath {
+  public:
+  /**
+   * Velocity math helper which tracks the position with an alpha-beta filter. Throws a
+   * `std::invalid_argument` exception if `iticksPerRev` is zero or the gains are invalid, see
+   * AlphaBetaFilter.
+   *
+   * @param iticksPerRev The number of ticks per revolution (or whatever units you are using).
+   * @param ialpha The position gain.
+   * @param ibeta The velocity gain.
+   * @param igamma The acceleration gain. Zero estimates the acceleration from the velocity instead.
+   * @param isampleTime The minimum time between position samples.
+   * @param iloopDtTimer The timer used to measure the time between samples.
+   * @param ilogger The logger this instance will log to.
+   */
+  AlphaBetaVelMath(double iticksPerRev,
+                   double ialpha,
+                   double ibeta,
+                   double igamma,
+                   QTime isampleTime,
+                   std::unique_ptr<AbstractTimer> iloopDtTimer,
+                   std::shared_ptr<Logger> ilogger = Logger::getDefaultLogger());
+
+  /**
+   * @return The filter which tracks the position, in ticks.
+   */
+  AlphaBetaFilter &getFilter();
+
+  protected:
+  AlphaBetaFilter tracker;
+
+  /**
+   * Runs the filter on a new position and reads its estimates.
+   *
+   * @param inewPos The new position measurement.
+   * @param idt The time since the last position measurement.
+   */
+  void addSample(double inewPos, QTime idt) override;
+};
+} // namespace okapi
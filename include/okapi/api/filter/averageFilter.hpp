@@ -7,6 +7,7 @@
 
 #include "okapi/api/filter/filter.hpp"
 #include <array>
+#include <cmath>
 #include <cstddef>
 
 namespace okapi {
@@ -29,15 +30,23 @@ template <std::size_t n> class AverageFilter : public Filter {
    * @return filtered result
    */
   double filter(const double ireading) override {
+    // Swap the oldest sample for the new one in a running sum, so each call is constant time no
+    // matter how many taps there are. The sum is compensated so it does not drift.
+    add(ireading);
+    add(-data[index]);
+
     data[index++] = ireading;
     if (index >= n) {
       index = 0;
     }
 
-    output = 0.0;
-    for (size_t i = 0; i < n; i++)
-      output += data[i];
-    output /= (double)n;
+    if (!std::isfinite(sum)) {
+      // A non-finite sample would poison the running sum forever, so recompute it once the window
+      // lets go of that sample
+      resum();
+    }
+
+    output = (sum + compensation) / (double)n;
 
     return output;
   }
@@ -51,9 +60,51 @@ template <std::size_t n> class AverageFilter : public Filter {
     return output;
   }
 
+  /**
+   * Filters readings in order, as if by calling `filter()` on each of them.
+   *
+   * @param iinput The readings, oldest first.
+   * @param ooutput The filtered results, one per reading. May be the same buffer as the input.
+   * @param icount The number of readings.
+   */
+  void filterBatch(const double *iinput, double *ooutput, std::size_t icount) override {
+    for (std::size_t i = 0; i < icount; i++) {
+      ooutput[i] = AverageFilter::filter(iinput[i]);
+    }
+  }
+
   protected:
   std::array<double, n> data{0};
   std::size_t index = 0;
+  double sum = 0;
+  double compensation = 0;
   double output = 0;
+
+  /**
+   * Adds to the sum with Neumaier's compensated summation, which keeps the rounding error of each
+   * addition in the compensation term.
+   *
+   * @param ivalue The value to add.
+   */
+  void add(const double ivalue) {
+    const double newSum = sum + ivalue;
+    if (std::abs(sum) >= std::abs(ivalue)) {
+      compensation += (sum - newSum) + ivalue;
+    } else {
+      compensation += (ivalue - newSum) + sum;
+    }
+    sum = newSum;
+  }
+
+  /**
+   * Recomputes the sum from the samples.
+   */
+  void resum() {
+    sum = 0;
+    compensation = 0;
+    for (const double sample : data) {
+      sum += sample;
+    }
+  }
 };
 } // namespace okapi
@@ -0,0 +1,179 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#pragma once
+
+#include "okapi/api/filter/filter.hpp"
+#include "okapi/api/units/QFrequency.hpp"
+#include "okapi/api/util/resourceUsage.hpp"
+#include <cstddef>
+#include <vector>
+
+namespace okapi {
+/**
+ * The coefficients of one second order IIR section, normalized so the leading feedback
+ * coefficient is `1`:
+ *
+ * `y[k] = b0 x[k] + b1 x[k-1] + b2 x[k-2] - a1 y[k-1] - a2 y[k-2]`
+ *
+ * A first order section has `b2` and `a2` set to zero.
+ */
+struct BiquadCoefficients {
+  double b0{1};
+  double b1{0};
+  double b2{0};
+  double a1{0};
+  double a2{0};
+};
+
+/**
+ * A cascade of second order IIR sections ("biquads"). The factories design the common filters
+ * from a cutoff and sample rate with the bilinear transform, so all the trigonometry happens at
+ * construction and each reading costs five multiplies per section.
+ *
+ * A second order low-pass smooths a velocity with less lag than an AverageFilter wide enough to
+ * remove the same noise. For a VelMath with a 10 ms sample time:
+ *
+ * ```cpp
+ * auto filter = std::make_unique<BiquadFilter>(BiquadFilter::lowPass(10_Hz, 100_Hz));
+ * ```
+ */
+class BiquadFilter : public Filter {
+  public:
+  /**
+   * A filter which runs a reading through each section in order. Throws a `std::invalid_argument`
+   * if there are no sections.
+   *
+   * @param isections The coefficients of the sections, in order.
+   */
+  explicit BiquadFilter(std::vector<BiquadCoefficients> isections);
+
+  /**
+   * A second order low-pass filter. A Q of `1 / sqrt(2)` is a Butterworth response, which has no
+   * overshoot in its passband. Throws a `std::invalid_argument` if the cutoff is not between zero
+   * and half the sample rate or the Q is not positive.
+   *
+   * @param icutoff The -3 dB frequency.
+   * @param isampleRate The rate the filter is given readings at.
+   * @param iq The quality factor.
+   * @return The filter.
+   */
+  static BiquadFilter
+  lowPass(QFrequency icutoff, QFrequency isampleRate, double iq = butterworthQ);
+
+  /**
+   * A second order high-pass filter. Throws like `lowPass()`.
+   *
+   * @param icutoff The -3 dB frequency.
+   * @param isampleRate The rate the filter is given readings at.
+   * @param iq The quality factor.
+   * @return The filter.
+   */
+  static BiquadFilter
+  highPass(QFrequency icutoff, QFrequency isampleRate, double iq = butterworthQ);
+
+  /**
+   * A notch filter which removes one frequency, like the vibration of a mechanism, and passes the
+   * rest. Throws like `lowPass()`.
+   *
+   * @param icenter The frequency to remove.
+   * @param isampleRate The rate the filter is given readings at.
+   * @param iq The quality factor. Higher values make the notch narrower.
+   * @return The filter.
+   */
+  static BiquadFilter notch(QFrequency icenter, QFrequency isampleRate, double iq);
+
+  /**
+   * A Butterworth low-pass filter of any order, made of `iorder / 2` second order sections and a
+   * first order section if the order is odd. Each order makes the rolloff 20 dB per decade
+   * steeper, at the cost of more lag. Throws a `std::invalid_argument` if the order is zero or the
+   * cutoff is not between zero and half the sample rate.
+   *
+   * @param iorder The order of the filter.
+   * @param icutoff The -3 dB frequency.
+   * @param isampleRate The rate the filter is given readings at.
+   * @return The filter.
+   */
+  static BiquadFilter
+  butterworthLowPass(std::size_t iorder, QFrequency icutoff, QFrequency isampleRate);
+
+  /**
+   * A Butterworth high-pass filter of any order. Throws like `butterworthLowPass()`.
+   *
+   * @param iorder The order of the filter.
+   * @param icutoff The -3 dB frequency.
+   * @param isampleRate The rate the filter is given readings at.
+   * @return The filter.
+   */
+  static BiquadFilter
+  butterworthHighPass(std::size_t iorder, QFrequency icutoff, QFrequency isampleRate);
+
+  /**
+   * Filters a value, like a sensor reading.
+   *
+   * @param ireading A new measurement.
+   * @return The filtered result.
+   */
+  double filter(double ireading) override;
+
+  /**
+   * @return The previous output from filter.
+   */
+  double getOutput() const override;
+
+  /**
+   * Filters readings in order, as if by calling `filter()` on each of them.
+   *
+   * @param iinput The readings, oldest first.
+   * @param ooutput The filtered results, one per reading. May be the same buffer as the input.
+   * @param icount The number of readings.
+   */
+  void filterBatch(const double *iinput, double *ooutput, std::size_t icount) override;
+
+  /**
+   * Clears the state of every section, as if the filter had only been given zeros.
+   */
+  void reset();
+
+  /**
+   * @return The coefficients of the sections, in order.
+   */
+  std::vector<BiquadCoefficients> getSections() const;
+
+  /**
+   * The Q of a second order Butterworth filter, `1 / sqrt(2)`.
+   */
+  static constexpr double butterworthQ = 0.70710678118654752440;
+
+  protected:
+  struct Section {
+    BiquadCoefficients coefficients;
+    double z1{0};
+    double z2{0};
+  };
+
+  std::vector<Section> sections;
+  HeapAttribution heap{HeapSubsystem::filters};
+  double output{0};
+
+  static BiquadCoefficients lowPassSection(double iw0, double iq);
+  static BiquadCoefficients highPassSection(double iw0, double iq);
+  static BiquadCoefficients firstOrderLowPassSection(double iw0);
+  static BiquadCoefficients firstOrderHighPassSection(double iw0);
+
+  /**
+   * @return The Q of each second order section of a Butterworth filter of the order.
+   */
+  static std::vector<double> butterworthQs(std::size_t iorder);
+
+  /**
+   * Checks that a frequency can be filtered at the sample rate and converts it to radians per
+   * sample.
+   *
+   * @return The frequency in radians per sample.
+   */
+  static double normalizedFrequency(QFrequency ifrequency, QFrequency isampleRate, double iq);
+};
+} // namespace okapi
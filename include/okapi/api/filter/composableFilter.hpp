@@ -36,6 +36,16 @@ class ComposableFilter : public Filter {
    */
   double getOutput() const override;
 
+  /**
+   * Filters readings in order, as if by calling `filter()` on each of them. Each filter in
+   * the sequence filters the whole buffer before the next one does.
+   *
+   * @param iinput The readings, oldest first.
+   * @param ooutput The filtered results, one per reading. May be the same buffer as the input.
+   * @param icount The number of readings.
+   */
+  void filterBatch(const double *iinput, double *ooutput, std::size_t icount) override;
+
   /**
    * Adds a filter to the end of the sequence.
    *
@@ -0,0 +1,116 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#pragma once
+
+#include <array>
+#include <cstddef>
+
+namespace okapi {
+/**
+ * Double exponential moving average filters for many channels which share one pair of gains. Each
+ * channel gives the same result as a DemaFilter with those gains. The smoothed values and trends
+ * of all channels are kept in two aligned arrays and updated in one loop the compiler can
+ * vectorize.
+ *
+ * @tparam channels The number of channels.
+ * @tparam T The number type of the gains and channels. `float` halves the memory of each channel
+ * and fits twice as many channels in each vector instruction, at single precision.
+ */
+template <std::size_t channels, typename T = double> class DemaBank {
+  public:
+  /**
+   * Double exponential moving average filters for many channels.
+   *
+   * @param ialpha alpha gain
+   * @param ibeta beta gain
+   */
+  DemaBank(const T ialpha, const T ibeta) : alpha(ialpha), beta(ibeta) {
+  }
+
+  /**
+   * Filters one reading of every channel.
+   *
+   * @param ireadings The new readings, one per channel.
+   * @return The filtered results, one per channel.
+   */
+  std::array<T, channels> filter(const std::array<T, channels> &ireadings) {
+    std::array<T, channels> out;
+    filter(ireadings.data(), out.data());
+    return out;
+  }
+
+  /**
+   * Filters one reading of every channel.
+   *
+   * @param iinput The new readings, one per channel.
+   * @param ooutput The filtered results, one per channel. May be the same buffer as the input.
+   */
+  void filter(const T *iinput, T *ooutput) {
+    const T a = alpha;
+    const T b = beta;
+    for (std::size_t i = 0; i < channels; i++) {
+      const T lastS = outputS[i];
+      const T lastB = outputB[i];
+      outputS[i] = (a * iinput[i]) + ((T(1) - a) * (lastS + lastB));
+      outputB[i] = (b * (outputS[i] - lastS)) + ((T(1) - b) * lastB);
+    }
+
+    for (std::size_t i = 0; i < channels; i++) {
+      ooutput[i] = outputS[i] + outputB[i];
+    }
+  }
+
+  /**
+   * @return The previous output of every channel.
+   */
+  std::array<T, channels> getOutput() const {
+    std::array<T, channels> out;
+    for (std::size_t i = 0; i < channels; i++) {
+      out[i] = outputS[i] + outputB[i];
+    }
+    return out;
+  }
+
+  /**
+   * @param ichannel The channel.
+   * @return The previous output of the channel.
+   */
+  T getOutput(const std::size_t ichannel) const {
+    return outputS.at(ichannel) + outputB.at(ichannel);
+  }
+
+  /**
+   * Set filter gains.
+   *
+   * @param ialpha alpha gain
+   * @param ibeta beta gain
+   */
+  void setGains(const T ialpha, const T ibeta) {
+    alpha = ialpha;
+    beta = ibeta;
+  }
+
+  /**
+   * Clears the output of every channel.
+   */
+  void reset() {
+    outputS.fill(0);
+    outputB.fill(0);
+  }
+
+  /**
+   * @return The number of channels.
+   */
+  static constexpr std::size_t size() {
+    return channels;
+  }
+
+  protected:
+  T alpha, beta;
+  alignas(64) std::array<T, channels> outputS{};
+  alignas(64) std::array<T, channels> outputB{};
+};
+} // namespace okapi
@@ -5,6 +5,8 @@
  */
 #pragma once
 
+#include <cstddef>
+
 namespace okapi {
 class Filter {
   public:
@@ -18,6 +20,17 @@ class Filter {
    */
   virtual double filter(double ireading) = 0;
 
+  /**
+   * Filters readings in order, as if by calling `filter()` on each of them. The filters override
+   * this to filter the whole buffer behind one virtual call, instead of one per reading, so a
+   * subclass which overrides `filter()` must override this too.
+   *
+   * @param iinput The readings, oldest first.
+   * @param ooutput The filtered results, one per reading. May be the same buffer as the input.
+   * @param icount The number of readings.
+   */
+  virtual void filterBatch(const double *iinput, double *ooutput, std::size_t icount);
+
   /**
    * Returns the previous output from filter.
    *
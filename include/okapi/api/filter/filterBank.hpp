@@ -0,0 +1,96 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <utility>
+
+namespace okapi {
+/**
+ * A bank of filters of one type, one per channel, which filters a reading of every channel in one
+ * pass. The filters are held by value and called without virtual dispatch, so filtering all of a
+ * chassis' encoders costs one inlined loop instead of a virtual call per encoder.
+ *
+ * @tparam FilterType The type of the filters. Calls to it are bound to this exact type, so it
+ * should be the type whose `filter()` is wanted, not a base class.
+ * @tparam channels The number of channels.
+ */
+template <typename FilterType, std::size_t channels> class FilterBank {
+  public:
+  /**
+   * A bank of default constructed filters.
+   */
+  FilterBank() = default;
+
+  /**
+   * A bank of copies of a filter.
+   *
+   * @param iprototype The filter every channel starts as a copy of.
+   */
+  explicit FilterBank(const FilterType &iprototype)
+    : FilterBank(iprototype, std::make_index_sequence<channels>()) {
+  }
+
+  /**
+   * Filters one reading of every channel.
+   *
+   * @param ireadings The new readings, one per channel.
+   * @return The filtered results, one per channel.
+   */
+  std::array<double, channels> filter(const std::array<double, channels> &ireadings) {
+    std::array<double, channels> out;
+    filter(ireadings.data(), out.data());
+    return out;
+  }
+
+  /**
+   * Filters one reading of every channel.
+   *
+   * @param iinput The new readings, one per channel.
+   * @param ooutput The filtered results, one per channel. May be the same buffer as the input.
+   */
+  void filter(const double *iinput, double *ooutput) {
+    for (std::size_t i = 0; i < channels; i++) {
+      ooutput[i] = filters[i].FilterType::filter(iinput[i]);
+    }
+  }
+
+  /**
+   * @return The previous output of every channel.
+   */
+  std::array<double, channels> getOutput() const {
+    std::array<double, channels> out;
+    for (std::size_t i = 0; i < channels; i++) {
+      out[i] = filters[i].FilterType::getOutput();
+    }
+    return out;
+  }
+
+  /**
+   * @param ichannel The channel.
+   * @return The filter of the channel.
+   */
+  FilterType &get(const std::size_t ichannel) {
+    return filters.at(ichannel);
+  }
+
+  /**
+   * @return The number of channels.
+   */
+  static constexpr std::size_t size() {
+    return channels;
+  }
+
+  protected:
+  std::array<FilterType, channels> filters;
+
+  template <std::size_t... Is>
+  FilterBank(const FilterType &iprototype, std::index_sequence<Is...>)
+    : filters{{(static_cast<void>(Is), iprototype)...}} {
+  }
+};
+} // namespace okapi
@@ -0,0 +1,96 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#pragma once
+
+#include "okapi/api/filter/filter.hpp"
+#include <cstddef>
+#include <tuple>
+#include <utility>
+
+namespace okapi {
+/**
+ * A filter made of other filters, like ComposableFilter, but with the sequence fixed at compile
+ * time. The stages are stored by value next to each other and called without virtual dispatch, so
+ * the whole chain can be inlined into one function. The input signal is passed through each stage
+ * in order and the output of this filter is the output of the last stage.
+ *
+ * ```cpp
+ * FilterChain<MedianFilter<5>, EmaFilter> filter(MedianFilter<5>(), EmaFilter(0.2));
+ * ```
+ *
+ * @tparam Stages The types of the filters, in order. Calls to them are bound to these exact types.
+ */
+template <typename... Stages> class FilterChain : public Filter {
+  static_assert(sizeof...(Stages) > 0, "A FilterChain needs at least one stage.");
+
+  public:
+  /**
+   * A chain of default constructed stages.
+   */
+  FilterChain() = default;
+
+  /**
+   * A chain of the given stages.
+   *
+   * @param istages The filters to use in sequence.
+   */
+  explicit FilterChain(Stages... istages) : stages(std::move(istages)...) {
+  }
+
+  /**
+   * Filters a value through every stage.
+   *
+   * @param ireading A new measurement.
+   * @return The filtered result.
+   */
+  double filter(const double ireading) override {
+    output = std::apply(
+      [ireading](Stages &... istages) {
+        double value = ireading;
+        ((value = filterStage(istages, value)), ...);
+        return value;
+      },
+      stages);
+    return output;
+  }
+
+  /**
+   * @return The previous output from filter.
+   */
+  double getOutput() const override {
+    return output;
+  }
+
+  /**
+   * Filters readings in order, as if by calling `filter()` on each of them.
+   *
+   * @param iinput The readings, oldest first.
+   * @param ooutput The filtered results, one per reading. May be the same buffer as the input.
+   * @param icount The number of readings.
+   */
+  void filterBatch(const double *iinput, double *ooutput, std::size_t icount) override {
+    for (std::size_t i = 0; i < icount; i++) {
+      ooutput[i] = FilterChain::filter(iinput[i]);
+    }
+  }
+
+  /**
+   * @tparam index The index of the stage.
+   * @return The stage.
+   */
+  template <std::size_t index> auto &getStage() {
+    return std::get<index>(stages);
+  }
+
+  protected:
+  std::tuple<Stages...> stages;
+  double output = 0;
+
+  template <typename Stage> static double filterStage(Stage &istage, const double ireading) {
+    return istage.Stage::filter(ireading);
+  }
+};
+} // namespace okapi
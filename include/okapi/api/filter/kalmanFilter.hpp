@@ -0,0 +1,147 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#pragma once
+
+#include "okapi/api/util/matrix.hpp"
+#include <cstddef>
+
+namespace okapi {
+/**
+ * A Kalman filter with a state of `stateDim` values. Unlike EKFFilter, which filters one value,
+ * this tracks several values which depend on each other, like the position, heading, and velocity
+ * of a robot. All of the matrices are fixed size, so the filter never allocates.
+ *
+ * Each step, call one of the `predict` methods to move the state forward in time, then call one of
+ * the `update` methods for each measurement. A measurement can have any number of values, so
+ * different sensors can be fused by one filter. For a nonlinear model (an extended Kalman filter),
+ * pass the predicted state or the innovation computed from the model itself, and the Jacobian of
+ * the model in place of the linear model.
+ */
+template <std::size_t stateDim> class KalmanFilter {
+  public:
+  using State = Matrix<stateDim, 1>;
+  using Covariance = Matrix<stateDim, stateDim>;
+
+  /**
+   * A Kalman filter with a state of `stateDim` values.
+   *
+   * @param iinitialState The initial estimate of the state.
+   * @param iinitialCovariance The covariance of the error in the initial estimate.
+   */
+  explicit KalmanFilter(const State &iinitialState = State(),
+                        const Covariance &iinitialCovariance = Covariance::identity())
+    : x(iinitialState), P(iinitialCovariance) {
+  }
+
+  /**
+   * Moves the state forward with a linear model, `x = F * x`.
+   *
+   * @param iF The state transition matrix.
+   * @param iQ The covariance of the process noise.
+   */
+  void predict(const Covariance &iF, const Covariance &iQ) {
+    predict(iF * x, iF, iQ);
+  }
+
+  /**
+   * Moves the state forward with a nonlinear model.
+   *
+   * @param ipredicted The state predicted by the model.
+   * @param iF The Jacobian of the model with respect to the state.
+   * @param iQ The covariance of the process noise.
+   */
+  void predict(const State &ipredicted, const Covariance &iF, const Covariance &iQ) {
+    x = ipredicted;
+    P = iF * P * iF.transpose() + iQ;
+  }
+
+  /**
+   * Corrects the state with a measurement of a linear model, `z = H * x`.
+   *
+   * @param iz The measurement.
+   * @param iH The measurement matrix.
+   * @param iR The covariance of the measurement noise.
+   * @return False if the measurement was not used because its covariance can't be inverted.
+   */
+  template <std::size_t measDim>
+  bool update(const Matrix<measDim, 1> &iz,
+              const Matrix<measDim, stateDim> &iH,
+              const Matrix<measDim, measDim> &iR) {
+    return updateInnovation(iz - iH * x, iH, iR);
+  }
+
+  /**
+   * Corrects the state with the innovation of a measurement, which is the measurement minus the
+   * measurement the model expects for the current state. Use this for a nonlinear measurement.
+   *
+   * @param iinnovation The measurement minus the expected measurement.
+   * @param iH The Jacobian of the expected measurement with respect to the state.
+   * @param iR The covariance of the measurement noise.
+   * @return False if the measurement was not used because its covariance can't be inverted.
+   */
+  template <std::size_t measDim>
+  bool updateInnovation(const Matrix<measDim, 1> &iinnovation,
+                        const Matrix<measDim, stateDim> &iH,
+                        const Matrix<measDim, measDim> &iR) {
+    Matrix<measDim, measDim> Sinv;
+    if (!getInnovationCovariance(iH, iR).inverse(Sinv)) {
+      return false;
+    }
+
+    const Matrix<stateDim, measDim> K = P * iH.transpose() * Sinv;
+    x += K * iinnovation;
+
+    // The Joseph form keeps P symmetric and positive definite despite rounding
+    const Covariance IKH = Covariance::identity() - K * iH;
+    P = IKH * P * IKH.transpose() + K * iR * K.transpose();
+    return true;
+  }
+
+  /**
+   * Returns the covariance of the innovation of a measurement. The squared innovation divided by
+   * this covariance is how many standard deviations a measurement is from what the filter expects,
+   * which can be used to reject outliers.
+   *
+   * @param iH The measurement matrix or the Jacobian of the expected measurement.
+   * @param iR The covariance of the measurement noise.
+   * @return The covariance of the innovation.
+   */
+  template <std::size_t measDim>
+  Matrix<measDim, measDim> getInnovationCovariance(const Matrix<measDim, stateDim> &iH,
+                                                   const Matrix<measDim, measDim> &iR) const {
+    return iH * P * iH.transpose() + iR;
+  }
+
+  /**
+   * @return The estimate of the state.
+   */
+  const State &getState() const {
+    return x;
+  }
+
+  /**
+   * @return The covariance of the error in the estimate of the state.
+   */
+  const Covariance &getCovariance() const {
+    return P;
+  }
+
+  /**
+   * Replaces the estimate of the state.
+   *
+   * @param istate The new estimate.
+   * @param icovariance The covariance of the error in the new estimate.
+   */
+  void setState(const State &istate, const Covariance &icovariance) {
+    x = istate;
+    P = icovariance;
+  }
+
+  protected:
+  State x;
+  Covariance P;
+};
+} // namespace okapi
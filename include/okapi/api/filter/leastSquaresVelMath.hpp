@@ -0,0 +1,75 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#pragma once
+
+#include "okapi/api/filter/velMath.hpp"
+#include "okapi/api/util/resourceUsage.hpp"
+#include <cstddef>
+#include <vector>
+
+namespace okapi {
+/**
+ * A VelMath which fits a quadratic to the last few timestamped positions by least squares and
+ * reads the velocity and acceleration from the fit at the newest position. With evenly spaced
+ * samples this is a Savitzky-Golay differentiator evaluated at the end of the window. Compared to
+ * differencing two positions and smoothing the result, the fit rejects noise with less lag, and
+ * the acceleration comes from the same fit instead of a difference of velocities.
+ *
+ * The fit uses the measured time of each sample, so late samples do not bias it. Pass the device
+ * timestamps to `step()` to fit against when the positions were measured instead of when they
+ * were read. Each new sample costs a pass over the window.
+ */
+class LeastSquaresVelMath : public VelMath {
+  public:
+  /**
+   * Velocity math helper which fits the last positions. Throws a `std::invalid_argument` exception
+   * if `iticksPerRev` is zero or the window is smaller than three samples.
+   *
+   * @param iticksPerRev The number of ticks per revolution (or whatever units you are using).
+   * @param iwindowSize The number of positions to fit. Larger windows reject more noise and lag
+   * more.
+   * @param isampleTime The minimum time between position samples.
+   * @param iloopDtTimer The timer used to measure the time between samples.
+   * @param ilogger The logger this instance will log to.
+   */
+  LeastSquaresVelMath(double iticksPerRev,
+                      std::size_t iwindowSize,
+                      QTime isampleTime,
+                      std::unique_ptr<AbstractTimer> iloopDtTimer,
+                      std::shared_ptr<Logger> ilogger = Logger::getDefaultLogger());
+
+  /**
+   * Clears the window. The next samples build it up again.
+   */
+  void reset();
+
+  /**
+   * @return The number of positions fit.
+   */
+  std::size_t getWindowSize() const;
+
+  protected:
+  std::vector<double> times;
+  std::vector<double> positions;
+  HeapAttribution heap;
+  std::size_t newest{0};
+  std::size_t count{0};
+  double elapsed{0};
+
+  /**
+   * Adds a position to the window and fits the window again.
+   *
+   * @param inewPos The new position measurement.
+   * @param idt The time since the last position measurement.
+   */
+  void addSample(double inewPos, QTime idt) override;
+
+  /**
+   * Fits the window and sets the velocity and acceleration from the fit.
+   */
+  void fit();
+};
+} // namespace okapi
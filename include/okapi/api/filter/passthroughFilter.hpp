@@ -30,6 +30,15 @@ class PassthroughFilter : public Filter {
    */
   double getOutput() const override;
 
+  /**
+   * Filters readings in order, as if by calling `filter()` on each of them.
+   *
+   * @param iinput The readings, oldest first.
+   * @param ooutput The filtered results, one per reading. May be the same buffer as the input.
+   * @param icount The number of readings.
+   */
+  void filterBatch(const double *iinput, double *ooutput, std::size_t icount) override;
+
   protected:
   double lastOutput = 0;
 };
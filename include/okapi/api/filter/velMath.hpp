@@ -41,6 +41,22 @@ class VelMath {
    */
   virtual QAngularSpeed step(double inewPos);
 
+  /**
+   * Calculates the current velocity and acceleration from a position and the time the device
+   * measured it, like the timestamp from `AbstractMotor::getRawPosition()` or
+   * `ContinuousRotarySensor::getTimestamped()`. The time between samples comes from the
+   * timestamps instead of the loop timer, so scheduling jitter does not show up as velocity noise.
+   * The first call only records the sample. A sample measured less than the sample time after the
+   * last one is skipped, so a device which has not updated since the last call is not counted as
+   * standing still. Use either this or the untimed `step()` on one instance, not both.
+   *
+   * @param inewPos The new position measurement.
+   * @param itimestamp The time the position was measured. Zero, which sensors report when they
+   * don't timestamp their readings, falls back to the loop timer.
+   * @return The new velocity estimate.
+   */
+  virtual QAngularSpeed step(double inewPos, QTime itimestamp);
+
   /**
    * Sets ticks per revolution (or whatever units you are using). Throws a `std::invalid_argument`
    * exception if iticksPerRev is zero.
@@ -66,9 +82,21 @@ class VelMath {
   QAngularAcceleration accel{0.0};
   double lastPos{0};
   double ticksPerRev;
+  double rpmPerTicksPerSecond; // 60 / ticksPerRev, so a sample needs no divide by it
 
   QTime sampleTime;
   std::unique_ptr<AbstractTimer> loopDtTimer;
   std::unique_ptr<Filter> filter;
+  QTime lastTimestamp{0_ms};
+  bool hasTimestamp{false};
+
+  /**
+   * Updates the velocity and acceleration from a new position. Called by both `step()` overloads
+   * once the sample time has passed.
+   *
+   * @param inewPos The new position measurement.
+   * @param idt The time since the last position measurement.
+   */
+  virtual void addSample(double inewPos, QTime idt);
 };
 } // namespace okapi
@@ -0,0 +1,102 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#pragma once
+
+#include "okapi/api/odometry/point.hpp"
+#include "okapi/api/units/QAngle.hpp"
+#include "okapi/api/util/logging.hpp"
+#include <memory>
+#include <vector>
+
+namespace okapi {
+/**
+ * A straight wall, from one end to the other, in `StateMode::FRAME_TRANSFORMATION`.
+ */
+struct FieldWall {
+  Point start;
+  Point end;
+};
+
+/**
+ * Where a ray hit a wall.
+ */
+struct RaycastHit {
+  /**
+   * The distance from the start of the ray to the wall.
+   */
+  QLength distance{0_m};
+
+  /**
+   * The unit normal of the wall, pointing back toward the start of the ray.
+   */
+  double normalX{0};
+  double normalY{0};
+
+  /**
+   * The angle between the ray and the normal of the wall. Zero when the ray hits the wall straight
+   * on.
+   */
+  QAngle incidence{0_deg};
+};
+
+/**
+ * The walls of a field, used to work out what a distance sensor should read from a pose.
+ */
+class FieldMap {
+  public:
+  /**
+   * A map with the given walls. Throws a std::invalid_argument if a wall has no length.
+   *
+   * @param iwalls The walls.
+   * @param ilogger The logger this instance will log to.
+   */
+  explicit FieldMap(const std::vector<FieldWall> &iwalls = {},
+                    const std::shared_ptr<Logger> &ilogger = Logger::getDefaultLogger());
+
+  /**
+   * A rectangular field with walls of constant `x` and `y`, in `StateMode::FRAME_TRANSFORMATION`.
+   * Throws a std::invalid_argument if a minimum is not below its maximum.
+   *
+   * @param iminX The wall the robot faces at a heading of 180 degrees.
+   * @param imaxX The wall the robot faces at a heading of 0 degrees.
+   * @param iminY The wall the robot faces at a heading of -90 degrees.
+   * @param imaxY The wall the robot faces at a heading of 90 degrees.
+   * @param ilogger The logger the map will log to.
+   * @return The map.
+   */
+  static FieldMap rectangle(const QLength &iminX,
+                            const QLength &imaxX,
+                            const QLength &iminY,
+                            const QLength &imaxY,
+                            const std::shared_ptr<Logger> &ilogger = Logger::getDefaultLogger());
+
+  /**
+   * Adds a wall. Throws a std::invalid_argument if the wall has no length.
+   *
+   * @param iwall The wall.
+   */
+  void addWall(const FieldWall &iwall);
+
+  /**
+   * @return The walls.
+   */
+  const std::vector<FieldWall> &getWalls() const;
+
+  /**
+   * Finds the first wall a ray hits.
+   *
+   * @param iorigin The start of the ray.
+   * @param idirection The direction of the ray, like the heading of the robot.
+   * @param ohit Set to where the ray hit the wall, if it hit one.
+   * @return Whether the ray hit a wall.
+   */
+  bool raycast(const Point &iorigin, const QAngle &idirection, RaycastHit &ohit) const;
+
+  protected:
+  std::shared_ptr<Logger> logger;
+  std::vector<FieldWall> walls{};
+};
+} // namespace okapi
@@ -0,0 +1,80 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#pragma once
+
+#include "okapi/api/odometry/threeEncoderOdometry.hpp"
+#include "okapi/api/units/QAngularSpeed.hpp"
+#include "okapi/api/units/QSpeed.hpp"
+#include <atomic>
+
+namespace okapi {
+/**
+ * Odometry for holonomic drives, such as a `ThreeEncoderXDriveModel`, which read a left, right, and
+ * middle tracking wheel. The robot can move forward, strafe, and turn at once, so each step is
+ * integrated as a constant forward, strafing, and turning velocity with the exponential map, which
+ * is exact for that movement; `setIntegration` has no effect.
+ *
+ * `ThreeEncoderOdometry` skips any step in which a sensor moved more than a fixed number of ticks,
+ * which high resolution sensors pass when strafing at speed. This odometry instead skips a step
+ * only if a wheel moved faster than the maximum speed of the robot could have moved it.
+ */
+class HolonomicOdometry : public ThreeEncoderOdometry {
+  public:
+  /**
+   * The fastest a tracking wheel can roll before a step is skipped, by default.
+   */
+  static constexpr QSpeed defaultMaxSpeed = 5_mps; // NOLINT
+
+  /**
+   * Holonomic odometry. Tracks the movement of the robot and estimates its position in coordinates
+   * relative to the start (assumed to be (0, 0, 0)).
+   *
+   * @param itimeUtil The TimeUtil.
+   * @param imodel The chassis model for reading sensors. Its readings are the left, right, and
+   * middle tracking wheels.
+   * @param ichassisScales See ChassisScales docs (the middle wheel scale is the third member).
+   * @param imaxSpeed The fastest a tracking wheel can roll. A step in which one rolled faster is a
+   * glitch of its sensor and is skipped.
+   * @param ilogger The logger this instance will log to.
+   */
+  HolonomicOdometry(const TimeUtil &itimeUtil,
+                    const std::shared_ptr<ReadOnlyChassisModel> &imodel,
+                    const ChassisScales &ichassisScales,
+                    const QSpeed &imaxSpeed = defaultMaxSpeed,
+                    const std::shared_ptr<Logger> &ilogger = Logger::getDefaultLogger());
+
+  /**
+   * @return The velocity of the robot towards its front over the last step.
+   */
+  QSpeed getForwardVelocity() const;
+
+  /**
+   * @return The velocity of the robot towards its right over the last step.
+   */
+  QSpeed getStrafeVelocity() const;
+
+  /**
+   * @return The angular velocity of the robot over the last step, positive clockwise.
+   */
+  QAngularSpeed getAngularVelocity() const;
+
+  protected:
+  double maxSpeed;
+  std::atomic<double> forwardVelocity{0};
+  std::atomic<double> strafeVelocity{0};
+  std::atomic<double> angularVelocity{0};
+
+  /**
+   * Does the math for one odom step and updates the velocities.
+   *
+   * @param itickDiff The tick difference from the previous step to this step.
+   * @param ideltaT The time difference from the previous step to this step.
+   * @return The newly computed OdomState.
+   */
+  OdomState odomMathStep(const std::valarray<std::int32_t> &itickDiff,
+                         const QTime &ideltaT) override;
+};
+} // namespace okapi
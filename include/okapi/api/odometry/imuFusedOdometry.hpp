@@ -0,0 +1,104 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#pragma once
+
+#include "okapi/api/device/rotarysensor/continuousRotarySensor.hpp"
+#include "okapi/api/odometry/odometry.hpp"
+#include "okapi/api/odometry/sharedOdomState.hpp"
+#include "okapi/api/util/logging.hpp"
+#include <memory>
+
+namespace okapi {
+/**
+ * Odometry which corrects the heading of another odometry with an inertial sensor. The encoders
+ * alone work out the heading from the difference between the wheels, so wheel slip and scrub make
+ * the heading drift, and every later movement is tracked in the wrong direction. Each step, the
+ * change in heading measured by the encoders is blended with the heading of the inertial sensor
+ * by a complementary filter, and the distance measured by the encoders is tracked along the
+ * blended heading.
+ */
+class ImuFusedOdometry : public Odometry {
+  public:
+  /**
+   * The weight of the inertial sensor heading by default.
+   */
+  static constexpr double defaultImuWeight = 0.9;
+
+  /**
+   * Odometry which corrects the heading of another odometry with an inertial sensor. If the
+   * inertial sensor reading fails, the step uses the encoder heading alone.
+   *
+   * @param iodometry The odometry which reads the encoders.
+   * @param iimu The inertial sensor. Must read the heading in degrees, increasing clockwise, like
+   * the V5 inertial sensor.
+   * @param iimuWeight How much of the difference between the encoder heading and the inertial
+   * sensor heading is corrected every step, between `0` (only the encoders) and `1` (only the
+   * inertial sensor).
+   * @param ilogger The logger this instance will log to.
+   */
+  ImuFusedOdometry(std::shared_ptr<Odometry> iodometry,
+                   std::shared_ptr<ContinuousRotarySensor> iimu,
+                   double iimuWeight = defaultImuWeight,
+                   const std::shared_ptr<Logger> &ilogger = Logger::getDefaultLogger());
+
+  /**
+   * Sets the drive and turn scales.
+   */
+  void setScales(const ChassisScales &ichassisScales) override;
+
+  /**
+   * Do one odometry step.
+   */
+  void step() override;
+
+  /**
+   * Returns the current state.
+   *
+   * @param imode The mode to return the state in.
+   * @return The current state in the given format.
+   */
+  OdomState getState(const StateMode &imode = StateMode::FRAME_TRANSFORMATION) const override;
+
+  /**
+   * Sets a new state to be the current state. The inertial sensor heading is measured relative to
+   * the new heading from the next step on.
+   *
+   * @param istate The new state in the given format.
+   * @param imode The mode to treat the input state as.
+   */
+  void setState(const OdomState &istate,
+                const StateMode &imode = StateMode::FRAME_TRANSFORMATION) override;
+
+  /**
+   * @return The internal ChassisModel.
+   */
+  std::shared_ptr<ReadOnlyChassisModel> getModel() override;
+
+  /**
+   * @return The internal ChassisScales.
+   */
+  ChassisScales getScales() override;
+
+  /**
+   * @return The odometry which reads the encoders.
+   */
+  std::shared_ptr<Odometry> getEncoderOdometry() const;
+
+  protected:
+  std::shared_ptr<Logger> logger;
+  std::shared_ptr<Odometry> odometry;
+  std::shared_ptr<ContinuousRotarySensor> imu;
+  double imuWeight;
+  // Only used by the stepping task. Other tasks read and set the state through sharedState.
+  OdomState state;
+  SharedOdomState sharedState;
+
+  // The difference between the state heading and the inertial sensor heading, found on the first
+  // good reading after the state is set
+  bool hasImuOffset{false};
+  QAngle imuOffset{0_deg};
+};
+} // namespace okapi
@@ -0,0 +1,276 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#pragma once
+
+#include "okapi/api/control/controllerInput.hpp"
+#include "okapi/api/device/rotarysensor/continuousRotarySensor.hpp"
+#include "okapi/api/filter/kalmanFilter.hpp"
+#include "okapi/api/odometry/fieldMap.hpp"
+#include "okapi/api/odometry/odometry.hpp"
+#include "okapi/api/odometry/sharedOdomState.hpp"
+#include "okapi/api/units/QAngularSpeed.hpp"
+#include "okapi/api/units/QSpeed.hpp"
+#include "okapi/api/util/logging.hpp"
+#include "okapi/api/util/timeUtil.hpp"
+#include <memory>
+#include <vector>
+
+namespace okapi {
+/**
+ * The noise of the KalmanOdometry model and sensors. Process noise is the variance added to the
+ * estimate every second; measurement noise is the variance of one measurement. Raise a process
+ * noise to make the estimate follow the measurements faster, and raise a measurement noise to
+ * trust that sensor less.
+ */
+struct KalmanOdometryNoise {
+  /**
+   * The process noise of the position, in square meters per second.
+   */
+  double position{1e-4};
+
+  /**
+   * The process noise of the heading, in square radians per second.
+   */
+  double heading{1e-4};
+
+  /**
+   * The process noise of the velocity, in square meters per second squared per second.
+   */
+  double velocity{1};
+
+  /**
+   * The process noise of the angular velocity, in square radians per second squared per second.
+   */
+  double angularVelocity{10};
+
+  /**
+   * The variance of the velocity measured by the encoders, in square meters per second squared.
+   */
+  double encoderVelocity{1e-4};
+
+  /**
+   * The variance of the angular velocity measured by the encoders, in square radians per second
+   * squared.
+   */
+  double encoderAngularVelocity{1e-1};
+
+  /**
+   * The variance of the heading measured by the inertial sensor, in square radians. Wheel slip
+   * makes the encoders much less accurate than the inertial sensor in a turn, so this is low.
+   */
+  double imuHeading{1e-6};
+
+  /**
+   * The variance of the distance measured by a distance sensor, in square meters.
+   */
+  double distance{2.5e-4};
+};
+
+/**
+ * Odometry which estimates the pose and velocity of the robot with an extended Kalman filter. The
+ * state is the position, heading, velocity, and angular velocity of the robot. The encoders
+ * measure the velocities, an optional inertial sensor measures the heading, and optional distance
+ * sensors measure the distance to the walls of the field, which corrects the position as well.
+ *
+ * Only the left and right encoders of the chassis model are used.
+ */
+class KalmanOdometry : public Odometry {
+  public:
+  /**
+   * The index of each value in the state of the filter.
+   */
+  static constexpr std::size_t xIndex = 0;
+  static constexpr std::size_t yIndex = 1;
+  static constexpr std::size_t thetaIndex = 2;
+  static constexpr std::size_t velocityIndex = 3;
+  static constexpr std::size_t angularVelocityIndex = 4;
+  static constexpr std::size_t stateDim = 5;
+
+  using PoseFilter = KalmanFilter<stateDim>;
+
+  /**
+   * Distance measurements further than this many standard deviations from the expected distance
+   * are rejected, because the sensor probably saw something other than a wall.
+   */
+  static constexpr double distanceGate = 3;
+
+  /**
+   * Distance sensors are ignored while their beam hits a wall more than this many radians from
+   * straight on, because the reading is unreliable at a shallow angle.
+   */
+  static constexpr double maxDistanceIncidence = 1.0;
+
+  /**
+   * Odometry which estimates the pose and velocity of the robot with an extended Kalman filter.
+   *
+   * @param itimeUtil The TimeUtil.
+   * @param imodel The chassis model for reading the encoders.
+   * @param ichassisScales The chassis dimensions.
+   * @param iimu The inertial sensor, or `nullptr` to not use one. Must read the heading in degrees,
+   * increasing clockwise, like the V5 inertial sensor.
+   * @param inoise The noise of the model and sensors.
+   * @param ilogger The logger this instance will log to.
+   */
+  KalmanOdometry(const TimeUtil &itimeUtil,
+                 const std::shared_ptr<ReadOnlyChassisModel> &imodel,
+                 const ChassisScales &ichassisScales,
+                 std::shared_ptr<ContinuousRotarySensor> iimu = nullptr,
+                 const KalmanOdometryNoise &inoise = KalmanOdometryNoise(),
+                 const std::shared_ptr<Logger> &ilogger = Logger::getDefaultLogger());
+
+  /**
+   * Adds a distance sensor. Its readings are used once the walls are set with `setFieldMap()` or
+   * `setWalls()`.
+   *
+   * @param isensor The sensor. Must read the distance in millimeters, like the DistanceSensor.
+   * @param imount Where the sensor is on the robot: `x` is forward and `y` is to the right of the
+   * center of the robot, and `theta` is the direction of the beam relative to the front.
+   * @param imaxRange Readings further than this, or zero or less, are ignored.
+   */
+  void addDistanceSensor(std::shared_ptr<ControllerInput<double>> isensor,
+                         const OdomState &imount,
+                         const QLength &imaxRange = 2_m);
+
+  /**
+   * Sets the walls the distance sensors measure to, in the frame transformation mode. The field is
+   * assumed to be a rectangle with walls of constant `x` and `y`.
+   *
+   * @param iminX The wall the robot faces at a heading of 180 degrees.
+   * @param imaxX The wall the robot faces at a heading of 0 degrees.
+   * @param iminY The wall the robot faces at a heading of -90 degrees.
+   * @param imaxY The wall the robot faces at a heading of 90 degrees.
+   */
+  void setWalls(const QLength &iminX,
+                const QLength &imaxX,
+                const QLength &iminY,
+                const QLength &imaxY);
+
+  /**
+   * Sets the walls the distance sensors measure to.
+   *
+   * @param imap The walls.
+   */
+  void setFieldMap(const FieldMap &imap);
+
+  /**
+   * Sets the drive and turn scales.
+   */
+  void setScales(const ChassisScales &ichassisScales) override;
+
+  /**
+   * Do one odometry step.
+   */
+  void step() override;
+
+  /**
+   * Returns the current state.
+   *
+   * @param imode The mode to return the state in.
+   * @return The current state in the given format.
+   */
+  OdomState getState(const StateMode &imode = StateMode::FRAME_TRANSFORMATION) const override;
+
+  /**
+   * Sets a new state to be the current state. The velocities are kept. The inertial sensor heading
+   * is measured relative to the new heading from the next step on.
+   *
+   * @param istate The new state in the given format.
+   * @param imode The mode to treat the input state as.
+   */
+  void setState(const OdomState &istate,
+                const StateMode &imode = StateMode::FRAME_TRANSFORMATION) override;
+
+  /**
+   * @return The estimated velocity of the robot, positive forward.
+   */
+  QSpeed getVelocity() const;
+
+  /**
+   * @return The estimated angular velocity of the robot, positive clockwise.
+   */
+  QAngularSpeed getAngularVelocity() const;
+
+  /**
+   * @return The filter, for its estimate and covariance. Only read it from the task which steps
+   * this odometry.
+   */
+  const PoseFilter &getFilter() const;
+
+  /**
+   * @return The internal ChassisModel.
+   */
+  std::shared_ptr<ReadOnlyChassisModel> getModel() override;
+
+  /**
+   * @return The internal ChassisScales.
+   */
+  ChassisScales getScales() override;
+
+  protected:
+  struct DistanceSensorMount {
+    std::shared_ptr<ControllerInput<double>> sensor;
+    double forward;
+    double right;
+    double angle;
+    double maxRange;
+  };
+
+  std::shared_ptr<Logger> logger;
+  std::unique_ptr<AbstractTimer> timer;
+  std::shared_ptr<ReadOnlyChassisModel> model;
+  ChassisScales chassisScales;
+  std::shared_ptr<ContinuousRotarySensor> imu;
+  KalmanOdometryNoise noise;
+  PoseFilter filter;
+  // Only used by the stepping task. Other tasks read and set the state through sharedState.
+  OdomState state;
+  SharedOdomState sharedState;
+  ReadOnlyChassisModel::SensorValues newTicks{}, lastTicks{};
+  const std::int32_t maximumTickDiff{1000};
+
+  // The difference between the estimated heading and the inertial sensor heading, found on the
+  // first good reading after the state is set
+  bool hasImuOffset{false};
+  double imuOffset{0};
+
+  std::vector<DistanceSensorMount> distanceSensors{};
+  FieldMap fieldMap;
+
+  /**
+   * Corrects the velocities with the encoders. This comes before the prediction, so the position
+   * moves by the distance the encoders measured this step.
+   *
+   * @param idt The time since the last step in seconds.
+   */
+  void updateEncoders(double idt);
+
+  /**
+   * Moves the estimate forward in time.
+   *
+   * @param idt The time since the last step in seconds.
+   */
+  void predict(double idt);
+
+  /**
+   * Corrects the heading with the inertial sensor.
+   */
+  void updateImu();
+
+  /**
+   * Corrects the pose with a distance sensor.
+   *
+   * @param imount The sensor.
+   */
+  void updateDistance(const DistanceSensorMount &imount);
+
+  /**
+   * Moves the estimate to a state which was set.
+   *
+   * @param istate The state in `StateMode::FRAME_TRANSFORMATION`.
+   */
+  void applyState(const OdomState &istate);
+};
+} // namespace okapi
@@ -0,0 +1,18 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#pragma once
+
+namespace okapi {
+/**
+ * How encoder odometry turns the movement measured in one step into a change in state. Both
+ * assume the robot moved along an arc during the step.
+ */
+enum class OdomIntegration {
+  ARC,            ///< Find the chord of the arc, then rotate it through polar coordinates
+  EXPONENTIAL_MAP ///< The closed form SE(2) exponential map, which needs fewer trig calls
+};
+
+} // namespace okapi
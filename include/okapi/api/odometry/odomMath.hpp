@@ -8,6 +8,7 @@
 #include "okapi/api/odometry/odomState.hpp"
 #include "okapi/api/odometry/point.hpp"
 #include "okapi/api/util/logging.hpp"
+#include <cstddef>
 #include <tuple>
 
 namespace okapi {
@@ -44,6 +45,36 @@ class OdomMath {
   static std::pair<QLength, QAngle> computeDistanceAndAngleToPoint(const Point &ipoint,
                                                                    const OdomState &istate);
 
+  /**
+   * Computes the distance and angle from the given Odometry state to each of the given points in
+   * one pass, like computeDistanceAndAngleToPoint. The points and the OdomState must be in
+   * `StateMode::FRAME_TRANSFORMATION`. Either output may be null to skip computing it; skipping the
+   * angles skips the trig.
+   *
+   * @param ipoints The points.
+   * @param icount The number of points.
+   * @param istate The Odometry state.
+   * @param odistances The distance to each point is written here.
+   * @param oangles The angle to each point is written here.
+   */
+  static void computeDistancesAndAnglesToPoints(const Point *ipoints,
+                                                std::size_t icount,
+                                                const OdomState &istate,
+                                                QLength *odistances,
+                                                QAngle *oangles);
+
+  /**
+   * Finds the point closest to the given Odometry state. The points and the OdomState must be in
+   * `StateMode::FRAME_TRANSFORMATION`. Ties go to the earlier point.
+   *
+   * @param ipoints The points.
+   * @param icount The number of points.
+   * @param istate The Odometry state.
+   * @return The index of the closest point, or `icount` if there are no points.
+   */
+  static std::size_t
+  findClosestPoint(const Point *ipoints, std::size_t icount, const OdomState &istate);
+
   /**
    * Constraints the angle to [0,360] degrees.
    *
@@ -60,6 +91,21 @@ class OdomMath {
    */
   static QAngle constrainAngle180(const QAngle &angle);
 
+  /**
+   * Finds the change in state of a robot which moved along an arc, using the SE(2) exponential
+   * map. Small turns use a Taylor series instead of trig calls.
+   *
+   * @param iforward The distance the robot moved forward, along the arc.
+   * @param iright The distance the robot moved to its right, along the arc.
+   * @param ideltaTheta The angle the robot turned.
+   * @param itheta The heading of the robot before it moved.
+   * @return The change in state, in `StateMode::FRAME_TRANSFORMATION`.
+   */
+  static OdomState integrateExponentialMap(const QLength &iforward,
+                                           const QLength &iright,
+                                           const QAngle &ideltaTheta,
+                                           const QAngle &itheta);
+
   private:
   OdomMath();
   ~OdomMath();
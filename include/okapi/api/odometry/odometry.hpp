@@ -8,7 +8,9 @@
 #include "okapi/api/chassis/controller/chassisScales.hpp"
 #include "okapi/api/chassis/model/readOnlyChassisModel.hpp"
 #include "okapi/api/odometry/odomState.hpp"
+#include "okapi/api/odometry/poseHistory.hpp"
 #include "okapi/api/odometry/stateMode.hpp"
+#include "okapi/api/util/logging.hpp"
 
 namespace okapi {
 class Odometry {
@@ -57,5 +59,54 @@ class Odometry {
    * @return The internal ChassisScales.
    */
   virtual ChassisScales getScales() = 0;
+
+  /**
+   * Returns the state at a time in the past, interpolated between the states recorded by each
+   * step. Use this to find where the robot was when a delayed measurement, like a vision sensor
+   * reading, was made. Reading the history never blocks the task which steps this odometry. Times
+   * older than the history give the oldest recorded state. Gives the current state if no step has
+   * been recorded.
+   *
+   * @param itime The time, in the time base of `Timer::millis`.
+   * @param imode The mode to return the state in.
+   * @return The state at the time in the given format.
+   */
+  OdomState getStateAt(const QTime &itime,
+                       const StateMode &imode = StateMode::FRAME_TRANSFORMATION) const;
+
+  /**
+   * Corrects the state with a pose measured by something else, like a coprocessor localizing the
+   * robot against field features. The estimate may be of where the robot was at some time in the
+   * past, so the motion the odometry tracked since then is moved onto the estimate instead of being
+   * thrown away. This sets the state, so it has the same thread safety as `setState()`.
+   *
+   * @param iestimate The estimated pose in `StateMode::FRAME_TRANSFORMATION`.
+   * @param itime The time the estimate was measured at, in the time base of `Timer::millis`.
+   * @param iweight How much to trust the estimate, from 0 (ignore it) to 1 (replace the pose the
+   * odometry had at that time).
+   */
+  void applyPoseEstimate(const OdomState &iestimate, const QTime &itime, double iweight = 1);
+
+  /**
+   * @return The states recorded by each step, in `StateMode::FRAME_TRANSFORMATION`.
+   */
+  const PoseHistory &getHistory() const;
+
+  protected:
+  // Written only by step, after the state is updated
+  PoseHistory history;
+
+  /**
+   * Logs and records in the flight recorder that a step skipped an implausible reading.
+   *
+   * @param ilogger The logger to log to.
+   * @param isource The name of the odometry, which must be a string literal.
+   * @param ivalue The rejected reading.
+   * @param ireason Why the reading was rejected and what the step did instead.
+   */
+  static void rejectStep(const std::shared_ptr<Logger> &ilogger,
+                         const char *isource,
+                         double ivalue,
+                         const std::string &ireason);
 };
 } // namespace okapi
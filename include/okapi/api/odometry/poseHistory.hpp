@@ -0,0 +1,102 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#pragma once
+
+#include "okapi/api/odometry/odomState.hpp"
+#include "okapi/api/units/QTime.hpp"
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+namespace okapi {
+/**
+ * A fixed size history of timestamped poses, newest first. One task records poses and any number
+ * of tasks read them. Recording and reading never block, allocate, or retry, so a control task
+ * reading the history never waits on the odometry task. When the history is full, recording a pose
+ * overwrites the oldest one.
+ */
+class PoseHistory {
+  public:
+  /**
+   * The number of poses kept by default. This is over a second of history at the default odometry
+   * loop period.
+   */
+  static constexpr std::size_t defaultCapacity = 128;
+
+  /**
+   * @param icapacity The number of poses the history holds. Must be at least two.
+   */
+  explicit PoseHistory(std::size_t icapacity = defaultCapacity);
+
+  PoseHistory(const PoseHistory &) = delete;
+  PoseHistory &operator=(const PoseHistory &) = delete;
+
+  /**
+   * Records a pose. This must only be called from one task at a time, and with times which never
+   * decrease.
+   *
+   * @param itime When the robot was at the pose.
+   * @param istate The pose, in `StateMode::FRAME_TRANSFORMATION`.
+   */
+  void record(const QTime &itime, const OdomState &istate);
+
+  /**
+   * Finds the pose at a time, linearly interpolated between the two recorded poses around it.
+   * Times before the oldest pose or after the newest pose give that pose.
+   *
+   * @param itime The time.
+   * @param ostate The pose is written to this.
+   * @return False if no pose has been recorded.
+   */
+  bool getStateAt(const QTime &itime, OdomState &ostate) const;
+
+  /**
+   * Reads the newest pose.
+   *
+   * @param otime When the robot was at the pose.
+   * @param ostate The pose is written to this.
+   * @return False if no pose has been recorded.
+   */
+  bool getLatest(QTime &otime, OdomState &ostate) const;
+
+  /**
+   * @return The number of poses the history holds.
+   */
+  std::size_t getCapacity() const;
+
+  protected:
+  // A cell's sequence number is odd while its pose is being written, so a read which overlaps a
+  // write can tell and stop instead of using a torn pose
+  struct Cell {
+    std::atomic_uint32_t sequence{0};
+    std::atomic<double> time{0};
+    std::atomic<double> x{0};
+    std::atomic<double> y{0};
+    std::atomic<double> theta{0};
+  };
+
+  struct Sample {
+    double time;
+    double x;
+    double y;
+    double theta;
+  };
+
+  std::size_t capacity;
+  std::unique_ptr<Cell[]> cells;
+  std::atomic_size_t writePosition{0};
+
+  /**
+   * Reads a cell.
+   *
+   * @param icell The cell.
+   * @param osample The pose is written to this.
+   * @return False if the cell was being written while it was read.
+   */
+  static bool readCell(const Cell &icell, Sample &osample);
+};
+} // namespace okapi
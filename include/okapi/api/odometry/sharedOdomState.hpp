@@ -0,0 +1,86 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#pragma once
+
+#include "okapi/api/odometry/odomState.hpp"
+#include <atomic>
+#include <cstdint>
+
+namespace okapi {
+/**
+ * The state of an odometry, shared between the task which steps the odometry and the tasks which
+ * read or set its state. Reads never see a state which is partly written, and never make the
+ * stepping task wait.
+ *
+ * Only the stepping task writes the state which is read. A state set from another task is held
+ * until the next step takes it, and reads give the set state until then.
+ */
+class SharedOdomState {
+  public:
+  /**
+   * Returns the newest state: the state set with `set` if the stepping task has not taken it yet,
+   * or else the state the stepping task last published. Can be called from any task.
+   *
+   * @return The state in `StateMode::FRAME_TRANSFORMATION`.
+   */
+  OdomState get() const;
+
+  /**
+   * Sets a new state for the stepping task to take. Must only be called from one task at a time.
+   *
+   * @param istate The state in `StateMode::FRAME_TRANSFORMATION`.
+   */
+  void set(const OdomState &istate);
+
+  /**
+   * Takes the state set with `set` since the last call, if there is one. Must only be called by
+   * the stepping task, before it steps.
+   *
+   * @param ostate The set state is written to this.
+   * @return False if no state has been set since the last call.
+   */
+  bool take(OdomState &ostate);
+
+  /**
+   * Publishes the state for `get` to read. Must only be called by the stepping task, after it
+   * steps.
+   *
+   * @param istate The state in `StateMode::FRAME_TRANSFORMATION`.
+   */
+  void publish(const OdomState &istate);
+
+  protected:
+  // One writer and many readers. The newest write is in `cells[writeCount % 2]`, so a
+  // read only has to retry if the writer finishes a write and starts another while it reads.
+  class DoubleBuffer {
+    public:
+    void store(const OdomState &istate);
+
+    OdomState load(std::uint32_t &owriteCount) const;
+
+    std::uint32_t getWriteCount() const;
+
+    protected:
+    // A cell's sequence number is odd while it is being written
+    struct Cell {
+      std::atomic_uint32_t sequence{0};
+      std::atomic<double> x{0};
+      std::atomic<double> y{0};
+      std::atomic<double> theta{0};
+    };
+
+    Cell cells[2]{};
+    std::atomic_uint32_t writeCount{0};
+  };
+
+  DoubleBuffer published;
+  DoubleBuffer setStates;
+  // The number of set states which the published state includes
+  std::atomic_uint32_t appliedCount{0};
+  // Only used by the stepping task
+  std::uint32_t takenCount{0};
+};
+} // namespace okapi
@@ -0,0 +1,132 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#pragma once
+
+#include "okapi/api/odometry/twoEncoderOdometry.hpp"
+#include "okapi/api/units/QAngle.hpp"
+#include "okapi/api/units/QLength.hpp"
+#include <array>
+#include <vector>
+
+namespace okapi {
+/**
+ * Where a tracking wheel is mounted and how far it rolls per tick.
+ */
+struct TrackingWheel {
+  /**
+   * @param ix How far the wheel is in front of the tracking center.
+   * @param iy How far the wheel is to the right of the tracking center.
+   * @param iheading The direction the wheel rolls when its sensor counts up, relative to the front
+   * of the robot. Positive angles turn towards the right, like the heading of the robot.
+   * @param iwheelDiameter The diameter of the wheel.
+   * @param itpr The ticks per revolution of the sensor on the wheel.
+   * @param iweight How much the wheel is trusted compared to the others. Give wheels which slip
+   * more or have coarser sensors less weight.
+   */
+  TrackingWheel(const QLength &ix,
+                const QLength &iy,
+                const QAngle &iheading,
+                const QLength &iwheelDiameter,
+                double itpr,
+                double iweight = 1);
+
+  QLength x;
+  QLength y;
+  QAngle heading;
+  double ticksPerMeter;
+  double weight;
+};
+
+/**
+ * Odometry for any number of tracking wheels mounted anywhere on the robot. Each step, the change
+ * in each wheel's reading is a linear function of how far the robot moved forward, to the right,
+ * and how far it turned, so the movement is found by weighted least squares. The pseudo-inverse of
+ * the wheel geometry is computed once, so a step costs one small matrix multiply and no
+ * allocation.
+ *
+ * With more than three wheels, a step in which the wheels disagree by more than the outlier
+ * threshold, such as when one slips or leaves the ground, drops one wheel. Four wheels can tell
+ * that one is wrong but not which one, so the dropped wheel is the one whose absence leaves the
+ * movement closest to the last step's. The solutions without each wheel are also computed once.
+ *
+ * The model's sensor readings are matched to the tracking wheels in order. Both integrations of
+ * `TwoEncoderOdometry` find the same arc, so this always uses the exponential map.
+ */
+class TrackingWheelOdometry : public TwoEncoderOdometry {
+  public:
+  /**
+   * The most tracking wheels, one per reading of a chassis model.
+   */
+  static constexpr std::size_t maxWheelCount = ReadOnlyChassisModel::maxSensorCount;
+
+  /**
+   * Odometry for any number of tracking wheels.
+   *
+   * @param itimeUtil The TimeUtil.
+   * @param imodel The chassis model for reading sensors. It must return at least one reading per
+   * tracking wheel.
+   * @param ichassisScales The chassis dimensions the chassis controllers use to drive. The tracking
+   * wheels are described by `iwheels` instead.
+   * @param iwheels The tracking wheels, in the order of the model's readings. There must be at
+   * least three, placed so they can tell every movement of the robot apart.
+   * @param ioutlierThreshold How far a wheel can disagree with the others in one step before it is
+   * dropped from that step. Only used with more than three wheels.
+   * @param ilogger The logger this instance will log to.
+   */
+  TrackingWheelOdometry(const TimeUtil &itimeUtil,
+                        const std::shared_ptr<ReadOnlyChassisModel> &imodel,
+                        const ChassisScales &ichassisScales,
+                        const std::vector<TrackingWheel> &iwheels,
+                        const QLength &ioutlierThreshold = 0.25_in,
+                        const std::shared_ptr<Logger> &ilogger = Logger::getDefaultLogger());
+
+  /**
+   * @return The number of steps which dropped an outlying wheel.
+   */
+  std::uint32_t getOutlierCount() const;
+
+  protected:
+  // The gains which turn the distance each wheel rolled into the forward, right, and turn movement,
+  // which is the transposed pseudo-inverse of the wheel geometry. A dropped wheel has no gain.
+  using Gains = std::array<std::array<double, 3>, maxWheelCount>;
+
+  std::size_t wheelCount;
+  std::array<double, maxWheelCount> ticksPerMeter{};
+  // The rows of the wheel geometry, which turn a movement into the distance each wheel rolls
+  std::array<std::array<double, 3>, maxWheelCount> geometry{};
+  Gains gains{};
+  // The gains without each wheel, if the other wheels can still find the movement
+  std::array<Gains, maxWheelCount> gainsWithout{};
+  std::array<bool, maxWheelCount> canDrop{};
+  double outlierThreshold;
+  std::atomic<std::uint32_t> outlierCount{0};
+  // The forward, right, and turn movement of the last step
+  std::array<double, 3> lastMovement{};
+
+  /**
+   * Does the math for one odom step. Only remembers the movement, to find outliers in the next.
+   *
+   * @param itickDiff The tick difference from the previous step to this step.
+   * @param ideltaT The time difference from the previous step to this step.
+   * @return The newly computed OdomState.
+   */
+  OdomState odomMathStep(const std::valarray<std::int32_t> &itickDiff,
+                         const QTime &ideltaT) override;
+
+  /**
+   * Computes the weighted pseudo-inverse of the wheel geometry, leaving out one wheel.
+   *
+   * @param iweights The weight of each wheel.
+   * @param iskip The wheel to leave out, or `maxWheelCount` to use every wheel.
+   * @param ogains The gains to write.
+   * @return Whether the wheels can find the movement, which fails if they can't tell some
+   * movements apart.
+   */
+  bool computeGains(const std::array<double, maxWheelCount> &iweights,
+                    std::size_t iskip,
+                    Gains &ogains) const;
+};
+} // namespace okapi
@@ -5,11 +5,16 @@
  */
 #pragma once
 
+#include "okapi/api/odometry/odomIntegration.hpp"
 #include "okapi/api/odometry/odometry.hpp"
+#include "okapi/api/odometry/sharedOdomState.hpp"
 #include "okapi/api/units/QSpeed.hpp"
 #include "okapi/api/util/abstractRate.hpp"
 #include "okapi/api/util/logging.hpp"
+#include "okapi/api/util/telemetryLogger.hpp"
+#include "okapi/api/util/telemetryStream.hpp"
 #include "okapi/api/util/timeUtil.hpp"
+#include <array>
 #include <atomic>
 #include <memory>
 #include <valarray>
@@ -38,6 +43,19 @@ class TwoEncoderOdometry : public Odometry {
    */
   void setScales(const ChassisScales &ichassisScales) override;
 
+  /**
+   * Sets how the movement measured in each step is turned into a change in state.
+   * `OdomIntegration::ARC` by default.
+   *
+   * @param iintegration The integration.
+   */
+  void setIntegration(const OdomIntegration &iintegration);
+
+  /**
+   * @return How the movement measured in each step is turned into a change in state.
+   */
+  OdomIntegration getIntegration() const;
+
   /**
    * Do one odometry step.
    */
@@ -70,15 +88,64 @@ class TwoEncoderOdometry : public Odometry {
    */
   ChassisScales getScales() override;
 
+  /**
+   * Streams the estimated pose as signals named `<iname>.x` and `<iname>.y` in meters and
+   * `<iname>.theta` in degrees, in the frame transformation mode. The signals are removed when
+   * this odometry is destroyed.
+   *
+   * @param istream The stream to add the signals to.
+   * @param iname The prefix of the signal names.
+   */
+  void addTelemetry(const std::shared_ptr<TelemetryStream> &istream, const std::string &iname);
+
+  /**
+   * Records the encoder readings of every step to a telemetry channel with a field per sensor,
+   * named `sensor0`, `sensor1`, and so on. Decode the file with the `telemetryDecoder` tool to
+   * replay the readings through odometry on a computer. Call this before stepping this odometry.
+   *
+   * @param itelemetry The logger to record to.
+   * @param ichannelName The name of the channel.
+   */
+  void recordSensors(const std::shared_ptr<TelemetryLogger> &itelemetry,
+                     const std::string &ichannelName = "odometrySensors");
+
   protected:
   std::shared_ptr<Logger> logger;
   std::unique_ptr<AbstractRate> rate;
   std::unique_ptr<AbstractTimer> timer;
   std::shared_ptr<ReadOnlyChassisModel> model;
   ChassisScales chassisScales;
+  std::atomic<OdomIntegration> integration{OdomIntegration::ARC};
+  // Only used by the stepping task. Other tasks read and set the state through sharedState.
   OdomState state;
-  std::valarray<std::int32_t> newTicks{0, 0, 0}, tickDiff{0, 0, 0}, lastTicks{0, 0, 0};
+  SharedOdomState sharedState;
+  // Reused every step so stepping doesn't allocate
+  ReadOnlyChassisModel::SensorValues newTicks{}, lastTicks{};
+  std::valarray<std::int32_t> tickDiff{};
+
+  // The last raw readings, when they were measured, and the velocity of each sensor in ticks per
+  // millisecond, used to correct for the skew between reads
+  ReadOnlyChassisModel::SensorTimestamps newTimestamps{}, lastTimestamps{};
+  ReadOnlyChassisModel::SensorValues lastRawTicks{};
+  std::array<double, ReadOnlyChassisModel::maxSensorCount> tickVelocities{};
+  // Zero if the sensors didn't report when they were measured in the last step
+  std::uint32_t lastSampleTime{0};
   const std::int32_t maximumTickDiff{1000};
+  std::shared_ptr<TelemetryLogger> sensorTelemetry{nullptr};
+  std::uint16_t sensorChannel{0};
+  std::size_t sensorChannelFieldCount{0};
+  // Declared last so the signals are removed before anything they read is destroyed
+  TelemetryRegistration telemetry;
+
+  /**
+   * Moves each reading in `newTicks` to the time of the newest reading, using the velocity of its
+   * sensor, so readings measured at different times describe the same instant.
+   *
+   * @param isensorCount The number of readings.
+   * @return The time between the newest reading of this step and of the last step, or zero if the
+   * sensors don't report when they were measured or this is the first step.
+   */
+  QTime correctSensorSkew(std::size_t isensorCount);
 
   /**
    * Does the math, side-effect free, for one odom step.
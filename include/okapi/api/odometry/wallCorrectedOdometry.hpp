@@ -0,0 +1,153 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#pragma once
+
+#include "okapi/api/control/controllerInput.hpp"
+#include "okapi/api/odometry/fieldMap.hpp"
+#include "okapi/api/odometry/odometry.hpp"
+#include "okapi/api/odometry/sharedOdomState.hpp"
+#include "okapi/api/util/logging.hpp"
+#include <atomic>
+#include <memory>
+#include <vector>
+
+namespace okapi {
+/**
+ * Odometry which corrects the position of another odometry with distance sensors aimed at the
+ * walls of the field. The position tracked by the encoders drifts over a long run. Each step, the
+ * distance every sensor should read is worked out from the pose and the map of the walls. If a
+ * reading lines up with a wall, the position is moved toward the wall (or away from it) by the
+ * difference. One sensor only corrects the position across the wall it sees, so use sensors which
+ * see walls in different directions to correct both axes.
+ *
+ * A reading is only used if it is close to the distance expected from the pose, so readings of
+ * other robots or field elements don't move the pose.
+ */
+class WallCorrectedOdometry : public Odometry {
+  public:
+  /**
+   * How much of the error is corrected each time a reading lines up with a wall, by default.
+   */
+  static constexpr double defaultGain = 0.2;
+
+  /**
+   * Readings further than this from the expected distance are ignored, by default.
+   */
+  static constexpr QLength defaultMaxError = 2_in; // NOLINT
+
+  /**
+   * Readings of a wall hit at more than this angle from straight on are ignored, by default.
+   */
+  static constexpr QAngle defaultMaxIncidence = 30_deg; // NOLINT
+
+  /**
+   * Odometry which corrects the position of another odometry with distance sensors.
+   *
+   * @param iodometry The odometry which reads the encoders.
+   * @param imap The walls of the field, in `StateMode::FRAME_TRANSFORMATION`.
+   * @param igain How much of the error is corrected each time a reading lines up with a wall,
+   * between `0` (never correct) and `1` (snap to the reading).
+   * @param imaxError Readings further than this from the expected distance don't line up with a
+   * wall and are ignored.
+   * @param imaxIncidence Readings of a wall hit at more than this angle from straight on are
+   * ignored, because the sensor is unreliable at a shallow angle.
+   * @param ilogger The logger this instance will log to.
+   */
+  WallCorrectedOdometry(std::shared_ptr<Odometry> iodometry,
+                        const FieldMap &imap,
+                        double igain = defaultGain,
+                        const QLength &imaxError = defaultMaxError,
+                        const QAngle &imaxIncidence = defaultMaxIncidence,
+                        const std::shared_ptr<Logger> &ilogger = Logger::getDefaultLogger());
+
+  /**
+   * Adds a distance sensor. Add the sensors before stepping this odometry.
+   *
+   * @param isensor The sensor. Must read the distance in millimeters, like the DistanceSensor.
+   * @param imount Where the sensor is on the robot: `x` is forward and `y` is to the right of the
+   * center of the robot, and `theta` is the direction of the beam relative to the front.
+   * @param imaxRange Readings further than this, or zero or less, are ignored.
+   */
+  void addDistanceSensor(std::shared_ptr<ControllerInput<double>> isensor,
+                         const OdomState &imount,
+                         const QLength &imaxRange = 2_m);
+
+  /**
+   * Sets the drive and turn scales.
+   */
+  void setScales(const ChassisScales &ichassisScales) override;
+
+  /**
+   * Do one odometry step.
+   */
+  void step() override;
+
+  /**
+   * Returns the current state.
+   *
+   * @param imode The mode to return the state in.
+   * @return The current state in the given format.
+   */
+  OdomState getState(const StateMode &imode = StateMode::FRAME_TRANSFORMATION) const override;
+
+  /**
+   * Sets a new state to be the current state.
+   *
+   * @param istate The new state in the given format.
+   * @param imode The mode to treat the input state as.
+   */
+  void setState(const OdomState &istate,
+                const StateMode &imode = StateMode::FRAME_TRANSFORMATION) override;
+
+  /**
+   * @return The internal ChassisModel.
+   */
+  std::shared_ptr<ReadOnlyChassisModel> getModel() override;
+
+  /**
+   * @return The internal ChassisScales.
+   */
+  ChassisScales getScales() override;
+
+  /**
+   * @return The odometry which reads the encoders.
+   */
+  std::shared_ptr<Odometry> getEncoderOdometry() const;
+
+  /**
+   * @return The number of readings which lined up with a wall and corrected the position.
+   */
+  std::uint32_t getCorrectionCount() const;
+
+  protected:
+  struct DistanceSensorMount {
+    std::shared_ptr<ControllerInput<double>> sensor;
+    double forward;
+    double right;
+    double angle;
+    QLength maxRange;
+  };
+
+  std::shared_ptr<Logger> logger;
+  std::shared_ptr<Odometry> odometry;
+  FieldMap map;
+  double gain;
+  QLength maxError;
+  QAngle maxIncidence;
+  std::vector<DistanceSensorMount> distanceSensors{};
+  // Only used by the stepping task. Other tasks read and set the state through sharedState.
+  OdomState state;
+  SharedOdomState sharedState;
+  std::atomic_uint32_t correctionCount{0};
+
+  /**
+   * Corrects the position with one distance sensor.
+   *
+   * @param imount The sensor.
+   */
+  void correct(const DistanceSensorMount &imount);
+};
+} // namespace okapi
@@ -16,6 +16,7 @@ QUANTITY_TYPE(0, 0, 1, 0, QTime)
 
 constexpr QTime second(1.0); // SI base unit
 constexpr QTime millisecond = second / 1000;
+constexpr QTime microsecond = millisecond / 1000;
 constexpr QTime minute = 60 * second;
 constexpr QTime hour = 60 * minute;
 constexpr QTime day = 24 * hour;
@@ -27,6 +28,9 @@ constexpr QTime operator"" _s(long double x) {
 constexpr QTime operator"" _ms(long double x) {
   return static_cast<double>(x) * millisecond;
 }
+constexpr QTime operator"" _us(long double x) {
+  return static_cast<double>(x) * microsecond;
+}
 constexpr QTime operator"" _min(long double x) {
   return static_cast<double>(x) * minute;
 }
@@ -42,6 +46,9 @@ constexpr QTime operator"" _s(unsigned long long int x) {
 constexpr QTime operator"" _ms(unsigned long long int x) {
   return static_cast<double>(x) * millisecond;
 }
+constexpr QTime operator"" _us(unsigned long long int x) {
+  return static_cast<double>(x) * microsecond;
+}
 constexpr QTime operator"" _min(unsigned long long int x) {
   return static_cast<double>(x) * minute;
 }
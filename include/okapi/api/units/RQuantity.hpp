@@ -11,6 +11,7 @@
 
 #include <cmath>
 #include <ratio>
+#include <type_traits>
 
 namespace okapi {
 template <typename MassDim, typename LengthDim, typename TimeDim, typename AngleDim>
@@ -188,6 +189,22 @@ constexpr bool operator>(const RQuantity<M, L, T, A> &lhs, const RQuantity<M, L,
   return (lhs.getValue() > rhs.getValue());
 }
 
+// Compile-time unit conversions:
+// ------------------------------
+
+// The factor which converts a quantity to multiples of a unit, folded at compile time
+template <const auto &Unit> constexpr double unitFactor = 1.0 / Unit.getValue();
+
+// Returns the value of the quantity in multiples of the unit, like convert(), but costs one
+// multiply instead of a divide, e.g. unit_cast<millisecond>(dt). For units which are not a power of
+// two of the SI unit, the result may differ from convert() in the last bit, so prefer convert()
+// where the result is truncated to an integer.
+template <const auto &Unit>
+constexpr double
+unit_cast(const std::remove_cv_t<std::remove_reference_t<decltype(Unit)>> &iquantity) {
+  return iquantity.getValue() * unitFactor<Unit>;
+}
+
 // Common math functions:
 // ------------------------------
 
@@ -37,5 +37,12 @@ class AbstractRate {
    * @param ims the time period
    */
   virtual void delayUntil(uint32_t ims) = 0;
+
+  /**
+   * Forget the previous period, so the next delay is timed from when it is called, as if this
+   * rate were new. Call this before reusing a rate for a new wait, so one rate can be made once
+   * and kept instead of making a new one for every wait.
+   */
+  virtual void reset() = 0;
 };
 } // namespace okapi
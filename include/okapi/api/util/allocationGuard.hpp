@@ -0,0 +1,89 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#pragma once
+
+#include <cstddef>
+
+namespace okapi {
+/**
+ * Catches heap allocations made after the robot is set up, which would otherwise contend for the
+ * allocator's lock and fragment the heap while the control tasks run. Build with
+ * `-DOKAPI_ALLOCATION_GUARD` to route every `new` and `delete` through the guard. Without that
+ * flag nothing is routed through it, so sealing it has no effect and costs nothing.
+ *
+ * Build every controller, path, and log sink in `initialize()` and `competition_initialize()`,
+ * then seal the guard at the start of `autonomous()` or `opcontrol()`:
+ *
+ * ```cpp
+ * void autonomous() {
+ *   AllocationGuard::seal();
+ *   // ...
+ * }
+ * ```
+ *
+ * Every allocation while the guard is sealed is a violation. By default a violation aborts, so the
+ * allocation is found at once. Seal the guard with your own handler to only count or report them.
+ */
+class AllocationGuard {
+  public:
+  /**
+   * Called with the size of the allocation on each violation. It runs inside `operator new`, so
+   * anything it allocates is not reported again.
+   */
+  using ViolationHandler = void (*)(std::size_t isize);
+
+  /**
+   * Treats every allocation from now on as a violation, until the guard is unsealed.
+   *
+   * @param ihandler Called on each violation. Pass `nullptr` to only count them.
+   */
+  static void seal(ViolationHandler ihandler = abortOnViolation);
+
+  /**
+   * Allows allocations again, e.g. before building a new path between autonomous routines.
+   */
+  static void unseal();
+
+  /**
+   * @return Whether the guard is sealed.
+   */
+  static bool isSealed();
+
+  /**
+   * @return The number of allocations made since startup.
+   */
+  static std::size_t getAllocationCount();
+
+  /**
+   * @return The number of allocations made while the guard was sealed.
+   */
+  static std::size_t getViolationCount();
+
+  /**
+   * @return Whether this build routes allocations through the guard.
+   */
+  static constexpr bool isEnabled() {
+#ifdef OKAPI_ALLOCATION_GUARD
+    return true;
+#else
+    return false;
+#endif
+  }
+
+  /**
+   * Records an allocation. The replaced `operator new` calls this, so there is no reason to call
+   * it yourself except in tests.
+   *
+   * @param isize The size of the allocation in bytes.
+   */
+  static void recordAllocation(std::size_t isize);
+
+  /**
+   * The default violation handler. Aborts the program.
+   */
+  static void abortOnViolation(std::size_t isize);
+};
+} // namespace okapi
@@ -0,0 +1,109 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#pragma once
+
+#include <cstddef>
+
+namespace okapi {
+/**
+ * Single-precision kernels which run the same math over many channels at once. On the brain they
+ * use NEON to work on four channels per instruction. Everywhere else they are plain loops, which
+ * give the same results up to float rounding.
+ *
+ * Every array holds one value per channel. Outputs may be the same arrays as inputs unless noted.
+ */
+class BatchMath {
+  public:
+  /**
+   * Steps exponential moving averages, like EmaFilter:
+   * `ioutput = ialpha * iinput + (1 - ialpha) * ioutput`.
+   *
+   * @param ioutput The previous outputs, which are replaced by the new outputs.
+   * @param iinput The new readings.
+   * @param ialpha The alpha gain shared by every channel.
+   * @param icount The number of channels.
+   */
+  static void emaStep(float *ioutput, const float *iinput, float ialpha, std::size_t icount);
+
+  /**
+   * Steps moving averages over windows of a fixed length, like AverageFilter once its window is
+   * full. The caller keeps the window of each channel and passes in the reading which enters it and
+   * the reading which leaves it.
+   *
+   * @param iosum The sums of the windows, which are updated.
+   * @param inewest The readings entering the windows.
+   * @param ioldest The readings leaving the windows, or zeros while the windows fill up.
+   * @param ooutput The averages are written here.
+   * @param ilength The length of the windows.
+   * @param icount The number of channels.
+   */
+  static void movingAverageStep(float *iosum,
+                                const float *inewest,
+                                const float *ioldest,
+                                float *ooutput,
+                                std::size_t ilength,
+                                std::size_t icount);
+
+  /**
+   * Mixes x-drive commands into wheel outputs, like XDriveModel::xArcade without the deadband:
+   * each wheel is the sum of the forward, strafe, and yaw parts for its corner, clamped to
+   * `[-1, 1]`.
+   *
+   * @param ixSpeed The strafe speeds.
+   * @param iforwardSpeed The forward speeds.
+   * @param iyaw The yaw speeds.
+   * @param otopLeft The top left wheel outputs are written here.
+   * @param otopRight The top right wheel outputs are written here.
+   * @param obottomRight The bottom right wheel outputs are written here.
+   * @param obottomLeft The bottom left wheel outputs are written here.
+   * @param icount The number of commands.
+   */
+  static void mixXDrive(const float *ixSpeed,
+                        const float *iforwardSpeed,
+                        const float *iyaw,
+                        float *otopLeft,
+                        float *otopRight,
+                        float *obottomRight,
+                        float *obottomLeft,
+                        std::size_t icount);
+
+  /**
+   * Integrates robot-relative motions into poses, like OdomMath::integrateExponentialMap. The
+   * heading of each pose is kept as its cosine and sine, so the kernel needs no trig. The turn of
+   * each step is expanded as a Taylor series, which is accurate to float precision for turns of a
+   * few degrees per step, like odometry steps. The heading is normalized after each step so it does
+   * not drift.
+   *
+   * @param iox The x positions, which are updated.
+   * @param ioy The y positions, which are updated.
+   * @param iocosTheta The cosines of the headings, which are updated.
+   * @param iosinTheta The sines of the headings, which are updated.
+   * @param iforward The distances moved forward.
+   * @param iright The distances moved to the right.
+   * @param ideltaTheta The turns, in radians.
+   * @param icount The number of poses.
+   */
+  static void integratePoses(float *iox,
+                             float *ioy,
+                             float *iocosTheta,
+                             float *iosinTheta,
+                             const float *iforward,
+                             const float *iright,
+                             const float *ideltaTheta,
+                             std::size_t icount);
+
+  /**
+   * @return Whether the kernels use NEON in this build.
+   */
+  static constexpr bool isAccelerated() {
+#if defined(__ARM_NEON) || defined(__ARM_NEON__)
+    return true;
+#else
+    return false;
+#endif
+  }
+};
+} // namespace okapi
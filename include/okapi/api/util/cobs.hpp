@@ -0,0 +1,52 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace okapi {
+/**
+ * Consistent Overhead Byte Stuffing. Encoding removes every zero byte from a packet so a zero can
+ * mark the end of each packet in a byte stream. A reader which starts in the middle of the stream,
+ * or loses bytes, finds the start of the next packet at the next zero.
+ */
+class Cobs {
+  public:
+  /**
+   * @param ilength The length of the packet in bytes.
+   * @return The largest size of the encoded packet in bytes, not including the zero delimiter.
+   */
+  static constexpr std::size_t getMaxEncodedSize(const std::size_t ilength) {
+    return ilength + ilength / 254 + 1;
+  }
+
+  /**
+   * Encodes a packet. The output does not include the zero delimiter.
+   *
+   * @param ipacket The packet to encode.
+   * @param ilength The length of the packet in bytes.
+   * @param oencoded The buffer to write to, which must hold `getMaxEncodedSize(ilength)` bytes.
+   * @return The length of the encoded packet in bytes.
+   */
+  static std::size_t
+  encode(const std::uint8_t *ipacket, std::size_t ilength, std::uint8_t *oencoded);
+
+  /**
+   * Decodes a packet. The input should not include the zero delimiter.
+   *
+   * @param iencoded The encoded packet.
+   * @param ilength The length of the encoded packet in bytes.
+   * @param opacket The buffer to write to, which must hold `ilength` bytes.
+   * @param opacketLength Set to the length of the decoded packet in bytes.
+   * @return False if the input is not a valid encoded packet.
+   */
+  static bool decode(const std::uint8_t *iencoded,
+                     std::size_t ilength,
+                     std::uint8_t *opacket,
+                     std::size_t &opacketLength);
+};
+} // namespace okapi
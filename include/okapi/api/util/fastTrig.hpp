@@ -0,0 +1,96 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#pragma once
+
+#include <cmath>
+
+/**
+ * Whether odometry and the chassis models use FastTrig instead of the standard library for their
+ * trig. Off by default. Set it with a `-D`, e.g. `-DOKAPI_FAST_TRIG=1`.
+ */
+#ifndef OKAPI_FAST_TRIG
+#define OKAPI_FAST_TRIG 0
+#endif
+
+namespace okapi {
+/**
+ * Polynomial approximations of the trig functions which skip the edge-case handling of the
+ * standard library. Arguments are reduced to a quarter turn around zero, so the error does not grow
+ * with the size of the angle until the reduction itself loses precision, far past any heading a
+ * robot reaches.
+ *
+ * Error bounds, for finite arguments:
+ * - `sin` and `cos`: absolute error at most 1e-10 for `|x| < 1e5` radians.
+ * - `atan2`: absolute error at most 1e-10 radians.
+ *
+ * Non-finite arguments return NaN, except that `atan2` of an infinite and a finite argument is not
+ * handled specially.
+ */
+class FastTrig {
+  public:
+  /**
+   * @param x The angle in radians.
+   * @return The sine of the angle.
+   */
+  static double sin(double x);
+
+  /**
+   * @param x The angle in radians.
+   * @return The cosine of the angle.
+   */
+  static double cos(double x);
+
+  /**
+   * Computes the sine and cosine of an angle with one range reduction.
+   *
+   * @param x The angle in radians.
+   * @param osin The sine is written here.
+   * @param ocos The cosine is written here.
+   */
+  static void sincos(double x, double &osin, double &ocos);
+
+  /**
+   * @param y The y coordinate.
+   * @param x The x coordinate.
+   * @return The angle of the point in radians, in `[-pi, pi]`, like `std::atan2`.
+   */
+  static double atan2(double y, double x);
+};
+
+/**
+ * The trig odometry and the chassis models call: FastTrig when `OKAPI_FAST_TRIG` is set, otherwise
+ * the standard library. Square roots always use the standard library, because the brain's FPU
+ * computes them in hardware.
+ */
+class Trig {
+  public:
+  static constexpr bool isFast = OKAPI_FAST_TRIG != 0;
+
+  static double sin(const double x) {
+    if constexpr (isFast) {
+      return FastTrig::sin(x);
+    } else {
+      return std::sin(x);
+    }
+  }
+
+  static double cos(const double x) {
+    if constexpr (isFast) {
+      return FastTrig::cos(x);
+    } else {
+      return std::cos(x);
+    }
+  }
+
+  static double atan2(const double y, const double x) {
+    if constexpr (isFast) {
+      return FastTrig::atan2(y, x);
+    } else {
+      return std::atan2(y, x);
+    }
+  }
+};
+} // namespace okapi
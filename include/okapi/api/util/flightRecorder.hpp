@@ -0,0 +1,171 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#pragma once
+
+#include "okapi/api/coreProsAPI.hpp"
+#include "okapi/api/units/QTime.hpp"
+#include "okapi/api/util/abstractTimer.hpp"
+#include "okapi/api/util/logging.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace okapi {
+/**
+ * The kinds of events okapi records to a `FlightRecorder`.
+ */
+enum class FlightEventType : std::uint8_t {
+  targetChanged,    ///< A controller was given a new target. The code is the target's handle.
+  settled,          ///< A controller settled. The code is whether it followed a path.
+  motorFault,       ///< A motor reported new faults. The code is its index, the value its faults.
+  odometryRejected, ///< Odometry skipped a step. The value is the rejected tick diff.
+  loopOverrun,      ///< A loop took longer than its period. The value is the time in ms.
+  wheelSlip,        ///< The drive wheels started slipping. The code is 0 if the left side slips
+                    ///< and 1 otherwise, the value the slip speed in m/s.
+  user              ///< An event recorded by user code.
+};
+
+/**
+ * @return The name of the event type, as written to the file.
+ */
+const char *toString(FlightEventType itype);
+
+/**
+ * One event of a `FlightRecorder`.
+ */
+struct FlightEvent {
+  std::uint32_t time;   ///< The time since the recorder was made, in ms
+  FlightEventType type; ///< What happened
+  const char *source;   ///< The name of the subsystem which recorded the event
+  std::int32_t code;    ///< A code which depends on the type
+  double value;         ///< A value which depends on the type
+};
+
+/**
+ * Keeps the most recent events of okapi's subsystems in a fixed-size buffer in RAM, so the moments
+ * before something went wrong can be looked at afterwards. Recording an event copies a few bytes
+ * into the buffer, and nothing is recorded unless a recorder is made the default (see
+ * `setDefault()`), so diagnostics cost nothing until they are needed. The events are written to
+ * the SD card by `flush()`, or right after a motor fault is recorded if `setFlushOnFault()` is
+ * enabled.
+ *
+ * The source of an event is not copied, so it must be a string literal.
+ */
+class FlightRecorder {
+  public:
+  /**
+   * The number of events kept by default.
+   */
+  static constexpr std::size_t defaultCapacity = 512;
+
+  /**
+   * @param itimer A timer used to get the time of each event.
+   * @param icapacity The number of events kept. Older events are overwritten by newer ones.
+   * @param ifileName The name of the file `flush()` writes to. It is overwritten on every flush.
+   * @param ilogger The logger this instance will log to.
+   */
+  FlightRecorder(std::unique_ptr<AbstractTimer> itimer,
+                 std::size_t icapacity = defaultCapacity,
+                 std::string ifileName = "/usd/flight.csv",
+                 const std::shared_ptr<Logger> &ilogger = Logger::getDefaultLogger());
+
+  virtual ~FlightRecorder() = default;
+
+  FlightRecorder(const FlightRecorder &) = delete;
+  FlightRecorder &operator=(const FlightRecorder &) = delete;
+
+  /**
+   * Records an event, overwriting the oldest event if the buffer is full.
+   *
+   * @param itype What happened.
+   * @param isource The name of the subsystem, which must be a string literal.
+   * @param icode A code which depends on the type.
+   * @param ivalue A value which depends on the type.
+   */
+  void
+  record(FlightEventType itype, const char *isource, std::int32_t icode = 0, double ivalue = 0);
+
+  /**
+   * @param iwindow How far back to look.
+   * @return The events recorded within the window, oldest first.
+   */
+  std::vector<FlightEvent> getEvents(QTime iwindow = 1e9 * second) const;
+
+  /**
+   * Writes the events recorded within the window to the file as CSV with a header line. This takes
+   * a while on the SD card, so it should not be called from a control loop.
+   *
+   * @param iwindow How far back to look.
+   * @return Whether the file was written.
+   */
+  bool flush(QTime iwindow = 1e9 * second);
+
+  /**
+   * Sets whether recording a motor fault flushes the recorder. The flush happens in the task
+   * which records the fault, which for `MotorHealthMonitor` is its own low-rate task.
+   *
+   * @param iflushOnFault Whether to flush on a motor fault.
+   * @param iwindow How far back the flush looks.
+   */
+  void setFlushOnFault(bool iflushOnFault, QTime iwindow = 1e9 * second);
+
+  /**
+   * @return The number of events recorded since this was made, including overwritten ones.
+   */
+  std::uint32_t getRecordedCount() const;
+
+  /**
+   * Makes a recorder the one okapi's subsystems record to. Pass `nullptr` to stop recording,
+   * which is the default.
+   *
+   * @param irecorder The recorder.
+   */
+  static void setDefault(std::shared_ptr<FlightRecorder> irecorder);
+
+  /**
+   * @return The recorder okapi's subsystems record to, or `nullptr` if there is none.
+   */
+  static std::shared_ptr<FlightRecorder> getDefault();
+
+  /**
+   * Records an event to the default recorder, if there is one. This is what okapi's subsystems
+   * call. Without a default recorder it only reads one atomic flag.
+   *
+   * @param itype What happened.
+   * @param isource The name of the subsystem, which must be a string literal.
+   * @param icode A code which depends on the type.
+   * @param ivalue A value which depends on the type.
+   */
+  static void recordDefault(FlightEventType itype,
+                            const char *isource,
+                            std::int32_t icode = 0,
+                            double ivalue = 0);
+
+  protected:
+  std::shared_ptr<Logger> logger;
+  std::unique_ptr<AbstractTimer> timer;
+  std::string fileName;
+
+  // Guards everything below
+  mutable CrossplatformMutex mutex;
+  std::vector<FlightEvent> events;
+  std::size_t next{0};
+  std::uint32_t recordedCount{0};
+  bool flushOnFault{false};
+  QTime faultWindow{1e9 * second};
+
+  /**
+   * Opens the file to write the events to. The default implementation opens an `std::ofstream`.
+   *
+   * @param ifileName The name of the file.
+   * @return The stream to write to.
+   */
+  virtual std::unique_ptr<std::ostream> openOutput(const std::string &ifileName);
+};
+} // namespace okapi
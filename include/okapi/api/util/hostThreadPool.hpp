@@ -0,0 +1,127 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#pragma once
+
+#include "okapi/api/coreProsAPI.hpp"
+#include <atomic>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <vector>
+
+#if defined(THREADS_STD)
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#endif
+
+namespace okapi {
+/**
+ * A fixed set of host threads which run batches of finite jobs, such as the trials of PIDTuner.
+ * Running every batch on the same threads keeps large simulations from starting and stopping
+ * threads for each batch, and from running more threads than the host has cores.
+ *
+ * Each thread has its own queue of jobs. A thread takes the newest job from its own queue and, once
+ * that is empty, steals the oldest job from another queue. A thread which waits for a batch takes
+ * jobs too instead of blocking, so a job may start a batch of its own without deadlocking the pool.
+ *
+ * Only the host build has threads. On the brain, every job runs on the calling task.
+ */
+class HostThreadPool {
+  public:
+  /**
+   * @param inumWorkers The number of threads to start. The thread which calls `runAll()` also runs
+   * jobs, so zero runs every job on the calling thread.
+   */
+  explicit HostThreadPool(std::size_t inumWorkers = getDefaultWorkerCount());
+
+  HostThreadPool(const HostThreadPool &) = delete;
+  HostThreadPool &operator=(const HostThreadPool &) = delete;
+
+  /**
+   * Runs the queued jobs and stops the threads.
+   */
+  ~HostThreadPool();
+
+  /**
+   * Runs a job once for every index from zero up to the count, across the threads of the pool and
+   * the calling thread, and returns once they are all done. If any of them throw, the first
+   * exception is rethrown here after the rest are done.
+   *
+   * @param icount The number of times to run the job.
+   * @param ijob The job. It is given the index of the run.
+   */
+  void runAll(std::size_t icount, const std::function<void(std::size_t)> &ijob);
+
+  /**
+   * @return The number of threads the pool started.
+   */
+  std::size_t getWorkerCount() const;
+
+  /**
+   * @return One less than the number of cores of the host, so the calling thread has a core too.
+   * Zero on the brain.
+   */
+  static std::size_t getDefaultWorkerCount();
+
+  /**
+   * @return A pool shared by everything in okapi which runs batches of jobs, with the default
+   * number of threads.
+   */
+  static HostThreadPool &getShared();
+
+  protected:
+  struct Batch {
+    const std::function<void(std::size_t)> *job;
+    std::atomic<std::size_t> remaining;
+    std::exception_ptr error{nullptr};
+  };
+
+  struct Job {
+    Batch *batch;
+    std::size_t index;
+  };
+
+#if defined(THREADS_STD)
+  struct Queue {
+    std::mutex mutex;
+    std::deque<Job> jobs{};
+  };
+
+  std::vector<std::unique_ptr<Queue>> queues{};
+  std::vector<std::thread> workers{};
+  std::size_t nextQueue{0};
+  std::size_t pending{0};
+  bool stopping{false};
+  std::mutex mutex;
+  std::condition_variable condition;
+
+  static inline thread_local const HostThreadPool *currentPool{nullptr};
+  static inline thread_local std::size_t currentQueue{0};
+
+  /**
+   * Takes the newest job from a queue, or else steals the oldest job from another queue.
+   *
+   * @param iqueue The queue to take from first.
+   * @param ojob The job is written here.
+   * @return Whether there was a job.
+   */
+  bool take(std::size_t iqueue, Job &ojob);
+
+  /**
+   * Runs jobs until the pool stops.
+   */
+  void workerLoop(std::size_t iqueue);
+#endif
+
+  /**
+   * Runs a job and counts it done.
+   */
+  void run(Job &ijob);
+};
+} // namespace okapi
@@ -0,0 +1,128 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#pragma once
+
+#include "okapi/api/control/controllerInput.hpp"
+#include "okapi/api/device/button/abstractButton.hpp"
+#include "okapi/api/device/motor/abstractMotor.hpp"
+#include "okapi/api/device/rotarysensor/continuousRotarySensor.hpp"
+#include "okapi/api/util/telemetryLogger.hpp"
+#include <cstdint>
+#include <memory>
+#include <string>
+
+namespace okapi {
+/**
+ * The readings an InputRecorder records. Each recorded reading is one sample of the device's
+ * channel holding the reading and its value.
+ */
+enum class InputReading : std::uint8_t {
+  motorTargetPosition,
+  motorPosition,
+  motorTargetVelocity,
+  motorActualVelocity,
+  motorCurrentDraw,
+  motorDirection,
+  motorEfficiency,
+  motorOverCurrent,
+  motorOverTemp,
+  motorStopped,
+  motorZeroPositionFlag,
+  motorFaults,
+  motorFlags,
+  motorRawPosition,
+  motorRawPositionTimestamp,
+  motorPower,
+  motorTemperature,
+  motorTorque,
+  motorVoltage,
+  sensorValue,
+  sensorTimestampedValue,
+  sensorTimestamp,
+  sensorVelocity,
+  sensorControllerValue,
+  buttonPressed,
+  buttonChanged,
+  buttonChangedToPressed,
+  buttonChangedToReleased,
+  buttonControllerValue,
+  inputValue
+};
+
+/**
+ * Records everything a robot reads from its devices so it can be replayed on a host by an
+ * InputReplayer. Wrap each device the code reads before handing it to the code, and every reading
+ * is passed through and recorded to the telemetry logger with the time it was read. Commands are
+ * passed through without being recorded, since replaying the code makes them again.
+ *
+ * Each device is recorded to its own channel named `input/` followed by the name of the device, so
+ * the same telemetry logger can record other channels too. Values are recorded as 32-bit floats,
+ * which hold encoder ticks and the integer readings exactly.
+ */
+class InputRecorder {
+  public:
+  /**
+   * The prefix of the name of every channel the recorder adds.
+   */
+  static constexpr const char *channelPrefix = "input/";
+
+  /**
+   * @param itelemetry The telemetry logger to record to.
+   */
+  explicit InputRecorder(std::shared_ptr<TelemetryLogger> itelemetry);
+
+  /**
+   * Records the readings of a motor and of its encoder. The encoder is recorded as the sensor
+   * named `<name>/encoder`.
+   *
+   * @param iname The name of the motor, which must be unique among the recorded devices.
+   * @param imotor The motor.
+   * @return A motor which passes everything through to the given motor and records its readings.
+   */
+  std::shared_ptr<AbstractMotor> recordMotor(const std::string &iname,
+                                             const std::shared_ptr<AbstractMotor> &imotor);
+
+  /**
+   * Records the readings of a sensor.
+   *
+   * @param iname The name of the sensor, which must be unique among the recorded devices.
+   * @param isensor The sensor.
+   * @return A sensor which passes everything through to the given sensor and records its readings.
+   */
+  std::shared_ptr<ContinuousRotarySensor>
+  recordSensor(const std::string &iname, const std::shared_ptr<ContinuousRotarySensor> &isensor);
+
+  /**
+   * Records the readings of a button.
+   *
+   * @param iname The name of the button, which must be unique among the recorded devices.
+   * @param ibutton The button.
+   * @return A button which passes everything through to the given button and records its readings.
+   */
+  std::shared_ptr<AbstractButton> recordButton(const std::string &iname,
+                                               const std::shared_ptr<AbstractButton> &ibutton);
+
+  /**
+   * Records the readings of any other input, such as a joystick axis.
+   *
+   * @param iname The name of the input, which must be unique among the recorded devices.
+   * @param iinput The input.
+   * @return An input which passes its readings through and records them.
+   */
+  std::shared_ptr<ControllerInput<double>>
+  recordInput(const std::string &iname, const std::shared_ptr<ControllerInput<double>> &iinput);
+
+  protected:
+  std::shared_ptr<TelemetryLogger> telemetry;
+
+  /**
+   * Adds the channel of a device.
+   *
+   * @return The id of the channel.
+   */
+  std::uint16_t addChannel(const std::string &iname);
+};
+} // namespace okapi
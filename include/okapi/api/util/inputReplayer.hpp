@@ -0,0 +1,108 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#pragma once
+
+#include "okapi/api/units/QTime.hpp"
+#include "okapi/api/util/abstractTimer.hpp"
+#include "okapi/api/util/inputRecorder.hpp"
+#include "okapi/api/util/logging.hpp"
+#include <iostream>
+#include <map>
+#include <memory>
+#include <string>
+
+namespace okapi {
+class ReplayedDevice;
+
+/**
+ * Replays the readings an InputRecorder recorded, so code which misbehaved on the robot can be
+ * run again on a host, as many times as needed and as fast as the host allows. Load the telemetry
+ * file, make a device for each recorded device, and hand those to the same code the robot ran,
+ * driving it with a simulated clock such as a SimWorld's.
+ *
+ * Each reading returns the last value recorded at or before the same time into the recording, as
+ * read from the given timer. Time zero is the first recorded reading. The button readings which
+ * report a change return whether the change was recorded since they were last read, so a press is
+ * seen once however often the replayed code polls. Readings which were never recorded return zero.
+ * Commands to the devices do nothing, since the recording already holds how the robot responded.
+ */
+class InputReplayer {
+  public:
+  /**
+   * @param itimer The clock of the replay, which should start at zero.
+   * @param ilogger The logger this instance will log to.
+   */
+  explicit InputReplayer(std::unique_ptr<AbstractTimer> itimer,
+                         const std::shared_ptr<Logger> &ilogger = Logger::getDefaultLogger());
+
+  /**
+   * Reads the recorded devices from a telemetry file. Channels which were not recorded by an
+   * InputRecorder are skipped. Load the file before making any devices.
+   *
+   * @param istream The stream to read from, opened in binary mode.
+   * @return Whether the whole file could be read. A file which was cut off in the middle of a
+   * record is loaded up to that record.
+   */
+  bool load(std::istream &istream);
+
+  /**
+   * @param iname The name the device was recorded with.
+   * @return Whether a device was recorded with the name.
+   */
+  bool hasDevice(const std::string &iname) const;
+
+  /**
+   * Makes a motor which replays a recorded motor, and its encoder if it was recorded. Throws a
+   * `std::invalid_argument` if no device was recorded with the name.
+   *
+   * @param iname The name the motor was recorded with.
+   */
+  std::shared_ptr<AbstractMotor> replayMotor(const std::string &iname);
+
+  /**
+   * Makes a sensor which replays a recorded sensor. Throws a `std::invalid_argument` if no device
+   * was recorded with the name.
+   *
+   * @param iname The name the sensor was recorded with.
+   */
+  std::shared_ptr<ContinuousRotarySensor> replaySensor(const std::string &iname);
+
+  /**
+   * Makes a button which replays a recorded button. Throws a `std::invalid_argument` if no device
+   * was recorded with the name.
+   *
+   * @param iname The name the button was recorded with.
+   */
+  std::shared_ptr<AbstractButton> replayButton(const std::string &iname);
+
+  /**
+   * Makes an input which replays a recorded input. Throws a `std::invalid_argument` if no device
+   * was recorded with the name.
+   *
+   * @param iname The name the input was recorded with.
+   */
+  std::shared_ptr<ControllerInput<double>> replayInput(const std::string &iname);
+
+  /**
+   * @return The time from the first to the last recorded reading. A replay which runs this long
+   * has seen every reading.
+   */
+  QTime getDuration() const;
+
+  protected:
+  std::shared_ptr<Logger> logger;
+  std::shared_ptr<AbstractTimer> timer;
+  std::map<std::string, std::shared_ptr<ReplayedDevice>> devices{};
+  std::uint32_t startTime{0};
+  std::uint32_t endTime{0};
+  bool hasSamples{false};
+
+  /**
+   * @return The recorded device, or throws a `std::invalid_argument` if there is none.
+   */
+  std::shared_ptr<ReplayedDevice> getDevice(const std::string &iname) const;
+};
+} // namespace okapi
@@ -0,0 +1,143 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#pragma once
+
+#include "okapi/api/util/logging.hpp"
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <functional>
+#include <memory>
+
+namespace okapi {
+/**
+ * A response curve for a joystick axis, computed once for every reading the controller can give.
+ * Shaping a reading is then one table lookup, so the curve can be as expensive as it likes.
+ * Readings inside the deadband give `0`, and the rest of the axis is stretched so the curve
+ * starts at `0` right outside the deadband and reaches `1` at full stick. The curve is the same
+ * for both directions of the axis.
+ */
+class JoystickCurve {
+  public:
+  /**
+   * The largest magnitude `controller_get_analog` returns.
+   */
+  static constexpr std::int32_t maxRaw = 127;
+
+  /**
+   * Computes the table for a curve.
+   *
+   * Throws a `std::invalid_argument` if the deadband is not in `[0, 1)`.
+   *
+   * @param icurve Maps the magnitude of the stick outside the deadband, in `[0, 1]`, to the
+   * magnitude of the output, in `[0, 1]`. Outputs outside that range are clamped.
+   * @param ideadband The fraction of the axis around the center which gives `0`.
+   * @param ilogger The logger this instance will log to.
+   */
+  explicit JoystickCurve(const std::function<double(double)> &icurve,
+                         double ideadband = 0,
+                         const std::shared_ptr<Logger> &ilogger = Logger::getDefaultLogger());
+
+  /**
+   * A curve which passes the stick through.
+   *
+   * @param ideadband The fraction of the axis around the center which gives `0`.
+   */
+  static JoystickCurve linear(double ideadband = 0);
+
+  /**
+   * A curve which raises the stick to a power, for finer control at low speeds. An exponent of
+   * `2` or `3` is common.
+   *
+   * Throws a `std::invalid_argument` if the exponent is not positive.
+   *
+   * @param iexponent The power to raise the stick to.
+   * @param ideadband The fraction of the axis around the center which gives `0`.
+   */
+  static JoystickCurve exponential(double iexponent, double ideadband = 0);
+
+  /**
+   * Shapes a reading straight from `controller_get_analog`. Readings past `maxRaw` are clamped.
+   *
+   * @param iraw The reading in the range `[-127, 127]`.
+   * @return The shaped output in the range `[-1, 1]`.
+   */
+  double operator()(const std::int32_t iraw) const {
+    return table[static_cast<std::size_t>(std::clamp(iraw, -maxRaw, maxRaw) + maxRaw)];
+  }
+
+  /**
+   * Shapes a reading from `Controller::getAnalog` or a `ControllerSnapshot`.
+   *
+   * @param ivalue The reading in the range `[-1, 1]`.
+   * @return The shaped output in the range `[-1, 1]`.
+   */
+  double shape(double ivalue) const;
+
+  protected:
+  std::array<float, 2 * maxRaw + 1> table{};
+};
+
+/**
+ * One joystick axis shaped by a JoystickCurve, with a limit on how fast its output can change.
+ * Call `step` once per iteration of the control loop. The output moves toward the shaped reading
+ * like a side of a SlewRateChassisModel: by at most the acceleration step when speeding up and by
+ * at most the deceleration step when slowing down, stopping at zero before it reverses unless the
+ * deceleration step reaches the target at once.
+ */
+class JoystickAxis {
+  public:
+  /**
+   * Throws a `std::invalid_argument` if either step is not positive.
+   *
+   * @param icurve The curve to shape readings with.
+   * @param iaccelStep The largest change per tick of the output speeding up. `1` or more does not
+   * limit it.
+   * @param idecelStep The largest change per tick of the output slowing down. `2` or more does not
+   * limit it.
+   * @param ilogger The logger this instance will log to.
+   */
+  explicit JoystickAxis(JoystickCurve icurve,
+                        double iaccelStep = 2,
+                        double idecelStep = 2,
+                        const std::shared_ptr<Logger> &ilogger = Logger::getDefaultLogger());
+
+  /**
+   * Shapes a reading straight from `controller_get_analog` and steps the output toward it.
+   *
+   * @param iraw The reading in the range `[-127, 127]`.
+   * @return The new output in the range `[-1, 1]`.
+   */
+  double step(std::int32_t iraw);
+
+  /**
+   * Shapes a reading from `Controller::getAnalog` or a `ControllerSnapshot` and steps the output
+   * toward it.
+   *
+   * @param ivalue The reading in the range `[-1, 1]`.
+   * @return The new output in the range `[-1, 1]`.
+   */
+  double step(double ivalue);
+
+  /**
+   * @return The current output.
+   */
+  double getOutput() const;
+
+  /**
+   * Sets the output to `0` at once, for example when the robot is disabled.
+   */
+  void reset();
+
+  protected:
+  JoystickCurve curve;
+  double accelStep;
+  double decelStep;
+  double output{0};
+
+  double stepToward(double itarget);
+};
+} // namespace okapi
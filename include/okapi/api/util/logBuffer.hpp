@@ -0,0 +1,84 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#pragma once
+
+#include "okapi/api/coreProsAPI.hpp"
+#include "okapi/api/util/resourceUsage.hpp"
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <initializer_list>
+#include <memory>
+#include <string_view>
+
+namespace okapi {
+/**
+ * A fixed size, double-buffered block of log lines. Many tasks append lines to one half while one
+ * task writes the other half to a file, so appending only ever waits for a copy, never for the
+ * file. Lines which do not fit in the half being filled are dropped.
+ */
+class LogBuffer {
+  public:
+  /**
+   * @param icapacity The number of bytes each half holds.
+   * @param iflushThreshold The number of buffered bytes at which `append()` asks for the buffer to
+   * be written. This is clamped to the capacity.
+   */
+  explicit LogBuffer(std::size_t icapacity, std::size_t iflushThreshold);
+
+  LogBuffer(const LogBuffer &) = delete;
+  LogBuffer &operator=(const LogBuffer &) = delete;
+
+  /**
+   * Appends one line made of several parts. The parts are copied together, so lines from
+   * different tasks are never interleaved.
+   *
+   * @param iparts The parts of the line.
+   * @param oshouldFlush Set to whether the buffered bytes reached the flush threshold.
+   * @return False if the line did not fit, so it was dropped.
+   */
+  bool append(std::initializer_list<std::string_view> iparts, bool &oshouldFlush) noexcept;
+
+  /**
+   * Writes the buffered lines to a file. This must only be called from one task at a time.
+   *
+   * @param ifile The file.
+   * @return The number of bytes written.
+   */
+  std::size_t writeTo(FILE *ifile) noexcept;
+
+  /**
+   * @return The number of bytes waiting to be written.
+   */
+  std::size_t getBufferedSize() const noexcept;
+
+  /**
+   * @return The number of lines which were dropped because the buffer was full.
+   */
+  std::uint32_t getDroppedCount() const noexcept;
+
+  /**
+   * @return The number of bytes each half holds.
+   */
+  std::size_t getCapacity() const noexcept;
+
+  protected:
+  std::size_t capacity;
+  std::size_t flushThreshold;
+  std::unique_ptr<char[]> storage;
+  HeapAttribution heap;
+  std::atomic_uint32_t droppedCount{0};
+
+  // Guards the half being filled and its size
+  mutable CrossplatformMutex mutex;
+  char *filling;
+  std::size_t size{0};
+
+  // Only touched by writeTo()
+  char *writing;
+};
+} // namespace okapi
@@ -0,0 +1,60 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#pragma once
+
+#include "okapi/api/util/logRecordQueue.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace okapi {
+/**
+ * An in-memory sink for a `Logger`, meant for host tests and benchmarks. Log statements are copied
+ * into a fixed size queue without locking, allocating, or formatting, so turning on debug logging
+ * only costs the copy. The captured statements are formatted when they are taken. Statements are
+ * dropped if the queue is full.
+ */
+class LogCapture : public LogRecordQueue {
+  public:
+  /**
+   * A captured log statement.
+   */
+  struct Line {
+    long time;
+    std::uint8_t level;
+    std::string taskName;
+    std::string message;
+  };
+
+  /**
+   * @param icapacity The number of statements the queue holds. This is rounded up to a power of
+   * two.
+   */
+  explicit LogCapture(std::size_t icapacity = defaultCapacity);
+
+  /**
+   * Removes every captured statement and formats it. This must only be called from one task at a
+   * time.
+   *
+   * @return The captured statements, oldest first.
+   */
+  std::vector<Line> takeLines();
+
+  /**
+   * Removes every captured statement without formatting it, e.g. between benchmark iterations.
+   * This must only be called from one task at a time.
+   *
+   * @return The number of statements which were removed.
+   */
+  std::size_t clear();
+
+  /**
+   * The number of statements the queue holds by default.
+   */
+  static constexpr std::size_t defaultCapacity = 1024;
+};
+} // namespace okapi
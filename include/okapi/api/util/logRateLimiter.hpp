@@ -0,0 +1,90 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#pragma once
+
+#include "okapi/api/units/QTime.hpp"
+#include <atomic>
+#include <cstdint>
+
+namespace okapi {
+/**
+ * Limits how often a log statement is written, so a statement in a control loop which fires on
+ * every step can't flood the log file or slow down the loop. A statement can be limited to a number
+ * of messages per interval, sampled so only every Nth occurrence is logged, or both. The number of
+ * occurrences which were suppressed is reported with the next message which is logged.
+ *
+ * Use it through the `LOG_*_LIMITED` macros, which keep one limiter per call site:
+ *
+ * ```cpp
+ * LOG_WARN_LIMITED(LogRateLimiter::perSecond(1), "Skipping this step.");
+ * ```
+ */
+class LogRateLimiter {
+  public:
+  /**
+   * Logs at most `imaxCount` messages per interval.
+   *
+   * @param imaxCount The most messages to log per interval.
+   * @param iinterval The length of the interval.
+   * @return The limiter.
+   */
+  static LogRateLimiter perInterval(std::uint32_t imaxCount, QTime iinterval);
+
+  /**
+   * Logs at most `imaxCount` messages per second.
+   *
+   * @param imaxCount The most messages to log per second.
+   * @return The limiter.
+   */
+  static LogRateLimiter perSecond(std::uint32_t imaxCount);
+
+  /**
+   * Logs the first occurrence and every `in`th occurrence after it.
+   *
+   * @param in The sampling period, in occurrences.
+   * @return The limiter.
+   */
+  static LogRateLimiter everyNth(std::uint32_t in);
+
+  /**
+   * Logs every `in`th occurrence, and at most `imaxCount` of those per interval.
+   *
+   * @param in The sampling period, in occurrences.
+   * @param imaxCount The most messages to log per interval, or `0` for no limit.
+   * @param iinterval The length of the interval.
+   */
+  LogRateLimiter(std::uint32_t in, std::uint32_t imaxCount, QTime iinterval) noexcept;
+
+  LogRateLimiter(const LogRateLimiter &) = delete;
+  LogRateLimiter &operator=(const LogRateLimiter &) = delete;
+
+  /**
+   * Counts an occurrence and returns whether it should be logged. This is safe to call from
+   * multiple tasks and does not block.
+   *
+   * @param inow The current time.
+   * @param osuppressed Set to the number of occurrences suppressed since the last logged one, if
+   * this one should be logged.
+   * @return Whether this occurrence should be logged.
+   */
+  bool tryAcquire(QTime inow, std::uint32_t &osuppressed) noexcept;
+
+  /**
+   * @return The number of occurrences suppressed since the last logged one.
+   */
+  std::uint32_t getSuppressedCount() const noexcept;
+
+  protected:
+  const std::uint32_t sampleEvery;
+  const std::uint32_t maxCount;
+  const std::uint32_t intervalMs;
+
+  std::atomic_uint32_t occurrences{0};
+  std::atomic_uint32_t windowStart{0};
+  std::atomic_uint32_t windowCount{0};
+  std::atomic_uint32_t suppressed{0};
+};
+} // namespace okapi
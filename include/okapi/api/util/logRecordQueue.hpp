@@ -0,0 +1,200 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#pragma once
+
+#include "okapi/api/util/resourceUsage.hpp"
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <type_traits>
+
+namespace okapi {
+/**
+ * An argument of a format-string log statement, captured without formatting it. Strings are only
+ * referenced until the statement is queued, when they are copied.
+ */
+struct LogArg {
+  enum class Type : std::uint8_t { signedInteger, unsignedInteger, floatingPoint, string, pointer };
+
+  Type type{Type::signedInteger};
+  union {
+    long long i;
+    unsigned long long u;
+    double d;
+    const char *s;
+    const void *p;
+  } value{0};
+
+  LogArg() = default;
+
+  template <typename T> LogArg(const T &iarg) noexcept { // NOLINT(google-explicit-constructor)
+    if constexpr (std::is_convertible_v<const T &, const char *>) {
+      type = Type::string;
+      value.s = iarg;
+    } else if constexpr (std::is_same_v<T, std::string>) {
+      type = Type::string;
+      value.s = iarg.c_str();
+    } else if constexpr (std::is_floating_point_v<T>) {
+      type = Type::floatingPoint;
+      value.d = static_cast<double>(iarg);
+    } else if constexpr (std::is_enum_v<T>) {
+      type = Type::signedInteger;
+      value.i = static_cast<long long>(iarg);
+    } else if constexpr (std::is_integral_v<T> && std::is_unsigned_v<T>) {
+      type = Type::unsignedInteger;
+      value.u = static_cast<unsigned long long>(iarg);
+    } else if constexpr (std::is_integral_v<T>) {
+      type = Type::signedInteger;
+      value.i = static_cast<long long>(iarg);
+    } else {
+      static_assert(std::is_pointer_v<T>, "Log arguments must be numbers, strings, or pointers.");
+      type = Type::pointer;
+      value.p = static_cast<const void *>(iarg);
+    }
+  }
+};
+
+/**
+ * A log statement which has not been written yet. Messages longer than `maxMessageLength` are
+ * truncated.
+ */
+struct LogRecord {
+  static constexpr std::size_t maxTaskNameLength = 31;
+  static constexpr std::size_t maxMessageLength = 159;
+  static constexpr std::size_t maxArgs = 6;
+
+  /**
+   * The longest message a format-string log statement is formatted into.
+   */
+  static constexpr std::size_t maxFormattedLength = 255;
+
+  long time{0};
+  std::uint8_t level{0};
+  char taskName[maxTaskNameLength + 1]{};
+
+  // For a format-string log statement, the message holds the string arguments, whose values
+  // are offsets into it
+  char message[maxMessageLength + 1]{};
+  const char *format{nullptr};
+  std::uint8_t argCount{0};
+  LogArg args[maxArgs]{};
+
+  /**
+   * Makes this a format-string log statement which is formatted when it is written. String
+   * arguments are copied into the record. Arguments after the first `maxArgs` are ignored.
+   *
+   * @param iformat The printf-style format. This must outlive the record, like a string literal.
+   * @param iargs The arguments.
+   * @param iargCount The number of arguments.
+   */
+  void setFormat(const char *iformat, const LogArg *iargs, std::size_t iargCount) noexcept;
+
+  /**
+   * Writes the message of this record. Format-string log statements are formatted with the
+   * length modifiers in the format replaced by ones which match the captured arguments, so the
+   * format doesn't need to match the argument types exactly.
+   *
+   * @param obuffer The message is written to this.
+   * @param isize The size of the buffer.
+   */
+  void formatMessage(char *obuffer, std::size_t isize) const noexcept;
+};
+
+/**
+ * A fixed size queue of log records which many tasks can push to and one task pops from. Pushing
+ * and popping never block or allocate. When the queue is full, new records are dropped.
+ */
+class LogRecordQueue {
+  public:
+  /**
+   * @param icapacity The number of records the queue holds. This is rounded up to a power of two.
+   */
+  explicit LogRecordQueue(std::size_t icapacity);
+
+  LogRecordQueue(const LogRecordQueue &) = delete;
+  LogRecordQueue &operator=(const LogRecordQueue &) = delete;
+
+  /**
+   * Adds a record to the queue.
+   *
+   * @param itime The time of the log statement in milliseconds.
+   * @param ilevel The level of the log statement.
+   * @param itaskName The name of the task which made the log statement.
+   * @param imessage The message.
+   * @return False if the queue was full, so the record was dropped.
+   */
+  bool tryPush(long itime, std::uint8_t ilevel, const char *itaskName, std::string_view imessage);
+
+  /**
+   * Adds a format-string record to the queue. See `LogRecord::setFormat`.
+   *
+   * @param itime The time of the log statement in milliseconds.
+   * @param ilevel The level of the log statement.
+   * @param itaskName The name of the task which made the log statement.
+   * @param iformat The printf-style format. This must outlive the record, like a string literal.
+   * @param iargs The arguments.
+   * @param iargCount The number of arguments.
+   * @return False if the queue was full, so the record was dropped.
+   */
+  bool tryPushFormat(long itime,
+                     std::uint8_t ilevel,
+                     const char *itaskName,
+                     const char *iformat,
+                     const LogArg *iargs,
+                     std::size_t iargCount);
+
+  /**
+   * Removes the oldest record from the queue. This must only be called from one task at a time.
+   *
+   * @param orecord The record is written to this.
+   * @return False if the queue was empty.
+   */
+  bool tryPop(LogRecord &orecord);
+
+  /**
+   * @return The number of records which were dropped because the queue was full.
+   */
+  std::uint32_t getDroppedCount() const;
+
+  /**
+   * @return The number of records the queue holds.
+   */
+  std::size_t getCapacity() const;
+
+  protected:
+  // Each cell's sequence number says whether it is free for the push with the same position or
+  // holds the record for the pop with that position plus one
+  struct Cell {
+    std::atomic_size_t sequence{0};
+    LogRecord record{};
+  };
+
+  std::size_t capacity;
+  std::unique_ptr<Cell[]> cells;
+  HeapAttribution heap;
+  std::atomic_size_t pushPosition{0};
+  std::atomic_size_t popPosition{0};
+  std::atomic_uint32_t droppedCount{0};
+
+  /**
+   * Claims the next free cell.
+   *
+   * @param oposition The position of the cell, used to publish it.
+   * @return The cell, or nullptr if the queue was full.
+   */
+  Cell *claimCell(std::size_t &oposition);
+
+  /**
+   * Makes a claimed cell available to pop.
+   */
+  void publishCell(Cell &icell, std::size_t iposition);
+
+  static void setHeader(LogRecord &orecord, long itime, std::uint8_t ilevel, const char *itaskName);
+};
+} // namespace okapi
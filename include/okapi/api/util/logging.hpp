@@ -7,19 +7,95 @@
 
 #include "okapi/api/coreProsAPI.hpp"
 #include "okapi/api/util/abstractTimer.hpp"
+#include "okapi/api/util/logBuffer.hpp"
+#include "okapi/api/util/logCapture.hpp"
+#include "okapi/api/util/logRateLimiter.hpp"
+#include "okapi/api/util/logRecordQueue.hpp"
 #include "okapi/api/util/mathUtil.hpp"
+#include <atomic>
+#include <initializer_list>
 #include <memory>
 #include <mutex>
+#include <string>
 
 #if defined(THREADS_STD)
 #else
 #include "okapi/impl/util/timer.hpp"
 #endif
 
-#define LOG_DEBUG(msg) logger->debug([=]() { return msg; })
-#define LOG_INFO(msg) logger->info([=]() { return msg; })
-#define LOG_WARN(msg) logger->warn([=]() { return msg; })
-#define LOG_ERROR(msg) logger->error([=]() { return msg; })
+/**
+ * The most verbose log level which is compiled in, using the values of `Logger::LogLevel`. Log
+ * statements which are more verbose than this are removed at compile time, so they cost nothing
+ * even in the inner loops. Set it with a `-D`, e.g. `-DOKAPI_COMPILED_LOG_LEVEL=2` to only keep
+ * warnings and errors. By default, every level is compiled in.
+ */
+#ifndef OKAPI_COMPILED_LOG_LEVEL
+#define OKAPI_COMPILED_LOG_LEVEL 4
+#endif
+
+// LOG_*_F are format-string log statements, e.g. LOG_DEBUG_F("moving %f ticks", x). The arguments
+// are captured without allocating and formatted when the statement is written.
+#define OKAPI_LOG_DEBUG(msg) logger->debug([=]() { return msg; })
+#define OKAPI_LOG_INFO(msg) logger->info([=]() { return msg; })
+#define OKAPI_LOG_WARN(msg) logger->warn([=]() { return msg; })
+#define OKAPI_LOG_ERROR(msg) logger->error([=]() { return msg; })
+
+// LOG_*_LIMITED are log statements limited by a LogRateLimiter, e.g.
+// LOG_WARN_LIMITED(LogRateLimiter::perSecond(1), msg). Each call site keeps its own limiter.
+#define OKAPI_LOG_LIMITED(level, ilimiter, msg)                                                    \
+  do {                                                                                             \
+    static ::okapi::LogRateLimiter okapiLogRateLimiter = ilimiter;                                 \
+    logger->level(okapiLogRateLimiter, [=]() { return msg; });                                     \
+  } while (false)
+
+// A removed log statement is still type checked, and the variables it uses still count as used,
+// but no code is generated for it
+#define OKAPI_LOG_REMOVED(statement)                                                               \
+  do {                                                                                             \
+    if constexpr (false) {                                                                         \
+      statement;                                                                                   \
+    }                                                                                              \
+  } while (false)
+
+#if OKAPI_COMPILED_LOG_LEVEL >= 4
+#define LOG_DEBUG(msg) OKAPI_LOG_DEBUG(msg)
+#define LOG_DEBUG_F(...) logger->debugf(__VA_ARGS__)
+#define LOG_DEBUG_LIMITED(ilimiter, msg) OKAPI_LOG_LIMITED(debug, ilimiter, msg)
+#else
+#define LOG_DEBUG(msg) OKAPI_LOG_REMOVED(OKAPI_LOG_DEBUG(msg))
+#define LOG_DEBUG_F(...) OKAPI_LOG_REMOVED(logger->debugf(__VA_ARGS__))
+#define LOG_DEBUG_LIMITED(ilimiter, msg) OKAPI_LOG_REMOVED(OKAPI_LOG_DEBUG(msg))
+#endif
+
+#if OKAPI_COMPILED_LOG_LEVEL >= 3
+#define LOG_INFO(msg) OKAPI_LOG_INFO(msg)
+#define LOG_INFO_F(...) logger->infof(__VA_ARGS__)
+#define LOG_INFO_LIMITED(ilimiter, msg) OKAPI_LOG_LIMITED(info, ilimiter, msg)
+#else
+#define LOG_INFO(msg) OKAPI_LOG_REMOVED(OKAPI_LOG_INFO(msg))
+#define LOG_INFO_F(...) OKAPI_LOG_REMOVED(logger->infof(__VA_ARGS__))
+#define LOG_INFO_LIMITED(ilimiter, msg) OKAPI_LOG_REMOVED(OKAPI_LOG_INFO(msg))
+#endif
+
+#if OKAPI_COMPILED_LOG_LEVEL >= 2
+#define LOG_WARN(msg) OKAPI_LOG_WARN(msg)
+#define LOG_WARN_F(...) logger->warnf(__VA_ARGS__)
+#define LOG_WARN_LIMITED(ilimiter, msg) OKAPI_LOG_LIMITED(warn, ilimiter, msg)
+#else
+#define LOG_WARN(msg) OKAPI_LOG_REMOVED(OKAPI_LOG_WARN(msg))
+#define LOG_WARN_F(...) OKAPI_LOG_REMOVED(logger->warnf(__VA_ARGS__))
+#define LOG_WARN_LIMITED(ilimiter, msg) OKAPI_LOG_REMOVED(OKAPI_LOG_WARN(msg))
+#endif
+
+#if OKAPI_COMPILED_LOG_LEVEL >= 1
+#define LOG_ERROR(msg) OKAPI_LOG_ERROR(msg)
+#define LOG_ERROR_F(...) logger->errorf(__VA_ARGS__)
+#define LOG_ERROR_LIMITED(ilimiter, msg) OKAPI_LOG_LIMITED(error, ilimiter, msg)
+#else
+#define LOG_ERROR(msg) OKAPI_LOG_REMOVED(OKAPI_LOG_ERROR(msg))
+#define LOG_ERROR_F(...) OKAPI_LOG_REMOVED(logger->errorf(__VA_ARGS__))
+#define LOG_ERROR_LIMITED(ilimiter, msg) OKAPI_LOG_REMOVED(OKAPI_LOG_ERROR(msg))
+#endif
 
 #define LOG_DEBUG_S(msg) LOG_DEBUG(std::string(msg))
 #define LOG_INFO_S(msg) LOG_INFO(std::string(msg))
@@ -65,86 +141,209 @@ class Logger {
    */
   Logger(std::unique_ptr<AbstractTimer> itimer, FILE *ifile, const LogLevel &ilevel) noexcept;
 
+  /**
+   * A logger that writes to an in-memory capture instead of a file, for host tests and benchmarks.
+   * Log statements are copied into the capture without locking or formatting.
+   *
+   * @param itimer A timer used to get the current time for log statements.
+   * @param icapture The capture to write to.
+   * @param ilevel The log level. Log statements more verbose than this level will be disabled.
+   */
+  Logger(std::unique_ptr<AbstractTimer> itimer,
+         std::shared_ptr<LogCapture> icapture,
+         const LogLevel &ilevel) noexcept;
+
   ~Logger();
 
   constexpr bool isDebugLevelEnabled() const noexcept {
-    return toUnderlyingType(logLevel) >= toUnderlyingType(LogLevel::debug);
+    return OKAPI_COMPILED_LOG_LEVEL >= 4 &&
+           toUnderlyingType(logLevel) >= toUnderlyingType(LogLevel::debug);
   }
 
   template <typename T> void debug(T ilazyMessage) noexcept {
-    if (isDebugLevelEnabled() && logfile && timer) {
-      std::scoped_lock lock(logfileMutex);
-      fprintf(logfile,
-              "%ld (%s) DEBUG: %s\n",
-              static_cast<long>(timer->millis().convert(millisecond)),
-              CrossplatformThread::getName().c_str(),
-              ilazyMessage().c_str());
+    if (isDebugLevelEnabled() && writable()) {
+      write(LogLevel::debug, ilazyMessage());
+    }
+  }
+
+  template <typename T> void debug(LogRateLimiter &ilimiter, T ilazyMessage) noexcept {
+    if (isDebugLevelEnabled() && writable()) {
+      writeLimited(LogLevel::debug, ilimiter, ilazyMessage);
+    }
+  }
+
+  template <typename... Args> void debugf(const char *iformat, const Args &...iargs) noexcept {
+    if (isDebugLevelEnabled() && writable()) {
+      writeFormat(LogLevel::debug, iformat, {LogArg(iargs)...});
     }
   }
 
   constexpr bool isInfoLevelEnabled() const noexcept {
-    return toUnderlyingType(logLevel) >= toUnderlyingType(LogLevel::info);
+    return OKAPI_COMPILED_LOG_LEVEL >= 3 &&
+           toUnderlyingType(logLevel) >= toUnderlyingType(LogLevel::info);
   }
 
   template <typename T> void info(T ilazyMessage) noexcept {
-    if (isInfoLevelEnabled() && logfile && timer) {
-      std::scoped_lock lock(logfileMutex);
-      fprintf(logfile,
-              "%ld (%s) INFO: %s\n",
-              static_cast<long>(timer->millis().convert(millisecond)),
-              CrossplatformThread::getName().c_str(),
-              ilazyMessage().c_str());
+    if (isInfoLevelEnabled() && writable()) {
+      write(LogLevel::info, ilazyMessage());
+    }
+  }
+
+  template <typename T> void info(LogRateLimiter &ilimiter, T ilazyMessage) noexcept {
+    if (isInfoLevelEnabled() && writable()) {
+      writeLimited(LogLevel::info, ilimiter, ilazyMessage);
+    }
+  }
+
+  template <typename... Args> void infof(const char *iformat, const Args &...iargs) noexcept {
+    if (isInfoLevelEnabled() && writable()) {
+      writeFormat(LogLevel::info, iformat, {LogArg(iargs)...});
     }
   }
 
   constexpr bool isWarnLevelEnabled() const noexcept {
-    return toUnderlyingType(logLevel) >= toUnderlyingType(LogLevel::warn);
+    return OKAPI_COMPILED_LOG_LEVEL >= 2 &&
+           toUnderlyingType(logLevel) >= toUnderlyingType(LogLevel::warn);
   }
 
   template <typename T> void warn(T ilazyMessage) noexcept {
-    if (isWarnLevelEnabled() && logfile && timer) {
-      std::scoped_lock lock(logfileMutex);
-      fprintf(logfile,
-              "%ld (%s) WARN: %s\n",
-              static_cast<long>(timer->millis().convert(millisecond)),
-              CrossplatformThread::getName().c_str(),
-              ilazyMessage().c_str());
+    if (isWarnLevelEnabled() && writable()) {
+      write(LogLevel::warn, ilazyMessage());
+    }
+  }
+
+  template <typename T> void warn(LogRateLimiter &ilimiter, T ilazyMessage) noexcept {
+    if (isWarnLevelEnabled() && writable()) {
+      writeLimited(LogLevel::warn, ilimiter, ilazyMessage);
+    }
+  }
+
+  template <typename... Args> void warnf(const char *iformat, const Args &...iargs) noexcept {
+    if (isWarnLevelEnabled() && writable()) {
+      writeFormat(LogLevel::warn, iformat, {LogArg(iargs)...});
     }
   }
 
   constexpr bool isErrorLevelEnabled() const noexcept {
-    return toUnderlyingType(logLevel) >= toUnderlyingType(LogLevel::error);
+    return OKAPI_COMPILED_LOG_LEVEL >= 1 &&
+           toUnderlyingType(logLevel) >= toUnderlyingType(LogLevel::error);
   }
 
   template <typename T> void error(T ilazyMessage) noexcept {
-    if (isErrorLevelEnabled() && logfile && timer) {
-      std::scoped_lock lock(logfileMutex);
-      fprintf(logfile,
-              "%ld (%s) ERROR: %s\n",
-              static_cast<long>(timer->millis().convert(millisecond)),
-              CrossplatformThread::getName().c_str(),
-              ilazyMessage().c_str());
+    if (isErrorLevelEnabled() && writable()) {
+      write(LogLevel::error, ilazyMessage());
     }
   }
 
-  /**
-   * Closes the connection to the log file.
-   */
-  constexpr void close() noexcept {
-    if (logfile) {
-      fclose(logfile);
-      logfile = nullptr;
+  template <typename T> void error(LogRateLimiter &ilimiter, T ilazyMessage) noexcept {
+    if (isErrorLevelEnabled() && writable()) {
+      writeLimited(LogLevel::error, ilimiter, ilazyMessage);
+    }
+  }
+
+  template <typename... Args> void errorf(const char *iformat, const Args &...iargs) noexcept {
+    if (isErrorLevelEnabled() && writable()) {
+      writeFormat(LogLevel::error, iformat, {LogArg(iargs)...});
     }
   }
 
   /**
+   * Closes the connection to the log file or capture. Records which are still queued by an
+   * asynchronous logger or buffered by a buffered logger are written first.
+   */
+  void close() noexcept;
+
+  /**
+   * Makes log statements asynchronous. Instead of writing to the log file from the task which
+   * logs, each statement is copied into a fixed size queue without blocking, and a drain task
+   * writes the queued statements to the log file. Statements are dropped if the queue is full. Call
+   * this before the logger is used from more than one task.
+   *
+   * @param icapacity The number of statements the queue holds. This is rounded up to a power of
+   * two.
+   * @param ipriority The priority of the drain task. This should be lower than the control tasks.
+   * @param istackDepth The stack depth of the drain task in words.
+   */
+  void startAsync(std::size_t icapacity = defaultAsyncCapacity,
+                  std::uint32_t ipriority = TASK_PRIORITY_MIN,
+                  std::uint16_t istackDepth = TASK_STACK_DEPTH_DEFAULT);
+
+  /**
+   * @return Whether log statements are asynchronous.
+   */
+  bool isAsync() const noexcept;
+
+  /**
+   * @return The number of asynchronous, buffered, or captured log statements which were dropped
+   * because the queue or buffer was full.
+   */
+  std::uint32_t getDroppedCount() const noexcept;
+
+  /**
+   * Buffers the log file. Instead of writing each statement to the log file, which waits for the
+   * SD card, statements are copied into a fixed size buffer and a flush task writes the buffer to
+   * the log file every flush period, or sooner once the buffer is half full. Logging only waits for
+   * the copy, so its latency is bounded. Statements are dropped if the buffer is full. Call this
+   * before the logger is used from more than one task. This can be combined with `startAsync()`,
+   * in which case the drain task fills the buffer.
+   *
+   * Buffered statements are lost if the brain loses power, so call `flush()` from `disabled()`.
+   *
+   * @param ibufferSize The number of bytes the buffer holds.
+   * @param iflushPeriod The longest time in ms a statement waits in the buffer.
+   * @param ipriority The priority of the flush task. This should be lower than the control tasks.
+   * @param istackDepth The stack depth of the flush task in words.
+   */
+  void startBuffered(std::size_t ibufferSize = defaultBufferSize,
+                     std::uint32_t iflushPeriod = defaultFlushPeriod,
+                     std::uint32_t ipriority = TASK_PRIORITY_MIN,
+                     std::uint16_t istackDepth = TASK_STACK_DEPTH_DEFAULT);
+
+  /**
+   * @return Whether the log file is buffered.
+   */
+  bool isBuffered() const noexcept;
+
+  /**
+   * Writes the buffered statements of a buffered logger to the log file and flushes it. This waits
+   * for the SD card, so call it when the robot is not moving, such as from `disabled()`. Statements
+   * still queued by an asynchronous logger are written by its drain task.
+   */
+  void flush() noexcept;
+
+  /**
+   * The number of statements the queue of an asynchronous logger holds by default.
+   */
+  static constexpr std::size_t defaultAsyncCapacity = 64;
+
+  /**
+   * The longest time the drain task of an asynchronous logger waits before writing the queued
+   * statements.
+   */
+  static constexpr std::uint32_t drainLoopTimeout = 10;
+
+  /**
+   * The number of bytes the buffer of a buffered logger holds by default.
+   */
+  static constexpr std::size_t defaultBufferSize = 16384;
+
+  /**
+   * The longest time in ms a statement waits in the buffer of a buffered logger by default.
+   */
+  static constexpr std::uint32_t defaultFlushPeriod = 500;
+
+  /**
+   * The default logger is made on the first call, unless a logger was set with
+   * `setDefaultLogger()` first, so programs which never log or which replace the default logger
+   * never open `/ser/sout`.
+   *
    * @return The default logger.
    */
   static std::shared_ptr<Logger> getDefaultLogger();
 
   /**
    * Sets a new default logger. OkapiLib classes use the default logger unless given another logger
-   * in their constructor.
+   * in their constructor. Call this before the OkapiLib classes which should use it are made.
    *
    * @param ilogger The new logger instance.
    */
@@ -155,38 +354,55 @@ class Logger {
   const LogLevel logLevel;
   FILE *logfile;
   CrossplatformMutex logfileMutex;
+  std::shared_ptr<LogCapture> capture{nullptr};
 
-  static bool isSerialStream(std::string_view filename);
-};
+  std::unique_ptr<LogRecordQueue> asyncQueue{nullptr};
+  std::atomic_bool stopDraining{false};
+  std::atomic_bool drainStopped{false};
+  CrossplatformThread *drainTask{nullptr};
 
-extern std::shared_ptr<Logger> defaultLogger;
+  std::unique_ptr<LogBuffer> buffer{nullptr};
+  std::uint32_t flushPeriod{defaultFlushPeriod};
+  std::atomic_bool stopFlushing{false};
+  std::atomic_bool flushStopped{false};
+  CrossplatformThread *flushTask{nullptr};
 
-struct DefaultLoggerInitializer {
-  DefaultLoggerInitializer() {
-    if (count++ == 0) {
-      init();
-    }
-  }
-  ~DefaultLoggerInitializer() {
-    if (--count == 0) {
-      cleanup();
-    }
+  bool writable() const noexcept {
+    return timer && (logfile || capture);
   }
 
-  static int count;
+  void write(LogLevel ilevel, const std::string &imessage) noexcept;
+  void writeFormat(LogLevel ilevel,
+                   const char *iformat,
+                   std::initializer_list<LogArg> iargs) noexcept;
+  void writeLine(long itime,
+                 const char *itaskName,
+                 LogLevel ilevel,
+                 const char *imessage) noexcept;
+  void stopAsync() noexcept;
+  void stopBuffered() noexcept;
 
-  static void init() {
-#if defined(THREADS_STD)
-    defaultLogger = std::make_shared<Logger>();
-#else
-    defaultLogger =
-      std::make_shared<Logger>(std::make_unique<Timer>(), "/ser/sout", Logger::LogLevel::warn);
-#endif
-  }
+  template <typename T>
+  void writeLimited(const LogLevel ilevel, LogRateLimiter &ilimiter, T ilazyMessage) noexcept {
+    std::uint32_t suppressed;
+    if (!ilimiter.tryAcquire(timer->millis(), suppressed)) {
+      return;
+    }
 
-  static void cleanup() {
+    if (suppressed > 0) {
+      write(ilevel,
+            ilazyMessage() + " (suppressed " + std::to_string(suppressed) + " similar messages)");
+    } else {
+      write(ilevel, ilazyMessage());
+    }
   }
-};
 
-static DefaultLoggerInitializer defaultLoggerInitializer; // NOLINT(cert-err58-cpp)
+  void drainLoop();
+  static void drainTrampoline(void *context);
+  void flushLoop();
+  static void flushTrampoline(void *context);
+  static const char *getLevelName(LogLevel ilevel) noexcept;
+  static bool isSerialStream(std::string_view filename);
+  static std::shared_ptr<Logger> makeDefaultLogger();
+};
 } // namespace okapi
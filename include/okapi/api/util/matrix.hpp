@@ -0,0 +1,214 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <initializer_list>
+
+namespace okapi {
+/**
+ * A fixed size matrix of doubles. The values are stored in row-major order inside the object, so
+ * a matrix never allocates and can live on the stack. Meant for the small matrices of filters and
+ * estimators, not for large linear algebra.
+ */
+template <std::size_t rows, std::size_t cols> class Matrix {
+  public:
+  static_assert(rows > 0 && cols > 0, "A Matrix must have at least one row and one column.");
+
+  /**
+   * A matrix of zeros.
+   */
+  Matrix() = default;
+
+  /**
+   * A matrix with the given values in row-major order. Missing values are zero.
+   *
+   * @param ivalues The values.
+   */
+  Matrix(std::initializer_list<double> ivalues) {
+    std::copy_n(ivalues.begin(), std::min(ivalues.size(), rows * cols), values.begin());
+  }
+
+  /**
+   * @return An identity matrix.
+   */
+  static Matrix identity() {
+    static_assert(rows == cols, "Only a square Matrix has an identity.");
+    Matrix out;
+    for (std::size_t i = 0; i < rows; i++) {
+      out(i, i) = 1;
+    }
+    return out;
+  }
+
+  /**
+   * @return The number of rows.
+   */
+  static constexpr std::size_t getRows() {
+    return rows;
+  }
+
+  /**
+   * @return The number of columns.
+   */
+  static constexpr std::size_t getCols() {
+    return cols;
+  }
+
+  double &operator()(const std::size_t irow, const std::size_t icol) {
+    return values[irow * cols + icol];
+  }
+
+  double operator()(const std::size_t irow, const std::size_t icol) const {
+    return values[irow * cols + icol];
+  }
+
+  /**
+   * @return The transpose of this matrix.
+   */
+  Matrix<cols, rows> transpose() const {
+    Matrix<cols, rows> out;
+    for (std::size_t r = 0; r < rows; r++) {
+      for (std::size_t c = 0; c < cols; c++) {
+        out(c, r) = (*this)(r, c);
+      }
+    }
+    return out;
+  }
+
+  /**
+   * Inverts this matrix with Gauss-Jordan elimination.
+   *
+   * @param oinverse Set to the inverse if this matrix can be inverted.
+   * @return False if this matrix is singular.
+   */
+  bool inverse(Matrix &oinverse) const {
+    static_assert(rows == cols, "Only a square Matrix can be inverted.");
+    Matrix work = *this;
+    Matrix out = identity();
+
+    for (std::size_t c = 0; c < cols; c++) {
+      // Pivot on the largest value in the column so small values don't blow up the result
+      std::size_t pivot = c;
+      for (std::size_t r = c + 1; r < rows; r++) {
+        if (std::abs(work(r, c)) > std::abs(work(pivot, c))) {
+          pivot = r;
+        }
+      }
+
+      if (std::abs(work(pivot, c)) < singularTolerance) {
+        return false;
+      }
+
+      if (pivot != c) {
+        for (std::size_t i = 0; i < cols; i++) {
+          std::swap(work(c, i), work(pivot, i));
+          std::swap(out(c, i), out(pivot, i));
+        }
+      }
+
+      const double scale = 1.0 / work(c, c);
+      for (std::size_t i = 0; i < cols; i++) {
+        work(c, i) *= scale;
+        out(c, i) *= scale;
+      }
+
+      for (std::size_t r = 0; r < rows; r++) {
+        const double factor = work(r, c);
+        if (r == c || factor == 0) {
+          continue;
+        }
+
+        for (std::size_t i = 0; i < cols; i++) {
+          work(r, i) -= factor * work(c, i);
+          out(r, i) -= factor * out(c, i);
+        }
+      }
+    }
+
+    oinverse = out;
+    return true;
+  }
+
+  Matrix &operator+=(const Matrix &irhs) {
+    for (std::size_t i = 0; i < rows * cols; i++) {
+      values[i] += irhs.values[i];
+    }
+    return *this;
+  }
+
+  Matrix &operator-=(const Matrix &irhs) {
+    for (std::size_t i = 0; i < rows * cols; i++) {
+      values[i] -= irhs.values[i];
+    }
+    return *this;
+  }
+
+  Matrix &operator*=(const double iscalar) {
+    for (auto &value : values) {
+      value *= iscalar;
+    }
+    return *this;
+  }
+
+  bool operator==(const Matrix &irhs) const {
+    return values == irhs.values;
+  }
+
+  bool operator!=(const Matrix &irhs) const {
+    return values != irhs.values;
+  }
+
+  protected:
+  /**
+   * Pivots smaller than this are treated as zero when inverting.
+   */
+  static constexpr double singularTolerance = 1e-12;
+
+  std::array<double, rows * cols> values{};
+};
+
+template <std::size_t rows, std::size_t cols>
+Matrix<rows, cols> operator+(Matrix<rows, cols> ilhs, const Matrix<rows, cols> &irhs) {
+  return ilhs += irhs;
+}
+
+template <std::size_t rows, std::size_t cols>
+Matrix<rows, cols> operator-(Matrix<rows, cols> ilhs, const Matrix<rows, cols> &irhs) {
+  return ilhs -= irhs;
+}
+
+template <std::size_t rows, std::size_t cols>
+Matrix<rows, cols> operator*(Matrix<rows, cols> ilhs, const double irhs) {
+  return ilhs *= irhs;
+}
+
+template <std::size_t rows, std::size_t cols>
+Matrix<rows, cols> operator*(const double ilhs, Matrix<rows, cols> irhs) {
+  return irhs *= ilhs;
+}
+
+template <std::size_t rows, std::size_t inner, std::size_t cols>
+Matrix<rows, cols> operator*(const Matrix<rows, inner> &ilhs, const Matrix<inner, cols> &irhs) {
+  Matrix<rows, cols> out;
+  for (std::size_t r = 0; r < rows; r++) {
+    for (std::size_t i = 0; i < inner; i++) {
+      const double lhs = ilhs(r, i);
+      if (lhs == 0) {
+        continue;
+      }
+
+      for (std::size_t c = 0; c < cols; c++) {
+        out(r, c) += lhs * irhs(i, c);
+      }
+    }
+  }
+  return out;
+}
+} // namespace okapi
@@ -0,0 +1,134 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#pragma once
+
+#include "okapi/api/coreProsAPI.hpp"
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+namespace okapi {
+class Logger;
+
+/**
+ * The parts of okapi whose heap memory is counted.
+ */
+enum class HeapSubsystem : std::uint8_t {
+  paths,   ///< Motion profile paths stored in a PathPool, including the pooled buffers
+  logging, ///< The record queues and buffers of loggers
+  filters  ///< The buffers of filters whose size is picked at runtime
+};
+
+/**
+ * The heap memory counted for one subsystem. Byte counts are approximate.
+ */
+struct HeapUsage {
+  std::size_t bytes{0};     ///< The memory the subsystem holds now
+  std::size_t peakBytes{0}; ///< The most memory the subsystem has held at once
+};
+
+/**
+ * Reports the memory okapi uses: the heap memory of each subsystem and the stack of each task
+ * okapi started. Running out of either on the brain fails silently, so use these to size stacks
+ * and memory budgets. Counting heap memory uses atomics only, so it never blocks or allocates.
+ */
+class ResourceUsage {
+  public:
+  static constexpr std::size_t subsystemCount = 3;
+
+  /**
+   * Counts memory a subsystem allocated.
+   *
+   * @param isubsystem The subsystem.
+   * @param ibytes The size of the allocation.
+   */
+  static void allocated(HeapSubsystem isubsystem, std::size_t ibytes);
+
+  /**
+   * Counts memory a subsystem freed.
+   *
+   * @param isubsystem The subsystem.
+   * @param ibytes The size of the allocation.
+   */
+  static void freed(HeapSubsystem isubsystem, std::size_t ibytes);
+
+  /**
+   * @param isubsystem The subsystem.
+   * @return The heap memory counted for the subsystem.
+   */
+  static HeapUsage getHeapUsage(HeapSubsystem isubsystem);
+
+  /**
+   * Sets the peak of each subsystem to the memory it holds now, to measure the peak of one part of
+   * a program.
+   */
+  static void resetPeaks();
+
+  /**
+   * Gets the stack of every task okapi started which is still running. See
+   * `CrossplatformThread::getStats()`.
+   *
+   * @param ostats The stacks are written here.
+   * @return The number of tasks.
+   */
+  static std::size_t getTaskStats(
+    std::array<CrossplatformThreadStats, CrossplatformThread::maxTrackedThreads> &ostats);
+
+  /**
+   * Logs the heap memory of each subsystem and the stack of each task at the info level.
+   *
+   * @param ilogger The logger to log to.
+   */
+  static void logReport(const std::shared_ptr<Logger> &ilogger);
+
+  /**
+   * @return The name of the subsystem.
+   */
+  static const char *getName(HeapSubsystem isubsystem);
+
+  protected:
+  static std::array<std::atomic_size_t, subsystemCount> bytes;
+  static std::array<std::atomic_size_t, subsystemCount> peakBytes;
+};
+
+/**
+ * Counts the memory of a buffer toward a subsystem for as long as this lives. Make it a member of
+ * the class which owns the buffer. Copies count the memory again, like the copied buffer, and
+ * moves take it over.
+ */
+class HeapAttribution {
+  public:
+  /**
+   * @param isubsystem The subsystem to count the memory toward.
+   * @param ibytes The memory of the buffer.
+   */
+  explicit HeapAttribution(HeapSubsystem isubsystem, std::size_t ibytes = 0);
+
+  HeapAttribution(const HeapAttribution &iother);
+  HeapAttribution(HeapAttribution &&iother) noexcept;
+  HeapAttribution &operator=(const HeapAttribution &iother);
+  HeapAttribution &operator=(HeapAttribution &&iother) noexcept;
+  ~HeapAttribution();
+
+  /**
+   * Changes the memory counted, like after the buffer is resized.
+   *
+   * @param ibytes The memory of the buffer.
+   */
+  void setBytes(std::size_t ibytes);
+
+  /**
+   * @return The memory counted.
+   */
+  std::size_t getBytes() const;
+
+  protected:
+  HeapSubsystem subsystem;
+  std::size_t bytes;
+};
+} // namespace okapi
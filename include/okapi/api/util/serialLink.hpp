@@ -0,0 +1,268 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#pragma once
+
+#include "okapi/api/coreProsAPI.hpp"
+#include "okapi/api/device/abstractSerialPort.hpp"
+#include "okapi/api/util/cobs.hpp"
+#include "okapi/api/util/logging.hpp"
+#include "okapi/api/util/timeUtil.hpp"
+#include <array>
+#include <atomic>
+#include <functional>
+#include <map>
+#include <memory>
+#include <optional>
+#include <vector>
+
+namespace okapi {
+/**
+ * A framed, checksummed message link to a coprocessor, like a Raspberry Pi, over a serial port.
+ * Messages can be sent either way, and either side can call a procedure on the other and wait for
+ * its response, so heavy computation can be moved off the brain.
+ *
+ * Every frame is COBS encoded and ends with a zero byte, so a reader which loses bytes finds the
+ * next frame at the next zero. Before encoding, a frame is:
+ *
+ *  - 1 byte: the message type
+ *  - 1 byte: the flags (`requestFlag`, `responseFlag`, `errorFlag`, `moreFlag`)
+ *  - 1 byte: the sequence number which pairs a response with its request, zero for other messages
+ *  - Up to `maxPayloadSize` bytes: the payload
+ *  - 2 bytes: the CRC-16/CCITT-FALSE of the bytes above, little-endian
+ *
+ * A request or response longer than `maxPayloadSize` is split into frames which have `moreFlag`
+ * set, except for the last one. Other messages must fit in one frame.
+ *
+ * Frames are received into a fixed buffer and decoded in place, and handlers are given the payload
+ * in that buffer, so receiving a single-frame message does not allocate or copy.
+ */
+class SerialLink {
+  public:
+  /**
+   * The most payload bytes in one frame.
+   */
+  static constexpr std::size_t maxPayloadSize = 248;
+
+  static constexpr std::uint8_t requestFlag = 1 << 0;
+  static constexpr std::uint8_t responseFlag = 1 << 1;
+  static constexpr std::uint8_t errorFlag = 1 << 2;
+  static constexpr std::uint8_t moreFlag = 1 << 3;
+
+  /**
+   * The longest request or response, split across frames, which is received.
+   */
+  static constexpr std::size_t maxSplitPayloadSize = 16384;
+
+  /**
+   * How often the link task receives, and how often a task waiting in `call()` checks for the
+   * response.
+   */
+  static constexpr QTime pollPeriod = 2_ms; // NOLINT
+
+  /**
+   * How long a frame waits for room in the transmit buffer before it is dropped.
+   */
+  static constexpr QTime writeTimeout = 100_ms; // NOLINT
+
+  /**
+   * Handles a message. The payload is only valid until the handler returns.
+   */
+  using MessageHandler = std::function<void(const std::uint8_t *ipayload, std::size_t ilength)>;
+
+  /**
+   * Handles a request. The payload is only valid until the handler returns. Return the payload of
+   * the response, or `std::nullopt` to send an error response.
+   */
+  using RequestHandler = std::function<std::optional<std::vector<std::uint8_t>>(
+    const std::uint8_t *ipayload, std::size_t ilength)>;
+
+  /**
+   * A link over a serial port. Call `startThread()` to receive in the background, or call `step()`
+   * periodically.
+   *
+   * @param iport The serial port.
+   * @param itimeUtil The TimeUtil used to time calls and the link task.
+   * @param ilogger The logger this instance will log to.
+   */
+  SerialLink(std::shared_ptr<AbstractSerialPort> iport,
+             const TimeUtil &itimeUtil,
+             std::shared_ptr<Logger> ilogger = Logger::getDefaultLogger());
+
+  SerialLink(const SerialLink &) = delete;
+  SerialLink &operator=(const SerialLink &) = delete;
+
+  virtual ~SerialLink();
+
+  /**
+   * Sends a message which has no response.
+   *
+   * @param itype The message type.
+   * @param ipayload The payload.
+   * @param ilength The length of the payload, at most `maxPayloadSize`.
+   * @return Whether the message was sent.
+   */
+  bool send(std::uint8_t itype, const std::uint8_t *ipayload, std::size_t ilength);
+
+  /**
+   * Calls a procedure on the other side and blocks until its response arrives. Messages and
+   * requests received while waiting are still handled. If the link task is not running, this
+   * receives by calling `step()` while it waits.
+   *
+   * @param itype The message type.
+   * @param ipayload The payload of the request.
+   * @param ilength The length of the payload.
+   * @param itimeout How long to wait for the response.
+   * @return The payload of the response, or `std::nullopt` if the request could not be sent, the
+   * other side sent an error response, or no response arrived in time.
+   */
+  std::optional<std::vector<std::uint8_t>> call(std::uint8_t itype,
+                                                const std::uint8_t *ipayload,
+                                                std::size_t ilength,
+                                                const QTime &itimeout);
+
+  /**
+   * Sets the handler for messages of a type, replacing any previous handler. Handlers are run by
+   * the task which receives, so they should be quick.
+   *
+   * @param itype The message type.
+   * @param ihandler The handler, or `nullptr` to ignore messages of this type.
+   */
+  void onMessage(std::uint8_t itype, MessageHandler ihandler);
+
+  /**
+   * Sets the handler for requests of a type, replacing any previous handler. Requests without a
+   * handler get an error response.
+   *
+   * @param itype The message type.
+   * @param ihandler The handler, or `nullptr` to answer requests of this type with an error.
+   */
+  void onRequest(std::uint8_t itype, RequestHandler ihandler);
+
+  /**
+   * Receives the bytes which have arrived and handles every complete frame.
+   */
+  void step();
+
+  /**
+   * @return The number of valid frames received.
+   */
+  std::uint32_t getReceivedCount() const;
+
+  /**
+   * @return The number of frames dropped because they were too long, could not be decoded, or did
+   * not match their checksum.
+   */
+  std::uint32_t getCorruptCount() const;
+
+  /**
+   * Starts the link task, which receives and handles frames.
+   *
+   * @param ipriority The priority of the task.
+   * @param istackDepth The stack depth of the task in words.
+   */
+  void startThread(std::uint32_t ipriority = TASK_PRIORITY_DEFAULT,
+                   std::uint16_t istackDepth = TASK_STACK_DEPTH_DEFAULT);
+
+  /**
+   * @return The underlying thread handle.
+   */
+  CrossplatformThread *getThread() const;
+
+  /**
+   * Computes the CRC-16/CCITT-FALSE of some bytes.
+   *
+   * @param idata The bytes.
+   * @param ilength The number of bytes.
+   * @return The CRC.
+   */
+  static std::uint16_t crc16(const std::uint8_t *idata, std::size_t ilength);
+
+  protected:
+  static constexpr std::size_t headerSize = 3;
+  static constexpr std::size_t checksumSize = 2;
+  static constexpr std::size_t maxFrameSize = headerSize + maxPayloadSize + checksumSize;
+  static constexpr std::size_t maxEncodedFrameSize = Cobs::getMaxEncodedSize(maxFrameSize) + 1;
+
+  struct PendingCall {
+    std::vector<std::uint8_t> payload{};
+    bool done{false};
+    bool failed{false};
+  };
+
+  std::shared_ptr<Logger> logger;
+  std::shared_ptr<AbstractSerialPort> port;
+  TimeUtil timeUtil;
+
+  // Guards the transmit buffers, so frames from different tasks are not interleaved
+  CrossplatformMutex txMutex;
+  std::unique_ptr<AbstractTimer> txTimer;
+  std::unique_ptr<AbstractRate> txRate;
+  std::array<std::uint8_t, maxFrameSize> txFrame{};
+  std::array<std::uint8_t, maxEncodedFrameSize> txEncoded{};
+
+  // The receive state is guarded by rxMutex
+  CrossplatformMutex rxMutex;
+  std::array<std::uint8_t, maxEncodedFrameSize> rxBuffer{};
+  std::size_t rxLength{0};
+  bool rxOverflowed{false};
+  // The requests from the other side which are split across frames, keyed by sequence number
+  std::map<std::uint8_t, std::vector<std::uint8_t>> partialRequests{};
+
+  // The handlers and pending calls are guarded by handlerMutex
+  CrossplatformMutex handlerMutex;
+  // Shared so a handler can be run without holding the mutex or copying it
+  std::map<std::uint8_t, std::shared_ptr<MessageHandler>> messageHandlers{};
+  std::map<std::uint8_t, std::shared_ptr<RequestHandler>> requestHandlers{};
+  std::map<std::uint8_t, PendingCall> pendingCalls{};
+  std::uint8_t nextSequence{1};
+
+  std::atomic_uint32_t receivedCount{0};
+  std::atomic_uint32_t corruptCount{0};
+
+  std::atomic_bool stopLink{false};
+  std::atomic_bool linkStopped{false};
+  CrossplatformThread *task{nullptr};
+
+  static void trampoline(void *context);
+  void loop();
+
+  /**
+   * Sends a payload of any length, split across frames. Frames of one payload are not interleaved
+   * with other frames.
+   *
+   * @return Whether every frame was sent.
+   */
+  bool sendSplit(std::uint8_t itype,
+                 std::uint8_t iflags,
+                 std::uint8_t isequence,
+                 const std::uint8_t *ipayload,
+                 std::size_t ilength);
+
+  /**
+   * Encodes and writes one frame. txMutex must be locked.
+   *
+   * @return Whether the whole frame was written.
+   */
+  bool writeFrame(std::uint8_t itype,
+                  std::uint8_t iflags,
+                  std::uint8_t isequence,
+                  const std::uint8_t *ipayload,
+                  std::size_t ilength);
+
+  /**
+   * Decodes the frame in the receive buffer in place and handles it. rxMutex must be locked.
+   */
+  void handleFrame();
+
+  /**
+   * Runs the request handler and sends its response. rxMutex must be locked.
+   */
+  void handleRequest(std::uint8_t itype,
+                     std::uint8_t isequence,
+                     const std::uint8_t *ipayload,
+                     std::size_t ilength);
+};
+} // namespace okapi
@@ -6,16 +6,34 @@
 #pragma once
 
 #include <functional>
+#include <memory>
+#include <type_traits>
+#include <utility>
 
 namespace okapi {
 /**
  * A supplier of instances of T.
  *
+ * By default, the function is held in a `std::function` so suppliers of different functions have
+ * the same type. Code which calls a supplier in a loop can hold the function's own type instead
+ * (see `makeSupplier`), so the call can be inlined and nothing is allocated to hold the function.
+ * A supplier of a concrete function converts to the default supplier of the same type.
+ *
  * @tparam T the type to supply
+ * @tparam F the type of the function which makes each instance
  */
-template <typename T> class Supplier {
+template <typename T, typename F = std::function<T(void)>> class Supplier {
   public:
-  explicit Supplier(std::function<T(void)> ifunc) : func(ifunc) {
+  explicit Supplier(F ifunc) : func(std::move(ifunc)) {
+  }
+
+  /**
+   * Holds the function of a supplier of the same type in a `std::function`.
+   */
+  template <typename G,
+            typename = std::enable_if_t<!std::is_same<F, G>::value &&
+                                        std::is_constructible<F, const G &>::value>>
+  Supplier(const Supplier<T, G> &isupplier) : func(isupplier.getFunction()) { // NOLINT
   }
 
   virtual ~Supplier() = default;
@@ -28,7 +46,38 @@ template <typename T> class Supplier {
     return func();
   }
 
+  /**
+   * @return The function which makes each instance.
+   */
+  const F &getFunction() const {
+    return func;
+  }
+
   protected:
-  std::function<T(void)> func;
+  F func;
+};
+
+/**
+ * Makes a supplier which holds its function's own type, so calling it involves no type-erased
+ * call.
+ *
+ * @param ifunc The function which makes each instance.
+ * @return A supplier of whatever the function returns.
+ */
+template <typename F> Supplier<std::invoke_result_t<F &>, F> makeSupplier(F ifunc) {
+  return Supplier<std::invoke_result_t<F &>, F>(std::move(ifunc));
+}
+
+/**
+ * A function which makes a new `Derived` behind a pointer to its `Base`, for a `Supplier` of
+ * `std::unique_ptr<Base>`. It holds no state, so a `std::function` holding it never allocates.
+ *
+ * @tparam Base The type the instances are supplied as.
+ * @tparam Derived The type to make.
+ */
+template <typename Base, typename Derived> struct MakeUniqueFunction {
+  std::unique_ptr<Base> operator()() const {
+    return std::make_unique<Derived>();
+  }
 };
 } // namespace okapi
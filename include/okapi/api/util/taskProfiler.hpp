@@ -0,0 +1,144 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#pragma once
+
+#include "okapi/api/coreProsAPI.hpp"
+#include "okapi/api/util/abstractRate.hpp"
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+namespace okapi {
+class Logger;
+
+/**
+ * How much of its time a task spends running its loop body and how much it spends sleeping.
+ */
+struct TaskProfileStats {
+  char name[32]{};                ///< The name of the task, cut short if it is longer
+  std::uint64_t loops{0};         ///< The number of loop iterations measured
+  std::uint64_t busyMicros{0};    ///< Time spent in the loop body, in microseconds
+  std::uint64_t sleepMicros{0};   ///< Time spent sleeping until the next iteration, in microseconds
+  std::uint64_t maxBusyMicros{0}; ///< The longest loop body, in microseconds
+
+  /**
+   * @return The fraction of the measured time the task spent in its loop body, from `0` to `1`.
+   */
+  double getUtilization() const;
+};
+
+/**
+ * Reports how busy okapi's periodic tasks are. Each task measures its loop with a ProfiledRate:
+ * the time between delays is its loop body and the time in a delay is sleep. The busy time of a
+ * task includes any time it was preempted, so the utilizations of all the tasks add up to more
+ * than the load of the brain when tasks preempt each other.
+ */
+class TaskProfiler {
+  public:
+  /**
+   * The most profiles kept at once. Rates made past this limit delay normally but are not
+   * measured.
+   */
+  static constexpr std::size_t maxProfiles = 32;
+
+  /**
+   * Gets the profile of every measured task.
+   *
+   * @param ostats The profiles are written here.
+   * @return The number of profiles.
+   */
+  static std::size_t getStats(std::array<TaskProfileStats, maxProfiles> &ostats);
+
+  /**
+   * Clears the measurements of every profile, to measure one part of a program.
+   */
+  static void resetStats();
+
+  /**
+   * Logs the profile of every measured task at the info level.
+   *
+   * @param ilogger The logger to log to.
+   */
+  static void logReport(const std::shared_ptr<Logger> &ilogger);
+
+  protected:
+  friend class ProfiledRate;
+
+  // Only the task which owns a profile writes its counters, so they are loaded and stored instead
+  // of being updated atomically
+  struct Profile {
+    bool inUse{false};
+    char name[32]{};
+    std::atomic_uint64_t loops{0};
+    std::atomic_uint64_t busyMicros{0};
+    std::atomic_uint64_t sleepMicros{0};
+    std::atomic_uint64_t maxBusyMicros{0};
+
+    void clear();
+  };
+
+  struct Registry {
+    CrossplatformMutex mutex;
+    std::array<Profile, maxProfiles> profiles{};
+  };
+
+  static Registry &getRegistry();
+
+  /**
+   * @return A free profile with the name, or nullptr if every profile is in use.
+   */
+  static Profile *acquire(const char *iname);
+
+  static void release(Profile *iprofile);
+};
+
+/**
+ * A rate which measures the loop of the task which delays on it for the TaskProfiler. The time
+ * from the end of one delay to the start of the next is counted as the loop body. Resetting the
+ * rate starts a new measurement, so time spent blocked somewhere else between two uses of the rate
+ * is not counted as busy.
+ */
+class ProfiledRate : public AbstractRate {
+  public:
+  /**
+   * @param irate The rate to delay with.
+   * @param iname The name to report the task under.
+   */
+  ProfiledRate(std::unique_ptr<AbstractRate> irate, const char *iname);
+
+  ~ProfiledRate() override;
+
+  ProfiledRate(const ProfiledRate &) = delete;
+  ProfiledRate &operator=(const ProfiledRate &) = delete;
+
+  void delay(QFrequency ihz) override;
+
+  void delayUntil(QTime itime) override;
+
+  void delayUntil(uint32_t ims) override;
+
+  void reset() override;
+
+  protected:
+  std::unique_ptr<AbstractRate> rate;
+  TaskProfiler::Profile *profile;
+  std::uint64_t lastWake{0};
+
+  /**
+   * Counts the loop body which just ended.
+   *
+   * @return The time the delay starts.
+   */
+  std::uint64_t beginDelay();
+
+  /**
+   * Counts the delay which just ended.
+   */
+  void endDelay(std::uint64_t istart);
+};
+} // namespace okapi
@@ -0,0 +1,136 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <iostream>
+#include <string>
+#include <vector>
+
+namespace okapi {
+/**
+ * A compact binary format for telemetry. A file starts with an 8 byte header:
+ *
+ *  - 4 bytes: the magic `OKTL`
+ *  - 2 bytes: the format version
+ *  - 2 bytes: reserved, always zero
+ *
+ * Next is a sequence of tagged records. A channel record names a channel and its fields before any
+ * of its samples:
+ *
+ *  - 1 byte: the tag, `1`
+ *  - 1 byte: the number of fields
+ *  - 2 bytes: the channel id
+ *  - 1 byte: the length of the channel name, then the name
+ *  - For each field, 1 byte: the length of the field name, then the name
+ *
+ * A sample record holds one value per field of its channel:
+ *
+ *  - 1 byte: the tag, `2`
+ *  - 1 byte: the number of values
+ *  - 2 bytes: the channel id
+ *  - 4 bytes: the time in milliseconds
+ *  - The values as 32-bit floats
+ *
+ * All values are little-endian, which is the native byte order of both the V5 brain and common
+ * host machines.
+ */
+class TelemetryFormat {
+  public:
+  /**
+   * The current version of the format.
+   */
+  static constexpr std::uint16_t version = 1;
+
+  /**
+   * The size of the header in bytes.
+   */
+  static constexpr std::size_t headerSize = 8;
+
+  /**
+   * The size of a sample record before its values in bytes.
+   */
+  static constexpr std::size_t sampleHeaderSize = 8;
+
+  /**
+   * The most fields a channel can have.
+   */
+  static constexpr std::size_t maxFields = 255;
+
+  /**
+   * The longest channel or field name in bytes.
+   */
+  static constexpr std::size_t maxNameLength = 255;
+
+  static constexpr std::uint8_t channelTag = 1;
+  static constexpr std::uint8_t sampleTag = 2;
+
+  struct Channel {
+    std::uint16_t id;
+    std::string name;
+    std::vector<std::string> fieldNames;
+  };
+
+  struct Sample {
+    std::uint32_t time;
+    std::uint16_t channel;
+    std::vector<double> values;
+  };
+
+  /**
+   * Writes the header.
+   *
+   * @param obuffer The buffer to write to, which must hold `headerSize` bytes.
+   */
+  static void writeHeader(std::uint8_t *obuffer);
+
+  /**
+   * @param ivalueCount The number of values in the sample.
+   * @return The size of a sample record in bytes.
+   */
+  static constexpr std::size_t getSampleSize(const std::size_t ivalueCount) {
+    return sampleHeaderSize + ivalueCount * sizeof(float);
+  }
+
+  /**
+   * Writes a sample record.
+   *
+   * @param obuffer The buffer to write to, which must hold `getSampleSize(ivalueCount)` bytes.
+   * @param itime The time of the sample in milliseconds.
+   * @param ichannel The channel id.
+   * @param ivalues The values.
+   * @param ivalueCount The number of values.
+   */
+  static void writeSample(std::uint8_t *obuffer,
+                          std::uint32_t itime,
+                          std::uint16_t ichannel,
+                          const double *ivalues,
+                          std::size_t ivalueCount);
+
+  /**
+   * Encodes a channel record. Names longer than `maxNameLength` are truncated.
+   *
+   * @param ichannel The channel.
+   * @return The record.
+   */
+  static std::vector<std::uint8_t> encodeChannel(const Channel &ichannel);
+
+  /**
+   * Reads every record of a telemetry file. A file which ends in the middle of a record, for
+   * example because the robot was turned off while it was written, is read up to that record.
+   *
+   * @param istream The stream to read from. This should be opened in binary mode.
+   * @param ionChannel Called with each channel record.
+   * @param ionSample Called with each sample record.
+   * @return False if the stream does not start with a valid header of a supported version or does
+   * not end on a whole record.
+   */
+  static bool decode(std::istream &istream,
+                     const std::function<void(const Channel &)> &ionChannel,
+                     const std::function<void(const Sample &)> &ionSample);
+};
+} // namespace okapi
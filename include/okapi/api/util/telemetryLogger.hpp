@@ -0,0 +1,155 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#pragma once
+
+#include "okapi/api/coreProsAPI.hpp"
+#include "okapi/api/util/abstractTimer.hpp"
+#include "okapi/api/util/logging.hpp"
+#include "okapi/api/util/telemetryFormat.hpp"
+#include <atomic>
+#include <cstdio>
+#include <initializer_list>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace okapi {
+/**
+ * Records numeric telemetry, like PID error or odometry, to a file in the `TelemetryFormat`. Each
+ * sample is a few bytes copied into a buffer, so recording is cheap enough for every step of a
+ * control loop. A background task writes a full buffer to the file while samples go into the
+ * other buffer, so the file is written in large blocks and never from the task which records.
+ * Samples are dropped if both buffers are full. Use the `telemetryDecoder` tool to turn the file
+ * into CSV files.
+ */
+class TelemetryLogger {
+  public:
+  /**
+   * The size of each of the two buffers by default, in bytes.
+   */
+  static constexpr std::size_t defaultBufferSize = 4096;
+
+  /**
+   * The longest time samples wait in a buffer before they are written, in milliseconds.
+   */
+  static constexpr std::uint32_t writeLoopTimeout = 500;
+
+  /**
+   * Records telemetry to a file opened by name. The file is overwritten.
+   *
+   * @param itimer A timer used to get the time of each sample.
+   * @param ifileName The name of the file to open, e.g. `/usd/telemetry.bin`.
+   * @param ibufferSize The size of each of the two buffers in bytes.
+   * @param ilogger The logger this instance will log to.
+   */
+  TelemetryLogger(std::unique_ptr<AbstractTimer> itimer,
+                  std::string_view ifileName,
+                  std::size_t ibufferSize = defaultBufferSize,
+                  std::shared_ptr<Logger> ilogger = Logger::getDefaultLogger());
+
+  /**
+   * Records telemetry to an existing file handle. The file will be closed by the logger.
+   *
+   * @param itimer A timer used to get the time of each sample.
+   * @param ifile The file to write to. Will be closed by the logger!
+   * @param ibufferSize The size of each of the two buffers in bytes.
+   * @param ilogger The logger this instance will log to.
+   */
+  TelemetryLogger(std::unique_ptr<AbstractTimer> itimer,
+                  FILE *ifile,
+                  std::size_t ibufferSize = defaultBufferSize,
+                  std::shared_ptr<Logger> ilogger = Logger::getDefaultLogger());
+
+  TelemetryLogger(const TelemetryLogger &) = delete;
+  TelemetryLogger &operator=(const TelemetryLogger &) = delete;
+
+  /**
+   * Writes the buffered samples and closes the file.
+   */
+  ~TelemetryLogger();
+
+  /**
+   * Adds a channel, which is a group of values recorded together. Add channels before recording
+   * to them.
+   *
+   * @param iname The name of the channel, used for the name of its CSV file.
+   * @param ifieldNames The names of the values, in the order they are recorded.
+   * @return The id of the channel, used to record to it.
+   */
+  std::uint16_t addChannel(const std::string &iname, const std::vector<std::string> &ifieldNames);
+
+  /**
+   * Records a sample. This never blocks on the file.
+   *
+   * @param ichannel The id returned by `addChannel()`.
+   * @param ivalues The values, in the order of the channel's fields. Values are stored as 32-bit
+   * floats.
+   * @return False if the sample was dropped because both buffers were full or the channel doesn't
+   * exist.
+   */
+  bool record(std::uint16_t ichannel, std::initializer_list<double> ivalues);
+
+  /**
+   * Records a sample. This never blocks on the file.
+   *
+   * @param ichannel The id returned by `addChannel()`.
+   * @param ivalues The values, in the order of the channel's fields. Values are stored as 32-bit
+   * floats.
+   * @param icount The number of values.
+   * @return False if the sample was dropped because both buffers were full or the channel doesn't
+   * exist.
+   */
+  bool record(std::uint16_t ichannel, const double *ivalues, std::size_t icount);
+
+  /**
+   * Blocks until every sample recorded so far was written to the file.
+   */
+  void flush();
+
+  /**
+   * @return The number of samples which were dropped because both buffers were full.
+   */
+  std::uint32_t getDroppedCount() const;
+
+  /**
+   * @return Whether the file is open.
+   */
+  bool isOpen() const;
+
+  protected:
+  std::shared_ptr<Logger> logger;
+  std::unique_ptr<AbstractTimer> timer;
+  FILE *file;
+  std::size_t bufferSize;
+  std::vector<std::uint16_t> channelFieldCounts{};
+
+  // Records go into the front buffer. The back buffer is written by the writer task while
+  // backBufferFull is set. Both are guarded by bufferMutex.
+  std::vector<std::uint8_t> frontBuffer{};
+  std::vector<std::uint8_t> backBuffer{};
+  bool backBufferFull{false};
+  CrossplatformMutex bufferMutex;
+
+  std::atomic_uint32_t droppedCount{0};
+  std::atomic_bool stopWriting{false};
+  std::atomic_bool writerStopped{false};
+  // Notified after the writer task writes a buffer
+  CrossplatformEvent writtenEvent;
+  CrossplatformThread *task{nullptr};
+
+  static void trampoline(void *context);
+  void writeLoop();
+
+  /**
+   * Hands the front buffer to the writer task if it has bytes and the back buffer is free. The
+   * buffer mutex must be held.
+   *
+   * @return Whether the buffers were swapped.
+   */
+  bool swapBuffers();
+};
+} // namespace okapi
@@ -0,0 +1,214 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#pragma once
+
+#include "okapi/api/coreProsAPI.hpp"
+#include "okapi/api/util/logging.hpp"
+#include "okapi/api/util/timeUtil.hpp"
+#include <atomic>
+#include <cstdio>
+#include <functional>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace okapi {
+/**
+ * Streams live values, like the error of a controller or the position of the robot, over serial so
+ * they can be watched while the robot runs. Each registered signal is read at a fixed rate by a
+ * background task and the values are packed into one binary packet, which costs much less than
+ * printing them and doesn't block the control tasks. Use the `telemetryViewer.py` tool to watch the
+ * stream.
+ *
+ * Every packet is COBS encoded and ends with a zero byte, followed by:
+ *
+ *  - 1 byte: the packet type
+ *  - The payload
+ *  - 1 byte: the sum of the type and payload bytes, modulo 256
+ *
+ * A descriptor packet (type `1`) names the signals. It is sent when the signals change and once
+ * per `descriptorPeriod` so a viewer can start watching at any time.
+ *
+ *  - 1 byte: the number of signals
+ *  - For each signal, 1 byte: the length of the name, then the name
+ *
+ * A sample packet (type `2`) holds one value per signal, in the order of the last descriptor.
+ *
+ *  - 4 bytes: the time in milliseconds
+ *  - 1 byte: the number of values
+ *  - The values as 32-bit floats
+ *
+ * All values are little-endian.
+ */
+class TelemetryStream {
+  public:
+  /**
+   * The most signals a stream can have.
+   */
+  static constexpr std::size_t maxSignals = 255;
+
+  static constexpr std::uint8_t descriptorPacketType = 1;
+  static constexpr std::uint8_t samplePacketType = 2;
+
+  /**
+   * How often the descriptor packet is sent when the signals don't change.
+   */
+  static constexpr QTime descriptorPeriod = 1_s; // NOLINT
+
+  /**
+   * Streams to a file opened by name, usually a serial stream like `/ser/sout`.
+   *
+   * @param itimeUtil The TimeUtil used to time the samples and the stream task.
+   * @param ifileName The name of the file to open.
+   * @param iperiod The time between samples.
+   * @param ilogger The logger this instance will log to.
+   */
+  TelemetryStream(const TimeUtil &itimeUtil,
+                  std::string_view ifileName,
+                  QTime iperiod = 20_ms,
+                  std::shared_ptr<Logger> ilogger = Logger::getDefaultLogger());
+
+  /**
+   * Streams to an existing file handle. The file will be closed by the stream.
+   *
+   * @param itimeUtil The TimeUtil used to time the samples and the stream task.
+   * @param ifile The file to write to. Will be closed by the stream!
+   * @param iperiod The time between samples.
+   * @param ilogger The logger this instance will log to.
+   */
+  TelemetryStream(const TimeUtil &itimeUtil,
+                  FILE *ifile,
+                  QTime iperiod = 20_ms,
+                  std::shared_ptr<Logger> ilogger = Logger::getDefaultLogger());
+
+  TelemetryStream(const TelemetryStream &) = delete;
+  TelemetryStream &operator=(const TelemetryStream &) = delete;
+
+  /**
+   * Stops the stream task and closes the file.
+   */
+  ~TelemetryStream();
+
+  /**
+   * Adds a signal. The source is called from the stream task, so it must be safe to call from
+   * another task and must not block.
+   *
+   * @param iname The name of the signal.
+   * @param isource Reads the current value.
+   * @return The id of the signal, used to remove it.
+   */
+  std::uint32_t addSignal(const std::string &iname, std::function<double()> isource);
+
+  /**
+   * Removes a signal. Blocks until the stream task is done reading it, so its source can be
+   * destroyed once this returns.
+   *
+   * @param iid The id returned by `addSignal()`.
+   */
+  void removeSignal(std::uint32_t iid);
+
+  /**
+   * @return The number of signals.
+   */
+  std::size_t getSignalCount();
+
+  /**
+   * Starts the stream task. Signals can be added before or after the task is started.
+   *
+   * @param ipriority The priority of the task. This should be lower than the control tasks.
+   * @param istackDepth The stack depth of the task in words.
+   */
+  void startThread(std::uint32_t ipriority = TASK_PRIORITY_MIN,
+                   std::uint16_t istackDepth = TASK_STACK_DEPTH_DEFAULT);
+
+  /**
+   * @return The underlying thread handle.
+   */
+  CrossplatformThread *getThread() const;
+
+  protected:
+  struct Signal {
+    std::uint32_t id;
+    std::string name;
+    std::function<double()> source;
+  };
+
+  std::shared_ptr<Logger> logger;
+  std::unique_ptr<AbstractTimer> timer;
+  std::unique_ptr<AbstractRate> rate;
+  FILE *file;
+  QTime period;
+
+  // The signals and packet buffers are guarded by signalMutex
+  std::vector<Signal> signalList{};
+  std::uint32_t nextSignalId{0};
+  std::vector<std::uint8_t> descriptorPacket{};
+  std::vector<std::uint8_t> samplePacket{};
+  std::vector<std::uint8_t> encodedPacket{};
+  bool descriptorChanged{true};
+  QTime lastDescriptorTime{0_ms};
+  CrossplatformMutex signalMutex;
+
+  std::atomic_bool stopStreaming{false};
+  std::atomic_bool streamStopped{false};
+  CrossplatformThread *task{nullptr};
+
+  static void trampoline(void *context);
+  void loop();
+
+  /**
+   * Reads every signal and writes a sample packet, and a descriptor packet when it's due.
+   */
+  void step();
+
+  /**
+   * Encodes the descriptor packet after the signals change. The signal mutex must be held.
+   */
+  void updateDescriptor();
+
+  /**
+   * Adds the checksum to a packet, encodes it, and writes it. The signal mutex must be held.
+   *
+   * @param ipacket The type and payload of the packet. The checksum is appended while it is
+   * encoded and removed again.
+   */
+  void writePacket(std::vector<std::uint8_t> &ipacket);
+};
+
+/**
+ * Signals added to a `TelemetryStream` on behalf of an owner, like a controller. The signals are
+ * removed when this is destroyed, so an owner which declares this as its last member can't be read
+ * by the stream after it starts being destroyed.
+ */
+class TelemetryRegistration {
+  public:
+  TelemetryRegistration() = default;
+  TelemetryRegistration(const TelemetryRegistration &) = delete;
+  TelemetryRegistration &operator=(const TelemetryRegistration &) = delete;
+  ~TelemetryRegistration();
+
+  /**
+   * Adds a signal. Signals from a previous stream are removed first.
+   *
+   * @param istream The stream to add the signal to.
+   * @param iname The name of the signal.
+   * @param isource Reads the current value.
+   */
+  void add(const std::shared_ptr<TelemetryStream> &istream,
+           const std::string &iname,
+           std::function<double()> isource);
+
+  /**
+   * Removes every signal.
+   */
+  void clear();
+
+  protected:
+  std::shared_ptr<TelemetryStream> stream{nullptr};
+  std::vector<std::uint32_t> ids{};
+};
+} // namespace okapi
@@ -10,15 +10,25 @@
 #include "okapi/api/chassis/controller/defaultOdomChassisController.hpp"
 #include "okapi/api/chassis/model/hDriveModel.hpp"
 #include "okapi/api/chassis/model/skidSteerModel.hpp"
+#include "okapi/api/chassis/model/voltageCompensator.hpp"
 #include "okapi/api/chassis/model/xDriveModel.hpp"
+#include "okapi/api/control/util/controlScheduler.hpp"
+#include "okapi/api/odometry/imuFusedOdometry.hpp"
+#include "okapi/api/odometry/odomIntegration.hpp"
+#include "okapi/api/odometry/wallCorrectedOdometry.hpp"
 #include "okapi/api/util/logging.hpp"
 #include "okapi/api/util/mathUtil.hpp"
+#include "okapi/impl/device/distanceSensor.hpp"
 #include "okapi/impl/device/motor/motor.hpp"
 #include "okapi/impl/device/motor/motorGroup.hpp"
+#include "okapi/impl/device/rotarysensor/IMU.hpp"
 #include "okapi/impl/device/rotarysensor/adiEncoder.hpp"
 #include "okapi/impl/device/rotarysensor/integratedEncoder.hpp"
 #include "okapi/impl/device/rotarysensor/rotationSensor.hpp"
+#include "okapi/impl/device/rotarysensor/rotationSensorGroup.hpp"
 #include "okapi/impl/util/timeUtilFactory.hpp"
+#include <string>
+#include <vector>
 
 namespace okapi {
 class ChassisControllerBuilder {
@@ -176,7 +186,8 @@ class ChassisControllerBuilder {
   ChassisControllerBuilder &withSensors(const RotationSensor &ileft, const RotationSensor &iright);
 
   /**
-   * Sets the sensors. The default sensors are the motor's integrated encoders.
+   * Sets the sensors. The default sensors are the motor's integrated encoders. A skid steer
+   * chassis reads the three sensors back to back through a RotationSensorGroup.
    *
    * @param ileft The left side sensor.
    * @param iright The right side sensor.
@@ -254,6 +265,55 @@ class ChassisControllerBuilder {
                                       const IterativePosPIDController::Gains &iturnGains,
                                       const IterativePosPIDController::Gains &iangleGains);
 
+  /**
+   * Closes the loop on the middle wheel of an H-drive, so the ChassisControllerPID can strafe and
+   * move diagonally (see ChassisControllerPID::setStrafeController). Needs `withGains`, an H-drive,
+   * and dimensions with a middle wheel.
+   *
+   * @param istrafeGains The strafe controller's gains, per tick of the middle sensor.
+   * @return An ongoing builder.
+   */
+  ChassisControllerBuilder &withStrafeGains(const IterativePosPIDController::Gains &istrafeGains);
+
+  /**
+   * Makes the ChassisController's moves and turns follow a profile instead of jumping to the
+   * target (see ChassisControllerPID::setProfileLimits). Without PID gains, the
+   * ChassisControllerIntegrated streams the velocity of a trapezoidal profile to the motors
+   * instead (see ChassisControllerIntegrated::setProfileLimits).
+   *
+   * @param ilimits The max velocity in m/s, acceleration in m/s^2, and jerk in m/s^3.
+   * @param ishape The shape of the profile. The jerk is only used by an S-curve, which is only
+   * used with PID gains.
+   * @return An ongoing builder.
+   */
+  ChassisControllerBuilder &
+  withProfileLimits(const PathfinderLimits &ilimits,
+                    ChassisControllerPID::ProfileShape ishape =
+                      ChassisControllerPID::ProfileShape::trapezoid);
+
+  /**
+   * Feeds the ChassisControllerPID's turn and angle controllers from an inertial sensor instead of
+   * the encoders (see ChassisControllerPID::setHeadingSensor). Their gains are then per degree of
+   * heading. Without PID gains, the ChassisControllerIntegrated uses it to correct its heading
+   * during moves instead (see ChassisControllerIntegrated::setHeadingCorrection).
+   *
+   * @param iimu The inertial sensor.
+   * @return An ongoing builder.
+   */
+  ChassisControllerBuilder &withHeadingSensor(const IMU &iimu);
+
+  /**
+   * Feeds the ChassisControllerPID's turn and angle controllers from a heading sensor instead of
+   * the encoders (see ChassisControllerPID::setHeadingSensor). Their gains are then per degree of
+   * heading. Without PID gains, the ChassisControllerIntegrated uses it to correct its heading
+   * during moves instead (see ChassisControllerIntegrated::setHeadingCorrection).
+   *
+   * @param isensor The heading sensor. Must read the heading in degrees, increasing clockwise.
+   * @return An ongoing builder.
+   */
+  ChassisControllerBuilder &
+  withHeadingSensor(const std::shared_ptr<ContinuousRotarySensor> &isensor);
+
   /**
    * Sets the odometry information, causing the builder to generate an Odometry variant.
    *
@@ -261,11 +321,15 @@ class ChassisControllerBuilder {
    * state.
    * @param imoveThreshold The minimum length movement.
    * @param iturnThreshold The minimum angle turn.
+   * @param iodomLoopPeriod The time between odometry steps. Use a shorter period, like `5_ms`, if
+   * the sensors update that fast. Must be at least `1_ms`.
    * @return An ongoing builder.
    */
   ChassisControllerBuilder &withOdometry(const StateMode &imode = StateMode::FRAME_TRANSFORMATION,
                                          const QLength &imoveThreshold = 0_mm,
-                                         const QAngle &iturnThreshold = 0_deg);
+                                         const QAngle &iturnThreshold = 0_deg,
+                                         const QTime &iodomLoopPeriod =
+                                           OdomChassisController::defaultOdomLoopPeriod);
 
   /**
    * Sets the odometry information, causing the builder to generate an Odometry variant.
@@ -276,12 +340,16 @@ class ChassisControllerBuilder {
    * state.
    * @param imoveThreshold The minimum length movement.
    * @param iturnThreshold The minimum angle turn.
+   * @param iodomLoopPeriod The time between odometry steps. Use a shorter period, like `5_ms`, if
+   * the sensors update that fast. Must be at least `1_ms`.
    * @return An ongoing builder.
    */
   ChassisControllerBuilder &withOdometry(const ChassisScales &iodomScales,
                                          const StateMode &imode = StateMode::FRAME_TRANSFORMATION,
                                          const QLength &imoveThreshold = 0_mm,
-                                         const QAngle &iturnThreshold = 0_deg);
+                                         const QAngle &iturnThreshold = 0_deg,
+                                         const QTime &iodomLoopPeriod =
+                                           OdomChassisController::defaultOdomLoopPeriod);
 
   /**
    * Sets the odometry information, causing the builder to generate an Odometry variant.
@@ -291,12 +359,88 @@ class ChassisControllerBuilder {
    * state.
    * @param imoveThreshold The minimum length movement.
    * @param iturnThreshold The minimum angle turn.
+   * @param iodomLoopPeriod The time between odometry steps. Use a shorter period, like `5_ms`, if
+   * the sensors update that fast. Must be at least `1_ms`.
    * @return An ongoing builder.
    */
   ChassisControllerBuilder &withOdometry(std::shared_ptr<Odometry> iodometry,
                                          const StateMode &imode = StateMode::FRAME_TRANSFORMATION,
                                          const QLength &imoveThreshold = 0_mm,
-                                         const QAngle &iturnThreshold = 0_deg);
+                                         const QAngle &iturnThreshold = 0_deg,
+                                         const QTime &iodomLoopPeriod =
+                                           OdomChassisController::defaultOdomLoopPeriod);
+
+  /**
+   * Sets how the odometry the builder generates turns the movement measured in each step into a
+   * change in state. Call `withOdometry` as well. `OdomIntegration::ARC` by default. X-drives with
+   * a middle sensor get a `HolonomicOdometry`, which always uses the exponential map.
+   *
+   * @param iintegration The integration.
+   * @return An ongoing builder.
+   */
+  ChassisControllerBuilder &withOdometryIntegration(const OdomIntegration &iintegration);
+
+  /**
+   * Corrects the odometry heading with an inertial sensor, causing the builder to generate an
+   * ImuFusedOdometry around the odometry. Call `withOdometry` as well.
+   *
+   * @param iimu The inertial sensor.
+   * @param iimuWeight How much of the difference between the encoder heading and the inertial
+   * sensor heading is corrected every step, between `0` (only the encoders) and `1` (only the
+   * inertial sensor).
+   * @return An ongoing builder.
+   */
+  ChassisControllerBuilder &withOdometryImu(const IMU &iimu,
+                                            double iimuWeight = ImuFusedOdometry::defaultImuWeight);
+
+  /**
+   * Corrects the odometry heading with an inertial sensor, causing the builder to generate an
+   * ImuFusedOdometry around the odometry. Call `withOdometry` as well.
+   *
+   * @param iimu The inertial sensor. Must read the heading in degrees, increasing clockwise.
+   * @param iimuWeight How much of the difference between the encoder heading and the inertial
+   * sensor heading is corrected every step, between `0` (only the encoders) and `1` (only the
+   * inertial sensor).
+   * @return An ongoing builder.
+   */
+  ChassisControllerBuilder &withOdometryImu(const std::shared_ptr<ContinuousRotarySensor> &iimu,
+                                            double iimuWeight = ImuFusedOdometry::defaultImuWeight);
+
+  /**
+   * Corrects the odometry position with distance sensors aimed at the walls of the field, causing
+   * the builder to generate a WallCorrectedOdometry around the odometry. Add the sensors with
+   * `withOdometryDistanceSensor`. Call `withOdometry` as well.
+   *
+   * @param imap The walls of the field, in `StateMode::FRAME_TRANSFORMATION`.
+   * @param igain How much of the error is corrected each time a reading lines up with a wall,
+   * between `0` (never correct) and `1` (snap to the reading).
+   * @return An ongoing builder.
+   */
+  ChassisControllerBuilder &withOdometryWalls(const FieldMap &imap,
+                                              double igain = WallCorrectedOdometry::defaultGain);
+
+  /**
+   * Adds a distance sensor which corrects the odometry position. Call `withOdometryWalls` as well.
+   *
+   * @param iport The port of the distance sensor.
+   * @param imount Where the sensor is on the robot: `x` is forward and `y` is to the right of the
+   * center of the robot, and `theta` is the direction of the beam relative to the front.
+   * @return An ongoing builder.
+   */
+  ChassisControllerBuilder &withOdometryDistanceSensor(std::uint8_t iport,
+                                                       const OdomState &imount);
+
+  /**
+   * Adds a distance sensor which corrects the odometry position. Call `withOdometryWalls` as well.
+   *
+   * @param isensor The sensor. Must read the distance in millimeters, like the DistanceSensor.
+   * @param imount Where the sensor is on the robot: `x` is forward and `y` is to the right of the
+   * center of the robot, and `theta` is the direction of the beam relative to the front.
+   * @return An ongoing builder.
+   */
+  ChassisControllerBuilder &
+  withOdometryDistanceSensor(const std::shared_ptr<ControllerInput<double>> &isensor,
+                             const OdomState &imount);
 
   /**
    * Sets the derivative filters. Uses a PassthroughFilter by default.
@@ -337,6 +481,27 @@ class ChassisControllerBuilder {
    */
   ChassisControllerBuilder &withMaxVoltage(double imaxVoltage);
 
+  /**
+   * Scales the max voltage of the chassis model by the battery voltage, so voltage-mode outputs
+   * stay the same as the battery sags. The battery is read every
+   * `VoltageCompensator::defaultReadPeriod`.
+   *
+   * @param inominalVoltage The battery voltage in mV at which the max voltage is not scaled. This
+   * is usually the voltage the robot was tuned at.
+   * @return An ongoing builder.
+   */
+  ChassisControllerBuilder &
+  withVoltageCompensation(double inominalVoltage = VoltageCompensator::defaultNominalVoltage);
+
+  /**
+   * Scales the max voltage of the chassis model with the given compensator.
+   *
+   * @param icompensator The compensator.
+   * @return An ongoing builder.
+   */
+  ChassisControllerBuilder &
+  withVoltageCompensation(const std::shared_ptr<VoltageCompensator> &icompensator);
+
   /**
    * Sets the TimeUtilFactory used when building a ChassisController. This instance will be given
    * to the ChassisController (not to controllers it uses). The default is the static
@@ -413,6 +578,65 @@ class ChassisControllerBuilder {
    */
   ChassisControllerBuilder &notParentedToCurrentTask();
 
+  /**
+   * Sets the priority of the internal tasks started by this builder. Give them a higher priority
+   * than your own tasks so the control loops are not preempted by them. The default is
+   * `TASK_PRIORITY_DEFAULT`. The odometry task runs one priority higher (up to
+   * `TASK_PRIORITY_MAX`) so the odometry is stepped on time and is fresh when the controllers read
+   * it.
+   *
+   * @param ipriority The priority, between `TASK_PRIORITY_MIN` and `TASK_PRIORITY_MAX`.
+   * @return An ongoing builder.
+   */
+  ChassisControllerBuilder &withTaskPriority(std::uint32_t ipriority);
+
+  /**
+   * Sets the stack depth of the internal tasks started by this builder. The default is
+   * `TASK_STACK_DEPTH_DEFAULT`.
+   *
+   * @param istackDepth The stack depth in words, at least `TASK_STACK_DEPTH_MIN`.
+   * @return An ongoing builder.
+   */
+  ChassisControllerBuilder &withTaskStackDepth(std::uint16_t istackDepth);
+
+  /**
+   * Steps the odometry and the PID chassis controller from a shared scheduler instead of starting
+   * internal tasks for them. In each tick the odometry is stepped before the chassis controller, so
+   * the controller reads the pose from the same tick. Both run every 10 ms unless the odometry is
+   * given another period with `withOdometry`. Start the scheduler's task with
+   * `ControlScheduler::startThread`.
+   *
+   * @param ischeduler The scheduler.
+   * @return An ongoing builder.
+   */
+  ChassisControllerBuilder &withScheduler(const std::shared_ptr<ControlScheduler> &ischeduler);
+
+  /**
+   * Starts the chassis controller's task on its first movement instead of during `build`, so a
+   * chassis built in `initialize` but only driven in autonomous doesn't run a task until then (see
+   * ChassisControllerPID::startThreadLazily). The task is not parented to the task which builds the
+   * chassis. The odometry task still starts during `build` so it sees every movement of the robot.
+   *
+   * @return An ongoing builder.
+   */
+  ChassisControllerBuilder &withLazyThreadStart();
+
+  /**
+   * How long a phase of the last build took.
+   */
+  struct BuildPhase {
+    std::string name;
+    QTime duration;
+  };
+
+  /**
+   * Gets how long each phase of the last `build` or `buildOdometry` took, in the order they ran,
+   * to find what delays the robot being ready. The report is also logged at the info level.
+   *
+   * @return The phases of the last build.
+   */
+  const std::vector<BuildPhase> &getBuildReport() const;
+
   /**
    * Builds the ChassisController. Throws a std::runtime_exception if no motors were set or if no
    * dimensions were set.
@@ -462,6 +686,7 @@ class ChassisControllerBuilder {
   std::shared_ptr<ContinuousRotarySensor> leftSensor{nullptr};
   std::shared_ptr<ContinuousRotarySensor> rightSensor{nullptr};
   std::shared_ptr<ContinuousRotarySensor> middleSensor{nullptr};
+  std::shared_ptr<RotarySensorGroup> sensorGroup{nullptr};
 
   bool hasGains{false}; // Whether gains were passed, no gains means CCI
   IterativePosPIDController::Gains distanceGains;
@@ -470,6 +695,12 @@ class ChassisControllerBuilder {
   std::unique_ptr<Filter> angleFilter = std::make_unique<PassthroughFilter>();
   IterativePosPIDController::Gains turnGains;
   std::unique_ptr<Filter> turnFilter = std::make_unique<PassthroughFilter>();
+  bool hasStrafeGains{false};
+  IterativePosPIDController::Gains strafeGains;
+  bool hasProfileLimits{false};
+  PathfinderLimits profileLimits{0, 0, 0};
+  ChassisControllerPID::ProfileShape profileShape{ChassisControllerPID::ProfileShape::trapezoid};
+  std::shared_ptr<ContinuousRotarySensor> headingSensor{nullptr};
   TimeUtilFactory chassisControllerTimeUtilFactory = TimeUtilFactory();
   TimeUtilFactory closedLoopControllerTimeUtilFactory = TimeUtilFactory();
   TimeUtilFactory odometryTimeUtilFactory = TimeUtilFactory();
@@ -485,13 +716,55 @@ class ChassisControllerBuilder {
   StateMode stateMode;
   QLength moveThreshold;
   QAngle turnThreshold;
+  QTime odomLoopPeriod{OdomChassisController::defaultOdomLoopPeriod};
+  OdomIntegration odomIntegration{OdomIntegration::ARC};
+  std::shared_ptr<ContinuousRotarySensor> odomImu{nullptr};
+  double odomImuWeight{ImuFusedOdometry::defaultImuWeight};
+  bool hasOdomWalls{false};
+  FieldMap odomWalls;
+  double odomWallGain{WallCorrectedOdometry::defaultGain};
+  std::vector<std::pair<std::shared_ptr<ControllerInput<double>>, OdomState>>
+    odomDistanceSensors{};
 
   bool maxVelSetByUser{false}; // Used so motors don't overwrite maxVelocity
   double maxVelocity{600};
 
   double maxVoltage{12000};
+  bool hasVoltageCompensation{false};
+  double nominalVoltage{VoltageCompensator::defaultNominalVoltage};
+  std::shared_ptr<VoltageCompensator> voltageCompensator{nullptr};
 
   bool isParentedToCurrentTask{true};
+  std::uint32_t taskPriority{TASK_PRIORITY_DEFAULT};
+  std::uint16_t taskStackDepth{TASK_STACK_DEPTH_DEFAULT};
+  std::shared_ptr<ControlScheduler> scheduler{nullptr};
+  bool lazyThreadStart{false};
+
+  std::vector<BuildPhase> buildReport{};
+  std::unique_ptr<AbstractTimer> buildTimer{nullptr};
+  QTime lastPhaseEnd{0_ms};
+
+  /**
+   * Builds the ChassisController without starting or ending a build report.
+   */
+  std::shared_ptr<ChassisController> buildChassisController();
+
+  /**
+   * Starts timing the phases of a build.
+   */
+  void startBuildReport();
+
+  /**
+   * Records the time since the last phase ended as a phase of the build.
+   *
+   * @param iname The name of the phase.
+   */
+  void recordBuildPhase(const std::string &iname);
+
+  /**
+   * Logs the phases of the build and their total.
+   */
+  void finishBuildReport();
 
   std::shared_ptr<ChassisControllerPID> buildCCPID();
   std::shared_ptr<ChassisControllerIntegrated> buildCCI();
@@ -99,6 +99,19 @@ class AsyncMotionProfileControllerBuilder {
    */
   AsyncMotionProfileControllerBuilder &withLimits(const PathfinderLimits &ilimits);
 
+  /**
+   * Sets the odometry used to close the loop around the profile with a Ramsete controller. Only
+   * applies to the controller built by buildMotionProfileController(). The default is to follow
+   * paths open-loop.
+   *
+   * @param iodometry The odometry.
+   * @param ib The Ramsete convergence gain (b > 0).
+   * @param izeta The Ramsete damping gain (0 < zeta < 1).
+   * @return An ongoing builder.
+   */
+  AsyncMotionProfileControllerBuilder &
+  withOdometry(const std::shared_ptr<Odometry> &iodometry, double ib = 2.0, double izeta = 0.7);
+
   /**
    * Sets the TimeUtilFactory used when building the controller. The default is the static
    * TimeUtilFactory.
@@ -141,6 +154,25 @@ class AsyncMotionProfileControllerBuilder {
    */
   AsyncMotionProfileControllerBuilder &notParentedToCurrentTask();
 
+  /**
+   * Sets the priority of the internal tasks started by this builder. Give them a higher priority
+   * than your own tasks so the control loops are not preempted by them. The default is
+   * `TASK_PRIORITY_DEFAULT`.
+   *
+   * @param ipriority The priority, between `TASK_PRIORITY_MIN` and `TASK_PRIORITY_MAX`.
+   * @return An ongoing builder.
+   */
+  AsyncMotionProfileControllerBuilder &withTaskPriority(std::uint32_t ipriority);
+
+  /**
+   * Sets the stack depth of the internal tasks started by this builder. The default is
+   * `TASK_STACK_DEPTH_DEFAULT`.
+   *
+   * @param istackDepth The stack depth in words, at least `TASK_STACK_DEPTH_MIN`.
+   * @return An ongoing builder.
+   */
+  AsyncMotionProfileControllerBuilder &withTaskStackDepth(std::uint16_t istackDepth);
+
   /**
    * Builds the AsyncLinearMotionProfileController.
    *
@@ -161,6 +193,10 @@ class AsyncMotionProfileControllerBuilder {
   bool hasLimits{false};
   PathfinderLimits limits;
 
+  std::shared_ptr<Odometry> odometry;
+  double ramseteB{2.0};
+  double ramseteZeta{0.7};
+
   bool hasOutput{false};
   std::shared_ptr<ControllerOutput<double>> output;
   QLength diameter;
@@ -173,5 +209,7 @@ class AsyncMotionProfileControllerBuilder {
   std::shared_ptr<Logger> controllerLogger = Logger::getDefaultLogger();
 
   bool isParentedToCurrentTask{true};
+  std::uint32_t taskPriority{TASK_PRIORITY_DEFAULT};
+  std::uint16_t taskStackDepth{TASK_STACK_DEPTH_DEFAULT};
 };
 } // namespace okapi
@@ -8,6 +8,7 @@
 #include "okapi/api/control/async/asyncPosIntegratedController.hpp"
 #include "okapi/api/control/async/asyncPosPidController.hpp"
 #include "okapi/api/control/async/asyncPositionController.hpp"
+#include "okapi/api/control/util/controlScheduler.hpp"
 #include "okapi/api/util/logging.hpp"
 #include "okapi/impl/device/motor/motor.hpp"
 #include "okapi/impl/device/motor/motorGroup.hpp"
@@ -153,6 +154,35 @@ class AsyncPosControllerBuilder {
    */
   AsyncPosControllerBuilder &notParentedToCurrentTask();
 
+  /**
+   * Sets the priority of the internal tasks started by this builder. Give them a higher priority
+   * than your own tasks so the control loops are not preempted by them. The default is
+   * `TASK_PRIORITY_DEFAULT`.
+   *
+   * @param ipriority The priority, between `TASK_PRIORITY_MIN` and `TASK_PRIORITY_MAX`.
+   * @return An ongoing builder.
+   */
+  AsyncPosControllerBuilder &withTaskPriority(std::uint32_t ipriority);
+
+  /**
+   * Sets the stack depth of the internal tasks started by this builder. The default is
+   * `TASK_STACK_DEPTH_DEFAULT`.
+   *
+   * @param istackDepth The stack depth in words, at least `TASK_STACK_DEPTH_MIN`.
+   * @return An ongoing builder.
+   */
+  AsyncPosControllerBuilder &withTaskStackDepth(std::uint16_t istackDepth);
+
+  /**
+   * Steps the PID controller from a shared scheduler instead of starting an internal task for it.
+   * The integrated controller does not use a task, so this does nothing for it. Start the
+   * scheduler's task with `ControlScheduler::startThread`.
+   *
+   * @param ischeduler The scheduler.
+   * @return An ongoing builder.
+   */
+  AsyncPosControllerBuilder &withScheduler(const std::shared_ptr<ControlScheduler> &ischeduler);
+
   /**
    * Builds the AsyncPositionController. Throws a std::runtime_exception is no motors were set.
    *
@@ -183,6 +213,9 @@ class AsyncPosControllerBuilder {
   std::shared_ptr<Logger> controllerLogger = Logger::getDefaultLogger();
 
   bool isParentedToCurrentTask{true};
+  std::uint32_t taskPriority{TASK_PRIORITY_DEFAULT};
+  std::uint16_t taskStackDepth{TASK_STACK_DEPTH_DEFAULT};
+  std::shared_ptr<ControlScheduler> scheduler{nullptr};
 
   std::shared_ptr<AsyncPosIntegratedController> buildAPIC();
   std::shared_ptr<AsyncPosPIDController> buildAPPC();
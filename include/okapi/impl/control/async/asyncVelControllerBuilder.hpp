@@ -5,9 +5,12 @@
  */
 #pragma once
 
+#include "okapi/api/control/async/asyncVelBangBangController.hpp"
 #include "okapi/api/control/async/asyncVelIntegratedController.hpp"
 #include "okapi/api/control/async/asyncVelPidController.hpp"
+#include "okapi/api/control/async/asyncVelTbhController.hpp"
 #include "okapi/api/control/async/asyncVelocityController.hpp"
+#include "okapi/api/control/util/controlScheduler.hpp"
 #include "okapi/api/util/logging.hpp"
 #include "okapi/impl/device/motor/motor.hpp"
 #include "okapi/impl/device/motor/motorGroup.hpp"
@@ -20,7 +23,8 @@ class AsyncVelControllerBuilder {
   public:
   /**
    * A builder that creates async velocity controllers. Use this to create an
-   * AsyncVelIntegratedController or an AsyncVelPIDController.
+   * AsyncVelIntegratedController, an AsyncVelPIDController, an AsyncVelTBHController, or an
+   * AsyncVelBangBangController.
    *
    * @param ilogger The logger this instance will log to.
    */
@@ -84,9 +88,28 @@ class AsyncVelControllerBuilder {
    */
   AsyncVelControllerBuilder &withGains(const IterativeVelPIDController::Gains &igains);
 
+  /**
+   * Sets the controller gains, causing the builder to generate an AsyncVelTBHController. This does
+   * not set the integrated control's gains.
+   *
+   * @param igains The gains.
+   * @return An ongoing builder.
+   */
+  AsyncVelControllerBuilder &withGains(const IterativeTBHController::Gains &igains);
+
+  /**
+   * Sets the controller gains, causing the builder to generate an AsyncVelBangBangController. This
+   * does not set the integrated control's gains.
+   *
+   * @param igains The gains.
+   * @return An ongoing builder.
+   */
+  AsyncVelControllerBuilder &withGains(const IterativeBangBangController::Gains &igains);
+
   /**
    * Sets the VelMath which calculates and filters velocity. This is ignored when using integrated
-   * controller. If using a PID controller (by setting the gains), this is required.
+   * controller. If using a PID, TBH, or bang-bang controller (by setting the gains), this is
+   * required.
    *
    * @param ivelMath The VelMath.
    * @return An ongoing builder.
@@ -113,7 +136,7 @@ class AsyncVelControllerBuilder {
 
   /**
    * Sets the maximum velocity. The default maximum velocity is derived from the motor's gearset.
-   * This parameter is ignored when using an AsyncVelPIDController.
+   * This parameter is ignored unless using an AsyncVelIntegratedController.
    *
    * @param imaxVelocity The maximum velocity.
    * @return An ongoing builder.
@@ -162,6 +185,35 @@ class AsyncVelControllerBuilder {
    */
   AsyncVelControllerBuilder &notParentedToCurrentTask();
 
+  /**
+   * Sets the priority of the internal tasks started by this builder. Give them a higher priority
+   * than your own tasks so the control loops are not preempted by them. The default is
+   * `TASK_PRIORITY_DEFAULT`.
+   *
+   * @param ipriority The priority, between `TASK_PRIORITY_MIN` and `TASK_PRIORITY_MAX`.
+   * @return An ongoing builder.
+   */
+  AsyncVelControllerBuilder &withTaskPriority(std::uint32_t ipriority);
+
+  /**
+   * Sets the stack depth of the internal tasks started by this builder. The default is
+   * `TASK_STACK_DEPTH_DEFAULT`.
+   *
+   * @param istackDepth The stack depth in words, at least `TASK_STACK_DEPTH_MIN`.
+   * @return An ongoing builder.
+   */
+  AsyncVelControllerBuilder &withTaskStackDepth(std::uint16_t istackDepth);
+
+  /**
+   * Steps the PID, TBH, or bang-bang controller from a shared scheduler instead of starting an
+   * internal task for it. The integrated controller does not use a task, so this does nothing for
+   * it. Start the scheduler's task with `ControlScheduler::startThread`.
+   *
+   * @param ischeduler The scheduler.
+   * @return An ongoing builder.
+   */
+  AsyncVelControllerBuilder &withScheduler(const std::shared_ptr<ControlScheduler> &ischeduler);
+
   /**
    * Builds the AsyncVelocityController. Throws a std::runtime_exception is no motors were set.
    *
@@ -178,8 +230,12 @@ class AsyncVelControllerBuilder {
   bool sensorsSetByUser{false}; // Used so motors don't overwrite sensors set manually
   std::shared_ptr<RotarySensor> sensor;
 
-  bool hasGains{false}; // Whether gains were passed, no gains means integrated control
+  // Which gains were passed last, no gains means integrated control
+  enum class ControllerType { integrated, pid, tbh, bangBang };
+  ControllerType controllerType{ControllerType::integrated};
   IterativeVelPIDController::Gains gains;
+  IterativeTBHController::Gains tbhGains;
+  IterativeBangBangController::Gains bangBangGains;
 
   bool hasVelMath{false}; // Used to verify velMath was passed
   std::unique_ptr<VelMath> velMath;
@@ -196,8 +252,18 @@ class AsyncVelControllerBuilder {
   std::shared_ptr<Logger> controllerLogger = Logger::getDefaultLogger();
 
   bool isParentedToCurrentTask{true};
+  std::uint32_t taskPriority{TASK_PRIORITY_DEFAULT};
+  std::uint16_t taskStackDepth{TASK_STACK_DEPTH_DEFAULT};
+  std::shared_ptr<ControlScheduler> scheduler{nullptr};
 
   std::shared_ptr<AsyncVelIntegratedController> buildAVIC();
   std::shared_ptr<AsyncVelPIDController> buildAVPC();
+  std::shared_ptr<AsyncVelTBHController> buildAVTC();
+  std::shared_ptr<AsyncVelBangBangController> buildAVBC();
+
+  /**
+   * Starts the task of a controller built on AsyncWrapper, or steps it from the scheduler.
+   */
+  void startWrapper(AsyncWrapper<double, double> &icontroller);
 };
 } // namespace okapi
@@ -0,0 +1,33 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#pragma once
+
+#include "okapi/api/control/util/relayTuner.hpp"
+#include <memory>
+
+namespace okapi {
+class RelayTunerFactory {
+  public:
+  static RelayTuner create(const std::shared_ptr<ControllerInput<double>> &iinput,
+                           const std::shared_ptr<ControllerOutput<double>> &ioutput,
+                           double igoal,
+                           double irelayAmplitude = 1,
+                           double ihysteresis = 0,
+                           std::size_t inumCycles = 3,
+                           QTime itimeout = 10_s,
+                           const std::shared_ptr<Logger> &ilogger = Logger::getDefaultLogger());
+
+  static std::unique_ptr<RelayTuner>
+  createPtr(const std::shared_ptr<ControllerInput<double>> &iinput,
+            const std::shared_ptr<ControllerOutput<double>> &ioutput,
+            double igoal,
+            double irelayAmplitude = 1,
+            double ihysteresis = 0,
+            std::size_t inumCycles = 3,
+            QTime itimeout = 10_s,
+            const std::shared_ptr<Logger> &ilogger = Logger::getDefaultLogger());
+};
+} // namespace okapi
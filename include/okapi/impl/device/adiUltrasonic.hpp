@@ -6,12 +6,13 @@
 #pragma once
 
 #include "api.h"
-#include "okapi/api/control/controllerInput.hpp"
+#include "okapi/api/device/abstractPingSensor.hpp"
 #include "okapi/api/filter/passthroughFilter.hpp"
 #include <memory>
+#include <tuple>
 
 namespace okapi {
-class ADIUltrasonic : public ControllerInput<double> {
+class ADIUltrasonic : public AbstractPingSensor {
   public:
   /**
    * An ultrasonic sensor in the ADI (3-wire) ports.
@@ -64,7 +65,24 @@ class ADIUltrasonic : public ControllerInput<double> {
    */
   virtual double controllerGet() override;
 
+  /**
+   * Configure the ports as an ultrasonic again, so the sensor starts pinging. The sensor pings from
+   * when it is made; this is only needed after `stopPinging()`.
+   *
+   * @return ``1`` or ``PROS_ERR``.
+   */
+  std::int32_t startPinging() override;
+
+  /**
+   * Stop the sensor pinging, so it doesn't interfere with other ultrasonics. The sensor reads
+   * ``PROS_ERR`` until `startPinging()` is called.
+   *
+   * @return ``1`` or ``PROS_ERR``.
+   */
+  std::int32_t stopPinging() override;
+
   protected:
+  std::tuple<std::uint8_t, std::uint8_t, std::uint8_t> ports;
   pros::c::ext_adi_ultrasonic_t ultra;
   std::unique_ptr<Filter> filter;
 };
@@ -0,0 +1,54 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#pragma once
+
+#include "api.h"
+#include "okapi/api/control/controllerInput.hpp"
+
+namespace okapi {
+class Battery : public ControllerInput<double> {
+  public:
+  /**
+   * The V5 battery.
+   *
+   * ```cpp
+   * auto battery = std::make_shared<Battery>();
+   * ```
+   */
+  Battery() = default;
+
+  virtual ~Battery() = default;
+
+  /**
+   * Get the battery voltage in mV.
+   *
+   * @return The battery voltage in mV, or ``PROS_ERR`` on a failure.
+   */
+  double get() const;
+
+  /**
+   * Get the battery current in mA.
+   *
+   * @return The battery current in mA, or ``PROS_ERR`` on a failure.
+   */
+  double getCurrent() const;
+
+  /**
+   * Get the battery capacity in percent.
+   *
+   * @return The battery capacity in percent, or ``PROS_ERR_F`` on a failure.
+   */
+  double getCapacity() const;
+
+  /**
+   * Get the sensor value for use in a control loop. This method might be automatically called in
+   * another thread by the controller.
+   *
+   * @return The same as [get](@ref okapi::Battery::get).
+   */
+  double controllerGet() override;
+};
+} // namespace okapi
@@ -7,7 +7,9 @@
 
 #include "api.h"
 #include "okapi/api/device/button/buttonBase.hpp"
+#include "okapi/impl/device/button/controllerButtonEventService.hpp"
 #include "okapi/impl/device/controllerUtil.hpp"
+#include <memory>
 
 namespace okapi {
 class ControllerButton : public ButtonBase {
@@ -29,9 +31,25 @@ class ControllerButton : public ButtonBase {
    */
   ControllerButton(ControllerId icontroller, ControllerDigital ibtn, bool iinverted = false);
 
+  /**
+   * A button on a Controller which reads the state sampled by a ControllerButtonEventService
+   * instead of asking the kernel each time.
+   *
+   * @param iservice The service which samples the button's controller.
+   * @param icontroller The Controller the button is on.
+   * @param ibtn The button id.
+   * @param iinverted Whether the button is inverted (default pressed instead of default released).
+   */
+  ControllerButton(std::shared_ptr<ControllerButtonEventService> iservice,
+                   ControllerId icontroller,
+                   ControllerDigital ibtn,
+                   bool iinverted = false);
+
   protected:
   pros::controller_id_e_t id;
   pros::controller_digital_e_t btn;
+  std::shared_ptr<ControllerButtonEventService> service;
+  std::uint8_t serviceButtonId{0};
 
   virtual bool currentlyPressed() override;
 };
@@ -0,0 +1,64 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#pragma once
+
+#include "api.h"
+#include "okapi/api/device/button/buttonEventService.hpp"
+#include "okapi/impl/device/controllerUtil.hpp"
+#include <initializer_list>
+
+namespace okapi {
+/**
+ * A ButtonEventService which samples every button of the V5 controllers in one pass per tick.
+ * Events carry the id from `buttonId()`. ControllerButtons made with this service read the
+ * sampled state instead of asking the kernel.
+ */
+class ControllerButtonEventService : public ButtonEventService {
+  public:
+  /**
+   * Samples every button of the controllers. The sampling task is started.
+   *
+   * @param icontrollers The controllers to sample.
+   * @param isamplePeriod The time between samples.
+   * @param iqueueCapacity The number of events the queue holds.
+   * @param ilogger The logger this instance will log to.
+   */
+  explicit ControllerButtonEventService(
+    const std::initializer_list<ControllerId> &icontrollers = {ControllerId::master},
+    const QTime &isamplePeriod = defaultSamplePeriod,
+    std::size_t iqueueCapacity = defaultQueueCapacity,
+    std::shared_ptr<Logger> ilogger = Logger::getDefaultLogger());
+
+  /**
+   * @param icontroller The controller the button is on.
+   * @param ibtn The button.
+   * @return The id of the button in the events of this service.
+   */
+  static std::uint8_t buttonId(ControllerId icontroller, ControllerDigital ibtn);
+
+  /**
+   * Adds a function called for each event of a button.
+   *
+   * @param icontroller The controller the button is on.
+   * @param ibtn The button.
+   * @param icallback The function to call.
+   */
+  void addCallback(ControllerId icontroller, ControllerDigital ibtn, Callback icallback);
+
+  /**
+   * @param icontroller The controller the button is on.
+   * @param ibtn The button.
+   * @return Whether the button was pressed in the last sample.
+   */
+  bool isPressed(ControllerId icontroller, ControllerDigital ibtn) const;
+
+  using ButtonEventService::addCallback;
+  using ButtonEventService::isPressed;
+
+  protected:
+  static Sampler makeSampler(const std::initializer_list<ControllerId> &icontrollers);
+};
+} // namespace okapi
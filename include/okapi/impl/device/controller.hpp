@@ -9,8 +9,49 @@
 #include "okapi/impl/device/button/controllerButton.hpp"
 #include "okapi/impl/device/controllerUtil.hpp"
 #include <array>
+#include <cstdint>
 
 namespace okapi {
+/**
+ * Every analog axis and digital button of a controller, read together by
+ * `Controller::snapshot()`.
+ */
+struct ControllerSnapshot {
+  /**
+   * Whether the controller was connected. Every axis reads 0 and every button reads released if it
+   * was not.
+   */
+  bool connected{false};
+
+  /**
+   * The axes in the range [-1, 1], indexed by ControllerAnalog.
+   */
+  std::array<float, 4> analog{};
+
+  /**
+   * The buttons, one bit per button starting from L1 in the order of ControllerDigital. A set bit
+   * means pressed.
+   */
+  std::uint16_t digital{0};
+
+  /**
+   * @param ichannel the channel to read
+   * @return the value of that channel in the range [-1, 1]
+   */
+  float getAnalog(const ControllerAnalog ichannel) const {
+    return analog[static_cast<std::size_t>(ichannel)];
+  }
+
+  /**
+   * @param ibutton the button to check
+   * @return true if the button was pressed
+   */
+  bool getDigital(const ControllerDigital ibutton) const {
+    const auto bit = static_cast<int>(ibutton) - static_cast<int>(ControllerDigital::L1);
+    return (digital >> bit) & 1u;
+  }
+};
+
 class Controller {
   public:
   Controller(ControllerId iid = ControllerId::master);
@@ -33,6 +74,16 @@ class Controller {
    */
   virtual float getAnalog(ControllerAnalog ichannel);
 
+  /**
+   * Returns the current analog reading for the channel as the controller reports it, in the range
+   * [-127, 127]. Use this to index a JoystickCurve directly. Returns 0 if the controller is not
+   * connected.
+   *
+   * @param ichannel the channel to read
+   * @return the value of that channel in the range [-127, 127]
+   */
+  virtual std::int32_t getAnalogRaw(ControllerAnalog ichannel);
+
   /**
    * Returns whether the digital button is currently pressed. Returns false if the controller is
    * not connected.
@@ -42,6 +93,15 @@ class Controller {
    */
   virtual bool getDigital(ControllerDigital ibutton);
 
+  /**
+   * Reads every analog axis and digital button at once. Use this once per iteration of a control
+   * loop so every input in it comes from one consistent sample, instead of reading the controller
+   * again for each axis and button. If the controller is not connected, nothing else is read.
+   *
+   * @return the state of the controller
+   */
+  virtual ControllerSnapshot snapshot();
+
   /**
    * Returns a ControllerButton for the given button on this controller.
    *
@@ -51,7 +111,8 @@ class Controller {
   virtual ControllerButton &operator[](ControllerDigital ibtn);
 
   /**
-   * Sets text to the controller LCD screen.
+   * Sets text to the controller LCD screen. The controller drops writes which arrive less than
+   * 50 ms apart; use a ControllerScreen to update the screen often.
    *
    * @param iline the line number in the range [0-2] at which the text will be displayed
    * @param icol the column number in the range [0-14] at which the text will be displayed
@@ -0,0 +1,35 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#pragma once
+
+#include "api.h"
+#include "okapi/api/device/controllerDisplayService.hpp"
+#include "okapi/impl/device/controllerUtil.hpp"
+
+namespace okapi {
+/**
+ * A ControllerDisplayService which writes to the screen of a V5 controller. Use this instead of
+ * `Controller::setText()` and `Controller::rumble()` when updating the screen often. The whole
+ * screen is sent again when the controller reconnects.
+ */
+class ControllerScreen : public ControllerDisplayService {
+  public:
+  /**
+   * Buffers writes to the screen of a controller. The writing task is started.
+   *
+   * @param icontroller The controller.
+   * @param iwritePeriod The time between writes.
+   * @param ilogger The logger this instance will log to.
+   */
+  explicit ControllerScreen(ControllerId icontroller = ControllerId::master,
+                            const QTime &iwritePeriod = defaultWritePeriod,
+                            std::shared_ptr<Logger> ilogger = Logger::getDefaultLogger());
+
+  protected:
+  static TextWriter makeTextWriter(ControllerScreen *iscreen, pros::controller_id_e_t iid);
+  static RumbleWriter makeRumbleWriter(pros::controller_id_e_t iid);
+};
+} // namespace okapi
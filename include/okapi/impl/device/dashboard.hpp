@@ -0,0 +1,45 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#pragma once
+
+#include "api.h"
+#include "display/lvgl.h"
+#include "okapi/api/device/dashboardService.hpp"
+#include <array>
+
+namespace okapi {
+/**
+ * A DashboardService which draws on the screen of the V5 brain, in two columns of labels. Only the
+ * labels whose text changed are set, so LVGL only redraws their part of the screen. The dashboard
+ * is opt in: nothing is drawn until one is made.
+ */
+class Dashboard : public DashboardService {
+  public:
+  /**
+   * Draws fields on the brain screen. The refresh task is started at the lowest priority.
+   *
+   * @param irefreshPeriod The time between refreshes, at least `minRefreshPeriod`.
+   * @param iparent The LVGL object to draw in, or `nullptr` for the active screen.
+   * @param ilogger The logger this instance will log to.
+   */
+  explicit Dashboard(const QTime &irefreshPeriod = defaultRefreshPeriod,
+                     lv_obj_t *iparent = nullptr,
+                     std::shared_ptr<Logger> ilogger = Logger::getDefaultLogger());
+
+  /**
+   * Stops the refresh task and removes the dashboard from the screen.
+   */
+  ~Dashboard() override;
+
+  protected:
+  static constexpr lv_coord_t rowHeight = 24;
+
+  lv_obj_t *container;
+  std::array<lv_obj_t *, maxCells> labels{};
+
+  static CellWriter makeCellWriter(Dashboard *idashboard);
+};
+} // namespace okapi
@@ -7,6 +7,7 @@
 
 #include "api.h"
 #include "okapi/api/control/controllerOutput.hpp"
+#include "okapi/api/device/motor/motorLinearizer.hpp"
 #include "okapi/api/util/logging.hpp"
 
 namespace okapi {
@@ -47,7 +48,7 @@ class ADIMotor : public ControllerOutput<double> {
            const std::shared_ptr<Logger> &logger = Logger::getDefaultLogger());
 
   /**
-   * Set the voltage to the motor.
+   * Set the voltage to the motor. The voltage is mapped by the linearizer before it is sent.
    *
    * @param ivoltage voltage in the range [-127, 127].
    */
@@ -61,9 +62,39 @@ class ADIMotor : public ControllerOutput<double> {
    */
   void controllerSet(double ivalue) override;
 
+  /**
+   * Sets the map applied to every voltage before it is sent, so the speed of the motor is
+   * proportional to the voltage asked for. Set this before the motor is used by a controller.
+   *
+   * @param ilinearizer The map.
+   */
+  void setLinearizer(const MotorLinearizer &ilinearizer);
+
+  /**
+   * @return The map applied to every voltage before it is sent.
+   */
+  const MotorLinearizer &getLinearizer() const;
+
+  /**
+   * Measures the response of the motor with `MotorLinearizer::calibrate()` and uses the result as
+   * the linearizer. Print `getTable()` of the result to hard code it instead of calibrating every
+   * time.
+   *
+   * @param isensor A sensor which measures the position of the motor.
+   * @param istep The PWM difference between measurements.
+   * @param isettleTime The time the motor is given to reach a steady speed.
+   * @param isampleTime The time the speed is measured over.
+   * @return The new linearizer.
+   */
+  MotorLinearizer calibrateLinearizer(const std::shared_ptr<RotarySensor> &isensor,
+                                      std::int32_t istep = 8,
+                                      QTime isettleTime = 500_ms,
+                                      QTime isampleTime = 250_ms);
+
   protected:
   std::uint8_t smartPort;
   std::uint8_t port;
   std::int8_t reversed;
+  MotorLinearizer linearizer{};
 };
 } // namespace okapi
@@ -7,9 +7,32 @@
 
 #include "api.h"
 #include "okapi/api/device/motor/abstractMotor.hpp"
+#include "okapi/api/device/motor/motorWriteCoalescer.hpp"
 #include "okapi/api/util/logging.hpp"
 
 namespace okapi {
+/**
+ * The telemetry of a Motor at one instant, see Motor::refresh(). Values which depend on the
+ * direction of the motor are already reversed if the motor is reversed.
+ */
+struct MotorSnapshot {
+  double position{0};
+  double targetPosition{0};
+  double actualVelocity{0};
+  std::int32_t targetVelocity{0};
+  std::int32_t currentDraw{0};
+  std::int32_t direction{0};
+  double efficiency{0};
+  double power{0};
+  double temperature{0};
+  double torque{0};
+  std::int32_t voltage{0};
+  std::uint32_t faults{0};
+  std::uint32_t flags{0};
+  std::int32_t rawPosition{0};
+  std::uint32_t timestamp{0};
+};
+
 class Motor : public AbstractMotor {
   public:
   /**
@@ -450,8 +473,51 @@ class Motor : public AbstractMotor {
    */
   bool isReversed() const;
 
+  /**
+   * Reads all of the motor's telemetry from the kernel into a snapshot, in one call per field. In
+   * snapshot mode, the telemetry getters return the values from this snapshot instead of asking
+   * the kernel, so a control loop can refresh once per tick and read the motor as often as it
+   * likes for free.
+   */
+  virtual void refresh();
+
+  /**
+   * Sets whether the telemetry getters return the values from the last refresh() (snapshot mode)
+   * or read them from the kernel. Turning snapshot mode on refreshes the snapshot. The snapshot is
+   * not synchronized, so refresh() and the getters should be called from the same task while
+   * snapshot mode is on.
+   *
+   * @param ienabled Whether to use snapshot mode.
+   */
+  virtual void setSnapshotMode(bool ienabled);
+
+  /**
+   * @return Whether the telemetry getters return the values from the last refresh().
+   */
+  bool isSnapshotMode() const;
+
+  /**
+   * @return The telemetry from the last refresh().
+   */
+  const MotorSnapshot &getSnapshot() const;
+
+  /**
+   * Sets whether `moveVelocity()` and `moveVoltage()` skip the kernel call when the command is the
+   * same as the last one sent. A repeated command is still sent once every refresh period. Any
+   * other movement command, a failed write, or reversing the motor makes the next command be sent.
+   * Commands sent to the same port through another Motor are not seen by this one, so coalescing
+   * should only be enabled when this is the only Motor commanding the port.
+   *
+   * @param ienabled Whether to skip repeated commands.
+   * @param irefreshPeriod The longest time a repeated command is skipped for.
+   */
+  virtual void setWriteCoalescing(bool ienabled, QTime irefreshPeriod = 100_ms);
+
   protected:
   std::uint8_t port;
   std::int8_t reversed{1};
+  MotorSnapshot snapshot;
+  bool snapshotMode{false};
+  MotorWriteCoalescer writeCoalescer;
 };
 } // namespace okapi
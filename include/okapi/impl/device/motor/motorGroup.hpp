@@ -6,12 +6,55 @@
 #pragma once
 
 #include "okapi/api/device/motor/abstractMotor.hpp"
+#include "okapi/api/device/motor/motorLoadBalancer.hpp"
+#include "okapi/api/device/motor/motorWriteCoalescer.hpp"
 #include "okapi/api/util/logging.hpp"
 #include "okapi/impl/device/motor/motor.hpp"
 #include <initializer_list>
+#include <memory>
 #include <vector>
 
 namespace okapi {
+/**
+ * The telemetry of every motor in a MotorGroup, reduced over the motors which responded. A motor
+ * whose reading fails (for example, because it is unplugged) is left out of that reading's field.
+ * Fields which no motor responded to are `PROS_ERR_F`.
+ */
+struct MotorGroupTelemetry {
+  /**
+   * One telemetry field reduced over the motors.
+   */
+  struct Field {
+    double mean{0};
+    double max{0};
+    double sum{0};
+  };
+
+  Field position;
+  Field actualVelocity;
+  Field currentDraw;
+  Field efficiency;
+  Field power;
+  Field temperature;
+  Field torque;
+  Field voltage;
+
+  /**
+   * The faults of every motor, or'd together.
+   */
+  std::uint32_t faults{0};
+
+  /**
+   * The flags of every motor, or'd together.
+   */
+  std::uint32_t flags{0};
+
+  /**
+   * The number of motors whose position could be read.
+   */
+  std::size_t respondingMotors{0};
+};
+
 class MotorGroup : public AbstractMotor {
   public:
   /**
@@ -82,6 +125,9 @@ class MotorGroup : public AbstractMotor {
    * is held with PID to ensure consistent speed, as opposed to setting the motor's
    * voltage.
    *
+   * Load balancing does not trim velocity commands; each motor holds the velocity with its own
+   * PID. Use `moveVoltage()` to balance the load.
+   *
    * @param ivelocity The new motor velocity from -+-100, +-200, or +-600 depending on the motor's
    * gearset
    * @return 1 if the operation was successful or `PROS_ERR` if the operation failed, setting errno.
@@ -91,6 +137,8 @@ class MotorGroup : public AbstractMotor {
   /**
    * Sets the voltage for the motor from `-12000` to `12000`.
    *
+   * When load balancing is enabled, each motor's voltage is trimmed to share the load.
+   *
    * @param ivoltage The new voltage value from `-12000` to `12000`.
    * @return 1 if the operation was successful or `PROS_ERR` if the operation failed, setting errno.
    */
@@ -394,7 +442,71 @@ class MotorGroup : public AbstractMotor {
    */
   virtual std::shared_ptr<ContinuousRotarySensor> getEncoder(std::size_t index);
 
+  /**
+   * Reads the telemetry of every motor in one pass and reduces each field over the motors which
+   * responded.
+   *
+   * @return The telemetry of the group.
+   */
+  virtual MotorGroupTelemetry getTelemetry();
+
+  /**
+   * Sets whether the telemetry getters read every motor instead of only the first one. When
+   * enabled, the position, velocity, efficiency, and voltage are the mean over the motors, the
+   * current draw, power, and torque are the sum, the temperature is the max, the faults and flags
+   * are or'd together, and `isOverCurrent()` and `isOverTemp()` are true if any motor is. The
+   * other getters still read the first motor. Motors whose reading fails are left out, so an
+   * unplugged motor does not corrupt the result. Disabled by default.
+   *
+   * @param ienabled Whether to aggregate the telemetry of every motor.
+   */
+  virtual void setAggregateTelemetry(bool ienabled);
+
+  /**
+   * @return Whether the telemetry getters read every motor.
+   */
+  bool isAggregateTelemetry() const;
+
+  /**
+   * Sets whether `moveVelocity()` and `moveVoltage()` skip writing to every motor when the command
+   * is the same as the last one the group sent. A repeated command is still sent once every
+   * refresh period. Any other movement command, a failed write, or reversing the group makes the
+   * next command be sent. Commands sent to the motors outside of this group are not seen by it, so
+   * coalescing should only be enabled when the group is the only thing commanding its motors.
+   *
+   * @param ienabled Whether to skip repeated commands.
+   * @param irefreshPeriod The longest time a repeated command is skipped for.
+   */
+  virtual void setWriteCoalescing(bool ienabled, QTime irefreshPeriod = 100_ms);
+
+  /**
+   * Sets whether the group trims the command of each motor so the motors draw the same current.
+   * Linked motors which are worn differently do not share the load evenly, so the one which works
+   * hardest overheats and is throttled first. Each `moveVoltage()` reads the velocity and current
+   * of every motor and moves its trim towards the mean current of the group. A motor which can't
+   * be read or moves differently from the rest of the group is given the command untrimmed.
+   *
+   * Only voltage commands are balanced. The velocity loop of each motor runs on the motor and holds
+   * its velocity between commands, which a voltage trim can't do, so `moveVelocity()` drives every
+   * motor at the velocity untrimmed. Balancing reads every motor on every voltage command, so it
+   * costs more than an untrimmed command.
+   * Enabling it again starts from no trims.
+   *
+   * @param ienabled Whether to balance the load.
+   * @param iparams The settings of the balancing.
+   */
+  virtual void setLoadBalancing(bool ienabled, const MotorLoadBalancerParams &iparams = {});
+
+  /**
+   * @return Whether the group balances the load between its motors.
+   */
+  bool isLoadBalancing() const;
+
   protected:
   std::vector<std::shared_ptr<AbstractMotor>> motors;
+  bool aggregateTelemetry{false};
+  MotorWriteCoalescer writeCoalescer;
+  std::unique_ptr<MotorLoadBalancer> loadBalancer;
+  std::uint32_t lastBalanceTime{0};
 };
 } // namespace okapi
@@ -8,6 +8,7 @@
 #include "api.h"
 #include "okapi/api/control/controllerInput.hpp"
 #include "okapi/api/device/rotarysensor/continuousRotarySensor.hpp"
+#include "okapi/api/units/QTime.hpp"
 
 namespace okapi {
 enum class IMUAxes {
@@ -16,6 +17,42 @@ enum class IMUAxes {
   x  ///< Roll Axis
 };
 
+/**
+ * Everything an IMU measures, read together by `IMU::getSample()`.
+ */
+struct IMUSample {
+  /**
+   * The rotation about the configured axis, the same as `IMU::get()`.
+   */
+  double angle{0};
+
+  /**
+   * The Euler angles in degrees. These do not account for `IMU::reset()`.
+   */
+  double pitch{0};
+  double roll{0};
+  double yaw{0};
+
+  /**
+   * The rotation rates about each axis in degrees per second.
+   */
+  double gyroX{0};
+  double gyroY{0};
+  double gyroZ{0};
+
+  /**
+   * The accelerations along each axis in g.
+   */
+  double accelX{0};
+  double accelY{0};
+  double accelZ{0};
+
+  /**
+   * Whether the sensor could be read. Every other field is zero if it could not.
+   */
+  bool valid{false};
+};
+
 class IMU : public ContinuousRotarySensor {
   public:
   /**
@@ -55,6 +92,14 @@ class IMU : public ContinuousRotarySensor {
    */
   double getAcceleration() const;
 
+  /**
+   * Read the angles, rotation rates, and accelerations of every axis at once. This takes three
+   * reads from the sensor, instead of one read per axis and value.
+   *
+   * @return Everything the IMU measures.
+   */
+  IMUSample getSample() const;
+
   /**
    * Reset the rotation value to zero.
    *
@@ -80,6 +125,38 @@ class IMU : public ContinuousRotarySensor {
    */
   std::int32_t calibrate();
 
+  /**
+   * Start calibrating the IMU without waiting for it to finish, so other setup can run during the
+   * two seconds calibration takes. Resets the rotation value to zero. Use
+   * [isCalibrated](@ref okapi::IMU::isCalibrated) to check whether it finished, or
+   * [waitForCalibration](@ref okapi::IMU::waitForCalibration) to wait for it.
+   *
+   * ```cpp
+   * imu.calibrateAsync();
+   * // Load paths, set up the other sensors, ...
+   * imu.waitForCalibration();
+   * ```
+   *
+   * @return ``1`` or ``PROS_ERR``.
+   */
+  std::int32_t calibrateAsync();
+
+  /**
+   * @return Whether the calibration started by
+   * [calibrateAsync](@ref okapi::IMU::calibrateAsync) finished. This is false for the first two
+   * seconds of calibration, before the status of the IMU can be trusted.
+   */
+  bool isCalibrated() const;
+
+  /**
+   * Wait for the calibration started by [calibrateAsync](@ref okapi::IMU::calibrateAsync) to
+   * finish. The wait is bounded to five seconds after calibration started.
+   *
+   * @return ``1``, or ``PROS_ERR`` with ``errno`` set to ``EAGAIN`` if calibration did not
+   * finish in time.
+   */
+  std::int32_t waitForCalibration();
+
   /**
    * Get the sensor value for use in a control loop. This method might be automatically called in
    * another thread by the controller.
@@ -88,6 +165,16 @@ class IMU : public ContinuousRotarySensor {
    */
   double controllerGet() override;
 
+  /**
+   * Sets how often the IMU sends new readings. The kernel copies readings every 10 ms, so a
+   * shorter period keeps each reading fresher rather than giving more of them.
+   *
+   * @param iperiod The time between readings, rounded down to a multiple of 5 ms and at least
+   * 5 ms. The default is 10 ms.
+   * @return ``1`` or ``PROS_ERR``.
+   */
+  std::int32_t setDataRate(QTime iperiod);
+
   /**
    * @return Whether the IMU is calibrating.
    */
@@ -97,6 +184,7 @@ class IMU : public ContinuousRotarySensor {
   std::uint8_t port;
   IMUAxes axis;
   double offset = 0;
+  std::uint32_t calibrationStart = 0;
 
   /**
    * Get the current rotation about the configured axis. The internal offset is not accounted for
@@ -15,7 +15,8 @@ class ADIGyro : public ContinuousRotarySensor {
   /**
    * A gyroscope on the given ADI port. If the port has not previously been configured as a gyro,
    * then the constructor will block for 1 second for calibration. The gyro measures in tenths of a
-   * degree, so there are ``3600`` measurement points per revolution.
+   * degree, so there are ``3600`` measurement points per revolution. Wrap it in a
+   * DriftCompensatedGyro to estimate its bias without blocking and remove its drift.
    *
    * ```cpp
    * auto gyro = ADIGyro('A');
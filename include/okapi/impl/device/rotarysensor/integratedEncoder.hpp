@@ -34,6 +34,15 @@ class IntegratedEncoder : public ContinuousRotarySensor {
    */
   virtual double get() const override;
 
+  /**
+   * Get the current sensor value and the time the motor measured it.
+   *
+   * @param otimestamp Set to the time the value was measured in milliseconds since the program
+   * started.
+   * @return the current sensor value, or ``PROS_ERR`` on a failure.
+   */
+  double getTimestamped(std::uint32_t &otimestamp) const override;
+
   /**
    * Reset the sensor to zero.
    *
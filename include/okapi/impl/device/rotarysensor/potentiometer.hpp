@@ -6,7 +6,9 @@
 #pragma once
 
 #include "api.h"
+#include "okapi/api/device/rotarysensor/potentiometerCalibration.hpp"
 #include "okapi/api/device/rotarysensor/rotarySensor.hpp"
+#include <memory>
 
 namespace okapi {
 class Potentiometer : public RotarySensor {
@@ -36,12 +38,28 @@ class Potentiometer : public RotarySensor {
   Potentiometer(std::pair<std::uint8_t, std::uint8_t> iports);
 
   /**
-   * Get the current sensor value.
+   * Get the current sensor value. This is the angle of the mechanism if a calibration is set, and
+   * the raw reading otherwise.
    *
    * @return the current sensor value, or ``PROS_ERR`` on a failure.
    */
   virtual double get() const override;
 
+  /**
+   * Get the raw reading, without the calibration. Use this to find the readings to calibrate with.
+   *
+   * @return the raw reading in the range ``[0, 4095]``, or ``PROS_ERR`` on a failure.
+   */
+  std::int32_t getRaw() const;
+
+  /**
+   * Sets the map from raw readings to the angle of the mechanism. Set this before the sensor is
+   * used by a controller. Several potentiometers can share one calibration.
+   *
+   * @param icalibration The calibration, or ``nullptr`` to read raw values.
+   */
+  void setCalibration(std::shared_ptr<const PotentiometerCalibration> icalibration);
+
   /**
    * Get the sensor value for use in a control loop. This method might be automatically called in
    * another thread by the controller.
@@ -53,5 +71,6 @@ class Potentiometer : public RotarySensor {
   protected:
   std::uint8_t smartPort;
   std::uint8_t port;
+  std::shared_ptr<const PotentiometerCalibration> calibration{nullptr};
 };
 } // namespace okapi
@@ -55,7 +55,22 @@ class RotationSensor : public ContinuousRotarySensor {
    * @return The current rotational velocity estimate in degrees per second or ``PROS_ERR_F`` if the
    * operation failed, setting ``errno``.
    */
-  double getVelocity() const;
+  double getVelocity() const override;
+
+  /**
+   * @return ``true``, the sensor measures its velocity.
+   */
+  bool measuresVelocity() const override;
+
+  /**
+   * @return The V5 port the device uses.
+   */
+  std::uint8_t getPort() const;
+
+  /**
+   * @return Whether the sensor is reversed.
+   */
+  bool isReversed() const;
 
   protected:
   std::uint8_t port;
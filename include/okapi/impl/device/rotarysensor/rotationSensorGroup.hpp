@@ -0,0 +1,48 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#pragma once
+
+#include "api.h"
+#include "okapi/api/device/rotarysensor/rotarySensorGroup.hpp"
+#include "okapi/impl/device/rotarysensor/rotationSensor.hpp"
+#include <vector>
+
+namespace okapi {
+/**
+ * A RotarySensorGroup of rotation sensors which reads them straight from the kernel, in one tight
+ * loop, instead of through each sensor.
+ *
+ * ```cpp
+ * auto group = std::make_shared<RotationSensorGroup>(
+ *   std::vector<RotationSensor>{RotationSensor(1), RotationSensor(2, true), RotationSensor(3)});
+ * ```
+ */
+class RotationSensorGroup : public RotarySensorGroup {
+  public:
+  /**
+   * @param isensors The sensors, in the order they are read in.
+   */
+  explicit RotationSensorGroup(const std::vector<RotationSensor> &isensors);
+
+  /**
+   * Reads every sensor, back to back. The rotation sensor does not report when it measured, so
+   * every timestamp is zero.
+   *
+   * @param ovalues The rotations in degrees are written here, or ``PROS_ERR_F`` for sensors which
+   * failed to read.
+   * @param otimestamps Zeros are written here.
+   * @return The number of readings written.
+   */
+  std::size_t read(double *ovalues, std::uint32_t *otimestamps) const override;
+
+  protected:
+  std::vector<std::uint8_t> ports;
+  std::vector<double> scales;
+
+  static std::vector<std::shared_ptr<ContinuousRotarySensor>>
+  share(const std::vector<RotationSensor> &isensors);
+};
+} // namespace okapi
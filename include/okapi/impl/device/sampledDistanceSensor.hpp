@@ -0,0 +1,45 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#pragma once
+
+#include "api.h"
+#include "okapi/api/device/sensorSamplingService.hpp"
+#include "okapi/api/filter/medianFilter.hpp"
+#include <memory>
+
+namespace okapi {
+class SampledDistanceSensor : public SensorSamplingService {
+  public:
+  /**
+   * The confidence below which readings are dropped, by default. The sensor reports confidence in
+   * the range [0, 63].
+   */
+  static constexpr double defaultMinConfidence = 32;
+
+  /**
+   * A distance sensor on a V5 port, read from a task. Readings the sensor has little confidence in
+   * are dropped, and the rest go through a median filter, so `get()` returns the latest distance
+   * in mm without waiting on the sensor. The sampling task is started.
+   *
+   * ```cpp
+   * auto ds = SampledDistanceSensor(1);
+   * auto strictDs = SampledDistanceSensor(1, std::make_unique<MedianFilter<7>>(), 50);
+   * ```
+   *
+   * @param iport The V5 port the device uses.
+   * @param ifilter The filter the accepted distances are run through.
+   * @param iminConfidence Readings with a confidence below this are dropped.
+   * @param isamplePeriod The time between samples. The sensor updates about every 33 ms.
+   * @param ilogger The logger this instance will log to.
+   */
+  explicit SampledDistanceSensor(
+    std::uint8_t iport,
+    std::unique_ptr<Filter> ifilter = std::make_unique<MedianFilter<5>>(),
+    double iminConfidence = defaultMinConfidence,
+    const QTime &isamplePeriod = 33_ms,
+    std::shared_ptr<Logger> ilogger = Logger::getDefaultLogger());
+};
+} // namespace okapi
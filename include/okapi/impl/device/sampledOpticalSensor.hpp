@@ -0,0 +1,40 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#pragma once
+
+#include "api.h"
+#include "okapi/api/device/sensorSamplingService.hpp"
+#include "okapi/api/filter/medianFilter.hpp"
+#include "okapi/impl/device/opticalSensor.hpp"
+#include <memory>
+
+namespace okapi {
+class SampledOpticalSensor : public SensorSamplingService {
+  public:
+  /**
+   * An optical sensor on a V5 port, read from a task. Readings go through a median filter, so
+   * `get()` returns the latest value without waiting on the sensor. The optical sensor doesn't
+   * report a confidence, so only failed reads are dropped. The sampling task is started.
+   *
+   * ```cpp
+   * auto hue = SampledOpticalSensor(1);
+   * auto brightness = SampledOpticalSensor(1, OpticalSensorOutput::brightness);
+   * ```
+   *
+   * @param iport The V5 port the device uses.
+   * @param ioutput Which sensor output to sample.
+   * @param ifilter The filter the readings are run through.
+   * @param isamplePeriod The time between samples.
+   * @param ilogger The logger this instance will log to.
+   */
+  explicit SampledOpticalSensor(
+    std::uint8_t iport,
+    OpticalSensorOutput ioutput = OpticalSensorOutput::hue,
+    std::unique_ptr<Filter> ifilter = std::make_unique<MedianFilter<5>>(),
+    const QTime &isamplePeriod = 20_ms,
+    std::shared_ptr<Logger> ilogger = Logger::getDefaultLogger());
+};
+} // namespace okapi
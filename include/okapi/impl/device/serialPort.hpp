@@ -0,0 +1,63 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#pragma once
+
+#include "api.h"
+#include "pros/serial.h"
+#include "okapi/api/device/abstractSerialPort.hpp"
+#include "okapi/api/util/logging.hpp"
+#include <memory>
+
+namespace okapi {
+class SerialPort : public AbstractSerialPort {
+  public:
+  /**
+   * A V5 smart port used as a generic serial port, for talking to a coprocessor through a
+   * `SerialLink`.
+   *
+   * ```cpp
+   * auto link = std::make_shared<SerialLink>(std::make_shared<SerialPort>(21, 115200),
+   *                                          TimeUtilFactory::createDefault());
+   * link->startThread();
+   * ```
+   *
+   * @param iport The V5 port the device uses.
+   * @param ibaudrate The baud rate.
+   * @param ilogger The logger this instance will log to.
+   */
+  SerialPort(std::uint8_t iport,
+             std::int32_t ibaudrate,
+             std::shared_ptr<Logger> ilogger = Logger::getDefaultLogger());
+
+  /**
+   * Reads the bytes which have already arrived, without blocking.
+   *
+   * @param obuffer The buffer to read into.
+   * @param ilength The most bytes to read.
+   * @return The number of bytes read, which is zero if none have arrived or the read failed.
+   */
+  std::size_t read(std::uint8_t *obuffer, std::size_t ilength) override;
+
+  /**
+   * Queues bytes to be sent, without blocking.
+   *
+   * @param ibuffer The bytes to send.
+   * @param ilength The number of bytes to send.
+   * @return The number of bytes queued, which is less than `ilength` if the transmit buffer is full
+   * and zero if the write failed.
+   */
+  std::size_t write(const std::uint8_t *ibuffer, std::size_t ilength) override;
+
+  /**
+   * @return The V5 port the device uses.
+   */
+  std::uint8_t getPort() const;
+
+  protected:
+  std::shared_ptr<Logger> logger;
+  std::uint8_t port;
+};
+} // namespace okapi
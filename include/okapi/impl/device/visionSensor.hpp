@@ -0,0 +1,45 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#pragma once
+
+#include "api.h"
+#include "okapi/api/device/visionSamplingService.hpp"
+#include <memory>
+
+namespace okapi {
+class VisionSensor : public VisionSamplingService {
+  public:
+  /**
+   * A vision sensor on a V5 port, read from a task. The largest objects the sensor sees are kept
+   * in a double buffer, so `getFrame()` returns the latest objects without waiting on the sensor.
+   * Coordinates are measured from the center of the image. The sampling task is started.
+   *
+   * ```cpp
+   * auto vision = VisionSensor(1);
+   * if (auto goal = vision.getFrame().findLargest(1)) {
+   *   // goal->x is the offset of the goal from the center of the image
+   * }
+   * ```
+   *
+   * @param iport The V5 port the device uses.
+   * @param isamplePeriod The time between samples. The sensor updates about every 20 ms.
+   * @param ilatency The time between when an image is captured and when it can be read.
+   * @param ilogger The logger this instance will log to.
+   */
+  explicit VisionSensor(std::uint8_t iport,
+                        const QTime &isamplePeriod = 20_ms,
+                        const QTime &ilatency = 30_ms,
+                        std::shared_ptr<Logger> ilogger = Logger::getDefaultLogger());
+
+  /**
+   * @return The V5 port the device uses.
+   */
+  std::uint8_t getPort() const;
+
+  protected:
+  std::uint8_t port;
+};
+} // namespace okapi
@@ -5,6 +5,8 @@
  */
 #pragma once
 
+#include "okapi/api/filter/alphaBetaVelMath.hpp"
+#include "okapi/api/filter/leastSquaresVelMath.hpp"
 #include "okapi/api/filter/velMath.hpp"
 #include <memory>
 
@@ -64,5 +66,41 @@ class VelMathFactory {
             std::unique_ptr<Filter> ifilter,
             QTime isampleTime = 0_ms,
             const std::shared_ptr<Logger> &ilogger = Logger::getDefaultLogger());
+
+  /**
+   * Velocity math helper which fits a quadratic to the last positions, see LeastSquaresVelMath.
+   * Throws a std::invalid_argument exception if iticksPerRev is zero or iwindowSize is less than
+   * three.
+   *
+   * @param iticksPerRev The number of ticks per revolution.
+   * @param iwindowSize The number of positions to fit.
+   * @param isampleTime The minimum time between samples.
+   * @param ilogger The logger this instance will log to.
+   */
+  static std::unique_ptr<VelMath>
+  createLeastSquaresPtr(double iticksPerRev,
+                        std::size_t iwindowSize = 7,
+                        QTime isampleTime = 10_ms,
+                        const std::shared_ptr<Logger> &ilogger = Logger::getDefaultLogger());
+
+  /**
+   * Velocity math helper which tracks the position with an alpha-beta filter, see
+   * AlphaBetaVelMath. Throws a std::invalid_argument exception if iticksPerRev is zero or the
+   * gains are invalid.
+   *
+   * @param iticksPerRev The number of ticks per revolution.
+   * @param ialpha The position gain.
+   * @param ibeta The velocity gain.
+   * @param igamma The acceleration gain.
+   * @param isampleTime The minimum time between samples.
+   * @param ilogger The logger this instance will log to.
+   */
+  static std::unique_ptr<VelMath>
+  createAlphaBetaPtr(double iticksPerRev,
+                     double ialpha,
+                     double ibeta,
+                     double igamma = 0,
+                     QTime isampleTime = 10_ms,
+                     const std::shared_ptr<Logger> &ilogger = Logger::getDefaultLogger());
 };
 } // namespace okapi
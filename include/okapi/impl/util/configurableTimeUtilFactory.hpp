@@ -9,20 +9,21 @@
 
 namespace okapi {
 /**
- * A TimeUtilFactory that supplies the SettledUtil parameters passed in the constructor to every
- * new TimeUtil instance.
+ * A TimeUtilFactory that supplies the SettledUtil parameters and clock resolution passed in the
+ * constructor to every new TimeUtil instance.
  */
 class ConfigurableTimeUtilFactory : public TimeUtilFactory {
   public:
   ConfigurableTimeUtilFactory(double iatTargetError = 50,
                               double iatTargetDerivative = 5,
-                              const QTime &iatTargetTime = 250_ms);
+                              const QTime &iatTargetTime = 250_ms,
+                              resolution iresolution = resolution::milliseconds);
 
   /**
-   * Creates a TimeUtil with the SettledUtil parameters specified in the constructor by
-   * delegating to TimeUtilFactory::withSettledUtilParams.
+   * Creates a TimeUtil with the SettledUtil parameters and resolution specified in the constructor
+   * by delegating to TimeUtilFactory::withSettledUtilParams.
    *
-   * @return A TimeUtil with the SettledUtil parameters specified in the constructor.
+   * @return A TimeUtil with the SettledUtil parameters and resolution specified in the constructor.
    */
   TimeUtil create() override;
 
@@ -30,5 +31,6 @@ class ConfigurableTimeUtilFactory : public TimeUtilFactory {
   double atTargetError;
   double atTargetDerivative;
   QTime atTargetTime;
+  resolution timeResolution;
 };
 } // namespace okapi
@@ -0,0 +1,57 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#pragma once
+
+#include "okapi/api/util/abstractRate.hpp"
+#include <cstdint>
+
+namespace okapi {
+class HybridRate : public AbstractRate {
+  public:
+  /**
+   * A Rate which can wake a task at a fraction of a millisecond. It sleeps through most of each
+   * period like Rate, waking up ispinWindow early, and then spins on the microsecond clock until
+   * the period is over. The spin keeps the CPU from tasks of lower priority, so keep the window
+   * short.
+   *
+   * @param ispinWindow How long before the end of each period to stop sleeping and start spinning.
+   */
+  explicit HybridRate(QTime ispinWindow = 1000_us);
+
+  /**
+   * Delay the current task such that it runs at the given frequency. The first delay will run for
+   * 1/(ihz). Subsequent delays will adjust according to the previous runtime of the task.
+   *
+   * @param ihz the frequency
+   */
+  void delay(QFrequency ihz) override;
+
+  /**
+   * Delay the current task until itime has passed. This method can be used by periodic tasks to
+   * ensure a consistent execution frequency.
+   *
+   * @param itime the time period
+   */
+  void delayUntil(QTime itime) override;
+
+  /**
+   * Delay the current task until ims milliseconds have passed. This method can be used by
+   * periodic tasks to ensure a consistent execution frequency.
+   *
+   * @param ims the time period
+   */
+  void delayUntil(uint32_t ims) override;
+
+  /**
+   * Forget the previous period, so the next delay is timed from when it is called.
+   */
+  void reset() override;
+
+  protected:
+  std::uint64_t spinWindow;
+  std::uint64_t lastTime{0};
+};
+} // namespace okapi
@@ -0,0 +1,27 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#pragma once
+
+#include "okapi/api/util/abstractTimer.hpp"
+
+namespace okapi {
+/**
+ * A Timer which reads the microsecond clock of the brain instead of the millisecond one, so the dt
+ * it measures is not rounded to whole milliseconds. Use it where that rounding shows up as noise,
+ * like in the derivative term of a fast PID loop or in VelMath.
+ */
+class MicrosTimer : public AbstractTimer {
+  public:
+  MicrosTimer();
+
+  /**
+   * Returns the current time in units of QTime, with microsecond resolution.
+   *
+   * @return the current time
+   */
+  QTime millis() const override;
+};
+} // namespace okapi
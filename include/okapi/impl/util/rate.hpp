@@ -36,6 +36,11 @@ class Rate : public AbstractRate {
    */
   void delayUntil(uint32_t ims) override;
 
+  /**
+   * Forget the previous period, so the next delay is timed from when it is called.
+   */
+  void reset() override;
+
   protected:
   std::uint32_t lastTime{0};
 };
@@ -10,6 +10,14 @@
 namespace okapi {
 class TimeUtilFactory {
   public:
+  /**
+   * The clocks a TimeUtil is made with.
+   */
+  enum class resolution {
+    milliseconds, ///< Timer and Rate, which work in whole milliseconds.
+    microseconds  ///< MicrosTimer and HybridRate, which work in microseconds.
+  };
+
   virtual ~TimeUtilFactory() = default;
 
   /**
@@ -19,14 +27,30 @@ class TimeUtilFactory {
 
   /**
    * Creates a default TimeUtil.
+   *
+   * @param iresolution The clocks to make the TimeUtil with.
    */
-  static TimeUtil createDefault();
+  static TimeUtil createDefault(resolution iresolution = resolution::milliseconds);
 
   /**
    * Creates a TimeUtil with custom SettledUtil params. See SettledUtil docs.
+   *
+   * @param iresolution The clocks to make the TimeUtil with.
    */
   static TimeUtil withSettledUtilParams(double iatTargetError = 50,
                                         double iatTargetDerivative = 5,
-                                        const QTime &iatTargetTime = 250_ms);
+                                        const QTime &iatTargetTime = 250_ms,
+                                        resolution iresolution = resolution::milliseconds);
+
+  protected:
+  /**
+   * Creates a timer with the given resolution.
+   */
+  static std::unique_ptr<AbstractTimer> createTimer(resolution iresolution);
+
+  /**
+   * Creates a rate with the given resolution.
+   */
+  static std::unique_ptr<AbstractRate> createRate(resolution iresolution);
 };
 } // namespace okapi
@@ -13,6 +13,7 @@
 #include "okapi/api/control/iterative/iterativePosPidController.hpp"
 #include "okapi/api/control/util/flywheelSimulator.hpp"
 #include "okapi/api/control/util/settledUtil.hpp"
+#include "okapi/api/device/abstractSerialPort.hpp"
 #include "okapi/api/device/motor/abstractMotor.hpp"
 #include "okapi/api/device/rotarysensor/continuousRotarySensor.hpp"
 #include "okapi/api/odometry/odometry.hpp"
@@ -21,7 +22,9 @@
 #include "okapi/api/util/timeUtil.hpp"
 #include <atomic>
 #include <chrono>
+#include <deque>
 #include <gtest/gtest.h>
+#include <mutex>
 
 namespace okapi {
 
@@ -36,6 +39,27 @@ class MockContinuousRotarySensor : public ContinuousRotarySensor {
   mutable std::int32_t value{0};
 };
 
+/**
+ * An inertial sensor mock which reads a settable heading in degrees.
+ */
+class MockImu : public ContinuousRotarySensor {
+  public:
+  double controllerGet() override {
+    return get();
+  }
+
+  std::int32_t reset() override {
+    heading = 0;
+    return 1;
+  }
+
+  double get() const override {
+    return heading;
+  }
+
+  double heading{0};
+};
+
 /**
  * A motor mock that saves the last set position, velocity, and voltage.
  */
@@ -299,6 +323,8 @@ class MockRate : public AbstractRate {
   void delayUntil(QTime itime) override;
 
   void delayUntil(uint32_t ims) override;
+
+  void reset() override;
 };
 
 class MockControllerInput : public ControllerInput<double> {
@@ -358,8 +384,11 @@ class MockAsyncPosIntegratedController : public AsyncPosIntegratedController {
 
   bool isSettled() override;
 
+  void modifyProfiledVelocity(std::int32_t ivelocity) override;
+
   IsSettledOverride isSettledOverride{IsSettledOverride::none};
   using AsyncPosIntegratedController::maxVelocity;
+  std::int32_t lastProfiledVelocity{0};
 };
 
 class MockAsyncVelIntegratedController : public AsyncVelIntegratedController {
@@ -531,7 +560,17 @@ class MockChassisModel : public ChassisModel {
   double getMaxVoltage() const override {
     return maxVoltage;
   }
+  void setVoltageCompensator(std::shared_ptr<VoltageCompensator> icompensator) override {
+    voltageCompensator = std::move(icompensator);
+  }
+  std::shared_ptr<VoltageCompensator> getVoltageCompensator() const override {
+    return voltageCompensator;
+  }
+  void applyCommands(const WheelCommands &icommands) override {
+    lastCommands = icommands;
+  }
 
+  mutable WheelCommands lastCommands;
   mutable double lastForward{0};
   mutable double lastVectorY{0};
   mutable double lastVectorZ{0};
@@ -548,6 +587,7 @@ class MockChassisModel : public ChassisModel {
   mutable bool resetSensorsWasCalled{false};
   double maxVelocity{600};
   double maxVoltage{12000};
+  std::shared_ptr<VoltageCompensator> voltageCompensator;
   mutable AbstractMotor::brakeMode lastBrakeMode{AbstractMotor::brakeMode::invalid};
   mutable AbstractMotor::encoderUnits lastEncoderUnits{AbstractMotor::encoderUnits::invalid};
   mutable AbstractMotor::gearset lastGearset{AbstractMotor::gearset::invalid};
@@ -655,4 +695,29 @@ class MockChassisController : public ChassisController {
   AbstractMotor::GearsetRatioPair gearset{AbstractMotor::gearset::green};
   std::shared_ptr<MockChassisModel> chassisModel = std::make_shared<MockChassisModel>();
 };
+
+/**
+ * One end of an in-memory serial cable. Bytes written to one end are read from the other.
+ */
+class MockSerialPort : public AbstractSerialPort {
+  public:
+  struct Pipe {
+    std::mutex mutex;
+    std::deque<std::uint8_t> bytes;
+  };
+
+  MockSerialPort(std::shared_ptr<Pipe> irx, std::shared_ptr<Pipe> itx);
+
+  /**
+   * @return Both ends of a cable.
+   */
+  static std::pair<std::shared_ptr<MockSerialPort>, std::shared_ptr<MockSerialPort>> makeCable();
+
+  std::size_t read(std::uint8_t *obuffer, std::size_t ilength) override;
+
+  std::size_t write(const std::uint8_t *ibuffer, std::size_t ilength) override;
+
+  std::shared_ptr<Pipe> rx;
+  std::shared_ptr<Pipe> tx;
+};
 } // namespace okapi
@@ -0,0 +1,340 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#pragma once
+
+#include "okapi/api/device/motor/abstractMotor.hpp"
+#include "okapi/api/device/rotarysensor/continuousRotarySensor.hpp"
+#include "okapi/api/odometry/odomState.hpp"
+#include "okapi/api/units/QLength.hpp"
+#include "okapi/api/units/QMass.hpp"
+#include "okapi/api/units/QTime.hpp"
+#include "okapi/api/util/abstractRate.hpp"
+#include "okapi/api/util/abstractTimer.hpp"
+#include "okapi/api/util/timeUtil.hpp"
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace okapi {
+/**
+ * Something a SimWorld moves forward in time.
+ */
+class SimDevice {
+  public:
+  virtual ~SimDevice() = default;
+
+  /**
+   * Move the device forward in time.
+   *
+   * @param idt The time step in seconds.
+   */
+  virtual void simulate(double idt) = 0;
+};
+
+/**
+ * The clock and physics of a simulation. Time only passes when the world is advanced, either
+ * directly or by a task waiting on a rate from `createTimeUtil()`, so a whole control stack can run
+ * as fast as the host allows. With one task the simulation is deterministic. With several, time
+ * advances to the furthest wake time any of them asked for.
+ */
+class SimWorld {
+  public:
+  /**
+   * @param isubstep The longest step the physics is moved forward by at once.
+   */
+  explicit SimWorld(QTime isubstep = 1_ms);
+
+  /**
+   * Adds a device to move forward in time. Devices are simulated in the order they were added.
+   */
+  void addDevice(std::shared_ptr<SimDevice> idevice);
+
+  /**
+   * Move the world forward in time.
+   */
+  void advance(QTime idt);
+
+  /**
+   * Move the world forward to a time. Does nothing if the world is already past it.
+   */
+  void advanceTo(QTime itime);
+
+  /**
+   * @return The time since the world was made.
+   */
+  QTime now() const;
+
+  /**
+   * @return A TimeUtil whose timers read the world's clock and whose rates advance the world
+   * instead of sleeping.
+   */
+  TimeUtil createTimeUtil();
+
+  protected:
+  QTime substep;
+  QTime time{0_ms};
+  std::vector<std::shared_ptr<SimDevice>> devices{};
+  mutable std::recursive_mutex mutex;
+};
+
+/**
+ * A timer which reads the clock of a SimWorld.
+ */
+class SimTimer : public AbstractTimer {
+  public:
+  explicit SimTimer(SimWorld &iworld);
+
+  QTime millis() const override;
+
+  protected:
+  SimWorld &world;
+};
+
+/**
+ * A rate which advances a SimWorld to the next wake time instead of sleeping.
+ */
+class SimRate : public AbstractRate {
+  public:
+  explicit SimRate(SimWorld &iworld);
+
+  void delay(QFrequency ihz) override;
+
+  void delayUntil(QTime itime) override;
+
+  void delayUntil(uint32_t ims) override;
+
+  void reset() override;
+
+  protected:
+  SimWorld &world;
+  QTime lastWake{-1_ms};
+};
+
+/**
+ * The electrical and mechanical constants of a simulated DC motor, measured at the output shaft.
+ */
+struct SimMotorParams {
+  /**
+   * The speed at 12 V with no load, in rpm.
+   */
+  double freeSpeed{200};
+
+  /**
+   * The torque at 12 V when stalled, in N*m.
+   */
+  double stallTorque{1.05};
+
+  /**
+   * The moment of inertia of the load, in kg*m^2. The time constant of the motor is this times
+   * the free speed over the stall torque, and must be several substeps long.
+   */
+  double inertia{0.002};
+
+  /**
+   * The viscous friction, in N*m per rad/s.
+   */
+  double damping{0.001};
+
+  /**
+   * @return The constants of a V5 motor with a cartridge.
+   */
+  static SimMotorParams fromGearset(AbstractMotor::gearset igearset);
+};
+
+class SimMotor;
+
+/**
+ * The integrated encoder of a SimMotor. It reads the position of the motor in its encoder units.
+ */
+class SimEncoder : public ContinuousRotarySensor {
+  public:
+  explicit SimEncoder(SimMotor &imotor);
+
+  double get() const override;
+
+  std::int32_t reset() override;
+
+  double controllerGet() override;
+
+  double getVelocity() const override;
+
+  bool measuresVelocity() const override;
+
+  protected:
+  SimMotor &motor;
+};
+
+/**
+ * A V5 motor simulated as a DC motor driving an inertia. Voltage commands drive the motor
+ * directly. Velocity and position commands go through loops playing the part of the motor's
+ * firmware.
+ */
+class SimMotor : public AbstractMotor, public SimDevice {
+  public:
+  explicit SimMotor(AbstractMotor::gearset igearset = AbstractMotor::gearset::green);
+
+  SimMotor(AbstractMotor::gearset igearset, const SimMotorParams &iparams);
+
+  void simulate(double idt) override;
+
+  /**
+   * Sets a torque, in N*m, added to the motor's at the output shaft, such as gravity on an arm.
+   */
+  void setExternalTorque(std::function<double(double iangle, double iomega)> itorque);
+
+  /**
+   * @return The angle of the output shaft in radians, ignoring tares and reversal.
+   */
+  double getAngle() const;
+
+  /**
+   * @return The speed of the output shaft in rad/s, ignoring reversal.
+   */
+  double getOmega() const;
+
+  SimMotorParams &getParams();
+
+  void controllerSet(double ivalue) override;
+  std::int32_t moveAbsolute(double iposition, std::int32_t ivelocity) override;
+  std::int32_t moveRelative(double iposition, std::int32_t ivelocity) override;
+  std::int32_t moveVelocity(std::int16_t ivelocity) override;
+  std::int32_t moveVoltage(std::int16_t ivoltage) override;
+  std::int32_t modifyProfiledVelocity(std::int32_t ivelocity) override;
+  double getTargetPosition() override;
+  double getPosition() override;
+  std::int32_t getTargetVelocity() override;
+  double getActualVelocity() override;
+  std::int32_t getCurrentDraw() override;
+  std::int32_t getDirection() override;
+  double getEfficiency() override;
+  std::int32_t isOverCurrent() override;
+  std::int32_t isOverTemp() override;
+  std::int32_t isStopped() override;
+  std::int32_t getZeroPositionFlag() override;
+  uint32_t getFaults() override;
+  uint32_t getFlags() override;
+  std::int32_t getRawPosition(std::uint32_t *timestamp) override;
+  double getPower() override;
+  double getTemperature() override;
+  double getTorque() override;
+  std::int32_t getVoltage() override;
+  std::int32_t tarePosition() override;
+  std::int32_t setBrakeMode(AbstractMotor::brakeMode imode) override;
+  AbstractMotor::brakeMode getBrakeMode() override;
+  std::int32_t setCurrentLimit(std::int32_t ilimit) override;
+  std::int32_t getCurrentLimit() override;
+  std::int32_t setEncoderUnits(AbstractMotor::encoderUnits iunits) override;
+  AbstractMotor::encoderUnits getEncoderUnits() override;
+  std::int32_t setGearing(AbstractMotor::gearset igearset) override;
+  AbstractMotor::gearset getGearing() override;
+  std::int32_t setReversed(bool ireverse) override;
+  std::int32_t setVoltageLimit(std::int32_t ilimit) override;
+  std::shared_ptr<ContinuousRotarySensor> getEncoder() override;
+
+  protected:
+  enum class mode { voltage, velocity, position };
+
+  SimMotorParams params;
+  std::function<double(double, double)> externalTorque{};
+  double angle{0};          // rad
+  double omega{0};          // rad / s
+  double torque{0};         // N*m
+  double appliedVoltage{0}; // V
+  double tareAngle{0};
+  mode controlMode{mode::voltage};
+  double target{0}; // mV, rpm, or encoder units
+  double velocityIntegral{0}; // V
+  std::int32_t profiledVelocity{0};
+  std::int32_t currentLimit{2500};
+  std::int32_t voltageLimit{12000};
+  std::int8_t reversed{1};
+  AbstractMotor::gearset gearset;
+  AbstractMotor::encoderUnits encoderUnits{AbstractMotor::encoderUnits::counts};
+  AbstractMotor::brakeMode brakeMode{AbstractMotor::brakeMode::coast};
+  std::shared_ptr<SimEncoder> encoder;
+  mutable std::recursive_mutex mutex;
+
+  double positionPerRadian() const;
+  double velocityLoop(double itargetRpm, double idt);
+};
+
+/**
+ * A skid steer drive simulated as a rigid robot on one motor per side. The sides don't affect each
+ * other, so there is no scrub. It moves the motors itself, so add the drive, not its motors, to the
+ * world.
+ */
+class SimSkidSteerDrive : public SimDevice {
+  public:
+  /**
+   * @param igearset The cartridge of the motors.
+   * @param iwheelDiameter The diameter of the wheels, driven straight from the motors.
+   * @param iwheelTrack The distance between the wheels on either side.
+   * @param imass The mass of the robot.
+   */
+  SimSkidSteerDrive(AbstractMotor::gearset igearset,
+                    QLength iwheelDiameter,
+                    QLength iwheelTrack,
+                    QMass imass);
+
+  void simulate(double idt) override;
+
+  std::shared_ptr<SimMotor> getLeftMotor() const;
+
+  std::shared_ptr<SimMotor> getRightMotor() const;
+
+  /**
+   * @return The true pose of the robot. x is forward, y is right, and theta increases clockwise,
+   * like OdomState.
+   */
+  OdomState getPose() const;
+
+  /**
+   * Teleport the robot. The motors keep spinning.
+   */
+  void setPose(const OdomState &ipose);
+
+  protected:
+  std::shared_ptr<SimMotor> leftMotor;
+  std::shared_ptr<SimMotor> rightMotor;
+  double wheelRadius; // m
+  double wheelTrack;  // m
+  double x{0};        // m
+  double y{0};        // m
+  double theta{0};    // rad
+  double lastLeftAngle{0};
+  double lastRightAngle{0};
+  mutable std::mutex mutex;
+};
+
+/**
+ * An inertial sensor which reads the heading of a SimSkidSteerDrive in degrees in the range
+ * [-180, 180], increasing clockwise like IMU, with an optional drift.
+ */
+class SimImu : public ContinuousRotarySensor {
+  public:
+  /**
+   * @param idrive The drive to read the heading of.
+   * @param iworld The world whose clock drives the drift.
+   * @param idriftRate How fast the reading drifts, in degrees per second.
+   */
+  SimImu(const std::shared_ptr<SimSkidSteerDrive> &idrive,
+         SimWorld &iworld,
+         double idriftRate = 0);
+
+  double get() const override;
+
+  std::int32_t reset() override;
+
+  double controllerGet() override;
+
+  protected:
+  std::shared_ptr<SimSkidSteerDrive> drive;
+  SimWorld &world;
+  double driftRate;
+  double offset{0};
+};
+} // namespace okapi
@@ -0,0 +1,144 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#pragma once
+
+#include "okapi/api/units/QFrequency.hpp"
+#include "okapi/api/units/QTime.hpp"
+#include "okapi/api/util/abstractRate.hpp"
+#include "okapi/api/util/abstractTimer.hpp"
+#include "okapi/api/util/timeUtil.hpp"
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <map>
+#include <set>
+#include <thread>
+#include <vector>
+
+namespace okapi {
+/**
+ * A clock shared by every task of a host-side run which only moves when all of them are waiting.
+ * A task joins the clock the first time it waits on a rate from `createTimeUtil()` and leaves it
+ * when that rate is destroyed. A task which joined with several rates counts once and leaves when
+ * the last of them does, so it can hold the clock with one rate while it runs code which waits on
+ * others, such as a blocking chassis move. Once every task which joined is waiting, the clock jumps
+ * straight to the earliest wake time and wakes the tasks due then, so a run takes only as long as
+ * its code does and every task sees the same times on every run. Like PROS, the clock counts whole
+ * milliseconds, so periods add up exactly.
+ *
+ * A task which blocks on anything else, such as joining another task, holds the clock until it is
+ * done. Threads which never wait on a rate, such as a test polling `isSettled()`, don't hold it.
+ */
+class VirtualClock {
+  public:
+  /**
+   * Called with the new time each time the clock moves, before any task wakes.
+   */
+  using Listener = std::function<void(QTime inow)>;
+
+  VirtualClock() = default;
+
+  VirtualClock(const VirtualClock &) = delete;
+  VirtualClock &operator=(const VirtualClock &) = delete;
+
+  /**
+   * @return The time since the clock was made.
+   */
+  QTime now() const;
+
+  /**
+   * @return The number of tasks which joined the clock.
+   */
+  std::size_t getTaskCount() const;
+
+  /**
+   * Adds a function to call each time the clock moves, such as one which advances a SimWorld to
+   * the new time. Listeners are called with the clock held, so they must not wait on it.
+   */
+  void addListener(Listener ilistener);
+
+  /**
+   * @return A TimeUtil whose timers read this clock and whose rates wait on it. The clock must
+   * outlive everything made from it.
+   */
+  TimeUtil createTimeUtil();
+
+  protected:
+  friend class VirtualRate;
+
+  std::uint32_t time{0}; // ms
+  std::map<std::thread::id, std::size_t> taskJoins{}; // The number of rates each task joined with
+  std::multiset<std::uint32_t> wakeTimes{};
+  std::vector<Listener> listeners{};
+  mutable std::mutex mutex;
+  std::condition_variable condition;
+
+  /**
+   * Joins the calling task.
+   *
+   * @return The time in ms when the task joined.
+   */
+  std::uint32_t join();
+  void leave(std::thread::id itask);
+  void waitUntil(std::uint32_t iwakeTime);
+
+  /**
+   * Moves the clock to the earliest wake time if every task is waiting and none are due yet.
+   * Requires the mutex.
+   */
+  void advanceIfIdle();
+};
+
+/**
+ * A timer which reads a VirtualClock.
+ */
+class VirtualTimer : public AbstractTimer {
+  public:
+  explicit VirtualTimer(const VirtualClock &iclock);
+
+  QTime millis() const override;
+
+  protected:
+  const VirtualClock &clock;
+};
+
+/**
+ * A rate which waits on a VirtualClock. Like the PROS rate, it wakes periodically from its first
+ * wait, so time spent between waits does not stretch the period.
+ */
+class VirtualRate : public AbstractRate {
+  public:
+  explicit VirtualRate(VirtualClock &iclock);
+
+  VirtualRate(const VirtualRate &) = delete;
+  VirtualRate &operator=(const VirtualRate &) = delete;
+
+  /**
+   * Leaves the clock, if this rate joined it.
+   */
+  ~VirtualRate() override;
+
+  void delay(QFrequency ihz) override;
+
+  void delayUntil(QTime itime) override;
+
+  void delayUntil(uint32_t ims) override;
+
+  /**
+   * Leaves the clock, if this rate joined it, so an idle rate does not hold the clock back. The
+   * next delay joins it again.
+   */
+  void reset() override;
+
+  protected:
+  VirtualClock &clock;
+  bool joined{false};
+  std::thread::id task{}; // The task which joined
+  std::uint32_t lastWake{0};
+};
+} // namespace okapi
@@ -0,0 +1,17 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#pragma once
+
+#include <string>
+
+/**
+ * Measures how long okapi takes to do common work on the brain and appends the results to a CSV
+ * file, one row per benchmark, so runs before and after a PROS or okapi update can be compared.
+ * Motors must be plugged into MOTOR_1_PORT and MOTOR_2_PORT, and an SD card must be inserted.
+ *
+ * @param icsvPath The CSV file to append to.
+ */
+void runPerformanceTests(const std::string &icsvPath = "/usd/okapi_perf.csv");
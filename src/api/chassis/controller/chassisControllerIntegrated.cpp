@@ -5,6 +5,10 @@
  */
 #include "okapi/api/chassis/controller/chassisControllerIntegrated.hpp"
 #include "okapi/api/util/mathUtil.hpp"
+#include "okapi/api/util/taskProfiler.hpp"
+#include <algorithm>
+#include <cmath>
+#include <limits>
 
 namespace okapi {
 ChassisControllerIntegrated::ChassisControllerIntegrated(
@@ -22,7 +26,10 @@ ChassisControllerIntegrated::ChassisControllerIntegrated(
     rightController(std::move(irightController)),
     lastTarget(0),
     scales(iscales),
-    gearsetRatioPair(igearset) {
+    gearsetRatioPair(igearset),
+    moveTimer(timeUtil.getTimer()),
+    waitRate(timeUtil.getRate()),
+    profileTimer(timeUtil.getTimer()) {
   if (igearset.ratio == 0) {
     std::string msg("ChassisControllerIntegrated: The gear ratio cannot be zero! Check if you are "
                     "using integer division.");
@@ -36,6 +43,11 @@ ChassisControllerIntegrated::ChassisControllerIntegrated(
   rightController->setMaxVelocity(chassisModel->getMaxVelocity());
 }
 
+ChassisControllerIntegrated::~ChassisControllerIntegrated() {
+  dtorCalled.store(true, std::memory_order_release);
+  delete task;
+}
+
 void ChassisControllerIntegrated::moveDistance(const QLength itarget) {
   moveDistanceAsync(itarget);
   waitUntilSettled();
@@ -50,17 +62,11 @@ void ChassisControllerIntegrated::moveDistanceAsync(const QLength itarget) {
   LOG_INFO("ChassisControllerIntegrated: moving " + std::to_string(itarget.convert(meter)) +
            " meters");
 
-  leftController->reset();
-  rightController->reset();
-  leftController->flipDisable(false);
-  rightController->flipDisable(false);
-
   const double newTarget = itarget.convert(meter) * scales.straight * gearsetRatioPair.ratio;
 
   LOG_INFO("ChassisControllerIntegrated: moving " + std::to_string(newTarget) + " motor ticks");
 
-  leftController->setTarget(newTarget + leftController->getProcessValue());
-  rightController->setTarget(newTarget + rightController->getProcessValue());
+  startMovement(newTarget, 1);
 }
 
 void ChassisControllerIntegrated::moveRawAsync(const double itarget) {
@@ -82,18 +88,60 @@ void ChassisControllerIntegrated::turnAngleAsync(const QAngle idegTarget) {
   LOG_INFO("ChassisControllerIntegrated: turning " + std::to_string(idegTarget.convert(degree)) +
            " degrees");
 
-  leftController->reset();
-  rightController->reset();
-  leftController->flipDisable(false);
-  rightController->flipDisable(false);
-
   const double newTarget =
     idegTarget.convert(degree) * scales.turn * gearsetRatioPair.ratio * boolToSign(normalTurns);
 
   LOG_INFO("ChassisControllerIntegrated: turning " + std::to_string(newTarget) + " motor ticks");
 
-  leftController->setTarget(newTarget + leftController->getProcessValue());
-  rightController->setTarget(-1 * newTarget + rightController->getProcessValue());
+  startMovement(newTarget, -1);
+}
+
+void ChassisControllerIntegrated::startMovement(const double itarget, const double irightSign) {
+  if (lazyStart) {
+    lazyStart = false;
+    startThread(lazyPriority, lazyStackDepth);
+  }
+
+  leftController->reset();
+  rightController->reset();
+
+  {
+    std::scoped_lock lock(profileMutex);
+    const bool profiled = maxProfileVelocity > 0;
+
+    // A profiled movement holds the position targets back until the profile is done
+    leftController->flipDisable(profiled);
+    rightController->flipDisable(profiled);
+    leftController->setTarget(itarget + leftController->getProcessValue());
+    rightController->setTarget(irightSign * itarget + rightController->getProcessValue());
+
+    if (profiled) {
+      moveProfile = std::make_unique<TrapezoidProfile>(
+        itarget,
+        maxProfileVelocity,
+        maxProfileAcceleration,
+        std::numeric_limits<double>::infinity(),
+        logger);
+      profileStart = profileTimer->millis();
+      rightProfileSign = irightSign;
+      profileRunning.store(true, std::memory_order_release);
+    } else {
+      moveProfile = nullptr;
+      profileRunning.store(false, std::memory_order_release);
+    }
+
+    // Only moves are corrected, since a turn is meant to change the heading
+    headingDirection = irightSign > 0 && headingSensor ? (itarget < 0 ? -1 : 1) : 0;
+    if (headingSensor) {
+      headingStart = headingSensor->controllerGet();
+    }
+    leftTrim = 1;
+    rightTrim = 1;
+    leftTrimmedVelocity = static_cast<std::int32_t>(chassisModel->getMaxVelocity());
+    rightTrimmedVelocity = leftTrimmedVelocity;
+  }
+
+  startMoveMonitor();
 }
 
 void ChassisControllerIntegrated::turnRawAsync(const double idegTarget) {
@@ -106,17 +154,26 @@ void ChassisControllerIntegrated::setTurnsMirrored(const bool ishouldMirror) {
 }
 
 bool ChassisControllerIntegrated::isSettled() {
-  return leftController->isSettled() && rightController->isSettled();
+  return !profileRunning.load(std::memory_order_acquire) && leftController->isSettled() &&
+         rightController->isSettled();
 }
 
 void ChassisControllerIntegrated::waitUntilSettled() {
   LOG_INFO_S("ChassisControllerIntegrated: Waiting to settle");
 
-  auto rate = timeUtil.getRate();
   while (!isSettled()) {
-    rate->delayUntil(10_ms);
+    if (const auto result = moveMonitor.check(moveTimer->millis(), getMoveTravel())) {
+      LOG_WARN(std::string("ChassisControllerIntegrated: Ending the movement because it ") +
+               (*result == MoveResult::stalled ? "stalled" : "timed out"));
+      lastMoveResult = *result;
+      break;
+    }
+
+    waitRate->delayUntil(10_ms);
   }
+  waitRate->reset();
 
+  clearMoveProfile();
   leftController->flipDisable(true);
   rightController->flipDisable(true);
   chassisModel->stop();
@@ -124,8 +181,207 @@ void ChassisControllerIntegrated::waitUntilSettled() {
   LOG_INFO_S("ChassisControllerIntegrated: Done waiting to settle");
 }
 
+void ChassisControllerIntegrated::setProfileLimits(const PathfinderLimits &ilimits,
+                                                   const QTime iperiod) {
+  if (!(ilimits.maxVel > 0) || !(ilimits.maxAccel > 0) || iperiod < 1_ms) {
+    std::string msg("ChassisControllerIntegrated: The max velocity and max acceleration of the "
+                    "profile must be positive and the period must be at least 1 ms.");
+    LOG_ERROR(msg);
+    throw std::invalid_argument(msg);
+  }
+
+  // Both sides work in motor ticks of wheel travel
+  const double ticksPerMeter = scales.straight * gearsetRatioPair.ratio;
+
+  {
+    std::scoped_lock lock(profileMutex);
+    maxProfileVelocity = ilimits.maxVel * ticksPerMeter;
+    maxProfileAcceleration = ilimits.maxAccel * ticksPerMeter;
+    profilePeriod = iperiod;
+  }
+
+  startThread();
+}
+
+void ChassisControllerIntegrated::clearProfileLimits() {
+  std::scoped_lock lock(profileMutex);
+  maxProfileVelocity = 0;
+  maxProfileAcceleration = 0;
+}
+
+void ChassisControllerIntegrated::setHeadingCorrection(
+  std::shared_ptr<ContinuousRotarySensor> isensor,
+  const double ikP) {
+  if (ikP < 0) {
+    std::string msg("ChassisControllerIntegrated: The heading correction gain cannot be negative.");
+    LOG_ERROR(msg);
+    throw std::invalid_argument(msg);
+  }
+
+  {
+    std::scoped_lock lock(profileMutex);
+    headingSensor = std::move(isensor);
+    headingGain = ikP;
+    headingDirection = 0;
+    leftTrim = 1;
+    rightTrim = 1;
+  }
+
+  if (headingSensor) {
+    startThread();
+  }
+}
+
+void ChassisControllerIntegrated::startThread(const std::uint32_t ipriority,
+                                              const std::uint16_t istackDepth) {
+  if (!task) {
+    task = new CrossplatformThread(
+      trampoline, this, "ChassisControllerIntegrated", ipriority, istackDepth);
+  }
+}
+
+void ChassisControllerIntegrated::startThreadLazily(const std::uint32_t ipriority,
+                                                    const std::uint16_t istackDepth) {
+  if (!task) {
+    lazyStart = true;
+    lazyPriority = ipriority;
+    lazyStackDepth = istackDepth;
+  }
+}
+
+CrossplatformThread *ChassisControllerIntegrated::getThread() const {
+  return task;
+}
+
+void ChassisControllerIntegrated::trampoline(void *context) {
+  if (context) {
+    static_cast<ChassisControllerIntegrated *>(context)->loop();
+  }
+}
+
+void ChassisControllerIntegrated::loop() {
+  LOG_INFO_S("Started ChassisControllerIntegrated task.");
+
+  auto rate = std::make_unique<ProfiledRate>(timeUtil.getRate(), "ChassisControllerIntegrated");
+  while (!dtorCalled.load(std::memory_order_acquire) && !task->notifyTake(0)) {
+    // Reading the motors here once per tick lets isSettled() skip reading them
+    leftController->updateSettled();
+    rightController->updateSettled();
+    stepHeadingCorrection();
+    stepProfile();
+
+    QTime period;
+    {
+      std::scoped_lock lock(profileMutex);
+      period = profilePeriod;
+    }
+    rate->delayUntil(period);
+  }
+
+  LOG_INFO_S("Stopped ChassisControllerIntegrated task.");
+}
+
+void ChassisControllerIntegrated::stepProfile() {
+  std::scoped_lock lock(profileMutex);
+  if (!moveProfile) {
+    return;
+  }
+
+  const QTime time = profileTimer->millis() - profileStart;
+  if (time >= moveProfile->getDuration()) {
+    // The motors close the rest of the distance and hold the target
+    moveProfile = nullptr;
+    leftController->flipDisable(false);
+    rightController->flipDisable(false);
+    profileRunning.store(false, std::memory_order_release);
+    return;
+  }
+
+  const double maxVelocity = chassisModel->getMaxVelocity();
+  if (maxVelocity <= 0) {
+    return;
+  }
+
+  // The profile is in motor ticks per second and the motors take rpm
+  const double rpm = moveProfile->sample(time).velocity * 60.0 /
+                     gearsetToTPR(gearsetRatioPair.internalGearset);
+  chassisModel->left(leftTrim * rpm / maxVelocity);
+  chassisModel->right(rightTrim * rightProfileSign * rpm / maxVelocity);
+}
+
+void ChassisControllerIntegrated::stepHeadingCorrection() {
+  std::scoped_lock lock(profileMutex);
+  if (headingDirection == 0) {
+    return;
+  }
+
+  // Drifting clockwise means the left side is ahead when driving forward and behind when driving
+  // backward
+  const double drift = headingSensor->controllerGet() - headingStart;
+  const double trim = std::clamp(headingDirection * headingGain * drift, -1.0, 1.0);
+  leftTrim = 1 - std::max(trim, 0.0);
+  rightTrim = 1 - std::max(-trim, 0.0);
+
+  if (moveProfile) {
+    // stepProfile trims the velocity it streams
+    return;
+  }
+
+  // Only send the motors a new velocity when it changes
+  const double maxVelocity = chassisModel->getMaxVelocity();
+  const auto leftVelocity = static_cast<std::int32_t>(std::lround(leftTrim * maxVelocity));
+  const auto rightVelocity = static_cast<std::int32_t>(std::lround(rightTrim * maxVelocity));
+  if (leftVelocity != leftTrimmedVelocity) {
+    leftController->modifyProfiledVelocity(leftVelocity);
+    leftTrimmedVelocity = leftVelocity;
+  }
+  if (rightVelocity != rightTrimmedVelocity) {
+    rightController->modifyProfiledVelocity(rightVelocity);
+    rightTrimmedVelocity = rightVelocity;
+  }
+}
+
+void ChassisControllerIntegrated::clearMoveProfile() {
+  std::scoped_lock lock(profileMutex);
+  moveProfile = nullptr;
+  profileRunning.store(false, std::memory_order_release);
+  headingDirection = 0;
+  leftTrim = 1;
+  rightTrim = 1;
+}
+
+void ChassisControllerIntegrated::setMoveTimeout(const QTime itimeout) {
+  moveMonitor.setTimeout(itimeout);
+}
+
+void ChassisControllerIntegrated::setStallDetection(const QSpeed iminSpeed,
+                                                    const QTime istallTime) {
+  // The monitor watches the wheel travel in motor ticks
+  moveMonitor.setStallDetection(iminSpeed.convert(mps) * scales.straight * gearsetRatioPair.ratio,
+                                istallTime);
+}
+
+MoveResult ChassisControllerIntegrated::getLastMoveResult() const {
+  return lastMoveResult;
+}
+
+void ChassisControllerIntegrated::startMoveMonitor() {
+  leftMoveStart = leftController->getProcessValue();
+  rightMoveStart = rightController->getProcessValue();
+  lastMoveResult = MoveResult::settled;
+  moveMonitor.start(moveTimer->millis(), 0);
+}
+
+double ChassisControllerIntegrated::getMoveTravel() const {
+  // The motors run the movement, so read them instead of any other sensors on the model
+  return (std::abs(leftController->getProcessValue() - leftMoveStart) +
+          std::abs(rightController->getProcessValue() - rightMoveStart)) /
+         2.0;
+}
+
 void ChassisControllerIntegrated::stop() {
   LOG_INFO_S("ChassisControllerIntegrated: Stopping");
+  clearMoveProfile();
   leftController->flipDisable(true);
   rightController->flipDisable(true);
   chassisModel->stop();
@@ -5,10 +5,22 @@
  */
 #include "okapi/api/chassis/controller/chassisControllerPid.hpp"
 #include "okapi/api/util/mathUtil.hpp"
+#include "okapi/api/util/taskProfiler.hpp"
 #include <cmath>
+#include <optional>
 #include <utility>
 
 namespace okapi {
+ChassisCommand
+ChassisCommand::move(const QLength idistance, const Settle isettle, const QTime itimeout) {
+  return ChassisCommand{Type::move, idistance, 0_deg, isettle, itimeout};
+}
+
+ChassisCommand
+ChassisCommand::turn(const QAngle iangle, const Settle isettle, const QTime itimeout) {
+  return ChassisCommand{Type::turn, 0_m, iangle, isettle, itimeout};
+}
+
 ChassisControllerPID::ChassisControllerPID(
   TimeUtil itimeUtil,
   std::shared_ptr<ChassisModel> ichassisModel,
@@ -25,7 +37,9 @@ ChassisControllerPID::ChassisControllerPID(
     turnPid(std::move(iturnController)),
     anglePid(std::move(iangleController)),
     scales(iscales),
-    gearsetRatioPair(igearset) {
+    gearsetRatioPair(igearset),
+    profileTimer(timeUtil.getTimer()),
+    waitRate(timeUtil.getRate()) {
   if (igearset.ratio == 0) {
     std::string msg("ChassisControllerPID: The gear ratio cannot be zero! Check if you are using "
                     "integer division.");
@@ -38,75 +52,132 @@ ChassisControllerPID::ChassisControllerPID(
 
 ChassisControllerPID::~ChassisControllerPID() {
   dtorCalled.store(true, std::memory_order_release);
+  if (scheduler) {
+    scheduler->removeLoop(schedulerLoopId);
+    stop();
+  }
   delete task;
 }
 
 void ChassisControllerPID::loop() {
   LOG_INFO_S("Started ChassisControllerPID task.");
 
-  auto encStartVals = chassisModel->getSensorVals();
-  std::valarray<std::int32_t> encVals;
+  beginStepping();
+  auto rate = std::make_unique<ProfiledRate>(timeUtil.getRate(), "ChassisControllerPID");
+  while (!dtorCalled.load(std::memory_order_acquire) && !task->notifyTake(0)) {
+    step();
+    rate->delayUntil(threadSleepTime);
+  }
+
+  stop();
+
+  LOG_INFO_S("Stopped ChassisControllerPID task.");
+}
+
+void ChassisControllerPID::beginStepping() {
+  encStartVals = chassisModel->getSensorVals();
+  moveStart = profileTimer->millis();
+}
+
+void ChassisControllerPID::step() {
   double distanceElapsed = 0, angleChange = 0;
-  modeType pastMode = none;
-  auto rate = timeUtil.getRate();
 
-  while (!dtorCalled.load(std::memory_order_acquire) && !task->notifyTake(0)) {
-    /**
-     * doneLooping is set to false by moveDistanceAsync and turnAngleAsync and then set to true by
-     * waitUntilSettled
-     */
-    if (doneLooping.load(std::memory_order_acquire)) {
-      doneLoopingSeen.store(true, std::memory_order_release);
-    } else {
-      if (mode != pastMode || newMovement.load(std::memory_order_acquire)) {
-        encStartVals = chassisModel->getSensorVals();
-        newMovement.store(false, std::memory_order_release);
+  /**
+   * doneLooping is set to false by moveDistanceAsync and turnAngleAsync and then set to true by
+   * waitUntilSettled
+   */
+  if (doneLooping.load(std::memory_order_acquire)) {
+    doneLoopingSeen.store(true, std::memory_order_release);
+  } else {
+    if (mode != pastMode || newMovement.load(std::memory_order_acquire)) {
+      encStartVals = chassisModel->getSensorVals();
+      moveStart = profileTimer->millis();
+      QTime timeout;
+      {
+        std::scoped_lock lock(queueMutex);
+        timeout = commandTimeout > 0_ms ? commandTimeout : moveTimeout;
+      }
+      {
+        std::scoped_lock lock(profileMutex);
+        stepHeading = headingSensor;
+        moveMonitor.setTimeout(timeout);
+        moveMonitor.start(moveStart, 0);
+      }
+      headingStart = stepHeading ? stepHeading->get() : 0;
+      newMovement.store(false, std::memory_order_release);
+    }
+
+    // A movement which stalled or timed out holds still until the next one
+    switch (moveEnded.load(std::memory_order_acquire) ? none : mode) {
+    case distance:
+      stepMoveProfile(*distancePid, profileTimer->millis() - moveStart);
+      encVals = chassisModel->getSensorVals() - encStartVals;
+      distanceElapsed = static_cast<double>((encVals[0] + encVals[1])) / 2.0;
+      angleChange = stepHeading ? stepHeading->get() - headingStart
+                                : static_cast<double>(encVals[0] - encVals[1]);
+
+      distancePid->step(distanceElapsed);
+      anglePid->step(angleChange);
+
+      if (velocityMode) {
+        chassisModel->driveVector(distancePid->getOutput(), anglePid->getOutput());
+      } else {
+        chassisModel->driveVectorVoltage(distancePid->getOutput(), anglePid->getOutput());
       }
 
-      switch (mode) {
-      case distance:
-        encVals = chassisModel->getSensorVals() - encStartVals;
-        distanceElapsed = static_cast<double>((encVals[0] + encVals[1])) / 2.0;
-        angleChange = static_cast<double>(encVals[0] - encVals[1]);
+      if (strafing.load(std::memory_order_acquire) && encVals.size() > 2) {
+        // Driving the vector stops the middle wheel, so drive it after
+        strafePid->step(encVals[2]);
+        driveStrafe(strafePid->getOutput());
+      }
 
-        distancePid->step(distanceElapsed);
-        anglePid->step(angleChange);
+      break;
 
-        if (velocityMode) {
-          chassisModel->driveVector(distancePid->getOutput(), anglePid->getOutput());
-        } else {
-          chassisModel->driveVectorVoltage(distancePid->getOutput(), anglePid->getOutput());
-        }
+    case angle:
+      stepMoveProfile(*turnPid, profileTimer->millis() - moveStart);
+      encVals = chassisModel->getSensorVals() - encStartVals;
+      angleChange =
+        stepHeading ? stepHeading->get() - headingStart : (encVals[0] - encVals[1]) / 2.0;
 
-        break;
+      turnPid->step(angleChange);
 
-      case angle:
-        encVals = chassisModel->getSensorVals() - encStartVals;
-        angleChange = (encVals[0] - encVals[1]) / 2.0;
+      if (velocityMode) {
+        chassisModel->driveVector(0, turnPid->getOutput());
+      } else {
+        chassisModel->driveVectorVoltage(0, turnPid->getOutput());
+      }
 
-        turnPid->step(angleChange);
+      break;
 
-        if (velocityMode) {
-          chassisModel->driveVector(0, turnPid->getOutput());
-        } else {
-          chassisModel->driveVectorVoltage(0, turnPid->getOutput());
-        }
+    default:
+      break;
+    }
 
-        break;
+    pastMode = mode;
 
-      default:
-        break;
+    if (mode != none && !isMovementSettled()) {
+      // Both wheels move in a movement which is going anywhere, whether it is a move or a turn.
+      // Only the middle wheel moves in a strafe.
+      double travel = (std::abs(encVals[0]) + std::abs(encVals[1])) / 2.0;
+      if (strafing.load(std::memory_order_acquire) && encVals.size() > 2) {
+        travel += std::abs(encVals[2]);
+      }
+      std::optional<MoveResult> result;
+      {
+        std::scoped_lock lock(profileMutex);
+        result = moveMonitor.check(profileTimer->millis(), travel);
       }
 
-      pastMode = mode;
+      if (result) {
+        endMovement(*result);
+      }
     }
 
-    rate->delayUntil(threadSleepTime);
+    // The next command starts on the step this one settles, without waiting on the user task
+    if (queueRunning.load(std::memory_order_acquire) && isCommandDone()) {
+      startNextQueuedCommand();
+    }
   }
-
-  stop();
-
-  LOG_INFO_S("Stopped ChassisControllerPID task.");
 }
 
 void ChassisControllerPID::trampoline(void *context) {
@@ -116,6 +187,13 @@ void ChassisControllerPID::trampoline(void *context) {
 }
 
 void ChassisControllerPID::moveDistanceAsync(const QLength itarget) {
+  startLazyThread();
+  clearQueue();
+  startMoveDistance(itarget);
+}
+
+void ChassisControllerPID::startMoveDistance(const QLength itarget, const QLength istrafe) {
+  resetMoveMonitor();
   LOG_INFO("ChassisControllerPID: moving " + std::to_string(itarget.convert(meter)) + " meters");
   LOG_DEBUG("ChassisControllerPID: straight " + std::to_string(scales.straight) + " ratio " +
             std::to_string(gearsetRatioPair.ratio));
@@ -127,11 +205,26 @@ void ChassisControllerPID::moveDistanceAsync(const QLength itarget) {
   turnPid->flipDisable(true);
   mode = distance;
 
+  if (strafePid) {
+    strafePid->reset();
+    strafePid->flipDisable(istrafe == 0_m);
+    if (istrafe != 0_m) {
+      const double strafeTarget = istrafe.convert(meter) * scales.middle * gearsetRatioPair.ratio;
+      LOG_INFO("ChassisControllerPID: strafing " + std::to_string(strafeTarget) +
+               " middle ticks");
+      strafePid->setTarget(strafeTarget);
+    }
+  }
+  strafing.store(strafePid && istrafe != 0_m, std::memory_order_release);
+
   const double newTarget = itarget.convert(meter) * scales.straight * gearsetRatioPair.ratio;
 
   LOG_INFO("ChassisControllerPID: moving " + std::to_string(newTarget) + " motor ticks");
 
-  distancePid->setTarget(newTarget);
+  {
+    std::scoped_lock lock(profileMutex);
+    startMoveProfile(*distancePid, distanceLimits, newTarget);
+  }
   anglePid->setTarget(0);
 
   doneLooping.store(false, std::memory_order_release);
@@ -153,7 +246,79 @@ void ChassisControllerPID::moveRaw(const double itarget) {
   moveDistance((itarget / scales.straight) * meter);
 }
 
+void ChassisControllerPID::strafeDistanceAsync(const QLength itarget) {
+  moveVectorAsync(0_m, itarget);
+}
+
+void ChassisControllerPID::strafeDistance(const QLength itarget) {
+  strafeDistanceAsync(itarget);
+  waitUntilSettled();
+}
+
+void ChassisControllerPID::moveVectorAsync(const QLength iforward, const QLength istrafe) {
+  if (!strafePid && istrafe != 0_m) {
+    std::string msg("ChassisControllerPID: Strafing needs a strafe controller. Call "
+                    "setStrafeController first.");
+    LOG_ERROR(msg);
+    throw std::runtime_error(msg);
+  }
+
+  startLazyThread();
+  clearQueue();
+  startMoveDistance(iforward, istrafe);
+}
+
+void ChassisControllerPID::moveVector(const QLength iforward, const QLength istrafe) {
+  moveVectorAsync(iforward, istrafe);
+  waitUntilSettled();
+}
+
+void ChassisControllerPID::setStrafeController(
+  std::unique_ptr<IterativePosPIDController> icontroller) {
+  if (icontroller == nullptr) {
+    strafePid = nullptr;
+    hDriveModel = nullptr;
+    return;
+  }
+
+  auto model = std::dynamic_pointer_cast<HDriveModel>(chassisModel);
+  if (model == nullptr) {
+    std::string msg("ChassisControllerPID: Strafing needs an HDriveModel.");
+    LOG_ERROR(msg);
+    throw std::invalid_argument(msg);
+  }
+
+  if (scales.middle == 0) {
+    std::string msg("ChassisControllerPID: Strafing needs a middle scale.");
+    LOG_ERROR(msg);
+    throw std::invalid_argument(msg);
+  }
+
+  icontroller->flipDisable(true);
+  strafePid = std::move(icontroller);
+  hDriveModel = std::move(model);
+}
+
+bool ChassisControllerPID::hasStrafeController() const {
+  return strafePid != nullptr;
+}
+
+void ChassisControllerPID::driveStrafe(const double ioutput) {
+  if (velocityMode) {
+    hDriveModel->middle(ioutput);
+  } else {
+    hDriveModel->middleVoltage(ioutput);
+  }
+}
+
 void ChassisControllerPID::turnAngleAsync(const QAngle idegTarget) {
+  startLazyThread();
+  clearQueue();
+  startTurnAngle(idegTarget);
+}
+
+void ChassisControllerPID::startTurnAngle(const QAngle idegTarget) {
+  resetMoveMonitor();
   LOG_INFO("ChassisControllerPID: turning " + std::to_string(idegTarget.convert(degree)) +
            " degrees");
   LOG_DEBUG("ChassisControllerPID: scales.turn " + std::to_string(scales.turn) + " ratio " +
@@ -163,14 +328,32 @@ void ChassisControllerPID::turnAngleAsync(const QAngle idegTarget) {
   turnPid->flipDisable(false);
   distancePid->flipDisable(true);
   anglePid->flipDisable(true);
+  if (strafePid) {
+    strafePid->flipDisable(true);
+  }
+  strafing.store(false, std::memory_order_release);
   mode = angle;
 
-  const double newTarget =
-    idegTarget.convert(degree) * scales.turn * gearsetRatioPair.ratio * boolToSign(normalTurns);
-
-  LOG_INFO("ChassisControllerPID: turning " + std::to_string(newTarget) + " motor ticks");
-
-  turnPid->setTarget(newTarget);
+  const double ticksPerDegree = scales.turn * gearsetRatioPair.ratio;
+
+  {
+    std::scoped_lock lock(profileMutex);
+    if (headingSensor) {
+      // The turn controller works in degrees of heading
+      const double newTarget = idegTarget.convert(degree) * boolToSign(normalTurns);
+      LOG_INFO("ChassisControllerPID: turning " + std::to_string(newTarget) +
+               " degrees of heading");
+      const ProfileLimits limits{turnLimits.maxVelocity / ticksPerDegree,
+                                 turnLimits.maxAcceleration / ticksPerDegree,
+                                 turnLimits.maxJerk / ticksPerDegree};
+      startMoveProfile(*turnPid, limits, newTarget);
+    } else {
+      const double newTarget =
+        idegTarget.convert(degree) * ticksPerDegree * boolToSign(normalTurns);
+      LOG_INFO("ChassisControllerPID: turning " + std::to_string(newTarget) + " motor ticks");
+      startMoveProfile(*turnPid, turnLimits, newTarget);
+    }
+  }
 
   doneLooping.store(false, std::memory_order_release);
   newMovement.store(true, std::memory_order_release);
@@ -195,13 +378,178 @@ void ChassisControllerPID::setTurnsMirrored(const bool ishouldMirror) {
   normalTurns = !ishouldMirror;
 }
 
+void ChassisControllerPID::startMoveProfile(IterativePosPIDController &icontroller,
+                                            const ProfileLimits &ilimits,
+                                            const double itarget) {
+  if (ilimits.maxVelocity > 0) {
+    // The target starts where the robot is and moves along the profile
+    moveProfile = std::make_unique<TrapezoidProfile>(
+      itarget, ilimits.maxVelocity, ilimits.maxAcceleration, ilimits.maxJerk, logger);
+    moveProfileDone.store(false, std::memory_order_release);
+    icontroller.setProfiledTarget(0, 0);
+  } else {
+    moveProfile = nullptr;
+    moveProfileDone.store(true, std::memory_order_release);
+    icontroller.setTarget(itarget);
+  }
+}
+
+void ChassisControllerPID::stepMoveProfile(IterativePosPIDController &icontroller,
+                                           const QTime &itime) {
+  std::scoped_lock lock(profileMutex);
+  if (!moveProfile) {
+    return;
+  }
+
+  const auto state = moveProfile->sample(itime);
+  icontroller.setProfiledTarget(state.position, state.velocity, state.acceleration);
+  if (itime >= moveProfile->getDuration()) {
+    moveProfileDone.store(true, std::memory_order_release);
+  }
+}
+
+ChassisControllerPID::CommandChain::CommandChain(ChassisControllerPID &icontroller)
+  : controller(icontroller) {
+}
+
+ChassisControllerPID::CommandChain &
+ChassisControllerPID::CommandChain::then(const ChassisCommand &icommand) {
+  controller.enqueue(icommand);
+  return *this;
+}
+
+ChassisControllerPID::CommandChain ChassisControllerPID::enqueue(const ChassisCommand &icommand) {
+  startLazyThread();
+  std::scoped_lock lock(queueMutex);
+  if (!queueRunning.load(std::memory_order_acquire) &&
+      doneLooping.load(std::memory_order_acquire)) {
+    // Nothing is moving, so there is nothing to wait for
+    startCommand(icommand);
+  } else {
+    commandQueue.push_back(icommand);
+  }
+
+  queueRunning.store(true, std::memory_order_release);
+  return CommandChain(*this);
+}
+
+std::size_t ChassisControllerPID::getQueueSize() const {
+  std::scoped_lock lock(queueMutex);
+  return commandQueue.size();
+}
+
+void ChassisControllerPID::setLooseSettleTolerance(const QLength idistance, const QAngle iangle) {
+  std::scoped_lock lock(queueMutex);
+  looseDistanceTolerance = abs(idistance);
+  looseAngleTolerance = abs(iangle);
+}
+
+void ChassisControllerPID::startCommand(const ChassisCommand &icommand) {
+  currentSettle = icommand.settle;
+  commandTimeout = icommand.timeout;
+  switch (icommand.type) {
+  case ChassisCommand::Type::turn:
+    startTurnAngle(icommand.angle);
+    break;
+
+  case ChassisCommand::Type::move:
+  default:
+    startMoveDistance(icommand.distance);
+    break;
+  }
+}
+
+void ChassisControllerPID::startNextQueuedCommand() {
+  std::scoped_lock lock(queueMutex);
+  if (commandQueue.empty()) {
+    // The last command holds its target until waitUntilSettled
+    queueRunning.store(false, std::memory_order_release);
+    return;
+  }
+
+  LOG_DEBUG("ChassisControllerPID: Starting the next queued command, " +
+            std::to_string(commandQueue.size() - 1) + " left");
+  startCommand(commandQueue.front());
+  commandQueue.pop_front();
+}
+
+void ChassisControllerPID::clearQueue() {
+  std::scoped_lock lock(queueMutex);
+  commandQueue.clear();
+  queueRunning.store(false, std::memory_order_release);
+  currentSettle = ChassisCommand::Settle::tight;
+  commandTimeout = 0_ms;
+}
+
 bool ChassisControllerPID::isSettled() {
+  return !queueRunning.load(std::memory_order_acquire) && isCommandDone();
+}
+
+bool ChassisControllerPID::isCommandDone() {
+  if (moveEnded.load(std::memory_order_acquire)) {
+    return true;
+  }
+
+  ChassisCommand::Settle settle;
+  double looseTolerance = 0;
+  {
+    std::scoped_lock lock(queueMutex);
+    settle = currentSettle;
+
+    if (mode == distance) {
+      looseTolerance =
+        looseDistanceTolerance.convert(meter) * scales.straight * gearsetRatioPair.ratio;
+    } else {
+      std::scoped_lock profileLock(profileMutex);
+      looseTolerance = looseAngleTolerance.convert(degree) *
+                       (headingSensor ? 1 : scales.turn * gearsetRatioPair.ratio);
+    }
+  }
+
+  if (settle == ChassisCommand::Settle::tight) {
+    return isMovementSettled();
+  }
+
+  IterativePosPIDController *controller = nullptr;
   switch (mode) {
   case distance:
-    return distancePid->isSettled() && anglePid->isSettled();
+    controller = distancePid.get();
+    break;
 
   case angle:
-    return turnPid->isSettled();
+    controller = turnPid.get();
+    break;
+
+  default:
+    return true;
+  }
+
+  if (!moveProfileDone.load(std::memory_order_acquire)) {
+    return false;
+  }
+
+  const double error = controller->getError();
+  if (settle == ChassisCommand::Settle::loose) {
+    return std::abs(error) <= looseTolerance;
+  }
+
+  // The target is measured from where the movement started, so the error changes sign once the
+  // robot reaches it
+  return error * controller->getTarget() <= 0;
+}
+
+bool ChassisControllerPID::isMovementSettled() {
+  if (moveEnded.load(std::memory_order_acquire)) {
+    return true;
+  }
+
+  switch (mode) {
+  case distance:
+    return moveProfileDone.load(std::memory_order_acquire) && distancePid->isSettled() &&
+           anglePid->isSettled() && isStrafeSettled();
+
+  case angle:
+    return moveProfileDone.load(std::memory_order_acquire) && turnPid->isSettled();
 
   default:
     return true;
@@ -211,7 +559,19 @@ bool ChassisControllerPID::isSettled() {
 void ChassisControllerPID::waitUntilSettled() {
   LOG_INFO_S("ChassisControllerPID: Waiting to settle");
 
-  bool completelySettled = false;
+  // The controller task runs the queue, so wait for it to reach the last command
+  while (queueRunning.load(std::memory_order_acquire)) {
+    waitRate->delayUntil(threadSleepTime);
+  }
+  waitRate->reset();
+
+  // A command which settles loosely was already done when the queue finished, so don't hold the
+  // robot until it settles tightly
+  bool completelySettled;
+  {
+    std::scoped_lock lock(queueMutex);
+    completelySettled = currentSettle != ChassisCommand::Settle::tight;
+  }
 
   while (!completelySettled) {
     switch (mode) {
@@ -235,10 +595,10 @@ void ChassisControllerPID::waitUntilSettled() {
   doneLoopingSeen.store(false, std::memory_order_release);
 
   // Wait for the thread to finish if it happens to be writing to motors
-  auto rate = timeUtil.getRate();
   while (!doneLoopingSeen.load(std::memory_order_acquire)) {
-    rate->delayUntil(threadSleepTime);
+    waitRate->delayUntil(threadSleepTime);
   }
+  waitRate->reset();
 
   // Stop after the thread has run at least once
   stopAfterSettled();
@@ -249,16 +609,19 @@ void ChassisControllerPID::waitUntilSettled() {
 bool ChassisControllerPID::waitForDistanceSettled() {
   LOG_INFO_S("ChassisControllerPID: Waiting to settle in distance mode");
 
-  auto rate = timeUtil.getRate();
-  while (!(distancePid->isSettled() && anglePid->isSettled())) {
+  while (!moveEnded.load(std::memory_order_acquire) &&
+         !(moveProfileDone.load(std::memory_order_acquire) && distancePid->isSettled() &&
+           anglePid->isSettled() && isStrafeSettled())) {
     if (mode == angle) {
       // False will cause the loop to re-enter the switch
       LOG_WARN_S("ChassisControllerPID: Mode changed to angle while waiting in distance!");
+      waitRate->reset();
       return false;
     }
 
-    rate->delayUntil(10_ms);
+    waitRate->delayUntil(10_ms);
   }
+  waitRate->reset();
 
   // True will cause the loop to exit
   return true;
@@ -267,25 +630,35 @@ bool ChassisControllerPID::waitForDistanceSettled() {
 bool ChassisControllerPID::waitForAngleSettled() {
   LOG_INFO_S("ChassisControllerPID: Waiting to settle in angle mode");
 
-  auto rate = timeUtil.getRate();
-  while (!turnPid->isSettled()) {
+  while (!moveEnded.load(std::memory_order_acquire) &&
+         !(moveProfileDone.load(std::memory_order_acquire) && turnPid->isSettled())) {
     if (mode == distance) {
       // False will cause the loop to re-enter the switch
       LOG_WARN_S("ChassisControllerPID: Mode changed to distance while waiting in angle!");
+      waitRate->reset();
       return false;
     }
 
-    rate->delayUntil(10_ms);
+    waitRate->delayUntil(10_ms);
   }
+  waitRate->reset();
 
   // True will cause the loop to exit
   return true;
 }
 
+bool ChassisControllerPID::isStrafeSettled() {
+  return !strafing.load(std::memory_order_acquire) || strafePid->isSettled();
+}
+
 void ChassisControllerPID::stopAfterSettled() {
   distancePid->flipDisable(true);
   anglePid->flipDisable(true);
   turnPid->flipDisable(true);
+  if (strafePid) {
+    strafePid->flipDisable(true);
+  }
+  strafing.store(false, std::memory_order_release);
   chassisModel->stop();
 }
 
@@ -316,9 +689,144 @@ ChassisControllerPID::getGains() const {
   return std::make_tuple(distancePid->getGains(), turnPid->getGains(), anglePid->getGains());
 }
 
-void ChassisControllerPID::startThread() {
-  if (!task) {
-    task = new CrossplatformThread(trampoline, this, "ChassisControllerPID");
+void ChassisControllerPID::setAntiWindup(const IterativePosPIDController::antiWindup istrategy,
+                                         const double itrackingGain) {
+  distancePid->setAntiWindup(istrategy, itrackingGain);
+  turnPid->setAntiWindup(istrategy, itrackingGain);
+  anglePid->setAntiWindup(istrategy, itrackingGain);
+  if (strafePid) {
+    strafePid->setAntiWindup(istrategy, itrackingGain);
+  }
+}
+
+void ChassisControllerPID::setDistanceProfile(const MotorFeedforward &ifeedforward,
+                                              const QSpeed &imaxVelocity,
+                                              const QAcceleration &imaxAcceleration) {
+  if (imaxVelocity <= 0_mps || imaxAcceleration <= 0_mps2) {
+    std::string msg("ChassisControllerPID: The max velocity and max acceleration of the distance "
+                    "profile must be positive.");
+    LOG_ERROR(msg);
+    throw std::invalid_argument(msg);
+  }
+
+  // The distance controller works in motor ticks
+  const double ticksPerMeter = scales.straight * gearsetRatioPair.ratio;
+
+  std::scoped_lock lock(profileMutex);
+  distanceLimits = {imaxVelocity.convert(mps) * ticksPerMeter,
+                    imaxAcceleration.convert(mps2) * ticksPerMeter};
+  distancePid->setFeedforward(
+    {ifeedforward.kS, ifeedforward.kV / ticksPerMeter, ifeedforward.kA / ticksPerMeter});
+}
+
+void ChassisControllerPID::clearDistanceProfile() {
+  std::scoped_lock lock(profileMutex);
+  distanceLimits = {};
+  distancePid->setFeedforward({});
+}
+
+void ChassisControllerPID::setProfileLimits(const PathfinderLimits &ilimits,
+                                            const ProfileShape ishape) {
+  const bool sCurve = ishape == ProfileShape::sCurve;
+  if (!(ilimits.maxVel > 0) || !(ilimits.maxAccel > 0) || (sCurve && !(ilimits.maxJerk > 0))) {
+    std::string msg("ChassisControllerPID: The max velocity, max acceleration, and max jerk of the "
+                    "profile must be positive.");
+    LOG_ERROR(msg);
+    throw std::invalid_argument(msg);
+  }
+
+  // Both controllers work in motor ticks of wheel travel
+  const double ticksPerMeter = scales.straight * gearsetRatioPair.ratio;
+  const ProfileLimits limits{ilimits.maxVel * ticksPerMeter,
+                             ilimits.maxAccel * ticksPerMeter,
+                             sCurve ? ilimits.maxJerk * ticksPerMeter
+                                    : std::numeric_limits<double>::infinity()};
+
+  std::scoped_lock lock(profileMutex);
+  distanceLimits = limits;
+  turnLimits = limits;
+}
+
+void ChassisControllerPID::clearProfileLimits() {
+  std::scoped_lock lock(profileMutex);
+  distanceLimits = {};
+  turnLimits = {};
+}
+
+void ChassisControllerPID::setHeadingSensor(std::shared_ptr<ContinuousRotarySensor> isensor) {
+  std::scoped_lock lock(profileMutex);
+  headingSensor = std::move(isensor);
+}
+
+std::shared_ptr<ContinuousRotarySensor> ChassisControllerPID::getHeadingSensor() const {
+  std::scoped_lock lock(profileMutex);
+  return headingSensor;
+}
+
+void ChassisControllerPID::setMoveTimeout(const QTime itimeout) {
+  std::scoped_lock lock(queueMutex);
+  moveTimeout = itimeout;
+}
+
+void ChassisControllerPID::setStallDetection(const QSpeed iminSpeed, const QTime istallTime) {
+  // The monitor watches the wheel travel in motor ticks
+  std::scoped_lock lock(profileMutex);
+  moveMonitor.setStallDetection(iminSpeed.convert(mps) * scales.straight * gearsetRatioPair.ratio,
+                                istallTime);
+}
+
+MoveResult ChassisControllerPID::getLastMoveResult() const {
+  return lastMoveResult.load(std::memory_order_acquire);
+}
+
+void ChassisControllerPID::resetMoveMonitor() {
+  {
+    std::scoped_lock lock(profileMutex);
+    moveMonitor.start(profileTimer->millis(), 0);
+  }
+  lastMoveResult.store(MoveResult::settled, std::memory_order_release);
+  moveEnded.store(false, std::memory_order_release);
+}
+
+void ChassisControllerPID::endMovement(const MoveResult iresult) {
+  LOG_WARN(std::string("ChassisControllerPID: Ending the movement because it ") +
+           (iresult == MoveResult::stalled ? "stalled" : "timed out"));
+  lastMoveResult.store(iresult, std::memory_order_release);
+  moveEnded.store(true, std::memory_order_release);
+  chassisModel->stop();
+}
+
+void ChassisControllerPID::startThread(const std::uint32_t ipriority,
+                                       const std::uint16_t istackDepth) {
+  if (!task && !scheduler) {
+    task = new CrossplatformThread(
+      trampoline, this, "ChassisControllerPID", ipriority, istackDepth);
+  }
+}
+
+void ChassisControllerPID::startThreadLazily(const std::uint32_t ipriority,
+                                             const std::uint16_t istackDepth) {
+  if (!task && !scheduler) {
+    lazyStart = true;
+    lazyPriority = ipriority;
+    lazyStackDepth = istackDepth;
+  }
+}
+
+void ChassisControllerPID::startLazyThread() {
+  if (lazyStart) {
+    lazyStart = false;
+    startThread(lazyPriority, lazyStackDepth);
+  }
+}
+
+void ChassisControllerPID::startScheduled(const std::shared_ptr<ControlScheduler> &ischeduler) {
+  if (!task && !scheduler) {
+    beginStepping();
+    scheduler = ischeduler;
+    schedulerLoopId = scheduler->addLoop([this]() { step(); },
+                                         [this]() { return threadSleepTime; },
+                                         ControlScheduler::phase::controllers);
   }
 }
 
@@ -326,9 +834,20 @@ CrossplatformThread *ChassisControllerPID::getThread() const {
   return task;
 }
 
+void ChassisControllerPID::addTelemetry(const std::shared_ptr<TelemetryStream> &istream,
+                                        const std::string &iname) {
+  telemetry.add(istream, iname + ".distanceError", [this]() { return distancePid->getError(); });
+  telemetry.add(istream, iname + ".distanceOutput", [this]() { return distancePid->getOutput(); });
+  telemetry.add(istream, iname + ".turnError", [this]() { return turnPid->getError(); });
+  telemetry.add(istream, iname + ".turnOutput", [this]() { return turnPid->getOutput(); });
+  telemetry.add(istream, iname + ".angleError", [this]() { return anglePid->getError(); });
+  telemetry.add(istream, iname + ".angleOutput", [this]() { return anglePid->getOutput(); });
+}
+
 void ChassisControllerPID::stop() {
   LOG_INFO_S("ChassisControllerPID: Stopping");
 
+  clearQueue();
   mode = none;
   doneLooping.store(true, std::memory_order_release);
   stopAfterSettled();
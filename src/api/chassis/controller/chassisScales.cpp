@@ -37,6 +37,7 @@ ChassisScales::ChassisScales(const std::initializer_list<QLength> &idimensions,
   straight = static_cast<double>(tpr / (wheelDiameter.convert(meter) * 1_pi));
   turn = wheelTrack.convert(meter) / wheelDiameter.convert(meter) * itpr / 360.0;
   middle = static_cast<double>(tpr / (middleWheelDiameter.convert(meter) * 1_pi));
+  computeDerivedScales();
 }
 
 ChassisScales::ChassisScales(const std::initializer_list<double> &iscales,
@@ -70,6 +71,19 @@ ChassisScales::ChassisScales(const std::initializer_list<double> &iscales,
   } else {
     middleWheelDistance = 0_m;
   }
+
+  computeDerivedScales();
+}
+
+void ChassisScales::computeDerivedScales() {
+  metersPerTick = 1 / straight;
+  middleMetersPerTick = 1 / middle;
+  inverseWheelTrack = 1 / wheelTrack.convert(meter);
+  wheelRpmPerMps = 60 / (wheelDiameter.convert(meter) * 1_pi);
+}
+
+double ChassisScales::getMotorRpmPerMps(const AbstractMotor::GearsetRatioPair &ipair) const {
+  return wheelRpmPerMps * ipair.ratio;
 }
 
 void ChassisScales::validateInputSize(size_t inputSize, const std::shared_ptr<Logger> &logger) {
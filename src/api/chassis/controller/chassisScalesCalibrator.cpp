@@ -0,0 +1,124 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#include "okapi/api/chassis/controller/chassisScalesCalibrator.hpp"
+#include <cmath>
+
+namespace okapi {
+ChassisScalesCalibrator::ChassisScalesCalibrator(std::shared_ptr<ChassisModel> imodel,
+                                                 const ChassisScales &iinitialScales,
+                                                 const TimeUtil &itimeUtil,
+                                                 std::shared_ptr<Logger> ilogger)
+  : logger(std::move(ilogger)),
+    model(std::move(imodel)),
+    timeUtil(itimeUtil),
+    tpr(iinitialScales.tpr),
+    straight(iinitialScales.straight),
+    wheelTrack(iinitialScales.wheelTrack),
+    middleWheelDistance(iinitialScales.middleWheelDistance),
+    middleWheelDiameter(iinitialScales.middleWheelDiameter) {
+}
+
+bool ChassisScalesCalibrator::measureStraight(const std::function<QLength()> &idistanceToWall,
+                                              const QLength &idistance,
+                                              const double ispeed,
+                                              const QTime &itimeout,
+                                              const QTime &isettleTime) {
+  const auto startTicks = model->getSensorVals();
+  const QLength startDistance = idistanceToWall();
+
+  if (!runManeuver([&] { model->forward(std::abs(ispeed)); },
+                   [&] { return startDistance - idistanceToWall() >= idistance; },
+                   itimeout,
+                   isettleTime)) {
+    LOG_WARN_S("ChassisScalesCalibrator: The straight drive timed out.");
+    return false;
+  }
+
+  const auto endTicks = model->getSensorVals();
+  const double driven = (startDistance - idistanceToWall()).convert(meter);
+  if (startTicks.size() < 2 || endTicks.size() < 2 || driven <= 0) {
+    LOG_WARN_S("ChassisScalesCalibrator: The straight drive did not move the robot.");
+    return false;
+  }
+
+  const double ticks = ((endTicks[0] - startTicks[0]) + (endTicks[1] - startTicks[1])) / 2.0;
+  straight = ticks / driven;
+  LOG_INFO("ChassisScalesCalibrator: The straight scale is " + std::to_string(straight) +
+           " ticks per meter.");
+  return true;
+}
+
+bool ChassisScalesCalibrator::measureTurn(const std::shared_ptr<ContinuousRotarySensor> &iheading,
+                                          const int iturns,
+                                          const double ispeed,
+                                          const QTime &itimeout,
+                                          const QTime &isettleTime) {
+  const auto startTicks = model->getSensorVals();
+  const double startHeading = iheading->get();
+  const double target = std::abs(iturns) * 360.0;
+
+  if (!runManeuver([&] { model->rotate(std::abs(ispeed)); },
+                   [&] { return std::abs(iheading->get() - startHeading) >= target; },
+                   itimeout,
+                   isettleTime)) {
+    LOG_WARN_S("ChassisScalesCalibrator: The spin timed out.");
+    return false;
+  }
+
+  const auto endTicks = model->getSensorVals();
+  const double turned = (iheading->get() - startHeading) * degree.convert(radian);
+  if (startTicks.size() < 2 || endTicks.size() < 2 || turned == 0) {
+    LOG_WARN_S("ChassisScalesCalibrator: The spin did not turn the robot.");
+    return false;
+  }
+
+  // The wheels roll in opposite directions around the center, so their difference over the turn is
+  // the distance between them
+  const double leftMinusRight =
+    ((endTicks[0] - startTicks[0]) - (endTicks[1] - startTicks[1])) / straight;
+  wheelTrack = leftMinusRight / turned * meter;
+  LOG_INFO("ChassisScalesCalibrator: The wheel track is " +
+           std::to_string(wheelTrack.convert(inch)) + " inches.");
+
+  if (startTicks.size() >= 3 && endTicks.size() >= 3) {
+    // Spinning in place doesn't strafe, so odometry must see the middle wheel roll back by the turn
+    // times its distance from the center
+    const double middle = tpr / (middleWheelDiameter.convert(meter) * 1_pi);
+    middleWheelDistance = -(endTicks[2] - startTicks[2]) / middle / turned * meter;
+    LOG_INFO("ChassisScalesCalibrator: The middle wheel is " +
+             std::to_string(middleWheelDistance.convert(inch)) + " inches from the center.");
+  }
+
+  return true;
+}
+
+ChassisScales ChassisScalesCalibrator::getScales() const {
+  const QLength wheelDiameter = tpr / (straight * 1_pi) * meter;
+  return ChassisScales({wheelDiameter, wheelTrack, middleWheelDistance, middleWheelDiameter},
+                       tpr,
+                       logger);
+}
+
+bool ChassisScalesCalibrator::runManeuver(const std::function<void()> &idrive,
+                                          const std::function<bool()> &idone,
+                                          const QTime &itimeout,
+                                          const QTime &isettleTime) {
+  auto timer = timeUtil.getTimer();
+  auto rate = timeUtil.getRate();
+  timer->placeMark();
+
+  idrive();
+  bool done = idone();
+  while (!done && timer->getDtFromMark() < itimeout) {
+    rate->delayUntil(10_ms);
+    done = idone();
+  }
+
+  model->stop();
+  rate->delayUntil(isettleTime);
+  return done;
+}
+} // namespace okapi
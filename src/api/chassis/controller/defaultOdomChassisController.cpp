@@ -5,6 +5,7 @@
  */
 #include "okapi/api/chassis/controller/defaultOdomChassisController.hpp"
 #include "okapi/api/odometry/odomMath.hpp"
+#include <algorithm>
 #include <cmath>
 
 namespace okapi {
@@ -18,19 +19,23 @@ DefaultOdomChassisController::DefaultOdomChassisController(
   std::shared_ptr<Logger> ilogger)
   : OdomChassisController(itimeUtil, std::move(iodometry), imode, imoveThreshold, iturnThreshold),
     logger(std::move(ilogger)),
-    controller(std::move(icontroller)) {
+    controller(std::move(icontroller)),
+    moveRate(timeUtil.getRate()) {
 }
 
 void DefaultOdomChassisController::waitForOdomTask() {
-  if (odomTaskRunning) {
-    // Early exit to save calling getRate
+  if (odomReady.load(std::memory_order_acquire)) {
     return;
   }
 
-  auto rate = timeUtil.getRate();
-  while (!odomTaskRunning) {
-    LOG_INFO_S("DefaultOdomChassisController: Waiting for odometry task to start.");
-    rate->delayUntil(10);
+  LOG_INFO_S("DefaultOdomChassisController: Waiting for odometry task to start.");
+
+  // The odometry notifies odomReadyEvent after its first step. The timeout is only a fallback.
+  auto generation = odomReadyEvent.getGeneration();
+  while (!odomReady.load(std::memory_order_acquire) &&
+         !dtorCalled.load(std::memory_order_acquire)) {
+    odomReadyEvent.waitFor(generation, 100);
+    generation = odomReadyEvent.getGeneration();
   }
 }
 
@@ -66,6 +71,152 @@ void DefaultOdomChassisController::driveToPoint(const Point &ipoint,
   }
 }
 
+void DefaultOdomChassisController::driveToPointCurved(const Point &ipoint,
+                                                      const bool ibackwards,
+                                                      const QLength &ioffset) {
+  waitForOdomTask();
+
+  const Point target = ipoint.inFT(defaultStateMode);
+  const CurvedMotionSettings settings = curvedMotionSettings;
+  auto chassisModel = controller->getModel();
+
+  LOG_INFO("DefaultOdomChassisController: Driving along a curve to " +
+           std::to_string(target.x.convert(meter)) + ", " +
+           std::to_string(target.y.convert(meter)) + " meters");
+
+  controller->stop();
+  while (!dtorCalled.load(std::memory_order_acquire) &&
+         !stepCurvedMotion(target, ibackwards, ioffset, 0_m, settings, *chassisModel)) {
+    moveRate->delayUntil(10_ms);
+  }
+  moveRate->reset();
+
+  chassisModel->stop();
+}
+
+void DefaultOdomChassisController::driveThrough(const std::vector<Point> &ipoints,
+                                                const bool ibackwards) {
+  if (ipoints.empty()) {
+    LOG_WARN_S("DefaultOdomChassisController: No points to drive through.");
+    return;
+  }
+
+  waitForOdomTask();
+
+  std::vector<Point> points;
+  points.reserve(ipoints.size());
+  for (const auto &point : ipoints) {
+    points.push_back(point.inFT(defaultStateMode));
+  }
+
+  // The length of the path left after each point
+  std::vector<double> pathLeftAfter(points.size(), 0);
+  for (std::size_t i = points.size() - 1; i > 0; i--) {
+    pathLeftAfter[i - 1] =
+      pathLeftAfter[i] + std::hypot((points[i].x - points[i - 1].x).convert(meter),
+                                    (points[i].y - points[i - 1].y).convert(meter));
+  }
+
+  const CurvedMotionSettings settings = curvedMotionSettings;
+  const double lookahead = settings.lookahead.convert(meter);
+  auto chassisModel = controller->getModel();
+
+  LOG_INFO("DefaultOdomChassisController: Driving through " + std::to_string(points.size()) +
+           " points");
+
+  controller->stop();
+  const OdomState start = odom->getState(StateMode::FRAME_TRANSFORMATION);
+  Point segmentStart{start.x, start.y};
+  std::size_t index = 0;
+  while (!dtorCalled.load(std::memory_order_acquire)) {
+    const OdomState state = odom->getState(StateMode::FRAME_TRANSFORMATION);
+    const double x = state.x.convert(meter);
+    const double y = state.y.convert(meter);
+
+    // Move on to the next point once the current one is within the lookahead
+    while (index + 1 < points.size() &&
+           std::hypot(points[index].x.convert(meter) - x, points[index].y.convert(meter) - y) <
+             lookahead) {
+      segmentStart = points[index];
+      index++;
+    }
+
+    Point target = points[index];
+    QLength pathLeft = pathLeftAfter[index] * meter;
+    if (index + 1 < points.size()) {
+      // Steer toward the point the lookahead past the robot along the line to the current point
+      const double startX = segmentStart.x.convert(meter);
+      const double startY = segmentStart.y.convert(meter);
+      const double segmentX = target.x.convert(meter) - startX;
+      const double segmentY = target.y.convert(meter) - startY;
+      const double segmentLength = std::hypot(segmentX, segmentY);
+      if (segmentLength > 0) {
+        const double along = std::clamp(
+          ((x - startX) * segmentX + (y - startY) * segmentY) / segmentLength + lookahead,
+          0.0,
+          segmentLength);
+        target = {(startX + segmentX * along / segmentLength) * meter,
+                  (startY + segmentY * along / segmentLength) * meter};
+        pathLeft += (segmentLength - along) * meter;
+      }
+    }
+
+    if (stepCurvedMotion(target, ibackwards, 0_m, pathLeft, settings, *chassisModel)) {
+      break;
+    }
+
+    moveRate->delayUntil(10_ms);
+  }
+  moveRate->reset();
+
+  chassisModel->stop();
+}
+
+bool DefaultOdomChassisController::stepCurvedMotion(const Point &itarget,
+                                                    const bool ibackwards,
+                                                    const QLength &ioffset,
+                                                    const QLength &ipathLeft,
+                                                    const CurvedMotionSettings &isettings,
+                                                    ChassisModel &imodel) {
+  auto [length, angle] = OdomMath::computeDistanceAndAngleToPoint(
+    itarget, odom->getState(StateMode::FRAME_TRANSFORMATION));
+
+  if (ibackwards) {
+    angle += 180_deg;
+  }
+
+  angle = OdomMath::constrainAngle180(angle);
+
+  const double cosAngle = std::cos(angle.convert(radian));
+  const QLength remaining = length - ioffset;
+  // The distance left along the heading, which goes negative once the robot passes the point
+  const QLength remainingAhead = length * cosAngle - ioffset;
+  const bool last = ipathLeft <= 0_m;
+  const bool straight = last && remaining < isettings.straightDistance;
+
+  if (last && (remaining.abs() < isettings.tolerance ||
+               (straight && remainingAhead < isettings.tolerance))) {
+    return true;
+  }
+
+  double forward;
+  double yaw;
+  if (straight) {
+    forward = isettings.distanceGain * remainingAhead.convert(meter);
+    yaw = 0;
+  } else {
+    // Slow down while the point is off to the side, and turn in place while it is beside or
+    // behind the robot
+    forward =
+      isettings.distanceGain * (remaining + ipathLeft).convert(meter) * std::max(0.0, cosAngle);
+    yaw = isettings.angleGain * angle.convert(radian);
+  }
+
+  imodel.driveVector((ibackwards ? -1 : 1) * std::clamp(forward, -1.0, 1.0),
+                     std::clamp(yaw, -1.0, 1.0));
+  return false;
+}
+
 void DefaultOdomChassisController::turnToPoint(const Point &ipoint) {
   waitForOdomTask();
 
@@ -142,6 +293,10 @@ void DefaultOdomChassisController::waitUntilSettled() {
   controller->waitUntilSettled();
 }
 
+MoveResult DefaultOdomChassisController::getLastMoveResult() const {
+  return controller->getLastMoveResult();
+}
+
 void DefaultOdomChassisController::stop() {
   controller->stop();
 }
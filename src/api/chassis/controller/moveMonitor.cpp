@@ -0,0 +1,41 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#include "okapi/api/chassis/controller/moveMonitor.hpp"
+#include <cmath>
+
+namespace okapi {
+void MoveMonitor::setTimeout(const QTime itimeout) {
+  timeout = itimeout;
+}
+
+void MoveMonitor::setStallDetection(const double iminSpeed, const QTime istallTime) {
+  minSpeed = std::abs(iminSpeed);
+  stallTime = istallTime;
+}
+
+void MoveMonitor::start(const QTime inow, const double iposition) {
+  startTime = inow;
+  anchorTime = inow;
+  anchorPosition = iposition;
+}
+
+std::optional<MoveResult> MoveMonitor::check(const QTime inow, const double iposition) {
+  if (timeout > 0_ms && inow - startTime >= timeout) {
+    return MoveResult::timedOut;
+  }
+
+  if (stallTime > 0_ms) {
+    if (std::abs(iposition - anchorPosition) > minSpeed * stallTime.convert(second)) {
+      anchorTime = inow;
+      anchorPosition = iposition;
+    } else if (inow - anchorTime >= stallTime) {
+      return MoveResult::stalled;
+    }
+  }
+
+  return std::nullopt;
+}
+} // namespace okapi
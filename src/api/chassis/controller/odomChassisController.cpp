@@ -4,6 +4,8 @@
  * file, You can obtain one at http://mozilla.org/MPL/2.0/.
  */
 #include "okapi/api/chassis/controller/odomChassisController.hpp"
+#include "okapi/api/util/taskProfiler.hpp"
+#include <stdexcept>
 
 namespace okapi {
 OdomChassisController::OdomChassisController(TimeUtil itimeUtil,
@@ -22,6 +24,9 @@ OdomChassisController::OdomChassisController(TimeUtil itimeUtil,
 
 OdomChassisController::~OdomChassisController() {
   dtorCalled.store(true, std::memory_order_release);
+  if (scheduler) {
+    scheduler->removeLoop(schedulerLoopId);
+  }
   delete odomTask;
 }
 
@@ -45,6 +50,23 @@ void OdomChassisController::setTurnThreshold(const QAngle &iturnTreshold) {
   turnThreshold = iturnTreshold;
 }
 
+void OdomChassisController::setCurvedMotionSettings(const CurvedMotionSettings &isettings) {
+  if (!(isettings.distanceGain > 0) || !(isettings.angleGain > 0) || isettings.tolerance <= 0_m ||
+      isettings.straightDistance <= 0_m || isettings.lookahead <= 0_m) {
+    std::string msg(
+      "OdomChassisController: The curved motion gains and distances must be positive.");
+    LOG_ERROR(msg);
+    throw std::invalid_argument(msg);
+  }
+
+  curvedMotionSettings = isettings;
+}
+
+OdomChassisController::CurvedMotionSettings
+OdomChassisController::getCurvedMotionSettings() const {
+  return curvedMotionSettings;
+}
+
 QLength OdomChassisController::getMoveThreshold() const {
   return moveThreshold;
 }
@@ -53,9 +75,36 @@ QAngle OdomChassisController::getTurnThreshold() const {
   return turnThreshold;
 }
 
-void OdomChassisController::startOdomThread() {
-  if (!odomTask) {
-    odomTask = new CrossplatformThread(trampoline, this, "OdomChassisController");
+void OdomChassisController::setOdomLoopPeriod(const QTime &iperiod) {
+  if (iperiod < 1_ms) {
+    std::string msg("OdomChassisController: The odometry loop period must be at least 1 ms.");
+    LOG_ERROR(msg);
+    throw std::invalid_argument(msg);
+  }
+
+  odomLoopPeriod = iperiod;
+}
+
+QTime OdomChassisController::getOdomLoopPeriod() const {
+  return odomLoopPeriod;
+}
+
+void OdomChassisController::startOdomThread(const std::uint32_t ipriority,
+                                            const std::uint16_t istackDepth) {
+  if (!odomTask && !scheduler) {
+    odomTask = new CrossplatformThread(
+      trampoline, this, "OdomChassisController", ipriority, istackDepth);
+  }
+}
+
+void OdomChassisController::startOdomScheduled(
+  const std::shared_ptr<ControlScheduler> &ischeduler) {
+  if (!odomTask && !scheduler) {
+    scheduler = ischeduler;
+    schedulerLoopId = scheduler->addLoop([this]() { stepOdom(); },
+                                         [this]() { return odomLoopPeriod; },
+                                         ControlScheduler::phase::odometry);
+    odomTaskRunning = true;
   }
 }
 
@@ -69,16 +118,24 @@ void OdomChassisController::loop() {
   odomTaskRunning = true;
   LOG_INFO_S("Started OdomChassisController task.");
 
-  auto rate = timeUtil.getRate();
+  auto rate = std::make_unique<ProfiledRate>(timeUtil.getRate(), "OdomChassisController");
   while (!dtorCalled.load(std::memory_order_acquire) && !odomTask->notifyTake(0)) {
-    odom->step();
-    rate->delayUntil(10_ms);
+    stepOdom();
+    rate->delayUntil(odomLoopPeriod);
   }
 
   odomTaskRunning = false;
   LOG_INFO_S("Stopped OdomChassisController task.");
 }
 
+void OdomChassisController::stepOdom() {
+  odom->step();
+  if (!odomReady.load(std::memory_order_relaxed)) {
+    odomReady.store(true, std::memory_order_release);
+    odomReadyEvent.notifyAll();
+  }
+}
+
 CrossplatformThread *OdomChassisController::getOdomThread() const {
   return odomTask;
 }
@@ -0,0 +1,183 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#include "okapi/api/chassis/controller/slipDetector.hpp"
+#include "okapi/api/util/flightRecorder.hpp"
+#include <algorithm>
+#include <cmath>
+#include <mutex>
+
+namespace okapi {
+SlipDetector::SlipDetector(std::shared_ptr<SkidSteerModel> imodel,
+                           const ChassisScales &idriveScales,
+                           const AbstractMotor::GearsetRatioPair &igearset,
+                           const ChassisScales &itrackingScales,
+                           const TimeUtil &itimeUtil,
+                           const QSpeed &islipSpeed,
+                           std::shared_ptr<Logger> ilogger)
+  : logger(std::move(ilogger)),
+    model(std::move(imodel)),
+    metersPerMotorUnit(idriveScales.metersPerTick / igearset.ratio),
+    metersPerTrackingTick(itrackingScales.metersPerTick),
+    timeUtil(itimeUtil),
+    timer(timeUtil.getTimer()),
+    slipSpeed(islipSpeed.convert(mps)) {
+  if (model == nullptr) {
+    std::string msg = "SlipDetector: The model cannot be null.";
+    LOG_ERROR(msg);
+    throw std::invalid_argument(msg);
+  }
+
+  if (!(slipSpeed > 0)) {
+    std::string msg = "SlipDetector: The slip speed must be greater than zero.";
+    LOG_ERROR(msg);
+    throw std::invalid_argument(msg);
+  }
+}
+
+SlipDetector::~SlipDetector() {
+  dtorCalled.store(true, std::memory_order_release);
+  delete task;
+}
+
+void SlipDetector::step() {
+  const double leftMotor = model->getLeftSideMotor()->getPosition();
+  const double rightMotor = model->getRightSideMotor()->getPosition();
+  if (model->getSensorVals(trackingTicks) < 2) {
+    LOG_ERROR_S("SlipDetector: The model did not read two tracking wheels.");
+    return;
+  }
+
+  const double dt = timer->getDt().convert(second);
+  if (hasLast && dt > 0) {
+    const double rawLeft = ((leftMotor - lastLeftMotor) * metersPerMotorUnit -
+                            (trackingTicks[0] - lastTrackingTicks[0]) * metersPerTrackingTick) /
+                           dt;
+    const double rawRight = ((rightMotor - lastRightMotor) * metersPerMotorUnit -
+                             (trackingTicks[1] - lastTrackingTicks[1]) * metersPerTrackingTick) /
+                            dt;
+
+    const double left = leftSlip.load(std::memory_order_relaxed);
+    const double right = rightSlip.load(std::memory_order_relaxed);
+    const double newLeft = left + filterGain * (rawLeft - left);
+    const double newRight = right + filterGain * (rawRight - right);
+    leftSlip.store(newLeft, std::memory_order_relaxed);
+    rightSlip.store(newRight, std::memory_order_relaxed);
+
+    // Update the flags under the lock so the limited model always sees whether they changed
+    std::scoped_lock lock(limitMutex);
+    const bool wasSlipping = isSlipping();
+    const bool slipping =
+      updateSlipping(leftSlipping, newLeft) | updateSlipping(rightSlipping, newRight);
+
+    if (slipping != wasSlipping) {
+      if (slipping) {
+        slipCount.fetch_add(1, std::memory_order_relaxed);
+        FlightRecorder::recordDefault(FlightEventType::wheelSlip,
+                                      "SlipDetector",
+                                      leftSlipping.load() ? 0 : 1,
+                                      std::max(std::abs(newLeft), std::abs(newRight)));
+      }
+
+      if (limitedModel) {
+        if (slipping) {
+          normalAccelStep = limitedModel->getAccelStep();
+          limitedModel->setAccelStep(slipAccelStep);
+        } else {
+          limitedModel->setAccelStep(normalAccelStep);
+        }
+      }
+    }
+  }
+
+  hasLast = true;
+  lastLeftMotor = leftMotor;
+  lastRightMotor = rightMotor;
+  lastTrackingTicks = trackingTicks;
+}
+
+bool SlipDetector::updateSlipping(std::atomic_bool &islipping, const double islip) const {
+  const bool slipping = islipping.load(std::memory_order_relaxed)
+                          ? std::abs(islip) > slipSpeed / 2
+                          : std::abs(islip) > slipSpeed;
+  islipping.store(slipping, std::memory_order_relaxed);
+  return slipping;
+}
+
+bool SlipDetector::isSlipping() const {
+  return isLeftSlipping() || isRightSlipping();
+}
+
+bool SlipDetector::isLeftSlipping() const {
+  return leftSlipping.load(std::memory_order_relaxed);
+}
+
+bool SlipDetector::isRightSlipping() const {
+  return rightSlipping.load(std::memory_order_relaxed);
+}
+
+QSpeed SlipDetector::getLeftSlip() const {
+  return leftSlip.load(std::memory_order_relaxed) * mps;
+}
+
+QSpeed SlipDetector::getRightSlip() const {
+  return rightSlip.load(std::memory_order_relaxed) * mps;
+}
+
+std::uint32_t SlipDetector::getSlipCount() const {
+  return slipCount.load(std::memory_order_relaxed);
+}
+
+void SlipDetector::limitAcceleration(std::shared_ptr<SlewRateChassisModel> imodel,
+                                     const double islipAccelStep) {
+  if (imodel && !(islipAccelStep > 0)) {
+    std::string msg = "SlipDetector: The acceleration step while slipping must be greater than "
+                      "zero.";
+    LOG_ERROR(msg);
+    throw std::invalid_argument(msg);
+  }
+
+  std::scoped_lock lock(limitMutex);
+  const bool slipping = isSlipping();
+  if (limitedModel && slipping) {
+    limitedModel->setAccelStep(normalAccelStep);
+  }
+
+  limitedModel = std::move(imodel);
+  slipAccelStep = islipAccelStep;
+  if (limitedModel && slipping) {
+    normalAccelStep = limitedModel->getAccelStep();
+    limitedModel->setAccelStep(slipAccelStep);
+  }
+}
+
+void SlipDetector::startThread(const std::uint32_t ipriority, const std::uint16_t istackDepth) {
+  if (!task) {
+    task = new CrossplatformThread(trampoline, this, "SlipDetector", ipriority, istackDepth);
+  }
+}
+
+CrossplatformThread *SlipDetector::getThread() const {
+  return task;
+}
+
+void SlipDetector::trampoline(void *context) {
+  if (context) {
+    static_cast<SlipDetector *>(context)->loop();
+  }
+}
+
+void SlipDetector::loop() {
+  LOG_INFO_S("Started SlipDetector task.");
+
+  auto rate = timeUtil.getRate();
+  while (!dtorCalled.load(std::memory_order_acquire) && !task->notifyTake(0)) {
+    step();
+    rate->delayUntil(10_ms);
+  }
+
+  LOG_INFO_S("Stopped SlipDetector task.");
+}
+} // namespace okapi
@@ -67,8 +67,9 @@ void HDriveModel::driveVectorVoltage(const double iforwardSpeed, const double iy
     rightOutput /= maxInputMag;
   }
 
-  leftSideMotor->moveVoltage(static_cast<int16_t>(leftOutput * maxVoltage));
-  rightSideMotor->moveVoltage(static_cast<int16_t>(rightOutput * maxVoltage));
+  const double voltage = getCompensatedMaxVoltage();
+  leftSideMotor->moveVoltage(static_cast<int16_t>(leftOutput * voltage));
+  rightSideMotor->moveVoltage(static_cast<int16_t>(rightOutput * voltage));
   middleMotor->moveVelocity(0);
 }
 
@@ -98,8 +99,9 @@ void HDriveModel::tank(const double ileftSpeed, const double irightSpeed, const
     rightSpeed = 0;
   }
 
-  leftSideMotor->moveVoltage(static_cast<int16_t>(leftSpeed * maxVoltage));
-  rightSideMotor->moveVoltage(static_cast<int16_t>(rightSpeed * maxVoltage));
+  const double voltage = getCompensatedMaxVoltage();
+  leftSideMotor->moveVoltage(static_cast<int16_t>(leftSpeed * voltage));
+  rightSideMotor->moveVoltage(static_cast<int16_t>(rightSpeed * voltage));
   middleMotor->moveVelocity(0);
 }
 
@@ -138,9 +140,10 @@ void HDriveModel::arcade(const double iforwardSpeed, const double iyaw, const do
     }
   }
 
-  leftSideMotor->moveVoltage(static_cast<int16_t>(std::clamp(leftOutput, -1.0, 1.0) * maxVoltage));
+  const double voltage = getCompensatedMaxVoltage();
+  leftSideMotor->moveVoltage(static_cast<int16_t>(std::clamp(leftOutput, -1.0, 1.0) * voltage));
   rightSideMotor->moveVoltage(
-    static_cast<int16_t>(std::clamp(rightOutput, -1.0, 1.0) * maxVoltage));
+    static_cast<int16_t>(std::clamp(rightOutput, -1.0, 1.0) * voltage));
   middleMotor->moveVelocity(0);
 }
 
@@ -175,8 +178,9 @@ void HDriveModel::curvature(const double iforwardSpeed,
     rightSpeed /= maxSpeed;
   }
 
-  leftSideMotor->moveVoltage(static_cast<int16_t>(leftSpeed * maxVoltage));
-  rightSideMotor->moveVoltage(static_cast<int16_t>(rightSpeed * maxVoltage));
+  const double voltage = getCompensatedMaxVoltage();
+  leftSideMotor->moveVoltage(static_cast<int16_t>(leftSpeed * voltage));
+  rightSideMotor->moveVoltage(static_cast<int16_t>(rightSpeed * voltage));
   middleMotor->moveVelocity(0);
 }
 
@@ -199,11 +203,12 @@ void HDriveModel::hArcade(const double ixSpeed,
     yaw = 0;
   }
 
+  const double voltage = getCompensatedMaxVoltage();
   leftSideMotor->moveVoltage(
-    static_cast<int16_t>(std::clamp(forwardSpeed + yaw, -1.0, 1.0) * maxVoltage));
+    static_cast<int16_t>(std::clamp(forwardSpeed + yaw, -1.0, 1.0) * voltage));
   rightSideMotor->moveVoltage(
-    static_cast<int16_t>(std::clamp(forwardSpeed - yaw, -1.0, 1.0) * maxVoltage));
-  middleMotor->moveVoltage(static_cast<int16_t>(std::clamp(xSpeed, -1.0, 1.0) * maxVoltage));
+    static_cast<int16_t>(std::clamp(forwardSpeed - yaw, -1.0, 1.0) * voltage));
+  middleMotor->moveVoltage(static_cast<int16_t>(std::clamp(xSpeed, -1.0, 1.0) * voltage));
 }
 
 void HDriveModel::hCurvature(const double ixSpeed,
@@ -241,9 +246,10 @@ void HDriveModel::hCurvature(const double ixSpeed,
     rightSpeed /= maxSpeed;
   }
 
-  leftSideMotor->moveVoltage(static_cast<int16_t>(leftSpeed * maxVoltage));
-  rightSideMotor->moveVoltage(static_cast<int16_t>(rightSpeed * maxVoltage));
-  middleMotor->moveVoltage(static_cast<int16_t>(xSpeed * maxVoltage));
+  const double voltage = getCompensatedMaxVoltage();
+  leftSideMotor->moveVoltage(static_cast<int16_t>(leftSpeed * voltage));
+  rightSideMotor->moveVoltage(static_cast<int16_t>(rightSpeed * voltage));
+  middleMotor->moveVoltage(static_cast<int16_t>(xSpeed * voltage));
 }
 
 void HDriveModel::left(const double ispeed) {
@@ -258,12 +264,32 @@ void HDriveModel::middle(const double ispeed) {
   middleMotor->moveVelocity(static_cast<int16_t>(std::clamp(ispeed, -1.0, 1.0) * maxVelocity));
 }
 
+void HDriveModel::middleVoltage(const double ivoltage) {
+  middleMotor->moveVoltage(
+    static_cast<int16_t>(std::clamp(ivoltage, -1.0, 1.0) * getCompensatedMaxVoltage()));
+}
+
 std::valarray<std::int32_t> HDriveModel::getSensorVals() const {
   return std::valarray<std::int32_t>{static_cast<std::int32_t>(leftSensor->get()),
                                      static_cast<std::int32_t>(rightSensor->get()),
                                      static_cast<std::int32_t>(middleSensor->get())};
 }
 
+std::size_t HDriveModel::getSensorVals(SensorValues &ovalues) const {
+  ovalues[0] = static_cast<std::int32_t>(leftSensor->get());
+  ovalues[1] = static_cast<std::int32_t>(rightSensor->get());
+  ovalues[2] = static_cast<std::int32_t>(middleSensor->get());
+  return 3;
+}
+
+std::size_t HDriveModel::getSensorSamples(SensorValues &ovalues,
+                                          SensorTimestamps &otimestamps) const {
+  ovalues[0] = static_cast<std::int32_t>(leftSensor->getTimestamped(otimestamps[0]));
+  ovalues[1] = static_cast<std::int32_t>(rightSensor->getTimestamped(otimestamps[1]));
+  ovalues[2] = static_cast<std::int32_t>(middleSensor->getTimestamped(otimestamps[2]));
+  return 3;
+}
+
 void HDriveModel::resetSensors() {
   leftSensor->reset();
   rightSensor->reset();
@@ -319,4 +345,27 @@ std::shared_ptr<AbstractMotor> HDriveModel::getRightSideMotor() const {
 std::shared_ptr<AbstractMotor> HDriveModel::getMiddleMotor() const {
   return middleMotor;
 }
+
+void HDriveModel::setVoltageCompensator(std::shared_ptr<VoltageCompensator> icompensator) {
+  voltageCompensator = std::move(icompensator);
+}
+
+std::shared_ptr<VoltageCompensator> HDriveModel::getVoltageCompensator() const {
+  return voltageCompensator;
+}
+
+double HDriveModel::getCompensatedMaxVoltage() const {
+  if (voltageCompensator == nullptr) {
+    return maxVoltage;
+  }
+
+  return voltageCompensator->compensate(maxVoltage);
+}
+
+void HDriveModel::applyCommands(const WheelCommands &icommands) {
+  writeWheelCommands<3>(icommands,
+                        {leftSideMotor.get(), rightSideMotor.get(), middleMotor.get()},
+                        maxVelocity,
+                        getCompensatedMaxVoltage());
+}
 } // namespace okapi
@@ -6,6 +6,7 @@
 #include "okapi/api/chassis/model/skidSteerModel.hpp"
 #include "okapi/api/util/mathUtil.hpp"
 #include <algorithm>
+#include <cmath>
 #include <utility>
 
 namespace okapi {
@@ -61,8 +62,9 @@ void SkidSteerModel::driveVectorVoltage(const double iforwardSpeed, const double
     rightOutput /= maxInputMag;
   }
 
-  leftSideMotor->moveVoltage(static_cast<int16_t>(leftOutput * maxVoltage));
-  rightSideMotor->moveVoltage(static_cast<int16_t>(rightOutput * maxVoltage));
+  const double voltage = getCompensatedMaxVoltage();
+  leftSideMotor->moveVoltage(static_cast<int16_t>(leftOutput * voltage));
+  rightSideMotor->moveVoltage(static_cast<int16_t>(rightOutput * voltage));
 }
 
 void SkidSteerModel::rotate(const double ispeed) {
@@ -91,8 +93,9 @@ void SkidSteerModel::tank(const double ileftSpeed,
     rightSpeed = 0;
   }
 
-  leftSideMotor->moveVoltage(static_cast<int16_t>(leftSpeed * maxVoltage));
-  rightSideMotor->moveVoltage(static_cast<int16_t>(rightSpeed * maxVoltage));
+  const double voltage = getCompensatedMaxVoltage();
+  leftSideMotor->moveVoltage(static_cast<int16_t>(leftSpeed * voltage));
+  rightSideMotor->moveVoltage(static_cast<int16_t>(rightSpeed * voltage));
 }
 
 void SkidSteerModel::arcade(const double iforwardSpeed,
@@ -132,9 +135,10 @@ void SkidSteerModel::arcade(const double iforwardSpeed,
     }
   }
 
-  leftSideMotor->moveVoltage(static_cast<int16_t>(std::clamp(leftOutput, -1.0, 1.0) * maxVoltage));
+  const double voltage = getCompensatedMaxVoltage();
+  leftSideMotor->moveVoltage(static_cast<int16_t>(std::clamp(leftOutput, -1.0, 1.0) * voltage));
   rightSideMotor->moveVoltage(
-    static_cast<int16_t>(std::clamp(rightOutput, -1.0, 1.0) * maxVoltage));
+    static_cast<int16_t>(std::clamp(rightOutput, -1.0, 1.0) * voltage));
 }
 
 void SkidSteerModel::curvature(const double iforwardSpeed,
@@ -168,8 +172,112 @@ void SkidSteerModel::curvature(const double iforwardSpeed,
     rightSpeed /= maxSpeed;
   }
 
-  leftSideMotor->moveVoltage(static_cast<int16_t>(leftSpeed * maxVoltage));
-  rightSideMotor->moveVoltage(static_cast<int16_t>(rightSpeed * maxVoltage));
+  const double voltage = getCompensatedMaxVoltage();
+  leftSideMotor->moveVoltage(static_cast<int16_t>(leftSpeed * voltage));
+  rightSideMotor->moveVoltage(static_cast<int16_t>(rightSpeed * voltage));
+}
+
+void SkidSteerModel::cheesyDrive(const double ithrottle,
+                                 const double iwheel,
+                                 const bool iquickTurn,
+                                 const double ithreshold) {
+  // This code is adapted from Team 254. All credit goes to them. Link:
+  // https://github.com/Team254/FRC-2016-Public/blob/master/src/com/team254/frc2016/CheesyDriveHelper.java
+  double throttle = std::clamp(ithrottle, -1.0, 1.0);
+  if (std::abs(throttle) < ithreshold) {
+    throttle = 0;
+  }
+
+  double wheel = std::clamp(iwheel, -1.0, 1.0);
+  if (std::abs(wheel) < ithreshold) {
+    wheel = 0;
+  }
+
+  const double negInertia = wheel - cheesyOldWheel;
+  cheesyOldWheel = wheel;
+
+  // Bend the turn stick twice so small inputs turn gently
+  const double nonLinearity = std::clamp(cheesyConfig.wheelNonLinearity, 0.01, 1.0) * pi / 2;
+  const double denominator = std::sin(nonLinearity);
+  wheel = std::sin(nonLinearity * wheel) / denominator;
+  wheel = std::sin(nonLinearity * wheel) / denominator;
+
+  double negInertiaScalar = cheesyConfig.negInertiaFarScalar;
+  if (wheel * negInertia > 0) {
+    negInertiaScalar = cheesyConfig.negInertiaTurnScalar;
+  } else if (std::abs(wheel) > cheesyConfig.negInertiaThreshold) {
+    negInertiaScalar = cheesyConfig.negInertiaCloseScalar;
+  }
+
+  // The accumulator spends the change of the turn stick over the next few calls
+  cheesyNegInertiaAccumulator += negInertia * negInertiaScalar;
+  wheel += cheesyNegInertiaAccumulator;
+  if (cheesyNegInertiaAccumulator > 1) {
+    cheesyNegInertiaAccumulator -= 1;
+  } else if (cheesyNegInertiaAccumulator < -1) {
+    cheesyNegInertiaAccumulator += 1;
+  } else {
+    cheesyNegInertiaAccumulator = 0;
+  }
+
+  double overPower = 0;
+  double angularPower = 0;
+  if (iquickTurn) {
+    if (std::abs(throttle) < cheesyConfig.quickStopDeadband) {
+      const double alpha = cheesyConfig.quickStopWeight;
+      const double quickStop = std::clamp(wheel, -1.0, 1.0) * cheesyConfig.quickStopScalar;
+      cheesyQuickStopAccumulator = (1 - alpha) * cheesyQuickStopAccumulator + alpha * quickStop;
+    }
+    overPower = 1;
+    angularPower = wheel;
+  } else {
+    angularPower =
+      std::abs(throttle) * wheel * cheesyConfig.sensitivity - cheesyQuickStopAccumulator;
+    if (cheesyQuickStopAccumulator > 1) {
+      cheesyQuickStopAccumulator -= 1;
+    } else if (cheesyQuickStopAccumulator < -1) {
+      cheesyQuickStopAccumulator += 1;
+    } else {
+      cheesyQuickStopAccumulator = 0;
+    }
+  }
+
+  double leftOutput = throttle + angularPower;
+  double rightOutput = throttle - angularPower;
+
+  // A quick turn keeps the difference between the sides by taking the excess off the other side
+  if (leftOutput > 1) {
+    rightOutput -= overPower * (leftOutput - 1);
+    leftOutput = 1;
+  } else if (rightOutput > 1) {
+    leftOutput -= overPower * (rightOutput - 1);
+    rightOutput = 1;
+  } else if (leftOutput < -1) {
+    rightOutput += overPower * (-1 - leftOutput);
+    leftOutput = -1;
+  } else if (rightOutput < -1) {
+    leftOutput += overPower * (-1 - rightOutput);
+    rightOutput = -1;
+  }
+
+  const double voltage = getCompensatedMaxVoltage();
+  leftSideMotor->moveVoltage(static_cast<int16_t>(std::clamp(leftOutput, -1.0, 1.0) * voltage));
+  rightSideMotor->moveVoltage(
+    static_cast<int16_t>(std::clamp(rightOutput, -1.0, 1.0) * voltage));
+}
+
+void SkidSteerModel::setCheesyDriveConfig(const CheesyDriveConfig &iconfig) {
+  cheesyConfig = iconfig;
+}
+
+SkidSteerModel::CheesyDriveConfig SkidSteerModel::getCheesyDriveConfig() const {
+  return cheesyConfig;
+}
+
+void SkidSteerModel::resetCheesyDrive() {
+  cheesyOldWheel = 0;
+  cheesyNegInertiaAccumulator = 0;
+  cheesyQuickStopAccumulator = 0;
 }
 
 void SkidSteerModel::left(const double ispeed) {
@@ -185,6 +293,19 @@ std::valarray<std::int32_t> SkidSteerModel::getSensorVals() const {
                                      static_cast<std::int32_t>(rightSensor->get())};
 }
 
+std::size_t SkidSteerModel::getSensorVals(SensorValues &ovalues) const {
+  ovalues[0] = static_cast<std::int32_t>(leftSensor->get());
+  ovalues[1] = static_cast<std::int32_t>(rightSensor->get());
+  return 2;
+}
+
+std::size_t SkidSteerModel::getSensorSamples(SensorValues &ovalues,
+                                             SensorTimestamps &otimestamps) const {
+  ovalues[0] = static_cast<std::int32_t>(leftSensor->getTimestamped(otimestamps[0]));
+  ovalues[1] = static_cast<std::int32_t>(rightSensor->getTimestamped(otimestamps[1]));
+  return 2;
+}
+
 void SkidSteerModel::resetSensors() {
   leftSensor->reset();
   rightSensor->reset();
@@ -232,4 +353,27 @@ std::shared_ptr<AbstractMotor> SkidSteerModel::getLeftSideMotor() const {
 std::shared_ptr<AbstractMotor> SkidSteerModel::getRightSideMotor() const {
   return rightSideMotor;
 }
+
+void SkidSteerModel::setVoltageCompensator(std::shared_ptr<VoltageCompensator> icompensator) {
+  voltageCompensator = std::move(icompensator);
+}
+
+std::shared_ptr<VoltageCompensator> SkidSteerModel::getVoltageCompensator() const {
+  return voltageCompensator;
+}
+
+double SkidSteerModel::getCompensatedMaxVoltage() const {
+  if (voltageCompensator == nullptr) {
+    return maxVoltage;
+  }
+
+  return voltageCompensator->compensate(maxVoltage);
+}
+
+void SkidSteerModel::applyCommands(const WheelCommands &icommands) {
+  writeWheelCommands<2>(icommands,
+                        {leftSideMotor.get(), rightSideMotor.get()},
+                        maxVelocity,
+                        getCompensatedMaxVoltage());
+}
 } // namespace okapi
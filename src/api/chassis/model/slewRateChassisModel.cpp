@@ -0,0 +1,268 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#include "okapi/api/chassis/model/slewRateChassisModel.hpp"
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+#include <string>
+#include <utility>
+
+namespace okapi {
+namespace {
+/**
+ * Mixes a forward speed and a yaw like SkidSteerModel::driveVector().
+ */
+std::pair<double, double> mixDriveVector(const double iforwardSpeed, const double iyaw) {
+  const double forwardSpeed = std::clamp(iforwardSpeed, -1.0, 1.0);
+  const double yaw = std::clamp(iyaw, -1.0, 1.0);
+
+  double leftOutput = forwardSpeed + yaw;
+  double rightOutput = forwardSpeed - yaw;
+  if (const double maxInputMag = std::max<double>(std::abs(leftOutput), std::abs(rightOutput));
+      maxInputMag > 1) {
+    leftOutput /= maxInputMag;
+    rightOutput /= maxInputMag;
+  }
+
+  return {leftOutput, rightOutput};
+}
+
+/**
+ * Mixes a forward speed and a yaw like SkidSteerModel::arcade().
+ */
+std::pair<double, double>
+mixArcade(const double iforwardSpeed, const double iyaw, const double ithreshold) {
+  double forwardSpeed = std::clamp(iforwardSpeed, -1.0, 1.0);
+  if (std::abs(forwardSpeed) <= ithreshold) {
+    forwardSpeed = 0;
+  }
+
+  double yaw = std::clamp(iyaw, -1.0, 1.0);
+  if (std::abs(yaw) <= ithreshold) {
+    yaw = 0;
+  }
+
+  const double maxInput =
+    std::copysign(std::max(std::abs(forwardSpeed), std::abs(yaw)), forwardSpeed);
+  if ((forwardSpeed >= 0) == (yaw >= 0)) {
+    return {maxInput, forwardSpeed - yaw};
+  }
+  return {forwardSpeed + yaw, maxInput};
+}
+} // namespace
+
+SlewRateChassisModel::SlewRateChassisModel(std::shared_ptr<ChassisModel> imodel,
+                                           const double iaccelStep,
+                                           const double idecelStep,
+                                           const std::shared_ptr<Logger> &ilogger)
+  : logger(ilogger), model(std::move(imodel)), accelStep(iaccelStep), decelStep(idecelStep) {
+  if (model == nullptr) {
+    std::string msg = "SlewRateChassisModel: The model cannot be null.";
+    LOG_ERROR(msg);
+    throw std::invalid_argument(msg);
+  }
+
+  if (!(accelStep > 0) || !(decelStep > 0)) {
+    std::string msg = "SlewRateChassisModel: The acceleration and deceleration steps must be "
+                      "greater than zero.";
+    LOG_ERROR(msg);
+    throw std::invalid_argument(msg);
+  }
+}
+
+SlewRateChassisModel::SlewRateChassisModel(std::shared_ptr<ChassisModel> imodel,
+                                           const double istep,
+                                           const std::shared_ptr<Logger> &ilogger)
+  : SlewRateChassisModel(std::move(imodel), istep, istep, ilogger) {
+}
+
+double SlewRateChassisModel::step(const double ioutput, const double itarget) const {
+  const bool speedingUp = itarget * ioutput >= 0 && std::abs(itarget) > std::abs(ioutput);
+  if (speedingUp) {
+    const double limit = accelStep.load(std::memory_order_relaxed);
+    return ioutput + std::clamp(itarget - ioutput, -limit, limit);
+  }
+
+  // A side which reverses stops at zero first, so the next tick speeds it up the other way
+  const double next = ioutput + std::clamp(itarget - ioutput, -decelStep, decelStep);
+  return next * ioutput < 0 ? 0 : next;
+}
+
+void SlewRateChassisModel::stepSides(const double ileftTarget, const double irightTarget) {
+  leftOutput = step(leftOutput, std::clamp(ileftTarget, -1.0, 1.0));
+  rightOutput = step(rightOutput, std::clamp(irightTarget, -1.0, 1.0));
+}
+
+void SlewRateChassisModel::forward(const double ispeed) {
+  stepSides(ispeed, ispeed);
+  model->left(leftOutput);
+  model->right(rightOutput);
+}
+
+void SlewRateChassisModel::driveVector(const double iforwardSpeed, const double iyaw) {
+  const auto [leftTarget, rightTarget] = mixDriveVector(iforwardSpeed, iyaw);
+  stepSides(leftTarget, rightTarget);
+  model->left(leftOutput);
+  model->right(rightOutput);
+}
+
+void SlewRateChassisModel::driveVectorVoltage(const double iforwardSpeed, const double iyaw) {
+  const auto [leftTarget, rightTarget] = mixDriveVector(iforwardSpeed, iyaw);
+  stepSides(leftTarget, rightTarget);
+  model->tank(leftOutput, rightOutput);
+}
+
+void SlewRateChassisModel::rotate(const double ispeed) {
+  stepSides(ispeed, -ispeed);
+  model->left(leftOutput);
+  model->right(rightOutput);
+}
+
+void SlewRateChassisModel::stop() {
+  leftOutput = 0;
+  rightOutput = 0;
+  wheelOutputs.fill(0);
+  model->stop();
+}
+
+void SlewRateChassisModel::tank(const double ileftSpeed,
+                                const double irightSpeed,
+                                const double ithreshold) {
+  const double leftTarget = std::abs(ileftSpeed) < ithreshold ? 0 : ileftSpeed;
+  const double rightTarget = std::abs(irightSpeed) < ithreshold ? 0 : irightSpeed;
+  stepSides(leftTarget, rightTarget);
+  model->tank(leftOutput, rightOutput);
+}
+
+void SlewRateChassisModel::arcade(const double iforwardSpeed,
+                                  const double iyaw,
+                                  const double ithreshold) {
+  const auto [leftTarget, rightTarget] = mixArcade(iforwardSpeed, iyaw, ithreshold);
+  stepSides(leftTarget, rightTarget);
+  model->tank(leftOutput, rightOutput);
+}
+
+void SlewRateChassisModel::curvature(const double iforwardSpeed,
+                                     const double icurvature,
+                                     const double ithreshold) {
+  double forwardSpeed = std::clamp(iforwardSpeed, -1.0, 1.0);
+  if (std::abs(forwardSpeed) < ithreshold) {
+    forwardSpeed = 0;
+  }
+
+  double curvature = std::clamp(icurvature, -1.0, 1.0);
+  if (std::abs(curvature) < ithreshold) {
+    curvature = 0;
+  }
+
+  // Like SkidSteerModel, switch to arcade for point turns
+  if (forwardSpeed == 0) {
+    arcade(forwardSpeed, curvature, ithreshold);
+    return;
+  }
+
+  double leftTarget = forwardSpeed + std::abs(forwardSpeed) * curvature;
+  double rightTarget = forwardSpeed - std::abs(forwardSpeed) * curvature;
+  if (const double maxSpeed = std::max(leftTarget, rightTarget); maxSpeed > 1.0) {
+    leftTarget /= maxSpeed;
+    rightTarget /= maxSpeed;
+  }
+
+  stepSides(leftTarget, rightTarget);
+  model->tank(leftOutput, rightOutput);
+}
+
+void SlewRateChassisModel::left(const double ispeed) {
+  leftOutput = step(leftOutput, std::clamp(ispeed, -1.0, 1.0));
+  model->left(leftOutput);
+}
+
+void SlewRateChassisModel::right(const double ispeed) {
+  rightOutput = step(rightOutput, std::clamp(ispeed, -1.0, 1.0));
+  model->right(rightOutput);
+}
+
+void SlewRateChassisModel::applyCommands(const WheelCommands &icommands) {
+  WheelCommands limited = icommands;
+  for (std::size_t i = 0; i < WheelCommands::maxWheels; i++) {
+    wheelOutputs[i] = step(wheelOutputs[i], std::clamp(icommands.outputs[i], -1.0, 1.0));
+    limited.outputs[i] = wheelOutputs[i];
+  }
+
+  model->applyCommands(limited);
+}
+
+std::valarray<std::int32_t> SlewRateChassisModel::getSensorVals() const {
+  return model->getSensorVals();
+}
+
+std::size_t SlewRateChassisModel::getSensorVals(SensorValues &ovalues) const {
+  return model->getSensorVals(ovalues);
+}
+
+std::size_t SlewRateChassisModel::getSensorSamples(SensorValues &ovalues,
+                                                   SensorTimestamps &otimestamps) const {
+  return model->getSensorSamples(ovalues, otimestamps);
+}
+
+void SlewRateChassisModel::resetSensors() {
+  model->resetSensors();
+}
+
+void SlewRateChassisModel::setBrakeMode(const AbstractMotor::brakeMode mode) {
+  model->setBrakeMode(mode);
+}
+
+void SlewRateChassisModel::setEncoderUnits(const AbstractMotor::encoderUnits units) {
+  model->setEncoderUnits(units);
+}
+
+void SlewRateChassisModel::setGearing(const AbstractMotor::gearset gearset) {
+  model->setGearing(gearset);
+}
+
+void SlewRateChassisModel::setMaxVelocity(const double imaxVelocity) {
+  model->setMaxVelocity(imaxVelocity);
+}
+
+double SlewRateChassisModel::getMaxVelocity() const {
+  return model->getMaxVelocity();
+}
+
+void SlewRateChassisModel::setMaxVoltage(const double imaxVoltage) {
+  model->setMaxVoltage(imaxVoltage);
+}
+
+double SlewRateChassisModel::getMaxVoltage() const {
+  return model->getMaxVoltage();
+}
+
+void SlewRateChassisModel::setVoltageCompensator(std::shared_ptr<VoltageCompensator> icompensator) {
+  model->setVoltageCompensator(std::move(icompensator));
+}
+
+std::shared_ptr<VoltageCompensator> SlewRateChassisModel::getVoltageCompensator() const {
+  return model->getVoltageCompensator();
+}
+
+void SlewRateChassisModel::setAccelStep(const double iaccelStep) {
+  if (!(iaccelStep > 0)) {
+    std::string msg = "SlewRateChassisModel: The acceleration step must be greater than zero.";
+    LOG_ERROR(msg);
+    throw std::invalid_argument(msg);
+  }
+
+  accelStep.store(iaccelStep, std::memory_order_relaxed);
+}
+
+double SlewRateChassisModel::getAccelStep() const {
+  return accelStep.load(std::memory_order_relaxed);
+}
+
+std::shared_ptr<ChassisModel> SlewRateChassisModel::getModel() const {
+  return model;
+}
+} // namespace okapi
@@ -4,6 +4,7 @@
  * file, You can obtain one at http://mozilla.org/MPL/2.0/.
  */
 #include "okapi/api/chassis/model/threeEncoderSkidSteerModel.hpp"
+#include <stdexcept>
 
 namespace okapi {
 ThreeEncoderSkidSteerModel::ThreeEncoderSkidSteerModel(
@@ -23,13 +24,58 @@ ThreeEncoderSkidSteerModel::ThreeEncoderSkidSteerModel(
     middleSensor(std::move(imiddleEnc)) {
 }
 
+void ThreeEncoderSkidSteerModel::setSensorGroup(std::shared_ptr<RotarySensorGroup> igroup) {
+  if (igroup && igroup->size() != 3) {
+    throw std::invalid_argument("ThreeEncoderSkidSteerModel: The sensor group must have the "
+                                "left, right, and middle sensors.");
+  }
+
+  sensorGroup = std::move(igroup);
+}
+
 std::valarray<std::int32_t> ThreeEncoderSkidSteerModel::getSensorVals() const {
+  if (sensorGroup) {
+    SensorValues values;
+    getSensorVals(values);
+    return std::valarray<std::int32_t>{values[0], values[1], values[2]};
+  }
+
   // Return the middle sensor last so this is compatible with SkidSteerModel::getSensorVals()
   return std::valarray<std::int32_t>{static_cast<std::int32_t>(leftSensor->get()),
                                      static_cast<std::int32_t>(rightSensor->get()),
                                      static_cast<std::int32_t>(middleSensor->get())};
 }
 
+std::size_t ThreeEncoderSkidSteerModel::getSensorVals(SensorValues &ovalues) const {
+  if (sensorGroup) {
+    SensorTimestamps timestamps;
+    return getSensorSamples(ovalues, timestamps);
+  }
+
+  // Return the middle sensor last so this is compatible with SkidSteerModel
+  ovalues[0] = static_cast<std::int32_t>(leftSensor->get());
+  ovalues[1] = static_cast<std::int32_t>(rightSensor->get());
+  ovalues[2] = static_cast<std::int32_t>(middleSensor->get());
+  return 3;
+}
+
+std::size_t ThreeEncoderSkidSteerModel::getSensorSamples(SensorValues &ovalues,
+                                                         SensorTimestamps &otimestamps) const {
+  if (sensorGroup) {
+    double values[3];
+    sensorGroup->read(values, otimestamps.data());
+    for (std::size_t i = 0; i < 3; i++) {
+      ovalues[i] = static_cast<std::int32_t>(values[i]);
+    }
+    return 3;
+  }
+
+  ovalues[0] = static_cast<std::int32_t>(leftSensor->getTimestamped(otimestamps[0]));
+  ovalues[1] = static_cast<std::int32_t>(rightSensor->getTimestamped(otimestamps[1]));
+  ovalues[2] = static_cast<std::int32_t>(middleSensor->getTimestamped(otimestamps[2]));
+  return 3;
+}
+
 void ThreeEncoderSkidSteerModel::resetSensors() {
   SkidSteerModel::resetSensors();
   middleSensor->reset();
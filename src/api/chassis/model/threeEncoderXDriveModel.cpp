@@ -33,6 +33,22 @@ std::valarray<std::int32_t> ThreeEncoderXDriveModel::getSensorVals() const {
                                      static_cast<std::int32_t>(middleSensor->get())};
 }
 
+std::size_t ThreeEncoderXDriveModel::getSensorVals(SensorValues &ovalues) const {
+  // Return the middle sensor last so this is compatible with XDriveModel
+  ovalues[0] = static_cast<std::int32_t>(leftSensor->get());
+  ovalues[1] = static_cast<std::int32_t>(rightSensor->get());
+  ovalues[2] = static_cast<std::int32_t>(middleSensor->get());
+  return 3;
+}
+
+std::size_t ThreeEncoderXDriveModel::getSensorSamples(SensorValues &ovalues,
+                                                      SensorTimestamps &otimestamps) const {
+  ovalues[0] = static_cast<std::int32_t>(leftSensor->getTimestamped(otimestamps[0]));
+  ovalues[1] = static_cast<std::int32_t>(rightSensor->getTimestamped(otimestamps[1]));
+  ovalues[2] = static_cast<std::int32_t>(middleSensor->getTimestamped(otimestamps[2]));
+  return 3;
+}
+
 void ThreeEncoderXDriveModel::resetSensors() {
   XDriveModel::resetSensors();
   middleSensor->reset();
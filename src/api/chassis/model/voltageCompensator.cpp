@@ -0,0 +1,83 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#include "okapi/api/chassis/model/voltageCompensator.hpp"
+#include "okapi/api/util/mathUtil.hpp"
+#include <algorithm>
+#include <cmath>
+#include <mutex>
+#include <stdexcept>
+
+namespace okapi {
+VoltageCompensator::VoltageCompensator(std::shared_ptr<ControllerInput<double>> ibattery,
+                                       std::unique_ptr<AbstractTimer> itimer,
+                                       const double inominalVoltage,
+                                       const double imaxScale,
+                                       const QTime &ireadPeriod,
+                                       const std::shared_ptr<Logger> &ilogger)
+  : logger(ilogger),
+    battery(std::move(ibattery)),
+    timer(std::move(itimer)),
+    nominalVoltage(inominalVoltage),
+    maxScale(imaxScale),
+    readPeriod(ireadPeriod),
+    batteryVoltage(inominalVoltage) {
+  if (battery == nullptr) {
+    std::string msg = "VoltageCompensator: The battery cannot be null.";
+    LOG_ERROR(msg);
+    throw std::invalid_argument(msg);
+  }
+
+  if (!(nominalVoltage > 0)) {
+    std::string msg = "VoltageCompensator: The nominal voltage must be greater than zero.";
+    LOG_ERROR(msg);
+    throw std::invalid_argument(msg);
+  }
+
+  if (!(maxScale >= 1)) {
+    std::string msg = "VoltageCompensator: The max scale must be at least 1.";
+    LOG_ERROR(msg);
+    throw std::invalid_argument(msg);
+  }
+}
+
+double VoltageCompensator::compensate(const double imaxVoltage) {
+  return std::min(imaxVoltage * getScale(), v5MotorMaxVoltage);
+}
+
+double VoltageCompensator::getScale() {
+  std::scoped_lock lock(mutex);
+  update();
+  return scale;
+}
+
+double VoltageCompensator::getBatteryVoltage() const {
+  std::scoped_lock lock(mutex);
+  return batteryVoltage;
+}
+
+double VoltageCompensator::getNominalVoltage() const {
+  return nominalVoltage;
+}
+
+void VoltageCompensator::update() {
+  timer->placeHardMark();
+  if (hasRead && timer->getDtFromHardMark() < readPeriod) {
+    return;
+  }
+
+  timer->clearHardMark();
+  hasRead = true;
+
+  const double reading = battery->controllerGet();
+  if (!std::isfinite(reading) || reading <= 0 || reading == OKAPI_PROS_ERR) {
+    LOG_WARN("VoltageCompensator: Ignoring a bad battery reading: " + std::to_string(reading));
+    return;
+  }
+
+  batteryVoltage = reading;
+  scale = std::min(nominalVoltage / batteryVoltage, maxScale);
+}
+} // namespace okapi
@@ -4,6 +4,7 @@
  * file, You can obtain one at http://mozilla.org/MPL/2.0/.
  */
 #include "okapi/api/chassis/model/xDriveModel.hpp"
+#include "okapi/api/util/fastTrig.hpp"
 #include "okapi/api/util/mathUtil.hpp"
 #include <utility>
 
@@ -68,10 +69,11 @@ void XDriveModel::driveVectorVoltage(const double iforwardSpeed, const double iy
     rightOutput /= maxInputMag;
   }
 
-  topLeftMotor->moveVoltage(static_cast<int16_t>(leftOutput * maxVoltage));
-  topRightMotor->moveVoltage(static_cast<int16_t>(rightOutput * maxVoltage));
-  bottomRightMotor->moveVoltage(static_cast<int16_t>(rightOutput * maxVoltage));
-  bottomLeftMotor->moveVoltage(static_cast<int16_t>(leftOutput * maxVoltage));
+  const double voltage = getCompensatedMaxVoltage();
+  topLeftMotor->moveVoltage(static_cast<int16_t>(leftOutput * voltage));
+  topRightMotor->moveVoltage(static_cast<int16_t>(rightOutput * voltage));
+  bottomRightMotor->moveVoltage(static_cast<int16_t>(rightOutput * voltage));
+  bottomLeftMotor->moveVoltage(static_cast<int16_t>(leftOutput * voltage));
 }
 
 void XDriveModel::rotate(const double ispeed) {
@@ -137,10 +139,11 @@ void XDriveModel::tank(const double ileftSpeed, const double irightSpeed, const
     rightSpeed = 0;
   }
 
-  topLeftMotor->moveVoltage(static_cast<int16_t>(leftSpeed * maxVoltage));
-  topRightMotor->moveVoltage(static_cast<int16_t>(rightSpeed * maxVoltage));
-  bottomRightMotor->moveVoltage(static_cast<int16_t>(rightSpeed * maxVoltage));
-  bottomLeftMotor->moveVoltage(static_cast<int16_t>(leftSpeed * maxVoltage));
+  const double voltage = getCompensatedMaxVoltage();
+  topLeftMotor->moveVoltage(static_cast<int16_t>(leftSpeed * voltage));
+  topRightMotor->moveVoltage(static_cast<int16_t>(rightSpeed * voltage));
+  bottomRightMotor->moveVoltage(static_cast<int16_t>(rightSpeed * voltage));
+  bottomLeftMotor->moveVoltage(static_cast<int16_t>(leftSpeed * voltage));
 }
 
 void XDriveModel::arcade(const double iforwardSpeed, const double iyaw, const double ithreshold) {
@@ -181,10 +184,11 @@ void XDriveModel::arcade(const double iforwardSpeed, const double iyaw, const do
   leftOutput = std::clamp(leftOutput, -1.0, 1.0);
   rightOutput = std::clamp(rightOutput, -1.0, 1.0);
 
-  topLeftMotor->moveVoltage(static_cast<int16_t>(leftOutput * maxVoltage));
-  topRightMotor->moveVoltage(static_cast<int16_t>(rightOutput * maxVoltage));
-  bottomRightMotor->moveVoltage(static_cast<int16_t>(rightOutput * maxVoltage));
-  bottomLeftMotor->moveVoltage(static_cast<int16_t>(leftOutput * maxVoltage));
+  const double voltage = getCompensatedMaxVoltage();
+  topLeftMotor->moveVoltage(static_cast<int16_t>(leftOutput * voltage));
+  topRightMotor->moveVoltage(static_cast<int16_t>(rightOutput * voltage));
+  bottomRightMotor->moveVoltage(static_cast<int16_t>(rightOutput * voltage));
+  bottomLeftMotor->moveVoltage(static_cast<int16_t>(leftOutput * voltage));
 }
 
 void XDriveModel::curvature(const double iforwardSpeed,
@@ -218,10 +222,11 @@ void XDriveModel::curvature(const double iforwardSpeed,
     rightSpeed /= maxSpeed;
   }
 
-  topLeftMotor->moveVoltage(static_cast<int16_t>(leftSpeed * maxVoltage));
-  topRightMotor->moveVoltage(static_cast<int16_t>(rightSpeed * maxVoltage));
-  bottomRightMotor->moveVoltage(static_cast<int16_t>(rightSpeed * maxVoltage));
-  bottomLeftMotor->moveVoltage(static_cast<int16_t>(leftSpeed * maxVoltage));
+  const double voltage = getCompensatedMaxVoltage();
+  topLeftMotor->moveVoltage(static_cast<int16_t>(leftSpeed * voltage));
+  topRightMotor->moveVoltage(static_cast<int16_t>(rightSpeed * voltage));
+  bottomRightMotor->moveVoltage(static_cast<int16_t>(rightSpeed * voltage));
+  bottomLeftMotor->moveVoltage(static_cast<int16_t>(leftSpeed * voltage));
 }
 
 void XDriveModel::xArcade(const double ixSpeed,
@@ -243,14 +248,15 @@ void XDriveModel::xArcade(const double ixSpeed,
     yaw = 0;
   }
 
+  const double voltage = getCompensatedMaxVoltage();
   topLeftMotor->moveVoltage(
-    static_cast<int16_t>(std::clamp(forwardSpeed + xSpeed + yaw, -1.0, 1.0) * maxVoltage));
+    static_cast<int16_t>(std::clamp(forwardSpeed + xSpeed + yaw, -1.0, 1.0) * voltage));
   topRightMotor->moveVoltage(
-    static_cast<int16_t>(std::clamp(forwardSpeed - xSpeed - yaw, -1.0, 1.0) * maxVoltage));
+    static_cast<int16_t>(std::clamp(forwardSpeed - xSpeed - yaw, -1.0, 1.0) * voltage));
   bottomRightMotor->moveVoltage(
-    static_cast<int16_t>(std::clamp(forwardSpeed + xSpeed - yaw, -1.0, 1.0) * maxVoltage));
+    static_cast<int16_t>(std::clamp(forwardSpeed + xSpeed - yaw, -1.0, 1.0) * voltage));
   bottomLeftMotor->moveVoltage(
-    static_cast<int16_t>(std::clamp(forwardSpeed - xSpeed + yaw, -1.0, 1.0) * maxVoltage));
+    static_cast<int16_t>(std::clamp(forwardSpeed - xSpeed + yaw, -1.0, 1.0) * voltage));
 }
 
 void XDriveModel::fieldOrientedXArcade(double ixSpeed,
@@ -258,6 +264,43 @@ void XDriveModel::fieldOrientedXArcade(double ixSpeed,
                                        double iyaw,
                                        QAngle iangle,
                                        double ithreshold) {
+  const double angle = iangle.convert(radian);
+  fieldOrientedXArcade(ixSpeed, iySpeed, iyaw, Trig::cos(angle), Trig::sin(angle), ithreshold);
+}
+
+void XDriveModel::fieldOrientedXArcade(const double ixSpeed,
+                                       const double iySpeed,
+                                       const double iyaw,
+                                       const double ithreshold) {
+  fieldOrientedXArcade(ixSpeed, iySpeed, iyaw, headingCos, headingSin, ithreshold);
+}
+
+void XDriveModel::setHeadingSensor(std::shared_ptr<ContinuousRotarySensor> isensor) {
+  headingSensor = std::move(isensor);
+}
+
+void XDriveModel::updateHeading() {
+  if (headingSensor) {
+    updateHeading(headingSensor->controllerGet() * degree);
+  }
+}
+
+void XDriveModel::updateHeading(const QAngle iheading) {
+  heading = iheading;
+  headingCos = Trig::cos(iheading.convert(radian));
+  headingSin = Trig::sin(iheading.convert(radian));
+}
+
+QAngle XDriveModel::getHeading() const {
+  return heading;
+}
+
+void XDriveModel::fieldOrientedXArcade(const double ixSpeed,
+                                       const double iySpeed,
+                                       const double iyaw,
+                                       const double iheadingCos,
+                                       const double iheadingSin,
+                                       const double ithreshold) {
   double xSpeed = std::clamp(ixSpeed, -1.0, 1.0);
   if (std::abs(xSpeed) < ithreshold) {
     xSpeed = 0;
@@ -273,17 +316,18 @@ void XDriveModel::fieldOrientedXArcade(double ixSpeed,
     yaw = 0;
   }
 
-  double fwd = xSpeed * cos(iangle).getValue() - ySpeed * sin(iangle).getValue();
-  double right = xSpeed * sin(iangle).getValue() + ySpeed * cos(iangle).getValue();
+  double fwd = xSpeed * iheadingCos - ySpeed * iheadingSin;
+  double right = xSpeed * iheadingSin + ySpeed * iheadingCos;
 
+  const double voltage = getCompensatedMaxVoltage();
   topLeftMotor->moveVoltage(
-    static_cast<int16_t>(std::clamp(fwd - right + yaw, -1.0, 1.0) * maxVoltage));
+    static_cast<int16_t>(std::clamp(fwd - right + yaw, -1.0, 1.0) * voltage));
   topRightMotor->moveVoltage(
-    static_cast<int16_t>(std::clamp(fwd + right - yaw, -1.0, 1.0) * maxVoltage));
+    static_cast<int16_t>(std::clamp(fwd + right - yaw, -1.0, 1.0) * voltage));
   bottomRightMotor->moveVoltage(
-    static_cast<int16_t>(std::clamp(fwd - right - yaw, -1.0, 1.0) * maxVoltage));
+    static_cast<int16_t>(std::clamp(fwd - right - yaw, -1.0, 1.0) * voltage));
   bottomLeftMotor->moveVoltage(
-    static_cast<int16_t>(std::clamp(fwd + right + yaw, -1.0, 1.0) * maxVoltage));
+    static_cast<int16_t>(std::clamp(fwd + right + yaw, -1.0, 1.0) * voltage));
 }
 
 void XDriveModel::left(const double ispeed) {
@@ -303,6 +347,19 @@ std::valarray<std::int32_t> XDriveModel::getSensorVals() const {
                                      static_cast<std::int32_t>(rightSensor->get())};
 }
 
+std::size_t XDriveModel::getSensorVals(SensorValues &ovalues) const {
+  ovalues[0] = static_cast<std::int32_t>(leftSensor->get());
+  ovalues[1] = static_cast<std::int32_t>(rightSensor->get());
+  return 2;
+}
+
+std::size_t XDriveModel::getSensorSamples(SensorValues &ovalues,
+                                          SensorTimestamps &otimestamps) const {
+  ovalues[0] = static_cast<std::int32_t>(leftSensor->getTimestamped(otimestamps[0]));
+  ovalues[1] = static_cast<std::int32_t>(rightSensor->getTimestamped(otimestamps[1]));
+  return 2;
+}
+
 void XDriveModel::resetSensors() {
   leftSensor->reset();
   rightSensor->reset();
@@ -364,4 +421,30 @@ std::shared_ptr<AbstractMotor> XDriveModel::getBottomRightMotor() const {
 std::shared_ptr<AbstractMotor> XDriveModel::getBottomLeftMotor() const {
   return bottomLeftMotor;
 }
+
+void XDriveModel::setVoltageCompensator(std::shared_ptr<VoltageCompensator> icompensator) {
+  voltageCompensator = std::move(icompensator);
+}
+
+std::shared_ptr<VoltageCompensator> XDriveModel::getVoltageCompensator() const {
+  return voltageCompensator;
+}
+
+double XDriveModel::getCompensatedMaxVoltage() const {
+  if (voltageCompensator == nullptr) {
+    return maxVoltage;
+  }
+
+  return voltageCompensator->compensate(maxVoltage);
+}
+
+void XDriveModel::applyCommands(const WheelCommands &icommands) {
+  writeWheelCommands<4>(icommands,
+                        {topLeftMotor.get(),
+                         topRightMotor.get(),
+                         bottomRightMotor.get(),
+                         bottomLeftMotor.get()},
+                        maxVelocity,
+                        getCompensatedMaxVoltage());
+}
 } // namespace okapi
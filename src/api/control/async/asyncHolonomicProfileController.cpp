@@ -0,0 +1,407 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#include "okapi/api/control/async/asyncHolonomicProfileController.hpp"
+#include "okapi/api/util/mathUtil.hpp"
+#include "okapi/api/util/taskProfiler.hpp"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <mutex>
+
+namespace okapi {
+AsyncHolonomicProfileController::AsyncHolonomicProfileController(
+  const TimeUtil &itimeUtil,
+  const PathfinderLimits &ilimits,
+  const std::shared_ptr<XDriveModel> &imodel,
+  const ChassisScales &iscales,
+  const AbstractMotor::GearsetRatioPair &ipair,
+  const std::shared_ptr<Logger> &ilogger)
+  : logger(ilogger),
+    limits(ilimits),
+    model(imodel),
+    scales(iscales),
+    pair(ipair),
+    timeUtil(itimeUtil),
+    pathRate(
+      std::make_unique<ProfiledRate>(timeUtil.getRate(), "AsyncHolonomicProfileController")) {
+  if (ipair.ratio == 0) {
+    std::string msg(
+      "AsyncHolonomicProfileController: The gear ratio cannot be zero! Check if you are "
+      "using integer division.");
+    LOG_ERROR(msg);
+    throw std::invalid_argument(msg);
+  }
+}
+
+AsyncHolonomicProfileController::~AsyncHolonomicProfileController() {
+  dtorCalled.store(true, std::memory_order_release);
+  wakeTask();
+
+  // A running path is kept alive by the task's own reference
+  currentPathMutex.lock();
+  paths.clear();
+  currentPathMutex.unlock();
+
+  delete task;
+}
+
+void AsyncHolonomicProfileController::generatePath(
+  std::initializer_list<PathfinderPoint> iwaypoints,
+  const std::string &ipathId) {
+  generatePath(iwaypoints, ipathId, limits);
+}
+
+void AsyncHolonomicProfileController::generatePath(
+  std::initializer_list<PathfinderPoint> iwaypoints,
+  const std::string &ipathId,
+  const PathfinderLimits &ilimits) {
+  if (iwaypoints.size() < 2) {
+    // The first waypoint is the start, so there is nowhere to go
+    LOG_WARN_S("AsyncHolonomicProfileController: Not generating a path because fewer than two "
+               "waypoints were given.");
+    return;
+  }
+
+  if (!(ilimits.maxVel > 0) || !(ilimits.maxAccel > 0)) {
+    std::string msg("AsyncHolonomicProfileController: The max velocity and max acceleration must "
+                    "be positive.");
+    LOG_ERROR(msg);
+    throw std::invalid_argument(msg);
+  }
+
+  LOG_INFO_S("AsyncHolonomicProfileController: Preparing trajectory");
+
+  // The distance from the center of the robot to each wheel
+  const double wheelRadius = scales.wheelTrack.convert(meter) / 2;
+
+  Path path;
+  path.reserve(iwaypoints.size() - 1);
+  for (auto it = std::next(iwaypoints.begin()); it != iwaypoints.end(); ++it) {
+    const PathfinderPoint &start = *std::prev(it);
+    const PathfinderPoint delta{it->x - start.x, it->y - start.y, it->theta - start.theta};
+
+    // A wheel moves at most as fast as the robot translates plus the speed it gets from the
+    // rotation, so profiling the sum of the two keeps every wheel within the limits
+    const double travel = std::hypot(delta.x.convert(meter), delta.y.convert(meter)) +
+                          std::abs(delta.theta.convert(radian)) * wheelRadius;
+    if (travel <= 0) {
+      continue;
+    }
+
+    path.push_back(
+      Segment{start,
+              delta,
+              TrapezoidProfile(travel,
+                               ilimits.maxVel,
+                               ilimits.maxAccel,
+                               std::numeric_limits<double>::infinity(),
+                               logger)});
+  }
+
+  const auto pathLength = path.size();
+
+  // A running path with the same ID keeps its own reference to the old path
+  currentPathMutex.lock();
+  paths.insert_or_assign(ipathId, std::make_shared<const Path>(std::move(path)));
+  currentPathMutex.unlock();
+
+  LOG_INFO("AsyncHolonomicProfileController: Completely done generating path " + ipathId);
+  LOG_DEBUG("AsyncHolonomicProfileController: Path length: " + std::to_string(pathLength));
+}
+
+bool AsyncHolonomicProfileController::removePath(const std::string &ipathId) {
+  std::scoped_lock lock(currentPathMutex);
+
+  // If this path is running, the controller task still holds a reference to it, so it will be
+  // freed once it is done
+  paths.erase(ipathId);
+  return true;
+}
+
+std::vector<std::string> AsyncHolonomicProfileController::getPaths() {
+  std::vector<std::string> keys;
+
+  std::scoped_lock lock(currentPathMutex);
+
+  for (const auto &path : paths) {
+    keys.push_back(path.first);
+  }
+
+  return keys;
+}
+
+void AsyncHolonomicProfileController::setTarget(std::string ipathId) {
+  LOG_INFO("AsyncHolonomicProfileController: Set target to: " + ipathId);
+
+  currentPathMutex.lock();
+  currentPath = ipathId;
+  currentPathMutex.unlock();
+
+  isRunning.store(true, std::memory_order_release);
+  wakeTask();
+}
+
+void AsyncHolonomicProfileController::controllerSet(const std::string ivalue) {
+  setTarget(ivalue);
+}
+
+std::string AsyncHolonomicProfileController::getTarget() {
+  std::scoped_lock lock(currentPathMutex);
+  return currentPath;
+}
+
+std::string AsyncHolonomicProfileController::getProcessValue() const {
+  std::scoped_lock lock(currentPathMutex);
+  return currentPath;
+}
+
+void AsyncHolonomicProfileController::loop() {
+  LOG_INFO_S("Started AsyncHolonomicProfileController task.");
+
+  while (!dtorCalled.load(std::memory_order_acquire)) {
+    if (isRunning.load(std::memory_order_acquire) && !isDisabled()) {
+      currentPathMutex.lock();
+      const std::string pathId = currentPath;
+      currentPathMutex.unlock();
+
+      if (executePath(pathId)) {
+        model->stop();
+        LOG_INFO_S("AsyncHolonomicProfileController: Done moving");
+      }
+
+      isRunning.store(false, std::memory_order_release);
+      settledEvent.notifyAll();
+    }
+
+    // Sleep until setTarget() wakes this task. Any other notification means the task which made
+    // this controller was deleted, so stop.
+    if (CrossplatformThread::notifyTake(idleLoopTimeout) & ~CrossplatformThread::wakeNotification) {
+      break;
+    }
+  }
+
+  LOG_INFO_S("Stopped AsyncHolonomicProfileController task.");
+}
+
+bool AsyncHolonomicProfileController::executePath(const std::string &ipathId) {
+  LOG_INFO_F("AsyncHolonomicProfileController: Running with path: %s", ipathId);
+
+  // Take our own reference to the path so it stays valid even if it is removed or replaced
+  // while we follow it
+  std::shared_ptr<const Path> path;
+  currentPathMutex.lock();
+  if (auto it = paths.find(ipathId); it != paths.end()) {
+    path = it->second;
+  }
+  plannedPose = {0_m, 0_m, 0_deg};
+  currentPathMutex.unlock();
+
+  if (!path) {
+    LOG_WARN("AsyncHolonomicProfileController: Target was set to non-existent path with name: " +
+             ipathId);
+    return false;
+  }
+
+  executeSinglePath(*path, *pathRate);
+  pathRate->reset();
+  return true;
+}
+
+void AsyncHolonomicProfileController::executeSinglePath(const Path &path,
+                                                        AbstractRate &rate) {
+  // The caller holds a reference to the path for as long as this runs, so there is nothing to lock
+  for (const auto &segment : path) {
+    const QTime duration = segment.profile.getDuration();
+    const double travel = segment.profile.sample(duration).position;
+
+    for (QTime time = 0_ms; time < duration && !isDisabled(); time += profilePeriod) {
+      const auto state = segment.profile.sample(time);
+      const double progress = state.position / travel;
+      const double progressRate = state.velocity / travel; // per second
+
+      const QAngle heading = segment.start.theta + segment.delta.theta * progress;
+      currentPathMutex.lock();
+      plannedPose = {segment.start.x + segment.delta.x * progress,
+                     segment.start.y + segment.delta.y * progress,
+                     heading};
+      currentPathMutex.unlock();
+
+      // The path is in the frame of its start, so turn the velocity into the frame of the robot
+      const QSpeed vx = segment.delta.x * progressRate / second;
+      const QSpeed vy = segment.delta.y * progressRate / second;
+      const double cosHeading = std::cos(heading.convert(radian));
+      const double sinHeading = std::sin(heading.convert(radian));
+      writeVelocity({vx * cosHeading + vy * sinHeading,
+                     vy * cosHeading - vx * sinHeading,
+                     segment.delta.theta * progressRate / second});
+
+      rate.delayUntil(profilePeriod);
+    }
+
+    if (isDisabled()) {
+      return;
+    }
+
+    // Stop at the waypoint before the next segment
+    model->stop();
+  }
+
+  if (!path.empty()) {
+    const Segment &last = path.back();
+    currentPathMutex.lock();
+    plannedPose = {last.start.x + last.delta.x,
+                   last.start.y + last.delta.y,
+                   last.start.theta + last.delta.theta};
+    currentPathMutex.unlock();
+  }
+}
+
+std::array<QSpeed, 4>
+AsyncHolonomicProfileController::toWheelVelocities(const ChassisVelocity &ivelocity,
+                                                   const ChassisScales &iscales) {
+  // Each wheel points 45 degrees from forward and is half the wheel track from the center. Spinning
+  // clockwise drives the left wheels forward and the right wheels backward.
+  const QSpeed diagonalA = (ivelocity.forward + ivelocity.right) / std::sqrt(2.0);
+  const QSpeed diagonalB = (ivelocity.forward - ivelocity.right) / std::sqrt(2.0);
+  const QSpeed spin = ivelocity.yaw.convert(radps) * (iscales.wheelTrack / 2) / second;
+  return {diagonalA + spin, diagonalB - spin, diagonalA - spin, diagonalB + spin};
+}
+
+void AsyncHolonomicProfileController::writeVelocity(const ChassisVelocity &ivelocity) {
+  const double maxVelocity = model->getMaxVelocity();
+  if (maxVelocity <= 0) {
+    return;
+  }
+
+  const auto wheelVelocities = toWheelVelocities(ivelocity, scales);
+
+  WheelCommands commands;
+  commands.mode = WheelCommands::outputMode::velocity;
+  double largest = 1;
+  const double outputPerMps = scales.getMotorRpmPerMps(pair) / maxVelocity;
+  for (std::size_t i = 0; i < wheelVelocities.size(); i++) {
+    commands.outputs[i] = wheelVelocities[i].convert(mps) * outputPerMps;
+    largest = std::max(largest, std::abs(commands.outputs[i]));
+  }
+
+  // Scale every wheel together so the robot keeps its direction
+  for (auto &output : commands.outputs) {
+    output /= largest;
+  }
+
+  model->applyCommands(commands);
+}
+
+void AsyncHolonomicProfileController::wakeTask() {
+  if (task) {
+    task->notify();
+  }
+}
+
+void AsyncHolonomicProfileController::trampoline(void *context) {
+  if (context) {
+    static_cast<AsyncHolonomicProfileController *>(context)->loop();
+  }
+}
+
+void AsyncHolonomicProfileController::waitUntilSettled() {
+  LOG_INFO_S("AsyncHolonomicProfileController: Waiting to settle");
+
+  // The controller task notifies settledEvent when it settles. The timeout is only a fallback.
+  auto generation = settledEvent.getGeneration();
+  while (!isSettled()) {
+    settledEvent.waitFor(generation, settledWaitTimeout);
+    generation = settledEvent.getGeneration();
+  }
+
+  LOG_INFO_S("AsyncHolonomicProfileController: Done waiting to settle");
+}
+
+void AsyncHolonomicProfileController::moveTo(std::initializer_list<PathfinderPoint> iwaypoints) {
+  moveTo(iwaypoints, limits);
+}
+
+void AsyncHolonomicProfileController::moveTo(std::initializer_list<PathfinderPoint> iwaypoints,
+                                             const PathfinderLimits &ilimits) {
+  static int moveToCount = 0;
+  std::string name = "__moveTo" + std::to_string(moveToCount++);
+  generatePath(iwaypoints, name, ilimits);
+  setTarget(name);
+  waitUntilSettled();
+  removePath(name);
+}
+
+PathfinderPoint AsyncHolonomicProfileController::getError() const {
+  std::scoped_lock lock(currentPathMutex);
+  if (!isRunning.load(std::memory_order_acquire)) {
+    return {0_m, 0_m, 0_deg};
+  }
+
+  const auto it = paths.find(currentPath);
+  if (it == paths.end() || it->second->empty()) {
+    return {0_m, 0_m, 0_deg};
+  }
+
+  // The end of the last segment is the target pose
+  const Segment &last = it->second->back();
+  return {last.start.x + last.delta.x - plannedPose.x,
+          last.start.y + last.delta.y - plannedPose.y,
+          last.start.theta + last.delta.theta - plannedPose.theta};
+}
+
+bool AsyncHolonomicProfileController::isSettled() {
+  return isDisabled() || !isRunning.load(std::memory_order_acquire);
+}
+
+void AsyncHolonomicProfileController::reset() {
+  // Interrupt executeSinglePath() by disabling the controller
+  flipDisable(true);
+
+  LOG_INFO_S("AsyncHolonomicProfileController: Waiting to reset");
+
+  auto generation = settledEvent.getGeneration();
+  while (isRunning.load(std::memory_order_acquire)) {
+    settledEvent.waitFor(generation, settledWaitTimeout);
+    generation = settledEvent.getGeneration();
+  }
+
+  flipDisable(false);
+}
+
+void AsyncHolonomicProfileController::flipDisable() {
+  flipDisable(!disabled.load(std::memory_order_acquire));
+}
+
+void AsyncHolonomicProfileController::flipDisable(const bool iisDisabled) {
+  LOG_INFO("AsyncHolonomicProfileController: flipDisable " + std::to_string(iisDisabled));
+  disabled.store(iisDisabled, std::memory_order_release);
+  // Disabling the controller settles it, and loop() stops the robot once the path is interrupted
+  settledEvent.notifyAll();
+  wakeTask();
+}
+
+bool AsyncHolonomicProfileController::isDisabled() const {
+  return disabled.load(std::memory_order_acquire);
+}
+
+void AsyncHolonomicProfileController::startThread(const std::uint32_t ipriority,
+                                                  const std::uint16_t istackDepth) {
+  if (!task) {
+    task = new CrossplatformThread(
+      trampoline, this, "AsyncHolonomicProfileController", ipriority, istackDepth);
+  }
+}
+
+CrossplatformThread *AsyncHolonomicProfileController::getThread() const {
+  return task;
+}
+
+void AsyncHolonomicProfileController::tarePosition() {
+}
+
+void AsyncHolonomicProfileController::setMaxVelocity(std::int32_t) {
+}
+} // namespace okapi
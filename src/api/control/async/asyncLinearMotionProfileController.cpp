@@ -4,7 +4,11 @@
  * file, You can obtain one at http://mozilla.org/MPL/2.0/.
  */
 #include "okapi/api/control/async/asyncLinearMotionProfileController.hpp"
+#include "okapi/api/util/flightRecorder.hpp"
 #include "okapi/api/util/mathUtil.hpp"
+#include "okapi/api/util/taskProfiler.hpp"
+#include <algorithm>
+#include <cmath>
 #include <mutex>
 #include <numeric>
 
@@ -21,7 +25,9 @@ AsyncLinearMotionProfileController::AsyncLinearMotionProfileController(
     output(ioutput),
     diameter(idiameter),
     pair(ipair),
-    timeUtil(itimeUtil) {
+    timeUtil(itimeUtil),
+    pathRate(
+      std::make_unique<ProfiledRate>(timeUtil.getRate(), "AsyncLinearMotionProfileController")) {
   if (ipair.ratio == 0) {
     std::string msg(
       "AsyncLinearMotionProfileController: The gear ratio cannot be zero! Check if you are "
@@ -29,14 +35,21 @@ AsyncLinearMotionProfileController::AsyncLinearMotionProfileController(
     LOG_ERROR(msg);
     throw std::invalid_argument(msg);
   }
+
+  motorCommandPerMps =
+    convertLinearToRotational(1_mps).convert(rpm) / toUnderlyingType(pair.internalGearset);
+  motorDegreesPerMeter = convertLinearToRotational(1_mps).convert(degree / second);
 }
 
 AsyncLinearMotionProfileController::~AsyncLinearMotionProfileController() {
   dtorCalled.store(true, std::memory_order_release);
+  wakeTask();
 
-  // Free paths before deleting the task
-  std::scoped_lock lock(currentPathMutex);
+  // Free paths before deleting the task. A running path is kept alive by the task's own reference,
+  // so the lock does not need to be held while the task stops.
+  currentPathMutex.lock();
   paths.clear();
+  currentPathMutex.unlock();
 
   delete task;
 }
@@ -49,6 +62,14 @@ void AsyncLinearMotionProfileController::generatePath(std::initializer_list<QLen
 void AsyncLinearMotionProfileController::generatePath(std::initializer_list<QLength> iwaypoints,
                                                       const std::string &ipathId,
                                                       const PathfinderLimits &ilimits) {
+  generatePath(iwaypoints, ipathId, ilimits, 0_mps, 0_mps);
+}
+
+void AsyncLinearMotionProfileController::generatePath(std::initializer_list<QLength> iwaypoints,
+                                                      const std::string &ipathId,
+                                                      const PathfinderLimits &ilimits,
+                                                      const QSpeed istartVelocity,
+                                                      const QSpeed iendVelocity) {
   if (iwaypoints.size() == 0) {
     // No point in generating a path
     LOG_WARN_S("AsyncLinearMotionProfileController: Not generating a path because no "
@@ -56,26 +77,46 @@ void AsyncLinearMotionProfileController::generatePath(std::initializer_list<QLen
     return;
   }
 
-  std::vector<squiggles::Pose> points;
+  const double startVel = istartVelocity.convert(mps);
+  const double endVel = iendVelocity.convert(mps);
+  if (startVel < 0 || startVel > ilimits.maxVel || endVel < 0 || endVel > ilimits.maxVel) {
+    std::string msg("AsyncLinearMotionProfileController: The start and end velocities must be "
+                    "between zero and the maximum velocity.");
+    LOG_ERROR(msg);
+    throw std::invalid_argument(msg);
+  }
+
+  std::vector<squiggles::ControlVector> points;
   points.reserve(iwaypoints.size());
   for (auto &point : iwaypoints) {
-    points.push_back(squiggles::Pose{point.convert(meter), 0, 0});
+    points.emplace_back(squiggles::Pose{point.convert(meter), 0, 0});
+  }
+
+  if (startVel > 0) {
+    points.front().vel = startVel;
+  }
+
+  if (endVel > 0) {
+    points.back().vel = endVel;
   }
 
   LOG_INFO_S("AsyncLinearMotionProfileController: Preparing trajectory");
 
   auto constraints = squiggles::Constraints(ilimits.maxVel, ilimits.maxAccel, ilimits.maxJerk);
   auto splineGenerator =
-    squiggles::SplineGenerator(constraints, std::make_shared<squiggles::PassthroughModel>(), 0.01);
+    squiggles::SplineGenerator(constraints, std::make_shared<squiggles::PassthroughModel>(), DT);
   auto path = splineGenerator.generate(points);
+  const auto pathLength = path.size();
 
-  // Free the old path before overwriting it
-  forceRemovePath(ipathId);
+  auto stored = pathPool->store(std::move(path));
 
-  paths.emplace(ipathId, path);
+  // A running path with the same ID keeps its own reference to the old path
+  currentPathMutex.lock();
+  paths.insert_or_assign(ipathId, std::move(stored));
+  currentPathMutex.unlock();
 
   LOG_INFO("AsyncLinearMotionProfileController: Completely done generating path " + ipathId);
-  LOG_DEBUG("AsyncLinearMotionProfileController: Path length: " + std::to_string(path.size()));
+  LOG_DEBUG("AsyncLinearMotionProfileController: Path length: " + std::to_string(pathLength));
 }
 
 std::string
@@ -98,18 +139,11 @@ AsyncLinearMotionProfileController::getPathErrorMessage(const std::vector<Pathfi
 }
 
 bool AsyncLinearMotionProfileController::removePath(const std::string &ipathId) {
-  if (!isDisabled() && isRunning.load(std::memory_order_acquire) && getTarget() == ipathId) {
-    LOG_WARN("AsyncLinearMotionProfileController: Attempted to remove currently running path " +
-             ipathId);
-    return false;
-  }
-
   std::scoped_lock lock(currentPathMutex);
 
-  auto oldPath = paths.find(ipathId);
-  if (oldPath != paths.end()) {
-    paths.erase(ipathId);
-  }
+  // If this path is running, the controller task still holds a reference to it, so it will be
+  // freed once it is done
+  paths.erase(ipathId);
 
   /*
    * A return value of true provides no feedback about whether the
@@ -122,6 +156,8 @@ bool AsyncLinearMotionProfileController::removePath(const std::string &ipathId)
 std::vector<std::string> AsyncLinearMotionProfileController::getPaths() {
   std::vector<std::string> keys;
 
+  std::scoped_lock lock(currentPathMutex);
+
   for (const auto &path : paths) {
     keys.push_back(path.first);
   }
@@ -129,17 +165,82 @@ std::vector<std::string> AsyncLinearMotionProfileController::getPaths() {
   return keys;
 }
 
+std::shared_ptr<PathPool> AsyncLinearMotionProfileController::getPathPool() const {
+  return pathPool;
+}
+
 void AsyncLinearMotionProfileController::setTarget(std::string ipathId) {
   setTarget(ipathId, false);
 }
 
-void AsyncLinearMotionProfileController::setTarget(std::string ipathId, const bool ibackwards) {
+void AsyncLinearMotionProfileController::setTarget(std::string ipathId,
+                                                   const bool ibackwards,
+                                                   const double ispeedScale) {
   LOG_INFO("AsyncLinearMotionProfileController: Set target to: " + ipathId + " (ibackwards" +
-           std::to_string(ibackwards) + ")");
+           std::to_string(ibackwards) + ", ispeedScale=" + std::to_string(ispeedScale) + ")");
+
+  if (!(ispeedScale > 0)) {
+    std::string msg("AsyncLinearMotionProfileController: The speed scale must be positive.");
+    LOG_ERROR(msg);
+    throw std::invalid_argument(msg);
+  }
+
+  currentPathMutex.lock();
+  queuedPaths.clear();
+  currentPathMutex.unlock();
 
   currentPath = ipathId;
   direction.store(boolToSign(!ibackwards), std::memory_order_release);
+  speedScale.store(ispeedScale, std::memory_order_release);
   isRunning.store(true, std::memory_order_release);
+  FlightRecorder::recordDefault(FlightEventType::targetChanged,
+                                "AsyncLinearMotionProfileController");
+  wakeTask();
+}
+
+void AsyncLinearMotionProfileController::setTargetSequence(
+  const std::vector<std::string> &ipathIds,
+  const bool ibackwards,
+  const double ispeedScale) {
+  if (!(ispeedScale > 0)) {
+    std::string msg("AsyncLinearMotionProfileController: The speed scale must be positive.");
+    LOG_ERROR(msg);
+    throw std::invalid_argument(msg);
+  }
+
+  if (ipathIds.empty()) {
+    LOG_WARN_S("AsyncLinearMotionProfileController: Not setting a target because the sequence is "
+               "empty.");
+    return;
+  }
+
+  LOG_INFO("AsyncLinearMotionProfileController: Set target sequence starting with: " +
+           ipathIds.front() + " (length " + std::to_string(ipathIds.size()) +
+           ", ibackwards=" + std::to_string(ibackwards) +
+           ", ispeedScale=" + std::to_string(ispeedScale) + ")");
+
+  currentPathMutex.lock();
+  for (std::size_t i = 0; i + 1 < ipathIds.size(); ++i) {
+    const auto current = paths.find(ipathIds[i]);
+    const auto next = paths.find(ipathIds[i + 1]);
+    if (current != paths.end() && next != paths.end() && !current->second->empty() &&
+        !next->second->empty() &&
+        std::abs(current->second->back().vector.vel - next->second->front().vector.vel) > 0.05) {
+      LOG_WARN("AsyncLinearMotionProfileController: The end velocity of path " + ipathIds[i] +
+               " does not match the start velocity of path " + ipathIds[i + 1]);
+    }
+  }
+
+  queuedPaths.assign(std::next(ipathIds.begin()), ipathIds.end());
+  currentPathMutex.unlock();
+
+  currentPath = ipathIds.front();
+  direction.store(boolToSign(!ibackwards), std::memory_order_release);
+  speedScale.store(ispeedScale, std::memory_order_release);
+  isRunning.store(true, std::memory_order_release);
+  FlightRecorder::recordDefault(FlightEventType::targetChanged,
+                                "AsyncLinearMotionProfileController");
+  wakeTask();
 }
 
 void AsyncLinearMotionProfileController::controllerSet(const std::string ivalue) {
@@ -161,65 +262,166 @@ std::string AsyncLinearMotionProfileController::getProcessValue() const {
 void AsyncLinearMotionProfileController::loop() {
   LOG_INFO_S("Started AsyncLinearMotionProfileController task.");
 
-  auto rate = timeUtil.getRate();
-
-  while (!dtorCalled.load(std::memory_order_acquire) && !task->notifyTake(0)) {
+  while (!dtorCalled.load(std::memory_order_acquire)) {
     if (isRunning.load(std::memory_order_acquire) && !isDisabled()) {
-      LOG_INFO("AsyncLinearMotionProfileController: Running with path: " + currentPath);
-
-      auto path = paths.find(currentPath);
-
-      if (path == paths.end()) {
-        LOG_WARN(
-          "AsyncLinearMotionProfileController: Target was set to non-existent path with name: " +
-          currentPath);
-      } else {
-        LOG_DEBUG("AsyncLinearMotionProfileController: Path length is " +
-                  std::to_string(path->second.size()));
+      feedbackMutex.lock();
+      activeTrackingRecorder = trackingRecorder;
+      feedbackMutex.unlock();
+      if (activeTrackingRecorder) {
+        activeTrackingRecorder->beginPath(currentPath);
+      }
 
-        executeSinglePath(path->second, timeUtil.getRate());
+      bool followedPath = false;
+      do {
+        followedPath = executePath(currentPath) || followedPath;
+      } while (advanceToQueuedPath());
 
-        // Set 0 after the path because:
-        // 1. We only support an exit velocity of zero
+      if (followedPath) {
+        // Set 0 after the last path because:
+        // 1. Only the paths inside a sequence can have a non-zero exit velocity
         // 2. Because of (1), we should make sure the system is stopped
         output->controllerSet(0);
 
         LOG_INFO_S("AsyncLinearMotionProfileController: Done moving");
       }
 
+      // Write the samples once the output is stopped so writing them can not delay a command
+      if (activeTrackingRecorder) {
+        activeTrackingRecorder->endPath();
+        activeTrackingRecorder = nullptr;
+      }
+
+      FlightRecorder::recordDefault(
+        FlightEventType::settled, "AsyncLinearMotionProfileController", followedPath);
       isRunning.store(false, std::memory_order_release);
+      settledEvent.notifyAll();
     }
 
-    rate->delayUntil(10_ms);
+    // Sleep until setTarget() wakes this task. Any other notification means the task which made
+    // this controller was deleted, so stop.
+    if (CrossplatformThread::notifyTake(idleLoopTimeout) & ~CrossplatformThread::wakeNotification) {
+      break;
+    }
   }
 
   LOG_INFO_S("Stopped AsyncLinearMotionProfileController task.");
 }
 
+bool AsyncLinearMotionProfileController::executePath(const std::string &ipathId) {
+  LOG_INFO_F("AsyncLinearMotionProfileController: Running with path: %s", ipathId);
+
+  // Take our own reference to the path so it stays valid even if it is removed or replaced
+  // while we follow it
+  std::shared_ptr<const std::vector<squiggles::ProfilePoint>> path;
+  currentPathMutex.lock();
+  if (auto it = paths.find(ipathId); it != paths.end()) {
+    path = it->second;
+  }
+  currentPathMutex.unlock();
+
+  if (!path) {
+    LOG_WARN("AsyncLinearMotionProfileController: Target was set to non-existent path with name: " +
+             ipathId);
+    return false;
+  }
+
+  LOG_DEBUG_F("AsyncLinearMotionProfileController: Path length is %zu", path->size());
+
+  executeSinglePath(*path, *pathRate);
+  pathRate->reset();
+  return true;
+}
+
+bool AsyncLinearMotionProfileController::advanceToQueuedPath() {
+  std::scoped_lock lock(currentPathMutex);
+
+  if (isDisabled()) {
+    // Disabling the controller cancels the rest of the sequence
+    queuedPaths.clear();
+  }
+
+  if (queuedPaths.empty()) {
+    return false;
+  }
+
+  currentPath = queuedPaths.front();
+  queuedPaths.pop_front();
+  return true;
+}
+
 void AsyncLinearMotionProfileController::executeSinglePath(
   const std::vector<squiggles::ProfilePoint> &path,
-  std::unique_ptr<AbstractRate> rate) {
+  AbstractRate &rate) {
   const auto reversed = direction.load(std::memory_order_acquire);
+  const double scale = speedScale.load(std::memory_order_acquire);
+  // Scaling the speed stretches the time between points
+  const QTime segDT = DT / scale * second;
+
+  feedbackMutex.lock();
+  const auto input = feedbackInput;
+  const auto controller = feedbackController;
+  const auto ff = feedforward;
+  const auto settleTimeout = feedbackSettleTimeout;
+  feedbackMutex.unlock();
+
+  const auto record = [&](const double ivelocity) {
+    if (activeTrackingRecorder) {
+      const double commanded = convertLinearToRotational(ivelocity * mps).convert(rpm);
+      activeTrackingRecorder->record(commanded, commanded);
+    }
+  };
 
-  std::scoped_lock pathLock(currentPathMutex);
-  // store this locally so we aren't accessing the path when we don't know if it's valid
-  std::size_t pathSize = path.size();
-  currentPathMutex.unlock();
-  for (std::size_t i = 0; i < pathSize && !isDisabled(); ++i) {
-    // This mutex is used to combat an edge case of an edge case
-    // if a running path is asked to be removed at the moment this loop is executing
-    std::scoped_lock lock(currentPathMutex);
+  // The caller holds a reference to the path for as long as this runs, so there is nothing to lock
+  if (!input || !controller) {
+    for (std::size_t i = 0; i < path.size() && !isDisabled(); ++i) {
+      const double vel = path[i].vector.vel * scale * reversed;
+      currentProfilePosition.store(path[i].vector.pose.x, std::memory_order_release);
+      record(vel);
+      output->controllerSet(vel * motorCommandPerMps);
+      rate.delayUntil(segDT);
+    }
+    return;
+  }
 
-    const auto segDT = path[i].time * millisecond;
-    currentProfilePosition = path[i].vector.pose.x;
+  if (path.empty()) {
+    return;
+  }
+
+  // Positions are relative to where the path and the input start, in the degrees of the input
+  const double startPosition = path.front().vector.pose.x;
+  const double startReading = input->controllerGet();
+  controller->reset();
+  controller->flipDisable(false);
+
+  const auto step = [&](const double idesired, const double ivelocity, const double ifeedforward) {
+    record(ivelocity);
+    const double reading = input->controllerGet() - startReading;
+    currentProfilePosition.store(startPosition + reading / motorDegreesPerMeter * reversed,
+                                 std::memory_order_release);
+    controller->setTarget(idesired);
+    output->controllerSet(std::clamp(ifeedforward + controller->step(reading), -1.0, 1.0));
+    rate.delayUntil(segDT);
+  };
 
-    const auto motorRPM = convertLinearToRotational(path[i].vector.vel * mps).convert(rpm);
-    output->controllerSet(motorRPM / toUnderlyingType(pair.internalGearset) * reversed);
+  for (std::size_t i = 0; i < path.size() && !isDisabled(); ++i) {
+    const auto &point = path[i];
+    const double vel = point.vector.vel * scale * reversed;
+    const double accel = point.vector.accel * scale * scale * reversed;
+    step((point.vector.pose.x - startPosition) * motorDegreesPerMeter * reversed,
+         vel,
+         ff.isEnabled() ? ff.calculate(vel, accel) : vel * motorCommandPerMps);
+  }
 
-    // Unlock before the delay to be nice to other tasks
-    currentPathMutex.unlock();
+  // Paths in a sequence which end moving flow into the next one instead of stopping to settle
+  if (path.back().vector.vel != 0) {
+    return;
+  }
 
-    rate->delayUntil(segDT);
+  const double target =
+    (path.back().vector.pose.x - startPosition) * motorDegreesPerMeter * reversed;
+  const auto settleSteps = static_cast<std::size_t>((settleTimeout / segDT).getValue());
+  for (std::size_t i = 0; i < settleSteps && !isDisabled() && !controller->isSettled(); ++i) {
+    step(target, 0, 0);
   }
 }
 
@@ -227,6 +429,12 @@ QAngularSpeed AsyncLinearMotionProfileController::convertLinearToRotational(QSpe
   return (linear * (360_deg / (diameter * 1_pi))) * pair.ratio;
 }
 
+void AsyncLinearMotionProfileController::wakeTask() {
+  if (task) {
+    task->notify();
+  }
+}
+
 void AsyncLinearMotionProfileController::trampoline(void *context) {
   if (context) {
     static_cast<AsyncLinearMotionProfileController *>(context)->loop();
@@ -236,9 +444,11 @@ void AsyncLinearMotionProfileController::trampoline(void *context) {
 void AsyncLinearMotionProfileController::waitUntilSettled() {
   LOG_INFO_S("AsyncLinearMotionProfileController: Waiting to settle");
 
-  auto rate = timeUtil.getRate();
+  // The controller task notifies settledEvent when it settles. The timeout is only a fallback.
+  auto generation = settledEvent.getGeneration();
   while (!isSettled()) {
-    rate->delayUntil(10_ms);
+    settledEvent.waitFor(generation, settledWaitTimeout);
+    generation = settledEvent.getGeneration();
   }
 
   LOG_INFO_S("AsyncLinearMotionProfileController: Done waiting to settle");
@@ -266,12 +476,19 @@ void AsyncLinearMotionProfileController::moveTo(const QLength &iposition,
 }
 
 double AsyncLinearMotionProfileController::getError() const {
-  if (const auto path = paths.find(getTarget()); path == paths.end()) {
+  std::shared_ptr<const std::vector<squiggles::ProfilePoint>> path;
+  currentPathMutex.lock();
+  if (const auto it = paths.find(getTarget()); it != paths.end()) {
+    path = it->second;
+  }
+  currentPathMutex.unlock();
+
+  if (!path || path->empty()) {
     return 0;
-  } else {
-    // The last position in the path is the target position
-    return path->second.back().vector.pose.x - currentProfilePosition;
   }
+
+  // The last position in the path is the target position
+  return path->back().vector.pose.x - currentProfilePosition.load(std::memory_order_acquire);
 }
 
 bool AsyncLinearMotionProfileController::isSettled() {
@@ -284,9 +501,10 @@ void AsyncLinearMotionProfileController::reset() {
 
   LOG_INFO_S("AsyncLinearMotionProfileController: Waiting to reset");
 
-  auto rate = timeUtil.getRate();
+  auto generation = settledEvent.getGeneration();
   while (isRunning.load(std::memory_order_acquire)) {
-    rate->delayUntil(1_ms);
+    settledEvent.waitFor(generation, settledWaitTimeout);
+    generation = settledEvent.getGeneration();
   }
 
   flipDisable(false);
@@ -299,6 +517,9 @@ void AsyncLinearMotionProfileController::flipDisable() {
 void AsyncLinearMotionProfileController::flipDisable(const bool iisDisabled) {
   LOG_INFO("AsyncLinearMotionProfileController: flipDisable " + std::to_string(iisDisabled));
   disabled.store(iisDisabled, std::memory_order_release);
+  // Disabling the controller settles it, and enabling it resumes any target
+  settledEvent.notifyAll();
+  wakeTask();
   // loop() will set the output to 0 when executeSinglePath() is done
   // the default implementation of executeSinglePath() breaks when disabled
 }
@@ -307,9 +528,11 @@ bool AsyncLinearMotionProfileController::isDisabled() const {
   return disabled.load(std::memory_order_acquire);
 }
 
-void AsyncLinearMotionProfileController::startThread() {
+void AsyncLinearMotionProfileController::startThread(const std::uint32_t ipriority,
+                                                     const std::uint16_t istackDepth) {
   if (!task) {
-    task = new CrossplatformThread(trampoline, this, "AsyncLinearMotionProfileController");
+    task = new CrossplatformThread(
+      trampoline, this, "AsyncLinearMotionProfileController", ipriority, istackDepth);
   }
 }
 
@@ -324,11 +547,30 @@ void AsyncLinearMotionProfileController::setMaxVelocity(std::int32_t) {
 }
 
 void AsyncLinearMotionProfileController::forceRemovePath(const std::string &ipathId) {
-  if (!removePath(ipathId)) {
-    LOG_WARN("AsyncLinearMotionProfileController: Disabling controller to remove path " + ipathId);
-    flipDisable(true);
-    removePath(ipathId);
-  }
+  removePath(ipathId);
+}
+
+void AsyncLinearMotionProfileController::setFeedback(
+  const std::shared_ptr<ControllerInput<double>> &iinput,
+  const std::shared_ptr<IterativePosPIDController> &icontroller,
+  const MotorFeedforward &ifeedforward,
+  const QTime isettleTimeout) {
+  LOG_INFO_S(iinput && icontroller ? "AsyncLinearMotionProfileController: Following paths with "
+                                     "feedback"
+                                   : "AsyncLinearMotionProfileController: Following paths open "
+                                     "loop");
+
+  std::scoped_lock lock(feedbackMutex);
+  feedbackInput = iinput;
+  feedbackController = icontroller;
+  feedforward = ifeedforward;
+  feedbackSettleTimeout = isettleTimeout;
+}
+
+void AsyncLinearMotionProfileController::setTrackingRecorder(
+  const std::shared_ptr<PathTrackingRecorder> &irecorder) {
+  std::scoped_lock lock(feedbackMutex);
+  trackingRecorder = irecorder;
 }
 
 } // namespace okapi
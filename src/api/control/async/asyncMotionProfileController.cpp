@@ -4,13 +4,17 @@
  * file, You can obtain one at http://mozilla.org/MPL/2.0/.
  */
 #include <algorithm>
+#include <cmath>
 #include <fstream>
 #include <iostream>
 #include <mutex>
 #include <numeric>
+#include <tuple>
 
 #include "okapi/api/control/async/asyncMotionProfileController.hpp"
+#include "okapi/api/util/flightRecorder.hpp"
 #include "okapi/api/util/mathUtil.hpp"
+#include "okapi/api/util/taskProfiler.hpp"
 
 namespace okapi {
 AsyncMotionProfileController::AsyncMotionProfileController(
@@ -25,63 +29,514 @@ AsyncMotionProfileController::AsyncMotionProfileController(
     model(imodel),
     scales(iscales),
     pair(ipair),
-    timeUtil(itimeUtil) {
+    timeUtil(itimeUtil),
+    pathRate(std::make_unique<ProfiledRate>(timeUtil.getRate(), "AsyncMotionProfileController")) {
   if (ipair.ratio == 0) {
     std::string msg("AsyncMotionProfileController: The gear ratio cannot be zero! Check if you are "
                     "using integer division.");
     LOG_ERROR(msg);
     throw std::invalid_argument(msg);
   }
+
+  motorCommandPerMps =
+    convertLinearToRotational(1_mps).convert(rpm) / toUnderlyingType(pair.internalGearset);
 }
 
 AsyncMotionProfileController::~AsyncMotionProfileController() {
   dtorCalled.store(true, std::memory_order_release);
+  wakeTask();
+  generationEvent.notifyAll();
 
-  // Free paths before deleting the task
-  std::scoped_lock lock(currentPathMutex);
+  // The generator task saves paths, so it has to stop before the paths are freed
+  delete generatorTask;
+
+  // Free paths before deleting the task. A running path is kept alive by the task's own reference,
+  // so the lock does not need to be held while the task stops.
+  currentPathMutex.lock();
   paths.clear();
+  pathTable.clear();
+  staticPaths.clear();
+  currentPathMutex.unlock();
 
   delete task;
 }
 
-void AsyncMotionProfileController::generatePath(std::initializer_list<PathfinderPoint> iwaypoints,
-                                                const std::string &ipathId) {
-  generatePath(iwaypoints, ipathId, limits);
+PathHandle
+AsyncMotionProfileController::generatePath(std::initializer_list<PathfinderPoint> iwaypoints,
+                                           const std::string &ipathId) {
+  return generatePath(iwaypoints, ipathId, limits);
 }
 
-void AsyncMotionProfileController::generatePath(std::initializer_list<PathfinderPoint> iwaypoints,
-                                                const std::string &ipathId,
-                                                const PathfinderLimits &ilimits) {
-  if (iwaypoints.size() == 0) {
+PathHandle
+AsyncMotionProfileController::generatePath(std::initializer_list<PathfinderPoint> iwaypoints,
+                                           const std::string &ipathId,
+                                           const PathfinderLimits &ilimits) {
+  return generatePath(iwaypoints, ipathId, ilimits, 0_mps, 0_mps);
+}
+
+PathHandle
+AsyncMotionProfileController::generatePath(std::initializer_list<PathfinderPoint> iwaypoints,
+                                           const std::string &ipathId,
+                                           const PathfinderLimits &ilimits,
+                                           const QSpeed istartVelocity,
+                                           const QSpeed iendVelocity) {
+  return generatePath(
+    std::vector<PathfinderPoint>(iwaypoints), ipathId, ilimits, istartVelocity, iendVelocity);
+}
+
+PathHandle
+AsyncMotionProfileController::generatePath(const std::vector<PathfinderPoint> &iwaypoints,
+                                           const std::string &ipathId) {
+  return generatePath(iwaypoints, ipathId, limits);
+}
+
+PathHandle
+AsyncMotionProfileController::generatePath(const std::vector<PathfinderPoint> &iwaypoints,
+                                           const std::string &ipathId,
+                                           const PathfinderLimits &ilimits,
+                                           const QSpeed istartVelocity,
+                                           const QSpeed iendVelocity) {
+  if (iwaypoints.empty()) {
     // No point in generating a path
     LOG_WARN_S(
       "AsyncMotionProfileController: Not generating a path because no waypoints were given.");
-    return;
+    return PathHandle();
+  }
+
+  auto path = generateProfile(iwaypoints, ilimits, istartVelocity, iendVelocity);
+  insertPath(ipathId, std::move(path));
+
+  LOG_INFO("AsyncMotionProfileController: Completely done generating path " + ipathId);
+  return getPathHandle(ipathId);
+}
+
+PathHandle AsyncMotionProfileController::generatePathIncremental(
+  const std::vector<PathfinderPoint> &iwaypoints, const std::string &ipathId) {
+  return generatePathIncremental(iwaypoints, ipathId, limits);
+}
+
+PathHandle AsyncMotionProfileController::generatePathIncremental(
+  const std::vector<PathfinderPoint> &iwaypoints,
+  const std::string &ipathId,
+  const PathfinderLimits &ilimits) {
+  std::shared_ptr<IncrementalPathGenerator> generator;
+  {
+    std::scoped_lock lock(currentPathMutex);
+    auto &entry = incrementalGenerators[ipathId];
+    const bool sameLimits = entry && entry->getLimits().maxVel == ilimits.maxVel &&
+                            entry->getLimits().maxAccel == ilimits.maxAccel &&
+                            entry->getLimits().maxJerk == ilimits.maxJerk;
+    if (!sameLimits) {
+      entry = std::make_shared<IncrementalPathGenerator>(ilimits, scales.wheelTrack, logger);
+    }
+    generator = entry;
   }
 
-  std::vector<squiggles::Pose> points;
-  points.reserve(iwaypoints.size());
-  for (auto &point : iwaypoints) {
-    points.push_back(squiggles::Pose{
-      point.y.convert(meter), point.x.convert(meter), (90_deg - point.theta).convert(radian)});
+  // Generating the segments can take a while, so it is done without holding the lock
+  auto path = postProcessProfile(generator->generate(iwaypoints), ilimits);
+  insertPath(ipathId, std::move(path));
+
+  LOG_INFO("AsyncMotionProfileController: Regenerated " +
+           std::to_string(generator->getGeneratedSegmentCount()) + " segments of path " + ipathId);
+  return getPathHandle(ipathId);
+}
+
+std::vector<squiggles::ProfilePoint>
+AsyncMotionProfileController::generateProfile(const std::vector<PathfinderPoint> &iwaypoints,
+                                              const PathfinderLimits &ilimits,
+                                              const QSpeed istartVelocity,
+                                              const QSpeed iendVelocity) const {
+  const double startVel = istartVelocity.convert(mps);
+  const double endVel = iendVelocity.convert(mps);
+  if (startVel < 0 || startVel > ilimits.maxVel || endVel < 0 || endVel > ilimits.maxVel) {
+    std::string msg("AsyncMotionProfileController: The start and end velocities must be between "
+                    "zero and the maximum velocity.");
+    LOG_ERROR(msg);
+    throw std::invalid_argument(msg);
   }
 
   LOG_INFO_S("AsyncMotionProfileController: Preparing trajectory");
 
-  auto constraints = squiggles::Constraints(ilimits.maxVel, ilimits.maxAccel, ilimits.maxJerk);
-  auto splineGenerator = squiggles::SplineGenerator(
-    constraints,
-    std::make_shared<squiggles::TankModel>(scales.wheelTrack.convert(meter), constraints),
-    DT);
-  auto path = splineGenerator.generate(points);
+  currentPathMutex.lock();
+  const auto client = coprocessor;
+  currentPathMutex.unlock();
+
+  if (client) {
+    auto path =
+      client->generateProfile(iwaypoints, ilimits, scales.wheelTrack, istartVelocity, iendVelocity);
+    if (path && !path->empty()) {
+      return postProcessProfile(std::move(*path), ilimits);
+    }
+
+    LOG_WARN_S("AsyncMotionProfileController: The coprocessor did not generate the path, "
+               "generating it on the brain");
+  }
 
-  // Free the old path before overwriting it
-  forceRemovePath(ipathId);
+  return postProcessProfile(
+    ProfileGenerator::generate(
+      iwaypoints, ilimits, scales.wheelTrack, istartVelocity, iendVelocity),
+    ilimits);
+}
 
-  paths.insert({ipathId, path});
+std::vector<squiggles::ProfilePoint>
+AsyncMotionProfileController::postProcessProfile(std::vector<squiggles::ProfilePoint> ipath,
+                                                 const PathfinderLimits &ilimits) const {
+  auto path = std::move(ipath);
+
+  currentPathMutex.lock();
+  const auto stride = decimationStride;
+  const auto curvatureChange = decimationCurvatureChange;
+  const auto retimer = profileRetimer;
+  const auto centripetalAccel = maxCentripetalAccel;
+  currentPathMutex.unlock();
+
+  if (retimer && !path.empty()) {
+    const double generatedDuration = path.back().time - path.front().time;
+    path = retimer->retime(path);
+    LOG_DEBUG("AsyncMotionProfileController: Retimed path from " +
+              std::to_string(generatedDuration) + " s to " +
+              std::to_string(path.back().time - path.front().time) + " s");
+  }
+
+  if (std::isfinite(centripetalAccel) && !path.empty()) {
+    const double unlimitedDuration = path.back().time - path.front().time;
+    path = ProfileRetimer::limitCentripetalAcceleration(
+      path, scales.wheelTrack.convert(meter) / 2, centripetalAccel, ilimits.maxAccel);
+    LOG_DEBUG("AsyncMotionProfileController: Limited centripetal acceleration, path took " +
+              std::to_string(unlimitedDuration) + " s and takes " +
+              std::to_string(path.back().time - path.front().time) + " s");
+  }
+
+  if (stride > 1) {
+    const auto generatedLength = path.size();
+    path = ProfileResampler::decimate(path, stride, curvatureChange);
+    LOG_DEBUG("AsyncMotionProfileController: Decimated path from " +
+              std::to_string(generatedLength) + " points");
+  }
 
-  LOG_INFO("AsyncMotionProfileController: Completely done generating path " + ipathId);
   LOG_DEBUG("AsyncMotionProfileController: Path length: " + std::to_string(path.size()));
+  return path;
+}
+
+void AsyncMotionProfileController::insertPath(const std::string &ipathId,
+                                              std::vector<squiggles::ProfilePoint> ipath) {
+  insertPath(ipathId, pathPool->store(std::move(ipath)));
+}
+
+void AsyncMotionProfileController::insertPath(
+  const std::string &ipathId,
+  std::shared_ptr<const std::vector<squiggles::ProfilePoint>> ipath) {
+  const auto bytes = estimatePathBytes(*ipath);
+
+  // A running path with the same ID keeps its own reference to the old path
+  std::scoped_lock lock(currentPathMutex);
+  staticPaths.erase(ipathId);
+  pathViews.erase(ipathId);
+  streamedPaths.erase(ipathId);
+  pathTable[internPath(ipathId).getIndex()] = ipath;
+  paths.insert_or_assign(ipathId, std::move(ipath));
+
+  // Any copy on the SD card no longer matches this path
+  pathSources.erase(ipathId);
+
+  touchCachedPath(ipathId, bytes);
+  evictCachedPaths(ipathId);
+}
+
+void AsyncMotionProfileController::setPathSource(const std::string &ipathId,
+                                                 const std::string &idirectory) {
+  std::scoped_lock lock(currentPathMutex);
+  if (paths.find(ipathId) != paths.end()) {
+    pathSources.insert_or_assign(ipathId, idirectory);
+  }
+}
+
+void AsyncMotionProfileController::reloadPath(const std::string &idirectory,
+                                              const std::string &ipathId) {
+  loadPath(idirectory, ipathId);
+}
+
+void AsyncMotionProfileController::touchCachedPath(const std::string &ipathId,
+                                                   const std::size_t ibytes) {
+  if (auto entry = pathCacheEntries.find(ipathId); entry != pathCacheEntries.end()) {
+    pathCacheStats.bytesUsed -= entry->second.bytes;
+    pathLru.splice(pathLru.begin(), pathLru, entry->second.lruPosition);
+    entry->second.bytes = ibytes;
+  } else {
+    pathLru.push_front(ipathId);
+    pathCacheEntries.emplace(ipathId, CachedPath{pathLru.begin(), ibytes});
+  }
+
+  pathCacheStats.bytesUsed += ibytes;
+}
+
+void AsyncMotionProfileController::forgetCachedPath(const std::string &ipathId) {
+  if (auto entry = pathCacheEntries.find(ipathId); entry != pathCacheEntries.end()) {
+    pathCacheStats.bytesUsed -= entry->second.bytes;
+    pathLru.erase(entry->second.lruPosition);
+    pathCacheEntries.erase(entry);
+  }
+}
+
+void AsyncMotionProfileController::evictCachedPaths(const std::string &ikeepId) {
+  if (pathCacheStats.byteBudget == 0) {
+    return;
+  }
+
+  auto it = pathLru.end();
+  while (pathCacheStats.bytesUsed > pathCacheStats.byteBudget && it != pathLru.begin()) {
+    --it;
+    const std::string pathId = *it;
+    if (pathId == ikeepId || pathSources.find(pathId) == pathSources.end()) {
+      // This path can't be reloaded, so it has to stay in memory
+      continue;
+    }
+
+    // Step past the path before its list entry is erased
+    ++it;
+    erasePathData(pathId);
+    forgetCachedPath(pathId);
+    pathCacheStats.evictions++;
+
+    LOG_DEBUG("AsyncMotionProfileController: Evicted path " + pathId);
+  }
+
+  if (pathCacheStats.bytesUsed > pathCacheStats.byteBudget) {
+    LOG_WARN("AsyncMotionProfileController: Paths use " +
+             std::to_string(pathCacheStats.bytesUsed) + " bytes, which is over the budget of " +
+             std::to_string(pathCacheStats.byteBudget) +
+             " bytes, but none of them can be reloaded. Store them to an SD card to allow "
+             "evicting them.");
+  }
+}
+
+std::size_t
+AsyncMotionProfileController::estimatePathBytes(const std::vector<squiggles::ProfilePoint> &ipath) {
+  return PathPool::estimatePathBytes(ipath);
+}
+
+void AsyncMotionProfileController::setPathCacheBudget(const std::size_t ibytes) {
+  LOG_INFO("AsyncMotionProfileController: Set path cache budget to " + std::to_string(ibytes) +
+           " bytes");
+
+  std::scoped_lock lock(currentPathMutex);
+  pathCacheStats.byteBudget = ibytes;
+  evictCachedPaths("");
+}
+
+PathCacheStats AsyncMotionProfileController::getPathCacheStats() const {
+  std::scoped_lock lock(currentPathMutex);
+  return pathCacheStats;
+}
+
+std::shared_ptr<PathPool> AsyncMotionProfileController::getPathPool() const {
+  return pathPool;
+}
+
+PathGenerationHandle
+AsyncMotionProfileController::generatePathAsync(std::initializer_list<PathfinderPoint> iwaypoints,
+                                                const std::string &ipathId) {
+  return generatePathAsync(iwaypoints, ipathId, limits);
+}
+
+PathGenerationHandle
+AsyncMotionProfileController::generatePathAsync(std::initializer_list<PathfinderPoint> iwaypoints,
+                                                const std::string &ipathId,
+                                                const PathfinderLimits &ilimits) {
+  return generatePathAsync(std::vector<PathfinderPoint>(iwaypoints), ipathId, ilimits);
+}
+
+PathGenerationHandle
+AsyncMotionProfileController::generatePathAsync(std::vector<PathfinderPoint> iwaypoints,
+                                                const std::string &ipathId) {
+  return generatePathAsync(std::move(iwaypoints), ipathId, limits);
+}
+
+PathGenerationHandle
+AsyncMotionProfileController::generatePathAsync(std::vector<PathfinderPoint> iwaypoints,
+                                                const std::string &ipathId,
+                                                const PathfinderLimits &ilimits) {
+  auto status = std::make_shared<std::atomic<PathGenerationStatus>>(PathGenerationStatus::queued);
+
+  if (iwaypoints.empty()) {
+    LOG_WARN_S(
+      "AsyncMotionProfileController: Not generating a path because no waypoints were given.");
+    status->store(PathGenerationStatus::failed, std::memory_order_release);
+    return PathGenerationHandle(ipathId, status);
+  }
+
+  {
+    std::scoped_lock lock(generationMutex);
+    generationQueue.push_back(PathGenerationJob{std::move(iwaypoints), ipathId, ilimits, status});
+    pendingPaths[ipathId] = status;
+
+    startGeneratorTask();
+  }
+  generationEvent.notifyAll();
+
+  LOG_INFO("AsyncMotionProfileController: Queued path " + ipathId + " for generation");
+  return PathGenerationHandle(ipathId, status);
+}
+
+PathGenerationHandle AsyncMotionProfileController::replan() {
+  return replan(limits);
+}
+
+PathGenerationHandle AsyncMotionProfileController::replan(const PathfinderLimits &ilimits) {
+  auto status = std::make_shared<std::atomic<PathGenerationStatus>>(PathGenerationStatus::queued);
+
+  const std::string pathId = getTarget();
+
+  feedbackMutex.lock();
+  const ReplanContext context = replanContext;
+  feedbackMutex.unlock();
+
+  if (!context.active || !context.hasPose) {
+    LOG_WARN_S("AsyncMotionProfileController: Not replanning because no generated path is being "
+               "followed with odometry.");
+    status->store(PathGenerationStatus::failed, std::memory_order_release);
+    return PathGenerationHandle(pathId, status);
+  }
+
+  // The speed the robot is commanded at is the best estimate of how fast it is moving
+  const QSpeed startVelocity = std::clamp(context.velocity, 0.0, ilimits.maxVel) * mps;
+
+  PathGenerationJob job{{poseToWaypoint(context.robotPose), poseToWaypoint(context.goal)},
+                        pathId,
+                        ilimits,
+                        status};
+  job.isReplan = true;
+  job.startVelocity = startVelocity;
+  job.followId = context.followId;
+  job.step = context.step;
+
+  {
+    std::scoped_lock lock(generationMutex);
+    // Replanned profiles are not saved, so they are not pending paths
+    generationQueue.push_back(std::move(job));
+
+    startGeneratorTask();
+  }
+  generationEvent.notifyAll();
+
+  LOG_INFO("AsyncMotionProfileController: Queued a replan of path " + pathId);
+  return PathGenerationHandle(pathId, status);
+}
+
+void AsyncMotionProfileController::generatorTrampoline(void *context) {
+  if (context) {
+    static_cast<AsyncMotionProfileController *>(context)->generatorLoop();
+  }
+}
+
+void AsyncMotionProfileController::generatorLoop() {
+  LOG_INFO_S("Started AsyncMotionProfileController generator task.");
+
+  while (!dtorCalled.load(std::memory_order_acquire)) {
+    // Read the generation before checking the queue so a job queued in between is not missed
+    const auto generation = generationEvent.getGeneration();
+    generationMutex.lock();
+    if (generationQueue.empty()) {
+      generationMutex.unlock();
+      generationEvent.waitFor(generation, idleLoopTimeout);
+      continue;
+    }
+
+    auto job = std::move(generationQueue.front());
+    generationQueue.pop_front();
+    generationMutex.unlock();
+
+    job.status->store(PathGenerationStatus::generating, std::memory_order_release);
+
+    if (job.isLibrary) {
+      const bool loaded = loadPathLibrary(job.pathId) > 0;
+      job.status->store(loaded ? PathGenerationStatus::ready : PathGenerationStatus::failed,
+                        std::memory_order_release);
+
+      generationMutex.lock();
+      pendingLibraries--;
+      generationMutex.unlock();
+
+      generationEvent.notifyAll();
+      continue;
+    }
+
+    std::vector<squiggles::ProfilePoint> path;
+    try {
+      path = generateProfile(job.waypoints, job.limits, job.startVelocity);
+    } catch (const std::runtime_error &e) {
+      // There is no caller to throw to, so the failure is reported through the handle
+      LOG_ERROR("AsyncMotionProfileController: Failed to generate path " + job.pathId + ": " +
+                std::string(e.what()));
+    }
+
+    if (path.empty()) {
+      LOG_ERROR("AsyncMotionProfileController: " +
+                getPathErrorMessage(job.waypoints, job.pathId, 0));
+      job.status->store(PathGenerationStatus::failed, std::memory_order_release);
+    } else if (job.isReplan) {
+      auto profile = pathPool->store(std::move(path));
+      {
+        // Handed to the controller task, which drops it if the path it was planned for is done
+        std::scoped_lock lock(feedbackMutex);
+        replannedPath = std::move(profile);
+        replannedFollowId = job.followId;
+        replannedStep = job.step;
+      }
+      replanReady.store(true, std::memory_order_release);
+      job.status->store(PathGenerationStatus::ready, std::memory_order_release);
+      LOG_INFO("AsyncMotionProfileController: Completely done replanning path " + job.pathId);
+    } else {
+      insertPath(job.pathId, std::move(path));
+      job.status->store(PathGenerationStatus::ready, std::memory_order_release);
+      LOG_INFO("AsyncMotionProfileController: Completely done generating path " + job.pathId);
+    }
+
+    {
+      std::scoped_lock lock(generationMutex);
+      auto pending = pendingPaths.find(job.pathId);
+      // Only clear the entry if the path was not queued again in the meantime
+      if (pending != pendingPaths.end() && pending->second == job.status) {
+        pendingPaths.erase(pending);
+      }
+    }
+
+    // Wake any tasks in waitForPath()
+    generationEvent.notifyAll();
+  }
+
+  LOG_INFO_S("Stopped AsyncMotionProfileController generator task.");
+}
+
+bool AsyncMotionProfileController::isPathPending(const std::string &ipathId) {
+  std::scoped_lock lock(generationMutex);
+  return pendingLibraries > 0 || pendingPaths.find(ipathId) != pendingPaths.end();
+}
+
+void AsyncMotionProfileController::startGeneratorTask() {
+  if (!generatorTask) {
+    // Run below the default priority so generation never delays a control loop
+    generatorTask = new CrossplatformThread(generatorTrampoline,
+                                            this,
+                                            "AsyncMotionProfileController generator",
+                                            TASK_PRIORITY_DEFAULT - 2);
+  }
+}
+
+void AsyncMotionProfileController::waitForPath(const std::string &ipathId) {
+  if (!isPathPending(ipathId)) {
+    return;
+  }
+
+  LOG_INFO("AsyncMotionProfileController: Waiting for path " + ipathId + " to be generated");
+
+  // The generator task notifies generationEvent when it finishes a job. The timeout is only a
+  // fallback.
+  auto generation = generationEvent.getGeneration();
+  while (isPathPending(ipathId)) {
+    generationEvent.waitFor(generation, settledWaitTimeout);
+    generation = generationEvent.getGeneration();
+  }
 }
 
 std::string
@@ -103,19 +558,73 @@ AsyncMotionProfileController::getPathErrorMessage(const std::vector<PathfinderPo
            [&](std::string a, PathfinderPoint b) { return a + ", " + pointToString(b); });
 }
 
-bool AsyncMotionProfileController::removePath(const std::string &ipathId) {
-  if (!isDisabled() && isRunning.load(std::memory_order_acquire) && getTarget() == ipathId) {
-    LOG_WARN("AsyncMotionProfileController: Attempted to remove currently running path " + ipathId);
-    return false;
+void AsyncMotionProfileController::registerStaticPath(const std::string &ipathId,
+                                                      const StaticProfilePoint *ipoints,
+                                                      const std::size_t icount) {
+  if (ipoints == nullptr || icount == 0) {
+    LOG_WARN("AsyncMotionProfileController: Not registering empty static path " + ipathId);
+    return;
   }
 
   std::scoped_lock lock(currentPathMutex);
+  erasePathData(ipathId);
+  forgetCachedPath(ipathId);
+  pathSources.erase(ipathId);
+  pathViews.erase(ipathId);
+  streamedPaths.erase(ipathId);
+  staticPaths.insert_or_assign(ipathId, std::make_pair(ipoints, icount));
+
+  LOG_INFO("AsyncMotionProfileController: Registered static path " + ipathId + " with " +
+           std::to_string(icount) + " points");
+}
+
+void AsyncMotionProfileController::registerPathView(const std::string &iviewId,
+                                                    const std::string &ibasePathId,
+                                                    const bool ibackwards,
+                                                    const bool imirrored,
+                                                    const double ispeedScale) {
+  if (!(ispeedScale > 0)) {
+    std::string msg("AsyncMotionProfileController: The speed scale of a path view must be "
+                    "positive.");
+    LOG_ERROR(msg);
+    throw std::invalid_argument(msg);
+  }
 
-  auto oldPath = paths.find(ipathId);
-  if (oldPath != paths.end()) {
-    paths.erase(ipathId);
+  if (iviewId == ibasePathId) {
+    std::string msg("AsyncMotionProfileController: A path view can't be a view of itself.");
+    LOG_ERROR(msg);
+    throw std::invalid_argument(msg);
   }
 
+  std::scoped_lock lock(currentPathMutex);
+  erasePathData(iviewId);
+  forgetCachedPath(iviewId);
+  pathSources.erase(iviewId);
+  staticPaths.erase(iviewId);
+  streamedPaths.erase(iviewId);
+  pathViews.insert_or_assign(iviewId, PathView{ibasePathId, ibackwards, imirrored, ispeedScale});
+
+  LOG_INFO("AsyncMotionProfileController: Registered path view " + iviewId + " of " +
+           ibasePathId);
+}
+
+bool AsyncMotionProfileController::removePath(const std::string &ipathId) {
+  std::scoped_lock lock(currentPathMutex);
+
+  // If this path is running, the controller task still holds a reference to it, so it will be
+  // freed once it is done
+  erasePathData(ipathId);
+  forgetCachedPath(ipathId);
+  incrementalGenerators.erase(ipathId);
+
+  // Forget the copy on the SD card so the path is not reloaded
+  pathSources.erase(ipathId);
+
+  // Static paths are not owned by this controller so there is nothing to free
+  staticPaths.erase(ipathId);
+  pathViews.erase(ipathId);
+  streamedPaths.erase(ipathId);
+
   // A return value of true provides no feedback about whether the path was actually removed but
   // instead tells us that the path does not exist at this moment
   return true;
@@ -124,27 +633,164 @@ bool AsyncMotionProfileController::removePath(const std::string &ipathId) {
 std::vector<std::string> AsyncMotionProfileController::getPaths() {
   std::vector<std::string> keys;
 
+  std::scoped_lock lock(currentPathMutex);
+
   for (const auto &path : paths) {
     keys.push_back(path.first);
   }
 
+  for (const auto &path : staticPaths) {
+    keys.push_back(path.first);
+  }
+
+  for (const auto &view : pathViews) {
+    keys.push_back(view.first);
+  }
+
+  for (const auto &path : streamedPaths) {
+    keys.push_back(path.first);
+  }
+
+  // Evicted paths are still available because they are reloaded when they are followed
+  for (const auto &source : pathSources) {
+    if (paths.find(source.first) == paths.end()) {
+      keys.push_back(source.first);
+    }
+  }
+
   return keys;
 }
 
+PathHandle AsyncMotionProfileController::getPathHandle(const std::string &ipathId) {
+  std::scoped_lock lock(currentPathMutex);
+  return internPath(ipathId);
+}
+
+std::string AsyncMotionProfileController::getPathId(const PathHandle ipath) const {
+  std::scoped_lock lock(currentPathMutex);
+  if (ipath.getIndex() < pathNames.size()) {
+    return pathNames[ipath.getIndex()];
+  }
+  return "";
+}
+
+PathHandle AsyncMotionProfileController::internPath(const std::string &ipathId) {
+  if (const auto it = pathHandles.find(ipathId); it != pathHandles.end()) {
+    return it->second;
+  }
+
+  const PathHandle handle(static_cast<std::uint32_t>(pathNames.size()));
+  pathNames.push_back(ipathId);
+  pathHandles.emplace(ipathId, handle);
+  pathTable.emplace_back(nullptr);
+  return handle;
+}
+
+void AsyncMotionProfileController::erasePathData(const std::string &ipathId) {
+  if (paths.erase(ipathId) > 0) {
+    pathTable[pathHandles.at(ipathId).getIndex()] = nullptr;
+  }
+}
+
 void AsyncMotionProfileController::setTarget(std::string ipathId) {
-  setTarget(ipathId, false);
+  setTarget(getPathHandle(ipathId), false);
 }
 
 void AsyncMotionProfileController::setTarget(std::string ipathId,
                                              const bool ibackwards,
-                                             const bool imirrored) {
+                                             const bool imirrored,
+                                             const double ispeedScale) {
+  setTarget(getPathHandle(ipathId), ibackwards, imirrored, ispeedScale);
+}
+
+void AsyncMotionProfileController::setTarget(const PathHandle ipath,
+                                             const bool ibackwards,
+                                             const bool imirrored,
+                                             const double ispeedScale) {
+  const std::string ipathId = getPathId(ipath);
   LOG_INFO("AsyncMotionProfileController: Set target to: " + ipathId + " (ibackwards=" +
-           std::to_string(ibackwards) + ", imirrored=" + std::to_string(imirrored) + ")");
+           std::to_string(ibackwards) + ", imirrored=" + std::to_string(imirrored) +
+           ", ispeedScale=" + std::to_string(ispeedScale) + ")");
+
+  if (!(ispeedScale > 0)) {
+    std::string msg("AsyncMotionProfileController: The speed scale must be positive.");
+    LOG_ERROR(msg);
+    throw std::invalid_argument(msg);
+  }
+
+  // The path might still be generating in the background
+  waitForTargetPath(ipathId);
+
+  currentPathMutex.lock();
+  queuedPaths.clear();
+  currentPathMutex.unlock();
 
-  currentPath = ipathId;
+  currentPath.store(ipath, std::memory_order_release);
   direction.store(boolToSign(!ibackwards), std::memory_order_release);
   mirrored.store(imirrored, std::memory_order_release);
+  speedScale.store(ispeedScale, std::memory_order_release);
   isRunning.store(true, std::memory_order_release);
+  FlightRecorder::recordDefault(FlightEventType::targetChanged,
+                                "AsyncMotionProfileController",
+                                static_cast<std::int32_t>(ipath.getIndex()));
+  wakeTask();
+}
+
+void AsyncMotionProfileController::setTargetSequence(const std::vector<std::string> &ipathIds,
+                                                     const bool ibackwards,
+                                                     const bool imirrored,
+                                                     const double ispeedScale) {
+  if (!(ispeedScale > 0)) {
+    std::string msg("AsyncMotionProfileController: The speed scale must be positive.");
+    LOG_ERROR(msg);
+    throw std::invalid_argument(msg);
+  }
+
+  if (ipathIds.empty()) {
+    LOG_WARN_S(
+      "AsyncMotionProfileController: Not setting a target because the sequence is empty.");
+    return;
+  }
+
+  LOG_INFO("AsyncMotionProfileController: Set target sequence starting with: " +
+           ipathIds.front() + " (length " + std::to_string(ipathIds.size()) +
+           ", ibackwards=" + std::to_string(ibackwards) +
+           ", imirrored=" + std::to_string(imirrored) +
+           ", ispeedScale=" + std::to_string(ispeedScale) + ")");
+
+  // Any of the paths might still be generating in the background
+  for (const auto &pathId : ipathIds) {
+    waitForTargetPath(pathId);
+  }
+
+  currentPathMutex.lock();
+  for (std::size_t i = 0; i + 1 < ipathIds.size(); ++i) {
+    const auto current = paths.find(ipathIds[i]);
+    const auto next = paths.find(ipathIds[i + 1]);
+    if (current != paths.end() && next != paths.end() && !current->second->empty() &&
+        !next->second->empty() &&
+        std::abs(current->second->back().vector.vel - next->second->front().vector.vel) > 0.05) {
+      LOG_WARN("AsyncMotionProfileController: The end velocity of path " + ipathIds[i] +
+               " does not match the start velocity of path " + ipathIds[i + 1]);
+    }
+  }
+
+  queuedPaths.clear();
+  for (auto it = std::next(ipathIds.begin()); it != ipathIds.end(); ++it) {
+    queuedPaths.push_back(internPath(*it));
+  }
+  const PathHandle first = internPath(ipathIds.front());
+  currentPathMutex.unlock();
+
+  currentPath.store(first, std::memory_order_release);
+  direction.store(boolToSign(!ibackwards), std::memory_order_release);
+  mirrored.store(imirrored, std::memory_order_release);
+  speedScale.store(ispeedScale, std::memory_order_release);
+  isRunning.store(true, std::memory_order_release);
+  FlightRecorder::recordDefault(FlightEventType::targetChanged,
+                                "AsyncMotionProfileController",
+                                static_cast<std::int32_t>(first.getIndex()));
+  wakeTask();
 }
 
 void AsyncMotionProfileController::controllerSet(std::string ivalue) {
@@ -152,87 +798,708 @@ void AsyncMotionProfileController::controllerSet(std::string ivalue) {
 }
 
 std::string AsyncMotionProfileController::getTarget() {
-  return currentPath;
+  return getPathId(currentPath.load(std::memory_order_acquire));
 }
 
 std::string AsyncMotionProfileController::getProcessValue() const {
-  return currentPath;
+  return getPathId(currentPath.load(std::memory_order_acquire));
 }
 
 void AsyncMotionProfileController::loop() {
   LOG_INFO_S("Started AsyncMotionProfileController task.");
 
-  auto rate = timeUtil.getRate();
-
-  while (!dtorCalled.load(std::memory_order_acquire) && !task->notifyTake(0)) {
+  while (!dtorCalled.load(std::memory_order_acquire)) {
     if (isRunning.load(std::memory_order_acquire) && !isDisabled()) {
-      LOG_INFO("AsyncMotionProfileController: Running with path: " + currentPath);
-
-      auto path = paths.find(currentPath);
-      if (path == paths.end()) {
-        LOG_WARN("AsyncMotionProfileController: Target was set to non-existent path with name: " +
-                 currentPath);
-      } else {
-        LOG_DEBUG("AsyncMotionProfileController: Path length is " +
-                  std::to_string(path->second.size()));
+      feedbackMutex.lock();
+      activeTrackingRecorder = trackingRecorder;
+      feedbackMutex.unlock();
+      if (activeTrackingRecorder) {
+        activeTrackingRecorder->beginPath(getPathId(currentPath.load(std::memory_order_acquire)));
+      }
 
-        executeSinglePath(path->second, timeUtil.getRate());
+      bool followedPath = false;
+      do {
+        followedPath = executePath(currentPath.load(std::memory_order_acquire)) || followedPath;
+      } while (advanceToQueuedPath());
 
-        // Stop the chassis after the path because:
-        // 1. We only support an exit velocity of zero
+      if (followedPath) {
+        // Stop the chassis after the last path because:
+        // 1. Only the paths inside a sequence can have a non-zero exit velocity
         // 2. Because of (1), we should make sure the system is stopped
         model->stop();
 
         LOG_INFO_S("AsyncMotionProfileController: Done moving");
       }
 
+      // Write the samples once the chassis is stopped so writing them can not delay a command
+      if (activeTrackingRecorder) {
+        activeTrackingRecorder->endPath();
+        activeTrackingRecorder = nullptr;
+      }
+
+      FlightRecorder::recordDefault(
+        FlightEventType::settled, "AsyncMotionProfileController", followedPath);
       isRunning.store(false, std::memory_order_release);
+      settledEvent.notifyAll();
     }
 
-    rate->delayUntil(10_ms);
+    // Sleep until setTarget() wakes this task. Any other notification means the task which made
+    // this controller was deleted, so stop.
+    if (CrossplatformThread::notifyTake(idleLoopTimeout) & ~CrossplatformThread::wakeNotification) {
+      break;
+    }
   }
 
   LOG_INFO_S("Stopped AsyncMotionProfileController task.");
 }
 
-void AsyncMotionProfileController::executeSinglePath(
-  const std::vector<squiggles::ProfilePoint> &path,
-  std::unique_ptr<AbstractRate> rate) {
-  const int reversed = direction.load(std::memory_order_acquire);
-  const bool followMirrored = mirrored.load(std::memory_order_acquire);
-
+bool AsyncMotionProfileController::executePath(const PathHandle ipath) {
   currentPathMutex.lock();
-  // store this locally so we aren't accessing the path when we don't know if it's valid
-  std::size_t pathSize = path.size();
+  if (ipath.getIndex() >= pathNames.size()) {
+    currentPathMutex.unlock();
+    LOG_WARN_S("AsyncMotionProfileController: Target was set to an invalid path handle");
+    return false;
+  }
+
+  // Interned IDs are never removed, so this reference stays valid after unlocking
+  const std::string &targetId = pathNames[ipath.getIndex()];
+  LOG_INFO_F("AsyncMotionProfileController: Running with path: %s", targetId);
+
+  // Take our own reference to the path so it stays valid even if it is removed or replaced
+  // while we follow it. Generated paths are found by handle, everything else by ID.
+  std::shared_ptr<const std::vector<squiggles::ProfilePoint>> path = pathTable[ipath.getIndex()];
+  std::pair<const StaticProfilePoint *, std::size_t> staticPath{nullptr, 0};
+  std::string evictedFrom;
+  std::string streamedFrom;
+  std::string pathId;
+  int viewDirection = 1;
+  bool viewMirrored = false;
+  double viewSpeedScale = 1;
+
+  if (path) {
+    pathCacheStats.hits++;
+    if (auto entry = pathCacheEntries.find(targetId); entry != pathCacheEntries.end()) {
+      touchCachedPath(targetId, entry->second.bytes);
+    }
+  } else {
+    // Follow path views down to the path they share
+    pathId = targetId;
+    for (std::size_t depth = 0;; ++depth) {
+      const auto view = pathViews.find(pathId);
+      if (view == pathViews.end()) {
+        break;
+      }
+
+      if (depth == maxPathViewDepth) {
+        currentPathMutex.unlock();
+        LOG_WARN("AsyncMotionProfileController: Path view " + targetId +
+                 " does not lead to a path. Check for a cycle of path views.");
+        return false;
+      }
+
+      viewDirection *= boolToSign(!view->second.backwards);
+      viewMirrored = viewMirrored != view->second.mirrored;
+      viewSpeedScale *= view->second.speedScale;
+      pathId = view->second.basePathId;
+    }
+
+    if (auto it = paths.find(pathId); it != paths.end()) {
+      path = it->second;
+      pathCacheStats.hits++;
+      if (auto entry = pathCacheEntries.find(pathId); entry != pathCacheEntries.end()) {
+        touchCachedPath(pathId, entry->second.bytes);
+      }
+    } else if (auto staticIt = staticPaths.find(pathId); staticIt != staticPaths.end()) {
+      staticPath = staticIt->second;
+    } else if (auto source = pathSources.find(pathId); source != pathSources.end()) {
+      evictedFrom = source->second;
+      pathCacheStats.misses++;
+    } else if (auto streamed = streamedPaths.find(pathId); streamed != streamedPaths.end()) {
+      streamedFrom = streamed->second;
+    }
+  }
   currentPathMutex.unlock();
-  for (std::size_t i = 0; i < pathSize && !isDisabled(); ++i) {
-    // This mutex is used to combat an edge case of an edge case
-    // if a running path is asked to be removed at the moment this loop is executing
+
+  if (!evictedFrom.empty()) {
+    LOG_INFO("AsyncMotionProfileController: Reloading evicted path " + pathId + " from " +
+             evictedFrom);
+    reloadPath(evictedFrom, pathId);
+    path = getPathData(pathId);
+  }
+
+  activeDirection.store(direction.load(std::memory_order_acquire) * viewDirection,
+                        std::memory_order_release);
+  activeMirrored.store(mirrored.load(std::memory_order_acquire) != viewMirrored,
+                       std::memory_order_release);
+  activeSpeedScale.store(speedScale.load(std::memory_order_acquire) * viewSpeedScale,
+                         std::memory_order_release);
+
+  if (path) {
+    LOG_DEBUG_F("AsyncMotionProfileController: Path length is %zu", path->size());
+    executeSinglePath(*path, *pathRate);
+    pathRate->reset();
+    return true;
+  }
+
+  if (staticPath.first) {
+    LOG_DEBUG_F("AsyncMotionProfileController: Static path length is %zu", staticPath.second);
+    executeStaticPath(staticPath.first, staticPath.second, *pathRate);
+    pathRate->reset();
+    return true;
+  }
+
+  if (!streamedFrom.empty()) {
+    PathStreamReader reader(openStreamedPath(streamedFrom, pathId), timeUtil);
+    if (reader.isValid()) {
+      LOG_DEBUG_F("AsyncMotionProfileController: Streamed path length is %zu",
+                  reader.getPointCount());
+      executeStreamedPath(reader, *pathRate);
+      pathRate->reset();
+      return true;
+    }
+
+    LOG_WARN("AsyncMotionProfileController: Couldn't stream path " + pathId + " from " +
+             streamedFrom + ". Check that the binary path file exists and is valid.");
+    return false;
+  }
+
+  LOG_WARN("AsyncMotionProfileController: Target was set to non-existent path with name: " +
+           targetId);
+  return false;
+}
+
+void AsyncMotionProfileController::waitForTargetPath(const std::string &ipathId) {
+  std::string pathId = ipathId;
+  for (std::size_t depth = 0; depth <= maxPathViewDepth; ++depth) {
+    waitForPath(pathId);
+
     std::scoped_lock lock(currentPathMutex);
+    const auto view = pathViews.find(pathId);
+    if (view == pathViews.end()) {
+      return;
+    }
+    pathId = view->second.basePathId;
+  }
+}
+
+bool AsyncMotionProfileController::advanceToQueuedPath() {
+  std::scoped_lock lock(currentPathMutex);
+
+  if (isDisabled()) {
+    // Disabling the controller cancels the rest of the sequence
+    queuedPaths.clear();
+  }
+
+  if (queuedPaths.empty()) {
+    return false;
+  }
+
+  currentPath.store(queuedPaths.front(), std::memory_order_release);
+  queuedPaths.pop_front();
+  return true;
+}
+
+void AsyncMotionProfileController::executeSinglePath(
+  const std::vector<squiggles::ProfilePoint> &path,
+  AbstractRate &rate) {
+  const double scale = activeSpeedScale.load(std::memory_order_acquire);
+  const auto interpolation = profileInterpolation.load(std::memory_order_acquire);
+  const double period = commandPeriod.load(std::memory_order_acquire);
+
+  // The caller holds a reference to the path for as long as this runs, so there is nothing to
+  // lock. Profiles with timestamps (including decimated ones) are sampled every command period,
+  // other profiles are followed point by point every DT. Scaling the speed stretches the time
+  // between samples and scales the velocities.
+  const bool sampled = ProfileResampler::hasIncreasingTimes(path);
+  const double profileStep = period * scale;
+  const auto countSteps = [&](const std::vector<squiggles::ProfilePoint> &iprofile) {
+    if (!sampled) {
+      return iprofile.size();
+    }
+    return static_cast<std::size_t>(
+             (iprofile.back().time - iprofile.front().time) / profileStep + 1e-3) +
+           1;
+  };
+
+  std::uint64_t followId;
+  {
+    std::scoped_lock lock(feedbackMutex);
+    followId = ++replanContext.followId;
+    replanContext.active = true;
+    replanContext.hasPose = false;
+    replanContext.goal = path.back().vector.pose;
+    replanContext.step = 0;
+    replannedPath = nullptr;
+  }
+
+  // A replanned profile replaces the path in place, so the robot never stops in between
+  const std::vector<squiggles::ProfilePoint> *profile = &path;
+  std::shared_ptr<const std::vector<squiggles::ProfilePoint>> replanned;
+  std::size_t steps = countSteps(path);
+  std::size_t step = 0;
+  std::size_t segment = 0;
+  followProfile(
+    [&](squiggles::ProfilePoint &opoint) {
+      if (replanReady.exchange(false, std::memory_order_acq_rel)) {
+        std::scoped_lock lock(feedbackMutex);
+        if (replannedPath && replannedFollowId == followId &&
+            ProfileResampler::hasIncreasingTimes(*replannedPath) == sampled) {
+          replanned = std::move(replannedPath);
+          profile = replanned.get();
+          steps = countSteps(*profile);
+          // Skip the part of the new profile the robot drove while it was being generated
+          step = replanContext.step - replannedStep;
+          segment = 0;
+        }
+        replannedPath = nullptr;
+      }
+
+      if (step >= steps) {
+        return false;
+      }
+
+      if (sampled) {
+        const double time = profile->front().time + step * profileStep;
+        opoint = ProfileResampler::sample(*profile, time, segment, interpolation);
+      } else {
+        opoint = (*profile)[step];
+      }
 
-    const auto segDT = DT * second;
-    const auto leftRPM = convertLinearToRotational(path[i].wheel_velocities[0] * mps).convert(rpm);
-    const auto rightRPM = convertLinearToRotational(path[i].wheel_velocities[1] * mps).convert(rpm);
+      ++step;
+      return true;
+    },
+    (sampled ? period : DT / scale) * second,
+    rate);
+
+  std::scoped_lock lock(feedbackMutex);
+  replanContext.active = false;
+  replannedPath = nullptr;
+}
+
+std::unique_ptr<std::istream>
+AsyncMotionProfileController::openStreamedPath(const std::string &idirectory,
+                                               const std::string &ipathId) {
+  return std::make_unique<std::ifstream>(makeFilePath(idirectory, ipathId + ".bin"),
+                                         std::ifstream::in | std::ifstream::binary);
+}
 
-    const double rightSpeed = rightRPM / toUnderlyingType(pair.internalGearset) * reversed;
-    const double leftSpeed = leftRPM / toUnderlyingType(pair.internalGearset) * reversed;
-    if (followMirrored) {
-      model->left(rightSpeed);
-      model->right(leftSpeed);
+void AsyncMotionProfileController::executeStreamedPath(PathStreamReader &ireader,
+                                                       AbstractRate &rate) {
+  const double scale = activeSpeedScale.load(std::memory_order_acquire);
+  const auto interpolation = profileInterpolation.load(std::memory_order_acquire);
+  const double period = commandPeriod.load(std::memory_order_acquire);
+
+  // Only a window of the points around the current time is kept. With the point before the
+  // sample time second in the window, it holds every point the interpolation looks at.
+  constexpr std::size_t windowSize = 4;
+  std::vector<squiggles::ProfilePoint> window;
+  squiggles::ProfilePoint point;
+  while (window.size() < windowSize && ireader.next(point)) {
+    window.push_back(std::move(point));
+  }
+
+  bool streamEnded = window.size() < windowSize;
+  const bool sampled = ProfileResampler::hasIncreasingTimes(window);
+  const double profileStep = period * scale;
+  std::size_t step = 0;
+
+  if (!sampled) {
+    // Follow the points in the order they are read, like executeSinglePath()
+    followProfile(
+      [&](squiggles::ProfilePoint &opoint) {
+        if (step < window.size()) {
+          opoint = window[step++];
+          return true;
+        }
+        return ireader.next(opoint);
+      },
+      DT / scale * second,
+      rate);
+    return;
+  }
+
+  const double startTime = window.front().time;
+  followProfile(
+    [&](squiggles::ProfilePoint &opoint) {
+      const double time = startTime + step * profileStep;
+      while (!streamEnded && window[2].time <= time + ProfileResampler::timeEpsilon) {
+        if (ireader.next(point)) {
+          window.erase(window.begin());
+          window.push_back(std::move(point));
+        } else {
+          streamEnded = true;
+        }
+      }
+
+      // Stop at the same sample executeSinglePath() would
+      if (streamEnded && time > window.back().time + profileStep * 1e-3) {
+        return false;
+      }
+
+      std::size_t segment = 0;
+      opoint = ProfileResampler::sample(window, time, segment, interpolation);
+      ++step;
+      return true;
+    },
+    period * second,
+    rate);
+}
+
+void AsyncMotionProfileController::followProfile(
+  const std::function<bool(squiggles::ProfilePoint &)> &inextPoint,
+  const QTime &isegmentTime,
+  AbstractRate &rate) {
+  const int reversed = activeDirection.load(std::memory_order_acquire);
+  const bool followMirrored = activeMirrored.load(std::memory_order_acquire);
+  const double scale = activeSpeedScale.load(std::memory_order_acquire);
+
+  feedbackMutex.lock();
+  const auto feedbackOdometry = odometry;
+  const double b = ramseteB;
+  const double zeta = ramseteZeta;
+  const auto feedbackMpc = mpc;
+  activeFeedforward = feedforward;
+  lastError = PathfinderPoint{0_m, 0_m, 0_deg};
+  feedbackMutex.unlock();
+
+  squiggles::ProfilePoint point;
+  if (isDisabled() || !inextPoint(point)) {
+    return;
+  }
+
+  // The wheel accelerations for the feedforward. The robot starts at rest.
+  const double segmentTime = isegmentTime.convert(second);
+  double lastLeftVel = 0;
+  double lastRightVel = 0;
+
+  if (!feedbackOdometry) {
+    do {
+      const double leftVel = point.wheel_velocities[0] * scale;
+      const double rightVel = point.wheel_velocities[1] * scale;
+      setWheelVelocities(leftVel,
+                         rightVel,
+                         reversed,
+                         followMirrored,
+                         (leftVel - lastLeftVel) / segmentTime,
+                         (rightVel - lastRightVel) / segmentTime);
+      lastLeftVel = leftVel;
+      lastRightVel = rightVel;
+      rate.delayUntil(isegmentTime);
+    } while (!isDisabled() && inextPoint(point));
+    return;
+  }
+
+  // The profile and the robot are both tracked relative to where they start so the path can be
+  // followed from wherever the robot is
+  const auto pathStart = point.vector.pose;
+  const auto robotStart = odomStateToPose(feedbackOdometry->getState());
+  const double halfTrack = scales.wheelTrack.convert(meter) / 2;
+  const double angularSign = followMirrored ? -reversed : reversed;
+  if (feedbackMpc) {
+    feedbackMpc->reset();
+  }
+
+  do {
+    // Following the profile backwards negates x and heading, mirroring it negates y and heading
+    auto desired = relativePose(pathStart, point.vector.pose);
+    desired.x *= reversed;
+    desired.y *= followMirrored ? -1 : 1;
+    desired.yaw *= angularSign;
+
+    const double leftVel = point.wheel_velocities[0] * scale;
+    const double rightVel = point.wheel_velocities[1] * scale;
+    const double desiredVel = (leftVel + rightVel) / 2 * reversed;
+    const double desiredAngularVel = (rightVel - leftVel) / (2 * halfTrack) * angularSign;
+
+    const auto actual = relativePose(robotStart, odomStateToPose(feedbackOdometry->getState()));
+    const auto errorInRobotFrame = relativePose(actual, desired);
+
+    double vel = 0;
+    double angularVel = 0;
+    if (feedbackMpc) {
+      const auto [left, right] = feedbackMpc->step(errorInRobotFrame.x,
+                                                   errorInRobotFrame.y,
+                                                   errorInRobotFrame.yaw,
+                                                   desiredVel,
+                                                   desiredAngularVel);
+      vel = (left + right) / 2;
+      angularVel = (right - left) / (2 * halfTrack);
     } else {
-      model->left(leftSpeed);
-      model->right(rightSpeed);
+      std::tie(vel, angularVel) =
+        computeRamseteVelocities(desired, desiredVel, desiredAngularVel, actual, b, zeta);
     }
 
-    // Unlock before the delay to be nice to other tasks
-    currentPathMutex.unlock();
+    // Report the error in the robot frame with the okapi conventions (+y right, clockwise angles)
+    feedbackMutex.lock();
+    lastError = PathfinderPoint{
+      errorInRobotFrame.x * meter, -errorInRobotFrame.y * meter, -errorInRobotFrame.yaw * radian};
+    // Undo the direction and mirroring to get where the robot is along the path, for replan()
+    replanContext.robotPose = absolutePose(
+      pathStart,
+      squiggles::Pose(
+        actual.x * reversed, actual.y * (followMirrored ? -1 : 1), actual.yaw * angularSign));
+    replanContext.velocity = vel * reversed / scale;
+    replanContext.hasPose = true;
+    replanContext.step++;
+    feedbackMutex.unlock();
+
+    // The direction and mirroring are already part of the corrected velocities, but not of the
+    // accelerations along the profile
+    const double leftAccel = (leftVel - lastLeftVel) / segmentTime * reversed;
+    const double rightAccel = (rightVel - lastRightVel) / segmentTime * reversed;
+    lastLeftVel = leftVel;
+    lastRightVel = rightVel;
+    setWheelVelocities(vel - angularVel * halfTrack,
+                       vel + angularVel * halfTrack,
+                       1,
+                       false,
+                       followMirrored ? rightAccel : leftAccel,
+                       followMirrored ? leftAccel : rightAccel);
+    rate.delayUntil(isegmentTime);
+  } while (!isDisabled() && inextPoint(point));
+}
+
+std::pair<double, double>
+AsyncMotionProfileController::computeRamseteVelocities(const squiggles::Pose &idesired,
+                                                       const double idesiredVel,
+                                                       const double idesiredAngularVel,
+                                                       const squiggles::Pose &iactual,
+                                                       const double ib,
+                                                       const double izeta) {
+  const auto error = relativePose(iactual, idesired);
+  const double headingError = std::remainder(error.yaw, 2 * pi);
+
+  const double k =
+    2 * izeta * std::sqrt(idesiredAngularVel * idesiredAngularVel + ib * idesiredVel * idesiredVel);
+
+  // sin(x) / x approaches 1 as x approaches 0
+  const double sinc = std::abs(headingError) < 1e-9 ? 1 : std::sin(headingError) / headingError;
+
+  return {idesiredVel * std::cos(headingError) + k * error.x,
+          idesiredAngularVel + k * headingError + ib * idesiredVel * sinc * error.y};
+}
+
+squiggles::Pose AsyncMotionProfileController::relativePose(const squiggles::Pose &iorigin,
+                                                           const squiggles::Pose &ipose) {
+  const double dx = ipose.x - iorigin.x;
+  const double dy = ipose.y - iorigin.y;
+  const double c = std::cos(iorigin.yaw);
+  const double s = std::sin(iorigin.yaw);
+  return squiggles::Pose(c * dx + s * dy, -s * dx + c * dy, ipose.yaw - iorigin.yaw);
+}
+
+squiggles::Pose AsyncMotionProfileController::absolutePose(const squiggles::Pose &iorigin,
+                                                           const squiggles::Pose &irelative) {
+  const double c = std::cos(iorigin.yaw);
+  const double s = std::sin(iorigin.yaw);
+  return squiggles::Pose(iorigin.x + c * irelative.x - s * irelative.y,
+                         iorigin.y + s * irelative.x + c * irelative.y,
+                         iorigin.yaw + irelative.yaw);
+}
+
+PathfinderPoint AsyncMotionProfileController::poseToWaypoint(const squiggles::Pose &ipose) {
+  // The inverse of how generatePath() converts waypoints
+  return PathfinderPoint{ipose.y * meter, ipose.x * meter, 90_deg - ipose.yaw * radian};
+}
 
-    rate->delayUntil(segDT);
+squiggles::Pose AsyncMotionProfileController::odomStateToPose(const OdomState &istate) {
+  // This matches how generatePath() converts waypoints
+  return squiggles::Pose(
+    istate.y.convert(meter), istate.x.convert(meter), (90_deg - istate.theta).convert(radian));
+}
+
+void AsyncMotionProfileController::setProfileDecimation(const std::size_t istride,
+                                                       const double imaxCurvatureChange) {
+  if (istride == 0) {
+    std::string msg("AsyncMotionProfileController: The decimation stride must be at least one.");
+    LOG_ERROR(msg);
+    throw std::invalid_argument(msg);
+  }
+
+  LOG_INFO("AsyncMotionProfileController: Set profile decimation stride to " +
+           std::to_string(istride));
+
+  std::scoped_lock lock(currentPathMutex);
+  decimationStride = istride;
+  decimationCurvatureChange = imaxCurvatureChange;
+
+  // The remembered moveTo() profiles were stored with the old settings
+  moveToProfiles.clear();
+}
+
+void AsyncMotionProfileController::setProfileRetimer(
+  const std::optional<ProfileRetimer> &iretimer) {
+  LOG_INFO_S(iretimer ? "AsyncMotionProfileController: Retiming paths to the drive motors"
+                      : "AsyncMotionProfileController: Not retiming paths");
+
+  std::scoped_lock lock(currentPathMutex);
+  profileRetimer = iretimer;
+
+  // The remembered moveTo() profiles were stored with the old settings
+  moveToProfiles.clear();
+}
+
+void AsyncMotionProfileController::setMaxCentripetalAcceleration(const QAcceleration imaxAccel) {
+  if (!(imaxAccel > 0_mps2)) {
+    std::string msg(
+      "AsyncMotionProfileController: The max centripetal acceleration must be positive.");
+    LOG_ERROR(msg);
+    throw std::invalid_argument(msg);
+  }
+
+  LOG_INFO("AsyncMotionProfileController: Set max centripetal acceleration to " +
+           std::to_string(imaxAccel.convert(mps2)) + " m/s^2");
+
+  std::scoped_lock lock(currentPathMutex);
+  maxCentripetalAccel = imaxAccel.convert(mps2);
+
+  // The remembered moveTo() profiles were stored with the old settings
+  moveToProfiles.clear();
+}
+
+void AsyncMotionProfileController::setCoprocessor(
+  const std::shared_ptr<CoprocessorClient> &icoprocessor) {
+  LOG_INFO_S(icoprocessor ? "AsyncMotionProfileController: Generating paths on the coprocessor"
+                          : "AsyncMotionProfileController: Generating paths on the brain");
+
+  std::scoped_lock lock(currentPathMutex);
+  coprocessor = icoprocessor;
+}
+
+void AsyncMotionProfileController::setProfileInterpolation(
+  const ProfileInterpolation iinterpolation) {
+  profileInterpolation.store(iinterpolation, std::memory_order_release);
+}
+
+void AsyncMotionProfileController::setCommandPeriod(const QTime &iperiod) {
+  if (iperiod <= 0_ms) {
+    std::string msg("AsyncMotionProfileController: The command period must be positive.");
+    LOG_ERROR(msg);
+    throw std::invalid_argument(msg);
+  }
+
+  LOG_INFO("AsyncMotionProfileController: Set command period to " +
+           std::to_string(iperiod.convert(millisecond)) + " ms");
+
+  commandPeriod.store(iperiod.convert(second), std::memory_order_release);
+}
+
+void AsyncMotionProfileController::setOdometry(const std::shared_ptr<Odometry> &iodometry,
+                                               const double ib,
+                                               const double izeta) {
+  std::scoped_lock lock(feedbackMutex);
+  odometry = iodometry;
+  ramseteB = ib;
+  ramseteZeta = izeta;
+}
+
+void AsyncMotionProfileController::setModelPredictiveControl(const DiffDriveMpcParams &iparams) {
+  // The wheels are at their max velocity at a normalized command of 1
+  auto newMpc = std::make_shared<DiffDriveMpc>(
+    scales.wheelTrack, (1 / motorCommandPerMps) * mps, iparams, logger);
+
+  std::scoped_lock lock(feedbackMutex);
+  mpc = std::move(newMpc);
+}
+
+void AsyncMotionProfileController::clearModelPredictiveControl() {
+  std::scoped_lock lock(feedbackMutex);
+  mpc = nullptr;
+}
+
+void AsyncMotionProfileController::setFeedforward(const MotorFeedforward &ifeedforward) {
+  std::scoped_lock lock(feedbackMutex);
+  feedforward = ifeedforward;
+}
+
+MotorFeedforward AsyncMotionProfileController::getFeedforward() const {
+  std::scoped_lock lock(feedbackMutex);
+  return feedforward;
+}
+
+void AsyncMotionProfileController::setTrackingRecorder(
+  const std::shared_ptr<PathTrackingRecorder> &irecorder) {
+  std::scoped_lock lock(feedbackMutex);
+  trackingRecorder = irecorder;
+}
+
+void AsyncMotionProfileController::executeStaticPath(const StaticProfilePoint *ipoints,
+                                                     const std::size_t icount,
+                                                     AbstractRate &rate) {
+  const int reversed = activeDirection.load(std::memory_order_acquire);
+  const bool followMirrored = activeMirrored.load(std::memory_order_acquire);
+  const double scale = activeSpeedScale.load(std::memory_order_acquire);
+
+  feedbackMutex.lock();
+  activeFeedforward = feedforward;
+  feedbackMutex.unlock();
+
+  // The points are read-only and owned by the caller, so there is nothing to lock here
+  const double segmentTime = DT / scale;
+  double lastLeftVel = 0;
+  double lastRightVel = 0;
+  for (std::size_t i = 0; i < icount && !isDisabled(); ++i) {
+    const double leftVel = ipoints[i].leftVelocity * scale;
+    const double rightVel = ipoints[i].rightVelocity * scale;
+    setWheelVelocities(leftVel,
+                       rightVel,
+                       reversed,
+                       followMirrored,
+                       (leftVel - lastLeftVel) / segmentTime,
+                       (rightVel - lastRightVel) / segmentTime);
+    lastLeftVel = leftVel;
+    lastRightVel = rightVel;
+    rate.delayUntil(segmentTime * second);
+  }
+}
+
+void AsyncMotionProfileController::setWheelVelocities(const double ileftVelocity,
+                                                      const double irightVelocity,
+                                                      const int ireversed,
+                                                      const bool imirrored,
+                                                      const double ileftAcceleration,
+                                                      const double irightAcceleration) {
+  if (activeTrackingRecorder) {
+    // Record the velocity each side is commanded, after the direction and mirroring
+    const double left = (imirrored ? irightVelocity : ileftVelocity) * ireversed;
+    const double right = (imirrored ? ileftVelocity : irightVelocity) * ireversed;
+    activeTrackingRecorder->record(convertLinearToRotational(left * mps).convert(rpm),
+                                   convertLinearToRotational(right * mps).convert(rpm));
+  }
+
+  if (activeFeedforward.isEnabled()) {
+    double leftVoltage =
+      activeFeedforward.calculate(ileftVelocity * ireversed, ileftAcceleration * ireversed);
+    double rightVoltage =
+      activeFeedforward.calculate(irightVelocity * ireversed, irightAcceleration * ireversed);
+    if (imirrored) {
+      std::swap(leftVoltage, rightVoltage);
+    }
+
+    // driveVectorVoltage drives the left side with forward + yaw and the right with forward - yaw
+    model->driveVectorVoltage((leftVoltage + rightVoltage) / 2, (leftVoltage - rightVoltage) / 2);
+    return;
+  }
+
+  const double leftSpeed = ileftVelocity * motorCommandPerMps * ireversed;
+  const double rightSpeed = irightVelocity * motorCommandPerMps * ireversed;
+  if (imirrored) {
+    model->left(rightSpeed);
+    model->right(leftSpeed);
+  } else {
+    model->left(leftSpeed);
+    model->right(rightSpeed);
   }
 }
 
 QAngularSpeed AsyncMotionProfileController::convertLinearToRotational(QSpeed linear) const {
-  return (linear * (360_deg / (scales.wheelDiameter * 1_pi))) * pair.ratio;
+  return linear.convert(mps) * scales.getMotorRpmPerMps(pair) * rpm;
+}
+
+void AsyncMotionProfileController::wakeTask() {
+  if (task) {
+    task->notify();
+  }
 }
 
 void AsyncMotionProfileController::trampoline(void *context) {
@@ -244,9 +1511,11 @@ void AsyncMotionProfileController::trampoline(void *context) {
 void AsyncMotionProfileController::waitUntilSettled() {
   LOG_INFO_S("AsyncMotionProfileController: Waiting to settle");
 
-  auto rate = timeUtil.getRate();
+  // The controller task notifies settledEvent when it settles. The timeout is only a fallback.
+  auto generation = settledEvent.getGeneration();
   while (!isSettled()) {
-    rate->delayUntil(10_ms);
+    settledEvent.waitFor(generation, settledWaitTimeout);
+    generation = settledEvent.getGeneration();
   }
 
   LOG_INFO_S("AsyncMotionProfileController: Done waiting to settle");
@@ -262,16 +1531,80 @@ void AsyncMotionProfileController::moveTo(std::initializer_list<PathfinderPoint>
                                           const PathfinderLimits &ilimits,
                                           const bool ibackwards,
                                           const bool imirrored) {
-  static int moveToCount = 0;
-  std::string name = "__moveTo" + std::to_string(moveToCount++);
-  generatePath(iwaypoints, name, ilimits);
-  setTarget(name, ibackwards, imirrored);
+  moveTo(std::vector<PathfinderPoint>(iwaypoints), ilimits, ibackwards, imirrored);
+}
+
+void AsyncMotionProfileController::moveTo(const std::vector<PathfinderPoint> &iwaypoints,
+                                          const bool ibackwards,
+                                          const bool imirrored) {
+  moveTo(iwaypoints, limits, ibackwards, imirrored);
+}
+
+void AsyncMotionProfileController::moveTo(const std::vector<PathfinderPoint> &iwaypoints,
+                                          const PathfinderLimits &ilimits,
+                                          const bool ibackwards,
+                                          const bool imirrored) {
+  if (iwaypoints.empty()) {
+    // No point in generating a path
+    LOG_WARN_S("AsyncMotionProfileController: Not moving because no waypoints were given.");
+    return;
+  }
+
+  insertPath(moveToPathId, getMoveToProfile(iwaypoints, ilimits));
+  setTarget(moveToPathId, ibackwards, imirrored);
   waitUntilSettled();
-  forceRemovePath(name);
+  forceRemovePath(moveToPathId);
+}
+
+std::shared_ptr<const std::vector<squiggles::ProfilePoint>>
+AsyncMotionProfileController::getMoveToProfile(const std::vector<PathfinderPoint> &iwaypoints,
+                                               const PathfinderLimits &ilimits) {
+  std::vector<double> key;
+  {
+    std::scoped_lock lock(currentPathMutex);
+
+    // Compare the exact values instead of a hash so different moves can never share a profile.
+    // The key is built in a buffer which keeps its capacity, so only a new profile allocates.
+    moveToKey.clear();
+    for (const auto &point : iwaypoints) {
+      moveToKey.push_back(point.x.convert(meter));
+      moveToKey.push_back(point.y.convert(meter));
+      moveToKey.push_back(point.theta.convert(radian));
+    }
+    moveToKey.push_back(ilimits.maxVel);
+    moveToKey.push_back(ilimits.maxAccel);
+    moveToKey.push_back(ilimits.maxJerk);
+    moveToKey.push_back(scales.wheelTrack.convert(meter));
+
+    auto it = std::find_if(moveToProfiles.begin(), moveToProfiles.end(), [&](const auto &entry) {
+      return entry.first == moveToKey;
+    });
+
+    if (it != moveToProfiles.end()) {
+      LOG_DEBUG_S("AsyncMotionProfileController: Reusing a profile from a previous moveTo");
+      // Move the entry to the front without copying its key
+      std::rotate(moveToProfiles.begin(), it, std::next(it));
+      return moveToProfiles.front().second;
+    }
+
+    key = moveToKey;
+  }
+
+  // Generate without holding the lock because it can take a long time
+  auto profile = pathPool->store(generateProfile(iwaypoints, ilimits));
+
+  std::scoped_lock lock(currentPathMutex);
+  moveToProfiles.emplace_front(std::move(key), profile);
+  if (moveToProfiles.size() > moveToProfileCapacity) {
+    moveToProfiles.pop_back();
+  }
+
+  return profile;
 }
 
 PathfinderPoint AsyncMotionProfileController::getError() const {
-  return PathfinderPoint{0_m, 0_m, 0_deg};
+  std::scoped_lock lock(feedbackMutex);
+  return lastError;
 }
 
 bool AsyncMotionProfileController::isSettled() {
@@ -284,9 +1617,10 @@ void AsyncMotionProfileController::reset() {
 
   LOG_INFO_S("AsyncMotionProfileController: Waiting to reset");
 
-  auto rate = timeUtil.getRate();
+  auto generation = settledEvent.getGeneration();
   while (isRunning.load(std::memory_order_acquire)) {
-    rate->delayUntil(1_ms);
+    settledEvent.waitFor(generation, settledWaitTimeout);
+    generation = settledEvent.getGeneration();
   }
 
   flipDisable(false);
@@ -299,6 +1633,9 @@ void AsyncMotionProfileController::flipDisable() {
 void AsyncMotionProfileController::flipDisable(const bool iisDisabled) {
   LOG_INFO("AsyncMotionProfileController: flipDisable " + std::to_string(iisDisabled));
   disabled.store(iisDisabled, std::memory_order_release);
+  // Disabling the controller settles it, and enabling it resumes any target
+  settledEvent.notifyAll();
+  wakeTask();
   // loop() will stop the chassis when executeSinglePath() is done
   // the default implementation of executeSinglePath() breaks when disabled
 }
@@ -313,9 +1650,11 @@ void AsyncMotionProfileController::tarePosition() {
 void AsyncMotionProfileController::setMaxVelocity(std::int32_t) {
 }
 
-void AsyncMotionProfileController::startThread() {
+void AsyncMotionProfileController::startThread(const std::uint32_t ipriority,
+                                               const std::uint16_t istackDepth) {
   if (!task) {
-    task = new CrossplatformThread(trampoline, this, "AsyncMotionProfileController");
+    task = new CrossplatformThread(
+      trampoline, this, "AsyncMotionProfileController", ipriority, istackDepth);
   }
 }
 
@@ -337,11 +1676,50 @@ void AsyncMotionProfileController::storePath(const std::string &idirectory,
 
   internalStorePath(file, ipathId);
 
+  if (file.good()) {
+    setPathSource(ipathId, idirectory);
+  }
+
   file.close();
 }
 
-void AsyncMotionProfileController::loadPath(const std::string &idirectory,
-                                            const std::string &ipathId) {
+void AsyncMotionProfileController::storeBinaryPath(const std::string &idirectory,
+                                                   const std::string &ipathId,
+                                                   const bool icompact) {
+  std::string filePath = makeFilePath(idirectory, ipathId + ".bin");
+  std::ofstream file;
+  file.open(filePath, std::ofstream::out | std::ofstream::binary);
+
+  // Make sure we can open the file successfully
+  if (!file.good()) {
+    LOG_WARN("AsyncMotionProfileController: Couldn't open file " + filePath + " for writing");
+    return;
+  }
+
+  const bool written = internalStoreBinaryPath(file, ipathId, icompact);
+
+  if (written && file.good()) {
+    setPathSource(ipathId, idirectory);
+  }
+
+  file.close();
+}
+
+PathHandle AsyncMotionProfileController::loadPath(const std::string &idirectory,
+                                                  const std::string &ipathId) {
+  std::string binaryPath = makeFilePath(idirectory, ipathId + ".bin");
+  std::ifstream binaryPathFile;
+  binaryPathFile.open(binaryPath, std::ifstream::in | std::ifstream::binary);
+  if (binaryPathFile.good()) {
+    // give preference to a binary path because it is the fastest to load
+    const bool loaded = internalLoadBinaryPath(binaryPathFile, ipathId);
+    binaryPathFile.close();
+    if (loaded) {
+      setPathSource(ipathId, idirectory);
+      return getPathHandle(ipathId);
+    }
+  }
+
   std::string squigglesPath = makeFilePath(idirectory, ipathId + ".csv");
   std::ifstream squigglesPathFile;
   squigglesPathFile.open(squigglesPath, std::ifstream::in);
@@ -349,7 +1727,8 @@ void AsyncMotionProfileController::loadPath(const std::string &idirectory,
     // give preference to a squiggles path stored for this id
     internalLoadPath(squigglesPathFile, ipathId);
     squigglesPathFile.close();
-    return;
+    setPathSource(ipathId, idirectory);
+    return getPathHandle(ipathId);
   }
 
   // There's no Squiggles path, let's check for Pathfinder files
@@ -362,43 +1741,143 @@ void AsyncMotionProfileController::loadPath(const std::string &idirectory,
     internalLoadPathfinderPath(leftPathFile, rightPathFile, ipathId);
     leftPathFile.close();
     rightPathFile.close();
+    setPathSource(ipathId, idirectory);
+    return getPathHandle(ipathId);
   } else {
     // we don't have both pathfinder files available, check if there's one
     if (rightPathFile.good()) {
       LOG_WARN("AsyncMotionProfileController: Couldn't open file " + leftFilePath + " for reading");
       rightPathFile.close();
-      return;
+      return PathHandle();
     }
     if (leftPathFile.good()) {
       LOG_WARN("AsyncMotionProfileController: Couldn't open file " + rightFilePath +
                " for reading");
       leftPathFile.close();
-      return;
+      return PathHandle();
     }
     LOG_WARN("AsyncMotionProfileController: Couldn't find any path files for id " + ipathId);
+    return PathHandle();
   }
 }
 
 void AsyncMotionProfileController::internalStorePath(std::ostream &file,
                                                      const std::string &ipathId) {
-  auto pathData = this->paths.find(ipathId);
+  const auto path = getPathData(ipathId);
 
   // Make sure path exists
-  if (pathData == paths.end()) {
+  if (!path) {
     LOG_WARN("AsyncMotionProfileController: Controller was asked to serialize non-existent path " +
              ipathId);
     // Do nothing- can't serialize nonexistent path
   } else {
-    squiggles::serialize_path(file, pathData->second);
+    squiggles::serialize_path(file, *path);
   }
 }
 
+bool AsyncMotionProfileController::internalStoreBinaryPath(std::ostream &file,
+                                                           const std::string &ipathId,
+                                                           const bool icompact) {
+  const auto path = getPathData(ipathId);
+
+  // Make sure path exists
+  if (!path) {
+    LOG_WARN("AsyncMotionProfileController: Controller was asked to serialize non-existent path " +
+             ipathId);
+    return false;
+  }
+
+  if (!(icompact ? PathBinaryFormat::serializeCompact(file, *path)
+                 : PathBinaryFormat::serialize(file, *path))) {
+    LOG_WARN("AsyncMotionProfileController: Failed to write binary path " + ipathId);
+    return false;
+  }
+
+  return true;
+}
+
+bool AsyncMotionProfileController::internalLoadBinaryPath(std::istream &file,
+                                                          const std::string &ipathId) {
+  auto path = PathBinaryFormat::deserialize(file);
+  if (!path) {
+    LOG_WARN("AsyncMotionProfileController: Binary path file for " + ipathId +
+             " is invalid or has an unsupported version");
+    return false;
+  }
+
+  insertPath(ipathId, std::move(path.value()));
+  return true;
+}
+
+std::size_t AsyncMotionProfileController::loadPathLibrary(const std::string &idirectory) {
+  auto file = openPathLibrary(idirectory);
+  if (!file || !file->good()) {
+    LOG_WARN("AsyncMotionProfileController: Couldn't open the path library in " + idirectory);
+    return 0;
+  }
+
+  return internalLoadPathLibrary(*file, idirectory);
+}
+
+PathGenerationHandle
+AsyncMotionProfileController::loadPathLibraryAsync(const std::string &idirectory) {
+  auto status = std::make_shared<std::atomic<PathGenerationStatus>>(PathGenerationStatus::queued);
+
+  {
+    std::scoped_lock lock(generationMutex);
+    PathGenerationJob job{{}, idirectory, limits, status};
+    job.isLibrary = true;
+    generationQueue.push_back(std::move(job));
+    pendingLibraries++;
+    startGeneratorTask();
+  }
+  generationEvent.notifyAll();
+
+  LOG_INFO("AsyncMotionProfileController: Queued the path library in " + idirectory +
+           " for loading");
+  return PathGenerationHandle(makeFilePath(idirectory, PathBinaryFormat::libraryFileName),
+                              status);
+}
+
+std::unique_ptr<std::istream>
+AsyncMotionProfileController::openPathLibrary(const std::string &idirectory) {
+  return std::make_unique<std::ifstream>(
+    makeFilePath(idirectory, PathBinaryFormat::libraryFileName),
+    std::ifstream::in | std::ifstream::binary);
+}
+
+std::size_t AsyncMotionProfileController::internalLoadPathLibrary(std::istream &file,
+                                                                  const std::string &idirectory) {
+  const auto pathCount = PathBinaryFormat::readLibraryHeader(file);
+  if (!pathCount) {
+    LOG_WARN("AsyncMotionProfileController: The path library in " + idirectory +
+             " is invalid or has an unsupported version");
+    return 0;
+  }
+
+  std::size_t loaded = 0;
+  for (; loaded < *pathCount; ++loaded) {
+    auto entry = PathBinaryFormat::readLibraryEntry(file);
+    if (!entry) {
+      LOG_WARN("AsyncMotionProfileController: The path library in " + idirectory +
+               " is truncated after " + std::to_string(loaded) + " of " +
+               std::to_string(*pathCount) + " paths");
+      break;
+    }
+
+    insertPath(entry->first, std::move(entry->second));
+  }
+
+  LOG_INFO("AsyncMotionProfileController: Loaded " + std::to_string(loaded) +
+           " paths from the path library in " + idirectory);
+  return loaded;
+}
+
 void AsyncMotionProfileController::internalLoadPath(std::istream &file,
                                                     const std::string &ipathId) {
 
   auto path = squiggles::deserialize_path(file);
-  forceRemovePath(ipathId);
-  paths.emplace(ipathId, path.value());
+  insertPath(ipathId, std::move(path.value()));
 }
 
 void AsyncMotionProfileController::internalLoadPathfinderPath(std::istream &leftFile,
@@ -406,8 +1885,7 @@ void AsyncMotionProfileController::internalLoadPathfinderPath(std::istream &left
                                                               const std::string &ipathId) {
 
   auto path = squiggles::deserialize_pathfinder_path(leftFile, rightFile);
-  forceRemovePath(ipathId);
-  paths.emplace(ipathId, path.value());
+  insertPath(ipathId, std::move(path.value()));
 }
 
 std::string AsyncMotionProfileController::makeFilePath(const std::string &directory,
@@ -447,11 +1925,30 @@ std::string AsyncMotionProfileController::makeFilePath(const std::string &direct
   return path;
 }
 
+void AsyncMotionProfileController::registerStreamedPath(const std::string &idirectory,
+                                                        const std::string &ipathId) {
+  std::scoped_lock lock(currentPathMutex);
+  erasePathData(ipathId);
+  forgetCachedPath(ipathId);
+  pathSources.erase(ipathId);
+  staticPaths.erase(ipathId);
+  pathViews.erase(ipathId);
+  streamedPaths.insert_or_assign(ipathId, idirectory);
+
+  LOG_INFO("AsyncMotionProfileController: Registered streamed path " + ipathId + " from " +
+           idirectory);
+}
+
 void AsyncMotionProfileController::forceRemovePath(const std::string &ipathId) {
-  if (!removePath(ipathId)) {
-    LOG_WARN("AsyncMotionProfileController: Disabling controller to remove path " + ipathId);
-    flipDisable(true);
-    removePath(ipathId);
+  removePath(ipathId);
+}
+
+std::shared_ptr<const std::vector<squiggles::ProfilePoint>>
+AsyncMotionProfileController::getPathData(const std::string &ipathId) {
+  std::scoped_lock lock(currentPathMutex);
+  if (auto path = paths.find(ipathId); path != paths.end()) {
+    return path->second;
   }
+  return nullptr;
 }
 } // namespace okapi
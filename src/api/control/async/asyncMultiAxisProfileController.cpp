@@ -0,0 +1,345 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#include "okapi/api/control/async/asyncMultiAxisProfileController.hpp"
+#include "okapi/api/units/QAngularSpeed.hpp"
+#include "okapi/api/units/QSpeed.hpp"
+#include "okapi/api/util/mathUtil.hpp"
+#include "okapi/api/util/taskProfiler.hpp"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <mutex>
+
+namespace okapi {
+AsyncMultiAxisProfileController::AsyncMultiAxisProfileController(
+  const TimeUtil &itimeUtil,
+  std::vector<Axis> iaxes,
+  const std::shared_ptr<Logger> &ilogger)
+  : logger(ilogger),
+    axes(std::move(iaxes)),
+    timeUtil(itimeUtil),
+    pathRate(
+      std::make_unique<ProfiledRate>(timeUtil.getRate(), "AsyncMultiAxisProfileController")) {
+  if (axes.empty()) {
+    std::string msg("AsyncMultiAxisProfileController: There must be at least one axis.");
+    LOG_ERROR(msg);
+    throw std::invalid_argument(msg);
+  }
+
+  motorCommandPerMps.reserve(axes.size());
+  for (std::size_t i = 0; i < axes.size(); i++) {
+    const Axis &axis = axes[i];
+    if (axis.pair.ratio == 0) {
+      std::string msg("AsyncMultiAxisProfileController: The gear ratio of axis " +
+                      std::to_string(i) +
+                      " cannot be zero! Check if you are using integer division.");
+      LOG_ERROR(msg);
+      throw std::invalid_argument(msg);
+    }
+
+    if (!(axis.limits.maxVel > 0) || !(axis.limits.maxAccel > 0)) {
+      std::string msg("AsyncMultiAxisProfileController: The max velocity and max acceleration of "
+                      "axis " +
+                      std::to_string(i) + " must be positive.");
+      LOG_ERROR(msg);
+      throw std::invalid_argument(msg);
+    }
+
+    const QAngularSpeed rotational = (1_mps * (360_deg / (axis.diameter * 1_pi))) * axis.pair.ratio;
+    motorCommandPerMps.push_back(rotational.convert(rpm) /
+                                 toUnderlyingType(axis.pair.internalGearset));
+  }
+}
+
+AsyncMultiAxisProfileController::~AsyncMultiAxisProfileController() {
+  dtorCalled.store(true, std::memory_order_release);
+  wakeTask();
+
+  // A running path is kept alive by the task's own reference
+  currentPathMutex.lock();
+  paths.clear();
+  currentPathMutex.unlock();
+
+  delete task;
+}
+
+void AsyncMultiAxisProfileController::generatePath(const std::vector<QLength> &idistances,
+                                                   const std::string &ipathId) {
+  if (idistances.size() != axes.size()) {
+    std::string msg("AsyncMultiAxisProfileController: Expected " + std::to_string(axes.size()) +
+                    " distances, one per axis, but got " + std::to_string(idistances.size()) +
+                    ".");
+    LOG_ERROR(msg);
+    throw std::invalid_argument(msg);
+  }
+
+  // Every axis moves the same fraction of its distance, so the fraction may only change as fast as
+  // the axis with the least room to spare allows
+  double maxVel = std::numeric_limits<double>::infinity();
+  double maxAccel = std::numeric_limits<double>::infinity();
+  for (std::size_t i = 0; i < axes.size(); i++) {
+    const double distance = std::abs(idistances[i].convert(meter));
+    if (distance > 0) {
+      maxVel = std::min(maxVel, axes[i].limits.maxVel / distance);
+      maxAccel = std::min(maxAccel, axes[i].limits.maxAccel / distance);
+    }
+  }
+
+  if (std::isinf(maxVel)) {
+    LOG_WARN_S("AsyncMultiAxisProfileController: Not generating a path because no axis moves.");
+    return;
+  }
+
+  LOG_INFO_S("AsyncMultiAxisProfileController: Preparing trajectory");
+
+  auto path = std::make_shared<const Path>(
+    Path{idistances,
+         TrapezoidProfile(1, maxVel, maxAccel, std::numeric_limits<double>::infinity(), logger)});
+
+  LOG_DEBUG("AsyncMultiAxisProfileController: Path duration: " +
+            std::to_string(path->progress.getDuration().convert(second)) + " s");
+
+  // A running path with the same ID keeps its own reference to the old path
+  currentPathMutex.lock();
+  paths.insert_or_assign(ipathId, std::move(path));
+  currentPathMutex.unlock();
+
+  LOG_INFO("AsyncMultiAxisProfileController: Completely done generating path " + ipathId);
+}
+
+bool AsyncMultiAxisProfileController::removePath(const std::string &ipathId) {
+  std::scoped_lock lock(currentPathMutex);
+
+  // If this path is running, the controller task still holds a reference to it, so it will be
+  // freed once it is done
+  paths.erase(ipathId);
+  return true;
+}
+
+std::vector<std::string> AsyncMultiAxisProfileController::getPaths() {
+  std::vector<std::string> keys;
+
+  std::scoped_lock lock(currentPathMutex);
+
+  for (const auto &path : paths) {
+    keys.push_back(path.first);
+  }
+
+  return keys;
+}
+
+void AsyncMultiAxisProfileController::setTarget(std::string ipathId) {
+  LOG_INFO("AsyncMultiAxisProfileController: Set target to: " + ipathId);
+
+  currentPathMutex.lock();
+  currentPath = ipathId;
+  currentPathMutex.unlock();
+
+  isRunning.store(true, std::memory_order_release);
+  wakeTask();
+}
+
+void AsyncMultiAxisProfileController::controllerSet(const std::string ivalue) {
+  setTarget(ivalue);
+}
+
+std::string AsyncMultiAxisProfileController::getTarget() {
+  std::scoped_lock lock(currentPathMutex);
+  return currentPath;
+}
+
+std::string AsyncMultiAxisProfileController::getProcessValue() const {
+  std::scoped_lock lock(currentPathMutex);
+  return currentPath;
+}
+
+void AsyncMultiAxisProfileController::loop() {
+  LOG_INFO_S("Started AsyncMultiAxisProfileController task.");
+
+  while (!dtorCalled.load(std::memory_order_acquire)) {
+    if (isRunning.load(std::memory_order_acquire) && !isDisabled()) {
+      currentPathMutex.lock();
+      const std::string pathId = currentPath;
+      currentPathMutex.unlock();
+
+      if (executePath(pathId)) {
+        stopAxes();
+        LOG_INFO_S("AsyncMultiAxisProfileController: Done moving");
+      }
+
+      isRunning.store(false, std::memory_order_release);
+      settledEvent.notifyAll();
+    }
+
+    // Sleep until setTarget() wakes this task. Any other notification means the task which made
+    // this controller was deleted, so stop.
+    if (CrossplatformThread::notifyTake(idleLoopTimeout) & ~CrossplatformThread::wakeNotification) {
+      break;
+    }
+  }
+
+  LOG_INFO_S("Stopped AsyncMultiAxisProfileController task.");
+}
+
+bool AsyncMultiAxisProfileController::executePath(const std::string &ipathId) {
+  LOG_INFO_F("AsyncMultiAxisProfileController: Running with path: %s", ipathId);
+
+  // Take our own reference to the path so it stays valid even if it is removed or replaced
+  // while we follow it
+  std::shared_ptr<const Path> path;
+  currentPathMutex.lock();
+  if (auto it = paths.find(ipathId); it != paths.end()) {
+    path = it->second;
+  }
+  currentProgress.store(0, std::memory_order_release);
+  currentPathMutex.unlock();
+
+  if (!path) {
+    LOG_WARN("AsyncMultiAxisProfileController: Target was set to non-existent path with name: " +
+             ipathId);
+    return false;
+  }
+
+  executeSinglePath(*path, *pathRate);
+  pathRate->reset();
+  return true;
+}
+
+void AsyncMultiAxisProfileController::executeSinglePath(const Path &path, AbstractRate &rate) {
+  // The caller holds a reference to the path for as long as this runs, so there is nothing to lock
+  const QTime duration = path.progress.getDuration();
+  for (QTime time = 0_ms; time < duration && !isDisabled(); time += profilePeriod) {
+    const auto state = path.progress.sample(time);
+    currentProgress.store(state.position, std::memory_order_release);
+
+    // Every axis is written in the same step, so they stay in lockstep
+    for (std::size_t i = 0; i < axes.size(); i++) {
+      const double velocity = path.distances[i].convert(meter) * state.velocity; // m/s
+      axes[i].output->controllerSet(velocity * motorCommandPerMps[i]);
+    }
+
+    rate.delayUntil(profilePeriod);
+  }
+
+  if (!isDisabled()) {
+    currentProgress.store(1, std::memory_order_release);
+  }
+}
+
+void AsyncMultiAxisProfileController::stopAxes() {
+  for (const auto &axis : axes) {
+    axis.output->controllerSet(0);
+  }
+}
+
+void AsyncMultiAxisProfileController::wakeTask() {
+  if (task) {
+    task->notify();
+  }
+}
+
+void AsyncMultiAxisProfileController::trampoline(void *context) {
+  if (context) {
+    static_cast<AsyncMultiAxisProfileController *>(context)->loop();
+  }
+}
+
+void AsyncMultiAxisProfileController::waitUntilSettled() {
+  LOG_INFO_S("AsyncMultiAxisProfileController: Waiting to settle");
+
+  // The controller task notifies settledEvent when it settles. The timeout is only a fallback.
+  auto generation = settledEvent.getGeneration();
+  while (!isSettled()) {
+    settledEvent.waitFor(generation, settledWaitTimeout);
+    generation = settledEvent.getGeneration();
+  }
+
+  LOG_INFO_S("AsyncMultiAxisProfileController: Done waiting to settle");
+}
+
+void AsyncMultiAxisProfileController::moveTo(const std::vector<QLength> &idistances) {
+  static int moveToCount = 0;
+  std::string name = "__moveTo" + std::to_string(moveToCount++);
+  generatePath(idistances, name);
+  setTarget(name);
+  waitUntilSettled();
+  removePath(name);
+}
+
+std::vector<QLength> AsyncMultiAxisProfileController::getError() const {
+  std::vector<QLength> error(axes.size(), 0_m);
+
+  std::scoped_lock lock(currentPathMutex);
+  if (!isRunning.load(std::memory_order_acquire)) {
+    return error;
+  }
+
+  const auto it = paths.find(currentPath);
+  if (it == paths.end()) {
+    return error;
+  }
+
+  const double remaining = 1 - currentProgress.load(std::memory_order_acquire);
+  for (std::size_t i = 0; i < axes.size(); i++) {
+    error[i] = it->second->distances[i] * remaining;
+  }
+
+  return error;
+}
+
+bool AsyncMultiAxisProfileController::isSettled() {
+  return isDisabled() || !isRunning.load(std::memory_order_acquire);
+}
+
+void AsyncMultiAxisProfileController::reset() {
+  // Interrupt executeSinglePath() by disabling the controller
+  flipDisable(true);
+
+  LOG_INFO_S("AsyncMultiAxisProfileController: Waiting to reset");
+
+  auto generation = settledEvent.getGeneration();
+  while (isRunning.load(std::memory_order_acquire)) {
+    settledEvent.waitFor(generation, settledWaitTimeout);
+    generation = settledEvent.getGeneration();
+  }
+
+  flipDisable(false);
+}
+
+void AsyncMultiAxisProfileController::flipDisable() {
+  flipDisable(!disabled.load(std::memory_order_acquire));
+}
+
+void AsyncMultiAxisProfileController::flipDisable(const bool iisDisabled) {
+  LOG_INFO("AsyncMultiAxisProfileController: flipDisable " + std::to_string(iisDisabled));
+  disabled.store(iisDisabled, std::memory_order_release);
+  // Disabling the controller settles it, and loop() stops the axes once the path is interrupted
+  settledEvent.notifyAll();
+  wakeTask();
+}
+
+bool AsyncMultiAxisProfileController::isDisabled() const {
+  return disabled.load(std::memory_order_acquire);
+}
+
+void AsyncMultiAxisProfileController::startThread(const std::uint32_t ipriority,
+                                                  const std::uint16_t istackDepth) {
+  if (!task) {
+    task = new CrossplatformThread(
+      trampoline, this, "AsyncMultiAxisProfileController", ipriority, istackDepth);
+  }
+}
+
+CrossplatformThread *AsyncMultiAxisProfileController::getThread() const {
+  return task;
+}
+
+void AsyncMultiAxisProfileController::tarePosition() {
+}
+
+void AsyncMultiAxisProfileController::setMaxVelocity(std::int32_t) {
+}
+} // namespace okapi
@@ -18,7 +18,8 @@ AsyncPosIntegratedController::AsyncPosIntegratedController(
     motor(imotor),
     pair(ipair),
     maxVelocity(imaxVelocity),
-    settledUtil(itimeUtil.getSettledUtil()) {
+    settledUtil(itimeUtil.getSettledUtil()),
+    waitRate(itimeUtil.getRate()) {
   if (ipair.ratio == 0) {
     std::string msg("AsyncPosIntegratedController: The gear ratio cannot be zero! Check if you are "
                     "using integer division.");
@@ -39,6 +40,7 @@ void AsyncPosIntegratedController::setTarget(const double itarget) {
   }
 
   lastTarget = itarget;
+  settleTracker.reset();
 }
 
 double AsyncPosIntegratedController::getTarget() {
@@ -54,13 +56,26 @@ double AsyncPosIntegratedController::getError() const {
 }
 
 bool AsyncPosIntegratedController::isSettled() {
-  return isDisabled() || settledUtil->isSettled(getError());
+  if (isDisabled()) {
+    return true;
+  }
+
+  if (settleTracker.isTracking()) {
+    return settleTracker.isSettled();
+  }
+
+  return settledUtil->isSettled(getError());
+}
+
+void AsyncPosIntegratedController::updateSettled() {
+  settleTracker.update(getError(), motor->getActualVelocity(), motor->isStopped() == 1);
 }
 
 void AsyncPosIntegratedController::reset() {
   LOG_INFO_S("AsyncPosIntegratedController: Reset");
   hasFirstTarget = false;
   settledUtil->reset();
+  settleTracker.reset();
 }
 
 void AsyncPosIntegratedController::flipDisable() {
@@ -90,9 +105,19 @@ void AsyncPosIntegratedController::resumeMovement() {
 void AsyncPosIntegratedController::waitUntilSettled() {
   LOG_INFO_S("AsyncPosIntegratedController: Waiting to settle");
 
-  auto rate = timeUtil.getRate();
-  while (!isSettled()) {
-    rate->delayUntil(motorUpdateRate);
+  if (settleTracker.isTracking()) {
+    // The task calling updateSettled() wakes this one when the motor settles. The timeout is only a
+    // fallback.
+    auto generation = settleTracker.getGeneration();
+    while (!isSettled()) {
+      settleTracker.waitFor(generation, motorUpdateRate);
+      generation = settleTracker.getGeneration();
+    }
+  } else {
+    while (!isSettled()) {
+      waitRate->delayUntil(motorUpdateRate);
+    }
+    waitRate->reset();
   }
 
   LOG_INFO_S("AsyncPosIntegratedController: Done waiting to settle");
@@ -114,6 +139,12 @@ void AsyncPosIntegratedController::setMaxVelocity(const std::int32_t imaxVelocit
   maxVelocity = imaxVelocity;
 }
 
+void AsyncPosIntegratedController::modifyProfiledVelocity(const std::int32_t ivelocity) {
+  if (!controllerIsDisabled) {
+    motor->modifyProfiledVelocity(ivelocity);
+  }
+}
+
 void AsyncPosIntegratedController::tarePosition() {
   offset = getProcessValue() / pair.ratio;
 }
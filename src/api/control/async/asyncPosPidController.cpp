@@ -50,6 +50,7 @@ AsyncPosPIDController::AsyncPosPIDController(
                                                   itimeUtil,
                                                   std::move(iderivativeFilter)),
       itimeUtil.getRateSupplier(),
+      itimeUtil.getTimerSupplier(),
       iratio,
       ilogger),
     offsettableInput(iinput),
@@ -0,0 +1,464 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#include "okapi/api/control/async/asyncPurePursuitController.hpp"
+#include "okapi/api/units/QAngularSpeed.hpp"
+#include "okapi/api/util/fastTrig.hpp"
+#include "okapi/api/util/mathUtil.hpp"
+#include "okapi/api/util/taskProfiler.hpp"
+#include <algorithm>
+#include <cmath>
+#include <mutex>
+
+namespace okapi {
+AsyncPurePursuitController::AsyncPurePursuitController(const TimeUtil &itimeUtil,
+                                                       const std::shared_ptr<ChassisModel> &imodel,
+                                                       const std::shared_ptr<Odometry> &iodometry,
+                                                       const ChassisScales &iscales,
+                                                       const AbstractMotor::GearsetRatioPair &ipair,
+                                                       const PathfinderLimits &ilimits,
+                                                       const QLength ilookahead,
+                                                       const QLength isettleDistance,
+                                                       const std::shared_ptr<Logger> &ilogger)
+  : logger(ilogger),
+    model(imodel),
+    odometry(iodometry),
+    scales(iscales),
+    pair(ipair),
+    limits(ilimits),
+    lookahead(ilookahead),
+    settleDistance(isettleDistance),
+    timeUtil(itimeUtil),
+    pathRate(std::make_unique<ProfiledRate>(timeUtil.getRate(), "AsyncPurePursuitController")) {
+  if (ipair.ratio == 0) {
+    std::string msg("AsyncPurePursuitController: The gear ratio cannot be zero! Check if you are "
+                    "using integer division.");
+    LOG_ERROR(msg);
+    throw std::invalid_argument(msg);
+  }
+
+  if (!(lookahead > 0_m) || !(settleDistance > 0_m)) {
+    std::string msg("AsyncPurePursuitController: The lookahead distance and the settle distance "
+                    "must be positive.");
+    LOG_ERROR(msg);
+    throw std::invalid_argument(msg);
+  }
+
+  if (!(limits.maxVel > 0) || !(limits.maxAccel > 0)) {
+    std::string msg(
+      "AsyncPurePursuitController: The max velocity and max acceleration must be positive.");
+    LOG_ERROR(msg);
+    throw std::invalid_argument(msg);
+  }
+}
+
+AsyncPurePursuitController::~AsyncPurePursuitController() {
+  dtorCalled.store(true, std::memory_order_release);
+  wakeTask();
+
+  // A running path is kept alive by the task's own reference
+  currentPathMutex.lock();
+  paths.clear();
+  currentPathMutex.unlock();
+
+  delete task;
+}
+
+void AsyncPurePursuitController::addPath(const std::vector<Point> &iwaypoints,
+                                         const std::string &ipathId) {
+  if (iwaypoints.size() < 2) {
+    LOG_WARN_S("AsyncPurePursuitController: Not adding a path because fewer than two waypoints "
+               "were given.");
+    return;
+  }
+
+  Path path;
+  path.x.reserve(iwaypoints.size());
+  path.y.reserve(iwaypoints.size());
+  path.distance.reserve(iwaypoints.size());
+  for (const auto &waypoint : iwaypoints) {
+    const double x = waypoint.x.convert(meter);
+    const double y = waypoint.y.convert(meter);
+    path.distance.push_back(path.x.empty() ? 0
+                                           : path.distance.back() +
+                                               std::hypot(x - path.x.back(), y - path.y.back()));
+    path.x.push_back(x);
+    path.y.push_back(y);
+  }
+
+  // A running path with the same ID keeps its own reference to the old path
+  currentPathMutex.lock();
+  paths.insert_or_assign(ipathId, std::make_shared<const Path>(std::move(path)));
+  currentPathMutex.unlock();
+
+  LOG_INFO("AsyncPurePursuitController: Added path " + ipathId);
+}
+
+std::vector<Point> AsyncPurePursuitController::interpolate(const std::vector<Point> &iwaypoints,
+                                                           const QLength ispacing) {
+  if (!(ispacing > 0_m)) {
+    auto logger = Logger::getDefaultLogger();
+    std::string msg("AsyncPurePursuitController: The spacing must be positive.");
+    LOG_ERROR(msg);
+    throw std::invalid_argument(msg);
+  }
+
+  std::vector<Point> out;
+  if (iwaypoints.empty()) {
+    return out;
+  }
+
+  out.push_back(iwaypoints.front());
+  for (std::size_t i = 1; i < iwaypoints.size(); i++) {
+    const Point &start = iwaypoints[i - 1];
+    const Point &end = iwaypoints[i];
+    const QLength deltaX = end.x - start.x;
+    const QLength deltaY = end.y - start.y;
+    const double length = std::hypot(deltaX.convert(meter), deltaY.convert(meter));
+
+    // Split the leg into equal pieces no longer than the spacing
+    const auto pieces =
+      static_cast<std::size_t>(std::max(1.0, std::ceil(length / ispacing.convert(meter))));
+    for (std::size_t piece = 1; piece < pieces; piece++) {
+      const double fraction = static_cast<double>(piece) / static_cast<double>(pieces);
+      out.push_back({start.x + deltaX * fraction, start.y + deltaY * fraction});
+    }
+    out.push_back(end);
+  }
+
+  return out;
+}
+
+bool AsyncPurePursuitController::removePath(const std::string &ipathId) {
+  std::scoped_lock lock(currentPathMutex);
+
+  // If this path is running, the controller task still holds a reference to it, so it will be
+  // freed once it is done
+  paths.erase(ipathId);
+  return true;
+}
+
+std::vector<std::string> AsyncPurePursuitController::getPaths() {
+  std::vector<std::string> keys;
+
+  std::scoped_lock lock(currentPathMutex);
+
+  for (const auto &path : paths) {
+    keys.push_back(path.first);
+  }
+
+  return keys;
+}
+
+void AsyncPurePursuitController::setTarget(std::string ipathId) {
+  LOG_INFO("AsyncPurePursuitController: Set target to: " + ipathId);
+
+  currentPathMutex.lock();
+  currentPath = ipathId;
+  currentPathMutex.unlock();
+
+  isRunning.store(true, std::memory_order_release);
+  wakeTask();
+}
+
+void AsyncPurePursuitController::controllerSet(const std::string ivalue) {
+  setTarget(ivalue);
+}
+
+std::string AsyncPurePursuitController::getTarget() {
+  std::scoped_lock lock(currentPathMutex);
+  return currentPath;
+}
+
+std::string AsyncPurePursuitController::getProcessValue() const {
+  std::scoped_lock lock(currentPathMutex);
+  return currentPath;
+}
+
+void AsyncPurePursuitController::loop() {
+  LOG_INFO_S("Started AsyncPurePursuitController task.");
+
+  while (!dtorCalled.load(std::memory_order_acquire)) {
+    if (isRunning.load(std::memory_order_acquire) && !isDisabled()) {
+      currentPathMutex.lock();
+      const std::string pathId = currentPath;
+      currentPathMutex.unlock();
+
+      if (executePath(pathId)) {
+        model->stop();
+        LOG_INFO_S("AsyncPurePursuitController: Done moving");
+      }
+
+      isRunning.store(false, std::memory_order_release);
+      settledEvent.notifyAll();
+    }
+
+    // Sleep until setTarget() wakes this task. Any other notification means the task which made
+    // this controller was deleted, so stop.
+    if (CrossplatformThread::notifyTake(idleLoopTimeout) & ~CrossplatformThread::wakeNotification) {
+      break;
+    }
+  }
+
+  LOG_INFO_S("Stopped AsyncPurePursuitController task.");
+}
+
+bool AsyncPurePursuitController::executePath(const std::string &ipathId) {
+  LOG_INFO_F("AsyncPurePursuitController: Running with path: %s", ipathId);
+
+  // Take our own reference to the path so it stays valid even if it is removed or replaced
+  // while we follow it
+  std::shared_ptr<const Path> path;
+  currentPathMutex.lock();
+  if (auto it = paths.find(ipathId); it != paths.end()) {
+    path = it->second;
+  }
+  currentPathMutex.unlock();
+
+  if (!path) {
+    LOG_WARN("AsyncPurePursuitController: Target was set to non-existent path with name: " +
+             ipathId);
+    return false;
+  }
+
+  executeSinglePath(*path, *pathRate);
+  pathRate->reset();
+  return true;
+}
+
+void AsyncPurePursuitController::executeSinglePath(const Path &ipath, AbstractRate &rate) {
+  // The caller holds a reference to the path for as long as this runs, so there is nothing to lock
+  FollowState state;
+  while (!isDisabled() && !dtorCalled.load(std::memory_order_acquire) &&
+         !followStep(ipath, state)) {
+    rate.delayUntil(followPeriod);
+  }
+}
+
+bool AsyncPurePursuitController::followStep(const Path &ipath, FollowState &iostate) {
+  const OdomState pose = odometry->getState(StateMode::FRAME_TRANSFORMATION);
+  const double x = pose.x.convert(meter);
+  const double y = pose.y.convert(meter);
+  const std::size_t last = ipath.x.size() - 1;
+
+  const double endX = ipath.x[last] - x;
+  const double endY = ipath.y[last] - y;
+  currentPathMutex.lock();
+  error = {endX * meter, endY * meter};
+  currentPathMutex.unlock();
+
+  const double endDistance = std::hypot(endX, endY);
+  if (endDistance <= settleDistance.convert(meter)) {
+    return true;
+  }
+
+  updateSearch(ipath, x, y, iostate);
+
+  const auto index = static_cast<std::size_t>(iostate.lookaheadIndex);
+  double lookaheadX = ipath.x[last];
+  double lookaheadY = ipath.y[last];
+  if (index < last) {
+    const double fraction = iostate.lookaheadIndex - static_cast<double>(index);
+    lookaheadX = ipath.x[index] + (ipath.x[index + 1] - ipath.x[index]) * fraction;
+    lookaheadY = ipath.y[index] + (ipath.y[index + 1] - ipath.y[index]) * fraction;
+  }
+
+  // The arc through the lookahead point which is tangent to the heading of the robot
+  const double dx = lookaheadX - x;
+  const double dy = lookaheadY - y;
+  const double lookaheadDistance = std::hypot(dx, dy);
+  const double angle = Trig::atan2(dy, dx) - pose.theta.convert(radian);
+  const double curvature = lookaheadDistance > 0 ? 2 * Trig::sin(angle) / lookaheadDistance : 0;
+
+  // Slow down in time to stop at the end. The distance left along the path is zero once the last
+  // point is the closest, so the straight distance to the end keeps the robot moving until then.
+  const double remaining =
+    std::max(ipath.distance[last] - ipath.distance[iostate.closestIndex], endDistance);
+  const double stoppingSpeed = std::sqrt(2 * limits.maxAccel * remaining);
+  const double rampedSpeed = iostate.speed + limits.maxAccel * followPeriod.convert(second);
+  iostate.speed = std::min({limits.maxVel, stoppingSpeed, rampedSpeed});
+
+  writeArc(iostate.speed, curvature);
+  return false;
+}
+
+void AsyncPurePursuitController::updateSearch(const Path &ipath,
+                                              const double ix,
+                                              const double iy,
+                                              FollowState &iostate) const {
+  const std::size_t count = ipath.x.size();
+  const auto squaredDistance = [&](const std::size_t i) {
+    const double dx = ipath.x[i] - ix;
+    const double dy = ipath.y[i] - iy;
+    return dx * dx + dy * dy;
+  };
+
+  // Walk forward from the last closest point while the next point is no farther away
+  std::size_t closest = iostate.closestIndex;
+  double closestSquared = squaredDistance(closest);
+  while (closest + 1 < count) {
+    const double next = squaredDistance(closest + 1);
+    if (next > closestSquared) {
+      break;
+    }
+    closest++;
+    closestSquared = next;
+  }
+  iostate.closestIndex = closest;
+
+  const double radius = lookahead.convert(meter);
+  const double radiusSquared = radius * radius;
+  if (squaredDistance(count - 1) <= radiusSquared) {
+    // The end is within reach, so steer straight for it
+    iostate.lookaheadIndex = static_cast<double>(count - 1);
+    return;
+  }
+
+  // The first segment from the last lookahead point on which leaves the circle holds the new one
+  for (auto i = static_cast<std::size_t>(iostate.lookaheadIndex); i + 1 < count; i++) {
+    const double segmentX = ipath.x[i + 1] - ipath.x[i];
+    const double segmentY = ipath.y[i + 1] - ipath.y[i];
+    const double a = segmentX * segmentX + segmentY * segmentY;
+    if (a == 0) {
+      continue;
+    }
+
+    const double offsetX = ipath.x[i] - ix;
+    const double offsetY = ipath.y[i] - iy;
+    const double b = 2 * (offsetX * segmentX + offsetY * segmentY);
+    const double c = offsetX * offsetX + offsetY * offsetY - radiusSquared;
+    const double discriminant = b * b - 4 * a * c;
+    if (discriminant < 0) {
+      continue;
+    }
+
+    // The larger root is where the segment leaves the circle, which is farther along the path
+    const double t = (-b + std::sqrt(discriminant)) / (2 * a);
+    const double candidate = static_cast<double>(i) + t;
+    if (t >= 0 && t <= 1 && candidate >= iostate.lookaheadIndex) {
+      iostate.lookaheadIndex = candidate;
+      return;
+    }
+  }
+
+  // The robot is too far from the path to reach it with the circle, so head back to it
+  iostate.lookaheadIndex = std::max(iostate.lookaheadIndex, static_cast<double>(closest));
+}
+
+void AsyncPurePursuitController::writeArc(const double ispeed, const double icurvature) {
+  const double maxVelocity = model->getMaxVelocity();
+  if (maxVelocity <= 0) {
+    return;
+  }
+
+  // Turning clockwise drives the left side faster than the right side
+  const double halfTrack = scales.wheelTrack.convert(meter) / 2;
+  const double outputPerMps = scales.getMotorRpmPerMps(pair) / maxVelocity;
+  const auto toOutput = [&](const double speed) { return speed * outputPerMps; };
+  const double leftOutput = toOutput(ispeed * (1 + icurvature * halfTrack));
+  const double rightOutput = toOutput(ispeed * (1 - icurvature * halfTrack));
+
+  // Scale both sides together so the robot keeps the curvature
+  const double largest = std::max({1.0, std::abs(leftOutput), std::abs(rightOutput)});
+  model->left(leftOutput / largest);
+  model->right(rightOutput / largest);
+}
+
+void AsyncPurePursuitController::wakeTask() {
+  if (task) {
+    task->notify();
+  }
+}
+
+void AsyncPurePursuitController::trampoline(void *context) {
+  if (context) {
+    static_cast<AsyncPurePursuitController *>(context)->loop();
+  }
+}
+
+void AsyncPurePursuitController::waitUntilSettled() {
+  LOG_INFO_S("AsyncPurePursuitController: Waiting to settle");
+
+  // The controller task notifies settledEvent when it settles. The timeout is only a fallback.
+  auto generation = settledEvent.getGeneration();
+  while (!isSettled()) {
+    settledEvent.waitFor(generation, settledWaitTimeout);
+    generation = settledEvent.getGeneration();
+  }
+
+  LOG_INFO_S("AsyncPurePursuitController: Done waiting to settle");
+}
+
+void AsyncPurePursuitController::moveTo(const std::vector<Point> &iwaypoints) {
+  static int moveToCount = 0;
+  std::string name = "__moveTo" + std::to_string(moveToCount++);
+  addPath(iwaypoints, name);
+  setTarget(name);
+  waitUntilSettled();
+  removePath(name);
+}
+
+Point AsyncPurePursuitController::getError() const {
+  std::scoped_lock lock(currentPathMutex);
+  if (!isRunning.load(std::memory_order_acquire)) {
+    return {0_m, 0_m};
+  }
+
+  return error;
+}
+
+bool AsyncPurePursuitController::isSettled() {
+  return isDisabled() || !isRunning.load(std::memory_order_acquire);
+}
+
+void AsyncPurePursuitController::reset() {
+  // Interrupt executeSinglePath() by disabling the controller
+  flipDisable(true);
+
+  LOG_INFO_S("AsyncPurePursuitController: Waiting to reset");
+
+  auto generation = settledEvent.getGeneration();
+  while (isRunning.load(std::memory_order_acquire)) {
+    settledEvent.waitFor(generation, settledWaitTimeout);
+    generation = settledEvent.getGeneration();
+  }
+
+  flipDisable(false);
+}
+
+void AsyncPurePursuitController::flipDisable() {
+  flipDisable(!disabled.load(std::memory_order_acquire));
+}
+
+void AsyncPurePursuitController::flipDisable(const bool iisDisabled) {
+  LOG_INFO("AsyncPurePursuitController: flipDisable " + std::to_string(iisDisabled));
+  disabled.store(iisDisabled, std::memory_order_release);
+  // Disabling the controller settles it, and loop() stops the robot once the path is interrupted
+  settledEvent.notifyAll();
+  wakeTask();
+}
+
+bool AsyncPurePursuitController::isDisabled() const {
+  return disabled.load(std::memory_order_acquire);
+}
+
+void AsyncPurePursuitController::startThread(const std::uint32_t ipriority,
+                                             const std::uint16_t istackDepth) {
+  if (!task) {
+    task = new CrossplatformThread(
+      trampoline, this, "AsyncPurePursuitController", ipriority, istackDepth);
+  }
+}
+
+CrossplatformThread *AsyncPurePursuitController::getThread() const {
+  return task;
+}
+
+void AsyncPurePursuitController::tarePosition() {
+}
+
+void AsyncPurePursuitController::setMaxVelocity(std::int32_t) {
+}
+} // namespace okapi
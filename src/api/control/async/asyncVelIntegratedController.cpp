@@ -18,7 +18,8 @@ AsyncVelIntegratedController::AsyncVelIntegratedController(
     motor(imotor),
     pair(ipair),
     maxVelocity(imaxVelocity),
-    settledUtil(itimeUtil.getSettledUtil()) {
+    settledUtil(itimeUtil.getSettledUtil()),
+    waitRate(itimeUtil.getRate()) {
   if (ipair.ratio == 0) {
     std::string msg("AsyncVelIntegratedController: The gear ratio cannot be zero! Check if you are "
                     "using integer division.");
@@ -96,10 +97,10 @@ void AsyncVelIntegratedController::resumeMovement() {
 void AsyncVelIntegratedController::waitUntilSettled() {
   LOG_INFO_S("AsyncVelIntegratedController: Waiting to settle");
 
-  auto rate = timeUtil.getRate();
   while (!isSettled()) {
-    rate->delayUntil(motorUpdateRate);
+    waitRate->delayUntil(motorUpdateRate);
   }
+  waitRate->reset();
 
   LOG_INFO_S("AsyncVelIntegratedController: Done waiting to settle");
 }
@@ -30,6 +30,7 @@ AsyncVelPIDController::AsyncVelPIDController(
                                                   itimeUtil,
                                                   std::move(iderivativeFilter)),
       itimeUtil.getRateSupplier(),
+      itimeUtil.getTimerSupplier(),
       iratio,
       ilogger),
     internalController(std::static_pointer_cast<IterativeVelPIDController>(controller)) {
@@ -0,0 +1,35 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#include "okapi/api/control/async/asyncVelTbhController.hpp"
+
+namespace okapi {
+AsyncVelTBHController::AsyncVelTBHController(
+  const std::shared_ptr<ControllerInput<double>> &iinput,
+  const std::shared_ptr<ControllerOutput<double>> &ioutput,
+  const TimeUtil &itimeUtil,
+  const IterativeTBHController::Gains &igains,
+  std::unique_ptr<VelMath> ivelMath,
+  const double iratio,
+  const std::shared_ptr<Logger> &ilogger)
+  : AsyncWrapper<double, double>(
+      iinput,
+      ioutput,
+      std::make_shared<IterativeTBHController>(igains, std::move(ivelMath), itimeUtil, ilogger),
+      itimeUtil.getRateSupplier(),
+      itimeUtil.getTimerSupplier(),
+      iratio,
+      ilogger),
+    internalController(std::static_pointer_cast<IterativeTBHController>(controller)) {
+}
+
+void AsyncVelTBHController::setGains(const IterativeTBHController::Gains &igains) {
+  internalController->setGains(igains);
+}
+
+IterativeTBHController::Gains AsyncVelTBHController::getGains() const {
+  return internalController->getGains();
+}
+} // namespace okapi
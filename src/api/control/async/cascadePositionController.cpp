@@ -0,0 +1,276 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#include "okapi/api/control/async/cascadePositionController.hpp"
+#include <cmath>
+#include <mutex>
+#include <stdexcept>
+
+namespace okapi {
+CascadePositionController::CascadePositionController(
+  const std::shared_ptr<ControllerInput<double>> &iinput,
+  const std::shared_ptr<IterativePosPIDController> &iouter,
+  const double imaxVelocity,
+  const TimeUtil &itimeUtil,
+  const QTime &iinnerPeriod,
+  const QTime &iouterPeriod,
+  const std::shared_ptr<Logger> &ilogger)
+  : logger(ilogger),
+    input(iinput),
+    outer(iouter),
+    maxVelocity(imaxVelocity),
+    rateSupplier(itimeUtil.getRateSupplier()),
+    innerPeriod(iinnerPeriod),
+    outerPeriod(iouterPeriod) {
+  if (input == nullptr || outer == nullptr) {
+    std::string msg = "CascadePositionController: The input and outer controller cannot be null.";
+    LOG_ERROR(msg);
+    throw std::invalid_argument(msg);
+  }
+
+  if (innerPeriod <= 0_ms || outerPeriod < innerPeriod) {
+    std::string msg = "CascadePositionController: The inner period must be greater than zero and "
+                      "the outer period must be at least the inner period.";
+    LOG_ERROR(msg);
+    throw std::invalid_argument(msg);
+  }
+
+  offsettableInput = std::make_shared<OffsetableControllerInput>(input);
+  innerStepsPerOuterStep =
+    static_cast<std::uint32_t>(std::round((outerPeriod / innerPeriod).getValue()));
+  outer->setSampleTime(outerPeriod);
+}
+
+CascadePositionController::CascadePositionController(
+  const std::shared_ptr<ControllerInput<double>> &iinput,
+  const std::shared_ptr<IterativePosPIDController> &iouter,
+  const std::shared_ptr<IterativeVelocityController<double, double>> &iinner,
+  const std::shared_ptr<ControllerOutput<double>> &ioutput,
+  const double imaxVelocity,
+  const TimeUtil &itimeUtil,
+  const QTime &iinnerPeriod,
+  const QTime &iouterPeriod,
+  const std::shared_ptr<Logger> &ilogger)
+  : CascadePositionController(
+      iinput, iouter, imaxVelocity, itimeUtil, iinnerPeriod, iouterPeriod, ilogger) {
+  if (iinner == nullptr || ioutput == nullptr) {
+    std::string msg = "CascadePositionController: The inner controller and output cannot be null.";
+    LOG_ERROR(msg);
+    throw std::invalid_argument(msg);
+  }
+
+  iterativeInner = iinner;
+  output = ioutput;
+  iterativeInner->setSampleTime(innerPeriod);
+}
+
+CascadePositionController::CascadePositionController(
+  const std::shared_ptr<ControllerInput<double>> &iinput,
+  const std::shared_ptr<IterativePosPIDController> &iouter,
+  const std::shared_ptr<AsyncVelocityController<double, double>> &iinner,
+  const double imaxVelocity,
+  const TimeUtil &itimeUtil,
+  const QTime &iinnerPeriod,
+  const QTime &iouterPeriod,
+  const std::shared_ptr<Logger> &ilogger)
+  : CascadePositionController(
+      iinput, iouter, imaxVelocity, itimeUtil, iinnerPeriod, iouterPeriod, ilogger) {
+  if (iinner == nullptr) {
+    std::string msg = "CascadePositionController: The inner controller cannot be null.";
+    LOG_ERROR(msg);
+    throw std::invalid_argument(msg);
+  }
+
+  asyncInner = iinner;
+}
+
+CascadePositionController::~CascadePositionController() {
+  dtorCalled.store(true, std::memory_order_release);
+  delete task;
+}
+
+void CascadePositionController::setTarget(const double itarget) {
+  LOG_INFO("CascadePositionController: Set target to " + std::to_string(itarget));
+  std::scoped_lock lock(stepMutex);
+  hasFirstTarget = true;
+  lastTarget = itarget;
+  outer->setTarget(itarget);
+  // Step the outer loop on the next step so the inner loop sees the new target right away
+  innerStepCount = 0;
+}
+
+void CascadePositionController::controllerSet(const double ivalue) {
+  std::scoped_lock lock(stepMutex);
+  hasFirstTarget = true;
+  outer->controllerSet(ivalue);
+  lastTarget = outer->getTarget();
+  innerStepCount = 0;
+}
+
+double CascadePositionController::getTarget() {
+  std::scoped_lock lock(stepMutex);
+  return outer->getTarget();
+}
+
+double CascadePositionController::getProcessValue() const {
+  std::scoped_lock lock(stepMutex);
+  return outer->getProcessValue();
+}
+
+double CascadePositionController::getError() const {
+  std::scoped_lock lock(stepMutex);
+  return outer->getError();
+}
+
+bool CascadePositionController::isSettled() {
+  std::scoped_lock lock(stepMutex);
+  return outer->isDisabled() || outer->isSettled();
+}
+
+void CascadePositionController::reset() {
+  LOG_INFO_S("CascadePositionController: Reset");
+  std::scoped_lock lock(stepMutex);
+  outer->reset();
+  if (iterativeInner) {
+    iterativeInner->reset();
+  } else {
+    asyncInner->reset();
+  }
+
+  innerTarget = 0;
+  innerStepCount = 0;
+  hasFirstTarget = false;
+}
+
+void CascadePositionController::flipDisable() {
+  flipDisable(!isDisabled());
+}
+
+void CascadePositionController::flipDisable(const bool iisDisabled) {
+  LOG_INFO("CascadePositionController: flipDisable " + std::to_string(iisDisabled));
+  {
+    std::scoped_lock lock(stepMutex);
+    outer->flipDisable(iisDisabled);
+    if (iterativeInner) {
+      iterativeInner->flipDisable(iisDisabled);
+    } else {
+      asyncInner->flipDisable(iisDisabled);
+    }
+
+    resumeMovement();
+  }
+
+  settledEvent.notifyAll();
+}
+
+bool CascadePositionController::isDisabled() const {
+  std::scoped_lock lock(stepMutex);
+  return outer->isDisabled();
+}
+
+void CascadePositionController::waitUntilSettled() {
+  LOG_INFO_S("CascadePositionController: Waiting to settle");
+
+  // The task notifies settledEvent after every step. The timeout is only a fallback.
+  auto generation = settledEvent.getGeneration();
+  while (!isSettled()) {
+    settledEvent.waitFor(generation, settledWaitTimeout);
+    generation = settledEvent.getGeneration();
+  }
+
+  LOG_INFO_S("CascadePositionController: Done waiting to settle");
+}
+
+void CascadePositionController::tarePosition() {
+  offsettableInput->tarePosition();
+}
+
+void CascadePositionController::setMaxVelocity(const std::int32_t imaxVelocity) {
+  maxVelocity.store(imaxVelocity, std::memory_order_relaxed);
+}
+
+double CascadePositionController::getInnerTarget() const {
+  std::scoped_lock lock(stepMutex);
+  return innerTarget;
+}
+
+void CascadePositionController::step() {
+  {
+    std::scoped_lock lock(stepMutex);
+    if (outer->isDisabled()) {
+      return;
+    }
+
+    if (innerStepCount == 0) {
+      setInnerTarget(outer->stepFixed(offsettableInput->controllerGet(), outerPeriod));
+    }
+    innerStepCount = (innerStepCount + 1) % innerStepsPerOuterStep;
+
+    if (iterativeInner) {
+      output->controllerSet(iterativeInner->stepFixed(input->controllerGet(), innerPeriod));
+    }
+  }
+
+  settledEvent.notifyAll();
+}
+
+void CascadePositionController::startThread(const std::uint32_t ipriority,
+                                            const std::uint16_t istackDepth) {
+  if (!task) {
+    task = new CrossplatformThread(
+      trampoline, this, "CascadePositionController", ipriority, istackDepth);
+  }
+}
+
+CrossplatformThread *CascadePositionController::getThread() const {
+  return task;
+}
+
+void CascadePositionController::trampoline(void *context) {
+  if (context) {
+    static_cast<CascadePositionController *>(context)->loop();
+  }
+}
+
+void CascadePositionController::loop() {
+  auto rate = rateSupplier.get();
+  while (!dtorCalled.load(std::memory_order_acquire) && !task->notifyTake(0)) {
+    step();
+    rate->delayUntil(innerPeriod);
+  }
+}
+
+void CascadePositionController::setInnerTarget(const double iouterOutput) {
+  const double target = iouterOutput * maxVelocity.load(std::memory_order_relaxed);
+  if (!innerTargetStale && target == innerTarget) {
+    // The async controllers move their motor on every new target, so skip repeats
+    return;
+  }
+
+  innerTarget = target;
+  innerTargetStale = false;
+  if (iterativeInner) {
+    iterativeInner->setTarget(innerTarget);
+  } else {
+    asyncInner->setTarget(innerTarget);
+  }
+}
+
+void CascadePositionController::resumeMovement() {
+  if (outer->isDisabled()) {
+    if (iterativeInner) {
+      // This will grab the output *when disabled*
+      output->controllerSet(iterativeInner->getOutput());
+    }
+  } else {
+    // The inner controller may have moved to its own last target, so set it again
+    innerTargetStale = true;
+    if (hasFirstTarget) {
+      outer->setTarget(lastTarget);
+      innerStepCount = 0;
+    }
+  }
+}
+} // namespace okapi
@@ -0,0 +1,184 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#include "okapi/api/control/iterative/iterativeBangBangController.hpp"
+#include "okapi/api/util/mathUtil.hpp"
+#include <algorithm>
+#include <cmath>
+
+namespace okapi {
+IterativeBangBangController::IterativeBangBangController(const Gains &igains,
+                                                         std::unique_ptr<VelMath> ivelMath,
+                                                         const TimeUtil &itimeUtil,
+                                                         std::shared_ptr<Logger> ilogger)
+  : logger(std::move(ilogger)),
+    velMath(std::move(ivelMath)),
+    loopDtTimer(itimeUtil.getTimer()),
+    settledUtil(itimeUtil.getSettledUtil()) {
+  setOutputLimits(1, -1);
+  setGains(igains);
+}
+
+void IterativeBangBangController::setSampleTime(const QTime isampleTime) {
+  if (isampleTime > 0_ms) {
+    sampleTime = isampleTime;
+  }
+}
+
+void IterativeBangBangController::setOutputLimits(double imax, double imin) {
+  // Always use larger value as max
+  if (imin > imax) {
+    const double temp = imax;
+    imax = imin;
+    imin = temp;
+  }
+
+  outputMax = imax;
+  outputMin = imin;
+
+  output = std::clamp(output, outputMin, outputMax);
+}
+
+void IterativeBangBangController::setControllerSetTargetLimits(double itargetMax,
+                                                               double itargetMin) {
+  // Always use larger value as max
+  if (itargetMin > itargetMax) {
+    const double temp = itargetMax;
+    itargetMax = itargetMin;
+    itargetMin = temp;
+  }
+
+  controllerSetTargetMax = itargetMax;
+  controllerSetTargetMin = itargetMin;
+}
+
+QAngularSpeed IterativeBangBangController::stepVel(const double inewReading) {
+  return velMath->step(inewReading);
+}
+
+double IterativeBangBangController::step(const double inewReading) {
+  auto profile = stepProfiler.start();
+  if (!controllerIsDisabled) {
+    loopDtTimer->placeHardMark();
+
+    if (loopDtTimer->getDtFromHardMark() >= sampleTime) {
+      stepVel(inewReading);
+      error = getError();
+
+      if (error > band) {
+        output = outputMax;
+      } else if (error < -band) {
+        output = outputMin;
+      } else {
+        output = std::clamp(kF * target + kP * error, outputMin, outputMax);
+      }
+
+      loopDtTimer->clearHardMark(); // Important that we only clear if dt >= sampleTime
+
+      settledUtil->isSettled(error);
+    } else {
+      profile.skip();
+    }
+
+    return output;
+  }
+
+  return 0;
+}
+
+void IterativeBangBangController::setTarget(const double itarget) {
+  LOG_INFO("IterativeBangBangController: Set target to " + std::to_string(itarget));
+  target = itarget;
+}
+
+void IterativeBangBangController::controllerSet(const double ivalue) {
+  target = remapRange(ivalue, -1, 1, controllerSetTargetMin, controllerSetTargetMax);
+}
+
+double IterativeBangBangController::getTarget() {
+  return target;
+}
+
+double IterativeBangBangController::getTarget() const {
+  return target;
+}
+
+double IterativeBangBangController::getProcessValue() const {
+  return unit_cast<rpm>(velMath->getVelocity());
+}
+
+double IterativeBangBangController::getOutput() const {
+  return isDisabled() ? 0 : output;
+}
+
+double IterativeBangBangController::getMaxOutput() {
+  return outputMax;
+}
+
+double IterativeBangBangController::getMinOutput() {
+  return outputMin;
+}
+
+double IterativeBangBangController::getError() const {
+  return getTarget() - getProcessValue();
+}
+
+bool IterativeBangBangController::isSettled() {
+  return isDisabled() ? true : settledUtil->isSettled(error);
+}
+
+void IterativeBangBangController::reset() {
+  LOG_INFO_S("IterativeBangBangController: Reset");
+
+  error = 0;
+  output = 0;
+  settledUtil->reset();
+}
+
+void IterativeBangBangController::flipDisable() {
+  flipDisable(!controllerIsDisabled);
+}
+
+void IterativeBangBangController::flipDisable(const bool iisDisabled) {
+  LOG_INFO("IterativeBangBangController: flipDisable " + std::to_string(iisDisabled));
+  controllerIsDisabled = iisDisabled;
+}
+
+bool IterativeBangBangController::isDisabled() const {
+  return controllerIsDisabled;
+}
+
+void IterativeBangBangController::setGains(const Gains &igains) {
+  kF = igains.kF;
+  kP = igains.kP;
+  band = std::abs(igains.band);
+}
+
+IterativeBangBangController::Gains IterativeBangBangController::getGains() const {
+  return {kF, kP, band};
+}
+
+void IterativeBangBangController::setTicksPerRev(const double tpr) {
+  velMath->setTicksPerRev(tpr);
+}
+
+QAngularSpeed IterativeBangBangController::getVel() const {
+  return velMath->getVelocity();
+}
+
+QTime IterativeBangBangController::getSampleTime() const {
+  return sampleTime;
+}
+
+bool IterativeBangBangController::Gains::operator==(
+  const IterativeBangBangController::Gains &rhs) const {
+  return kF == rhs.kF && kP == rhs.kP && band == rhs.band;
+}
+
+bool IterativeBangBangController::Gains::operator!=(
+  const IterativeBangBangController::Gains &rhs) const {
+  return !(rhs == *this);
+}
+} // namespace okapi
@@ -13,6 +13,7 @@ IterativeMotorVelocityController::IterativeMotorVelocityController(
 }
 
 double IterativeMotorVelocityController::step(const double ireading) {
+  auto profile = stepProfiler.start();
   motor->controllerSet(controller->step(ireading));
   return controller->getOutput();
 }
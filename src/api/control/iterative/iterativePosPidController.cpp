@@ -9,6 +9,8 @@
 #include "okapi/api/util/mathUtil.hpp"
 #include <algorithm>
 #include <cmath>
+#include <stdexcept>
+#include <string>
 
 namespace okapi {
 IterativePosPIDController::IterativePosPIDController(const double ikP,
@@ -42,10 +44,22 @@ IterativePosPIDController::IterativePosPIDController(const Gains &igains,
 void IterativePosPIDController::setTarget(const double itarget) {
   LOG_INFO("IterativePosPIDController: Set target to " + std::to_string(itarget));
   target = itarget;
+  targetVelocity = 0;
+  targetAcceleration = 0;
+}
+
+void IterativePosPIDController::setProfiledTarget(const double itarget,
+                                                  const double ivelocity,
+                                                  const double iacceleration) {
+  target = itarget;
+  targetVelocity = ivelocity;
+  targetAcceleration = iacceleration;
 }
 
 void IterativePosPIDController::controllerSet(const double ivalue) {
   target = remapRange(ivalue, -1, 1, controllerSetTargetMin, controllerSetTargetMax);
+  targetVelocity = 0;
+  targetAcceleration = 0;
 }
 
 double IterativePosPIDController::getTarget() {
@@ -116,42 +130,91 @@ void IterativePosPIDController::setControllerSetTargetLimits(double itargetMax,
 }
 
 double IterativePosPIDController::step(const double inewReading) {
+  auto profile = stepProfiler.start();
   if (controllerIsDisabled) {
     return 0;
   } else {
     loopDtTimer->placeHardMark();
 
     if (loopDtTimer->getDtFromHardMark() >= sampleTime) {
-      // lastReading must only be updated here so its updates are time-gated by sampleTime
-      const double readingDiff = inewReading - lastReading;
-      lastReading = inewReading;
+      update(inewReading, 1);
+      loopDtTimer->clearHardMark(); // Important that we only clear if dt >= sampleTime
+    } else {
+      profile.skip();
+    }
+  }
 
-      error = getError();
+  return output;
+}
+
+double IterativePosPIDController::stepFixed(const double inewReading, const QTime &idt) {
+  auto profile = stepProfiler.start();
+  if (controllerIsDisabled) {
+    return 0;
+  } else if (idt > 0_ms) {
+    update(inewReading, idt.convert(second) / sampleTime.convert(second));
+  } else {
+    profile.skip();
+  }
 
-      if ((std::abs(error) < target - errorSumMin && std::abs(error) > target - errorSumMax) ||
-          (std::abs(error) > target + errorSumMin && std::abs(error) < target + errorSumMax)) {
-        integral += kI * error; // Eliminate integral kick while realtime tuning
-      }
+  return output;
+}
 
-      if (shouldResetOnCross && std::copysign(1.0, error) != std::copysign(1.0, lastError)) {
-        integral = 0;
-      }
+void IterativePosPIDController::update(const double inewReading, const double idtRatio) {
+  // lastReading must only be updated here so its updates are gated like the rest of the step
+  const double readingDiff = inewReading - lastReading;
+  lastReading = inewReading;
+
+  error = getError();
+
+  if (gainSchedule) {
+    const double key = gainScheduleInput ? gainScheduleInput->controllerGet() : std::abs(error);
+    const Gains gains = gainSchedule->at(key);
+    const double sampleTimeSec = sampleTime.convert(second);
+    kP = gains.kP;
+    kI = gains.kI * sampleTimeSec;
+    kD = gains.kD / sampleTimeSec;
+    kBias = gains.kBias;
+  }
 
-      integral = std::clamp(integral, integralMin, integralMax);
+  // Derivative over measurement to eliminate derivative kick on setpoint change
+  derivative = derivativeFilter->filter(readingDiff);
+
+  // Everything in the output except the integral
+  const double otherTerms = kP * error - kD / idtRatio * derivative + kBias +
+                            feedforward.calculate(targetVelocity, targetAcceleration);
+
+  if ((std::abs(error) < target - errorSumMin && std::abs(error) > target - errorSumMax) ||
+      (std::abs(error) > target + errorSumMin && std::abs(error) < target + errorSumMax)) {
+    // Eliminate integral kick while realtime tuning
+    const double integralStep = kI * idtRatio * error;
+    const double unclamped = otherTerms + integral + integralStep;
+    if (antiWindupStrategy != antiWindup::conditionalIntegration ||
+        !((unclamped > outputMax && integralStep > 0) ||
+          (unclamped < outputMin && integralStep < 0))) {
+      integral += integralStep;
+    }
+  }
 
-      // Derivative over measurement to eliminate derivative kick on setpoint change
-      derivative = derivativeFilter->filter(readingDiff);
+  if (shouldResetOnCross && std::copysign(1.0, error) != std::copysign(1.0, lastError)) {
+    integral = 0;
+  }
 
-      output = std::clamp(kP * error + integral - kD * derivative + kBias, outputMin, outputMax);
+  integral = std::clamp(integral, integralMin, integralMax);
 
-      lastError = error;
-      loopDtTimer->clearHardMark(); // Important that we only clear if dt >= sampleTime
+  const double unclamped = otherTerms + integral;
+  output = std::clamp(unclamped, outputMin, outputMax);
 
-      settledUtil->isSettled(error);
-    }
+  // Only the part of the integral pushing the output past its limit is wound up, so only that part
+  // is taken back. A long step takes out more, but never more than the whole clamped amount.
+  const double excess = unclamped - output;
+  if (antiWindupStrategy == antiWindup::backCalculation && excess * integral > 0) {
+    const double bled = integral - std::min(trackingGain * idtRatio, 1.0) * excess;
+    integral = integral > 0 ? std::max(bled, 0.0) : std::min(bled, 0.0);
   }
 
-  return output;
+  lastError = error;
+  settledUtil->isSettled(error);
 }
 
 void IterativePosPIDController::reset() {
@@ -169,6 +232,23 @@ void IterativePosPIDController::setIntegratorReset(bool iresetOnZero) {
   shouldResetOnCross = iresetOnZero;
 }
 
+void IterativePosPIDController::setAntiWindup(const antiWindup istrategy,
+                                              const double itrackingGain) {
+  if (!(itrackingGain > 0 && itrackingGain <= 1)) {
+    std::string msg("IterativePosPIDController: The tracking gain must be in (0, 1], got " +
+                    std::to_string(itrackingGain) + ".");
+    LOG_ERROR(msg);
+    throw std::invalid_argument(msg);
+  }
+
+  antiWindupStrategy = istrategy;
+  trackingGain = itrackingGain;
+}
+
+IterativePosPIDController::antiWindup IterativePosPIDController::getAntiWindup() const {
+  return antiWindupStrategy;
+}
+
 void IterativePosPIDController::flipDisable() {
   flipDisable(!controllerIsDisabled);
 }
@@ -213,6 +293,29 @@ void IterativePosPIDController::setGains(const Gains &igains) {
   kBias = igains.kBias;
 }
 
+void IterativePosPIDController::setFeedforward(const MotorFeedforward &ifeedforward) {
+  feedforward = ifeedforward;
+}
+
+MotorFeedforward IterativePosPIDController::getFeedforward() const {
+  return feedforward;
+}
+
+void IterativePosPIDController::setGainSchedule(const GainSchedule &ischedule) {
+  setGainSchedule(ischedule, nullptr);
+}
+
+void IterativePosPIDController::setGainSchedule(const GainSchedule &ischedule,
+                                                std::shared_ptr<ControllerInput<double>> iinput) {
+  gainSchedule = std::make_unique<GainSchedule>(ischedule);
+  gainScheduleInput = std::move(iinput);
+}
+
+void IterativePosPIDController::clearGainSchedule() {
+  gainSchedule = nullptr;
+  gainScheduleInput = nullptr;
+}
+
 IterativePosPIDController::Gains IterativePosPIDController::getGains() const {
   return {kP, kI / sampleTime.convert(second), kD * sampleTime.convert(second), kBias};
 }
@@ -226,4 +329,56 @@ bool IterativePosPIDController::Gains::operator!=(
   const IterativePosPIDController::Gains &rhs) const {
   return !(rhs == *this);
 }
+
+IterativePosPIDController::GainSchedule::GainSchedule(std::vector<Point> ipoints,
+                                                      const std::shared_ptr<Logger> &logger)
+  : points(std::move(ipoints)) {
+  if (points.empty()) {
+    std::string msg("IterativePosPIDController::GainSchedule: The schedule must have a point.");
+    LOG_ERROR(msg);
+    throw std::invalid_argument(msg);
+  }
+
+  std::sort(points.begin(), points.end(), [](const Point &a, const Point &b) {
+    return a.key < b.key;
+  });
+
+  for (std::size_t i = 1; i < points.size(); i++) {
+    if (points[i].key == points[i - 1].key) {
+      std::string msg("IterativePosPIDController::GainSchedule: Two points have the key " +
+                      std::to_string(points[i].key) + ".");
+      LOG_ERROR(msg);
+      throw std::invalid_argument(msg);
+    }
+  }
+}
+
+IterativePosPIDController::Gains
+IterativePosPIDController::GainSchedule::at(const double ikey) const {
+  if (ikey <= points.front().key) {
+    return points.front().gains;
+  } else if (ikey >= points.back().key) {
+    return points.back().gains;
+  }
+
+  // The first point past the key, which is never the first point
+  const auto upper = std::upper_bound(
+    points.begin(), points.end(), ikey, [](const double key, const Point &point) {
+      return key < point.key;
+    });
+  const auto &high = *upper;
+  const auto &low = *(upper - 1);
+
+  const double t = (ikey - low.key) / (high.key - low.key);
+  const auto lerp = [t](const double a, const double b) { return a + (b - a) * t; };
+  return {lerp(low.gains.kP, high.gains.kP),
+          lerp(low.gains.kI, high.gains.kI),
+          lerp(low.gains.kD, high.gains.kD),
+          lerp(low.gains.kBias, high.gains.kBias)};
+}
+
+const std::vector<IterativePosPIDController::GainSchedule::Point> &
+IterativePosPIDController::GainSchedule::getPoints() const {
+  return points;
+}
 } // namespace okapi
@@ -0,0 +1,207 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#include "okapi/api/control/iterative/iterativeTbhController.hpp"
+#include "okapi/api/util/mathUtil.hpp"
+#include <algorithm>
+#include <cmath>
+
+namespace okapi {
+IterativeTBHController::IterativeTBHController(const Gains &igains,
+                                               std::unique_ptr<VelMath> ivelMath,
+                                               const TimeUtil &itimeUtil,
+                                               std::shared_ptr<Logger> ilogger)
+  : logger(std::move(ilogger)),
+    velMath(std::move(ivelMath)),
+    loopDtTimer(itimeUtil.getTimer()),
+    settledUtil(itimeUtil.getSettledUtil()) {
+  setOutputLimits(1, -1);
+  setGains(igains);
+}
+
+void IterativeTBHController::setSampleTime(const QTime isampleTime) {
+  if (isampleTime > 0_ms) {
+    kI *= isampleTime.convert(millisecond) / sampleTime.convert(millisecond);
+    sampleTime = isampleTime;
+  }
+}
+
+void IterativeTBHController::setOutputLimits(double imax, double imin) {
+  // Always use larger value as max
+  if (imin > imax) {
+    const double temp = imax;
+    imax = imin;
+    imin = temp;
+  }
+
+  outputMax = imax;
+  outputMin = imin;
+
+  output = std::clamp(output, outputMin, outputMax);
+  takeBackHalf = std::clamp(takeBackHalf, outputMin, outputMax);
+}
+
+void IterativeTBHController::setControllerSetTargetLimits(double itargetMax, double itargetMin) {
+  // Always use larger value as max
+  if (itargetMin > itargetMax) {
+    const double temp = itargetMax;
+    itargetMax = itargetMin;
+    itargetMin = temp;
+  }
+
+  controllerSetTargetMax = itargetMax;
+  controllerSetTargetMin = itargetMin;
+}
+
+QAngularSpeed IterativeTBHController::stepVel(const double inewReading) {
+  return velMath->step(inewReading);
+}
+
+double IterativeTBHController::step(const double inewReading) {
+  auto profile = stepProfiler.start();
+  if (!controllerIsDisabled) {
+    loopDtTimer->placeHardMark();
+
+    if (loopDtTimer->getDtFromHardMark() >= sampleTime) {
+      stepVel(inewReading);
+      error = getError();
+
+      output = std::clamp(output + kI * error, outputMin, outputMax);
+
+      // The velocity crossed the target, so take back half of the output gained since the last
+      // crossing
+      if (std::signbit(error) != std::signbit(lastError)) {
+        if (isFirstCrossing) {
+          // Jump to the guess, or halve the output if there is no guess
+          output = kF != 0 ? takeBackHalf : 0.5 * (output + takeBackHalf);
+          isFirstCrossing = false;
+        } else {
+          output = 0.5 * (output + takeBackHalf);
+        }
+
+        takeBackHalf = output;
+      }
+      lastError = error;
+
+      loopDtTimer->clearHardMark(); // Important that we only clear if dt >= sampleTime
+
+      settledUtil->isSettled(error);
+    } else {
+      profile.skip();
+    }
+
+    return output;
+  }
+
+  return 0;
+}
+
+void IterativeTBHController::setTarget(const double itarget) {
+  LOG_INFO("IterativeTBHController: Set target to " + std::to_string(itarget));
+  retarget(itarget);
+}
+
+void IterativeTBHController::controllerSet(const double ivalue) {
+  retarget(remapRange(ivalue, -1, 1, controllerSetTargetMin, controllerSetTargetMax));
+}
+
+void IterativeTBHController::retarget(const double itarget) {
+  if (itarget == target) {
+    return;
+  }
+
+  target = itarget;
+  takeBackHalf = std::clamp(kF * target, outputMin, outputMax);
+  isFirstCrossing = true;
+
+  // Crossings are measured against the new target
+  lastError = getError();
+}
+
+double IterativeTBHController::getTarget() {
+  return target;
+}
+
+double IterativeTBHController::getTarget() const {
+  return target;
+}
+
+double IterativeTBHController::getProcessValue() const {
+  return unit_cast<rpm>(velMath->getVelocity());
+}
+
+double IterativeTBHController::getOutput() const {
+  return isDisabled() ? 0 : output;
+}
+
+double IterativeTBHController::getMaxOutput() {
+  return outputMax;
+}
+
+double IterativeTBHController::getMinOutput() {
+  return outputMin;
+}
+
+double IterativeTBHController::getError() const {
+  return getTarget() - getProcessValue();
+}
+
+bool IterativeTBHController::isSettled() {
+  return isDisabled() ? true : settledUtil->isSettled(error);
+}
+
+void IterativeTBHController::reset() {
+  LOG_INFO_S("IterativeTBHController: Reset");
+
+  error = 0;
+  lastError = getError();
+  output = 0;
+  takeBackHalf = std::clamp(kF * target, outputMin, outputMax);
+  isFirstCrossing = true;
+  settledUtil->reset();
+}
+
+void IterativeTBHController::flipDisable() {
+  flipDisable(!controllerIsDisabled);
+}
+
+void IterativeTBHController::flipDisable(const bool iisDisabled) {
+  LOG_INFO("IterativeTBHController: flipDisable " + std::to_string(iisDisabled));
+  controllerIsDisabled = iisDisabled;
+}
+
+bool IterativeTBHController::isDisabled() const {
+  return controllerIsDisabled;
+}
+
+void IterativeTBHController::setGains(const Gains &igains) {
+  kI = igains.kI * sampleTime.convert(second);
+  kF = igains.kF;
+}
+
+IterativeTBHController::Gains IterativeTBHController::getGains() const {
+  return {kI / sampleTime.convert(second), kF};
+}
+
+void IterativeTBHController::setTicksPerRev(const double tpr) {
+  velMath->setTicksPerRev(tpr);
+}
+
+QAngularSpeed IterativeTBHController::getVel() const {
+  return velMath->getVelocity();
+}
+
+QTime IterativeTBHController::getSampleTime() const {
+  return sampleTime;
+}
+
+bool IterativeTBHController::Gains::operator==(const IterativeTBHController::Gains &rhs) const {
+  return kI == rhs.kI && kF == rhs.kF;
+}
+
+bool IterativeTBHController::Gains::operator!=(const IterativeTBHController::Gains &rhs) const {
+  return !(rhs == *this);
+}
+} // namespace okapi
@@ -77,6 +77,7 @@ QAngularSpeed IterativeVelPIDController::stepVel(const double inewReading) {
 }
 
 double IterativeVelPIDController::step(const double inewReading) {
+  auto profile = stepProfiler.start();
   if (!controllerIsDisabled) {
     loopDtTimer->placeHardMark();
 
@@ -84,6 +85,10 @@ double IterativeVelPIDController::step(const double inewReading) {
       stepVel(inewReading);
       error = getError();
 
+      const double dt = loopDtTimer->getDtFromHardMark().convert(second);
+      targetAcceleration = dt > 0 ? (target - lastTarget) / dt : 0;
+      lastTarget = target;
+
       // Derivative over measurement to eliminate derivative kick on setpoint change
       derivative = derivativeFilter->filter(velMath->getAccel().getValue());
 
@@ -93,10 +98,14 @@ double IterativeVelPIDController::step(const double inewReading) {
       loopDtTimer->clearHardMark(); // Important that we only clear if dt >= sampleTime
 
       settledUtil->isSettled(error);
+    } else {
+      profile.skip();
     }
 
-    output =
-      std::clamp(outputSum + kF * target + kSF * std::copysign(1.0, target), outputMin, outputMax);
+    output = std::clamp(outputSum + kF * target + kSF * std::copysign(1.0, target) +
+                          kA * targetAcceleration,
+                        outputMin,
+                        outputMax);
     return output;
   }
 
@@ -121,7 +130,7 @@ double IterativeVelPIDController::getTarget() const {
 }
 
 double IterativeVelPIDController::getProcessValue() const {
-  return velMath->getVelocity().convert(rpm);
+  return unit_cast<rpm>(velMath->getVelocity());
 }
 
 double IterativeVelPIDController::getOutput() const {
@@ -150,6 +159,7 @@ void IterativeVelPIDController::reset() {
   error = 0;
   outputSum = 0;
   output = 0;
+  targetAcceleration = 0;
   settledUtil->reset();
 }
 
@@ -171,10 +181,11 @@ void IterativeVelPIDController::setGains(const Gains &igains) {
   kD = igains.kD / sampleTime.convert(second);
   kF = igains.kF;
   kSF = igains.kSF;
+  kA = igains.kA;
 }
 
 IterativeVelPIDController::Gains IterativeVelPIDController::getGains() const {
-  return {kP, kD * sampleTime.convert(second), kF, kSF};
+  return {kP, kD * sampleTime.convert(second), kF, kSF, kA};
 }
 
 void IterativeVelPIDController::setTicksPerRev(const double tpr) {
@@ -191,7 +202,7 @@ QTime IterativeVelPIDController::getSampleTime() const {
 
 bool IterativeVelPIDController::Gains::operator==(
   const IterativeVelPIDController::Gains &rhs) const {
-  return kP == rhs.kP && kD == rhs.kD && kF == rhs.kF && kSF == rhs.kSF;
+  return kP == rhs.kP && kD == rhs.kD && kF == rhs.kF && kSF == rhs.kSF && kA == rhs.kA;
 }
 
 bool IterativeVelPIDController::Gains::operator!=(
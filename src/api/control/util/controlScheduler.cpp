@@ -0,0 +1,139 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#include "okapi/api/control/util/controlScheduler.hpp"
+#include <algorithm>
+#include <cmath>
+#include <mutex>
+
+namespace okapi {
+ControlScheduler::ControlScheduler(const TimeUtil &itimeUtil, std::shared_ptr<Logger> ilogger)
+  : logger(std::move(ilogger)), timeUtil(itimeUtil), timer(timeUtil.getTimer()) {
+}
+
+ControlScheduler::~ControlScheduler() {
+  dtorCalled.store(true, std::memory_order_release);
+  if (task) {
+    task->notify();
+  }
+  delete task;
+}
+
+std::size_t ControlScheduler::addLoop(std::function<void()> istep,
+                                      std::function<QTime()> iperiod,
+                                      const phase iphase) {
+  std::size_t id;
+  {
+    std::scoped_lock lock(loopsMutex);
+    id = nextId++;
+
+    // Keep the loops sorted by phase, after the loops which were added before in the same phase
+    const auto position =
+      std::upper_bound(loops.begin(), loops.end(), iphase, [](const phase ip, const Loop &loop) {
+        return ip < loop.loopPhase;
+      });
+    loops.insert(position, Loop{id, iphase, std::move(istep), std::move(iperiod), 0_ms, false});
+  }
+
+  LOG_INFO("ControlScheduler: Added loop " + std::to_string(id));
+
+  // Step the new loop now instead of after the current sleep
+  if (task) {
+    task->notify();
+  }
+
+  return id;
+}
+
+void ControlScheduler::removeLoop(const std::size_t iid) {
+  std::scoped_lock lock(loopsMutex);
+  const auto it =
+    std::find_if(loops.begin(), loops.end(), [&](const Loop &loop) { return loop.id == iid; });
+  if (it == loops.end()) {
+    LOG_WARN("ControlScheduler: Tried to remove loop " + std::to_string(iid) +
+             " which was not added.");
+    return;
+  }
+
+  loops.erase(it);
+  LOG_INFO("ControlScheduler: Removed loop " + std::to_string(iid));
+}
+
+std::size_t ControlScheduler::getLoopCount() const {
+  std::scoped_lock lock(loopsMutex);
+  return loops.size();
+}
+
+std::uint32_t ControlScheduler::getOverrunCount() const {
+  return overrunCount.load(std::memory_order_relaxed);
+}
+
+void ControlScheduler::startThread(const std::uint32_t ipriority,
+                                   const std::uint16_t istackDepth) {
+  if (!task) {
+    task = new CrossplatformThread(trampoline, this, "ControlScheduler", ipriority, istackDepth);
+  }
+}
+
+CrossplatformThread *ControlScheduler::getThread() const {
+  return task;
+}
+
+void ControlScheduler::trampoline(void *context) {
+  if (context) {
+    static_cast<ControlScheduler *>(context)->loop();
+  }
+}
+
+void ControlScheduler::loop() {
+  LOG_INFO_S("Started ControlScheduler task.");
+
+  while (!dtorCalled.load(std::memory_order_acquire)) {
+    const QTime nextRun = stepDueLoops(timer->millis());
+    const QTime now = timer->millis();
+    const auto sleepTime =
+      nextRun > now ? static_cast<std::uint32_t>(std::ceil((nextRun - now).convert(millisecond)))
+                    : 0u;
+
+    // A wake means a loop was added. Any other notification means the task which made this
+    // scheduler was deleted, so stop.
+    if (CrossplatformThread::notifyTake(sleepTime) & ~CrossplatformThread::wakeNotification) {
+      break;
+    }
+  }
+
+  LOG_INFO_S("Stopped ControlScheduler task.");
+}
+
+QTime ControlScheduler::stepDueLoops(const QTime inow) {
+  std::scoped_lock lock(loopsMutex);
+
+  QTime earliest = inow + idleLoopTimeout * millisecond;
+  for (auto &loop : loops) {
+    if (!loop.started) {
+      // Start on a multiple of the period so loops with the same period run in phase
+      const QTime period = std::max(loop.period(), 1_ms);
+      loop.nextRun = std::floor((inow / period).getValue()) * period;
+      loop.started = true;
+    }
+
+    if (loop.nextRun <= inow) {
+      loop.step();
+
+      const QTime period = std::max(loop.period(), 1_ms);
+      loop.nextRun += period;
+      if (loop.nextRun <= inow) {
+        // Skip the steps which were missed instead of running them back to back
+        overrunCount.fetch_add(1, std::memory_order_relaxed);
+        loop.nextRun += (std::floor(((inow - loop.nextRun) / period).getValue()) + 1) * period;
+      }
+    }
+
+    earliest = std::min(earliest, loop.nextRun);
+  }
+
+  return earliest;
+}
+} // namespace okapi
@@ -0,0 +1,92 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#include "okapi/api/control/util/coprocessorClient.hpp"
+#include "okapi/api/control/util/pathBinaryFormat.hpp"
+#include <cstring>
+#include <sstream>
+
+namespace okapi {
+template <typename T> static void appendField(std::vector<std::uint8_t> &obuffer, const T ivalue) {
+  std::uint8_t bytes[sizeof(T)];
+  std::memcpy(bytes, &ivalue, sizeof(T));
+  obuffer.insert(obuffer.end(), bytes, bytes + sizeof(T));
+}
+
+template <typename T> static T readField(const std::uint8_t *ibuffer) {
+  T value;
+  std::memcpy(&value, ibuffer, sizeof(T));
+  return value;
+}
+
+CoprocessorClient::CoprocessorClient(std::shared_ptr<SerialLink> ilink,
+                                     const TimeUtil &itimeUtil,
+                                     const QTime &itimeout,
+                                     std::shared_ptr<Logger> ilogger)
+  : logger(std::move(ilogger)), link(std::move(ilink)), timeUtil(itimeUtil), timeout(itimeout) {
+}
+
+std::optional<std::vector<squiggles::ProfilePoint>>
+CoprocessorClient::generateProfile(const std::vector<PathfinderPoint> &iwaypoints,
+                                   const PathfinderLimits &ilimits,
+                                   const QLength &iwheelTrack,
+                                   const QSpeed &istartVelocity,
+                                   const QSpeed &iendVelocity) {
+  std::vector<std::uint8_t> request;
+  request.reserve(sizeof(float) * (6 + 3 * iwaypoints.size()));
+  appendField(request, static_cast<float>(iwheelTrack.convert(meter)));
+  appendField(request, static_cast<float>(istartVelocity.convert(mps)));
+  appendField(request, static_cast<float>(iendVelocity.convert(mps)));
+  appendField(request, static_cast<float>(ilimits.maxVel));
+  appendField(request, static_cast<float>(ilimits.maxAccel));
+  appendField(request, static_cast<float>(ilimits.maxJerk));
+  for (const auto &point : iwaypoints) {
+    appendField(request, static_cast<float>(point.x.convert(meter)));
+    appendField(request, static_cast<float>(point.y.convert(meter)));
+    appendField(request, static_cast<float>(point.theta.convert(radian)));
+  }
+
+  const auto response = link->call(generateProfileType, request.data(), request.size(), timeout);
+  if (!response) {
+    return std::nullopt;
+  }
+
+  std::istringstream stream(std::string(response->begin(), response->end()));
+  auto profile = PathBinaryFormat::deserialize(stream);
+  if (!profile) {
+    LOG_WARN_S("CoprocessorClient: The coprocessor sent an invalid profile.");
+  }
+
+  return profile;
+}
+
+void CoprocessorClient::forwardPoseEstimates(const std::shared_ptr<Odometry> &iodometry,
+                                             const double iweight) {
+  if (!iodometry) {
+    link->onMessage(poseEstimateType, nullptr);
+    return;
+  }
+
+  // The handler can outlive this client, so it owns what it uses
+  std::shared_ptr<AbstractTimer> timer = timeUtil.getTimer();
+  link->onMessage(
+    poseEstimateType,
+    [timer, odometry = iodometry, iweight, logger = logger](const std::uint8_t *ipayload,
+                                                            const std::size_t ilength) {
+      if (ilength != sizeof(std::uint16_t) + 3 * sizeof(float)) {
+        LOG_WARN("CoprocessorClient: Ignored a pose estimate of " + std::to_string(ilength) +
+                 " bytes.");
+        return;
+      }
+
+      const QTime age = readField<std::uint16_t>(ipayload) * millisecond;
+      const std::uint8_t *pose = ipayload + sizeof(std::uint16_t);
+      const OdomState estimate{readField<float>(pose) * meter,
+                               readField<float>(pose + sizeof(float)) * meter,
+                               readField<float>(pose + 2 * sizeof(float)) * radian};
+      odometry->applyPoseEstimate(estimate, timer->millis() - age, iweight);
+    });
+}
+} // namespace okapi
@@ -0,0 +1,197 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#include "okapi/api/control/util/diffDriveMpc.hpp"
+#include "okapi/api/util/mathUtil.hpp"
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+#include <string>
+
+namespace okapi {
+DiffDriveMpc::DiffDriveMpc(const QLength &iwheelTrack,
+                           const QSpeed &imaxWheelVelocity,
+                           const DiffDriveMpcParams &iparams,
+                           const std::shared_ptr<Logger> &ilogger)
+  : logger(ilogger),
+    wheelTrack(iwheelTrack.convert(meter)),
+    maxWheelVelocity(imaxWheelVelocity.convert(mps)),
+    params(iparams) {
+  if (!(wheelTrack > 0) || !(maxWheelVelocity > 0) || !(params.modelStep > 0_ms)) {
+    std::string msg("DiffDriveMpc: The wheel track, max wheel velocity, and model step must be "
+                    "positive.");
+    LOG_ERROR(msg);
+    throw std::invalid_argument(msg);
+  }
+
+  if (params.positionWeight < 0 || params.headingWeight < 0 || params.controlWeight < 0) {
+    std::string msg("DiffDriveMpc: The weights must not be negative.");
+    LOG_ERROR(msg);
+    throw std::invalid_argument(msg);
+  }
+}
+
+std::pair<double, double> DiffDriveMpc::step(const double ixError,
+                                             const double iyError,
+                                             const double iheadingError,
+                                             const double ivelocity,
+                                             const double iangularVelocity) {
+  buildProgram({ixError, iyError, std::remainder(iheadingError, 2 * pi)},
+               ivelocity,
+               iangularVelocity);
+
+  // The last solution, one step later, is a good guess at this one
+  std::rotate(solution.begin(), solution.begin() + inputs, solution.end());
+  std::copy(solution.end() - 2 * inputs, solution.end() - inputs, solution.end() - inputs);
+
+  solve();
+
+  const double halfTrack = wheelTrack / 2;
+  return {std::clamp(ivelocity - iangularVelocity * halfTrack + solution[0],
+                     -maxWheelVelocity,
+                     maxWheelVelocity),
+          std::clamp(ivelocity + iangularVelocity * halfTrack + solution[1],
+                     -maxWheelVelocity,
+                     maxWheelVelocity)};
+}
+
+void DiffDriveMpc::reset() {
+  solution.fill(0);
+}
+
+const DiffDriveMpcParams &DiffDriveMpc::getParams() const {
+  return params;
+}
+
+void DiffDriveMpc::buildProgram(const State &ierror,
+                                const double ivelocity,
+                                const double iangularVelocity) {
+  const double h = params.modelStep.convert(second);
+
+  // The error dynamics linearized around the profile, with the error being where the profile is
+  // in the frame of the robot:
+  //   x' =  w * y - dv
+  //   y' = -w * x + v * theta
+  //   theta' = -dw
+  // where dv = (dl + dr) / 2 and dw = (dr - dl) / track are the changes to the profile's wheel
+  // velocities
+  const StateMatrix ad{{{1, h * iangularVelocity, 0}, {-h * iangularVelocity, 1, h * ivelocity},
+                        {0, 0, 1}}};
+  InputMatrix bd{{{-h / 2, -h / 2}, {0, 0}, {h / wheelTrack, -h / wheelTrack}}};
+
+  const auto multiply = [&](const State &istate) {
+    State out{};
+    for (std::size_t r = 0; r < states; r++) {
+      for (std::size_t c = 0; c < states; c++) {
+        out[r] += ad[r][c] * istate[c];
+      }
+    }
+    return out;
+  };
+
+  // Ad^k Bd column by column, and Ad^(k + 1) e0
+  State free = ierror;
+  for (std::size_t k = 0; k < horizon; k++) {
+    inputResponse[k] = bd;
+    for (std::size_t c = 0; c < inputs; c++) {
+      const State next = multiply({bd[0][c], bd[1][c], bd[2][c]});
+      for (std::size_t r = 0; r < states; r++) {
+        bd[r][c] = next[r];
+      }
+    }
+
+    free = multiply(free);
+    freeResponse[k] = free;
+  }
+
+  const State weights{params.positionWeight, params.positionWeight, params.headingWeight};
+
+  // The input at step j moves the error at every step k >= j by inputResponse[k - j], so the cost
+  // of the errors is a sum over the steps after both inputs
+  for (std::size_t j1 = 0; j1 < horizon; j1++) {
+    for (std::size_t j2 = j1; j2 < horizon; j2++) {
+      for (std::size_t a = 0; a < inputs; a++) {
+        for (std::size_t b = 0; b < inputs; b++) {
+          double sum = 0;
+          for (std::size_t k = j2; k < horizon; k++) {
+            for (std::size_t s = 0; s < states; s++) {
+              sum += weights[s] * inputResponse[k - j1][s][a] * inputResponse[k - j2][s][b];
+            }
+          }
+
+          hessian[j1 * inputs + a][j2 * inputs + b] = sum;
+          hessian[j2 * inputs + b][j1 * inputs + a] = sum;
+        }
+      }
+    }
+  }
+
+  for (std::size_t i = 0; i < variables; i++) {
+    hessian[i][i] += params.controlWeight;
+  }
+
+  for (std::size_t j = 0; j < horizon; j++) {
+    for (std::size_t a = 0; a < inputs; a++) {
+      double sum = 0;
+      for (std::size_t k = j; k < horizon; k++) {
+        for (std::size_t s = 0; s < states; s++) {
+          sum += inputResponse[k - j][s][a] * weights[s] * freeResponse[k][s];
+        }
+      }
+      gradientOffset[j * inputs + a] = sum;
+    }
+  }
+
+  // The profile's wheel velocities are taken to hold over the horizon, so each change can only
+  // use what is left before its wheel hits the max velocity
+  const double halfTrack = wheelTrack / 2;
+  const std::array<double, inputs> profileWheels{ivelocity - iangularVelocity * halfTrack,
+                                                 ivelocity + iangularVelocity * halfTrack};
+  for (std::size_t j = 0; j < horizon; j++) {
+    for (std::size_t a = 0; a < inputs; a++) {
+      lower[j * inputs + a] = -maxWheelVelocity - profileWheels[a];
+      upper[j * inputs + a] = maxWheelVelocity - profileWheels[a];
+    }
+  }
+}
+
+void DiffDriveMpc::solve() {
+  // The largest absolute row sum bounds the largest eigenvalue of the Hessian, which makes its
+  // inverse a step size the iterations can't diverge with
+  double lipschitz = 0;
+  for (const auto &row : hessian) {
+    double sum = 0;
+    for (const double value : row) {
+      sum += std::abs(value);
+    }
+    lipschitz = std::max(lipschitz, sum);
+  }
+
+  if (!(lipschitz > 0)) {
+    solution.fill(0);
+    return;
+  }
+
+  const double stepSize = 1 / lipschitz;
+  for (std::size_t i = 0; i < variables; i++) {
+    solution[i] = std::clamp(solution[i], lower[i], upper[i]);
+  }
+
+  std::array<double, variables> gradient{};
+  for (std::size_t iteration = 0; iteration < params.iterations; iteration++) {
+    for (std::size_t r = 0; r < variables; r++) {
+      double sum = gradientOffset[r];
+      for (std::size_t c = 0; c < variables; c++) {
+        sum += hessian[r][c] * solution[c];
+      }
+      gradient[r] = sum;
+    }
+
+    for (std::size_t i = 0; i < variables; i++) {
+      solution[i] = std::clamp(solution[i] - stepSize * gradient[i], lower[i], upper[i]);
+    }
+  }
+}
+} // namespace okapi
@@ -14,13 +14,15 @@ FlywheelSimulator::FlywheelSimulator(const double imass,
                                      const double ilinkLen,
                                      const double imuStatic,
                                      const double imuDynamic,
-                                     const double itimestep)
+                                     const double itimestep,
+                                     const Integrator iintegrator)
   : mass(imass),
     linkLen(ilinkLen),
     muStatic(imuStatic),
     muDynamic(imuDynamic),
     timestep(itimestep),
     I(mass * ipow(linkLen, 2)),
+    integrator(iintegrator),
     torqueFunc([](double iiangle, double iimass, double iilinkLen) {
       return (iilinkLen * std::cos(iiangle)) * (iimass * -1 * gravity);
     }) {
@@ -38,25 +40,38 @@ double FlywheelSimulator::step(const double itorque) {
 }
 
 double FlywheelSimulator::stepImpl() {
-  double torqueTotal = inputTorque + torqueFunc(angle, mass, linkLen);
-
-  if (omega == 0 && muStatic > std::fabs(torqueTotal)) {
-    torqueTotal = 0;
-  }
-
-  if (omega != 0) {
-    if (torqueTotal > 0) {
-      torqueTotal -= muDynamic * omega;
-    } else {
-      torqueTotal += muDynamic * omega * -1;
-    }
+  switch (integrator) {
+  case Integrator::semiImplicitEuler:
+    accel = computeAcceleration(angle, omega);
+    omega += accel * timestep;
+    angle += omega * timestep;
+    break;
+
+  case Integrator::rk4: {
+    const double halfStep = timestep / 2;
+    const double a1 = computeAcceleration(angle, omega);
+    const double v2 = omega + a1 * halfStep;
+    const double a2 = computeAcceleration(angle + omega * halfStep, v2);
+    const double v3 = omega + a2 * halfStep;
+    const double a3 = computeAcceleration(angle + v2 * halfStep, v3);
+    const double v4 = omega + a3 * timestep;
+    const double a4 = computeAcceleration(angle + v3 * timestep, v4);
+
+    accel = a1;
+    angle += (omega + 2 * v2 + 2 * v3 + v4) * timestep / 6;
+    omega += (a1 + 2 * a2 + 2 * a3 + a4) * timestep / 6;
+    break;
   }
 
-  accel = torqueTotal / I;
-  omega += accel * ipow(timestep, 2);
+  case Integrator::euler:
+  default:
+    accel = computeAcceleration(angle, omega);
+    omega += accel * ipow(timestep, 2);
 
-  if (omega != 0) {
-    angle += omega * timestep;
+    if (omega != 0) {
+      angle += omega * timestep;
+    }
+    break;
   }
 
   if (radianToDegree * angle > 181) {
@@ -72,6 +87,24 @@ double FlywheelSimulator::stepImpl() {
   return angle;
 }
 
+double FlywheelSimulator::computeAcceleration(const double iangle, const double iomega) const {
+  double torqueTotal = inputTorque + torqueFunc(iangle, mass, linkLen);
+
+  if (iomega == 0 && muStatic > std::fabs(torqueTotal)) {
+    torqueTotal = 0;
+  }
+
+  if (iomega != 0) {
+    if (torqueTotal > 0) {
+      torqueTotal -= muDynamic * iomega;
+    } else {
+      torqueTotal += muDynamic * iomega * -1;
+    }
+  }
+
+  return torqueTotal / I;
+}
+
 void FlywheelSimulator::setExternalTorqueFunction(
   std::function<double(double, double, double)> itorqueFunc) {
   torqueFunc = std::move(itorqueFunc);
@@ -0,0 +1,112 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#include "okapi/api/control/util/incrementalPathGenerator.hpp"
+#include "okapi/api/control/util/profileGenerator.hpp"
+#include "okapi/api/control/util/profileRetimer.hpp"
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+#include <string>
+
+namespace okapi {
+IncrementalPathGenerator::IncrementalPathGenerator(const PathfinderLimits &ilimits,
+                                                   const QLength &iwheelTrack,
+                                                   const std::shared_ptr<Logger> &ilogger)
+  : logger(ilogger), limits(ilimits), wheelTrack(iwheelTrack) {
+  if (!(ilimits.maxVel > 0) || !(ilimits.maxAccel > 0)) {
+    std::string msg("IncrementalPathGenerator: The max velocity and acceleration must be "
+                    "positive.");
+    LOG_ERROR(msg);
+    throw std::invalid_argument(msg);
+  }
+}
+
+std::vector<squiggles::ProfilePoint>
+IncrementalPathGenerator::generate(const std::vector<PathfinderPoint> &iwaypoints,
+                                   const QSpeed &istartVelocity,
+                                   const QSpeed &iendVelocity) {
+  const double startVel = istartVelocity.convert(mps);
+  const double endVel = iendVelocity.convert(mps);
+  if (iwaypoints.size() < 2 || startVel < 0 || startVel > limits.maxVel || endVel < 0 ||
+      endVel > limits.maxVel) {
+    std::string msg("IncrementalPathGenerator: There must be at least two waypoints, and the "
+                    "start and end velocities must be between zero and the maximum velocity.");
+    LOG_ERROR(msg);
+    throw std::invalid_argument(msg);
+  }
+
+  // Build the new segments on the side so nothing is lost if generating one throws
+  std::vector<Segment> next;
+  next.reserve(iwaypoints.size() - 1);
+  std::size_t generated = 0;
+  for (std::size_t i = 0; i + 1 < iwaypoints.size(); ++i) {
+    const auto &start = iwaypoints[i];
+    const auto &end = iwaypoints[i + 1];
+    const auto old = std::find_if(segments.begin(), segments.end(), [&](const Segment &segment) {
+      return isSameWaypoint(segment.start, start) && isSameWaypoint(segment.end, end);
+    });
+
+    if (old != segments.end()) {
+      // Each old segment is reused at most once, in case a pair of waypoints repeats
+      next.push_back(std::move(*old));
+      segments.erase(old);
+    } else {
+      next.push_back({start, end, ProfileGenerator::generate({start, end}, limits, wheelTrack)});
+      ++generated;
+    }
+  }
+
+  // Neighbouring segments share their joining point, which the retimer drops
+  std::vector<squiggles::ProfilePoint> path;
+  for (const auto &segment : next) {
+    path.insert(path.end(), segment.profile.begin(), segment.profile.end());
+  }
+
+  segments = std::move(next);
+  generatedSegmentCount = generated;
+  LOG_DEBUG("IncrementalPathGenerator: Generated " + std::to_string(generated) + " of " +
+            std::to_string(segments.size()) + " segments");
+
+  if (path.empty()) {
+    return path;
+  }
+
+  path.front().vector.vel = startVel;
+  path.back().vector.vel = endVel;
+  path.front().time = 0;
+
+  // This matches squiggles::TankModel, which limits the outer wheel to the max velocity
+  const double halfTrack = wheelTrack.convert(meter) / 2;
+  const double maxVel = limits.maxVel;
+  const double maxAccel = limits.maxAccel;
+  return ProfileRetimer::retime(
+    path,
+    halfTrack,
+    [&](const double icurvature) {
+      return maxVel / std::max(std::abs(1 - icurvature * halfTrack),
+                               std::abs(1 + icurvature * halfTrack));
+    },
+    [&](double, double) { return maxAccel; },
+    [&](double) { return maxAccel; });
+}
+
+void IncrementalPathGenerator::clear() {
+  segments.clear();
+}
+
+std::size_t IncrementalPathGenerator::getGeneratedSegmentCount() const {
+  return generatedSegmentCount;
+}
+
+const PathfinderLimits &IncrementalPathGenerator::getLimits() const {
+  return limits;
+}
+
+bool IncrementalPathGenerator::isSameWaypoint(const PathfinderPoint &ia,
+                                              const PathfinderPoint &ib) {
+  return ia.x == ib.x && ia.y == ib.y && ia.theta == ib.theta;
+}
+} // namespace okapi
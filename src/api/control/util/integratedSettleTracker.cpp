@@ -0,0 +1,62 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#include "okapi/api/control/util/integratedSettleTracker.hpp"
+#include <algorithm>
+#include <cmath>
+
+namespace okapi {
+IntegratedSettleTracker::IntegratedSettleTracker(const double iatTargetError,
+                                                 const double iatTargetVelocity,
+                                                 const std::uint32_t iupdates)
+  : atTargetError(std::abs(iatTargetError)),
+    atTargetVelocity(std::abs(iatTargetVelocity)),
+    updatesToSettle(std::max<std::uint32_t>(iupdates, 1)) {
+}
+
+bool IntegratedSettleTracker::update(const double ierror,
+                                     const double ivelocity,
+                                     const bool istopped) {
+  tracking.store(true, std::memory_order_release);
+
+  const bool stopped = istopped || std::abs(ivelocity) <= atTargetVelocity;
+  if (std::abs(ierror) > atTargetError || !stopped) {
+    settledUpdates.store(0, std::memory_order_release);
+    return false;
+  }
+
+  if (isSettled()) {
+    return true;
+  }
+
+  if (settledUpdates.fetch_add(1, std::memory_order_acq_rel) + 1 == updatesToSettle) {
+    settledEvent.notifyAll();
+    return true;
+  }
+
+  return false;
+}
+
+void IntegratedSettleTracker::reset() {
+  settledUpdates.store(0, std::memory_order_release);
+}
+
+bool IntegratedSettleTracker::isSettled() const {
+  return settledUpdates.load(std::memory_order_acquire) >= updatesToSettle;
+}
+
+bool IntegratedSettleTracker::isTracking() const {
+  return tracking.load(std::memory_order_acquire);
+}
+
+std::uint32_t IntegratedSettleTracker::getGeneration() const {
+  return settledEvent.getGeneration();
+}
+
+void IntegratedSettleTracker::waitFor(const std::uint32_t igeneration,
+                                      const std::uint32_t itimeout) {
+  settledEvent.waitFor(igeneration, itimeout);
+}
+} // namespace okapi
@@ -0,0 +1,86 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#include "okapi/api/control/util/loopTimingRecorder.hpp"
+#include "okapi/api/util/flightRecorder.hpp"
+#include <algorithm>
+#include <mutex>
+
+namespace okapi {
+std::string LoopTimingStats::toString() const {
+  return "samples=" + std::to_string(sampleCount) + " overruns=" + std::to_string(overrunCount) +
+         " min=" + std::to_string(minDt.convert(millisecond)) +
+         "ms max=" + std::to_string(maxDt.convert(millisecond)) +
+         "ms mean=" + std::to_string(meanDt.convert(millisecond)) +
+         "ms p99=" + std::to_string(p99Dt.convert(millisecond)) + "ms";
+}
+
+LoopTimingRecorder::LoopTimingRecorder(const char *isource) : source(isource) {
+}
+
+void LoopTimingRecorder::record(const QTime idt, const QTime iperiod) {
+  std::scoped_lock lock(mutex);
+
+  if (sampleCount == 0) {
+    minDt = idt;
+    maxDt = idt;
+  } else {
+    minDt = std::min(minDt, idt);
+    maxDt = std::max(maxDt, idt);
+  }
+
+  totalDt += idt;
+  sampleCount++;
+
+  if (idt > iperiod) {
+    overrunCount++;
+    FlightRecorder::recordDefault(
+      FlightEventType::loopOverrun, source, 0, idt.convert(millisecond));
+  }
+
+  const double ms = std::max(idt.convert(millisecond), 0.0);
+  histogram[std::min(static_cast<std::size_t>(ms), histogramSize - 1)]++;
+}
+
+LoopTimingStats LoopTimingRecorder::getStats() const {
+  std::scoped_lock lock(mutex);
+
+  LoopTimingStats stats;
+  stats.sampleCount = sampleCount;
+  stats.overrunCount = overrunCount;
+  if (sampleCount == 0) {
+    return stats;
+  }
+
+  stats.minDt = minDt;
+  stats.maxDt = maxDt;
+  stats.meanDt = totalDt / static_cast<double>(sampleCount);
+
+  // The smallest bin which has at least 99% of the samples at or below it
+  const std::uint64_t threshold = (static_cast<std::uint64_t>(sampleCount) * 99 + 99) / 100;
+  std::uint64_t cumulative = 0;
+  for (std::size_t i = 0; i < histogramSize; i++) {
+    cumulative += histogram[i];
+    if (cumulative >= threshold) {
+      // The last bin has no upper bound, so the longest time is the best estimate for it
+      stats.p99Dt =
+        i == histogramSize - 1 ? maxDt : std::min(static_cast<double>(i) * millisecond, maxDt);
+      break;
+    }
+  }
+
+  return stats;
+}
+
+void LoopTimingRecorder::reset() {
+  std::scoped_lock lock(mutex);
+  histogram.fill(0);
+  sampleCount = 0;
+  overrunCount = 0;
+  minDt = 0_ms;
+  maxDt = 0_ms;
+  totalDt = 0_ms;
+}
+} // namespace okapi
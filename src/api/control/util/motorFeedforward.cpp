@@ -0,0 +1,32 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#include "okapi/api/control/util/motorFeedforward.hpp"
+
+namespace okapi {
+double MotorFeedforward::calculate(const double ivelocity, const double iacceleration) const {
+  // Static friction only acts while moving, so there is no kS at a velocity of zero
+  double staticFriction = 0;
+  if (ivelocity > 0) {
+    staticFriction = kS;
+  } else if (ivelocity < 0) {
+    staticFriction = -kS;
+  }
+
+  return staticFriction + kV * ivelocity + kA * iacceleration;
+}
+
+bool MotorFeedforward::isEnabled() const {
+  return kS != 0 || kV != 0 || kA != 0;
+}
+
+bool MotorFeedforward::operator==(const MotorFeedforward &rhs) const {
+  return kS == rhs.kS && kV == rhs.kV && kA == rhs.kA;
+}
+
+bool MotorFeedforward::operator!=(const MotorFeedforward &rhs) const {
+  return !(rhs == *this);
+}
+} // namespace okapi
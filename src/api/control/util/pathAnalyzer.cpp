@@ -0,0 +1,69 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#include "okapi/api/control/util/pathAnalyzer.hpp"
+#include "okapi/api/control/util/profileGenerator.hpp"
+#include "okapi/api/control/util/profileResampler.hpp"
+#include "okapi/api/util/mathUtil.hpp"
+#include <algorithm>
+#include <cmath>
+
+namespace okapi {
+bool PathReport::isFeasible() const {
+  const double most = 1 + PathAnalyzer::tolerance;
+  return velocityUsage <= most && accelerationUsage <= most && motorSpeedUsage <= most;
+}
+
+double PathAnalyzer::getWheelFreeSpeed(const AbstractMotor::GearsetRatioPair &ipair,
+                                       const QLength iwheelDiameter) {
+  // The ratio is motor rotations per wheel rotation
+  const double wheelRpm = toUnderlyingType(ipair.internalGearset) / ipair.ratio;
+  return wheelRpm / 60 * pi * iwheelDiameter.convert(meter);
+}
+
+PathReport PathAnalyzer::analyze(const std::vector<squiggles::ProfilePoint> &ipath,
+                                 const PathfinderLimits &ilimits,
+                                 const AbstractMotor::GearsetRatioPair &ipair,
+                                 const QLength iwheelDiameter) {
+  PathReport report;
+  report.pointCount = ipath.size();
+  report.wheelFreeSpeed = getWheelFreeSpeed(ipair, iwheelDiameter);
+  if (ipath.empty()) {
+    return report;
+  }
+
+  const bool timed = ProfileResampler::hasIncreasingTimes(ipath);
+  const auto timeAt = [&](const std::size_t i) {
+    return timed ? ipath[i].time : i * ProfileGenerator::DT;
+  };
+
+  double lastVelocity = 0;
+  for (std::size_t i = 0; i < ipath.size(); ++i) {
+    const auto &point = ipath[i];
+    const double left = point.wheel_velocities.at(0);
+    const double right = point.wheel_velocities.at(1);
+    const double velocity = (left + right) / 2;
+
+    report.peakVelocity = std::max(report.peakVelocity, std::abs(velocity));
+    report.peakWheelVelocity =
+      std::max({report.peakWheelVelocity, std::abs(left), std::abs(right)});
+    report.peakCurvature = std::max(report.peakCurvature, std::abs(point.curvature));
+
+    if (i > 0) {
+      const double dt = timeAt(i) - timeAt(i - 1);
+      report.peakAcceleration =
+        std::max(report.peakAcceleration, std::abs(velocity - lastVelocity) / dt);
+      report.length += ipath[i - 1].vector.pose.dist(point.vector.pose);
+    }
+    lastVelocity = velocity;
+  }
+
+  report.duration = timeAt(ipath.size() - 1) - timeAt(0);
+  report.velocityUsage = report.peakVelocity / ilimits.maxVel;
+  report.accelerationUsage = report.peakAcceleration / ilimits.maxAccel;
+  report.motorSpeedUsage = report.peakWheelVelocity / report.wheelFreeSpeed;
+  return report;
+}
+} // namespace okapi
@@ -0,0 +1,394 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#include "okapi/api/control/util/pathBinaryFormat.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <limits>
+
+namespace okapi {
+static constexpr char pathBinaryMagic[4] = {'O', 'K', 'P', 'F'};
+static constexpr char pathLibraryMagic[4] = {'O', 'K', 'P', 'L'};
+
+template <typename T> static void writeField(std::uint8_t *&iout, const T ivalue) {
+  std::memcpy(iout, &ivalue, sizeof(T));
+  iout += sizeof(T);
+}
+
+template <typename T> static T readField(const std::uint8_t *&iin) {
+  T value;
+  std::memcpy(&value, iin, sizeof(T));
+  iin += sizeof(T);
+  return value;
+}
+
+static void writeHeader(std::uint8_t *iout,
+                        const std::uint16_t iversion,
+                        const std::uint16_t iwheelCount,
+                        const std::size_t ipointCount) {
+  std::memcpy(iout, pathBinaryMagic, sizeof(pathBinaryMagic));
+  iout += sizeof(pathBinaryMagic);
+  writeField<std::uint16_t>(iout, iversion);
+  writeField<std::uint16_t>(iout, iwheelCount);
+  writeField<std::uint32_t>(iout, static_cast<std::uint32_t>(ipointCount));
+  writeField<std::uint32_t>(iout, 0);
+}
+
+// The fields of a point in the order they are stored
+static void getFields(const squiggles::ProfilePoint &ipoint, std::vector<double> &ofields) {
+  ofields.assign({ipoint.time,
+                  ipoint.vector.pose.x,
+                  ipoint.vector.pose.y,
+                  ipoint.vector.pose.yaw,
+                  ipoint.vector.vel,
+                  ipoint.vector.accel,
+                  ipoint.vector.jerk,
+                  ipoint.curvature});
+  ofields.insert(ofields.end(), ipoint.wheel_velocities.begin(), ipoint.wheel_velocities.end());
+}
+
+// The compact format predicts each field on a straight line through the two previous points
+static std::int64_t predictField(const std::vector<std::int64_t> &ihistory,
+                                 const std::size_t ifield,
+                                 const std::size_t ifieldCount,
+                                 const std::uint32_t ipointsBefore) {
+  if (ipointsBefore == 0) {
+    return 0;
+  }
+
+  const std::int64_t last = ihistory[ifield];
+  if (ipointsBefore == 1) {
+    return last;
+  }
+
+  return 2 * last - ihistory[ifieldCount + ifield];
+}
+
+static void pushHistory(std::vector<std::int64_t> &ihistory,
+                        const std::size_t ifield,
+                        const std::size_t ifieldCount,
+                        const std::int64_t ivalue) {
+  ihistory[ifieldCount + ifield] = ihistory[ifield];
+  ihistory[ifield] = ivalue;
+}
+
+static void writeVarint(std::vector<std::uint8_t> &oout, const std::int64_t ivalue) {
+  // Zigzag encoding keeps small negative differences small
+  auto value = (static_cast<std::uint64_t>(ivalue) << 1) ^ static_cast<std::uint64_t>(ivalue >> 63);
+  while (value >= 0x80) {
+    oout.push_back(static_cast<std::uint8_t>(value | 0x80));
+    value >>= 7;
+  }
+  oout.push_back(static_cast<std::uint8_t>(value));
+}
+
+static bool readVarint(std::istream &istream, std::int64_t &ovalue) {
+  std::uint64_t value = 0;
+  for (unsigned int shift = 0; shift < 64; shift += 7) {
+    const auto byte = istream.get();
+    if (byte == std::char_traits<char>::eof()) {
+      return false;
+    }
+
+    value |= static_cast<std::uint64_t>(byte & 0x7f) << shift;
+    if ((byte & 0x80) == 0) {
+      ovalue = static_cast<std::int64_t>(value >> 1) ^ -static_cast<std::int64_t>(value & 1);
+      return true;
+    }
+  }
+
+  return false;
+}
+
+// The number of bytes from the position of a stream to its end, or nothing if it can't seek
+static std::optional<std::uint64_t> remainingBytes(std::istream &istream) {
+  const auto position = istream.tellg();
+  if (position < 0 || !istream.seekg(0, std::ios::end)) {
+    istream.clear();
+    return std::nullopt;
+  }
+
+  const auto end = istream.tellg();
+  istream.seekg(position);
+  if (end < position) {
+    return std::nullopt;
+  }
+  return static_cast<std::uint64_t>(end - position);
+}
+
+bool PathBinaryFormat::serialize(std::ostream &ostream,
+                                 const std::vector<squiggles::ProfilePoint> &ipath) {
+  if (!ipath.empty() && ipath.front().wheel_velocities.size() > maxWheelCount) {
+    return false;
+  }
+
+  const std::uint16_t wheelCount =
+    ipath.empty() ? 0 : static_cast<std::uint16_t>(ipath.front().wheel_velocities.size());
+  const std::size_t floatsPerPoint = fixedFieldsPerPoint + wheelCount;
+
+  // Build the whole file in memory so it is written with one call
+  std::vector<std::uint8_t> buffer(headerSize + ipath.size() * floatsPerPoint * sizeof(float));
+  writeHeader(buffer.data(), version, wheelCount, ipath.size());
+  std::uint8_t *out = buffer.data() + headerSize;
+
+  for (const auto &point : ipath) {
+    if (point.wheel_velocities.size() != wheelCount) {
+      // Every record must have the same width
+      return false;
+    }
+
+    writeField<float>(out, static_cast<float>(point.time));
+    writeField<float>(out, static_cast<float>(point.vector.pose.x));
+    writeField<float>(out, static_cast<float>(point.vector.pose.y));
+    writeField<float>(out, static_cast<float>(point.vector.pose.yaw));
+    writeField<float>(out, static_cast<float>(point.vector.vel));
+    writeField<float>(out, static_cast<float>(point.vector.accel));
+    writeField<float>(out, static_cast<float>(point.vector.jerk));
+    writeField<float>(out, static_cast<float>(point.curvature));
+    for (const auto wheelVelocity : point.wheel_velocities) {
+      writeField<float>(out, static_cast<float>(wheelVelocity));
+    }
+  }
+
+  ostream.write(reinterpret_cast<const char *>(buffer.data()),
+                static_cast<std::streamsize>(buffer.size()));
+  return ostream.good();
+}
+
+bool PathBinaryFormat::serializeCompact(std::ostream &ostream,
+                                        const std::vector<squiggles::ProfilePoint> &ipath) {
+  if (!ipath.empty() && ipath.front().wheel_velocities.size() > maxWheelCount) {
+    return false;
+  }
+
+  const std::uint16_t wheelCount =
+    ipath.empty() ? 0 : static_cast<std::uint16_t>(ipath.front().wheel_velocities.size());
+  const std::size_t fieldCount = fixedFieldsPerPoint + wheelCount;
+
+  // Build the whole file in memory so it is written with one call, and so nothing is written if a
+  // value can't be stored
+  std::vector<std::uint8_t> buffer(headerSize);
+  writeHeader(buffer.data(), compactVersion, wheelCount, ipath.size());
+  buffer.reserve(headerSize + ipath.size() * fieldCount * 2);
+
+  // Larger values could overflow the predictions
+  constexpr double maxSteps = 1e15;
+  std::vector<std::int64_t> history(2 * fieldCount, 0);
+  std::vector<double> fields;
+  for (std::size_t i = 0; i < ipath.size(); ++i) {
+    if (ipath[i].wheel_velocities.size() != wheelCount) {
+      return false;
+    }
+
+    getFields(ipath[i], fields);
+    for (std::size_t field = 0; field < fieldCount; ++field) {
+      const double steps = std::round(fields[field] / compactResolution);
+      if (!(std::abs(steps) < maxSteps)) {
+        return false;
+      }
+
+      const auto value = static_cast<std::int64_t>(steps);
+      const auto pointsBefore = static_cast<std::uint32_t>(std::min<std::size_t>(i, 2));
+      writeVarint(buffer, value - predictField(history, field, fieldCount, pointsBefore));
+      pushHistory(history, field, fieldCount, value);
+    }
+  }
+
+  ostream.write(reinterpret_cast<const char *>(buffer.data()),
+                static_cast<std::streamsize>(buffer.size()));
+  return ostream.good();
+}
+
+std::optional<std::vector<squiggles::ProfilePoint>>
+PathBinaryFormat::deserialize(std::istream &istream) {
+  auto header = readHeader(istream);
+  if (!header) {
+    return std::nullopt;
+  }
+
+  // The count comes from the file, so check it against what the rest of the file can hold before
+  // allocating for it. Every value takes at least a byte in the compact format.
+  const std::uint64_t fieldsPerPoint = fixedFieldsPerPoint + header->wheelCount;
+  const std::uint64_t minBytesPerPoint = header->compact ? fieldsPerPoint
+                                                         : fieldsPerPoint * sizeof(float);
+  const auto remaining = remainingBytes(istream);
+  if (remaining && header->pointCount * minBytesPerPoint > *remaining) {
+    return std::nullopt;
+  }
+
+  std::vector<squiggles::ProfilePoint> path;
+  if (remaining) {
+    path.reserve(header->pointCount);
+  }
+
+  // Read in blocks so a stream which can't be measured doesn't allocate for a bogus count at once
+  constexpr std::size_t blockSize = 256;
+  while (path.size() < header->pointCount) {
+    const std::size_t count = std::min<std::size_t>(blockSize, header->pointCount - path.size());
+    if (!readPoints(istream, header.value(), count, path)) {
+      return std::nullopt;
+    }
+  }
+
+  return path;
+}
+
+std::optional<PathBinaryFormat::Header> PathBinaryFormat::readHeader(std::istream &istream) {
+  std::uint8_t header[headerSize];
+  if (!istream.read(reinterpret_cast<char *>(header), headerSize)) {
+    return std::nullopt;
+  }
+
+  if (std::memcmp(header, pathBinaryMagic, sizeof(pathBinaryMagic)) != 0) {
+    return std::nullopt;
+  }
+
+  const std::uint8_t *in = header + sizeof(pathBinaryMagic);
+  const auto fileVersion = readField<std::uint16_t>(in);
+  const auto wheelCount = readField<std::uint16_t>(in);
+  const auto pointCount = readField<std::uint32_t>(in);
+
+  if ((fileVersion != version && fileVersion != compactVersion) || wheelCount > maxWheelCount) {
+    return std::nullopt;
+  }
+
+  Header out{wheelCount, pointCount};
+  out.compact = fileVersion == compactVersion;
+  if (out.compact) {
+    out.history.assign(2 * (fixedFieldsPerPoint + wheelCount), 0);
+  }
+  return out;
+}
+
+bool PathBinaryFormat::readPoints(std::istream &istream,
+                                  Header &iheader,
+                                  const std::size_t icount,
+                                  std::vector<squiggles::ProfilePoint> &opoints) {
+  const std::size_t floatsPerPoint = fixedFieldsPerPoint + iheader.wheelCount;
+  if (iheader.compact) {
+    std::vector<double> fields(floatsPerPoint);
+    for (std::size_t i = 0; i < icount; ++i) {
+      const auto pointsBefore = std::min<std::uint32_t>(iheader.pointsRead, 2);
+      for (std::size_t field = 0; field < floatsPerPoint; ++field) {
+        std::int64_t difference;
+        if (!readVarint(istream, difference)) {
+          return false;
+        }
+
+        const std::int64_t value =
+          predictField(iheader.history, field, floatsPerPoint, pointsBefore) + difference;
+        pushHistory(iheader.history, field, floatsPerPoint, value);
+        fields[field] = static_cast<double>(value) * compactResolution;
+      }
+
+      iheader.pointsRead++;
+      const squiggles::Pose pose(fields[1], fields[2], fields[3]);
+      opoints.emplace_back(squiggles::ControlVector(pose, fields[4], fields[5], fields[6]),
+                           std::vector<double>(fields.begin() + fixedFieldsPerPoint, fields.end()),
+                           fields[7],
+                           fields[0]);
+    }
+
+    return true;
+  }
+
+  if (icount > std::numeric_limits<std::size_t>::max() / (floatsPerPoint * sizeof(float))) {
+    return false;
+  }
+
+  std::vector<float> records(icount * floatsPerPoint);
+  if (!istream.read(reinterpret_cast<char *>(records.data()),
+                    static_cast<std::streamsize>(records.size() * sizeof(float)))) {
+    return false;
+  }
+
+  for (std::size_t i = 0; i < icount; ++i) {
+    const float *record = &records[i * floatsPerPoint];
+    const squiggles::Pose pose(record[1], record[2], record[3]);
+    opoints.emplace_back(squiggles::ControlVector(pose, record[4], record[5], record[6]),
+                         std::vector<double>(record + fixedFieldsPerPoint, record + floatsPerPoint),
+                         record[7],
+                         record[0]);
+  }
+
+  return true;
+}
+
+bool PathBinaryFormat::serializeLibrary(
+  std::ostream &ostream,
+  const std::vector<std::pair<std::string, std::vector<squiggles::ProfilePoint>>> &ipaths,
+  const bool icompact) {
+  std::uint8_t header[libraryHeaderSize];
+  std::uint8_t *out = header;
+  std::memcpy(out, pathLibraryMagic, sizeof(pathLibraryMagic));
+  out += sizeof(pathLibraryMagic);
+  writeField<std::uint16_t>(out, libraryVersion);
+  writeField<std::uint16_t>(out, 0);
+  writeField<std::uint32_t>(out, static_cast<std::uint32_t>(ipaths.size()));
+  ostream.write(reinterpret_cast<const char *>(header), libraryHeaderSize);
+
+  for (const auto &[pathId, path] : ipaths) {
+    if (pathId.size() > UINT16_MAX) {
+      return false;
+    }
+
+    std::uint8_t length[sizeof(std::uint16_t)];
+    std::uint8_t *lengthOut = length;
+    writeField<std::uint16_t>(lengthOut, static_cast<std::uint16_t>(pathId.size()));
+    ostream.write(reinterpret_cast<const char *>(length), sizeof(length));
+    ostream.write(pathId.data(), static_cast<std::streamsize>(pathId.size()));
+
+    if (!(icompact ? serializeCompact(ostream, path) : serialize(ostream, path))) {
+      return false;
+    }
+  }
+
+  return ostream.good();
+}
+
+std::optional<std::uint32_t> PathBinaryFormat::readLibraryHeader(std::istream &istream) {
+  std::uint8_t header[libraryHeaderSize];
+  if (!istream.read(reinterpret_cast<char *>(header), libraryHeaderSize)) {
+    return std::nullopt;
+  }
+
+  if (std::memcmp(header, pathLibraryMagic, sizeof(pathLibraryMagic)) != 0) {
+    return std::nullopt;
+  }
+
+  const std::uint8_t *in = header + sizeof(pathLibraryMagic);
+  const auto fileVersion = readField<std::uint16_t>(in);
+  in += sizeof(std::uint16_t); // Reserved
+  const auto pathCount = readField<std::uint32_t>(in);
+
+  if (fileVersion != libraryVersion) {
+    return std::nullopt;
+  }
+
+  return pathCount;
+}
+
+std::optional<std::pair<std::string, std::vector<squiggles::ProfilePoint>>>
+PathBinaryFormat::readLibraryEntry(std::istream &istream) {
+  std::uint8_t length[sizeof(std::uint16_t)];
+  if (!istream.read(reinterpret_cast<char *>(length), sizeof(length))) {
+    return std::nullopt;
+  }
+
+  const std::uint8_t *in = length;
+  std::string pathId(readField<std::uint16_t>(in), '\0');
+  if (!istream.read(pathId.data(), static_cast<std::streamsize>(pathId.size()))) {
+    return std::nullopt;
+  }
+
+  auto path = deserialize(istream);
+  if (!path) {
+    return std::nullopt;
+  }
+
+  return std::make_pair(std::move(pathId), std::move(path.value()));
+}
+} // namespace okapi
@@ -0,0 +1,154 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#include "okapi/api/control/util/pathPool.hpp"
+#include <algorithm>
+#include <mutex>
+
+namespace okapi {
+double PathPoolStats::getFragmentation() const {
+  const std::size_t held = bytesInUse + pooledBytes;
+  if (held == 0) {
+    return 0;
+  }
+
+  return static_cast<double>(wastedBytes + pooledBytes) / static_cast<double>(held);
+}
+
+PathPool::PathPool(const std::size_t imaxPooledPaths) : maxPooledPaths(imaxPooledPaths) {
+}
+
+PathPool::~PathPool() {
+  ResourceUsage::freed(HeapSubsystem::paths, stats.pooledBytes);
+}
+
+std::shared_ptr<const PathPool::Path> PathPool::store(Path ipath) {
+  std::unique_ptr<Path> buffer;
+  {
+    std::scoped_lock lock(mutex);
+
+    // The smallest buffer which can hold every point wastes the least
+    auto best = pooled.end();
+    for (auto it = pooled.begin(); it != pooled.end(); ++it) {
+      const bool fits = (*it)->size() >= ipath.size();
+      if (fits && (best == pooled.end() || (*it)->size() < (*best)->size())) {
+        best = it;
+      }
+    }
+
+    if (best != pooled.end()) {
+      buffer = std::move(*best);
+      pooled.erase(best);
+      const std::size_t bytes = estimatePathBytes(*buffer);
+      stats.pooledBytes -= bytes;
+      ResourceUsage::freed(HeapSubsystem::paths, bytes);
+      stats.reuses++;
+    } else {
+      stats.allocations++;
+    }
+  }
+
+  if (buffer) {
+    // Copying over the old points reuses their wheel velocity buffers
+    std::copy(ipath.begin(), ipath.end(), buffer->begin());
+    buffer->resize(ipath.size());
+  } else {
+    buffer = std::make_unique<Path>(std::move(ipath));
+  }
+
+  const std::weak_ptr<PathPool> owner = weak_from_this();
+  if (owner.expired()) {
+    // Not owned by a shared_ptr, so there is nothing to return the buffer to
+    return std::shared_ptr<const Path>(std::move(buffer));
+  }
+
+  {
+    std::scoped_lock lock(mutex);
+    const std::size_t bytes = estimatePathBytes(*buffer);
+    stats.pathsInUse++;
+    stats.bytesInUse += bytes;
+    ResourceUsage::allocated(HeapSubsystem::paths, bytes);
+    stats.wastedBytes += estimateWastedBytes(*buffer);
+    stats.peakBytesInUse = std::max(stats.peakBytesInUse, stats.bytesInUse);
+  }
+
+  // If making the shared_ptr throws, it calls the deleter, which undoes the accounting above
+  return std::shared_ptr<const Path>(buffer.release(), [owner](const Path *ibuffer) {
+    if (const auto pool = owner.lock()) {
+      pool->recycle(const_cast<Path *>(ibuffer));
+    } else {
+      delete ibuffer;
+    }
+  });
+}
+
+void PathPool::recycle(Path *ipath) {
+  std::unique_ptr<Path> path(ipath);
+  {
+    std::scoped_lock lock(mutex);
+    const std::size_t bytes = estimatePathBytes(*path);
+    stats.pathsInUse--;
+    stats.bytesInUse -= bytes;
+    stats.wastedBytes -= estimateWastedBytes(*path);
+
+    if (pooled.size() < maxPooledPaths) {
+      stats.pooledBytes += bytes;
+      pooled.push_back(std::move(path));
+    } else {
+      ResourceUsage::freed(HeapSubsystem::paths, bytes);
+    }
+  }
+
+  // A buffer which was not kept is freed here, outside the lock
+}
+
+void PathPool::release() {
+  std::vector<std::unique_ptr<Path>> released;
+  {
+    std::scoped_lock lock(mutex);
+    released.swap(pooled);
+    ResourceUsage::freed(HeapSubsystem::paths, stats.pooledBytes);
+    stats.pooledBytes = 0;
+  }
+}
+
+void PathPool::setMaxPooledPaths(const std::size_t imaxPooledPaths) {
+  std::vector<std::unique_ptr<Path>> released;
+  {
+    std::scoped_lock lock(mutex);
+    maxPooledPaths = imaxPooledPaths;
+    while (pooled.size() > maxPooledPaths) {
+      const std::size_t bytes = estimatePathBytes(*pooled.back());
+      stats.pooledBytes -= bytes;
+      ResourceUsage::freed(HeapSubsystem::paths, bytes);
+      released.push_back(std::move(pooled.back()));
+      pooled.pop_back();
+    }
+  }
+}
+
+PathPoolStats PathPool::getStats() const {
+  std::scoped_lock lock(mutex);
+  PathPoolStats out = stats;
+  out.pooledPaths = pooled.size();
+  return out;
+}
+
+std::size_t PathPool::estimatePathBytes(const Path &ipath) {
+  std::size_t bytes = sizeof(ipath) + ipath.capacity() * sizeof(squiggles::ProfilePoint);
+  for (const auto &point : ipath) {
+    bytes += point.wheel_velocities.capacity() * sizeof(double);
+  }
+  return bytes;
+}
+
+std::size_t PathPool::estimateWastedBytes(const Path &ipath) {
+  std::size_t bytes = (ipath.capacity() - ipath.size()) * sizeof(squiggles::ProfilePoint);
+  for (const auto &point : ipath) {
+    bytes += (point.wheel_velocities.capacity() - point.wheel_velocities.size()) * sizeof(double);
+  }
+  return bytes;
+}
+} // namespace okapi
@@ -0,0 +1,125 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#include "okapi/api/control/util/pathStreamReader.hpp"
+#include <algorithm>
+
+namespace okapi {
+PathStreamReader::PathStreamReader(std::unique_ptr<std::istream> istream,
+                                   const TimeUtil &itimeUtil,
+                                   const std::size_t ichunkSize)
+  : stream(std::move(istream)),
+    timeUtil(itimeUtil),
+    chunkSize(std::max<std::size_t>(1, ichunkSize)) {
+  const auto fileHeader = PathBinaryFormat::readHeader(*stream);
+  if (!fileHeader) {
+    readerDone.store(true, std::memory_order_release);
+    return;
+  }
+
+  header = fileHeader.value();
+  valid = true;
+
+  // Read the first chunk now so the first point is available as soon as the reader is made
+  if (!readChunk(buffers[0]) || pointsRead >= header.pointCount) {
+    readerDone.store(true, std::memory_order_release);
+    return;
+  }
+
+  task = new CrossplatformThread(trampoline, this, "PathStreamReader");
+}
+
+PathStreamReader::~PathStreamReader() {
+  stopReading.store(true, std::memory_order_release);
+
+  if (task) {
+    // Let the background task finish its read so it is never stopped in the middle of one
+    auto rate = timeUtil.getRate();
+    while (!readerDone.load(std::memory_order_acquire)) {
+      rate->delayUntil(1_ms);
+    }
+
+    delete task;
+  }
+}
+
+bool PathStreamReader::isValid() const {
+  return valid;
+}
+
+std::size_t PathStreamReader::getPointCount() const {
+  return header.pointCount;
+}
+
+bool PathStreamReader::next(squiggles::ProfilePoint &opoint) {
+  if (!valid || pointsConsumed >= header.pointCount) {
+    return false;
+  }
+
+  if (frontPosition >= buffers[frontBuffer].size()) {
+    if (!backBufferFull.load(std::memory_order_acquire)) {
+      auto rate = timeUtil.getRate();
+      while (!backBufferFull.load(std::memory_order_acquire)) {
+        // The background task fills the buffer before it stops, so check it again
+        if (readerDone.load(std::memory_order_acquire) &&
+            !backBufferFull.load(std::memory_order_acquire)) {
+          return false;
+        }
+
+        rate->delayUntil(1_ms);
+      }
+    }
+
+    // Swap the buffers and give the consumed one back to the background task
+    frontBuffer = 1 - frontBuffer;
+    frontPosition = 0;
+    backBufferFull.store(false, std::memory_order_release);
+  }
+
+  opoint = std::move(buffers[frontBuffer][frontPosition++]);
+  pointsConsumed++;
+  return true;
+}
+
+void PathStreamReader::trampoline(void *context) {
+  if (context) {
+    static_cast<PathStreamReader *>(context)->readLoop();
+  }
+}
+
+void PathStreamReader::readLoop() {
+  auto rate = timeUtil.getRate();
+
+  // The first chunk was read into the first buffer, and the buffers alternate from there
+  std::size_t fillBuffer = 1;
+  while (!stopReading.load(std::memory_order_acquire) && pointsRead < header.pointCount) {
+    if (backBufferFull.load(std::memory_order_acquire)) {
+      rate->delayUntil(1_ms);
+      continue;
+    }
+
+    if (!readChunk(buffers[fillBuffer])) {
+      break;
+    }
+
+    fillBuffer = 1 - fillBuffer;
+    backBufferFull.store(true, std::memory_order_release);
+  }
+
+  readerDone.store(true, std::memory_order_release);
+}
+
+bool PathStreamReader::readChunk(std::vector<squiggles::ProfilePoint> &obuffer) {
+  const std::size_t count = std::min(chunkSize, header.pointCount - pointsRead);
+  obuffer.clear();
+  obuffer.reserve(count);
+  if (!PathBinaryFormat::readPoints(*stream, header, count, obuffer)) {
+    return false;
+  }
+
+  pointsRead += count;
+  return true;
+}
+} // namespace okapi
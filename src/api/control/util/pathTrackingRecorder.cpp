@@ -0,0 +1,136 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#include "okapi/api/control/util/pathTrackingRecorder.hpp"
+#include <fstream>
+#include <limits>
+#include <mutex>
+#include <string_view>
+#include <utility>
+
+namespace okapi {
+PathTrackingRecorder::PathTrackingRecorder(const TimeUtil &itimeUtil,
+                                           std::shared_ptr<AbstractMotor> ileftMotor,
+                                           std::shared_ptr<AbstractMotor> irightMotor,
+                                           std::shared_ptr<Odometry> iodometry,
+                                           const std::size_t icapacity,
+                                           std::string idirectory,
+                                           const std::shared_ptr<Logger> &ilogger)
+  : logger(ilogger),
+    timer(itimeUtil.getTimer()),
+    leftMotor(std::move(ileftMotor)),
+    rightMotor(std::move(irightMotor)),
+    odometry(std::move(iodometry)),
+    directory(std::move(idirectory)),
+    capacity(icapacity) {
+  samples.reserve(capacity);
+}
+
+void PathTrackingRecorder::beginPath(const std::string &ipathId) {
+  std::scoped_lock lock(mutex);
+  samples.clear();
+  droppedCount = 0;
+  pathId = ipathId;
+  startTime = timer->millis();
+}
+
+void PathTrackingRecorder::record(const double ileftCommanded, const double irightCommanded) {
+  constexpr double none = std::numeric_limits<double>::quiet_NaN();
+
+  // Read the sensors before locking so a slow read does not block getSamples()
+  PathTrackingSample sample{timer->millis().convert(second),
+                            ileftCommanded,
+                            rightMotor ? irightCommanded : none,
+                            leftMotor ? leftMotor->getActualVelocity() : none,
+                            rightMotor ? rightMotor->getActualVelocity() : none,
+                            none,
+                            none,
+                            none};
+  if (odometry) {
+    const auto state = odometry->getState();
+    sample.x = state.x.convert(meter);
+    sample.y = state.y.convert(meter);
+    sample.theta = state.theta.convert(degree);
+  }
+
+  std::scoped_lock lock(mutex);
+  if (samples.size() >= capacity) {
+    droppedCount++;
+    return;
+  }
+
+  sample.time -= startTime.convert(second);
+  samples.push_back(sample);
+}
+
+bool PathTrackingRecorder::endPath() {
+  std::string fileName;
+  {
+    std::scoped_lock lock(mutex);
+    if (samples.empty() || directory.empty()) {
+      return false;
+    }
+
+    if (droppedCount > 0) {
+      LOG_WARN("PathTrackingRecorder: Dropped " + std::to_string(droppedCount) +
+               " samples of path " + pathId + ". Increase the capacity to keep them.");
+    }
+
+    // Characters which can not be in a file name on the SD card are replaced
+    std::string name(pathId);
+    for (auto &c : name) {
+      if (std::string_view("\\/:?*\"<>|").find(c) != std::string_view::npos) {
+        c = '_';
+      }
+    }
+    fileName = directory + (directory.back() == '/' ? "" : "/") + name + ".csv";
+  }
+
+  auto out = openOutput(fileName);
+  if (!out || !*out) {
+    LOG_ERROR("PathTrackingRecorder: Couldn't open " + fileName + " for writing");
+    return false;
+  }
+
+  write(*out);
+  out->flush();
+  if (!*out) {
+    LOG_ERROR("PathTrackingRecorder: Couldn't write " + fileName);
+    return false;
+  }
+
+  LOG_INFO("PathTrackingRecorder: Wrote " + fileName);
+  return true;
+}
+
+void PathTrackingRecorder::write(std::ostream &ostream) const {
+  std::scoped_lock lock(mutex);
+  ostream << "time,left_commanded,right_commanded,left_actual,right_actual,x,y,theta\n";
+  for (const auto &sample : samples) {
+    ostream << sample.time << ',' << sample.leftCommanded << ',' << sample.rightCommanded << ','
+            << sample.leftActual << ',' << sample.rightActual << ',' << sample.x << ',' << sample.y
+            << ',' << sample.theta << '\n';
+  }
+}
+
+std::vector<PathTrackingSample> PathTrackingRecorder::getSamples() const {
+  std::scoped_lock lock(mutex);
+  return samples;
+}
+
+std::size_t PathTrackingRecorder::getDroppedCount() const {
+  std::scoped_lock lock(mutex);
+  return droppedCount;
+}
+
+std::string PathTrackingRecorder::getPathId() const {
+  std::scoped_lock lock(mutex);
+  return pathId;
+}
+
+std::unique_ptr<std::ostream> PathTrackingRecorder::openOutput(const std::string &ifileName) {
+  return std::make_unique<std::ofstream>(ifileName, std::ofstream::out | std::ofstream::trunc);
+}
+} // namespace okapi
@@ -4,12 +4,31 @@
  * file, You can obtain one at http://mozilla.org/MPL/2.0/.
  */
 #include "okapi/api/control/util/pidTuner.hpp"
+#include "okapi/api/util/hostThreadPool.hpp"
 #include <algorithm>
 #include <cmath>
 #include <limits>
 #include <random>
 
 namespace okapi {
+namespace {
+/**
+ * A timer which reads a simulated time owned by its creator.
+ */
+class SimulatedTimer : public AbstractTimer {
+  public:
+  explicit SimulatedTimer(const QTime &inow) : AbstractTimer(inow), now(inow) {
+  }
+
+  QTime millis() const override {
+    return now;
+  }
+
+  protected:
+  const QTime &now;
+};
+} // namespace
+
 PIDTuner::PIDTuner(const std::shared_ptr<ControllerInput<double>> &iinput,
                    const std::shared_ptr<ControllerOutput<double>> &ioutput,
                    const TimeUtil &itimeUtil,
@@ -52,7 +71,6 @@ PIDTuner::Output PIDTuner::autotune() {
   std::mt19937 gen(rd()); // Mersenne twister
   std::uniform_real_distribution<double> dist(0, 1);
 
-  IterativePosPIDController testController(0, 0, 0, 0, timeUtil);
   std::vector<ParticleSet> particles;
   for (std::size_t i = 0; i < numParticles; i++) {
     ParticleSet set{};
@@ -82,49 +100,50 @@ PIDTuner::Output PIDTuner::autotune() {
   for (std::size_t iteration = 0; iteration < numIterations; iteration++) {
     LOG_INFO("PIDTuner: Iteration number " + std::to_string(iteration));
 
-    bool firstGoal = true;
-
-    for (std::size_t particleIndex = 0; particleIndex < numParticles; particleIndex++) {
-      LOG_INFO("PIDTuner: Particle number " + std::to_string(particleIndex));
-
-      testController.setGains({particles.at(particleIndex).kP.pos,
-                               particles.at(particleIndex).kI.pos,
-                               particles.at(particleIndex).kD.pos});
+    std::vector<double> errors(numParticles);
+    if (simulatorFactory) {
+      std::vector<Trial> trials;
+      trials.reserve(numParticles);
+      for (std::size_t particleIndex = 0; particleIndex < numParticles; particleIndex++) {
+        // Every simulator starts in the same state, so the goal never needs reversing
+        trials.push_back(
+          Trial{&particles.at(particleIndex), goal, global.bestError, simulatorFactory(), 0});
+      }
 
-      // Reverse the goal every iteration to stay in the same general area
-      std::int32_t target = goal;
-      if (!firstGoal) {
-        target *= -1;
+      runTrials(trials);
+      for (std::size_t particleIndex = 0; particleIndex < numParticles; particleIndex++) {
+        errors.at(particleIndex) = trials.at(particleIndex).error;
       }
+    } else {
+      bool firstGoal = true;
+      double cutoff = global.bestError;
+      auto rate = timeUtil.getRate();
 
-      firstGoal = !firstGoal;
+      for (std::size_t particleIndex = 0; particleIndex < numParticles; particleIndex++) {
+        LOG_INFO("PIDTuner: Particle number " + std::to_string(particleIndex));
 
-      testController.setTarget(target);
-      const double start_val = input->controllerGet();
+        // Reverse the goal every iteration to stay in the same general area
+        std::int32_t target = goal;
+        if (!firstGoal) {
+          target *= -1;
+        }
 
-      QTime settleTime = 0_ms;
-      double itae = 0;
-      // Test constants then calculate fitness function
-      auto rate = timeUtil.getRate();
-      while (!testController.isSettled()) {
-        settleTime += loopDelta;
-        if (settleTime > timeout)
-          break;
-
-        const double inputVal = input->controllerGet() - start_val;
-        const double outputVal = testController.step(inputVal);
-        const double error = testController.getError();
-        // sum of the error emphasizing later error
-        itae += (settleTime.convert(millisecond) * std::abs((int)error)) / divisor;
-
-        output->controllerSet(outputVal);
-        rate->delayUntil(loopDelta);
-      }
+        firstGoal = !firstGoal;
 
-      output->controllerSet(0);
-      testController.reset();
+        errors.at(particleIndex) = testParticle(particles.at(particleIndex),
+                                                target,
+                                                cutoff,
+                                                timeUtil,
+                                                *input,
+                                                *output,
+                                                [&]() { rate->delayUntil(loopDelta); });
+        rate->reset();
+        cutoff = std::min(cutoff, errors.at(particleIndex));
+      }
+    }
 
-      const double error = kSettle * settleTime.convert(millisecond) + kITAE * itae;
+    for (std::size_t particleIndex = 0; particleIndex < numParticles; particleIndex++) {
+      const double error = errors.at(particleIndex);
 
       LOG_DEBUG("PIDTuner: New error is " + std::to_string(error));
 
@@ -144,6 +163,7 @@ PIDTuner::Output PIDTuner::autotune() {
     }
 
     // Update particle trajectories
+    const double inertia = getInertia(iteration);
     for (std::size_t i = 0; i < numParticles; i++) {
       // Factor in the particles inertia to keep on the same trajectory
       particles.at(i).kP.vel *= inertia;
@@ -182,8 +202,153 @@ PIDTuner::Output PIDTuner::autotune() {
       particles.at(i).kI.pos = std::clamp(particles.at(i).kI.pos, kIMin, kIMax);
       particles.at(i).kD.pos = std::clamp(particles.at(i).kD.pos, kDMin, kDMax);
     }
+
+    if (hasConverged(particles)) {
+      LOG_INFO("PIDTuner: Swarm converged after iteration " + std::to_string(iteration));
+      break;
+    }
   }
 
   return Output{global.kP.best, global.kI.best, global.kD.best};
 }
+
+void PIDTuner::setSimulator(SimulatorFactory ifactory,
+                            const std::size_t inumThreads,
+                            const double iatTargetError,
+                            const double iatTargetDerivative,
+                            const QTime iatTargetTime) {
+  simulatorFactory = std::move(ifactory);
+  numThreads = std::max<std::size_t>(inumThreads, 1);
+  atTargetError = iatTargetError;
+  atTargetDerivative = iatTargetDerivative;
+  atTargetTime = iatTargetTime;
+}
+
+void PIDTuner::setInertiaSchedule(const double iinertiaStart, const double iinertiaEnd) {
+  inertiaStart = iinertiaStart;
+  inertiaEnd = iinertiaEnd;
+}
+
+void PIDTuner::setConvergenceTolerance(const double itolerance) {
+  convergenceTolerance = itolerance;
+}
+
+double PIDTuner::getInertia(const std::size_t iiteration) const {
+  if (numIterations <= 1) {
+    return inertiaStart;
+  }
+
+  return inertiaStart + (inertiaEnd - inertiaStart) * static_cast<double>(iiteration) /
+                          static_cast<double>(numIterations - 1);
+}
+
+bool PIDTuner::hasConverged(const std::vector<ParticleSet> &iparticles) const {
+  if (convergenceTolerance <= 0 || iparticles.empty()) {
+    return false;
+  }
+
+  // Gains which can't move don't count toward the spread
+  const auto withinTolerance = [&](auto igetter, const double imin, const double imax) {
+    if (imax <= imin) {
+      return true;
+    }
+
+    const auto bounds =
+      std::minmax_element(iparticles.begin(), iparticles.end(), [&](const auto &a, const auto &b) {
+        return igetter(a) < igetter(b);
+      });
+    return igetter(*bounds.second) - igetter(*bounds.first) <=
+           convergenceTolerance * (imax - imin);
+  };
+
+  return withinTolerance([](const ParticleSet &set) { return set.kP.pos; }, kPMin, kPMax) &&
+         withinTolerance([](const ParticleSet &set) { return set.kI.pos; }, kIMin, kIMax) &&
+         withinTolerance([](const ParticleSet &set) { return set.kD.pos; }, kDMin, kDMax);
+}
+
+double PIDTuner::testParticle(const ParticleSet &iparticle,
+                              const std::int32_t itarget,
+                              const double icutoff,
+                              const TimeUtil &itimeUtil,
+                              ControllerInput<double> &iinput,
+                              ControllerOutput<double> &ioutput,
+                              const std::function<void()> &iwait) const {
+  IterativePosPIDController testController(
+    iparticle.kP.pos, iparticle.kI.pos, iparticle.kD.pos, 0, itimeUtil);
+  testController.setTarget(itarget);
+  const double start_val = iinput.controllerGet();
+
+  QTime settleTime = 0_ms;
+  double itae = 0;
+  // Test constants then calculate fitness function
+  while (!testController.isSettled()) {
+    settleTime += loopDelta;
+    if (settleTime > timeout)
+      break;
+
+    const double inputVal = iinput.controllerGet() - start_val;
+    const double outputVal = testController.step(inputVal);
+    const double error = testController.getError();
+    // sum of the error emphasizing later error
+    itae += (settleTime.convert(millisecond) * std::abs((int)error)) / divisor;
+
+    ioutput.controllerSet(outputVal);
+
+    // The fitness only grows, so stop once the particle can't beat the best
+    if (kSettle * settleTime.convert(millisecond) + kITAE * itae > icutoff) {
+      ioutput.controllerSet(0);
+      return std::numeric_limits<double>::infinity();
+    }
+
+    iwait();
+  }
+
+  ioutput.controllerSet(0);
+
+  return kSettle * settleTime.convert(millisecond) + kITAE * itae;
+}
+
+void PIDTuner::runTrials(std::vector<Trial> &itrials) const {
+  TrialQueue queue{this, &itrials};
+
+  // Each run takes trials until there are none left. The shared pool keeps its threads between
+  // iterations, and the calling thread runs trials too. On the brain, every run is on this task.
+  const std::size_t runs = std::max<std::size_t>(1, std::min(numThreads, itrials.size()));
+  HostThreadPool::getShared().runAll(runs, [&](std::size_t) { trampoline(&queue); });
+}
+
+void PIDTuner::runTrial(Trial &itrial) const {
+  // The simulator only moves when it is stepped, so the test controller keeps its time
+  QTime now = 0_ms;
+  const TimeUtil simulatedTimeUtil(
+    Supplier<std::unique_ptr<AbstractTimer>>(
+      [&]() { return std::make_unique<SimulatedTimer>(now); }),
+    timeUtil.getRateSupplier(),
+    Supplier<std::unique_ptr<SettledUtil>>([&]() {
+      return std::make_unique<SettledUtil>(std::make_unique<SimulatedTimer>(now),
+                                           atTargetError,
+                                           atTargetDerivative,
+                                           atTargetTime);
+    }));
+
+  itrial.error = testParticle(*itrial.particle,
+                              itrial.target,
+                              itrial.cutoff,
+                              simulatedTimeUtil,
+                              *itrial.simulator.input,
+                              *itrial.simulator.output,
+                              [&]() {
+                                itrial.simulator.step(loopDelta);
+                                now += loopDelta;
+                              });
+}
+
+void PIDTuner::trampoline(void *context) {
+  if (context) {
+    auto *queue = static_cast<TrialQueue *>(context);
+    for (std::size_t i = queue->next++; i < queue->trials->size(); i = queue->next++) {
+      queue->tuner->runTrial(queue->trials->at(i));
+    }
+  }
+}
 } // namespace okapi
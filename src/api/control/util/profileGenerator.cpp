@@ -0,0 +1,40 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#include "okapi/api/control/util/profileGenerator.hpp"
+#include <utility>
+
+namespace okapi {
+std::vector<squiggles::ProfilePoint>
+ProfileGenerator::generate(const std::vector<PathfinderPoint> &iwaypoints,
+                           const PathfinderLimits &ilimits,
+                           const QLength &iwheelTrack,
+                           const QSpeed &istartVelocity,
+                           const QSpeed &iendVelocity) {
+  // Squiggles uses the standard math frame, so x and y swap and angles are counter-clockwise
+  std::vector<squiggles::ControlVector> points;
+  points.reserve(iwaypoints.size());
+  for (auto &point : iwaypoints) {
+    points.emplace_back(squiggles::Pose{
+      point.y.convert(meter), point.x.convert(meter), (90_deg - point.theta).convert(radian)});
+  }
+
+  if (!points.empty() && istartVelocity > 0_mps) {
+    points.front().vel = istartVelocity.convert(mps);
+  }
+
+  if (!points.empty() && iendVelocity > 0_mps) {
+    points.back().vel = iendVelocity.convert(mps);
+  }
+
+  auto constraints = squiggles::Constraints(ilimits.maxVel, ilimits.maxAccel, ilimits.maxJerk);
+  auto splineGenerator = squiggles::SplineGenerator(
+    constraints,
+    std::make_shared<squiggles::TankModel>(iwheelTrack.convert(meter), constraints),
+    DT);
+  // Squiggles takes the waypoints by value, so hand them over instead of copying them
+  return splineGenerator.generate(std::move(points));
+}
+} // namespace okapi
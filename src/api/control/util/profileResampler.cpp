@@ -0,0 +1,129 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#include "okapi/api/control/util/profileResampler.hpp"
+#include "okapi/api/util/mathUtil.hpp"
+#include <cmath>
+
+namespace okapi {
+std::vector<squiggles::ProfilePoint>
+ProfileResampler::decimate(const std::vector<squiggles::ProfilePoint> &ipath,
+                           const std::size_t istride,
+                           const double imaxCurvatureChange) {
+  if (istride <= 1 || ipath.size() <= 2) {
+    return ipath;
+  }
+
+  std::vector<squiggles::ProfilePoint> out;
+  out.reserve(ipath.size() / istride + 2);
+  out.push_back(ipath.front());
+
+  std::size_t sinceLastKept = 0;
+  for (std::size_t i = 1; i + 1 < ipath.size(); ++i) {
+    ++sinceLastKept;
+    if (sinceLastKept >= istride ||
+        std::abs(ipath[i].curvature - out.back().curvature) > imaxCurvatureChange) {
+      out.push_back(ipath[i]);
+      sinceLastKept = 0;
+    }
+  }
+
+  out.push_back(ipath.back());
+  out.shrink_to_fit();
+  return out;
+}
+
+bool ProfileResampler::hasIncreasingTimes(const std::vector<squiggles::ProfilePoint> &ipath) {
+  for (std::size_t i = 1; i < ipath.size(); ++i) {
+    if (!(ipath[i].time > ipath[i - 1].time)) {
+      return false;
+    }
+  }
+
+  return !ipath.empty();
+}
+
+/**
+ * The slope of a value at a point, from the neighbouring points.
+ */
+template <typename F>
+static double
+slopeAt(const std::vector<squiggles::ProfilePoint> &ipath, const std::size_t i, F &&ivalue) {
+  const std::size_t before = i == 0 ? 0 : i - 1;
+  const std::size_t after = i + 1 < ipath.size() ? i + 1 : i;
+  return (ivalue(ipath[after]) - ivalue(ipath[before])) / (ipath[after].time - ipath[before].time);
+}
+
+squiggles::ProfilePoint ProfileResampler::sample(const std::vector<squiggles::ProfilePoint> &ipath,
+                                                 const double itime,
+                                                 std::size_t &isegment,
+                                                 const ProfileInterpolation iinterpolation) {
+  if (ipath.size() == 1 || itime <= ipath.front().time + timeEpsilon) {
+    isegment = 0;
+    return ipath.front();
+  }
+
+  if (itime >= ipath.back().time - timeEpsilon) {
+    isegment = ipath.size() - 1;
+    return ipath.back();
+  }
+
+  if (isegment >= ipath.size() || ipath[isegment].time > itime + timeEpsilon) {
+    isegment = 0;
+  }
+
+  while (ipath[isegment + 1].time <= itime + timeEpsilon) {
+    ++isegment;
+  }
+
+  const auto &a = ipath[isegment];
+  if (itime <= a.time + timeEpsilon) {
+    return a;
+  }
+
+  const auto &b = ipath[isegment + 1];
+  const double dt = b.time - a.time;
+  const double u = (itime - a.time) / dt;
+
+  auto lerp = [u](const double ia, const double ib) { return ia + (ib - ia) * u; };
+
+  squiggles::ProfilePoint out = a;
+  out.time = itime;
+  out.vector.pose.x = lerp(a.vector.pose.x, b.vector.pose.x);
+  out.vector.pose.y = lerp(a.vector.pose.y, b.vector.pose.y);
+  const double yawChange = std::remainder(b.vector.pose.yaw - a.vector.pose.yaw, 2 * pi);
+  out.vector.pose.yaw = a.vector.pose.yaw + yawChange * u;
+  out.vector.accel = lerp(a.vector.accel, b.vector.accel);
+  out.vector.jerk = lerp(a.vector.jerk, b.vector.jerk);
+  out.curvature = lerp(a.curvature, b.curvature);
+
+  if (iinterpolation == ProfileInterpolation::linear) {
+    out.vector.vel = lerp(a.vector.vel, b.vector.vel);
+    for (std::size_t i = 0; i < out.wheel_velocities.size(); ++i) {
+      out.wheel_velocities[i] = lerp(a.wheel_velocities[i], b.wheel_velocities[i]);
+    }
+  } else {
+    const double u2 = u * u;
+    const double u3 = u2 * u;
+    const double h00 = 2 * u3 - 3 * u2 + 1;
+    const double h10 = u3 - 2 * u2 + u;
+    const double h01 = -2 * u3 + 3 * u2;
+    const double h11 = u3 - u2;
+
+    auto hermite = [&](auto &&ivalue) {
+      return h00 * ivalue(a) + h10 * dt * slopeAt(ipath, isegment, ivalue) + h01 * ivalue(b) +
+             h11 * dt * slopeAt(ipath, isegment + 1, ivalue);
+    };
+
+    out.vector.vel = hermite([](const squiggles::ProfilePoint &p) { return p.vector.vel; });
+    for (std::size_t i = 0; i < out.wheel_velocities.size(); ++i) {
+      out.wheel_velocities[i] =
+        hermite([i](const squiggles::ProfilePoint &p) { return p.wheel_velocities[i]; });
+    }
+  }
+
+  return out;
+}
+} // namespace okapi
@@ -0,0 +1,206 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#include "okapi/api/control/util/profileRetimer.hpp"
+#include "okapi/api/util/mathUtil.hpp"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+#include <string>
+
+namespace okapi {
+// The stall torque of a V5 motor through the 100 rpm cartridge, in N*m. Faster cartridges trade
+// it for speed.
+static constexpr double redStallTorque = 2.1;
+
+ProfileRetimer::ProfileRetimer(const AbstractMotor::GearsetRatioPair &ipair,
+                               const ChassisScales &iscales,
+                               const QMass imass,
+                               const std::size_t imotorsPerSide,
+                               const double ivoltageFraction,
+                               const std::shared_ptr<Logger> &ilogger)
+  : logger(ilogger) {
+  if (ipair.internalGearset == AbstractMotor::gearset::invalid || !(ipair.ratio > 0) ||
+      !(imass > 0_kg) || imotorsPerSide == 0 || !(ivoltageFraction > 0) ||
+      ivoltageFraction > 1) {
+    std::string msg("ProfileRetimer: The gearset must be valid, the ratio and mass must be "
+                    "positive, there must be a motor on each side, and the voltage fraction must "
+                    "be greater than zero and at most one.");
+    LOG_ERROR(msg);
+    throw std::invalid_argument(msg);
+  }
+
+  const double gearsetRpm = toUnderlyingType(ipair.internalGearset);
+  const double wheelRadius = iscales.wheelDiameter.convert(meter) / 2;
+
+  // The ratio is motor rotations per wheel rotation, so it divides the speed and multiplies the
+  // torque. Both drop in proportion to the voltage.
+  wheelFreeSpeed = ivoltageFraction * gearsetRpm / ipair.ratio * 2 * pi / 60 * wheelRadius;
+  sideStallForce = ivoltageFraction * static_cast<double>(imotorsPerSide) * redStallTorque * 100 /
+                   gearsetRpm * ipair.ratio / wheelRadius;
+  halfTrack = iscales.wheelTrack.convert(meter) / 2;
+  sideMass = imass.convert(kg) / 2;
+}
+
+std::pair<double, double> ProfileRetimer::getSideFactors(const double icurvature) const {
+  // This matches squiggles::TankModel, which turns toward the left wheel for positive curvature
+  return {std::abs(1 - icurvature * halfTrack), std::abs(1 + icurvature * halfTrack)};
+}
+
+double ProfileRetimer::getMaxVelocity(const double icurvature) const {
+  const auto [left, right] = getSideFactors(icurvature);
+  return wheelFreeSpeed / std::max(left, right);
+}
+
+double ProfileRetimer::getMaxAcceleration(const double ivelocity, const double icurvature) const {
+  const auto [left, right] = getSideFactors(icurvature);
+  double out = std::numeric_limits<double>::infinity();
+  for (const double factor : {left, right}) {
+    // A wheel which does not move needs no force
+    if (factor > 1e-9) {
+      const double torqueFraction = 1 - std::abs(ivelocity) * factor / wheelFreeSpeed;
+      out = std::min(out, sideStallForce * torqueFraction / (sideMass * factor));
+    }
+  }
+
+  return std::max(out, 0.0);
+}
+
+double ProfileRetimer::getMaxDeceleration(const double icurvature) const {
+  // The motors can brake with their stall torque at any speed
+  const auto [left, right] = getSideFactors(icurvature);
+  return sideStallForce / (sideMass * std::max(left, right));
+}
+
+std::vector<squiggles::ProfilePoint>
+ProfileRetimer::retime(const std::vector<squiggles::ProfilePoint> &ipath) const {
+  return retime(
+    ipath,
+    halfTrack,
+    [&](const double icurvature) { return getMaxVelocity(icurvature); },
+    [&](const double ivelocity, const double icurvature) {
+      return getMaxAcceleration(ivelocity, icurvature);
+    },
+    [&](const double icurvature) { return getMaxDeceleration(icurvature); });
+}
+
+std::vector<squiggles::ProfilePoint>
+ProfileRetimer::retime(const std::vector<squiggles::ProfilePoint> &ipath,
+                       const double ihalfTrack,
+                       const std::function<double(double)> &imaxVelocity,
+                       const std::function<double(double, double)> &imaxAcceleration,
+                       const std::function<double(double)> &imaxDeceleration) {
+  return retimePoints(
+    ipath,
+    ihalfTrack,
+    [&](const squiggles::ProfilePoint &ipoint) { return imaxVelocity(ipoint.curvature); },
+    imaxAcceleration,
+    imaxDeceleration);
+}
+
+std::vector<squiggles::ProfilePoint>
+ProfileRetimer::limitCentripetalAcceleration(const std::vector<squiggles::ProfilePoint> &ipath,
+                                             const double ihalfTrack,
+                                             const double imaxCentripetalAccel,
+                                             const double imaxAccel) {
+  const auto maxVelocity = [&](const squiggles::ProfilePoint &ipoint) {
+    const double curvature = std::abs(ipoint.curvature);
+    const double limit = curvature > 0 ? std::sqrt(imaxCentripetalAccel / curvature)
+                                       : std::numeric_limits<double>::infinity();
+    return std::min(std::abs(ipoint.vector.vel), limit);
+  };
+
+  const bool withinLimit =
+    std::all_of(ipath.begin(), ipath.end(), [&](const squiggles::ProfilePoint &ipoint) {
+      return std::abs(ipoint.vector.vel) <= maxVelocity(ipoint);
+    });
+  if (withinLimit) {
+    return ipath;
+  }
+
+  // The velocities of the profile are the ceiling, so its ramps are kept outside of the curves
+  return retimePoints(
+    ipath,
+    ihalfTrack,
+    maxVelocity,
+    [&](double, double) { return imaxAccel; },
+    [&](double) { return imaxAccel; });
+}
+
+std::vector<squiggles::ProfilePoint> ProfileRetimer::retimePoints(
+  const std::vector<squiggles::ProfilePoint> &ipath,
+  const double ihalfTrack,
+  const std::function<double(const squiggles::ProfilePoint &)> &imaxVelocity,
+  const std::function<double(double, double)> &imaxAcceleration,
+  const std::function<double(double)> &imaxDeceleration) {
+  std::vector<squiggles::ProfilePoint> out;
+  out.reserve(ipath.size());
+  std::vector<double> distances;
+  distances.reserve(ipath.size());
+
+  // distances[i] is the length of the segment from point i - 1 to point i
+  for (const auto &point : ipath) {
+    const double distance = out.empty() ? 0 : out.back().vector.pose.dist(point.vector.pose);
+    if (out.empty() || distance > 1e-9) {
+      out.push_back(point);
+      distances.push_back(distance);
+    }
+  }
+
+  if (out.size() < 2) {
+    return out;
+  }
+
+  const std::size_t count = out.size();
+  std::vector<double> velocities(count);
+  for (std::size_t i = 0; i < count; ++i) {
+    velocities[i] = imaxVelocity(out[i]);
+  }
+  velocities.front() = std::clamp(ipath.front().vector.vel, 0.0, velocities.front());
+  velocities.back() = std::clamp(ipath.back().vector.vel, 0.0, velocities.back());
+
+  // Speed up as hard as the motors can from the start, then slow down as hard as they can into
+  // the end and every curve
+  for (std::size_t i = 1; i < count; ++i) {
+    const double accel = imaxAcceleration(velocities[i - 1], out[i - 1].curvature);
+    velocities[i] = std::min(
+      velocities[i],
+      std::sqrt(velocities[i - 1] * velocities[i - 1] + 2 * accel * distances[i]));
+  }
+
+  for (std::size_t i = count - 1; i > 0; --i) {
+    const double decel = imaxDeceleration(out[i].curvature);
+    velocities[i - 1] = std::min(
+      velocities[i - 1], std::sqrt(velocities[i] * velocities[i] + 2 * decel * distances[i]));
+  }
+
+  // Both passes leave a positive velocity at one end of every segment, so each takes some time
+  double time = out.front().time;
+  for (std::size_t i = 0; i < count; ++i) {
+    auto &point = out[i];
+    const double vel = velocities[i];
+    if (i > 0) {
+      time += 2 * distances[i] / (velocities[i - 1] + vel);
+    }
+
+    point.time = time;
+    point.vector.vel = vel;
+    point.vector.accel =
+      i + 1 < count ? (velocities[i + 1] * velocities[i + 1] - vel * vel) / (2 * distances[i + 1])
+                    : 0;
+    point.wheel_velocities = {vel * (1 - point.curvature * ihalfTrack),
+                              vel * (1 + point.curvature * ihalfTrack)};
+  }
+
+  for (std::size_t i = 0; i < count; ++i) {
+    out[i].vector.jerk = i + 1 < count ? (out[i + 1].vector.accel - out[i].vector.accel) /
+                                           (out[i + 1].time - out[i].time)
+                                       : 0;
+  }
+
+  return out;
+}
+} // namespace okapi
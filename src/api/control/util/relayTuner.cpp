@@ -0,0 +1,146 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#include "okapi/api/control/util/relayTuner.hpp"
+#include "okapi/api/util/mathUtil.hpp"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+#include <vector>
+
+namespace okapi {
+RelayTuner::RelayTuner(const std::shared_ptr<ControllerInput<double>> &iinput,
+                       const std::shared_ptr<ControllerOutput<double>> &ioutput,
+                       const TimeUtil &itimeUtil,
+                       const double igoal,
+                       const double irelayAmplitude,
+                       const double ihysteresis,
+                       const std::size_t inumCycles,
+                       const QTime itimeout,
+                       const std::shared_ptr<Logger> &ilogger)
+  : logger(ilogger),
+    timeUtil(itimeUtil),
+    input(iinput),
+    output(ioutput),
+    goal(igoal),
+    relayAmplitude(irelayAmplitude),
+    hysteresis(std::abs(ihysteresis)),
+    numCycles(inumCycles),
+    timeout(itimeout) {
+  if (relayAmplitude <= 0 || relayAmplitude > 1) {
+    std::string msg = "RelayTuner: The relay amplitude must be in the range (0, 1].";
+    LOG_ERROR(msg);
+    throw std::invalid_argument(msg);
+  }
+
+  if (numCycles == 0) {
+    std::string msg = "RelayTuner: At least one cycle must be measured.";
+    LOG_ERROR(msg);
+    throw std::invalid_argument(msg);
+  }
+}
+
+RelayTuner::~RelayTuner() = default;
+
+RelayTuner::Output RelayTuner::autotune(const Rule irule) {
+  auto rate = timeUtil.getRate();
+  auto timer = timeUtil.getTimer();
+
+  const double start = input->controllerGet();
+  const QTime startTime = timer->millis();
+
+  // The relay starts by pushing toward the goal
+  double relay = goal >= 0 ? relayAmplitude : -relayAmplitude;
+  std::vector<QTime> risingEdges;
+  std::vector<double> amplitudes;
+  double cycleMax = std::numeric_limits<double>::lowest();
+  double cycleMin = std::numeric_limits<double>::max();
+
+  // The first cycle is the system settling into the oscillation, so it is not measured
+  while (risingEdges.size() < numCycles + 2) {
+    const QTime now = timer->millis();
+    if (now - startTime > timeout) {
+      break;
+    }
+
+    const double reading = input->controllerGet() - start;
+    cycleMax = std::max(cycleMax, reading);
+    cycleMin = std::min(cycleMin, reading);
+
+    const double error = goal - reading;
+    if (relay > 0 && error < -hysteresis) {
+      relay = -relayAmplitude;
+    } else if (relay < 0 && error > hysteresis) {
+      relay = relayAmplitude;
+
+      // A cycle runs from one switch up to the next
+      if (!risingEdges.empty()) {
+        amplitudes.push_back((cycleMax - cycleMin) / 2);
+      }
+      risingEdges.push_back(now);
+      cycleMax = reading;
+      cycleMin = reading;
+    }
+
+    output->controllerSet(relay);
+    rate->delayUntil(loopDelta);
+  }
+
+  output->controllerSet(0);
+
+  if (risingEdges.size() < numCycles + 2) {
+    LOG_ERROR("RelayTuner: The system did not oscillate before the timeout.");
+    return Output{0, 0, 0, 0, 0_ms};
+  }
+
+  const QTime period = (risingEdges.back() - risingEdges.at(1)) / static_cast<double>(numCycles);
+  double amplitude = 0;
+  for (std::size_t i = 1; i < amplitudes.size(); i++) {
+    amplitude += amplitudes.at(i);
+  }
+  amplitude /= static_cast<double>(amplitudes.size() - 1);
+
+  if (amplitude <= hysteresis) {
+    LOG_ERROR("RelayTuner: The oscillation was no bigger than the hysteresis.");
+    return Output{0, 0, 0, 0, 0_ms};
+  }
+
+  // The describing function of a relay with hysteresis
+  const double ultimateGain =
+    4 * relayAmplitude / (pi * std::sqrt(amplitude * amplitude - hysteresis * hysteresis));
+
+  LOG_INFO("RelayTuner: Ultimate gain is " + std::to_string(ultimateGain) +
+           ", ultimate period is " + std::to_string(period.convert(millisecond)) + " ms");
+
+  return computeGains(ultimateGain, period, irule);
+}
+
+RelayTuner::Output RelayTuner::computeGains(const double iultimateGain,
+                                            const QTime iultimatePeriod,
+                                            const Rule irule) {
+  const double period = iultimatePeriod.convert(second);
+
+  double kP = 0;
+  double integralTime = 0;
+  double derivativeTime = 0;
+  switch (irule) {
+  case Rule::tyreusLuyben:
+    kP = iultimateGain / 2.2;
+    integralTime = 2.2 * period;
+    derivativeTime = period / 6.3;
+    break;
+  case Rule::zieglerNichols:
+  default:
+    kP = 0.6 * iultimateGain;
+    integralTime = period / 2;
+    derivativeTime = period / 8;
+    break;
+  }
+
+  const double kI = integralTime > 0 ? kP / integralTime : 0;
+  return Output{kP, kI, kP * derivativeTime, iultimateGain, iultimatePeriod};
+}
+} // namespace okapi
@@ -0,0 +1,102 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#include "okapi/api/control/util/routineExecutor.hpp"
+#include <algorithm>
+
+namespace okapi {
+Routine &Routine::then(std::function<void()> iaction) {
+  return thenWait(std::move(iaction), DoneCheck());
+}
+
+Routine &Routine::thenWait(std::function<void()> istart, DoneCheck iisDone) {
+  steps.push_back(Step{std::move(istart), std::move(iisDone)});
+  return *this;
+}
+
+Routine &Routine::thenDelay(const QTime itime) {
+  return thenWait(std::function<void()>(), [itime](QTime ielapsed) { return ielapsed >= itime; });
+}
+
+std::size_t Routine::getStepCount() const {
+  return steps.size();
+}
+
+RoutineExecutor::RoutineExecutor(const TimeUtil &itimeUtil, std::shared_ptr<Logger> ilogger)
+  : logger(std::move(ilogger)), timer(itimeUtil.getTimer()), rate(itimeUtil.getRate()) {
+}
+
+std::size_t RoutineExecutor::add(Routine iroutine) {
+  const std::size_t id = nextId++;
+  added.push_back(Running{id, std::move(iroutine)});
+  LOG_INFO("RoutineExecutor: Added routine " + std::to_string(id));
+  return id;
+}
+
+void RoutineExecutor::cancel(const std::size_t iid) {
+  const auto matches = [&](const Running &iroutine) { return iroutine.id == iid; };
+  running.erase(std::remove_if(running.begin(), running.end(), matches), running.end());
+  added.erase(std::remove_if(added.begin(), added.end(), matches), added.end());
+  LOG_INFO("RoutineExecutor: Cancelled routine " + std::to_string(iid));
+}
+
+bool RoutineExecutor::isDone(const std::size_t iid) const {
+  const auto matches = [&](const Running &iroutine) { return iroutine.id == iid; };
+  return std::none_of(running.begin(), running.end(), matches) &&
+         std::none_of(added.begin(), added.end(), matches);
+}
+
+std::size_t RoutineExecutor::getRunningCount() const {
+  return running.size() + added.size();
+}
+
+bool RoutineExecutor::step() {
+  // Routines added by a step are moved over before stepping, so the loop below never grows the
+  // vector it iterates
+  std::move(added.begin(), added.end(), std::back_inserter(running));
+  added.clear();
+
+  for (std::size_t i = 0; i < running.size();) {
+    if (advance(running[i])) {
+      LOG_INFO("RoutineExecutor: Finished routine " + std::to_string(running[i].id));
+      running.erase(running.begin() + static_cast<std::ptrdiff_t>(i));
+    } else {
+      i++;
+    }
+  }
+
+  return !running.empty() || !added.empty();
+}
+
+void RoutineExecutor::run(const QTime iperiod) {
+  rate->reset();
+  while (step()) {
+    rate->delayUntil(iperiod);
+  }
+}
+
+bool RoutineExecutor::advance(Running &iroutine) {
+  auto &steps = iroutine.routine.steps;
+  while (iroutine.stepIndex < steps.size()) {
+    auto &current = steps[iroutine.stepIndex];
+    if (!iroutine.started) {
+      iroutine.started = true;
+      iroutine.stepStart = timer->millis();
+      if (current.start) {
+        current.start();
+      }
+    }
+
+    if (current.isDone && !current.isDone(timer->millis() - iroutine.stepStart)) {
+      return false;
+    }
+
+    iroutine.stepIndex++;
+    iroutine.started = false;
+  }
+
+  return true;
+}
+} // namespace okapi
@@ -0,0 +1,91 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#include "okapi/api/control/util/stepProfiler.hpp"
+#include "okapi/api/coreProsAPI.hpp"
+
+namespace okapi {
+double StepProfile::meanStepMicros() const {
+  return stepCount == 0 ? 0 : static_cast<double>(totalStepMicros) / stepCount;
+}
+
+std::string StepProfile::toString() const {
+  return "steps=" + std::to_string(stepCount) + " skipped=" + std::to_string(skippedCount) +
+         " total=" + std::to_string(totalStepMicros) +
+         "us max=" + std::to_string(maxStepMicros) +
+         "us mean=" + std::to_string(meanStepMicros()) + "us";
+}
+
+StepProfiler::Scope::Scope(StepProfiler *iprofiler) : profiler(iprofiler) {
+  if (profiler) {
+    start = CrossplatformClock::micros();
+  }
+}
+
+StepProfiler::Scope::~Scope() {
+  if (profiler) {
+    profiler->record(CrossplatformClock::micros() - start, skipped);
+  }
+}
+
+void StepProfiler::Scope::skip() {
+  skipped = true;
+}
+
+StepProfiler::StepProfiler(const StepProfiler &iother) {
+  *this = iother;
+}
+
+StepProfiler &StepProfiler::operator=(const StepProfiler &iother) {
+  const StepProfile profile = iother.get();
+  enabled.store(iother.isEnabled(), std::memory_order_relaxed);
+  stepCount.store(profile.stepCount, std::memory_order_relaxed);
+  skippedCount.store(profile.skippedCount, std::memory_order_relaxed);
+  totalStepMicros.store(profile.totalStepMicros, std::memory_order_relaxed);
+  maxStepMicros.store(profile.maxStepMicros, std::memory_order_relaxed);
+  return *this;
+}
+
+StepProfiler::Scope StepProfiler::start() {
+  return Scope(enabled.load(std::memory_order_relaxed) ? this : nullptr);
+}
+
+void StepProfiler::setEnabled(const bool ienabled) {
+  enabled.store(ienabled, std::memory_order_relaxed);
+}
+
+bool StepProfiler::isEnabled() const {
+  return enabled.load(std::memory_order_relaxed);
+}
+
+StepProfile StepProfiler::get() const {
+  return StepProfile{stepCount.load(std::memory_order_relaxed),
+                     skippedCount.load(std::memory_order_relaxed),
+                     totalStepMicros.load(std::memory_order_relaxed),
+                     maxStepMicros.load(std::memory_order_relaxed)};
+}
+
+void StepProfiler::reset() {
+  stepCount.store(0, std::memory_order_relaxed);
+  skippedCount.store(0, std::memory_order_relaxed);
+  totalStepMicros.store(0, std::memory_order_relaxed);
+  maxStepMicros.store(0, std::memory_order_relaxed);
+}
+
+void StepProfiler::record(const std::uint64_t iduration, const bool iskipped) {
+  stepCount.fetch_add(1, std::memory_order_relaxed);
+  if (iskipped) {
+    skippedCount.fetch_add(1, std::memory_order_relaxed);
+  }
+
+  totalStepMicros.fetch_add(iduration, std::memory_order_relaxed);
+
+  // Only the stepping task writes the max, so a plain compare is enough
+  const auto duration = static_cast<std::uint32_t>(iduration);
+  if (duration > maxStepMicros.load(std::memory_order_relaxed)) {
+    maxStepMicros.store(duration, std::memory_order_relaxed);
+  }
+}
+} // namespace okapi
@@ -0,0 +1,120 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#include "okapi/api/control/util/trapezoidProfile.hpp"
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+#include <string>
+
+namespace okapi {
+TrapezoidProfile::TrapezoidProfile(const double idistance,
+                                   const double imaxVelocity,
+                                   const double imaxAcceleration,
+                                   const double imaxJerk,
+                                   const std::shared_ptr<Logger> &ilogger)
+  : logger(ilogger),
+    direction(idistance < 0 ? -1 : 1),
+    distance(std::abs(idistance)),
+    jerk(imaxJerk),
+    acceleration(imaxAcceleration) {
+  if (!(imaxVelocity > 0) || !(imaxAcceleration > 0) || !(imaxJerk > 0)) {
+    std::string msg(
+      "TrapezoidProfile: The max velocity, max acceleration, and max jerk must be positive.");
+    LOG_ERROR(msg);
+    throw std::invalid_argument(msg);
+  }
+
+  if (distance == 0) {
+    peakVelocity = 0;
+    return;
+  }
+
+  // The acceleration can only reach its max if the jerk gets there before the max velocity. The
+  // speed up covers the peak velocity times half its duration because it is symmetric.
+  acceleration = std::min(imaxAcceleration, std::sqrt(imaxVelocity * jerk));
+  const double fullSpeedUp = imaxVelocity / acceleration + acceleration / jerk;
+  if (imaxVelocity * fullSpeedUp <= distance) {
+    peakVelocity = imaxVelocity;
+  } else {
+    // Moves too short to reach the max velocity speed up for half the distance. Solve
+    // v^2 / a + v * a / j = distance for the peak velocity v.
+    const double rampVelocity = imaxAcceleration * imaxAcceleration / jerk;
+    const double ratio = imaxAcceleration / jerk;
+    peakVelocity = imaxAcceleration *
+                   (-ratio + std::sqrt(ratio * ratio + 4 * distance / imaxAcceleration)) / 2;
+    acceleration = imaxAcceleration;
+
+    if (peakVelocity < rampVelocity) {
+      // The acceleration never reaches its max, so solve 2 * v^1.5 / sqrt(j) = distance instead
+      peakVelocity = std::cbrt(distance * distance * jerk / 4);
+      acceleration = std::sqrt(peakVelocity * jerk);
+    }
+  }
+
+  jerkTime = acceleration / jerk;
+  accelTime = std::max(0.0, peakVelocity / acceleration - jerkTime);
+  cruiseTime = std::max(0.0, (distance - peakVelocity * rampTime()) / peakVelocity);
+}
+
+TrapezoidProfile::State TrapezoidProfile::sample(const QTime &itime) const {
+  const double time = itime.convert(second);
+  const double ramp = rampTime();
+  const double duration = 2 * ramp + cruiseTime;
+
+  State state;
+  if (time <= 0) {
+    return state;
+  } else if (time < ramp) {
+    state = sampleAcceleration(time);
+  } else if (time < ramp + cruiseTime) {
+    state = {peakVelocity * ramp / 2 + peakVelocity * (time - ramp), peakVelocity, 0};
+  } else if (time < duration) {
+    // Slowing down mirrors speeding up
+    const State mirrored = sampleAcceleration(duration - time);
+    state = {distance - mirrored.position, mirrored.velocity, -mirrored.acceleration};
+  } else {
+    state = {distance, 0, 0};
+  }
+
+  return {state.position * direction, state.velocity * direction, state.acceleration * direction};
+}
+
+TrapezoidProfile::State TrapezoidProfile::sampleAcceleration(const double itime) const {
+  if (itime < jerkTime) {
+    return {jerk * itime * itime * itime / 6, jerk * itime * itime / 2, jerk * itime};
+  }
+
+  // Written without the jerk where it can be infinite
+  const double jerkVelocity = acceleration * jerkTime / 2;
+  const double jerkPosition = acceleration * jerkTime * jerkTime / 6;
+  if (itime < jerkTime + accelTime) {
+    const double t = itime - jerkTime;
+    return {jerkPosition + jerkVelocity * t + acceleration * t * t / 2,
+            jerkVelocity + acceleration * t,
+            acceleration};
+  }
+
+  const double accelVelocity = jerkVelocity + acceleration * accelTime;
+  const double accelPosition =
+    jerkPosition + jerkVelocity * accelTime + acceleration * accelTime * accelTime / 2;
+  const double t = itime - jerkTime - accelTime;
+  if (t <= 0) {
+    return {accelPosition, accelVelocity, acceleration};
+  }
+
+  return {accelPosition + accelVelocity * t + acceleration * t * t / 2 - jerk * t * t * t / 6,
+          accelVelocity + acceleration * t - jerk * t * t / 2,
+          acceleration - jerk * t};
+}
+
+double TrapezoidProfile::rampTime() const {
+  return 2 * jerkTime + accelTime;
+}
+
+QTime TrapezoidProfile::getDuration() const {
+  return (2 * rampTime() + cruiseTime) * second;
+}
+} // namespace okapi
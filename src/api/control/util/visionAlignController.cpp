@@ -0,0 +1,86 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#include "okapi/api/control/util/visionAlignController.hpp"
+#include "okapi/api/odometry/odomMath.hpp"
+#include <cmath>
+
+namespace okapi {
+VisionAlignController::VisionAlignController(std::shared_ptr<VisionSamplingService> ivision,
+                                             std::shared_ptr<Odometry> iodometry,
+                                             const std::uint16_t isignature,
+                                             const IterativePosPIDController::Gains &igains,
+                                             const TimeUtil &itimeUtil,
+                                             const QAngle ifieldOfView,
+                                             const double iimageWidth,
+                                             std::shared_ptr<Logger> ilogger)
+  : logger(std::move(ilogger)),
+    vision(std::move(ivision)),
+    odometry(std::move(iodometry)),
+    signature(isignature),
+    controller(std::make_unique<IterativePosPIDController>(
+      igains, itimeUtil, std::make_unique<PassthroughFilter>(), logger)),
+    // The distance in pixels from the lens to the image plane of a pinhole camera
+    focalLength(iimageWidth / 2 / std::tan(ifieldOfView.convert(radian) / 2)) {
+  controller->setTarget(0);
+}
+
+double VisionAlignController::step() {
+  takeFrame();
+  if (!targetSeen) {
+    return 0;
+  }
+
+  // The controller drives the negated error to zero, so its output has the sign of the error
+  return controller->step(-getError().convert(degree));
+}
+
+void VisionAlignController::takeFrame() {
+  const std::uint32_t frameCount = vision->getFrameCount();
+  if (frameCount == lastFrameCount) {
+    return;
+  }
+  lastFrameCount = frameCount;
+
+  const VisionFrame frame = vision->getFrame();
+  const VisionObject *object = frame.findLargest(signature);
+  if (!object) {
+    return;
+  }
+
+  // The object was seen from where the robot was when the image was captured, not where it is now
+  const QAngle bearing = std::atan2(static_cast<double>(object->x), focalLength) * radian;
+  targetHeading = OdomMath::constrainAngle180(odometry->getStateAt(frame.time).theta + bearing);
+
+  if (!targetSeen) {
+    LOG_INFO("VisionAlignController: Saw signature " + std::to_string(signature) + " at " +
+             std::to_string(targetHeading.convert(degree)) + " deg");
+  }
+  targetSeen = true;
+}
+
+bool VisionAlignController::hasTarget() const {
+  return targetSeen;
+}
+
+QAngle VisionAlignController::getTargetHeading() const {
+  return targetHeading;
+}
+
+QAngle VisionAlignController::getError() const {
+  return OdomMath::constrainAngle180(targetHeading - odometry->getState().theta);
+}
+
+bool VisionAlignController::isSettled() {
+  return targetSeen && controller->isSettled();
+}
+
+void VisionAlignController::reset() {
+  targetSeen = false;
+  targetHeading = 0_deg;
+  lastFrameCount = vision->getFrameCount();
+  controller->reset();
+}
+} // namespace okapi
@@ -0,0 +1,31 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#include "okapi/api/control/velocityControllerInput.hpp"
+#include "okapi/api/util/mathUtil.hpp"
+#include <stdexcept>
+#include <string>
+
+namespace okapi {
+VelocityControllerInput::VelocityControllerInput(std::shared_ptr<ContinuousRotarySensor> isensor,
+                                                 const double iscale,
+                                                 const std::shared_ptr<Logger> &logger)
+  : sensor(std::move(isensor)), scale(iscale) {
+  if (!sensor->measuresVelocity()) {
+    std::string msg = "VelocityControllerInput: The sensor does not measure its velocity.";
+    LOG_ERROR(msg);
+    throw std::invalid_argument(msg);
+  }
+}
+
+double VelocityControllerInput::controllerGet() {
+  const double velocity = sensor->getVelocity();
+  if (velocity == OKAPI_PROS_ERR_F) {
+    return OKAPI_PROS_ERR_F;
+  }
+
+  return velocity * scale;
+}
+} // namespace okapi
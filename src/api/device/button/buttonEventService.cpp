@@ -0,0 +1,132 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#include "okapi/api/device/button/buttonEventService.hpp"
+#include <algorithm>
+#include <mutex>
+
+namespace okapi {
+ButtonEventService::ButtonEventService(Sampler isampler,
+                                       const TimeUtil &itimeUtil,
+                                       const QTime &isamplePeriod,
+                                       const std::size_t iqueueCapacity,
+                                       std::shared_ptr<Logger> ilogger)
+  : logger(std::move(ilogger)),
+    sampler(std::move(isampler)),
+    timeUtil(itimeUtil),
+    timer(timeUtil.getTimer()),
+    samplePeriod(isamplePeriod),
+    queue(std::max<std::size_t>(iqueueCapacity, 1)) {
+}
+
+ButtonEventService::~ButtonEventService() {
+  dtorCalled.store(true, std::memory_order_release);
+  delete task;
+}
+
+void ButtonEventService::step() {
+  const std::uint32_t sampled = sampler();
+  const QTime time = timer->millis();
+
+  std::vector<ButtonEvent> events;
+  std::vector<ButtonCallback> eventCallbacks;
+  {
+    std::scoped_lock lock(mutex);
+    const std::uint32_t previous = states.exchange(sampled, std::memory_order_relaxed);
+    if (!hasSampled) {
+      hasSampled = true;
+      return;
+    }
+
+    const std::uint32_t changed = sampled ^ previous;
+    if (changed == 0) {
+      return;
+    }
+
+    for (std::uint8_t bit = 0; bit < 32; bit++) {
+      if (changed & (1u << bit)) {
+        const ButtonEvent event{bit, (sampled & (1u << bit)) != 0, time};
+        events.push_back(event);
+
+        if (queueSize < queue.size()) {
+          queue[(queueHead + queueSize) % queue.size()] = event;
+          queueSize++;
+        } else {
+          droppedCount.fetch_add(1, std::memory_order_relaxed);
+        }
+      }
+    }
+
+    eventCallbacks = callbacks;
+  }
+
+  // Call back outside of the lock so the callbacks can poll
+  for (const auto &event : events) {
+    for (const auto &elem : eventCallbacks) {
+      if (elem.button == anyButton || elem.button == event.button) {
+        elem.callback(event);
+      }
+    }
+  }
+}
+
+bool ButtonEventService::poll(ButtonEvent &oevent) {
+  std::scoped_lock lock(mutex);
+  if (queueSize == 0) {
+    return false;
+  }
+
+  oevent = queue[queueHead];
+  queueHead = (queueHead + 1) % queue.size();
+  queueSize--;
+  return true;
+}
+
+void ButtonEventService::addCallback(const std::uint8_t ibutton, Callback icallback) {
+  std::scoped_lock lock(mutex);
+  callbacks.push_back(ButtonCallback{ibutton, std::move(icallback)});
+}
+
+bool ButtonEventService::isPressed(const std::uint8_t ibutton) const {
+  return ibutton < 32 && (getStates() & (1u << ibutton)) != 0;
+}
+
+std::uint32_t ButtonEventService::getStates() const {
+  return states.load(std::memory_order_relaxed);
+}
+
+std::uint32_t ButtonEventService::getDroppedCount() const {
+  return droppedCount.load(std::memory_order_relaxed);
+}
+
+void ButtonEventService::startThread(const std::uint32_t ipriority,
+                                     const std::uint16_t istackDepth) {
+  if (!task) {
+    task = new CrossplatformThread(trampoline, this, "ButtonEventService", ipriority, istackDepth);
+  }
+}
+
+CrossplatformThread *ButtonEventService::getThread() const {
+  return task;
+}
+
+void ButtonEventService::trampoline(void *context) {
+  if (context) {
+    static_cast<ButtonEventService *>(context)->loop();
+  }
+}
+
+void ButtonEventService::loop() {
+  LOG_INFO_S("Started ButtonEventService task.");
+
+  auto rate = timeUtil.getRate();
+  while (!dtorCalled.load(std::memory_order_acquire) && !task->notifyTake(0)) {
+    step();
+    rate->delayUntil(samplePeriod);
+  }
+
+  LOG_INFO_S("Stopped ButtonEventService task.");
+}
+} // namespace okapi
@@ -0,0 +1,175 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#include "okapi/api/device/controllerDisplayService.hpp"
+#include <algorithm>
+#include <mutex>
+
+namespace okapi {
+ControllerDisplayService::ControllerDisplayService(TextWriter itextWriter,
+                                                   RumbleWriter irumbleWriter,
+                                                   const TimeUtil &itimeUtil,
+                                                   const QTime &iwritePeriod,
+                                                   std::shared_ptr<Logger> ilogger)
+  : logger(std::move(ilogger)),
+    textWriter(std::move(itextWriter)),
+    rumbleWriter(std::move(irumbleWriter)),
+    timeUtil(itimeUtil),
+    writePeriod(iwritePeriod) {
+  for (auto &line : desired) {
+    line.fill(' ');
+  }
+
+  for (auto &line : sent) {
+    line.fill(unknownChar);
+  }
+}
+
+ControllerDisplayService::~ControllerDisplayService() {
+  dtorCalled.store(true, std::memory_order_release);
+  delete task;
+}
+
+void ControllerDisplayService::setText(const std::uint8_t iline,
+                                       const std::uint8_t icol,
+                                       const std::string &itext) {
+  if (iline >= lines || icol >= columns) {
+    return;
+  }
+
+  std::scoped_lock lock(mutex);
+  const auto count = std::min<std::size_t>(itext.size(), columns - icol);
+  std::copy_n(itext.begin(), count, desired[iline].begin() + icol);
+}
+
+void ControllerDisplayService::clearLine(const std::uint8_t iline) {
+  if (iline >= lines) {
+    return;
+  }
+
+  std::scoped_lock lock(mutex);
+  desired[iline].fill(' ');
+}
+
+void ControllerDisplayService::clear() {
+  std::scoped_lock lock(mutex);
+  for (auto &line : desired) {
+    line.fill(' ');
+  }
+}
+
+void ControllerDisplayService::rumble(const std::string &ipattern) {
+  std::scoped_lock lock(mutex);
+  pendingRumble = ipattern;
+}
+
+std::string ControllerDisplayService::getText(const std::uint8_t iline) const {
+  if (iline >= lines) {
+    return "";
+  }
+
+  std::scoped_lock lock(mutex);
+  return std::string(desired[iline].begin(), desired[iline].end());
+}
+
+bool ControllerDisplayService::isSynced() const {
+  std::scoped_lock lock(mutex);
+  return pendingRumble.empty() && desired == sent;
+}
+
+void ControllerDisplayService::invalidate() {
+  std::scoped_lock lock(mutex);
+  for (auto &line : sent) {
+    line.fill(unknownChar);
+  }
+}
+
+bool ControllerDisplayService::step() {
+  std::string rumblePattern;
+  std::string text;
+  std::uint8_t textLine = 0;
+  std::uint8_t textCol = 0;
+  {
+    std::scoped_lock lock(mutex);
+    if (!pendingRumble.empty()) {
+      rumblePattern.swap(pendingRumble);
+    } else {
+      for (std::uint8_t i = 0; i < lines; i++) {
+        const auto line = static_cast<std::uint8_t>((nextLine + i) % lines);
+        const auto mismatch =
+          std::mismatch(desired[line].begin(), desired[line].end(), sent[line].begin());
+        if (mismatch.first == desired[line].end()) {
+          continue;
+        }
+
+        // Send from the first changed column through the last one
+        auto last = desired[line].end();
+        auto lastSent = sent[line].end();
+        while (*(last - 1) == *(lastSent - 1)) {
+          last--;
+          lastSent--;
+        }
+
+        textLine = line;
+        textCol = static_cast<std::uint8_t>(mismatch.first - desired[line].begin());
+        text.assign(mismatch.first, last);
+        nextLine = static_cast<std::uint8_t>((line + 1) % lines);
+        break;
+      }
+    }
+  }
+
+  // Write outside of the lock so the writers can call back into this service
+  if (!rumblePattern.empty()) {
+    if (rumbleWriter(rumblePattern)) {
+      return true;
+    }
+
+    std::scoped_lock lock(mutex);
+    if (pendingRumble.empty()) {
+      pendingRumble = rumblePattern;
+    }
+    return false;
+  }
+
+  if (text.empty() || !textWriter(textLine, textCol, text)) {
+    return false;
+  }
+
+  std::scoped_lock lock(mutex);
+  std::copy(text.begin(), text.end(), sent[textLine].begin() + textCol);
+  return true;
+}
+
+void ControllerDisplayService::startThread(const std::uint32_t ipriority,
+                                           const std::uint16_t istackDepth) {
+  if (!task) {
+    task =
+      new CrossplatformThread(trampoline, this, "ControllerDisplayService", ipriority, istackDepth);
+  }
+}
+
+CrossplatformThread *ControllerDisplayService::getThread() const {
+  return task;
+}
+
+void ControllerDisplayService::trampoline(void *context) {
+  if (context) {
+    static_cast<ControllerDisplayService *>(context)->loop();
+  }
+}
+
+void ControllerDisplayService::loop() {
+  LOG_INFO_S("Started ControllerDisplayService task.");
+
+  auto rate = timeUtil.getRate();
+  while (!dtorCalled.load(std::memory_order_acquire) && !task->notifyTake(0)) {
+    step();
+    rate->delayUntil(writePeriod);
+  }
+
+  LOG_INFO_S("Stopped ControllerDisplayService task.");
+}
+} // namespace okapi
@@ -0,0 +1,207 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#include "okapi/api/device/dashboardService.hpp"
+#include "okapi/api/util/taskProfiler.hpp"
+#include <algorithm>
+#include <cstdio>
+#include <mutex>
+
+namespace okapi {
+DashboardService::DashboardService(CellWriter icellWriter,
+                                   const TimeUtil &itimeUtil,
+                                   const QTime &irefreshPeriod,
+                                   std::shared_ptr<Logger> ilogger)
+  : logger(std::move(ilogger)),
+    cellWriter(std::move(icellWriter)),
+    timeUtil(itimeUtil),
+    refreshPeriod(std::max(irefreshPeriod, minRefreshPeriod)) {
+  if (irefreshPeriod < minRefreshPeriod) {
+    LOG_WARN("DashboardService: The refresh period was raised to " +
+             std::to_string(minRefreshPeriod.convert(millisecond)) + " ms.");
+  }
+}
+
+DashboardService::~DashboardService() {
+  stopThread();
+}
+
+bool DashboardService::addField(const std::string &ilabel, std::function<std::string()> isource) {
+  std::scoped_lock lock(fieldMutex);
+  if (fields.size() >= maxCells) {
+    LOG_WARN("DashboardService: No room for the field " + ilabel);
+    return false;
+  }
+
+  fields.push_back({ilabel, std::move(isource)});
+  return true;
+}
+
+bool DashboardService::addValue(const std::string &ilabel,
+                                std::function<double()> isource,
+                                const int iprecision) {
+  return addField(ilabel, [source = std::move(isource), iprecision] {
+    return formatValue(source(), iprecision);
+  });
+}
+
+bool DashboardService::addOdometry(const std::shared_ptr<Odometry> &iodometry) {
+  std::scoped_lock lock(fieldMutex);
+  if (fields.size() + 3 > maxCells) {
+    LOG_WARN_S("DashboardService: No room for the odometry.");
+    return false;
+  }
+
+  fields.push_back(
+    {"x", [iodometry] { return formatValue(iodometry->getState().x.convert(inch), 2); }});
+  fields.push_back(
+    {"y", [iodometry] { return formatValue(iodometry->getState().y.convert(inch), 2); }});
+  fields.push_back(
+    {"theta", [iodometry] { return formatValue(iodometry->getState().theta.convert(degree), 1); }});
+  return true;
+}
+
+bool DashboardService::addError(
+  const std::string &ilabel,
+  const std::shared_ptr<ClosedLoopController<double, double>> &icontroller) {
+  return addField(ilabel, [icontroller] { return formatValue(icontroller->getError(), 2); });
+}
+
+bool DashboardService::addTemperature(const std::string &ilabel,
+                                      const std::shared_ptr<AbstractMotor> &imotor) {
+  return addField(ilabel, [imotor] { return formatValue(imotor->getTemperature(), 0) + " C"; });
+}
+
+bool DashboardService::addTaskLoad(const std::size_t icount) {
+  std::scoped_lock lock(fieldMutex);
+  if (fields.size() + icount > maxCells) {
+    LOG_WARN_S("DashboardService: No room for the task load.");
+    return false;
+  }
+
+  for (std::size_t rank = 0; rank < icount; rank++) {
+    fields.push_back({"", [rank] {
+                        std::array<TaskProfileStats, TaskProfiler::maxProfiles> stats;
+                        const std::size_t count = TaskProfiler::getStats(stats);
+                        if (rank >= count) {
+                          return std::string();
+                        }
+
+                        std::partial_sort(stats.begin(),
+                                          stats.begin() + rank + 1,
+                                          stats.begin() + count,
+                                          [](const auto &a, const auto &b) {
+                                            return a.getUtilization() > b.getUtilization();
+                                          });
+
+                        char text[64];
+                        std::snprintf(text,
+                                      sizeof(text),
+                                      "%.20s %.0f%% %.1f ms",
+                                      stats[rank].name,
+                                      stats[rank].getUtilization() * 100,
+                                      static_cast<double>(stats[rank].maxBusyMicros) / 1000);
+                        return std::string(text);
+                      }});
+  }
+
+  return true;
+}
+
+std::size_t DashboardService::getFieldCount() const {
+  std::scoped_lock lock(fieldMutex);
+  return fields.size();
+}
+
+std::string DashboardService::getText(const std::size_t icell) const {
+  if (icell >= maxCells) {
+    return "";
+  }
+
+  std::scoped_lock lock(shownMutex);
+  return shown[icell].value_or("");
+}
+
+void DashboardService::invalidate() {
+  std::scoped_lock lock(shownMutex);
+  shown.fill(std::nullopt);
+}
+
+std::size_t DashboardService::step() {
+  std::array<std::string, maxCells> texts;
+  std::size_t count;
+  {
+    std::scoped_lock lock(fieldMutex);
+    count = fields.size();
+    for (std::size_t i = 0; i < count; i++) {
+      const Field &field = fields[i];
+      texts[i] = field.label.empty() ? field.source() : field.label + ": " + field.source();
+    }
+  }
+
+  std::array<bool, maxCells> changed{};
+  {
+    std::scoped_lock lock(shownMutex);
+    for (std::size_t i = 0; i < count; i++) {
+      changed[i] = shown[i] != texts[i];
+    }
+  }
+
+  // Write outside of the lock so the writer can call back into this service
+  std::size_t written = 0;
+  for (std::size_t i = 0; i < count; i++) {
+    if (changed[i]) {
+      cellWriter(i, texts[i]);
+      written++;
+
+      std::scoped_lock lock(shownMutex);
+      shown[i] = std::move(texts[i]);
+    }
+  }
+
+  return written;
+}
+
+void DashboardService::startThread(const std::uint32_t ipriority,
+                                   const std::uint16_t istackDepth) {
+  if (!task) {
+    task = new CrossplatformThread(trampoline, this, "DashboardService", ipriority, istackDepth);
+  }
+}
+
+CrossplatformThread *DashboardService::getThread() const {
+  return task;
+}
+
+void DashboardService::trampoline(void *context) {
+  if (context) {
+    static_cast<DashboardService *>(context)->loop();
+  }
+}
+
+void DashboardService::loop() {
+  LOG_INFO_S("Started DashboardService task.");
+
+  auto rate = timeUtil.getRate();
+  while (!dtorCalled.load(std::memory_order_acquire) && !task->notifyTake(0)) {
+    step();
+    rate->delayUntil(refreshPeriod);
+  }
+
+  LOG_INFO_S("Stopped DashboardService task.");
+}
+
+void DashboardService::stopThread() {
+  dtorCalled.store(true, std::memory_order_release);
+  delete task;
+  task = nullptr;
+}
+
+std::string DashboardService::formatValue(const double ivalue, const int iprecision) {
+  char text[32];
+  std::snprintf(text, sizeof(text), "%.*f", iprecision, ivalue);
+  return std::string(text);
+}
+} // namespace okapi
@@ -0,0 +1,130 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#include "okapi/api/device/motor/motorCurrentController.hpp"
+#include "okapi/api/util/mathUtil.hpp"
+#include <algorithm>
+#include <cmath>
+#include <string>
+
+namespace okapi {
+MotorCurrentController::MotorCurrentController(std::shared_ptr<AbstractMotor> imotor,
+                                               const TimeUtil &itimeUtil,
+                                               const std::int32_t imaxCurrent,
+                                               const MotorCurrentModel &imodel,
+                                               const MotorCurrentGains &igains,
+                                               const QTime &iloopPeriod,
+                                               std::shared_ptr<Logger> ilogger)
+  : motor(std::move(imotor)),
+    timeUtil(itimeUtil),
+    maxCurrent(imaxCurrent),
+    model(imodel),
+    gains(igains),
+    loopPeriod(iloopPeriod),
+    logger(std::move(ilogger)) {
+  if (maxCurrent <= 0 || loopPeriod <= 0_ms || !(model.stallCurrent > 0) ||
+      !(model.maxVoltage > 0)) {
+    std::string msg("MotorCurrentController: The maximum current, the loop period, the stall "
+                    "current, and the maximum voltage must be positive.");
+    LOG_ERROR(msg);
+    throw std::invalid_argument(msg);
+  }
+
+  motor->setCurrentLimit(maxCurrent);
+}
+
+MotorCurrentController::~MotorCurrentController() {
+  dtorCalled.store(true, std::memory_order_release);
+  delete task;
+  motor->moveVoltage(0);
+}
+
+void MotorCurrentController::setTarget(const std::int32_t icurrent) {
+  target.store(std::clamp(icurrent, -maxCurrent, maxCurrent), std::memory_order_release);
+}
+
+std::int32_t MotorCurrentController::getTarget() const {
+  return target.load(std::memory_order_acquire);
+}
+
+std::int32_t MotorCurrentController::getMaxCurrent() const {
+  return maxCurrent;
+}
+
+void MotorCurrentController::controllerSet(const double ivalue) {
+  setTarget(static_cast<std::int32_t>(std::clamp(ivalue, -1.0, 1.0) * maxCurrent));
+}
+
+void MotorCurrentController::step() {
+  const std::int32_t currentTarget = target.load(std::memory_order_acquire);
+
+  // The integral only holds for the direction it was built up in
+  if (currentTarget == 0 || (currentTarget > 0) != (lastTarget > 0)) {
+    integral = 0;
+  }
+  lastTarget = currentTarget;
+
+  if (currentTarget == 0) {
+    motor->moveVoltage(0);
+    return;
+  }
+
+  const std::int32_t currentDraw = motor->getCurrentDraw();
+  const double velocity = motor->getActualVelocity();
+  if (currentDraw == OKAPI_PROS_ERR || !std::isfinite(velocity)) {
+    // The motor is probably unplugged, so leave its last command alone
+    return;
+  }
+
+  // A DC motor draws (V - kE * velocity) / R, so give it the voltage which draws the target
+  const double freeSpeed = toUnderlyingType(motor->getGearing());
+  const double feedforward = currentTarget / model.stallCurrent * model.maxVoltage +
+                             velocity / freeSpeed * model.maxVoltage;
+
+  const double sign = currentTarget > 0 ? 1 : -1;
+  const double error = std::abs(currentTarget) - currentDraw;
+  const double output = feedforward + sign * (gains.kP * error + integral);
+
+  // Don't wind up while the motor can't be pushed any harder
+  if (sign * output < model.maxVoltage || error < 0) {
+    integral = std::clamp(integral + gains.kI * error * loopPeriod.convert(second),
+                          -model.maxVoltage,
+                          model.maxVoltage);
+  }
+
+  motor->moveVoltage(
+    static_cast<std::int16_t>(std::clamp(output, -model.maxVoltage, model.maxVoltage)));
+}
+
+void MotorCurrentController::startThread(const std::uint32_t ipriority,
+                                         const std::uint16_t istackDepth) {
+  if (!task) {
+    task =
+      new CrossplatformThread(trampoline, this, "MotorCurrentController", ipriority, istackDepth);
+  }
+}
+
+CrossplatformThread *MotorCurrentController::getThread() const {
+  return task;
+}
+
+void MotorCurrentController::trampoline(void *context) {
+  if (context) {
+    static_cast<MotorCurrentController *>(context)->loop();
+  }
+}
+
+void MotorCurrentController::loop() {
+  LOG_INFO_S("Started MotorCurrentController task.");
+
+  auto rate = timeUtil.getRate();
+  while (!dtorCalled.load(std::memory_order_acquire) && !task->notifyTake(0)) {
+    step();
+    rate->delayUntil(loopPeriod);
+  }
+
+  LOG_INFO_S("Stopped MotorCurrentController task.");
+}
+} // namespace okapi
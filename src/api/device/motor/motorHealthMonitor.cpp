@@ -0,0 +1,203 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#include "okapi/api/device/motor/motorHealthMonitor.hpp"
+#include "okapi/api/util/flightRecorder.hpp"
+#include "okapi/api/util/mathUtil.hpp"
+#include <algorithm>
+#include <cmath>
+#include <mutex>
+#include <string>
+
+namespace okapi {
+MotorHealthMonitor::MotorHealthMonitor(const TimeUtil &itimeUtil,
+                                       const QTime &isamplePeriod,
+                                       std::shared_ptr<Logger> ilogger)
+  : logger(std::move(ilogger)), timeUtil(itimeUtil), samplePeriod(isamplePeriod) {
+}
+
+MotorHealthMonitor::~MotorHealthMonitor() {
+  dtorCalled.store(true, std::memory_order_release);
+  delete task;
+}
+
+std::size_t MotorHealthMonitor::addMotor(std::shared_ptr<AbstractMotor> imotor,
+                                         const MotorHealthLimits &ilimits) {
+  std::scoped_lock lock(mutex);
+  motors.push_back(WatchedMotor{std::move(imotor), ilimits, MotorHealthStats{}, 0});
+  return motors.size() - 1;
+}
+
+std::size_t MotorHealthMonitor::addMotor(std::shared_ptr<AbstractMotor> imotor) {
+  return addMotor(std::move(imotor), MotorHealthLimits{});
+}
+
+void MotorHealthMonitor::setCallback(Callback icallback) {
+  std::scoped_lock lock(mutex);
+  callback = std::move(icallback);
+}
+
+void MotorHealthMonitor::step() {
+  std::vector<PendingEvent> events;
+  Callback stepCallback;
+  {
+    std::scoped_lock lock(mutex);
+    for (std::size_t i = 0; i < motors.size(); i++) {
+      sample(i, events);
+    }
+    stepCallback = callback;
+  }
+
+  // Report outside of the lock so the callback can read the statistics
+  if (stepCallback) {
+    for (const auto &pending : events) {
+      stepCallback(pending.motor, pending.type, pending.stats);
+    }
+  }
+}
+
+void MotorHealthMonitor::sample(const std::size_t iindex, std::vector<PendingEvent> &oevents) {
+  auto &watched = motors[iindex];
+  auto &stats = watched.stats;
+  const auto &limits = watched.limits;
+
+  const double temperature = watched.motor->getTemperature();
+  const std::int32_t currentDraw = watched.motor->getCurrentDraw();
+  if (!std::isfinite(temperature) || temperature == OKAPI_PROS_ERR ||
+      currentDraw == OKAPI_PROS_ERR) {
+    // The motor is probably unplugged, so the rest of its readings would fail too
+    stats.failedSampleCount++;
+    return;
+  }
+
+  const bool isOverTemp = watched.motor->isOverTemp() == 1;
+  const bool isOverCurrent = watched.motor->isOverCurrent() == 1;
+  std::uint32_t faults = watched.motor->getFaults();
+  if (faults == static_cast<std::uint32_t>(OKAPI_PROS_ERR)) {
+    faults = stats.faults;
+  }
+
+  const auto report = [&](const event ievent) {
+    oevents.push_back(PendingEvent{iindex, ievent, stats});
+  };
+
+  if (stats.sampleCount == 0) {
+    stats.meanTemperature = temperature;
+    stats.meanCurrentDraw = currentDraw;
+    stats.peakTemperature = temperature;
+    stats.peakCurrentDraw = currentDraw;
+  } else {
+    stats.meanTemperature += meanWeight * (temperature - stats.meanTemperature);
+    stats.meanCurrentDraw += meanWeight * (currentDraw - stats.meanCurrentDraw);
+    stats.peakTemperature = std::max(stats.peakTemperature, temperature);
+    stats.peakCurrentDraw = std::max(stats.peakCurrentDraw, currentDraw);
+  }
+
+  const std::uint32_t newFaults = faults & ~stats.faults;
+  const bool becameOverTemp = isOverTemp && !stats.isOverTemp;
+  const bool becameOverCurrent = isOverCurrent && !stats.isOverCurrent;
+
+  stats.temperature = temperature;
+  stats.currentDraw = currentDraw;
+  stats.faults = faults;
+  stats.isOverTemp = isOverTemp;
+  stats.isOverCurrent = isOverCurrent;
+  stats.sampleCount++;
+
+  if (!stats.isTooHot && temperature > limits.maxTemperature) {
+    stats.isTooHot = true;
+    if (limits.hotCurrentLimit > 0) {
+      watched.normalCurrentLimit = watched.motor->getCurrentLimit();
+      watched.motor->setCurrentLimit(limits.hotCurrentLimit);
+    }
+    LOG_WARN("MotorHealthMonitor: Motor " + std::to_string(iindex) + " is too hot (" +
+             std::to_string(temperature) + " C).");
+    report(event::tooHot);
+  } else if (stats.isTooHot && temperature < limits.maxTemperature - limits.temperatureHysteresis) {
+    stats.isTooHot = false;
+    if (limits.hotCurrentLimit > 0) {
+      watched.motor->setCurrentLimit(watched.normalCurrentLimit);
+    }
+    LOG_INFO("MotorHealthMonitor: Motor " + std::to_string(iindex) + " cooled down.");
+    report(event::cooledDown);
+  }
+
+  if (!stats.isDrawingTooMuchCurrent && currentDraw > limits.maxCurrentDraw) {
+    stats.isDrawingTooMuchCurrent = true;
+    report(event::drawingTooMuchCurrent);
+  } else if (stats.isDrawingTooMuchCurrent && currentDraw <= limits.maxCurrentDraw) {
+    stats.isDrawingTooMuchCurrent = false;
+    report(event::currentDrawNormal);
+  }
+
+  if (becameOverTemp) {
+    LOG_WARN("MotorHealthMonitor: Motor " + std::to_string(iindex) + " is over temperature.");
+    report(event::overTemp);
+  }
+
+  if (becameOverCurrent) {
+    report(event::overCurrent);
+  }
+
+  if (newFaults != 0) {
+    LOG_WARN("MotorHealthMonitor: Motor " + std::to_string(iindex) + " reported faults " +
+             std::to_string(newFaults) + ".");
+    FlightRecorder::recordDefault(FlightEventType::motorFault,
+                                  "MotorHealthMonitor",
+                                  static_cast<std::int32_t>(iindex),
+                                  static_cast<double>(newFaults));
+    report(event::newFaults);
+  }
+}
+
+MotorHealthStats MotorHealthMonitor::getStats(const std::size_t imotor) const {
+  std::scoped_lock lock(mutex);
+  return motors.at(imotor).stats;
+}
+
+void MotorHealthMonitor::resetStats() {
+  std::scoped_lock lock(mutex);
+  for (auto &watched : motors) {
+    if (watched.stats.isTooHot && watched.limits.hotCurrentLimit > 0) {
+      watched.motor->setCurrentLimit(watched.normalCurrentLimit);
+    }
+    watched.stats = MotorHealthStats{};
+  }
+}
+
+std::size_t MotorHealthMonitor::getMotorCount() const {
+  std::scoped_lock lock(mutex);
+  return motors.size();
+}
+
+void MotorHealthMonitor::startThread(const std::uint32_t ipriority,
+                                     const std::uint16_t istackDepth) {
+  if (!task) {
+    task = new CrossplatformThread(trampoline, this, "MotorHealthMonitor", ipriority, istackDepth);
+  }
+}
+
+CrossplatformThread *MotorHealthMonitor::getThread() const {
+  return task;
+}
+
+void MotorHealthMonitor::trampoline(void *context) {
+  if (context) {
+    static_cast<MotorHealthMonitor *>(context)->loop();
+  }
+}
+
+void MotorHealthMonitor::loop() {
+  LOG_INFO_S("Started MotorHealthMonitor task.");
+
+  auto rate = timeUtil.getRate();
+  while (!dtorCalled.load(std::memory_order_acquire) && !task->notifyTake(0)) {
+    step();
+    rate->delayUntil(samplePeriod);
+  }
+
+  LOG_INFO_S("Stopped MotorHealthMonitor task.");
+}
+} // namespace okapi
@@ -0,0 +1,120 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#include "okapi/api/device/motor/motorLinearizer.hpp"
+#include <cmath>
+#include <stdexcept>
+#include <string>
+
+namespace okapi {
+MotorLinearizer::MotorLinearizer() {
+  for (std::size_t i = 0; i < table.size(); i++) {
+    table[i] = static_cast<std::uint8_t>(i);
+  }
+}
+
+MotorLinearizer::MotorLinearizer(const Table &itable) : table(itable) {
+}
+
+MotorLinearizer
+MotorLinearizer::fromResponse(std::vector<std::pair<std::int32_t, double>> iresponse,
+                              const std::shared_ptr<Logger> &ilogger) {
+  const auto &logger = ilogger;
+
+  for (auto &point : iresponse) {
+    point.first = std::clamp(point.first, 0, maxPwm);
+    point.second = std::abs(point.second);
+  }
+
+  // The motor does not move without power
+  iresponse.emplace_back(0, 0);
+  std::sort(iresponse.begin(), iresponse.end());
+
+  // Interpolate the speed at every PWM value, never letting it go down
+  std::array<double, maxPwm + 1> speeds{};
+  std::size_t next = 0;
+  for (std::int32_t pwm = 0; pwm <= maxPwm; pwm++) {
+    while (next < iresponse.size() && iresponse[next].first < pwm) {
+      next++;
+    }
+
+    double speed;
+    if (next == iresponse.size()) {
+      speed = iresponse.back().second;
+    } else if (iresponse[next].first == pwm || next == 0) {
+      speed = iresponse[next].second;
+    } else {
+      const auto &[lowPwm, lowSpeed] = iresponse[next - 1];
+      const auto &[highPwm, highSpeed] = iresponse[next];
+      speed = lowSpeed + (highSpeed - lowSpeed) * (pwm - lowPwm) / (highPwm - lowPwm);
+    }
+
+    speeds[static_cast<std::size_t>(pwm)] = pwm == 0 ? speed : std::max(speed, speeds[pwm - 1]);
+  }
+
+  const double topSpeed = speeds[maxPwm];
+  if (!(topSpeed > 0)) {
+    std::string msg = "MotorLinearizer: The response has no speed above zero.";
+    LOG_ERROR(msg);
+    throw std::invalid_argument(msg);
+  }
+
+  // Send the smallest PWM value which reaches each fraction of the top speed
+  Table table{};
+  std::size_t pwm = 1;
+  for (std::size_t command = 1; command < table.size(); command++) {
+    const double target = topSpeed * static_cast<double>(command) / maxPwm;
+    while (pwm < maxPwm && speeds[pwm] < target) {
+      pwm++;
+    }
+
+    double exact = static_cast<double>(pwm);
+    if (const double rise = speeds[pwm] - speeds[pwm - 1]; rise > 0) {
+      exact = static_cast<double>(pwm) - (speeds[pwm] - target) / rise;
+    }
+
+    table[command] = static_cast<std::uint8_t>(std::clamp<long>(std::lround(exact), 1, maxPwm));
+  }
+
+  return MotorLinearizer(table);
+}
+
+MotorLinearizer MotorLinearizer::calibrate(const std::function<void(std::int8_t)> &ipwmWriter,
+                                           const std::shared_ptr<RotarySensor> &isensor,
+                                           const TimeUtil &itimeUtil,
+                                           const std::int32_t istep,
+                                           const QTime isettleTime,
+                                           const QTime isampleTime,
+                                           const std::shared_ptr<Logger> &ilogger) {
+  const auto &logger = ilogger;
+  auto rate = itimeUtil.getRate();
+  const std::int32_t step = std::max(istep, 1);
+
+  std::vector<std::pair<std::int32_t, double>> response;
+  for (std::int32_t pwm = step;; pwm = std::min(pwm + step, maxPwm)) {
+    ipwmWriter(static_cast<std::int8_t>(pwm));
+    rate->delayUntil(isettleTime);
+
+    const double start = isensor->get();
+    rate->delayUntil(isampleTime);
+    const double speed = (isensor->get() - start) / isampleTime.convert(second);
+    response.emplace_back(pwm, speed);
+
+    LOG_INFO("MotorLinearizer: Speed at PWM " + std::to_string(pwm) + " is " +
+             std::to_string(speed));
+
+    if (pwm == maxPwm) {
+      break;
+    }
+  }
+
+  ipwmWriter(0);
+  return fromResponse(std::move(response), ilogger);
+}
+
+const MotorLinearizer::Table &MotorLinearizer::getTable() const {
+  return table;
+}
+} // namespace okapi
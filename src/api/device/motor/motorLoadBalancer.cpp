@@ -0,0 +1,138 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#include "okapi/api/device/motor/motorLoadBalancer.hpp"
+#include "okapi/api/util/mathUtil.hpp"
+#include <algorithm>
+#include <cmath>
+
+namespace okapi {
+namespace {
+bool isErrorReading(const double ivalue) {
+  return !std::isfinite(ivalue) || std::abs(ivalue) == OKAPI_PROS_ERR;
+}
+} // namespace
+
+MotorLoadBalancer::MotorLoadBalancer(const std::size_t imotorCount,
+                                     const MotorLoadBalancerParams &iparams)
+  : params(iparams), trims(imotorCount, 0), balanced(imotorCount, false), readings(imotorCount) {
+  scratch.reserve(imotorCount);
+}
+
+void MotorLoadBalancer::update(const std::vector<Reading> &ireadings, const QTime idt) {
+  const std::size_t count = std::min(ireadings.size(), trims.size());
+
+  scratch.clear();
+  for (std::size_t i = 0; i < count; i++) {
+    const auto &reading = ireadings[i];
+    if (!isErrorReading(reading.velocity) && !isErrorReading(reading.currentDraw)) {
+      scratch.push_back(reading.velocity);
+    }
+  }
+
+  if (scratch.empty()) {
+    std::fill(trims.begin(), trims.end(), 0);
+    return;
+  }
+
+  // The median is not pulled away by one motor which slips or is stalled on its own
+  const auto middle = scratch.begin() + scratch.size() / 2;
+  std::nth_element(scratch.begin(), middle, scratch.end());
+  const double medianVelocity = *middle;
+
+  double currentSum = 0;
+  std::size_t balancedCount = 0;
+  for (std::size_t i = 0; i < trims.size(); i++) {
+    balanced[i] = i < count && !isErrorReading(ireadings[i].velocity) &&
+                  !isErrorReading(ireadings[i].currentDraw) &&
+                  std::abs(ireadings[i].velocity - medianVelocity) <= params.slipVelocity;
+    if (balanced[i]) {
+      currentSum += ireadings[i].currentDraw;
+      balancedCount++;
+    } else {
+      trims[i] = 0;
+    }
+  }
+
+  const double meanCurrent = balancedCount > 0 ? currentSum / balancedCount : 0;
+  if (balancedCount < 2 || meanCurrent < params.minCurrent) {
+    return;
+  }
+
+  const double dt = std::min(idt, maxDt).convert(second);
+  double trimSum = 0;
+  for (std::size_t i = 0; i < trims.size(); i++) {
+    if (balanced[i]) {
+      // A motor which draws less than the others is pushed harder, and one which draws more is
+      // eased off
+      trims[i] += params.gain * (meanCurrent - ireadings[i].currentDraw) * dt;
+      trimSum += trims[i];
+    }
+  }
+
+  // Keep the trims centered so the group is driven as hard as it was asked to be
+  const double trimMean = trimSum / balancedCount;
+  for (std::size_t i = 0; i < trims.size(); i++) {
+    if (balanced[i]) {
+      trims[i] = std::clamp(trims[i] - trimMean, -params.maxTrim, params.maxTrim);
+    }
+  }
+}
+
+std::int16_t MotorLoadBalancer::apply(const std::size_t imotor, const std::int16_t ivoltage) const {
+  if (imotor >= trims.size() || ivoltage == 0) {
+    return ivoltage;
+  }
+
+  const double trimmed = ivoltage + (ivoltage > 0 ? 1 : -1) * trims[imotor];
+  return static_cast<std::int16_t>(std::clamp(std::lround(trimmed), -12000L, 12000L));
+}
+
+std::int32_t
+MotorLoadBalancer::moveVoltage(const std::vector<std::shared_ptr<AbstractMotor>> &imotors,
+                               const std::int16_t ivoltage,
+                               const QTime idt) {
+  const std::size_t count = std::min(imotors.size(), readings.size());
+  for (std::size_t i = 0; i < count; i++) {
+    readings[i].velocity = imotors[i]->getActualVelocity();
+    readings[i].currentDraw = imotors[i]->getCurrentDraw();
+  }
+  update(readings, idt);
+
+  std::int32_t out = 1;
+  for (std::size_t i = 0; i < imotors.size(); i++) {
+    const auto errorCode = imotors[i]->moveVoltage(i < count ? apply(i, ivoltage) : ivoltage);
+    if (errorCode != 1) {
+      out = errorCode;
+    }
+  }
+  return out;
+}
+
+std::int32_t
+MotorLoadBalancer::moveVelocity(const std::vector<std::shared_ptr<AbstractMotor>> &imotors,
+                                const std::int16_t ivelocity) {
+  std::int32_t out = 1;
+  for (auto &&motor : imotors) {
+    const auto errorCode = motor->moveVelocity(ivelocity);
+    if (errorCode != 1) {
+      out = errorCode;
+    }
+  }
+  return out;
+}
+
+double MotorLoadBalancer::getTrim(const std::size_t imotor) const {
+  return imotor < trims.size() ? trims[imotor] : 0;
+}
+
+void MotorLoadBalancer::reset() {
+  std::fill(trims.begin(), trims.end(), 0);
+}
+
+const MotorLoadBalancerParams &MotorLoadBalancer::getParams() const {
+  return params;
+}
+} // namespace okapi
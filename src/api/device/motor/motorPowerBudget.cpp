@@ -0,0 +1,291 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#include "okapi/api/device/motor/motorPowerBudget.hpp"
+#include "okapi/api/util/mathUtil.hpp"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+
+namespace okapi {
+MotorPowerBudget::MotorPowerBudget(const TimeUtil &itimeUtil,
+                                   const std::int32_t itotalCurrent,
+                                   const QTime &imatchLength,
+                                   const MotorThermalModel &imodel,
+                                   const QTime &isamplePeriod,
+                                   std::shared_ptr<Logger> ilogger)
+  : logger(std::move(ilogger)),
+    timeUtil(itimeUtil),
+    timer(itimeUtil.getTimer()),
+    totalCurrent(itotalCurrent),
+    matchLength(imatchLength),
+    model(imodel),
+    samplePeriod(isamplePeriod) {
+  if (totalCurrent <= 0) {
+    std::string msg("MotorPowerBudget: The total current must be positive.");
+    LOG_ERROR(msg);
+    throw std::invalid_argument(msg);
+  }
+
+  if (!(model.windingResistance > 0) || !(model.thermalResistance > 0) ||
+      !(model.timeConstant > 0_ms) || !(model.throttleTemperature > model.ambientTemperature) ||
+      model.temperatureResolution < 0) {
+    std::string msg("MotorPowerBudget: The resistances and time constant of the thermal model "
+                    "must be positive, and the throttle temperature must be above the ambient "
+                    "temperature.");
+    LOG_ERROR(msg);
+    throw std::invalid_argument(msg);
+  }
+
+  matchStart = timer->millis();
+}
+
+MotorPowerBudget::~MotorPowerBudget() {
+  dtorCalled.store(true, std::memory_order_release);
+  delete task;
+}
+
+std::size_t
+MotorPowerBudget::addSubsystem(const std::vector<std::shared_ptr<AbstractMotor>> &imotors,
+                               const PowerBudgetSubsystem &isubsystem) {
+  if (!(isubsystem.weight > 0) || isubsystem.minCurrentLimit < 0 ||
+      isubsystem.minCurrentLimit > isubsystem.maxCurrentLimit) {
+    std::string msg("MotorPowerBudget: The weight of a subsystem must be positive and its minimum "
+                    "current limit must be between zero and its maximum current limit.");
+    LOG_ERROR(msg);
+    throw std::invalid_argument(msg);
+  }
+
+  Subsystem subsystem{{}, isubsystem};
+  subsystem.motors.reserve(imotors.size());
+  for (auto &&motor : imotors) {
+    subsystem.motors.push_back(BudgetedMotor{motor, MotorPowerStats{}, false, 0});
+  }
+
+  std::scoped_lock lock(mutex);
+  subsystems.push_back(std::move(subsystem));
+  return subsystems.size() - 1;
+}
+
+void MotorPowerBudget::startMatch() {
+  std::scoped_lock lock(mutex);
+  matchStart = timer->millis();
+}
+
+void MotorPowerBudget::step() {
+  std::scoped_lock lock(mutex);
+
+  const QTime now = timer->millis();
+  const double dt = hasSampled ? std::max((now - lastSample).convert(second), 0.0) : 0;
+  const double horizon = std::max(matchLength - (now - matchStart), minHorizon).convert(second);
+  lastSample = now;
+  hasSampled = true;
+
+  for (auto &subsystem : subsystems) {
+    for (auto &motor : subsystem.motors) {
+      sample(motor, dt, horizon, subsystem.params);
+    }
+  }
+
+  allocate();
+}
+
+void MotorPowerBudget::sample(BudgetedMotor &imotor,
+                              const double idt,
+                              const double ihorizon,
+                              const PowerBudgetSubsystem &isubsystem) {
+  auto &stats = imotor.stats;
+
+  const double temperature = imotor.motor->getTemperature();
+  const std::int32_t currentDraw = imotor.motor->getCurrentDraw();
+  if (!std::isfinite(temperature) || temperature == OKAPI_PROS_ERR ||
+      currentDraw == OKAPI_PROS_ERR) {
+    // The motor is probably unplugged. Keep its estimate until it can be read again.
+    if (!imotor.sampled) {
+      imotor.target = isubsystem.minCurrentLimit;
+    }
+    return;
+  }
+
+  const double power = imotor.motor->getPower();
+  stats.power = std::isfinite(power) && power != OKAPI_PROS_ERR ? power : 0;
+
+  const double tau = model.timeConstant.convert(second);
+  const double current = std::abs(currentDraw) / 1000.0;
+  if (!imotor.sampled) {
+    stats.estimatedTemperature = temperature;
+    stats.meanCurrentDraw = std::abs(currentDraw);
+    imotor.sampled = true;
+  } else {
+    // Move towards where the winding settles at this current, exactly for a constant current
+    const double settled = model.ambientTemperature +
+                           current * current * model.windingResistance * model.thermalResistance;
+    stats.estimatedTemperature += (settled - stats.estimatedTemperature) * -std::expm1(-idt / tau);
+    stats.meanCurrentDraw += meanWeight * (std::abs(currentDraw) - stats.meanCurrentDraw);
+  }
+
+  // The reading is rounded to its resolution, so the winding is within half a step of it
+  const double halfStep = model.temperatureResolution / 2;
+  stats.estimatedTemperature =
+    std::clamp(stats.estimatedTemperature, temperature - halfStep, temperature + halfStep);
+  stats.temperature = temperature;
+
+  // The power which heats the winding from its estimate to the throttle temperature in exactly the
+  // time left
+  const double decay = std::exp(-ihorizon / tau);
+  const double settledLimit =
+    (model.throttleTemperature - stats.estimatedTemperature * decay) / (1 - decay);
+  const double sustainablePower =
+    std::max((settledLimit - model.ambientTemperature) / model.thermalResistance, 0.0);
+  stats.sustainableCurrent = 1000 * std::sqrt(sustainablePower / model.windingResistance);
+
+  stats.timeToThrottle =
+    predictTimeToThrottle(stats.estimatedTemperature, stats.meanCurrentDraw / 1000);
+
+  imotor.target = static_cast<std::int32_t>(
+    std::clamp(stats.sustainableCurrent,
+               static_cast<double>(isubsystem.minCurrentLimit),
+               static_cast<double>(isubsystem.maxCurrentLimit)));
+}
+
+void MotorPowerBudget::allocate() {
+  // Each motor gets its minimum plus a share of the rest of its target. The share of a subsystem
+  // is its weight times a scale, found so the limits add up to the total budget.
+  const auto limitAt = [&](const Subsystem &isubsystem,
+                           const BudgetedMotor &imotor,
+                           const double iscale) {
+    const double share = std::min(isubsystem.params.weight * iscale, 1.0);
+    const double minimum = isubsystem.params.minCurrentLimit;
+    return minimum + (std::max(imotor.target - minimum, 0.0)) * share;
+  };
+
+  const auto totalAt = [&](const double iscale) {
+    double total = 0;
+    for (const auto &subsystem : subsystems) {
+      for (const auto &motor : subsystem.motors) {
+        total += limitAt(subsystem, motor, iscale);
+      }
+    }
+    return total;
+  };
+
+  double minWeight = std::numeric_limits<double>::infinity();
+  for (const auto &subsystem : subsystems) {
+    minWeight = std::min(minWeight, subsystem.params.weight);
+  }
+
+  // At this scale every subsystem gets its whole target
+  double high = subsystems.empty() ? 0 : 1 / minWeight;
+  double scale = high;
+  if (totalAt(high) > totalCurrent) {
+    if (totalAt(0) > totalCurrent && !overBudgetLogged) {
+      LOG_WARN("MotorPowerBudget: The minimum current limits add up to more than the total "
+               "current of " +
+               std::to_string(totalCurrent) + " mA.");
+      overBudgetLogged = true;
+    }
+
+    double low = 0;
+    for (int i = 0; i < 40; i++) {
+      const double mid = (low + high) / 2;
+      if (totalAt(mid) > totalCurrent) {
+        high = mid;
+      } else {
+        low = mid;
+      }
+    }
+    scale = low;
+  }
+
+  for (auto &subsystem : subsystems) {
+    for (auto &motor : subsystem.motors) {
+      // Round down to a step so small changes in the estimate don't write to the motor every time
+      const auto limit = static_cast<std::int32_t>(limitAt(subsystem, motor, scale)) / 10 * 10;
+      if (limit != motor.stats.currentLimit) {
+        motor.motor->setCurrentLimit(limit);
+        motor.stats.currentLimit = limit;
+      }
+    }
+  }
+}
+
+QTime MotorPowerBudget::predictTimeToThrottle(const double iestimatedTemperature,
+                                              const double icurrent) const {
+  if (iestimatedTemperature >= model.throttleTemperature) {
+    return 0_ms;
+  }
+
+  const double settled = model.ambientTemperature +
+                         icurrent * icurrent * model.windingResistance * model.thermalResistance;
+  if (settled <= model.throttleTemperature) {
+    return std::numeric_limits<double>::infinity() * second;
+  }
+
+  return model.timeConstant *
+         std::log((settled - iestimatedTemperature) / (settled - model.throttleTemperature));
+}
+
+MotorPowerStats MotorPowerBudget::getMotorStats(const std::size_t isubsystem,
+                                                const std::size_t imotor) const {
+  std::scoped_lock lock(mutex);
+  return subsystems.at(isubsystem).motors.at(imotor).stats;
+}
+
+QTime MotorPowerBudget::getTimeToThrottle(const std::size_t isubsystem) const {
+  std::scoped_lock lock(mutex);
+  QTime shortest = std::numeric_limits<double>::infinity() * second;
+  for (const auto &motor : subsystems.at(isubsystem).motors) {
+    if (motor.sampled) {
+      shortest = std::min(shortest, motor.stats.timeToThrottle);
+    }
+  }
+  return shortest;
+}
+
+double MotorPowerBudget::getPower(const std::size_t isubsystem) const {
+  std::scoped_lock lock(mutex);
+  double power = 0;
+  for (const auto &motor : subsystems.at(isubsystem).motors) {
+    power += motor.stats.power;
+  }
+  return power;
+}
+
+std::size_t MotorPowerBudget::getSubsystemCount() const {
+  std::scoped_lock lock(mutex);
+  return subsystems.size();
+}
+
+void MotorPowerBudget::startThread(const std::uint32_t ipriority, const std::uint16_t istackDepth) {
+  if (!task) {
+    task = new CrossplatformThread(trampoline, this, "MotorPowerBudget", ipriority, istackDepth);
+  }
+}
+
+CrossplatformThread *MotorPowerBudget::getThread() const {
+  return task;
+}
+
+void MotorPowerBudget::trampoline(void *context) {
+  if (context) {
+    static_cast<MotorPowerBudget *>(context)->loop();
+  }
+}
+
+void MotorPowerBudget::loop() {
+  LOG_INFO_S("Started MotorPowerBudget task.");
+
+  auto rate = timeUtil.getRate();
+  while (!dtorCalled.load(std::memory_order_acquire) && !task->notifyTake(0)) {
+    step();
+    rate->delayUntil(samplePeriod);
+  }
+
+  LOG_INFO_S("Stopped MotorPowerBudget task.");
+}
+} // namespace okapi
@@ -0,0 +1,47 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#include "okapi/api/device/motor/motorWriteCoalescer.hpp"
+
+namespace okapi {
+MotorWriteCoalescer::MotorWriteCoalescer(const QTime irefreshPeriod)
+  : refreshPeriod(irefreshPeriod) {
+}
+
+bool MotorWriteCoalescer::shouldWrite(const command icommand,
+                                      const std::int32_t ivalue,
+                                      const QTime inow) {
+  if (enabled && icommand == lastCommand && ivalue == lastValue &&
+      inow - lastWriteTime < refreshPeriod) {
+    return false;
+  }
+
+  lastCommand = icommand;
+  lastValue = ivalue;
+  lastWriteTime = inow;
+  return true;
+}
+
+void MotorWriteCoalescer::invalidate() {
+  lastCommand = command::none;
+}
+
+void MotorWriteCoalescer::setEnabled(const bool ienabled) {
+  enabled = ienabled;
+  invalidate();
+}
+
+bool MotorWriteCoalescer::isEnabled() const {
+  return enabled;
+}
+
+void MotorWriteCoalescer::setRefreshPeriod(const QTime irefreshPeriod) {
+  refreshPeriod = irefreshPeriod;
+}
+
+QTime MotorWriteCoalescer::getRefreshPeriod() const {
+  return refreshPeriod;
+}
+} // namespace okapi
@@ -0,0 +1,95 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#include "okapi/api/device/pingScheduler.hpp"
+#include "okapi/api/util/mathUtil.hpp"
+#include <mutex>
+#include <string>
+
+namespace okapi {
+PingScheduler::PingScheduler(const TimeUtil &itimeUtil,
+                             const QTime &islotPeriod,
+                             std::shared_ptr<Logger> ilogger)
+  : logger(std::move(ilogger)), timeUtil(itimeUtil), slotPeriod(islotPeriod) {
+}
+
+PingScheduler::~PingScheduler() {
+  dtorCalled.store(true, std::memory_order_release);
+  delete task;
+}
+
+std::size_t PingScheduler::addSensor(std::shared_ptr<AbstractPingSensor> isensor) {
+  std::scoped_lock lock(mutex);
+  isensor->stopPinging();
+  sensors.push_back(ScheduledSensor{std::move(isensor), OKAPI_PROS_ERR});
+  return sensors.size() - 1;
+}
+
+void PingScheduler::step() {
+  std::scoped_lock lock(mutex);
+  if (sensors.empty()) {
+    return;
+  }
+
+  if (!isPinging) {
+    // Give the first sensor a whole turn before reading it
+    active = 0;
+    isPinging = sensors[active].sensor->startPinging() != OKAPI_PROS_ERR;
+    return;
+  }
+
+  auto &current = sensors[active];
+  const double reading = current.sensor->controllerGet();
+  if (reading != OKAPI_PROS_ERR) {
+    current.reading = reading;
+  }
+
+  if (sensors.size() > 1) {
+    current.sensor->stopPinging();
+    active = (active + 1) % sensors.size();
+    if (sensors[active].sensor->startPinging() == OKAPI_PROS_ERR) {
+      LOG_WARN("PingScheduler: Sensor " + std::to_string(active) + " failed to start pinging.");
+    }
+  }
+}
+
+double PingScheduler::get(const std::size_t isensor) const {
+  std::scoped_lock lock(mutex);
+  return sensors.at(isensor).reading;
+}
+
+std::size_t PingScheduler::getSensorCount() const {
+  std::scoped_lock lock(mutex);
+  return sensors.size();
+}
+
+void PingScheduler::startThread(const std::uint32_t ipriority, const std::uint16_t istackDepth) {
+  if (!task) {
+    task = new CrossplatformThread(trampoline, this, "PingScheduler", ipriority, istackDepth);
+  }
+}
+
+CrossplatformThread *PingScheduler::getThread() const {
+  return task;
+}
+
+void PingScheduler::trampoline(void *context) {
+  if (context) {
+    static_cast<PingScheduler *>(context)->loop();
+  }
+}
+
+void PingScheduler::loop() {
+  LOG_INFO_S("Started PingScheduler task.");
+
+  auto rate = timeUtil.getRate();
+  while (!dtorCalled.load(std::memory_order_acquire) && !task->notifyTake(0)) {
+    step();
+    rate->delayUntil(slotPeriod);
+  }
+
+  LOG_INFO_S("Stopped PingScheduler task.");
+}
+} // namespace okapi
@@ -0,0 +1,17 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#include "okapi/api/device/rotarysensor/continuousRotarySensor.hpp"
+#include "okapi/api/util/mathUtil.hpp"
+
+namespace okapi {
+double ContinuousRotarySensor::getVelocity() const {
+  return OKAPI_PROS_ERR_F;
+}
+
+bool ContinuousRotarySensor::measuresVelocity() const {
+  return false;
+}
+} // namespace okapi
@@ -0,0 +1,148 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#include "okapi/api/device/rotarysensor/driftCompensatedGyro.hpp"
+#include <cmath>
+#include <mutex>
+
+namespace okapi {
+DriftCompensatedGyro::DriftCompensatedGyro(std::shared_ptr<ContinuousRotarySensor> igyro,
+                                           const TimeUtil &itimeUtil,
+                                           const QTime &icalibrationTime,
+                                           const double istillRate,
+                                           std::shared_ptr<Logger> ilogger)
+  : logger(std::move(ilogger)),
+    gyro(std::move(igyro)),
+    timeUtil(itimeUtil),
+    timer(timeUtil.getTimer()),
+    calibrationTime(icalibrationTime),
+    stillRate(istillRate),
+    value(OKAPI_PROS_ERR) {
+}
+
+DriftCompensatedGyro::~DriftCompensatedGyro() {
+  dtorCalled.store(true, std::memory_order_release);
+  delete task;
+}
+
+void DriftCompensatedGyro::setStillSupplier(std::function<bool()> iisStill) {
+  std::scoped_lock lock(mutex);
+  isStill = std::move(iisStill);
+}
+
+void DriftCompensatedGyro::step() {
+  const double reading = gyro->get();
+  if (reading == OKAPI_PROS_ERR || !std::isfinite(reading)) {
+    return;
+  }
+
+  const QTime now = timer->millis();
+  std::scoped_lock lock(mutex);
+
+  if (!started) {
+    started = true;
+    lastTime = checkTime = windowTime = now;
+    checkReading = windowReading = reading;
+    value.store(reading - correction, std::memory_order_relaxed);
+    return;
+  }
+
+  double currentBias = bias.load(std::memory_order_relaxed);
+  correction += currentBias * (now - lastTime).convert(second);
+  lastTime = now;
+
+  if (const QTime checkDt = now - checkTime; checkDt >= stillCheckPeriod) {
+    const double rate = (reading - checkReading) / checkDt.convert(second);
+    const bool still = isStill ? isStill() : std::abs(rate - currentBias) <= stillRate;
+    checkTime = now;
+    checkReading = reading;
+
+    if (!still) {
+      // Only warn when a still stretch is cut short, not on every check while the robot moves
+      if (!calibrated.load(std::memory_order_relaxed) && now - windowTime >= 2 * stillCheckPeriod) {
+        LOG_WARN_S("DriftCompensatedGyro: The robot moved during calibration. Starting over.");
+      }
+
+      windowTime = now;
+      windowReading = reading;
+    } else if (const QTime windowDt = now - windowTime; windowDt >= calibrationTime) {
+      const double estimate = (reading - windowReading) / windowDt.convert(second);
+      if (calibrated.load(std::memory_order_relaxed)) {
+        currentBias += biasUpdateGain * (estimate - currentBias);
+      } else {
+        // Nothing was corrected while calibrating, so remove the drift of the whole window
+        correction += reading - windowReading;
+        currentBias = estimate;
+        calibrated.store(true, std::memory_order_relaxed);
+        LOG_INFO("DriftCompensatedGyro: Calibrated with a bias of " + std::to_string(estimate) +
+                 " per second.");
+      }
+
+      bias.store(currentBias, std::memory_order_relaxed);
+      windowTime = now;
+      windowReading = reading;
+    }
+  }
+
+  value.store(reading - correction, std::memory_order_relaxed);
+}
+
+double DriftCompensatedGyro::get() const {
+  return value.load(std::memory_order_relaxed);
+}
+
+std::int32_t DriftCompensatedGyro::reset() {
+  std::scoped_lock lock(mutex);
+  const std::int32_t result = gyro->reset();
+
+  // The next step starts measuring from the new zero
+  started = false;
+  correction = 0;
+  value.store(0, std::memory_order_relaxed);
+  return result;
+}
+
+double DriftCompensatedGyro::controllerGet() {
+  return get();
+}
+
+double DriftCompensatedGyro::getBias() const {
+  return bias.load(std::memory_order_relaxed);
+}
+
+bool DriftCompensatedGyro::isCalibrated() const {
+  return calibrated.load(std::memory_order_relaxed);
+}
+
+void DriftCompensatedGyro::startThread(const std::uint32_t ipriority,
+                                       const std::uint16_t istackDepth) {
+  if (!task) {
+    task =
+      new CrossplatformThread(trampoline, this, "DriftCompensatedGyro", ipriority, istackDepth);
+  }
+}
+
+CrossplatformThread *DriftCompensatedGyro::getThread() const {
+  return task;
+}
+
+void DriftCompensatedGyro::trampoline(void *context) {
+  if (context) {
+    static_cast<DriftCompensatedGyro *>(context)->loop();
+  }
+}
+
+void DriftCompensatedGyro::loop() {
+  LOG_INFO_S("Started DriftCompensatedGyro task.");
+
+  auto rate = timeUtil.getRate();
+  while (!dtorCalled.load(std::memory_order_acquire) && !task->notifyTake(0)) {
+    step();
+    rate->delayUntil(samplePeriod);
+  }
+
+  LOG_INFO_S("Stopped DriftCompensatedGyro task.");
+}
+} // namespace okapi
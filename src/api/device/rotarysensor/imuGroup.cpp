@@ -0,0 +1,65 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#include "okapi/api/device/rotarysensor/imuGroup.hpp"
+#include "okapi/api/util/mathUtil.hpp"
+#include <cmath>
+#include <stdexcept>
+#include <string>
+
+namespace okapi {
+ImuGroup::ImuGroup(std::vector<std::shared_ptr<ContinuousRotarySensor>> iimus,
+                   const std::shared_ptr<Logger> &logger)
+  : imus(std::move(iimus)) {
+  if (imus.empty()) {
+    std::string msg = "ImuGroup: There must be at least one IMU.";
+    LOG_ERROR(msg);
+    throw std::invalid_argument(msg);
+  }
+}
+
+double ImuGroup::get() const {
+  // Average the headings as unit vectors so they don't average wrong across the wrap at 180
+  double sinSum = 0;
+  double cosSum = 0;
+  std::size_t count = 0;
+  for (const auto &imu : imus) {
+    const double heading = imu->get();
+    if (heading == OKAPI_PROS_ERR || !std::isfinite(heading)) {
+      continue;
+    }
+
+    const double angle = heading * degreeToRadian;
+    sinSum += std::sin(angle);
+    cosSum += std::cos(angle);
+    count++;
+  }
+
+  if (count == 0) {
+    return OKAPI_PROS_ERR;
+  }
+
+  return std::atan2(sinSum, cosSum) * radianToDegree;
+}
+
+std::int32_t ImuGroup::reset() {
+  std::int32_t out = 1;
+  for (const auto &imu : imus) {
+    if (imu->reset() == OKAPI_PROS_ERR) {
+      out = OKAPI_PROS_ERR;
+    }
+  }
+
+  return out;
+}
+
+double ImuGroup::controllerGet() {
+  return get();
+}
+
+std::size_t ImuGroup::size() const {
+  return imus.size();
+}
+} // namespace okapi
@@ -0,0 +1,44 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#include "okapi/api/device/rotarysensor/potentiometerCalibration.hpp"
+#include <stdexcept>
+#include <string>
+
+namespace okapi {
+PotentiometerCalibration::PotentiometerCalibration(
+  std::vector<std::pair<std::int32_t, double>> ipoints, const std::shared_ptr<Logger> &ilogger) {
+  const auto &logger = ilogger;
+
+  std::stable_sort(ipoints.begin(), ipoints.end(), [](const auto &a, const auto &b) {
+    return a.first < b.first;
+  });
+  ipoints.erase(std::unique(ipoints.begin(),
+                            ipoints.end(),
+                            [](const auto &a, const auto &b) { return a.first == b.first; }),
+                ipoints.end());
+
+  if (ipoints.size() < 2) {
+    std::string msg = "PotentiometerCalibration: At least two points with different raw readings "
+                      "are needed.";
+    LOG_ERROR(msg);
+    throw std::invalid_argument(msg);
+  }
+
+  // Each reading uses the segment it falls in, or the nearest one past either end
+  std::size_t segment = 0;
+  for (std::int32_t raw = 0; raw <= maxRaw; raw++) {
+    while (segment + 2 < ipoints.size() && raw > ipoints[segment + 1].first) {
+      segment++;
+    }
+
+    const auto &[lowRaw, lowAngle] = ipoints[segment];
+    const auto &[highRaw, highAngle] = ipoints[segment + 1];
+    const double angle =
+      lowAngle + (highAngle - lowAngle) * static_cast<double>(raw - lowRaw) / (highRaw - lowRaw);
+    table[static_cast<std::size_t>(raw)] = static_cast<float>(angle);
+  }
+}
+} // namespace okapi
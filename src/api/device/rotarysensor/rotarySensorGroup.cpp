@@ -0,0 +1,26 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#include "okapi/api/device/rotarysensor/rotarySensorGroup.hpp"
+
+namespace okapi {
+RotarySensorGroup::RotarySensorGroup(std::vector<std::shared_ptr<ContinuousRotarySensor>> isensors)
+  : sensors(std::move(isensors)) {
+}
+
+RotarySensorGroup::~RotarySensorGroup() = default;
+
+std::size_t RotarySensorGroup::read(double *ovalues, std::uint32_t *otimestamps) const {
+  for (std::size_t i = 0; i < sensors.size(); i++) {
+    ovalues[i] = sensors[i]->getTimestamped(otimestamps[i]);
+  }
+
+  return sensors.size();
+}
+
+std::size_t RotarySensorGroup::size() const {
+  return sensors.size();
+}
+} // namespace okapi
@@ -0,0 +1,103 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#include "okapi/api/device/sensorSamplingService.hpp"
+#include "okapi/api/util/mathUtil.hpp"
+#include <cmath>
+
+namespace okapi {
+SensorSamplingService::SensorSamplingService(Sampler isampler,
+                                             std::unique_ptr<Filter> ifilter,
+                                             const double iminConfidence,
+                                             const TimeUtil &itimeUtil,
+                                             const QTime &isamplePeriod,
+                                             std::shared_ptr<Logger> ilogger)
+  : logger(std::move(ilogger)),
+    sampler(std::move(isampler)),
+    filter(std::move(ifilter)),
+    minConfidence(iminConfidence),
+    timeUtil(itimeUtil),
+    timer(timeUtil.getTimer()),
+    samplePeriod(isamplePeriod),
+    value(OKAPI_PROS_ERR) {
+}
+
+SensorSamplingService::~SensorSamplingService() {
+  dtorCalled.store(true, std::memory_order_release);
+  if (scheduler) {
+    scheduler->removeLoop(schedulerLoopId);
+  }
+  delete task;
+}
+
+bool SensorSamplingService::step() {
+  const SensorSample sample = sampler();
+  if (sample.value == OKAPI_PROS_ERR || !std::isfinite(sample.value) ||
+      sample.confidence < minConfidence) {
+    rejectedCount.fetch_add(1, std::memory_order_relaxed);
+    return false;
+  }
+
+  value.store(filter->filter(sample.value), std::memory_order_relaxed);
+  lastSampleTime.store(static_cast<std::uint32_t>(timer->millis().convert(millisecond)),
+                       std::memory_order_relaxed);
+  return true;
+}
+
+double SensorSamplingService::get() const {
+  return value.load(std::memory_order_relaxed);
+}
+
+double SensorSamplingService::controllerGet() {
+  return get();
+}
+
+QTime SensorSamplingService::getLastSampleTime() const {
+  return lastSampleTime.load(std::memory_order_relaxed) * millisecond;
+}
+
+std::uint32_t SensorSamplingService::getRejectedCount() const {
+  return rejectedCount.load(std::memory_order_relaxed);
+}
+
+void SensorSamplingService::startThread(const std::uint32_t ipriority,
+                                        const std::uint16_t istackDepth) {
+  if (!task && !scheduler) {
+    task =
+      new CrossplatformThread(trampoline, this, "SensorSamplingService", ipriority, istackDepth);
+  }
+}
+
+void SensorSamplingService::startScheduled(const std::shared_ptr<ControlScheduler> &ischeduler) {
+  if (!task && !scheduler) {
+    scheduler = ischeduler;
+    schedulerLoopId = scheduler->addLoop([this]() { step(); },
+                                         [this]() { return samplePeriod; },
+                                         ControlScheduler::phase::sensors);
+  }
+}
+
+CrossplatformThread *SensorSamplingService::getThread() const {
+  return task;
+}
+
+void SensorSamplingService::trampoline(void *context) {
+  if (context) {
+    static_cast<SensorSamplingService *>(context)->loop();
+  }
+}
+
+void SensorSamplingService::loop() {
+  LOG_INFO_S("Started SensorSamplingService task.");
+
+  auto rate = timeUtil.getRate();
+  while (!dtorCalled.load(std::memory_order_acquire) && !task->notifyTake(0)) {
+    step();
+    rate->delayUntil(samplePeriod);
+  }
+
+  LOG_INFO_S("Stopped SensorSamplingService task.");
+}
+} // namespace okapi
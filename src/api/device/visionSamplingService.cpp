@@ -0,0 +1,157 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#include "okapi/api/device/visionSamplingService.hpp"
+#include <algorithm>
+
+namespace okapi {
+// x, y, width, and height share one word, and the signature has the other
+static std::uint64_t packPosition(const VisionObject &iobject) {
+  return static_cast<std::uint64_t>(static_cast<std::uint16_t>(iobject.x)) |
+         static_cast<std::uint64_t>(static_cast<std::uint16_t>(iobject.y)) << 16 |
+         static_cast<std::uint64_t>(iobject.width) << 32 |
+         static_cast<std::uint64_t>(iobject.height) << 48;
+}
+
+static void unpackPosition(const std::uint64_t iword, VisionObject &oobject) {
+  oobject.x = static_cast<std::int16_t>(iword & 0xFFFF);
+  oobject.y = static_cast<std::int16_t>((iword >> 16) & 0xFFFF);
+  oobject.width = static_cast<std::uint16_t>((iword >> 32) & 0xFFFF);
+  oobject.height = static_cast<std::uint16_t>((iword >> 48) & 0xFFFF);
+}
+
+const VisionObject *VisionFrame::findLargest(const std::uint16_t isignature) const {
+  for (std::size_t i = 0; i < count; i++) {
+    if (objects[i].signature == isignature) {
+      return &objects[i];
+    }
+  }
+
+  return nullptr;
+}
+
+VisionSamplingService::VisionSamplingService(Sampler isampler,
+                                             const TimeUtil &itimeUtil,
+                                             const QTime &isamplePeriod,
+                                             const QTime &ilatency,
+                                             std::shared_ptr<Logger> ilogger)
+  : logger(std::move(ilogger)),
+    sampler(std::move(isampler)),
+    timeUtil(itimeUtil),
+    timer(timeUtil.getTimer()),
+    samplePeriod(isamplePeriod),
+    latency(ilatency) {
+}
+
+VisionSamplingService::~VisionSamplingService() {
+  dtorCalled.store(true, std::memory_order_release);
+  delete task;
+}
+
+bool VisionSamplingService::step() {
+  VisionFrame frame;
+  const std::int32_t count = sampler(frame.objects.data(), VisionFrame::maxObjects);
+  if (count == OKAPI_PROS_ERR || count < 0) {
+    failedCount.fetch_add(1, std::memory_order_relaxed);
+    return false;
+  }
+
+  frame.count =
+    static_cast<std::uint8_t>(std::min(static_cast<std::size_t>(count), VisionFrame::maxObjects));
+  frame.time = std::max(timer->millis() - latency, 0_ms);
+  publish(frame);
+  return true;
+}
+
+void VisionSamplingService::publish(const VisionFrame &iframe) {
+  const std::uint32_t count = frameCount.load(std::memory_order_relaxed) + 1;
+  Cell &cell = cells[count % 2];
+
+  const std::uint32_t sequence = cell.sequence.load(std::memory_order_relaxed);
+  cell.sequence.store(sequence + 1, std::memory_order_relaxed);
+  std::atomic_thread_fence(std::memory_order_release);
+
+  cell.time.store(static_cast<std::uint32_t>(iframe.time.convert(millisecond)),
+                  std::memory_order_relaxed);
+  cell.count.store(iframe.count, std::memory_order_relaxed);
+  for (std::size_t i = 0; i < iframe.count; i++) {
+    const VisionObject &object = iframe.objects[i];
+    cell.words[2 * i].store(packPosition(object), std::memory_order_relaxed);
+    cell.words[2 * i + 1].store(object.signature, std::memory_order_relaxed);
+  }
+
+  cell.sequence.store(sequence + 2, std::memory_order_release);
+  frameCount.store(count, std::memory_order_release);
+}
+
+VisionFrame VisionSamplingService::getFrame() const {
+  VisionFrame frame;
+  while (true) {
+    const std::uint32_t count = frameCount.load(std::memory_order_acquire);
+    if (count == 0) {
+      return frame;
+    }
+
+    const Cell &cell = cells[count % 2];
+    const std::uint32_t sequence = cell.sequence.load(std::memory_order_acquire);
+    if (sequence % 2 != 0) {
+      continue;
+    }
+
+    frame.time = cell.time.load(std::memory_order_relaxed) * millisecond;
+    frame.count = std::min<std::uint8_t>(cell.count.load(std::memory_order_relaxed),
+                                         VisionFrame::maxObjects);
+    for (std::size_t i = 0; i < frame.count; i++) {
+      VisionObject &object = frame.objects[i];
+      unpackPosition(cell.words[2 * i].load(std::memory_order_relaxed), object);
+      object.signature =
+        static_cast<std::uint16_t>(cell.words[2 * i + 1].load(std::memory_order_relaxed));
+    }
+
+    std::atomic_thread_fence(std::memory_order_acquire);
+    if (cell.sequence.load(std::memory_order_relaxed) == sequence) {
+      return frame;
+    }
+  }
+}
+
+std::uint32_t VisionSamplingService::getFrameCount() const {
+  return frameCount.load(std::memory_order_acquire);
+}
+
+std::uint32_t VisionSamplingService::getFailedCount() const {
+  return failedCount.load(std::memory_order_relaxed);
+}
+
+void VisionSamplingService::startThread(const std::uint32_t ipriority,
+                                        const std::uint16_t istackDepth) {
+  if (!task) {
+    task =
+      new CrossplatformThread(trampoline, this, "VisionSamplingService", ipriority, istackDepth);
+  }
+}
+
+CrossplatformThread *VisionSamplingService::getThread() const {
+  return task;
+}
+
+void VisionSamplingService::trampoline(void *context) {
+  if (context) {
+    static_cast<VisionSamplingService *>(context)->loop();
+  }
+}
+
+void VisionSamplingService::loop() {
+  LOG_INFO_S("Started VisionSamplingService task.");
+
+  auto rate = timeUtil.getRate();
+  while (!dtorCalled.load(std::memory_order_acquire) && !task->notifyTake(0)) {
+    step();
+    rate->delayUntil(samplePeriod);
+  }
+
+  LOG_INFO_S("Stopped VisionSamplingService task.");
+}
+} // namespace okapi
@@ -0,0 +1,98 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#include "okapi/api/filter/alphaBetaFilter.hpp"
+#include "okapi/api/util/logging.hpp"
+#include <stdexcept>
+
+namespace okapi {
+AlphaBetaFilter::AlphaBetaFilter(const double ialpha,
+                                 const double ibeta,
+                                 const QTime idt,
+                                 const double igamma)
+  : alpha(ialpha), beta(ibeta), gamma(igamma), nominalDt(idt.convert(second)) {
+  checkGains(alpha, beta, gamma);
+
+  if (!(nominalDt > 0)) {
+    auto logger = Logger::getDefaultLogger();
+    std::string msg("AlphaBetaFilter: The time between readings must be positive.");
+    LOG_ERROR(msg);
+    throw std::invalid_argument(msg);
+  }
+}
+
+double AlphaBetaFilter::filter(const double ireading) {
+  return filter(ireading, nominalDt * second);
+}
+
+double AlphaBetaFilter::filter(const double ireading, const QTime idt) {
+  const double dt = idt.convert(second);
+  if (!initialized) {
+    initialized = true;
+    position = ireading;
+    return position;
+  }
+
+  if (!(dt > 0)) {
+    // No time has passed, so there is nothing to predict
+    return position;
+  }
+
+  const double predictedPosition = position + velocity * dt + acceleration * dt * dt / 2;
+  const double predictedVelocity = velocity + acceleration * dt;
+  const double residual = ireading - predictedPosition;
+
+  position = predictedPosition + alpha * residual;
+  velocity = predictedVelocity + beta * residual / dt;
+  acceleration += 2 * gamma * residual / (dt * dt);
+
+  return position;
+}
+
+double AlphaBetaFilter::getOutput() const {
+  return position;
+}
+
+void AlphaBetaFilter::filterBatch(const double *iinput,
+                                  double *ooutput,
+                                  const std::size_t icount) {
+  for (std::size_t i = 0; i < icount; i++) {
+    ooutput[i] = AlphaBetaFilter::filter(iinput[i]);
+  }
+}
+
+double AlphaBetaFilter::getVelocity() const {
+  return velocity;
+}
+
+double AlphaBetaFilter::getAcceleration() const {
+  return acceleration;
+}
+
+void AlphaBetaFilter::setGains(const double ialpha, const double ibeta, const double igamma) {
+  checkGains(ialpha, ibeta, igamma);
+  alpha = ialpha;
+  beta = ibeta;
+  gamma = igamma;
+}
+
+void AlphaBetaFilter::reset() {
+  position = 0;
+  velocity = 0;
+  acceleration = 0;
+  initialized = false;
+}
+
+void AlphaBetaFilter::checkGains(const double ialpha, const double ibeta, const double igamma) {
+  if (!(ialpha > 0 && ialpha <= 1) || !(ibeta >= 0) || !(igamma >= 0) ||
+      !(4 - 2 * ialpha - ibeta > 0)) {
+    auto logger = Logger::getDefaultLogger();
+    std::string msg("AlphaBetaFilter: Alpha must be in (0, 1], beta and gamma must not be "
+                    "negative, and 4 - 2 * alpha - beta must be positive.");
+    LOG_ERROR(msg);
+    throw std::invalid_argument(msg);
+  }
+}
+} // namespace okapi
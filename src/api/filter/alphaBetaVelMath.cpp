@@ -0,0 +1,45 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#include "okapi/api/filter/alphaBetaVelMath.hpp"
+#include "okapi/api/filter/passthroughFilter.hpp"
+#include <utility>
+
+namespace okapi {
+AlphaBetaVelMath::AlphaBetaVelMath(const double iticksPerRev,
+                                   const double ialpha,
+                                   const double ibeta,
+                                   const double igamma,
+                                   const QTime isampleTime,
+                                   std::unique_ptr<AbstractTimer> iloopDtTimer,
+                                   std::shared_ptr<Logger> ilogger)
+  : VelMath(iticksPerRev,
+            std::make_unique<PassthroughFilter>(),
+            isampleTime,
+            std::move(iloopDtTimer),
+            std::move(ilogger)),
+    // The tracker is always given the measured dt, so its nominal dt only needs to be valid
+    tracker(ialpha, ibeta, isampleTime > 0_ms ? isampleTime : 10_ms, igamma) {
+}
+
+AlphaBetaFilter &AlphaBetaVelMath::getFilter() {
+  return tracker;
+}
+
+void AlphaBetaVelMath::addSample(const double inewPos, const QTime idt) {
+  tracker.filter(inewPos, idt);
+
+  lastVel = vel;
+  vel = tracker.getVelocity() * rpmPerTicksPerSecond * rpm;
+  // The acceleration estimate stays exactly zero unless gamma is not zero
+  if (tracker.getAcceleration() != 0) {
+    accel = tracker.getAcceleration() * rpmPerTicksPerSecond * rpm / second;
+  } else {
+    accel = (vel - lastVel) / idt;
+  }
+
+  lastPos = inewPos;
+}
+} // namespace okapi
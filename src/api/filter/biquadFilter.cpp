@@ -0,0 +1,185 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#include "okapi/api/filter/biquadFilter.hpp"
+#include "okapi/api/util/logging.hpp"
+#include "okapi/api/util/mathUtil.hpp"
+#include <cmath>
+#include <stdexcept>
+#include <utility>
+
+namespace okapi {
+BiquadFilter::BiquadFilter(std::vector<BiquadCoefficients> isections) {
+  if (isections.empty()) {
+    auto logger = Logger::getDefaultLogger();
+    std::string msg("BiquadFilter: The filter needs at least one section.");
+    LOG_ERROR(msg);
+    throw std::invalid_argument(msg);
+  }
+
+  sections.reserve(isections.size());
+  for (const auto &coefficients : isections) {
+    sections.push_back(Section{coefficients});
+  }
+  heap.setBytes(sections.capacity() * sizeof(Section));
+}
+
+BiquadFilter
+BiquadFilter::lowPass(const QFrequency icutoff, const QFrequency isampleRate, const double iq) {
+  return BiquadFilter({lowPassSection(normalizedFrequency(icutoff, isampleRate, iq), iq)});
+}
+
+BiquadFilter
+BiquadFilter::highPass(const QFrequency icutoff, const QFrequency isampleRate, const double iq) {
+  return BiquadFilter({highPassSection(normalizedFrequency(icutoff, isampleRate, iq), iq)});
+}
+
+BiquadFilter
+BiquadFilter::notch(const QFrequency icenter, const QFrequency isampleRate, const double iq) {
+  const double w0 = normalizedFrequency(icenter, isampleRate, iq);
+  const double cosW0 = std::cos(w0);
+  const double alpha = std::sin(w0) / (2 * iq);
+  const double a0 = 1 + alpha;
+  return BiquadFilter({{1 / a0, -2 * cosW0 / a0, 1 / a0, -2 * cosW0 / a0, (1 - alpha) / a0}});
+}
+
+BiquadFilter BiquadFilter::butterworthLowPass(const std::size_t iorder,
+                                              const QFrequency icutoff,
+                                              const QFrequency isampleRate) {
+  const auto qs = butterworthQs(iorder);
+  const double w0 = normalizedFrequency(icutoff, isampleRate, butterworthQ);
+
+  std::vector<BiquadCoefficients> out;
+  for (const double q : qs) {
+    out.push_back(lowPassSection(w0, q));
+  }
+
+  if (iorder % 2 == 1) {
+    out.push_back(firstOrderLowPassSection(w0));
+  }
+
+  return BiquadFilter(std::move(out));
+}
+
+BiquadFilter BiquadFilter::butterworthHighPass(const std::size_t iorder,
+                                               const QFrequency icutoff,
+                                               const QFrequency isampleRate) {
+  const auto qs = butterworthQs(iorder);
+  const double w0 = normalizedFrequency(icutoff, isampleRate, butterworthQ);
+
+  std::vector<BiquadCoefficients> out;
+  for (const double q : qs) {
+    out.push_back(highPassSection(w0, q));
+  }
+
+  if (iorder % 2 == 1) {
+    out.push_back(firstOrderHighPassSection(w0));
+  }
+
+  return BiquadFilter(std::move(out));
+}
+
+double BiquadFilter::filter(const double ireading) {
+  double value = ireading;
+  for (auto &section : sections) {
+    // Transposed direct form II, which needs two state variables per section
+    const auto &c = section.coefficients;
+    const double out = c.b0 * value + section.z1;
+    section.z1 = c.b1 * value - c.a1 * out + section.z2;
+    section.z2 = c.b2 * value - c.a2 * out;
+    value = out;
+  }
+
+  output = value;
+  return output;
+}
+
+double BiquadFilter::getOutput() const {
+  return output;
+}
+
+void BiquadFilter::filterBatch(const double *iinput, double *ooutput, const std::size_t icount) {
+  for (std::size_t i = 0; i < icount; i++) {
+    ooutput[i] = BiquadFilter::filter(iinput[i]);
+  }
+}
+
+void BiquadFilter::reset() {
+  for (auto &section : sections) {
+    section.z1 = 0;
+    section.z2 = 0;
+  }
+
+  output = 0;
+}
+
+std::vector<BiquadCoefficients> BiquadFilter::getSections() const {
+  std::vector<BiquadCoefficients> out;
+  out.reserve(sections.size());
+  for (const auto &section : sections) {
+    out.push_back(section.coefficients);
+  }
+  return out;
+}
+
+BiquadCoefficients BiquadFilter::lowPassSection(const double iw0, const double iq) {
+  const double cosW0 = std::cos(iw0);
+  const double alpha = std::sin(iw0) / (2 * iq);
+  const double a0 = 1 + alpha;
+  const double b1 = (1 - cosW0) / a0;
+  return {b1 / 2, b1, b1 / 2, -2 * cosW0 / a0, (1 - alpha) / a0};
+}
+
+BiquadCoefficients BiquadFilter::highPassSection(const double iw0, const double iq) {
+  const double cosW0 = std::cos(iw0);
+  const double alpha = std::sin(iw0) / (2 * iq);
+  const double a0 = 1 + alpha;
+  const double b0 = (1 + cosW0) / (2 * a0);
+  return {b0, -2 * b0, b0, -2 * cosW0 / a0, (1 - alpha) / a0};
+}
+
+BiquadCoefficients BiquadFilter::firstOrderLowPassSection(const double iw0) {
+  const double k = std::tan(iw0 / 2);
+  return {k / (k + 1), k / (k + 1), 0, (k - 1) / (k + 1), 0};
+}
+
+BiquadCoefficients BiquadFilter::firstOrderHighPassSection(const double iw0) {
+  const double k = std::tan(iw0 / 2);
+  return {1 / (k + 1), -1 / (k + 1), 0, (k - 1) / (k + 1), 0};
+}
+
+std::vector<double> BiquadFilter::butterworthQs(const std::size_t iorder) {
+  if (iorder == 0) {
+    auto logger = Logger::getDefaultLogger();
+    std::string msg("BiquadFilter: The order of a Butterworth filter must be at least one.");
+    LOG_ERROR(msg);
+    throw std::invalid_argument(msg);
+  }
+
+  // Each pair of poles at an angle phi from the negative real axis is a section with a Q of
+  // 1 / (2 cos(phi))
+  std::vector<double> out;
+  for (std::size_t k = 0; k < iorder / 2; k++) {
+    const double phi = pi * static_cast<double>(iorder - 1 - 2 * k) / (2.0 * iorder);
+    out.push_back(1 / (2 * std::cos(phi)));
+  }
+  return out;
+}
+
+double BiquadFilter::normalizedFrequency(const QFrequency ifrequency,
+                                         const QFrequency isampleRate,
+                                         const double iq) {
+  if (!(isampleRate.getValue() > 0) || !(ifrequency.getValue() > 0) ||
+      !(ifrequency < isampleRate / 2) || !(iq > 0)) {
+    auto logger = Logger::getDefaultLogger();
+    std::string msg("BiquadFilter: The frequency must be between zero and half the sample rate "
+                    "and the Q must be positive.");
+    LOG_ERROR(msg);
+    throw std::invalid_argument(msg);
+  }
+
+  return 2 * pi * (ifrequency / isampleRate).getValue();
+}
+} // namespace okapi
@@ -21,6 +21,12 @@ double DemaFilter::getOutput() const {
   return outputS + outputB;
 }
 
+void DemaFilter::filterBatch(const double *iinput, double *ooutput, const std::size_t icount) {
+  for (std::size_t i = 0; i < icount; i++) {
+    ooutput[i] = DemaFilter::filter(iinput[i]);
+  }
+}
+
 void DemaFilter::setGains(const double ialpha, const double ibeta) {
   alpha = ialpha;
   beta = ibeta;
@@ -32,4 +32,10 @@ double EKFFilter::filter(const double ireading, const double icontrol) {
 double EKFFilter::getOutput() const {
   return xHat;
 }
+
+void EKFFilter::filterBatch(const double *iinput, double *ooutput, const std::size_t icount) {
+  for (std::size_t i = 0; i < icount; i++) {
+    ooutput[i] = EKFFilter::filter(iinput[i]);
+  }
+}
 } // namespace okapi
@@ -19,6 +19,12 @@ double EmaFilter::getOutput() const {
   return output;
 }
 
+void EmaFilter::filterBatch(const double *iinput, double *ooutput, const std::size_t icount) {
+  for (std::size_t i = 0; i < icount; i++) {
+    ooutput[i] = EmaFilter::filter(iinput[i]);
+  }
+}
+
 void EmaFilter::setGains(const double ialpha) {
   alpha = ialpha;
 }
@@ -7,4 +7,10 @@
 
 namespace okapi {
 Filter::~Filter() = default;
+
+void Filter::filterBatch(const double *iinput, double *ooutput, const std::size_t icount) {
+  for (std::size_t i = 0; i < icount; i++) {
+    ooutput[i] = filter(iinput[i]);
+  }
+}
 } // namespace okapi
@@ -0,0 +1,116 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#include "okapi/api/filter/leastSquaresVelMath.hpp"
+#include "okapi/api/filter/passthroughFilter.hpp"
+#include <algorithm>
+#include <cmath>
+#include <utility>
+
+namespace okapi {
+LeastSquaresVelMath::LeastSquaresVelMath(const double iticksPerRev,
+                                         const std::size_t iwindowSize,
+                                         const QTime isampleTime,
+                                         std::unique_ptr<AbstractTimer> iloopDtTimer,
+                                         std::shared_ptr<Logger> ilogger)
+  : VelMath(iticksPerRev,
+            std::make_unique<PassthroughFilter>(),
+            isampleTime,
+            std::move(iloopDtTimer),
+            std::move(ilogger)),
+    times(iwindowSize, 0),
+    positions(iwindowSize, 0),
+    heap(HeapSubsystem::filters, (times.capacity() + positions.capacity()) * sizeof(double)) {
+  if (iwindowSize < 3) {
+    std::string msg("LeastSquaresVelMath: The window must hold at least three samples.");
+    LOG_ERROR(msg);
+    throw std::invalid_argument(msg);
+  }
+}
+
+void LeastSquaresVelMath::addSample(const double inewPos, const QTime idt) {
+  if (count == 0) {
+    newest = 0;
+  } else {
+    elapsed += idt.convert(second);
+    newest = (newest + 1) % times.size();
+  }
+
+  times[newest] = elapsed;
+  positions[newest] = inewPos;
+  count = std::min(count + 1, times.size());
+
+  fit();
+  lastPos = inewPos;
+}
+
+void LeastSquaresVelMath::reset() {
+  count = 0;
+  elapsed = 0;
+  hasTimestamp = false;
+  vel = 0_rpm;
+  lastVel = 0_rpm;
+  accel = 0_rpm / second;
+}
+
+std::size_t LeastSquaresVelMath::getWindowSize() const {
+  return times.size();
+}
+
+/**
+ * The determinant of the 3x3 matrix with the given columns.
+ */
+static double det3(const double (&a)[3], const double (&b)[3], const double (&c)[3]) {
+  return a[0] * (b[1] * c[2] - b[2] * c[1]) - b[0] * (a[1] * c[2] - a[2] * c[1]) +
+         c[0] * (a[1] * b[2] - a[2] * b[1]);
+}
+
+void LeastSquaresVelMath::fit() {
+  const std::size_t oldest = (newest + times.size() + 1 - count) % times.size();
+  const double span = times[newest] - times[oldest];
+  if (count < 2 || span <= 0) {
+    return;
+  }
+
+  // Fit in time scaled to [-1, 0] and position relative to the newest sample, so the sums stay
+  // well conditioned no matter the sample time or how far the encoder has turned
+  double s[5]{};
+  double t[3]{};
+  for (std::size_t i = 0; i < count; i++) {
+    const std::size_t index = (oldest + i) % times.size();
+    const double x = (times[index] - times[newest]) / span;
+    const double y = positions[index] - positions[newest];
+
+    double xPow = 1;
+    for (std::size_t k = 0; k < 5; k++) {
+      s[k] += xPow;
+      if (k < 3) {
+        t[k] += xPow * y;
+      }
+      xPow *= x;
+    }
+  }
+
+  const double ticksPerSecondToRpm = 60 / ticksPerRev;
+  const double col0[3]{s[0], s[1], s[2]};
+  const double col1[3]{s[1], s[2], s[3]};
+  const double col2[3]{s[2], s[3], s[4]};
+  const double det = count >= 3 ? det3(col0, col1, col2) : 0;
+
+  lastVel = vel;
+  if (std::abs(det) > 1e-9) {
+    // y = c0 + c1 x + c2 x^2, so at the newest sample dy/dx = c1 and d2y/dx2 = 2 c2
+    const double c1 = det3(col0, t, col2) / det;
+    const double c2 = det3(col0, col1, t) / det;
+    vel = c1 / span * ticksPerSecondToRpm * rpm;
+    accel = 2 * c2 / (span * span) * ticksPerSecondToRpm * rpm / second;
+  } else {
+    // Not enough distinct samples for a quadratic yet, so fit a line
+    const double c1 = (s[0] * t[1] - s[1] * t[0]) / (s[0] * s[2] - s[1] * s[1]);
+    vel = c1 / span * ticksPerSecondToRpm * rpm;
+    accel = (vel - lastVel) / (span * second);
+  }
+}
+} // namespace okapi
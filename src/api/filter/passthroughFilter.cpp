@@ -17,4 +17,12 @@ double PassthroughFilter::filter(const double ireading) {
 double PassthroughFilter::getOutput() const {
   return lastOutput;
 }
+
+void PassthroughFilter::filterBatch(const double *iinput,
+                                    double *ooutput,
+                                    const std::size_t icount) {
+  for (std::size_t i = 0; i < icount; i++) {
+    ooutput[i] = PassthroughFilter::filter(iinput[i]);
+  }
+}
 } // namespace okapi
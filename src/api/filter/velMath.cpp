@@ -17,6 +17,7 @@ VelMath::VelMath(const double iticksPerRev,
                  std::shared_ptr<Logger> ilogger)
   : logger(std::move(ilogger)),
     ticksPerRev(iticksPerRev),
+    rpmPerTicksPerSecond(60 / iticksPerRev),
     sampleTime(isampleTime),
     loopDtTimer(std::move(iloopDtTimer)),
     filter(std::move(ifilter)) {
@@ -32,18 +33,41 @@ VelMath::~VelMath() = default;
 
 QAngularSpeed VelMath::step(const double inewPos) {
   if (loopDtTimer->readDt() >= sampleTime) {
-    const QTime dt = loopDtTimer->getDt();
+    addSample(inewPos, loopDtTimer->getDt());
+  }
 
-    vel = filter->filter(((inewPos - lastPos) * (60 / ticksPerRev)) / dt.convert(second)) * rpm;
-    accel = (vel - lastVel) / dt;
+  return vel;
+}
+
+QAngularSpeed VelMath::step(const double inewPos, const QTime itimestamp) {
+  if (itimestamp == 0_ms) {
+    return step(inewPos);
+  }
 
-    lastVel = vel;
+  if (!hasTimestamp) {
+    hasTimestamp = true;
+    lastTimestamp = itimestamp;
     lastPos = inewPos;
+    return vel;
+  }
+
+  const QTime dt = itimestamp - lastTimestamp;
+  if (dt > 0_ms && dt >= sampleTime) {
+    addSample(inewPos, dt);
+    lastTimestamp = itimestamp;
   }
 
   return vel;
 }
 
+void VelMath::addSample(const double inewPos, const QTime idt) {
+  vel = filter->filter(((inewPos - lastPos) * rpmPerTicksPerSecond) / idt.convert(second)) * rpm;
+  accel = (vel - lastVel) / idt;
+
+  lastVel = vel;
+  lastPos = inewPos;
+}
+
 void VelMath::setTicksPerRev(const double iTPR) {
   if (iTPR == 0) {
     std::string msg(
@@ -53,6 +77,7 @@ void VelMath::setTicksPerRev(const double iTPR) {
   }
 
   ticksPerRev = iTPR;
+  rpmPerTicksPerSecond = 60 / iTPR;
 }
 
 QAngularSpeed VelMath::getVelocity() const {
@@ -0,0 +1,99 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#include "okapi/api/odometry/fieldMap.hpp"
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+#include <string>
+
+namespace okapi {
+FieldMap::FieldMap(const std::vector<FieldWall> &iwalls, const std::shared_ptr<Logger> &ilogger)
+  : logger(ilogger) {
+  for (const auto &wall : iwalls) {
+    addWall(wall);
+  }
+}
+
+FieldMap FieldMap::rectangle(const QLength &iminX,
+                             const QLength &imaxX,
+                             const QLength &iminY,
+                             const QLength &imaxY,
+                             const std::shared_ptr<Logger> &logger) {
+  if (iminX >= imaxX || iminY >= imaxY) {
+    std::string msg("FieldMap: The minimum walls must be below the maximum walls.");
+    LOG_ERROR(msg);
+    throw std::invalid_argument(msg);
+  }
+
+  return FieldMap({{{iminX, iminY}, {imaxX, iminY}},
+                   {{imaxX, iminY}, {imaxX, imaxY}},
+                   {{imaxX, imaxY}, {iminX, imaxY}},
+                   {{iminX, imaxY}, {iminX, iminY}}},
+                  logger);
+}
+
+void FieldMap::addWall(const FieldWall &iwall) {
+  if (iwall.start.x == iwall.end.x && iwall.start.y == iwall.end.y) {
+    std::string msg("FieldMap: A wall must have a length.");
+    LOG_ERROR(msg);
+    throw std::invalid_argument(msg);
+  }
+
+  walls.push_back(iwall);
+}
+
+const std::vector<FieldWall> &FieldMap::getWalls() const {
+  return walls;
+}
+
+bool FieldMap::raycast(const Point &iorigin, const QAngle &idirection, RaycastHit &ohit) const {
+  const double originX = iorigin.x.convert(meter);
+  const double originY = iorigin.y.convert(meter);
+  const double dirX = std::cos(idirection.convert(radian));
+  const double dirY = std::sin(idirection.convert(radian));
+
+  bool hit = false;
+  double closest = std::numeric_limits<double>::infinity();
+  for (const auto &wall : walls) {
+    const double startX = wall.start.x.convert(meter);
+    const double startY = wall.start.y.convert(meter);
+    const double wallX = wall.end.x.convert(meter) - startX;
+    const double wallY = wall.end.y.convert(meter) - startY;
+
+    const double denominator = dirX * wallY - dirY * wallX;
+    if (std::abs(denominator) < 1e-12) {
+      // The ray runs along the wall
+      continue;
+    }
+
+    // Solve origin + t * dir = start + u * wall
+    const double toStartX = startX - originX;
+    const double toStartY = startY - originY;
+    const double t = (toStartX * wallY - toStartY * wallX) / denominator;
+    const double u = (toStartX * dirY - toStartY * dirX) / denominator;
+    if (t <= 0 || u < 0 || u > 1 || t >= closest) {
+      continue;
+    }
+
+    const double length = std::hypot(wallX, wallY);
+    double normalX = -wallY / length;
+    double normalY = wallX / length;
+    if (normalX * dirX + normalY * dirY > 0) {
+      normalX = -normalX;
+      normalY = -normalY;
+    }
+
+    closest = t;
+    hit = true;
+    ohit.distance = t * meter;
+    ohit.normalX = normalX;
+    ohit.normalY = normalY;
+    ohit.incidence = std::acos(std::min(1.0, -(normalX * dirX + normalY * dirY))) * radian;
+  }
+
+  return hit;
+}
+} // namespace okapi
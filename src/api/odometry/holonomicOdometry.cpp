@@ -0,0 +1,76 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#include "okapi/api/odometry/holonomicOdometry.hpp"
+#include "okapi/api/odometry/odomMath.hpp"
+#include <cmath>
+
+namespace okapi {
+HolonomicOdometry::HolonomicOdometry(const TimeUtil &itimeUtil,
+                                     const std::shared_ptr<ReadOnlyChassisModel> &imodel,
+                                     const ChassisScales &ichassisScales,
+                                     const QSpeed &imaxSpeed,
+                                     const std::shared_ptr<Logger> &ilogger)
+  : ThreeEncoderOdometry(itimeUtil, imodel, ichassisScales, ilogger),
+    maxSpeed(imaxSpeed.convert(mps)) {
+  if (!(maxSpeed > 0)) {
+    std::string msg = "HolonomicOdometry: The maximum speed must be greater than zero.";
+    LOG_ERROR(msg);
+    throw std::invalid_argument(msg);
+  }
+
+  integration = OdomIntegration::EXPONENTIAL_MAP;
+}
+
+OdomState HolonomicOdometry::odomMathStep(const std::valarray<std::int32_t> &itickDiff,
+                                          const QTime &ideltaT) {
+  if (itickDiff.size() < 3) {
+    LOG_ERROR_S("HolonomicOdometry: itickDiff did not have at least three elements.");
+    return OdomState{};
+  }
+
+  const double deltaL = itickDiff[0] * chassisScales.metersPerTick;
+  const double deltaR = itickDiff[1] * chassisScales.metersPerTick;
+  const double deltaM = itickDiff[2] * chassisScales.middleMetersPerTick;
+
+  const double dt = ideltaT.convert(second);
+  const double maxDistance = maxSpeed * dt;
+  for (const double delta : {deltaL, deltaR, deltaM}) {
+    if (std::abs(delta) > maxDistance) {
+      rejectStep(logger,
+                 "HolonomicOdometry",
+                 delta,
+                 "A wheel moved " + std::to_string(delta) +
+                   " m in one step, faster than the maximum speed. Skipping this odometry step.");
+      return OdomState{};
+    }
+  }
+
+  const double forward = (deltaL + deltaR) / 2;
+  const double deltaTheta = (deltaL - deltaR) * chassisScales.inverseWheelTrack;
+  // The middle wheel rolls back by its distance from the tracking center as the robot turns, which
+  // isn't strafing
+  const double strafe = deltaM + deltaTheta * chassisScales.middleWheelDistance.convert(meter);
+
+  forwardVelocity.store(forward / dt, std::memory_order_relaxed);
+  strafeVelocity.store(strafe / dt, std::memory_order_relaxed);
+  angularVelocity.store(deltaTheta / dt, std::memory_order_relaxed);
+
+  return OdomMath::integrateExponentialMap(
+    forward * meter, strafe * meter, deltaTheta * radian, state.theta);
+}
+
+QSpeed HolonomicOdometry::getForwardVelocity() const {
+  return forwardVelocity.load(std::memory_order_relaxed) * mps;
+}
+
+QSpeed HolonomicOdometry::getStrafeVelocity() const {
+  return strafeVelocity.load(std::memory_order_relaxed) * mps;
+}
+
+QAngularSpeed HolonomicOdometry::getAngularVelocity() const {
+  return angularVelocity.load(std::memory_order_relaxed) * radps;
+}
+} // namespace okapi
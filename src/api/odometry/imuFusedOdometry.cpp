@@ -0,0 +1,112 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#include "okapi/api/odometry/imuFusedOdometry.hpp"
+#include <cmath>
+#include <stdexcept>
+
+namespace okapi {
+ImuFusedOdometry::ImuFusedOdometry(std::shared_ptr<Odometry> iodometry,
+                                   std::shared_ptr<ContinuousRotarySensor> iimu,
+                                   const double iimuWeight,
+                                   const std::shared_ptr<Logger> &ilogger)
+  : logger(ilogger), odometry(std::move(iodometry)), imu(std::move(iimu)), imuWeight(iimuWeight) {
+  if (odometry == nullptr || imu == nullptr) {
+    std::string msg = "ImuFusedOdometry: The odometry and the inertial sensor cannot be null.";
+    LOG_ERROR(msg);
+    throw std::invalid_argument(msg);
+  }
+
+  if (!(imuWeight >= 0 && imuWeight <= 1)) {
+    std::string msg = "ImuFusedOdometry: The inertial sensor weight must be between 0 and 1.";
+    LOG_ERROR(msg);
+    throw std::invalid_argument(msg);
+  }
+}
+
+void ImuFusedOdometry::setScales(const ChassisScales &ichassisScales) {
+  odometry->setScales(ichassisScales);
+}
+
+void ImuFusedOdometry::step() {
+  if (sharedState.take(state)) {
+    // Anchor the inertial sensor to the new heading
+    hasImuOffset = false;
+  }
+
+  const OdomState encoderBefore = odometry->getState();
+  odometry->step();
+  const OdomState encoderAfter = odometry->getState();
+
+  QAngle theta = state.theta + (encoderAfter.theta - encoderBefore.theta);
+
+  const double imuReading = imu->get();
+  if (std::isfinite(imuReading)) {
+    const QAngle imuTheta = imuReading * degree;
+    if (!hasImuOffset) {
+      imuOffset = theta - imuTheta;
+      hasImuOffset = true;
+    }
+
+    theta += imuWeight * (imuTheta + imuOffset - theta);
+  } else {
+    LOG_WARN_LIMITED(LogRateLimiter::perSecond(1),
+                     std::string("ImuFusedOdometry: Couldn't read the inertial sensor. Using the "
+                                 "encoder heading for this step."));
+  }
+
+  // The encoder odometry tracked this step along the middle of its own heading. Rotate it onto the
+  // middle of the fused heading.
+  const double rotation = ((state.theta + theta - encoderBefore.theta - encoderAfter.theta) / 2.0)
+                            .convert(radian);
+  const double cosRotation = std::cos(rotation);
+  const double sinRotation = std::sin(rotation);
+  const double dX = (encoderAfter.x - encoderBefore.x).convert(meter);
+  const double dY = (encoderAfter.y - encoderBefore.y).convert(meter);
+
+  state.x += (dX * cosRotation - dY * sinRotation) * meter;
+  state.y += (dY * cosRotation + dX * sinRotation) * meter;
+  state.theta = theta;
+
+  // This pose is from the time the encoder odometry's pose is from
+  QTime time;
+  OdomState encoderState;
+  if (odometry->getHistory().getLatest(time, encoderState)) {
+    history.record(time, state);
+  }
+
+  sharedState.publish(state);
+}
+
+OdomState ImuFusedOdometry::getState(const StateMode &imode) const {
+  const OdomState current = sharedState.get();
+  if (imode == StateMode::FRAME_TRANSFORMATION) {
+    return current;
+  } else {
+    return OdomState{current.y, current.x, current.theta};
+  }
+}
+
+void ImuFusedOdometry::setState(const OdomState &istate, const StateMode &imode) {
+  LOG_DEBUG("State set to: " + istate.str());
+  if (imode == StateMode::FRAME_TRANSFORMATION) {
+    sharedState.set(istate);
+  } else {
+    sharedState.set(OdomState{istate.y, istate.x, istate.theta});
+  }
+}
+
+std::shared_ptr<ReadOnlyChassisModel> ImuFusedOdometry::getModel() {
+  return odometry->getModel();
+}
+
+ChassisScales ImuFusedOdometry::getScales() {
+  return odometry->getScales();
+}
+
+std::shared_ptr<Odometry> ImuFusedOdometry::getEncoderOdometry() const {
+  return odometry;
+}
+} // namespace okapi
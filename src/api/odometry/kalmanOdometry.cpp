@@ -0,0 +1,290 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#include "okapi/api/odometry/kalmanOdometry.hpp"
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+namespace okapi {
+KalmanOdometry::KalmanOdometry(const TimeUtil &itimeUtil,
+                               const std::shared_ptr<ReadOnlyChassisModel> &imodel,
+                               const ChassisScales &ichassisScales,
+                               std::shared_ptr<ContinuousRotarySensor> iimu,
+                               const KalmanOdometryNoise &inoise,
+                               const std::shared_ptr<Logger> &ilogger)
+  : logger(ilogger),
+    timer(itimeUtil.getTimer()),
+    model(imodel),
+    chassisScales(ichassisScales),
+    imu(std::move(iimu)),
+    noise(inoise) {
+  // The robot starts at the origin, so only the velocities are unknown
+  PoseFilter::Covariance initialCovariance;
+  initialCovariance(velocityIndex, velocityIndex) = 1;
+  initialCovariance(angularVelocityIndex, angularVelocityIndex) = 1;
+  filter.setState(PoseFilter::State(), initialCovariance);
+}
+
+void KalmanOdometry::addDistanceSensor(std::shared_ptr<ControllerInput<double>> isensor,
+                                       const OdomState &imount,
+                                       const QLength &imaxRange) {
+  if (isensor == nullptr) {
+    std::string msg = "KalmanOdometry: The distance sensor cannot be null.";
+    LOG_ERROR(msg);
+    throw std::invalid_argument(msg);
+  }
+
+  distanceSensors.push_back({std::move(isensor),
+                             imount.x.convert(meter),
+                             imount.y.convert(meter),
+                             imount.theta.convert(radian),
+                             imaxRange.convert(meter)});
+}
+
+void KalmanOdometry::setWalls(const QLength &iminX,
+                              const QLength &imaxX,
+                              const QLength &iminY,
+                              const QLength &imaxY) {
+  setFieldMap(FieldMap::rectangle(iminX, imaxX, iminY, imaxY, logger));
+}
+
+void KalmanOdometry::setFieldMap(const FieldMap &imap) {
+  fieldMap = imap;
+}
+
+void KalmanOdometry::setScales(const ChassisScales &ichassisScales) {
+  chassisScales = ichassisScales;
+  chassisScales.computeDerivedScales();
+}
+
+void KalmanOdometry::step() {
+  OdomState newState;
+  if (sharedState.take(newState)) {
+    applyState(newState);
+  }
+
+  const auto deltaT = timer->getDt();
+  if (deltaT.getValue() == 0) {
+    sharedState.publish(state);
+    return;
+  }
+
+  const double dt = deltaT.convert(second);
+  updateEncoders(dt);
+  predict(dt);
+
+  if (imu) {
+    updateImu();
+  }
+
+  if (!fieldMap.getWalls().empty()) {
+    for (const auto &mount : distanceSensors) {
+      updateDistance(mount);
+    }
+  }
+
+  const auto &x = filter.getState();
+  state = OdomState{x(xIndex, 0) * meter, x(yIndex, 0) * meter, x(thetaIndex, 0) * radian};
+  history.record(timer->millis(), state);
+  sharedState.publish(state);
+}
+
+void KalmanOdometry::updateEncoders(const double idt) {
+  const std::size_t sensorCount = model->getSensorVals(newTicks);
+  if (sensorCount < 2) {
+    LOG_ERROR_LIMITED(LogRateLimiter::perSecond(1),
+                      std::string("KalmanOdometry: The model did not have at least two sensors."));
+    return;
+  }
+
+  const std::int32_t leftDiff = newTicks[0] - lastTicks[0];
+  const std::int32_t rightDiff = newTicks[1] - lastTicks[1];
+  lastTicks = newTicks;
+
+  if (std::abs(leftDiff) > maximumTickDiff || std::abs(rightDiff) > maximumTickDiff) {
+    rejectStep(logger,
+               "KalmanOdometry",
+               std::max(std::abs(leftDiff), std::abs(rightDiff)),
+               "A tick diff (" + std::to_string(leftDiff) + ", " + std::to_string(rightDiff) +
+                 ") was greater than the maximum allowable diff (" +
+                 std::to_string(maximumTickDiff) + "). Skipping the encoders this step.");
+    return;
+  }
+
+  const double deltaL = leftDiff * chassisScales.metersPerTick;
+  const double deltaR = rightDiff * chassisScales.metersPerTick;
+
+  const Matrix<2, 1> z{(deltaL + deltaR) / 2 / idt,
+                       (deltaL - deltaR) * chassisScales.inverseWheelTrack / idt};
+
+  Matrix<2, stateDim> H;
+  H(0, velocityIndex) = 1;
+  H(1, angularVelocityIndex) = 1;
+
+  Matrix<2, 2> R;
+  R(0, 0) = noise.encoderVelocity;
+  R(1, 1) = noise.encoderAngularVelocity;
+
+  filter.update(z, H, R);
+}
+
+void KalmanOdometry::predict(const double idt) {
+  const auto &x = filter.getState();
+  const double velocity = x(velocityIndex, 0);
+  const double angularVelocity = x(angularVelocityIndex, 0);
+
+  // Move along the heading in the middle of the step, like the arc the encoder odometry tracks
+  const double midTheta = x(thetaIndex, 0) + angularVelocity * idt / 2;
+  const double cosTheta = std::cos(midTheta);
+  const double sinTheta = std::sin(midTheta);
+
+  PoseFilter::State predicted = x;
+  predicted(xIndex, 0) += velocity * cosTheta * idt;
+  predicted(yIndex, 0) += velocity * sinTheta * idt;
+  predicted(thetaIndex, 0) += angularVelocity * idt;
+
+  PoseFilter::Covariance F = PoseFilter::Covariance::identity();
+  F(xIndex, thetaIndex) = -velocity * sinTheta * idt;
+  F(xIndex, velocityIndex) = cosTheta * idt;
+  F(xIndex, angularVelocityIndex) = -velocity * sinTheta * idt * idt / 2;
+  F(yIndex, thetaIndex) = velocity * cosTheta * idt;
+  F(yIndex, velocityIndex) = sinTheta * idt;
+  F(yIndex, angularVelocityIndex) = velocity * cosTheta * idt * idt / 2;
+  F(thetaIndex, angularVelocityIndex) = idt;
+
+  PoseFilter::Covariance Q;
+  Q(xIndex, xIndex) = noise.position * idt;
+  Q(yIndex, yIndex) = noise.position * idt;
+  Q(thetaIndex, thetaIndex) = noise.heading * idt;
+  Q(velocityIndex, velocityIndex) = noise.velocity * idt;
+  Q(angularVelocityIndex, angularVelocityIndex) = noise.angularVelocity * idt;
+
+  filter.predict(predicted, F, Q);
+}
+
+void KalmanOdometry::updateImu() {
+  const double imuReading = imu->get();
+  if (!std::isfinite(imuReading)) {
+    LOG_WARN_LIMITED(LogRateLimiter::perSecond(1),
+                     std::string("KalmanOdometry: Couldn't read the inertial sensor."));
+    return;
+  }
+
+  const double imuTheta = (imuReading * degree).convert(radian);
+  const double theta = filter.getState()(thetaIndex, 0);
+  if (!hasImuOffset) {
+    imuOffset = theta - imuTheta;
+    hasImuOffset = true;
+  }
+
+  Matrix<1, stateDim> H;
+  H(0, thetaIndex) = 1;
+  filter.updateInnovation(
+    Matrix<1, 1>{imuTheta + imuOffset - theta}, H, Matrix<1, 1>{noise.imuHeading});
+}
+
+void KalmanOdometry::updateDistance(const DistanceSensorMount &imount) {
+  const double reading = imount.sensor->controllerGet() / 1000.0;
+  if (!std::isfinite(reading) || reading <= 0 || reading > imount.maxRange) {
+    return;
+  }
+
+  const auto &x = filter.getState();
+  const double theta = x(thetaIndex, 0);
+  const double cosTheta = std::cos(theta);
+  const double sinTheta = std::sin(theta);
+
+  // The position of the sensor and the direction of its beam
+  const double sensorX = x(xIndex, 0) + imount.forward * cosTheta - imount.right * sinTheta;
+  const double sensorY = x(yIndex, 0) + imount.forward * sinTheta + imount.right * cosTheta;
+  const double beamAngle = theta + imount.angle;
+
+  RaycastHit hit;
+  if (!fieldMap.raycast({sensorX * meter, sensorY * meter}, beamAngle * radian, hit) ||
+      hit.incidence.convert(radian) > maxDistanceIncidence) {
+    return;
+  }
+
+  // The expected distance is n . (sensor - wall) / c, where n is the normal of the wall and c is
+  // the cosine of the incidence. Differentiate it with respect to the pose.
+  const double expected = hit.distance.convert(meter);
+  const double cosIncidence = std::cos(hit.incidence.convert(radian));
+  const double dSensorX = -imount.forward * sinTheta - imount.right * cosTheta;
+  const double dSensorY = imount.forward * cosTheta - imount.right * sinTheta;
+  const double dCosIncidence =
+    hit.normalX * std::sin(beamAngle) - hit.normalY * std::cos(beamAngle);
+
+  Matrix<1, stateDim> H;
+  H(0, xIndex) = hit.normalX / cosIncidence;
+  H(0, yIndex) = hit.normalY / cosIncidence;
+  H(0, thetaIndex) = (hit.normalX * dSensorX + hit.normalY * dSensorY) / cosIncidence -
+                     expected * dCosIncidence / cosIncidence;
+
+  const Matrix<1, 1> innovation{reading - expected};
+  const Matrix<1, 1> R{noise.distance};
+  const double innovationVariance = filter.getInnovationCovariance(H, R)(0, 0);
+  if (innovation(0, 0) * innovation(0, 0) > distanceGate * distanceGate * innovationVariance) {
+    // Probably another robot or field element, not the wall
+    return;
+  }
+
+  filter.updateInnovation(innovation, H, R);
+}
+
+OdomState KalmanOdometry::getState(const StateMode &imode) const {
+  const OdomState current = sharedState.get();
+  if (imode == StateMode::FRAME_TRANSFORMATION) {
+    return current;
+  } else {
+    return OdomState{current.y, current.x, current.theta};
+  }
+}
+
+void KalmanOdometry::setState(const OdomState &istate, const StateMode &imode) {
+  LOG_DEBUG("State set to: " + istate.str());
+  if (imode == StateMode::FRAME_TRANSFORMATION) {
+    sharedState.set(istate);
+  } else {
+    sharedState.set(OdomState{istate.y, istate.x, istate.theta});
+  }
+}
+
+void KalmanOdometry::applyState(const OdomState &istate) {
+  state = istate;
+  PoseFilter::State x = filter.getState();
+  x(xIndex, 0) = state.x.convert(meter);
+  x(yIndex, 0) = state.y.convert(meter);
+  x(thetaIndex, 0) = state.theta.convert(radian);
+
+  // The new pose is known exactly, so it no longer depends on the velocities
+  PoseFilter::Covariance P;
+  P(velocityIndex, velocityIndex) = filter.getCovariance()(velocityIndex, velocityIndex);
+  P(angularVelocityIndex, angularVelocityIndex) =
+    filter.getCovariance()(angularVelocityIndex, angularVelocityIndex);
+  filter.setState(x, P);
+  hasImuOffset = false;
+}
+
+QSpeed KalmanOdometry::getVelocity() const {
+  return filter.getState()(velocityIndex, 0) * mps;
+}
+
+QAngularSpeed KalmanOdometry::getAngularVelocity() const {
+  return filter.getState()(angularVelocityIndex, 0) * radps;
+}
+
+const KalmanOdometry::PoseFilter &KalmanOdometry::getFilter() const {
+  return filter;
+}
+
+std::shared_ptr<ReadOnlyChassisModel> KalmanOdometry::getModel() {
+  return model;
+}
+
+ChassisScales KalmanOdometry::getScales() {
+  return chassisScales;
+}
+} // namespace okapi
@@ -4,6 +4,7 @@
  * file, You can obtain one at http://mozilla.org/MPL/2.0/.
  */
 #include "okapi/api/odometry/odomMath.hpp"
+#include "okapi/api/util/fastTrig.hpp"
 #include "okapi/api/util/mathUtil.hpp"
 #include <cmath>
 
@@ -29,6 +30,89 @@ std::pair<QLength, QAngle> OdomMath::computeDistanceAndAngleToPoint(const Point
                         computeAngle(xDiff, yDiff, istate.theta.convert(radian)) * radian);
 }
 
+void OdomMath::computeDistancesAndAnglesToPoints(const Point *ipoints,
+                                                 const std::size_t icount,
+                                                 const OdomState &istate,
+                                                 QLength *odistances,
+                                                 QAngle *oangles) {
+  const double x = istate.x.convert(meter);
+  const double y = istate.y.convert(meter);
+  const double theta = istate.theta.convert(radian);
+
+  // Separate loops keep the distance loop free of calls, so it can be vectorized
+  if (odistances != nullptr) {
+    for (std::size_t i = 0; i < icount; i++) {
+      const double xDiff = ipoints[i].x.convert(meter) - x;
+      const double yDiff = ipoints[i].y.convert(meter) - y;
+      odistances[i] = computeDistance(xDiff, yDiff) * meter;
+    }
+  }
+
+  if (oangles != nullptr) {
+    for (std::size_t i = 0; i < icount; i++) {
+      const double xDiff = ipoints[i].x.convert(meter) - x;
+      const double yDiff = ipoints[i].y.convert(meter) - y;
+      oangles[i] = computeAngle(xDiff, yDiff, theta) * radian;
+    }
+  }
+}
+
+std::size_t OdomMath::findClosestPoint(const Point *ipoints,
+                                       const std::size_t icount,
+                                       const OdomState &istate) {
+  const double x = istate.x.convert(meter);
+  const double y = istate.y.convert(meter);
+
+  // Squared distances sort the same way, without the square roots
+  std::size_t closest = icount;
+  double closestSquared = 0;
+  for (std::size_t i = 0; i < icount; i++) {
+    const double xDiff = ipoints[i].x.convert(meter) - x;
+    const double yDiff = ipoints[i].y.convert(meter) - y;
+    const double squared = xDiff * xDiff + yDiff * yDiff;
+    if (closest == icount || squared < closestSquared) {
+      closest = i;
+      closestSquared = squared;
+    }
+  }
+
+  return closest;
+}
+
+OdomState OdomMath::integrateExponentialMap(const QLength &iforward,
+                                            const QLength &iright,
+                                            const QAngle &ideltaTheta,
+                                            const QAngle &itheta) {
+  const double theta = itheta.convert(radian);
+  const double halfDeltaTheta = ideltaTheta.convert(radian) / 2;
+
+  // The chord of the arc points along the heading halfway through the turn, and is shorter than
+  // the arc by sin(halfDeltaTheta) / halfDeltaTheta
+  double chordScale, cosChord, sinChord;
+  if (std::abs(halfDeltaTheta) < 5e-4) {
+    // Close enough to straight that the Taylor series is accurate to about 1e-14, so only the
+    // heading needs trig
+    const double halfSquared = halfDeltaTheta * halfDeltaTheta;
+    chordScale = 1 - halfSquared / 6;
+    const double cosHalf = 1 - halfSquared / 2;
+    const double sinHalf = halfDeltaTheta * chordScale;
+    const double cosTheta = Trig::cos(theta);
+    const double sinTheta = Trig::sin(theta);
+    cosChord = cosTheta * cosHalf - sinTheta * sinHalf;
+    sinChord = sinTheta * cosHalf + cosTheta * sinHalf;
+  } else {
+    chordScale = Trig::sin(halfDeltaTheta) / halfDeltaTheta;
+    cosChord = Trig::cos(theta + halfDeltaTheta);
+    sinChord = Trig::sin(theta + halfDeltaTheta);
+  }
+
+  const double forward = iforward.convert(meter) * chordScale;
+  const double right = iright.convert(meter) * chordScale;
+  return OdomState{(forward * cosChord - right * sinChord) * meter,
+                   (forward * sinChord + right * cosChord) * meter,
+                   ideltaTheta};
+}
+
 std::pair<double, double> OdomMath::computeDiffs(const Point &ipoint, const OdomState &istate) {
   const double xDiff = (ipoint.x - istate.x).convert(meter);
   const double yDiff = (ipoint.y - istate.y).convert(meter);
@@ -40,7 +124,7 @@ double OdomMath::computeDistance(double xDiff, double yDiff) {
 }
 
 double OdomMath::computeAngle(double xDiff, double yDiff, double theta) {
-  return std::atan2(yDiff, xDiff) - theta;
+  return Trig::atan2(yDiff, xDiff) - theta;
 }
 
 QAngle OdomMath::constrainAngle360(const QAngle &theta) {
@@ -0,0 +1,60 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#include "okapi/api/odometry/odometry.hpp"
+#include "okapi/api/odometry/odomMath.hpp"
+#include "okapi/api/util/flightRecorder.hpp"
+#include <algorithm>
+#include <cmath>
+
+namespace okapi {
+OdomState Odometry::getStateAt(const QTime &itime, const StateMode &imode) const {
+  OdomState state;
+  if (!history.getStateAt(itime, state)) {
+    return getState(imode);
+  }
+
+  if (imode == StateMode::FRAME_TRANSFORMATION) {
+    return state;
+  } else {
+    return OdomState{state.y, state.x, state.theta};
+  }
+}
+
+void Odometry::applyPoseEstimate(const OdomState &iestimate,
+                                 const QTime &itime,
+                                 const double iweight) {
+  const double weight = std::clamp(iweight, 0.0, 1.0);
+  const OdomState past = getStateAt(itime);
+  const OdomState current = getState();
+
+  // Blend the estimate with the pose the odometry had when the estimate was measured
+  const QAngle turn = weight * OdomMath::constrainAngle180(iestimate.theta - past.theta);
+  const QLength x = past.x + weight * (iestimate.x - past.x);
+  const QLength y = past.y + weight * (iestimate.y - past.y);
+
+  // Replay the motion since then from the corrected pose
+  const QLength dx = current.x - past.x;
+  const QLength dy = current.y - past.y;
+  const double cosTurn = std::cos(turn.convert(radian));
+  const double sinTurn = std::sin(turn.convert(radian));
+  setState(
+    {x + dx * cosTurn - dy * sinTurn, y + dx * sinTurn + dy * cosTurn, current.theta + turn});
+}
+
+const PoseHistory &Odometry::getHistory() const {
+  return history;
+}
+
+void Odometry::rejectStep(const std::shared_ptr<Logger> &ilogger,
+                          const char *isource,
+                          const double ivalue,
+                          const std::string &ireason) {
+  const auto &logger = ilogger;
+  // This can fire on every odometry step, so don't let it flood the log
+  LOG_ERROR_LIMITED(LogRateLimiter::perSecond(1), std::string(isource) + ": " + ireason);
+  FlightRecorder::recordDefault(FlightEventType::odometryRejected, isource, 0, ivalue);
+}
+} // namespace okapi
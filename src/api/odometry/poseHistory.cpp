@@ -0,0 +1,101 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#include "okapi/api/odometry/poseHistory.hpp"
+#include <algorithm>
+
+namespace okapi {
+PoseHistory::PoseHistory(const std::size_t icapacity)
+  : capacity(std::max<std::size_t>(icapacity, 2)), cells(std::make_unique<Cell[]>(capacity)) {
+}
+
+void PoseHistory::record(const QTime &itime, const OdomState &istate) {
+  const std::size_t position = writePosition.load(std::memory_order_relaxed);
+  Cell &cell = cells[position % capacity];
+
+  const std::uint32_t sequence = cell.sequence.load(std::memory_order_relaxed);
+  cell.sequence.store(sequence + 1, std::memory_order_relaxed);
+  std::atomic_thread_fence(std::memory_order_release);
+
+  cell.time.store(unit_cast<millisecond>(itime), std::memory_order_relaxed);
+  cell.x.store(istate.x.convert(meter), std::memory_order_relaxed);
+  cell.y.store(istate.y.convert(meter), std::memory_order_relaxed);
+  cell.theta.store(istate.theta.convert(radian), std::memory_order_relaxed);
+
+  cell.sequence.store(sequence + 2, std::memory_order_release);
+  writePosition.store(position + 1, std::memory_order_release);
+}
+
+bool PoseHistory::getStateAt(const QTime &itime, OdomState &ostate) const {
+  const double time = unit_cast<millisecond>(itime);
+  const std::size_t end = writePosition.load(std::memory_order_acquire);
+  const std::size_t count = std::min(end, capacity);
+
+  // Walk back from the newest pose until one is at or before the time. Stop early at a cell which
+  // was overwritten while it was read, because the poses after it have already been replaced.
+  Sample after{};
+  Sample before{};
+  bool hasAfter = false;
+  for (std::size_t i = 1; i <= count; i++) {
+    if (!readCell(cells[(end - i) % capacity], before) || (hasAfter && before.time > after.time)) {
+      break;
+    }
+
+    if (before.time <= time) {
+      if (hasAfter && after.time > before.time) {
+        const double fraction = (time - before.time) / (after.time - before.time);
+        ostate = OdomState{(before.x + (after.x - before.x) * fraction) * meter,
+                           (before.y + (after.y - before.y) * fraction) * meter,
+                           (before.theta + (after.theta - before.theta) * fraction) * radian};
+      } else {
+        ostate = OdomState{before.x * meter, before.y * meter, before.theta * radian};
+      }
+      return true;
+    }
+
+    after = before;
+    hasAfter = true;
+  }
+
+  if (!hasAfter) {
+    return false;
+  }
+
+  // The time is before the oldest pose which could be read
+  ostate = OdomState{after.x * meter, after.y * meter, after.theta * radian};
+  return true;
+}
+
+bool PoseHistory::getLatest(QTime &otime, OdomState &ostate) const {
+  const std::size_t end = writePosition.load(std::memory_order_acquire);
+  Sample sample{};
+  if (end == 0 || !readCell(cells[(end - 1) % capacity], sample)) {
+    return false;
+  }
+
+  otime = sample.time * millisecond;
+  ostate = OdomState{sample.x * meter, sample.y * meter, sample.theta * radian};
+  return true;
+}
+
+std::size_t PoseHistory::getCapacity() const {
+  return capacity;
+}
+
+bool PoseHistory::readCell(const Cell &icell, Sample &osample) {
+  const std::uint32_t sequence = icell.sequence.load(std::memory_order_acquire);
+  if (sequence % 2 != 0) {
+    return false;
+  }
+
+  osample.time = icell.time.load(std::memory_order_relaxed);
+  osample.x = icell.x.load(std::memory_order_relaxed);
+  osample.y = icell.y.load(std::memory_order_relaxed);
+  osample.theta = icell.theta.load(std::memory_order_relaxed);
+
+  std::atomic_thread_fence(std::memory_order_acquire);
+  return icell.sequence.load(std::memory_order_relaxed) == sequence;
+}
+} // namespace okapi
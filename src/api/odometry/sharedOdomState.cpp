@@ -0,0 +1,77 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#include "okapi/api/odometry/sharedOdomState.hpp"
+
+namespace okapi {
+OdomState SharedOdomState::get() const {
+  std::uint32_t count;
+  if (setStates.getWriteCount() != appliedCount.load(std::memory_order_acquire)) {
+    // The stepping task hasn't taken the set state yet
+    return setStates.load(count);
+  }
+
+  return published.load(count);
+}
+
+void SharedOdomState::set(const OdomState &istate) {
+  setStates.store(istate);
+}
+
+bool SharedOdomState::take(OdomState &ostate) {
+  if (setStates.getWriteCount() == takenCount) {
+    return false;
+  }
+
+  ostate = setStates.load(takenCount);
+  return true;
+}
+
+void SharedOdomState::publish(const OdomState &istate) {
+  published.store(istate);
+  appliedCount.store(takenCount, std::memory_order_release);
+}
+
+void SharedOdomState::DoubleBuffer::store(const OdomState &istate) {
+  const std::uint32_t count = writeCount.load(std::memory_order_relaxed) + 1;
+  Cell &cell = cells[count % 2];
+
+  const std::uint32_t sequence = cell.sequence.load(std::memory_order_relaxed);
+  cell.sequence.store(sequence + 1, std::memory_order_relaxed);
+  std::atomic_thread_fence(std::memory_order_release);
+
+  cell.x.store(istate.x.convert(meter), std::memory_order_relaxed);
+  cell.y.store(istate.y.convert(meter), std::memory_order_relaxed);
+  cell.theta.store(istate.theta.convert(radian), std::memory_order_relaxed);
+
+  cell.sequence.store(sequence + 2, std::memory_order_release);
+  writeCount.store(count, std::memory_order_release);
+}
+
+OdomState SharedOdomState::DoubleBuffer::load(std::uint32_t &owriteCount) const {
+  while (true) {
+    owriteCount = writeCount.load(std::memory_order_acquire);
+    const Cell &cell = cells[owriteCount % 2];
+
+    const std::uint32_t sequence = cell.sequence.load(std::memory_order_acquire);
+    if (sequence % 2 != 0) {
+      continue;
+    }
+
+    const double x = cell.x.load(std::memory_order_relaxed);
+    const double y = cell.y.load(std::memory_order_relaxed);
+    const double theta = cell.theta.load(std::memory_order_relaxed);
+
+    std::atomic_thread_fence(std::memory_order_acquire);
+    if (cell.sequence.load(std::memory_order_relaxed) == sequence) {
+      return OdomState{x * meter, y * meter, theta * radian};
+    }
+  }
+}
+
+std::uint32_t SharedOdomState::DoubleBuffer::getWriteCount() const {
+  return writeCount.load(std::memory_order_acquire);
+}
+} // namespace okapi
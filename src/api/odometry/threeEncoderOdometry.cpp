@@ -4,7 +4,9 @@
  * file, You can obtain one at http://mozilla.org/MPL/2.0/.
  */
 #include "okapi/api/odometry/threeEncoderOdometry.hpp"
+#include "okapi/api/odometry/odomMath.hpp"
 #include "okapi/api/units/QSpeed.hpp"
+#include "okapi/api/util/fastTrig.hpp"
 #include <math.h>
 
 namespace okapi {
@@ -29,40 +31,52 @@ OdomState ThreeEncoderOdometry::odomMathStep(const std::valarray<std::int32_t> &
 
   for (auto &&elem : itickDiff) {
     if (std::abs(elem) > maximumTickDiff) {
-      LOG_ERROR("ThreeEncoderOdometry: A tick diff (" + std::to_string(elem) +
-                ") was greater than the maximum allowable diff (" +
-                std::to_string(maximumTickDiff) + "). Skipping this odometry step.");
+      rejectStep(logger,
+                 "ThreeEncoderOdometry",
+                 elem,
+                 "A tick diff (" + std::to_string(elem) +
+                   ") was greater than the maximum allowable diff (" +
+                   std::to_string(maximumTickDiff) + "). Skipping this odometry step.");
       return OdomState{};
     }
   }
 
-  const double deltaL = itickDiff[0] / chassisScales.straight;
-  const double deltaR = itickDiff[1] / chassisScales.straight;
+  const double deltaL = itickDiff[0] * chassisScales.metersPerTick;
+  const double deltaR = itickDiff[1] * chassisScales.metersPerTick;
 
-  double deltaTheta = (deltaL - deltaR) / chassisScales.wheelTrack.convert(meter);
+  double deltaTheta = (deltaL - deltaR) * chassisScales.inverseWheelTrack;
   double localOffX, localOffY;
 
   const auto deltaM = static_cast<const double>(
-    itickDiff[2] / chassisScales.middle -
+    itickDiff[2] * chassisScales.middleMetersPerTick -
     ((deltaTheta / 2_pi) * 1_pi * chassisScales.middleWheelDistance.convert(meter) * 2));
 
+  if (integration == OdomIntegration::EXPONENTIAL_MAP) {
+    // The same arc as below, without going through polar coordinates
+    return OdomMath::integrateExponentialMap(
+      (deltaL + deltaR) / 2 * meter,
+      (deltaM + deltaTheta * chassisScales.middleWheelDistance.convert(meter) * 2) * meter,
+      deltaTheta * radian,
+      state.theta);
+  }
+
   if (deltaL == deltaR) {
     localOffX = deltaM;
     localOffY = deltaR;
   } else {
-    localOffX = 2 * std::sin(deltaTheta / 2) *
+    localOffX = 2 * Trig::sin(deltaTheta / 2) *
                 (deltaM / deltaTheta + chassisScales.middleWheelDistance.convert(meter) * 2);
-    localOffY = 2 * std::sin(deltaTheta / 2) *
+    localOffY = 2 * Trig::sin(deltaTheta / 2) *
                 (deltaR / deltaTheta + chassisScales.wheelTrack.convert(meter) / 2);
   }
 
   double avgA = state.theta.convert(radian) + (deltaTheta / 2);
 
   double polarR = std::sqrt((localOffX * localOffX) + (localOffY * localOffY));
-  double polarA = std::atan2(localOffY, localOffX) - avgA;
+  double polarA = Trig::atan2(localOffY, localOffX) - avgA;
 
-  double dX = std::sin(polarA) * polarR;
-  double dY = std::cos(polarA) * polarR;
+  double dX = Trig::sin(polarA) * polarR;
+  double dY = Trig::cos(polarA) * polarR;
 
   if (isnan(dX)) {
     dX = 0;
@@ -0,0 +1,211 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#include "okapi/api/odometry/trackingWheelOdometry.hpp"
+#include "okapi/api/odometry/odomMath.hpp"
+#include <cmath>
+
+namespace okapi {
+TrackingWheel::TrackingWheel(const QLength &ix,
+                             const QLength &iy,
+                             const QAngle &iheading,
+                             const QLength &iwheelDiameter,
+                             const double itpr,
+                             const double iweight)
+  : x(ix),
+    y(iy),
+    heading(iheading),
+    ticksPerMeter(itpr / (1_pi * iwheelDiameter).convert(meter)),
+    weight(iweight) {
+}
+
+TrackingWheelOdometry::TrackingWheelOdometry(const TimeUtil &itimeUtil,
+                                             const std::shared_ptr<ReadOnlyChassisModel> &imodel,
+                                             const ChassisScales &ichassisScales,
+                                             const std::vector<TrackingWheel> &iwheels,
+                                             const QLength &ioutlierThreshold,
+                                             const std::shared_ptr<Logger> &ilogger)
+  : TwoEncoderOdometry(itimeUtil, imodel, ichassisScales, ilogger),
+    wheelCount(iwheels.size()),
+    outlierThreshold(ioutlierThreshold.convert(meter)) {
+  if (iwheels.size() < 3 || iwheels.size() > maxWheelCount) {
+    std::string msg = "TrackingWheelOdometry: There must be between 3 and " +
+                      std::to_string(maxWheelCount) + " tracking wheels.";
+    LOG_ERROR(msg);
+    throw std::invalid_argument(msg);
+  }
+
+  std::array<double, maxWheelCount> weights{};
+  for (std::size_t i = 0; i < wheelCount; i++) {
+    const TrackingWheel &wheel = iwheels[i];
+    if (wheel.ticksPerMeter == 0 || !std::isfinite(wheel.ticksPerMeter) || wheel.weight <= 0) {
+      std::string msg = "TrackingWheelOdometry: Tracking wheel " + std::to_string(i) +
+                        " must have a size, ticks per revolution, and weight.";
+      LOG_ERROR(msg);
+      throw std::invalid_argument(msg);
+    }
+
+    // A wheel rolls by the part of the movement of its mounting point along its heading
+    const double cosHeading = std::cos(wheel.heading.convert(radian));
+    const double sinHeading = std::sin(wheel.heading.convert(radian));
+    geometry[i] = {cosHeading,
+                   sinHeading,
+                   wheel.x.convert(meter) * sinHeading - wheel.y.convert(meter) * cosHeading};
+    ticksPerMeter[i] = wheel.ticksPerMeter;
+    weights[i] = wheel.weight;
+  }
+
+  if (!computeGains(weights, maxWheelCount, gains)) {
+    std::string msg =
+      "TrackingWheelOdometry: The tracking wheels can't tell every movement of the robot apart.";
+    LOG_ERROR(msg);
+    throw std::invalid_argument(msg);
+  }
+
+  if (wheelCount > 3) {
+    for (std::size_t i = 0; i < wheelCount; i++) {
+      canDrop[i] = computeGains(weights, i, gainsWithout[i]);
+    }
+  }
+}
+
+std::uint32_t TrackingWheelOdometry::getOutlierCount() const {
+  return outlierCount.load(std::memory_order_relaxed);
+}
+
+bool TrackingWheelOdometry::computeGains(const std::array<double, maxWheelCount> &iweights,
+                                         const std::size_t iskip,
+                                         Gains &ogains) const {
+  // The normal matrix of the weighted least squares problem
+  std::array<std::array<double, 3>, 3> normal{};
+  for (std::size_t i = 0; i < wheelCount; i++) {
+    if (i == iskip) {
+      continue;
+    }
+
+    for (std::size_t row = 0; row < 3; row++) {
+      for (std::size_t col = 0; col < 3; col++) {
+        normal[row][col] += iweights[i] * geometry[i][row] * geometry[i][col];
+      }
+    }
+  }
+
+  const auto &n = normal;
+  const std::array<std::array<double, 3>, 3> adjugate{
+    {{n[1][1] * n[2][2] - n[1][2] * n[2][1],
+      n[0][2] * n[2][1] - n[0][1] * n[2][2],
+      n[0][1] * n[1][2] - n[0][2] * n[1][1]},
+     {n[1][2] * n[2][0] - n[1][0] * n[2][2],
+      n[0][0] * n[2][2] - n[0][2] * n[2][0],
+      n[0][2] * n[1][0] - n[0][0] * n[1][2]},
+     {n[1][0] * n[2][1] - n[1][1] * n[2][0],
+      n[0][1] * n[2][0] - n[0][0] * n[2][1],
+      n[0][0] * n[1][1] - n[0][1] * n[1][0]}}};
+  const double determinant =
+    n[0][0] * adjugate[0][0] + n[0][1] * adjugate[1][0] + n[0][2] * adjugate[2][0];
+
+  // Compare against the diagonal so the check doesn't depend on the size of the robot
+  if (std::abs(determinant) <= 1e-9 * std::abs(n[0][0] * n[1][1] * n[2][2])) {
+    return false;
+  }
+
+  ogains = {};
+  for (std::size_t i = 0; i < wheelCount; i++) {
+    if (i == iskip) {
+      continue;
+    }
+
+    for (std::size_t row = 0; row < 3; row++) {
+      double sum = 0;
+      for (std::size_t col = 0; col < 3; col++) {
+        sum += adjugate[row][col] * geometry[i][col];
+      }
+      ogains[i][row] = iweights[i] * sum / determinant;
+    }
+  }
+
+  return true;
+}
+
+OdomState TrackingWheelOdometry::odomMathStep(const std::valarray<std::int32_t> &itickDiff,
+                                              const QTime &) {
+  if (itickDiff.size() < wheelCount) {
+    LOG_ERROR_S("TrackingWheelOdometry: itickDiff did not have a reading for every wheel.");
+    return OdomState{};
+  }
+
+  std::array<double, maxWheelCount> distances{};
+  for (std::size_t i = 0; i < wheelCount; i++) {
+    if (std::abs(itickDiff[i]) > maximumTickDiff) {
+      rejectStep(logger,
+                 "TrackingWheelOdometry",
+                 itickDiff[i],
+                 "A tick diff (" + std::to_string(itickDiff[i]) +
+                   ") was greater than the maximum allowable diff (" +
+                   std::to_string(maximumTickDiff) + "). Skipping this odometry step.");
+      return OdomState{};
+    }
+
+    distances[i] = itickDiff[i] / ticksPerMeter[i];
+  }
+
+  const auto solve = [&](const Gains &igains) {
+    std::array<double, 3> movement{};
+    for (std::size_t i = 0; i < wheelCount; i++) {
+      for (std::size_t row = 0; row < 3; row++) {
+        movement[row] += igains[i][row] * distances[i];
+      }
+    }
+    return movement;
+  };
+
+  std::array<double, 3> movement = solve(gains);
+
+  if (wheelCount > 3) {
+    double largestResidual = 0;
+    for (std::size_t i = 0; i < wheelCount; i++) {
+      const double expected = geometry[i][0] * movement[0] + geometry[i][1] * movement[1] +
+                              geometry[i][2] * movement[2];
+      largestResidual = std::max(largestResidual, std::abs(distances[i] - expected));
+    }
+
+    if (largestResidual > outlierThreshold) {
+      // Four wheels can tell that one is wrong but not which one, so drop the wheel whose absence
+      // leaves the movement closest to the last step's, since the robot can't change speed much
+      // in one step. The difference is measured as distances rolled by the wheels.
+      double bestChange = INFINITY;
+      std::array<double, 3> best = movement;
+      for (std::size_t skip = 0; skip < wheelCount; skip++) {
+        if (!canDrop[skip]) {
+          continue;
+        }
+
+        const std::array<double, 3> candidate = solve(gainsWithout[skip]);
+        double change = 0;
+        for (std::size_t i = 0; i < wheelCount; i++) {
+          const double difference = geometry[i][0] * (candidate[0] - lastMovement[0]) +
+                                    geometry[i][1] * (candidate[1] - lastMovement[1]) +
+                                    geometry[i][2] * (candidate[2] - lastMovement[2]);
+          change += difference * difference;
+        }
+
+        if (change < bestChange) {
+          bestChange = change;
+          best = candidate;
+        }
+      }
+
+      if (bestChange != INFINITY) {
+        movement = best;
+        outlierCount.fetch_add(1, std::memory_order_relaxed);
+      }
+    }
+  }
+
+  lastMovement = movement;
+  return OdomMath::integrateExponentialMap(
+    movement[0] * meter, movement[1] * meter, movement[2] * radian, state.theta);
+}
+} // namespace okapi
@@ -4,9 +4,13 @@
  * file, You can obtain one at http://mozilla.org/MPL/2.0/.
  */
 #include "okapi/api/odometry/twoEncoderOdometry.hpp"
+#include "okapi/api/odometry/odomMath.hpp"
 #include "okapi/api/units/QAngularSpeed.hpp"
+#include "okapi/api/util/fastTrig.hpp"
 #include "okapi/api/util/mathUtil.hpp"
+#include <algorithm>
 #include <cmath>
+#include <vector>
 
 namespace okapi {
 TwoEncoderOdometry::TwoEncoderOdometry(const TimeUtil &itimeUtil,
@@ -22,22 +26,85 @@ TwoEncoderOdometry::TwoEncoderOdometry(const TimeUtil &itimeUtil,
 
 void TwoEncoderOdometry::setScales(const ChassisScales &ichassisScales) {
   chassisScales = ichassisScales;
+  // Stepping only uses the derived scales, so keep them current even if a scale was changed by hand
+  chassisScales.computeDerivedScales();
+}
+
+void TwoEncoderOdometry::setIntegration(const OdomIntegration &iintegration) {
+  integration = iintegration;
+}
+
+OdomIntegration TwoEncoderOdometry::getIntegration() const {
+  return integration;
 }
 
 void TwoEncoderOdometry::step() {
+  sharedState.take(state);
   const auto deltaT = timer->getDt();
 
   if (deltaT.getValue() != 0) {
-    newTicks = model->getSensorVals();
-    tickDiff = newTicks - lastTicks;
+    const std::size_t sensorCount = model->getSensorSamples(newTicks, newTimestamps);
+    if (tickDiff.size() != sensorCount) {
+      // Only happens on the first step
+      tickDiff.resize(sensorCount);
+    }
+
+    if (sensorTelemetry) {
+      std::array<double, ReadOnlyChassisModel::maxSensorCount> values{};
+      std::copy(newTicks.begin(), newTicks.end(), values.begin());
+      sensorTelemetry->record(sensorChannel, values.data(), sensorChannelFieldCount);
+    }
+
+    // Prefer the time between the sensor measurements over the time between steps
+    const QTime sampleDeltaT = correctSensorSkew(sensorCount);
+
+    for (std::size_t i = 0; i < sensorCount; i++) {
+      tickDiff[i] = newTicks[i] - lastTicks[i];
+    }
     lastTicks = newTicks;
 
-    const auto newState = odomMathStep(tickDiff, deltaT);
+    const auto newState =
+      odomMathStep(tickDiff, sampleDeltaT.getValue() > 0 ? sampleDeltaT : deltaT);
 
     state.x += newState.x;
     state.y += newState.y;
     state.theta += newState.theta;
+
+    // The pose is from when the sensors were measured, if they say when that was
+    history.record(lastSampleTime != 0 ? lastSampleTime * millisecond : timer->millis(), state);
+  }
+
+  sharedState.publish(state);
+}
+
+QTime TwoEncoderOdometry::correctSensorSkew(const std::size_t isensorCount) {
+  std::uint32_t sampleTime = 0;
+  for (std::size_t i = 0; i < isensorCount; i++) {
+    if (newTimestamps[i] == 0) {
+      // This sensor doesn't report when it was measured, so there is nothing to correct
+      lastSampleTime = 0;
+      return 0_ms;
+    }
+    sampleTime = std::max(sampleTime, newTimestamps[i]);
+  }
+
+  const bool hasLastSample = lastSampleTime != 0;
+  for (std::size_t i = 0; i < isensorCount; i++) {
+    const std::int32_t rawTicks = newTicks[i];
+    if (hasLastSample && newTimestamps[i] != lastTimestamps[i]) {
+      tickVelocities[i] = static_cast<double>(rawTicks - lastRawTicks[i]) /
+                          static_cast<double>(newTimestamps[i] - lastTimestamps[i]);
+    }
+
+    const double skew = static_cast<double>(sampleTime - newTimestamps[i]);
+    newTicks[i] = rawTicks + static_cast<std::int32_t>(std::lround(tickVelocities[i] * skew));
+    lastRawTicks[i] = rawTicks;
   }
+
+  lastTimestamps = newTimestamps;
+  const std::uint32_t sampleDeltaT = hasLastSample ? sampleTime - lastSampleTime : 0;
+  lastSampleTime = sampleTime;
+  return sampleDeltaT * millisecond;
 }
 
 OdomState TwoEncoderOdometry::odomMathStep(const std::valarray<std::int32_t> &itickDiff,
@@ -49,22 +116,36 @@ OdomState TwoEncoderOdometry::odomMathStep(const std::valarray<std::int32_t> &it
 
   for (auto &&elem : itickDiff) {
     if (std::abs(elem) > maximumTickDiff) {
-      LOG_ERROR("TwoEncoderOdometry: A tick diff (" + std::to_string(elem) +
-                ") was greater than the maximum allowable diff (" +
-                std::to_string(maximumTickDiff) + "). Skipping this odometry step.");
+      rejectStep(logger,
+                 "TwoEncoderOdometry",
+                 elem,
+                 "A tick diff (" + std::to_string(elem) +
+                   ") was greater than the maximum allowable diff (" +
+                   std::to_string(maximumTickDiff) + "). Skipping this odometry step.");
       return OdomState{};
     }
   }
 
-  const double deltaL = itickDiff[0] / chassisScales.straight;
-  const double deltaR = itickDiff[1] / chassisScales.straight;
+  const double deltaL = itickDiff[0] * chassisScales.metersPerTick;
+  const double deltaR = itickDiff[1] * chassisScales.metersPerTick;
+
+  double deltaTheta = (deltaL - deltaR) * chassisScales.inverseWheelTrack;
+
+  if (integration == OdomIntegration::EXPONENTIAL_MAP) {
+    // The middle of the robot moves forward by the average of the wheels, and to the side by
+    // its turn around the tracking center
+    return OdomMath::integrateExponentialMap(
+      (deltaL + deltaR) / 2 * meter,
+      deltaTheta * chassisScales.middleWheelDistance,
+      deltaTheta * radian,
+      state.theta);
+  }
 
-  double deltaTheta = (deltaL - deltaR) / chassisScales.wheelTrack.convert(meter);
   double localOffX, localOffY;
 
   if (deltaTheta != 0) {
-    localOffX = 2 * std::sin(deltaTheta / 2) * chassisScales.middleWheelDistance.convert(meter);
-    localOffY = 2 * std::sin(deltaTheta / 2) *
+    localOffX = 2 * Trig::sin(deltaTheta / 2) * chassisScales.middleWheelDistance.convert(meter);
+    localOffY = 2 * Trig::sin(deltaTheta / 2) *
                 (deltaR / deltaTheta + chassisScales.wheelTrack.convert(meter) / 2);
   } else {
     localOffX = 0;
@@ -74,10 +155,10 @@ OdomState TwoEncoderOdometry::odomMathStep(const std::valarray<std::int32_t> &it
   double avgA = state.theta.convert(radian) + (deltaTheta / 2);
 
   double polarR = std::sqrt(localOffX * localOffX + localOffY * localOffY);
-  double polarA = std::atan2(localOffY, localOffX) - avgA;
+  double polarA = Trig::atan2(localOffY, localOffX) - avgA;
 
-  double dX = std::sin(polarA) * polarR;
-  double dY = std::cos(polarA) * polarR;
+  double dX = Trig::sin(polarA) * polarR;
+  double dY = Trig::cos(polarA) * polarR;
 
   if (isnan(dX)) {
     dX = 0;
@@ -95,22 +176,45 @@ OdomState TwoEncoderOdometry::odomMathStep(const std::valarray<std::int32_t> &it
 }
 
 OdomState TwoEncoderOdometry::getState(const StateMode &imode) const {
+  const OdomState current = sharedState.get();
   if (imode == StateMode::FRAME_TRANSFORMATION) {
-    return state;
+    return current;
   } else {
-    return OdomState{state.y, state.x, state.theta};
+    return OdomState{current.y, current.x, current.theta};
   }
 }
 
 void TwoEncoderOdometry::setState(const OdomState &istate, const StateMode &imode) {
   LOG_DEBUG("State set to: " + istate.str());
   if (imode == StateMode::FRAME_TRANSFORMATION) {
-    state = istate;
+    sharedState.set(istate);
   } else {
-    state = OdomState{istate.y, istate.x, istate.theta};
+    sharedState.set(OdomState{istate.y, istate.x, istate.theta});
   }
 }
 
+void TwoEncoderOdometry::addTelemetry(const std::shared_ptr<TelemetryStream> &istream,
+                                      const std::string &iname) {
+  telemetry.add(istream, iname + ".x", [this]() { return sharedState.get().x.convert(meter); });
+  telemetry.add(istream, iname + ".y", [this]() { return sharedState.get().y.convert(meter); });
+  telemetry.add(
+    istream, iname + ".theta", [this]() { return sharedState.get().theta.convert(degree); });
+}
+
+void TwoEncoderOdometry::recordSensors(const std::shared_ptr<TelemetryLogger> &itelemetry,
+                                       const std::string &ichannelName) {
+  const std::size_t sensorCount =
+    std::min(model->getSensorVals().size(), ReadOnlyChassisModel::maxSensorCount);
+  std::vector<std::string> fieldNames;
+  for (std::size_t i = 0; i < sensorCount; i++) {
+    fieldNames.push_back("sensor" + std::to_string(i));
+  }
+
+  sensorChannel = itelemetry->addChannel(ichannelName, fieldNames);
+  sensorChannelFieldCount = sensorCount;
+  sensorTelemetry = itelemetry;
+}
+
 std::shared_ptr<ReadOnlyChassisModel> TwoEncoderOdometry::getModel() {
   return model;
 }
@@ -0,0 +1,155 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#include "okapi/api/odometry/wallCorrectedOdometry.hpp"
+#include <cmath>
+#include <stdexcept>
+
+namespace okapi {
+WallCorrectedOdometry::WallCorrectedOdometry(std::shared_ptr<Odometry> iodometry,
+                                             const FieldMap &imap,
+                                             const double igain,
+                                             const QLength &imaxError,
+                                             const QAngle &imaxIncidence,
+                                             const std::shared_ptr<Logger> &ilogger)
+  : logger(ilogger),
+    odometry(std::move(iodometry)),
+    map(imap),
+    gain(igain),
+    maxError(imaxError),
+    maxIncidence(imaxIncidence) {
+  if (odometry == nullptr) {
+    std::string msg = "WallCorrectedOdometry: The odometry cannot be null.";
+    LOG_ERROR(msg);
+    throw std::invalid_argument(msg);
+  }
+
+  if (!(gain >= 0 && gain <= 1)) {
+    std::string msg = "WallCorrectedOdometry: The gain must be between 0 and 1.";
+    LOG_ERROR(msg);
+    throw std::invalid_argument(msg);
+  }
+}
+
+void WallCorrectedOdometry::addDistanceSensor(std::shared_ptr<ControllerInput<double>> isensor,
+                                              const OdomState &imount,
+                                              const QLength &imaxRange) {
+  if (isensor == nullptr) {
+    std::string msg = "WallCorrectedOdometry: The distance sensor cannot be null.";
+    LOG_ERROR(msg);
+    throw std::invalid_argument(msg);
+  }
+
+  distanceSensors.push_back({std::move(isensor),
+                             imount.x.convert(meter),
+                             imount.y.convert(meter),
+                             imount.theta.convert(radian),
+                             imaxRange});
+}
+
+void WallCorrectedOdometry::setScales(const ChassisScales &ichassisScales) {
+  odometry->setScales(ichassisScales);
+}
+
+void WallCorrectedOdometry::step() {
+  sharedState.take(state);
+  const OdomState encoderBefore = odometry->getState();
+  odometry->step();
+  const OdomState encoderAfter = odometry->getState();
+
+  // This state drifts apart from the encoder odometry once it is set, so move it by the change in
+  // the encoder odometry rotated onto this heading
+  const QAngle theta = state.theta + (encoderAfter.theta - encoderBefore.theta);
+  const double rotation = ((state.theta + theta - encoderBefore.theta - encoderAfter.theta) / 2.0)
+                            .convert(radian);
+  const double cosRotation = std::cos(rotation);
+  const double sinRotation = std::sin(rotation);
+  const double dX = (encoderAfter.x - encoderBefore.x).convert(meter);
+  const double dY = (encoderAfter.y - encoderBefore.y).convert(meter);
+
+  state.x += (dX * cosRotation - dY * sinRotation) * meter;
+  state.y += (dY * cosRotation + dX * sinRotation) * meter;
+  state.theta = theta;
+
+  for (const auto &mount : distanceSensors) {
+    correct(mount);
+  }
+
+  // This pose is from the time the encoder odometry's pose is from
+  QTime time;
+  OdomState encoderState;
+  if (odometry->getHistory().getLatest(time, encoderState)) {
+    history.record(time, state);
+  }
+
+  sharedState.publish(state);
+}
+
+void WallCorrectedOdometry::correct(const DistanceSensorMount &imount) {
+  const QLength reading = imount.sensor->controllerGet() * millimeter;
+  if (!std::isfinite(reading.getValue()) || reading <= 0_m || reading > imount.maxRange) {
+    return;
+  }
+
+  const double theta = state.theta.convert(radian);
+  const double cosTheta = std::cos(theta);
+  const double sinTheta = std::sin(theta);
+  const Point sensor{state.x + (imount.forward * cosTheta - imount.right * sinTheta) * meter,
+                     state.y + (imount.forward * sinTheta + imount.right * cosTheta) * meter};
+  const double beamAngle = theta + imount.angle;
+
+  RaycastHit hit;
+  if (!map.raycast(sensor, beamAngle * radian, hit) || hit.incidence > maxIncidence) {
+    return;
+  }
+
+  const QLength error = hit.distance - reading;
+  if (abs(error) > maxError) {
+    // The sensor probably sees something other than the wall
+    return;
+  }
+
+  // The robot is closer to the wall than expected if the error is positive. Along the normal of
+  // the wall, the robot is off by the error times the cosine of the incidence.
+  const QLength offset = -gain * error * std::cos(hit.incidence.convert(radian));
+  state.x += offset * hit.normalX;
+  state.y += offset * hit.normalY;
+  correctionCount.fetch_add(1, std::memory_order_relaxed);
+}
+
+OdomState WallCorrectedOdometry::getState(const StateMode &imode) const {
+  const OdomState current = sharedState.get();
+  if (imode == StateMode::FRAME_TRANSFORMATION) {
+    return current;
+  } else {
+    return OdomState{current.y, current.x, current.theta};
+  }
+}
+
+void WallCorrectedOdometry::setState(const OdomState &istate, const StateMode &imode) {
+  LOG_DEBUG("State set to: " + istate.str());
+  if (imode == StateMode::FRAME_TRANSFORMATION) {
+    sharedState.set(istate);
+  } else {
+    sharedState.set(OdomState{istate.y, istate.x, istate.theta});
+  }
+}
+
+std::shared_ptr<ReadOnlyChassisModel> WallCorrectedOdometry::getModel() {
+  return odometry->getModel();
+}
+
+ChassisScales WallCorrectedOdometry::getScales() {
+  return odometry->getScales();
+}
+
+std::shared_ptr<Odometry> WallCorrectedOdometry::getEncoderOdometry() const {
+  return odometry;
+}
+
+std::uint32_t WallCorrectedOdometry::getCorrectionCount() const {
+  return correctionCount.load(std::memory_order_relaxed);
+}
+} // namespace okapi
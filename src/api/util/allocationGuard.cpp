@@ -0,0 +1,101 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#include "okapi/api/util/allocationGuard.hpp"
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+namespace okapi {
+namespace {
+// Allocations can happen before any constructor runs, so all of these are constant-initialized
+std::atomic_bool sealed{false};
+std::atomic<AllocationGuard::ViolationHandler> handler{nullptr};
+std::atomic_size_t allocationCount{0};
+std::atomic_size_t violationCount{0};
+// Set while a handler runs, so allocations it makes don't call it again
+std::atomic_flag inHandler = ATOMIC_FLAG_INIT;
+} // namespace
+
+void AllocationGuard::seal(const ViolationHandler ihandler) {
+  handler.store(ihandler, std::memory_order_release);
+  sealed.store(true, std::memory_order_release);
+}
+
+void AllocationGuard::unseal() {
+  sealed.store(false, std::memory_order_release);
+}
+
+bool AllocationGuard::isSealed() {
+  return sealed.load(std::memory_order_acquire);
+}
+
+std::size_t AllocationGuard::getAllocationCount() {
+  return allocationCount.load(std::memory_order_relaxed);
+}
+
+std::size_t AllocationGuard::getViolationCount() {
+  return violationCount.load(std::memory_order_relaxed);
+}
+
+void AllocationGuard::recordAllocation(const std::size_t isize) {
+  allocationCount.fetch_add(1, std::memory_order_relaxed);
+  if (!sealed.load(std::memory_order_acquire)) {
+    return;
+  }
+
+  violationCount.fetch_add(1, std::memory_order_relaxed);
+  if (const auto violationHandler = handler.load(std::memory_order_acquire);
+      violationHandler != nullptr && !inHandler.test_and_set(std::memory_order_acquire)) {
+    violationHandler(isize);
+    inHandler.clear(std::memory_order_release);
+  }
+}
+
+void AllocationGuard::abortOnViolation(std::size_t) {
+  std::abort();
+}
+} // namespace okapi
+
+#ifdef OKAPI_ALLOCATION_GUARD
+// Replacing these in the same translation unit as seal() makes sure they are linked in whenever
+// the guard is used. The aligned overloads are left to the standard library.
+void *operator new(const std::size_t isize) {
+  okapi::AllocationGuard::recordAllocation(isize);
+  if (void *ptr = std::malloc(isize == 0 ? 1 : isize)) {
+    return ptr;
+  }
+  throw std::bad_alloc();
+}
+
+void *operator new[](const std::size_t isize) {
+  return operator new(isize);
+}
+
+void *operator new(const std::size_t isize, const std::nothrow_t &) noexcept {
+  okapi::AllocationGuard::recordAllocation(isize);
+  return std::malloc(isize == 0 ? 1 : isize);
+}
+
+void *operator new[](const std::size_t isize, const std::nothrow_t &itag) noexcept {
+  return operator new(isize, itag);
+}
+
+void operator delete(void *ptr) noexcept {
+  std::free(ptr);
+}
+
+void operator delete[](void *ptr) noexcept {
+  std::free(ptr);
+}
+
+void operator delete(void *ptr, std::size_t) noexcept {
+  std::free(ptr);
+}
+
+void operator delete[](void *ptr, std::size_t) noexcept {
+  std::free(ptr);
+}
+#endif
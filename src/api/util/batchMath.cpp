@@ -0,0 +1,199 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#include "okapi/api/util/batchMath.hpp"
+#include <algorithm>
+#include <cmath>
+
+#if defined(__ARM_NEON) || defined(__ARM_NEON__)
+#include <arm_neon.h>
+#define OKAPI_BATCH_MATH_NEON
+#endif
+
+namespace okapi {
+namespace {
+/**
+ * The number of channels the NEON loops handle, a multiple of four. The scalar loops do the rest,
+ * or every channel when NEON is not available.
+ */
+std::size_t vectorChannels(const std::size_t icount) {
+#ifdef OKAPI_BATCH_MATH_NEON
+  return icount & ~static_cast<std::size_t>(3);
+#else
+  static_cast<void>(icount);
+  return 0;
+#endif
+}
+
+/**
+ * The Taylor series of the half turn of one step of integratePoses(). The NEON loop expands the
+ * same series four lanes at a time.
+ */
+struct HalfTurn {
+  float cosHalf;
+  float sinHalf;
+  float chordScale; // sin(half) / half
+};
+
+HalfTurn expandHalfTurn(const float ideltaTheta) {
+  const float half = ideltaTheta * 0.5f;
+  const float halfSquared = half * half;
+  HalfTurn out;
+  out.chordScale = 1 - halfSquared * (1 / 6.0f) + halfSquared * halfSquared * (1 / 120.0f);
+  out.cosHalf = 1 - halfSquared * 0.5f + halfSquared * halfSquared * (1 / 24.0f);
+  out.sinHalf = half * out.chordScale;
+  return out;
+}
+} // namespace
+
+void BatchMath::emaStep(float *ioutput,
+                        const float *iinput,
+                        const float ialpha,
+                        const std::size_t icount) {
+  std::size_t i = 0;
+#ifdef OKAPI_BATCH_MATH_NEON
+  const float32x4_t alpha = vdupq_n_f32(ialpha);
+  const float32x4_t keep = vdupq_n_f32(1 - ialpha);
+  for (const std::size_t end = vectorChannels(icount); i < end; i += 4) {
+    const float32x4_t kept = vmulq_f32(keep, vld1q_f32(ioutput + i));
+    vst1q_f32(ioutput + i, vmlaq_f32(kept, alpha, vld1q_f32(iinput + i)));
+  }
+#endif
+
+  for (; i < icount; i++) {
+    ioutput[i] = ialpha * iinput[i] + (1 - ialpha) * ioutput[i];
+  }
+}
+
+void BatchMath::movingAverageStep(float *iosum,
+                                  const float *inewest,
+                                  const float *ioldest,
+                                  float *ooutput,
+                                  const std::size_t ilength,
+                                  const std::size_t icount) {
+  const float inverseLength = 1.0f / static_cast<float>(ilength);
+
+  std::size_t i = 0;
+#ifdef OKAPI_BATCH_MATH_NEON
+  const float32x4_t scale = vdupq_n_f32(inverseLength);
+  for (const std::size_t end = vectorChannels(icount); i < end; i += 4) {
+    const float32x4_t change = vsubq_f32(vld1q_f32(inewest + i), vld1q_f32(ioldest + i));
+    const float32x4_t sum = vaddq_f32(vld1q_f32(iosum + i), change);
+    vst1q_f32(iosum + i, sum);
+    vst1q_f32(ooutput + i, vmulq_f32(sum, scale));
+  }
+#endif
+
+  for (; i < icount; i++) {
+    iosum[i] += inewest[i] - ioldest[i];
+    ooutput[i] = iosum[i] * inverseLength;
+  }
+}
+
+void BatchMath::mixXDrive(const float *ixSpeed,
+                          const float *iforwardSpeed,
+                          const float *iyaw,
+                          float *otopLeft,
+                          float *otopRight,
+                          float *obottomRight,
+                          float *obottomLeft,
+                          const std::size_t icount) {
+  std::size_t i = 0;
+#ifdef OKAPI_BATCH_MATH_NEON
+  const float32x4_t upper = vdupq_n_f32(1);
+  const float32x4_t lower = vdupq_n_f32(-1);
+  const auto clamp = [&](const float32x4_t ivalue) {
+    return vminq_f32(vmaxq_f32(ivalue, lower), upper);
+  };
+  for (const std::size_t end = vectorChannels(icount); i < end; i += 4) {
+    const float32x4_t x = vld1q_f32(ixSpeed + i);
+    const float32x4_t forward = vld1q_f32(iforwardSpeed + i);
+    const float32x4_t yaw = vld1q_f32(iyaw + i);
+    const float32x4_t forwardPlusX = vaddq_f32(forward, x);
+    const float32x4_t forwardMinusX = vsubq_f32(forward, x);
+    vst1q_f32(otopLeft + i, clamp(vaddq_f32(forwardPlusX, yaw)));
+    vst1q_f32(otopRight + i, clamp(vsubq_f32(forwardMinusX, yaw)));
+    vst1q_f32(obottomRight + i, clamp(vsubq_f32(forwardPlusX, yaw)));
+    vst1q_f32(obottomLeft + i, clamp(vaddq_f32(forwardMinusX, yaw)));
+  }
+#endif
+
+  for (; i < icount; i++) {
+    const float x = ixSpeed[i];
+    const float forward = iforwardSpeed[i];
+    const float yaw = iyaw[i];
+    otopLeft[i] = std::clamp(forward + x + yaw, -1.0f, 1.0f);
+    otopRight[i] = std::clamp(forward - x - yaw, -1.0f, 1.0f);
+    obottomRight[i] = std::clamp(forward + x - yaw, -1.0f, 1.0f);
+    obottomLeft[i] = std::clamp(forward - x + yaw, -1.0f, 1.0f);
+  }
+}
+
+void BatchMath::integratePoses(float *iox,
+                               float *ioy,
+                               float *iocosTheta,
+                               float *iosinTheta,
+                               const float *iforward,
+                               const float *iright,
+                               const float *ideltaTheta,
+                               const std::size_t icount) {
+  std::size_t i = 0;
+#ifdef OKAPI_BATCH_MATH_NEON
+  const float32x4_t one = vdupq_n_f32(1);
+  for (const std::size_t end = vectorChannels(icount); i < end; i += 4) {
+    const float32x4_t half = vmulq_n_f32(vld1q_f32(ideltaTheta + i), 0.5f);
+    const float32x4_t halfSquared = vmulq_f32(half, half);
+    const float32x4_t halfFourth = vmulq_f32(halfSquared, halfSquared);
+    const float32x4_t chordScale =
+      vmlaq_n_f32(vmlsq_n_f32(one, halfSquared, 1 / 6.0f), halfFourth, 1 / 120.0f);
+    const float32x4_t cosHalf =
+      vmlaq_n_f32(vmlsq_n_f32(one, halfSquared, 0.5f), halfFourth, 1 / 24.0f);
+    const float32x4_t sinHalf = vmulq_f32(half, chordScale);
+
+    // The chord of the arc points along the heading halfway through the turn
+    const float32x4_t cosTheta = vld1q_f32(iocosTheta + i);
+    const float32x4_t sinTheta = vld1q_f32(iosinTheta + i);
+    const float32x4_t cosChord = vmlsq_f32(vmulq_f32(cosTheta, cosHalf), sinTheta, sinHalf);
+    const float32x4_t sinChord = vmlaq_f32(vmulq_f32(sinTheta, cosHalf), cosTheta, sinHalf);
+
+    const float32x4_t forward = vmulq_f32(vld1q_f32(iforward + i), chordScale);
+    const float32x4_t right = vmulq_f32(vld1q_f32(iright + i), chordScale);
+    const float32x4_t dx = vmlsq_f32(vmulq_f32(forward, cosChord), right, sinChord);
+    const float32x4_t dy = vmlaq_f32(vmulq_f32(forward, sinChord), right, cosChord);
+    vst1q_f32(iox + i, vaddq_f32(vld1q_f32(iox + i), dx));
+    vst1q_f32(ioy + i, vaddq_f32(vld1q_f32(ioy + i), dy));
+
+    // Turn the rest of the way, then normalize with a refined reciprocal square root
+    const float32x4_t cosAfter = vmlsq_f32(vmulq_f32(cosChord, cosHalf), sinChord, sinHalf);
+    const float32x4_t sinAfter = vmlaq_f32(vmulq_f32(sinChord, cosHalf), cosChord, sinHalf);
+    const float32x4_t norm = vmlaq_f32(vmulq_f32(cosAfter, cosAfter), sinAfter, sinAfter);
+    float32x4_t inverse = vrsqrteq_f32(norm);
+    inverse = vmulq_f32(inverse, vrsqrtsq_f32(vmulq_f32(norm, inverse), inverse));
+    inverse = vmulq_f32(inverse, vrsqrtsq_f32(vmulq_f32(norm, inverse), inverse));
+    vst1q_f32(iocosTheta + i, vmulq_f32(cosAfter, inverse));
+    vst1q_f32(iosinTheta + i, vmulq_f32(sinAfter, inverse));
+  }
+#endif
+
+  for (; i < icount; i++) {
+    const HalfTurn turn = expandHalfTurn(ideltaTheta[i]);
+    const float cosTheta = iocosTheta[i];
+    const float sinTheta = iosinTheta[i];
+    const float cosChord = cosTheta * turn.cosHalf - sinTheta * turn.sinHalf;
+    const float sinChord = sinTheta * turn.cosHalf + cosTheta * turn.sinHalf;
+
+    const float forward = iforward[i] * turn.chordScale;
+    const float right = iright[i] * turn.chordScale;
+    iox[i] += forward * cosChord - right * sinChord;
+    ioy[i] += forward * sinChord + right * cosChord;
+
+    const float cosAfter = cosChord * turn.cosHalf - sinChord * turn.sinHalf;
+    const float sinAfter = sinChord * turn.cosHalf + cosChord * turn.sinHalf;
+    const float inverse = 1 / std::sqrt(cosAfter * cosAfter + sinAfter * sinAfter);
+    iocosTheta[i] = cosAfter * inverse;
+    iosinTheta[i] = sinAfter * inverse;
+  }
+}
+} // namespace okapi
@@ -0,0 +1,63 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#include "okapi/api/util/cobs.hpp"
+
+namespace okapi {
+std::size_t
+Cobs::encode(const std::uint8_t *ipacket, const std::size_t ilength, std::uint8_t *oencoded) {
+  // Each block starts with a code byte: the distance to the next zero, or 0xFF for a block of 254
+  // bytes which is not followed by a zero
+  std::size_t out = 1;
+  std::size_t codeIndex = 0;
+  std::uint8_t code = 1;
+
+  for (std::size_t i = 0; i < ilength; i++) {
+    if (ipacket[i] != 0) {
+      oencoded[out++] = ipacket[i];
+      code++;
+    }
+
+    if (ipacket[i] == 0 || code == 0xFF) {
+      oencoded[codeIndex] = code;
+      codeIndex = out++;
+      code = 1;
+    }
+  }
+
+  oencoded[codeIndex] = code;
+  return out;
+}
+
+bool Cobs::decode(const std::uint8_t *iencoded,
+                  const std::size_t ilength,
+                  std::uint8_t *opacket,
+                  std::size_t &opacketLength) {
+  std::size_t out = 0;
+  std::size_t i = 0;
+
+  while (i < ilength) {
+    const std::uint8_t code = iencoded[i++];
+    if (code == 0 || i + code - 1 > ilength) {
+      return false;
+    }
+
+    for (std::uint8_t j = 1; j < code; j++) {
+      if (iencoded[i] == 0) {
+        return false;
+      }
+      opacket[out++] = iencoded[i++];
+    }
+
+    // A block shorter than 254 bytes was followed by a zero, except for the last block
+    if (code != 0xFF && i < ilength) {
+      opacket[out++] = 0;
+    }
+  }
+
+  opacketLength = out;
+  return true;
+}
+} // namespace okapi
@@ -0,0 +1,147 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#include "okapi/api/util/fastTrig.hpp"
+#include <limits>
+
+namespace okapi {
+namespace {
+constexpr double halfPi = 1.57079632679489661923;
+constexpr double quarterPi = 0.78539816339744830962;
+constexpr double twoOverPi = 0.63661977236758134308;
+
+// pi / 2 split in two. The high part has 26 significant bits, so k * halfPiHigh is exact for
+// |k| < 2^27 and k * pi / 2 is subtracted without losing the low bits of the angle
+constexpr double halfPiHigh = 1.570796310901641845703125;
+constexpr double halfPiLow = 1.5893254773528196e-08;
+
+/**
+ * The Taylor series of sin and cos through x^11 and x^12. For |r| <= pi / 4, the first dropped
+ * term bounds the error below 1e-11.
+ */
+double sinPoly(const double r) {
+  const double r2 = r * r;
+  return r *
+         (1 + r2 * (-1.0 / 6 +
+                    r2 * (1.0 / 120 +
+                          r2 * (-1.0 / 5040 +
+                                r2 * (1.0 / 362880 + r2 * (-1.0 / 39916800))))));
+}
+
+double cosPoly(const double r) {
+  const double r2 = r * r;
+  return 1 + r2 * (-1.0 / 2 +
+                   r2 * (1.0 / 24 +
+                         r2 * (-1.0 / 720 +
+                               r2 * (1.0 / 40320 +
+                                     r2 * (-1.0 / 3628800 + r2 * (1.0 / 479001600))))));
+}
+
+/**
+ * Reduces an angle to `oreduced` in `[-pi / 4, pi / 4]` and its quarter turn `k`, so
+ * `x = oreduced + k * pi / 2`.
+ *
+ * @return The quarter turn, modulo 4.
+ */
+int reduce(const double x, double &oreduced) {
+  const double k = std::nearbyint(x * twoOverPi);
+  oreduced = (x - k * halfPiHigh) - k * halfPiLow;
+  return static_cast<int>(static_cast<long long>(k) & 3);
+}
+
+/**
+ * The arctangent for `t` in `[0, 1]`. Above tan(pi / 8), the identity
+ * atan(t) = pi / 4 + atan((t - 1) / (t + 1)) keeps the series argument below 0.415, where the
+ * series through u^21 bounds the error below 1e-10.
+ */
+double atanUnit(const double t) {
+  constexpr double tanEighthPi = 0.41421356237309504880;
+  double offset = 0;
+  double u = t;
+  if (t > tanEighthPi) {
+    offset = quarterPi;
+    u = (t - 1) / (t + 1);
+  }
+
+  const double u2 = u * u;
+  double sum = 1.0 / 21;
+  sum = -1.0 / 19 + u2 * sum;
+  sum = 1.0 / 17 + u2 * sum;
+  sum = -1.0 / 15 + u2 * sum;
+  sum = 1.0 / 13 + u2 * sum;
+  sum = -1.0 / 11 + u2 * sum;
+  sum = 1.0 / 9 + u2 * sum;
+  sum = -1.0 / 7 + u2 * sum;
+  sum = 1.0 / 5 + u2 * sum;
+  sum = -1.0 / 3 + u2 * sum;
+  sum = 1.0 + u2 * sum;
+
+  return offset + u * sum;
+}
+} // namespace
+
+double FastTrig::sin(const double x) {
+  double s, c;
+  sincos(x, s, c);
+  return s;
+}
+
+double FastTrig::cos(const double x) {
+  double s, c;
+  sincos(x, s, c);
+  return c;
+}
+
+void FastTrig::sincos(const double x, double &osin, double &ocos) {
+  if (!std::isfinite(x)) {
+    osin = ocos = std::numeric_limits<double>::quiet_NaN();
+    return;
+  }
+
+  double r;
+  const int quadrant = reduce(x, r);
+  const double s = sinPoly(r);
+  const double c = cosPoly(r);
+  switch (quadrant) {
+  case 0:
+    osin = s;
+    ocos = c;
+    break;
+  case 1:
+    osin = c;
+    ocos = -s;
+    break;
+  case 2:
+    osin = -s;
+    ocos = -c;
+    break;
+  default:
+    osin = -c;
+    ocos = s;
+    break;
+  }
+}
+
+double FastTrig::atan2(const double y, const double x) {
+  if (std::isnan(x) || std::isnan(y)) {
+    return std::numeric_limits<double>::quiet_NaN();
+  }
+
+  const double ax = std::abs(x);
+  const double ay = std::abs(y);
+  if (ax == 0 && ay == 0) {
+    // Like std::atan2, (+-0, +0) is +-0 and (+-0, -0) is +-pi
+    return std::signbit(x) ? std::copysign(2 * halfPi, y) : y;
+  }
+
+  // Work in the octant where the ratio is at most 1, then unfold
+  double angle = ay <= ax ? atanUnit(ay / ax) : halfPi - atanUnit(ax / ay);
+  if (x < 0 || (x == 0 && std::signbit(x))) {
+    angle = 2 * halfPi - angle;
+  }
+
+  return std::copysign(angle, y);
+}
+} // namespace okapi
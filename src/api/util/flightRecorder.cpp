@@ -0,0 +1,165 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#include "okapi/api/util/flightRecorder.hpp"
+#include <algorithm>
+#include <atomic>
+#include <fstream>
+#include <mutex>
+#include <utility>
+
+namespace okapi {
+namespace {
+// Function statics so recording from a static initializer can not see them unconstructed
+CrossplatformMutex &defaultMutex() {
+  static CrossplatformMutex mutex;
+  return mutex;
+}
+
+std::shared_ptr<FlightRecorder> &defaultRecorder() {
+  static std::shared_ptr<FlightRecorder> recorder;
+  return recorder;
+}
+
+std::atomic_bool hasDefault{false};
+} // namespace
+
+const char *toString(const FlightEventType itype) {
+  switch (itype) {
+  case FlightEventType::targetChanged:
+    return "targetChanged";
+  case FlightEventType::settled:
+    return "settled";
+  case FlightEventType::motorFault:
+    return "motorFault";
+  case FlightEventType::odometryRejected:
+    return "odometryRejected";
+  case FlightEventType::loopOverrun:
+    return "loopOverrun";
+  case FlightEventType::wheelSlip:
+    return "wheelSlip";
+  case FlightEventType::user:
+    return "user";
+  }
+  return "unknown";
+}
+
+FlightRecorder::FlightRecorder(std::unique_ptr<AbstractTimer> itimer,
+                               const std::size_t icapacity,
+                               std::string ifileName,
+                               const std::shared_ptr<Logger> &ilogger)
+  : logger(ilogger),
+    timer(std::move(itimer)),
+    fileName(std::move(ifileName)),
+    events(std::max<std::size_t>(icapacity, 1)) {
+}
+
+void FlightRecorder::record(const FlightEventType itype,
+                            const char *isource,
+                            const std::int32_t icode,
+                            const double ivalue) {
+  const auto time = static_cast<std::uint32_t>(timer->getDtFromStart().convert(millisecond));
+
+  bool shouldFlush;
+  QTime window;
+  {
+    std::scoped_lock lock(mutex);
+    events[next] = FlightEvent{time, itype, isource, icode, ivalue};
+    next = (next + 1) % events.size();
+    recordedCount++;
+    shouldFlush = flushOnFault && itype == FlightEventType::motorFault;
+    window = faultWindow;
+  }
+
+  if (shouldFlush) {
+    flush(window);
+  }
+}
+
+std::vector<FlightEvent> FlightRecorder::getEvents(const QTime iwindow) const {
+  const double since =
+    timer->getDtFromStart().convert(millisecond) - iwindow.convert(millisecond);
+
+  std::scoped_lock lock(mutex);
+  const std::size_t count = std::min<std::size_t>(recordedCount, events.size());
+  std::vector<FlightEvent> out;
+  out.reserve(count);
+
+  // The oldest event is at next once the buffer has wrapped
+  const std::size_t first = (next + events.size() - count) % events.size();
+  for (std::size_t i = 0; i < count; ++i) {
+    const auto &event = events[(first + i) % events.size()];
+    if (event.time >= since) {
+      out.push_back(event);
+    }
+  }
+
+  return out;
+}
+
+bool FlightRecorder::flush(const QTime iwindow) {
+  const auto recent = getEvents(iwindow);
+  auto out = openOutput(fileName);
+  if (!out || !*out) {
+    LOG_ERROR("FlightRecorder: Couldn't open " + fileName + " for writing");
+    return false;
+  }
+
+  *out << "time,type,source,code,value\n";
+  for (const auto &event : recent) {
+    *out << event.time << ',' << toString(event.type) << ',' << event.source << ',' << event.code
+         << ',' << event.value << '\n';
+  }
+
+  out->flush();
+  if (!*out) {
+    LOG_ERROR("FlightRecorder: Couldn't write " + fileName);
+    return false;
+  }
+
+  LOG_INFO("FlightRecorder: Wrote " + std::to_string(recent.size()) + " events to " + fileName);
+  return true;
+}
+
+void FlightRecorder::setFlushOnFault(const bool iflushOnFault, const QTime iwindow) {
+  std::scoped_lock lock(mutex);
+  flushOnFault = iflushOnFault;
+  faultWindow = iwindow;
+}
+
+std::uint32_t FlightRecorder::getRecordedCount() const {
+  std::scoped_lock lock(mutex);
+  return recordedCount;
+}
+
+void FlightRecorder::setDefault(std::shared_ptr<FlightRecorder> irecorder) {
+  std::scoped_lock lock(defaultMutex());
+  hasDefault.store(irecorder != nullptr, std::memory_order_release);
+  defaultRecorder() = std::move(irecorder);
+}
+
+std::shared_ptr<FlightRecorder> FlightRecorder::getDefault() {
+  std::scoped_lock lock(defaultMutex());
+  return defaultRecorder();
+}
+
+void FlightRecorder::recordDefault(const FlightEventType itype,
+                                   const char *isource,
+                                   const std::int32_t icode,
+                                   const double ivalue) {
+  if (!hasDefault.load(std::memory_order_acquire)) {
+    return;
+  }
+
+  // Record outside the lock so a flush on a fault does not block other tasks' events
+  if (auto recorder = getDefault()) {
+    recorder->record(itype, isource, icode, ivalue);
+  }
+}
+
+std::unique_ptr<std::ostream> FlightRecorder::openOutput(const std::string &ifileName) {
+  return std::make_unique<std::ofstream>(ifileName, std::ofstream::out | std::ofstream::trunc);
+}
+} // namespace okapi
@@ -0,0 +1,189 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#include "okapi/api/util/hostThreadPool.hpp"
+#include <algorithm>
+
+namespace okapi {
+#if defined(THREADS_STD)
+HostThreadPool::HostThreadPool(const std::size_t inumWorkers) {
+  // The calling threads share one extra queue, so jobs are queued even with no workers
+  for (std::size_t i = 0; i <= inumWorkers; i++) {
+    queues.push_back(std::make_unique<Queue>());
+  }
+
+  for (std::size_t i = 0; i < inumWorkers; i++) {
+    workers.emplace_back([this, i]() { workerLoop(i); });
+  }
+}
+
+HostThreadPool::~HostThreadPool() {
+  {
+    std::scoped_lock lock(mutex);
+    stopping = true;
+  }
+  condition.notify_all();
+
+  for (auto &worker : workers) {
+    worker.join();
+  }
+}
+
+void HostThreadPool::runAll(const std::size_t icount,
+                            const std::function<void(std::size_t)> &ijob) {
+  if (icount == 0) {
+    return;
+  }
+
+  Batch batch{&ijob, icount};
+
+  // A worker queues on its own queue, so it takes the jobs of its batch back first
+  const bool isWorker = currentPool == this;
+  const std::size_t ownQueue = isWorker ? currentQueue : queues.size() - 1;
+
+  {
+    std::scoped_lock lock(mutex);
+    for (std::size_t i = 0; i < icount; i++) {
+      const std::size_t queue = isWorker ? ownQueue : nextQueue++ % queues.size();
+      std::scoped_lock queueLock(queues[queue]->mutex);
+      queues[queue]->jobs.push_back(Job{&batch, i});
+    }
+    pending += icount;
+  }
+  condition.notify_all();
+
+  while (batch.remaining.load() > 0) {
+    Job job{};
+    if (take(ownQueue, job)) {
+      run(job);
+    } else {
+      // Every job of the batch is running, so wait for them or for new jobs to help with
+      std::unique_lock lock(mutex);
+      condition.wait(lock, [&]() { return batch.remaining.load() == 0 || pending > 0; });
+    }
+  }
+
+  if (batch.error) {
+    std::rethrow_exception(batch.error);
+  }
+}
+
+std::size_t HostThreadPool::getWorkerCount() const {
+  return workers.size();
+}
+
+std::size_t HostThreadPool::getDefaultWorkerCount() {
+  const std::size_t cores = std::thread::hardware_concurrency();
+  return cores > 1 ? cores - 1 : 0;
+}
+
+bool HostThreadPool::take(const std::size_t iqueue, Job &ojob) {
+  for (std::size_t i = 0; i < queues.size(); i++) {
+    Queue &queue = *queues[(iqueue + i) % queues.size()];
+    {
+      std::scoped_lock queueLock(queue.mutex);
+      if (queue.jobs.empty()) {
+        continue;
+      }
+
+      if (i == 0) {
+        ojob = queue.jobs.back();
+        queue.jobs.pop_back();
+      } else {
+        ojob = queue.jobs.front();
+        queue.jobs.pop_front();
+      }
+    }
+
+    // runAll() takes the pool lock before the queue locks, so this must not hold a queue lock
+    std::scoped_lock lock(mutex);
+    pending--;
+    return true;
+  }
+
+  return false;
+}
+
+void HostThreadPool::workerLoop(const std::size_t iqueue) {
+  currentPool = this;
+  currentQueue = iqueue;
+
+  while (true) {
+    Job job{};
+    if (take(iqueue, job)) {
+      run(job);
+      continue;
+    }
+
+    std::unique_lock lock(mutex);
+    condition.wait(lock, [&]() { return stopping || pending > 0; });
+    if (stopping && pending == 0) {
+      return;
+    }
+  }
+}
+
+void HostThreadPool::run(Job &ijob) {
+  try {
+    (*ijob.batch->job)(ijob.index);
+  } catch (...) {
+    std::scoped_lock lock(mutex);
+    if (!ijob.batch->error) {
+      ijob.batch->error = std::current_exception();
+    }
+  }
+
+  // Counting the last job done under the lock keeps the waiting thread from missing the wakeup
+  if (ijob.batch->remaining.fetch_sub(1) == 1) {
+    {
+      std::scoped_lock lock(mutex);
+    }
+    condition.notify_all();
+  }
+}
+#else
+HostThreadPool::HostThreadPool(std::size_t) {
+}
+
+HostThreadPool::~HostThreadPool() = default;
+
+void HostThreadPool::runAll(const std::size_t icount,
+                            const std::function<void(std::size_t)> &ijob) {
+  Batch batch{&ijob, icount};
+  for (std::size_t i = 0; i < icount; i++) {
+    Job job{&batch, i};
+    run(job);
+  }
+
+  if (batch.error) {
+    std::rethrow_exception(batch.error);
+  }
+}
+
+std::size_t HostThreadPool::getWorkerCount() const {
+  return 0;
+}
+
+std::size_t HostThreadPool::getDefaultWorkerCount() {
+  return 0;
+}
+
+void HostThreadPool::run(Job &ijob) {
+  try {
+    (*ijob.batch->job)(ijob.index);
+  } catch (...) {
+    if (!ijob.batch->error) {
+      ijob.batch->error = std::current_exception();
+    }
+  }
+  ijob.batch->remaining--;
+}
+#endif
+
+HostThreadPool &HostThreadPool::getShared() {
+  static HostThreadPool pool;
+  return pool;
+}
+} // namespace okapi
@@ -0,0 +1,310 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#include "okapi/api/util/inputRecorder.hpp"
+
+namespace okapi {
+namespace {
+/**
+ * Records readings to one channel of a telemetry logger.
+ */
+class InputChannel {
+  public:
+  InputChannel(std::shared_ptr<TelemetryLogger> itelemetry, const std::uint16_t ichannel)
+    : telemetry(std::move(itelemetry)), channel(ichannel) {
+  }
+
+  template <typename T> T record(const InputReading ireading, const T ivalue) const {
+    telemetry->record(channel, {static_cast<double>(ireading), static_cast<double>(ivalue)});
+    return ivalue;
+  }
+
+  protected:
+  std::shared_ptr<TelemetryLogger> telemetry;
+  std::uint16_t channel;
+};
+
+class RecordingSensor : public ContinuousRotarySensor {
+  public:
+  RecordingSensor(std::shared_ptr<ContinuousRotarySensor> isensor, InputChannel irecorder)
+    : sensor(std::move(isensor)), recorder(std::move(irecorder)) {
+  }
+
+  double get() const override {
+    return recorder.record(InputReading::sensorValue, sensor->get());
+  }
+
+  double getTimestamped(std::uint32_t &otimestamp) const override {
+    const double value = sensor->getTimestamped(otimestamp);
+    recorder.record(InputReading::sensorTimestamp, otimestamp);
+    return recorder.record(InputReading::sensorTimestampedValue, value);
+  }
+
+  double getVelocity() const override {
+    return recorder.record(InputReading::sensorVelocity, sensor->getVelocity());
+  }
+
+  bool measuresVelocity() const override {
+    return sensor->measuresVelocity();
+  }
+
+  std::int32_t reset() override {
+    return sensor->reset();
+  }
+
+  double controllerGet() override {
+    return recorder.record(InputReading::sensorControllerValue, sensor->controllerGet());
+  }
+
+  protected:
+  std::shared_ptr<ContinuousRotarySensor> sensor;
+  InputChannel recorder;
+};
+
+class RecordingMotor : public AbstractMotor {
+  public:
+  RecordingMotor(std::shared_ptr<AbstractMotor> imotor,
+                 InputChannel irecorder,
+                 std::shared_ptr<ContinuousRotarySensor> iencoder)
+    : motor(std::move(imotor)), recorder(std::move(irecorder)), encoder(std::move(iencoder)) {
+  }
+
+  std::int32_t moveAbsolute(const double iposition, const std::int32_t ivelocity) override {
+    return motor->moveAbsolute(iposition, ivelocity);
+  }
+
+  std::int32_t moveRelative(const double iposition, const std::int32_t ivelocity) override {
+    return motor->moveRelative(iposition, ivelocity);
+  }
+
+  std::int32_t moveVelocity(const std::int16_t ivelocity) override {
+    return motor->moveVelocity(ivelocity);
+  }
+
+  std::int32_t moveVoltage(const std::int16_t ivoltage) override {
+    return motor->moveVoltage(ivoltage);
+  }
+
+  std::int32_t modifyProfiledVelocity(const std::int32_t ivelocity) override {
+    return motor->modifyProfiledVelocity(ivelocity);
+  }
+
+  double getTargetPosition() override {
+    return recorder.record(InputReading::motorTargetPosition, motor->getTargetPosition());
+  }
+
+  double getPosition() override {
+    return recorder.record(InputReading::motorPosition, motor->getPosition());
+  }
+
+  std::int32_t tarePosition() override {
+    return motor->tarePosition();
+  }
+
+  std::int32_t getTargetVelocity() override {
+    return recorder.record(InputReading::motorTargetVelocity, motor->getTargetVelocity());
+  }
+
+  double getActualVelocity() override {
+    return recorder.record(InputReading::motorActualVelocity, motor->getActualVelocity());
+  }
+
+  std::int32_t getCurrentDraw() override {
+    return recorder.record(InputReading::motorCurrentDraw, motor->getCurrentDraw());
+  }
+
+  std::int32_t getDirection() override {
+    return recorder.record(InputReading::motorDirection, motor->getDirection());
+  }
+
+  double getEfficiency() override {
+    return recorder.record(InputReading::motorEfficiency, motor->getEfficiency());
+  }
+
+  std::int32_t isOverCurrent() override {
+    return recorder.record(InputReading::motorOverCurrent, motor->isOverCurrent());
+  }
+
+  std::int32_t isOverTemp() override {
+    return recorder.record(InputReading::motorOverTemp, motor->isOverTemp());
+  }
+
+  std::int32_t isStopped() override {
+    return recorder.record(InputReading::motorStopped, motor->isStopped());
+  }
+
+  std::int32_t getZeroPositionFlag() override {
+    return recorder.record(InputReading::motorZeroPositionFlag, motor->getZeroPositionFlag());
+  }
+
+  std::uint32_t getFaults() override {
+    return recorder.record(InputReading::motorFaults, motor->getFaults());
+  }
+
+  std::uint32_t getFlags() override {
+    return recorder.record(InputReading::motorFlags, motor->getFlags());
+  }
+
+  std::int32_t getRawPosition(std::uint32_t *timestamp) override {
+    const auto position = motor->getRawPosition(timestamp);
+    if (timestamp != nullptr) {
+      recorder.record(InputReading::motorRawPositionTimestamp, *timestamp);
+    }
+    return recorder.record(InputReading::motorRawPosition, position);
+  }
+
+  double getPower() override {
+    return recorder.record(InputReading::motorPower, motor->getPower());
+  }
+
+  double getTemperature() override {
+    return recorder.record(InputReading::motorTemperature, motor->getTemperature());
+  }
+
+  double getTorque() override {
+    return recorder.record(InputReading::motorTorque, motor->getTorque());
+  }
+
+  std::int32_t getVoltage() override {
+    return recorder.record(InputReading::motorVoltage, motor->getVoltage());
+  }
+
+  std::int32_t setBrakeMode(const brakeMode imode) override {
+    return motor->setBrakeMode(imode);
+  }
+
+  brakeMode getBrakeMode() override {
+    return motor->getBrakeMode();
+  }
+
+  std::int32_t setCurrentLimit(const std::int32_t ilimit) override {
+    return motor->setCurrentLimit(ilimit);
+  }
+
+  std::int32_t getCurrentLimit() override {
+    return motor->getCurrentLimit();
+  }
+
+  std::int32_t setEncoderUnits(const encoderUnits iunits) override {
+    return motor->setEncoderUnits(iunits);
+  }
+
+  encoderUnits getEncoderUnits() override {
+    return motor->getEncoderUnits();
+  }
+
+  std::int32_t setGearing(const gearset igearset) override {
+    return motor->setGearing(igearset);
+  }
+
+  gearset getGearing() override {
+    return motor->getGearing();
+  }
+
+  std::int32_t setReversed(const bool ireverse) override {
+    return motor->setReversed(ireverse);
+  }
+
+  std::int32_t setVoltageLimit(const std::int32_t ilimit) override {
+    return motor->setVoltageLimit(ilimit);
+  }
+
+  std::shared_ptr<ContinuousRotarySensor> getEncoder() override {
+    return encoder;
+  }
+
+  void controllerSet(const double ivalue) override {
+    motor->controllerSet(ivalue);
+  }
+
+  protected:
+  std::shared_ptr<AbstractMotor> motor;
+  InputChannel recorder;
+  std::shared_ptr<ContinuousRotarySensor> encoder;
+};
+
+class RecordingButton : public AbstractButton {
+  public:
+  RecordingButton(std::shared_ptr<AbstractButton> ibutton, InputChannel irecorder)
+    : button(std::move(ibutton)), recorder(std::move(irecorder)) {
+  }
+
+  bool isPressed() override {
+    return recorder.record(InputReading::buttonPressed, button->isPressed());
+  }
+
+  bool changed() override {
+    return recorder.record(InputReading::buttonChanged, button->changed());
+  }
+
+  bool changedToPressed() override {
+    return recorder.record(InputReading::buttonChangedToPressed, button->changedToPressed());
+  }
+
+  bool changedToReleased() override {
+    return recorder.record(InputReading::buttonChangedToReleased, button->changedToReleased());
+  }
+
+  bool controllerGet() override {
+    return recorder.record(InputReading::buttonControllerValue, button->controllerGet());
+  }
+
+  protected:
+  std::shared_ptr<AbstractButton> button;
+  InputChannel recorder;
+};
+
+class RecordingInput : public ControllerInput<double> {
+  public:
+  RecordingInput(std::shared_ptr<ControllerInput<double>> iinput, InputChannel irecorder)
+    : input(std::move(iinput)), recorder(std::move(irecorder)) {
+  }
+
+  double controllerGet() override {
+    return recorder.record(InputReading::inputValue, input->controllerGet());
+  }
+
+  protected:
+  std::shared_ptr<ControllerInput<double>> input;
+  InputChannel recorder;
+};
+} // namespace
+
+InputRecorder::InputRecorder(std::shared_ptr<TelemetryLogger> itelemetry)
+  : telemetry(std::move(itelemetry)) {
+}
+
+std::shared_ptr<AbstractMotor>
+InputRecorder::recordMotor(const std::string &iname, const std::shared_ptr<AbstractMotor> &imotor) {
+  const auto channel = addChannel(iname);
+  const auto encoder = imotor->getEncoder();
+  return std::make_shared<RecordingMotor>(
+    imotor,
+    InputChannel(telemetry, channel),
+    encoder ? recordSensor(iname + "/encoder", encoder) : nullptr);
+}
+
+std::shared_ptr<ContinuousRotarySensor>
+InputRecorder::recordSensor(const std::string &iname,
+                            const std::shared_ptr<ContinuousRotarySensor> &isensor) {
+  return std::make_shared<RecordingSensor>(isensor, InputChannel(telemetry, addChannel(iname)));
+}
+
+std::shared_ptr<AbstractButton>
+InputRecorder::recordButton(const std::string &iname,
+                            const std::shared_ptr<AbstractButton> &ibutton) {
+  return std::make_shared<RecordingButton>(ibutton, InputChannel(telemetry, addChannel(iname)));
+}
+
+std::shared_ptr<ControllerInput<double>>
+InputRecorder::recordInput(const std::string &iname,
+                           const std::shared_ptr<ControllerInput<double>> &iinput) {
+  return std::make_shared<RecordingInput>(iinput, InputChannel(telemetry, addChannel(iname)));
+}
+
+std::uint16_t InputRecorder::addChannel(const std::string &iname) {
+  return telemetry->addChannel(channelPrefix + iname, {"reading", "value"});
+}
+} // namespace okapi
@@ -0,0 +1,445 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#include "okapi/api/util/inputReplayer.hpp"
+#include "okapi/api/util/mathUtil.hpp"
+#include "okapi/api/util/telemetryFormat.hpp"
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <limits>
+#include <mutex>
+#include <stdexcept>
+#include <vector>
+
+namespace okapi {
+/**
+ * The recorded readings of one device.
+ */
+class ReplayedDevice {
+  public:
+  static constexpr std::size_t readingCount =
+    static_cast<std::size_t>(InputReading::inputValue) + 1;
+
+  explicit ReplayedDevice(std::shared_ptr<AbstractTimer> itimer) : timer(std::move(itimer)) {
+  }
+
+  void add(const std::uint32_t itime, const double ireading, const double ivalue) {
+    if (!(ireading >= 0 && ireading < readingCount)) {
+      return;
+    }
+
+    auto &track = tracks[static_cast<std::size_t>(ireading)];
+    track.times.push_back(itime);
+    track.values.push_back(ivalue);
+  }
+
+  void setStartTime(const std::uint32_t itime) {
+    startTime = itime;
+  }
+
+  bool has(const InputReading ireading) const {
+    return !tracks[static_cast<std::size_t>(ireading)].times.empty();
+  }
+
+  /**
+   * @return The last value recorded at or before now, or the first value if none was.
+   */
+  double read(const InputReading ireading) const {
+    const auto &track = tracks[static_cast<std::size_t>(ireading)];
+    if (track.times.empty()) {
+      return 0;
+    }
+
+    const auto end = findEnd(track);
+    return end == 0 ? track.values.front() : track.values[end - 1];
+  }
+
+  /**
+   * @return Whether a true value was recorded since the last time the reading was read.
+   */
+  bool readEdge(const InputReading ireading) {
+    const auto &track = tracks[static_cast<std::size_t>(ireading)];
+    const auto end = findEnd(track);
+
+    std::scoped_lock lock(edgeMutex);
+    auto &cursor = edgeCursors[static_cast<std::size_t>(ireading)];
+    const bool edge =
+      cursor < end && std::any_of(track.values.begin() + cursor,
+                                  track.values.begin() + end,
+                                  [](const double ivalue) { return ivalue != 0; });
+    cursor = std::max(cursor, end);
+    return edge;
+  }
+
+  protected:
+  struct Track {
+    std::vector<std::uint32_t> times{};
+    std::vector<double> values{};
+  };
+
+  std::shared_ptr<AbstractTimer> timer;
+  std::uint32_t startTime{0};
+  std::array<Track, readingCount> tracks{};
+  std::array<std::size_t, readingCount> edgeCursors{};
+  std::mutex edgeMutex;
+
+  /**
+   * @return The number of samples of a track recorded at or before now.
+   */
+  std::size_t findEnd(const Track &itrack) const {
+    const auto now =
+      startTime + static_cast<std::uint32_t>(std::lround(timer->millis().convert(millisecond)));
+    return static_cast<std::size_t>(
+      std::upper_bound(itrack.times.begin(), itrack.times.end(), now) - itrack.times.begin());
+  }
+};
+
+namespace {
+/**
+ * Converts a replayed value back to an integer reading. PROS_ERR does not fit in a 32-bit float,
+ * so it was recorded as the next float up.
+ */
+std::int32_t toInt32(const double ivalue) {
+  if (!(ivalue < static_cast<double>(OKAPI_PROS_ERR))) {
+    return OKAPI_PROS_ERR;
+  }
+  return static_cast<std::int32_t>(
+    std::max(std::llround(ivalue), static_cast<long long>(std::numeric_limits<int32_t>::min())));
+}
+
+std::uint32_t toUint32(const double ivalue) {
+  if (!(ivalue < static_cast<double>(OKAPI_PROS_ERR))) {
+    return OKAPI_PROS_ERR;
+  }
+  return static_cast<std::uint32_t>(std::max(std::llround(ivalue), 0LL));
+}
+
+class ReplaySensor : public ContinuousRotarySensor {
+  public:
+  explicit ReplaySensor(std::shared_ptr<ReplayedDevice> idevice) : device(std::move(idevice)) {
+  }
+
+  double get() const override {
+    return device->read(InputReading::sensorValue);
+  }
+
+  double getTimestamped(std::uint32_t &otimestamp) const override {
+    otimestamp = toUint32(device->read(InputReading::sensorTimestamp));
+    return device->read(InputReading::sensorTimestampedValue);
+  }
+
+  double getVelocity() const override {
+    return device->has(InputReading::sensorVelocity) ? device->read(InputReading::sensorVelocity)
+                                                     : OKAPI_PROS_ERR_F;
+  }
+
+  bool measuresVelocity() const override {
+    return device->has(InputReading::sensorVelocity);
+  }
+
+  std::int32_t reset() override {
+    return 1;
+  }
+
+  double controllerGet() override {
+    return device->read(InputReading::sensorControllerValue);
+  }
+
+  protected:
+  std::shared_ptr<ReplayedDevice> device;
+};
+
+class ReplayMotor : public AbstractMotor {
+  public:
+  ReplayMotor(std::shared_ptr<ReplayedDevice> idevice,
+              std::shared_ptr<ContinuousRotarySensor> iencoder)
+    : device(std::move(idevice)), encoder(std::move(iencoder)) {
+  }
+
+  std::int32_t moveAbsolute(double, std::int32_t) override {
+    return 1;
+  }
+
+  std::int32_t moveRelative(double, std::int32_t) override {
+    return 1;
+  }
+
+  std::int32_t moveVelocity(std::int16_t) override {
+    return 1;
+  }
+
+  std::int32_t moveVoltage(std::int16_t) override {
+    return 1;
+  }
+
+  std::int32_t modifyProfiledVelocity(std::int32_t) override {
+    return 1;
+  }
+
+  double getTargetPosition() override {
+    return device->read(InputReading::motorTargetPosition);
+  }
+
+  double getPosition() override {
+    return device->read(InputReading::motorPosition);
+  }
+
+  std::int32_t tarePosition() override {
+    return 1;
+  }
+
+  std::int32_t getTargetVelocity() override {
+    return toInt32(device->read(InputReading::motorTargetVelocity));
+  }
+
+  double getActualVelocity() override {
+    return device->read(InputReading::motorActualVelocity);
+  }
+
+  std::int32_t getCurrentDraw() override {
+    return toInt32(device->read(InputReading::motorCurrentDraw));
+  }
+
+  std::int32_t getDirection() override {
+    return toInt32(device->read(InputReading::motorDirection));
+  }
+
+  double getEfficiency() override {
+    return device->read(InputReading::motorEfficiency);
+  }
+
+  std::int32_t isOverCurrent() override {
+    return toInt32(device->read(InputReading::motorOverCurrent));
+  }
+
+  std::int32_t isOverTemp() override {
+    return toInt32(device->read(InputReading::motorOverTemp));
+  }
+
+  std::int32_t isStopped() override {
+    return toInt32(device->read(InputReading::motorStopped));
+  }
+
+  std::int32_t getZeroPositionFlag() override {
+    return toInt32(device->read(InputReading::motorZeroPositionFlag));
+  }
+
+  std::uint32_t getFaults() override {
+    return toUint32(device->read(InputReading::motorFaults));
+  }
+
+  std::uint32_t getFlags() override {
+    return toUint32(device->read(InputReading::motorFlags));
+  }
+
+  std::int32_t getRawPosition(std::uint32_t *timestamp) override {
+    if (timestamp != nullptr) {
+      *timestamp = toUint32(device->read(InputReading::motorRawPositionTimestamp));
+    }
+    return toInt32(device->read(InputReading::motorRawPosition));
+  }
+
+  double getPower() override {
+    return device->read(InputReading::motorPower);
+  }
+
+  double getTemperature() override {
+    return device->read(InputReading::motorTemperature);
+  }
+
+  double getTorque() override {
+    return device->read(InputReading::motorTorque);
+  }
+
+  std::int32_t getVoltage() override {
+    return toInt32(device->read(InputReading::motorVoltage));
+  }
+
+  std::int32_t setBrakeMode(const brakeMode imode) override {
+    mode = imode;
+    return 1;
+  }
+
+  brakeMode getBrakeMode() override {
+    return mode;
+  }
+
+  std::int32_t setCurrentLimit(const std::int32_t ilimit) override {
+    currentLimit = ilimit;
+    return 1;
+  }
+
+  std::int32_t getCurrentLimit() override {
+    return currentLimit;
+  }
+
+  std::int32_t setEncoderUnits(const encoderUnits iunits) override {
+    units = iunits;
+    return 1;
+  }
+
+  encoderUnits getEncoderUnits() override {
+    return units;
+  }
+
+  std::int32_t setGearing(const gearset igearset) override {
+    gearing = igearset;
+    return 1;
+  }
+
+  gearset getGearing() override {
+    return gearing;
+  }
+
+  std::int32_t setReversed(bool) override {
+    return 1;
+  }
+
+  std::int32_t setVoltageLimit(std::int32_t) override {
+    return 1;
+  }
+
+  std::shared_ptr<ContinuousRotarySensor> getEncoder() override {
+    return encoder;
+  }
+
+  void controllerSet(double) override {
+  }
+
+  protected:
+  std::shared_ptr<ReplayedDevice> device;
+  std::shared_ptr<ContinuousRotarySensor> encoder;
+  brakeMode mode{brakeMode::coast};
+  std::int32_t currentLimit{2500};
+  encoderUnits units{encoderUnits::degrees};
+  gearset gearing{gearset::green};
+};
+
+class ReplayButton : public AbstractButton {
+  public:
+  explicit ReplayButton(std::shared_ptr<ReplayedDevice> idevice) : device(std::move(idevice)) {
+  }
+
+  bool isPressed() override {
+    return device->read(InputReading::buttonPressed) != 0;
+  }
+
+  bool changed() override {
+    return device->readEdge(InputReading::buttonChanged);
+  }
+
+  bool changedToPressed() override {
+    return device->readEdge(InputReading::buttonChangedToPressed);
+  }
+
+  bool changedToReleased() override {
+    return device->readEdge(InputReading::buttonChangedToReleased);
+  }
+
+  bool controllerGet() override {
+    return device->read(InputReading::buttonControllerValue) != 0;
+  }
+
+  protected:
+  std::shared_ptr<ReplayedDevice> device;
+};
+
+class ReplayInput : public ControllerInput<double> {
+  public:
+  explicit ReplayInput(std::shared_ptr<ReplayedDevice> idevice) : device(std::move(idevice)) {
+  }
+
+  double controllerGet() override {
+    return device->read(InputReading::inputValue);
+  }
+
+  protected:
+  std::shared_ptr<ReplayedDevice> device;
+};
+} // namespace
+
+InputReplayer::InputReplayer(std::unique_ptr<AbstractTimer> itimer,
+                             const std::shared_ptr<Logger> &ilogger)
+  : logger(ilogger), timer(std::move(itimer)) {
+}
+
+bool InputReplayer::load(std::istream &istream) {
+  const std::string prefix(InputRecorder::channelPrefix);
+  std::map<std::uint16_t, std::shared_ptr<ReplayedDevice>> channels;
+
+  const bool decoded = TelemetryFormat::decode(
+    istream,
+    [&](const TelemetryFormat::Channel &ichannel) {
+      if (ichannel.fieldNames.size() == 2 && ichannel.name.compare(0, prefix.size(), prefix) == 0) {
+        auto &device = devices[ichannel.name.substr(prefix.size())];
+        device = std::make_shared<ReplayedDevice>(timer);
+        channels[ichannel.id] = device;
+      }
+    },
+    [&](const TelemetryFormat::Sample &isample) {
+      const auto channel = channels.find(isample.channel);
+      if (channel == channels.end() || isample.values.size() != 2) {
+        return;
+      }
+
+      channel->second->add(isample.time, isample.values[0], isample.values[1]);
+      if (!hasSamples) {
+        startTime = isample.time;
+        endTime = isample.time;
+        hasSamples = true;
+      }
+      startTime = std::min(startTime, isample.time);
+      endTime = std::max(endTime, isample.time);
+    });
+
+  for (auto &&device : devices) {
+    device.second->setStartTime(startTime);
+  }
+
+  if (!decoded) {
+    LOG_WARN_S("InputReplayer: The recording could not be read to its end.");
+  }
+  LOG_INFO("InputReplayer: Loaded " + std::to_string(devices.size()) + " devices.");
+  return decoded;
+}
+
+bool InputReplayer::hasDevice(const std::string &iname) const {
+  return devices.find(iname) != devices.end();
+}
+
+std::shared_ptr<AbstractMotor> InputReplayer::replayMotor(const std::string &iname) {
+  const auto device = getDevice(iname);
+  const auto encoderName = iname + "/encoder";
+  return std::make_shared<ReplayMotor>(
+    device, hasDevice(encoderName) ? replaySensor(encoderName) : nullptr);
+}
+
+std::shared_ptr<ContinuousRotarySensor> InputReplayer::replaySensor(const std::string &iname) {
+  return std::make_shared<ReplaySensor>(getDevice(iname));
+}
+
+std::shared_ptr<AbstractButton> InputReplayer::replayButton(const std::string &iname) {
+  return std::make_shared<ReplayButton>(getDevice(iname));
+}
+
+std::shared_ptr<ControllerInput<double>> InputReplayer::replayInput(const std::string &iname) {
+  return std::make_shared<ReplayInput>(getDevice(iname));
+}
+
+QTime InputReplayer::getDuration() const {
+  return (endTime - startTime) * millisecond;
+}
+
+std::shared_ptr<ReplayedDevice> InputReplayer::getDevice(const std::string &iname) const {
+  const auto device = devices.find(iname);
+  if (device == devices.end()) {
+    std::string msg("InputReplayer: No device was recorded with the name " + iname + ".");
+    LOG_ERROR(msg);
+    throw std::invalid_argument(msg);
+  }
+  return device->second;
+}
+} // namespace okapi
@@ -0,0 +1,101 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#include "okapi/api/util/joystickCurve.hpp"
+#include <cmath>
+#include <stdexcept>
+#include <string>
+#include <utility>
+
+namespace okapi {
+JoystickCurve::JoystickCurve(const std::function<double(double)> &icurve,
+                             const double ideadband,
+                             const std::shared_ptr<Logger> &ilogger) {
+  const auto &logger = ilogger;
+  if (!(ideadband >= 0 && ideadband < 1)) {
+    std::string msg = "JoystickCurve: The deadband must be in [0, 1).";
+    LOG_ERROR(msg);
+    throw std::invalid_argument(msg);
+  }
+
+  for (std::int32_t raw = 1; raw <= maxRaw; raw++) {
+    const double magnitude = static_cast<double>(raw) / maxRaw;
+    if (magnitude <= ideadband) {
+      continue;
+    }
+
+    const double output = std::clamp(icurve((magnitude - ideadband) / (1 - ideadband)), 0.0, 1.0);
+    table[static_cast<std::size_t>(maxRaw + raw)] = static_cast<float>(output);
+    table[static_cast<std::size_t>(maxRaw - raw)] = static_cast<float>(-output);
+  }
+}
+
+JoystickCurve JoystickCurve::linear(const double ideadband) {
+  return JoystickCurve([](const double x) { return x; }, ideadband);
+}
+
+JoystickCurve JoystickCurve::exponential(const double iexponent, const double ideadband) {
+  if (!(iexponent > 0)) {
+    auto logger = Logger::getDefaultLogger();
+    std::string msg = "JoystickCurve: The exponent must be greater than zero.";
+    LOG_ERROR(msg);
+    throw std::invalid_argument(msg);
+  }
+
+  return JoystickCurve([iexponent](const double x) { return std::pow(x, iexponent); }, ideadband);
+}
+
+double JoystickCurve::shape(const double ivalue) const {
+  return (*this)(static_cast<std::int32_t>(std::lround(std::clamp(ivalue, -1.0, 1.0) * maxRaw)));
+}
+
+JoystickAxis::JoystickAxis(JoystickCurve icurve,
+                           const double iaccelStep,
+                           const double idecelStep,
+                           const std::shared_ptr<Logger> &ilogger)
+  : curve(std::move(icurve)), accelStep(iaccelStep), decelStep(idecelStep) {
+  const auto &logger = ilogger;
+  if (!(accelStep > 0) || !(decelStep > 0)) {
+    std::string msg =
+      "JoystickAxis: The acceleration and deceleration steps must be greater than zero.";
+    LOG_ERROR(msg);
+    throw std::invalid_argument(msg);
+  }
+}
+
+double JoystickAxis::step(const std::int32_t iraw) {
+  return stepToward(curve(iraw));
+}
+
+double JoystickAxis::step(const double ivalue) {
+  return stepToward(curve.shape(ivalue));
+}
+
+double JoystickAxis::getOutput() const {
+  return output;
+}
+
+void JoystickAxis::reset() {
+  output = 0;
+}
+
+double JoystickAxis::stepToward(const double itarget) {
+  const bool speedingUp = itarget * output >= 0 && std::abs(itarget) > std::abs(output);
+  if (speedingUp) {
+    output += std::clamp(itarget - output, -accelStep, accelStep);
+    return output;
+  }
+
+  if (std::abs(itarget - output) <= decelStep) {
+    output = itarget;
+    return output;
+  }
+
+  // An output which reverses stops at zero first, so the next tick speeds it up the other way
+  const double next = output + std::clamp(itarget - output, -decelStep, decelStep);
+  output = next * output < 0 ? 0 : next;
+  return output;
+}
+} // namespace okapi
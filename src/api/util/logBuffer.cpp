@@ -0,0 +1,74 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#include "okapi/api/util/logBuffer.hpp"
+#include <algorithm>
+#include <cstring>
+#include <mutex>
+#include <utility>
+
+namespace okapi {
+LogBuffer::LogBuffer(const std::size_t icapacity, const std::size_t iflushThreshold)
+  : capacity(std::max<std::size_t>(icapacity, 1)),
+    flushThreshold(std::min(iflushThreshold, capacity)),
+    storage(std::make_unique<char[]>(2 * capacity)),
+    heap(HeapSubsystem::logging, 2 * capacity),
+    filling(storage.get()),
+    writing(storage.get() + capacity) {
+}
+
+bool LogBuffer::append(const std::initializer_list<std::string_view> iparts,
+                       bool &oshouldFlush) noexcept {
+  std::size_t length = 0;
+  for (const auto &part : iparts) {
+    length += part.size();
+  }
+
+  std::scoped_lock lock(mutex);
+  if (size + length > capacity) {
+    droppedCount.fetch_add(1, std::memory_order_relaxed);
+    oshouldFlush = true;
+    return false;
+  }
+
+  for (const auto &part : iparts) {
+    std::memcpy(filling + size, part.data(), part.size());
+    size += part.size();
+  }
+
+  oshouldFlush = size >= flushThreshold;
+  return true;
+}
+
+std::size_t LogBuffer::writeTo(FILE *const ifile) noexcept {
+  std::size_t length;
+  {
+    // Swap the halves so appending can continue while the full half is written
+    std::scoped_lock lock(mutex);
+    std::swap(filling, writing);
+    length = size;
+    size = 0;
+  }
+
+  if (length == 0 || !ifile) {
+    return 0;
+  }
+
+  return fwrite(writing, 1, length, ifile);
+}
+
+std::size_t LogBuffer::getBufferedSize() const noexcept {
+  std::scoped_lock lock(mutex);
+  return size;
+}
+
+std::uint32_t LogBuffer::getDroppedCount() const noexcept {
+  return droppedCount.load(std::memory_order_relaxed);
+}
+
+std::size_t LogBuffer::getCapacity() const noexcept {
+  return capacity;
+}
+} // namespace okapi
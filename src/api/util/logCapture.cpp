@@ -0,0 +1,31 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#include "okapi/api/util/logCapture.hpp"
+
+namespace okapi {
+LogCapture::LogCapture(const std::size_t icapacity) : LogRecordQueue(icapacity) {
+}
+
+std::vector<LogCapture::Line> LogCapture::takeLines() {
+  std::vector<Line> lines;
+  LogRecord record;
+  char message[LogRecord::maxFormattedLength + 1];
+  while (tryPop(record)) {
+    record.formatMessage(message, sizeof(message));
+    lines.push_back({record.time, record.level, record.taskName, message});
+  }
+  return lines;
+}
+
+std::size_t LogCapture::clear() {
+  std::size_t count = 0;
+  LogRecord record;
+  while (tryPop(record)) {
+    count++;
+  }
+  return count;
+}
+} // namespace okapi
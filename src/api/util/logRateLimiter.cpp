@@ -0,0 +1,59 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#include "okapi/api/util/logRateLimiter.hpp"
+#include <algorithm>
+
+namespace okapi {
+LogRateLimiter LogRateLimiter::perInterval(const std::uint32_t imaxCount, const QTime iinterval) {
+  return LogRateLimiter(1, std::max<std::uint32_t>(imaxCount, 1), iinterval);
+}
+
+LogRateLimiter LogRateLimiter::perSecond(const std::uint32_t imaxCount) {
+  return perInterval(imaxCount, 1_s);
+}
+
+LogRateLimiter LogRateLimiter::everyNth(const std::uint32_t in) {
+  return LogRateLimiter(in, 0, 0_ms);
+}
+
+LogRateLimiter::LogRateLimiter(const std::uint32_t in,
+                               const std::uint32_t imaxCount,
+                               const QTime iinterval) noexcept
+  : sampleEvery(std::max<std::uint32_t>(in, 1)),
+    maxCount(imaxCount),
+    intervalMs(static_cast<std::uint32_t>(iinterval.convert(millisecond))) {
+}
+
+bool LogRateLimiter::tryAcquire(const QTime inow, std::uint32_t &osuppressed) noexcept {
+  if (occurrences.fetch_add(1, std::memory_order_relaxed) % sampleEvery != 0) {
+    suppressed.fetch_add(1, std::memory_order_relaxed);
+    return false;
+  }
+
+  if (maxCount > 0) {
+    // Start a new interval once the current one is over. If two tasks race here, one of them
+    // starts it and the other counts against it.
+    const auto now = static_cast<std::uint32_t>(inow.convert(millisecond));
+    auto start = windowStart.load(std::memory_order_relaxed);
+    if (now - start >= intervalMs &&
+        windowStart.compare_exchange_strong(start, now, std::memory_order_relaxed)) {
+      windowCount.store(0, std::memory_order_relaxed);
+    }
+
+    if (windowCount.fetch_add(1, std::memory_order_relaxed) >= maxCount) {
+      suppressed.fetch_add(1, std::memory_order_relaxed);
+      return false;
+    }
+  }
+
+  osuppressed = suppressed.exchange(0, std::memory_order_relaxed);
+  return true;
+}
+
+std::uint32_t LogRateLimiter::getSuppressedCount() const noexcept {
+  return suppressed.load(std::memory_order_relaxed);
+}
+} // namespace okapi
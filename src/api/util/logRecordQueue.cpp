@@ -0,0 +1,301 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#include "okapi/api/util/logRecordQueue.hpp"
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+
+namespace okapi {
+static std::size_t roundUpToPowerOfTwo(const std::size_t ivalue) {
+  std::size_t out = 1;
+  while (out < ivalue) {
+    out <<= 1;
+  }
+  return out;
+}
+
+static long long asSigned(const LogArg &iarg) {
+  switch (iarg.type) {
+  case LogArg::Type::unsignedInteger:
+    return static_cast<long long>(iarg.value.u);
+  case LogArg::Type::floatingPoint:
+    return static_cast<long long>(iarg.value.d);
+  case LogArg::Type::signedInteger:
+    return iarg.value.i;
+  default:
+    return 0;
+  }
+}
+
+static unsigned long long asUnsigned(const LogArg &iarg) {
+  switch (iarg.type) {
+  case LogArg::Type::signedInteger:
+    return static_cast<unsigned long long>(iarg.value.i);
+  case LogArg::Type::floatingPoint:
+    return static_cast<unsigned long long>(iarg.value.d);
+  case LogArg::Type::unsignedInteger:
+    return iarg.value.u;
+  default:
+    return 0;
+  }
+}
+
+static double asDouble(const LogArg &iarg) {
+  switch (iarg.type) {
+  case LogArg::Type::signedInteger:
+    return static_cast<double>(iarg.value.i);
+  case LogArg::Type::unsignedInteger:
+    return static_cast<double>(iarg.value.u);
+  case LogArg::Type::floatingPoint:
+    return iarg.value.d;
+  default:
+    return 0;
+  }
+}
+
+void LogRecord::setFormat(const char *iformat,
+                          const LogArg *iargs,
+                          const std::size_t iargCount) noexcept {
+  format = iformat;
+  argCount = static_cast<std::uint8_t>(std::min(iargCount, maxArgs));
+
+  std::size_t used = 0;
+  for (std::size_t i = 0; i < argCount; i++) {
+    args[i] = iargs[i];
+    if (args[i].type != LogArg::Type::string) {
+      continue;
+    }
+
+    // Copy the string so it doesn't need to outlive the log statement. Strings which don't fit
+    // are truncated.
+    const char *source = iargs[i].value.s ? iargs[i].value.s : "(null)";
+    const std::size_t length = strnlen(source, maxMessageLength - std::min(used, maxMessageLength));
+    std::memcpy(message + used, source, length);
+    message[used + length] = '\0';
+    args[i].value.u = used;
+    used = std::min(used + length + 1, maxMessageLength);
+  }
+}
+
+void LogRecord::formatMessage(char *obuffer, const std::size_t isize) const noexcept {
+  if (isize == 0) {
+    return;
+  }
+
+  if (!format) {
+    std::snprintf(obuffer, isize, "%s", message);
+    return;
+  }
+
+  std::size_t out = 0;
+  std::size_t argIndex = 0;
+  const char *c = format;
+  while (*c && out + 1 < isize) {
+    if (*c != '%') {
+      obuffer[out++] = *c++;
+      continue;
+    }
+
+    if (c[1] == '%') {
+      obuffer[out++] = '%';
+      c += 2;
+      continue;
+    }
+
+    // Keep the flags, width, and precision, and replace the length modifier with one which
+    // matches the captured argument
+    char spec[24] = "%";
+    std::size_t specLength = 1;
+    c++;
+    while (*c && std::strchr("-+ #0123456789.", *c) && specLength < 16) {
+      spec[specLength++] = *c++;
+    }
+    while (*c && std::strchr("hlLqjzt", *c)) {
+      c++;
+    }
+
+    const char conversion = *c;
+    if (!conversion) {
+      break;
+    }
+    c++;
+
+    if (argIndex >= argCount) {
+      continue;
+    }
+    const LogArg &arg = args[argIndex++];
+
+    int written = 0;
+    const std::size_t remaining = isize - out;
+    switch (conversion) {
+    case 'd':
+    case 'i':
+      std::snprintf(spec + specLength, sizeof(spec) - specLength, "ll%c", conversion);
+      written = std::snprintf(obuffer + out, remaining, spec, asSigned(arg));
+      break;
+
+    case 'u':
+    case 'x':
+    case 'X':
+    case 'o':
+      std::snprintf(spec + specLength, sizeof(spec) - specLength, "ll%c", conversion);
+      written = std::snprintf(obuffer + out, remaining, spec, asUnsigned(arg));
+      break;
+
+    case 'c':
+      std::snprintf(spec + specLength, sizeof(spec) - specLength, "c");
+      written = std::snprintf(obuffer + out, remaining, spec, static_cast<int>(asSigned(arg)));
+      break;
+
+    case 'f':
+    case 'F':
+    case 'e':
+    case 'E':
+    case 'g':
+    case 'G':
+    case 'a':
+    case 'A':
+      std::snprintf(spec + specLength, sizeof(spec) - specLength, "%c", conversion);
+      written = std::snprintf(obuffer + out, remaining, spec, asDouble(arg));
+      break;
+
+    case 's':
+      std::snprintf(spec + specLength, sizeof(spec) - specLength, "s");
+      written = std::snprintf(obuffer + out,
+                              remaining,
+                              spec,
+                              arg.type == LogArg::Type::string ? message + arg.value.u : "");
+      break;
+
+    case 'p':
+      std::snprintf(spec + specLength, sizeof(spec) - specLength, "p");
+      written = std::snprintf(obuffer + out,
+                              remaining,
+                              spec,
+                              arg.type == LogArg::Type::pointer ? arg.value.p : nullptr);
+      break;
+
+    default:
+      break;
+    }
+
+    if (written > 0) {
+      out += std::min(static_cast<std::size_t>(written), remaining - 1);
+    }
+  }
+
+  obuffer[out] = '\0';
+}
+
+LogRecordQueue::LogRecordQueue(const std::size_t icapacity)
+  : capacity(roundUpToPowerOfTwo(std::max<std::size_t>(icapacity, 2))),
+    cells(std::make_unique<Cell[]>(capacity)),
+    heap(HeapSubsystem::logging, capacity * sizeof(Cell)) {
+  for (std::size_t i = 0; i < capacity; i++) {
+    cells[i].sequence.store(i, std::memory_order_relaxed);
+  }
+}
+
+bool LogRecordQueue::tryPush(const long itime,
+                             const std::uint8_t ilevel,
+                             const char *itaskName,
+                             const std::string_view imessage) {
+  std::size_t position;
+  Cell *cell = claimCell(position);
+  if (!cell) {
+    return false;
+  }
+
+  LogRecord &record = cell->record;
+  setHeader(record, itime, ilevel, itaskName);
+  record.format = nullptr;
+  const std::size_t length = std::min(imessage.size(), LogRecord::maxMessageLength);
+  std::memcpy(record.message, imessage.data(), length);
+  record.message[length] = '\0';
+
+  publishCell(*cell, position);
+  return true;
+}
+
+bool LogRecordQueue::tryPushFormat(const long itime,
+                                   const std::uint8_t ilevel,
+                                   const char *itaskName,
+                                   const char *iformat,
+                                   const LogArg *iargs,
+                                   const std::size_t iargCount) {
+  std::size_t position;
+  Cell *cell = claimCell(position);
+  if (!cell) {
+    return false;
+  }
+
+  setHeader(cell->record, itime, ilevel, itaskName);
+  cell->record.setFormat(iformat, iargs, iargCount);
+
+  publishCell(*cell, position);
+  return true;
+}
+
+bool LogRecordQueue::tryPop(LogRecord &orecord) {
+  const std::size_t position = popPosition.load(std::memory_order_relaxed);
+  Cell &cell = cells[position & (capacity - 1)];
+  if (cell.sequence.load(std::memory_order_acquire) != position + 1) {
+    return false;
+  }
+
+  orecord = cell.record;
+  popPosition.store(position + 1, std::memory_order_relaxed);
+  cell.sequence.store(position + capacity, std::memory_order_release);
+  return true;
+}
+
+std::uint32_t LogRecordQueue::getDroppedCount() const {
+  return droppedCount.load(std::memory_order_relaxed);
+}
+
+std::size_t LogRecordQueue::getCapacity() const {
+  return capacity;
+}
+
+LogRecordQueue::Cell *LogRecordQueue::claimCell(std::size_t &oposition) {
+  std::size_t position = pushPosition.load(std::memory_order_relaxed);
+  while (true) {
+    Cell *cell = &cells[position & (capacity - 1)];
+    const std::size_t sequence = cell->sequence.load(std::memory_order_acquire);
+    const auto difference =
+      static_cast<std::ptrdiff_t>(sequence) - static_cast<std::ptrdiff_t>(position);
+
+    if (difference == 0) {
+      // The cell is free, so try to claim it
+      if (pushPosition.compare_exchange_weak(position, position + 1, std::memory_order_relaxed)) {
+        oposition = position;
+        return cell;
+      }
+    } else if (difference < 0) {
+      // The cell still holds a record which was not popped, so the queue is full
+      droppedCount.fetch_add(1, std::memory_order_relaxed);
+      return nullptr;
+    } else {
+      // Another task claimed the cell first
+      position = pushPosition.load(std::memory_order_relaxed);
+    }
+  }
+}
+
+void LogRecordQueue::publishCell(Cell &icell, const std::size_t iposition) {
+  icell.sequence.store(iposition + 1, std::memory_order_release);
+}
+
+void LogRecordQueue::setHeader(LogRecord &orecord,
+                               const long itime,
+                               const std::uint8_t ilevel,
+                               const char *itaskName) {
+  orecord.time = itime;
+  orecord.level = ilevel;
+  std::strncpy(orecord.taskName, itaskName, LogRecord::maxTaskNameLength);
+  orecord.taskName[LogRecord::maxTaskNameLength] = '\0';
+}
+} // namespace okapi
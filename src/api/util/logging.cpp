@@ -4,11 +4,17 @@
  * file, You can obtain one at http://mozilla.org/MPL/2.0/.
  */
 #include "okapi/api/util/logging.hpp"
+#include <algorithm>
 
 namespace okapi {
-std::shared_ptr<Logger> defaultLogger;
+// The default logger is made on first use instead of during static initialization, which would
+// open the serial stream in every program and depend on the order of static initializers
+static std::shared_ptr<Logger> defaultLogger;
 
-int DefaultLoggerInitializer::count;
+static CrossplatformMutex &getDefaultLoggerMutex() {
+  static CrossplatformMutex mutex;
+  return mutex;
+}
 
 Logger::Logger() noexcept : Logger(nullptr, nullptr, LogLevel::off) {
 }
@@ -27,21 +33,278 @@ Logger::Logger(std::unique_ptr<AbstractTimer> itimer,
   : timer(std::move(itimer)), logLevel(ilevel), logfile(ifile) {
 }
 
+Logger::Logger(std::unique_ptr<AbstractTimer> itimer,
+               std::shared_ptr<LogCapture> icapture,
+               const Logger::LogLevel &ilevel) noexcept
+  : timer(std::move(itimer)), logLevel(ilevel), logfile(nullptr), capture(std::move(icapture)) {
+}
+
 Logger::~Logger() {
+  close();
+}
+
+void Logger::close() noexcept {
+  // The drain task writes into the buffer, so stop it first
+  stopAsync();
+  stopBuffered();
+  flush();
+  capture = nullptr;
+
   if (logfile) {
     fclose(logfile);
     logfile = nullptr;
   }
 }
 
+void Logger::startAsync(const std::size_t icapacity,
+                        const std::uint32_t ipriority,
+                        const std::uint16_t istackDepth) {
+  if (asyncQueue || !logfile) {
+    return;
+  }
+
+  asyncQueue = std::make_unique<LogRecordQueue>(icapacity);
+  drainTask = new CrossplatformThread(drainTrampoline, this, "Logger", ipriority, istackDepth);
+}
+
+bool Logger::isAsync() const noexcept {
+  return asyncQueue != nullptr;
+}
+
+void Logger::startBuffered(const std::size_t ibufferSize,
+                           const std::uint32_t iflushPeriod,
+                           const std::uint32_t ipriority,
+                           const std::uint16_t istackDepth) {
+  if (buffer || !logfile) {
+    return;
+  }
+
+  buffer = std::make_unique<LogBuffer>(ibufferSize, ibufferSize / 2);
+  flushPeriod = iflushPeriod;
+  flushTask = new CrossplatformThread(flushTrampoline, this, "LoggerFlush", ipriority, istackDepth);
+}
+
+bool Logger::isBuffered() const noexcept {
+  return buffer != nullptr;
+}
+
+void Logger::flush() noexcept {
+  if (!logfile) {
+    return;
+  }
+
+  std::scoped_lock lock(logfileMutex);
+  if (buffer) {
+    buffer->writeTo(logfile);
+  }
+  fflush(logfile);
+}
+
+std::uint32_t Logger::getDroppedCount() const noexcept {
+  return (asyncQueue ? asyncQueue->getDroppedCount() : 0) +
+         (buffer ? buffer->getDroppedCount() : 0) + (capture ? capture->getDroppedCount() : 0);
+}
+
+void Logger::write(const LogLevel ilevel, const std::string &imessage) noexcept {
+  const auto time = static_cast<long>(timer->millis().convert(millisecond));
+
+  if (capture) {
+    capture->tryPush(
+      time, toUnderlyingType(ilevel), CrossplatformThread::getNameCString(), imessage);
+    return;
+  }
+
+  if (asyncQueue) {
+    asyncQueue->tryPush(
+      time, toUnderlyingType(ilevel), CrossplatformThread::getNameCString(), imessage);
+    return;
+  }
+
+  writeLine(time, CrossplatformThread::getNameCString(), ilevel, imessage.c_str());
+}
+
+void Logger::writeFormat(const LogLevel ilevel,
+                         const char *iformat,
+                         const std::initializer_list<LogArg> iargs) noexcept {
+  const auto time = static_cast<long>(timer->millis().convert(millisecond));
+
+  if (capture) {
+    capture->tryPushFormat(time,
+                           toUnderlyingType(ilevel),
+                           CrossplatformThread::getNameCString(),
+                           iformat,
+                           iargs.begin(),
+                           iargs.size());
+    return;
+  }
+
+  if (asyncQueue) {
+    asyncQueue->tryPushFormat(time,
+                              toUnderlyingType(ilevel),
+                              CrossplatformThread::getNameCString(),
+                              iformat,
+                              iargs.begin(),
+                              iargs.size());
+    return;
+  }
+
+  LogRecord record;
+  record.setFormat(iformat, iargs.begin(), iargs.size());
+  char message[LogRecord::maxFormattedLength + 1];
+  record.formatMessage(message, sizeof(message));
+
+  writeLine(time, CrossplatformThread::getNameCString(), ilevel, message);
+}
+
+void Logger::writeLine(const long itime,
+                       const char *itaskName,
+                       const LogLevel ilevel,
+                       const char *imessage) noexcept {
+  if (buffer) {
+    // Only copy the line, so a flush of the buffer never delays the task which logs
+    char header[LogRecord::maxTaskNameLength + 48];
+    const int length =
+      snprintf(header, sizeof(header), "%ld (%s) %s: ", itime, itaskName, getLevelName(ilevel));
+    const auto headerLength =
+      std::min(static_cast<std::size_t>(std::max(length, 0)), sizeof(header) - 1);
+
+    bool shouldFlush;
+    buffer->append({std::string_view(header, headerLength), imessage, "\n"}, shouldFlush);
+    if (shouldFlush && flushTask) {
+      flushTask->notify();
+    }
+    return;
+  }
+
+  std::scoped_lock lock(logfileMutex);
+  fprintf(logfile, "%ld (%s) %s: %s\n", itime, itaskName, getLevelName(ilevel), imessage);
+}
+
+void Logger::stopAsync() noexcept {
+  if (!drainTask) {
+    return;
+  }
+
+  // Let the drain task write the queued records so it is never stopped in the middle of a write
+  stopDraining.store(true, std::memory_order_release);
+  drainTask->notify();
+#ifndef THREADS_STD
+  while (!drainStopped.load(std::memory_order_acquire)) {
+    pros::c::delay(1);
+  }
+#endif
+
+  delete drainTask;
+  drainTask = nullptr;
+}
+
+void Logger::stopBuffered() noexcept {
+  if (!flushTask) {
+    return;
+  }
+
+  stopFlushing.store(true, std::memory_order_release);
+  flushTask->notify();
+#ifndef THREADS_STD
+  while (!flushStopped.load(std::memory_order_acquire)) {
+    pros::c::delay(1);
+  }
+#endif
+
+  delete flushTask;
+  flushTask = nullptr;
+}
+
+void Logger::drainTrampoline(void *context) {
+  if (context) {
+    static_cast<Logger *>(context)->drainLoop();
+  }
+}
+
+void Logger::drainLoop() {
+  LogRecord record;
+  char message[LogRecord::maxFormattedLength + 1];
+  while (true) {
+    const bool stopping = stopDraining.load(std::memory_order_acquire);
+
+    bool wroteRecords = false;
+    while (asyncQueue->tryPop(record)) {
+      record.formatMessage(message, sizeof(message));
+      writeLine(record.time, record.taskName, static_cast<LogLevel>(record.level), message);
+      wroteRecords = true;
+    }
+
+    // The flush task of a buffered logger flushes the log file
+    if (wroteRecords && !buffer) {
+      fflush(logfile);
+    }
+
+    if (stopping) {
+      break;
+    }
+
+    CrossplatformThread::notifyTake(drainLoopTimeout);
+  }
+
+  drainStopped.store(true, std::memory_order_release);
+}
+
+void Logger::flushTrampoline(void *context) {
+  if (context) {
+    static_cast<Logger *>(context)->flushLoop();
+  }
+}
+
+void Logger::flushLoop() {
+  while (true) {
+    const bool stopping = stopFlushing.load(std::memory_order_acquire);
+    flush();
+    if (stopping) {
+      break;
+    }
+
+    CrossplatformThread::notifyTake(flushPeriod);
+  }
+
+  flushStopped.store(true, std::memory_order_release);
+}
+
+const char *Logger::getLevelName(const LogLevel ilevel) noexcept {
+  switch (ilevel) {
+  case LogLevel::debug:
+    return "DEBUG";
+  case LogLevel::info:
+    return "INFO";
+  case LogLevel::warn:
+    return "WARN";
+  case LogLevel::error:
+    return "ERROR";
+  default:
+    return "OFF";
+  }
+}
+
 std::shared_ptr<Logger> Logger::getDefaultLogger() {
+  std::scoped_lock lock(getDefaultLoggerMutex());
+  if (!defaultLogger) {
+    defaultLogger = makeDefaultLogger();
+  }
   return defaultLogger;
 }
 
 void Logger::setDefaultLogger(std::shared_ptr<Logger> ilogger) {
+  std::scoped_lock lock(getDefaultLoggerMutex());
   defaultLogger = std::move(ilogger);
 }
 
+std::shared_ptr<Logger> Logger::makeDefaultLogger() {
+#if defined(THREADS_STD)
+  return std::make_shared<Logger>();
+#else
+  return std::make_shared<Logger>(std::make_unique<Timer>(), "/ser/sout", LogLevel::warn);
+#endif
+}
+
 bool Logger::isSerialStream(std::string_view filename) {
   return filename.find("/ser/") != std::string::npos;
 }
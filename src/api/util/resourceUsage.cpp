@@ -0,0 +1,127 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#include "okapi/api/util/resourceUsage.hpp"
+#include "okapi/api/util/logging.hpp"
+#include <string>
+#include <utility>
+
+namespace okapi {
+std::array<std::atomic_size_t, ResourceUsage::subsystemCount> ResourceUsage::bytes{};
+std::array<std::atomic_size_t, ResourceUsage::subsystemCount> ResourceUsage::peakBytes{};
+
+void ResourceUsage::allocated(const HeapSubsystem isubsystem, const std::size_t ibytes) {
+  const auto index = static_cast<std::size_t>(isubsystem);
+  const std::size_t now = bytes[index].fetch_add(ibytes) + ibytes;
+
+  std::size_t peak = peakBytes[index].load();
+  while (now > peak && !peakBytes[index].compare_exchange_weak(peak, now)) {
+  }
+}
+
+void ResourceUsage::freed(const HeapSubsystem isubsystem, const std::size_t ibytes) {
+  bytes[static_cast<std::size_t>(isubsystem)].fetch_sub(ibytes);
+}
+
+HeapUsage ResourceUsage::getHeapUsage(const HeapSubsystem isubsystem) {
+  const auto index = static_cast<std::size_t>(isubsystem);
+  return {bytes[index].load(), peakBytes[index].load()};
+}
+
+void ResourceUsage::resetPeaks() {
+  for (std::size_t i = 0; i < subsystemCount; i++) {
+    peakBytes[i].store(bytes[i].load());
+  }
+}
+
+std::size_t ResourceUsage::getTaskStats(
+  std::array<CrossplatformThreadStats, CrossplatformThread::maxTrackedThreads> &ostats) {
+  return CrossplatformThread::getStats(ostats);
+}
+
+void ResourceUsage::logReport(const std::shared_ptr<Logger> &ilogger) {
+  const auto &logger = ilogger;
+
+  for (std::size_t i = 0; i < subsystemCount; i++) {
+    const auto subsystem = static_cast<HeapSubsystem>(i);
+    const HeapUsage usage = getHeapUsage(subsystem);
+    LOG_INFO("ResourceUsage: Heap of " + std::string(getName(subsystem)) + ": " +
+             std::to_string(usage.bytes) + " bytes, peak " + std::to_string(usage.peakBytes) +
+             " bytes");
+  }
+
+  std::array<CrossplatformThreadStats, CrossplatformThread::maxTrackedThreads> tasks{};
+  const std::size_t taskCount = getTaskStats(tasks);
+  for (std::size_t i = 0; i < taskCount; i++) {
+    const auto &task = tasks[i];
+    const std::string highWaterMark = task.stackHighWaterMark < 0
+                                        ? std::string("unknown")
+                                        : std::to_string(task.stackHighWaterMark) + " words";
+    LOG_INFO("ResourceUsage: Stack of " + std::string(task.name) + ": depth " +
+             std::to_string(task.stackDepth) + " words, least free " + highWaterMark);
+  }
+}
+
+const char *ResourceUsage::getName(const HeapSubsystem isubsystem) {
+  switch (isubsystem) {
+  case HeapSubsystem::paths:
+    return "paths";
+  case HeapSubsystem::logging:
+    return "logging";
+  case HeapSubsystem::filters:
+    return "filters";
+  }
+  return "unknown";
+}
+
+HeapAttribution::HeapAttribution(const HeapSubsystem isubsystem, const std::size_t ibytes)
+  : subsystem(isubsystem), bytes(ibytes) {
+  ResourceUsage::allocated(subsystem, bytes);
+}
+
+HeapAttribution::HeapAttribution(const HeapAttribution &iother)
+  : HeapAttribution(iother.subsystem, iother.bytes) {
+}
+
+HeapAttribution::HeapAttribution(HeapAttribution &&iother) noexcept
+  : subsystem(iother.subsystem), bytes(std::exchange(iother.bytes, 0)) {
+}
+
+HeapAttribution &HeapAttribution::operator=(const HeapAttribution &iother) {
+  if (this != &iother) {
+    ResourceUsage::freed(subsystem, bytes);
+    subsystem = iother.subsystem;
+    bytes = iother.bytes;
+    ResourceUsage::allocated(subsystem, bytes);
+  }
+  return *this;
+}
+
+HeapAttribution &HeapAttribution::operator=(HeapAttribution &&iother) noexcept {
+  if (this != &iother) {
+    ResourceUsage::freed(subsystem, bytes);
+    subsystem = iother.subsystem;
+    bytes = std::exchange(iother.bytes, 0);
+  }
+  return *this;
+}
+
+HeapAttribution::~HeapAttribution() {
+  ResourceUsage::freed(subsystem, bytes);
+}
+
+void HeapAttribution::setBytes(const std::size_t ibytes) {
+  if (ibytes > bytes) {
+    ResourceUsage::allocated(subsystem, ibytes - bytes);
+  } else {
+    ResourceUsage::freed(subsystem, bytes - ibytes);
+  }
+  bytes = ibytes;
+}
+
+std::size_t HeapAttribution::getBytes() const {
+  return bytes;
+}
+} // namespace okapi
@@ -0,0 +1,371 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#include "okapi/api/util/serialLink.hpp"
+#include <algorithm>
+#include <mutex>
+
+namespace okapi {
+SerialLink::SerialLink(std::shared_ptr<AbstractSerialPort> iport,
+                       const TimeUtil &itimeUtil,
+                       std::shared_ptr<Logger> ilogger)
+  : logger(std::move(ilogger)),
+    port(std::move(iport)),
+    timeUtil(itimeUtil),
+    txTimer(timeUtil.getTimer()),
+    txRate(timeUtil.getRate()) {
+}
+
+SerialLink::~SerialLink() {
+  if (task) {
+    // Let the link task finish its frame so it is never stopped holding a mutex
+    stopLink.store(true, std::memory_order_release);
+    task->notify();
+#ifndef THREADS_STD
+    while (!linkStopped.load(std::memory_order_acquire)) {
+      pros::c::delay(1);
+    }
+#endif
+    delete task;
+  }
+}
+
+bool SerialLink::send(const std::uint8_t itype,
+                      const std::uint8_t *ipayload,
+                      const std::size_t ilength) {
+  if (ilength > maxPayloadSize) {
+    LOG_ERROR("SerialLink: A message of " + std::to_string(ilength) +
+              " bytes is longer than one frame.");
+    return false;
+  }
+
+  std::scoped_lock lock(txMutex);
+  return writeFrame(itype, 0, 0, ipayload, ilength);
+}
+
+std::optional<std::vector<std::uint8_t>> SerialLink::call(const std::uint8_t itype,
+                                                          const std::uint8_t *ipayload,
+                                                          const std::size_t ilength,
+                                                          const QTime &itimeout) {
+  std::uint8_t sequence;
+  {
+    std::scoped_lock lock(handlerMutex);
+    sequence = nextSequence;
+    nextSequence = nextSequence == 255 ? 1 : nextSequence + 1;
+    pendingCalls[sequence] = PendingCall();
+  }
+
+  if (sendSplit(itype, requestFlag, sequence, ipayload, ilength)) {
+    auto timer = timeUtil.getTimer();
+    auto rate = timeUtil.getRate();
+    timer->placeMark();
+
+    while (true) {
+      if (!task) {
+        step();
+      }
+
+      {
+        std::scoped_lock lock(handlerMutex);
+        auto &pending = pendingCalls[sequence];
+        if (pending.done) {
+          std::optional<std::vector<std::uint8_t>> response;
+          if (pending.failed) {
+            LOG_WARN("SerialLink: The other side failed request type " + std::to_string(itype));
+          } else {
+            response = std::move(pending.payload);
+          }
+
+          pendingCalls.erase(sequence);
+          return response;
+        }
+      }
+
+      if (timer->getDtFromMark() >= itimeout) {
+        LOG_WARN("SerialLink: Request type " + std::to_string(itype) + " timed out.");
+        break;
+      }
+
+      rate->delayUntil(pollPeriod);
+    }
+  }
+
+  std::scoped_lock lock(handlerMutex);
+  pendingCalls.erase(sequence);
+  return std::nullopt;
+}
+
+void SerialLink::onMessage(const std::uint8_t itype, MessageHandler ihandler) {
+  std::scoped_lock lock(handlerMutex);
+  if (ihandler) {
+    messageHandlers[itype] = std::make_shared<MessageHandler>(std::move(ihandler));
+  } else {
+    messageHandlers.erase(itype);
+  }
+}
+
+void SerialLink::onRequest(const std::uint8_t itype, RequestHandler ihandler) {
+  std::scoped_lock lock(handlerMutex);
+  if (ihandler) {
+    requestHandlers[itype] = std::make_shared<RequestHandler>(std::move(ihandler));
+  } else {
+    requestHandlers.erase(itype);
+  }
+}
+
+void SerialLink::step() {
+  std::array<std::uint8_t, 64> chunk;
+  std::scoped_lock lock(rxMutex);
+
+  while (true) {
+    const std::size_t count = port->read(chunk.data(), chunk.size());
+
+    for (std::size_t i = 0; i < count; i++) {
+      if (chunk[i] == 0) {
+        if (rxOverflowed) {
+          corruptCount.fetch_add(1, std::memory_order_relaxed);
+        } else if (rxLength > 0) {
+          handleFrame();
+        }
+
+        rxLength = 0;
+        rxOverflowed = false;
+      } else if (rxLength < rxBuffer.size()) {
+        rxBuffer[rxLength++] = chunk[i];
+      } else {
+        rxOverflowed = true;
+      }
+    }
+
+    if (count < chunk.size()) {
+      return;
+    }
+  }
+}
+
+std::uint32_t SerialLink::getReceivedCount() const {
+  return receivedCount.load(std::memory_order_relaxed);
+}
+
+std::uint32_t SerialLink::getCorruptCount() const {
+  return corruptCount.load(std::memory_order_relaxed);
+}
+
+void SerialLink::startThread(const std::uint32_t ipriority, const std::uint16_t istackDepth) {
+  if (!task) {
+    task = new CrossplatformThread(trampoline, this, "SerialLink", ipriority, istackDepth);
+  }
+}
+
+CrossplatformThread *SerialLink::getThread() const {
+  return task;
+}
+
+std::uint16_t SerialLink::crc16(const std::uint8_t *idata, const std::size_t ilength) {
+  std::uint16_t crc = 0xFFFF;
+  for (std::size_t i = 0; i < ilength; i++) {
+    crc ^= static_cast<std::uint16_t>(idata[i] << 8);
+    for (int bit = 0; bit < 8; bit++) {
+      crc = (crc & 0x8000) ? static_cast<std::uint16_t>((crc << 1) ^ 0x1021)
+                           : static_cast<std::uint16_t>(crc << 1);
+    }
+  }
+
+  return crc;
+}
+
+void SerialLink::trampoline(void *context) {
+  if (context) {
+    static_cast<SerialLink *>(context)->loop();
+  }
+}
+
+void SerialLink::loop() {
+  LOG_INFO_S("Started SerialLink task.");
+
+  auto rate = timeUtil.getRate();
+  while (!stopLink.load(std::memory_order_acquire)) {
+    step();
+    rate->delayUntil(pollPeriod);
+  }
+
+  LOG_INFO_S("Stopped SerialLink task.");
+  linkStopped.store(true, std::memory_order_release);
+}
+
+bool SerialLink::sendSplit(const std::uint8_t itype,
+                           const std::uint8_t iflags,
+                           const std::uint8_t isequence,
+                           const std::uint8_t *ipayload,
+                           const std::size_t ilength) {
+  std::scoped_lock lock(txMutex);
+
+  // An empty payload is still sent as one frame
+  std::size_t offset = 0;
+  do {
+    const std::size_t length = std::min(maxPayloadSize, ilength - offset);
+    const bool more = offset + length < ilength;
+    const std::uint8_t flags = more ? iflags | moreFlag : iflags;
+    if (!writeFrame(itype, flags, isequence, ipayload + offset, length)) {
+      return false;
+    }
+
+    offset += length;
+  } while (offset < ilength);
+
+  return true;
+}
+
+bool SerialLink::writeFrame(const std::uint8_t itype,
+                            const std::uint8_t iflags,
+                            const std::uint8_t isequence,
+                            const std::uint8_t *ipayload,
+                            const std::size_t ilength) {
+  txFrame[0] = itype;
+  txFrame[1] = iflags;
+  txFrame[2] = isequence;
+  std::copy(ipayload, ipayload + ilength, txFrame.begin() + headerSize);
+
+  std::size_t frameLength = headerSize + ilength;
+  const std::uint16_t crc = crc16(txFrame.data(), frameLength);
+  txFrame[frameLength++] = static_cast<std::uint8_t>(crc & 0xFF);
+  txFrame[frameLength++] = static_cast<std::uint8_t>(crc >> 8);
+
+  std::size_t encodedLength = Cobs::encode(txFrame.data(), frameLength, txEncoded.data());
+  txEncoded[encodedLength++] = 0;
+
+  // Wait for room in the transmit buffer instead of dropping the rest of the frame
+  std::size_t written = 0;
+  txTimer->placeMark();
+  while (true) {
+    written += port->write(txEncoded.data() + written, encodedLength - written);
+    if (written >= encodedLength) {
+      return true;
+    }
+
+    if (txTimer->getDtFromMark() >= writeTimeout) {
+      LOG_WARN("SerialLink: Dropped a frame of type " + std::to_string(itype) +
+               " because the port is not sending.");
+      return false;
+    }
+
+    txRate->delayUntil(1_ms);
+  }
+}
+
+void SerialLink::handleFrame() {
+  // Decoding never writes past the byte it reads, so the frame is decoded in place
+  std::size_t length = 0;
+  if (!Cobs::decode(rxBuffer.data(), rxLength, rxBuffer.data(), length) ||
+      length < headerSize + checksumSize || length > maxFrameSize) {
+    corruptCount.fetch_add(1, std::memory_order_relaxed);
+    return;
+  }
+
+  const std::uint16_t checksum = static_cast<std::uint16_t>(
+    rxBuffer[length - 2] | static_cast<std::uint16_t>(rxBuffer[length - 1] << 8));
+  if (crc16(rxBuffer.data(), length - checksumSize) != checksum) {
+    corruptCount.fetch_add(1, std::memory_order_relaxed);
+    return;
+  }
+
+  receivedCount.fetch_add(1, std::memory_order_relaxed);
+
+  const std::uint8_t type = rxBuffer[0];
+  const std::uint8_t flags = rxBuffer[1];
+  const std::uint8_t sequence = rxBuffer[2];
+  const std::uint8_t *payload = rxBuffer.data() + headerSize;
+  const std::size_t payloadLength = length - headerSize - checksumSize;
+
+  if (flags & responseFlag) {
+    std::scoped_lock lock(handlerMutex);
+    auto pending = pendingCalls.find(sequence);
+    if (pending == pendingCalls.end() || pending->second.done) {
+      // The call timed out
+      return;
+    }
+
+    PendingCall &call = pending->second;
+    if (call.payload.size() + payloadLength > maxSplitPayloadSize) {
+      LOG_WARN_S("SerialLink: Dropped a response which is too long.");
+      call.failed = true;
+      call.done = true;
+      return;
+    }
+
+    call.payload.insert(call.payload.end(), payload, payload + payloadLength);
+    call.failed = call.failed || (flags & errorFlag);
+    call.done = !(flags & moreFlag);
+    return;
+  }
+
+  if (flags & requestFlag) {
+    auto partial = partialRequests.find(sequence);
+    if (partial == partialRequests.end()) {
+      if (flags & moreFlag) {
+        partialRequests[sequence].assign(payload, payload + payloadLength);
+      } else {
+        handleRequest(type, sequence, payload, payloadLength);
+      }
+      return;
+    }
+
+    std::vector<std::uint8_t> &request = partial->second;
+    if (request.size() + payloadLength > maxSplitPayloadSize) {
+      LOG_WARN_S("SerialLink: Dropped a request which is too long.");
+      partialRequests.erase(partial);
+      return;
+    }
+
+    request.insert(request.end(), payload, payload + payloadLength);
+    if (!(flags & moreFlag)) {
+      const std::vector<std::uint8_t> whole = std::move(request);
+      partialRequests.erase(partial);
+      handleRequest(type, sequence, whole.data(), whole.size());
+    }
+    return;
+  }
+
+  std::shared_ptr<MessageHandler> handler;
+  {
+    std::scoped_lock lock(handlerMutex);
+    auto it = messageHandlers.find(type);
+    if (it != messageHandlers.end()) {
+      handler = it->second;
+    }
+  }
+
+  if (handler) {
+    (*handler)(payload, payloadLength);
+  }
+}
+
+void SerialLink::handleRequest(const std::uint8_t itype,
+                               const std::uint8_t isequence,
+                               const std::uint8_t *ipayload,
+                               const std::size_t ilength) {
+  std::shared_ptr<RequestHandler> handler;
+  {
+    std::scoped_lock lock(handlerMutex);
+    auto it = requestHandlers.find(itype);
+    if (it != requestHandlers.end()) {
+      handler = it->second;
+    }
+  }
+
+  std::optional<std::vector<std::uint8_t>> response;
+  if (handler) {
+    response = (*handler)(ipayload, ilength);
+  } else {
+    LOG_WARN("SerialLink: No handler for request type " + std::to_string(itype));
+  }
+
+  if (response) {
+    sendSplit(itype, responseFlag, isequence, response->data(), response->size());
+  } else {
+    sendSplit(itype, responseFlag | errorFlag, isequence, nullptr, 0);
+  }
+}
+} // namespace okapi
@@ -0,0 +1,149 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#include "okapi/api/util/taskProfiler.hpp"
+#include "okapi/api/util/logging.hpp"
+#include <cstdio>
+#include <string>
+#include <utility>
+
+namespace okapi {
+double TaskProfileStats::getUtilization() const {
+  const std::uint64_t total = busyMicros + sleepMicros;
+  if (total == 0) {
+    return 0;
+  }
+
+  return static_cast<double>(busyMicros) / static_cast<double>(total);
+}
+
+void TaskProfiler::Profile::clear() {
+  loops.store(0, std::memory_order_relaxed);
+  busyMicros.store(0, std::memory_order_relaxed);
+  sleepMicros.store(0, std::memory_order_relaxed);
+  maxBusyMicros.store(0, std::memory_order_relaxed);
+}
+
+TaskProfiler::Registry &TaskProfiler::getRegistry() {
+  static Registry registry;
+  return registry;
+}
+
+TaskProfiler::Profile *TaskProfiler::acquire(const char *iname) {
+  Registry &registry = getRegistry();
+  std::scoped_lock lock(registry.mutex);
+  for (auto &profile : registry.profiles) {
+    if (!profile.inUse) {
+      profile.inUse = true;
+      std::snprintf(profile.name, sizeof(profile.name), "%s", iname ? iname : "");
+      profile.clear();
+      return &profile;
+    }
+  }
+  return nullptr;
+}
+
+void TaskProfiler::release(Profile *iprofile) {
+  Registry &registry = getRegistry();
+  std::scoped_lock lock(registry.mutex);
+  iprofile->inUse = false;
+}
+
+std::size_t TaskProfiler::getStats(std::array<TaskProfileStats, maxProfiles> &ostats) {
+  Registry &registry = getRegistry();
+  std::scoped_lock lock(registry.mutex);
+
+  std::size_t count = 0;
+  for (const auto &profile : registry.profiles) {
+    if (profile.inUse) {
+      TaskProfileStats &stats = ostats[count++];
+      std::snprintf(stats.name, sizeof(stats.name), "%s", profile.name);
+      stats.loops = profile.loops.load(std::memory_order_relaxed);
+      stats.busyMicros = profile.busyMicros.load(std::memory_order_relaxed);
+      stats.sleepMicros = profile.sleepMicros.load(std::memory_order_relaxed);
+      stats.maxBusyMicros = profile.maxBusyMicros.load(std::memory_order_relaxed);
+    }
+  }
+  return count;
+}
+
+void TaskProfiler::resetStats() {
+  Registry &registry = getRegistry();
+  std::scoped_lock lock(registry.mutex);
+  for (auto &profile : registry.profiles) {
+    profile.clear();
+  }
+}
+
+void TaskProfiler::logReport(const std::shared_ptr<Logger> &ilogger) {
+  const auto &logger = ilogger;
+
+  std::array<TaskProfileStats, maxProfiles> stats{};
+  const std::size_t count = getStats(stats);
+  for (std::size_t i = 0; i < count; i++) {
+    const auto &task = stats[i];
+    LOG_INFO("TaskProfiler: " + std::string(task.name) + ": busy " +
+             std::to_string(task.getUtilization() * 100) + "% over " + std::to_string(task.loops) +
+             " loops, longest loop " + std::to_string(task.maxBusyMicros) + " us");
+  }
+}
+
+ProfiledRate::ProfiledRate(std::unique_ptr<AbstractRate> irate, const char *iname)
+  : rate(std::move(irate)), profile(TaskProfiler::acquire(iname)) {
+}
+
+ProfiledRate::~ProfiledRate() {
+  if (profile) {
+    TaskProfiler::release(profile);
+  }
+}
+
+void ProfiledRate::delay(const QFrequency ihz) {
+  const std::uint64_t start = beginDelay();
+  rate->delay(ihz);
+  endDelay(start);
+}
+
+void ProfiledRate::delayUntil(const QTime itime) {
+  const std::uint64_t start = beginDelay();
+  rate->delayUntil(itime);
+  endDelay(start);
+}
+
+void ProfiledRate::delayUntil(const uint32_t ims) {
+  const std::uint64_t start = beginDelay();
+  rate->delayUntil(ims);
+  endDelay(start);
+}
+
+void ProfiledRate::reset() {
+  lastWake = 0;
+  rate->reset();
+}
+
+std::uint64_t ProfiledRate::beginDelay() {
+  const std::uint64_t now = CrossplatformClock::micros();
+  if (profile && lastWake != 0) {
+    const std::uint64_t busy = now - lastWake;
+    profile->busyMicros.store(profile->busyMicros.load(std::memory_order_relaxed) + busy,
+                              std::memory_order_relaxed);
+    profile->loops.store(profile->loops.load(std::memory_order_relaxed) + 1,
+                         std::memory_order_relaxed);
+    if (busy > profile->maxBusyMicros.load(std::memory_order_relaxed)) {
+      profile->maxBusyMicros.store(busy, std::memory_order_relaxed);
+    }
+  }
+  return now;
+}
+
+void ProfiledRate::endDelay(const std::uint64_t istart) {
+  lastWake = CrossplatformClock::micros();
+  if (profile) {
+    profile->sleepMicros.store(profile->sleepMicros.load(std::memory_order_relaxed) +
+                                 (lastWake - istart),
+                               std::memory_order_relaxed);
+  }
+}
+} // namespace okapi
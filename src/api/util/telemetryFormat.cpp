@@ -0,0 +1,143 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#include "okapi/api/util/telemetryFormat.hpp"
+#include <algorithm>
+#include <cstring>
+
+namespace okapi {
+static constexpr char telemetryMagic[4] = {'O', 'K', 'T', 'L'};
+
+template <typename T> static void writeField(std::uint8_t *&iout, const T ivalue) {
+  std::memcpy(iout, &ivalue, sizeof(T));
+  iout += sizeof(T);
+}
+
+template <typename T> static T readField(const std::uint8_t *iin) {
+  T value;
+  std::memcpy(&value, iin, sizeof(T));
+  return value;
+}
+
+static void writeName(std::vector<std::uint8_t> &obuffer, const std::string &iname) {
+  const std::size_t length = std::min(iname.size(), TelemetryFormat::maxNameLength);
+  obuffer.push_back(static_cast<std::uint8_t>(length));
+  obuffer.insert(obuffer.end(), iname.begin(), iname.begin() + length);
+}
+
+static bool readName(std::istream &istream, std::string &oname) {
+  const int length = istream.get();
+  if (length == std::istream::traits_type::eof()) {
+    return false;
+  }
+
+  oname.resize(static_cast<std::size_t>(length));
+  istream.read(oname.data(), length);
+  return istream.gcount() == length;
+}
+
+void TelemetryFormat::writeHeader(std::uint8_t *obuffer) {
+  std::memcpy(obuffer, telemetryMagic, sizeof(telemetryMagic));
+  obuffer += sizeof(telemetryMagic);
+  writeField<std::uint16_t>(obuffer, version);
+  writeField<std::uint16_t>(obuffer, 0);
+}
+
+void TelemetryFormat::writeSample(std::uint8_t *obuffer,
+                                  const std::uint32_t itime,
+                                  const std::uint16_t ichannel,
+                                  const double *ivalues,
+                                  const std::size_t ivalueCount) {
+  writeField<std::uint8_t>(obuffer, sampleTag);
+  writeField<std::uint8_t>(obuffer, static_cast<std::uint8_t>(ivalueCount));
+  writeField<std::uint16_t>(obuffer, ichannel);
+  writeField<std::uint32_t>(obuffer, itime);
+  for (std::size_t i = 0; i < ivalueCount; i++) {
+    writeField<float>(obuffer, static_cast<float>(ivalues[i]));
+  }
+}
+
+std::vector<std::uint8_t> TelemetryFormat::encodeChannel(const Channel &ichannel) {
+  const std::size_t fieldCount = std::min(ichannel.fieldNames.size(), maxFields);
+
+  std::vector<std::uint8_t> buffer(4);
+  std::uint8_t *out = buffer.data();
+  writeField<std::uint8_t>(out, channelTag);
+  writeField<std::uint8_t>(out, static_cast<std::uint8_t>(fieldCount));
+  writeField<std::uint16_t>(out, ichannel.id);
+
+  writeName(buffer, ichannel.name);
+  for (std::size_t i = 0; i < fieldCount; i++) {
+    writeName(buffer, ichannel.fieldNames[i]);
+  }
+
+  return buffer;
+}
+
+bool TelemetryFormat::decode(std::istream &istream,
+                             const std::function<void(const Channel &)> &ionChannel,
+                             const std::function<void(const Sample &)> &ionSample) {
+  std::uint8_t header[headerSize];
+  istream.read(reinterpret_cast<char *>(header), headerSize);
+  if (istream.gcount() != static_cast<std::streamsize>(headerSize) ||
+      std::memcmp(header, telemetryMagic, sizeof(telemetryMagic)) != 0 ||
+      readField<std::uint16_t>(header + sizeof(telemetryMagic)) != version) {
+    return false;
+  }
+
+  Channel channel;
+  Sample sample;
+  std::vector<float> values;
+  while (true) {
+    // Both record types start with the tag, a count, and the channel id
+    std::uint8_t start[4];
+    istream.read(reinterpret_cast<char *>(start), sizeof(start));
+    if (istream.gcount() == 0) {
+      return true;
+    }
+    if (istream.gcount() != sizeof(start)) {
+      return false;
+    }
+
+    const std::uint8_t count = start[1];
+    const auto id = readField<std::uint16_t>(start + 2);
+
+    if (start[0] == channelTag) {
+      channel.id = id;
+      channel.fieldNames.resize(count);
+      if (!readName(istream, channel.name)) {
+        return false;
+      }
+      for (auto &fieldName : channel.fieldNames) {
+        if (!readName(istream, fieldName)) {
+          return false;
+        }
+      }
+
+      ionChannel(channel);
+    } else if (start[0] == sampleTag) {
+      std::uint8_t time[4];
+      istream.read(reinterpret_cast<char *>(time), sizeof(time));
+      if (istream.gcount() != sizeof(time)) {
+        return false;
+      }
+
+      values.resize(count);
+      const auto valuesSize = static_cast<std::streamsize>(count * sizeof(float));
+      istream.read(reinterpret_cast<char *>(values.data()), valuesSize);
+      if (istream.gcount() != valuesSize) {
+        return false;
+      }
+
+      sample.time = readField<std::uint32_t>(time);
+      sample.channel = id;
+      sample.values.assign(values.begin(), values.end());
+      ionSample(sample);
+    } else {
+      return false;
+    }
+  }
+}
+} // namespace okapi
@@ -0,0 +1,201 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#include "okapi/api/util/telemetryLogger.hpp"
+#include <algorithm>
+#include <mutex>
+#include <stdexcept>
+
+namespace okapi {
+TelemetryLogger::TelemetryLogger(std::unique_ptr<AbstractTimer> itimer,
+                                 std::string_view ifileName,
+                                 const std::size_t ibufferSize,
+                                 std::shared_ptr<Logger> ilogger)
+  : TelemetryLogger(std::move(itimer),
+                    fopen(std::string(ifileName).c_str(), "wb"),
+                    ibufferSize,
+                    std::move(ilogger)) {
+}
+
+TelemetryLogger::TelemetryLogger(std::unique_ptr<AbstractTimer> itimer,
+                                 FILE *ifile,
+                                 const std::size_t ibufferSize,
+                                 std::shared_ptr<Logger> ilogger)
+  : logger(std::move(ilogger)),
+    timer(std::move(itimer)),
+    file(ifile),
+    bufferSize(std::max(ibufferSize, TelemetryFormat::getSampleSize(TelemetryFormat::maxFields))) {
+  if (!file) {
+    LOG_ERROR_S("TelemetryLogger: Couldn't open the telemetry file.");
+    return;
+  }
+
+  // Reserve both buffers now so recording never allocates
+  frontBuffer.reserve(bufferSize);
+  backBuffer.reserve(bufferSize);
+  frontBuffer.resize(TelemetryFormat::headerSize);
+  TelemetryFormat::writeHeader(frontBuffer.data());
+
+  task = new CrossplatformThread(trampoline, this, "TelemetryLogger", TASK_PRIORITY_MIN);
+}
+
+TelemetryLogger::~TelemetryLogger() {
+  if (task) {
+    // Let the writer task write the buffered samples so it is never stopped in the middle of a
+    // write
+    stopWriting.store(true, std::memory_order_release);
+    task->notify();
+#ifndef THREADS_STD
+    while (!writerStopped.load(std::memory_order_acquire)) {
+      pros::c::delay(1);
+    }
+#endif
+    delete task;
+  }
+
+  if (file) {
+    fclose(file);
+  }
+}
+
+std::uint16_t TelemetryLogger::addChannel(const std::string &iname,
+                                          const std::vector<std::string> &ifieldNames) {
+  if (ifieldNames.size() > TelemetryFormat::maxFields) {
+    std::string msg("TelemetryLogger: A channel can have at most " +
+                    std::to_string(TelemetryFormat::maxFields) + " fields.");
+    LOG_ERROR(msg);
+    throw std::invalid_argument(msg);
+  }
+
+  std::scoped_lock lock(bufferMutex);
+  const auto id = static_cast<std::uint16_t>(channelFieldCounts.size());
+  channelFieldCounts.push_back(static_cast<std::uint16_t>(ifieldNames.size()));
+
+  // Channel records are never dropped. If they don't fit, the front buffer grows past its size.
+  const auto channelRecord = TelemetryFormat::encodeChannel({id, iname, ifieldNames});
+  frontBuffer.insert(frontBuffer.end(), channelRecord.begin(), channelRecord.end());
+
+  LOG_INFO("TelemetryLogger: Added channel " + iname + " with id " + std::to_string(id));
+  return id;
+}
+
+bool TelemetryLogger::record(const std::uint16_t ichannel,
+                             const std::initializer_list<double> ivalues) {
+  return record(ichannel, ivalues.begin(), ivalues.size());
+}
+
+bool TelemetryLogger::record(const std::uint16_t ichannel,
+                             const double *ivalues,
+                             const std::size_t icount) {
+  if (!file) {
+    return false;
+  }
+
+  const auto time = static_cast<std::uint32_t>(timer->millis().convert(millisecond));
+  const std::size_t size = TelemetryFormat::getSampleSize(icount);
+
+  std::scoped_lock lock(bufferMutex);
+  if (ichannel >= channelFieldCounts.size() || icount != channelFieldCounts[ichannel]) {
+    LOG_WARN_F("TelemetryLogger: Sample for channel %u does not match the channel.", ichannel);
+    return false;
+  }
+
+  if (frontBuffer.size() + size > bufferSize) {
+    if (!swapBuffers()) {
+      droppedCount.fetch_add(1, std::memory_order_relaxed);
+      return false;
+    }
+
+    task->notify();
+  }
+
+  const std::size_t offset = frontBuffer.size();
+  frontBuffer.resize(offset + size);
+  TelemetryFormat::writeSample(
+    frontBuffer.data() + offset, time, ichannel, ivalues, icount);
+  return true;
+}
+
+void TelemetryLogger::flush() {
+  if (!task) {
+    return;
+  }
+
+  auto generation = writtenEvent.getGeneration();
+  while (true) {
+    {
+      std::scoped_lock lock(bufferMutex);
+      if (frontBuffer.empty() && !backBufferFull) {
+        return;
+      }
+    }
+
+    task->notify();
+    writtenEvent.waitFor(generation, writeLoopTimeout);
+    generation = writtenEvent.getGeneration();
+  }
+}
+
+std::uint32_t TelemetryLogger::getDroppedCount() const {
+  return droppedCount.load(std::memory_order_relaxed);
+}
+
+bool TelemetryLogger::isOpen() const {
+  return file != nullptr;
+}
+
+void TelemetryLogger::trampoline(void *context) {
+  if (context) {
+    static_cast<TelemetryLogger *>(context)->writeLoop();
+  }
+}
+
+void TelemetryLogger::writeLoop() {
+  while (true) {
+    const bool stopping = stopWriting.load(std::memory_order_acquire);
+
+    bool hasBuffer;
+    {
+      std::scoped_lock lock(bufferMutex);
+      swapBuffers();
+      hasBuffer = backBufferFull;
+    }
+
+    if (hasBuffer) {
+      // Producers don't touch the back buffer while it is full, so write it without the mutex
+      fwrite(backBuffer.data(), 1, backBuffer.size(), file);
+      fflush(file);
+
+      {
+        std::scoped_lock lock(bufferMutex);
+        backBuffer.clear();
+        backBufferFull = false;
+      }
+      writtenEvent.notifyAll();
+
+      // The front buffer might have filled up while this one was written
+      continue;
+    }
+
+    if (stopping) {
+      break;
+    }
+
+    CrossplatformThread::notifyTake(writeLoopTimeout);
+  }
+
+  writerStopped.store(true, std::memory_order_release);
+}
+
+bool TelemetryLogger::swapBuffers() {
+  if (backBufferFull || frontBuffer.empty()) {
+    return false;
+  }
+
+  std::swap(frontBuffer, backBuffer);
+  backBufferFull = true;
+  return true;
+}
+} // namespace okapi
@@ -0,0 +1,202 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#include "okapi/api/util/telemetryStream.hpp"
+#include "okapi/api/util/cobs.hpp"
+#include <algorithm>
+#include <cstring>
+#include <mutex>
+#include <stdexcept>
+
+namespace okapi {
+template <typename T> static void appendField(std::vector<std::uint8_t> &obuffer, const T ivalue) {
+  std::uint8_t bytes[sizeof(T)];
+  std::memcpy(bytes, &ivalue, sizeof(T));
+  obuffer.insert(obuffer.end(), bytes, bytes + sizeof(T));
+}
+
+TelemetryStream::TelemetryStream(const TimeUtil &itimeUtil,
+                                 std::string_view ifileName,
+                                 const QTime iperiod,
+                                 std::shared_ptr<Logger> ilogger)
+  : TelemetryStream(
+      itimeUtil, fopen(std::string(ifileName).c_str(), "w"), iperiod, std::move(ilogger)) {
+}
+
+TelemetryStream::TelemetryStream(const TimeUtil &itimeUtil,
+                                 FILE *ifile,
+                                 const QTime iperiod,
+                                 std::shared_ptr<Logger> ilogger)
+  : logger(std::move(ilogger)),
+    timer(itimeUtil.getTimer()),
+    rate(itimeUtil.getRate()),
+    file(ifile),
+    period(iperiod) {
+  if (!file) {
+    LOG_ERROR_S("TelemetryStream: Couldn't open the telemetry stream.");
+  }
+}
+
+TelemetryStream::~TelemetryStream() {
+  if (task) {
+    // Let the stream task finish its packet so it is never stopped in the middle of a write
+    stopStreaming.store(true, std::memory_order_release);
+    task->notify();
+#ifndef THREADS_STD
+    while (!streamStopped.load(std::memory_order_acquire)) {
+      pros::c::delay(1);
+    }
+#endif
+    delete task;
+  }
+
+  if (file) {
+    fclose(file);
+  }
+}
+
+std::uint32_t TelemetryStream::addSignal(const std::string &iname,
+                                         std::function<double()> isource) {
+  std::scoped_lock lock(signalMutex);
+  if (signalList.size() >= maxSignals) {
+    std::string msg("TelemetryStream: A stream can have at most " + std::to_string(maxSignals) +
+                    " signals.");
+    LOG_ERROR(msg);
+    throw std::invalid_argument(msg);
+  }
+
+  const std::uint32_t id = nextSignalId++;
+  signalList.push_back({id, iname, std::move(isource)});
+  updateDescriptor();
+
+  LOG_INFO("TelemetryStream: Added signal " + iname);
+  return id;
+}
+
+void TelemetryStream::removeSignal(const std::uint32_t iid) {
+  std::scoped_lock lock(signalMutex);
+  const auto signal = std::find_if(
+    signalList.begin(), signalList.end(), [&](const Signal &isignal) { return isignal.id == iid; });
+  if (signal != signalList.end()) {
+    signalList.erase(signal);
+    updateDescriptor();
+  }
+}
+
+std::size_t TelemetryStream::getSignalCount() {
+  std::scoped_lock lock(signalMutex);
+  return signalList.size();
+}
+
+void TelemetryStream::startThread(const std::uint32_t ipriority, const std::uint16_t istackDepth) {
+  if (!task && file) {
+    task = new CrossplatformThread(trampoline, this, "TelemetryStream", ipriority, istackDepth);
+  }
+}
+
+CrossplatformThread *TelemetryStream::getThread() const {
+  return task;
+}
+
+void TelemetryStream::trampoline(void *context) {
+  if (context) {
+    static_cast<TelemetryStream *>(context)->loop();
+  }
+}
+
+void TelemetryStream::loop() {
+  while (!stopStreaming.load(std::memory_order_acquire)) {
+    step();
+    rate->delayUntil(period);
+  }
+
+  streamStopped.store(true, std::memory_order_release);
+}
+
+void TelemetryStream::step() {
+  const QTime now = timer->millis();
+
+  std::scoped_lock lock(signalMutex);
+  if (descriptorChanged || now - lastDescriptorTime >= descriptorPeriod) {
+    writePacket(descriptorPacket);
+    descriptorChanged = false;
+    lastDescriptorTime = now;
+  }
+
+  // The buffers are reserved when the signals change, so this doesn't allocate
+  samplePacket.clear();
+  samplePacket.push_back(samplePacketType);
+  appendField<std::uint32_t>(samplePacket, static_cast<std::uint32_t>(now.convert(millisecond)));
+  samplePacket.push_back(static_cast<std::uint8_t>(signalList.size()));
+  for (const auto &signal : signalList) {
+    appendField<float>(samplePacket, static_cast<float>(signal.source()));
+  }
+
+  writePacket(samplePacket);
+  fflush(file);
+}
+
+void TelemetryStream::updateDescriptor() {
+  descriptorPacket.clear();
+  descriptorPacket.push_back(descriptorPacketType);
+  descriptorPacket.push_back(static_cast<std::uint8_t>(signalList.size()));
+  for (const auto &signal : signalList) {
+    const std::size_t length = std::min<std::size_t>(signal.name.size(), 255);
+    descriptorPacket.push_back(static_cast<std::uint8_t>(length));
+    descriptorPacket.insert(
+      descriptorPacket.end(), signal.name.begin(), signal.name.begin() + length);
+  }
+
+  // Reserve room for the checksum and the encoding, so streaming doesn't allocate. A sample is
+  // the type, time, count, values, and checksum.
+  const std::size_t sampleSize = 1 + 4 + 1 + signalList.size() * sizeof(float) + 1;
+  descriptorPacket.reserve(descriptorPacket.size() + 1);
+  samplePacket.reserve(sampleSize);
+  encodedPacket.reserve(
+    Cobs::getMaxEncodedSize(std::max(sampleSize, descriptorPacket.size() + 1)) + 1);
+  descriptorChanged = true;
+}
+
+void TelemetryStream::writePacket(std::vector<std::uint8_t> &ipacket) {
+  std::uint8_t checksum = 0;
+  for (const std::uint8_t byte : ipacket) {
+    checksum += byte;
+  }
+
+  ipacket.push_back(checksum);
+  encodedPacket.resize(Cobs::getMaxEncodedSize(ipacket.size()) + 1);
+  std::size_t length = Cobs::encode(ipacket.data(), ipacket.size(), encodedPacket.data());
+  encodedPacket[length++] = 0;
+  ipacket.pop_back();
+
+  fwrite(encodedPacket.data(), 1, length, file);
+}
+
+TelemetryRegistration::~TelemetryRegistration() {
+  clear();
+}
+
+void TelemetryRegistration::add(const std::shared_ptr<TelemetryStream> &istream,
+                                const std::string &iname,
+                                std::function<double()> isource) {
+  if (stream != istream) {
+    clear();
+    stream = istream;
+  }
+
+  ids.push_back(stream->addSignal(iname, std::move(isource)));
+}
+
+void TelemetryRegistration::clear() {
+  if (stream) {
+    for (const auto id : ids) {
+      stream->removeSignal(id);
+    }
+  }
+
+  stream = nullptr;
+  ids.clear();
+}
+} // namespace okapi
@@ -6,8 +6,11 @@
 #include "okapi/impl/chassis/controller/chassisControllerBuilder.hpp"
 #include "okapi/api/chassis/model/threeEncoderSkidSteerModel.hpp"
 #include "okapi/api/chassis/model/threeEncoderXDriveModel.hpp"
+#include "okapi/api/odometry/holonomicOdometry.hpp"
 #include "okapi/api/odometry/threeEncoderOdometry.hpp"
+#include "okapi/impl/device/battery.hpp"
 #include "okapi/impl/util/configurableTimeUtilFactory.hpp"
+#include "okapi/impl/util/microsTimer.hpp"
 #include "okapi/impl/util/rate.hpp"
 #include "okapi/impl/util/timer.hpp"
 #include <stdexcept>
@@ -155,9 +158,12 @@ ChassisControllerBuilder &
 ChassisControllerBuilder::withSensors(const okapi::RotationSensor &ileft,
                                       const okapi::RotationSensor &iright,
                                       const okapi::RotationSensor &imiddle) {
-  return withSensors(std::make_shared<RotationSensor>(ileft),
-                     std::make_shared<RotationSensor>(iright),
-                     std::make_shared<RotationSensor>(imiddle));
+  withSensors(std::make_shared<RotationSensor>(ileft),
+              std::make_shared<RotationSensor>(iright),
+              std::make_shared<RotationSensor>(imiddle));
+  sensorGroup = std::make_shared<RotationSensorGroup>(
+    std::vector<RotationSensor>{ileft, iright, imiddle});
+  return *this;
 }
 
 ChassisControllerBuilder &ChassisControllerBuilder::withSensors(const IntegratedEncoder &ileft,
@@ -181,6 +187,7 @@ ChassisControllerBuilder::withSensors(const std::shared_ptr<ContinuousRotarySens
   sensorsSetByUser = true;
   leftSensor = ileft;
   rightSensor = iright;
+  sensorGroup = nullptr;
   return *this;
 }
 
@@ -192,6 +199,7 @@ ChassisControllerBuilder &ChassisControllerBuilder::withSensors(
   leftSensor = ileft;
   rightSensor = iright;
   middleSensor = imiddle;
+  sensorGroup = nullptr;
   return *this;
 }
 
@@ -212,6 +220,38 @@ ChassisControllerBuilder::withGains(const IterativePosPIDController::Gains &idis
   return *this;
 }
 
+ChassisControllerBuilder &
+ChassisControllerBuilder::withStrafeGains(const IterativePosPIDController::Gains &istrafeGains) {
+  hasStrafeGains = true;
+  strafeGains = istrafeGains;
+  return *this;
+}
+
+ChassisControllerBuilder &
+ChassisControllerBuilder::withProfileLimits(const PathfinderLimits &ilimits,
+                                            const ChassisControllerPID::ProfileShape ishape) {
+  hasProfileLimits = true;
+  profileLimits = ilimits;
+  profileShape = ishape;
+  return *this;
+}
+
+ChassisControllerBuilder &ChassisControllerBuilder::withHeadingSensor(const IMU &iimu) {
+  return withHeadingSensor(std::make_shared<IMU>(iimu));
+}
+
+ChassisControllerBuilder &ChassisControllerBuilder::withHeadingSensor(
+  const std::shared_ptr<ContinuousRotarySensor> &isensor) {
+  if (isensor == nullptr) {
+    std::string msg = "ChassisControllerBuilder: The heading sensor cannot be null.";
+    LOG_ERROR(msg);
+    throw std::runtime_error(msg);
+  }
+
+  headingSensor = isensor;
+  return *this;
+}
+
 ChassisControllerBuilder &
 ChassisControllerBuilder::withDerivativeFilters(std::unique_ptr<Filter> idistanceFilter,
                                                 std::unique_ptr<Filter> iturnFilter,
@@ -224,19 +264,22 @@ ChassisControllerBuilder::withDerivativeFilters(std::unique_ptr<Filter> idistanc
 
 ChassisControllerBuilder &ChassisControllerBuilder::withOdometry(const StateMode &imode,
                                                                  const QLength &imoveThreshold,
-                                                                 const QAngle &iturnThreshold) {
+                                                                 const QAngle &iturnThreshold,
+                                                                 const QTime &iodomLoopPeriod) {
   hasOdom = true;
   odometry = nullptr;
   stateMode = imode;
   moveThreshold = imoveThreshold;
   turnThreshold = iturnThreshold;
+  odomLoopPeriod = iodomLoopPeriod;
   return *this;
 }
 
 ChassisControllerBuilder &ChassisControllerBuilder::withOdometry(const ChassisScales &iodomScales,
                                                                  const StateMode &imode,
                                                                  const QLength &imoveThreshold,
-                                                                 const QAngle &iturnThreshold) {
+                                                                 const QAngle &iturnThreshold,
+                                                                 const QTime &iodomLoopPeriod) {
   hasOdom = true;
   differentOdomScales = true;
   odomScales = iodomScales;
@@ -244,6 +287,7 @@ ChassisControllerBuilder &ChassisControllerBuilder::withOdometry(const ChassisSc
   stateMode = imode;
   moveThreshold = imoveThreshold;
   turnThreshold = iturnThreshold;
+  odomLoopPeriod = iodomLoopPeriod;
   return *this;
 }
 
@@ -251,7 +295,8 @@ ChassisControllerBuilder &
 ChassisControllerBuilder::withOdometry(std::shared_ptr<Odometry> iodometry,
                                        const StateMode &imode,
                                        const QLength &imoveThreshold,
-                                       const QAngle &iturnThreshold) {
+                                       const QAngle &iturnThreshold,
+                                       const QTime &iodomLoopPeriod) {
   if (iodometry == nullptr) {
     std::string msg = "ChassisControllerBuilder: Odometry cannot be null.";
     LOG_ERROR(msg);
@@ -263,6 +308,7 @@ ChassisControllerBuilder::withOdometry(std::shared_ptr<Odometry> iodometry,
   stateMode = imode;
   moveThreshold = imoveThreshold;
   turnThreshold = iturnThreshold;
+  odomLoopPeriod = iodomLoopPeriod;
   return *this;
 }
 
@@ -294,6 +340,27 @@ ChassisControllerBuilder &ChassisControllerBuilder::withMaxVoltage(const double
   return *this;
 }
 
+ChassisControllerBuilder &
+ChassisControllerBuilder::withVoltageCompensation(const double inominalVoltage) {
+  hasVoltageCompensation = true;
+  nominalVoltage = inominalVoltage;
+  voltageCompensator = nullptr;
+  return *this;
+}
+
+ChassisControllerBuilder &ChassisControllerBuilder::withVoltageCompensation(
+  const std::shared_ptr<VoltageCompensator> &icompensator) {
+  if (icompensator == nullptr) {
+    std::string msg = "ChassisControllerBuilder: The voltage compensator cannot be null.";
+    LOG_ERROR(msg);
+    throw std::invalid_argument(msg);
+  }
+
+  hasVoltageCompensation = true;
+  voltageCompensator = icompensator;
+  return *this;
+}
+
 ChassisControllerBuilder &ChassisControllerBuilder::withChassisControllerTimeUtilFactory(
   const TimeUtilFactory &itimeUtilFactory) {
   chassisControllerTimeUtilFactory = itimeUtilFactory;
@@ -337,7 +404,131 @@ ChassisControllerBuilder &ChassisControllerBuilder::notParentedToCurrentTask() {
   return *this;
 }
 
+ChassisControllerBuilder &
+ChassisControllerBuilder::withOdometryIntegration(const OdomIntegration &iintegration) {
+  odomIntegration = iintegration;
+  return *this;
+}
+
+ChassisControllerBuilder &ChassisControllerBuilder::withOdometryImu(const IMU &iimu,
+                                                                    const double iimuWeight) {
+  return withOdometryImu(std::make_shared<IMU>(iimu), iimuWeight);
+}
+
+ChassisControllerBuilder &
+ChassisControllerBuilder::withOdometryImu(const std::shared_ptr<ContinuousRotarySensor> &iimu,
+                                          const double iimuWeight) {
+  if (iimu == nullptr) {
+    std::string msg = "ChassisControllerBuilder: The odometry inertial sensor cannot be null.";
+    LOG_ERROR(msg);
+    throw std::runtime_error(msg);
+  }
+
+  odomImu = iimu;
+  odomImuWeight = iimuWeight;
+  return *this;
+}
+
+ChassisControllerBuilder &ChassisControllerBuilder::withOdometryWalls(const FieldMap &imap,
+                                                                      const double igain) {
+  hasOdomWalls = true;
+  odomWalls = imap;
+  odomWallGain = igain;
+  return *this;
+}
+
+ChassisControllerBuilder &
+ChassisControllerBuilder::withOdometryDistanceSensor(const std::uint8_t iport,
+                                                     const OdomState &imount) {
+  return withOdometryDistanceSensor(std::make_shared<DistanceSensor>(iport), imount);
+}
+
+ChassisControllerBuilder &ChassisControllerBuilder::withOdometryDistanceSensor(
+  const std::shared_ptr<ControllerInput<double>> &isensor,
+  const OdomState &imount) {
+  if (isensor == nullptr) {
+    std::string msg = "ChassisControllerBuilder: The odometry distance sensor cannot be null.";
+    LOG_ERROR(msg);
+    throw std::runtime_error(msg);
+  }
+
+  odomDistanceSensors.emplace_back(isensor, imount);
+  return *this;
+}
+
+ChassisControllerBuilder &
+ChassisControllerBuilder::withTaskPriority(const std::uint32_t ipriority) {
+  if (ipriority < TASK_PRIORITY_MIN || ipriority > TASK_PRIORITY_MAX) {
+    std::string msg("ChassisControllerBuilder: The task priority must be between "
+                    "TASK_PRIORITY_MIN and TASK_PRIORITY_MAX.");
+    LOG_ERROR(msg);
+    throw std::invalid_argument(msg);
+  }
+
+  taskPriority = ipriority;
+  return *this;
+}
+
+ChassisControllerBuilder &
+ChassisControllerBuilder::withTaskStackDepth(const std::uint16_t istackDepth) {
+  if (istackDepth < TASK_STACK_DEPTH_MIN) {
+    std::string msg("ChassisControllerBuilder: The task stack depth must be at least "
+                    "TASK_STACK_DEPTH_MIN.");
+    LOG_ERROR(msg);
+    throw std::invalid_argument(msg);
+  }
+
+  taskStackDepth = istackDepth;
+  return *this;
+}
+
+ChassisControllerBuilder &
+ChassisControllerBuilder::withScheduler(const std::shared_ptr<ControlScheduler> &ischeduler) {
+  scheduler = ischeduler;
+  return *this;
+}
+
+ChassisControllerBuilder &ChassisControllerBuilder::withLazyThreadStart() {
+  lazyThreadStart = true;
+  return *this;
+}
+
+const std::vector<ChassisControllerBuilder::BuildPhase> &
+ChassisControllerBuilder::getBuildReport() const {
+  return buildReport;
+}
+
+void ChassisControllerBuilder::startBuildReport() {
+  buildReport.clear();
+  buildTimer = std::make_unique<MicrosTimer>();
+  lastPhaseEnd = buildTimer->millis();
+}
+
+void ChassisControllerBuilder::recordBuildPhase(const std::string &iname) {
+  const QTime now = buildTimer->millis();
+  buildReport.push_back({iname, now - lastPhaseEnd});
+  lastPhaseEnd = now;
+}
+
+void ChassisControllerBuilder::finishBuildReport() {
+  QTime total = 0_ms;
+  for (const auto &phase : buildReport) {
+    LOG_INFO("ChassisControllerBuilder: Building the " + phase.name + " took " +
+             std::to_string(phase.duration.convert(millisecond)) + " ms.");
+    total += phase.duration;
+  }
+  LOG_INFO("ChassisControllerBuilder: Building took " +
+           std::to_string(total.convert(millisecond)) + " ms.");
+}
+
 std::shared_ptr<ChassisController> ChassisControllerBuilder::build() {
+  startBuildReport();
+  auto out = buildChassisController();
+  finishBuildReport();
+  return out;
+}
+
+std::shared_ptr<ChassisController> ChassisControllerBuilder::buildChassisController() {
   if (!hasMotors) {
     std::string msg("ChassisControllerBuilder: No motors given.");
     LOG_ERROR(msg);
@@ -376,25 +567,63 @@ std::shared_ptr<OdomChassisController> ChassisControllerBuilder::buildOdometry()
     throw std::runtime_error(msg);
   }
 
-  return buildDOCC(build());
+  startBuildReport();
+  auto out = buildDOCC(buildChassisController());
+  finishBuildReport();
+  return out;
 }
 
 std::shared_ptr<DefaultOdomChassisController>
 ChassisControllerBuilder::buildDOCC(std::shared_ptr<ChassisController> chassisController) {
   if (odometry == nullptr) {
+    std::shared_ptr<TwoEncoderOdometry> encoderOdometry;
     if (middleSensor == nullptr) {
-      odometry = std::make_shared<TwoEncoderOdometry>(odometryTimeUtilFactory.create(),
-                                                      chassisController->getModel(),
-                                                      odomScales,
-                                                      controllerLogger);
+      encoderOdometry = std::make_shared<TwoEncoderOdometry>(odometryTimeUtilFactory.create(),
+                                                             chassisController->getModel(),
+                                                             odomScales,
+                                                             controllerLogger);
+    } else if (driveMode == DriveMode::XDrive) {
+      // X-drives strafe, so use odometry which always integrates strafing with turning
+      encoderOdometry =
+        std::make_shared<HolonomicOdometry>(odometryTimeUtilFactory.create(),
+                                            chassisController->getModel(),
+                                            odomScales,
+                                            HolonomicOdometry::defaultMaxSpeed,
+                                            controllerLogger);
     } else {
-      odometry = std::make_shared<ThreeEncoderOdometry>(odometryTimeUtilFactory.create(),
-                                                        chassisController->getModel(),
-                                                        odomScales,
-                                                        controllerLogger);
+      encoderOdometry = std::make_shared<ThreeEncoderOdometry>(odometryTimeUtilFactory.create(),
+                                                               chassisController->getModel(),
+                                                               odomScales,
+                                                               controllerLogger);
     }
+    encoderOdometry->setIntegration(odomIntegration);
+    odometry = std::move(encoderOdometry);
+  }
+
+  if (odomImu) {
+    odometry = std::make_shared<ImuFusedOdometry>(
+      std::move(odometry), odomImu, odomImuWeight, controllerLogger);
   }
 
+  if (hasOdomWalls) {
+    auto wallOdometry =
+      std::make_shared<WallCorrectedOdometry>(std::move(odometry),
+                                              odomWalls,
+                                              odomWallGain,
+                                              WallCorrectedOdometry::defaultMaxError,
+                                              WallCorrectedOdometry::defaultMaxIncidence,
+                                              controllerLogger);
+    for (const auto &[sensor, mount] : odomDistanceSensors) {
+      wallOdometry->addDistanceSensor(sensor, mount);
+    }
+    odometry = std::move(wallOdometry);
+  } else if (!odomDistanceSensors.empty()) {
+    LOG_WARN_S("ChassisControllerBuilder: Odometry distance sensors were given without the walls "
+               "of the field, so they won't be used. Call withOdometryWalls as well.");
+  }
+
+  recordBuildPhase("odometry");
+
   auto out =
     std::make_shared<DefaultOdomChassisController>(chassisControllerTimeUtilFactory.create(),
                                                    std::move(odometry),
@@ -404,11 +633,21 @@ ChassisControllerBuilder::buildDOCC(std::shared_ptr<ChassisController> chassisCo
                                                    turnThreshold,
                                                    controllerLogger);
 
-  out->startOdomThread();
+  out->setOdomLoopPeriod(odomLoopPeriod);
+
+  if (scheduler) {
+    out->startOdomScheduled(scheduler);
+  } else {
+    // Step the odometry ahead of the controllers which read it
+    const std::uint32_t odomTaskPriority =
+      taskPriority < TASK_PRIORITY_MAX ? taskPriority + 1 : taskPriority;
+    out->startOdomThread(odomTaskPriority, taskStackDepth);
 
-  if (isParentedToCurrentTask && NOT_INITIALIZE_TASK && NOT_COMP_INITIALIZE_TASK) {
-    out->getOdomThread()->notifyWhenDeletingRaw(pros::c::task_get_current());
+    if (isParentedToCurrentTask && NOT_INITIALIZE_TASK && NOT_COMP_INITIALIZE_TASK) {
+      out->getOdomThread()->notifyWhenDeletingRaw(pros::c::task_get_current());
+    }
   }
+  recordBuildPhase("odometry task");
 
   return out;
 }
@@ -420,9 +659,13 @@ std::shared_ptr<ChassisControllerPID> ChassisControllerBuilder::buildCCPID() {
     odomScales.straight = odomScales.straight / gearset.ratio;
     odomScales.turn = odomScales.turn / gearset.ratio;
   }
+
+  auto model = makeChassisModel();
+  recordBuildPhase("chassis model");
+
   auto out = std::make_shared<ChassisControllerPID>(
     chassisControllerTimeUtilFactory.create(),
-    makeChassisModel(),
+    std::move(model),
     std::make_unique<IterativePosPIDController>(distanceGains,
                                                 closedLoopControllerTimeUtilFactory.create(),
                                                 std::move(distanceFilter),
@@ -439,11 +682,40 @@ std::shared_ptr<ChassisControllerPID> ChassisControllerBuilder::buildCCPID() {
     odomScales,
     controllerLogger);
 
-  out->startThread();
+  if (hasProfileLimits) {
+    out->setProfileLimits(profileLimits, profileShape);
+  }
+
+  if (headingSensor) {
+    out->setHeadingSensor(headingSensor);
+  }
 
-  if (isParentedToCurrentTask && NOT_INITIALIZE_TASK && NOT_COMP_INITIALIZE_TASK) {
-    out->getThread()->notifyWhenDeletingRaw(pros::c::task_get_current());
+  if (hasStrafeGains) {
+    if (driveMode == DriveMode::HDrive) {
+      out->setStrafeController(
+        std::make_unique<IterativePosPIDController>(strafeGains,
+                                                    closedLoopControllerTimeUtilFactory.create(),
+                                                    std::make_unique<PassthroughFilter>(),
+                                                    controllerLogger));
+    } else {
+      LOG_WARN_S("ChassisControllerBuilder: Strafe gains were given for a drive which is not an "
+                 "H-drive, so they won't be used.");
+    }
   }
+  recordBuildPhase("chassis controller");
+
+  if (scheduler) {
+    out->startScheduled(scheduler);
+  } else if (lazyThreadStart) {
+    out->startThreadLazily(taskPriority, taskStackDepth);
+  } else {
+    out->startThread(taskPriority, taskStackDepth);
+
+    if (isParentedToCurrentTask && NOT_INITIALIZE_TASK && NOT_COMP_INITIALIZE_TASK) {
+      out->getThread()->notifyWhenDeletingRaw(pros::c::task_get_current());
+    }
+  }
+  recordBuildPhase("chassis controller task");
 
   return out;
 }
@@ -474,9 +746,12 @@ std::shared_ptr<ChassisControllerIntegrated> ChassisControllerBuilder::buildCCI(
   // The chassis controller will handle the conversion of distance to motor
   // position in terms of external gear ratio, so the controllers should
   // be set to a ratio of 1.0
-  return std::make_shared<ChassisControllerIntegrated>(
+  auto model = makeChassisModel();
+  recordBuildPhase("chassis model");
+
+  auto out = std::make_shared<ChassisControllerIntegrated>(
     chassisControllerTimeUtilFactory.create(),
-    makeChassisModel(),
+    std::move(model),
     std::make_unique<AsyncPosIntegratedController>(
       leftMotorGroup,
       AbstractMotor::GearsetRatioPair(gearset.internalGearset, 1.0),
@@ -492,19 +767,50 @@ std::shared_ptr<ChassisControllerIntegrated> ChassisControllerBuilder::buildCCI(
     gearset,
     driveScales,
     controllerLogger);
+
+  recordBuildPhase("chassis controller");
+
+  if (hasProfileLimits || headingSensor) {
+    // The thread streams the velocity of the profiles and corrects the heading
+    if (lazyThreadStart) {
+      out->startThreadLazily(taskPriority, taskStackDepth);
+    } else {
+      out->startThread(taskPriority, taskStackDepth);
+    }
+
+    if (hasProfileLimits) {
+      out->setProfileLimits(profileLimits);
+    }
+
+    if (headingSensor) {
+      out->setHeadingCorrection(headingSensor);
+    }
+
+    if (!lazyThreadStart && isParentedToCurrentTask && NOT_INITIALIZE_TASK &&
+        NOT_COMP_INITIALIZE_TASK) {
+      out->getThread()->notifyWhenDeletingRaw(pros::c::task_get_current());
+    }
+    recordBuildPhase("chassis controller task");
+  }
+
+  return out;
 }
 
 std::shared_ptr<ChassisModel> ChassisControllerBuilder::makeChassisModel() {
   // These implementations should handle a null middleSensor
+  std::shared_ptr<ChassisModel> model;
   switch (driveMode) {
   case DriveMode::SkidSteer:
-    return makeSkidSteerModel();
+    model = makeSkidSteerModel();
+    break;
 
   case DriveMode::XDrive:
-    return makeXDriveModel();
+    model = makeXDriveModel();
+    break;
 
   case DriveMode::HDrive:
-    return makeHDriveModel();
+    model = makeHDriveModel();
+    break;
 
   default:
     std::string msg =
@@ -512,17 +818,37 @@ std::shared_ptr<ChassisModel> ChassisControllerBuilder::makeChassisModel() {
     LOG_ERROR(msg);
     throw std::runtime_error(msg);
   }
+
+  if (hasVoltageCompensation) {
+    if (voltageCompensator == nullptr) {
+      voltageCompensator =
+        std::make_shared<VoltageCompensator>(std::make_shared<Battery>(),
+                                             chassisControllerTimeUtilFactory.create().getTimer(),
+                                             nominalVoltage,
+                                             VoltageCompensator::defaultMaxScale,
+                                             VoltageCompensator::defaultReadPeriod,
+                                             controllerLogger);
+    }
+
+    model->setVoltageCompensator(voltageCompensator);
+  }
+
+  return model;
 }
 
 std::shared_ptr<SkidSteerModel> ChassisControllerBuilder::makeSkidSteerModel() {
   if (middleSensor != nullptr) {
-    return std::make_shared<ThreeEncoderSkidSteerModel>(skidSteerMotors.left,
-                                                        skidSteerMotors.right,
-                                                        leftSensor,
-                                                        rightSensor,
-                                                        middleSensor,
-                                                        maxVelocity,
-                                                        maxVoltage);
+    auto model = std::make_shared<ThreeEncoderSkidSteerModel>(skidSteerMotors.left,
+                                                              skidSteerMotors.right,
+                                                              leftSensor,
+                                                              rightSensor,
+                                                              middleSensor,
+                                                              maxVelocity,
+                                                              maxVoltage);
+    if (sensorGroup) {
+      model->setSensorGroup(sensorGroup);
+    }
+    return model;
   } else {
     return std::make_shared<SkidSteerModel>(skidSteerMotors.left,
                                             skidSteerMotors.right,
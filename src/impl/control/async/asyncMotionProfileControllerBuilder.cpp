@@ -68,6 +68,14 @@ AsyncMotionProfileControllerBuilder::withLimits(const PathfinderLimits &ilimits)
   return *this;
 }
 
+AsyncMotionProfileControllerBuilder &AsyncMotionProfileControllerBuilder::withOdometry(
+  const std::shared_ptr<Odometry> &iodometry, const double ib, const double izeta) {
+  odometry = iodometry;
+  ramseteB = ib;
+  ramseteZeta = izeta;
+  return *this;
+}
+
 AsyncMotionProfileControllerBuilder &
 AsyncMotionProfileControllerBuilder::withTimeUtilFactory(const TimeUtilFactory &itimeUtilFactory) {
   timeUtilFactory = itimeUtilFactory;
@@ -91,6 +99,32 @@ AsyncMotionProfileControllerBuilder::notParentedToCurrentTask() {
   return *this;
 }
 
+AsyncMotionProfileControllerBuilder &
+AsyncMotionProfileControllerBuilder::withTaskPriority(const std::uint32_t ipriority) {
+  if (ipriority < TASK_PRIORITY_MIN || ipriority > TASK_PRIORITY_MAX) {
+    std::string msg("AsyncMotionProfileControllerBuilder: The task priority must be between "
+                    "TASK_PRIORITY_MIN and TASK_PRIORITY_MAX.");
+    LOG_ERROR(msg);
+    throw std::invalid_argument(msg);
+  }
+
+  taskPriority = ipriority;
+  return *this;
+}
+
+AsyncMotionProfileControllerBuilder &
+AsyncMotionProfileControllerBuilder::withTaskStackDepth(const std::uint16_t istackDepth) {
+  if (istackDepth < TASK_STACK_DEPTH_MIN) {
+    std::string msg("AsyncMotionProfileControllerBuilder: The task stack depth must be at least "
+                    "TASK_STACK_DEPTH_MIN.");
+    LOG_ERROR(msg);
+    throw std::invalid_argument(msg);
+  }
+
+  taskStackDepth = istackDepth;
+  return *this;
+}
+
 std::shared_ptr<AsyncLinearMotionProfileController>
 AsyncMotionProfileControllerBuilder::buildLinearMotionProfileController() {
   if (!hasOutput) {
@@ -107,7 +141,7 @@ AsyncMotionProfileControllerBuilder::buildLinearMotionProfileController() {
 
   auto out = std::make_shared<AsyncLinearMotionProfileController>(
     timeUtilFactory.create(), limits, output, diameter, pair, controllerLogger);
-  out->startThread();
+  out->startThread(taskPriority, taskStackDepth);
 
   if (isParentedToCurrentTask && NOT_INITIALIZE_TASK && NOT_COMP_INITIALIZE_TASK) {
     out->getThread()->notifyWhenDeletingRaw(pros::c::task_get_current());
@@ -132,7 +166,12 @@ AsyncMotionProfileControllerBuilder::buildMotionProfileController() {
 
   auto out = std::make_shared<AsyncMotionProfileController>(
     timeUtilFactory.create(), limits, model, scales, pair, controllerLogger);
-  out->startThread();
+
+  if (odometry) {
+    out->setOdometry(odometry, ramseteB, ramseteZeta);
+  }
+
+  out->startThread(taskPriority, taskStackDepth);
 
   if (isParentedToCurrentTask && NOT_INITIALIZE_TASK && NOT_COMP_INITIALIZE_TASK) {
     out->getThread()->notifyWhenDeletingRaw(pros::c::task_get_current());
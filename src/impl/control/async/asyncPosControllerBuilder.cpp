@@ -104,6 +104,38 @@ AsyncPosControllerBuilder &AsyncPosControllerBuilder::notParentedToCurrentTask()
   return *this;
 }
 
+AsyncPosControllerBuilder &
+AsyncPosControllerBuilder::withTaskPriority(const std::uint32_t ipriority) {
+  if (ipriority < TASK_PRIORITY_MIN || ipriority > TASK_PRIORITY_MAX) {
+    std::string msg("AsyncPosControllerBuilder: The task priority must be between "
+                    "TASK_PRIORITY_MIN and TASK_PRIORITY_MAX.");
+    LOG_ERROR(msg);
+    throw std::invalid_argument(msg);
+  }
+
+  taskPriority = ipriority;
+  return *this;
+}
+
+AsyncPosControllerBuilder &
+AsyncPosControllerBuilder::withTaskStackDepth(const std::uint16_t istackDepth) {
+  if (istackDepth < TASK_STACK_DEPTH_MIN) {
+    std::string msg("AsyncPosControllerBuilder: The task stack depth must be at least "
+                    "TASK_STACK_DEPTH_MIN.");
+    LOG_ERROR(msg);
+    throw std::invalid_argument(msg);
+  }
+
+  taskStackDepth = istackDepth;
+  return *this;
+}
+
+AsyncPosControllerBuilder &
+AsyncPosControllerBuilder::withScheduler(const std::shared_ptr<ControlScheduler> &ischeduler) {
+  scheduler = ischeduler;
+  return *this;
+}
+
 std::shared_ptr<AsyncPositionController<double, double>> AsyncPosControllerBuilder::build() {
   if (!hasMotors) {
     std::string msg("AsyncPosControllerBuilder: No motors given.");
@@ -139,10 +171,14 @@ std::shared_ptr<AsyncPosPIDController> AsyncPosControllerBuilder::buildAPPC() {
                                                      pair.ratio,
                                                      std::move(derivativeFilter),
                                                      controllerLogger);
-  out->startThread();
+  if (scheduler) {
+    out->startScheduled(scheduler);
+  } else {
+    out->startThread(taskPriority, taskStackDepth);
 
-  if (isParentedToCurrentTask && NOT_INITIALIZE_TASK && NOT_COMP_INITIALIZE_TASK) {
-    out->getThread()->notifyWhenDeletingRaw(pros::c::task_get_current());
+    if (isParentedToCurrentTask && NOT_INITIALIZE_TASK && NOT_COMP_INITIALIZE_TASK) {
+      out->getThread()->notifyWhenDeletingRaw(pros::c::task_get_current());
+    }
   }
 
   return out;
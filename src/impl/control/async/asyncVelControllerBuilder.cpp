@@ -58,11 +58,25 @@ AsyncVelControllerBuilder::withSensor(const std::shared_ptr<RotarySensor> &isens
 
 AsyncVelControllerBuilder &
 AsyncVelControllerBuilder::withGains(const IterativeVelPIDController::Gains &igains) {
-  hasGains = true;
+  controllerType = ControllerType::pid;
   gains = igains;
   return *this;
 }
 
+AsyncVelControllerBuilder &
+AsyncVelControllerBuilder::withGains(const IterativeTBHController::Gains &igains) {
+  controllerType = ControllerType::tbh;
+  tbhGains = igains;
+  return *this;
+}
+
+AsyncVelControllerBuilder &
+AsyncVelControllerBuilder::withGains(const IterativeBangBangController::Gains &igains) {
+  controllerType = ControllerType::bangBang;
+  bangBangGains = igains;
+  return *this;
+}
+
 AsyncVelControllerBuilder &
 AsyncVelControllerBuilder::withVelMath(std::unique_ptr<VelMath> ivelMath) {
   hasVelMath = true;
@@ -111,6 +125,38 @@ AsyncVelControllerBuilder &AsyncVelControllerBuilder::notParentedToCurrentTask()
   return *this;
 }
 
+AsyncVelControllerBuilder &
+AsyncVelControllerBuilder::withTaskPriority(const std::uint32_t ipriority) {
+  if (ipriority < TASK_PRIORITY_MIN || ipriority > TASK_PRIORITY_MAX) {
+    std::string msg("AsyncVelControllerBuilder: The task priority must be between "
+                    "TASK_PRIORITY_MIN and TASK_PRIORITY_MAX.");
+    LOG_ERROR(msg);
+    throw std::invalid_argument(msg);
+  }
+
+  taskPriority = ipriority;
+  return *this;
+}
+
+AsyncVelControllerBuilder &
+AsyncVelControllerBuilder::withTaskStackDepth(const std::uint16_t istackDepth) {
+  if (istackDepth < TASK_STACK_DEPTH_MIN) {
+    std::string msg("AsyncVelControllerBuilder: The task stack depth must be at least "
+                    "TASK_STACK_DEPTH_MIN.");
+    LOG_ERROR(msg);
+    throw std::invalid_argument(msg);
+  }
+
+  taskStackDepth = istackDepth;
+  return *this;
+}
+
+AsyncVelControllerBuilder &
+AsyncVelControllerBuilder::withScheduler(const std::shared_ptr<ControlScheduler> &ischeduler) {
+  scheduler = ischeduler;
+  return *this;
+}
+
 std::shared_ptr<AsyncVelocityController<double, double>> AsyncVelControllerBuilder::build() {
   if (!hasMotors) {
     std::string msg("AsyncVelControllerBuilder: No motors given.");
@@ -118,7 +164,7 @@ std::shared_ptr<AsyncVelocityController<double, double>> AsyncVelControllerBuild
     throw std::runtime_error(msg);
   }
 
-  if (hasGains) {
+  if (controllerType != ControllerType::integrated) {
     if (!hasVelMath) {
       std::string msg("AsyncVelControllerBuilder: No VelMath given.");
       LOG_ERROR(msg);
@@ -130,7 +176,14 @@ std::shared_ptr<AsyncVelocityController<double, double>> AsyncVelControllerBuild
         "AsyncVelControllerBuilder: The default gearset is selected. This could be a bug.");
     }
 
-    return buildAVPC();
+    switch (controllerType) {
+    case ControllerType::tbh:
+      return buildAVTC();
+    case ControllerType::bangBang:
+      return buildAVBC();
+    default:
+      return buildAVPC();
+    }
   } else {
     return buildAVIC();
   }
@@ -154,12 +207,45 @@ std::shared_ptr<AsyncVelPIDController> AsyncVelControllerBuilder::buildAVPC() {
                                                      pair.ratio,
                                                      std::move(derivativeFilter),
                                                      controllerLogger);
-  out->startThread();
+  startWrapper(*out);
+  return out;
+}
 
-  if (isParentedToCurrentTask && NOT_INITIALIZE_TASK && NOT_COMP_INITIALIZE_TASK) {
-    out->getThread()->notifyWhenDeletingRaw(pros::c::task_get_current());
-  }
+std::shared_ptr<AsyncVelTBHController> AsyncVelControllerBuilder::buildAVTC() {
+  motor->setGearing(pair.internalGearset);
+  auto out = std::make_shared<AsyncVelTBHController>(sensor,
+                                                     motor,
+                                                     timeUtilFactory.create(),
+                                                     tbhGains,
+                                                     std::move(velMath),
+                                                     pair.ratio,
+                                                     controllerLogger);
+  startWrapper(*out);
+  return out;
+}
 
+std::shared_ptr<AsyncVelBangBangController> AsyncVelControllerBuilder::buildAVBC() {
+  motor->setGearing(pair.internalGearset);
+  auto out = std::make_shared<AsyncVelBangBangController>(sensor,
+                                                          motor,
+                                                          timeUtilFactory.create(),
+                                                          bangBangGains,
+                                                          std::move(velMath),
+                                                          pair.ratio,
+                                                          controllerLogger);
+  startWrapper(*out);
   return out;
 }
+
+void AsyncVelControllerBuilder::startWrapper(AsyncWrapper<double, double> &icontroller) {
+  if (scheduler) {
+    icontroller.startScheduled(scheduler);
+  } else {
+    icontroller.startThread(taskPriority, taskStackDepth);
+
+    if (isParentedToCurrentTask && NOT_INITIALIZE_TASK && NOT_COMP_INITIALIZE_TASK) {
+      icontroller.getThread()->notifyWhenDeletingRaw(pros::c::task_get_current());
+    }
+  }
+}
 } // namespace okapi
@@ -0,0 +1,48 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#include "okapi/impl/control/util/relayTunerFactory.hpp"
+#include "okapi/impl/util/timeUtilFactory.hpp"
+
+namespace okapi {
+RelayTuner RelayTunerFactory::create(const std::shared_ptr<ControllerInput<double>> &iinput,
+                                     const std::shared_ptr<ControllerOutput<double>> &ioutput,
+                                     const double igoal,
+                                     const double irelayAmplitude,
+                                     const double ihysteresis,
+                                     const std::size_t inumCycles,
+                                     const QTime itimeout,
+                                     const std::shared_ptr<Logger> &ilogger) {
+  return RelayTuner(iinput,
+                    ioutput,
+                    TimeUtilFactory::createDefault(),
+                    igoal,
+                    irelayAmplitude,
+                    ihysteresis,
+                    inumCycles,
+                    itimeout,
+                    ilogger);
+}
+
+std::unique_ptr<RelayTuner>
+RelayTunerFactory::createPtr(const std::shared_ptr<ControllerInput<double>> &iinput,
+                             const std::shared_ptr<ControllerOutput<double>> &ioutput,
+                             const double igoal,
+                             const double irelayAmplitude,
+                             const double ihysteresis,
+                             const std::size_t inumCycles,
+                             const QTime itimeout,
+                             const std::shared_ptr<Logger> &ilogger) {
+  return std::make_unique<RelayTuner>(iinput,
+                                      ioutput,
+                                      TimeUtilFactory::createDefault(),
+                                      igoal,
+                                      irelayAmplitude,
+                                      ihysteresis,
+                                      inumCycles,
+                                      itimeout,
+                                      ilogger);
+}
+} // namespace okapi
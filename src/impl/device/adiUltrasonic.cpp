@@ -14,7 +14,8 @@ ADIUltrasonic::ADIUltrasonic(const std::uint8_t iportPing,
 
 ADIUltrasonic::ADIUltrasonic(std::tuple<std::uint8_t, std::uint8_t, std::uint8_t> iports,
                              std::unique_ptr<Filter> ifilter)
-  : ultra(pros::c::ext_adi_ultrasonic_init(std::get<0>(iports),
+  : ports(iports),
+    ultra(pros::c::ext_adi_ultrasonic_init(std::get<0>(iports),
                                            std::get<1>(iports),
                                            std::get<2>(iports))),
     filter(std::move(ifilter)) {
@@ -23,10 +24,32 @@ ADIUltrasonic::ADIUltrasonic(std::tuple<std::uint8_t, std::uint8_t, std::uint8_t
 ADIUltrasonic::~ADIUltrasonic() = default;
 
 double ADIUltrasonic::get() {
-  return filter->filter(pros::c::ext_adi_ultrasonic_get(ultra));
+  const std::int32_t reading = pros::c::ext_adi_ultrasonic_get(ultra);
+
+  // Keep failed reads, such as while the sensor is stopped, out of the filter
+  if (reading == PROS_ERR) {
+    return PROS_ERR;
+  }
+
+  return filter->filter(reading);
 }
 
 double ADIUltrasonic::controllerGet() {
   return get();
 }
+
+std::int32_t ADIUltrasonic::startPinging() {
+  const auto result = pros::c::ext_adi_ultrasonic_init(
+    std::get<0>(ports), std::get<1>(ports), std::get<2>(ports));
+  if (result == PROS_ERR) {
+    return PROS_ERR;
+  }
+
+  ultra = result;
+  return 1;
+}
+
+std::int32_t ADIUltrasonic::stopPinging() {
+  return pros::c::ext_adi_ultrasonic_shutdown(ultra);
+}
 } // namespace okapi
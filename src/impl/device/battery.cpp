@@ -0,0 +1,24 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#include "okapi/impl/device/battery.hpp"
+
+namespace okapi {
+double Battery::get() const {
+  return pros::c::battery_get_voltage();
+}
+
+double Battery::getCurrent() const {
+  return pros::c::battery_get_current();
+}
+
+double Battery::getCapacity() const {
+  return pros::c::battery_get_capacity();
+}
+
+double Battery::controllerGet() {
+  return get();
+}
+} // namespace okapi
@@ -18,8 +18,18 @@ ControllerButton::ControllerButton(const ControllerId icontroller,
     btn(ControllerUtil::digitalToProsEnum(ibtn)) {
 }
 
+ControllerButton::ControllerButton(std::shared_ptr<ControllerButtonEventService> iservice,
+                                   const ControllerId icontroller,
+                                   const ControllerDigital ibtn,
+                                   const bool iinverted)
+  : ControllerButton(icontroller, ibtn, iinverted) {
+  service = std::move(iservice);
+  serviceButtonId = ControllerButtonEventService::buttonId(icontroller, ibtn);
+}
+
 bool ControllerButton::currentlyPressed() {
-  const bool pressed = pros::c::controller_get_digital(id, btn) != 0;
+  const bool pressed =
+    service ? service->isPressed(serviceButtonId) : pros::c::controller_get_digital(id, btn) != 0;
   return inverted == !pressed;
 }
 } // namespace okapi
@@ -0,0 +1,63 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#include "okapi/impl/device/button/controllerButtonEventService.hpp"
+#include "okapi/impl/util/timeUtilFactory.hpp"
+#include <vector>
+
+namespace okapi {
+namespace {
+constexpr auto firstDigital = static_cast<std::uint8_t>(ControllerDigital::L1);
+constexpr auto lastDigital = static_cast<std::uint8_t>(ControllerDigital::A);
+constexpr std::uint8_t buttonsPerController = lastDigital - firstDigital + 1;
+} // namespace
+
+ControllerButtonEventService::ControllerButtonEventService(
+  const std::initializer_list<ControllerId> &icontrollers,
+  const QTime &isamplePeriod,
+  const std::size_t iqueueCapacity,
+  std::shared_ptr<Logger> ilogger)
+  : ButtonEventService(makeSampler(icontrollers),
+                       TimeUtilFactory::createDefault(),
+                       isamplePeriod,
+                       iqueueCapacity,
+                       std::move(ilogger)) {
+  startThread();
+}
+
+std::uint8_t ControllerButtonEventService::buttonId(const ControllerId icontroller,
+                                                    const ControllerDigital ibtn) {
+  return static_cast<std::uint8_t>(static_cast<std::uint8_t>(icontroller) * buttonsPerController +
+                                   static_cast<std::uint8_t>(ibtn) - firstDigital);
+}
+
+void ControllerButtonEventService::addCallback(const ControllerId icontroller,
+                                               const ControllerDigital ibtn,
+                                               Callback icallback) {
+  addCallback(buttonId(icontroller, ibtn), std::move(icallback));
+}
+
+bool ControllerButtonEventService::isPressed(const ControllerId icontroller,
+                                             const ControllerDigital ibtn) const {
+  return isPressed(buttonId(icontroller, ibtn));
+}
+
+ButtonEventService::Sampler
+ControllerButtonEventService::makeSampler(const std::initializer_list<ControllerId> &icontrollers) {
+  return [controllers = std::vector<ControllerId>(icontrollers)]() {
+    std::uint32_t out = 0;
+    for (const auto controller : controllers) {
+      const auto id = ControllerUtil::idToProsEnum(controller);
+      for (std::uint8_t digital = firstDigital; digital <= lastDigital; digital++) {
+        const auto btn = static_cast<ControllerDigital>(digital);
+        if (pros::c::controller_get_digital(id, ControllerUtil::digitalToProsEnum(btn)) == 1) {
+          out |= 1u << buttonId(controller, btn);
+        }
+      }
+    }
+    return out;
+  };
+}
+} // namespace okapi
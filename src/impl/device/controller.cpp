@@ -30,10 +30,43 @@ float Controller::getAnalog(const ControllerAnalog ichannel) {
   return static_cast<float>(val) / static_cast<float>(127);
 }
 
+std::int32_t Controller::getAnalogRaw(const ControllerAnalog ichannel) {
+  const auto val =
+    pros::c::controller_get_analog(prosId, ControllerUtil::analogToProsEnum(ichannel));
+  return val == PROS_ERR ? 0 : val;
+}
+
 bool Controller::getDigital(const ControllerDigital ibutton) {
   return pros::c::controller_get_digital(prosId, ControllerUtil::digitalToProsEnum(ibutton)) == 1;
 }
 
+ControllerSnapshot Controller::snapshot() {
+  ControllerSnapshot out;
+  out.connected = isConnected();
+  if (!out.connected) {
+    return out;
+  }
+
+  for (std::size_t i = 0; i < out.analog.size(); i++) {
+    const auto channel = ControllerUtil::analogToProsEnum(static_cast<ControllerAnalog>(i));
+    const auto val = pros::c::controller_get_analog(prosId, channel);
+    if (val != PROS_ERR) {
+      out.analog[i] = static_cast<float>(val) / static_cast<float>(127);
+    }
+  }
+
+  const auto first = toUnderlyingType(ControllerDigital::L1);
+  const auto last = toUnderlyingType(ControllerDigital::A);
+  for (auto i = first; i <= last; i++) {
+    const auto button = ControllerUtil::digitalToProsEnum(static_cast<ControllerDigital>(i));
+    if (pros::c::controller_get_digital(prosId, button) == 1) {
+      out.digital |= static_cast<std::uint16_t>(1u << (i - first));
+    }
+  }
+
+  return out;
+}
+
 ControllerButton &Controller::operator[](const ControllerDigital ibtn) {
   const auto index = toUnderlyingType(ibtn) - toUnderlyingType(ControllerDigital::L1);
 
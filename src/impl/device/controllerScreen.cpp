@@ -0,0 +1,47 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#include "okapi/impl/device/controllerScreen.hpp"
+#include "okapi/impl/util/timeUtilFactory.hpp"
+
+namespace okapi {
+ControllerScreen::ControllerScreen(const ControllerId icontroller,
+                                   const QTime &iwritePeriod,
+                                   std::shared_ptr<Logger> ilogger)
+  : ControllerDisplayService(makeTextWriter(this, ControllerUtil::idToProsEnum(icontroller)),
+                             makeRumbleWriter(ControllerUtil::idToProsEnum(icontroller)),
+                             TimeUtilFactory::createDefault(),
+                             iwritePeriod,
+                             std::move(ilogger)) {
+  startThread();
+}
+
+ControllerDisplayService::TextWriter
+ControllerScreen::makeTextWriter(ControllerScreen *iscreen, const pros::controller_id_e_t iid) {
+  return [iscreen, iid, wasConnected = false](const std::uint8_t iline,
+                                              const std::uint8_t icol,
+                                              const std::string &itext) mutable {
+    const std::int32_t state = pros::c::controller_is_connected(iid);
+    const bool connected = state == 1 || state == 2;
+    if (connected != wasConnected) {
+      wasConnected = connected;
+      if (connected) {
+        // The screen was blanked or written to while the controller was away
+        iscreen->invalidate();
+        return false;
+      }
+    }
+
+    return connected && pros::c::controller_set_text(iid, iline, icol, itext.c_str()) == 1;
+  };
+}
+
+ControllerDisplayService::RumbleWriter
+ControllerScreen::makeRumbleWriter(const pros::controller_id_e_t iid) {
+  return [iid](const std::string &ipattern) {
+    return pros::c::controller_rumble(iid, ipattern.c_str()) == 1;
+  };
+}
+} // namespace okapi
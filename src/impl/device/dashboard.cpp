@@ -0,0 +1,45 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#include "okapi/impl/device/dashboard.hpp"
+#include "okapi/impl/util/timeUtilFactory.hpp"
+
+namespace okapi {
+Dashboard::Dashboard(const QTime &irefreshPeriod,
+                     lv_obj_t *iparent,
+                     std::shared_ptr<Logger> ilogger)
+  : DashboardService(makeCellWriter(this),
+                     TimeUtilFactory::createDefault(),
+                     irefreshPeriod,
+                     std::move(ilogger)) {
+  container = lv_cont_create(iparent ? iparent : lv_scr_act(), NULL);
+  lv_obj_set_size(container, LV_HOR_RES, LV_VER_RES);
+  startThread();
+}
+
+Dashboard::~Dashboard() {
+  // The cell writer uses the labels, so stop it before deleting them
+  stopThread();
+  lv_obj_del(container);
+}
+
+DashboardService::CellWriter Dashboard::makeCellWriter(Dashboard *idashboard) {
+  return [idashboard](const std::size_t icell, const std::string &itext) {
+    lv_obj_t *&label = idashboard->labels[icell];
+    if (!label) {
+      // Fill the left column first, then the right one
+      const lv_coord_t rows = LV_VER_RES / rowHeight;
+      label = lv_label_create(idashboard->container, NULL);
+      lv_label_set_long_mode(label, LV_LABEL_LONG_CROP);
+      lv_obj_set_size(label, LV_HOR_RES / 2, rowHeight);
+      lv_obj_set_pos(label,
+                     static_cast<lv_coord_t>(icell / rows * LV_HOR_RES / 2),
+                     static_cast<lv_coord_t>(icell % rows * rowHeight));
+    }
+
+    lv_label_set_text(label, itext.c_str());
+  };
+}
+} // namespace okapi
@@ -4,6 +4,8 @@
  * file, You can obtain one at http://mozilla.org/MPL/2.0/.
  */
 #include "okapi/impl/device/motor/adiMotor.hpp"
+#include "okapi/impl/util/timeUtilFactory.hpp"
+#include <cmath>
 
 namespace okapi {
 ADIMotor::ADIMotor(const std::uint8_t iport,
@@ -26,10 +28,36 @@ ADIMotor::ADIMotor(std::pair<std::uint8_t, std::uint8_t> iports,
 }
 
 void ADIMotor::moveVoltage(const std::int8_t ivoltage) const {
-  pros::c::ext_adi_motor_set(smartPort, port, ivoltage * reversed);
+  pros::c::ext_adi_motor_set(smartPort, port, linearizer(ivoltage) * reversed);
 }
 
 void ADIMotor::controllerSet(const double ivalue) {
-  pros::c::ext_adi_motor_set(smartPort, port, ivalue * reversed * 127);
+  const auto voltage = static_cast<std::int32_t>(std::lround(ivalue * 127));
+  pros::c::ext_adi_motor_set(smartPort, port, linearizer(voltage) * reversed);
+}
+
+void ADIMotor::setLinearizer(const MotorLinearizer &ilinearizer) {
+  linearizer = ilinearizer;
+}
+
+const MotorLinearizer &ADIMotor::getLinearizer() const {
+  return linearizer;
+}
+
+MotorLinearizer ADIMotor::calibrateLinearizer(const std::shared_ptr<RotarySensor> &isensor,
+                                              const std::int32_t istep,
+                                              const QTime isettleTime,
+                                              const QTime isampleTime) {
+  // The calibration sends raw PWM values, without the current linearizer
+  linearizer = MotorLinearizer::calibrate(
+    [this](const std::int8_t ipwm) {
+      pros::c::ext_adi_motor_set(smartPort, port, ipwm * reversed);
+    },
+    isensor,
+    TimeUtilFactory::createDefault(),
+    istep,
+    isettleTime,
+    isampleTime);
+  return linearizer;
 }
 } // namespace okapi
@@ -41,98 +41,179 @@ Motor::Motor(const std::uint8_t iport,
 }
 
 std::int32_t Motor::moveAbsolute(const double iposition, const std::int32_t ivelocity) {
+  writeCoalescer.invalidate();
   return pros::c::motor_move_absolute(port, iposition * reversed, ivelocity);
 }
 
 std::int32_t Motor::moveRelative(const double iposition, const std::int32_t ivelocity) {
+  writeCoalescer.invalidate();
   return pros::c::motor_move_relative(port, iposition * reversed, ivelocity);
 }
 
 std::int32_t Motor::moveVelocity(const std::int16_t ivelocity) {
-  return pros::c::motor_move_velocity(port, ivelocity * reversed);
+  if (!writeCoalescer.shouldWrite(
+        MotorWriteCoalescer::command::velocity, ivelocity, pros::millis() * millisecond)) {
+    return 1;
+  }
+
+  const auto result = pros::c::motor_move_velocity(port, ivelocity * reversed);
+  if (result != 1) {
+    writeCoalescer.invalidate();
+  }
+  return result;
 }
 
 std::int32_t Motor::moveVoltage(const std::int16_t ivoltage) {
-  return pros::c::motor_move_voltage(port, ivoltage * reversed);
+  if (!writeCoalescer.shouldWrite(
+        MotorWriteCoalescer::command::voltage, ivoltage, pros::millis() * millisecond)) {
+    return 1;
+  }
+
+  const auto result = pros::c::motor_move_voltage(port, ivoltage * reversed);
+  if (result != 1) {
+    writeCoalescer.invalidate();
+  }
+  return result;
 }
 
 std::int32_t Motor::modifyProfiledVelocity(std::int32_t ivelocity) {
+  writeCoalescer.invalidate();
   return pros::c::motor_modify_profiled_velocity(port, ivelocity * reversed);
 }
 
 double Motor::getTargetPosition() {
+  if (snapshotMode) {
+    return snapshot.targetPosition;
+  }
   return pros::c::motor_get_target_position(port) * reversed;
 }
 
 double Motor::getPosition() {
+  if (snapshotMode) {
+    return snapshot.position;
+  }
   return pros::c::motor_get_position(port) * reversed;
 }
 
 std::int32_t Motor::tarePosition() {
-  return pros::c::motor_tare_position(port);
+  const auto result = pros::c::motor_tare_position(port);
+  // Keep the snapshot consistent with the new zero until the next refresh
+  snapshot.position = 0;
+  return result;
 }
 
 std::int32_t Motor::getTargetVelocity() {
+  if (snapshotMode) {
+    return snapshot.targetVelocity;
+  }
   return pros::c::motor_get_target_velocity(port) * reversed;
 }
 
 double Motor::getActualVelocity() {
+  if (snapshotMode) {
+    return snapshot.actualVelocity;
+  }
   return pros::c::motor_get_actual_velocity(port) * reversed;
 }
 
 std::int32_t Motor::getCurrentDraw() {
+  if (snapshotMode) {
+    return snapshot.currentDraw;
+  }
   return pros::c::motor_get_current_draw(port);
 }
 
 std::int32_t Motor::getDirection() {
+  if (snapshotMode) {
+    return snapshot.direction;
+  }
   return pros::c::motor_get_direction(port) * reversed;
 }
 
 double Motor::getEfficiency() {
+  if (snapshotMode) {
+    return snapshot.efficiency;
+  }
   return pros::c::motor_get_efficiency(port);
 }
 
 std::int32_t Motor::isOverCurrent() {
+  if (snapshotMode) {
+    return (snapshot.faults & pros::E_MOTOR_FAULT_OVER_CURRENT) != 0;
+  }
   return pros::c::motor_is_over_current(port);
 }
 
 std::int32_t Motor::isOverTemp() {
+  if (snapshotMode) {
+    return (snapshot.faults & pros::E_MOTOR_FAULT_MOTOR_OVER_TEMP) != 0;
+  }
   return pros::c::motor_is_over_temp(port);
 }
 
 std::int32_t Motor::isStopped() {
+  if (snapshotMode) {
+    return (snapshot.flags & pros::E_MOTOR_FLAGS_ZERO_VELOCITY) != 0;
+  }
   return pros::c::motor_is_stopped(port);
 }
 
 std::int32_t Motor::getZeroPositionFlag() {
+  if (snapshotMode) {
+    return (snapshot.flags & pros::E_MOTOR_FLAGS_ZERO_POSITION) != 0;
+  }
   return pros::c::motor_get_zero_position_flag(port);
 }
 
 uint32_t Motor::getFaults() {
+  if (snapshotMode) {
+    return snapshot.faults;
+  }
   return pros::c::motor_get_faults(port);
 }
 
 uint32_t Motor::getFlags() {
+  if (snapshotMode) {
+    return snapshot.flags;
+  }
   return pros::c::motor_get_flags(port);
 }
 
 std::int32_t Motor::getRawPosition(std::uint32_t *timestamp) {
+  if (snapshotMode) {
+    if (timestamp != nullptr) {
+      *timestamp = snapshot.timestamp;
+    }
+    return snapshot.rawPosition;
+  }
   return pros::c::motor_get_raw_position(port, timestamp) * reversed;
 }
 
 double Motor::getPower() {
+  if (snapshotMode) {
+    return snapshot.power;
+  }
   return pros::c::motor_get_power(port);
 }
 
 double Motor::getTemperature() {
+  if (snapshotMode) {
+    return snapshot.temperature;
+  }
   return pros::c::motor_get_temperature(port);
 }
 
 double Motor::getTorque() {
+  if (snapshotMode) {
+    return snapshot.torque;
+  }
   return pros::c::motor_get_torque(port);
 }
 
 std::int32_t Motor::getVoltage() {
+  if (snapshotMode) {
+    return snapshot.voltage;
+  }
   return pros::c::motor_get_voltage(port) * reversed;
 }
 
@@ -230,6 +311,10 @@ AbstractMotor::gearset Motor::getGearing() {
 
 std::int32_t Motor::setReversed(const bool ireverse) {
   reversed = ireverse ? -1 : 1;
+  writeCoalescer.invalidate();
+  if (snapshotMode) {
+    refresh();
+  }
   return 0;
 }
 
@@ -289,4 +374,41 @@ std::uint8_t Motor::getPort() const {
 bool Motor::isReversed() const {
   return reversed < 0;
 }
+
+void Motor::refresh() {
+  snapshot.position = pros::c::motor_get_position(port) * reversed;
+  snapshot.targetPosition = pros::c::motor_get_target_position(port) * reversed;
+  snapshot.actualVelocity = pros::c::motor_get_actual_velocity(port) * reversed;
+  snapshot.targetVelocity = pros::c::motor_get_target_velocity(port) * reversed;
+  snapshot.currentDraw = pros::c::motor_get_current_draw(port);
+  snapshot.direction = pros::c::motor_get_direction(port) * reversed;
+  snapshot.efficiency = pros::c::motor_get_efficiency(port);
+  snapshot.power = pros::c::motor_get_power(port);
+  snapshot.temperature = pros::c::motor_get_temperature(port);
+  snapshot.torque = pros::c::motor_get_torque(port);
+  snapshot.voltage = pros::c::motor_get_voltage(port) * reversed;
+  snapshot.faults = pros::c::motor_get_faults(port);
+  snapshot.flags = pros::c::motor_get_flags(port);
+  snapshot.rawPosition = pros::c::motor_get_raw_position(port, &snapshot.timestamp) * reversed;
+}
+
+void Motor::setSnapshotMode(const bool ienabled) {
+  if (ienabled) {
+    refresh();
+  }
+  snapshotMode = ienabled;
+}
+
+bool Motor::isSnapshotMode() const {
+  return snapshotMode;
+}
+
+const MotorSnapshot &Motor::getSnapshot() const {
+  return snapshot;
+}
+
+void Motor::setWriteCoalescing(const bool ienabled, const QTime irefreshPeriod) {
+  writeCoalescer.setRefreshPeriod(irefreshPeriod);
+  writeCoalescer.setEnabled(ienabled);
+}
 } // namespace okapi
@@ -4,8 +4,66 @@
  * file, You can obtain one at http://mozilla.org/MPL/2.0/.
  */
 #include "okapi/impl/device/motor/motorGroup.hpp"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <numeric>
 
 namespace okapi {
+namespace {
+/**
+ * Whether a reading is one of the PROS error values. Motor negates readings of reversed motors, so
+ * the negated error values are errors too.
+ */
+bool isErrorReading(const double ivalue) {
+  return std::isinf(ivalue) || std::abs(ivalue) == PROS_ERR;
+}
+
+/**
+ * Reduces one telemetry field over the motors which could be read.
+ */
+class FieldAccumulator {
+  public:
+  void add(const double ivalue) {
+    if (!isErrorReading(ivalue)) {
+      sum += ivalue;
+      max = std::max(max, ivalue);
+      count++;
+    }
+  }
+
+  MotorGroupTelemetry::Field get() const {
+    if (count == 0) {
+      return {PROS_ERR_F, PROS_ERR_F, PROS_ERR_F};
+    }
+    return {sum / count, max, sum};
+  }
+
+  std::size_t getCount() const {
+    return count;
+  }
+
+  private:
+  double sum{0};
+  double max{-std::numeric_limits<double>::infinity()};
+  std::size_t count{0};
+};
+
+template <typename T>
+MotorGroupTelemetry::Field reduceField(const std::vector<std::shared_ptr<AbstractMotor>> &imotors,
+                                       T (AbstractMotor::*iget)()) {
+  FieldAccumulator accumulator;
+  for (auto &&elem : imotors) {
+    accumulator.add(static_cast<double>(((*elem).*iget)()));
+  }
+  return accumulator.get();
+}
+
+std::int32_t toInt32Reading(const double ivalue) {
+  return std::isinf(ivalue) ? PROS_ERR : static_cast<std::int32_t>(std::lround(ivalue));
+}
+} // namespace
+
 MotorGroup::MotorGroup(const std::initializer_list<Motor> &imotors,
                        const std::shared_ptr<Logger> &logger) {
   if (imotors.size() == 0) {
@@ -33,6 +91,7 @@ MotorGroup::MotorGroup(const std::initializer_list<std::shared_ptr<AbstractMotor
 }
 
 std::int32_t MotorGroup::moveAbsolute(const double iposition, const std::int32_t ivelocity) {
+  writeCoalescer.invalidate();
   auto out = 1;
   for (auto &&elem : motors) {
     const auto errorCode = elem->moveAbsolute(iposition, ivelocity);
@@ -44,6 +103,7 @@ std::int32_t MotorGroup::moveAbsolute(const double iposition, const std::int32_t
 }
 
 std::int32_t MotorGroup::moveRelative(const double iposition, const std::int32_t ivelocity) {
+  writeCoalescer.invalidate();
   auto out = 1;
   for (auto &&elem : motors) {
     const auto errorCode = elem->moveRelative(iposition, ivelocity);
@@ -55,6 +115,16 @@ std::int32_t MotorGroup::moveRelative(const double iposition, const std::int32_t
 }
 
 std::int32_t MotorGroup::moveVelocity(const std::int16_t ivelocity) {
+  if (loadBalancer) {
+    writeCoalescer.invalidate();
+    return MotorLoadBalancer::moveVelocity(motors, ivelocity);
+  }
+
+  if (!writeCoalescer.shouldWrite(
+        MotorWriteCoalescer::command::velocity, ivelocity, pros::millis() * millisecond)) {
+    return 1;
+  }
+
   auto out = 1;
   for (auto &&elem : motors) {
     const auto errorCode = elem->moveVelocity(ivelocity);
@@ -62,10 +132,27 @@ std::int32_t MotorGroup::moveVelocity(const std::int16_t ivelocity) {
       out = errorCode;
     }
   }
+
+  if (out != 1) {
+    writeCoalescer.invalidate();
+  }
   return out;
 }
 
 std::int32_t MotorGroup::moveVoltage(const std::int16_t ivoltage) {
+  if (loadBalancer) {
+    writeCoalescer.invalidate();
+    const std::uint32_t now = pros::millis();
+    const QTime dt = (now - lastBalanceTime) * millisecond;
+    lastBalanceTime = now;
+    return loadBalancer->moveVoltage(motors, ivoltage, dt);
+  }
+
+  if (!writeCoalescer.shouldWrite(
+        MotorWriteCoalescer::command::voltage, ivoltage, pros::millis() * millisecond)) {
+    return 1;
+  }
+
   auto out = 1;
   for (auto &&elem : motors) {
     const auto errorCode = elem->moveVoltage(ivoltage);
@@ -73,10 +160,15 @@ std::int32_t MotorGroup::moveVoltage(const std::int16_t ivoltage) {
       out = errorCode;
     }
   }
+
+  if (out != 1) {
+    writeCoalescer.invalidate();
+  }
   return out;
 }
 
 std::int32_t MotorGroup::modifyProfiledVelocity(std::int32_t ivelocity) {
+  writeCoalescer.invalidate();
   auto out = 1;
   for (auto &&elem : motors) {
     const auto errorCode = elem->modifyProfiledVelocity(ivelocity);
@@ -92,6 +184,9 @@ double MotorGroup::getTargetPosition() {
 }
 
 double MotorGroup::getPosition() {
+  if (aggregateTelemetry) {
+    return reduceField(motors, &AbstractMotor::getPosition).mean;
+  }
   return motors[0]->getPosition();
 }
 
@@ -111,10 +206,16 @@ std::int32_t MotorGroup::getTargetVelocity() {
 }
 
 double MotorGroup::getActualVelocity() {
+  if (aggregateTelemetry) {
+    return reduceField(motors, &AbstractMotor::getActualVelocity).mean;
+  }
   return motors[0]->getActualVelocity();
 }
 
 std::int32_t MotorGroup::getCurrentDraw() {
+  if (aggregateTelemetry) {
+    return toInt32Reading(reduceField(motors, &AbstractMotor::getCurrentDraw).sum);
+  }
   return motors[0]->getCurrentDraw();
 }
 
@@ -123,14 +224,27 @@ std::int32_t MotorGroup::getDirection() {
 }
 
 double MotorGroup::getEfficiency() {
+  if (aggregateTelemetry) {
+    return reduceField(motors, &AbstractMotor::getEfficiency).mean;
+  }
   return motors[0]->getEfficiency();
 }
 
 std::int32_t MotorGroup::isOverCurrent() {
+  if (aggregateTelemetry) {
+    return std::any_of(motors.begin(), motors.end(), [](const auto &imotor) {
+      return imotor->isOverCurrent() == 1;
+    });
+  }
   return motors[0]->isOverCurrent();
 }
 
 std::int32_t MotorGroup::isOverTemp() {
+  if (aggregateTelemetry) {
+    return std::any_of(motors.begin(), motors.end(), [](const auto &imotor) {
+      return imotor->isOverTemp() == 1;
+    });
+  }
   return motors[0]->isOverTemp();
 }
 
@@ -143,10 +257,22 @@ std::int32_t MotorGroup::getZeroPositionFlag() {
 }
 
 uint32_t MotorGroup::getFaults() {
+  if (aggregateTelemetry) {
+    return std::accumulate(
+      motors.begin(), motors.end(), std::uint32_t{0}, [](const auto iout, const auto &imotor) {
+        return iout | imotor->getFaults();
+      });
+  }
   return motors[0]->getFaults();
 }
 
 uint32_t MotorGroup::getFlags() {
+  if (aggregateTelemetry) {
+    return std::accumulate(
+      motors.begin(), motors.end(), std::uint32_t{0}, [](const auto iout, const auto &imotor) {
+        return iout | imotor->getFlags();
+      });
+  }
   return motors[0]->getFlags();
 }
 
@@ -155,18 +281,30 @@ std::int32_t MotorGroup::getRawPosition(std::uint32_t *timestamp) {
 }
 
 double MotorGroup::getPower() {
+  if (aggregateTelemetry) {
+    return reduceField(motors, &AbstractMotor::getPower).sum;
+  }
   return motors[0]->getPower();
 }
 
 double MotorGroup::getTemperature() {
+  if (aggregateTelemetry) {
+    return reduceField(motors, &AbstractMotor::getTemperature).max;
+  }
   return motors[0]->getTemperature();
 }
 
 double MotorGroup::getTorque() {
+  if (aggregateTelemetry) {
+    return reduceField(motors, &AbstractMotor::getTorque).sum;
+  }
   return motors[0]->getTorque();
 }
 
 std::int32_t MotorGroup::getVoltage() {
+  if (aggregateTelemetry) {
+    return toInt32Reading(reduceField(motors, &AbstractMotor::getVoltage).mean);
+  }
   return motors[0]->getVoltage();
 }
 
@@ -231,6 +369,7 @@ AbstractMotor::gearset MotorGroup::getGearing() {
 }
 
 std::int32_t MotorGroup::setReversed(const bool ireverse) {
+  writeCoalescer.invalidate();
   auto out = 1;
   for (auto &&elem : motors) {
     const auto errorCode = elem->setReversed(ireverse);
@@ -253,6 +392,7 @@ std::int32_t MotorGroup::setVoltageLimit(const std::int32_t ilimit) {
 }
 
 void MotorGroup::controllerSet(const double ivalue) {
+  writeCoalescer.invalidate();
   for (auto &&elem : motors) {
     elem->controllerSet(ivalue);
   }
@@ -269,4 +409,67 @@ std::shared_ptr<ContinuousRotarySensor> MotorGroup::getEncoder() {
 std::shared_ptr<ContinuousRotarySensor> MotorGroup::getEncoder(const std::size_t index) {
   return motors[index]->getEncoder();
 }
+
+MotorGroupTelemetry MotorGroup::getTelemetry() {
+  FieldAccumulator position, actualVelocity, currentDraw, efficiency, power, temperature, torque,
+    voltage;
+  MotorGroupTelemetry out;
+
+  for (auto &&elem : motors) {
+    const double motorPosition = elem->getPosition();
+    if (isErrorReading(motorPosition)) {
+      // The motor is not responding, so its other readings would fail too
+      continue;
+    }
+
+    position.add(motorPosition);
+    actualVelocity.add(elem->getActualVelocity());
+    currentDraw.add(elem->getCurrentDraw());
+    efficiency.add(elem->getEfficiency());
+    power.add(elem->getPower());
+    temperature.add(elem->getTemperature());
+    torque.add(elem->getTorque());
+    voltage.add(elem->getVoltage());
+    out.faults |= elem->getFaults();
+    out.flags |= elem->getFlags();
+  }
+
+  out.position = position.get();
+  out.actualVelocity = actualVelocity.get();
+  out.currentDraw = currentDraw.get();
+  out.efficiency = efficiency.get();
+  out.power = power.get();
+  out.temperature = temperature.get();
+  out.torque = torque.get();
+  out.voltage = voltage.get();
+  out.respondingMotors = position.getCount();
+  return out;
+}
+
+void MotorGroup::setAggregateTelemetry(const bool ienabled) {
+  aggregateTelemetry = ienabled;
+}
+
+bool MotorGroup::isAggregateTelemetry() const {
+  return aggregateTelemetry;
+}
+
+void MotorGroup::setWriteCoalescing(const bool ienabled, const QTime irefreshPeriod) {
+  writeCoalescer.setRefreshPeriod(irefreshPeriod);
+  writeCoalescer.setEnabled(ienabled);
+}
+
+void MotorGroup::setLoadBalancing(const bool ienabled, const MotorLoadBalancerParams &iparams) {
+  writeCoalescer.invalidate();
+  if (ienabled) {
+    loadBalancer = std::make_unique<MotorLoadBalancer>(motors.size(), iparams);
+    lastBalanceTime = pros::millis();
+  } else {
+    loadBalancer.reset();
+  }
+}
+
+bool MotorGroup::isLoadBalancing() const {
+  return loadBalancer != nullptr;
+}
 } // namespace okapi
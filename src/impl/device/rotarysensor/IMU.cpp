@@ -7,6 +7,11 @@
 #include "okapi/api/odometry/odomMath.hpp"
 
 namespace okapi {
+namespace {
+constexpr std::uint32_t calibrationMinTime = 2000;
+constexpr std::uint32_t calibrationMaxTime = 5000;
+} // namespace
+
 IMU::IMU(const std::uint8_t iport, const IMUAxes iaxis) : port(iport), axis(iaxis) {
 }
 
@@ -18,7 +23,7 @@ double IMU::get() const {
   }
 
   // Account for the offset after checking for PROS_ERR
-  return OdomMath::constrainAngle180((angle - offset) * degree).convert(degree);
+  return unit_cast<degree>(OdomMath::constrainAngle180((angle - offset) * degree));
 }
 
 double IMU::getRemapped(const double iupperBound, const double ilowerBound) const {
@@ -47,6 +52,43 @@ double IMU::getAcceleration() const {
   return PROS_ERR;
 }
 
+IMUSample IMU::getSample() const {
+  const pros::c::euler_s_t eu = pros::c::imu_get_euler(port);
+  if (eu.yaw == PROS_ERR_F || eu.yaw == PROS_ERR) {
+    return IMUSample{};
+  }
+
+  const pros::c::imu_gyro_s_t gyro = pros::c::imu_get_gyro_rate(port);
+  const pros::c::imu_accel_s_t accel = pros::c::imu_get_accel(port);
+
+  double angle = 0;
+  switch (axis) {
+  case IMUAxes::x:
+    angle = eu.roll;
+    break;
+  case IMUAxes::y:
+    angle = eu.pitch;
+    break;
+  case IMUAxes::z:
+    angle = eu.yaw;
+    break;
+  }
+
+  IMUSample out;
+  out.angle = unit_cast<degree>(OdomMath::constrainAngle180((angle - offset) * degree));
+  out.pitch = eu.pitch;
+  out.roll = eu.roll;
+  out.yaw = eu.yaw;
+  out.gyroX = gyro.x;
+  out.gyroY = gyro.y;
+  out.gyroZ = gyro.z;
+  out.accelX = accel.x;
+  out.accelY = accel.y;
+  out.accelZ = accel.z;
+  out.valid = true;
+  return out;
+}
+
 std::int32_t IMU::reset() {
   offset = readAngle();
   if (offset == PROS_ERR) {
@@ -66,34 +108,53 @@ std::int32_t IMU::reset(double inewAngle) {
   }
 }
 
+std::int32_t IMU::setDataRate(const QTime iperiod) {
+  return pros::c::imu_set_data_rate(port,
+                                    static_cast<std::uint32_t>(iperiod.convert(millisecond)));
+}
+
 std::int32_t IMU::calibrate() {
+  const std::int32_t result = calibrateAsync();
+
+  // Don't wait for calibration if the reset failed
+  if (result == PROS_ERR) {
+    return PROS_ERR;
+  }
+
+  return waitForCalibration();
+}
+
+std::int32_t IMU::calibrateAsync() {
   const std::int32_t result = pros::c::imu_reset(port);
 
-  // Don't reset the offset or wait for calibration if the reset failed
+  // Don't reset the offset if the reset failed
   if (result == PROS_ERR) {
     return PROS_ERR;
   }
 
   offset = 0;
+  calibrationStart = pros::millis();
+  return 1;
+}
+
+bool IMU::isCalibrated() const {
+  // Calibration should take approximately two seconds. The IMU might not report that it is
+  // calibrating right after the reset, so don't trust its status before then.
+  return pros::millis() - calibrationStart >= calibrationMinTime && !isCalibrating();
+}
+
+std::int32_t IMU::waitForCalibration() {
+  // We bound the maximum delay time to ensure that this function does not hang indefinitely
+  while (!isCalibrated()) {
+    if (pros::millis() - calibrationStart >= calibrationMaxTime) {
+      errno = EAGAIN;
+      return PROS_ERR;
+    }
 
-  // This operation should take approximately two seconds, so wait two seconds and then wait for it
-  // to finish. We bound the maximum delay time to ensure that this function does not hang
-  // indefinitely.
-  const uint32_t maxDelayTime = 5000;
-  const uint32_t before = pros::millis();
-  pros::delay(2000);
-  while (isCalibrating() && pros::millis() - before < maxDelayTime) {
     pros::delay(10);
   }
 
-  if (pros::millis() - before < maxDelayTime) {
-    // We did not timeout
-    return 1;
-  } else {
-    // We timed out
-    errno = EAGAIN;
-    return PROS_ERR;
-  }
+  return 1;
 }
 
 double IMU::controllerGet() {
@@ -18,6 +18,13 @@ double IntegratedEncoder::get() const {
   return pros::c::motor_get_position(port) * reversed;
 }
 
+double IntegratedEncoder::getTimestamped(std::uint32_t &otimestamp) const {
+  // PROS only has a timestamp for the raw count. Both are read from the same packet from the
+  // motor, so the timestamp also applies to the position.
+  pros::c::motor_get_raw_position(port, &otimestamp);
+  return get();
+}
+
 std::int32_t IntegratedEncoder::reset() {
   return pros::c::motor_tare_position(port);
 }
@@ -15,9 +15,22 @@ Potentiometer::Potentiometer(std::pair<std::uint8_t, std::uint8_t> iports)
 }
 
 double Potentiometer::get() const {
+  const std::int32_t raw = getRaw();
+  if (raw == PROS_ERR || !calibration) {
+    return raw;
+  }
+
+  return (*calibration)(raw);
+}
+
+std::int32_t Potentiometer::getRaw() const {
   return pros::c::ext_adi_analog_read(smartPort, port);
 }
 
+void Potentiometer::setCalibration(std::shared_ptr<const PotentiometerCalibration> icalibration) {
+  calibration = std::move(icalibration);
+}
+
 double Potentiometer::controllerGet() {
   return get();
 }
@@ -11,8 +11,8 @@ RotationSensor::RotationSensor(const std::uint8_t iport, const bool ireversed)
 }
 
 double RotationSensor::get() const {
-  const double out = pros::c::rotation_get_position(port);
-  if (out == PROS_ERR_F) {
+  const std::int32_t out = pros::c::rotation_get_position(port);
+  if (out == PROS_ERR) {
     return PROS_ERR_F;
   } else {
     // Convert from centidegrees to degrees
@@ -21,8 +21,8 @@ double RotationSensor::get() const {
 }
 
 double RotationSensor::getVelocity() const {
-  const double out = pros::c::rotation_get_velocity(port);
-  if (out == PROS_ERR_F) {
+  const std::int32_t out = pros::c::rotation_get_velocity(port);
+  if (out == PROS_ERR) {
     return PROS_ERR_F;
   } else {
     // Convert from centidegrees per second to degrees per second
@@ -30,6 +30,18 @@ double RotationSensor::getVelocity() const {
   }
 }
 
+bool RotationSensor::measuresVelocity() const {
+  return true;
+}
+
+std::uint8_t RotationSensor::getPort() const {
+  return port;
+}
+
+bool RotationSensor::isReversed() const {
+  return reversed < 0;
+}
+
 std::int32_t RotationSensor::reset() {
   return pros::c::rotation_reset(port);
 }
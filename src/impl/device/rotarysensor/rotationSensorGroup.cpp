@@ -0,0 +1,39 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#include "okapi/impl/device/rotarysensor/rotationSensorGroup.hpp"
+
+namespace okapi {
+RotationSensorGroup::RotationSensorGroup(const std::vector<RotationSensor> &isensors)
+  : RotarySensorGroup(share(isensors)) {
+  for (const auto &sensor : isensors) {
+    ports.push_back(sensor.getPort());
+
+    // Convert from centidegrees to degrees
+    scales.push_back(sensor.isReversed() ? -0.01 : 0.01);
+  }
+}
+
+std::size_t RotationSensorGroup::read(double *ovalues, std::uint32_t *otimestamps) const {
+  for (std::size_t i = 0; i < ports.size(); i++) {
+    const std::int32_t out = pros::c::rotation_get_position(ports[i]);
+    ovalues[i] = out == PROS_ERR ? PROS_ERR_F : out * scales[i];
+    otimestamps[i] = 0;
+  }
+
+  return ports.size();
+}
+
+std::vector<std::shared_ptr<ContinuousRotarySensor>>
+RotationSensorGroup::share(const std::vector<RotationSensor> &isensors) {
+  std::vector<std::shared_ptr<ContinuousRotarySensor>> sensors;
+  sensors.reserve(isensors.size());
+  for (const auto &sensor : isensors) {
+    sensors.push_back(std::make_shared<RotationSensor>(sensor));
+  }
+
+  return sensors;
+}
+} // namespace okapi
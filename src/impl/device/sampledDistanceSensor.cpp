@@ -0,0 +1,32 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#include "okapi/impl/device/sampledDistanceSensor.hpp"
+#include "okapi/impl/util/timeUtilFactory.hpp"
+
+namespace okapi {
+SampledDistanceSensor::SampledDistanceSensor(const std::uint8_t iport,
+                                             std::unique_ptr<Filter> ifilter,
+                                             const double iminConfidence,
+                                             const QTime &isamplePeriod,
+                                             std::shared_ptr<Logger> ilogger)
+  : SensorSamplingService(
+      [iport]() {
+        const std::int32_t distance = pros::c::distance_get(iport);
+        if (distance == PROS_ERR) {
+          return SensorSample{static_cast<double>(PROS_ERR), 0};
+        }
+
+        return SensorSample{static_cast<double>(distance),
+                            static_cast<double>(pros::c::distance_get_confidence(iport))};
+      },
+      std::move(ifilter),
+      iminConfidence,
+      TimeUtilFactory::createDefault(),
+      isamplePeriod,
+      std::move(ilogger)) {
+  startThread();
+}
+} // namespace okapi
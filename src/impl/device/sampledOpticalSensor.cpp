@@ -0,0 +1,34 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#include "okapi/impl/device/sampledOpticalSensor.hpp"
+#include "okapi/impl/util/timeUtilFactory.hpp"
+
+namespace okapi {
+SampledOpticalSensor::SampledOpticalSensor(const std::uint8_t iport,
+                                           const OpticalSensorOutput ioutput,
+                                           std::unique_ptr<Filter> ifilter,
+                                           const QTime &isamplePeriod,
+                                           std::shared_ptr<Logger> ilogger)
+  : SensorSamplingService(
+      [iport, ioutput]() {
+        switch (ioutput) {
+        case OpticalSensorOutput::saturation:
+          return SensorSample{pros::c::optical_get_saturation(iport), 1};
+        case OpticalSensorOutput::brightness:
+          return SensorSample{pros::c::optical_get_brightness(iport), 1};
+        case OpticalSensorOutput::hue:
+        default:
+          return SensorSample{pros::c::optical_get_hue(iport), 1};
+        }
+      },
+      std::move(ifilter),
+      0,
+      TimeUtilFactory::createDefault(),
+      isamplePeriod,
+      std::move(ilogger)) {
+  startThread();
+}
+} // namespace okapi
@@ -0,0 +1,50 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#include "okapi/impl/device/serialPort.hpp"
+#include <algorithm>
+
+namespace okapi {
+SerialPort::SerialPort(const std::uint8_t iport,
+                       const std::int32_t ibaudrate,
+                       std::shared_ptr<Logger> ilogger)
+  : logger(std::move(ilogger)), port(iport) {
+  if (pros::c::serial_enable(port) == PROS_ERR ||
+      pros::c::serial_set_baudrate(port, ibaudrate) == PROS_ERR) {
+    LOG_ERROR("SerialPort: Couldn't open port " + std::to_string(port) + " as a serial port.");
+  }
+}
+
+std::size_t SerialPort::read(std::uint8_t *obuffer, const std::size_t ilength) {
+  const std::int32_t available = pros::c::serial_get_read_avail(port);
+  if (available == PROS_ERR || available <= 0) {
+    return 0;
+  }
+
+  const auto length =
+    static_cast<std::int32_t>(std::min(ilength, static_cast<std::size_t>(available)));
+  const std::int32_t count = pros::c::serial_read(port, obuffer, length);
+  return count == PROS_ERR || count < 0 ? 0 : static_cast<std::size_t>(count);
+}
+
+std::size_t SerialPort::write(const std::uint8_t *ibuffer, const std::size_t ilength) {
+  const std::int32_t writeFree = pros::c::serial_get_write_free(port);
+  if (writeFree == PROS_ERR || writeFree <= 0) {
+    return 0;
+  }
+
+  const auto length =
+    static_cast<std::int32_t>(std::min(ilength, static_cast<std::size_t>(writeFree)));
+
+  // serial_write does not modify the buffer
+  const std::int32_t count =
+    pros::c::serial_write(port, const_cast<std::uint8_t *>(ibuffer), length);
+  return count == PROS_ERR || count < 0 ? 0 : static_cast<std::size_t>(count);
+}
+
+std::uint8_t SerialPort::getPort() const {
+  return port;
+}
+} // namespace okapi
@@ -0,0 +1,47 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#include "okapi/impl/device/visionSensor.hpp"
+#include "okapi/impl/util/timeUtilFactory.hpp"
+#include <algorithm>
+#include <cerrno>
+
+namespace okapi {
+VisionSensor::VisionSensor(const std::uint8_t iport,
+                           const QTime &isamplePeriod,
+                           const QTime &ilatency,
+                           std::shared_ptr<Logger> ilogger)
+  : VisionSamplingService(
+      [iport](VisionObject *oobjects, const std::size_t imaxCount) -> std::int32_t {
+        pros::vision_object_s_t objects[VisionFrame::maxObjects];
+        const std::int32_t count = pros::c::vision_read_by_size(
+          iport, 0, std::min(imaxCount, VisionFrame::maxObjects), objects);
+        if (count == PROS_ERR) {
+          // The sensor reports seeing no objects as an error
+          return errno == EDOM ? 0 : PROS_ERR;
+        }
+
+        for (std::int32_t i = 0; i < count; i++) {
+          oobjects[i].signature = objects[i].signature;
+          oobjects[i].x = objects[i].x_middle_coord;
+          oobjects[i].y = objects[i].y_middle_coord;
+          oobjects[i].width = static_cast<std::uint16_t>(objects[i].width);
+          oobjects[i].height = static_cast<std::uint16_t>(objects[i].height);
+        }
+        return count;
+      },
+      TimeUtilFactory::createDefault(),
+      isamplePeriod,
+      ilatency,
+      std::move(ilogger)),
+    port(iport) {
+  pros::c::vision_set_zero_point(port, pros::E_VISION_ZERO_CENTER);
+  startThread();
+}
+
+std::uint8_t VisionSensor::getPort() const {
+  return port;
+}
+} // namespace okapi
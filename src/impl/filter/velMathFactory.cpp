@@ -42,4 +42,24 @@ std::unique_ptr<VelMath> VelMathFactory::createPtr(const double iticksPerRev,
   return std::make_unique<VelMath>(
     iticksPerRev, std::move(ifilter), isampleTime, std::make_unique<Timer>(), ilogger);
 }
+
+std::unique_ptr<VelMath>
+VelMathFactory::createLeastSquaresPtr(const double iticksPerRev,
+                                      const std::size_t iwindowSize,
+                                      const QTime isampleTime,
+                                      const std::shared_ptr<Logger> &ilogger) {
+  return std::make_unique<LeastSquaresVelMath>(
+    iticksPerRev, iwindowSize, isampleTime, std::make_unique<Timer>(), ilogger);
+}
+
+std::unique_ptr<VelMath>
+VelMathFactory::createAlphaBetaPtr(const double iticksPerRev,
+                                   const double ialpha,
+                                   const double ibeta,
+                                   const double igamma,
+                                   const QTime isampleTime,
+                                   const std::shared_ptr<Logger> &ilogger) {
+  return std::make_unique<AlphaBetaVelMath>(
+    iticksPerRev, ialpha, ibeta, igamma, isampleTime, std::make_unique<Timer>(), ilogger);
+}
 } // namespace okapi
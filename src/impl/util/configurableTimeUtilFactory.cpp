@@ -8,13 +8,15 @@
 namespace okapi {
 ConfigurableTimeUtilFactory::ConfigurableTimeUtilFactory(const double iatTargetError,
                                                          const double iatTargetDerivative,
-                                                         const QTime &iatTargetTime)
+                                                         const QTime &iatTargetTime,
+                                                         const resolution iresolution)
   : atTargetError(iatTargetError),
     atTargetDerivative(iatTargetDerivative),
-    atTargetTime(iatTargetTime) {
+    atTargetTime(iatTargetTime),
+    timeResolution(iresolution) {
 }
 
 TimeUtil ConfigurableTimeUtilFactory::create() {
-  return withSettledUtilParams(atTargetError, atTargetDerivative, atTargetTime);
+  return withSettledUtilParams(atTargetError, atTargetDerivative, atTargetTime, timeResolution);
 }
 } // namespace okapi
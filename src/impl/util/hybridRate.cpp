@@ -0,0 +1,48 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#include "okapi/impl/util/hybridRate.hpp"
+#include "api.h"
+
+namespace okapi {
+HybridRate::HybridRate(const QTime ispinWindow)
+  : spinWindow(static_cast<std::uint64_t>(ispinWindow.convert(microsecond))) {
+}
+
+void HybridRate::delay(const QFrequency ihz) {
+  delayUntil(1 / ihz);
+}
+
+void HybridRate::delayUntil(const QTime itime) {
+  const auto now = CrossplatformClock::micros();
+  if (lastTime == 0) {
+    // First call
+    lastTime = now;
+  }
+
+  lastTime += static_cast<std::uint64_t>(itime.convert(microsecond));
+  if (lastTime <= now) {
+    // The task ran past the end of its period, so start the next period now instead of running
+    // the missed ones back to back
+    lastTime = now;
+    return;
+  }
+
+  if (const auto remaining = lastTime - now; remaining > spinWindow) {
+    pros::delay(static_cast<std::uint32_t>((remaining - spinWindow) / 1000));
+  }
+
+  while (CrossplatformClock::micros() < lastTime) {
+  }
+}
+
+void HybridRate::delayUntil(const uint32_t ims) {
+  delayUntil(ims * millisecond);
+}
+
+void HybridRate::reset() {
+  lastTime = 0;
+}
+} // namespace okapi
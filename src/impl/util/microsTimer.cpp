@@ -0,0 +1,16 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#include "okapi/impl/util/microsTimer.hpp"
+#include "okapi/api/coreProsAPI.hpp"
+
+namespace okapi {
+MicrosTimer::MicrosTimer() : AbstractTimer(millis()) {
+}
+
+QTime MicrosTimer::millis() const {
+  return static_cast<double>(CrossplatformClock::micros()) * microsecond;
+}
+} // namespace okapi
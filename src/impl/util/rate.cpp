@@ -25,4 +25,8 @@ void Rate::delayUntil(const uint32_t ims) {
 
   pros::Task::delay_until(&lastTime, ims);
 }
+
+void Rate::reset() {
+  lastTime = 0;
+}
 } // namespace okapi
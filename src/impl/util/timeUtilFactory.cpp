@@ -4,6 +4,8 @@
  * file, You can obtain one at http://mozilla.org/MPL/2.0/.
  */
 #include "okapi/impl/util/timeUtilFactory.hpp"
+#include "okapi/impl/util/hybridRate.hpp"
+#include "okapi/impl/util/microsTimer.hpp"
 #include "okapi/impl/util/rate.hpp"
 #include "okapi/impl/util/timer.hpp"
 
@@ -12,23 +14,38 @@ TimeUtil TimeUtilFactory::create() {
   return TimeUtilFactory::createDefault();
 }
 
-TimeUtil TimeUtilFactory::createDefault() {
+TimeUtil TimeUtilFactory::createDefault(const resolution iresolution) {
   return TimeUtil(
-    Supplier<std::unique_ptr<AbstractTimer>>([]() { return std::make_unique<Timer>(); }),
-    Supplier<std::unique_ptr<AbstractRate>>([]() { return std::make_unique<Rate>(); }),
+    Supplier<std::unique_ptr<AbstractTimer>>([=]() { return createTimer(iresolution); }),
+    Supplier<std::unique_ptr<AbstractRate>>([=]() { return createRate(iresolution); }),
     Supplier<std::unique_ptr<SettledUtil>>(
-      []() { return std::make_unique<SettledUtil>(std::make_unique<Timer>()); }));
+      [=]() { return std::make_unique<SettledUtil>(createTimer(iresolution)); }));
 }
 
 TimeUtil TimeUtilFactory::withSettledUtilParams(const double iatTargetError,
                                                 const double iatTargetDerivative,
-                                                const QTime &iatTargetTime) {
+                                                const QTime &iatTargetTime,
+                                                const resolution iresolution) {
   return TimeUtil(
-    Supplier<std::unique_ptr<AbstractTimer>>([]() { return std::make_unique<Timer>(); }),
-    Supplier<std::unique_ptr<AbstractRate>>([]() { return std::make_unique<Rate>(); }),
+    Supplier<std::unique_ptr<AbstractTimer>>([=]() { return createTimer(iresolution); }),
+    Supplier<std::unique_ptr<AbstractRate>>([=]() { return createRate(iresolution); }),
     Supplier<std::unique_ptr<SettledUtil>>([=]() {
       return std::make_unique<SettledUtil>(
-        std::make_unique<Timer>(), iatTargetError, iatTargetDerivative, iatTargetTime);
+        createTimer(iresolution), iatTargetError, iatTargetDerivative, iatTargetTime);
     }));
 }
+
+std::unique_ptr<AbstractTimer> TimeUtilFactory::createTimer(const resolution iresolution) {
+  if (iresolution == resolution::microseconds) {
+    return std::make_unique<MicrosTimer>();
+  }
+  return std::make_unique<Timer>();
+}
+
+std::unique_ptr<AbstractRate> TimeUtilFactory::createRate(const resolution iresolution) {
+  if (iresolution == resolution::microseconds) {
+    return std::make_unique<HybridRate>();
+  }
+  return std::make_unique<Rate>();
+}
 } // namespace okapi
@@ -13,6 +13,7 @@
 #include "test/tests/impl/chassisControllerIntegratedTests.hpp"
 #include "test/tests/impl/chassisControllerPidTests.hpp"
 #include "test/tests/impl/controllerTests.hpp"
+#include "test/tests/impl/performanceTests.hpp"
 #include "test/tests/impl/utilTests.hpp"
 
 using namespace okapi;
@@ -27,5 +28,6 @@ void runAllImplTests() {
   runControllerTests();
   //  runChassisControllerPidTests();
   //  runChassisControllerIntegratedTests();
+  //  runPerformanceTests();
   test_print_report();
 }
@@ -0,0 +1,300 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#include "test/tests/impl/performanceTests.hpp"
+#include "test/testRunner.hpp"
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstdio>
+#include <vector>
+
+using namespace okapi;
+using namespace snowhouse;
+
+namespace {
+/**
+ * The distribution of the times measured for one benchmark, in microseconds.
+ */
+struct PerfResult {
+  std::string name;
+  std::size_t samples;
+  double min;
+  double mean;
+  double max;
+  double p99;
+};
+
+std::vector<PerfResult> results;
+
+void record(const std::string &iname, std::vector<double> &itimes) {
+  std::sort(itimes.begin(), itimes.end());
+
+  double sum = 0;
+  for (const double time : itimes) {
+    sum += time;
+  }
+
+  const auto p99Index = static_cast<std::size_t>(std::ceil(0.99 * itimes.size())) - 1;
+  results.push_back(PerfResult{iname,
+                               itimes.size(),
+                               itimes.front(),
+                               sum / itimes.size(),
+                               itimes.back(),
+                               itimes.at(p99Index)});
+
+  const auto &result = results.back();
+  printf("%-36s min=%8.1fus mean=%8.1fus max=%8.1fus p99=%8.1fus\n",
+         iname.c_str(),
+         result.min,
+         result.mean,
+         result.max,
+         result.p99);
+}
+
+/**
+ * Times each of a number of calls of a function.
+ */
+template <typename F>
+void measure(const std::string &iname, const std::size_t isamples, const F &ifunc) {
+  std::vector<double> times;
+  times.reserve(isamples);
+
+  for (std::size_t i = 0; i < isamples; i++) {
+    const auto start = CrossplatformClock::micros();
+    ifunc();
+    times.push_back(static_cast<double>(CrossplatformClock::micros() - start));
+  }
+
+  record(iname, times);
+}
+
+void testMotorCalls() {
+  printf("Measuring Motor calls\n");
+  resetHardware();
+
+  Motor motor(MOTOR_1_PORT);
+  measure("Motor::getPosition", 1000, [&] { motor.getPosition(); });
+  measure("Motor::getActualVelocity", 1000, [&] { motor.getActualVelocity(); });
+  measure("Motor::getCurrentDraw", 1000, [&] { motor.getCurrentDraw(); });
+  measure("Motor::getTemperature", 1000, [&] { motor.getTemperature(); });
+  measure("Motor::moveVoltage", 1000, [&] { motor.moveVoltage(0); });
+  measure("Motor::moveVelocity", 1000, [&] { motor.moveVelocity(0); });
+
+  resetHardware();
+}
+
+void testMotorGroupCalls() {
+  printf("Measuring MotorGroup fan-out\n");
+  resetHardware();
+
+  MotorGroup group({MOTOR_1_PORT, MOTOR_2_PORT});
+  measure("MotorGroup(2)::getPosition", 1000, [&] { group.getPosition(); });
+  measure("MotorGroup(2)::getActualVelocity", 1000, [&] { group.getActualVelocity(); });
+  measure("MotorGroup(2)::moveVoltage", 1000, [&] { group.moveVoltage(0); });
+  measure("MotorGroup(2)::moveVelocity", 1000, [&] { group.moveVelocity(0); });
+
+  resetHardware();
+}
+
+void measureLogger(const std::string &isink, const std::shared_ptr<Logger> &ilogger) {
+  measure("Logger " + isink, 200, [&] {
+    ilogger->info([]() { return std::string("Performance test log statement"); });
+  });
+
+  if (ilogger->getDroppedCount() != 0) {
+    printf("Logger %s dropped %u statements\n", isink.c_str(), ilogger->getDroppedCount());
+  }
+
+  ilogger->close();
+}
+
+void testLoggerSinks() {
+  printf("Measuring Logger sinks\n");
+
+  const auto timer = []() { return TimeUtilFactory::createDefault().getTimer(); };
+  const std::string file = "/usd/okapi_perf.log";
+
+  measureLogger(
+    "capture",
+    std::make_shared<Logger>(timer(), std::make_shared<LogCapture>(), Logger::LogLevel::info));
+  measureLogger("serial", std::make_shared<Logger>(timer(), "/ser/sout", Logger::LogLevel::info));
+  measureLogger("SD card", std::make_shared<Logger>(timer(), file, Logger::LogLevel::info));
+
+  auto buffered = std::make_shared<Logger>(timer(), file, Logger::LogLevel::info);
+  buffered->startBuffered();
+  measureLogger("SD card buffered", buffered);
+
+  auto async = std::make_shared<Logger>(timer(), file, Logger::LogLevel::info);
+  async->startAsync();
+  measureLogger("SD card async", async);
+}
+
+/**
+ * Takes a mutex for 100 us every millisecond until it is told to stop.
+ */
+struct MutexContender {
+  CrossplatformMutex &mutex;
+  std::atomic_bool stop{false};
+  std::atomic_bool stopped{false};
+
+  static void trampoline(void *context) {
+    auto *contender = static_cast<MutexContender *>(context);
+    while (!contender->stop.load(std::memory_order_acquire)) {
+      contender->mutex.lock();
+      const auto start = CrossplatformClock::micros();
+      while (CrossplatformClock::micros() - start < 100) {
+      }
+      contender->mutex.unlock();
+      pros::delay(1);
+    }
+
+    contender->stopped.store(true, std::memory_order_release);
+  }
+};
+
+void testMutexContention() {
+  printf("Measuring CrossplatformMutex\n");
+
+  CrossplatformMutex mutex;
+  measure("CrossplatformMutex uncontended", 1000, [&] {
+    mutex.lock();
+    mutex.unlock();
+  });
+
+  MutexContender contender{mutex};
+  {
+    CrossplatformThread thread(MutexContender::trampoline, &contender, "MutexContender");
+
+    // Time only the wait for the mutex, and give the contender time to take it between samples
+    std::vector<double> times;
+    times.reserve(1000);
+    for (int i = 0; i < 1000; i++) {
+      const auto start = CrossplatformClock::micros();
+      mutex.lock();
+      times.push_back(static_cast<double>(CrossplatformClock::micros() - start));
+      mutex.unlock();
+      pros::delay(1);
+    }
+    record("CrossplatformMutex contended lock", times);
+
+    // The contender must not be deleted while it holds the mutex
+    contender.stop.store(true, std::memory_order_release);
+    while (!contender.stopped.load(std::memory_order_acquire)) {
+      pros::delay(1);
+    }
+  }
+}
+
+/**
+ * Records how far each period of a rate was from the period it was asked for.
+ */
+void measureRate(const std::string &iname,
+                 const std::unique_ptr<AbstractRate> &irate,
+                 const QTime &iperiod) {
+  const double period = iperiod.convert(microsecond);
+  std::vector<double> errors;
+  errors.reserve(500);
+
+  // The first delay only marks the start
+  irate->delayUntil(iperiod);
+  auto last = CrossplatformClock::micros();
+  for (int i = 0; i < 500; i++) {
+    irate->delayUntil(iperiod);
+    const auto now = CrossplatformClock::micros();
+    errors.push_back(std::abs(static_cast<double>(now - last) - period));
+    last = now;
+  }
+
+  record(iname, errors);
+}
+
+void testRateJitter() {
+  printf("Measuring Rate jitter\n");
+
+  measureRate("Rate 5 ms jitter", std::make_unique<Rate>(), 5_ms);
+  measureRate("Rate 10 ms jitter", std::make_unique<Rate>(), 10_ms);
+  measureRate("HybridRate 5 ms jitter", std::make_unique<HybridRate>(), 5_ms);
+  measureRate("HybridRate 10 ms jitter", std::make_unique<HybridRate>(), 10_ms);
+}
+
+void testGeneratePath() {
+  printf("Measuring generatePath\n");
+  resetHardware();
+
+  auto left = std::make_shared<Motor>(MOTOR_1_PORT);
+  auto right = std::make_shared<Motor>(MOTOR_2_PORT);
+  auto controller =
+    AsyncMotionProfileControllerBuilder()
+      .withOutput(std::make_shared<SkidSteerModel>(
+                    left, right, left->getEncoder(), right->getEncoder(), 200, 12000),
+                  {{4_in, 11.5_in}, imev5GreenTPR},
+                  AbstractMotor::gearset::green)
+      .withLimits({1.0, 2.0, 10.0})
+      .buildMotionProfileController();
+
+  const std::vector<std::pair<std::string, std::vector<PathfinderPoint>>> paths{
+    {"generatePath straight 1 m", {{0_m, 0_m, 0_deg}, {1_m, 0_m, 0_deg}}},
+    {"generatePath S-curve", {{0_m, 0_m, 0_deg}, {1_m, 0.5_m, 0_deg}}},
+    {"generatePath 3 waypoints",
+     {{0_m, 0_m, 0_deg}, {0.6_m, 0.3_m, 45_deg}, {1.2_m, 0.6_m, 0_deg}}}};
+
+  for (const auto &path : paths) {
+    measure(path.first, 5, [&] {
+      controller->generatePath(path.second, "perf");
+      controller->removePath("perf");
+    });
+  }
+
+  resetHardware();
+}
+
+/**
+ * Appends the results to a CSV file, with a header if the file is new.
+ *
+ * @return Whether the file could be opened.
+ */
+bool writeResults(const std::string &icsvPath) {
+  FILE *file = fopen(icsvPath.c_str(), "a");
+  if (file == nullptr) {
+    return false;
+  }
+
+  fseek(file, 0, SEEK_END);
+  if (ftell(file) == 0) {
+    fprintf(file, "pros_version,benchmark,samples,min_us,mean_us,max_us,p99_us\n");
+  }
+
+  for (const auto &result : results) {
+    fprintf(file,
+            "%s,%s,%u,%.1f,%.1f,%.1f,%.1f\n",
+            PROS_VERSION_STRING,
+            result.name.c_str(),
+            static_cast<unsigned>(result.samples),
+            result.min,
+            result.mean,
+            result.max,
+            result.p99);
+  }
+
+  fclose(file);
+  return true;
+}
+} // namespace
+
+void runPerformanceTests(const std::string &icsvPath) {
+  test_printf("Measuring Performance");
+  results.clear();
+
+  testMotorCalls();
+  testMotorGroupCalls();
+  testLoggerSinks();
+  testMutexContention();
+  testRateJitter();
+  testGeneratePath();
+
+  const bool written = writeResults(icsvPath);
+  test("The results are written to " + icsvPath, TEST_BODY(AssertThat, written, IsTrue()));
+}
@@ -0,0 +1,85 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#include "okapi/api/util/allocationGuard.hpp"
+#include <gtest/gtest.h>
+
+using namespace okapi;
+
+namespace {
+std::size_t lastViolationSize = 0;
+int handlerCalls = 0;
+
+void recordViolation(const std::size_t isize) {
+  lastViolationSize = isize;
+  handlerCalls++;
+
+  // Allocations made by the handler are not reported to it again
+  AllocationGuard::recordAllocation(1);
+}
+} // namespace
+
+class AllocationGuardTest : public ::testing::Test {
+  protected:
+  void SetUp() override {
+    lastViolationSize = 0;
+    handlerCalls = 0;
+  }
+
+  void TearDown() override {
+    AllocationGuard::unseal();
+  }
+};
+
+TEST_F(AllocationGuardTest, AllocationsBeforeSealingAreNotViolations) {
+  const auto allocations = AllocationGuard::getAllocationCount();
+  const auto violations = AllocationGuard::getViolationCount();
+
+  AllocationGuard::recordAllocation(16);
+
+  EXPECT_FALSE(AllocationGuard::isSealed());
+  EXPECT_EQ(AllocationGuard::getAllocationCount(), allocations + 1);
+  EXPECT_EQ(AllocationGuard::getViolationCount(), violations);
+}
+
+TEST_F(AllocationGuardTest, AllocationsWhileSealedCallTheHandler) {
+  const auto violations = AllocationGuard::getViolationCount();
+
+  AllocationGuard::seal(recordViolation);
+  AllocationGuard::recordAllocation(24);
+
+  EXPECT_TRUE(AllocationGuard::isSealed());
+  EXPECT_EQ(handlerCalls, 1);
+  EXPECT_EQ(lastViolationSize, 24u);
+  // The allocation from the handler is still counted
+  EXPECT_EQ(AllocationGuard::getViolationCount(), violations + 2);
+}
+
+TEST_F(AllocationGuardTest, SealingWithoutAHandlerOnlyCounts) {
+  const auto violations = AllocationGuard::getViolationCount();
+
+  AllocationGuard::seal(nullptr);
+  AllocationGuard::recordAllocation(8);
+
+  EXPECT_EQ(AllocationGuard::getViolationCount(), violations + 1);
+}
+
+TEST_F(AllocationGuardTest, UnsealingAllowsAllocationsAgain) {
+  AllocationGuard::seal(recordViolation);
+  AllocationGuard::unseal();
+  AllocationGuard::recordAllocation(8);
+
+  EXPECT_FALSE(AllocationGuard::isSealed());
+  EXPECT_EQ(handlerCalls, 0);
+}
+
+TEST_F(AllocationGuardTest, DefaultHandlerAborts) {
+  EXPECT_DEATH(
+    {
+      AllocationGuard::seal();
+      AllocationGuard::recordAllocation(8);
+    },
+    "");
+}
@@ -0,0 +1,137 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#include "okapi/api/control/async/asyncHolonomicProfileController.hpp"
+#include "test/tests/api/implMocks.hpp"
+#include <gtest/gtest.h>
+
+using namespace okapi;
+
+class MockAsyncHolonomicProfileController : public AsyncHolonomicProfileController {
+  public:
+  using AsyncHolonomicProfileController::AsyncHolonomicProfileController;
+  using AsyncHolonomicProfileController::writeVelocity;
+};
+
+class AsyncHolonomicProfileControllerTest : public ::testing::Test {
+  protected:
+  void SetUp() override {
+    model = std::make_shared<XDriveModel>(topLeftMotor,
+                                          topRightMotor,
+                                          bottomRightMotor,
+                                          bottomLeftMotor,
+                                          std::make_shared<MockContinuousRotarySensor>(),
+                                          std::make_shared<MockContinuousRotarySensor>(),
+                                          200,
+                                          v5MotorMaxVoltage);
+
+    controller = new MockAsyncHolonomicProfileController(
+      createTimeUtil(), {1.0, 4.0, 10.0}, model, scales, AbstractMotor::gearset::green);
+    controller->startThread();
+  }
+
+  void TearDown() override {
+    delete controller;
+  }
+
+  std::shared_ptr<MockMotor> topLeftMotor = std::make_shared<MockMotor>();
+  std::shared_ptr<MockMotor> topRightMotor = std::make_shared<MockMotor>();
+  std::shared_ptr<MockMotor> bottomRightMotor = std::make_shared<MockMotor>();
+  std::shared_ptr<MockMotor> bottomLeftMotor = std::make_shared<MockMotor>();
+  std::shared_ptr<XDriveModel> model;
+  ChassisScales scales{{4_in, 16_in}, imev5GreenTPR};
+  MockAsyncHolonomicProfileController *controller;
+};
+
+TEST_F(AsyncHolonomicProfileControllerTest, ConstructWithGearRatioOf0) {
+  EXPECT_THROW(AsyncHolonomicProfileController(
+                 createTimeUtil(), {}, model, scales, AbstractMotor::gearset::green * 0),
+               std::invalid_argument);
+}
+
+TEST_F(AsyncHolonomicProfileControllerTest, SettledWhenDisabled) {
+  controller->generatePath({{0_m, 0_m, 0_deg}, {0.5_m, 0_m, 0_deg}}, "A");
+  assertControllerIsSettledWhenDisabled(*controller, std::string("A"));
+}
+
+TEST_F(AsyncHolonomicProfileControllerTest, WaitUntilSettledWorksWhenDisabled) {
+  assertWaitUntilSettledWorksWhenDisabled(*controller);
+}
+
+TEST_F(AsyncHolonomicProfileControllerTest, WheelVelocitiesDrivingForward) {
+  const auto wheels =
+    AsyncHolonomicProfileController::toWheelVelocities({1_mps, 0_mps, 0_rpm}, scales);
+  for (const auto &wheel : wheels) {
+    EXPECT_NEAR(wheel.convert(mps), 1 / std::sqrt(2.0), 1e-9);
+  }
+}
+
+TEST_F(AsyncHolonomicProfileControllerTest, WheelVelocitiesStrafingRight) {
+  const auto wheels =
+    AsyncHolonomicProfileController::toWheelVelocities({0_mps, 1_mps, 0_rpm}, scales);
+  EXPECT_GT(wheels[0].convert(mps), 0);
+  EXPECT_LT(wheels[1].convert(mps), 0);
+  EXPECT_GT(wheels[2].convert(mps), 0);
+  EXPECT_LT(wheels[3].convert(mps), 0);
+}
+
+TEST_F(AsyncHolonomicProfileControllerTest, WheelVelocitiesSpinningClockwise) {
+  const auto wheels =
+    AsyncHolonomicProfileController::toWheelVelocities({0_mps, 0_mps, 1 * radps}, scales);
+  const double wheelSpeed = (8_in).convert(meter);
+  EXPECT_NEAR(wheels[0].convert(mps), wheelSpeed, 1e-9);
+  EXPECT_NEAR(wheels[1].convert(mps), -wheelSpeed, 1e-9);
+  EXPECT_NEAR(wheels[2].convert(mps), -wheelSpeed, 1e-9);
+  EXPECT_NEAR(wheels[3].convert(mps), wheelSpeed, 1e-9);
+}
+
+TEST_F(AsyncHolonomicProfileControllerTest, WriteVelocityScalesEveryWheelTogether) {
+  // Far faster than the motors can go, so every wheel is slowed down together
+  controller->writeVelocity({10_mps, 5_mps, 0_rpm});
+
+  EXPECT_EQ(topLeftMotor->lastVelocity, 200);
+  EXPECT_EQ(bottomRightMotor->lastVelocity, 200);
+  EXPECT_EQ(topRightMotor->lastVelocity, 66);
+  EXPECT_EQ(bottomLeftMotor->lastVelocity, 66);
+}
+
+TEST_F(AsyncHolonomicProfileControllerTest, StrafingPathDrivesTheDiagonalsApartAndStops) {
+  controller->moveTo({{0_m, 0_m, 0_deg}, {0_m, 0.2_m, 0_deg}});
+
+  EXPECT_GT(topLeftMotor->maxVelocity, 0);
+  EXPECT_GT(bottomRightMotor->maxVelocity, 0);
+  EXPECT_EQ(topRightMotor->maxVelocity, 0);
+  EXPECT_EQ(bottomLeftMotor->maxVelocity, 0);
+
+  EXPECT_EQ(topLeftMotor->lastVelocity, 0);
+  EXPECT_EQ(topRightMotor->lastVelocity, 0);
+  EXPECT_EQ(bottomRightMotor->lastVelocity, 0);
+  EXPECT_EQ(bottomLeftMotor->lastVelocity, 0);
+  EXPECT_TRUE(controller->isSettled());
+  EXPECT_TRUE(controller->getPaths().empty());
+}
+
+TEST_F(AsyncHolonomicProfileControllerTest, FewerThanTwoWaypointsDoesNotGenerateAPath) {
+  controller->generatePath({{0_m, 0_m, 0_deg}}, "A");
+  EXPECT_TRUE(controller->getPaths().empty());
+}
+
+TEST_F(AsyncHolonomicProfileControllerTest, GenerateWithInvalidLimitsThrows) {
+  EXPECT_THROW(
+    controller->generatePath({{0_m, 0_m, 0_deg}, {1_m, 0_m, 0_deg}}, "A", {0, 1, 0}),
+    std::invalid_argument);
+  EXPECT_THROW(
+    controller->generatePath({{0_m, 0_m, 0_deg}, {1_m, 0_m, 0_deg}}, "A", {1, 0, 0}),
+    std::invalid_argument);
+}
+
+TEST_F(AsyncHolonomicProfileControllerTest, ErrorIsZeroWhenNotRunning) {
+  controller->generatePath({{0_m, 0_m, 0_deg}, {1_m, 0_m, 90_deg}}, "A");
+
+  const auto error = controller->getError();
+  EXPECT_EQ(error.x, 0_m);
+  EXPECT_EQ(error.y, 0_m);
+  EXPECT_EQ(error.theta, 0_deg);
+}
@@ -4,8 +4,13 @@
  * file, You can obtain one at http://mozilla.org/MPL/2.0/.
  */
 #include "okapi/api/control/async/asyncLinearMotionProfileController.hpp"
+#include "okapi/api/util/mathUtil.hpp"
 #include "test/tests/api/implMocks.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
 #include <gtest/gtest.h>
+#include <thread>
 
 using namespace okapi;
 
@@ -14,12 +19,15 @@ class MockAsyncLinearMotionProfileController : public AsyncLinearMotionProfileCo
   using AsyncLinearMotionProfileController::AsyncLinearMotionProfileController;
 
   void executeSinglePath(const std::vector<squiggles::ProfilePoint> &path,
-                         std::unique_ptr<AbstractRate> rate) override {
+                         AbstractRate &rate) override {
     executeSinglePathCalled = true;
-    AsyncLinearMotionProfileController::executeSinglePath(path, std::move(rate));
+    outputsAtPathStart.push_back(
+      std::dynamic_pointer_cast<MockAsyncVelIntegratedController>(output)->lastControllerOutputSet);
+    AsyncLinearMotionProfileController::executeSinglePath(path, rate);
   }
 
   bool executeSinglePathCalled{false};
+  std::vector<double> outputsAtPathStart{};
 };
 
 class AsyncLinearMotionProfileControllerTest : public ::testing::Test {
@@ -59,6 +67,41 @@ TEST_F(AsyncLinearMotionProfileControllerTest, WaitUntilSettledWorksWhenDisabled
   assertWaitUntilSettledWorksWhenDisabled(*controller);
 }
 
+TEST_F(AsyncLinearMotionProfileControllerTest, RegeneratedPathReusesTheRemovedPathsBuffer) {
+  controller->generatePath({0_m, 3_m}, "A");
+  controller->removePath("A");
+  controller->generatePath({0_m, 2_m}, "B");
+
+  const auto stats = controller->getPathPool()->getStats();
+  EXPECT_EQ(stats.allocations, 1u);
+  EXPECT_EQ(stats.reuses, 1u);
+  EXPECT_EQ(stats.pathsInUse, 1u);
+}
+
+TEST_F(AsyncLinearMotionProfileControllerTest, TrackingRecorderRecordsEachStepOfAPath) {
+  auto motor = std::make_shared<MockMotor>();
+  auto recorder = std::make_shared<PathTrackingRecorder>(
+    createTimeUtil(), motor, nullptr, nullptr, PathTrackingRecorder::defaultCapacity, "");
+  controller->setTrackingRecorder(recorder);
+  controller->generatePath({0_m, 0.5_m}, "A");
+  controller->setTarget("A");
+  controller->waitUntilSettled();
+
+  const auto samples = recorder->getSamples();
+  EXPECT_EQ(recorder->getPathId(), "A");
+  ASSERT_GT(samples.size(), 2u);
+  double fastest = 0;
+  for (const auto &sample : samples) {
+    fastest = std::max(fastest, sample.leftCommanded);
+    EXPECT_EQ(sample.leftActual, 0);
+    EXPECT_TRUE(std::isnan(sample.rightCommanded));
+  }
+
+  // 1 m/s on a 1 m wheel through the red gearset is 60 / pi rpm
+  EXPECT_GT(fastest, 0);
+  EXPECT_LE(fastest, 60 / pi + 1e-9);
+}
+
 TEST_F(AsyncLinearMotionProfileControllerTest, MoveToTest) {
   controller->moveTo(0_m, 3_m);
   EXPECT_EQ(output->lastControllerOutputSet, 0);
@@ -126,9 +169,18 @@ TEST_F(AsyncLinearMotionProfileControllerTest, RemoveRunningPath) {
 
   controller->setTarget("A");
 
-  EXPECT_FALSE(controller->removePath("A"));
+  auto rate = createTimeUtil().getRate();
+  while (!controller->executeSinglePathCalled) {
+    rate->delayUntil(1_ms);
+  }
+
+  // The running path keeps its own reference, so removing it always succeeds
+  EXPECT_TRUE(controller->removePath("A"));
+  EXPECT_EQ(controller->getPaths().size(), 0u);
 
-  EXPECT_EQ(controller->getPaths().size(), 1);
+  controller->waitUntilSettled();
+  EXPECT_EQ(output->lastControllerOutputSet, 0);
+  EXPECT_GT(output->maxControllerOutputSet, 0);
 }
 
 TEST_F(AsyncLinearMotionProfileControllerTest, ReplaceRunningPath) {
@@ -138,9 +190,13 @@ TEST_F(AsyncLinearMotionProfileControllerTest, ReplaceRunningPath) {
   controller->flipDisable(false);
 
   controller->generatePath({0_m, 3_m}, "A");
-  EXPECT_EQ(controller->isDisabled(), true);
 
+  // Replacing the path does not interrupt the copy which is running
+  EXPECT_FALSE(controller->isDisabled());
   EXPECT_EQ(controller->getPaths().size(), 1);
+
+  controller->waitUntilSettled();
+  EXPECT_EQ(output->lastControllerOutputSet, 0);
 }
 
 TEST_F(AsyncLinearMotionProfileControllerTest, RemoveAPathWhichDoesNotExist) {
@@ -233,3 +289,107 @@ TEST_F(AsyncLinearMotionProfileControllerTest, FollowPathBackwards) {
   // still running
   controller->flipDisable(true);
 }
+
+TEST_F(AsyncLinearMotionProfileControllerTest, FollowPathSequenceWithoutStopping) {
+  controller->generatePath({0_m, 1_m}, "A", {1.0, 2.0, 10.0}, 0_mps, 0.5_mps);
+  controller->generatePath({1_m, 2_m}, "B", {1.0, 2.0, 10.0}, 0.5_mps, 0_mps);
+  controller->setTargetSequence({"A", "B"});
+  controller->waitUntilSettled();
+
+  ASSERT_EQ(controller->outputsAtPathStart.size(), 2u);
+  EXPECT_EQ(controller->outputsAtPathStart[0], 0);
+  // The output was never stopped between the paths
+  EXPECT_GT(controller->outputsAtPathStart[1], 0);
+  EXPECT_EQ(output->lastControllerOutputSet, 0);
+}
+
+TEST_F(AsyncLinearMotionProfileControllerTest, FollowPathSequenceSkipsMissingPaths) {
+  controller->generatePath({0_m, 1_m}, "A");
+  controller->generatePath({1_m, 2_m}, "B");
+  controller->setTargetSequence({"A", "C", "B"});
+  controller->waitUntilSettled();
+
+  EXPECT_EQ(controller->outputsAtPathStart.size(), 2u);
+  EXPECT_EQ(output->lastControllerOutputSet, 0);
+}
+
+TEST_F(AsyncLinearMotionProfileControllerTest, DisablingCancelsPathSequence) {
+  controller->generatePath({0_m, 3_m}, "A");
+  controller->generatePath({3_m, 6_m}, "B");
+  controller->setTargetSequence({"A", "B"});
+
+  auto rate = createTimeUtil().getRate();
+  while (!controller->executeSinglePathCalled) {
+    rate->delayUntil(1_ms);
+  }
+
+  controller->reset();
+  controller->waitUntilSettled();
+
+  EXPECT_EQ(controller->outputsAtPathStart.size(), 1u);
+  EXPECT_EQ(output->lastControllerOutputSet, 0);
+}
+
+TEST_F(AsyncLinearMotionProfileControllerTest, GeneratePathWithTooFastEndVelocityThrows) {
+  EXPECT_THROW(controller->generatePath({0_m, 1_m}, "A", {1.0, 2.0, 10.0}, 0_mps, 2_mps),
+               std::invalid_argument);
+  EXPECT_EQ(controller->getPaths().size(), 0u);
+}
+
+TEST_F(AsyncLinearMotionProfileControllerTest, FollowPathAtHalfSpeed) {
+  controller->generatePath({0_m, 1_m}, "A");
+  controller->setTarget("A");
+  controller->waitUntilSettled();
+  const auto fullMaxOutput = output->maxControllerOutputSet;
+
+  output->maxControllerOutputSet = 0;
+  controller->setTarget("A", false, 0.5);
+  controller->waitUntilSettled();
+
+  EXPECT_NEAR(output->maxControllerOutputSet, fullMaxOutput / 2, 1e-6);
+  EXPECT_EQ(output->lastControllerOutputSet, 0);
+}
+
+TEST_F(AsyncLinearMotionProfileControllerTest, NonPositiveSpeedScaleThrows) {
+  EXPECT_THROW(controller->setTarget("A", false, 0), std::invalid_argument);
+  EXPECT_THROW(controller->setTargetSequence({"A"}, false, 0), std::invalid_argument);
+}
+
+TEST_F(AsyncLinearMotionProfileControllerTest, FeedbackPushesHarderWhenBehindTheProfile) {
+  controller->generatePath({0_m, 1_m}, "A");
+  controller->setTarget("A");
+  controller->waitUntilSettled();
+  const auto openLoopMaxOutput = output->maxControllerOutputSet;
+
+  // The input never moves, so the robot falls further behind the profile the longer it runs
+  auto pid = std::make_shared<IterativePosPIDController>(0.01, 0, 0, 0, createTimeUtil());
+  controller->setFeedback(std::make_shared<MockControllerInput>(), pid, {}, 100_ms);
+
+  output->maxControllerOutputSet = 0;
+  controller->setTarget("A");
+  std::this_thread::sleep_for(std::chrono::milliseconds(300));
+  EXPECT_NEAR(controller->getError(), 1, 1e-3);
+
+  // The PID could not settle while holding the end, so it gives up after the timeout
+  controller->waitUntilSettled();
+  EXPECT_GT(output->maxControllerOutputSet, openLoopMaxOutput);
+  EXPECT_LE(output->maxControllerOutputSet, 1);
+  EXPECT_EQ(output->lastControllerOutputSet, 0);
+}
+
+TEST_F(AsyncLinearMotionProfileControllerTest, FeedbackIsRemovedWithNullptr) {
+  controller->generatePath({0_m, 1_m}, "A");
+  controller->setTarget("A");
+  controller->waitUntilSettled();
+  const auto openLoopMaxOutput = output->maxControllerOutputSet;
+
+  controller->setFeedback(
+    std::make_shared<MockControllerInput>(),
+    std::make_shared<IterativePosPIDController>(0.01, 0, 0, 0, createTimeUtil()));
+  controller->setFeedback(nullptr, nullptr);
+
+  output->maxControllerOutputSet = 0;
+  controller->setTarget("A");
+  controller->waitUntilSettled();
+  EXPECT_NEAR(output->maxControllerOutputSet, openLoopMaxOutput, 1e-6);
+}
@@ -5,7 +5,10 @@
  */
 #include "okapi/api/control/async/asyncMotionProfileController.hpp"
 #include "test/tests/api/implMocks.hpp"
+#include <chrono>
+#include <cmath>
 #include <fstream>
+#include <sstream>
 #ifdef WINDOWS
 #include <direct.h>
 #define getcwd _getcwd
@@ -19,25 +22,180 @@ using namespace okapi;
 class MockAsyncMotionProfileController : public AsyncMotionProfileController {
   public:
   using AsyncMotionProfileController::AsyncMotionProfileController;
+  using AsyncMotionProfileController::absolutePose;
+  using AsyncMotionProfileController::computeRamseteVelocities;
   using AsyncMotionProfileController::convertLinearToRotational;
+  using AsyncMotionProfileController::incrementalGenerators;
+  using AsyncMotionProfileController::internalLoadBinaryPath;
   using AsyncMotionProfileController::internalLoadPath;
+  using AsyncMotionProfileController::internalLoadPathLibrary;
   using AsyncMotionProfileController::internalLoadPathfinderPath;
+  using AsyncMotionProfileController::internalStoreBinaryPath;
   using AsyncMotionProfileController::internalStorePath;
   using AsyncMotionProfileController::makeFilePath;
+  using AsyncMotionProfileController::pathNames;
+  using AsyncMotionProfileController::paths;
+  using AsyncMotionProfileController::pathTable;
+  using AsyncMotionProfileController::relativePose;
+  using AsyncMotionProfileController::replanReady;
+  using AsyncMotionProfileController::setPathSource;
 
   void executeSinglePath(const std::vector<squiggles::ProfilePoint> &path,
-                         std::unique_ptr<AbstractRate> rate) override {
+                         AbstractRate &rate) override {
     executeSinglePathCalled = true;
-    AsyncMotionProfileController::executeSinglePath(path, std::move(rate));
+    executeSinglePathCount++;
+    followedPathData.push_back(path.data());
+    AsyncMotionProfileController::executeSinglePath(path, rate);
   }
 
-  std::vector<squiggles::ProfilePoint> &getPathData(std::string ipathId) {
-    return paths.at(ipathId);
+  const std::vector<squiggles::ProfilePoint> &getPathData(const std::string &ipathId) {
+    return *paths.at(ipathId);
+  }
+
+  void reloadPath(const std::string &idirectory, const std::string &ipathId) override {
+    reloadedPaths.push_back(ipathId);
+    insertPath(ipathId, pathOnDisk);
+    setPathSource(ipathId, idirectory);
+  }
+
+  std::unique_ptr<std::istream> openStreamedPath(const std::string &,
+                                                 const std::string &ipathId) override {
+    streamedPathsOpened.push_back(ipathId);
+    return std::make_unique<std::stringstream>(streamedFiles[ipathId],
+                                               std::ios::in | std::ios::binary);
+  }
+
+  std::unique_ptr<std::istream> openPathLibrary(const std::string &) override {
+    pathLibrariesOpened++;
+    return std::make_unique<std::stringstream>(pathLibraryFile, std::ios::in | std::ios::binary);
   }
 
   bool executeSinglePathCalled{false};
+  int executeSinglePathCount{0};
+  std::string pathLibraryFile{};
+  int pathLibrariesOpened{0};
+  std::vector<const squiggles::ProfilePoint *> followedPathData{};
+  std::vector<squiggles::ProfilePoint> pathOnDisk{};
+  std::vector<std::string> reloadedPaths{};
+  std::map<std::string, std::string> streamedFiles{};
+  std::vector<std::string> streamedPathsOpened{};
+};
+
+class FixedOdometry : public Odometry {
+  public:
+  void setScales(const ChassisScales &) override {
+  }
+
+  void step() override {
+  }
+
+  OdomState getState(const StateMode &) const override {
+    return state;
+  }
+
+  void setState(const OdomState &istate, const StateMode &) override {
+    state = istate;
+  }
+
+  std::shared_ptr<ReadOnlyChassisModel> getModel() override {
+    return nullptr;
+  }
+
+  ChassisScales getScales() override {
+    return {{4_in, 10_in}, imev5GreenTPR};
+  }
+
+  OdomState state{};
+};
+
+class MockPathTrackingRecorder : public PathTrackingRecorder {
+  public:
+  using PathTrackingRecorder::PathTrackingRecorder;
+
+  std::unique_ptr<std::ostream> openOutput(const std::string &ifileName) override {
+    filesOpened.push_back(ifileName);
+    return std::make_unique<std::ostringstream>();
+  }
+
+  std::vector<std::string> filesOpened{};
+};
+
+class VelocityMockMotor : public MockMotor {
+  public:
+  double getActualVelocity() override {
+    return actualVelocity;
+  }
+
+  double actualVelocity{0};
 };
 
+TEST(PathTrackingRecorderTest, RecordsCommandsNextToTheMeasurements) {
+  auto left = std::make_shared<VelocityMockMotor>();
+  auto right = std::make_shared<VelocityMockMotor>();
+  left->actualVelocity = 90;
+  right->actualVelocity = -45;
+  auto odometry = std::make_shared<FixedOdometry>();
+  odometry->state = {1_m, 2_m, 90_deg};
+
+  MockPathTrackingRecorder recorder(createTimeUtil(), left, right, odometry, 2, "/usd/tracking/");
+  recorder.beginPath("a/b");
+  recorder.record(100, -50);
+  recorder.record(110, -55);
+  recorder.record(120, -60);
+
+  const auto samples = recorder.getSamples();
+  ASSERT_EQ(samples.size(), 2u);
+  EXPECT_EQ(recorder.getDroppedCount(), 1u);
+  EXPECT_GE(samples[0].time, 0);
+  EXPECT_LE(samples[0].time, samples[1].time);
+  EXPECT_EQ(samples[1].leftCommanded, 110);
+  EXPECT_EQ(samples[1].rightCommanded, -55);
+  EXPECT_EQ(samples[1].leftActual, 90);
+  EXPECT_EQ(samples[1].rightActual, -45);
+  EXPECT_EQ(samples[1].x, 1);
+  EXPECT_EQ(samples[1].y, 2);
+  EXPECT_DOUBLE_EQ(samples[1].theta, 90);
+
+  // Characters which can not be in a file name are replaced
+  EXPECT_TRUE(recorder.endPath());
+  EXPECT_EQ(recorder.filesOpened, std::vector<std::string>{"/usd/tracking/a_b.csv"});
+
+  std::stringstream csv;
+  recorder.write(csv);
+  std::string line;
+  std::size_t lines = 0;
+  std::getline(csv, line);
+  EXPECT_EQ(line, "time,left_commanded,right_commanded,left_actual,right_actual,x,y,theta");
+  while (std::getline(csv, line)) {
+    lines++;
+  }
+  EXPECT_EQ(lines, 2u);
+
+  // A new path starts over
+  recorder.beginPath("c");
+  EXPECT_TRUE(recorder.getSamples().empty());
+  EXPECT_EQ(recorder.getDroppedCount(), 0u);
+  EXPECT_FALSE(recorder.endPath());
+}
+
+TEST(PathTrackingRecorderTest, MissingMeasurementsAreNaN) {
+  auto left = std::make_shared<VelocityMockMotor>();
+  MockPathTrackingRecorder recorder(createTimeUtil(), left, nullptr, nullptr, 10, "");
+  recorder.beginPath("A");
+  recorder.record(100, 100);
+
+  const auto sample = recorder.getSamples().at(0);
+  EXPECT_EQ(sample.leftCommanded, 100);
+  EXPECT_TRUE(std::isnan(sample.rightCommanded));
+  EXPECT_TRUE(std::isnan(sample.rightActual));
+  EXPECT_TRUE(std::isnan(sample.x));
+  EXPECT_TRUE(std::isnan(sample.theta));
+
+  // Without a directory the samples are only kept in memory
+  EXPECT_FALSE(recorder.endPath());
+  EXPECT_TRUE(recorder.filesOpened.empty());
+}
+
 class AsyncMotionProfileControllerTest : public ::testing::Test {
   protected:
   std::string get_working_path() {
@@ -163,6 +321,69 @@ TEST_F(AsyncMotionProfileControllerTest, ZeroWaypointsDoesNothing) {
   EXPECT_EQ(controller->getPaths().size(), 0);
 }
 
+TEST_F(AsyncMotionProfileControllerTest, GeneratePathReturnsTheHandleOfItsId) {
+  const auto handle = controller->generatePath(
+    {PathfinderPoint{0_m, 0_m, 0_deg}, PathfinderPoint{3_ft, 0_m, 45_deg}}, "A");
+
+  EXPECT_TRUE(handle.isValid());
+  EXPECT_EQ(controller->getPathHandle("A"), handle);
+  EXPECT_NE(controller->getPathHandle("B"), handle);
+  EXPECT_EQ(controller->getPathId(handle), "A");
+  EXPECT_FALSE(controller->generatePath({}, "C").isValid());
+  EXPECT_EQ(controller->getPathId(PathHandle()), "");
+}
+
+TEST_F(AsyncMotionProfileControllerTest, FollowPathByHandle) {
+  const auto handle = controller->generatePath(
+    {PathfinderPoint{0_m, 0_m, 0_deg}, PathfinderPoint{3_ft, 0_m, 45_deg}}, "A");
+
+  controller->setTarget(handle);
+  EXPECT_EQ(controller->getTarget(), "A");
+  controller->waitUntilSettled();
+
+  assertMotorsHaveBeenStopped(leftMotor.get(), rightMotor.get());
+  EXPECT_GT(leftMotor->maxVelocity, 0);
+  EXPECT_GT(rightMotor->maxVelocity, 0);
+}
+
+TEST_F(AsyncMotionProfileControllerTest, HandleFollowsTheIdThroughRemoveAndRegenerate) {
+  const auto handle = controller->generatePath(
+    {PathfinderPoint{0_m, 0_m, 0_deg}, PathfinderPoint{3_ft, 0_m, 45_deg}}, "A");
+  controller->removePath("A");
+
+  controller->setTarget(handle);
+  controller->waitUntilSettled();
+  EXPECT_FALSE(controller->executeSinglePathCalled);
+
+  EXPECT_EQ(controller->generatePath(
+              {PathfinderPoint{0_m, 0_m, 0_deg}, PathfinderPoint{3_ft, 0_m, 45_deg}}, "A"),
+            handle);
+  controller->setTarget(handle);
+  controller->waitUntilSettled();
+  EXPECT_TRUE(controller->executeSinglePathCalled);
+}
+
+TEST_F(AsyncMotionProfileControllerTest, FollowStaticPathByHandle) {
+  static const StaticProfilePoint staticPath[] = {{0.5, 0.5}, {0.5, 0.5}};
+  controller->registerStaticPath("S", staticPath);
+
+  controller->setTarget(controller->getPathHandle("S"));
+  controller->waitUntilSettled();
+  EXPECT_GT(leftMotor->maxVelocity, 0);
+}
+
+TEST_F(AsyncMotionProfileControllerTest, InvalidHandleDoesNotMoveAnything) {
+  controller->setTarget(PathHandle());
+  controller->waitUntilSettled();
+  EXPECT_EQ(controller->getTarget(), "");
+
+  controller->setTarget(PathHandle(1000));
+  controller->waitUntilSettled();
+
+  EXPECT_EQ(leftMotor->maxVelocity, 0);
+  EXPECT_EQ(rightMotor->maxVelocity, 0);
+}
+
 TEST_F(AsyncMotionProfileControllerTest, RemoveAPath) {
   controller->generatePath({PathfinderPoint{0_m, 0_m, 0_deg}, PathfinderPoint{3_ft, 0_m, 45_deg}},
                            "A");
@@ -184,9 +405,19 @@ TEST_F(AsyncMotionProfileControllerTest, RemoveRunningPath) {
 
   controller->setTarget("A");
 
-  EXPECT_FALSE(controller->removePath("A"));
+  auto rate = createTimeUtil().getRate();
+  while (!controller->executeSinglePathCalled) {
+    rate->delayUntil(1_ms);
+  }
+
+  // The running path keeps its own reference, so removing it always succeeds
+  EXPECT_TRUE(controller->removePath("A"));
+  EXPECT_EQ(controller->getPaths().size(), 0u);
 
-  EXPECT_EQ(controller->getPaths().size(), 1);
+  controller->waitUntilSettled();
+  assertMotorsHaveBeenStopped(leftMotor.get(), rightMotor.get());
+  EXPECT_GT(leftMotor->maxVelocity, 0);
+  EXPECT_GT(rightMotor->maxVelocity, 0);
 }
 
 TEST_F(AsyncMotionProfileControllerTest, ReplaceRunningPath) {
@@ -198,9 +429,13 @@ TEST_F(AsyncMotionProfileControllerTest, ReplaceRunningPath) {
 
   controller->generatePath({PathfinderPoint{0_m, 0_m, 0_deg}, PathfinderPoint{3_ft, 3_ft, 45_deg}},
                            "A");
-  EXPECT_EQ(controller->isDisabled(), true);
 
+  // Replacing the path does not interrupt the copy which is running
+  EXPECT_FALSE(controller->isDisabled());
   EXPECT_EQ(controller->getPaths().size(), 1);
+
+  controller->waitUntilSettled();
+  assertMotorsHaveBeenStopped(leftMotor.get(), rightMotor.get());
 }
 
 TEST_F(AsyncMotionProfileControllerTest, RemoveAPathWhichDoesNotExist) {
@@ -402,3 +637,912 @@ TEST_F(AsyncMotionProfileControllerTest, LoadPathfinderPath) {
   controller->setTarget("A");
   EXPECT_EQ(controller->getTarget(), "A");
 }
+
+TEST_F(AsyncMotionProfileControllerTest, GeneratePathAsyncThenFollowIt) {
+  auto handle = controller->generatePathAsync(
+    {PathfinderPoint{0_m, 0_m, 0_deg}, PathfinderPoint{3_ft, 0_m, 0_deg}}, "A");
+  EXPECT_EQ(handle.getPathId(), "A");
+
+  // setTarget() waits for the path to finish generating
+  controller->setTarget("A");
+  EXPECT_TRUE(handle.isDone());
+  EXPECT_EQ(handle.getStatus(), PathGenerationStatus::ready);
+  EXPECT_EQ(controller->getPaths().size(), 1u);
+
+  controller->waitUntilSettled();
+
+  assertMotorsHaveBeenStopped(leftMotor.get(), rightMotor.get());
+  EXPECT_GT(leftMotor->maxVelocity, 0);
+  EXPECT_GT(rightMotor->maxVelocity, 0);
+}
+
+TEST_F(AsyncMotionProfileControllerTest, GeneratePathAsyncWithImpossiblePathFails) {
+  auto handle = controller->generatePathAsync(
+    {PathfinderPoint{0_m, 0_m, 0_deg}, PathfinderPoint{9999_m, 0_m, 0_deg}}, "A");
+  controller->waitForPath("A");
+
+  EXPECT_EQ(handle.getStatus(), PathGenerationStatus::failed);
+  EXPECT_EQ(controller->getPaths().size(), 0u);
+}
+
+TEST_F(AsyncMotionProfileControllerTest, GeneratorTaskWakesForPathsQueuedWhileItIsIdle) {
+  auto first = controller->generatePathAsync(
+    {PathfinderPoint{0_m, 0_m, 0_deg}, PathfinderPoint{3_ft, 0_m, 0_deg}}, "A");
+  controller->waitForPath("A");
+  EXPECT_EQ(first.getStatus(), PathGenerationStatus::ready);
+
+  // The generator task is now waiting on an empty queue, so queueing a path must wake it
+  auto second = controller->generatePathAsync(
+    {PathfinderPoint{0_m, 0_m, 0_deg}, PathfinderPoint{2_ft, 0_m, 0_deg}}, "B");
+  controller->waitForPath("B");
+  EXPECT_EQ(second.getStatus(), PathGenerationStatus::ready);
+  EXPECT_EQ(controller->getPaths().size(), 2u);
+}
+
+TEST_F(AsyncMotionProfileControllerTest, GeneratePathAsyncWithZeroWaypointsFails) {
+  auto handle = controller->generatePathAsync({}, "A");
+  EXPECT_EQ(handle.getStatus(), PathGenerationStatus::failed);
+  EXPECT_EQ(controller->getPaths().size(), 0u);
+}
+
+TEST_F(AsyncMotionProfileControllerTest, SaveLoadBinaryPath) {
+  controller->generatePath(
+    {PathfinderPoint{0_in, 0_in, 0_deg}, PathfinderPoint{3_ft, 0_in, 45_deg}}, "A");
+
+  std::stringstream binaryPathFile(std::ios::in | std::ios::out | std::ios::binary);
+  controller->internalStoreBinaryPath(binaryPathFile, "A");
+
+  auto startingPath = controller->getPathData("A");
+
+  controller->removePath("A");
+  EXPECT_TRUE(controller->internalLoadBinaryPath(binaryPathFile, "A"));
+  EXPECT_EQ(controller->getPaths().front(), "A");
+  EXPECT_EQ(controller->getPaths().size(), 1u);
+
+  // The binary format stores single-precision floats
+  auto loadedPath = controller->getPathData("A");
+  ASSERT_EQ(loadedPath.size(), startingPath.size());
+  for (std::size_t i = 0; i < startingPath.size(); ++i) {
+    EXPECT_NEAR(loadedPath[i].time, startingPath[i].time, 1e-5);
+    EXPECT_NEAR(loadedPath[i].vector.pose.x, startingPath[i].vector.pose.x, 1e-5);
+    EXPECT_NEAR(loadedPath[i].vector.pose.y, startingPath[i].vector.pose.y, 1e-5);
+    ASSERT_EQ(loadedPath[i].wheel_velocities.size(), 2u);
+    EXPECT_NEAR(loadedPath[i].wheel_velocities[0], startingPath[i].wheel_velocities[0], 1e-5);
+    EXPECT_NEAR(loadedPath[i].wheel_velocities[1], startingPath[i].wheel_velocities[1], 1e-5);
+  }
+}
+
+TEST_F(AsyncMotionProfileControllerTest, SaveLoadCompactBinaryPath) {
+  controller->generatePath(
+    {PathfinderPoint{0_in, 0_in, 0_deg}, PathfinderPoint{3_ft, 0_in, 45_deg}}, "A");
+
+  std::stringstream floatFile(std::ios::in | std::ios::out | std::ios::binary);
+  std::stringstream compactFile(std::ios::in | std::ios::out | std::ios::binary);
+  EXPECT_TRUE(controller->internalStoreBinaryPath(floatFile, "A"));
+  EXPECT_TRUE(controller->internalStoreBinaryPath(compactFile, "A", true));
+  EXPECT_LT(compactFile.str().size(), floatFile.str().size() / 2);
+
+  auto startingPath = controller->getPathData("A");
+  controller->removePath("A");
+  EXPECT_TRUE(controller->internalLoadBinaryPath(compactFile, "A"));
+
+  // Values are rounded to the resolution of the compact format
+  auto loadedPath = controller->getPathData("A");
+  ASSERT_EQ(loadedPath.size(), startingPath.size());
+  for (std::size_t i = 0; i < startingPath.size(); ++i) {
+    EXPECT_NEAR(loadedPath[i].time, startingPath[i].time, 1e-4);
+    EXPECT_NEAR(loadedPath[i].vector.pose.x, startingPath[i].vector.pose.x, 1e-4);
+    EXPECT_NEAR(loadedPath[i].vector.pose.yaw, startingPath[i].vector.pose.yaw, 1e-4);
+    ASSERT_EQ(loadedPath[i].wheel_velocities.size(), 2u);
+    EXPECT_NEAR(loadedPath[i].wheel_velocities[1], startingPath[i].wheel_velocities[1], 1e-4);
+  }
+}
+
+TEST_F(AsyncMotionProfileControllerTest, LoadInvalidBinaryPath) {
+  std::stringstream binaryPathFile("x,y,yaw\n1,2,3\n");
+  EXPECT_FALSE(controller->internalLoadBinaryPath(binaryPathFile, "A"));
+  EXPECT_EQ(controller->getPaths().size(), 0u);
+}
+
+TEST_F(AsyncMotionProfileControllerTest, LoadPathLibrary) {
+  controller->generatePath(
+    {PathfinderPoint{0_in, 0_in, 0_deg}, PathfinderPoint{3_ft, 0_in, 45_deg}}, "A");
+  controller->generatePath(
+    {PathfinderPoint{0_in, 0_in, 0_deg}, PathfinderPoint{2_ft, 1_ft, 0_deg}}, "B");
+  const auto pathA = controller->getPathData("A");
+  const auto pathB = controller->getPathData("B");
+
+  std::stringstream libraryFile(std::ios::in | std::ios::out | std::ios::binary);
+  ASSERT_TRUE(PathBinaryFormat::serializeLibrary(libraryFile, {{"A", pathA}, {"B", pathB}}));
+  controller->removePath("A");
+  controller->removePath("B");
+
+  controller->pathLibraryFile = libraryFile.str();
+  EXPECT_EQ(controller->loadPathLibrary("/usd/paths"), 2u);
+  EXPECT_EQ(controller->pathLibrariesOpened, 1);
+  EXPECT_EQ(controller->getPaths(), (std::vector<std::string>{"A", "B"}));
+
+  const auto &loadedB = controller->getPathData("B");
+  ASSERT_EQ(loadedB.size(), pathB.size());
+  for (std::size_t i = 0; i < pathB.size(); ++i) {
+    EXPECT_NEAR(loadedB[i].vector.pose.x, pathB[i].vector.pose.x, 1e-5);
+    EXPECT_NEAR(loadedB[i].wheel_velocities[1], pathB[i].wheel_velocities[1], 1e-5);
+  }
+}
+
+TEST_F(AsyncMotionProfileControllerTest, LoadTruncatedPathLibraryKeepsTheIntactPaths) {
+  controller->generatePath(
+    {PathfinderPoint{0_in, 0_in, 0_deg}, PathfinderPoint{3_ft, 0_in, 45_deg}}, "A");
+  const auto path = controller->getPathData("A");
+  controller->removePath("A");
+
+  std::stringstream libraryFile(std::ios::in | std::ios::out | std::ios::binary);
+  ASSERT_TRUE(PathBinaryFormat::serializeLibrary(libraryFile, {{"A", path}, {"B", path}}));
+  const auto contents = libraryFile.str();
+
+  std::stringstream truncated(contents.substr(0, contents.size() - 10),
+                              std::ios::in | std::ios::binary);
+  EXPECT_EQ(controller->internalLoadPathLibrary(truncated, "/usd/paths"), 1u);
+  EXPECT_EQ(controller->getPaths(), std::vector<std::string>{"A"});
+}
+
+TEST_F(AsyncMotionProfileControllerTest, LoadInvalidPathLibrary) {
+  std::stringstream libraryFile("x,y,yaw\n1,2,3\n");
+  EXPECT_EQ(controller->internalLoadPathLibrary(libraryFile, "/usd/paths"), 0u);
+  EXPECT_EQ(controller->getPaths().size(), 0u);
+
+  // A single path file is not a library
+  controller->generatePath(
+    {PathfinderPoint{0_in, 0_in, 0_deg}, PathfinderPoint{3_ft, 0_in, 45_deg}}, "A");
+  std::stringstream binaryPathFile(std::ios::in | std::ios::out | std::ios::binary);
+  controller->internalStoreBinaryPath(binaryPathFile, "A");
+  EXPECT_EQ(controller->internalLoadPathLibrary(binaryPathFile, "/usd/paths"), 0u);
+}
+
+TEST_F(AsyncMotionProfileControllerTest, LoadPathLibraryAsyncThenFollowIt) {
+  controller->generatePath(
+    {PathfinderPoint{0_in, 0_in, 0_deg}, PathfinderPoint{3_ft, 0_in, 45_deg}}, "A");
+  std::stringstream libraryFile(std::ios::in | std::ios::out | std::ios::binary);
+  ASSERT_TRUE(
+    PathBinaryFormat::serializeLibrary(libraryFile, {{"A", controller->getPathData("A")}}));
+  controller->removePath("A");
+  controller->pathLibraryFile = libraryFile.str();
+
+  auto handle = controller->loadPathLibraryAsync("paths");
+  EXPECT_EQ(handle.getPathId(), "/usd/paths/paths.lib");
+
+  // setTarget() waits for the library to finish loading
+  controller->setTarget("A");
+  EXPECT_EQ(handle.getStatus(), PathGenerationStatus::ready);
+  controller->waitUntilSettled();
+  EXPECT_GT(leftMotor->maxVelocity, 0);
+
+  controller->pathLibraryFile = "";
+  auto emptyHandle = controller->loadPathLibraryAsync("paths");
+  controller->setTarget("A");
+  EXPECT_EQ(emptyHandle.getStatus(), PathGenerationStatus::failed);
+}
+
+TEST_F(AsyncMotionProfileControllerTest, FollowStreamedPath) {
+  controller->generatePath(
+    {PathfinderPoint{0_in, 0_in, 0_deg}, PathfinderPoint{3_ft, 0_in, 45_deg}}, "A");
+
+  std::stringstream binaryPathFile(std::ios::in | std::ios::out | std::ios::binary);
+  controller->internalStoreBinaryPath(binaryPathFile, "A");
+  controller->streamedFiles["A"] = binaryPathFile.str();
+
+  controller->setTarget("A");
+  controller->waitUntilSettled();
+  const auto inMemoryLeftVelocity = leftMotor->maxVelocity;
+  const auto inMemoryRightVelocity = rightMotor->maxVelocity;
+
+  controller->registerStreamedPath("/usd/paths", "A");
+  EXPECT_EQ(controller->getPaths(), std::vector<std::string>{"A"});
+  EXPECT_EQ(controller->paths.count("A"), 0u);
+
+  leftMotor->maxVelocity = 0;
+  rightMotor->maxVelocity = 0;
+  controller->setTarget("A");
+  controller->waitUntilSettled();
+
+  EXPECT_EQ(controller->streamedPathsOpened, std::vector<std::string>{"A"});
+  EXPECT_EQ(controller->executeSinglePathCount, 1);
+  assertMotorsHaveBeenStopped(leftMotor.get(), rightMotor.get());
+  EXPECT_NEAR(leftMotor->maxVelocity, inMemoryLeftVelocity, 1);
+  EXPECT_NEAR(rightMotor->maxVelocity, inMemoryRightVelocity, 1);
+}
+
+TEST_F(AsyncMotionProfileControllerTest, FollowStreamedPathWithMissingFile) {
+  controller->registerStreamedPath("/usd/paths", "A");
+
+  controller->setTarget("A");
+  controller->waitUntilSettled();
+
+  EXPECT_EQ(controller->streamedPathsOpened, std::vector<std::string>{"A"});
+  EXPECT_EQ(leftMotor->maxVelocity, 0);
+  EXPECT_EQ(rightMotor->maxVelocity, 0);
+}
+
+TEST_F(AsyncMotionProfileControllerTest, GeneratedPathReplacesStreamedPath) {
+  controller->registerStreamedPath("/usd/paths", "A");
+  controller->generatePath({PathfinderPoint{0_m, 0_m, 0_deg}, PathfinderPoint{3_ft, 0_m, 0_deg}},
+                           "A");
+  EXPECT_EQ(controller->getPaths(), std::vector<std::string>{"A"});
+
+  controller->setTarget("A");
+  controller->waitUntilSettled();
+
+  EXPECT_TRUE(controller->streamedPathsOpened.empty());
+  EXPECT_TRUE(controller->executeSinglePathCalled);
+
+  EXPECT_TRUE(controller->removePath("A"));
+  EXPECT_EQ(controller->getPaths().size(), 0u);
+}
+
+static constexpr StaticProfilePoint staticPath[] = {
+  {0.1, 0.1}, {0.2, 0.2}, {0.3, 0.3}, {0.4, 0.4}, {0.5, 0.5}, {0.4, 0.4}, {0.3, 0.3}, {0.2, 0.2}};
+
+TEST_F(AsyncMotionProfileControllerTest, FollowStaticPath) {
+  controller->registerStaticPath("A", staticPath);
+
+  EXPECT_EQ(controller->getPaths().front(), "A");
+  EXPECT_EQ(controller->getPaths().size(), 1u);
+
+  controller->setTarget("A");
+  controller->waitUntilSettled();
+
+  assertMotorsHaveBeenStopped(leftMotor.get(), rightMotor.get());
+  EXPECT_GT(leftMotor->maxVelocity, 0);
+  EXPECT_GT(rightMotor->maxVelocity, 0);
+}
+
+TEST_F(AsyncMotionProfileControllerTest, RemoveStaticPath) {
+  controller->registerStaticPath("A", staticPath);
+  EXPECT_EQ(controller->getPaths().size(), 1u);
+
+  EXPECT_TRUE(controller->removePath("A"));
+  EXPECT_EQ(controller->getPaths().size(), 0u);
+}
+
+TEST_F(AsyncMotionProfileControllerTest, GeneratedPathReplacesStaticPath) {
+  controller->registerStaticPath("A", staticPath);
+  controller->generatePath({PathfinderPoint{0_m, 0_m, 0_deg}, PathfinderPoint{3_ft, 0_m, 0_deg}},
+                           "A");
+
+  EXPECT_EQ(controller->getPaths().size(), 1u);
+  EXPECT_GT(controller->getPathData("A").size(), 0u);
+}
+
+TEST_F(AsyncMotionProfileControllerTest, RamseteWithNoErrorReturnsProfileVelocities) {
+  const squiggles::Pose pose(1, 2, 0.5);
+  const auto [vel, angularVel] =
+    MockAsyncMotionProfileController::computeRamseteVelocities(pose, 1.5, 0.25, pose, 2.0, 0.7);
+
+  EXPECT_DOUBLE_EQ(vel, 1.5);
+  EXPECT_DOUBLE_EQ(angularVel, 0.25);
+}
+
+TEST_F(AsyncMotionProfileControllerTest, RamseteSpeedsUpWhenBehindTheProfile) {
+  const auto [vel, angularVel] = MockAsyncMotionProfileController::computeRamseteVelocities(
+    squiggles::Pose(1, 0, 0), 1, 0, squiggles::Pose(0.5, 0, 0), 2.0, 0.7);
+
+  EXPECT_GT(vel, 1);
+  EXPECT_DOUBLE_EQ(angularVel, 0);
+}
+
+TEST_F(AsyncMotionProfileControllerTest, RamseteTurnsTowardsTheProfile) {
+  // The robot is to the right of the profile, so it has to turn left (counter-clockwise)
+  const auto [vel, angularVel] = MockAsyncMotionProfileController::computeRamseteVelocities(
+    squiggles::Pose(1, 0, 0), 1, 0, squiggles::Pose(1, -0.25, 0), 2.0, 0.7);
+
+  EXPECT_GT(angularVel, 0);
+}
+
+TEST_F(AsyncMotionProfileControllerTest, FollowPathWithStationaryOdometryReportsError) {
+  auto odom = std::make_shared<FixedOdometry>();
+  controller->setOdometry(odom);
+  controller->generatePath({PathfinderPoint{0_m, 0_m, 0_deg}, PathfinderPoint{3_ft, 0_m, 0_deg}},
+                           "A");
+  controller->setTarget("A");
+
+  auto rate = createTimeUtil().getRate();
+  while (!controller->executeSinglePathCalled) {
+    rate->delayUntil(1_ms);
+  }
+  rate->delayUntil(200_ms);
+
+  // The robot never moves, so it falls behind the profile
+  EXPECT_GT(controller->getError().x.convert(meter), 0);
+  EXPECT_GT(leftMotor->maxVelocity, 0);
+  EXPECT_GT(rightMotor->maxVelocity, 0);
+
+  controller->waitUntilSettled();
+  assertMotorsHaveBeenStopped(leftMotor.get(), rightMotor.get());
+}
+
+TEST_F(AsyncMotionProfileControllerTest, FollowPathWithModelPredictiveControl) {
+  controller->setOdometry(std::make_shared<FixedOdometry>());
+  controller->setModelPredictiveControl();
+  controller->generatePath({PathfinderPoint{0_m, 0_m, 0_deg}, PathfinderPoint{3_ft, 0_m, 0_deg}},
+                           "A");
+  controller->setTarget("A");
+
+  auto rate = createTimeUtil().getRate();
+  while (!controller->executeSinglePathCalled) {
+    rate->delayUntil(1_ms);
+  }
+  rate->delayUntil(200_ms);
+
+  // The robot never moves, so it falls behind the profile and the wheels are driven forward
+  EXPECT_GT(controller->getError().x.convert(meter), 0);
+  EXPECT_GT(leftMotor->maxVelocity, 0);
+  EXPECT_GT(rightMotor->maxVelocity, 0);
+
+  controller->waitUntilSettled();
+  assertMotorsHaveBeenStopped(leftMotor.get(), rightMotor.get());
+}
+
+TEST_F(AsyncMotionProfileControllerTest, InvalidModelPredictiveControlParamsThrow) {
+  DiffDriveMpcParams params;
+  params.modelStep = 0_ms;
+  EXPECT_THROW(controller->setModelPredictiveControl(params), std::invalid_argument);
+}
+
+TEST_F(AsyncMotionProfileControllerTest, ReplanWithoutOdometryFails) {
+  controller->generatePath({PathfinderPoint{0_m, 0_m, 0_deg}, PathfinderPoint{3_ft, 0_m, 0_deg}},
+                           "A");
+  controller->setTarget("A");
+
+  auto rate = createTimeUtil().getRate();
+  while (!controller->executeSinglePathCalled) {
+    rate->delayUntil(1_ms);
+  }
+
+  auto handle = controller->replan();
+  EXPECT_EQ(handle.getPathId(), "A");
+  EXPECT_EQ(handle.getStatus(), PathGenerationStatus::failed);
+  controller->waitUntilSettled();
+}
+
+TEST_F(AsyncMotionProfileControllerTest, ReplanWhenNoPathIsFollowedFails) {
+  controller->setOdometry(std::make_shared<FixedOdometry>());
+  EXPECT_EQ(controller->replan().getStatus(), PathGenerationStatus::failed);
+}
+
+TEST_F(AsyncMotionProfileControllerTest, ReplanFromABumpedPoseKeepsFollowing) {
+  auto odom = std::make_shared<FixedOdometry>();
+  controller->setOdometry(odom);
+  controller->generatePath({PathfinderPoint{0_m, 0_m, 0_deg}, PathfinderPoint{3_ft, 0_m, 0_deg}},
+                           "A");
+  controller->setTarget("A");
+
+  auto rate = createTimeUtil().getRate();
+  while (!controller->executeSinglePathCalled) {
+    rate->delayUntil(1_ms);
+  }
+  rate->delayUntil(100_ms);
+
+  // Knock the robot forward and to the side
+  odom->state = {10_cm, 5_cm, 10_deg};
+  rate->delayUntil(20_ms);
+
+  auto handle = controller->replan();
+  EXPECT_EQ(handle.getPathId(), "A");
+  while (!handle.isDone()) {
+    rate->delayUntil(1_ms);
+  }
+  EXPECT_EQ(handle.getStatus(), PathGenerationStatus::ready);
+
+  // The controller task takes the new profile without starting over
+  while (controller->replanReady.load()) {
+    rate->delayUntil(1_ms);
+  }
+  EXPECT_FALSE(controller->isSettled());
+  EXPECT_EQ(controller->executeSinglePathCount, 1);
+  EXPECT_EQ(controller->getPaths(), std::vector<std::string>{"A"});
+
+  controller->waitUntilSettled();
+  assertMotorsHaveBeenStopped(leftMotor.get(), rightMotor.get());
+}
+
+TEST_F(AsyncMotionProfileControllerTest, AbsolutePoseUndoesRelativePose) {
+  const squiggles::Pose origin(1, -2, 0.7);
+  const squiggles::Pose pose(-0.5, 3, -1.2);
+  const auto roundTrip = MockAsyncMotionProfileController::absolutePose(
+    origin, MockAsyncMotionProfileController::relativePose(origin, pose));
+  EXPECT_NEAR(roundTrip.x, pose.x, 1e-12);
+  EXPECT_NEAR(roundTrip.y, pose.y, 1e-12);
+  EXPECT_NEAR(roundTrip.yaw, pose.yaw, 1e-12);
+}
+
+TEST_F(AsyncMotionProfileControllerTest, FollowStaticPathWithOdometryStaysOpenLoop) {
+  controller->setOdometry(std::make_shared<FixedOdometry>());
+  controller->registerStaticPath("A", staticPath);
+  controller->setTarget("A");
+  controller->waitUntilSettled();
+
+  EXPECT_EQ(controller->getError().x.convert(meter), 0);
+  assertMotorsHaveBeenStopped(leftMotor.get(), rightMotor.get());
+}
+
+TEST_F(AsyncMotionProfileControllerTest, FollowPathSequence) {
+  controller->generatePath({PathfinderPoint{0_m, 0_m, 0_deg}, PathfinderPoint{2_ft, 0_m, 0_deg}},
+                           "A",
+                           {1.0, 2.0, 10.0},
+                           0_mps,
+                           0.5_mps);
+  controller->generatePath({PathfinderPoint{0_m, 0_m, 0_deg}, PathfinderPoint{2_ft, 0_m, 0_deg}},
+                           "B",
+                           {1.0, 2.0, 10.0},
+                           0.5_mps,
+                           0_mps);
+  EXPECT_GT(controller->getPathData("A").back().vector.vel, 0);
+  EXPECT_GT(controller->getPathData("B").front().vector.vel, 0);
+
+  controller->setTargetSequence({"A", "B"});
+  controller->waitUntilSettled();
+
+  EXPECT_EQ(controller->executeSinglePathCount, 2);
+  assertMotorsHaveBeenStopped(leftMotor.get(), rightMotor.get());
+}
+
+TEST_F(AsyncMotionProfileControllerTest, TrackingRecorderRecordsEachStepOfAPath) {
+  auto recorder =
+    std::make_shared<MockPathTrackingRecorder>(createTimeUtil(), leftMotor, rightMotor);
+  controller->setTrackingRecorder(recorder);
+  controller->generatePath({PathfinderPoint{0_m, 0_m, 0_deg}, PathfinderPoint{2_ft, 0_m, 0_deg}},
+                           "A");
+  controller->generatePath({PathfinderPoint{0_m, 0_m, 0_deg}, PathfinderPoint{1_ft, 0_m, 0_deg}},
+                           "B");
+  const auto &path = controller->getPathData("A");
+
+  controller->setTarget("A", true);
+  controller->waitUntilSettled();
+
+  auto samples = recorder->getSamples();
+  ASSERT_EQ(samples.size(), path.size());
+  const std::size_t middle = path.size() / 2;
+  const double commanded =
+    controller->convertLinearToRotational(-path[middle].wheel_velocities[0] * mps).convert(rpm);
+  EXPECT_DOUBLE_EQ(samples[middle].leftCommanded, commanded);
+  EXPECT_LT(samples[middle].leftCommanded, 0);
+  EXPECT_EQ(recorder->filesOpened, std::vector<std::string>{"/usd/A.csv"});
+
+  // A sequence is one recording named after its first path
+  controller->setTargetSequence({"B", "A"});
+  controller->waitUntilSettled();
+  EXPECT_EQ(recorder->getSamples().size(), path.size() + controller->getPathData("B").size());
+  EXPECT_EQ(recorder->filesOpened.back(), "/usd/B.csv");
+
+  controller->setTrackingRecorder(nullptr);
+  controller->setTarget("A");
+  controller->waitUntilSettled();
+  EXPECT_EQ(recorder->filesOpened.size(), 2u);
+}
+
+TEST_F(AsyncMotionProfileControllerTest, FollowPathSequenceWithStaticPath) {
+  controller->generatePath({PathfinderPoint{0_m, 0_m, 0_deg}, PathfinderPoint{2_ft, 0_m, 0_deg}},
+                           "A");
+  controller->registerStaticPath("B", staticPath);
+  controller->setTargetSequence({"A", "missing", "B"});
+  controller->waitUntilSettled();
+
+  EXPECT_EQ(controller->executeSinglePathCount, 1);
+  assertMotorsHaveBeenStopped(leftMotor.get(), rightMotor.get());
+}
+
+TEST_F(AsyncMotionProfileControllerTest, SetTargetCancelsPathSequence) {
+  controller->generatePath({PathfinderPoint{0_m, 0_m, 0_deg}, PathfinderPoint{2_ft, 0_m, 0_deg}},
+                           "A");
+  controller->generatePath({PathfinderPoint{0_m, 0_m, 0_deg}, PathfinderPoint{2_ft, 0_m, 0_deg}},
+                           "B");
+  controller->setTargetSequence({"A", "B"});
+  controller->setTarget("A");
+  controller->waitUntilSettled();
+
+  EXPECT_EQ(controller->executeSinglePathCount, 1);
+}
+
+TEST_F(AsyncMotionProfileControllerTest, GeneratePathWithNegativeStartVelocityThrows) {
+  EXPECT_THROW(
+    controller->generatePath({PathfinderPoint{0_m, 0_m, 0_deg}, PathfinderPoint{2_ft, 0_m, 0_deg}},
+                             "A",
+                             {1.0, 2.0, 10.0},
+                             -1_mps,
+                             0_mps),
+    std::invalid_argument);
+  EXPECT_EQ(controller->getPaths().size(), 0u);
+}
+
+TEST_F(AsyncMotionProfileControllerTest, PathCacheEvictsLeastRecentlyUsedReloadablePath) {
+  controller->generatePath({PathfinderPoint{0_m, 0_m, 0_deg}, PathfinderPoint{2_ft, 0_m, 0_deg}},
+                           "A");
+  controller->setPathSource("A", "paths");
+  const auto bytes = controller->getPathCacheStats().bytesUsed;
+  EXPECT_GT(bytes, 0u);
+
+  controller->setPathCacheBudget(bytes + bytes / 2);
+  controller->generatePath({PathfinderPoint{0_m, 0_m, 0_deg}, PathfinderPoint{2_ft, 0_m, 0_deg}},
+                           "B");
+
+  const auto stats = controller->getPathCacheStats();
+  EXPECT_EQ(stats.evictions, 1u);
+  EXPECT_LE(stats.bytesUsed, stats.byteBudget);
+  EXPECT_EQ(controller->getPaths().size(), 2u);
+  EXPECT_EQ(controller->paths.count("A"), 0u);
+}
+
+TEST_F(AsyncMotionProfileControllerTest, PathCacheReloadsEvictedPathWhenFollowed) {
+  controller->generatePath({PathfinderPoint{0_m, 0_m, 0_deg}, PathfinderPoint{2_ft, 0_m, 0_deg}},
+                           "A");
+  controller->pathOnDisk = controller->getPathData("A");
+  controller->setPathSource("A", "paths");
+  controller->setPathCacheBudget(1);
+
+  controller->setTarget("A");
+  controller->waitUntilSettled();
+
+  const auto stats = controller->getPathCacheStats();
+  EXPECT_EQ(stats.misses, 1u);
+  EXPECT_EQ(stats.hits, 0u);
+  ASSERT_EQ(controller->reloadedPaths.size(), 1u);
+  EXPECT_EQ(controller->reloadedPaths.front(), "A");
+  EXPECT_EQ(controller->executeSinglePathCount, 1);
+  assertMotorsHaveBeenStopped(leftMotor.get(), rightMotor.get());
+}
+
+TEST_F(AsyncMotionProfileControllerTest, PathCacheCountsHits) {
+  controller->generatePath({PathfinderPoint{0_m, 0_m, 0_deg}, PathfinderPoint{2_ft, 0_m, 0_deg}},
+                           "A");
+  controller->setTarget("A");
+  controller->waitUntilSettled();
+
+  EXPECT_EQ(controller->getPathCacheStats().hits, 1u);
+  EXPECT_EQ(controller->getPathCacheStats().misses, 0u);
+}
+
+TEST_F(AsyncMotionProfileControllerTest, PathCacheDoesNotEvictPathsWhichCannotBeReloaded) {
+  controller->setPathCacheBudget(1);
+  controller->generatePath({PathfinderPoint{0_m, 0_m, 0_deg}, PathfinderPoint{2_ft, 0_m, 0_deg}},
+                           "A");
+  controller->generatePath({PathfinderPoint{0_m, 0_m, 0_deg}, PathfinderPoint{2_ft, 0_m, 0_deg}},
+                           "B");
+
+  EXPECT_EQ(controller->getPathCacheStats().evictions, 0u);
+  EXPECT_EQ(controller->paths.size(), 2u);
+}
+
+TEST_F(AsyncMotionProfileControllerTest, RemovedPathIsNotReloaded) {
+  controller->generatePath({PathfinderPoint{0_m, 0_m, 0_deg}, PathfinderPoint{2_ft, 0_m, 0_deg}},
+                           "A");
+  controller->setPathSource("A", "paths");
+  controller->setPathCacheBudget(1);
+  controller->removePath("A");
+
+  EXPECT_EQ(controller->getPaths().size(), 0u);
+  EXPECT_EQ(controller->getPathCacheStats().bytesUsed, 0u);
+}
+
+TEST_F(AsyncMotionProfileControllerTest, MoveToReusesProfileForSameWaypoints) {
+  controller->moveTo({PathfinderPoint{0_m, 0_m, 0_deg}, PathfinderPoint{2_ft, 0_m, 0_deg}});
+  controller->moveTo({PathfinderPoint{0_m, 0_m, 0_deg}, PathfinderPoint{2_ft, 0_m, 0_deg}});
+
+  ASSERT_EQ(controller->followedPathData.size(), 2u);
+  EXPECT_EQ(controller->followedPathData[0], controller->followedPathData[1]);
+  EXPECT_EQ(controller->getPaths().size(), 0u);
+  assertMotorsHaveBeenStopped(leftMotor.get(), rightMotor.get());
+}
+
+TEST_F(AsyncMotionProfileControllerTest, MoveToReusesOnePathId) {
+  controller->moveTo({PathfinderPoint{0_m, 0_m, 0_deg}, PathfinderPoint{2_ft, 0_m, 0_deg}});
+  const auto internedIds = controller->pathNames.size();
+
+  controller->moveTo({PathfinderPoint{0_m, 0_m, 0_deg}, PathfinderPoint{3_ft, 0_m, 0_deg}});
+  controller->moveTo({PathfinderPoint{0_m, 0_m, 0_deg}, PathfinderPoint{2_ft, 0_m, 0_deg}});
+  EXPECT_EQ(controller->pathNames.size(), internedIds);
+  EXPECT_EQ(controller->pathTable.size(), internedIds);
+  EXPECT_EQ(controller->getPaths().size(), 0u);
+}
+
+TEST_F(AsyncMotionProfileControllerTest, RuntimeWaypointsMatchAnInitializerList) {
+  std::vector<PathfinderPoint> waypoints;
+  waypoints.push_back({0_m, 0_m, 0_deg});
+  waypoints.push_back({2_ft, 0_m, 0_deg});
+
+  controller->generatePath({PathfinderPoint{0_m, 0_m, 0_deg}, PathfinderPoint{2_ft, 0_m, 0_deg}},
+                           "A");
+  const auto handle = controller->generatePath(waypoints, "B");
+  EXPECT_EQ(handle, controller->getPathHandle("B"));
+  EXPECT_EQ(controller->getPathData("A"), controller->getPathData("B"));
+  EXPECT_FALSE(controller->generatePath(std::vector<PathfinderPoint>{}, "C").isValid());
+
+  auto asyncHandle = controller->generatePathAsync(std::move(waypoints), "D");
+  controller->waitForPath("D");
+  EXPECT_EQ(asyncHandle.getStatus(), PathGenerationStatus::ready);
+  EXPECT_EQ(controller->getPathData("A"), controller->getPathData("D"));
+
+  // moveTo() shares its remembered profiles between both kinds of waypoints
+  const std::vector<PathfinderPoint> moveWaypoints{{0_m, 0_m, 0_deg}, {2_ft, 0_m, 0_deg}};
+  controller->moveTo({PathfinderPoint{0_m, 0_m, 0_deg}, PathfinderPoint{2_ft, 0_m, 0_deg}});
+  controller->moveTo(moveWaypoints);
+  ASSERT_EQ(controller->followedPathData.size(), 2u);
+  EXPECT_EQ(controller->followedPathData[0], controller->followedPathData[1]);
+  assertMotorsHaveBeenStopped(leftMotor.get(), rightMotor.get());
+}
+
+TEST_F(AsyncMotionProfileControllerTest, MoveToDoesNotReuseProfileForDifferentLimits) {
+  controller->moveTo({PathfinderPoint{0_m, 0_m, 0_deg}, PathfinderPoint{2_ft, 0_m, 0_deg}});
+  controller->moveTo({PathfinderPoint{0_m, 0_m, 0_deg}, PathfinderPoint{2_ft, 0_m, 0_deg}},
+                     {0.5, 2.0, 10.0});
+  controller->moveTo({PathfinderPoint{0_m, 0_m, 0_deg}, PathfinderPoint{3_ft, 0_m, 0_deg}});
+
+  ASSERT_EQ(controller->followedPathData.size(), 3u);
+  EXPECT_NE(controller->followedPathData[0], controller->followedPathData[1]);
+  EXPECT_NE(controller->followedPathData[0], controller->followedPathData[2]);
+  EXPECT_NE(controller->followedPathData[1], controller->followedPathData[2]);
+}
+
+TEST_F(AsyncMotionProfileControllerTest, FollowDecimatedPath) {
+  controller->generatePath({PathfinderPoint{0_m, 0_m, 0_deg}, PathfinderPoint{3_ft, 0_m, 0_deg}},
+                           "A");
+  const auto fullLength = controller->getPathData("A").size();
+  controller->setTarget("A");
+  controller->waitUntilSettled();
+  const auto fullMaxVelocity = leftMotor->maxVelocity;
+
+  leftMotor->maxVelocity = 0;
+  controller->setProfileDecimation(4);
+  controller->setProfileInterpolation(ProfileInterpolation::cubic);
+  controller->generatePath({PathfinderPoint{0_m, 0_m, 0_deg}, PathfinderPoint{3_ft, 0_m, 0_deg}},
+                           "A");
+  EXPECT_LT(controller->getPathData("A").size(), fullLength / 3);
+
+  controller->setTarget("A");
+  controller->waitUntilSettled();
+
+  EXPECT_NEAR(leftMotor->maxVelocity, fullMaxVelocity, 1);
+  assertMotorsHaveBeenStopped(leftMotor.get(), rightMotor.get());
+}
+
+TEST_F(AsyncMotionProfileControllerTest, FollowRetimedPath) {
+  const auto duration = [&](const std::string &ipathId) {
+    const auto &path = controller->getPathData(ipathId);
+    return path.back().time - path.front().time;
+  };
+
+  controller->generatePath({PathfinderPoint{0_m, 0_m, 0_deg}, PathfinderPoint{3_ft, 0_m, 0_deg}},
+                           "A");
+  controller->setTarget("A");
+  controller->waitUntilSettled();
+  const auto limitedMaxVelocity = leftMotor->maxVelocity;
+
+  leftMotor->maxVelocity = 0;
+  controller->setProfileRetimer(ProfileRetimer(
+    AbstractMotor::gearset::green * (1.0 / 2), {{4_in, 10.5_in}, quadEncoderTPR}, 7_kg));
+  controller->generatePath({PathfinderPoint{0_m, 0_m, 0_deg}, PathfinderPoint{3_ft, 0_m, 0_deg}},
+                           "B");
+  EXPECT_LT(duration("B"), duration("A"));
+
+  controller->setTarget("B");
+  controller->waitUntilSettled();
+  EXPECT_GT(leftMotor->maxVelocity, limitedMaxVelocity);
+  assertMotorsHaveBeenStopped(leftMotor.get(), rightMotor.get());
+
+  controller->setProfileRetimer(std::nullopt);
+  controller->generatePath({PathfinderPoint{0_m, 0_m, 0_deg}, PathfinderPoint{3_ft, 0_m, 0_deg}},
+                           "C");
+  EXPECT_EQ(duration("C"), duration("A"));
+}
+
+TEST_F(AsyncMotionProfileControllerTest, FollowCentripetallyLimitedPath) {
+  const auto duration = [&](const std::string &ipathId) {
+    const auto &path = controller->getPathData(ipathId);
+    return path.back().time - path.front().time;
+  };
+
+  EXPECT_THROW(controller->setMaxCentripetalAcceleration(0_mps2), std::invalid_argument);
+
+  controller->generatePath({PathfinderPoint{0_m, 0_m, 0_deg}, PathfinderPoint{3_ft, 0_m, 0_deg}},
+                           "Line");
+  controller->generatePath({PathfinderPoint{0_m, 0_m, 0_deg}, PathfinderPoint{1_ft, 1_ft, 0_deg}},
+                           "A");
+
+  controller->setMaxCentripetalAcceleration(0.2_mps2);
+  controller->generatePath({PathfinderPoint{0_m, 0_m, 0_deg}, PathfinderPoint{3_ft, 0_m, 0_deg}},
+                           "LimitedLine");
+  controller->generatePath({PathfinderPoint{0_m, 0_m, 0_deg}, PathfinderPoint{1_ft, 1_ft, 0_deg}},
+                           "B");
+  EXPECT_EQ(duration("LimitedLine"), duration("Line"));
+  EXPECT_GT(duration("B"), duration("A"));
+  for (const auto &point : controller->getPathData("B")) {
+    EXPECT_LE(point.vector.vel * point.vector.vel * std::abs(point.curvature), 0.2 + 1e-9);
+  }
+
+  controller->setTarget("B");
+  controller->waitUntilSettled();
+  assertMotorsHaveBeenStopped(leftMotor.get(), rightMotor.get());
+}
+
+TEST_F(AsyncMotionProfileControllerTest, FollowIncrementallyGeneratedPath) {
+  std::vector<PathfinderPoint> waypoints{
+    {0_m, 0_m, 0_deg}, {1_ft, 0_m, 0_deg}, {2_ft, 0_m, 0_deg}, {3_ft, 0_m, 0_deg}};
+  const auto handle = controller->generatePathIncremental(waypoints, "A");
+  EXPECT_EQ(handle, controller->getPathHandle("A"));
+  EXPECT_EQ(controller->incrementalGenerators.at("A")->getGeneratedSegmentCount(), 3u);
+
+  waypoints[2].x = 2.5_ft;
+  controller->generatePathIncremental(waypoints, "A");
+  EXPECT_EQ(controller->incrementalGenerators.at("A")->getGeneratedSegmentCount(), 2u);
+  EXPECT_TRUE(ProfileResampler::hasIncreasingTimes(controller->getPathData("A")));
+
+  controller->setTarget(handle);
+  controller->waitUntilSettled();
+  assertMotorsHaveBeenStopped(leftMotor.get(), rightMotor.get());
+
+  // Different limits start over, and removing the path forgets its segments
+  controller->generatePathIncremental(waypoints, "A", {0.5, 1, 10});
+  EXPECT_EQ(controller->incrementalGenerators.at("A")->getGeneratedSegmentCount(), 3u);
+  controller->removePath("A");
+  EXPECT_EQ(controller->incrementalGenerators.count("A"), 0u);
+}
+
+TEST_F(AsyncMotionProfileControllerTest, ProfileDecimationOfZeroThrows) {
+  EXPECT_THROW(controller->setProfileDecimation(0), std::invalid_argument);
+}
+
+TEST_F(AsyncMotionProfileControllerTest, FasterCommandPeriodKeepsPathDuration) {
+  controller->generatePath({PathfinderPoint{0_m, 0_m, 0_deg}, PathfinderPoint{3_ft, 0_m, 0_deg}},
+                           "A");
+
+  auto timeToFollow = [&]() {
+    const auto start = std::chrono::steady_clock::now();
+    controller->setTarget("A");
+    controller->waitUntilSettled();
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+  };
+
+  const double defaultDuration = timeToFollow();
+  const auto defaultMaxVelocity = leftMotor->maxVelocity;
+
+  leftMotor->maxVelocity = 0;
+  controller->setCommandPeriod(5_ms);
+  const double fastDuration = timeToFollow();
+
+  EXPECT_NEAR(fastDuration, defaultDuration, defaultDuration * 0.25);
+  EXPECT_NEAR(leftMotor->maxVelocity, defaultMaxVelocity, 1);
+  assertMotorsHaveBeenStopped(leftMotor.get(), rightMotor.get());
+}
+
+TEST_F(AsyncMotionProfileControllerTest, NonPositiveCommandPeriodThrows) {
+  EXPECT_THROW(controller->setCommandPeriod(0_ms), std::invalid_argument);
+}
+
+TEST_F(AsyncMotionProfileControllerTest, FollowPathViewBackwards) {
+  controller->generatePath({PathfinderPoint{0_m, 0_m, 0_deg}, PathfinderPoint{3_ft, 0_m, 0_deg}},
+                           "A");
+  controller->registerPathView("A backwards", "A", true, false);
+  EXPECT_EQ(controller->getPaths().size(), 2u);
+
+  controller->setTarget("A backwards");
+
+  auto rate = createTimeUtil().getRate();
+  while (!controller->executeSinglePathCalled) {
+    rate->delayUntil(1_ms);
+  }
+
+  // Wait a little longer so we get into the path
+  rate->delayUntil(200_ms);
+
+  EXPECT_LT(leftMotor->lastVelocity, 0);
+  EXPECT_LT(rightMotor->lastVelocity, 0);
+
+  controller->flipDisable(true);
+}
+
+TEST_F(AsyncMotionProfileControllerTest, PathViewTransformsCombineWithTarget) {
+  controller->generatePath({PathfinderPoint{0_m, 0_m, 0_deg}, PathfinderPoint{3_ft, 0_m, 0_deg}},
+                           "A");
+  controller->registerPathView("A backwards", "A", true, false);
+  controller->setTarget("A backwards", true);
+
+  auto rate = createTimeUtil().getRate();
+  while (!controller->executeSinglePathCalled) {
+    rate->delayUntil(1_ms);
+  }
+
+  rate->delayUntil(200_ms);
+
+  EXPECT_GT(leftMotor->lastVelocity, 0);
+  EXPECT_GT(rightMotor->lastVelocity, 0);
+
+  controller->flipDisable(true);
+}
+
+TEST_F(AsyncMotionProfileControllerTest, PathViewSharesBasePathAndScalesSpeed) {
+  controller->generatePath({PathfinderPoint{0_m, 0_m, 0_deg}, PathfinderPoint{2_ft, 0_m, 0_deg}},
+                           "A");
+  controller->registerPathView("A slow", "A", false, false, 0.5);
+
+  controller->setTarget("A");
+  controller->waitUntilSettled();
+  const auto fullMaxVelocity = leftMotor->maxVelocity;
+
+  leftMotor->maxVelocity = 0;
+  controller->setTarget("A slow");
+  controller->waitUntilSettled();
+
+  ASSERT_EQ(controller->followedPathData.size(), 2u);
+  EXPECT_EQ(controller->followedPathData[0], controller->followedPathData[1]);
+  EXPECT_NEAR(leftMotor->maxVelocity, fullMaxVelocity / 2.0, 1);
+  assertMotorsHaveBeenStopped(leftMotor.get(), rightMotor.get());
+}
+
+TEST_F(AsyncMotionProfileControllerTest, PathViewCycleIsNotFollowed) {
+  controller->registerPathView("A", "B", false, false);
+  controller->registerPathView("B", "A", false, false);
+  controller->setTarget("A");
+  controller->waitUntilSettled();
+
+  EXPECT_FALSE(controller->executeSinglePathCalled);
+}
+
+TEST_F(AsyncMotionProfileControllerTest, RemovePathView) {
+  controller->generatePath({PathfinderPoint{0_m, 0_m, 0_deg}, PathfinderPoint{2_ft, 0_m, 0_deg}},
+                           "A");
+  controller->registerPathView("B", "A", false, true);
+  controller->removePath("B");
+
+  ASSERT_EQ(controller->getPaths().size(), 1u);
+  EXPECT_EQ(controller->getPaths().front(), "A");
+}
+
+TEST_F(AsyncMotionProfileControllerTest, PathViewWithInvalidSpeedScaleThrows) {
+  EXPECT_THROW(controller->registerPathView("B", "A", false, false, 0), std::invalid_argument);
+  EXPECT_THROW(controller->registerPathView("A", "A", false, false), std::invalid_argument);
+}
+
+TEST_F(AsyncMotionProfileControllerTest, FollowPathAtHalfSpeed) {
+  controller->generatePath({PathfinderPoint{0_m, 0_m, 0_deg}, PathfinderPoint{2_ft, 0_m, 0_deg}},
+                           "A");
+
+  auto timeToFollow = [&](const double ispeedScale) {
+    const auto start = std::chrono::steady_clock::now();
+    controller->setTarget("A", false, false, ispeedScale);
+    controller->waitUntilSettled();
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+  };
+
+  const double fullDuration = timeToFollow(1);
+  const auto fullMaxVelocity = leftMotor->maxVelocity;
+
+  leftMotor->maxVelocity = 0;
+  const double halfDuration = timeToFollow(0.5);
+
+  EXPECT_NEAR(leftMotor->maxVelocity, fullMaxVelocity / 2.0, 1);
+  EXPECT_NEAR(halfDuration, 2 * fullDuration, fullDuration * 0.5);
+  EXPECT_EQ(controller->followedPathData[0], controller->followedPathData[1]);
+  assertMotorsHaveBeenStopped(leftMotor.get(), rightMotor.get());
+}
+
+TEST_F(AsyncMotionProfileControllerTest, NonPositiveSpeedScaleThrows) {
+  EXPECT_THROW(controller->setTarget("A", false, false, 0), std::invalid_argument);
+  EXPECT_THROW(controller->setTargetSequence({"A"}, false, false, -1), std::invalid_argument);
+}
+
+TEST_F(AsyncMotionProfileControllerTest, FeedforwardDrivesTheWheelsWithVoltage) {
+  controller->setFeedforward({0, 1, 0});
+  EXPECT_EQ(controller->getFeedforward(), (MotorFeedforward{0, 1, 0}));
+
+  controller->registerStaticPath("A", staticPath);
+  controller->setTarget("A");
+  controller->waitUntilSettled();
+
+  // The motors are stopped with a velocity command, so the last voltage is from the last point of
+  // the path: 0.2 m/s, which is 0.2 of the max voltage with this kV
+  EXPECT_EQ(leftMotor->lastVelocity, 0);
+  EXPECT_EQ(rightMotor->lastVelocity, 0);
+  EXPECT_EQ(leftMotor->maxVelocity, 0);
+  EXPECT_EQ(rightMotor->maxVelocity, 0);
+  EXPECT_EQ(leftMotor->lastVoltage, 0.2 * v5MotorMaxVoltage);
+  EXPECT_EQ(rightMotor->lastVoltage, 0.2 * v5MotorMaxVoltage);
+}
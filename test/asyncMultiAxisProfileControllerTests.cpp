@@ -0,0 +1,110 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#include "okapi/api/control/async/asyncMultiAxisProfileController.hpp"
+#include "test/tests/api/implMocks.hpp"
+#include <atomic>
+#include <gtest/gtest.h>
+
+using namespace okapi;
+
+class MultiAxisMockOutput : public ControllerOutput<double> {
+  public:
+  void controllerSet(double ivalue) override {
+    lastValue = ivalue;
+    if (std::abs(ivalue) > std::abs(maxValue.load())) {
+      maxValue = ivalue;
+    }
+  }
+
+  std::atomic<double> lastValue{0};
+  std::atomic<double> maxValue{0};
+};
+
+class AsyncMultiAxisProfileControllerTest : public ::testing::Test {
+  protected:
+  void SetUp() override {
+    controller = new AsyncMultiAxisProfileController(
+      createTimeUtil(),
+      {{drive, 4_in, AbstractMotor::gearset::green, {1.0, 2.0, 10.0}},
+       {lift, 4_in, AbstractMotor::gearset::green, {1.0, 2.0, 10.0}}});
+    controller->startThread();
+  }
+
+  void TearDown() override {
+    delete controller;
+  }
+
+  std::shared_ptr<MultiAxisMockOutput> drive = std::make_shared<MultiAxisMockOutput>();
+  std::shared_ptr<MultiAxisMockOutput> lift = std::make_shared<MultiAxisMockOutput>();
+  AsyncMultiAxisProfileController *controller;
+};
+
+TEST_F(AsyncMultiAxisProfileControllerTest, ConstructWithoutAxesThrows) {
+  EXPECT_THROW(AsyncMultiAxisProfileController(createTimeUtil(), {}), std::invalid_argument);
+}
+
+TEST_F(AsyncMultiAxisProfileControllerTest, ConstructWithGearRatioOf0) {
+  EXPECT_THROW(AsyncMultiAxisProfileController(
+                 createTimeUtil(),
+                 {{drive, 4_in, AbstractMotor::gearset::green * 0, {1.0, 2.0, 10.0}}}),
+               std::invalid_argument);
+}
+
+TEST_F(AsyncMultiAxisProfileControllerTest, ConstructWithInvalidLimitsThrows) {
+  EXPECT_THROW(AsyncMultiAxisProfileController(
+                 createTimeUtil(), {{drive, 4_in, AbstractMotor::gearset::green, {0, 2.0, 10.0}}}),
+               std::invalid_argument);
+  EXPECT_THROW(AsyncMultiAxisProfileController(
+                 createTimeUtil(), {{drive, 4_in, AbstractMotor::gearset::green, {1.0, 0, 10.0}}}),
+               std::invalid_argument);
+}
+
+TEST_F(AsyncMultiAxisProfileControllerTest, SettledWhenDisabled) {
+  controller->generatePath({0.5_m, 0.1_m}, "A");
+  assertControllerIsSettledWhenDisabled(*controller, std::string("A"));
+}
+
+TEST_F(AsyncMultiAxisProfileControllerTest, WaitUntilSettledWorksWhenDisabled) {
+  assertWaitUntilSettledWorksWhenDisabled(*controller);
+}
+
+TEST_F(AsyncMultiAxisProfileControllerTest, WrongNumberOfDistancesThrows) {
+  EXPECT_THROW(controller->generatePath({0.5_m}, "A"), std::invalid_argument);
+  EXPECT_THROW(controller->generatePath({0.5_m, 0.1_m, 0_m}, "A"), std::invalid_argument);
+}
+
+TEST_F(AsyncMultiAxisProfileControllerTest, NoMovementDoesNotGenerateAPath) {
+  controller->generatePath({0_m, 0_m}, "A");
+  EXPECT_TRUE(controller->getPaths().empty());
+}
+
+TEST_F(AsyncMultiAxisProfileControllerTest, AxesMoveInProportionToTheirDistancesAndStop) {
+  controller->moveTo({0.2_m, -0.1_m});
+
+  // Both axes follow the same profile, so the lift goes half as fast as the drive at every step
+  EXPECT_GT(drive->maxValue, 0);
+  EXPECT_NEAR(lift->maxValue, -drive->maxValue / 2, 1e-9);
+
+  EXPECT_EQ(drive->lastValue, 0);
+  EXPECT_EQ(lift->lastValue, 0);
+  EXPECT_TRUE(controller->isSettled());
+  EXPECT_TRUE(controller->getPaths().empty());
+}
+
+TEST_F(AsyncMultiAxisProfileControllerTest, AxisWhichDoesNotMoveStaysStill) {
+  controller->moveTo({0_m, 0.1_m});
+
+  EXPECT_EQ(drive->maxValue, 0);
+  EXPECT_GT(lift->maxValue, 0);
+  EXPECT_LE(lift->maxValue, 1);
+}
+
+TEST_F(AsyncMultiAxisProfileControllerTest, ErrorIsZeroWhenNotRunning) {
+  const auto error = controller->getError();
+  ASSERT_EQ(error.size(), 2u);
+  EXPECT_EQ(error[0], 0_m);
+  EXPECT_EQ(error[1], 0_m);
+}
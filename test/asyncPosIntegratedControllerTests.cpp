@@ -6,7 +6,9 @@
 #include "okapi/api/control/async/asyncPosIntegratedController.hpp"
 #include "okapi/api/util/mathUtil.hpp"
 #include "test/tests/api/implMocks.hpp"
+#include <chrono>
 #include <gtest/gtest.h>
+#include <thread>
 
 using namespace okapi;
 
@@ -121,3 +123,57 @@ TEST_F(AsyncPosIntegratedControllerTest, GearRatioOfZeroThrowsException) {
   EXPECT_THROW(AsyncPosIntegratedController(motor, motor->gearset * 0, 100, createTimeUtil()),
                std::invalid_argument);
 }
+
+TEST_F(AsyncPosIntegratedControllerTest, WaitUntilSettledDoesNotMakeANewRate) {
+  int ratesMade = 0;
+  AsyncPosIntegratedController counted(
+    motor,
+    motor->gearset,
+    toUnderlyingType(motor->gearset),
+    TimeUtil(
+      Supplier<std::unique_ptr<AbstractTimer>>([]() { return std::make_unique<MockTimer>(); }),
+      Supplier<std::unique_ptr<AbstractRate>>([&]() {
+        ratesMade++;
+        return std::make_unique<MockRate>();
+      }),
+      Supplier<std::unique_ptr<SettledUtil>>([]() { return createSettledUtilPtr(); })));
+  const int ratesMadeByConstructor = ratesMade;
+
+  counted.flipDisable(true);
+  counted.waitUntilSettled();
+  counted.waitUntilSettled();
+
+  EXPECT_EQ(ratesMade, ratesMadeByConstructor);
+}
+
+TEST_F(AsyncPosIntegratedControllerTest, UpdateSettledDecidesIsSettled) {
+  controller->setTarget(0);
+  controller->updateSettled();
+  EXPECT_FALSE(controller->isSettled());
+  controller->updateSettled();
+  EXPECT_TRUE(controller->isSettled());
+
+  // A new target is a new movement, and the motor is not moving yet
+  controller->setTarget(100);
+  EXPECT_FALSE(controller->isSettled());
+  controller->updateSettled();
+  controller->updateSettled();
+  EXPECT_FALSE(controller->isSettled());
+}
+
+TEST_F(AsyncPosIntegratedControllerTest, UpdateSettledWakesWaitUntilSettled) {
+  controller->setTarget(100);
+  controller->updateSettled();
+
+  std::thread updater([&]() {
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    // The motor reaches the target
+    motor->encoder->value = static_cast<std::int32_t>(100 * 1.5);
+    controller->updateSettled();
+    controller->updateSettled();
+  });
+
+  controller->waitUntilSettled();
+  EXPECT_TRUE(controller->isSettled());
+  updater.join();
+}
@@ -0,0 +1,279 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#include "okapi/api/chassis/model/skidSteerModel.hpp"
+#include "okapi/api/control/async/asyncPurePursuitController.hpp"
+#include "test/tests/api/implMocks.hpp"
+#include "test/tests/api/simulatedDevices.hpp"
+#include <chrono>
+#include <gtest/gtest.h>
+#include <thread>
+
+using namespace okapi;
+
+class MockAsyncPurePursuitController : public AsyncPurePursuitController {
+  public:
+  using AsyncPurePursuitController::AsyncPurePursuitController;
+  using AsyncPurePursuitController::FollowState;
+  using AsyncPurePursuitController::followStep;
+  using AsyncPurePursuitController::Path;
+  using AsyncPurePursuitController::updateSearch;
+
+  const Path &getPath(const std::string &ipathId) const {
+    return *paths.at(ipathId);
+  }
+};
+
+class PursuitOdometry : public Odometry {
+  public:
+  void setScales(const ChassisScales &) override {
+  }
+
+  void step() override {
+  }
+
+  OdomState getState(const StateMode &) const override {
+    return state;
+  }
+
+  void setState(const OdomState &istate, const StateMode &) override {
+    state = istate;
+  }
+
+  std::shared_ptr<ReadOnlyChassisModel> getModel() override {
+    return nullptr;
+  }
+
+  ChassisScales getScales() override {
+    return {{4_in, 10_in}, imev5GreenTPR};
+  }
+
+  OdomState state{};
+};
+
+class AsyncPurePursuitControllerTest : public ::testing::Test {
+  protected:
+  void SetUp() override {
+    model = std::make_shared<SkidSteerModel>(leftMotor,
+                                             rightMotor,
+                                             leftMotor->getEncoder(),
+                                             rightMotor->getEncoder(),
+                                             200,
+                                             v5MotorMaxVoltage);
+
+    controller = new MockAsyncPurePursuitController(
+      createTimeUtil(), model, odometry, scales, AbstractMotor::gearset::green, limits, 0.5_m);
+    controller->startThread();
+
+    // A straight line along x with a point every 10 cm
+    controller->addPath(
+      AsyncPurePursuitController::interpolate({{0_m, 0_m}, {2_m, 0_m}}, 10_cm), "line");
+  }
+
+  void TearDown() override {
+    delete controller;
+  }
+
+  std::shared_ptr<MockMotor> leftMotor = std::make_shared<MockMotor>();
+  std::shared_ptr<MockMotor> rightMotor = std::make_shared<MockMotor>();
+  std::shared_ptr<SkidSteerModel> model;
+  std::shared_ptr<PursuitOdometry> odometry = std::make_shared<PursuitOdometry>();
+  ChassisScales scales{{4_in, 10_in}, imev5GreenTPR};
+  PathfinderLimits limits{1.0, 2.0, 0};
+  MockAsyncPurePursuitController *controller;
+};
+
+TEST_F(AsyncPurePursuitControllerTest, ConstructWithInvalidParametersThrows) {
+  const auto make = [&](const AbstractMotor::GearsetRatioPair &ipair,
+                        const PathfinderLimits &ilimits,
+                        const QLength ilookahead,
+                        const QLength isettleDistance) {
+    AsyncPurePursuitController(
+      createTimeUtil(), model, odometry, scales, ipair, ilimits, ilookahead, isettleDistance);
+  };
+
+  const auto green = AbstractMotor::gearset::green;
+  EXPECT_THROW(make(green * 0, limits, 0.5_m, 1_in), std::invalid_argument);
+  EXPECT_THROW(make(green, limits, 0_m, 1_in), std::invalid_argument);
+  EXPECT_THROW(make(green, limits, 0.5_m, 0_m), std::invalid_argument);
+  EXPECT_THROW(make(green, {0, 2, 0}, 0.5_m, 1_in), std::invalid_argument);
+  EXPECT_THROW(make(green, {1, 0, 0}, 0.5_m, 1_in), std::invalid_argument);
+}
+
+TEST_F(AsyncPurePursuitControllerTest, SettledWhenDisabled) {
+  assertControllerIsSettledWhenDisabled(*controller, std::string("line"));
+}
+
+TEST_F(AsyncPurePursuitControllerTest, WaitUntilSettledWorksWhenDisabled) {
+  assertWaitUntilSettledWorksWhenDisabled(*controller);
+}
+
+TEST_F(AsyncPurePursuitControllerTest, InterpolateSplitsLegsEvenly) {
+  const auto path = AsyncPurePursuitController::interpolate({{0_m, 0_m}, {1_m, 0_m}}, 0.3_m);
+  ASSERT_EQ(path.size(), 5u);
+  for (std::size_t i = 0; i < path.size(); i++) {
+    EXPECT_NEAR(path[i].x.convert(meter), i * 0.25, 1e-12);
+    EXPECT_EQ(path[i].y, 0_m);
+  }
+
+  EXPECT_THROW(AsyncPurePursuitController::interpolate({}, 0_m), std::invalid_argument);
+}
+
+TEST_F(AsyncPurePursuitControllerTest, FewerThanTwoWaypointsDoesNotAddAPath) {
+  controller->addPath({{0_m, 0_m}}, "A");
+  EXPECT_EQ(controller->getPaths(), std::vector<std::string>{"line"});
+}
+
+TEST_F(AsyncPurePursuitControllerTest, LookaheadIsOneLookaheadDistanceAlongThePath) {
+  const auto &path = controller->getPath("line");
+  MockAsyncPurePursuitController::FollowState state;
+  controller->updateSearch(path, 0.2, 0, state);
+  EXPECT_EQ(state.closestIndex, 2u);
+  EXPECT_NEAR(state.lookaheadIndex, 7, 1e-9);
+
+  // Off to the side, the circle meets the path closer to the robot
+  MockAsyncPurePursuitController::FollowState sideState;
+  controller->updateSearch(path, 0.2, 0.3, sideState);
+  EXPECT_NEAR(sideState.lookaheadIndex, 6, 1e-9);
+}
+
+TEST_F(AsyncPurePursuitControllerTest, SearchResumesInsteadOfGoingBack) {
+  const auto &path = controller->getPath("line");
+  MockAsyncPurePursuitController::FollowState state;
+  controller->updateSearch(path, 1, 0, state);
+  EXPECT_NEAR(state.lookaheadIndex, 15, 1e-9);
+
+  controller->updateSearch(path, 0, 0, state);
+  EXPECT_EQ(state.closestIndex, 10u);
+  EXPECT_NEAR(state.lookaheadIndex, 15, 1e-9);
+}
+
+TEST_F(AsyncPurePursuitControllerTest, LookaheadIsTheEndOnceItIsInReach) {
+  const auto &path = controller->getPath("line");
+  MockAsyncPurePursuitController::FollowState state;
+  controller->updateSearch(path, 1.8, 0, state);
+  EXPECT_EQ(state.lookaheadIndex, 20);
+}
+
+TEST_F(AsyncPurePursuitControllerTest, FarFromThePathHeadsForTheClosestPoint) {
+  const auto &path = controller->getPath("line");
+  MockAsyncPurePursuitController::FollowState state;
+  controller->updateSearch(path, 0.5, 2, state);
+  EXPECT_EQ(state.closestIndex, 5u);
+  EXPECT_EQ(state.lookaheadIndex, 5);
+}
+
+TEST_F(AsyncPurePursuitControllerTest, FollowStepDrivesStraightOnALine) {
+  const auto &path = controller->getPath("line");
+  MockAsyncPurePursuitController::FollowState state;
+  EXPECT_FALSE(controller->followStep(path, state));
+
+  // The first step is limited by the acceleration
+  EXPECT_NEAR(state.speed, 0.02, 1e-12);
+  EXPECT_GT(leftMotor->lastVelocity, 0);
+  EXPECT_EQ(leftMotor->lastVelocity, rightMotor->lastVelocity);
+}
+
+TEST_F(AsyncPurePursuitControllerTest, FollowStepTurnsTowardThePath) {
+  const auto &path = controller->getPath("line");
+  MockAsyncPurePursuitController::FollowState state;
+  state.speed = 1;
+
+  // The path is to the right of the robot, so it turns clockwise
+  odometry->state = {0.5_m, -0.2_m, 0_deg};
+  EXPECT_FALSE(controller->followStep(path, state));
+  EXPECT_GT(leftMotor->lastVelocity, rightMotor->lastVelocity);
+
+  odometry->state = {0.5_m, 0.2_m, 0_deg};
+  EXPECT_FALSE(controller->followStep(path, state));
+  EXPECT_LT(leftMotor->lastVelocity, rightMotor->lastVelocity);
+}
+
+TEST_F(AsyncPurePursuitControllerTest, FollowStepSlowsDownNearTheEnd) {
+  const auto &path = controller->getPath("line");
+  MockAsyncPurePursuitController::FollowState state;
+  state.speed = 1;
+  odometry->state = {1.9_m, 0_m, 0_deg};
+  EXPECT_FALSE(controller->followStep(path, state));
+  EXPECT_NEAR(state.speed, std::sqrt(2 * 2 * 0.1), 1e-9);
+}
+
+TEST_F(AsyncPurePursuitControllerTest, FollowStepIsDoneWithinTheSettleDistance) {
+  const auto &path = controller->getPath("line");
+  MockAsyncPurePursuitController::FollowState state;
+  odometry->state = {1.99_m, 0_m, 0_deg};
+  EXPECT_TRUE(controller->followStep(path, state));
+  EXPECT_EQ(leftMotor->lastVelocity, 0);
+}
+
+TEST_F(AsyncPurePursuitControllerTest, FollowingAPathWhichIsAlreadyDoneStops) {
+  odometry->state = {2_m, 0_m, 0_deg};
+  leftMotor->lastVelocity = 50;
+  controller->setTarget("line");
+  controller->waitUntilSettled();
+
+  EXPECT_TRUE(controller->isSettled());
+  EXPECT_EQ(leftMotor->lastVelocity, 0);
+  EXPECT_EQ(controller->getError().x, 0_m);
+}
+
+TEST_F(AsyncPurePursuitControllerTest, ErrorIsTheOffsetToTheEndWhileRunning) {
+  odometry->state = {0.5_m, 0_m, 0_deg};
+  controller->setTarget("line");
+
+  // Nothing moves the robot, so the controller runs until it is reset
+  while (controller->getError().x == 0_m) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  }
+  EXPECT_NEAR(controller->getError().x.convert(meter), 1.5, 1e-12);
+  EXPECT_FALSE(controller->isSettled());
+
+  controller->reset();
+  EXPECT_TRUE(controller->isSettled());
+  EXPECT_EQ(leftMotor->lastVelocity, 0);
+}
+
+TEST_F(AsyncPurePursuitControllerTest, FollowsACornerOnASimulatedDrive) {
+  SimWorld world;
+  auto drive =
+    std::make_shared<SimSkidSteerDrive>(AbstractMotor::gearset::green, 4_in, 10_in, 7_kg);
+  world.addDevice(drive);
+  auto simModel = std::make_shared<SkidSteerModel>(drive->getLeftMotor(),
+                                                   drive->getRightMotor(),
+                                                   drive->getLeftMotor()->getEncoder(),
+                                                   drive->getRightMotor()->getEncoder(),
+                                                   200,
+                                                   v5MotorMaxVoltage);
+  MockAsyncPurePursuitController follower(world.createTimeUtil(),
+                                          simModel,
+                                          odometry,
+                                          scales,
+                                          AbstractMotor::gearset::green,
+                                          limits,
+                                          0.3_m);
+  follower.addPath(
+    AsyncPurePursuitController::interpolate({{0_m, 0_m}, {1_m, 0_m}, {1_m, 1_m}}, 5_cm),
+    "corner");
+
+  const auto &path = follower.getPath("corner");
+  MockAsyncPurePursuitController::FollowState state;
+  double worstOffset = 0;
+  int steps = 0;
+  for (odometry->state = drive->getPose(); !follower.followStep(path, state); steps++) {
+    ASSERT_LT(steps, 1000);
+    world.advance(10_ms);
+    odometry->state = drive->getPose();
+
+    // The distance from the robot to the nearer leg of the corner
+    const double x = odometry->state.x.convert(meter);
+    const double y = odometry->state.y.convert(meter);
+    worstOffset = std::max(worstOffset, std::min(std::abs(y), std::abs(x - 1)));
+  }
+
+  // Cutting the corner with a 30 cm lookahead stays within 10 cm of the path
+  EXPECT_LT(worstOffset, 0.1);
+  EXPECT_NEAR(odometry->state.x.convert(meter), 1, 0.03);
+  EXPECT_NEAR(odometry->state.y.convert(meter), 1, 0.03);
+}
@@ -6,7 +6,9 @@
 #include "okapi/api/control/async/asyncPosPidController.hpp"
 #include "okapi/api/control/async/asyncVelPidController.hpp"
 #include "test/tests/api/implMocks.hpp"
+#include <chrono>
 #include <gtest/gtest.h>
+#include <thread>
 
 using namespace okapi;
 
@@ -116,3 +118,116 @@ TEST_F(AsyncWrapperTest, TestRatioWorks) {
   velController.setTarget(10);
   EXPECT_EQ(velController.getError(), 20);
 }
+
+TEST_F(AsyncWrapperTest, StepsFromScheduler) {
+  auto scheduler = std::make_shared<ControlScheduler>(createTimeUtil());
+  scheduler->startThread();
+
+  {
+    AsyncPosPIDController controller(input, output, createTimeUtil(), 1, 0, 0);
+    controller.startScheduled(scheduler);
+    EXPECT_EQ(controller.getThread(), nullptr);
+    EXPECT_EQ(scheduler->getLoopCount(), 1u);
+
+    controller.setTarget(10);
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    EXPECT_EQ(output->lastVelocity, 1);
+  }
+
+  EXPECT_EQ(scheduler->getLoopCount(), 0u);
+}
+
+TEST_F(AsyncWrapperTest, SchedulerStepsDoNotDependOnTheControllerTimer) {
+  auto scheduler = std::make_shared<ControlScheduler>(createTimeUtil());
+  scheduler->startThread();
+
+  {
+    // The controller's timer never reaches the sample time, which would drop every step
+    AsyncPosPIDController controller(input, output, createConstantTimeUtil(1_ms), 1, 0, 0);
+    controller.startScheduled(scheduler);
+    controller.setTarget(10);
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    EXPECT_EQ(output->lastVelocity, 1);
+  }
+}
+
+TEST_F(AsyncWrapperTest, RecordsLoopTiming) {
+  posPIDController->startThread();
+  posPIDController->setLoopTimingLogInterval(5);
+  std::this_thread::sleep_for(std::chrono::milliseconds(100));
+
+  const auto stats = posPIDController->getLoopTimingStats();
+  EXPECT_GT(stats.sampleCount, 4u);
+  EXPECT_LE(stats.minDt, stats.meanDt);
+  EXPECT_LE(stats.meanDt, stats.maxDt);
+  EXPECT_GE(stats.minDt, 9_ms);
+
+  posPIDController->resetLoopTimingStats();
+  EXPECT_LT(posPIDController->getLoopTimingStats().sampleCount, 2u);
+}
+
+TEST_F(AsyncWrapperTest, AddsTelemetrySignalsUntilDestroyed) {
+  char *buffer = nullptr;
+  size_t size = 0;
+
+  {
+    auto stream =
+      std::make_shared<TelemetryStream>(createTimeUtil(), open_memstream(&buffer, &size));
+    posPIDController->addTelemetry(stream, "lift");
+    EXPECT_EQ(stream->getSignalCount(), 4u);
+
+    delete posPIDController;
+    posPIDController = nullptr;
+    EXPECT_EQ(stream->getSignalCount(), 0u);
+  }
+
+  free(buffer);
+}
+
+TEST_F(AsyncWrapperTest, PostedTargetIsReadBeforeAStepAppliesIt) {
+  posPIDController->startThread();
+  posPIDController->setTarget(10);
+  EXPECT_EQ(posPIDController->getTarget(), 10);
+  EXPECT_FALSE(posPIDController->isSettled());
+
+  std::this_thread::sleep_for(std::chrono::milliseconds(50));
+  EXPECT_EQ(posPIDController->getTarget(), 10);
+  EXPECT_EQ(posPIDController->getError(), 10);
+  EXPECT_EQ(posPIDController->getOutput(), 1);
+  EXPECT_EQ(posPIDController->getProcessValue(), 0);
+}
+
+TEST_F(AsyncWrapperTest, SettlesAtAPostedTargetOnceStepped) {
+  posPIDController->startThread();
+  posPIDController->setTarget(0);
+  posPIDController->waitUntilSettled();
+  EXPECT_EQ(posPIDController->getError(), 0);
+  EXPECT_TRUE(posPIDController->isSettled());
+}
+
+TEST(SharedControllerStateTest, ConcurrentReadsAreNeverTorn) {
+  SharedControllerState<double, double> state;
+  std::atomic_bool done{false};
+
+  // Every published state has the same target, process value, error, and output
+  std::thread writer([&] {
+    for (int i = 0; i < 200000; i++) {
+      state.publish({static_cast<double>(i),
+                     static_cast<double>(i),
+                     static_cast<double>(i),
+                     static_cast<double>(i),
+                     i % 2 == 1});
+    }
+    done = true;
+  });
+
+  while (!done) {
+    const auto read = state.get();
+    EXPECT_EQ(read.target, read.processValue);
+    EXPECT_EQ(read.target, read.error);
+    EXPECT_EQ(read.target, read.output);
+    EXPECT_EQ(static_cast<int>(read.target) % 2 == 1, read.settled);
+  }
+
+  writer.join();
+}
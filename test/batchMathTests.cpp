@@ -0,0 +1,130 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#include "okapi/api/filter/averageFilter.hpp"
+#include "okapi/api/filter/emaFilter.hpp"
+#include "okapi/api/odometry/odomMath.hpp"
+#include "okapi/api/util/batchMath.hpp"
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <gtest/gtest.h>
+
+using namespace okapi;
+
+// Seven channels cover both the four-wide loop and the leftover channels on the brain
+constexpr std::size_t channels = 7;
+
+TEST(BatchMathTest, EmaStepMatchesAnEmaFilter) {
+  std::array<float, channels> output{};
+  std::array<EmaFilter, channels> filters{EmaFilter(0.3),
+                                          EmaFilter(0.3),
+                                          EmaFilter(0.3),
+                                          EmaFilter(0.3),
+                                          EmaFilter(0.3),
+                                          EmaFilter(0.3),
+                                          EmaFilter(0.3)};
+
+  for (const float reading : {3, 1, 4, 1, 5, 9, 2, 6}) {
+    std::array<float, channels> input;
+    for (std::size_t i = 0; i < channels; i++) {
+      input[i] = reading * static_cast<float>(i) - 2;
+    }
+
+    BatchMath::emaStep(output.data(), input.data(), 0.3f, channels);
+    for (std::size_t i = 0; i < channels; i++) {
+      EXPECT_NEAR(output[i], filters[i].filter(input[i]), 1e-5) << "channel " << i;
+    }
+  }
+}
+
+TEST(BatchMathTest, MovingAverageStepMatchesAnAverageFilter) {
+  constexpr std::size_t length = 3;
+  std::array<float, channels> sum{};
+  std::array<float, channels> output{};
+  std::array<std::array<float, channels>, length> window{};
+  std::array<AverageFilter<length>, channels> filters{};
+
+  for (const float reading : {3, 1, 4, 1, 5, 9, 2, 6}) {
+    // The slot being overwritten holds the reading leaving the window, or zero at first
+    auto &slot = window[0];
+    const std::array<float, channels> oldest = slot;
+    for (std::size_t i = 0; i < channels; i++) {
+      slot[i] = reading + static_cast<float>(i);
+    }
+
+    BatchMath::movingAverageStep(
+      sum.data(), slot.data(), oldest.data(), output.data(), length, channels);
+    for (std::size_t i = 0; i < channels; i++) {
+      EXPECT_NEAR(output[i], filters[i].filter(slot[i]), 1e-5) << "channel " << i;
+    }
+
+    std::rotate(window.begin(), window.begin() + 1, window.end());
+  }
+}
+
+TEST(BatchMathTest, MixXDriveMatchesXArcade) {
+  const std::array<float, channels> x{0, 0.5f, -0.5f, 0, 1, 0.25f, -1};
+  const std::array<float, channels> forward{1, 0.5f, 0, -0.25f, 1, 0.25f, 0};
+  const std::array<float, channels> yaw{0, 0, 0.5f, 0.25f, 1, -0.25f, 0.5f};
+  std::array<float, channels> topLeft, topRight, bottomRight, bottomLeft;
+
+  BatchMath::mixXDrive(x.data(),
+                       forward.data(),
+                       yaw.data(),
+                       topLeft.data(),
+                       topRight.data(),
+                       bottomRight.data(),
+                       bottomLeft.data(),
+                       channels);
+
+  const auto clamp = [](const float ivalue) { return std::clamp(ivalue, -1.0f, 1.0f); };
+  for (std::size_t i = 0; i < channels; i++) {
+    EXPECT_FLOAT_EQ(topLeft[i], clamp(forward[i] + x[i] + yaw[i])) << "channel " << i;
+    EXPECT_FLOAT_EQ(topRight[i], clamp(forward[i] - x[i] - yaw[i])) << "channel " << i;
+    EXPECT_FLOAT_EQ(bottomRight[i], clamp(forward[i] + x[i] - yaw[i])) << "channel " << i;
+    EXPECT_FLOAT_EQ(bottomLeft[i], clamp(forward[i] - x[i] + yaw[i])) << "channel " << i;
+  }
+}
+
+TEST(BatchMathTest, IntegratePosesMatchesTheExponentialMap) {
+  std::array<float, channels> x{}, y{}, cosTheta, sinTheta, forward, right, deltaTheta;
+  std::array<OdomState, channels> expected{};
+  for (std::size_t i = 0; i < channels; i++) {
+    const double start = 0.4 * static_cast<double>(i);
+    cosTheta[i] = static_cast<float>(std::cos(start));
+    sinTheta[i] = static_cast<float>(std::sin(start));
+    expected[i].theta = start * radian;
+    forward[i] = 0.01f * static_cast<float>(i + 1);
+    right[i] = 0.002f * static_cast<float>(i) - 0.005f;
+    deltaTheta[i] = 0.01f * static_cast<float>(i) - 0.03f;
+  }
+
+  for (int step = 0; step < 100; step++) {
+    BatchMath::integratePoses(x.data(),
+                              y.data(),
+                              cosTheta.data(),
+                              sinTheta.data(),
+                              forward.data(),
+                              right.data(),
+                              deltaTheta.data(),
+                              channels);
+
+    for (std::size_t i = 0; i < channels; i++) {
+      const OdomState delta = OdomMath::integrateExponentialMap(
+        forward[i] * meter, right[i] * meter, deltaTheta[i] * radian, expected[i].theta);
+      expected[i].x += delta.x;
+      expected[i].y += delta.y;
+      expected[i].theta += delta.theta;
+    }
+  }
+
+  for (std::size_t i = 0; i < channels; i++) {
+    EXPECT_NEAR(x[i], expected[i].x.convert(meter), 1e-4) << "channel " << i;
+    EXPECT_NEAR(y[i], expected[i].y.convert(meter), 1e-4) << "channel " << i;
+    EXPECT_NEAR(cosTheta[i], std::cos(expected[i].theta.convert(radian)), 1e-5) << "channel " << i;
+    EXPECT_NEAR(sinTheta[i], std::sin(expected[i].theta.convert(radian)), 1e-5) << "channel " << i;
+  }
+}
@@ -4,8 +4,11 @@
  * file, You can obtain one at http://mozilla.org/MPL/2.0/.
  */
 #include "okapi/api/device/button/buttonBase.hpp"
+#include "okapi/api/device/button/buttonEventService.hpp"
+#include "test/tests/api/implMocks.hpp"
 #include <gtest/gtest.h>
 #include <utility>
+#include <vector>
 
 using namespace okapi;
 
@@ -99,3 +102,97 @@ TEST_F(ButtonBaseChangeTest, CallAllMethodsTogether) {
   EXPECT_FALSE(btn.changedToPressed());
   EXPECT_FALSE(btn.changedToReleased());
 }
+
+class ButtonEventServiceTest : public ::testing::Test {
+  protected:
+  std::uint32_t states{0};
+  ButtonEventService service{[&] { return states; }, createTimeUtil(), 10_ms, 4};
+};
+
+TEST_F(ButtonEventServiceTest, FirstSampleOnlyRecordsTheStates) {
+  states = 0b101;
+  service.step();
+
+  ButtonEvent event;
+  EXPECT_FALSE(service.poll(event));
+  EXPECT_TRUE(service.isPressed(0));
+  EXPECT_FALSE(service.isPressed(1));
+  EXPECT_TRUE(service.isPressed(2));
+  EXPECT_EQ(service.getStates(), 0b101u);
+}
+
+TEST_F(ButtonEventServiceTest, QueuesEdgesInOrder) {
+  service.step();
+
+  states = 0b10;
+  service.step();
+  states = 0b01;
+  service.step();
+
+  ButtonEvent event;
+  ASSERT_TRUE(service.poll(event));
+  EXPECT_EQ(event.button, 1);
+  EXPECT_TRUE(event.pressed);
+  ASSERT_TRUE(service.poll(event));
+  EXPECT_EQ(event.button, 0);
+  EXPECT_TRUE(event.pressed);
+  ASSERT_TRUE(service.poll(event));
+  EXPECT_EQ(event.button, 1);
+  EXPECT_FALSE(event.pressed);
+  EXPECT_FALSE(service.poll(event));
+}
+
+TEST_F(ButtonEventServiceTest, KeepsATapBetweenPolls) {
+  service.step();
+
+  // The button is pressed and released before the user polls
+  states = 0b1000;
+  service.step();
+  states = 0;
+  service.step();
+
+  ButtonEvent event;
+  ASSERT_TRUE(service.poll(event));
+  EXPECT_TRUE(event.pressed);
+  ASSERT_TRUE(service.poll(event));
+  EXPECT_FALSE(event.pressed);
+  EXPECT_EQ(event.button, 3);
+}
+
+TEST_F(ButtonEventServiceTest, DropsEventsWhileTheQueueIsFull) {
+  service.step();
+
+  for (int i = 0; i < 3; i++) {
+    states = 0b1;
+    service.step();
+    states = 0;
+    service.step();
+  }
+
+  EXPECT_EQ(service.getDroppedCount(), 2u);
+
+  int count = 0;
+  ButtonEvent event;
+  while (service.poll(event)) {
+    count++;
+  }
+  EXPECT_EQ(count, 4);
+}
+
+TEST_F(ButtonEventServiceTest, CallsTheCallbacksOfTheButton) {
+  std::vector<std::pair<std::uint8_t, bool>> buttonTwoEvents;
+  std::vector<std::pair<std::uint8_t, bool>> allEvents;
+  service.addCallback(2, [&](const ButtonEvent &ievent) {
+    buttonTwoEvents.emplace_back(ievent.button, ievent.pressed);
+  });
+  service.addCallback(ButtonEventService::anyButton, [&](const ButtonEvent &ievent) {
+    allEvents.emplace_back(ievent.button, ievent.pressed);
+  });
+
+  service.step();
+  states = 0b101;
+  service.step();
+
+  EXPECT_EQ(buttonTwoEvents, (std::vector<std::pair<std::uint8_t, bool>>{{2, true}}));
+  EXPECT_EQ(allEvents, (std::vector<std::pair<std::uint8_t, bool>>{{0, true}, {2, true}}));
+}
@@ -0,0 +1,186 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#include "okapi/api/control/async/cascadePositionController.hpp"
+#include "okapi/api/control/iterative/iterativeVelPidController.hpp"
+#include "test/tests/api/implMocks.hpp"
+#include <gtest/gtest.h>
+
+using namespace okapi;
+
+class CascadeMockOutput : public ControllerOutput<double> {
+  public:
+  void controllerSet(const double ivalue) override {
+    lastValue = ivalue;
+    setCount++;
+  }
+
+  double lastValue{0};
+  int setCount{0};
+};
+
+class CascadePositionControllerTest : public ::testing::Test {
+  protected:
+  void SetUp() override {
+    input = std::make_shared<MockControllerInput>();
+    outer = std::make_shared<IterativePosPIDController>(
+      IterativePosPIDController::Gains{0.01, 0, 0, 0}, createConstantTimeUtil(20_ms));
+    asyncInner = std::make_shared<MockAsyncVelIntegratedController>();
+    controller = std::make_unique<CascadePositionController>(
+      input, outer, asyncInner, 200, createConstantTimeUtil(5_ms));
+  }
+
+  std::shared_ptr<IterativeVelPIDController> makeIterativeInner() const {
+    // Only feedforward, so the output is the target scaled by kF
+    return std::make_shared<IterativeVelPIDController>(
+      0,
+      0,
+      0.001,
+      0,
+      std::make_unique<VelMath>(360,
+                                std::make_unique<PassthroughFilter>(),
+                                5_ms,
+                                std::make_unique<ConstantMockTimer>(5_ms)),
+      createConstantTimeUtil(5_ms));
+  }
+
+  std::shared_ptr<MockControllerInput> input;
+  std::shared_ptr<IterativePosPIDController> outer;
+  std::shared_ptr<MockAsyncVelIntegratedController> asyncInner;
+  std::unique_ptr<CascadePositionController> controller;
+};
+
+TEST_F(CascadePositionControllerTest, SetsTheSampleTimesOfBothLoops) {
+  auto inner = makeIterativeInner();
+  CascadePositionController cascade(input,
+                                    outer,
+                                    inner,
+                                    std::make_shared<CascadeMockOutput>(),
+                                    200,
+                                    createConstantTimeUtil(5_ms),
+                                    5_ms,
+                                    20_ms);
+
+  EXPECT_EQ(outer->getSampleTime(), 20_ms);
+  EXPECT_EQ(inner->getSampleTime(), 5_ms);
+}
+
+TEST_F(CascadePositionControllerTest, OuterOutputScalesIntoTheInnerTarget) {
+  controller->setTarget(10);
+  controller->step();
+
+  EXPECT_DOUBLE_EQ(controller->getInnerTarget(), 0.1 * 200);
+  EXPECT_DOUBLE_EQ(asyncInner->lastTarget, 0.1 * 200);
+}
+
+TEST_F(CascadePositionControllerTest, OuterLoopStepsEveryFourthInnerStep) {
+  controller->setTarget(10);
+  controller->step();
+  EXPECT_DOUBLE_EQ(asyncInner->lastTarget, 20);
+
+  input->reading = 5;
+  for (int i = 0; i < 3; i++) {
+    controller->step();
+    EXPECT_DOUBLE_EQ(asyncInner->lastTarget, 20);
+  }
+
+  controller->step();
+  EXPECT_DOUBLE_EQ(asyncInner->lastTarget, 10);
+}
+
+TEST_F(CascadePositionControllerTest, NewTargetStepsTheOuterLoopOnTheNextStep) {
+  controller->setTarget(10);
+  controller->step();
+  controller->step();
+
+  controller->setTarget(5);
+  controller->step();
+  EXPECT_DOUBLE_EQ(asyncInner->lastTarget, 10);
+}
+
+TEST_F(CascadePositionControllerTest, IterativeInnerLoopStepsEveryStep) {
+  auto inner = makeIterativeInner();
+  auto output = std::make_shared<CascadeMockOutput>();
+  CascadePositionController cascade(
+    input, outer, inner, output, 200, createConstantTimeUtil(5_ms));
+
+  cascade.setTarget(10);
+  for (int i = 0; i < 8; i++) {
+    cascade.step();
+  }
+
+  EXPECT_EQ(output->setCount, 8);
+  EXPECT_DOUBLE_EQ(inner->getTarget(), 20);
+  EXPECT_DOUBLE_EQ(output->lastValue, 0.001 * 20);
+}
+
+TEST_F(CascadePositionControllerTest, SetMaxVelocityScalesTheInnerTarget) {
+  controller->setMaxVelocity(100);
+  controller->setTarget(10);
+  controller->step();
+
+  EXPECT_DOUBLE_EQ(asyncInner->lastTarget, 10);
+}
+
+TEST_F(CascadePositionControllerTest, TarePositionOffsetsTheOuterLoop) {
+  input->reading = 10;
+  controller->tarePosition();
+  controller->setTarget(10);
+  controller->step();
+
+  EXPECT_DOUBLE_EQ(controller->getProcessValue(), 0);
+  EXPECT_DOUBLE_EQ(controller->getError(), 10);
+}
+
+TEST_F(CascadePositionControllerTest, DisabledControllerDoesNotStep) {
+  auto inner = makeIterativeInner();
+  auto output = std::make_shared<CascadeMockOutput>();
+  CascadePositionController cascade(
+    input, outer, inner, output, 200, createConstantTimeUtil(5_ms));
+
+  cascade.setTarget(10);
+  cascade.flipDisable(true);
+  EXPECT_TRUE(cascade.isDisabled());
+  EXPECT_TRUE(cascade.isSettled());
+  EXPECT_DOUBLE_EQ(output->lastValue, 0);
+
+  const int setCount = output->setCount;
+  cascade.step();
+  EXPECT_EQ(output->setCount, setCount);
+  EXPECT_TRUE(inner->isDisabled());
+}
+
+TEST_F(CascadePositionControllerTest, EnablingResumesTheLastTarget) {
+  controller->setTarget(10);
+  controller->flipDisable(true);
+  controller->flipDisable(false);
+  controller->step();
+
+  EXPECT_DOUBLE_EQ(controller->getTarget(), 10);
+  EXPECT_DOUBLE_EQ(asyncInner->lastTarget, 20);
+}
+
+TEST_F(CascadePositionControllerTest, ConstructorThrowsOnAnOuterPeriodShorterThanTheInner) {
+  EXPECT_THROW(CascadePositionController(
+                 input, outer, asyncInner, 200, createConstantTimeUtil(5_ms), 20_ms, 10_ms),
+               std::invalid_argument);
+}
+
+TEST_F(CascadePositionControllerTest, ConstructorThrowsOnANullInnerController) {
+  EXPECT_THROW(CascadePositionController(input,
+                                         outer,
+                                         std::shared_ptr<AsyncVelocityController<double, double>>(),
+                                         200,
+                                         createConstantTimeUtil(5_ms)),
+               std::invalid_argument);
+}
+
+TEST_F(CascadePositionControllerTest, StepsInItsOwnTask) {
+  controller->setTarget(10);
+  controller->startThread();
+  std::this_thread::sleep_for(std::chrono::milliseconds(50));
+
+  EXPECT_DOUBLE_EQ(asyncInner->lastTarget, 20);
+}
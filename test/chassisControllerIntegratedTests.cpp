@@ -6,7 +6,9 @@
 #include "okapi/api/chassis/controller/chassisControllerIntegrated.hpp"
 #include "okapi/api/chassis/model/skidSteerModel.hpp"
 #include "test/tests/api/implMocks.hpp"
+#include <chrono>
 #include <gtest/gtest.h>
+#include <thread>
 
 using namespace okapi;
 
@@ -394,3 +396,141 @@ TEST_F(ChassisControllerIntegratedTest, SetsTheCorrectTargetWhenCustomSensorsAre
   EXPECT_DOUBLE_EQ(leftController->getTarget(), 200);
   EXPECT_DOUBLE_EQ(rightController->getTarget(), -200);
 }
+
+TEST_F(ChassisControllerIntegratedTest, StalledMoveEndsAndReportsTheStall) {
+  leftController->isSettledOverride = IsSettledOverride::neverSettled;
+  rightController->isSettledOverride = IsSettledOverride::neverSettled;
+  controller->setStallDetection(0.1_mps, 100_ms);
+
+  // The mock motors never move, so the robot looks like it ran into a wall
+  controller->moveDistance(1_m);
+  EXPECT_EQ(controller->getLastMoveResult(), MoveResult::stalled);
+  EXPECT_TRUE(leftController->isDisabled());
+  EXPECT_TRUE(rightController->isDisabled());
+}
+
+TEST_F(ChassisControllerIntegratedTest, TimedOutTurnEndsAndReportsTheTimeout) {
+  leftController->isSettledOverride = IsSettledOverride::neverSettled;
+  rightController->isSettledOverride = IsSettledOverride::neverSettled;
+  controller->setMoveTimeout(100_ms);
+
+  controller->turnAngle(90_deg);
+  EXPECT_EQ(controller->getLastMoveResult(), MoveResult::timedOut);
+
+  leftController->isSettledOverride = IsSettledOverride::alwaysSettled;
+  rightController->isSettledOverride = IsSettledOverride::alwaysSettled;
+  controller->turnAngle(90_deg);
+  EXPECT_EQ(controller->getLastMoveResult(), MoveResult::settled);
+}
+
+TEST_F(ChassisControllerIntegratedTest, ProfiledMoveStreamsVelocitiesThenHoldsTheTarget) {
+  controller->setProfileLimits({1, 4, 0}, 5_ms);
+  EXPECT_NE(controller->getThread(), nullptr);
+  controller->moveDistanceAsync(wheelDiam * 1_pi);
+  std::this_thread::sleep_for(std::chrono::milliseconds(50));
+
+  // The position controllers wait for the profile
+  EXPECT_TRUE(leftController->isDisabled());
+  EXPECT_GT(leftMotor->lastVelocity, 0);
+  EXPECT_GT(rightMotor->lastVelocity, 0);
+  EXPECT_FALSE(controller->isSettled());
+
+  controller->waitUntilSettled();
+  const double ticksPerRotation = gearsetToTPR(gearset);
+  EXPECT_DOUBLE_EQ(leftController->getTarget(), ticksPerRotation);
+  EXPECT_DOUBLE_EQ(rightController->getTarget(), ticksPerRotation);
+}
+
+TEST_F(ChassisControllerIntegratedTest, ProfiledTurnSpinsTheSidesApart) {
+  controller->setProfileLimits({1, 4, 0});
+  controller->turnAngleAsync(90_deg);
+  std::this_thread::sleep_for(std::chrono::milliseconds(50));
+
+  EXPECT_GT(leftMotor->lastVelocity, 0);
+  EXPECT_LT(rightMotor->lastVelocity, 0);
+  controller->stop();
+  EXPECT_TRUE(controller->isSettled());
+}
+
+TEST_F(ChassisControllerIntegratedTest, ClearProfileLimitsSendsPositionTargets) {
+  controller->setProfileLimits({1, 4, 0});
+  controller->clearProfileLimits();
+  controller->moveDistanceAsync(wheelDiam * 1_pi);
+
+  EXPECT_FALSE(leftController->isDisabled());
+  EXPECT_TRUE(controller->isSettled());
+}
+
+TEST_F(ChassisControllerIntegratedTest, SetProfileLimitsWithInvalidLimitsThrows) {
+  EXPECT_THROW(controller->setProfileLimits({0, 1, 0}), std::invalid_argument);
+  EXPECT_THROW(controller->setProfileLimits({1, 0, 0}), std::invalid_argument);
+  EXPECT_THROW(controller->setProfileLimits({1, 1, 0}, 0_ms), std::invalid_argument);
+}
+
+TEST_F(ChassisControllerIntegratedTest, HeadingCorrectionSlowsTheSideWhichIsAhead) {
+  auto imu = std::make_shared<MockImu>();
+  controller->setHeadingCorrection(imu, 0.05);
+  EXPECT_NE(controller->getThread(), nullptr);
+  controller->moveDistanceAsync(1_m);
+
+  // Drifting clockwise means the left side is ahead
+  imu->heading = 4;
+  std::this_thread::sleep_for(std::chrono::milliseconds(50));
+
+  EXPECT_EQ(leftController->lastProfiledVelocity, 81);
+  EXPECT_EQ(rightController->lastProfiledVelocity, 0);
+  controller->stop();
+}
+
+TEST_F(ChassisControllerIntegratedTest, HeadingCorrectionSlowsTheRightSideWhenMovingBackward) {
+  auto imu = std::make_shared<MockImu>();
+  controller->setHeadingCorrection(imu, 0.05);
+  controller->moveDistanceAsync(-1_m);
+
+  imu->heading = 4;
+  std::this_thread::sleep_for(std::chrono::milliseconds(50));
+
+  EXPECT_EQ(leftController->lastProfiledVelocity, 0);
+  EXPECT_EQ(rightController->lastProfiledVelocity, 81);
+  controller->stop();
+}
+
+TEST_F(ChassisControllerIntegratedTest, HeadingCorrectionLeavesTurnsAlone) {
+  auto imu = std::make_shared<MockImu>();
+  controller->setHeadingCorrection(imu, 0.05);
+  controller->turnAngleAsync(90_deg);
+
+  imu->heading = 10;
+  std::this_thread::sleep_for(std::chrono::milliseconds(50));
+
+  EXPECT_EQ(leftController->lastProfiledVelocity, 0);
+  EXPECT_EQ(rightController->lastProfiledVelocity, 0);
+  controller->stop();
+}
+
+TEST_F(ChassisControllerIntegratedTest, HeadingCorrectionTrimsTheStreamedProfile) {
+  auto imu = std::make_shared<MockImu>();
+  controller->setProfileLimits({1, 4, 0});
+  controller->setHeadingCorrection(imu, 0.05);
+  controller->moveDistanceAsync(1_m);
+
+  imu->heading = 10;
+  std::this_thread::sleep_for(std::chrono::milliseconds(80));
+
+  EXPECT_GT(leftMotor->lastVelocity, 0);
+  EXPECT_LT(leftMotor->lastVelocity, rightMotor->lastVelocity);
+  controller->stop();
+}
+
+TEST_F(ChassisControllerIntegratedTest, SetHeadingCorrectionWithNegativeGainThrows) {
+  EXPECT_THROW(controller->setHeadingCorrection(std::make_shared<MockImu>(), -1),
+               std::invalid_argument);
+}
+
+TEST_F(ChassisControllerIntegratedTest, LazyThreadStartsOnTheFirstMovement) {
+  controller->startThreadLazily();
+  EXPECT_EQ(controller->getThread(), nullptr);
+
+  controller->moveRaw(100);
+  EXPECT_NE(controller->getThread(), nullptr);
+}
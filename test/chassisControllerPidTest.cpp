@@ -6,7 +6,9 @@
 #include "okapi/api/chassis/controller/chassisControllerPid.hpp"
 #include "okapi/api/chassis/model/skidSteerModel.hpp"
 #include "test/tests/api/implMocks.hpp"
+#include <chrono>
 #include <gtest/gtest.h>
+#include <thread>
 
 using namespace okapi;
 
@@ -399,3 +401,431 @@ TEST_F(ChassisControllerPIDTest, isSettledInModeNone) {
   controller->mode = CCPIDUnderTest::modeType::none;
   EXPECT_TRUE(controller->isSettled());
 }
+
+TEST_F(ChassisControllerPIDTest, SetDistanceProfileScalesTheFeedforwardToTicks) {
+  controller->setDistanceProfile({0.05, 2, 0.5}, 1_mps, 4_mps2);
+
+  const double ticksPerMeter = scales->straight;
+  EXPECT_EQ(distanceController->getFeedforward(),
+            (MotorFeedforward{0.05, 2 / ticksPerMeter, 0.5 / ticksPerMeter}));
+
+  controller->clearDistanceProfile();
+  EXPECT_EQ(distanceController->getFeedforward(), MotorFeedforward{});
+}
+
+TEST_F(ChassisControllerPIDTest, ProfiledMoveDistanceRampsTheTarget) {
+  controller->setDistanceProfile({0, 1, 0}, 1_mps, 4_mps2);
+  controller->moveDistanceAsync(wheelDiam * 1_pi);
+
+  // The target starts where the robot is and only reaches the end once the profile is done
+  const double fullTarget = gearsetToTPR(controller->getGearsetRatioPair().internalGearset);
+  EXPECT_LT(distanceController->getTarget(), fullTarget);
+  EXPECT_FALSE(controller->isSettled());
+
+  controller->waitUntilSettled();
+  EXPECT_DOUBLE_EQ(distanceController->getTarget(), fullTarget);
+  assertMotorsHaveBeenStopped(leftMotor, rightMotor);
+}
+
+TEST_F(ChassisControllerPIDTest, SetDistanceProfileWithInvalidLimitsThrows) {
+  EXPECT_THROW(controller->setDistanceProfile({}, 0_mps, 1_mps2), std::invalid_argument);
+  EXPECT_THROW(controller->setDistanceProfile({}, 1_mps, -1_mps2), std::invalid_argument);
+}
+
+TEST_F(ChassisControllerPIDTest, ProfiledTurnAngleRampsTheTarget) {
+  controller->setProfileLimits({1, 4, 40}, ChassisControllerPID::ProfileShape::sCurve);
+  controller->turnAngleAsync(90_deg);
+
+  const double fullTarget = 90 * scales->turn;
+  EXPECT_LT(turnController->getTarget(), fullTarget);
+  EXPECT_FALSE(controller->isSettled());
+
+  controller->waitUntilSettled();
+  EXPECT_DOUBLE_EQ(turnController->getTarget(), fullTarget);
+  assertMotorsHaveBeenStopped(leftMotor, rightMotor);
+}
+
+TEST_F(ChassisControllerPIDTest, ClearProfileLimitsJumpsToTheTarget) {
+  controller->setProfileLimits({1, 4, 40});
+  controller->clearProfileLimits();
+  controller->turnAngleAsync(90_deg);
+  EXPECT_DOUBLE_EQ(turnController->getTarget(), 90 * scales->turn);
+}
+
+TEST_F(ChassisControllerPIDTest, SetProfileLimitsWithInvalidLimitsThrows) {
+  EXPECT_THROW(controller->setProfileLimits({0, 1, 1}), std::invalid_argument);
+  EXPECT_THROW(controller->setProfileLimits({1, 0, 1}), std::invalid_argument);
+  EXPECT_NO_THROW(controller->setProfileLimits({1, 1, 0}));
+  EXPECT_THROW(controller->setProfileLimits({1, 1, 0}, ChassisControllerPID::ProfileShape::sCurve),
+               std::invalid_argument);
+}
+
+TEST_F(ChassisControllerPIDTest, HeadingSensorTurnsTargetDegrees) {
+  auto imu = std::make_shared<MockImu>();
+  controller->setHeadingSensor(imu);
+  EXPECT_EQ(controller->getHeadingSensor(), imu);
+
+  controller->turnAngleAsync(90_deg);
+  EXPECT_DOUBLE_EQ(turnController->getTarget(), 90);
+
+  controller->setTurnsMirrored(true);
+  controller->turnAngleAsync(90_deg);
+  EXPECT_DOUBLE_EQ(turnController->getTarget(), -90);
+
+  controller->setHeadingSensor(nullptr);
+  controller->setTurnsMirrored(false);
+  controller->turnAngleAsync(90_deg);
+  EXPECT_DOUBLE_EQ(turnController->getTarget(), 90 * scales->turn);
+}
+
+TEST_F(ChassisControllerPIDTest, HeadingSensorFeedsTheTurnController) {
+  auto imu = std::make_shared<MockImu>();
+  imu->heading = 10;
+  controller->setHeadingSensor(imu);
+  controller->turnAngleAsync(90_deg);
+  std::this_thread::sleep_for(std::chrono::milliseconds(50));
+
+  // The turn is measured from where the heading was when it started
+  imu->heading = 40;
+  std::this_thread::sleep_for(std::chrono::milliseconds(50));
+  EXPECT_DOUBLE_EQ(turnController->getError(), 60);
+  controller->stop();
+}
+
+TEST_F(ChassisControllerPIDTest, HeadingSensorFeedsTheAngleController) {
+  auto imu = std::make_shared<MockImu>();
+  controller->setHeadingSensor(imu);
+  controller->moveDistanceAsync(1_m);
+  std::this_thread::sleep_for(std::chrono::milliseconds(50));
+
+  imu->heading = 5;
+  std::this_thread::sleep_for(std::chrono::milliseconds(50));
+  EXPECT_DOUBLE_EQ(angleController->getError(), -5);
+  controller->stop();
+}
+
+TEST_F(ChassisControllerPIDTest, ProfiledTurnWithAHeadingSensorRampsTheTargetInDegrees) {
+  controller->setHeadingSensor(std::make_shared<MockImu>());
+  controller->setProfileLimits({1, 4, 40}, ChassisControllerPID::ProfileShape::sCurve);
+  controller->turnAngleAsync(90_deg);
+
+  EXPECT_LT(turnController->getTarget(), 90);
+  controller->waitUntilSettled();
+  EXPECT_DOUBLE_EQ(turnController->getTarget(), 90);
+}
+
+TEST_F(ChassisControllerPIDTest, QueuedCommandsRunInOrder) {
+  controller->enqueue(ChassisCommand::move(wheelDiam * 1_pi))
+    .then(ChassisCommand::turn(90_deg))
+    .then(ChassisCommand::move(wheelDiam * 2_pi));
+  controller->waitUntilSettled();
+
+  const double ticksPerRotation = gearsetToTPR(controller->getGearsetRatioPair().internalGearset);
+  EXPECT_EQ(controller->getQueueSize(), 0u);
+  EXPECT_DOUBLE_EQ(turnController->getTarget(), 90 * scales->turn);
+  EXPECT_DOUBLE_EQ(distanceController->getTarget(), 2 * ticksPerRotation);
+  EXPECT_TRUE(controller->isSettled());
+  assertMotorsHaveBeenStopped(leftMotor, rightMotor);
+}
+
+TEST_F(ChassisControllerPIDTest, QueuedCommandWaitsForTheCurrentOneToSettle) {
+  turnController->isSettledOverride = IsSettledOverride::neverSettled;
+  controller->enqueue(ChassisCommand::turn(90_deg)).then(ChassisCommand::move(wheelDiam * 1_pi));
+  std::this_thread::sleep_for(std::chrono::milliseconds(50));
+
+  EXPECT_EQ(controller->mode, CCPIDUnderTest::modeType::angle);
+  EXPECT_EQ(controller->getQueueSize(), 1u);
+  EXPECT_FALSE(controller->isSettled());
+
+  turnController->isSettledOverride = IsSettledOverride::alwaysSettled;
+  controller->waitUntilSettled();
+  EXPECT_DOUBLE_EQ(distanceController->getTarget(),
+                   gearsetToTPR(controller->getGearsetRatioPair().internalGearset));
+}
+
+TEST_F(ChassisControllerPIDTest, QueuedCommandFollowsAnAsyncMove) {
+  distanceController->isSettledOverride = IsSettledOverride::neverSettled;
+  controller->moveRawAsync(100);
+  controller->enqueue(ChassisCommand::turn(90_deg));
+  std::this_thread::sleep_for(std::chrono::milliseconds(50));
+  EXPECT_EQ(controller->mode, CCPIDUnderTest::modeType::distance);
+
+  distanceController->isSettledOverride = IsSettledOverride::alwaysSettled;
+  controller->waitUntilSettled();
+  EXPECT_DOUBLE_EQ(turnController->getTarget(), 90 * scales->turn);
+}
+
+TEST_F(ChassisControllerPIDTest, AsyncMoveClearsTheQueue) {
+  turnController->isSettledOverride = IsSettledOverride::neverSettled;
+  controller->enqueue(ChassisCommand::turn(90_deg)).then(ChassisCommand::move(wheelDiam * 1_pi));
+  controller->moveRawAsync(100);
+  EXPECT_EQ(controller->getQueueSize(), 0u);
+
+  controller->waitUntilSettled();
+  EXPECT_DOUBLE_EQ(distanceController->getTarget(), 100);
+  assertMotorsHaveBeenStopped(leftMotor, rightMotor);
+}
+
+TEST_F(ChassisControllerPIDTest, StopClearsTheQueue) {
+  turnController->isSettledOverride = IsSettledOverride::neverSettled;
+  controller->enqueue(ChassisCommand::turn(90_deg)).then(ChassisCommand::move(wheelDiam * 1_pi));
+  controller->stop();
+
+  EXPECT_EQ(controller->getQueueSize(), 0u);
+  EXPECT_TRUE(controller->isSettled());
+}
+
+TEST_F(ChassisControllerPIDTest, LooselySettledCommandMovesOnInsideTheTolerance) {
+  auto imu = std::make_shared<MockImu>();
+  controller->setHeadingSensor(imu);
+  controller->setLooseSettleTolerance(1_in, 3_deg);
+  turnController->isSettledOverride = IsSettledOverride::neverSettled;
+  controller->enqueue(ChassisCommand::turn(90_deg, ChassisCommand::Settle::loose))
+    .then(ChassisCommand::move(wheelDiam * 1_pi));
+  std::this_thread::sleep_for(std::chrono::milliseconds(50));
+
+  imu->heading = 85;
+  std::this_thread::sleep_for(std::chrono::milliseconds(50));
+  EXPECT_EQ(controller->mode, CCPIDUnderTest::modeType::angle);
+
+  // The turn controller never settles, but the error is inside the loose tolerance
+  imu->heading = 88;
+  std::this_thread::sleep_for(std::chrono::milliseconds(50));
+  EXPECT_EQ(controller->mode, CCPIDUnderTest::modeType::distance);
+
+  controller->waitUntilSettled();
+  assertMotorsHaveBeenStopped(leftMotor, rightMotor);
+}
+
+TEST_F(ChassisControllerPIDTest, ExitOnCrossCommandMovesOnAtTheTarget) {
+  auto imu = std::make_shared<MockImu>();
+  controller->setHeadingSensor(imu);
+  turnController->isSettledOverride = IsSettledOverride::neverSettled;
+  controller->enqueue(ChassisCommand::turn(-90_deg, ChassisCommand::Settle::exitOnCross))
+    .then(ChassisCommand::move(wheelDiam * 1_pi));
+  std::this_thread::sleep_for(std::chrono::milliseconds(50));
+
+  imu->heading = -89;
+  std::this_thread::sleep_for(std::chrono::milliseconds(50));
+  EXPECT_EQ(controller->mode, CCPIDUnderTest::modeType::angle);
+
+  imu->heading = -91;
+  std::this_thread::sleep_for(std::chrono::milliseconds(50));
+  EXPECT_EQ(controller->mode, CCPIDUnderTest::modeType::distance);
+
+  controller->waitUntilSettled();
+  assertMotorsHaveBeenStopped(leftMotor, rightMotor);
+}
+
+TEST_F(ChassisControllerPIDTest, WaitUntilSettledReturnsOnceALooseLastCommandIsDone) {
+  auto imu = std::make_shared<MockImu>();
+  controller->setHeadingSensor(imu);
+  turnController->isSettledOverride = IsSettledOverride::neverSettled;
+  imu->heading = 2;
+  controller->enqueue(ChassisCommand::turn(2_deg, ChassisCommand::Settle::loose));
+
+  // The turn never settles tightly, but it started inside the loose tolerance
+  controller->waitUntilSettled();
+  EXPECT_TRUE(turnController->isDisabled());
+  assertMotorsHaveBeenStopped(leftMotor, rightMotor);
+}
+
+TEST_F(ChassisControllerPIDTest, StalledMoveEndsAndReportsTheStall) {
+  distanceController->isSettledOverride = IsSettledOverride::neverSettled;
+  angleController->isSettledOverride = IsSettledOverride::neverSettled;
+  controller->setStallDetection(0.1_mps, 100_ms);
+
+  // The mock encoders never move, so the robot looks like it ran into a wall
+  controller->moveDistance(1_m);
+  EXPECT_EQ(controller->getLastMoveResult(), MoveResult::stalled);
+  assertMotorsHaveBeenStopped(leftMotor, rightMotor);
+}
+
+TEST_F(ChassisControllerPIDTest, TimedOutTurnEndsAndReportsTheTimeout) {
+  turnController->isSettledOverride = IsSettledOverride::neverSettled;
+  controller->setMoveTimeout(100_ms);
+
+  controller->turnAngle(90_deg);
+  EXPECT_EQ(controller->getLastMoveResult(), MoveResult::timedOut);
+  assertMotorsHaveBeenStopped(leftMotor, rightMotor);
+
+  // The next movement starts over
+  turnController->isSettledOverride = IsSettledOverride::alwaysSettled;
+  controller->turnAngle(90_deg);
+  EXPECT_EQ(controller->getLastMoveResult(), MoveResult::settled);
+}
+
+TEST_F(ChassisControllerPIDTest, QueuedCommandTimeoutMovesOnToTheNextCommand) {
+  turnController->isSettledOverride = IsSettledOverride::neverSettled;
+  controller->enqueue(ChassisCommand::turn(90_deg, ChassisCommand::Settle::tight, 100_ms))
+    .then(ChassisCommand::move(wheelDiam * 1_pi));
+  controller->waitUntilSettled();
+
+  EXPECT_DOUBLE_EQ(distanceController->getTarget(),
+                   gearsetToTPR(controller->getGearsetRatioPair().internalGearset));
+  EXPECT_EQ(controller->getLastMoveResult(), MoveResult::settled);
+}
+
+class CCPIDStepControlScheduler : public ControlScheduler {
+  public:
+  CCPIDStepControlScheduler() : ControlScheduler(createTimeUtil()) {
+  }
+
+  using ControlScheduler::stepDueLoops;
+};
+
+TEST(ChassisControllerPIDScheduledTest, StepsFromTheSchedulerInsteadOfATask) {
+  auto scheduler = std::make_shared<CCPIDStepControlScheduler>();
+  auto model = std::make_shared<MockSkidSteerModel>();
+  model->setMaxVelocity(100);
+  {
+    ChassisControllerPID drive(createTimeUtil(),
+                               model,
+                               std::make_unique<MockIterativeController>(0.1),
+                               std::make_unique<MockIterativeController>(0.1),
+                               std::make_unique<MockIterativeController>(0.1),
+                               AbstractMotor::gearset::green,
+                               ChassisScales({4_in, 8_in}, imev5GreenTPR));
+    drive.startScheduled(scheduler);
+    drive.startThread();
+    EXPECT_EQ(drive.getThread(), nullptr);
+    EXPECT_EQ(scheduler->getLoopCount(), 1u);
+
+    drive.moveRawAsync(100);
+    EXPECT_EQ(scheduler->stepDueLoops(0_ms), 10_ms);
+
+    // The controllers only update once their sample time has passed since their first step
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    EXPECT_EQ(scheduler->stepDueLoops(10_ms), 20_ms);
+    EXPECT_GT(model->leftMtr->lastVelocity, 0);
+    EXPECT_GT(model->rightMtr->lastVelocity, 0);
+  }
+  EXPECT_EQ(scheduler->getLoopCount(), 0u);
+}
+
+TEST_F(ChassisControllerPIDTest, StrafingNeedsAnHDriveModel) {
+  EXPECT_THROW(controller->setStrafeController(std::make_unique<MockIterativeController>(0.1)),
+               std::invalid_argument);
+  EXPECT_FALSE(controller->hasStrafeController());
+  EXPECT_THROW(controller->strafeDistanceAsync(1_in), std::runtime_error);
+
+  // Moving forward doesn't need a strafe controller
+  controller->moveVector(wheelDiam * 1_pi, 0_m);
+  EXPECT_DOUBLE_EQ(distanceController->getTarget(),
+                   gearsetToTPR(controller->getGearsetRatioPair().internalGearset));
+}
+
+TEST_F(ChassisControllerPIDTest, SetAntiWindupSetsEveryController) {
+  controller->setAntiWindup(IterativePosPIDController::antiWindup::backCalculation, 0.5);
+  EXPECT_EQ(distanceController->getAntiWindup(),
+            IterativePosPIDController::antiWindup::backCalculation);
+  EXPECT_EQ(turnController->getAntiWindup(),
+            IterativePosPIDController::antiWindup::backCalculation);
+  EXPECT_EQ(angleController->getAntiWindup(),
+            IterativePosPIDController::antiWindup::backCalculation);
+}
+
+class ChassisControllerPIDStrafeTest : public ::testing::Test {
+  protected:
+  void SetUp() override {
+    model = std::make_shared<HDriveModel>(leftMotor,
+                                          rightMotor,
+                                          middleMotor,
+                                          leftMotor->getEncoder(),
+                                          rightMotor->getEncoder(),
+                                          middleMotor->getEncoder(),
+                                          100,
+                                          v5MotorMaxVoltage);
+
+    auto distance = std::make_unique<MockIterativeController>(0.1);
+    auto turn = std::make_unique<MockIterativeController>(0.1);
+    auto angle = std::make_unique<MockIterativeController>(0.1);
+    auto strafe = std::make_unique<MockIterativeController>(0.1);
+    distanceController = distance.get();
+    strafeController = strafe.get();
+    distance->isSettledOverride = IsSettledOverride::alwaysSettled;
+    turn->isSettledOverride = IsSettledOverride::alwaysSettled;
+    angle->isSettledOverride = IsSettledOverride::alwaysSettled;
+
+    controller = std::make_unique<ChassisControllerPID>(
+      createTimeUtil(),
+      model,
+      std::move(distance),
+      std::move(turn),
+      std::move(angle),
+      AbstractMotor::gearset::green,
+      ChassisScales({4_in, 8_in, 0_in, 2_in}, imev5GreenTPR));
+    controller->setStrafeController(std::move(strafe));
+    controller->startScheduled(scheduler);
+  }
+
+  std::shared_ptr<CCPIDStepControlScheduler> scheduler =
+    std::make_shared<CCPIDStepControlScheduler>();
+  std::shared_ptr<MockMotor> leftMotor = std::make_shared<MockMotor>();
+  std::shared_ptr<MockMotor> rightMotor = std::make_shared<MockMotor>();
+  std::shared_ptr<MockMotor> middleMotor = std::make_shared<MockMotor>();
+  std::shared_ptr<HDriveModel> model;
+  MockIterativeController *distanceController;
+  MockIterativeController *strafeController;
+  std::unique_ptr<ChassisControllerPID> controller;
+};
+
+TEST_F(ChassisControllerPIDStrafeTest, StrafeDistanceTargetsTheMiddleWheel) {
+  EXPECT_TRUE(controller->hasStrafeController());
+  EXPECT_TRUE(strafeController->isDisabled());
+
+  controller->strafeDistanceAsync(-2_in * 1_pi);
+  EXPECT_DOUBLE_EQ(strafeController->getTarget(), -imev5GreenTPR);
+  EXPECT_DOUBLE_EQ(distanceController->getTarget(), 0);
+  EXPECT_FALSE(strafeController->isDisabled());
+}
+
+TEST_F(ChassisControllerPIDStrafeTest, MoveVectorDrivesForwardAndSideways) {
+  controller->moveVectorAsync(4_in * 1_pi, 2_in * 1_pi);
+  EXPECT_DOUBLE_EQ(distanceController->getTarget(), imev5GreenTPR);
+  EXPECT_DOUBLE_EQ(strafeController->getTarget(), imev5GreenTPR);
+
+  scheduler->stepDueLoops(0_ms);
+  // The controllers only update once their sample time has passed since their first step
+  std::this_thread::sleep_for(std::chrono::milliseconds(20));
+  scheduler->stepDueLoops(10_ms);
+  EXPECT_GT(leftMotor->lastVelocity, 0);
+  EXPECT_GT(rightMotor->lastVelocity, 0);
+  EXPECT_GT(middleMotor->lastVelocity, 0);
+
+  // The move isn't settled until the middle wheel is
+  EXPECT_FALSE(controller->isSettled());
+  strafeController->isSettledOverride = IsSettledOverride::alwaysSettled;
+  EXPECT_TRUE(controller->isSettled());
+}
+
+TEST_F(ChassisControllerPIDStrafeTest, MovingWithoutStrafingLeavesTheMiddleWheelStopped) {
+  controller->moveDistanceAsync(4_in * 1_pi);
+  EXPECT_TRUE(strafeController->isDisabled());
+
+  scheduler->stepDueLoops(0_ms);
+  std::this_thread::sleep_for(std::chrono::milliseconds(20));
+  scheduler->stepDueLoops(10_ms);
+  EXPECT_GT(leftMotor->lastVelocity, 0);
+  EXPECT_EQ(middleMotor->lastVelocity, 0);
+  EXPECT_TRUE(controller->isSettled());
+}
+
+TEST(ChassisControllerPIDLazyTest, LazyThreadStartsOnTheFirstMovement) {
+  auto distance = std::make_unique<MockIterativeController>(0.1);
+  distance->isSettledOverride = IsSettledOverride::alwaysSettled;
+  auto angle = std::make_unique<MockIterativeController>(0.1);
+  angle->isSettledOverride = IsSettledOverride::alwaysSettled;
+  ChassisControllerPID drive(createTimeUtil(),
+                             std::make_shared<MockSkidSteerModel>(),
+                             std::move(distance),
+                             std::make_unique<MockIterativeController>(0.1),
+                             std::move(angle),
+                             AbstractMotor::gearset::green,
+                             ChassisScales({4_in, 8_in}, imev5GreenTPR));
+  drive.startThreadLazily();
+  EXPECT_EQ(drive.getThread(), nullptr);
+
+  drive.moveRaw(100);
+  EXPECT_NE(drive.getThread(), nullptr);
+}
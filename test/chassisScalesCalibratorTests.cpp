@@ -0,0 +1,171 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#include "okapi/api/chassis/controller/chassisScalesCalibrator.hpp"
+#include "test/tests/api/implMocks.hpp"
+#include <gtest/gtest.h>
+
+using namespace okapi;
+
+class ChassisScalesCalibratorTest : public ::testing::Test {
+  protected:
+  /**
+   * A robot which drives at a fixed speed and stops at once.
+   */
+  class SimulatedModel : public MockChassisModel {
+    public:
+    void forward(double ispeed) override {
+      forwardSpeed = ispeed;
+      turnSpeed = 0;
+    }
+
+    void rotate(double ispeed) override {
+      forwardSpeed = 0;
+      turnSpeed = ispeed;
+    }
+
+    void stop() override {
+      forwardSpeed = 0;
+      turnSpeed = 0;
+    }
+
+    std::valarray<std::int32_t> getSensorVals() const override {
+      const double ticksPerMeter = 360 / (1_pi * wheelDiameter).convert(meter);
+      const double middleTicksPerMeter = 360 / (1_pi * middleWheelDiameter).convert(meter);
+      return {static_cast<std::int32_t>(std::lround(left * ticksPerMeter)),
+              static_cast<std::int32_t>(std::lround(right * ticksPerMeter)),
+              static_cast<std::int32_t>(std::lround(middle * middleTicksPerMeter))};
+    }
+
+    void advance(const QTime &idt) {
+      const double dt = idt.convert(second);
+      const double turn = turnSpeed * 10 * dt;
+      const double halfTrack = wheelTrack.convert(meter) / 2;
+      left += forwardSpeed * dt + turn * halfTrack;
+      right += forwardSpeed * dt - turn * halfTrack;
+      middle -= turn * middleWheelDistance.convert(meter);
+      driven += forwardSpeed * dt;
+      heading += turn * radian.convert(degree);
+    }
+
+    QLength wheelDiameter = 3.9_in;
+    QLength wheelTrack = 11_in;
+    QLength middleWheelDistance = 3_in;
+    QLength middleWheelDiameter = 4_in;
+    double forwardSpeed{0};
+    double turnSpeed{0};
+    double left{0};
+    double right{0};
+    double middle{0};
+    double driven{0};
+    double heading{0};
+  };
+
+  class SimulatedRate : public AbstractRate {
+    public:
+    SimulatedRate(SimulatedModel &imodel, QTime &inow) : model(imodel), now(inow) {
+    }
+
+    void delay(QFrequency ihz) override {
+      delayUntil(1 / ihz);
+    }
+
+    void delayUntil(QTime itime) override {
+      model.advance(itime);
+      now += itime;
+    }
+
+    void delayUntil(uint32_t ims) override {
+      delayUntil(ims * millisecond);
+    }
+
+    void reset() override {
+    }
+
+    SimulatedModel &model;
+    QTime &now;
+  };
+
+  class SimulatedHeading : public ContinuousRotarySensor {
+    public:
+    explicit SimulatedHeading(SimulatedModel &imodel) : model(imodel) {
+    }
+
+    double get() const override {
+      return model.heading;
+    }
+
+    std::int32_t reset() override {
+      return 0;
+    }
+
+    double controllerGet() override {
+      return get();
+    }
+
+    SimulatedModel &model;
+  };
+
+  class SettableTimer : public AbstractTimer {
+    public:
+    explicit SettableTimer(const QTime &inow) : AbstractTimer(inow), now(inow) {
+    }
+
+    QTime millis() const override {
+      return now;
+    }
+
+    const QTime &now;
+  };
+
+  void SetUp() override {
+    model = std::make_shared<SimulatedModel>();
+    calibrator = std::make_unique<ChassisScalesCalibrator>(
+      model,
+      ChassisScales({4_in, 10_in, 2_in, 4_in}, 360),
+      TimeUtil(Supplier<std::unique_ptr<AbstractTimer>>(
+                 [this]() { return std::make_unique<SettableTimer>(now); }),
+               Supplier<std::unique_ptr<AbstractRate>>(
+                 [this]() { return std::make_unique<SimulatedRate>(*model, now); }),
+               Supplier<std::unique_ptr<SettledUtil>>([]() { return createSettledUtilPtr(); })));
+  }
+
+  QLength distanceToWall() const {
+    return 2_m - model->driven * meter;
+  }
+
+  // Timers ignore a mark at zero
+  QTime now{1_ms};
+  std::shared_ptr<SimulatedModel> model;
+  std::unique_ptr<ChassisScalesCalibrator> calibrator;
+};
+
+TEST_F(ChassisScalesCalibratorTest, MeasuresTheScalesOfTheRobot) {
+  ASSERT_TRUE(calibrator->measureStraight([this] { return distanceToWall(); }));
+  EXPECT_GE(model->driven * meter, 48_in);
+  EXPECT_EQ(model->forwardSpeed, 0);
+
+  ASSERT_TRUE(calibrator->measureTurn(std::make_shared<SimulatedHeading>(*model)));
+  EXPECT_GE(model->heading, 5 * 360);
+  EXPECT_EQ(model->turnSpeed, 0);
+
+  const ChassisScales scales = calibrator->getScales();
+  EXPECT_NEAR(scales.wheelDiameter.convert(inch), 3.9, 0.01);
+  EXPECT_NEAR(scales.wheelTrack.convert(inch), 11, 0.01);
+  EXPECT_NEAR(scales.middleWheelDistance.convert(inch), 3, 0.01);
+  EXPECT_NEAR(scales.middleWheelDiameter.convert(inch), 4, 1e-9);
+  EXPECT_EQ(scales.tpr, 360);
+}
+
+TEST_F(ChassisScalesCalibratorTest, KeepsTheScalesIfAManeuverTimesOut) {
+  // The wall never gets closer
+  EXPECT_FALSE(calibrator->measureStraight([] { return 1_m; }, 48_in, 0.3, 1_s));
+  EXPECT_EQ(model->forwardSpeed, 0);
+
+  const ChassisScales scales = calibrator->getScales();
+  EXPECT_NEAR(scales.wheelDiameter.convert(inch), 4, 1e-9);
+  EXPECT_NEAR(scales.wheelTrack.convert(inch), 10, 1e-9);
+  EXPECT_NEAR(scales.middleWheelDistance.convert(inch), 2, 1e-9);
+}
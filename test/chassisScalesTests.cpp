@@ -61,3 +61,18 @@ TEST_F(ChassisScalesTest, TestMiddleWheelScaleWithLength) {
   EXPECT_FLOAT_EQ(scales.middleWheelDistance.convert(inch), 1);
   EXPECT_FLOAT_EQ(scales.middle, scales.straight / 2.0);
 }
+
+TEST_F(ChassisScalesTest, DerivedScales) {
+  ChassisScales scales({4_in, 11.5_in, 2_in, 5_in}, 360);
+  EXPECT_DOUBLE_EQ(scales.metersPerTick, 1 / scales.straight);
+  EXPECT_DOUBLE_EQ(scales.middleMetersPerTick, 1 / scales.middle);
+  EXPECT_DOUBLE_EQ(scales.inverseWheelTrack, 1 / (11.5_in).convert(meter));
+
+  // One meter per second turns a four inch wheel at 60 / (pi * 4 inches) rpm
+  EXPECT_NEAR(scales.wheelRpmPerMps, 187.9783, 1e-4);
+  EXPECT_NEAR(scales.getMotorRpmPerMps({AbstractMotor::gearset::green, 2}), 375.9566, 1e-4);
+
+  scales.wheelTrack = 10_in;
+  scales.computeDerivedScales();
+  EXPECT_DOUBLE_EQ(scales.inverseWheelTrack, 1 / (10_in).convert(meter));
+}
@@ -3,8 +3,25 @@
  * License, v. 2.0. If a copy of the MPL was not distributed with this
  * file, You can obtain one at http://mozilla.org/MPL/2.0/.
  */
+#include "okapi/api/control/util/batchFlywheelSimulator.hpp"
+#include "okapi/api/control/util/controlScheduler.hpp"
 #include "okapi/api/control/util/flywheelSimulator.hpp"
+#include "okapi/api/control/util/incrementalPathGenerator.hpp"
+#include "okapi/api/control/util/loopTimingRecorder.hpp"
+#include "okapi/api/control/util/pathAnalyzer.hpp"
+#include "okapi/api/control/util/pathStreamReader.hpp"
+#include "okapi/api/control/util/profileGenerator.hpp"
+#include "okapi/api/control/util/profileResampler.hpp"
+#include "okapi/api/control/util/profileRetimer.hpp"
+#include "okapi/api/control/util/stepProfiler.hpp"
+#include "test/tests/api/implMocks.hpp"
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstring>
 #include <gtest/gtest.h>
+#include <memory>
+#include <thread>
 
 using namespace okapi;
 
@@ -18,3 +35,828 @@ TEST(FlywheelSimulatorTest, BasicTest) {
   EXPECT_NEAR(sim.getOmega(), 0.0020193, 0.000005);
   EXPECT_NEAR(sim.getAcceleration(), 20.193, 0.0005);
 }
+
+TEST(FlywheelSimulatorTest, IntegratorsUnderConstantTorque) {
+  // With no gravity or friction the angle is a parabola, which RK4 follows exactly
+  auto run = [](FlywheelSimulator::Integrator iintegrator) {
+    FlywheelSimulator sim(1, 1, 0, 0, 0.1, iintegrator);
+    sim.setExternalTorqueFunction([](double, double, double) { return 0; });
+    sim.setTorque(0.2);
+    for (std::size_t i = 0; i < 20; i++) {
+      sim.step();
+    }
+    return sim.getAngle();
+  };
+
+  EXPECT_NEAR(run(FlywheelSimulator::Integrator::rk4), 0.4, 1e-9);
+  EXPECT_NEAR(run(FlywheelSimulator::Integrator::semiImplicitEuler), 0.42, 1e-9);
+}
+
+TEST(FlywheelSimulatorTest, IntegratorsOnASpring) {
+  // A spring about the top gives simple harmonic motion at 2 rad/s
+  auto error = [](FlywheelSimulator::Integrator iintegrator, double itimestep) {
+    FlywheelSimulator sim(1, 1, 0, 0, itimestep, iintegrator);
+    sim.setExternalTorqueFunction(
+      [](double iangle, double, double) { return -4 * (iangle - pi / 2); });
+    sim.setAngle(pi / 2 + 0.5);
+    const auto steps = static_cast<std::size_t>(std::lround(2 / itimestep));
+    for (std::size_t i = 0; i < steps; i++) {
+      sim.step();
+    }
+    return std::fabs(sim.getAngle() - (pi / 2 + 0.5 * std::cos(4)));
+  };
+
+  const double rk4Error = error(FlywheelSimulator::Integrator::rk4, 0.05);
+  const double semiImplicitError = error(FlywheelSimulator::Integrator::semiImplicitEuler, 0.05);
+  EXPECT_LT(rk4Error, 1e-4);
+  EXPECT_GT(semiImplicitError, 100 * rk4Error);
+
+  // A timestep 50x larger is still more accurate than semi-implicit Euler at the small one
+  EXPECT_LT(rk4Error, error(FlywheelSimulator::Integrator::semiImplicitEuler, 0.001));
+}
+
+TEST(BatchFlywheelSimulatorTest, MatchesFlywheelSimulator) {
+  BatchFlywheelSimulator<> batch;
+  std::vector<std::unique_ptr<FlywheelSimulator>> sims;
+  for (int i = 0; i < 8; i++) {
+    const double mass = 0.005 + 0.001 * i;
+    const double muDynamic = 0.1 * i;
+    batch.add(mass, 1, 0.1, muDynamic);
+    sims.push_back(std::make_unique<FlywheelSimulator>(mass, 1, 0.1, muDynamic));
+  }
+  ASSERT_EQ(batch.size(), 8u);
+
+  for (int step = 0; step < 500; step++) {
+    for (std::size_t i = 0; i < sims.size(); i++) {
+      // Swing back and forth so the friction and end stops all come into play
+      const double torque = (step / 100) % 2 == 0 ? 0.3 + 0.05 * i : -0.5;
+      batch.setTorque(i, torque);
+      sims.at(i)->setTorque(torque);
+      sims.at(i)->step();
+    }
+    batch.step();
+
+    for (std::size_t i = 0; i < sims.size(); i++) {
+      ASSERT_DOUBLE_EQ(batch.getAngle(i), sims.at(i)->getAngle()) << "step " << step;
+      ASSERT_DOUBLE_EQ(batch.getOmega(i), sims.at(i)->getOmega()) << "step " << step;
+      ASSERT_DOUBLE_EQ(batch.getAcceleration(i), sims.at(i)->getAcceleration());
+    }
+  }
+}
+
+TEST(BatchFlywheelSimulatorTest, TakesAFunctionPointerTorqueModel) {
+  BatchFlywheelSimulator<double (*)(double, double, double)> batch(
+    0.01, [](double, double, double) { return 0.0; });
+  batch.add();
+  batch.setTorque(0, 0.3);
+  batch.step();
+
+  // Without gravity, only the input torque moves the flywheel
+  EXPECT_NEAR(batch.getAcceleration(0), 0.3 / 0.01, 1e-9);
+  EXPECT_EQ(batch.getAngles().size(), 1u);
+}
+
+TEST(BatchFlywheelSimulatorTest, BoundsTheInputTorque) {
+  BatchFlywheelSimulator<> batch;
+  batch.add(0.01, 1, 0, 0.9);
+  batch.setMaxTorque(0, 0.1);
+  batch.setTorque(0, -1);
+  batch.setAngle(0, pi / 2);
+  batch.step();
+
+  const double gravityTorque = FlywheelGravityTorque()(pi / 2, 0.01, 1);
+  EXPECT_NEAR(batch.getAcceleration(0), (-0.1 + gravityTorque) / 0.01, 1e-6);
+}
+
+static std::vector<squiggles::ProfilePoint> makeRampProfile(const std::size_t icount) {
+  // The velocity ramps up linearly and the curvature jumps halfway through
+  std::vector<squiggles::ProfilePoint> path;
+  for (std::size_t i = 0; i < icount; ++i) {
+    const double vel = 0.1 * i;
+    path.emplace_back(squiggles::ControlVector(squiggles::Pose(i, 0, 0), vel, 0, 0),
+                      std::vector<double>{vel, 2 * vel},
+                      i < icount / 2 ? 0 : 1,
+                      0.01 * i);
+  }
+  return path;
+}
+
+TEST(ProfileResamplerTest, DecimateKeepsEveryNthPointAndTheEnds) {
+  const auto path = makeRampProfile(10);
+  const auto decimated = ProfileResampler::decimate(path, 4);
+
+  ASSERT_EQ(decimated.size(), 4u);
+  EXPECT_EQ(decimated[0].time, path[0].time);
+  EXPECT_EQ(decimated[1].time, path[4].time);
+  EXPECT_EQ(decimated[2].time, path[8].time);
+  EXPECT_EQ(decimated[3].time, path[9].time);
+}
+
+TEST(ProfileResamplerTest, DecimateKeepsCurvatureChanges) {
+  const auto path = makeRampProfile(10);
+  const auto decimated = ProfileResampler::decimate(path, 4, 0.5);
+
+  // The stride restarts from the point kept for its curvature
+  ASSERT_EQ(decimated.size(), 4u);
+  EXPECT_EQ(decimated[1].time, path[4].time);
+  EXPECT_EQ(decimated[2].time, path[5].time);
+  EXPECT_EQ(decimated[3].time, path[9].time);
+}
+
+TEST(ProfileResamplerTest, DecimateWithStrideOneKeepsEveryPoint) {
+  EXPECT_EQ(ProfileResampler::decimate(makeRampProfile(10), 1).size(), 10u);
+}
+
+TEST(ProfileResamplerTest, HasIncreasingTimes) {
+  auto path = makeRampProfile(5);
+  EXPECT_TRUE(ProfileResampler::hasIncreasingTimes(path));
+
+  path[3].time = path[2].time;
+  EXPECT_FALSE(ProfileResampler::hasIncreasingTimes(path));
+
+  EXPECT_FALSE(ProfileResampler::hasIncreasingTimes({}));
+}
+
+TEST(ProfileResamplerTest, SampleAtAPointReturnsThatPoint) {
+  const auto path = makeRampProfile(10);
+  std::size_t segment = 0;
+  const auto point =
+    ProfileResampler::sample(path, path[6].time, segment, ProfileInterpolation::linear);
+
+  EXPECT_EQ(segment, 6u);
+  EXPECT_EQ(point.wheel_velocities, path[6].wheel_velocities);
+  EXPECT_EQ(point.vector.pose.x, path[6].vector.pose.x);
+}
+
+TEST(ProfileResamplerTest, SampleInterpolatesDecimatedProfile) {
+  const auto path = makeRampProfile(20);
+  const auto decimated = ProfileResampler::decimate(path, 4);
+
+  for (const auto interpolation : {ProfileInterpolation::linear, ProfileInterpolation::cubic}) {
+    std::size_t segment = 0;
+    for (const auto &expected : path) {
+      const auto point = ProfileResampler::sample(decimated, expected.time, segment, interpolation);
+      EXPECT_NEAR(point.wheel_velocities[0], expected.wheel_velocities[0], 1e-9);
+      EXPECT_NEAR(point.wheel_velocities[1], expected.wheel_velocities[1], 1e-9);
+      EXPECT_NEAR(point.vector.pose.x, expected.vector.pose.x, 1e-9);
+    }
+  }
+}
+
+TEST(ProfileResamplerTest, SampleClampsToTheEnds) {
+  const auto path = makeRampProfile(10);
+  std::size_t segment = 0;
+
+  EXPECT_EQ(ProfileResampler::sample(path, -1, segment, ProfileInterpolation::linear).time,
+            path.front().time);
+  EXPECT_EQ(ProfileResampler::sample(path, 10, segment, ProfileInterpolation::cubic).time,
+            path.back().time);
+}
+
+static std::vector<squiggles::ProfilePoint> makeSlowLineProfile(const double icurvature) {
+  // Two meters along x at 0.5 m/s with a point every centimeter, starting and ending at rest
+  std::vector<squiggles::ProfilePoint> path;
+  for (std::size_t i = 0; i <= 200; ++i) {
+    const double vel = i == 0 || i == 200 ? 0 : 0.5;
+    path.emplace_back(squiggles::ControlVector(squiggles::Pose(0.01 * i, 0, 0), vel, 0, 0),
+                      std::vector<double>{vel, vel},
+                      icurvature,
+                      0.02 * i);
+  }
+  return path;
+}
+
+static ProfileRetimer makeRetimer(const double ivoltageFraction = 1) {
+  return ProfileRetimer(
+    AbstractMotor::gearset::green, {{4_in, 10_in}, imev5GreenTPR}, 7_kg, 2, ivoltageFraction);
+}
+
+TEST(ProfileRetimerTest, InvalidParametersThrow) {
+  const ChassisScales scales{{4_in, 10_in}, imev5GreenTPR};
+  const auto green = AbstractMotor::gearset::green;
+  EXPECT_THROW(ProfileRetimer(AbstractMotor::gearset::invalid, scales, 7_kg),
+               std::invalid_argument);
+  EXPECT_THROW(ProfileRetimer(green * 0, scales, 7_kg), std::invalid_argument);
+  EXPECT_THROW(ProfileRetimer(green, scales, 0_kg), std::invalid_argument);
+  EXPECT_THROW(ProfileRetimer(green, scales, 7_kg, 0), std::invalid_argument);
+  EXPECT_THROW(ProfileRetimer(green, scales, 7_kg, 2, 0), std::invalid_argument);
+  EXPECT_THROW(ProfileRetimer(green, scales, 7_kg, 2, 1.1), std::invalid_argument);
+}
+
+TEST(ProfileRetimerTest, MaxVelocityIsTheFreeSpeedOfTheOuterWheel) {
+  const double freeSpeed = 200.0 / 60 * pi * (4_in).convert(meter);
+  EXPECT_NEAR(makeRetimer().getMaxVelocity(0), freeSpeed, 1e-12);
+  EXPECT_NEAR(makeRetimer(0.5).getMaxVelocity(0), freeSpeed / 2, 1e-12);
+
+  // On a curve of 2/m, the outer wheel goes 1 + 2 * 5 in faster than the center
+  const double outer = 1 + 2 * (5_in).convert(meter);
+  EXPECT_NEAR(makeRetimer().getMaxVelocity(2), freeSpeed / outer, 1e-12);
+  EXPECT_NEAR(makeRetimer().getMaxVelocity(-2), freeSpeed / outer, 1e-12);
+
+  // Gearing the wheels up makes them faster
+  const ProfileRetimer geared(AbstractMotor::gearset::green * (1.0 / 2),
+                              {{4_in, 10_in}, imev5GreenTPR},
+                              7_kg);
+  EXPECT_NEAR(geared.getMaxVelocity(0), 2 * 0.9 * freeSpeed, 1e-12);
+}
+
+TEST(ProfileRetimerTest, AccelerationFallsWithSpeed) {
+  const auto retimer = makeRetimer();
+  // Two motors of 1.05 N*m on 2 in wheels push half of 7 kg
+  const double stallAccel = 2 * 1.05 / (2_in).convert(meter) / 3.5;
+  const double maxVel = retimer.getMaxVelocity(0);
+  EXPECT_NEAR(retimer.getMaxAcceleration(0, 0), stallAccel, 1e-9);
+  EXPECT_NEAR(retimer.getMaxAcceleration(maxVel / 2, 0), stallAccel / 2, 1e-9);
+  EXPECT_NEAR(retimer.getMaxAcceleration(maxVel, 0), 0, 1e-9);
+  EXPECT_NEAR(retimer.getMaxDeceleration(0), stallAccel, 1e-9);
+  EXPECT_LT(retimer.getMaxAcceleration(0, 2), stallAccel);
+}
+
+TEST(ProfileRetimerTest, RetimedProfileIsFasterWithinWhatTheMotorsCanDo) {
+  const auto retimer = makeRetimer();
+  const auto path = makeSlowLineProfile(0);
+  const auto retimed = retimer.retime(path);
+
+  ASSERT_EQ(retimed.size(), path.size());
+  EXPECT_TRUE(ProfileResampler::hasIncreasingTimes(retimed));
+  EXPECT_EQ(retimed.front().time, path.front().time);
+  EXPECT_LT(retimed.back().time, 0.6 * path.back().time);
+  EXPECT_EQ(retimed.front().vector.vel, 0);
+  EXPECT_EQ(retimed.back().vector.vel, 0);
+
+  double fastest = 0;
+  for (std::size_t i = 0; i + 1 < retimed.size(); ++i) {
+    const double vel = retimed[i].vector.vel;
+    const double accel = retimed[i].vector.accel;
+    fastest = std::max(fastest, vel);
+    EXPECT_LE(vel, retimer.getMaxVelocity(0) + 1e-12);
+    EXPECT_LE(accel, retimer.getMaxAcceleration(vel, 0) + 1e-9);
+    EXPECT_GE(accel, -retimer.getMaxDeceleration(0) - 1e-9);
+    EXPECT_EQ(retimed[i].wheel_velocities, (std::vector<double>{vel, vel}));
+    EXPECT_EQ(retimed[i].vector.pose, path[i].vector.pose);
+  }
+
+  // Two meters is long enough to get close to the free speed
+  EXPECT_GT(fastest, 0.95 * retimer.getMaxVelocity(0));
+}
+
+TEST(ProfileRetimerTest, CurvesAreSlower) {
+  const auto retimer = makeRetimer();
+  const auto retimed = retimer.retime(makeSlowLineProfile(2));
+
+  const double halfTrack = (5_in).convert(meter);
+  for (const auto &point : retimed) {
+    const double vel = point.vector.vel;
+    EXPECT_LE(vel, retimer.getMaxVelocity(2) + 1e-12);
+    EXPECT_NEAR(point.wheel_velocities[0], vel * (1 - 2 * halfTrack), 1e-12);
+    EXPECT_NEAR(point.wheel_velocities[1], vel * (1 + 2 * halfTrack), 1e-12);
+  }
+}
+
+TEST(ProfileRetimerTest, KeepsTheStartAndEndVelocities) {
+  auto path = makeSlowLineProfile(0);
+  path.front().vector.vel = 0.3;
+  path.back().vector.vel = 0.4;
+  const auto retimed = makeRetimer().retime(path);
+  EXPECT_EQ(retimed.front().vector.vel, 0.3);
+  EXPECT_EQ(retimed.back().vector.vel, 0.4);
+
+  // Faster than the motors can go is clamped
+  path.front().vector.vel = 5;
+  EXPECT_EQ(makeRetimer().retime(path).front().vector.vel, makeRetimer().getMaxVelocity(0));
+}
+
+TEST(ProfileRetimerTest, PointsInTheSamePlaceAreDropped) {
+  auto path = makeSlowLineProfile(0);
+  path.insert(path.begin() + 10, path[10]);
+  const auto retimed = makeRetimer().retime(path);
+  EXPECT_EQ(retimed.size(), path.size() - 1);
+  EXPECT_TRUE(ProfileResampler::hasIncreasingTimes(retimed));
+
+  EXPECT_EQ(makeRetimer().retime({path.front(), path.front()}).size(), 1u);
+  EXPECT_TRUE(makeRetimer().retime({}).empty());
+}
+
+static std::vector<squiggles::ProfilePoint> makeLineWithCurveProfile() {
+  // Two meters along x at 1 m/s with a sharp curve of 4/m in the middle
+  auto path = makeSlowLineProfile(0);
+  for (std::size_t i = 1; i < 200; ++i) {
+    path[i].vector.vel = 1;
+    path[i].wheel_velocities = {1, 1};
+    path[i].curvature = i >= 90 && i <= 110 ? 4 : 0;
+    path[i].time = 0.01 * i;
+  }
+  path.back().time = 2;
+  return path;
+}
+
+TEST(ProfileRetimerTest, CentripetalLimitSlowsOnlyTheCurve) {
+  const auto path = makeLineWithCurveProfile();
+  const double halfTrack = (5_in).convert(meter);
+  const auto limited = ProfileRetimer::limitCentripetalAcceleration(path, halfTrack, 1, 2);
+
+  ASSERT_EQ(limited.size(), path.size());
+  EXPECT_TRUE(ProfileResampler::hasIncreasingTimes(limited));
+  EXPECT_GT(limited.back().time, path.back().time);
+
+  for (std::size_t i = 0; i < limited.size(); ++i) {
+    const auto &point = limited[i];
+    const double vel = point.vector.vel;
+    EXPECT_LE(vel, path[i].vector.vel);
+    EXPECT_LE(vel * vel * std::abs(point.curvature), 1 + 1e-9);
+    EXPECT_GE(point.vector.accel, -2 - 1e-9);
+    EXPECT_LE(point.vector.accel, 2 + 1e-9);
+    EXPECT_NEAR(point.wheel_velocities[0], vel * (1 - point.curvature * halfTrack), 1e-12);
+  }
+
+  // The curve is entered at the limit, and the straight sections away from it keep their speed
+  EXPECT_NEAR(limited[100].vector.vel, 0.5, 1e-12);
+  EXPECT_EQ(limited[60].vector.vel, 1);
+  EXPECT_EQ(limited[140].vector.vel, 1);
+}
+
+TEST(ProfileRetimerTest, CentripetalLimitKeepsProfilesWithinIt) {
+  const auto path = makeLineWithCurveProfile();
+  const auto limited = ProfileRetimer::limitCentripetalAcceleration(path, 0.1, 4, 2);
+  ASSERT_EQ(limited.size(), path.size());
+  for (std::size_t i = 0; i < limited.size(); ++i) {
+    EXPECT_EQ(limited[i].time, path[i].time);
+    EXPECT_EQ(limited[i].vector.vel, path[i].vector.vel);
+  }
+
+  EXPECT_TRUE(ProfileRetimer::limitCentripetalAcceleration({}, 0.1, 1, 2).empty());
+}
+
+static std::vector<PathfinderPoint> makeIncrementalWaypoints() {
+  return {{0_m, 0_m, 0_deg}, {1_m, 0_m, 0_deg}, {2_m, 0_m, 0_deg}, {3_m, 0_m, 0_deg}};
+}
+
+TEST(IncrementalPathGeneratorTest, InvalidParametersThrow) {
+  EXPECT_THROW(IncrementalPathGenerator({0, 2, 10}, 10_in), std::invalid_argument);
+  EXPECT_THROW(IncrementalPathGenerator({1, 0, 10}, 10_in), std::invalid_argument);
+
+  IncrementalPathGenerator generator({1, 2, 10}, 10_in);
+  generator.generate(makeIncrementalWaypoints());
+  EXPECT_THROW(generator.generate({{0_m, 0_m, 0_deg}}), std::invalid_argument);
+  EXPECT_THROW(generator.generate(makeIncrementalWaypoints(), -1_mps), std::invalid_argument);
+  EXPECT_THROW(generator.generate(makeIncrementalWaypoints(), 0_mps, 2_mps),
+               std::invalid_argument);
+
+  // Throwing keeps the segments
+  generator.generate(makeIncrementalWaypoints());
+  EXPECT_EQ(generator.getGeneratedSegmentCount(), 0u);
+}
+
+TEST(IncrementalPathGeneratorTest, OnlySegmentsNextToAChangedWaypointAreRegenerated) {
+  IncrementalPathGenerator generator({1, 2, 10}, 10_in);
+  auto waypoints = makeIncrementalWaypoints();
+  generator.generate(waypoints);
+  EXPECT_EQ(generator.getGeneratedSegmentCount(), 3u);
+
+  generator.generate(waypoints);
+  EXPECT_EQ(generator.getGeneratedSegmentCount(), 0u);
+
+  waypoints[1].y = 0.2_m;
+  generator.generate(waypoints);
+  EXPECT_EQ(generator.getGeneratedSegmentCount(), 2u);
+
+  waypoints[3].x = 3.5_m;
+  generator.generate(waypoints);
+  EXPECT_EQ(generator.getGeneratedSegmentCount(), 1u);
+
+  // Adding or removing a waypoint at an end keeps every other segment
+  waypoints.push_back({4_m, 0_m, 0_deg});
+  generator.generate(waypoints);
+  EXPECT_EQ(generator.getGeneratedSegmentCount(), 1u);
+
+  waypoints.erase(waypoints.begin());
+  generator.generate(waypoints);
+  EXPECT_EQ(generator.getGeneratedSegmentCount(), 0u);
+
+  generator.clear();
+  generator.generate(waypoints);
+  EXPECT_EQ(generator.getGeneratedSegmentCount(), 3u);
+}
+
+TEST(IncrementalPathGeneratorTest, JoinedProfileIsRetimedToTheLimits) {
+  IncrementalPathGenerator generator({1, 2, 10}, 10_in);
+  const auto path = generator.generate(makeIncrementalWaypoints());
+
+  ASSERT_FALSE(path.empty());
+  EXPECT_TRUE(ProfileResampler::hasIncreasingTimes(path));
+  EXPECT_EQ(path.front().time, 0);
+  EXPECT_EQ(path.front().vector.vel, 0);
+  EXPECT_EQ(path.back().vector.vel, 0);
+
+  double length = 0;
+  for (std::size_t i = 0; i < path.size(); ++i) {
+    EXPECT_LE(path[i].vector.vel, 1 + 1e-12);
+    EXPECT_LE(std::abs(path[i].vector.accel), 2 + 1e-9);
+    if (i > 0) {
+      const double distance = path[i - 1].vector.pose.dist(path[i].vector.pose);
+      EXPECT_GT(distance, 0);
+      length += distance;
+    }
+  }
+
+  // The robot does not stop at the waypoints, so it takes about as long as one trapezoid over
+  // the whole path: 3 m at 1 m/s plus half a second to speed up and slow down
+  EXPECT_NEAR(length, 3, 0.02);
+  EXPECT_NEAR(path.back().time, 3.5, 0.05);
+}
+
+TEST(IncrementalPathGeneratorTest, KeepsTheStartAndEndVelocities) {
+  IncrementalPathGenerator generator({1, 2, 10}, 10_in);
+  const auto path = generator.generate(makeIncrementalWaypoints(), 0.5_mps, 0.25_mps);
+  EXPECT_EQ(path.front().vector.vel, 0.5);
+  EXPECT_EQ(path.back().vector.vel, 0.25);
+}
+
+TEST(PathAnalyzerTest, WheelFreeSpeedFollowsTheGearing) {
+  const double green = 200.0 / 60 * pi * (4_in).convert(meter);
+  EXPECT_NEAR(PathAnalyzer::getWheelFreeSpeed(AbstractMotor::gearset::green, 4_in), green, 1e-12);
+  EXPECT_NEAR(PathAnalyzer::getWheelFreeSpeed(
+                AbstractMotor::GearsetRatioPair(AbstractMotor::gearset::blue, 2), 4_in),
+              1.5 * green,
+              1e-12);
+}
+
+TEST(PathAnalyzerTest, MeasuresTheProfile) {
+  // makeSlowLineProfile() cruises at 0.5 m/s and gets there in one 20 ms step
+  const auto path = makeSlowLineProfile(0.5);
+  const PathfinderLimits limits{1, 50, 100};
+  const auto report = PathAnalyzer::analyze(path, limits, AbstractMotor::gearset::green, 4_in);
+
+  EXPECT_EQ(report.pointCount, path.size());
+  EXPECT_NEAR(report.duration, 4, 1e-12);
+  EXPECT_NEAR(report.length, 2, 1e-9);
+  EXPECT_NEAR(report.peakVelocity, 0.5, 1e-12);
+  EXPECT_NEAR(report.peakWheelVelocity, 0.5, 1e-12);
+  EXPECT_NEAR(report.peakAcceleration, 25, 1e-9);
+  EXPECT_NEAR(report.peakCurvature, 0.5, 1e-12);
+  EXPECT_NEAR(report.velocityUsage, 0.5, 1e-12);
+  EXPECT_NEAR(report.accelerationUsage, 0.5, 1e-9);
+  EXPECT_NEAR(report.motorSpeedUsage, 0.5 / report.wheelFreeSpeed, 1e-12);
+  EXPECT_TRUE(report.isFeasible());
+}
+
+TEST(PathAnalyzerTest, PathsWhichAskForTooMuchAreNotFeasible) {
+  auto path = makeSlowLineProfile(0);
+  path[100].wheel_velocities = {0.5, 2};
+  const auto report =
+    PathAnalyzer::analyze(path, {5, 100, 100}, AbstractMotor::gearset::green, 4_in);
+
+  EXPECT_NEAR(report.peakWheelVelocity, 2, 1e-12);
+  EXPECT_GT(report.motorSpeedUsage, 1);
+  EXPECT_LT(report.velocityUsage, 1);
+  EXPECT_FALSE(report.isFeasible());
+
+  // Too fast for the limits, but not for the motors
+  const auto tooFast = PathAnalyzer::analyze(
+    makeSlowLineProfile(0), {0.4, 100, 100}, AbstractMotor::gearset::green, 4_in);
+  EXPECT_GT(tooFast.velocityUsage, 1);
+  EXPECT_FALSE(tooFast.isFeasible());
+}
+
+TEST(PathAnalyzerTest, UntimedProfilesUseTheProfileTimestep) {
+  auto path = makeSlowLineProfile(0);
+  for (auto &point : path) {
+    point.time = 0;
+  }
+
+  const auto report =
+    PathAnalyzer::analyze(path, {1, 100, 100}, AbstractMotor::gearset::green, 4_in);
+  EXPECT_NEAR(report.duration, 200 * ProfileGenerator::DT, 1e-12);
+  EXPECT_NEAR(report.peakAcceleration, 0.5 / ProfileGenerator::DT, 1e-9);
+}
+
+TEST(PathAnalyzerTest, EmptyProfileIsEmptyReport) {
+  const auto report = PathAnalyzer::analyze({}, {1, 2, 10}, AbstractMotor::gearset::green, 4_in);
+  EXPECT_EQ(report.pointCount, 0u);
+  EXPECT_EQ(report.duration, 0);
+  EXPECT_TRUE(report.isFeasible());
+}
+
+static std::unique_ptr<std::stringstream>
+makeBinaryPathStream(const std::vector<squiggles::ProfilePoint> &ipath) {
+  auto stream =
+    std::make_unique<std::stringstream>(std::ios::in | std::ios::out | std::ios::binary);
+  PathBinaryFormat::serialize(*stream, ipath);
+  return stream;
+}
+
+TEST(PathStreamReaderTest, ReadsEveryPointAcrossChunks) {
+  const auto path = makeRampProfile(25);
+  PathStreamReader reader(makeBinaryPathStream(path), createTimeUtil(), 4);
+  ASSERT_TRUE(reader.isValid());
+  EXPECT_EQ(reader.getPointCount(), 25u);
+
+  squiggles::ProfilePoint point;
+  for (const auto &expected : path) {
+    ASSERT_TRUE(reader.next(point));
+    EXPECT_NEAR(point.time, expected.time, 1e-6);
+    EXPECT_NEAR(point.vector.vel, expected.vector.vel, 1e-6);
+    ASSERT_EQ(point.wheel_velocities.size(), 2u);
+    EXPECT_NEAR(point.wheel_velocities[1], expected.wheel_velocities[1], 1e-6);
+  }
+
+  EXPECT_FALSE(reader.next(point));
+}
+
+TEST(PathStreamReaderTest, ReadsACompactPathAcrossChunks) {
+  const auto path = makeRampProfile(25);
+  auto stream =
+    std::make_unique<std::stringstream>(std::ios::in | std::ios::out | std::ios::binary);
+  ASSERT_TRUE(PathBinaryFormat::serializeCompact(*stream, path));
+  PathStreamReader reader(std::move(stream), createTimeUtil(), 4);
+  ASSERT_TRUE(reader.isValid());
+  EXPECT_EQ(reader.getPointCount(), 25u);
+
+  squiggles::ProfilePoint point;
+  for (const auto &expected : path) {
+    ASSERT_TRUE(reader.next(point));
+    EXPECT_NEAR(point.time, expected.time, 1e-9);
+    EXPECT_NEAR(point.vector.pose.x, expected.vector.pose.x, 1e-9);
+    EXPECT_NEAR(point.curvature, expected.curvature, 1e-9);
+    ASSERT_EQ(point.wheel_velocities.size(), 2u);
+    EXPECT_NEAR(point.wheel_velocities[1], expected.wheel_velocities[1], 1e-9);
+  }
+
+  EXPECT_FALSE(reader.next(point));
+}
+
+TEST(PathBinaryFormatTest, CompactPathsAreSmallAndRounded) {
+  auto path = makeRampProfile(100);
+  path[10].vector.jerk = -0.123456;
+
+  std::stringstream floatFile(std::ios::in | std::ios::out | std::ios::binary);
+  std::stringstream compactFile(std::ios::in | std::ios::out | std::ios::binary);
+  ASSERT_TRUE(PathBinaryFormat::serialize(floatFile, path));
+  ASSERT_TRUE(PathBinaryFormat::serializeCompact(compactFile, path));
+
+  // The ramp is a straight line in every field, so almost every difference is a single byte
+  EXPECT_LT(compactFile.str().size(), floatFile.str().size() / 3);
+
+  const auto loaded = PathBinaryFormat::deserialize(compactFile);
+  ASSERT_TRUE(loaded.has_value());
+  ASSERT_EQ(loaded->size(), path.size());
+  EXPECT_NEAR(loaded->at(10).vector.jerk, -0.1235, 1e-9);
+  EXPECT_EQ(loaded->at(11).vector.jerk, 0);
+}
+
+TEST(PathBinaryFormatTest, CompactRejectsValuesItCannotStore) {
+  auto path = makeRampProfile(10);
+  path[5].curvature = std::numeric_limits<double>::infinity();
+
+  std::stringstream file(std::ios::in | std::ios::out | std::ios::binary);
+  EXPECT_FALSE(PathBinaryFormat::serializeCompact(file, path));
+  EXPECT_TRUE(file.str().empty());
+}
+
+TEST(PathBinaryFormatTest, RejectsCorruptHeaders) {
+  const auto setField = [](std::string &icontents, const std::size_t ioffset, const auto ivalue) {
+    std::memcpy(&icontents[ioffset], &ivalue, sizeof(ivalue));
+  };
+  const auto load = [](const std::string &icontents) {
+    std::stringstream file(icontents, std::ios::in | std::ios::binary);
+    return PathBinaryFormat::deserialize(file);
+  };
+
+  const auto contents = makeBinaryPathStream(makeRampProfile(10))->str();
+  ASSERT_TRUE(load(contents).has_value());
+
+  // Truncated in the header and in the points
+  EXPECT_FALSE(load(contents.substr(0, PathBinaryFormat::headerSize - 1)).has_value());
+  EXPECT_FALSE(load(contents.substr(0, contents.size() - 1)).has_value());
+
+  // More points than the file holds, including a count which overflows a 32-bit size
+  auto corrupt = contents;
+  setField(corrupt, 8, std::uint32_t{11});
+  EXPECT_FALSE(load(corrupt).has_value());
+  setField(corrupt, 8, std::uint32_t{0xFFFFFFFF});
+  EXPECT_FALSE(load(corrupt).has_value());
+
+  // Too many wheels
+  corrupt = contents;
+  setField(corrupt, 6, std::uint16_t{0xFFFF});
+  EXPECT_FALSE(load(corrupt).has_value());
+  std::stringstream header(corrupt.substr(0, PathBinaryFormat::headerSize));
+  EXPECT_FALSE(PathBinaryFormat::readHeader(header).has_value());
+
+  // A compact file with too many points for its length
+  std::stringstream compactFile(std::ios::in | std::ios::out | std::ios::binary);
+  ASSERT_TRUE(PathBinaryFormat::serializeCompact(compactFile, makeRampProfile(10)));
+  auto compact = compactFile.str();
+  setField(compact, 8, std::uint32_t{0x10000000});
+  EXPECT_FALSE(load(compact).has_value());
+}
+
+TEST(PathStreamReaderTest, InvalidStreamHasNoPoints) {
+  PathStreamReader reader(std::make_unique<std::stringstream>("x,y,yaw\n1,2,3\n"),
+                          createTimeUtil());
+  EXPECT_FALSE(reader.isValid());
+  EXPECT_EQ(reader.getPointCount(), 0u);
+
+  squiggles::ProfilePoint point;
+  EXPECT_FALSE(reader.next(point));
+}
+
+TEST(PathStreamReaderTest, TruncatedStreamStopsAtTheLastWholeChunk) {
+  // Ten points of a 25 point path fit in the stream, which is two chunks of four points
+  const auto bytesPerPoint = (PathBinaryFormat::fixedFieldsPerPoint + 2) * sizeof(float);
+  const auto contents = makeBinaryPathStream(makeRampProfile(25))
+                          ->str()
+                          .substr(0, PathBinaryFormat::headerSize + 10 * bytesPerPoint);
+  PathStreamReader reader(std::make_unique<std::stringstream>(contents), createTimeUtil(), 4);
+  ASSERT_TRUE(reader.isValid());
+
+  squiggles::ProfilePoint point;
+  std::size_t count = 0;
+  while (reader.next(point)) {
+    count++;
+  }
+
+  EXPECT_EQ(count, 8u);
+}
+
+class MockControlScheduler : public ControlScheduler {
+  public:
+  MockControlScheduler() : ControlScheduler(createTimeUtil()) {
+  }
+
+  using ControlScheduler::stepDueLoops;
+};
+
+TEST(ControlSchedulerTest, StepsLoopsAtTheirPeriodsInOrder) {
+  MockControlScheduler scheduler;
+  std::vector<int> steps;
+  scheduler.addLoop([&]() { steps.push_back(1); }, []() { return 10_ms; });
+  scheduler.addLoop([&]() { steps.push_back(2); }, []() { return 20_ms; });
+
+  EXPECT_EQ(scheduler.stepDueLoops(0_ms).convert(millisecond), 10);
+  EXPECT_EQ(scheduler.stepDueLoops(10_ms).convert(millisecond), 20);
+  EXPECT_EQ(scheduler.stepDueLoops(15_ms).convert(millisecond), 20);
+  EXPECT_EQ(scheduler.stepDueLoops(20_ms).convert(millisecond), 30);
+
+  EXPECT_EQ(steps, std::vector<int>({1, 2, 1, 1, 2}));
+  EXPECT_EQ(scheduler.getOverrunCount(), 0u);
+}
+
+TEST(ControlSchedulerTest, LoopsDueTogetherAreSteppedInPhaseOrder) {
+  MockControlScheduler scheduler;
+  std::vector<int> steps;
+  scheduler.addLoop([&]() { steps.push_back(3); }, []() { return 10_ms; });
+  scheduler.addLoop(
+    [&]() { steps.push_back(4); }, []() { return 10_ms; }, ControlScheduler::phase::actuators);
+  scheduler.addLoop(
+    [&]() { steps.push_back(2); }, []() { return 10_ms; }, ControlScheduler::phase::odometry);
+  scheduler.addLoop(
+    [&]() { steps.push_back(1); }, []() { return 10_ms; }, ControlScheduler::phase::sensors);
+  scheduler.addLoop([&]() { steps.push_back(5); }, []() { return 10_ms; });
+
+  scheduler.stepDueLoops(0_ms);
+  scheduler.stepDueLoops(10_ms);
+
+  // Loops in the same phase keep the order they were added in
+  EXPECT_EQ(steps, std::vector<int>({1, 2, 3, 5, 4, 1, 2, 3, 5, 4}));
+}
+
+TEST(ControlSchedulerTest, NewLoopsStartInPhase) {
+  MockControlScheduler scheduler;
+  int count = 0;
+  scheduler.addLoop([&]() { count++; }, []() { return 10_ms; });
+
+  // The loop is stepped immediately, then on multiples of its period
+  EXPECT_EQ(scheduler.stepDueLoops(13_ms).convert(millisecond), 20);
+  EXPECT_EQ(count, 1);
+}
+
+TEST(ControlSchedulerTest, SkipsMissedSteps) {
+  MockControlScheduler scheduler;
+  int count = 0;
+  scheduler.addLoop([&]() { count++; }, []() { return 10_ms; });
+
+  scheduler.stepDueLoops(0_ms);
+  EXPECT_EQ(scheduler.stepDueLoops(35_ms).convert(millisecond), 40);
+  EXPECT_EQ(count, 2);
+  EXPECT_EQ(scheduler.getOverrunCount(), 1u);
+}
+
+TEST(ControlSchedulerTest, RemovedLoopIsNotStepped) {
+  MockControlScheduler scheduler;
+  int count1 = 0;
+  int count2 = 0;
+  const auto id1 = scheduler.addLoop([&]() { count1++; }, []() { return 10_ms; });
+  scheduler.addLoop([&]() { count2++; }, []() { return 10_ms; });
+  scheduler.removeLoop(id1);
+
+  scheduler.stepDueLoops(0_ms);
+  EXPECT_EQ(count1, 0);
+  EXPECT_EQ(count2, 1);
+  EXPECT_EQ(scheduler.getLoopCount(), 1u);
+}
+
+TEST(ControlSchedulerTest, TaskStepsLoops) {
+  ControlScheduler scheduler(createTimeUtil());
+  std::atomic_int count{0};
+  scheduler.addLoop([&]() { count++; }, []() { return 10_ms; });
+  scheduler.startThread();
+
+  std::this_thread::sleep_for(std::chrono::milliseconds(100));
+  EXPECT_GT(count.load(), 4);
+  EXPECT_LT(count.load(), 15);
+}
+
+TEST(LoopTimingRecorderTest, NoSamples) {
+  LoopTimingRecorder recorder;
+  const auto stats = recorder.getStats();
+  EXPECT_EQ(stats.sampleCount, 0u);
+  EXPECT_EQ(stats.overrunCount, 0u);
+  EXPECT_EQ(stats.maxDt.convert(millisecond), 0);
+}
+
+TEST(LoopTimingRecorderTest, ComputesTheDistribution) {
+  LoopTimingRecorder recorder;
+  for (int i = 0; i < 98; i++) {
+    recorder.record(10_ms, 10_ms);
+  }
+  recorder.record(9_ms, 10_ms);
+  recorder.record(30_ms, 10_ms);
+
+  const auto stats = recorder.getStats();
+  EXPECT_EQ(stats.sampleCount, 100u);
+  EXPECT_EQ(stats.overrunCount, 1u);
+  EXPECT_DOUBLE_EQ(stats.minDt.convert(millisecond), 9);
+  EXPECT_DOUBLE_EQ(stats.maxDt.convert(millisecond), 30);
+  EXPECT_DOUBLE_EQ(stats.meanDt.convert(millisecond), 10.19);
+  EXPECT_DOUBLE_EQ(stats.p99Dt.convert(millisecond), 10);
+}
+
+TEST(LoopTimingRecorderTest, LongTimesUseTheMax) {
+  LoopTimingRecorder recorder;
+  recorder.record(500_ms, 10_ms);
+
+  const auto stats = recorder.getStats();
+  EXPECT_DOUBLE_EQ(stats.p99Dt.convert(millisecond), 500);
+}
+
+TEST(LoopTimingRecorderTest, ResetForgetsSamples) {
+  LoopTimingRecorder recorder;
+  recorder.record(20_ms, 10_ms);
+  recorder.reset();
+  recorder.record(10_ms, 10_ms);
+
+  const auto stats = recorder.getStats();
+  EXPECT_EQ(stats.sampleCount, 1u);
+  EXPECT_EQ(stats.overrunCount, 0u);
+  EXPECT_DOUBLE_EQ(stats.minDt.convert(millisecond), 10);
+}
+
+TEST(StepProfilerTest, DisabledProfilerRecordsNothing) {
+  StepProfiler profiler;
+  { auto scope = profiler.start(); }
+
+  EXPECT_FALSE(profiler.isEnabled());
+  EXPECT_EQ(profiler.get().stepCount, 0u);
+}
+
+TEST(StepProfilerTest, CountsStepsAndSkippedSteps) {
+  StepProfiler profiler;
+  profiler.setEnabled(true);
+  { auto scope = profiler.start(); }
+  {
+    auto scope = profiler.start();
+    scope.skip();
+  }
+
+  const auto profile = profiler.get();
+  EXPECT_EQ(profile.stepCount, 2u);
+  EXPECT_EQ(profile.skippedCount, 1u);
+}
+
+TEST(StepProfilerTest, TimesSteps) {
+  StepProfiler profiler;
+  profiler.setEnabled(true);
+  {
+    auto scope = profiler.start();
+    std::this_thread::sleep_for(std::chrono::milliseconds(2));
+  }
+
+  const auto profile = profiler.get();
+  EXPECT_GE(profile.maxStepMicros, 2000u);
+  EXPECT_GE(profile.totalStepMicros, profile.maxStepMicros);
+  EXPECT_DOUBLE_EQ(profile.meanStepMicros(), static_cast<double>(profile.totalStepMicros));
+}
+
+TEST(StepProfilerTest, ResetClearsTheProfile) {
+  StepProfiler profiler;
+  profiler.setEnabled(true);
+  { auto scope = profiler.start(); }
+  profiler.reset();
+
+  const auto profile = profiler.get();
+  EXPECT_EQ(profile.stepCount, 0u);
+  EXPECT_EQ(profile.totalStepMicros, 0u);
+  EXPECT_EQ(profile.maxStepMicros, 0u);
+  EXPECT_TRUE(profiler.isEnabled());
+}
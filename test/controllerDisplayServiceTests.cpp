@@ -0,0 +1,177 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#include "okapi/api/device/controllerDisplayService.hpp"
+#include "test/tests/api/implMocks.hpp"
+#include <gtest/gtest.h>
+#include <string>
+#include <vector>
+
+using namespace okapi;
+
+struct TextWrite {
+  std::uint8_t line;
+  std::uint8_t col;
+  std::string text;
+
+  bool operator==(const TextWrite &other) const {
+    return line == other.line && col == other.col && text == other.text;
+  }
+};
+
+class ControllerDisplayServiceTest : public ::testing::Test {
+  protected:
+  void SetUp() override {
+    display = std::make_unique<ControllerDisplayService>(
+      [this](std::uint8_t iline, std::uint8_t icol, const std::string &itext) {
+        textWrites.push_back({iline, icol, itext});
+        return acceptWrites;
+      },
+      [this](const std::string &ipattern) {
+        rumbles.push_back(ipattern);
+        return acceptWrites;
+      },
+      createTimeUtil());
+  }
+
+  void flush() {
+    while (display->step()) {
+    }
+  }
+
+  bool acceptWrites{true};
+  std::vector<TextWrite> textWrites;
+  std::vector<std::string> rumbles;
+  std::unique_ptr<ControllerDisplayService> display;
+};
+
+TEST_F(ControllerDisplayServiceTest, FirstWritesClearTheWholeScreen) {
+  EXPECT_FALSE(display->isSynced());
+  flush();
+
+  const std::string blank(ControllerDisplayService::columns, ' ');
+  EXPECT_EQ(textWrites, (std::vector<TextWrite>{{0, 0, blank}, {1, 0, blank}, {2, 0, blank}}));
+  EXPECT_TRUE(display->isSynced());
+}
+
+TEST_F(ControllerDisplayServiceTest, OnlyTheChangedColumnsAreSent) {
+  flush();
+  textWrites.clear();
+
+  display->setText(1, 2, "abc");
+  display->setText(1, 8, "d");
+  EXPECT_FALSE(display->isSynced());
+  flush();
+
+  EXPECT_EQ(textWrites, (std::vector<TextWrite>{{1, 2, "abc   d"}}));
+  EXPECT_TRUE(display->isSynced());
+}
+
+TEST_F(ControllerDisplayServiceTest, RewritingTheSameTextSendsNothing) {
+  display->setText(0, 0, "hello");
+  flush();
+  textWrites.clear();
+
+  display->setText(0, 0, "hello");
+  EXPECT_FALSE(display->step());
+  EXPECT_TRUE(textWrites.empty());
+}
+
+TEST_F(ControllerDisplayServiceTest, OneWritePerStep) {
+  flush();
+  textWrites.clear();
+
+  display->setText(0, 0, "a");
+  display->setText(2, 0, "b");
+  display->step();
+  EXPECT_EQ(textWrites, (std::vector<TextWrite>{{0, 0, "a"}}));
+  display->step();
+  EXPECT_EQ(textWrites, (std::vector<TextWrite>{{0, 0, "a"}, {2, 0, "b"}}));
+}
+
+TEST_F(ControllerDisplayServiceTest, LinesTakeTurns) {
+  flush();
+  textWrites.clear();
+
+  // Line 0 changes every step, but line 1 still gets sent
+  display->setText(0, 0, "1");
+  display->setText(1, 0, "x");
+  display->step();
+  display->setText(0, 0, "2");
+  display->step();
+  display->step();
+
+  EXPECT_EQ(textWrites, (std::vector<TextWrite>{{0, 0, "1"}, {1, 0, "x"}, {0, 0, "2"}}));
+}
+
+TEST_F(ControllerDisplayServiceTest, TextIsCutOffAtTheEndOfTheLine) {
+  display->setText(0, 10, "0123456789");
+  display->setText(3, 0, "ignored");
+  display->setText(0, 15, "ignored");
+
+  EXPECT_EQ(display->getText(0), "          01234");
+}
+
+TEST_F(ControllerDisplayServiceTest, ClearBlanksTheScreen) {
+  display->setText(0, 0, "abc");
+  display->setText(2, 3, "def");
+  flush();
+  textWrites.clear();
+
+  display->clear();
+  flush();
+
+  EXPECT_EQ(textWrites, (std::vector<TextWrite>{{0, 0, "   "}, {2, 3, "   "}}));
+}
+
+TEST_F(ControllerDisplayServiceTest, FailedWritesAreRetried) {
+  flush();
+  textWrites.clear();
+
+  acceptWrites = false;
+  display->setText(1, 0, "abc");
+  EXPECT_FALSE(display->step());
+  EXPECT_FALSE(display->isSynced());
+
+  acceptWrites = true;
+  EXPECT_TRUE(display->step());
+  EXPECT_EQ(textWrites, (std::vector<TextWrite>{{1, 0, "abc"}, {1, 0, "abc"}}));
+  EXPECT_TRUE(display->isSynced());
+}
+
+TEST_F(ControllerDisplayServiceTest, RumbleIsSentBeforeText) {
+  display->setText(0, 0, "a");
+  display->rumble(".");
+  display->rumble("-");
+  display->step();
+
+  EXPECT_EQ(rumbles, std::vector<std::string>{"-"});
+  EXPECT_TRUE(textWrites.empty());
+}
+
+TEST_F(ControllerDisplayServiceTest, FailedRumbleIsRetried) {
+  acceptWrites = false;
+  display->rumble(".");
+  display->step();
+
+  acceptWrites = true;
+  display->step();
+
+  EXPECT_EQ(rumbles, (std::vector<std::string>{".", "."}));
+  EXPECT_TRUE(textWrites.empty());
+}
+
+TEST_F(ControllerDisplayServiceTest, InvalidateSendsTheWholeScreenAgain) {
+  display->setText(0, 0, "abc");
+  flush();
+  textWrites.clear();
+
+  display->invalidate();
+  flush();
+
+  const std::string blank(ControllerDisplayService::columns, ' ');
+  const std::string first = "abc" + blank.substr(3);
+  EXPECT_EQ(textWrites, (std::vector<TextWrite>{{0, 0, first}, {1, 0, blank}, {2, 0, blank}}));
+}
@@ -13,12 +13,16 @@
 #include "okapi/api/control/iterative/iterativeVelPidController.hpp"
 #include "okapi/api/control/util/flywheelSimulator.hpp"
 #include "okapi/api/control/util/pidTuner.hpp"
+#include "okapi/api/control/util/relayTuner.hpp"
 #include "okapi/api/filter/averageFilter.hpp"
+#include "okapi/api/filter/filterChain.hpp"
 #include "okapi/api/filter/filteredControllerInput.hpp"
 #include "okapi/api/filter/passthroughFilter.hpp"
 #include "okapi/api/filter/velMath.hpp"
 #include "okapi/api/util/mathUtil.hpp"
 #include "test/tests/api/implMocks.hpp"
+#include "test/tests/api/virtualClock.hpp"
+#include <deque>
 #include <gtest/gtest.h>
 #include <limits>
 
@@ -108,6 +112,17 @@ TEST(FilteredControllerInputTest, InputShouldBePassedThrough) {
   }
 }
 
+TEST(FilteredControllerInputTest, FilterChainFiltersTheInput) {
+  auto reading = std::make_unique<MockControllerInput>();
+  auto readingPtr = reading.get();
+  FilteredControllerInput<double, FilterChain<AverageFilter<2>>> input(
+    std::move(reading), std::make_unique<FilterChain<AverageFilter<2>>>());
+
+  readingPtr->reading = 4;
+  EXPECT_DOUBLE_EQ(input.controllerGet(), 2);
+  EXPECT_DOUBLE_EQ(input.controllerGet(), 4);
+}
+
 TEST(PIDTunerTest, ConstructorShouldNotSegfault) {
   auto output = std::make_shared<MockMotor>();
   auto input = output->getEncoder();
@@ -127,6 +142,226 @@ TEST(PIDTunerTest, AutotuneShouldNotSegfault) {
   system->join(); // gtest will cause a SIGABRT if we don't join manually first
 }
 
+TEST(PIDTunerTest, AutotuneAgainstSimulators) {
+  std::size_t simulatorCount = 0;
+  PIDTuner pidTuner(nullptr, nullptr, createTimeUtil(), 2_s, 2, 0, 10, 0, 0, 0, 1, 5, 16);
+  pidTuner.setSimulator(
+    [&]() {
+      simulatorCount++;
+      auto simulator = std::make_shared<FlywheelSimulator>(0.001, 1, 0.1, 0.1);
+      simulator->setExternalTorqueFunction([](double, double, double) { return 0; });
+      auto system = std::make_shared<SimulatedSystem>(*simulator);
+      return PIDTuner::Simulator{system, system, [simulator](QTime) { simulator->step(); }};
+    },
+    4,
+    0.05,
+    0.05,
+    50_ms);
+
+  // Testing every particle in real time would take minutes
+  const auto start = std::chrono::steady_clock::now();
+  const auto gains = pidTuner.autotune();
+  EXPECT_LT(std::chrono::steady_clock::now() - start, std::chrono::seconds(10));
+  EXPECT_EQ(simulatorCount, 5u * 16);
+
+  EXPECT_GE(gains.kP, 0);
+  EXPECT_LE(gains.kP, 10);
+  EXPECT_EQ(gains.kI, 0);
+  EXPECT_GE(gains.kD, 0);
+  EXPECT_LE(gains.kD, 1);
+
+  // The best gains should reach the goal
+  FlywheelSimulator simulator(0.001, 1, 0.1, 0.1);
+  simulator.setExternalTorqueFunction([](double, double, double) { return 0; });
+  IterativePosPIDController controller(
+    gains.kP, gains.kI, gains.kD, 0, createConstantTimeUtil(10_ms));
+  controller.setTarget(2);
+  for (int i = 0; i < 200; i++) {
+    simulator.setTorque(controller.step(simulator.getAngle()));
+    simulator.step();
+  }
+  EXPECT_NEAR(simulator.getAngle(), 2, 0.25);
+}
+
+/**
+ * Exposes the pieces of the optimization so they can be tested one at a time.
+ */
+class MockPIDTuner : public PIDTuner {
+  public:
+  MockPIDTuner() : PIDTuner(nullptr, nullptr, createTimeUtil(), 2_s, 2, 0, 10, 0, 0, 0, 1, 5) {
+  }
+
+  using PIDTuner::getInertia;
+  using PIDTuner::hasConverged;
+  using PIDTuner::ParticleSet;
+  using PIDTuner::testParticle;
+};
+
+TEST(PIDTunerTest, TestParticleStopsOnceItCannotBeatTheCutoff) {
+  MockPIDTuner tuner;
+  FlywheelSimulator simulator(0.001, 1, 0.1, 0.1);
+  simulator.setExternalTorqueFunction([](double, double, double) { return 0; });
+  auto system = std::make_shared<SimulatedSystem>(simulator);
+
+  MockPIDTuner::ParticleSet particle{};
+  particle.kP.pos = 1;
+
+  int steps = 0;
+  const double error = tuner.testParticle(
+    particle, 2, 100, createConstantTimeUtil(10_ms), *system, *system, [&]() { steps++; });
+
+  EXPECT_EQ(error, std::numeric_limits<double>::infinity());
+  EXPECT_LT(steps, 10);
+}
+
+TEST(PIDTunerTest, InertiaMovesFromStartToEnd) {
+  MockPIDTuner tuner;
+  EXPECT_DOUBLE_EQ(tuner.getInertia(0), 0.9);
+  EXPECT_DOUBLE_EQ(tuner.getInertia(2), 0.65);
+  EXPECT_DOUBLE_EQ(tuner.getInertia(4), 0.4);
+
+  tuner.setInertiaSchedule(0.5, 0.5);
+  EXPECT_DOUBLE_EQ(tuner.getInertia(0), 0.5);
+  EXPECT_DOUBLE_EQ(tuner.getInertia(4), 0.5);
+}
+
+TEST(PIDTunerTest, SwarmConvergesWhenEveryParticleIsClose) {
+  MockPIDTuner tuner;
+  std::vector<MockPIDTuner::ParticleSet> particles(3);
+  particles.at(0).kP.pos = 5;
+  particles.at(1).kP.pos = 5.05;
+  particles.at(2).kP.pos = 5.08;
+  particles.at(2).kD.pos = 0.005;
+
+  // The kI range is empty, so kI never counts against convergence
+  EXPECT_TRUE(tuner.hasConverged(particles));
+
+  particles.at(2).kD.pos = 0.02;
+  EXPECT_FALSE(tuner.hasConverged(particles));
+
+  tuner.setConvergenceTolerance(0);
+  particles.at(2).kD.pos = 0;
+  EXPECT_FALSE(tuner.hasConverged(particles));
+}
+
+TEST(PIDTunerTest, AutotuneStopsOnceTheSwarmConverges) {
+  std::size_t simulatorCount = 0;
+  PIDTuner pidTuner(nullptr, nullptr, createTimeUtil(), 2_s, 2, 0, 10, 0, 0, 0, 1, 5, 16);
+  pidTuner.setSimulator([&]() {
+    simulatorCount++;
+    auto simulator = std::make_shared<FlywheelSimulator>(0.001, 1, 0.1, 0.1);
+    simulator->setExternalTorqueFunction([](double, double, double) { return 0; });
+    auto system = std::make_shared<SimulatedSystem>(*simulator);
+    return PIDTuner::Simulator{system, system, [simulator](QTime) { simulator->step(); }};
+  });
+
+  // Every swarm is within its whole range, so the first iteration is the only one
+  pidTuner.setConvergenceTolerance(1);
+  pidTuner.autotune();
+  EXPECT_EQ(simulatorCount, 16u);
+}
+
+namespace {
+/**
+ * An integrator behind a dead time. Under an ideal relay it oscillates with a period of four dead
+ * times and an amplitude of the relay times the gain times the dead time.
+ */
+class DeadTimeIntegrator : public ControllerInput<double>, public ControllerOutput<double> {
+  public:
+  DeadTimeIntegrator(const double igain, const std::size_t idelaySteps)
+    : gain(igain), pending(idelaySteps, 0) {
+  }
+
+  double controllerGet() override {
+    return position;
+  }
+
+  void controllerSet(const double ivalue) override {
+    command = ivalue;
+  }
+
+  void step(const double idt) {
+    pending.push_back(command);
+    position += gain * pending.front() * idt;
+    pending.pop_front();
+  }
+
+  double gain;
+  std::deque<double> pending;
+  double command{0};
+  double position{0};
+};
+} // namespace
+
+TEST(RelayTunerTest, FindsTheUltimateGainAndPeriod) {
+  VirtualClock clock;
+  auto plant = std::make_shared<DeadTimeIntegrator>(1, 9);
+  clock.addListener([&](QTime) { plant->step(0.01); });
+
+  // With the sample and hold, the dead time is 100 ms
+  RelayTuner tuner(plant, plant, clock.createTimeUtil(), 1, 0.5);
+  const auto result = tuner.autotune();
+
+  EXPECT_NEAR(result.ultimatePeriod.convert(millisecond), 400, 20);
+  EXPECT_NEAR(result.ultimateGain, 4 / (pi * 0.1), 1.5);
+  EXPECT_EQ(plant->command, 0);
+
+  const auto expected = RelayTuner::computeGains(
+    result.ultimateGain, result.ultimatePeriod, RelayTuner::Rule::zieglerNichols);
+  EXPECT_DOUBLE_EQ(result.kP, expected.kP);
+  EXPECT_DOUBLE_EQ(result.kI, expected.kI);
+  EXPECT_DOUBLE_EQ(result.kD, expected.kD);
+
+  // Two seconds to rise to the goal, then the cycles it measured and the one it skipped
+  EXPECT_LT(clock.now(), 4_s);
+}
+
+TEST(RelayTunerTest, HysteresisLowersTheUltimateGain) {
+  VirtualClock clock;
+  auto plant = std::make_shared<DeadTimeIntegrator>(1, 9);
+  clock.addListener([&](QTime) { plant->step(0.01); });
+
+  RelayTuner tuner(plant, plant, clock.createTimeUtil(), -1, 0.5, 0.02);
+  const auto result = tuner.autotune(RelayTuner::Rule::tyreusLuyben);
+
+  // The relay switches later, so the oscillation is slower
+  EXPECT_GT(result.ultimatePeriod, 400_ms);
+  EXPECT_GT(result.ultimateGain, 0);
+  EXPECT_LT(result.ultimateGain, 4 / (pi * 0.1));
+}
+
+TEST(RelayTunerTest, ReturnsZerosWithoutAnOscillation) {
+  VirtualClock clock;
+  auto plant = std::make_shared<DeadTimeIntegrator>(0, 0);
+  clock.addListener([&](QTime) { plant->step(0.01); });
+
+  RelayTuner tuner(plant, plant, clock.createTimeUtil(), 1, 1, 0, 3, 1_s);
+  const auto result = tuner.autotune();
+
+  EXPECT_EQ(result.kP, 0);
+  EXPECT_EQ(result.ultimateGain, 0);
+  EXPECT_EQ(plant->command, 0);
+}
+
+TEST(RelayTunerTest, ComputeGains) {
+  const auto zn = RelayTuner::computeGains(10, 1_s, RelayTuner::Rule::zieglerNichols);
+  EXPECT_DOUBLE_EQ(zn.kP, 6);
+  EXPECT_DOUBLE_EQ(zn.kI, 12);
+  EXPECT_DOUBLE_EQ(zn.kD, 0.75);
+
+  const auto tl = RelayTuner::computeGains(11, 2.2_s, RelayTuner::Rule::tyreusLuyben);
+  EXPECT_DOUBLE_EQ(tl.kP, 5);
+  EXPECT_NEAR(tl.kI, 5 / (2.2 * 2.2), 1e-9);
+  EXPECT_NEAR(tl.kD, 5 * 2.2 / 6.3, 1e-9);
+}
+
+TEST(RelayTunerTest, RejectsABadRelay) {
+  auto plant = std::make_shared<DeadTimeIntegrator>(1, 0);
+  EXPECT_THROW(RelayTuner(plant, plant, createTimeUtil(), 1, 0), std::invalid_argument);
+  EXPECT_THROW(RelayTuner(plant, plant, createTimeUtil(), 1, 1.5), std::invalid_argument);
+  EXPECT_THROW(RelayTuner(plant, plant, createTimeUtil(), 1, 1, 0, 0), std::invalid_argument);
+}
+
 TEST(SettledUtilTest, MaxDoubleError) {
   MockRate rate;
   SettledUtil settledUtil(
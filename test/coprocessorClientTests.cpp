@@ -0,0 +1,140 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#include "okapi/api/control/util/coprocessorClient.hpp"
+#include "okapi/api/control/util/pathBinaryFormat.hpp"
+#include "test/tests/api/implMocks.hpp"
+#include <cstring>
+#include <gtest/gtest.h>
+#include <sstream>
+
+using namespace okapi;
+
+class CoprocessorClientTest : public ::testing::Test {
+  protected:
+  class StateOdometry : public Odometry {
+    public:
+    void setScales(const ChassisScales &) override {
+    }
+
+    void step() override {
+    }
+
+    OdomState getState(const StateMode &) const override {
+      return state;
+    }
+
+    void setState(const OdomState &istate, const StateMode &) override {
+      state = istate;
+    }
+
+    std::shared_ptr<ReadOnlyChassisModel> getModel() override {
+      return nullptr;
+    }
+
+    ChassisScales getScales() override {
+      return {{4_in, 10_in}, imev5GreenTPR};
+    }
+
+    OdomState state{};
+  };
+
+  void SetUp() override {
+    auto [brainEnd, piEnd] = MockSerialPort::makeCable();
+    brain = std::make_shared<SerialLink>(brainEnd, createTimeUtil());
+    pi = std::make_shared<SerialLink>(piEnd, createTimeUtil());
+    client = std::make_unique<CoprocessorClient>(brain, createTimeUtil(), 1_s);
+  }
+
+  static std::vector<float> readFloats(const std::uint8_t *ipayload, const std::size_t ilength) {
+    std::vector<float> values(ilength / sizeof(float));
+    std::memcpy(values.data(), ipayload, values.size() * sizeof(float));
+    return values;
+  }
+
+  std::shared_ptr<SerialLink> brain;
+  std::shared_ptr<SerialLink> pi;
+  std::unique_ptr<CoprocessorClient> client;
+};
+
+TEST_F(CoprocessorClientTest, GeneratesProfilesOnTheCoprocessor) {
+  std::vector<float> request;
+  pi->onRequest(CoprocessorClient::generateProfileType,
+                [&](const std::uint8_t *ipayload, const std::size_t ilength) {
+                  request = readFloats(ipayload, ilength);
+
+                  std::vector<squiggles::ProfilePoint> profile;
+                  for (int i = 0; i < 3; i++) {
+                    profile.emplace_back(
+                      squiggles::ControlVector(squiggles::Pose(0.1 * i, 0, 0), 0.5, 1, 0),
+                      std::vector<double>{0.5, 0.5},
+                      0,
+                      0.01 * i);
+                  }
+
+                  std::ostringstream stream;
+                  PathBinaryFormat::serialize(stream, profile);
+                  const std::string bytes = stream.str();
+                  return std::optional<std::vector<std::uint8_t>>(
+                    std::vector<std::uint8_t>(bytes.begin(), bytes.end()));
+                });
+  pi->startThread();
+
+  const auto profile = client->generateProfile(
+    {{0_m, 0_m, 0_deg}, {1_m, 0.5_m, 90_deg}}, {1.0, 2.0, 10.0}, 0.25_m, 0_mps, 0.5_mps);
+
+  ASSERT_TRUE(profile.has_value());
+  ASSERT_EQ(profile->size(), 3u);
+  EXPECT_FLOAT_EQ(profile->at(2).vector.pose.x, 0.2);
+  EXPECT_FLOAT_EQ(profile->at(2).time, 0.02);
+
+  ASSERT_EQ(request.size(), 12u);
+  EXPECT_FLOAT_EQ(request[0], 0.25);
+  EXPECT_FLOAT_EQ(request[2], 0.5);
+  EXPECT_FLOAT_EQ(request[3], 1.0);
+  EXPECT_FLOAT_EQ(request[5], 10.0);
+  EXPECT_FLOAT_EQ(request[9], 1.0);
+  EXPECT_FLOAT_EQ(request[10], 0.5);
+  EXPECT_FLOAT_EQ(request[11], static_cast<float>(M_PI / 2));
+}
+
+TEST_F(CoprocessorClientTest, NoProfileIfTheCoprocessorFails) {
+  pi->onRequest(CoprocessorClient::generateProfileType,
+                [](const std::uint8_t *, std::size_t) {
+                  return std::optional<std::vector<std::uint8_t>>(std::vector<std::uint8_t>{1, 2});
+                });
+  pi->startThread();
+
+  EXPECT_FALSE(
+    client->generateProfile({{0_m, 0_m, 0_deg}, {1_m, 0_m, 0_deg}}, {1.0, 2.0, 10.0}, 0.25_m)
+      .has_value());
+}
+
+TEST_F(CoprocessorClientTest, PoseEstimatesCorrectTheOdometry) {
+  auto odometry = std::make_shared<StateOdometry>();
+  odometry->state = {1_m, 1_m, 10_deg};
+  client->forwardPoseEstimates(odometry);
+
+  std::vector<std::uint8_t> message(sizeof(std::uint16_t) + 3 * sizeof(float));
+  const std::uint16_t age = 0;
+  const float pose[] = {2, 3, static_cast<float>(M_PI / 2)};
+  std::memcpy(message.data(), &age, sizeof(age));
+  std::memcpy(message.data() + sizeof(age), pose, sizeof(pose));
+  pi->send(CoprocessorClient::poseEstimateType, message.data(), message.size());
+
+  // A message of the wrong size is ignored
+  pi->send(CoprocessorClient::poseEstimateType, message.data(), message.size() - 1);
+  brain->step();
+
+  EXPECT_NEAR(odometry->state.x.convert(meter), 2, 1e-6);
+  EXPECT_NEAR(odometry->state.y.convert(meter), 3, 1e-6);
+  EXPECT_NEAR(odometry->state.theta.convert(degree), 90, 1e-4);
+
+  client->forwardPoseEstimates(nullptr);
+  pi->send(CoprocessorClient::poseEstimateType, message.data(), message.size());
+  odometry->state = {0_m, 0_m, 0_deg};
+  brain->step();
+  EXPECT_EQ(odometry->state.x, 0_m);
+}
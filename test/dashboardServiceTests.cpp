@@ -0,0 +1,86 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#include "okapi/api/device/dashboardService.hpp"
+#include "test/tests/api/implMocks.hpp"
+#include <gtest/gtest.h>
+#include <string>
+#include <utility>
+#include <vector>
+
+using namespace okapi;
+
+class DashboardServiceTest : public ::testing::Test {
+  protected:
+  void SetUp() override {
+    dashboard = std::make_unique<DashboardService>(
+      [this](std::size_t icell, const std::string &itext) { writes.emplace_back(icell, itext); },
+      createTimeUtil());
+  }
+
+  std::vector<std::pair<std::size_t, std::string>> writes;
+  std::unique_ptr<DashboardService> dashboard;
+};
+
+TEST_F(DashboardServiceTest, FieldsAreFormattedWithTheirLabels) {
+  dashboard->addValue("error", [] { return 1.23456; });
+  dashboard->addValue("speed", [] { return -2.0; }, 0);
+  dashboard->addField("", [] { return std::string("idle"); });
+  dashboard->addTemperature("left", std::make_shared<MockMotor>());
+
+  EXPECT_EQ(dashboard->step(), 4u);
+  EXPECT_EQ(writes,
+            (std::vector<std::pair<std::size_t, std::string>>{
+              {0, "error: 1.23"}, {1, "speed: -2"}, {2, "idle"}, {3, "left: 0 C"}}));
+  EXPECT_EQ(dashboard->getText(0), "error: 1.23");
+  EXPECT_EQ(dashboard->getText(4), "");
+}
+
+TEST_F(DashboardServiceTest, OnlyChangedCellsAreWritten) {
+  double value = 1;
+  dashboard->addValue("a", [] { return 5.0; });
+  dashboard->addValue("b", [&] { return value; });
+  dashboard->step();
+  writes.clear();
+
+  EXPECT_EQ(dashboard->step(), 0u);
+  EXPECT_TRUE(writes.empty());
+
+  value = 2;
+  EXPECT_EQ(dashboard->step(), 1u);
+  EXPECT_EQ(writes, (std::vector<std::pair<std::size_t, std::string>>{{1, "b: 2.00"}}));
+
+  // A change smaller than the precision shows the same text
+  writes.clear();
+  value = 2.001;
+  EXPECT_EQ(dashboard->step(), 0u);
+  EXPECT_TRUE(writes.empty());
+}
+
+TEST_F(DashboardServiceTest, InvalidateWritesEveryCellAgain) {
+  dashboard->addValue("a", [] { return 5.0; });
+  dashboard->addValue("b", [] { return 6.0; });
+  dashboard->step();
+  writes.clear();
+
+  dashboard->invalidate();
+  EXPECT_EQ(dashboard->getText(0), "");
+  EXPECT_EQ(dashboard->step(), 2u);
+  EXPECT_EQ(writes.size(), 2u);
+}
+
+TEST_F(DashboardServiceTest, FieldsPastTheLastCellAreRejected) {
+  for (std::size_t i = 0; i < DashboardService::maxCells - 2; i++) {
+    EXPECT_TRUE(dashboard->addValue(std::to_string(i), [] { return 0.0; }));
+  }
+
+  // The task load needs three cells and is not added in part
+  EXPECT_FALSE(dashboard->addTaskLoad(3));
+  EXPECT_EQ(dashboard->getFieldCount(), DashboardService::maxCells - 2);
+
+  EXPECT_TRUE(dashboard->addTaskLoad(2));
+  EXPECT_FALSE(dashboard->addValue("extra", [] { return 0.0; }));
+  EXPECT_EQ(dashboard->getFieldCount(), DashboardService::maxCells);
+}
@@ -4,16 +4,25 @@
  * file, You can obtain one at http://mozilla.org/MPL/2.0/.
  */
 #include "okapi/api/chassis/controller/defaultOdomChassisController.hpp"
+#include "okapi/api/control/util/controlScheduler.hpp"
 #include "okapi/api/odometry/odomMath.hpp"
 #include "okapi/api/odometry/twoEncoderOdometry.hpp"
 #include "test/tests/api/implMocks.hpp"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
 #include <gtest/gtest.h>
+#include <limits>
+#include <thread>
+#include <vector>
 
 using namespace okapi;
 
 class MockDefaultOdomChassisController : public DefaultOdomChassisController {
   public:
   using DefaultOdomChassisController::DefaultOdomChassisController;
+  using DefaultOdomChassisController::odomReady;
   using DefaultOdomChassisController::odomTaskRunning;
 };
 
@@ -27,6 +36,7 @@ class DefaultOdomChassisControllerTest : public ::testing::Test {
     drive = new MockDefaultOdomChassisController(
       createTimeUtil(), std::shared_ptr<Odometry>(odom), controller);
     drive->odomTaskRunning = true;
+    drive->odomReady = true;
   }
 
   void TearDown() override {
@@ -185,3 +195,283 @@ TEST_F(DefaultOdomChassisControllerTest, SetStateInCartesianTest) {
   auto stateAfter = drive->getState();
   EXPECT_EQ(stateAfter, newState);
 }
+
+TEST_F(DefaultOdomChassisControllerTest, OdomLoopPeriodDefault) {
+  EXPECT_EQ(drive->getOdomLoopPeriod(), OdomChassisController::defaultOdomLoopPeriod);
+}
+
+TEST_F(DefaultOdomChassisControllerTest, SetOdomLoopPeriod) {
+  drive->setOdomLoopPeriod(5_ms);
+  EXPECT_EQ(drive->getOdomLoopPeriod(), 5_ms);
+}
+
+TEST_F(DefaultOdomChassisControllerTest, SetOdomLoopPeriodBelowOneMillisecondThrows) {
+  EXPECT_THROW(drive->setOdomLoopPeriod(0_ms), std::invalid_argument);
+  EXPECT_THROW(drive->setOdomLoopPeriod(0.5_ms), std::invalid_argument);
+  EXPECT_EQ(drive->getOdomLoopPeriod(), OdomChassisController::defaultOdomLoopPeriod);
+}
+
+class OdomStepControlScheduler : public ControlScheduler {
+  public:
+  OdomStepControlScheduler() : ControlScheduler(createTimeUtil()) {
+  }
+
+  using ControlScheduler::stepDueLoops;
+};
+
+TEST_F(DefaultOdomChassisControllerTest, OdomCommandsWaitForTheFirstOdomStep) {
+  auto scheduler = std::make_shared<OdomStepControlScheduler>();
+  MockDefaultOdomChassisController waitingDrive(
+    createTimeUtil(), std::make_shared<TwoEncoderOdometry>(
+                        createTimeUtil(), std::make_shared<MockReadOnlyChassisModel>(), scales),
+    controller);
+  waitingDrive.startOdomScheduled(scheduler);
+  EXPECT_FALSE(waitingDrive.odomReady);
+
+  std::atomic_bool turned{false};
+  std::thread turnThread([&]() {
+    waitingDrive.turnToAngle(90_deg);
+    turned = true;
+  });
+
+  std::this_thread::sleep_for(std::chrono::milliseconds(20));
+  EXPECT_FALSE(turned);
+
+  scheduler->stepDueLoops(0_ms);
+  turnThread.join();
+  EXPECT_TRUE(waitingDrive.odomReady);
+  EXPECT_EQ(controller->lastTurnAngleTargetQAngle, 90_deg);
+}
+
+TEST_F(DefaultOdomChassisControllerTest, ScheduledOdomUsesOdomLoopPeriod) {
+  auto scheduler = std::make_shared<OdomStepControlScheduler>();
+  drive->setOdomLoopPeriod(5_ms);
+  drive->startOdomScheduled(scheduler);
+
+  EXPECT_EQ(scheduler->getLoopCount(), 1u);
+  EXPECT_EQ(scheduler->stepDueLoops(0_ms), 5_ms);
+  EXPECT_EQ(scheduler->stepDueLoops(5_ms), 10_ms);
+}
+
+/**
+ * Moves the odometry state as a skid steer chassis would move with the commanded speeds, 10 ms per
+ * command.
+ */
+class CurvedMotionChassisModel : public MockChassisModel {
+  public:
+  void driveVector(const double iySpeed, const double izRotation) override {
+    MockChassisModel::driveVector(iySpeed, izRotation);
+    commandCount++;
+    if (std::abs(izRotation) > 0 && std::abs(iySpeed) < 1e-9) {
+      turnInPlaceCount++;
+    }
+
+    const double leftSpeed = std::clamp(iySpeed + izRotation, -1.0, 1.0) * maxSpeed;
+    const double rightSpeed = std::clamp(iySpeed - izRotation, -1.0, 1.0) * maxSpeed;
+    const double dt = 0.01;
+
+    const auto state = odom->getState();
+    const double theta = state.theta.convert(radian);
+    const double forward = (leftSpeed + rightSpeed) / 2 * dt;
+    odom->setState({state.x + forward * std::cos(theta) * meter,
+                    state.y + forward * std::sin(theta) * meter,
+                    state.theta + (leftSpeed - rightSpeed) / track * dt * radian});
+    states.push_back(odom->getState());
+    forwardSpeeds.push_back(iySpeed);
+  }
+
+  void stop() override {
+    MockChassisModel::stop();
+    stopCount++;
+  }
+
+  /**
+   * @return How close the robot came to a point, and the forward speed when it was closest.
+   */
+  std::pair<QLength, double> closestApproach(const Point &ipoint) const {
+    QLength closest = std::numeric_limits<double>::infinity() * meter;
+    double speed = 0;
+    for (std::size_t i = 0; i < states.size(); i++) {
+      const QLength distance = OdomMath::computeDistanceToPoint(ipoint, states[i]);
+      if (distance < closest) {
+        closest = distance;
+        speed = forwardSpeeds[i];
+      }
+    }
+    return {closest, speed};
+  }
+
+  Odometry *odom{nullptr};
+  int commandCount{0};
+  int turnInPlaceCount{0};
+  int stopCount{0};
+  std::vector<OdomState> states{};
+  std::vector<double> forwardSpeeds{};
+  double maxSpeed{1};
+  double track{0.254};
+};
+
+class NoDelayRate : public AbstractRate {
+  public:
+  void delay(QFrequency) override {
+  }
+
+  void delayUntil(QTime) override {
+  }
+
+  void delayUntil(uint32_t) override {
+  }
+
+  void reset() override {
+  }
+};
+
+class DefaultOdomChassisControllerCurvedTest : public ::testing::Test {
+  protected:
+  void SetUp() override {
+    const TimeUtil timeUtil(
+      Supplier<std::unique_ptr<AbstractTimer>>([]() { return std::make_unique<MockTimer>(); }),
+      Supplier<std::unique_ptr<AbstractRate>>([]() { return std::make_unique<NoDelayRate>(); }),
+      Supplier<std::unique_ptr<SettledUtil>>([]() { return createSettledUtilPtr(); }));
+
+    odom = std::make_shared<TwoEncoderOdometry>(
+      createTimeUtil(), std::make_shared<MockReadOnlyChassisModel>(), scales);
+    model = std::make_shared<CurvedMotionChassisModel>();
+    model->odom = odom.get();
+    controller = std::make_shared<MockChassisController>();
+    controller->chassisModel = model;
+
+    drive = std::make_unique<MockDefaultOdomChassisController>(timeUtil, odom, controller);
+    drive->odomTaskRunning = true;
+    drive->odomReady = true;
+  }
+
+  void expectNear(const QLength &ix, const QLength &iy, const QLength &itolerance) {
+    const auto state = odom->getState();
+    EXPECT_NEAR(state.x.convert(meter), ix.convert(meter), itolerance.convert(meter));
+    EXPECT_NEAR(state.y.convert(meter), iy.convert(meter), itolerance.convert(meter));
+  }
+
+  ChassisScales scales{{4.125_in, 10_in}, imev5GreenTPR};
+  std::shared_ptr<TwoEncoderOdometry> odom;
+  std::shared_ptr<CurvedMotionChassisModel> model;
+  std::shared_ptr<MockChassisController> controller;
+  std::unique_ptr<MockDefaultOdomChassisController> drive;
+};
+
+TEST_F(DefaultOdomChassisControllerCurvedTest, DrivesToAPointOffToTheSideInOneMotion) {
+  drive->driveToPointCurved({1_m, 0.5_m});
+
+  expectNear(1_m, 0.5_m, 1.5_in);
+  EXPECT_GT(odom->getState().theta, 0_deg);
+  EXPECT_EQ(model->turnInPlaceCount, 0);
+  EXPECT_TRUE(model->stopWasCalled);
+
+  // The chassis controller's turn and drive weren't used
+  EXPECT_EQ(controller->lastTurnAngleTargetQAngle, 0_deg);
+  EXPECT_EQ(controller->lastMoveDistanceTargetQLength, 0_m);
+  EXPECT_EQ(controller->waitUntilSettledCalled, 0);
+  EXPECT_EQ(controller->stopCalled, 1);
+}
+
+TEST_F(DefaultOdomChassisControllerCurvedTest, TurnsInPlaceToAPointBehind) {
+  drive->driveToPointCurved({-1_m, 0.1_m});
+
+  expectNear(-1_m, 0.1_m, 1.5_in);
+  EXPECT_GT(model->turnInPlaceCount, 0);
+}
+
+TEST_F(DefaultOdomChassisControllerCurvedTest, DrivesBackwardsToAPoint) {
+  drive->driveToPointCurved({-1_m, -0.3_m}, true);
+
+  expectNear(-1_m, -0.3_m, 1.5_in);
+  EXPECT_EQ(model->turnInPlaceCount, 0);
+  EXPECT_LT(model->lastVectorY, 0);
+  EXPECT_LT(odom->getState().theta.abs(), 90_deg);
+}
+
+TEST_F(DefaultOdomChassisControllerCurvedTest, StopsAtTheOffset) {
+  drive->driveToPointCurved({1_m, 0_m}, false, 0.3_m);
+
+  expectNear(0.7_m, 0_m, 1.5_in);
+}
+
+TEST_F(DefaultOdomChassisControllerCurvedTest, UsesTheDefaultStateMode) {
+  drive->setDefaultStateMode(StateMode::CARTESIAN);
+  drive->driveToPointCurved({0.5_m, 1_m});
+
+  expectNear(1_m, 0.5_m, 1.5_in);
+}
+
+TEST_F(DefaultOdomChassisControllerCurvedTest, PointWithinToleranceDoesNotMove) {
+  drive->driveToPointCurved({0.5_in, 0_m});
+
+  EXPECT_EQ(model->commandCount, 0);
+  EXPECT_TRUE(model->stopWasCalled);
+}
+
+TEST_F(DefaultOdomChassisControllerCurvedTest, SetCurvedMotionSettings) {
+  drive->setCurvedMotionSettings({1, 2, 0.5_in, 4_in, 8_in});
+  const auto settings = drive->getCurvedMotionSettings();
+  EXPECT_EQ(settings.distanceGain, 1);
+  EXPECT_EQ(settings.angleGain, 2);
+  EXPECT_EQ(settings.tolerance, 0.5_in);
+  EXPECT_EQ(settings.straightDistance, 4_in);
+  EXPECT_EQ(settings.lookahead, 8_in);
+
+  drive->driveToPointCurved({1_m, 0.5_m});
+  expectNear(1_m, 0.5_m, 1_in);
+}
+
+TEST_F(DefaultOdomChassisControllerCurvedTest, InvalidCurvedMotionSettingsThrow) {
+  EXPECT_THROW(drive->setCurvedMotionSettings({0, 1.5, 1_in, 6_in}), std::invalid_argument);
+  EXPECT_THROW(drive->setCurvedMotionSettings({2, -1, 1_in, 6_in}), std::invalid_argument);
+  EXPECT_THROW(drive->setCurvedMotionSettings({2, 1.5, 0_in, 6_in}), std::invalid_argument);
+  EXPECT_THROW(drive->setCurvedMotionSettings({2, 1.5, 1_in, 0_in}), std::invalid_argument);
+  EXPECT_THROW(drive->setCurvedMotionSettings({2, 1.5, 1_in, 6_in, 0_in}), std::invalid_argument);
+  EXPECT_EQ(drive->getCurvedMotionSettings().distanceGain, 2);
+}
+
+TEST_F(DefaultOdomChassisControllerCurvedTest, DrivesThroughPointsWithoutStopping) {
+  drive->driveThrough({{1_m, 0_m}, {1_m, 1_m}, {0_m, 1_m}});
+
+  expectNear(0_m, 1_m, 1.5_in);
+  EXPECT_EQ(model->stopCount, 1);
+  EXPECT_EQ(controller->waitUntilSettledCalled, 0);
+
+  // The corners are cut by less than the lookahead, at speed
+  for (const Point &corner : {Point{1_m, 0_m}, Point{1_m, 1_m}}) {
+    const auto [distance, speed] = model->closestApproach(corner);
+    EXPECT_LT(distance, drive->getCurvedMotionSettings().lookahead);
+    EXPECT_GT(speed, 0.5);
+  }
+}
+
+TEST_F(DefaultOdomChassisControllerCurvedTest, DrivesThroughPointsBackwards) {
+  drive->driveThrough({{-1_m, 0_m}, {-1_m, -1_m}}, true);
+
+  expectNear(-1_m, -1_m, 1.5_in);
+  EXPECT_EQ(model->turnInPlaceCount, 0);
+  EXPECT_LT(model->closestApproach({-1_m, 0_m}).first, 12_in);
+  EXPECT_LT(model->closestApproach({-1_m, 0_m}).second, -0.5);
+}
+
+TEST_F(DefaultOdomChassisControllerCurvedTest, DrivesThroughOnePoint) {
+  drive->driveThrough({{1_m, 0.5_m}});
+
+  expectNear(1_m, 0.5_m, 1.5_in);
+  EXPECT_EQ(model->stopCount, 1);
+}
+
+TEST_F(DefaultOdomChassisControllerCurvedTest, DrivesThroughNoPoints) {
+  drive->driveThrough({});
+
+  EXPECT_EQ(model->commandCount, 0);
+  EXPECT_EQ(controller->stopCalled, 0);
+}
+
+TEST_F(DefaultOdomChassisControllerCurvedTest, DrivesThroughRepeatedPoints) {
+  drive->driveThrough({{0_m, 0_m}, {1_m, 0_m}, {1_m, 0_m}, {1_m, 1_m}});
+
+  expectNear(1_m, 1_m, 1.5_in);
+}
@@ -0,0 +1,96 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#include "okapi/api/control/util/diffDriveMpc.hpp"
+#include <cmath>
+#include <gtest/gtest.h>
+
+using namespace okapi;
+
+class DiffDriveMpcTest : public ::testing::Test {
+  protected:
+  DiffDriveMpc mpc{0.3_m, 1.5_mps};
+};
+
+TEST_F(DiffDriveMpcTest, InvalidParametersThrow) {
+  EXPECT_THROW(DiffDriveMpc(0_m, 1.5_mps), std::invalid_argument);
+  EXPECT_THROW(DiffDriveMpc(0.3_m, 0_mps), std::invalid_argument);
+
+  DiffDriveMpcParams params;
+  params.modelStep = 0_ms;
+  EXPECT_THROW(DiffDriveMpc(0.3_m, 1.5_mps, params), std::invalid_argument);
+
+  params = DiffDriveMpcParams{};
+  params.controlWeight = -1;
+  EXPECT_THROW(DiffDriveMpc(0.3_m, 1.5_mps, params), std::invalid_argument);
+}
+
+TEST_F(DiffDriveMpcTest, FollowsTheProfileWithoutError) {
+  const auto [left, right] = mpc.step(0, 0, 0, 1, 2);
+  EXPECT_NEAR(left, 1 - 2 * 0.15, 1e-9);
+  EXPECT_NEAR(right, 1 + 2 * 0.15, 1e-9);
+}
+
+TEST_F(DiffDriveMpcTest, SpeedsUpWhenBehind) {
+  const auto [left, right] = mpc.step(0.1, 0, 0, 1, 0);
+  EXPECT_GT(left, 1);
+  EXPECT_GT(right, 1);
+}
+
+TEST_F(DiffDriveMpcTest, TurnsTowardsTheProfile) {
+  // The profile is to the left of the robot
+  const auto [left, right] = mpc.step(0, 0.1, 0, 1, 0);
+  EXPECT_GT(right, left);
+}
+
+TEST_F(DiffDriveMpcTest, CorrectsWithinTheWheelLimits) {
+  // At full speed the outside wheel can't go faster, so the robot turns by slowing the inside one
+  const auto [left, right] = mpc.step(0, -0.1, 0, 1.5, 0);
+  EXPECT_DOUBLE_EQ(left, 1.5);
+  EXPECT_LT(right, 1.5);
+}
+
+TEST_F(DiffDriveMpcTest, ResetForgetsTheLastSolution) {
+  // Without a reset, the correction for the last error is where the next solve starts from
+  mpc.step(0.5, 0.5, 0.5, 1, 0);
+  const auto warm = mpc.step(0, 0, 0, 1, 0);
+  EXPECT_NE(warm.first, 1);
+
+  mpc.step(0.5, 0.5, 0.5, 1, 0);
+  mpc.reset();
+  const auto [left, right] = mpc.step(0, 0, 0, 1, 0);
+  EXPECT_DOUBLE_EQ(left, 1);
+  EXPECT_DOUBLE_EQ(right, 1);
+}
+
+TEST_F(DiffDriveMpcTest, BringsARobotBackOntoAStraightProfile) {
+  // The profile drives along the x axis at 1 m/s. The robot starts beside it, turned away.
+  double x = 0, y = -0.2, theta = -0.1;
+  const double dt = 0.01;
+  for (int i = 0; i < 300; i++) {
+    const double time = i * dt;
+
+    // The pose of the profile in the frame of the robot
+    const double dx = time - x;
+    const double dy = -y;
+    const double xError = std::cos(theta) * dx + std::sin(theta) * dy;
+    const double yError = -std::sin(theta) * dx + std::cos(theta) * dy;
+
+    const auto [left, right] = mpc.step(xError, yError, -theta, 1, 0);
+    const double v = (left + right) / 2;
+    const double w = (right - left) / 0.3;
+
+    EXPECT_LE(std::abs(left), 1.5);
+    EXPECT_LE(std::abs(right), 1.5);
+
+    x += v * std::cos(theta) * dt;
+    y += v * std::sin(theta) * dt;
+    theta += w * dt;
+  }
+
+  EXPECT_NEAR(x, 3, 0.02);
+  EXPECT_NEAR(y, 0, 0.02);
+  EXPECT_NEAR(theta, 0, 0.02);
+}
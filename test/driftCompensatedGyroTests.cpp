@@ -0,0 +1,142 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#include "okapi/api/device/rotarysensor/driftCompensatedGyro.hpp"
+#include "test/tests/api/implMocks.hpp"
+#include <gtest/gtest.h>
+
+using namespace okapi;
+
+class DriftCompensatedGyroTest : public ::testing::Test {
+  protected:
+  class SettableTimer : public AbstractTimer {
+    public:
+    explicit SettableTimer(const QTime &inow) : AbstractTimer(inow), now(inow) {
+    }
+
+    QTime millis() const override {
+      return now;
+    }
+
+    const QTime &now;
+  };
+
+  class DriftingGyro : public ContinuousRotarySensor {
+    public:
+    double get() const override {
+      return heading;
+    }
+
+    std::int32_t reset() override {
+      heading = 0;
+      return 1;
+    }
+
+    double controllerGet() override {
+      return get();
+    }
+
+    double heading{0};
+  };
+
+  void SetUp() override {
+    rawGyro = std::make_shared<DriftingGyro>();
+    gyro = std::make_unique<DriftCompensatedGyro>(
+      rawGyro,
+      createTimeUtil(Supplier<std::unique_ptr<AbstractTimer>>(
+        [this]() { return std::make_unique<SettableTimer>(now); })),
+      1_s);
+  }
+
+  /**
+   * Steps the gyro for a time while it drifts and turns at rates in units per second.
+   */
+  void run(const QTime &iduration, const double idrift, const double iturnRate = 0) {
+    const int steps = static_cast<int>((iduration / DriftCompensatedGyro::samplePeriod).getValue());
+    for (int i = 0; i < steps; i++) {
+      now += DriftCompensatedGyro::samplePeriod;
+      rawGyro->heading += (idrift + iturnRate) * DriftCompensatedGyro::samplePeriod.convert(second);
+      gyro->step();
+    }
+  }
+
+  QTime now{0_ms};
+
+  // A little longer than the calibration time, so rounding in the sum of the steps doesn't matter
+  static constexpr QTime calibrationRun = 1050_ms;
+  std::shared_ptr<DriftingGyro> rawGyro;
+  std::unique_ptr<DriftCompensatedGyro> gyro;
+};
+
+TEST_F(DriftCompensatedGyroTest, ErrorBeforeTheFirstRead) {
+  EXPECT_EQ(gyro->get(), OKAPI_PROS_ERR);
+  EXPECT_FALSE(gyro->isCalibrated());
+}
+
+TEST_F(DriftCompensatedGyroTest, CalibrationRemovesTheDrift) {
+  gyro->step();
+  run(calibrationRun, 5);
+
+  EXPECT_TRUE(gyro->isCalibrated());
+  EXPECT_NEAR(gyro->getBias(), 5, 1e-6);
+  EXPECT_NEAR(gyro->get(), 0, 1e-6);
+
+  run(10_s, 5);
+  EXPECT_NEAR(gyro->get(), 0, 1e-6);
+}
+
+TEST_F(DriftCompensatedGyroTest, TurnsAreKept) {
+  gyro->step();
+  run(calibrationRun, 5);
+
+  run(2_s, 5, 450);
+  EXPECT_NEAR(gyro->get(), 900, 1e-6);
+  EXPECT_NEAR(gyro->getBias(), 5, 1e-6);
+}
+
+TEST_F(DriftCompensatedGyroTest, MovingRestartsTheCalibration) {
+  gyro->step();
+  run(500_ms, 5);
+  run(500_ms, 5, 300);
+  EXPECT_FALSE(gyro->isCalibrated());
+
+  run(calibrationRun, 5);
+  EXPECT_TRUE(gyro->isCalibrated());
+  EXPECT_NEAR(gyro->getBias(), 5, 1e-6);
+}
+
+TEST_F(DriftCompensatedGyroTest, BiasFollowsTheDriftWhileStill) {
+  gyro->step();
+  run(calibrationRun, 5);
+
+  run(20_s, 8);
+  EXPECT_NEAR(gyro->getBias(), 8, 0.02);
+}
+
+TEST_F(DriftCompensatedGyroTest, StillSupplierOverridesTheRate) {
+  bool still = true;
+  gyro->setStillSupplier([&] { return still; });
+  gyro->step();
+  run(calibrationRun, 5);
+
+  // A slow turn looks like drift, but the supplier knows the robot is moving
+  still = false;
+  run(5_s, 5, 10);
+  EXPECT_NEAR(gyro->getBias(), 5, 1e-6);
+  EXPECT_NEAR(gyro->get(), 50, 1e-6);
+}
+
+TEST_F(DriftCompensatedGyroTest, ResetZeroesTheHeadingAndKeepsTheBias) {
+  gyro->step();
+  run(calibrationRun, 5);
+  run(1_s, 5, 100);
+
+  EXPECT_EQ(gyro->reset(), 1);
+  EXPECT_EQ(gyro->get(), 0);
+  gyro->step();
+  run(calibrationRun, 5);
+  EXPECT_NEAR(gyro->get(), 0, 1e-6);
+  EXPECT_NEAR(gyro->getBias(), 5, 1e-6);
+}
@@ -0,0 +1,76 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#include "okapi/api/util/fastTrig.hpp"
+#include <cmath>
+#include <gtest/gtest.h>
+#include <limits>
+
+using namespace okapi;
+
+// The bound documented on FastTrig
+constexpr double bound = 1e-10;
+
+TEST(FastTrigTest, SinAndCosStayInTheirBound) {
+  double worst = 0;
+  for (double x = -1e5; x < 1e5; x += 0.37) {
+    worst = std::max(worst, std::abs(FastTrig::sin(x) - std::sin(x)));
+    worst = std::max(worst, std::abs(FastTrig::cos(x) - std::cos(x)));
+  }
+  EXPECT_LT(worst, bound);
+}
+
+TEST(FastTrigTest, SinAndCosNearZeroAndTheQuadrantEdges) {
+  for (const double x : {0.0, 1e-12, -1e-12, 0.785398, 0.785399, 1.570796, 3.141593, -4.712389}) {
+    EXPECT_NEAR(FastTrig::sin(x), std::sin(x), bound) << x;
+    EXPECT_NEAR(FastTrig::cos(x), std::cos(x), bound) << x;
+  }
+
+  EXPECT_EQ(FastTrig::sin(0), 0);
+  EXPECT_EQ(FastTrig::cos(0), 1);
+}
+
+TEST(FastTrigTest, SincosMatchesSinAndCos) {
+  double s, c;
+  FastTrig::sincos(2.5, s, c);
+  EXPECT_EQ(s, FastTrig::sin(2.5));
+  EXPECT_EQ(c, FastTrig::cos(2.5));
+}
+
+TEST(FastTrigTest, Atan2StaysInItsBound) {
+  double worst = 0;
+  for (double a = -3.2; a < 3.2; a += 1e-4) {
+    for (const double r : {1e-6, 1.0, 1e6}) {
+      const double y = r * std::sin(a);
+      const double x = r * std::cos(a);
+      worst = std::max(worst, std::abs(FastTrig::atan2(y, x) - std::atan2(y, x)));
+    }
+  }
+  EXPECT_LT(worst, bound);
+}
+
+TEST(FastTrigTest, Atan2OnTheAxesMatchesTheStandardLibrary) {
+  for (const double y : {0.0, -0.0, 1.0, -1.0}) {
+    for (const double x : {0.0, -0.0, 1.0, -1.0}) {
+      EXPECT_NEAR(FastTrig::atan2(y, x), std::atan2(y, x), bound) << y << ", " << x;
+    }
+  }
+
+  EXPECT_TRUE(std::signbit(FastTrig::atan2(-0.0, 1)));
+}
+
+TEST(FastTrigTest, NonFiniteArgumentsGiveNaN) {
+  const double inf = std::numeric_limits<double>::infinity();
+  EXPECT_TRUE(std::isnan(FastTrig::sin(inf)));
+  EXPECT_TRUE(std::isnan(FastTrig::cos(-inf)));
+  EXPECT_TRUE(std::isnan(FastTrig::sin(std::nan(""))));
+  EXPECT_TRUE(std::isnan(FastTrig::atan2(std::nan(""), 1)));
+}
+
+TEST(FastTrigTest, TrigUsesTheStandardLibraryByDefault) {
+  EXPECT_FALSE(Trig::isFast);
+  EXPECT_EQ(Trig::sin(1.234), std::sin(1.234));
+  EXPECT_EQ(Trig::atan2(1, 2), std::atan2(1, 2));
+}
@@ -0,0 +1,144 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#include "okapi/api/control/util/motorFeedforward.hpp"
+#include "okapi/api/control/util/trapezoidProfile.hpp"
+#include <gtest/gtest.h>
+
+using namespace okapi;
+
+TEST(MotorFeedforwardTest, CalculateAddsEachTerm) {
+  const MotorFeedforward feedforward{0.1, 0.5, 0.2};
+  EXPECT_DOUBLE_EQ(feedforward.calculate(2, 3), 0.1 + 0.5 * 2 + 0.2 * 3);
+  EXPECT_DOUBLE_EQ(feedforward.calculate(-2, -3), -0.1 - 0.5 * 2 - 0.2 * 3);
+}
+
+TEST(MotorFeedforwardTest, StaticFrictionOnlyWhileMoving) {
+  const MotorFeedforward feedforward{0.1, 0.5, 0.2};
+  EXPECT_DOUBLE_EQ(feedforward.calculate(0), 0);
+  EXPECT_DOUBLE_EQ(feedforward.calculate(0, 1), 0.2);
+}
+
+TEST(MotorFeedforwardTest, IsEnabled) {
+  EXPECT_FALSE(MotorFeedforward{}.isEnabled());
+  EXPECT_TRUE((MotorFeedforward{0, 0, 0.1}.isEnabled()));
+}
+
+TEST(TrapezoidProfileTest, ReachesTheMaxVelocity) {
+  const TrapezoidProfile profile(4, 2, 1);
+
+  // 2 s to accelerate over 2, 0 s of cruise, 2 s to decelerate over 2
+  EXPECT_DOUBLE_EQ(profile.getDuration().convert(second), 4);
+
+  const auto accelerating = profile.sample(1_s);
+  EXPECT_DOUBLE_EQ(accelerating.position, 0.5);
+  EXPECT_DOUBLE_EQ(accelerating.velocity, 1);
+  EXPECT_DOUBLE_EQ(accelerating.acceleration, 1);
+
+  const auto decelerating = profile.sample(3_s);
+  EXPECT_DOUBLE_EQ(decelerating.position, 3.5);
+  EXPECT_DOUBLE_EQ(decelerating.velocity, 1);
+  EXPECT_DOUBLE_EQ(decelerating.acceleration, -1);
+}
+
+TEST(TrapezoidProfileTest, CruisesAtTheMaxVelocity) {
+  const TrapezoidProfile profile(10, 2, 2);
+
+  // 1 s to accelerate over 1, 4 s to cruise over 8, 1 s to decelerate over 1
+  EXPECT_DOUBLE_EQ(profile.getDuration().convert(second), 6);
+
+  const auto cruising = profile.sample(3_s);
+  EXPECT_DOUBLE_EQ(cruising.position, 5);
+  EXPECT_DOUBLE_EQ(cruising.velocity, 2);
+  EXPECT_DOUBLE_EQ(cruising.acceleration, 0);
+}
+
+TEST(TrapezoidProfileTest, ShortMovesNeverReachTheMaxVelocity) {
+  const TrapezoidProfile profile(1, 10, 1);
+
+  EXPECT_DOUBLE_EQ(profile.getDuration().convert(second), 2);
+  EXPECT_DOUBLE_EQ(profile.sample(1_s).position, 0.5);
+  EXPECT_DOUBLE_EQ(profile.sample(1_s).velocity, 1);
+}
+
+TEST(TrapezoidProfileTest, BackwardsMoves) {
+  const TrapezoidProfile profile(-10, 2, 2);
+
+  const auto cruising = profile.sample(3_s);
+  EXPECT_DOUBLE_EQ(cruising.position, -5);
+  EXPECT_DOUBLE_EQ(cruising.velocity, -2);
+  EXPECT_DOUBLE_EQ(profile.sample(0.5_s).acceleration, -2);
+}
+
+TEST(TrapezoidProfileTest, RestsBeforeAndAfterTheMove) {
+  const TrapezoidProfile profile(10, 2, 2);
+
+  const auto before = profile.sample(-1_s);
+  EXPECT_DOUBLE_EQ(before.position, 0);
+  EXPECT_DOUBLE_EQ(before.velocity, 0);
+
+  const auto after = profile.sample(10_s);
+  EXPECT_DOUBLE_EQ(after.position, 10);
+  EXPECT_DOUBLE_EQ(after.velocity, 0);
+  EXPECT_DOUBLE_EQ(after.acceleration, 0);
+}
+
+TEST(TrapezoidProfileTest, ZeroDistance) {
+  const TrapezoidProfile profile(0, 2, 2);
+
+  EXPECT_DOUBLE_EQ(profile.getDuration().convert(second), 0);
+  EXPECT_DOUBLE_EQ(profile.sample(1_s).position, 0);
+}
+
+TEST(TrapezoidProfileTest, InvalidLimitsThrow) {
+  EXPECT_THROW(TrapezoidProfile(1, 0, 1), std::invalid_argument);
+  EXPECT_THROW(TrapezoidProfile(1, 1, -1), std::invalid_argument);
+  EXPECT_THROW(TrapezoidProfile(1, 1, 1, 0), std::invalid_argument);
+}
+
+TEST(TrapezoidProfileTest, SCurveRampsTheAcceleration) {
+  const TrapezoidProfile profile(10, 2, 2, 4);
+
+  // 0.5 s of jerk up to 2, 0.5 s at 2, 0.5 s of jerk down to 0, which covers 1.5
+  EXPECT_DOUBLE_EQ(profile.sample(0.25_s).acceleration, 1);
+  EXPECT_DOUBLE_EQ(profile.sample(0.75_s).acceleration, 2);
+  EXPECT_DOUBLE_EQ(profile.sample(1.25_s).acceleration, 1);
+
+  const auto cruising = profile.sample(1.5_s);
+  EXPECT_DOUBLE_EQ(cruising.position, 1.5);
+  EXPECT_DOUBLE_EQ(cruising.velocity, 2);
+  EXPECT_DOUBLE_EQ(cruising.acceleration, 0);
+
+  // 3.5 s of cruise over the other 7
+  EXPECT_DOUBLE_EQ(profile.getDuration().convert(second), 6.5);
+  EXPECT_DOUBLE_EQ(profile.sample(6.25_s).acceleration, -1);
+  EXPECT_DOUBLE_EQ(profile.sample(6.5_s).position, 10);
+}
+
+TEST(TrapezoidProfileTest, SCurveIsContinuous) {
+  const TrapezoidProfile profile(3, 2, 2, 4);
+
+  TrapezoidProfile::State last = profile.sample(0_s);
+  for (QTime time = 10_ms; time <= profile.getDuration() + 10_ms; time += 10_ms) {
+    const auto state = profile.sample(time);
+    EXPECT_NEAR(state.velocity, last.velocity, 4 * 0.01 * 0.01 + 2 * 0.01);
+    EXPECT_NEAR(state.acceleration, last.acceleration, 4 * 0.01 + 1e-9);
+    EXPECT_GE(state.position, last.position);
+    last = state;
+  }
+
+  EXPECT_DOUBLE_EQ(last.position, 3);
+  EXPECT_DOUBLE_EQ(last.velocity, 0);
+}
+
+TEST(TrapezoidProfileTest, ShortSCurveNeverReachesTheMaxAcceleration) {
+  const TrapezoidProfile profile(0.125, 10, 10, 4);
+
+  // The jerk ramps the acceleration up to 1 and straight back down, 0.25 s each way
+  EXPECT_DOUBLE_EQ(profile.getDuration().convert(second), 1);
+  EXPECT_DOUBLE_EQ(profile.sample(0.25_s).acceleration, 1);
+  EXPECT_DOUBLE_EQ(profile.sample(0.5_s).position, 0.0625);
+  EXPECT_DOUBLE_EQ(profile.sample(0.5_s).velocity, 0.25);
+}
@@ -3,17 +3,33 @@
  * License, v. 2.0. If a copy of the MPL was not distributed with this
  * file, You can obtain one at http://mozilla.org/MPL/2.0/.
  */
+#include "okapi/api/filter/alphaBetaFilter.hpp"
+#include "okapi/api/filter/alphaBetaVelMath.hpp"
 #include "okapi/api/filter/averageFilter.hpp"
+#include "okapi/api/filter/biquadFilter.hpp"
 #include "okapi/api/filter/composableFilter.hpp"
+#include "okapi/api/filter/demaBank.hpp"
 #include "okapi/api/filter/demaFilter.hpp"
 #include "okapi/api/filter/ekfFilter.hpp"
+#include "okapi/api/filter/emaBank.hpp"
 #include "okapi/api/filter/emaFilter.hpp"
+#include "okapi/api/filter/filterBank.hpp"
+#include "okapi/api/filter/filterChain.hpp"
+#include "okapi/api/filter/kalmanFilter.hpp"
+#include "okapi/api/filter/leastSquaresVelMath.hpp"
 #include "okapi/api/filter/medianFilter.hpp"
 #include "okapi/api/filter/passthroughFilter.hpp"
 #include "okapi/api/filter/velMath.hpp"
 #include "okapi/api/util/abstractTimer.hpp"
 #include "test/tests/api/implMocks.hpp"
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <deque>
 #include <gtest/gtest.h>
+#include <limits>
+#include <random>
+#include <vector>
 
 using namespace okapi;
 
@@ -55,6 +71,35 @@ TEST(AverageFilterTest, OutputTest) {
   }
 }
 
+TEST(AverageFilterTest, RunningSumDoesNotDriftOverManySamples) {
+  AverageFilter<64> filter;
+
+  // Large and small samples mixed, which loses precision in an uncompensated running sum
+  for (int i = 0; i < 100000; i++) {
+    filter.filter(i % 2 == 0 ? 1e9 + 0.1 : 0.3);
+  }
+
+  for (int i = 0; i < 64; i++) {
+    filter.filter(0.1 * (i % 4));
+  }
+
+  EXPECT_NEAR(filter.getOutput(), 0.15, 1e-9);
+}
+
+TEST(AverageFilterTest, RecoversOnceANonFiniteSampleLeavesTheWindow) {
+  AverageFilter<3> filter;
+
+  filter.filter(std::numeric_limits<double>::quiet_NaN());
+  EXPECT_TRUE(std::isnan(filter.filter(1)));
+  EXPECT_TRUE(std::isnan(filter.filter(2)));
+  assertThatFilterAndFilterOutputAreEqual(filter, 3, 2);
+
+  filter.filter(std::numeric_limits<double>::infinity());
+  filter.filter(1);
+  filter.filter(1);
+  assertThatFilterAndFilterOutputAreEqual(filter, 1, 1);
+}
+
 TEST(MedianFilterTest, OutputTest) {
   MedianFilter<5> filter;
 
@@ -67,6 +112,77 @@ TEST(MedianFilterTest, OutputTest) {
   }
 }
 
+template <std::size_t n> void assertMedianFilterMatchesTheMedianOfTheWindow() {
+  MedianFilter<n> filter;
+  std::deque<double> window(n, 0.0);
+
+  std::mt19937 gen(42);
+  std::uniform_int_distribution<int> dist(-20, 20);
+  for (int i = 0; i < 1000; i++) {
+    const double reading = dist(gen);
+    window.pop_front();
+    window.push_back(reading);
+
+    std::vector<double> sortedWindow(window.begin(), window.end());
+    std::sort(sortedWindow.begin(), sortedWindow.end());
+    assertThatFilterAndFilterOutputAreEqual(filter, reading, sortedWindow[(n - 1) / 2]);
+  }
+}
+
+TEST(MedianFilterTest, MatchesTheMedianOfTheWindow) {
+  assertMedianFilterMatchesTheMedianOfTheWindow<8>();
+  assertMedianFilterMatchesTheMedianOfTheWindow<9>();
+}
+
+TEST(MedianFilterTest, SortingNetworksMatchTheMedianOfTheWindow) {
+  assertMedianFilterMatchesTheMedianOfTheWindow<3>();
+  assertMedianFilterMatchesTheMedianOfTheWindow<5>();
+  assertMedianFilterMatchesTheMedianOfTheWindow<7>();
+}
+
+TEST(MedianFilterTest, OrdersNaNReadingsAboveTheOthers) {
+  MedianFilter<3> filter;
+
+  filter.filter(1);
+  assertThatFilterAndFilterOutputAreEqual(filter, std::numeric_limits<double>::quiet_NaN(), 1);
+  assertThatFilterAndFilterOutputAreEqual(filter, 2, 2);
+  assertThatFilterAndFilterOutputAreEqual(filter, 3, 3);
+  assertThatFilterAndFilterOutputAreEqual(filter, 4, 3);
+}
+
+TEST(MedianFilterTest, SortedWindowOrdersNaNReadingsAboveTheOthers) {
+  MedianFilter<4> filter;
+
+  filter.filter(1);
+  filter.filter(std::numeric_limits<double>::quiet_NaN());
+  assertThatFilterAndFilterOutputAreEqual(filter, 2, 1);
+  assertThatFilterAndFilterOutputAreEqual(filter, 3, 2);
+  assertThatFilterAndFilterOutputAreEqual(filter, 4, 3);
+  assertThatFilterAndFilterOutputAreEqual(filter, 5, 3);
+}
+
+TEST(MedianFilterTest, SortingNetworksOrderNaNReadingsAboveTheOthers) {
+  const double nan = std::numeric_limits<double>::quiet_NaN();
+
+  MedianFilter<5> filter5;
+  assertThatFilterAndFilterOutputAreEqual(filter5, 1, 0);
+  assertThatFilterAndFilterOutputAreEqual(filter5, nan, 0);
+  assertThatFilterAndFilterOutputAreEqual(filter5, nan, 1);
+  assertThatFilterAndFilterOutputAreEqual(filter5, 2, 2);
+  assertThatFilterAndFilterOutputAreEqual(filter5, 3, 3);
+  assertThatFilterAndFilterOutputAreEqual(filter5, 4, 4);
+  assertThatFilterAndFilterOutputAreEqual(filter5, 5, 4);
+
+  MedianFilter<7> filter7;
+  assertThatFilterAndFilterOutputAreEqual(filter7, 1, 0);
+  assertThatFilterAndFilterOutputAreEqual(filter7, nan, 0);
+  assertThatFilterAndFilterOutputAreEqual(filter7, nan, 0);
+  assertThatFilterAndFilterOutputAreEqual(filter7, nan, 1);
+  assertThatFilterAndFilterOutputAreEqual(filter7, 2, 2);
+  assertThatFilterAndFilterOutputAreEqual(filter7, 3, 3);
+  assertThatFilterAndFilterOutputAreEqual(filter7, 4, 4);
+}
+
 TEST(EmaFilterTest, FloatingPointGainOutputTest) {
   EmaFilter filter(0.5);
 
@@ -130,6 +246,51 @@ TEST(EKFFilterTest, OutputTest) {
   assertThatFilterAndFilterOutputAreEqual(filter, 0, 0.0992);
 }
 
+TEST(KalmanFilterTest, OneDimensionalMatchesEKFFilter) {
+  EKFFilter ekf(0.0001, ipow(0.2, 2));
+  KalmanFilter<1> kalman;
+  const Matrix<1, 1> F{1}, Q{0.0001}, H{1}, R{ipow(0.2, 2)};
+
+  for (const double reading : {0.0, 0.5, -0.5, 0.5, 0.0}) {
+    kalman.predict(F, Q);
+    EXPECT_TRUE(kalman.update(Matrix<1, 1>{reading}, H, R));
+    EXPECT_NEAR(kalman.getState()(0, 0), ekf.filter(reading), 1e-9);
+  }
+}
+
+TEST(KalmanFilterTest, EstimatesVelocityFromPositions) {
+  // A constant velocity model: the state is the position and velocity, only the position is
+  // measured
+  const double dt = 0.01;
+  KalmanFilter<2> filter;
+  const Matrix<2, 2> F{1, dt, 0, 1};
+  const Matrix<2, 2> Q{1e-6, 0, 0, 1e-4};
+  const Matrix<1, 2> H{1, 0};
+  const Matrix<1, 1> R{1e-4};
+
+  for (int i = 1; i <= 200; i++) {
+    filter.predict(F, Q);
+    filter.update(Matrix<1, 1>{2.0 * i * dt}, H, R);
+  }
+
+  EXPECT_NEAR(filter.getState()(0, 0), 4, 1e-2);
+  EXPECT_NEAR(filter.getState()(1, 0), 2, 1e-1);
+  EXPECT_LT(filter.getCovariance()(1, 1), 1e-1);
+}
+
+TEST(KalmanFilterTest, MeasurementWithSingularCovarianceIsNotUsed) {
+  KalmanFilter<2> filter(Matrix<2, 1>{1, 2}, Matrix<2, 2>());
+  EXPECT_FALSE(filter.update(Matrix<1, 1>{5}, Matrix<1, 2>{1, 0}, Matrix<1, 1>{0}));
+  EXPECT_EQ(filter.getState(), (Matrix<2, 1>{1, 2}));
+}
+
+TEST(KalmanFilterTest, NonlinearPredictUsesThePredictedState) {
+  KalmanFilter<2> filter;
+  filter.predict(Matrix<2, 1>{3, 4}, Matrix<2, 2>::identity(), Matrix<2, 2>());
+  EXPECT_EQ(filter.getState(), (Matrix<2, 1>{3, 4}));
+  EXPECT_EQ(filter.getCovariance(), (Matrix<2, 2>::identity()));
+}
+
 void testComposableFilterFunctionality(ComposableFilter &filter) {
   assertThatFilterAndFilterOutputAreEqual(filter, 1, 0.1111);
   assertThatFilterAndFilterOutputAreEqual(filter, 2, 0.4444);
@@ -164,6 +325,184 @@ TEST(ComposableFilterTest, AddingAFilterIsEquivalentToCtorParam) {
   testComposableFilterFunctionality(filterWithAdd);
 }
 
+TEST(ComposableFilterTest, FilterBatchMatchesFilteringEachReading) {
+  ComposableFilter batched({std::make_shared<MedianFilter<5>>(), std::make_shared<EmaFilter>(0.3)});
+  ComposableFilter sequential(
+    {std::make_shared<MedianFilter<5>>(), std::make_shared<EmaFilter>(0.3)});
+
+  std::array<double, 12> readings{3, 1, 4, 1, 5, 9, 2, 6, 5, 3, 5, 8};
+  std::array<double, 12> out{};
+  batched.filterBatch(readings.data(), out.data(), readings.size());
+
+  for (std::size_t i = 0; i < readings.size(); i++) {
+    EXPECT_DOUBLE_EQ(out[i], sequential.filter(readings[i]));
+  }
+  EXPECT_DOUBLE_EQ(batched.getOutput(), sequential.getOutput());
+}
+
+TEST(ComposableFilterTest, FilterBatchWithNoFiltersOutputsZero) {
+  ComposableFilter filter({});
+
+  std::array<double, 2> out{1, 1};
+  filter.filterBatch(std::array<double, 2>{3, 4}.data(), out.data(), out.size());
+  EXPECT_EQ(out, (std::array<double, 2>{0, 0}));
+}
+
+TEST(FilterTest, FilterBatchCanFilterInPlace) {
+  AverageFilter<2> filter;
+
+  std::array<double, 3> buffer{2, 4, 6};
+  filter.filterBatch(buffer.data(), buffer.data(), buffer.size());
+  EXPECT_EQ(buffer, (std::array<double, 3>{1, 3, 5}));
+  EXPECT_DOUBLE_EQ(filter.getOutput(), 5);
+}
+
+TEST(FilterBankTest, FiltersEachChannelIndependently) {
+  FilterBank<AverageFilter<2>, 3> bank;
+
+  bank.filter({2, 4, 6});
+  EXPECT_EQ(bank.filter({0, 4, 10}), (std::array<double, 3>{1, 4, 8}));
+  EXPECT_EQ(bank.getOutput(), (std::array<double, 3>{1, 4, 8}));
+  EXPECT_DOUBLE_EQ(bank.get(2).getOutput(), 8);
+}
+
+TEST(FilterBankTest, ChannelsStartAsCopiesOfThePrototype) {
+  FilterBank<EmaFilter, 2> bank(EmaFilter(0.5));
+
+  std::array<double, 2> buffer{2, 4};
+  bank.filter(buffer.data(), buffer.data());
+  EXPECT_EQ(buffer, (std::array<double, 2>{1, 2}));
+  EXPECT_EQ(bank.size(), 2u);
+}
+
+TEST(FilterChainTest, MatchesTheEquivalentComposableFilter) {
+  FilterChain<MedianFilter<5>, EmaFilter> chain(MedianFilter<5>(), EmaFilter(0.3));
+  ComposableFilter composable(
+    {std::make_shared<MedianFilter<5>>(), std::make_shared<EmaFilter>(0.3)});
+
+  for (const double reading : {3, 1, 4, 1, 5, 9, 2, 6, 5, 3, 5, 8}) {
+    assertThatFilterAndFilterOutputAreEqual(chain, reading, composable.filter(reading));
+  }
+}
+
+TEST(FilterChainTest, FilterBatchMatchesFilteringEachReading) {
+  FilterChain<AverageFilter<2>, AverageFilter<2>> batched;
+  FilterChain<AverageFilter<2>, AverageFilter<2>> sequential;
+
+  std::array<double, 4> buffer{4, 8, 0, 4};
+  std::array<double, 4> readings = buffer;
+  batched.filterBatch(buffer.data(), buffer.data(), buffer.size());
+
+  for (std::size_t i = 0; i < readings.size(); i++) {
+    EXPECT_DOUBLE_EQ(buffer[i], sequential.filter(readings[i]));
+  }
+}
+
+TEST(FilterChainTest, StagesCanBeReconfigured) {
+  FilterChain<EmaFilter> chain(EmaFilter(1));
+  chain.getStage<0>().setGains(0.5);
+
+  assertThatFilterAndFilterOutputAreEqual(chain, 2, 1);
+}
+
+TEST(FilterChainTest, DropsIntoVelMath) {
+  VelMath velMath(360,
+                  std::make_unique<FilterChain<MedianFilter<3>, PassthroughFilter>>(),
+                  10_ms,
+                  std::make_unique<ConstantMockTimer>(10_ms));
+
+  velMath.step(0);
+  EXPECT_DOUBLE_EQ(velMath.step(3).convert(rpm), 0);
+  EXPECT_DOUBLE_EQ(velMath.step(6).convert(rpm), 50);
+}
+
+/**
+ * Filters a sine wave and returns the amplitude of the output once it has settled. The amplitude
+ * comes from the RMS, so the frequency must fit a whole number of periods in 2000 readings.
+ */
+double biquadGainAt(BiquadFilter ifilter,
+                    const QFrequency ifrequency,
+                    const QFrequency isampleRate) {
+  const double w = 2 * okapi::pi * (ifrequency / isampleRate).getValue();
+  double sumOfSquares = 0;
+  for (int i = 0; i < 4000; i++) {
+    const double out = ifilter.filter(std::sin(w * i));
+    if (i >= 2000) {
+      sumOfSquares += out * out;
+    }
+  }
+  return std::sqrt(2 * sumOfSquares / 2000);
+}
+
+TEST(BiquadFilterTest, LowPassPassesDCAndAttenuatesAboveTheCutoff) {
+  EXPECT_NEAR(biquadGainAt(BiquadFilter::lowPass(10_Hz, 100_Hz), 0.5_Hz, 100_Hz), 1, 0.01);
+  EXPECT_NEAR(biquadGainAt(BiquadFilter::lowPass(10_Hz, 100_Hz), 10_Hz, 100_Hz), M_SQRT1_2, 0.01);
+  EXPECT_LT(biquadGainAt(BiquadFilter::lowPass(10_Hz, 100_Hz), 40_Hz, 100_Hz), 0.05);
+}
+
+TEST(BiquadFilterTest, LowPassSettlesToAStep) {
+  auto filter = BiquadFilter::lowPass(10_Hz, 100_Hz);
+
+  for (int i = 0; i < 100; i++) {
+    filter.filter(5);
+  }
+  assertThatFilterAndFilterOutputAreEqual(filter, 5, 5);
+
+  filter.reset();
+  EXPECT_DOUBLE_EQ(filter.getOutput(), 0);
+  EXPECT_NEAR(filter.filter(0), 0, 1e-12);
+}
+
+TEST(BiquadFilterTest, HighPassBlocksDC) {
+  EXPECT_LT(biquadGainAt(BiquadFilter::highPass(10_Hz, 100_Hz), 0.5_Hz, 100_Hz), 0.01);
+  EXPECT_NEAR(biquadGainAt(BiquadFilter::highPass(10_Hz, 100_Hz), 10_Hz, 100_Hz), M_SQRT1_2, 0.01);
+}
+
+TEST(BiquadFilterTest, NotchRemovesTheCenterFrequency) {
+  EXPECT_LT(biquadGainAt(BiquadFilter::notch(20_Hz, 200_Hz, 5), 20_Hz, 200_Hz), 0.01);
+  EXPECT_NEAR(biquadGainAt(BiquadFilter::notch(20_Hz, 200_Hz, 5), 2_Hz, 200_Hz), 1, 0.01);
+}
+
+TEST(BiquadFilterTest, ButterworthDesignsAreThreeDecibelsDownAtTheCutoff) {
+  EXPECT_EQ(BiquadFilter::butterworthLowPass(4, 10_Hz, 100_Hz).getSections().size(), 2u);
+  EXPECT_EQ(BiquadFilter::butterworthLowPass(3, 10_Hz, 100_Hz).getSections().size(), 2u);
+
+  // Every order is 3 dB down at the cutoff
+  for (std::size_t order = 1; order <= 5; order++) {
+    EXPECT_NEAR(biquadGainAt(BiquadFilter::butterworthLowPass(order, 10_Hz, 100_Hz), 10_Hz, 100_Hz),
+                M_SQRT1_2,
+                0.01);
+    EXPECT_NEAR(
+      biquadGainAt(BiquadFilter::butterworthHighPass(order, 10_Hz, 100_Hz), 10_Hz, 100_Hz),
+      M_SQRT1_2,
+      0.01);
+  }
+
+  EXPECT_LT(biquadGainAt(BiquadFilter::butterworthLowPass(4, 10_Hz, 100_Hz), 30_Hz, 100_Hz),
+            biquadGainAt(BiquadFilter::butterworthLowPass(2, 10_Hz, 100_Hz), 30_Hz, 100_Hz));
+}
+
+TEST(BiquadFilterTest, FilterBatchMatchesFilteringEachReading) {
+  auto batched = BiquadFilter::butterworthLowPass(3, 10_Hz, 100_Hz);
+  auto sequential = BiquadFilter::butterworthLowPass(3, 10_Hz, 100_Hz);
+
+  std::array<double, 6> buffer{1, 2, 3, 3, 2, 1};
+  std::array<double, 6> readings = buffer;
+  batched.filterBatch(buffer.data(), buffer.data(), buffer.size());
+
+  for (std::size_t i = 0; i < readings.size(); i++) {
+    EXPECT_DOUBLE_EQ(buffer[i], sequential.filter(readings[i]));
+  }
+}
+
+TEST(BiquadFilterTest, InvalidDesignsThrow) {
+  EXPECT_THROW(BiquadFilter({}), std::invalid_argument);
+  EXPECT_THROW(BiquadFilter::lowPass(50_Hz, 100_Hz), std::invalid_argument);
+  EXPECT_THROW(BiquadFilter::lowPass(0_Hz, 100_Hz), std::invalid_argument);
+  EXPECT_THROW(BiquadFilter::highPass(10_Hz, 100_Hz, 0), std::invalid_argument);
+  EXPECT_THROW(BiquadFilter::butterworthLowPass(0, 10_Hz, 100_Hz), std::invalid_argument);
+}
+
 TEST(PassthroughFilterTest, OutputTest) {
   PassthroughFilter filter;
 
@@ -232,3 +571,285 @@ TEST(VelMathTest, VelEqualToZeroWithoutStep) {
   EXPECT_EQ(velMath.getVelocity().convert(rpm), 0);
   EXPECT_EQ(velMath.getAccel().convert(rpm / second), 0);
 }
+
+TEST(LeastSquaresVelMathTest, ConstantVelocityIsExact) {
+  LeastSquaresVelMath velMath(360, 5, 10_ms, std::make_unique<ConstantMockTimer>(10_ms));
+
+  // 6 ticks every 10 ms is 100 rpm
+  for (int i = 0; i < 10; i++) {
+    velMath.step(6 * i);
+  }
+
+  EXPECT_NEAR(velMath.getVelocity().convert(rpm), 100, 1e-9);
+  EXPECT_NEAR(velMath.getAccel().convert(rpm / second), 0, 1e-6);
+}
+
+TEST(LeastSquaresVelMathTest, ConstantAccelerationIsExact) {
+  LeastSquaresVelMath velMath(360, 7, 10_ms, std::make_unique<ConstantMockTimer>(10_ms));
+
+  // position = 0.5 * a * t^2 with a = 3600 ticks/s^2 = 600 rpm/s
+  for (int i = 0; i < 20; i++) {
+    const double t = i * 0.01;
+    velMath.step(0.5 * 3600 * t * t);
+  }
+
+  EXPECT_NEAR(velMath.getVelocity().convert(rpm), 600 * 0.19, 1e-6);
+  EXPECT_NEAR(velMath.getAccel().convert(rpm / second), 600, 1e-6);
+}
+
+TEST(LeastSquaresVelMathTest, UsesTheMeasuredTimeOfEachSample) {
+  auto timer = std::make_unique<ConstantMockTimer>(10_ms);
+  auto timerPtr = timer.get();
+  LeastSquaresVelMath velMath(360, 5, 0_ms, std::move(timer));
+
+  // 0.6 ticks per ms is 100 rpm, sampled with jitter
+  double time = 0;
+  for (const double dt : {10, 10, 13, 7, 10, 15, 5}) {
+    timerPtr->dtToReturn = dt * millisecond;
+    time += dt;
+    velMath.step(0.6 * time);
+  }
+
+  EXPECT_NEAR(velMath.getVelocity().convert(rpm), 100, 1e-9);
+}
+
+TEST(LeastSquaresVelMathTest, RejectsMoreNoiseThanDifferencing) {
+  LeastSquaresVelMath leastSquares(360, 9, 10_ms, std::make_unique<ConstantMockTimer>(10_ms));
+  VelMath differencing(
+    360, std::make_unique<PassthroughFilter>(), 10_ms, std::make_unique<ConstantMockTimer>(10_ms));
+
+  std::mt19937 gen(7);
+  std::normal_distribution<double> noise(0, 1);
+  double leastSquaresError = 0;
+  double differencingError = 0;
+  for (int i = 0; i < 500; i++) {
+    const double pos = 6 * i + noise(gen);
+    const double lsVel = leastSquares.step(pos).convert(rpm);
+    const double diffVel = differencing.step(pos).convert(rpm);
+    if (i >= 10) {
+      leastSquaresError += (lsVel - 100) * (lsVel - 100);
+      differencingError += (diffVel - 100) * (diffVel - 100);
+    }
+  }
+
+  EXPECT_LT(leastSquaresError, differencingError / 2);
+}
+
+TEST(LeastSquaresVelMathTest, FitsALineUntilTheWindowHasThreeSamples) {
+  LeastSquaresVelMath velMath(360, 5, 10_ms, std::make_unique<ConstantMockTimer>(10_ms));
+
+  EXPECT_EQ(velMath.step(0).convert(rpm), 0);
+  EXPECT_NEAR(velMath.step(6).convert(rpm), 100, 1e-9);
+
+  velMath.reset();
+  EXPECT_EQ(velMath.getVelocity().convert(rpm), 0);
+  EXPECT_EQ(velMath.step(100).convert(rpm), 0);
+}
+
+TEST(LeastSquaresVelMathTest, SmallWindowThrows) {
+  EXPECT_THROW(LeastSquaresVelMath(360, 2, 10_ms, std::make_unique<ConstantMockTimer>(10_ms)),
+               std::invalid_argument);
+}
+
+TEST(VelMathTest, TimestampedStepUsesTheTimeBetweenTimestamps) {
+  // The loop timer would say 10 ms, but the device measured the samples 20 ms apart
+  VelMath velMath(
+    360, std::make_unique<PassthroughFilter>(), 0_ms, std::make_unique<ConstantMockTimer>(10_ms));
+
+  EXPECT_EQ(velMath.step(100, 1000_ms).convert(rpm), 0);
+  EXPECT_NEAR(velMath.step(112, 1020_ms).convert(rpm), 100, 1e-9);
+  EXPECT_NEAR(velMath.step(118, 1030_ms).convert(rpm), 100, 1e-9);
+  EXPECT_NEAR(velMath.getAccel().convert(rpm / second), 0, 1e-9);
+}
+
+TEST(VelMathTest, TimestampedStepSkipsSamplesWhichHaveNotUpdated) {
+  VelMath velMath(
+    360, std::make_unique<PassthroughFilter>(), 5_ms, std::make_unique<ConstantMockTimer>(10_ms));
+
+  velMath.step(0, 1000_ms);
+  velMath.step(6, 1010_ms);
+  EXPECT_NEAR(velMath.step(6, 1010_ms).convert(rpm), 100, 1e-9);
+  EXPECT_NEAR(velMath.step(7, 1012_ms).convert(rpm), 100, 1e-9);
+  EXPECT_NEAR(velMath.step(12, 1020_ms).convert(rpm), 100, 1e-9);
+}
+
+TEST(VelMathTest, ZeroTimestampFallsBackToTheLoopTimer) {
+  VelMath velMath(
+    360, std::make_unique<PassthroughFilter>(), 0_ms, std::make_unique<ConstantMockTimer>(10_ms));
+
+  EXPECT_DOUBLE_EQ(velMath.step(6, 0_ms).convert(rpm), 100);
+}
+
+TEST(LeastSquaresVelMathTest, FitsAgainstDeviceTimestamps) {
+  LeastSquaresVelMath velMath(360, 5, 0_ms, std::make_unique<ConstantMockTimer>(10_ms));
+
+  // 0.6 ticks per ms is 100 rpm, measured at uneven times
+  for (const double time : {1000, 1010, 1023, 1030, 1040, 1055, 1060}) {
+    velMath.step(0.6 * time, time * millisecond);
+  }
+
+  EXPECT_NEAR(velMath.getVelocity().convert(rpm), 100, 1e-9);
+}
+
+TEST(AlphaBetaFilterTest, TracksARampWithoutLag) {
+  AlphaBetaFilter filter(0.5, 0.2, 10_ms);
+
+  // 3 units every 10 ms is 300 units per second
+  for (int i = 0; i < 200; i++) {
+    filter.filter(100 + 3 * i);
+  }
+
+  EXPECT_NEAR(filter.getOutput(), 100 + 3 * 199, 1e-6);
+  EXPECT_NEAR(filter.getVelocity(), 300, 1e-6);
+  EXPECT_EQ(filter.getAcceleration(), 0);
+}
+
+TEST(AlphaBetaFilterTest, FirstReadingInitializesThePosition) {
+  AlphaBetaFilter filter(0.1, 0.01, 10_ms);
+
+  assertThatFilterAndFilterOutputAreEqual(filter, 500, 500);
+  EXPECT_EQ(filter.getVelocity(), 0);
+
+  filter.reset();
+  assertThatFilterAndFilterOutputAreEqual(filter, -20, -20);
+}
+
+TEST(AlphaBetaFilterTest, GammaTracksConstantAcceleration) {
+  AlphaBetaFilter filter(0.5, 0.4, 10_ms, 0.1);
+
+  // position = 0.5 * 200 * t^2
+  for (int i = 0; i < 400; i++) {
+    const double t = i * 0.01;
+    filter.filter(100 * t * t);
+  }
+
+  EXPECT_NEAR(filter.getVelocity(), 200 * 3.99, 1e-6);
+  EXPECT_NEAR(filter.getAcceleration(), 200, 1e-6);
+}
+
+TEST(AlphaBetaFilterTest, UsesTheGivenTimeBetweenReadings) {
+  AlphaBetaFilter filter(0.5, 0.2, 10_ms);
+
+  double time = 0;
+  for (int i = 0; i < 200; i++) {
+    const double dt = i % 2 == 0 ? 5 : 15;
+    time += dt;
+    filter.filter(0.3 * time, dt * millisecond);
+  }
+
+  EXPECT_NEAR(filter.getVelocity(), 300, 1e-6);
+}
+
+TEST(AlphaBetaFilterTest, InvalidGainsThrow) {
+  EXPECT_THROW(AlphaBetaFilter(0, 0.1, 10_ms), std::invalid_argument);
+  EXPECT_THROW(AlphaBetaFilter(1.1, 0.1, 10_ms), std::invalid_argument);
+  EXPECT_THROW(AlphaBetaFilter(1, 2, 10_ms), std::invalid_argument);
+  EXPECT_THROW(AlphaBetaFilter(0.5, 0.1, 10_ms, -1), std::invalid_argument);
+  EXPECT_THROW(AlphaBetaFilter(0.5, 0.1, 0_ms), std::invalid_argument);
+
+  AlphaBetaFilter filter(0.5, 0.1, 10_ms);
+  EXPECT_THROW(filter.setGains(0.5, -0.1), std::invalid_argument);
+}
+
+TEST(AlphaBetaVelMathTest, TracksAConstantVelocity) {
+  AlphaBetaVelMath velMath(
+    360, 0.5, 0.2, 0, 10_ms, std::make_unique<ConstantMockTimer>(10_ms));
+
+  // 6 ticks every 10 ms is 100 rpm
+  for (int i = 0; i < 200; i++) {
+    velMath.step(6 * i);
+  }
+
+  EXPECT_NEAR(velMath.getVelocity().convert(rpm), 100, 1e-6);
+  EXPECT_NEAR(velMath.getAccel().convert(rpm / second), 0, 1e-3);
+}
+
+TEST(AlphaBetaVelMathTest, RejectsMoreNoiseThanDifferencing) {
+  AlphaBetaVelMath alphaBeta(
+    360, 0.3, 0.05, 0, 10_ms, std::make_unique<ConstantMockTimer>(10_ms));
+  VelMath differencing(
+    360, std::make_unique<PassthroughFilter>(), 10_ms, std::make_unique<ConstantMockTimer>(10_ms));
+
+  std::mt19937 gen(11);
+  std::normal_distribution<double> noise(0, 1);
+  double alphaBetaError = 0;
+  double differencingError = 0;
+  for (int i = 0; i < 1000; i++) {
+    const double pos = 6 * i + noise(gen);
+    const double abVel = alphaBeta.step(pos).convert(rpm);
+    const double diffVel = differencing.step(pos).convert(rpm);
+    if (i >= 200) {
+      alphaBetaError += (abVel - 100) * (abVel - 100);
+      differencingError += (diffVel - 100) * (diffVel - 100);
+    }
+  }
+
+  EXPECT_LT(alphaBetaError, differencingError / 4);
+}
+
+TEST(EmaBankTest, EachChannelMatchesAnEmaFilter) {
+  EmaBank<3> bank(0.3);
+  std::array<EmaFilter, 3> filters{EmaFilter(0.3), EmaFilter(0.3), EmaFilter(0.3)};
+
+  for (const double reading : {3, 1, 4, 1, 5, 9, 2, 6}) {
+    const std::array<double, 3> readings{reading, -2 * reading, reading + 10};
+    const auto out = bank.filter(readings);
+    for (std::size_t i = 0; i < 3; i++) {
+      EXPECT_DOUBLE_EQ(out[i], filters[i].filter(readings[i]));
+      EXPECT_DOUBLE_EQ(bank.getOutput(i), filters[i].getOutput());
+    }
+  }
+}
+
+TEST(EmaBankTest, SetGainsAndReset) {
+  EmaBank<2> bank(0.5);
+
+  std::array<double, 2> buffer{2, 4};
+  bank.filter(buffer.data(), buffer.data());
+  EXPECT_EQ(buffer, (std::array<double, 2>{1, 2}));
+
+  bank.setGains(1);
+  EXPECT_EQ(bank.filter({7, 8}), (std::array<double, 2>{7, 8}));
+
+  bank.reset();
+  EXPECT_EQ(bank.getOutput(), (std::array<double, 2>{0, 0}));
+  EXPECT_EQ(bank.size(), 2u);
+}
+
+TEST(DemaBankTest, EachChannelMatchesADemaFilter) {
+  DemaBank<3> bank(0.3, 0.1);
+  std::array<DemaFilter, 3> filters{
+    DemaFilter(0.3, 0.1), DemaFilter(0.3, 0.1), DemaFilter(0.3, 0.1)};
+
+  for (const double reading : {3, 1, 4, 1, 5, 9, 2, 6}) {
+    const std::array<double, 3> readings{reading, -2 * reading, reading + 10};
+    const auto out = bank.filter(readings);
+    for (std::size_t i = 0; i < 3; i++) {
+      EXPECT_DOUBLE_EQ(out[i], filters[i].filter(readings[i]));
+      EXPECT_DOUBLE_EQ(bank.getOutput(i), filters[i].getOutput());
+    }
+  }
+
+  bank.reset();
+  EXPECT_EQ(bank.getOutput(), (std::array<double, 3>{0, 0, 0}));
+}
+
+TEST(EmaBankTest, FloatChannelsMatchAnEmaFilter) {
+  EmaBank<4, float> bank(0.3f);
+  EmaFilter filter(0.3);
+
+  for (const double reading : {3, 1, 4, 1, 5, 9, 2, 6}) {
+    const auto out = bank.filter({static_cast<float>(reading), 0, 0, 0});
+    EXPECT_NEAR(out[0], filter.filter(reading), 1e-5);
+  }
+}
+
+TEST(DemaBankTest, FloatChannelsMatchADemaFilter) {
+  DemaBank<4, float> bank(0.3f, 0.1f);
+  DemaFilter filter(0.3, 0.1);
+
+  for (const double reading : {3, 1, 4, 1, 5, 9, 2, 6}) {
+    const auto out = bank.filter({static_cast<float>(reading), 0, 0, 0});
+    EXPECT_NEAR(out[0], filter.filter(reading), 1e-5);
+  }
+}
@@ -0,0 +1,197 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#include "okapi/api/control/util/loopTimingRecorder.hpp"
+#include "okapi/api/device/motor/motorHealthMonitor.hpp"
+#include "okapi/api/odometry/twoEncoderOdometry.hpp"
+#include "okapi/api/util/flightRecorder.hpp"
+#include "test/tests/api/implMocks.hpp"
+#include <gtest/gtest.h>
+#include <memory>
+#include <sstream>
+#include <string>
+
+using namespace okapi;
+
+/**
+ * A timer which only moves when it is told to.
+ */
+class SteppedTimer : public AbstractTimer {
+  public:
+  explicit SteppedTimer(const QTime &inow) : AbstractTimer(0_ms), now(inow) {
+  }
+
+  QTime millis() const override {
+    return now;
+  }
+
+  const QTime &now;
+};
+
+/**
+ * Writes the events to a buffer instead of the SD card.
+ */
+class MockFlightRecorder : public FlightRecorder {
+  public:
+  using FlightRecorder::FlightRecorder;
+
+  std::unique_ptr<std::ostream> openOutput(const std::string &ifileName) override {
+    openedFile = ifileName;
+    flushCount++;
+    output.str("");
+    return std::make_unique<std::ostream>(&output);
+  }
+
+  std::string openedFile;
+  std::stringbuf output;
+  int flushCount{0};
+};
+
+class FlightRecorderTest : public ::testing::Test {
+  protected:
+  void TearDown() override {
+    FlightRecorder::setDefault(nullptr);
+  }
+
+  std::shared_ptr<MockFlightRecorder> makeRecorder(const std::size_t icapacity = 4) {
+    return std::make_shared<MockFlightRecorder>(
+      std::make_unique<SteppedTimer>(now), icapacity, "/usd/test.csv");
+  }
+
+  QTime now{0_ms};
+};
+
+TEST_F(FlightRecorderTest, KeepsTheNewestEventsOldestFirst) {
+  auto recorder = makeRecorder(3);
+  for (int i = 0; i < 5; i++) {
+    now = i * 10_ms;
+    recorder->record(FlightEventType::user, "test", i);
+  }
+
+  const auto events = recorder->getEvents();
+  ASSERT_EQ(events.size(), 3u);
+  for (std::size_t i = 0; i < events.size(); i++) {
+    EXPECT_EQ(events[i].code, static_cast<std::int32_t>(i + 2));
+    EXPECT_EQ(events[i].time, (i + 2) * 10);
+  }
+  EXPECT_EQ(recorder->getRecordedCount(), 5u);
+}
+
+TEST_F(FlightRecorderTest, GetEventsOnlyLooksBackTheWindow) {
+  auto recorder = makeRecorder();
+  recorder->record(FlightEventType::user, "test", 0);
+  now = 500_ms;
+  recorder->record(FlightEventType::user, "test", 1);
+  now = 1000_ms;
+  recorder->record(FlightEventType::user, "test", 2);
+
+  const auto events = recorder->getEvents(600_ms);
+  ASSERT_EQ(events.size(), 2u);
+  EXPECT_EQ(events[0].code, 1);
+  EXPECT_EQ(events[1].code, 2);
+}
+
+TEST_F(FlightRecorderTest, FlushWritesCsv) {
+  auto recorder = makeRecorder();
+  now = 20_ms;
+  recorder->record(FlightEventType::motorFault, "MotorHealthMonitor", 1, 4);
+  recorder->record(FlightEventType::loopOverrun, "AsyncWrapper", 0, 12.5);
+
+  EXPECT_TRUE(recorder->flush());
+  EXPECT_EQ(recorder->openedFile, "/usd/test.csv");
+  EXPECT_EQ(recorder->output.str(),
+            "time,type,source,code,value\n"
+            "20,motorFault,MotorHealthMonitor,1,4\n"
+            "20,loopOverrun,AsyncWrapper,0,12.5\n");
+}
+
+TEST_F(FlightRecorderTest, FlushesOnAFaultOnlyWhenEnabled) {
+  auto recorder = makeRecorder();
+  recorder->record(FlightEventType::motorFault, "test");
+  EXPECT_EQ(recorder->flushCount, 0);
+
+  recorder->setFlushOnFault(true);
+  recorder->record(FlightEventType::loopOverrun, "test");
+  EXPECT_EQ(recorder->flushCount, 0);
+  recorder->record(FlightEventType::motorFault, "test");
+  EXPECT_EQ(recorder->flushCount, 1);
+}
+
+TEST_F(FlightRecorderTest, RecordDefaultDoesNothingWithoutADefault) {
+  auto recorder = makeRecorder();
+  FlightRecorder::recordDefault(FlightEventType::user, "test");
+  EXPECT_EQ(recorder->getRecordedCount(), 0u);
+
+  FlightRecorder::setDefault(recorder);
+  EXPECT_EQ(FlightRecorder::getDefault(), recorder);
+  FlightRecorder::recordDefault(FlightEventType::user, "test");
+  EXPECT_EQ(recorder->getRecordedCount(), 1u);
+
+  FlightRecorder::setDefault(nullptr);
+  FlightRecorder::recordDefault(FlightEventType::user, "test");
+  EXPECT_EQ(recorder->getRecordedCount(), 1u);
+}
+
+TEST_F(FlightRecorderTest, RecordsLoopOverruns) {
+  auto recorder = makeRecorder();
+  FlightRecorder::setDefault(recorder);
+
+  LoopTimingRecorder loopTiming("loop");
+  loopTiming.record(10_ms, 10_ms);
+  loopTiming.record(25_ms, 10_ms);
+
+  const auto events = recorder->getEvents();
+  ASSERT_EQ(events.size(), 1u);
+  EXPECT_EQ(events[0].type, FlightEventType::loopOverrun);
+  EXPECT_STREQ(events[0].source, "loop");
+  EXPECT_DOUBLE_EQ(events[0].value, 25);
+}
+
+TEST_F(FlightRecorderTest, RecordsOdometryRejections) {
+  auto recorder = makeRecorder();
+  FlightRecorder::setDefault(recorder);
+
+  auto model = std::make_shared<MockSkidSteerModel>();
+  TwoEncoderOdometry odom(createConstantTimeUtil(10_ms), model, ChassisScales({4_in, 10_in}, 360));
+  model->setSensorVals(1e+9, 0);
+  odom.step();
+
+  const auto events = recorder->getEvents();
+  ASSERT_EQ(events.size(), 1u);
+  EXPECT_EQ(events[0].type, FlightEventType::odometryRejected);
+  EXPECT_STREQ(events[0].source, "TwoEncoderOdometry");
+  EXPECT_DOUBLE_EQ(events[0].value, 1e+9);
+}
+
+TEST_F(FlightRecorderTest, RecordsNewMotorFaults) {
+  auto recorder = makeRecorder();
+  FlightRecorder::setDefault(recorder);
+
+  class FaultMockMotor : public MockMotor {
+    public:
+    std::uint32_t getFaults() override {
+      return faults;
+    }
+
+    std::uint32_t faults{0};
+  };
+
+  MotorHealthMonitor monitor(createTimeUtil());
+  auto motor = std::make_shared<FaultMockMotor>();
+  monitor.addMotor(std::make_shared<MockMotor>());
+  monitor.addMotor(motor);
+  monitor.step();
+  EXPECT_EQ(recorder->getRecordedCount(), 0u);
+
+  motor->faults = 0b0100;
+  monitor.step();
+  monitor.step();
+
+  const auto events = recorder->getEvents();
+  ASSERT_EQ(events.size(), 1u);
+  EXPECT_EQ(events[0].type, FlightEventType::motorFault);
+  EXPECT_EQ(events[0].code, 1);
+  EXPECT_DOUBLE_EQ(events[0].value, 0b0100);
+}
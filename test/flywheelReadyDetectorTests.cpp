@@ -0,0 +1,66 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#include "okapi/api/control/util/flywheelReadyDetector.hpp"
+#include <gtest/gtest.h>
+
+using namespace okapi;
+
+TEST(FlywheelReadyDetectorTest, ReadyOnceTheWindowIsSteadyAtTarget) {
+  FlywheelReadyDetector<5> detector(20, 5);
+
+  for (int i = 0; i < 4; i++) {
+    EXPECT_FALSE(detector.step(3000, 3000));
+  }
+  EXPECT_TRUE(detector.step(3000, 3000));
+  EXPECT_DOUBLE_EQ(detector.getMean(), 3000);
+  EXPECT_DOUBLE_EQ(detector.getStdDev(), 0);
+}
+
+TEST(FlywheelReadyDetectorTest, NotReadyWhileOscillatingAroundTarget) {
+  FlywheelReadyDetector<4> detector(20, 5);
+
+  // Every sample is within tolerance and the mean is on target, but the velocity is not steady
+  for (int i = 0; i < 8; i++) {
+    EXPECT_FALSE(detector.step(i % 2 == 0 ? 2985 : 3015, 3000));
+  }
+  EXPECT_DOUBLE_EQ(detector.getMean(), 3000);
+  EXPECT_NEAR(detector.getStdDev(), 15, 1e-9);
+}
+
+TEST(FlywheelReadyDetectorTest, ChangingTheTargetClearsTheWindow) {
+  FlywheelReadyDetector<3> detector(20, 5);
+  for (int i = 0; i < 3; i++) {
+    detector.step(3000, 3000);
+  }
+  EXPECT_TRUE(detector.isReady());
+
+  EXPECT_FALSE(detector.step(3000, 3005));
+}
+
+TEST(FlywheelReadyDetectorTest, PredictsWhenARecoveringFlywheelIsWithinTolerance) {
+  FlywheelReadyDetector<4> detector(20, 5, 10_ms);
+
+  // Recovering from a shot at 10 rpm per sample, ending 50 rpm below the target
+  for (double velocity = 2900; velocity <= 2950; velocity += 10) {
+    detector.step(velocity, 3000);
+  }
+
+  EXPECT_FALSE(detector.isReady());
+  ASSERT_TRUE(detector.getTimeUntilReady());
+  EXPECT_NEAR(detector.getTimeUntilReady()->convert(millisecond), 30, 1e-9);
+  EXPECT_TRUE(detector.isReadyWithin(30_ms));
+  EXPECT_FALSE(detector.isReadyWithin(20_ms));
+}
+
+TEST(FlywheelReadyDetectorTest, NoPredictionWhenMovingAwayFromTarget) {
+  FlywheelReadyDetector<4> detector(20, 5);
+  for (double velocity = 2950; velocity >= 2900; velocity -= 10) {
+    detector.step(velocity, 3000);
+  }
+
+  EXPECT_FALSE(detector.getTimeUntilReady());
+  EXPECT_FALSE(detector.isReadyWithin(1000_ms));
+}
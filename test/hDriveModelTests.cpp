@@ -139,6 +139,16 @@ TEST_F(HDriveModelTest, RightBoundsInput) {
   assertLeftAndRightMotorsLastVelocity(0, 127);
 }
 
+TEST_F(HDriveModelTest, MiddleVoltageHalfPower) {
+  model.middleVoltage(0.5);
+  EXPECT_EQ(middleMotor->lastVoltage, 6000);
+}
+
+TEST_F(HDriveModelTest, MiddleVoltageBoundsInput) {
+  model.middleVoltage(-10);
+  EXPECT_EQ(middleMotor->lastVoltage, -12000);
+}
+
 TEST_F(HDriveModelTest, TankHalfPower) {
   model.tank(0.5, 0.5);
 
@@ -464,3 +474,15 @@ TEST_F(HDriveModelTest, SetMaxVelocityLessThan0) {
   model.setMaxVelocity(-1);
   EXPECT_EQ(model.getMaxVelocity(), 0);
 }
+
+TEST_F(HDriveModelTest, ApplyCommandsVoltage) {
+  model.applyCommands({WheelCommands::outputMode::voltage, {0.5, -0.25, 1}});
+  assertLeftAndRightMotorsLastVoltage(6000, -3000);
+  EXPECT_EQ(middleMotor->lastVoltage, 12000);
+}
+
+TEST_F(HDriveModelTest, ApplyCommandsVelocityBoundsInput) {
+  model.applyCommands({WheelCommands::outputMode::velocity, {2, -0.5, -3}});
+  assertLeftAndRightMotorsLastVelocity(127, -63);
+  EXPECT_EQ(middleMotor->lastVelocity, -127);
+}
@@ -0,0 +1,114 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#include "okapi/api/chassis/model/threeEncoderXDriveModel.hpp"
+#include "okapi/api/odometry/holonomicOdometry.hpp"
+#include "okapi/api/odometry/odomMath.hpp"
+#include "test/tests/api/implMocks.hpp"
+#include <gtest/gtest.h>
+#include <memory>
+
+using namespace okapi;
+
+class MockThreeEncoderXDriveModel : public ThreeEncoderXDriveModel {
+  public:
+  MockThreeEncoderXDriveModel()
+    : ThreeEncoderXDriveModel(std::make_shared<MockMotor>(),
+                              std::make_shared<MockMotor>(),
+                              std::make_shared<MockMotor>(),
+                              std::make_shared<MockMotor>(),
+                              std::make_shared<MockMotor>()->getEncoder(),
+                              std::make_shared<MockMotor>()->getEncoder(),
+                              std::make_shared<MockMotor>()->getEncoder(),
+                              toUnderlyingType(AbstractMotor::gearset::green),
+                              v5MotorMaxVoltage) {
+  }
+
+  std::size_t getSensorSamples(SensorValues &ovalues,
+                               SensorTimestamps &otimestamps) const override {
+    ovalues = {leftEnc, rightEnc, middleEnc};
+    otimestamps.fill(0);
+    return 3;
+  }
+
+  void setSensorVals(std::int32_t left, std::int32_t right, std::int32_t middle) {
+    leftEnc = left;
+    rightEnc = right;
+    middleEnc = middle;
+  }
+
+  std::int32_t leftEnc{0};
+  std::int32_t rightEnc{0};
+  std::int32_t middleEnc{0};
+};
+
+class HolonomicOdometryTest : public ::testing::Test {
+  protected:
+  void SetUp() override {
+    model = std::make_shared<MockThreeEncoderXDriveModel>();
+    odom = std::make_unique<HolonomicOdometry>(createConstantTimeUtil(10_ms), model, scales);
+  }
+
+  QLength distance(const int ticks) const {
+    return ticks / 36000.0 * 1_pi * wheelDiam;
+  }
+
+  QLength wheelDiam = 2.75_in;
+  QLength wheelTrack = 10_in;
+  // Rotation sensors count in centidegrees
+  ChassisScales scales{{wheelDiam, wheelTrack, wheelTrack / 2, wheelDiam}, 36000};
+  std::shared_ptr<MockThreeEncoderXDriveModel> model;
+  std::unique_ptr<HolonomicOdometry> odom;
+};
+
+TEST_F(HolonomicOdometryTest, StrafesAtSpeed) {
+  // About 2 m/s, which ThreeEncoderOdometry skips as a glitch
+  model->setSensorVals(0, 0, 3300);
+  odom->step();
+  assertOdomStateEquals(odom.get(), 0_m, distance(3300), 0_deg);
+  EXPECT_NEAR(odom->getStrafeVelocity().convert(mps), (distance(3300) / 10_ms).convert(mps), 1e-9);
+  EXPECT_NEAR(odom->getForwardVelocity().convert(mps), 0, 1e-9);
+
+  ThreeEncoderOdometry threeEncoderOdom(createConstantTimeUtil(10_ms), model, scales);
+  threeEncoderOdom.step();
+  model->setSensorVals(0, 0, 6600);
+  threeEncoderOdom.step();
+  assertOdomStateEquals(&threeEncoderOdom, 0_m, 0_m, 0_deg);
+}
+
+TEST_F(HolonomicOdometryTest, TurningInPlaceDoesNotStrafe) {
+  // The middle wheel rolls back by its distance from the center times the turn
+  model->setSensorVals(1000, -1000, -1000);
+  odom->step();
+  const QAngle turned = 2 * distance(1000) / wheelTrack * radian;
+  assertOdomStateEquals(odom.get(), 0_m, 0_m, turned);
+  EXPECT_NEAR(odom->getStrafeVelocity().convert(mps), 0, 1e-9);
+  EXPECT_NEAR(odom->getAngularVelocity().convert(radps), (turned / 10_ms).convert(radps), 1e-9);
+}
+
+TEST_F(HolonomicOdometryTest, StrafingWhileTurningFollowsTheExponentialMap) {
+  model->setSensorVals(1000, -1000, 2000);
+  odom->step();
+
+  const QAngle turned = 2 * distance(1000) / wheelTrack * radian;
+  const QLength strafe = distance(2000) + turned.convert(radian) * wheelTrack / 2;
+  const OdomState expected = OdomMath::integrateExponentialMap(0_m, strafe, turned, 0_deg);
+  assertOdomStateEquals(odom.get(), expected.x, expected.y, turned);
+}
+
+TEST_F(HolonomicOdometryTest, SkipsAStepFasterThanTheMaximumSpeed) {
+  model->setSensorVals(0, 0, 3300);
+  odom->step();
+
+  // 50 m/s
+  model->setSensorVals(0, 0, 3300 + 82000);
+  odom->step();
+  assertOdomStateEquals(odom.get(), 0_m, distance(3300), 0_deg);
+}
+
+TEST_F(HolonomicOdometryTest, ConstructWithNonPositiveMaxSpeedThrows) {
+  EXPECT_THROW(HolonomicOdometry(createConstantTimeUtil(10_ms), model, scales, 0_mps),
+               std::invalid_argument);
+}
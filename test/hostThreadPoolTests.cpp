@@ -0,0 +1,87 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#include "okapi/api/util/hostThreadPool.hpp"
+#include <gtest/gtest.h>
+#include <set>
+#include <stdexcept>
+
+using namespace okapi;
+
+TEST(HostThreadPoolTest, RunsEveryIndexOnce) {
+  HostThreadPool pool(3);
+  std::vector<std::atomic<int>> runs(100);
+
+  pool.runAll(runs.size(), [&](std::size_t i) { runs[i]++; });
+
+  for (const auto &count : runs) {
+    EXPECT_EQ(count.load(), 1);
+  }
+}
+
+TEST(HostThreadPoolTest, ZeroWorkersRunsOnTheCallingThread) {
+  HostThreadPool pool(0);
+  EXPECT_EQ(pool.getWorkerCount(), 0u);
+
+  std::set<std::thread::id> threads;
+  pool.runAll(10, [&](std::size_t) { threads.insert(std::this_thread::get_id()); });
+
+  EXPECT_EQ(threads, std::set<std::thread::id>{std::this_thread::get_id()});
+}
+
+TEST(HostThreadPoolTest, JobsAreSpreadAcrossTheWorkers) {
+  HostThreadPool pool(2);
+  std::mutex mutex;
+  std::set<std::thread::id> threads;
+  std::atomic<int> started{0};
+
+  // Every job waits for the others to start, so all three threads must take one
+  pool.runAll(3, [&](std::size_t) {
+    {
+      std::scoped_lock lock(mutex);
+      threads.insert(std::this_thread::get_id());
+    }
+    started++;
+    while (started.load() < 3) {
+      std::this_thread::yield();
+    }
+  });
+
+  EXPECT_EQ(threads.size(), 3u);
+}
+
+TEST(HostThreadPoolTest, NestedBatchesDoNotDeadlock) {
+  HostThreadPool pool(2);
+  std::atomic<int> runs{0};
+
+  pool.runAll(4, [&](std::size_t) { pool.runAll(4, [&](std::size_t) { runs++; }); });
+
+  EXPECT_EQ(runs.load(), 16);
+}
+
+TEST(HostThreadPoolTest, TheFirstExceptionIsRethrownAfterTheBatch) {
+  HostThreadPool pool(2);
+  std::atomic<int> runs{0};
+
+  EXPECT_THROW(pool.runAll(20,
+                           [&](std::size_t i) {
+                             runs++;
+                             if (i == 5) {
+                               throw std::runtime_error("failed");
+                             }
+                           }),
+               std::runtime_error);
+  EXPECT_EQ(runs.load(), 20);
+
+  // The pool still works afterwards
+  pool.runAll(5, [&](std::size_t) { runs++; });
+  EXPECT_EQ(runs.load(), 25);
+}
+
+TEST(HostThreadPoolTest, TheSharedPoolLeavesACoreForTheCaller) {
+  EXPECT_EQ(HostThreadPool::getShared().getWorkerCount(), HostThreadPool::getDefaultWorkerCount());
+  EXPECT_LT(HostThreadPool::getDefaultWorkerCount(),
+            std::max<std::size_t>(1, std::thread::hardware_concurrency()));
+}
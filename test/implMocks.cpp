@@ -264,6 +264,9 @@ void MockRate::delayUntil(uint32_t ims) {
   std::this_thread::sleep_for(std::chrono::milliseconds(ims));
 }
 
+void MockRate::reset() {
+}
+
 std::unique_ptr<SettledUtil> createSettledUtilPtr(const double iatTargetError,
                                                   const double iatTargetDerivative,
                                                   const QTime iatTargetTime) {
@@ -362,6 +365,13 @@ bool MockAsyncPosIntegratedController::isSettled() {
   }
 }
 
+void MockAsyncPosIntegratedController::modifyProfiledVelocity(const std::int32_t ivelocity) {
+  if (!controllerIsDisabled) {
+    lastProfiledVelocity = ivelocity;
+  }
+  AsyncPosIntegratedController::modifyProfiledVelocity(ivelocity);
+}
+
 MockAsyncVelIntegratedController::MockAsyncVelIntegratedController()
   : AsyncVelIntegratedController(std::make_shared<MockMotor>(),
                                  AbstractMotor::gearset::green,
@@ -763,4 +773,30 @@ void assertOdomStateEquals(Odometry *odom, QLength x, QLength y, QAngle theta) {
   EXPECT_NEAR(odom->getState().y.convert(meter), y.convert(meter), error);
   EXPECT_NEAR(odom->getState().theta.convert(degree), theta.convert(degree), error);
 }
+
+MockSerialPort::MockSerialPort(std::shared_ptr<Pipe> irx, std::shared_ptr<Pipe> itx)
+  : rx(std::move(irx)), tx(std::move(itx)) {
+}
+
+std::pair<std::shared_ptr<MockSerialPort>, std::shared_ptr<MockSerialPort>>
+MockSerialPort::makeCable() {
+  auto aToB = std::make_shared<Pipe>();
+  auto bToA = std::make_shared<Pipe>();
+  return {std::make_shared<MockSerialPort>(bToA, aToB),
+          std::make_shared<MockSerialPort>(aToB, bToA)};
+}
+
+std::size_t MockSerialPort::read(std::uint8_t *obuffer, const std::size_t ilength) {
+  std::scoped_lock lock(rx->mutex);
+  const std::size_t count = std::min(ilength, rx->bytes.size());
+  std::copy(rx->bytes.begin(), rx->bytes.begin() + count, obuffer);
+  rx->bytes.erase(rx->bytes.begin(), rx->bytes.begin() + count);
+  return count;
+}
+
+std::size_t MockSerialPort::write(const std::uint8_t *ibuffer, const std::size_t ilength) {
+  std::scoped_lock lock(tx->mutex);
+  tx->bytes.insert(tx->bytes.end(), ibuffer, ibuffer + ilength);
+  return ilength;
+}
 } // namespace okapi
@@ -0,0 +1,106 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#include "okapi/api/odometry/imuFusedOdometry.hpp"
+#include "okapi/api/odometry/twoEncoderOdometry.hpp"
+#include "test/tests/api/implMocks.hpp"
+#include <cmath>
+#include <gtest/gtest.h>
+#include <memory>
+
+using namespace okapi;
+
+class ImuFusedOdometryTest : public ::testing::Test {
+  protected:
+  void SetUp() override {
+    model = new MockSkidSteerModel();
+    imu = std::make_shared<MockImu>();
+    encoderOdom = std::make_shared<TwoEncoderOdometry>(
+      createConstantTimeUtil(10_ms),
+      std::shared_ptr<MockSkidSteerModel>(model),
+      ChassisScales({{wheelDiam, wheelbaseWidth}, 360}));
+    odom = std::make_unique<ImuFusedOdometry>(encoderOdom, imu, 1.0);
+  }
+
+  QLength calculateDistanceTraveled(int ticks) {
+    return (ticks / 360.0) * 1_pi * wheelDiam;
+  }
+
+  QLength wheelDiam = 4_in;
+  QLength wheelbaseWidth = 10_in;
+  MockSkidSteerModel *model;
+  std::shared_ptr<MockImu> imu;
+  std::shared_ptr<TwoEncoderOdometry> encoderOdom;
+  std::unique_ptr<ImuFusedOdometry> odom;
+};
+
+TEST_F(ImuFusedOdometryTest, MoveForwardMatchesEncoders) {
+  model->setSensorVals(10, 10);
+  odom->step();
+  assertOdomStateEquals(odom.get(), calculateDistanceTraveled(10), 0_m, 0_deg);
+
+  model->setSensorVals(20, 20);
+  odom->step();
+  assertOdomStateEquals(odom.get(), calculateDistanceTraveled(20), 0_m, 0_deg);
+}
+
+TEST_F(ImuFusedOdometryTest, ImuHeadingReplacesEncoderHeading) {
+  odom->step();
+
+  // The wheels slip, so the encoders measure a turn which didn't happen
+  model->setSensorVals(10, -10);
+  odom->step();
+  assertOdomStateEquals(odom.get(), 0_m, 0_m, 0_deg);
+  assertOdomStateEquals(encoderOdom.get(), 0_m, 0_m, 4_deg);
+}
+
+TEST_F(ImuFusedOdometryTest, DriveAlongImuHeading) {
+  // Turn 90 degrees without the encoders seeing it, then drive forward on the new heading
+  odom->step();
+  imu->heading = 90;
+  odom->step();
+  assertOdomStateEquals(odom.get(), 0_m, 0_m, 90_deg);
+
+  model->setSensorVals(10, 10);
+  odom->step();
+  assertOdomStateEquals(odom.get(), 0_m, calculateDistanceTraveled(10), 90_deg);
+}
+
+TEST_F(ImuFusedOdometryTest, ImuWeightBlendsHeadings) {
+  auto halfOdom = std::make_unique<ImuFusedOdometry>(encoderOdom, imu, 0.5);
+  halfOdom->step();
+
+  model->setSensorVals(10, -10);
+  halfOdom->step();
+  assertOdomStateEquals(halfOdom.get(), 0_m, 0_m, 2_deg);
+}
+
+TEST_F(ImuFusedOdometryTest, ImuHeadingIsRelativeToTheSetState) {
+  imu->heading = 30;
+  odom->setState({0_m, 0_m, 90_deg});
+  odom->step();
+  assertOdomStateEquals(odom.get(), 0_m, 0_m, 90_deg);
+
+  imu->heading = 40;
+  odom->step();
+  assertOdomStateEquals(odom.get(), 0_m, 0_m, 100_deg);
+}
+
+TEST_F(ImuFusedOdometryTest, FailedImuReadingUsesEncoderHeading) {
+  odom->step();
+  imu->heading = INFINITY;
+  model->setSensorVals(10, -10);
+  odom->step();
+  assertOdomStateEquals(odom.get(), 0_m, 0_m, 4_deg);
+}
+
+TEST_F(ImuFusedOdometryTest, InvalidWeightThrows) {
+  EXPECT_THROW(ImuFusedOdometry(encoderOdom, imu, 1.5), std::invalid_argument);
+  EXPECT_THROW(ImuFusedOdometry(encoderOdom, imu, -0.1), std::invalid_argument);
+}
+
+TEST_F(ImuFusedOdometryTest, NullImuThrows) {
+  EXPECT_THROW(ImuFusedOdometry(encoderOdom, nullptr), std::invalid_argument);
+}
@@ -0,0 +1,58 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#include "okapi/api/device/rotarysensor/imuGroup.hpp"
+#include "okapi/api/util/mathUtil.hpp"
+#include "test/tests/api/implMocks.hpp"
+#include <cmath>
+#include <gtest/gtest.h>
+
+using namespace okapi;
+
+class ImuGroupTest : public ::testing::Test {
+  protected:
+  std::shared_ptr<MockImu> imu1 = std::make_shared<MockImu>();
+  std::shared_ptr<MockImu> imu2 = std::make_shared<MockImu>();
+  ImuGroup group{{imu1, imu2}};
+};
+
+TEST_F(ImuGroupTest, AveragesTheHeadings) {
+  imu1->heading = 10;
+  imu2->heading = 20;
+  EXPECT_NEAR(group.get(), 15, 1e-6);
+  EXPECT_NEAR(group.controllerGet(), 15, 1e-6);
+}
+
+TEST_F(ImuGroupTest, AveragesAcrossTheWrap) {
+  imu1->heading = 179;
+  imu2->heading = -179;
+  EXPECT_NEAR(std::abs(group.get()), 180, 1e-6);
+
+  imu1->heading = 170;
+  imu2->heading = -176;
+  EXPECT_NEAR(group.get(), 177, 1e-6);
+}
+
+TEST_F(ImuGroupTest, LeavesOutSensorsWhichFailToRead) {
+  imu1->heading = OKAPI_PROS_ERR;
+  imu2->heading = 30;
+  EXPECT_NEAR(group.get(), 30, 1e-6);
+
+  imu2->heading = OKAPI_PROS_ERR_F;
+  EXPECT_EQ(group.get(), OKAPI_PROS_ERR);
+}
+
+TEST_F(ImuGroupTest, ResetsEverySensor) {
+  imu1->heading = 10;
+  imu2->heading = 20;
+  EXPECT_EQ(group.reset(), 1);
+  EXPECT_EQ(imu1->heading, 0);
+  EXPECT_EQ(imu2->heading, 0);
+  EXPECT_EQ(group.size(), 2u);
+}
+
+TEST(ImuGroupConstructorTest, AtLeastOneSensorIsRequired) {
+  EXPECT_THROW(ImuGroup({}), std::invalid_argument);
+}
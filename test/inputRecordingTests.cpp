@@ -0,0 +1,205 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#include "okapi/api/control/iterative/iterativePosPidController.hpp"
+#include "okapi/api/device/button/buttonBase.hpp"
+#include "okapi/api/util/inputRecorder.hpp"
+#include "okapi/api/util/inputReplayer.hpp"
+#include "okapi/api/util/mathUtil.hpp"
+#include "test/tests/api/implMocks.hpp"
+#include <gtest/gtest.h>
+#include <sstream>
+
+using namespace okapi;
+
+class InputRecordingTest : public ::testing::Test {
+  protected:
+  class SettableTimer : public AbstractTimer {
+    public:
+    explicit SettableTimer(const QTime &inow) : AbstractTimer(inow), now(inow) {
+    }
+
+    QTime millis() const override {
+      return now;
+    }
+
+    const QTime &now;
+  };
+
+  class SettableButton : public ButtonBase {
+    public:
+    bool currentlyPressed() override {
+      return pressed;
+    }
+
+    bool pressed{false};
+  };
+
+  class FailingMotor : public MockMotor {
+    public:
+    std::int32_t getCurrentDraw() override {
+      return OKAPI_PROS_ERR;
+    }
+
+    double getTemperature() override {
+      return OKAPI_PROS_ERR_F;
+    }
+  };
+
+  void SetUp() override {
+    telemetry = std::make_shared<TelemetryLogger>(
+      std::make_unique<SettableTimer>(recordTime), open_memstream(&buffer, &size));
+    recorder = std::make_unique<InputRecorder>(telemetry);
+  }
+
+  void TearDown() override {
+    recorder.reset();
+    telemetry.reset();
+    free(buffer);
+  }
+
+  /**
+   * Writes the recording and loads it into the replayer.
+   */
+  void loadRecording() {
+    telemetry->flush();
+
+    std::stringstream stream(std::string(buffer, size));
+    EXPECT_TRUE(replayer.load(stream));
+  }
+
+  char *buffer{nullptr};
+  size_t size{0};
+  QTime recordTime{5000_ms};
+  QTime replayTime{0_ms};
+  std::shared_ptr<TelemetryLogger> telemetry;
+  std::unique_ptr<InputRecorder> recorder;
+  InputReplayer replayer{std::make_unique<SettableTimer>(replayTime)};
+};
+
+TEST_F(InputRecordingTest, RecordedSensorPassesReadingsThrough) {
+  auto sensor = std::make_shared<MockContinuousRotarySensor>();
+  auto recorded = recorder->recordSensor("sensor", sensor);
+
+  sensor->value = 42;
+  EXPECT_EQ(recorded->get(), 42);
+  EXPECT_EQ(recorded->controllerGet(), 42);
+  recorded->reset();
+  EXPECT_EQ(sensor->value, 0);
+}
+
+TEST_F(InputRecordingTest, ReplaysTheReadingRecordedAtTheSameTime) {
+  auto sensor = std::make_shared<MockContinuousRotarySensor>();
+  auto recorded = recorder->recordSensor("sensor", sensor);
+  for (int i = 0; i < 10; i++) {
+    recordTime = 5000_ms + i * 10_ms;
+    sensor->value = i * 7;
+    recorded->get();
+  }
+  loadRecording();
+
+  auto replayed = replayer.replaySensor("sensor");
+  EXPECT_EQ(replayer.getDuration(), 90_ms);
+  EXPECT_EQ(replayed->get(), 0);
+
+  replayTime = 15_ms;
+  EXPECT_EQ(replayed->get(), 7);
+
+  replayTime = 20_ms;
+  EXPECT_EQ(replayed->get(), 14);
+
+  replayTime = 1_s;
+  EXPECT_EQ(replayed->get(), 63);
+
+  // Readings which were not recorded read zero
+  EXPECT_EQ(replayed->controllerGet(), 0);
+  EXPECT_FALSE(replayed->measuresVelocity());
+}
+
+TEST_F(InputRecordingTest, ReplaysAMotorAndItsEncoder) {
+  auto motor = std::make_shared<FailingMotor>();
+  auto recorded = recorder->recordMotor("motor", motor);
+
+  motor->encoder->value = 360;
+  EXPECT_EQ(recorded->getPosition(), 360);
+  EXPECT_EQ(recorded->getEncoder()->get(), 360);
+  EXPECT_EQ(recorded->getCurrentDraw(), OKAPI_PROS_ERR);
+  EXPECT_EQ(recorded->getTemperature(), OKAPI_PROS_ERR_F);
+
+  EXPECT_EQ(recorded->moveVoltage(1000), 1);
+  EXPECT_EQ(motor->lastVoltage, 1000);
+  loadRecording();
+
+  auto replayed = replayer.replayMotor("motor");
+  EXPECT_EQ(replayed->getPosition(), 360);
+  EXPECT_EQ(replayed->getEncoder()->get(), 360);
+  EXPECT_EQ(replayed->getCurrentDraw(), OKAPI_PROS_ERR);
+  EXPECT_EQ(replayed->getTemperature(), OKAPI_PROS_ERR_F);
+  EXPECT_EQ(replayed->moveVoltage(1000), 1);
+
+  replayed->setGearing(AbstractMotor::gearset::blue);
+  EXPECT_EQ(replayed->getGearing(), AbstractMotor::gearset::blue);
+}
+
+TEST_F(InputRecordingTest, ButtonChangesAreSeenOnce) {
+  auto button = std::make_shared<SettableButton>();
+  auto recorded = recorder->recordButton("button", button);
+
+  // The robot polls every 20 ms
+  for (int i = 0; i < 5; i++) {
+    recordTime = 5000_ms + i * 20_ms;
+    button->pressed = i >= 2;
+    recorded->isPressed();
+    recorded->changedToPressed();
+  }
+  loadRecording();
+
+  // The replay polls every 5 ms
+  auto replayed = replayer.replayButton("button");
+  int presses = 0;
+  for (int i = 0; i < 20; i++) {
+    replayTime = i * 5_ms;
+    if (replayed->changedToPressed()) {
+      presses++;
+      EXPECT_EQ(replayTime, 40_ms);
+      EXPECT_TRUE(replayed->isPressed());
+    }
+  }
+  EXPECT_EQ(presses, 1);
+}
+
+TEST_F(InputRecordingTest, ReplayingAControllerReproducesItsOutput) {
+  auto input = std::make_shared<MockContinuousRotarySensor>();
+  auto recorded = recorder->recordInput("input", input);
+  IterativePosPIDController fieldController({0.01, 0.001, 0.0001}, createConstantTimeUtil(10_ms));
+  fieldController.setTarget(500);
+
+  std::vector<double> fieldOutputs;
+  for (int i = 0; i < 100; i++) {
+    recordTime = 5000_ms + i * 10_ms;
+    input->value = static_cast<std::int32_t>(i * i * 0.3);
+    fieldOutputs.push_back(fieldController.step(recorded->controllerGet()));
+  }
+  loadRecording();
+
+  auto replayed = replayer.replayInput("input");
+  IterativePosPIDController replayController({0.01, 0.001, 0.0001}, createConstantTimeUtil(10_ms));
+  replayController.setTarget(500);
+  for (int i = 0; i < 100; i++) {
+    replayTime = i * 10_ms;
+    EXPECT_EQ(replayController.step(replayed->controllerGet()), fieldOutputs[i]);
+  }
+}
+
+TEST_F(InputRecordingTest, SkipsOtherTelemetryChannels) {
+  const auto other = telemetry->addChannel("pid", {"error", "output"});
+  telemetry->record(other, {1, 2});
+  recorder->recordInput("input", std::make_shared<MockContinuousRotarySensor>())->controllerGet();
+  loadRecording();
+
+  EXPECT_TRUE(replayer.hasDevice("input"));
+  EXPECT_FALSE(replayer.hasDevice("pid"));
+  EXPECT_THROW(replayer.replayMotor("pid"), std::invalid_argument);
+}
@@ -0,0 +1,77 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#include "okapi/api/control/util/integratedSettleTracker.hpp"
+#include <atomic>
+#include <chrono>
+#include <gtest/gtest.h>
+#include <thread>
+
+using namespace okapi;
+
+TEST(IntegratedSettleTrackerTest, NotTrackingUntilTheFirstUpdate) {
+  IntegratedSettleTracker tracker;
+  EXPECT_FALSE(tracker.isTracking());
+  EXPECT_FALSE(tracker.isSettled());
+
+  tracker.update(100, 50, false);
+  EXPECT_TRUE(tracker.isTracking());
+  EXPECT_FALSE(tracker.isSettled());
+}
+
+TEST(IntegratedSettleTrackerTest, SettlesOnceStoppedAtTheTarget) {
+  IntegratedSettleTracker tracker(5, 1, 2);
+
+  // Moving through the target is not settled
+  EXPECT_FALSE(tracker.update(2, 100, false));
+  EXPECT_FALSE(tracker.update(1, 0, true));
+  EXPECT_TRUE(tracker.update(1, 0, true));
+  EXPECT_TRUE(tracker.isSettled());
+}
+
+TEST(IntegratedSettleTrackerTest, LowVelocityCountsAsStopped) {
+  IntegratedSettleTracker tracker(5, 1, 1);
+  EXPECT_TRUE(tracker.update(-3, -0.5, false));
+}
+
+TEST(IntegratedSettleTrackerTest, StoppedAwayFromTheTargetIsNotSettled) {
+  IntegratedSettleTracker tracker(5, 1, 1);
+  EXPECT_FALSE(tracker.update(-6, 0, true));
+}
+
+TEST(IntegratedSettleTrackerTest, ResetStartsANewMovement) {
+  IntegratedSettleTracker tracker(5, 1, 2);
+  tracker.update(0, 0, true);
+  tracker.update(0, 0, true);
+  EXPECT_TRUE(tracker.isSettled());
+
+  tracker.reset();
+  EXPECT_FALSE(tracker.isSettled());
+
+  // A reading taken before the reset only counts once
+  EXPECT_FALSE(tracker.update(0, 0, true));
+  EXPECT_TRUE(tracker.update(0, 0, true));
+}
+
+TEST(IntegratedSettleTrackerTest, SettlingWakesWaiters) {
+  IntegratedSettleTracker tracker(5, 1, 1);
+  tracker.update(100, 50, false);
+
+  std::atomic_bool woken{false};
+  std::thread waiter([&]() {
+    auto generation = tracker.getGeneration();
+    while (!tracker.isSettled()) {
+      // Long enough that only a notification wakes it in time
+      tracker.waitFor(generation, 10000);
+      generation = tracker.getGeneration();
+    }
+    woken = true;
+  });
+
+  std::this_thread::sleep_for(std::chrono::milliseconds(10));
+  tracker.update(0, 0, true);
+  waiter.join();
+  EXPECT_TRUE(woken);
+}
@@ -0,0 +1,92 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#include "okapi/api/control/async/asyncVelBangBangController.hpp"
+#include "okapi/api/control/iterative/iterativeBangBangController.hpp"
+#include "test/tests/api/implMocks.hpp"
+#include <gtest/gtest.h>
+
+using namespace okapi;
+
+class IterativeBangBangControllerTest : public ::testing::Test {
+  protected:
+  void SetUp() override {
+    // 1800 ticks per rev every 10 ms, so each tick per step is 10/3 rpm
+    controller = new IterativeBangBangController(
+      {0.004, 0.01, 20},
+      std::make_unique<VelMath>(1800,
+                                std::make_unique<PassthroughFilter>(),
+                                0_ms,
+                                std::make_unique<ConstantMockTimer>(10_ms)),
+      createTimeUtil(Supplier<std::unique_ptr<AbstractTimer>>(
+        []() { return std::make_unique<ConstantMockTimer>(10_ms); })));
+  }
+
+  void TearDown() override {
+    delete controller;
+  }
+
+  IterativeBangBangController *controller;
+};
+
+TEST_F(IterativeBangBangControllerTest, SettledWhenDisabled) {
+  assertControllerIsSettledWhenDisabled(*controller, 100.0);
+}
+
+TEST_F(IterativeBangBangControllerTest, DisabledLifecycle) {
+  assertIterativeControllerFollowsDisableLifecycle(*controller);
+}
+
+TEST_F(IterativeBangBangControllerTest, TargetLifecycle) {
+  assertControllerFollowsTargetLifecycle(*controller);
+}
+
+TEST_F(IterativeBangBangControllerTest, ScalesControllerSetTarget) {
+  assertIterativeControllerScalesControllerSetTargets(*controller);
+}
+
+TEST_F(IterativeBangBangControllerTest, GainsRoundTrip) {
+  IterativeBangBangController::Gains gains{0.1, 0.2, 30};
+  controller->setGains(gains);
+  EXPECT_EQ(controller->getGains(), gains);
+}
+
+TEST_F(IterativeBangBangControllerTest, SaturatesOutsideTheBand) {
+  controller->setTarget(100);
+
+  // 0 rpm is below the band
+  EXPECT_DOUBLE_EQ(controller->step(0), 1);
+
+  // 200 rpm is above the band
+  EXPECT_DOUBLE_EQ(controller->step(60), -1);
+
+  // The lower bound coasts a flywheel when the limits are [0, 1]
+  controller->setOutputLimits(1, 0);
+  EXPECT_DOUBLE_EQ(controller->step(120), 0);
+}
+
+TEST_F(IterativeBangBangControllerTest, UsesFeedforwardWithinTheBand) {
+  controller->setTarget(100);
+
+  // 30 ticks per step is 100 rpm
+  EXPECT_NEAR(controller->step(30), 0.004 * 100, 1e-9);
+
+  // 33 ticks per step is 110 rpm
+  EXPECT_NEAR(controller->step(63), 0.004 * 100 + 0.01 * -10, 1e-9);
+}
+
+TEST(AsyncVelBangBangControllerTest, TestSetAndGetGains) {
+  AsyncVelBangBangController controller(
+    std::make_shared<MockControllerInput>(),
+    std::make_shared<MockMotor>(),
+    createTimeUtil(),
+    {0, 0, 0},
+    std::make_unique<VelMath>(
+      360, std::make_unique<PassthroughFilter>(), 10_ms, std::make_unique<MockTimer>()));
+
+  IterativeBangBangController::Gains gains{1, 2, 3};
+  controller.setGains(gains);
+  EXPECT_EQ(controller.getGains(), gains);
+}
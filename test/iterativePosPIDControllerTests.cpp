@@ -153,3 +153,236 @@ TEST_F(IterativePosPIDControllerTest, TestGetGainsReturnsTheOriginalGains) {
   EXPECT_FLOAT_EQ(gains.kD, 0.3);
   EXPECT_FLOAT_EQ(gains.kBias, 0.4);
 }
+
+TEST_F(IterativePosPIDControllerTest, FeedforwardFollowsTheProfiledTarget) {
+  controller->setGains({0, 0, 0, 0});
+  controller->setFeedforward({0.05, 0.01, 0.002});
+  EXPECT_EQ(controller->getFeedforward(), (MotorFeedforward{0.05, 0.01, 0.002}));
+
+  controller->setProfiledTarget(5, 20, 10);
+  EXPECT_DOUBLE_EQ(controller->step(5), 0.05 + 0.01 * 20 + 0.002 * 10);
+
+  controller->setProfiledTarget(5, -20, 0);
+  EXPECT_DOUBLE_EQ(controller->step(5), -0.05 - 0.01 * 20);
+}
+
+TEST_F(IterativePosPIDControllerTest, FeedforwardAddsToTheFeedback) {
+  controller->setFeedforward({0, 0.01, 0});
+  controller->setProfiledTarget(2, 20);
+  EXPECT_DOUBLE_EQ(controller->step(1), 0.1 * 1 + 0.01 * 20);
+}
+
+TEST_F(IterativePosPIDControllerTest, FeedforwardIsZeroForAStaticTarget) {
+  controller->setGains({0, 0, 0, 0});
+  controller->setFeedforward({0.05, 0.01, 0.002});
+  controller->setProfiledTarget(5, 20, 10);
+  controller->setTarget(5);
+  EXPECT_DOUBLE_EQ(controller->step(5), 0);
+}
+
+TEST(IterativePosPIDControllerFixedStepTest, StepFixedMatchesStepAtTheSampleTime) {
+  IterativePosPIDController timed({0.01, 0.05, 0.001, 0}, createConstantTimeUtil(10_ms));
+  IterativePosPIDController fixed({0.01, 0.05, 0.001, 0}, createConstantTimeUtil(10_ms));
+  timed.setTarget(50);
+  fixed.setTarget(50);
+
+  for (int i = 0; i < 20; i++) {
+    EXPECT_DOUBLE_EQ(fixed.stepFixed(i * 2, 10_ms), timed.step(i * 2));
+  }
+}
+
+TEST(IterativePosPIDControllerFixedStepTest, StepFixedSkipsTheTimer) {
+  // The timer never reaches the sample time, so step() would never update the output
+  IterativePosPIDController controller({0.1, 0, 0, 0}, createConstantTimeUtil(1_ms));
+  controller.setTarget(1);
+  EXPECT_DOUBLE_EQ(controller.step(0), 0);
+  EXPECT_DOUBLE_EQ(controller.stepFixed(0, 1_ms), 0.1);
+}
+
+TEST(IterativePosPIDControllerFixedStepTest, StepFixedScalesTheIntegralAndDerivative) {
+  IterativePosPIDController integral({0, 1, 0, 0}, createConstantTimeUtil(10_ms));
+  integral.setIntegratorReset(false);
+  integral.setTarget(10);
+  EXPECT_DOUBLE_EQ(integral.stepFixed(1, 20_ms), 9 * 0.02);
+  EXPECT_DOUBLE_EQ(integral.stepFixed(1, 5_ms), 9 * 0.025);
+
+  IterativePosPIDController derivative({0, 0, 1, 0}, createConstantTimeUtil(10_ms));
+  EXPECT_DOUBLE_EQ(derivative.stepFixed(0.01, 20_ms), -0.01 / 0.02);
+}
+
+TEST(IterativePosPIDControllerFixedStepTest, StepFixedWithoutTimeDoesNothing) {
+  IterativePosPIDController controller({0.1, 0, 0, 0}, createConstantTimeUtil(10_ms));
+  controller.setTarget(1);
+  EXPECT_DOUBLE_EQ(controller.stepFixed(0, 0_ms), 0);
+  EXPECT_DOUBLE_EQ(controller.getProcessValue(), 0);
+  controller.flipDisable(true);
+  EXPECT_DOUBLE_EQ(controller.stepFixed(0, 10_ms), 0);
+}
+
+TEST(IterativePosPIDControllerGainScheduleTest, InterpolatesBetweenPoints) {
+  const IterativePosPIDController::GainSchedule schedule(
+    {{100, {0.2, 0.02, 0.002, 0}}, {0, {0.1, 0, 0, 0}}, {50, {0.1, 0.01, 0, 0.5}}});
+
+  EXPECT_DOUBLE_EQ(schedule.getPoints().front().key, 0);
+  EXPECT_EQ(schedule.at(-10), (IterativePosPIDController::Gains{0.1, 0, 0, 0}));
+  EXPECT_EQ(schedule.at(50), (IterativePosPIDController::Gains{0.1, 0.01, 0, 0.5}));
+  EXPECT_EQ(schedule.at(1000), (IterativePosPIDController::Gains{0.2, 0.02, 0.002, 0}));
+
+  const auto gains = schedule.at(75);
+  EXPECT_DOUBLE_EQ(gains.kP, 0.15);
+  EXPECT_DOUBLE_EQ(gains.kI, 0.015);
+  EXPECT_DOUBLE_EQ(gains.kD, 0.001);
+  EXPECT_DOUBLE_EQ(gains.kBias, 0.25);
+}
+
+TEST(IterativePosPIDControllerGainScheduleTest, InvalidSchedulesThrow) {
+  EXPECT_THROW(IterativePosPIDController::GainSchedule({}), std::invalid_argument);
+  EXPECT_THROW(IterativePosPIDController::GainSchedule({{1, {}}, {1, {}}}),
+               std::invalid_argument);
+}
+
+TEST(IterativePosPIDControllerGainScheduleTest, SchedulesOnTheErrorMagnitude) {
+  IterativePosPIDController controller({0, 0, 0, 0}, createConstantTimeUtil(10_ms));
+  controller.setOutputLimits(100, -100);
+
+  // Gentle far from the target, aggressive close to it
+  controller.setGainSchedule(
+    IterativePosPIDController::GainSchedule({{0, {0.04, 0, 0, 0}}, {100, {0.01, 0, 0, 0}}}));
+  controller.setTarget(100);
+  EXPECT_DOUBLE_EQ(controller.step(0), 100 * 0.01);
+  EXPECT_DOUBLE_EQ(controller.step(50), 50 * 0.025);
+  EXPECT_DOUBLE_EQ(controller.step(-100), 200 * 0.01);
+  EXPECT_DOUBLE_EQ(controller.getGains().kP, 0.01);
+
+  // Clearing the schedule keeps the last gains
+  controller.clearGainSchedule();
+  EXPECT_DOUBLE_EQ(controller.step(50), 50 * 0.01);
+}
+
+TEST(IterativePosPIDControllerGainScheduleTest, SchedulesOnAnInput) {
+  IterativePosPIDController controller({0, 0, 0, 0}, createConstantTimeUtil(10_ms));
+  auto height = std::make_shared<MockControllerInput>();
+  controller.setGainSchedule(
+    IterativePosPIDController::GainSchedule({{0, {0.01, 0, 0, 0}}, {10, {0.03, 0, 0, 0.1}}}),
+    height);
+  controller.setTarget(10);
+
+  height->reading = 0;
+  EXPECT_DOUBLE_EQ(controller.step(0), 0.1);
+  height->reading = 5;
+  EXPECT_DOUBLE_EQ(controller.step(0), 0.2 + 0.05);
+}
+
+TEST(IterativePosPIDControllerGainScheduleTest, SwappingGainsKeepsTheIntegral) {
+  IterativePosPIDController controller({0, 0, 0, 0}, createConstantTimeUtil(10_ms));
+  auto input = std::make_shared<MockControllerInput>();
+  controller.setGainSchedule(
+    IterativePosPIDController::GainSchedule({{0, {0, 1, 0, 0}}, {1, {0, 2, 0, 0}}}), input);
+  controller.setIntegralLimits(10, -10);
+  controller.setTarget(10);
+
+  controller.step(5);
+  input->reading = 1;
+
+  // The integral from the first step is kept and the second step adds to it with the new gain
+  EXPECT_DOUBLE_EQ(controller.step(5), 5 * 0.01 + 5 * 0.02);
+}
+
+class IterativePosPIDControllerAntiWindupTest : public ::testing::Test {
+  protected:
+  // Steps once far from the target, where the output saturates, then once near it
+  double stepNearTarget(IterativePosPIDController::antiWindup istrategy) {
+    IterativePosPIDController controller({1, 10, 0, 0}, createConstantTimeUtil(10_ms));
+    controller.setIntegralLimits(10, -10);
+    controller.setIntegratorReset(false);
+    controller.setAntiWindup(istrategy);
+    controller.setTarget(20);
+
+    EXPECT_DOUBLE_EQ(controller.stepFixed(10, 10_ms), 1);
+    return controller.stepFixed(19.5, 10_ms);
+  }
+};
+
+TEST_F(IterativePosPIDControllerAntiWindupTest, ClampIsTheDefault) {
+  IterativePosPIDController controller({1, 10, 0, 0}, createConstantTimeUtil(10_ms));
+  EXPECT_EQ(controller.getAntiWindup(), IterativePosPIDController::antiWindup::clamp);
+}
+
+TEST_F(IterativePosPIDControllerAntiWindupTest, ClampKeepsTheWindup) {
+  // The integral of 1 from the saturated step keeps the output saturated
+  EXPECT_DOUBLE_EQ(stepNearTarget(IterativePosPIDController::antiWindup::clamp), 1);
+}
+
+TEST_F(IterativePosPIDControllerAntiWindupTest, ConditionalIntegrationSkipsSaturatedSteps) {
+  EXPECT_DOUBLE_EQ(stepNearTarget(IterativePosPIDController::antiWindup::conditionalIntegration),
+                   0.5 + 0.05);
+}
+
+TEST_F(IterativePosPIDControllerAntiWindupTest, BackCalculationTakesBackTheWindup) {
+  EXPECT_DOUBLE_EQ(stepNearTarget(IterativePosPIDController::antiWindup::backCalculation),
+                   0.5 + 0.05);
+}
+
+TEST_F(IterativePosPIDControllerAntiWindupTest, BackCalculationKeepsWhatTheLimitNeeds) {
+  IterativePosPIDController controller({0.05, 10, 0, 0}, createConstantTimeUtil(10_ms));
+  controller.setIntegralLimits(10, -10);
+  controller.setIntegratorReset(false);
+  controller.setAntiWindup(IterativePosPIDController::antiWindup::backCalculation);
+  controller.setTarget(20);
+
+  // The proportional term is 0.5, so the integral only needs 0.5 to hold the output at 1
+  EXPECT_DOUBLE_EQ(controller.stepFixed(10, 10_ms), 1);
+  EXPECT_DOUBLE_EQ(controller.stepFixed(10, 10_ms), 1);
+  EXPECT_DOUBLE_EQ(controller.stepFixed(20, 10_ms), 0.5);
+}
+
+TEST_F(IterativePosPIDControllerAntiWindupTest, BackCalculationWithALowerTrackingGain) {
+  IterativePosPIDController controller({0.05, 10, 0, 0}, createConstantTimeUtil(10_ms));
+  controller.setIntegralLimits(10, -10);
+  controller.setIntegratorReset(false);
+  controller.setAntiWindup(IterativePosPIDController::antiWindup::backCalculation, 0.5);
+  controller.setTarget(20);
+
+  // Half of the 0.5 the output was clamped by is taken out of the integral of 1
+  controller.stepFixed(10, 10_ms);
+  EXPECT_DOUBLE_EQ(controller.stepFixed(20, 10_ms), 0.75);
+}
+
+TEST_F(IterativePosPIDControllerAntiWindupTest, InvalidTrackingGainThrows) {
+  IterativePosPIDController controller({1, 10, 0, 0}, createConstantTimeUtil(10_ms));
+  EXPECT_THROW(controller.setAntiWindup(IterativePosPIDController::antiWindup::backCalculation, 0),
+               std::invalid_argument);
+  EXPECT_THROW(
+    controller.setAntiWindup(IterativePosPIDController::antiWindup::backCalculation, 1.5),
+    std::invalid_argument);
+}
+
+TEST_F(IterativePosPIDControllerTest, StepProfilingIsOffByDefault) {
+  controller->step(1);
+  EXPECT_EQ(controller->getStepProfile().stepCount, 0u);
+}
+
+TEST_F(IterativePosPIDControllerTest, StepProfilingCountsSteps) {
+  controller->setStepProfiling(true);
+  controller->step(1);
+  controller->stepFixed(1, 10_ms);
+  controller->stepFixed(1, 0_ms);
+
+  const auto profile = controller->getStepProfile();
+  EXPECT_EQ(profile.stepCount, 3u);
+  EXPECT_EQ(profile.skippedCount, 1u);
+
+  controller->resetStepProfile();
+  EXPECT_EQ(controller->getStepProfile().stepCount, 0u);
+}
+
+TEST(IterativePosPIDControllerProfilingTest, StepProfilingCountsStepsSkippedByTheSampleTime) {
+  IterativePosPIDController controller(0.1, 0, 0, 0, createConstantTimeUtil(5_ms));
+  controller.setStepProfiling(true);
+  controller.step(1);
+  controller.step(1);
+
+  const auto profile = controller.getStepProfile();
+  EXPECT_EQ(profile.stepCount, 2u);
+  EXPECT_EQ(profile.skippedCount, 2u);
+}
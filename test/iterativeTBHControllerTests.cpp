@@ -0,0 +1,98 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#include "okapi/api/control/async/asyncVelTbhController.hpp"
+#include "okapi/api/control/iterative/iterativeTbhController.hpp"
+#include "test/tests/api/implMocks.hpp"
+#include <gtest/gtest.h>
+
+using namespace okapi;
+
+class IterativeTBHControllerTest : public ::testing::Test {
+  protected:
+  void SetUp() override {
+    // 1800 ticks per rev every 10 ms, so each tick per step is 10/3 rpm
+    controller = new IterativeTBHController(
+      {0.1, 0},
+      std::make_unique<VelMath>(1800,
+                                std::make_unique<PassthroughFilter>(),
+                                0_ms,
+                                std::make_unique<ConstantMockTimer>(10_ms)),
+      createTimeUtil(Supplier<std::unique_ptr<AbstractTimer>>(
+        []() { return std::make_unique<ConstantMockTimer>(10_ms); })));
+  }
+
+  void TearDown() override {
+    delete controller;
+  }
+
+  IterativeTBHController *controller;
+};
+
+TEST_F(IterativeTBHControllerTest, SettledWhenDisabled) {
+  assertControllerIsSettledWhenDisabled(*controller, 100.0);
+}
+
+TEST_F(IterativeTBHControllerTest, DisabledLifecycle) {
+  assertIterativeControllerFollowsDisableLifecycle(*controller);
+}
+
+TEST_F(IterativeTBHControllerTest, TargetLifecycle) {
+  assertControllerFollowsTargetLifecycle(*controller);
+}
+
+TEST_F(IterativeTBHControllerTest, ScalesControllerSetTarget) {
+  assertIterativeControllerScalesControllerSetTargets(*controller);
+}
+
+TEST_F(IterativeTBHControllerTest, GainsRoundTrip) {
+  IterativeTBHController::Gains gains{0.2, 0.003};
+  controller->setGains(gains);
+  EXPECT_EQ(controller->getGains(), gains);
+}
+
+TEST_F(IterativeTBHControllerTest, TakesBackHalfAtEachCrossing) {
+  controller->setTarget(100);
+
+  // Below the target, so the error is integrated
+  EXPECT_NEAR(controller->step(0), 0.1, 1e-9);
+  EXPECT_NEAR(controller->step(0), 0.2, 1e-9);
+
+  // 200 rpm crosses the target, and with no guess the first crossing halves the output
+  EXPECT_NEAR(controller->step(60), 0.05, 1e-9);
+
+  // 0 rpm crosses back, so the output is halfway to the output at the last crossing
+  EXPECT_NEAR(controller->step(60), 0.5 * (0.15 + 0.05), 1e-9);
+}
+
+TEST_F(IterativeTBHControllerTest, FirstCrossingJumpsToTheGuess) {
+  controller->setGains({0.1, 0.002});
+  controller->setTarget(100);
+
+  EXPECT_NEAR(controller->step(0), 0.1, 1e-9);
+  EXPECT_NEAR(controller->step(60), 0.002 * 100, 1e-9);
+}
+
+TEST_F(IterativeTBHControllerTest, OutputIsClampedToTheLimits) {
+  controller->setOutputLimits(0.15, -0.15);
+  controller->setTarget(100);
+
+  controller->step(0);
+  EXPECT_NEAR(controller->step(0), 0.15, 1e-9);
+}
+
+TEST(AsyncVelTBHControllerTest, TestSetAndGetGains) {
+  AsyncVelTBHController controller(
+    std::make_shared<MockControllerInput>(),
+    std::make_shared<MockMotor>(),
+    createTimeUtil(),
+    {0, 0},
+    std::make_unique<VelMath>(
+      360, std::make_unique<PassthroughFilter>(), 10_ms, std::make_unique<MockTimer>()));
+
+  IterativeTBHController::Gains gains{1, 2};
+  controller.setGains(gains);
+  EXPECT_EQ(controller.getGains(), gains);
+}
@@ -154,3 +154,27 @@ TEST_F(IterativeVelPIDControllerTest, TestGetGainsReturnsTheOriginalGains) {
   EXPECT_FLOAT_EQ(gains.kF, 0.3);
   EXPECT_FLOAT_EQ(gains.kSF, 0.4);
 }
+
+TEST_F(IterativeVelPIDControllerTest, AccelerationGainUsesTheTargetDerivative) {
+  controller->setGains({0, 0, 0, 0, 0.001});
+  EXPECT_EQ(controller->getGains().kA, 0.001);
+
+  // The target rises by 10 every 10 ms step, which is an acceleration of 1000 per second
+  for (int i = 1; i <= 3; i++) {
+    controller->setTarget(10 * i);
+    EXPECT_DOUBLE_EQ(controller->step(0), 0.001 * 1000);
+  }
+
+  // A constant target has no acceleration
+  EXPECT_DOUBLE_EQ(controller->step(0), 0);
+}
+
+TEST_F(IterativeVelPIDControllerTest, StepProfilingCountsSteps) {
+  controller->setStepProfiling(true);
+  controller->step(0);
+  controller->step(0);
+
+  const auto profile = controller->getStepProfile();
+  EXPECT_EQ(profile.stepCount, 2u);
+  EXPECT_EQ(profile.skippedCount, 0u);
+}
@@ -0,0 +1,70 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#include "okapi/api/util/joystickCurve.hpp"
+#include <gtest/gtest.h>
+#include <stdexcept>
+
+using namespace okapi;
+
+TEST(JoystickCurveTest, LinearCurvePassesTheStickThrough) {
+  const auto curve = JoystickCurve::linear();
+  EXPECT_DOUBLE_EQ(curve(0), 0);
+  EXPECT_FLOAT_EQ(curve(127), 1);
+  EXPECT_FLOAT_EQ(curve(-127), -1);
+  EXPECT_FLOAT_EQ(curve(64), 64.0 / 127);
+  EXPECT_FLOAT_EQ(curve.shape(0.5), 64.0 / 127);
+}
+
+TEST(JoystickCurveTest, ReadingsPastTheEndsAreClamped) {
+  const auto curve = JoystickCurve::linear();
+  EXPECT_FLOAT_EQ(curve(200), 1);
+  EXPECT_FLOAT_EQ(curve(-128), -1);
+  EXPECT_FLOAT_EQ(curve.shape(1.5), 1);
+}
+
+TEST(JoystickCurveTest, ExponentialCurveIsOdd) {
+  const auto curve = JoystickCurve::exponential(2);
+  EXPECT_FLOAT_EQ(curve(127), 1);
+  EXPECT_FLOAT_EQ(curve(-64), -(64.0 / 127) * (64.0 / 127));
+  EXPECT_FLOAT_EQ(curve(64), (64.0 / 127) * (64.0 / 127));
+}
+
+TEST(JoystickCurveTest, DeadbandGivesZeroAndStretchesTheRest) {
+  const auto curve = JoystickCurve::linear(0.1);
+  EXPECT_DOUBLE_EQ(curve(12), 0);
+  EXPECT_DOUBLE_EQ(curve(-12), 0);
+  EXPECT_GT(curve(13), 0);
+  EXPECT_LT(curve(13), 0.01);
+  EXPECT_FLOAT_EQ(curve(127), 1);
+}
+
+TEST(JoystickCurveTest, BadParametersThrow) {
+  EXPECT_THROW(JoystickCurve::linear(1), std::invalid_argument);
+  EXPECT_THROW(JoystickCurve::linear(-0.1), std::invalid_argument);
+  EXPECT_THROW(JoystickCurve::exponential(0), std::invalid_argument);
+  EXPECT_THROW(JoystickAxis(JoystickCurve::linear(), 0), std::invalid_argument);
+}
+
+TEST(JoystickAxisTest, OutputIsSlewed) {
+  JoystickAxis axis(JoystickCurve::linear(), 0.25, 0.5);
+  EXPECT_DOUBLE_EQ(axis.step(127), 0.25);
+  EXPECT_DOUBLE_EQ(axis.step(127), 0.5);
+  EXPECT_DOUBLE_EQ(axis.step(1.0), 0.75);
+
+  // Reversing slows by the deceleration step and stops at zero first
+  EXPECT_DOUBLE_EQ(axis.step(-127), 0.25);
+  EXPECT_DOUBLE_EQ(axis.step(-127), 0);
+  EXPECT_DOUBLE_EQ(axis.step(-127), -0.25);
+
+  axis.reset();
+  EXPECT_DOUBLE_EQ(axis.getOutput(), 0);
+}
+
+TEST(JoystickAxisTest, DefaultStepsDoNotLimit) {
+  JoystickAxis axis(JoystickCurve::linear());
+  EXPECT_FLOAT_EQ(axis.step(127), 1);
+  EXPECT_FLOAT_EQ(axis.step(-127), -1);
+}
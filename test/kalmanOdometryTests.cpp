@@ -0,0 +1,163 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#include "okapi/api/odometry/kalmanOdometry.hpp"
+#include "test/tests/api/implMocks.hpp"
+#include <gtest/gtest.h>
+#include <memory>
+
+using namespace okapi;
+
+class KalmanOdometryTest : public ::testing::Test {
+  protected:
+  void SetUp() override {
+    model = new MockSkidSteerModel();
+    imu = std::make_shared<MockImu>();
+    distance = std::make_shared<MockControllerInput>();
+  }
+
+  std::unique_ptr<KalmanOdometry> makeOdom(std::shared_ptr<ContinuousRotarySensor> iimu) {
+    return std::make_unique<KalmanOdometry>(createConstantTimeUtil(10_ms),
+                                            std::shared_ptr<MockSkidSteerModel>(model),
+                                            ChassisScales({{wheelDiam, wheelbaseWidth}, 360}),
+                                            std::move(iimu));
+  }
+
+  QLength calculateDistanceTraveled(int ticks) {
+    return (ticks / 360.0) * 1_pi * wheelDiam;
+  }
+
+  QLength wheelDiam = 4_in;
+  QLength wheelbaseWidth = 10_in;
+  MockSkidSteerModel *model;
+  std::shared_ptr<MockImu> imu;
+  std::shared_ptr<MockControllerInput> distance;
+};
+
+TEST_F(KalmanOdometryTest, NoSensorMovementDoesNotAffectState) {
+  auto odom = makeOdom(nullptr);
+  odom->step();
+  assertOdomStateEquals(odom.get(), 0_m, 0_m, 0_deg);
+}
+
+TEST_F(KalmanOdometryTest, MoveForwardFollowsEncoders) {
+  auto odom = makeOdom(nullptr);
+  model->setSensorVals(10, 10);
+  odom->step();
+  assertOdomStateEquals(odom.get(), calculateDistanceTraveled(10), 0_m, 0_deg);
+
+  model->setSensorVals(20, 20);
+  odom->step();
+  assertOdomStateEquals(odom.get(), calculateDistanceTraveled(20), 0_m, 0_deg);
+  EXPECT_NEAR(odom->getVelocity().convert(mps),
+              (calculateDistanceTraveled(10) / 10_ms).convert(mps),
+              1e-3);
+}
+
+TEST_F(KalmanOdometryTest, TurnInPlaceFollowsEncoders) {
+  auto odom = makeOdom(nullptr);
+  for (int i = 1; i <= 10; i++) {
+    model->setSensorVals(10 * i, -10 * i);
+    odom->step();
+  }
+
+  // The angular velocity starts unknown, so the estimate lags slightly behind the encoders
+  EXPECT_NEAR(odom->getState().theta.convert(degree), 40, 1);
+  EXPECT_NEAR(odom->getState().x.convert(meter), 0, 1e-4);
+  EXPECT_GT(odom->getAngularVelocity().convert(radps), 0);
+}
+
+TEST_F(KalmanOdometryTest, ImuCorrectsEncoderHeading) {
+  auto odom = makeOdom(imu);
+  odom->step();
+
+  // The wheels slip, so the encoders measure a turn which didn't happen
+  for (int i = 1; i <= 10; i++) {
+    model->setSensorVals(10 * i, -10 * i);
+    odom->step();
+  }
+
+  // The encoders alone would measure 40 degrees
+  EXPECT_LT(std::abs(odom->getState().theta.convert(degree)), 1);
+}
+
+TEST_F(KalmanOdometryTest, ImuHeadingIsRelativeToTheSetState) {
+  auto odom = makeOdom(imu);
+  imu->heading = 30;
+  odom->setState({0_m, 0_m, 90_deg});
+  odom->step();
+  EXPECT_NEAR(odom->getState().theta.convert(degree), 90, 1e-6);
+
+  for (int i = 0; i < 100; i++) {
+    imu->heading = 40;
+    odom->step();
+  }
+  EXPECT_NEAR(odom->getState().theta.convert(degree), 100, 0.5);
+}
+
+TEST_F(KalmanOdometryTest, DistanceSensorCorrectsPosition) {
+  auto odom = makeOdom(nullptr);
+  odom->addDistanceSensor(distance, {0_m, 0_m, 0_deg});
+  odom->setWalls(-10_m, 1_m, -10_m, 10_m);
+
+  // The sensor faces the wall at x = 1 m and sees the robot 2 cm closer than the encoders
+  distance->reading = 980;
+  for (int i = 0; i < 300; i++) {
+    odom->step();
+  }
+
+  EXPECT_NEAR(odom->getState().x.convert(meter), 0.02, 1e-3);
+  EXPECT_NEAR(odom->getState().y.convert(meter), 0, 1e-6);
+}
+
+TEST_F(KalmanOdometryTest, DistanceSensorOnAYWall) {
+  auto odom = makeOdom(nullptr);
+  odom->addDistanceSensor(distance, {0.1_m, 0_m, 0_deg});
+  odom->setWalls(-10_m, 10_m, -10_m, 1_m);
+  odom->setState({0_m, 0_m, 90_deg});
+
+  // The sensor is 10 cm in front of the center and faces the wall at y = 1 m
+  distance->reading = 880;
+  for (int i = 0; i < 300; i++) {
+    odom->step();
+  }
+
+  EXPECT_NEAR(odom->getState().y.convert(meter), 0.02, 1e-3);
+  EXPECT_NEAR(odom->getState().x.convert(meter), 0, 1e-3);
+}
+
+TEST_F(KalmanOdometryTest, DistanceOutlierIsRejected) {
+  auto odom = makeOdom(nullptr);
+  odom->addDistanceSensor(distance, {0_m, 0_m, 0_deg});
+  odom->setWalls(-10_m, 1_m, -10_m, 10_m);
+
+  // Another robot is in front of the sensor
+  distance->reading = 500;
+  for (int i = 0; i < 100; i++) {
+    odom->step();
+  }
+
+  assertOdomStateEquals(odom.get(), 0_m, 0_m, 0_deg);
+}
+
+TEST_F(KalmanOdometryTest, DistanceWithoutWallsIsIgnored) {
+  auto odom = makeOdom(nullptr);
+  odom->addDistanceSensor(distance, {0_m, 0_m, 0_deg});
+  distance->reading = 980;
+  odom->step();
+  assertOdomStateEquals(odom.get(), 0_m, 0_m, 0_deg);
+}
+
+TEST_F(KalmanOdometryTest, InvalidWallsThrow) {
+  auto odom = makeOdom(nullptr);
+  EXPECT_THROW(odom->setWalls(1_m, 1_m, 0_m, 1_m), std::invalid_argument);
+}
+
+TEST_F(KalmanOdometryTest, SetStateInCartesian) {
+  auto odom = makeOdom(nullptr);
+  odom->setState({1_m, 2_m, 3_deg}, StateMode::CARTESIAN);
+  assertOdomStateEquals(odom.get(), 2_m, 1_m, 3_deg);
+  EXPECT_EQ(odom->getState(StateMode::CARTESIAN), (OdomState{1_m, 2_m, 3_deg}));
+}
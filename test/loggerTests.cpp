@@ -3,9 +3,20 @@
  * License, v. 2.0. If a copy of the MPL was not distributed with this
  * file, You can obtain one at http://mozilla.org/MPL/2.0/.
  */
+#include "okapi/api/util/cobs.hpp"
+#include "okapi/api/util/logBuffer.hpp"
+#include "okapi/api/util/logCapture.hpp"
 #include "okapi/api/util/logging.hpp"
+#include "okapi/api/util/telemetryLogger.hpp"
+#include "okapi/api/util/telemetryStream.hpp"
 #include "test/tests/api/implMocks.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cstring>
 #include <gtest/gtest.h>
+#include <sstream>
+#include <thread>
+#include <vector>
 
 using namespace okapi;
 
@@ -172,3 +183,644 @@ TEST_F(LoggerTest, TestLazyLogging) {
     free(line);
   }
 }
+
+TEST_F(LoggerTest, AsyncLoggingWritesFromTheDrainTask) {
+  logger = std::make_shared<Logger>(
+    std::make_unique<ConstantMockTimer>(0_ms), logFile, Logger::LogLevel::warn);
+  logger->startAsync();
+  EXPECT_TRUE(logger->isAsync());
+
+  logData(logger);
+  std::this_thread::sleep_for(std::chrono::milliseconds(Logger::drainLoopTimeout * 5));
+
+  char *line = nullptr;
+  size_t len;
+
+  getline(&line, &len, logFile);
+  std::string expected = "0 (" + CrossplatformThread::getName() + ") ERROR: MSG\n";
+  EXPECT_STREQ(line, expected.c_str());
+
+  getline(&line, &len, logFile);
+  expected = "0 (" + CrossplatformThread::getName() + ") WARN: MSG\n";
+  EXPECT_STREQ(line, expected.c_str());
+
+  EXPECT_EQ(logger->getDroppedCount(), 0u);
+
+  if (line) {
+    free(line);
+  }
+}
+
+TEST_F(LoggerTest, BufferedLoggingWritesOnFlush) {
+  logger = std::make_shared<Logger>(
+    std::make_unique<ConstantMockTimer>(0_ms), logFile, Logger::LogLevel::warn);
+  logger->startBuffered(Logger::defaultBufferSize, 100000);
+  EXPECT_TRUE(logger->isBuffered());
+
+  // The flush task flushes once when it starts
+  std::this_thread::sleep_for(std::chrono::milliseconds(20));
+  logData(logger);
+  fflush(logFile);
+  EXPECT_EQ(logSize, 0u);
+
+  logger->flush();
+  const std::string name = CrossplatformThread::getName();
+  EXPECT_EQ(std::string(logBuffer, logSize),
+            "0 (" + name + ") ERROR: MSG\n0 (" + name + ") WARN: MSG\n");
+  EXPECT_EQ(logger->getDroppedCount(), 0u);
+}
+
+TEST_F(LoggerTest, BufferedLoggingFlushesWhenHalfFull) {
+  logger = std::make_shared<Logger>(
+    std::make_unique<ConstantMockTimer>(0_ms), logFile, Logger::LogLevel::warn);
+  logger->startBuffered(256, 100000);
+  std::this_thread::sleep_for(std::chrono::milliseconds(20));
+
+  const std::string message(150, 'x');
+  LOG_ERROR(message);
+  std::this_thread::sleep_for(std::chrono::milliseconds(50));
+  EXPECT_GT(logSize, message.size());
+}
+
+TEST_F(LoggerTest, BufferedAsyncLoggingIsWrittenOnClose) {
+  logger = std::make_shared<Logger>(
+    std::make_unique<ConstantMockTimer>(0_ms), logFile, Logger::LogLevel::warn);
+  logger->startAsync();
+  logger->startBuffered(Logger::defaultBufferSize, 100000);
+
+  logData(logger);
+  logger->close();
+  EXPECT_EQ(std::count(logBuffer, logBuffer + logSize, '\n'), 2);
+}
+
+TEST_F(LoggerTest, CaptureHoldsStatementsInMemory) {
+  // The capture is written to instead of the log file
+  fclose(logFile);
+  auto capture = std::make_shared<LogCapture>();
+  logger = std::make_shared<Logger>(
+    std::make_unique<ConstantMockTimer>(0_ms), capture, Logger::LogLevel::info);
+
+  logData(logger);
+  LOG_INFO_F("moving %d ticks", 42);
+
+  const auto lines = capture->takeLines();
+  ASSERT_EQ(lines.size(), 4u);
+  EXPECT_EQ(lines[0].time, 0);
+  EXPECT_EQ(lines[0].level, toUnderlyingType(Logger::LogLevel::error));
+  EXPECT_EQ(lines[0].taskName, CrossplatformThread::getName());
+  EXPECT_EQ(lines[0].message, "MSG");
+  EXPECT_EQ(lines[2].level, toUnderlyingType(Logger::LogLevel::info));
+  EXPECT_EQ(lines[3].message, "moving 42 ticks");
+  EXPECT_TRUE(capture->takeLines().empty());
+  EXPECT_EQ(logSize, 0u);
+}
+
+TEST_F(LoggerTest, CaptureDropsStatementsWhenFull) {
+  fclose(logFile);
+  auto capture = std::make_shared<LogCapture>(2);
+  logger = std::make_shared<Logger>(
+    std::make_unique<ConstantMockTimer>(0_ms), capture, Logger::LogLevel::debug);
+
+  logData(logger);
+  EXPECT_EQ(logger->getDroppedCount(), 2u);
+  EXPECT_EQ(capture->clear(), 2u);
+
+  // A closed logger no longer writes to the capture
+  logger->close();
+  logData(logger);
+  EXPECT_EQ(capture->clear(), 0u);
+}
+
+TEST(LogBufferTest, WritesLinesInOrder) {
+  char *data;
+  size_t size;
+  FILE *file = open_memstream(&data, &size);
+
+  LogBuffer buffer(64, 32);
+  bool shouldFlush;
+  EXPECT_TRUE(buffer.append({"a", "b", "\n"}, shouldFlush));
+  EXPECT_FALSE(shouldFlush);
+  EXPECT_TRUE(buffer.append({"cd\n"}, shouldFlush));
+  EXPECT_EQ(buffer.getBufferedSize(), 6u);
+
+  EXPECT_EQ(buffer.writeTo(file), 6u);
+  EXPECT_EQ(buffer.getBufferedSize(), 0u);
+
+  // The other half is filled next
+  EXPECT_TRUE(buffer.append({"e\n"}, shouldFlush));
+  EXPECT_EQ(buffer.writeTo(file), 2u);
+  fclose(file);
+  EXPECT_EQ(std::string(data, size), "ab\ncd\ne\n");
+  free(data);
+}
+
+TEST(LogBufferTest, DropsLinesWhichDoNotFit) {
+  LogBuffer buffer(8, 4);
+  bool shouldFlush;
+  EXPECT_TRUE(buffer.append({"abcd"}, shouldFlush));
+  EXPECT_TRUE(shouldFlush);
+  EXPECT_FALSE(buffer.append({"efgh", "i"}, shouldFlush));
+  EXPECT_EQ(buffer.getDroppedCount(), 1u);
+  EXPECT_EQ(buffer.getBufferedSize(), 4u);
+  EXPECT_TRUE(buffer.append({"efgh"}, shouldFlush));
+}
+
+TEST(LogRecordQueueTest, PopsRecordsInOrder) {
+  LogRecordQueue queue(4);
+  EXPECT_TRUE(queue.tryPush(1, 2, "a", "first"));
+  EXPECT_TRUE(queue.tryPush(3, 4, "b", "second"));
+
+  LogRecord record;
+  ASSERT_TRUE(queue.tryPop(record));
+  EXPECT_EQ(record.time, 1);
+  EXPECT_EQ(record.level, 2);
+  EXPECT_STREQ(record.taskName, "a");
+  EXPECT_STREQ(record.message, "first");
+
+  ASSERT_TRUE(queue.tryPop(record));
+  EXPECT_STREQ(record.message, "second");
+  EXPECT_FALSE(queue.tryPop(record));
+}
+
+TEST(LogRecordQueueTest, DropsRecordsWhenFull) {
+  LogRecordQueue queue(3);
+  EXPECT_EQ(queue.getCapacity(), 4u);
+
+  for (int i = 0; i < 4; i++) {
+    EXPECT_TRUE(queue.tryPush(i, 0, "", "msg"));
+  }
+  EXPECT_FALSE(queue.tryPush(4, 0, "", "msg"));
+  EXPECT_EQ(queue.getDroppedCount(), 1u);
+
+  // Popping a record frees its cell
+  LogRecord record;
+  ASSERT_TRUE(queue.tryPop(record));
+  EXPECT_EQ(record.time, 0);
+  EXPECT_TRUE(queue.tryPush(5, 0, "", "msg"));
+}
+
+TEST(LogRecordQueueTest, TruncatesLongMessages) {
+  LogRecordQueue queue(2);
+  const std::string message(LogRecord::maxMessageLength + 10, 'x');
+  EXPECT_TRUE(queue.tryPush(0, 0, "", message));
+
+  LogRecord record;
+  ASSERT_TRUE(queue.tryPop(record));
+  EXPECT_EQ(std::string(record.message), message.substr(0, LogRecord::maxMessageLength));
+}
+
+TEST(LogRecordQueueTest, ManyProducers) {
+  LogRecordQueue queue(1024);
+  std::vector<std::thread> producers;
+  for (int i = 0; i < 4; i++) {
+    producers.emplace_back([&queue, i]() {
+      for (int j = 0; j < 200; j++) {
+        queue.tryPush(i * 1000 + j, 0, "", "msg");
+      }
+    });
+  }
+
+  for (auto &producer : producers) {
+    producer.join();
+  }
+
+  // Each producer's records come out in the order it pushed them
+  std::vector<long> lastTimes(4, -1);
+  LogRecord record;
+  int count = 0;
+  while (queue.tryPop(record)) {
+    const auto producer = record.time / 1000;
+    EXPECT_GT(record.time, lastTimes[producer]);
+    lastTimes[producer] = record.time;
+    count++;
+  }
+
+  EXPECT_EQ(count, 800);
+  EXPECT_EQ(queue.getDroppedCount(), 0u);
+}
+
+TEST_F(LoggerTest, FormatLogging) {
+  logger = std::make_shared<Logger>(
+    std::make_unique<ConstantMockTimer>(0_ms), logFile, Logger::LogLevel::info);
+
+  LOG_INFO_F("moving %.2f ticks at %d rpm (%s) %u%%", 1.5, -200, std::string("left"), 7u);
+  LOG_DEBUG_F("this is %d disabled", 1);
+
+  char *line = nullptr;
+  size_t len;
+
+  getline(&line, &len, logFile);
+  std::string expected =
+    "0 (" + CrossplatformThread::getName() + ") INFO: moving 1.50 ticks at -200 rpm (left) 7%\n";
+  EXPECT_STREQ(line, expected.c_str());
+  EXPECT_EQ(getline(&line, &len, logFile), -1);
+
+  if (line) {
+    free(line);
+  }
+}
+
+TEST_F(LoggerTest, AsyncFormatLoggingCopiesStrings) {
+  logger = std::make_shared<Logger>(
+    std::make_unique<ConstantMockTimer>(0_ms), logFile, Logger::LogLevel::info);
+  logger->startAsync();
+
+  {
+    std::string name = "path";
+    LOG_INFO_F("Running with %s, %zu points", name, std::size_t{42});
+    name = "overwritten";
+  }
+  std::this_thread::sleep_for(std::chrono::milliseconds(Logger::drainLoopTimeout * 5));
+
+  char *line = nullptr;
+  size_t len;
+
+  getline(&line, &len, logFile);
+  std::string expected =
+    "0 (" + CrossplatformThread::getName() + ") INFO: Running with path, 42 points\n";
+  EXPECT_STREQ(line, expected.c_str());
+
+  if (line) {
+    free(line);
+  }
+}
+
+TEST(LogRecordTest, FormatMatchesTheCapturedArguments) {
+  const LogArg args[] = {LogArg(3.7), LogArg(-2), LogArg(std::uint8_t{200}), LogArg('x')};
+  LogRecord record;
+  record.setFormat("%d %f %ld %c%s", args, 4);
+
+  // Each argument is converted to the type of its conversion, and missing arguments are skipped
+  char message[64];
+  record.formatMessage(message, sizeof(message));
+  EXPECT_STREQ(message, "3 -2.000000 200 x");
+}
+
+TEST(LogRecordTest, FormatTruncatesToTheBuffer) {
+  const LogArg args[] = {LogArg(123456)};
+  LogRecord record;
+  record.setFormat("value=%d end", args, 1);
+
+  char message[10];
+  record.formatMessage(message, sizeof(message));
+  EXPECT_STREQ(message, "value=123");
+}
+
+TEST(LogRecordTest, FormatTruncatesLongStringArguments) {
+  const std::string first(LogRecord::maxMessageLength, 'a');
+  const LogArg args[] = {LogArg(first), LogArg("b")};
+  LogRecord record;
+  record.setFormat("%s|%s", args, 2);
+
+  char message[LogRecord::maxFormattedLength + 1];
+  record.formatMessage(message, sizeof(message));
+  EXPECT_EQ(std::string(message), first + "|");
+}
+
+TEST_F(LoggerTest, RemovedLogStatementsDoNothing) {
+  logger = std::make_shared<Logger>(
+    std::make_unique<ConstantMockTimer>(0_ms), logFile, Logger::LogLevel::debug);
+
+  int x = 0;
+  OKAPI_LOG_REMOVED(logger->debug([&]() {
+    x++;
+    return std::string("MSG");
+  }));
+  EXPECT_EQ(x, 0);
+
+  char *line = nullptr;
+  size_t len;
+
+  fputs("EMPTY_FILE", logFile);
+
+  getline(&line, &len, logFile);
+  EXPECT_STREQ(line, "EMPTY_FILE");
+
+  if (line) {
+    free(line);
+  }
+}
+
+TEST(LogRateLimiterTest, PerSecondLimitsEachInterval) {
+  auto limiter = LogRateLimiter::perSecond(2);
+  std::uint32_t suppressed = 99;
+
+  EXPECT_TRUE(limiter.tryAcquire(0_ms, suppressed));
+  EXPECT_EQ(suppressed, 0u);
+  EXPECT_TRUE(limiter.tryAcquire(10_ms, suppressed));
+  EXPECT_FALSE(limiter.tryAcquire(20_ms, suppressed));
+  EXPECT_FALSE(limiter.tryAcquire(990_ms, suppressed));
+  EXPECT_EQ(limiter.getSuppressedCount(), 2u);
+
+  EXPECT_TRUE(limiter.tryAcquire(1000_ms, suppressed));
+  EXPECT_EQ(suppressed, 2u);
+  EXPECT_EQ(limiter.getSuppressedCount(), 0u);
+}
+
+TEST(LogRateLimiterTest, EveryNthSamplesOccurrences) {
+  auto limiter = LogRateLimiter::everyNth(3);
+  std::uint32_t suppressed = 99;
+
+  std::vector<bool> logged;
+  for (int i = 0; i < 7; i++) {
+    logged.push_back(limiter.tryAcquire(0_ms, suppressed));
+  }
+
+  EXPECT_EQ(logged, std::vector<bool>({true, false, false, true, false, false, true}));
+  EXPECT_EQ(suppressed, 2u);
+}
+
+TEST(LogRateLimiterTest, SampledAndRateLimited) {
+  LogRateLimiter limiter(2, 1, 100_ms);
+  std::uint32_t suppressed;
+
+  EXPECT_TRUE(limiter.tryAcquire(0_ms, suppressed));
+  EXPECT_FALSE(limiter.tryAcquire(0_ms, suppressed));
+  EXPECT_FALSE(limiter.tryAcquire(0_ms, suppressed));
+  EXPECT_FALSE(limiter.tryAcquire(100_ms, suppressed));
+  EXPECT_TRUE(limiter.tryAcquire(100_ms, suppressed));
+  EXPECT_EQ(suppressed, 3u);
+}
+
+TEST_F(LoggerTest, LimitedLoggingReportsSuppressedMessages) {
+  logger = std::make_shared<Logger>(
+    std::make_unique<ConstantMockTimer>(0_ms), logFile, Logger::LogLevel::warn);
+
+  int evaluated = 0;
+  int *counter = &evaluated;
+  for (int i = 0; i < 5; i++) {
+    LOG_WARN_LIMITED(LogRateLimiter::everyNth(4), "MSG" + std::to_string((*counter)++));
+  }
+
+  char *line = nullptr;
+  size_t len;
+
+  getline(&line, &len, logFile);
+  std::string expected = "0 (" + CrossplatformThread::getName() + ") WARN: MSG0\n";
+  EXPECT_STREQ(line, expected.c_str());
+
+  getline(&line, &len, logFile);
+  expected =
+    "0 (" + CrossplatformThread::getName() + ") WARN: MSG1 (suppressed 3 similar messages)\n";
+  EXPECT_STREQ(line, expected.c_str());
+  EXPECT_EQ(getline(&line, &len, logFile), -1);
+
+  // Suppressed messages are never built
+  EXPECT_EQ(evaluated, 2);
+
+  if (line) {
+    free(line);
+  }
+}
+
+TEST(TelemetryFormatTest, RoundTrip) {
+  std::stringstream stream;
+  std::uint8_t header[TelemetryFormat::headerSize];
+  TelemetryFormat::writeHeader(header);
+  stream.write(reinterpret_cast<char *>(header), sizeof(header));
+
+  const auto channel = TelemetryFormat::encodeChannel({3, "pid", {"error", "output"}});
+  stream.write(reinterpret_cast<const char *>(channel.data()), channel.size());
+
+  const double values[] = {1.5, -0.25};
+  std::uint8_t sample[TelemetryFormat::getSampleSize(2)];
+  TelemetryFormat::writeSample(sample, 120, 3, values, 2);
+  stream.write(reinterpret_cast<char *>(sample), sizeof(sample));
+
+  std::vector<TelemetryFormat::Channel> channels;
+  std::vector<TelemetryFormat::Sample> samples;
+  EXPECT_TRUE(TelemetryFormat::decode(
+    stream,
+    [&](const TelemetryFormat::Channel &ichannel) { channels.push_back(ichannel); },
+    [&](const TelemetryFormat::Sample &isample) { samples.push_back(isample); }));
+
+  ASSERT_EQ(channels.size(), 1u);
+  EXPECT_EQ(channels[0].id, 3);
+  EXPECT_EQ(channels[0].name, "pid");
+  EXPECT_EQ(channels[0].fieldNames, std::vector<std::string>({"error", "output"}));
+
+  ASSERT_EQ(samples.size(), 1u);
+  EXPECT_EQ(samples[0].time, 120u);
+  EXPECT_EQ(samples[0].channel, 3);
+  EXPECT_EQ(samples[0].values, std::vector<double>({1.5, -0.25}));
+}
+
+TEST(TelemetryFormatTest, TruncatedFileDecodesTheWholeRecords) {
+  std::string bytes(TelemetryFormat::headerSize, '\0');
+  TelemetryFormat::writeHeader(reinterpret_cast<std::uint8_t *>(bytes.data()));
+
+  const auto channel = TelemetryFormat::encodeChannel({0, "odom", {"x"}});
+  bytes.append(channel.begin(), channel.end());
+
+  const double value = 2;
+  std::uint8_t sample[TelemetryFormat::getSampleSize(1)];
+  TelemetryFormat::writeSample(sample, 10, 0, &value, 1);
+  bytes.append(reinterpret_cast<char *>(sample), sizeof(sample));
+  bytes.append(reinterpret_cast<char *>(sample), sizeof(sample) - 2);
+
+  std::stringstream stream(bytes);
+  std::size_t sampleCount = 0;
+  EXPECT_FALSE(TelemetryFormat::decode(
+    stream, [](const TelemetryFormat::Channel &) {}, [&](const auto &) { sampleCount++; }));
+  EXPECT_EQ(sampleCount, 1u);
+}
+
+TEST(TelemetryFormatTest, RejectsABadHeader) {
+  std::stringstream stream("NOTATELEMETRYFILE");
+  EXPECT_FALSE(TelemetryFormat::decode(
+    stream, [](const TelemetryFormat::Channel &) {}, [](const TelemetryFormat::Sample &) {}));
+}
+
+TEST(TelemetryLoggerTest, WritesDecodableSamples) {
+  char *buffer = nullptr;
+  size_t size = 0;
+
+  {
+    TelemetryLogger telemetry(
+      std::make_unique<ConstantMockTimer>(0_ms), open_memstream(&buffer, &size), 64);
+    const auto channel = telemetry.addChannel("pid", {"error", "output"});
+    EXPECT_FALSE(telemetry.record(channel, {1}));
+    EXPECT_FALSE(telemetry.record(channel + 1, {1, 2}));
+    for (int i = 0; i < 50; i++) {
+      EXPECT_TRUE(telemetry.record(channel, {static_cast<double>(i), 1}));
+      if (i % 8 == 0) {
+        telemetry.flush();
+      }
+    }
+    telemetry.flush();
+    EXPECT_EQ(telemetry.getDroppedCount(), 0u);
+  }
+
+  std::stringstream stream(std::string(buffer, size));
+  free(buffer);
+
+  std::vector<TelemetryFormat::Sample> samples;
+  EXPECT_TRUE(TelemetryFormat::decode(
+    stream,
+    [](const TelemetryFormat::Channel &ichannel) { EXPECT_EQ(ichannel.name, "pid"); },
+    [&](const TelemetryFormat::Sample &isample) { samples.push_back(isample); }));
+
+  ASSERT_EQ(samples.size(), 50u);
+  for (std::size_t i = 0; i < samples.size(); i++) {
+    EXPECT_EQ(samples[i].time, 0u);
+    EXPECT_EQ(samples[i].values, std::vector<double>({static_cast<double>(i), 1}));
+  }
+}
+
+TEST(TelemetryLoggerTest, TooManyFieldsThrows) {
+  char *buffer = nullptr;
+  size_t size = 0;
+
+  {
+    TelemetryLogger telemetry(
+      std::make_unique<ConstantMockTimer>(0_ms), open_memstream(&buffer, &size));
+    EXPECT_THROW(telemetry.addChannel("big", std::vector<std::string>(256, "x")),
+                 std::invalid_argument);
+  }
+
+  free(buffer);
+}
+
+TEST(CobsTest, RoundTripRemovesZeros) {
+  for (const std::size_t length : {0, 1, 5, 253, 254, 255, 600}) {
+    std::vector<std::uint8_t> packet(length);
+    for (std::size_t i = 0; i < length; i++) {
+      packet[i] = static_cast<std::uint8_t>(i % 7 == 0 ? 0 : i);
+    }
+
+    std::vector<std::uint8_t> encoded(Cobs::getMaxEncodedSize(length));
+    const std::size_t encodedLength = Cobs::encode(packet.data(), length, encoded.data());
+    ASSERT_LE(encodedLength, encoded.size());
+    for (std::size_t i = 0; i < encodedLength; i++) {
+      EXPECT_NE(encoded[i], 0);
+    }
+
+    std::vector<std::uint8_t> decoded(encodedLength);
+    std::size_t decodedLength;
+    ASSERT_TRUE(Cobs::decode(encoded.data(), encodedLength, decoded.data(), decodedLength));
+    decoded.resize(decodedLength);
+    EXPECT_EQ(decoded, packet) << "length " << length;
+  }
+}
+
+TEST(CobsTest, DecodeRejectsATruncatedPacket) {
+  const std::uint8_t encoded[] = {5, 1, 2};
+  std::uint8_t decoded[sizeof(encoded)];
+  std::size_t decodedLength;
+  EXPECT_FALSE(Cobs::decode(encoded, sizeof(encoded), decoded, decodedLength));
+}
+
+class MockTelemetryStream : public TelemetryStream {
+  public:
+  using TelemetryStream::step;
+  using TelemetryStream::TelemetryStream;
+};
+
+// Splits a stream into its packets and checks their checksums
+static std::vector<std::vector<std::uint8_t>> decodeTelemetryStream(const std::string &istream) {
+  std::vector<std::vector<std::uint8_t>> packets;
+  std::size_t start = 0;
+  for (std::size_t end = istream.find('\0'); end != std::string::npos;
+       start = end + 1, end = istream.find('\0', start)) {
+    std::vector<std::uint8_t> packet(end - start);
+    std::size_t length;
+    EXPECT_TRUE(Cobs::decode(reinterpret_cast<const std::uint8_t *>(istream.data()) + start,
+                             end - start,
+                             packet.data(),
+                             length));
+    packet.resize(length);
+
+    std::uint8_t checksum = 0;
+    for (std::size_t i = 0; i + 1 < packet.size(); i++) {
+      checksum += packet[i];
+    }
+    EXPECT_EQ(checksum, packet.back());
+    packet.pop_back();
+    packets.push_back(packet);
+  }
+  EXPECT_EQ(start, istream.size());
+  return packets;
+}
+
+TEST(TelemetryStreamTest, WritesDescriptorAndSamplePackets) {
+  char *buffer = nullptr;
+  size_t size = 0;
+
+  {
+    MockTelemetryStream stream(createConstantTimeUtil(10_ms), open_memstream(&buffer, &size));
+    double value = 1.5;
+    stream.addSignal("a", [&]() { return value; });
+    const auto b = stream.addSignal("b", []() { return -2.0; });
+    stream.step();
+    value = 3;
+    stream.step();
+    stream.removeSignal(b);
+    stream.step();
+    EXPECT_EQ(stream.getSignalCount(), 1u);
+  }
+
+  const auto packets = decodeTelemetryStream(std::string(buffer, size));
+  free(buffer);
+
+  const std::vector<std::uint8_t> descriptor{
+    TelemetryStream::descriptorPacketType, 2, 1, 'a', 1, 'b'};
+  ASSERT_EQ(packets.size(), 5u);
+  EXPECT_EQ(packets[0], descriptor);
+
+  auto sampleValue = [](const std::vector<std::uint8_t> &ipacket, const std::size_t i) {
+    float value;
+    std::memcpy(&value, ipacket.data() + 6 + i * sizeof(float), sizeof(float));
+    return value;
+  };
+
+  EXPECT_EQ(packets[1][0], TelemetryStream::samplePacketType);
+  EXPECT_EQ(packets[1][5], 2);
+  EXPECT_EQ(sampleValue(packets[1], 0), 1.5f);
+  EXPECT_EQ(sampleValue(packets[1], 1), -2.0f);
+
+  // The descriptor isn't repeated until the signals change
+  EXPECT_EQ(packets[2][0], TelemetryStream::samplePacketType);
+  EXPECT_EQ(sampleValue(packets[2], 0), 3.0f);
+
+  const std::vector<std::uint8_t> newDescriptor{TelemetryStream::descriptorPacketType, 1, 1, 'a'};
+  EXPECT_EQ(packets[3], newDescriptor);
+  EXPECT_EQ(packets[4][5], 1);
+}
+
+TEST(TelemetryStreamTest, RegistrationRemovesItsSignals) {
+  char *buffer = nullptr;
+  size_t size = 0;
+
+  {
+    auto stream =
+      std::make_shared<MockTelemetryStream>(createTimeUtil(), open_memstream(&buffer, &size));
+    stream->addSignal("other", []() { return 0.0; });
+
+    {
+      TelemetryRegistration registration;
+      registration.add(stream, "x", []() { return 1.0; });
+      registration.add(stream, "y", []() { return 2.0; });
+      EXPECT_EQ(stream->getSignalCount(), 3u);
+    }
+
+    EXPECT_EQ(stream->getSignalCount(), 1u);
+  }
+
+  free(buffer);
+}
+
+TEST(TelemetryStreamTest, StreamsFromItsTask) {
+  char *buffer = nullptr;
+  size_t size = 0;
+
+  {
+    TelemetryStream stream(createTimeUtil(), open_memstream(&buffer, &size), 1_ms);
+    stream.addSignal("a", []() { return 1.0; });
+    stream.startThread();
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+  }
+
+  const auto packets = decodeTelemetryStream(std::string(buffer, size));
+  free(buffer);
+  EXPECT_GT(packets.size(), 2u);
+}
@@ -0,0 +1,126 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#include "okapi/api/device/motor/motorCurrentController.hpp"
+#include "okapi/api/util/mathUtil.hpp"
+#include "test/tests/api/implMocks.hpp"
+#include "test/tests/api/simulatedDevices.hpp"
+#include <gtest/gtest.h>
+
+using namespace okapi;
+
+class MotorCurrentControllerTest : public ::testing::Test {
+  protected:
+  void SetUp() override {
+    world.addDevice(motor);
+  }
+
+  void run(MotorCurrentController &controller, const QTime &iduration) {
+    for (QTime time = 0_ms; time < iduration; time += MotorCurrentController::defaultLoopPeriod) {
+      controller.step();
+      world.advance(MotorCurrentController::defaultLoopPeriod);
+    }
+  }
+
+  void stall() {
+    // Takes away all of the motor's speed every substep, like a clamp closed on something
+    motor->setExternalTorque([&](double, double iomega) {
+      return -iomega * motor->getParams().inertia / 0.001;
+    });
+  }
+
+  SimWorld world;
+  std::shared_ptr<SimMotor> motor = std::make_shared<SimMotor>(AbstractMotor::gearset::green);
+};
+
+TEST_F(MotorCurrentControllerTest, ConstructWithInvalidParametersThrows) {
+  EXPECT_THROW(MotorCurrentController(motor, world.createTimeUtil(), 0), std::invalid_argument);
+  EXPECT_THROW(MotorCurrentController(motor, world.createTimeUtil(), 2500, {0, 12000}),
+               std::invalid_argument);
+  EXPECT_THROW(MotorCurrentController(motor, world.createTimeUtil(), 2500, {}, {}, 0_ms),
+               std::invalid_argument);
+}
+
+TEST_F(MotorCurrentControllerTest, SetsTheMotorCurrentLimit) {
+  MotorCurrentController controller(motor, world.createTimeUtil(), 1500);
+  EXPECT_EQ(motor->getCurrentLimit(), 1500);
+}
+
+TEST_F(MotorCurrentControllerTest, TargetIsClampedToTheMaxCurrent) {
+  MotorCurrentController controller(motor, world.createTimeUtil(), 1500);
+
+  controller.setTarget(5000);
+  EXPECT_EQ(controller.getTarget(), 1500);
+
+  controller.controllerSet(-0.5);
+  EXPECT_EQ(controller.getTarget(), -750);
+
+  controller.controllerSet(-2);
+  EXPECT_EQ(controller.getTarget(), -1500);
+}
+
+TEST_F(MotorCurrentControllerTest, HoldsTheTargetCurrentWhenStalled) {
+  stall();
+  MotorCurrentController controller(motor, world.createTimeUtil());
+
+  controller.setTarget(1000);
+  run(controller, 500_ms);
+
+  EXPECT_NEAR(motor->getCurrentDraw(), 1000, 25);
+  EXPECT_GT(motor->getVoltage(), 0);
+  EXPECT_LT(motor->getVoltage(), 12000);
+}
+
+TEST_F(MotorCurrentControllerTest, NegativeTargetPushesBackwards) {
+  stall();
+  MotorCurrentController controller(motor, world.createTimeUtil());
+
+  controller.setTarget(-1000);
+  run(controller, 500_ms);
+
+  EXPECT_NEAR(motor->getCurrentDraw(), 1000, 25);
+  EXPECT_LT(motor->getVoltage(), 0);
+}
+
+TEST_F(MotorCurrentControllerTest, HoldsTheTargetCurrentWhileMoving) {
+  // A load which takes more torque the faster it goes, like an intake full of game pieces
+  motor->setExternalTorque([](double, double iomega) { return -0.05 * iomega; });
+  MotorCurrentController controller(motor, world.createTimeUtil());
+
+  controller.setTarget(1000);
+  run(controller, 1_s);
+
+  EXPECT_NEAR(motor->getCurrentDraw(), 1000, 25);
+  EXPECT_GT(motor->getActualVelocity(), 50);
+}
+
+TEST_F(MotorCurrentControllerTest, ZeroTargetStopsTheMotor) {
+  stall();
+  MotorCurrentController controller(motor, world.createTimeUtil());
+
+  controller.setTarget(1000);
+  run(controller, 100_ms);
+  controller.setTarget(0);
+  run(controller, 10_ms);
+
+  EXPECT_EQ(motor->getVoltage(), 0);
+}
+
+TEST_F(MotorCurrentControllerTest, UnpluggedMotorIsLeftAlone) {
+  class UnpluggedMotor : public MockMotor {
+    public:
+    std::int32_t getCurrentDraw() override {
+      return OKAPI_PROS_ERR;
+    }
+  };
+
+  auto unplugged = std::make_shared<UnpluggedMotor>();
+  MotorCurrentController controller(unplugged, createTimeUtil());
+  unplugged->lastVoltage = 1234;
+
+  controller.setTarget(1000);
+  controller.step();
+  EXPECT_EQ(unplugged->lastVoltage, 1234);
+}
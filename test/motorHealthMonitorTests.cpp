@@ -0,0 +1,184 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#include "okapi/api/device/motor/motorHealthMonitor.hpp"
+#include "okapi/api/util/mathUtil.hpp"
+#include "test/tests/api/implMocks.hpp"
+#include <gtest/gtest.h>
+#include <utility>
+#include <vector>
+
+using namespace okapi;
+
+/**
+ * A motor mock with settable health readings.
+ */
+class HealthMockMotor : public MockMotor {
+  public:
+  double getTemperature() override {
+    return temperature;
+  }
+
+  std::int32_t getCurrentDraw() override {
+    return currentDraw;
+  }
+
+  std::int32_t isOverTemp() override {
+    return overTemp;
+  }
+
+  std::int32_t isOverCurrent() override {
+    return overCurrent;
+  }
+
+  std::uint32_t getFaults() override {
+    return faults;
+  }
+
+  std::int32_t getCurrentLimit() override {
+    return currentLimit;
+  }
+
+  std::int32_t setCurrentLimit(const std::int32_t ilimit) override {
+    currentLimit = ilimit;
+    return 1;
+  }
+
+  double temperature{30};
+  std::int32_t currentDraw{0};
+  std::int32_t overTemp{0};
+  std::int32_t overCurrent{0};
+  std::uint32_t faults{0};
+  std::int32_t currentLimit{2500};
+};
+
+class MotorHealthMonitorTest : public ::testing::Test {
+  protected:
+  void SetUp() override {
+    monitor.setCallback([&](std::size_t imotor, MotorHealthMonitor::event ievent, auto &&) {
+      events.emplace_back(imotor, ievent);
+    });
+  }
+
+  MotorHealthMonitor monitor{createTimeUtil()};
+  std::vector<std::pair<std::size_t, MotorHealthMonitor::event>> events;
+};
+
+TEST_F(MotorHealthMonitorTest, KeepsRollingStatistics) {
+  auto motor = std::make_shared<HealthMockMotor>();
+  const auto index = monitor.addMotor(motor);
+
+  motor->temperature = 30;
+  motor->currentDraw = 1000;
+  monitor.step();
+  motor->temperature = 40;
+  motor->currentDraw = 500;
+  monitor.step();
+
+  const auto stats = monitor.getStats(index);
+  EXPECT_EQ(stats.sampleCount, 2u);
+  EXPECT_DOUBLE_EQ(stats.temperature, 40);
+  EXPECT_DOUBLE_EQ(stats.meanTemperature, 31);
+  EXPECT_DOUBLE_EQ(stats.peakTemperature, 40);
+  EXPECT_EQ(stats.currentDraw, 500);
+  EXPECT_DOUBLE_EQ(stats.meanCurrentDraw, 950);
+  EXPECT_EQ(stats.peakCurrentDraw, 1000);
+  EXPECT_TRUE(events.empty());
+}
+
+TEST_F(MotorHealthMonitorTest, LowersTheCurrentLimitWhileTooHot) {
+  auto motor = std::make_shared<HealthMockMotor>();
+  MotorHealthLimits limits;
+  limits.maxTemperature = 50;
+  limits.temperatureHysteresis = 5;
+  limits.hotCurrentLimit = 1000;
+  monitor.addMotor(motor, limits);
+
+  motor->temperature = 51;
+  monitor.step();
+  EXPECT_EQ(motor->currentLimit, 1000);
+  EXPECT_TRUE(monitor.getStats(0).isTooHot);
+
+  // Still within the hysteresis
+  motor->temperature = 47;
+  monitor.step();
+  EXPECT_EQ(motor->currentLimit, 1000);
+
+  motor->temperature = 44;
+  monitor.step();
+  EXPECT_EQ(motor->currentLimit, 2500);
+  EXPECT_FALSE(monitor.getStats(0).isTooHot);
+
+  const decltype(events) expected{{0, MotorHealthMonitor::event::tooHot},
+                                  {0, MotorHealthMonitor::event::cooledDown}};
+  EXPECT_EQ(events, expected);
+}
+
+TEST_F(MotorHealthMonitorTest, ReportsEachCrossingOnce) {
+  auto first = std::make_shared<HealthMockMotor>();
+  auto second = std::make_shared<HealthMockMotor>();
+  monitor.addMotor(first);
+  monitor.addMotor(second);
+
+  second->currentDraw = 3000;
+  second->overCurrent = 1;
+  monitor.step();
+  monitor.step();
+  second->currentDraw = 2000;
+  second->overCurrent = 0;
+  monitor.step();
+
+  const decltype(events) expected{{1, MotorHealthMonitor::event::drawingTooMuchCurrent},
+                                  {1, MotorHealthMonitor::event::overCurrent},
+                                  {1, MotorHealthMonitor::event::currentDrawNormal}};
+  EXPECT_EQ(events, expected);
+}
+
+TEST_F(MotorHealthMonitorTest, ReportsOnlyNewFaults) {
+  auto motor = std::make_shared<HealthMockMotor>();
+  monitor.addMotor(motor);
+
+  motor->faults = 0b0100;
+  motor->overTemp = 1;
+  monitor.step();
+  monitor.step();
+  motor->faults = 0b0101;
+  monitor.step();
+
+  const decltype(events) expected{{0, MotorHealthMonitor::event::overTemp},
+                                  {0, MotorHealthMonitor::event::newFaults},
+                                  {0, MotorHealthMonitor::event::newFaults}};
+  EXPECT_EQ(events, expected);
+  EXPECT_EQ(monitor.getStats(0).faults, 0b0101u);
+}
+
+TEST_F(MotorHealthMonitorTest, SkipsFailedReadings) {
+  auto motor = std::make_shared<HealthMockMotor>();
+  monitor.addMotor(motor);
+
+  motor->temperature = OKAPI_PROS_ERR_F;
+  monitor.step();
+
+  const auto stats = monitor.getStats(0);
+  EXPECT_EQ(stats.sampleCount, 0u);
+  EXPECT_EQ(stats.failedSampleCount, 1u);
+  EXPECT_TRUE(events.empty());
+}
+
+TEST_F(MotorHealthMonitorTest, ResetStatsRestoresTheCurrentLimit) {
+  auto motor = std::make_shared<HealthMockMotor>();
+  MotorHealthLimits limits;
+  limits.hotCurrentLimit = 1000;
+  monitor.addMotor(motor, limits);
+
+  motor->temperature = 60;
+  monitor.step();
+  EXPECT_EQ(motor->currentLimit, 1000);
+
+  monitor.resetStats();
+  EXPECT_EQ(motor->currentLimit, 2500);
+  EXPECT_EQ(monitor.getStats(0).sampleCount, 0u);
+  EXPECT_EQ(monitor.getMotorCount(), 1u);
+}
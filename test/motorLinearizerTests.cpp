@@ -0,0 +1,89 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#include "okapi/api/device/motor/motorLinearizer.hpp"
+#include "test/tests/api/implMocks.hpp"
+#include <gtest/gtest.h>
+#include <stdexcept>
+
+using namespace okapi;
+
+TEST(MotorLinearizerTest, DefaultSendsCommandsUnchanged) {
+  const MotorLinearizer linearizer;
+  EXPECT_EQ(linearizer(0), 0);
+  EXPECT_EQ(linearizer(50), 50);
+  EXPECT_EQ(linearizer(-127), -127);
+  EXPECT_EQ(linearizer(300), 127);
+}
+
+TEST(MotorLinearizerTest, DeadZoneIsSkipped) {
+  // The motor does not move below 30 and is linear above it
+  const auto linearizer = MotorLinearizer::fromResponse({{30, 0}, {127, 97}});
+  EXPECT_EQ(linearizer(0), 0);
+  EXPECT_EQ(linearizer(1), 31);
+  EXPECT_EQ(linearizer(-1), -31);
+  EXPECT_EQ(linearizer(127), 127);
+
+  // Half the top speed is halfway through the part which moves
+  EXPECT_NEAR(linearizer(64), 30 + 97.0 * 64 / 127, 1);
+}
+
+TEST(MotorLinearizerTest, SaturationIsStretched) {
+  // The motor reaches its top speed at 80
+  const auto linearizer = MotorLinearizer::fromResponse({{80, 1}, {127, 1}});
+  EXPECT_EQ(linearizer(127), 80);
+  EXPECT_NEAR(linearizer(64), 40, 1);
+}
+
+TEST(MotorLinearizerTest, TableIsMonotonic) {
+  // A noisy measurement which goes down is ignored
+  const auto linearizer = MotorLinearizer::fromResponse({{40, 5}, {60, 4}, {100, 10}, {127, 11}});
+  const auto &table = linearizer.getTable();
+  for (std::size_t i = 1; i < table.size(); i++) {
+    EXPECT_GE(table[i], table[i - 1]);
+  }
+
+  EXPECT_EQ(MotorLinearizer(table).getTable(), table);
+}
+
+TEST(MotorLinearizerTest, NoResponseThrows) {
+  EXPECT_THROW(MotorLinearizer::fromResponse({{127, 0}}), std::invalid_argument);
+}
+
+TEST(MotorLinearizerTest, CalibrationMeasuresTheResponse) {
+  class StepSensor : public RotarySensor {
+    public:
+    double get() const override {
+      // Every read advances the sensor by the speed of the motor
+      position += speed;
+      return position;
+    }
+
+    double controllerGet() override {
+      return get();
+    }
+
+    mutable double position{0};
+    double speed{0};
+  };
+
+  auto sensor = std::make_shared<StepSensor>();
+  std::vector<std::int8_t> writes;
+  const auto linearizer = MotorLinearizer::calibrate(
+    [&](const std::int8_t ipwm) {
+      writes.push_back(ipwm);
+      sensor->speed = ipwm < 30 ? 0 : ipwm - 30;
+    },
+    sensor,
+    createTimeUtil(),
+    10,
+    1_ms,
+    1_ms);
+
+  EXPECT_EQ(writes,
+            (std::vector<std::int8_t>{10, 20, 30, 40, 50, 60, 70, 80, 90, 100, 110, 120, 127, 0}));
+  EXPECT_EQ(linearizer(1), 31);
+  EXPECT_EQ(linearizer(127), 127);
+}
@@ -0,0 +1,177 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#include "okapi/api/device/motor/motorLoadBalancer.hpp"
+#include "okapi/api/util/mathUtil.hpp"
+#include "test/tests/api/implMocks.hpp"
+#include <gtest/gtest.h>
+
+using namespace okapi;
+
+class MotorLoadBalancerTest : public ::testing::Test {
+  protected:
+  MotorLoadBalancer balancer{3};
+};
+
+TEST_F(MotorLoadBalancerTest, EvenLoadGivesNoTrim) {
+  balancer.update({{100, 1000}, {100, 1000}, {100, 1000}}, 10_ms);
+
+  for (std::size_t i = 0; i < 3; i++) {
+    EXPECT_DOUBLE_EQ(balancer.getTrim(i), 0);
+    EXPECT_EQ(balancer.apply(i, 6000), 6000);
+  }
+}
+
+TEST_F(MotorLoadBalancerTest, EasesOffTheMotorWhichDrawsTheMost) {
+  balancer.update({{100, 1600}, {100, 1000}, {100, 1000}}, 10_ms);
+
+  EXPECT_LT(balancer.getTrim(0), 0);
+  EXPECT_GT(balancer.getTrim(1), 0);
+  EXPECT_DOUBLE_EQ(balancer.getTrim(1), balancer.getTrim(2));
+  EXPECT_NEAR(balancer.getTrim(0) + balancer.getTrim(1) + balancer.getTrim(2), 0, 1e-9);
+}
+
+TEST_F(MotorLoadBalancerTest, TrimFollowsTheDirectionOfTheVoltage) {
+  for (int i = 0; i < 10; i++) {
+    balancer.update({{100, 1600}, {100, 1000}, {100, 1000}}, 10_ms);
+  }
+
+  const auto forward = balancer.apply(0, 6000);
+  const auto reverse = balancer.apply(0, -6000);
+  EXPECT_LT(forward, 6000);
+  EXPECT_EQ(reverse, -forward);
+  EXPECT_EQ(balancer.apply(0, 0), 0);
+}
+
+TEST_F(MotorLoadBalancerTest, TrimIsBounded) {
+  MotorLoadBalancerParams params;
+  params.maxTrim = 500;
+  MotorLoadBalancer bounded(2, params);
+
+  for (int i = 0; i < 1000; i++) {
+    bounded.update({{100, 2500}, {100, 500}}, 10_ms);
+  }
+
+  EXPECT_DOUBLE_EQ(bounded.getTrim(0), -500);
+  EXPECT_DOUBLE_EQ(bounded.getTrim(1), 500);
+  EXPECT_EQ(bounded.apply(1, 11800), 12000);
+}
+
+TEST_F(MotorLoadBalancerTest, LongGapsAreCapped) {
+  MotorLoadBalancer other(3);
+  balancer.update({{100, 1600}, {100, 1000}, {100, 1000}}, 100_ms);
+  other.update({{100, 1600}, {100, 1000}, {100, 1000}}, 10_s);
+
+  EXPECT_DOUBLE_EQ(balancer.getTrim(0), other.getTrim(0));
+}
+
+TEST_F(MotorLoadBalancerTest, HoldsTheTrimsUnderLightLoad) {
+  balancer.update({{100, 1600}, {100, 1000}, {100, 1000}}, 10_ms);
+  const double trim = balancer.getTrim(0);
+
+  balancer.update({{100, 150}, {100, 10}, {100, 10}}, 10_ms);
+  EXPECT_DOUBLE_EQ(balancer.getTrim(0), trim);
+}
+
+TEST_F(MotorLoadBalancerTest, LeavesOutASlippingMotor) {
+  balancer.update({{100, 1000}, {100, 1000}, {100, 1000}}, 10_ms);
+  balancer.update({{100, 1600}, {100, 1000}, {200, 0}}, 10_ms);
+
+  // The slipping motor draws no current, which would otherwise pull the mean down
+  EXPECT_DOUBLE_EQ(balancer.getTrim(2), 0);
+  EXPECT_EQ(balancer.apply(2, 6000), 6000);
+  EXPECT_LT(balancer.getTrim(0), 0);
+  EXPECT_DOUBLE_EQ(balancer.getTrim(0), -balancer.getTrim(1));
+}
+
+TEST_F(MotorLoadBalancerTest, LeavesOutAMotorWhichCantBeRead) {
+  balancer.update({{100, 1600}, {100, 1000}, {100, OKAPI_PROS_ERR}}, 10_ms);
+
+  EXPECT_DOUBLE_EQ(balancer.getTrim(2), 0);
+  EXPECT_DOUBLE_EQ(balancer.getTrim(0), -balancer.getTrim(1));
+}
+
+TEST_F(MotorLoadBalancerTest, NeedsTwoMotorsToBalance) {
+  balancer.update({{100, 1600}, {OKAPI_PROS_ERR, 1000}, {100, OKAPI_PROS_ERR}}, 10_ms);
+
+  for (std::size_t i = 0; i < 3; i++) {
+    EXPECT_DOUBLE_EQ(balancer.getTrim(i), 0);
+  }
+}
+
+TEST_F(MotorLoadBalancerTest, ResetClearsTheTrims) {
+  balancer.update({{100, 1600}, {100, 1000}, {100, 1000}}, 10_ms);
+  balancer.reset();
+
+  for (std::size_t i = 0; i < 3; i++) {
+    EXPECT_DOUBLE_EQ(balancer.getTrim(i), 0);
+  }
+}
+
+TEST_F(MotorLoadBalancerTest, BalancesAGroupWhoseMotorsDifferInStrength) {
+  // Each motor's current follows its voltage, but one motor is weaker and draws more for the same
+  // voltage
+  const double resistance[] = {2.0, 1.6, 2.0};
+  std::vector<MotorLoadBalancer::Reading> readings(3);
+  for (int step = 0; step < 500; step++) {
+    for (std::size_t i = 0; i < 3; i++) {
+      readings[i] = {100, balancer.apply(i, 4000) / resistance[i]};
+    }
+    balancer.update(readings, 10_ms);
+  }
+
+  EXPECT_NEAR(readings[0].currentDraw, readings[1].currentDraw, 20);
+  EXPECT_NEAR(readings[1].currentDraw, readings[2].currentDraw, 20);
+}
+
+/**
+ * A motor mock whose current draw follows its voltage through a resistance.
+ */
+class LoadedMockMotor : public MockMotor {
+  public:
+  explicit LoadedMockMotor(const double iresistance) : resistance(iresistance) {
+  }
+
+  double getActualVelocity() override {
+    return 100;
+  }
+
+  std::int32_t getCurrentDraw() override {
+    return static_cast<std::int32_t>(lastVoltage / resistance);
+  }
+
+  double resistance;
+};
+
+TEST_F(MotorLoadBalancerTest, VoltageCommandsBalanceTheMotors) {
+  std::vector<std::shared_ptr<AbstractMotor>> motors{std::make_shared<LoadedMockMotor>(2.0),
+                                                     std::make_shared<LoadedMockMotor>(1.6),
+                                                     std::make_shared<LoadedMockMotor>(2.0)};
+  for (int step = 0; step < 500; step++) {
+    EXPECT_EQ(balancer.moveVoltage(motors, 4000, 10_ms), 1);
+  }
+
+  EXPECT_NEAR(motors[0]->getCurrentDraw(), motors[1]->getCurrentDraw(), 20);
+  EXPECT_NEAR(motors[1]->getCurrentDraw(), motors[2]->getCurrentDraw(), 20);
+}
+
+TEST_F(MotorLoadBalancerTest, OneVelocityCommandFromRestDrivesEveryMotor) {
+  std::vector<std::shared_ptr<MockMotor>> mocks{std::make_shared<LoadedMockMotor>(2.0),
+                                                std::make_shared<LoadedMockMotor>(1.6),
+                                                std::make_shared<LoadedMockMotor>(2.0)};
+  const std::vector<std::shared_ptr<AbstractMotor>> motors(mocks.begin(), mocks.end());
+
+  // Trims from earlier voltage commands don't leave any motor behind
+  for (int step = 0; step < 10; step++) {
+    balancer.moveVoltage(motors, 4000, 10_ms);
+  }
+  balancer.moveVoltage(motors, 0, 10_ms);
+
+  EXPECT_EQ(MotorLoadBalancer::moveVelocity(motors, 150), 1);
+  for (auto &&motor : mocks) {
+    EXPECT_EQ(motor->lastVelocity, 150);
+    EXPECT_EQ(motor->lastVoltage, 0);
+  }
+}
@@ -0,0 +1,239 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#include "okapi/api/device/motor/motorPowerBudget.hpp"
+#include "okapi/api/util/mathUtil.hpp"
+#include "test/tests/api/implMocks.hpp"
+#include <cmath>
+#include <gtest/gtest.h>
+
+using namespace okapi;
+
+/**
+ * A motor mock with settable thermal readings which counts how often its current limit is set.
+ */
+class ThermalMockMotor : public MockMotor {
+  public:
+  double getTemperature() override {
+    return temperature;
+  }
+
+  std::int32_t getCurrentDraw() override {
+    return currentDraw;
+  }
+
+  double getPower() override {
+    return power;
+  }
+
+  std::int32_t getCurrentLimit() override {
+    return currentLimit;
+  }
+
+  std::int32_t setCurrentLimit(const std::int32_t ilimit) override {
+    currentLimit = ilimit;
+    limitWrites++;
+    return 1;
+  }
+
+  double temperature{25};
+  std::int32_t currentDraw{0};
+  double power{0};
+  std::int32_t currentLimit{2500};
+  int limitWrites{0};
+};
+
+class MotorPowerBudgetTest : public ::testing::Test {
+  protected:
+  class SettableTimer : public AbstractTimer {
+    public:
+    explicit SettableTimer(const QTime &inow) : AbstractTimer(inow), now(inow) {
+    }
+
+    QTime millis() const override {
+      return now;
+    }
+
+    const QTime &now;
+  };
+
+  std::unique_ptr<MotorPowerBudget> makeBudget(const std::int32_t itotalCurrent) {
+    return std::make_unique<MotorPowerBudget>(
+      createTimeUtil(Supplier<std::unique_ptr<AbstractTimer>>(
+        [&]() { return std::make_unique<SettableTimer>(now); })),
+      itotalCurrent);
+  }
+
+  /**
+   * Steps the budget every 100 ms for a while.
+   */
+  void run(MotorPowerBudget &ibudget, const QTime iduration) {
+    const QTime end = now + iduration;
+    while (now < end) {
+      now += 100_ms;
+      ibudget.step();
+    }
+  }
+
+  QTime now{0_ms};
+  std::shared_ptr<ThermalMockMotor> drive1 = std::make_shared<ThermalMockMotor>();
+  std::shared_ptr<ThermalMockMotor> drive2 = std::make_shared<ThermalMockMotor>();
+  std::shared_ptr<ThermalMockMotor> intake = std::make_shared<ThermalMockMotor>();
+};
+
+TEST_F(MotorPowerBudgetTest, InvalidParametersThrow) {
+  EXPECT_THROW(makeBudget(0), std::invalid_argument);
+
+  auto budget = makeBudget(20000);
+  PowerBudgetSubsystem subsystem;
+  subsystem.weight = 0;
+  EXPECT_THROW(budget->addSubsystem({intake}, subsystem), std::invalid_argument);
+
+  subsystem = PowerBudgetSubsystem{};
+  subsystem.minCurrentLimit = 3000;
+  EXPECT_THROW(budget->addSubsystem({intake}, subsystem), std::invalid_argument);
+}
+
+TEST_F(MotorPowerBudgetTest, CoolMotorsWithinBudgetGetTheirMaximum) {
+  auto budget = makeBudget(20000);
+  PowerBudgetSubsystem driveParams;
+  driveParams.maxCurrentLimit = 1500;
+  const auto drive = budget->addSubsystem({drive1, drive2}, driveParams);
+  budget->step();
+
+  EXPECT_EQ(drive1->currentLimit, 1500);
+  EXPECT_EQ(drive2->currentLimit, 1500);
+  EXPECT_EQ(budget->getMotorStats(drive, 0).currentLimit, 1500);
+}
+
+TEST_F(MotorPowerBudgetTest, FullCurrentIsNotSustainableForAWholeMatch) {
+  auto budget = makeBudget(20000);
+  const auto drive = budget->addSubsystem({drive1});
+  budget->step();
+
+  EXPECT_LT(drive1->currentLimit, 2500);
+  EXPECT_GT(drive1->currentLimit, 1500);
+  EXPECT_EQ(budget->getMotorStats(drive, 0).currentLimit, drive1->currentLimit);
+}
+
+TEST_F(MotorPowerBudgetTest, TightBudgetIsSharedByWeight) {
+  auto budget = makeBudget(5000);
+  PowerBudgetSubsystem driveParams;
+  driveParams.weight = 3;
+  budget->addSubsystem({drive1, drive2}, driveParams);
+  budget->addSubsystem({intake});
+  budget->step();
+
+  EXPECT_NEAR(drive1->currentLimit + drive2->currentLimit + intake->currentLimit, 5000, 30);
+  EXPECT_EQ(drive1->currentLimit, drive2->currentLimit);
+  EXPECT_GT(drive1->currentLimit, intake->currentLimit);
+  EXPECT_GE(intake->currentLimit, 500);
+
+  // The drive is cut back a third as much as the intake
+  EXPECT_NEAR(2500 - drive1->currentLimit, (2500 - intake->currentLimit) / 3.0, 10);
+}
+
+TEST_F(MotorPowerBudgetTest, MinimumLimitsHoldWhenTheBudgetIsTooSmall) {
+  auto budget = makeBudget(1000);
+  budget->addSubsystem({drive1, drive2, intake});
+  budget->step();
+
+  EXPECT_EQ(drive1->currentLimit, 500);
+  EXPECT_EQ(intake->currentLimit, 500);
+}
+
+TEST_F(MotorPowerBudgetTest, HotMotorIsEasedOffAndFreesBudget) {
+  auto budget = makeBudget(5000);
+  const auto drive = budget->addSubsystem({drive1, drive2});
+  const auto intakeSubsystem = budget->addSubsystem({intake});
+  budget->step();
+  const auto coolIntakeLimit = intake->currentLimit;
+
+  // The drive has worked hard and is close to throttling
+  drive1->temperature = 50;
+  drive2->temperature = 50;
+  budget->step();
+
+  EXPECT_LT(drive1->currentLimit, 2500);
+  EXPECT_LT(budget->getMotorStats(drive, 0).sustainableCurrent, 1500);
+  EXPECT_GT(intake->currentLimit, coolIntakeLimit);
+  EXPECT_EQ(budget->getMotorStats(intakeSubsystem, 0).currentLimit, intake->currentLimit);
+}
+
+TEST_F(MotorPowerBudgetTest, SustainableCurrentRisesAsTheMatchEnds) {
+  auto budget = makeBudget(20000);
+  const auto drive = budget->addSubsystem({drive1});
+  drive1->temperature = 40;
+  budget->startMatch();
+
+  budget->step();
+  const double early = budget->getMotorStats(drive, 0).sustainableCurrent;
+
+  now += 90_s;
+  budget->step();
+  EXPECT_GT(budget->getMotorStats(drive, 0).sustainableCurrent, early);
+}
+
+TEST_F(MotorPowerBudgetTest, PredictsTimeToThrottle) {
+  auto budget = makeBudget(20000);
+  const auto drive = budget->addSubsystem({drive1});
+
+  // Idle motors never throttle
+  budget->step();
+  EXPECT_TRUE(std::isinf(budget->getTimeToThrottle(drive).convert(second)));
+
+  // Stalled at full current, the estimate heats up and the time left goes down
+  drive1->currentDraw = 2500;
+  drive1->temperature = 30;
+  run(*budget, 5_s);
+  const QTime first = budget->getTimeToThrottle(drive);
+  EXPECT_GT(first, 0_ms);
+  EXPECT_LT(first, 200_s);
+
+  run(*budget, 5_s);
+  EXPECT_LT(budget->getTimeToThrottle(drive), first);
+
+  drive1->temperature = 60;
+  budget->step();
+  EXPECT_EQ(budget->getTimeToThrottle(drive), 0_ms);
+}
+
+TEST_F(MotorPowerBudgetTest, EstimateStaysWithinTheReadingStep) {
+  auto budget = makeBudget(20000);
+  const auto drive = budget->addSubsystem({drive1});
+  drive1->temperature = 30;
+  drive1->currentDraw = 2500;
+  run(*budget, 60_s);
+
+  const auto stats = budget->getMotorStats(drive, 0);
+  EXPECT_LE(stats.estimatedTemperature, 32.5);
+  EXPECT_GE(stats.estimatedTemperature, 27.5);
+  EXPECT_NEAR(stats.meanCurrentDraw, 2500, 1);
+}
+
+TEST_F(MotorPowerBudgetTest, FailedReadingsKeepTheLastEstimate) {
+  auto budget = makeBudget(20000);
+  const auto drive = budget->addSubsystem({drive1});
+  drive1->temperature = 45;
+  drive1->power = 3;
+  budget->step();
+  const auto stats = budget->getMotorStats(drive, 0);
+
+  drive1->temperature = OKAPI_PROS_ERR_F;
+  budget->step();
+  EXPECT_EQ(budget->getMotorStats(drive, 0).estimatedTemperature, stats.estimatedTemperature);
+  EXPECT_EQ(drive1->currentLimit, stats.currentLimit);
+  EXPECT_DOUBLE_EQ(budget->getPower(drive), 3);
+}
+
+TEST_F(MotorPowerBudgetTest, UnchangedLimitsAreNotWrittenAgain) {
+  auto budget = makeBudget(20000);
+  PowerBudgetSubsystem driveParams;
+  driveParams.maxCurrentLimit = 1500;
+  budget->addSubsystem({drive1}, driveParams);
+  run(*budget, 1_s);
+
+  EXPECT_EQ(drive1->limitWrites, 1);
+}
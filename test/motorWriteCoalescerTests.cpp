@@ -0,0 +1,62 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#include "okapi/api/device/motor/motorWriteCoalescer.hpp"
+#include <gtest/gtest.h>
+
+using namespace okapi;
+
+class MotorWriteCoalescerTest : public ::testing::Test {
+  protected:
+  void SetUp() override {
+    coalescer.setEnabled(true);
+  }
+
+  MotorWriteCoalescer coalescer{100_ms};
+};
+
+TEST_F(MotorWriteCoalescerTest, DisabledCoalescerSendsEveryCommand) {
+  coalescer.setEnabled(false);
+
+  EXPECT_TRUE(coalescer.shouldWrite(MotorWriteCoalescer::command::voltage, 100, 0_ms));
+  EXPECT_TRUE(coalescer.shouldWrite(MotorWriteCoalescer::command::voltage, 100, 10_ms));
+  EXPECT_FALSE(coalescer.isEnabled());
+}
+
+TEST_F(MotorWriteCoalescerTest, SkipsARepeatedCommand) {
+  EXPECT_TRUE(coalescer.shouldWrite(MotorWriteCoalescer::command::voltage, 100, 0_ms));
+  EXPECT_FALSE(coalescer.shouldWrite(MotorWriteCoalescer::command::voltage, 100, 10_ms));
+  EXPECT_FALSE(coalescer.shouldWrite(MotorWriteCoalescer::command::voltage, 100, 90_ms));
+}
+
+TEST_F(MotorWriteCoalescerTest, SendsAChangedValueOrCommand) {
+  EXPECT_TRUE(coalescer.shouldWrite(MotorWriteCoalescer::command::voltage, 100, 0_ms));
+  EXPECT_TRUE(coalescer.shouldWrite(MotorWriteCoalescer::command::voltage, 101, 10_ms));
+  EXPECT_TRUE(coalescer.shouldWrite(MotorWriteCoalescer::command::velocity, 101, 20_ms));
+  EXPECT_FALSE(coalescer.shouldWrite(MotorWriteCoalescer::command::velocity, 101, 30_ms));
+}
+
+TEST_F(MotorWriteCoalescerTest, ResendsARepeatedCommandEveryRefreshPeriod) {
+  EXPECT_TRUE(coalescer.shouldWrite(MotorWriteCoalescer::command::velocity, 50, 0_ms));
+  EXPECT_FALSE(coalescer.shouldWrite(MotorWriteCoalescer::command::velocity, 50, 99_ms));
+  EXPECT_TRUE(coalescer.shouldWrite(MotorWriteCoalescer::command::velocity, 50, 100_ms));
+  EXPECT_FALSE(coalescer.shouldWrite(MotorWriteCoalescer::command::velocity, 50, 150_ms));
+  EXPECT_TRUE(coalescer.shouldWrite(MotorWriteCoalescer::command::velocity, 50, 200_ms));
+}
+
+TEST_F(MotorWriteCoalescerTest, InvalidateSendsTheNextCommand) {
+  EXPECT_TRUE(coalescer.shouldWrite(MotorWriteCoalescer::command::voltage, 100, 0_ms));
+  coalescer.invalidate();
+  EXPECT_TRUE(coalescer.shouldWrite(MotorWriteCoalescer::command::voltage, 100, 10_ms));
+  EXPECT_FALSE(coalescer.shouldWrite(MotorWriteCoalescer::command::voltage, 100, 20_ms));
+}
+
+TEST_F(MotorWriteCoalescerTest, ZeroRefreshPeriodSendsEveryCommand) {
+  coalescer.setRefreshPeriod(0_ms);
+
+  EXPECT_TRUE(coalescer.shouldWrite(MotorWriteCoalescer::command::voltage, 100, 0_ms));
+  EXPECT_TRUE(coalescer.shouldWrite(MotorWriteCoalescer::command::voltage, 100, 0_ms));
+  EXPECT_EQ(coalescer.getRefreshPeriod(), 0_ms);
+}
@@ -0,0 +1,57 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#include "okapi/api/chassis/controller/moveMonitor.hpp"
+#include <gtest/gtest.h>
+
+using namespace okapi;
+
+TEST(MoveMonitorTest, NeverEndsAMovementByDefault) {
+  MoveMonitor monitor;
+  monitor.start(0_ms, 0);
+  EXPECT_FALSE(monitor.check(100_s, 0));
+}
+
+TEST(MoveMonitorTest, TimesOut) {
+  MoveMonitor monitor;
+  monitor.setTimeout(2_s);
+  monitor.start(1_s, 0);
+
+  EXPECT_FALSE(monitor.check(2900_ms, 100));
+  EXPECT_EQ(monitor.check(3_s, 200), MoveResult::timedOut);
+}
+
+TEST(MoveMonitorTest, StallsOnceTheRobotStopsMoving) {
+  MoveMonitor monitor;
+  monitor.setStallDetection(100, 200_ms);
+  monitor.start(0_ms, 0);
+
+  // Moving at 500 per second
+  for (int i = 1; i <= 10; i++) {
+    EXPECT_FALSE(monitor.check(i * 20_ms, i * 10.0));
+  }
+
+  // Then creeping at 50 per second, under the min speed
+  EXPECT_FALSE(monitor.check(300_ms, 105));
+  EXPECT_FALSE(monitor.check(370_ms, 109));
+  EXPECT_EQ(monitor.check(380_ms, 110), MoveResult::stalled);
+}
+
+TEST(MoveMonitorTest, StartResetsTheStall) {
+  MoveMonitor monitor;
+  monitor.setStallDetection(100, 200_ms);
+  monitor.start(0_ms, 0);
+  EXPECT_EQ(monitor.check(200_ms, 0), MoveResult::stalled);
+
+  monitor.start(200_ms, 0);
+  EXPECT_FALSE(monitor.check(300_ms, 0));
+}
+
+TEST(MoveMonitorTest, ZeroStallTimeTurnsStallDetectionOff) {
+  MoveMonitor monitor;
+  monitor.setStallDetection(100, 0_ms);
+  monitor.start(0_ms, 0);
+  EXPECT_FALSE(monitor.check(10_s, 0));
+}
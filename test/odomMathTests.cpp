@@ -4,6 +4,7 @@
  * file, You can obtain one at http://mozilla.org/MPL/2.0/.
  */
 #include "okapi/api/odometry/odomMath.hpp"
+#include <cmath>
 #include <gtest/gtest.h>
 
 using namespace okapi;
@@ -54,3 +55,72 @@ TEST(OdomMathTests, ConstrainAngle180) {
   angle = OdomMath::constrainAngle180(181.0_deg);
   EXPECT_FLOAT_EQ(-179.0, angle.convert(degree));
 }
+
+TEST(OdomMathTests, IntegrateExponentialMapStraight) {
+  const auto delta = OdomMath::integrateExponentialMap(1_m, 0_m, 0_deg, 90_deg);
+  EXPECT_NEAR(delta.x.convert(meter), 0, 1e-12);
+  EXPECT_NEAR(delta.y.convert(meter), 1, 1e-12);
+  EXPECT_EQ(delta.theta, 0_deg);
+}
+
+TEST(OdomMathTests, IntegrateExponentialMapQuarterTurn) {
+  // A quarter of a circle with a radius of 1 m, turning right
+  const auto delta = OdomMath::integrateExponentialMap(1_pi / 2 * meter, 0_m, 90_deg, 0_deg);
+  EXPECT_NEAR(delta.x.convert(meter), 1, 1e-12);
+  EXPECT_NEAR(delta.y.convert(meter), 1, 1e-12);
+  EXPECT_NEAR(delta.theta.convert(degree), 90, 1e-12);
+}
+
+TEST(OdomMathTests, IntegrateExponentialMapStrafe) {
+  const auto delta = OdomMath::integrateExponentialMap(0_m, 1_m, 0_deg, 90_deg);
+  EXPECT_NEAR(delta.x.convert(meter), -1, 1e-12);
+  EXPECT_NEAR(delta.y.convert(meter), 0, 1e-12);
+}
+
+TEST(OdomMathTests, IntegrateExponentialMapSmallTurnsMatchTheArc) {
+  const double theta = 0.3;
+  for (const double deltaTheta : {1e-6, 5e-4, 9.99e-4, 1.001e-3, 1e-2}) {
+    // The arc of length 1 m around a circle with a radius of 1 / deltaTheta
+    const double radius = 1 / deltaTheta;
+    const double expectedX = (std::sin(theta + deltaTheta) - std::sin(theta)) * radius;
+    const double expectedY = (std::cos(theta) - std::cos(theta + deltaTheta)) * radius;
+
+    const auto delta =
+      OdomMath::integrateExponentialMap(1_m, 0_m, deltaTheta * radian, theta * radian);
+    EXPECT_NEAR(delta.x.convert(meter), expectedX, 1e-9) << deltaTheta;
+    EXPECT_NEAR(delta.y.convert(meter), expectedY, 1e-9) << deltaTheta;
+  }
+}
+
+TEST(OdomMathTests, ComputeDistancesAndAnglesToPointsMatchesOnePointAtATime) {
+  const OdomState state{1_m, -2_m, 75_deg};
+  const Point points[] = {{2_m, 3_m}, {-1_m, 0_m}, {1_m, -2_m}, {0_m, -5_m}};
+  QLength distances[4];
+  QAngle angles[4];
+  OdomMath::computeDistancesAndAnglesToPoints(points, 4, state, distances, angles);
+
+  for (std::size_t i = 0; i < 4; i++) {
+    const auto [dist, angle] = OdomMath::computeDistanceAndAngleToPoint(points[i], state);
+    EXPECT_DOUBLE_EQ(distances[i].convert(meter), dist.convert(meter)) << i;
+    EXPECT_DOUBLE_EQ(angles[i].convert(radian), angle.convert(radian)) << i;
+  }
+}
+
+TEST(OdomMathTests, ComputeDistancesAndAnglesToPointsSkipsNullOutputs) {
+  const Point points[] = {{3_m, 4_m}};
+  QLength distances[1];
+  OdomMath::computeDistancesAndAnglesToPoints(points, 1, OdomState{}, distances, nullptr);
+  EXPECT_DOUBLE_EQ(distances[0].convert(meter), 5);
+
+  QAngle angles[1];
+  OdomMath::computeDistancesAndAnglesToPoints(points, 1, OdomState{}, nullptr, angles);
+  EXPECT_DOUBLE_EQ(angles[0].convert(radian), atan2(4, 3));
+}
+
+TEST(OdomMathTests, FindClosestPoint) {
+  const OdomState state{1_m, 1_m, 0_deg};
+  const Point points[] = {{5_m, 5_m}, {2_m, 1_m}, {1_m, 2_m}, {-3_m, 1_m}};
+  EXPECT_EQ(OdomMath::findClosestPoint(points, 4, state), 1u);
+  EXPECT_EQ(OdomMath::findClosestPoint(points, 1, state), 0u);
+  EXPECT_EQ(OdomMath::findClosestPoint(points, 0, state), 0u);
+}
@@ -0,0 +1,300 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+/**
+ * Replays recorded encoder readings through odometry and reports how far the final pose is from
+ * the ground truth, and how long each step took. Run these after changing the odometry math to
+ * check both accuracy and speed:
+ *
+ *   ./OkapiLibV5 --gtest_filter='OdometryReplayTest.*'
+ *
+ * A recording is the CSV the `telemetryDecoder` tool writes for the channel recorded by
+ * `TwoEncoderOdometry::recordSensors`, with lines added at the top for the chassis scales and the
+ * pose the robot really finished at, with lengths in meters:
+ *
+ *   # scales: <wheel diameter>,<wheel track>[,<middle distance>,<middle diameter>],<tpr>
+ *   # truth: <x (m)>,<y (m)>,<theta (deg)>
+ *   time_ms,sensor0,sensor1[,sensor2]
+ *
+ * Recordings with a middle encoder are replayed through ThreeEncoderOdometry. To replay a recording
+ * of your own, set `OKAPI_ODOMETRY_RECORDING` to its path.
+ */
+#include "okapi/api/odometry/threeEncoderOdometry.hpp"
+#include "okapi/api/odometry/twoEncoderOdometry.hpp"
+#include "test/tests/api/implMocks.hpp"
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <fstream>
+#include <gtest/gtest.h>
+#include <iostream>
+#include <sstream>
+#include <unistd.h>
+
+using namespace okapi;
+
+struct OdometryRecording {
+  std::string name;
+  std::vector<QLength> dimensions{};
+  double tpr{0};
+  bool hasTruth{false};
+  OdomState truth{};
+  std::size_t sensorCount{0};
+  std::vector<std::uint32_t> times{};
+  std::vector<ReadOnlyChassisModel::SensorValues> ticks{};
+};
+
+struct OdometryReplayResult {
+  OdomState state{};
+  double nanosecondsPerStep{0};
+};
+
+/**
+ * Returns the readings of the current step of a replay.
+ */
+class ReplayChassisModel : public MockReadOnlyChassisModel {
+  public:
+  explicit ReplayChassisModel(const std::size_t isensorCount) : sensorCount(isensorCount) {
+  }
+
+  std::valarray<std::int32_t> getSensorVals() const override {
+    return std::valarray<std::int32_t>(values.data(), sensorCount);
+  }
+
+  std::size_t getSensorVals(SensorValues &ovalues) const override {
+    ovalues = values;
+    return sensorCount;
+  }
+
+  std::size_t getSensorSamples(SensorValues &ovalues,
+                               SensorTimestamps &otimestamps) const override {
+    otimestamps.fill(0);
+    return getSensorVals(ovalues);
+  }
+
+  std::size_t sensorCount;
+  SensorValues values{};
+};
+
+/**
+ * Returns the time of the current step of a replay.
+ */
+class ReplayTimer : public AbstractTimer {
+  public:
+  explicit ReplayTimer(std::shared_ptr<QTime> itime)
+    : AbstractTimer(*itime), time(std::move(itime)) {
+  }
+
+  QTime millis() const override {
+    return *time;
+  }
+
+  std::shared_ptr<QTime> time;
+};
+
+static std::vector<double> parseNumbers(const std::string &iline) {
+  std::vector<double> numbers;
+  std::stringstream stream(iline);
+  std::string field;
+  while (std::getline(stream, field, ',')) {
+    numbers.push_back(std::stod(field));
+  }
+  return numbers;
+}
+
+static bool loadRecording(const std::string &ipath, OdometryRecording &orecording) {
+  std::ifstream file(ipath);
+  if (!file.good()) {
+    ADD_FAILURE() << "couldn't read " << ipath;
+    return false;
+  }
+
+  orecording.name = ipath.substr(ipath.find_last_of('/') + 1);
+  std::string line;
+  while (std::getline(file, line)) {
+    if (line.rfind("# scales:", 0) == 0) {
+      const auto numbers = parseNumbers(line.substr(9));
+      for (std::size_t i = 0; i + 1 < numbers.size(); i++) {
+        orecording.dimensions.push_back(numbers[i] * meter);
+      }
+      orecording.tpr = numbers.empty() ? 0 : numbers.back();
+    } else if (line.rfind("# truth:", 0) == 0) {
+      const auto numbers = parseNumbers(line.substr(8));
+      if (numbers.size() == 3) {
+        orecording.truth = {numbers[0] * meter, numbers[1] * meter, numbers[2] * degree};
+        orecording.hasTruth = true;
+      }
+    } else if (!line.empty() && line[0] != '#' && line.rfind("time_ms", 0) != 0) {
+      const auto numbers = parseNumbers(line);
+      const std::size_t sensorCount =
+        std::min(numbers.size() - 1, ReadOnlyChassisModel::maxSensorCount);
+      orecording.sensorCount = std::max(orecording.sensorCount, sensorCount);
+
+      ReadOnlyChassisModel::SensorValues values{};
+      for (std::size_t i = 0; i < sensorCount; i++) {
+        values[i] = static_cast<std::int32_t>(std::lround(numbers[i + 1]));
+      }
+      orecording.times.push_back(static_cast<std::uint32_t>(numbers[0]));
+      orecording.ticks.push_back(values);
+    }
+  }
+
+  if (orecording.dimensions.size() != 2 && orecording.dimensions.size() != 4) {
+    ADD_FAILURE() << ipath << " needs a line with the chassis scales";
+    return false;
+  }
+
+  if (orecording.ticks.empty()) {
+    ADD_FAILURE() << ipath << " has no readings";
+    return false;
+  }
+
+  return true;
+}
+
+static OdometryReplayResult replayRecording(const OdometryRecording &irecording,
+                                            const OdomIntegration &iintegration) {
+  auto model = std::make_shared<ReplayChassisModel>(irecording.sensorCount);
+  auto time = std::make_shared<QTime>(irecording.times.front() * millisecond);
+  const auto timeUtil =
+    createTimeUtil(Supplier<std::unique_ptr<AbstractTimer>>([=]() {
+      return std::make_unique<ReplayTimer>(time);
+    }));
+
+  const auto &dimensions = irecording.dimensions;
+  std::unique_ptr<TwoEncoderOdometry> odom;
+  if (dimensions.size() == 4 && irecording.sensorCount >= 3) {
+    odom = std::make_unique<ThreeEncoderOdometry>(
+      timeUtil,
+      model,
+      ChassisScales({dimensions[0], dimensions[1], dimensions[2], dimensions[3]}, irecording.tpr));
+  } else {
+    odom = std::make_unique<TwoEncoderOdometry>(
+      timeUtil, model, ChassisScales({dimensions[0], dimensions[1]}, irecording.tpr));
+  }
+  odom->setIntegration(iintegration);
+
+  const auto start = std::chrono::steady_clock::now();
+  for (std::size_t i = 0; i < irecording.ticks.size(); i++) {
+    *time = irecording.times[i] * millisecond;
+    model->values = irecording.ticks[i];
+    odom->step();
+  }
+  const auto elapsed = std::chrono::steady_clock::now() - start;
+
+  return {odom->getState(),
+          static_cast<double>(
+            std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count()) /
+            irecording.ticks.size()};
+}
+
+static QLength positionError(const OdometryRecording &irecording,
+                             const OdometryReplayResult &iresult) {
+  return std::hypot((iresult.state.x - irecording.truth.x).convert(meter),
+                    (iresult.state.y - irecording.truth.y).convert(meter)) *
+         meter;
+}
+
+static QAngle headingError(const OdometryRecording &irecording,
+                           const OdometryReplayResult &iresult) {
+  return abs(iresult.state.theta - irecording.truth.theta);
+}
+
+static void reportReplay(const OdometryRecording &irecording,
+                         const std::string &iintegrationName,
+                         const OdometryReplayResult &iresult) {
+  std::cout << "[ REPLAY   ] " << irecording.name << " " << iintegrationName << ": "
+            << irecording.ticks.size() << " steps, " << iresult.nanosecondsPerStep
+            << " ns/step, final pose " << iresult.state.str();
+  if (irecording.hasTruth) {
+    std::cout << ", position error " << positionError(irecording, iresult).convert(centimeter)
+              << " cm, heading error " << headingError(irecording, iresult).convert(degree)
+              << " deg";
+  }
+  std::cout << std::endl;
+}
+
+static std::string recordingPath(const std::string &iname) {
+  char workingPath[FILENAME_MAX];
+  return std::string(getcwd(workingPath, sizeof(workingPath)) ? workingPath : "") +
+         "/../test/odometryRecordings/" + iname;
+}
+
+static void expectReplayMatchesTruth(const std::string &iname,
+                                     const QLength &imaxPositionError,
+                                     const QAngle &imaxHeadingError) {
+  OdometryRecording recording;
+  ASSERT_TRUE(loadRecording(recordingPath(iname), recording));
+  ASSERT_TRUE(recording.hasTruth);
+
+  for (const auto &[integration, integrationName] :
+       {std::make_pair(OdomIntegration::ARC, "ARC"),
+        std::make_pair(OdomIntegration::EXPONENTIAL_MAP, "EXPONENTIAL_MAP")}) {
+    const auto result = replayRecording(recording, integration);
+    reportReplay(recording, integrationName, result);
+    EXPECT_LT(positionError(recording, result), imaxPositionError) << integrationName;
+    EXPECT_LT(headingError(recording, result), imaxHeadingError) << integrationName;
+  }
+}
+
+TEST(OdometryReplayTest, TwoEncoderDrive) {
+  expectReplayMatchesTruth("twoEncoderDrive.csv", 1_mm, 0.2_deg);
+}
+
+TEST(OdometryReplayTest, ThreeEncoderStrafe) {
+  expectReplayMatchesTruth("threeEncoderStrafe.csv", 1_mm, 0.2_deg);
+}
+
+TEST(OdometryReplayTest, RecordingFromEnvironment) {
+  const char *path = std::getenv("OKAPI_ODOMETRY_RECORDING");
+  if (path == nullptr) {
+    return;
+  }
+
+  OdometryRecording recording;
+  ASSERT_TRUE(loadRecording(path, recording));
+  reportReplay(recording, "ARC", replayRecording(recording, OdomIntegration::ARC));
+  reportReplay(
+    recording, "EXPONENTIAL_MAP", replayRecording(recording, OdomIntegration::EXPONENTIAL_MAP));
+}
+
+TEST(OdometryReplayTest, RecordedSensorsCanBeReplayed) {
+  char *buffer = nullptr;
+  size_t size = 0;
+
+  auto model = std::make_shared<ReplayChassisModel>(2);
+  {
+    auto telemetry = std::make_shared<TelemetryLogger>(
+      std::make_unique<ConstantMockTimer>(0_ms), open_memstream(&buffer, &size));
+    TwoEncoderOdometry odom(
+      createConstantTimeUtil(10_ms), model, ChassisScales({{4_in, 10_in}, 360}));
+    odom.recordSensors(telemetry);
+
+    for (std::int32_t i = 1; i <= 5; i++) {
+      model->values = {i * 10, i * 20};
+      odom.step();
+    }
+    telemetry->flush();
+  }
+
+  std::stringstream stream(std::string(buffer, size));
+  free(buffer);
+
+  std::vector<TelemetryFormat::Sample> samples;
+  EXPECT_TRUE(TelemetryFormat::decode(
+    stream,
+    [](const TelemetryFormat::Channel &ichannel) {
+      EXPECT_EQ(ichannel.name, "odometrySensors");
+      EXPECT_EQ(ichannel.fieldNames, std::vector<std::string>({"sensor0", "sensor1"}));
+    },
+    [&](const TelemetryFormat::Sample &isample) { samples.push_back(isample); }));
+
+  ASSERT_EQ(samples.size(), 5u);
+  for (std::size_t i = 0; i < samples.size(); i++) {
+    const double step = static_cast<double>(i + 1);
+    EXPECT_EQ(samples[i].values, std::vector<double>({step * 10, step * 20}));
+  }
+}
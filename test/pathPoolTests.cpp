@@ -0,0 +1,135 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#include "okapi/api/control/util/pathPool.hpp"
+#include <gtest/gtest.h>
+
+using namespace okapi;
+
+static PathPool::Path makePath(const std::size_t isize, const double itimeStep = 0.01) {
+  PathPool::Path path;
+  for (std::size_t i = 0; i < isize; i++) {
+    const double t = static_cast<double>(i) * itimeStep;
+    path.emplace_back(squiggles::ControlVector(squiggles::Pose(t, 0, 0), 1, 0, 0),
+                      std::vector<double>{1, 1},
+                      0,
+                      t);
+  }
+  return path;
+}
+
+class PathPoolTest : public ::testing::Test {
+  protected:
+  std::shared_ptr<PathPool> pool = std::make_shared<PathPool>(2);
+};
+
+TEST_F(PathPoolTest, StoredPathHasThePoints) {
+  const auto expected = makePath(5);
+  const auto path = pool->store(expected);
+  EXPECT_EQ(*path, expected);
+}
+
+TEST_F(PathPoolTest, FreedBufferIsReusedForASmallerPath) {
+  auto first = pool->store(makePath(10));
+  const auto *buffer = first->data();
+  first.reset();
+  EXPECT_EQ(pool->getStats().pooledPaths, 1u);
+
+  const auto expected = makePath(5, 0.02);
+  const auto second = pool->store(expected);
+  EXPECT_EQ(second->data(), buffer);
+  EXPECT_EQ(*second, expected);
+
+  const auto stats = pool->getStats();
+  EXPECT_EQ(stats.reuses, 1u);
+  EXPECT_EQ(stats.allocations, 1u);
+  EXPECT_EQ(stats.pooledPaths, 0u);
+}
+
+TEST_F(PathPoolTest, BufferWhichIsTooSmallIsNotReused) {
+  pool->store(makePath(3));
+  pool->store(makePath(10));
+
+  const auto stats = pool->getStats();
+  EXPECT_EQ(stats.reuses, 0u);
+  EXPECT_EQ(stats.allocations, 2u);
+  EXPECT_EQ(stats.pooledPaths, 2u);
+}
+
+TEST_F(PathPoolTest, SmallestBufferWhichFitsIsReused) {
+  auto large = pool->store(makePath(20));
+  auto small = pool->store(makePath(8));
+  const auto *smallBuffer = small->data();
+  large.reset();
+  small.reset();
+
+  const auto path = pool->store(makePath(6));
+  EXPECT_EQ(path->data(), smallBuffer);
+}
+
+TEST_F(PathPoolTest, StatsTrackTheMemoryInUse) {
+  auto path = pool->store(makePath(10));
+  const auto bytes = PathPool::estimatePathBytes(*path);
+
+  auto stats = pool->getStats();
+  EXPECT_EQ(stats.pathsInUse, 1u);
+  EXPECT_EQ(stats.bytesInUse, bytes);
+  EXPECT_EQ(stats.peakBytesInUse, bytes);
+
+  path.reset();
+  stats = pool->getStats();
+  EXPECT_EQ(stats.pathsInUse, 0u);
+  EXPECT_EQ(stats.bytesInUse, 0u);
+  EXPECT_EQ(stats.peakBytesInUse, bytes);
+  EXPECT_EQ(stats.pooledBytes, bytes);
+  // Nothing is stored in the kept buffer
+  EXPECT_DOUBLE_EQ(stats.getFragmentation(), 1);
+}
+
+TEST_F(PathPoolTest, ReusingALargerBufferIsFragmentation) {
+  pool->store(makePath(10));
+  const auto path = pool->store(makePath(4));
+
+  const auto stats = pool->getStats();
+  EXPECT_GT(stats.wastedBytes, 0u);
+  EXPECT_GT(stats.getFragmentation(), 0);
+  EXPECT_LT(stats.getFragmentation(), 1);
+}
+
+TEST_F(PathPoolTest, ReleaseFreesTheKeptBuffers) {
+  pool->store(makePath(10));
+  pool->store(makePath(20));
+  pool->release();
+
+  const auto stats = pool->getStats();
+  EXPECT_EQ(stats.pooledPaths, 0u);
+  EXPECT_EQ(stats.pooledBytes, 0u);
+}
+
+TEST_F(PathPoolTest, KeepsAtMostTheMaxPooledPaths) {
+  pool->store(makePath(10));
+  pool->store(makePath(20));
+  pool->store(makePath(30));
+  EXPECT_EQ(pool->getStats().pooledPaths, 2u);
+
+  pool->setMaxPooledPaths(1);
+  EXPECT_EQ(pool->getStats().pooledPaths, 1u);
+}
+
+TEST_F(PathPoolTest, PathCanOutliveThePool) {
+  const auto expected = makePath(5);
+  auto path = pool->store(expected);
+  pool.reset();
+
+  EXPECT_EQ(*path, expected);
+  path.reset();
+}
+
+TEST(PathPoolUnownedTest, PoolWhichIsNotSharedStillStoresPaths) {
+  PathPool pool;
+  const auto expected = makePath(3);
+  EXPECT_EQ(*pool.store(expected), expected);
+  EXPECT_EQ(pool.getStats().pathsInUse, 0u);
+}
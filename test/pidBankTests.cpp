@@ -0,0 +1,145 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#include "okapi/api/control/iterative/pidBank.hpp"
+#include "test/tests/api/implMocks.hpp"
+#include <gtest/gtest.h>
+
+using namespace okapi;
+
+class PidBankTest : public ::testing::Test {
+  protected:
+  void SetUp() override {
+    bank = std::make_unique<PidBank<3>>(createConstantTimeUtil(10_ms));
+  }
+
+  std::unique_ptr<PidBank<3>> bank;
+};
+
+TEST_F(PidBankTest, MatchesIterativePosPIDController) {
+  const std::array<IterativePosPIDController::Gains, 3> gains{
+    {{0.01, 0.001, 0.0001, 0}, {0.005, 0, 0.0002, 0.1}, {0.02, 0.01, 0, 0}}};
+  const std::array<double, 3> targets{500, -200, 50};
+
+  std::vector<std::unique_ptr<IterativePosPIDController>> pids;
+  for (std::size_t i = 0; i < 3; i++) {
+    bank->setGains(i, gains[i]);
+    bank->setTarget(i, targets[i]);
+    pids.push_back(
+      std::make_unique<IterativePosPIDController>(gains[i], createConstantTimeUtil(10_ms)));
+    pids.back()->setTarget(targets[i]);
+  }
+
+  std::array<double, 3> readings{0, 0, 0};
+  for (int step = 0; step < 200; step++) {
+    const auto outputs = bank->step(readings);
+    for (std::size_t i = 0; i < 3; i++) {
+      EXPECT_DOUBLE_EQ(outputs[i], pids[i]->step(readings[i])) << "axis " << i << " step " << step;
+
+      // A crude plant so the error crosses zero and the integral saturates
+      readings[i] += outputs[i] * 20;
+    }
+  }
+}
+
+TEST_F(PidBankTest, AxisViewIsAnIterativePositionController) {
+  auto view = std::make_shared<PidBank<3>::Axis>(bank->axis(1));
+  std::shared_ptr<IterativePositionController<double, double>> controller = view;
+
+  bank->setGains(1, {0.1, 0, 0, 0});
+  controller->setTarget(10);
+  EXPECT_DOUBLE_EQ(bank->getTarget(1), 10);
+  EXPECT_DOUBLE_EQ(controller->step(4), 0.6);
+  EXPECT_DOUBLE_EQ(controller->getError(), 6);
+  EXPECT_DOUBLE_EQ(controller->getProcessValue(), 4);
+
+  // The other axes are left alone
+  EXPECT_DOUBLE_EQ(bank->getOutput(0), 0);
+  EXPECT_DOUBLE_EQ(bank->getOutput(2), 0);
+}
+
+TEST_F(PidBankTest, DisabledAxesOutputZeroAndAreNotStepped) {
+  bank->setGains(0, {0.1, 0, 0, 0});
+  bank->setTarget(0, 10);
+  bank->flipDisable(0, true);
+
+  EXPECT_DOUBLE_EQ(bank->step({5, 0, 0})[0], 0);
+  EXPECT_TRUE(bank->isSettled(0));
+  EXPECT_DOUBLE_EQ(bank->axis(0).getProcessValue(), 0);
+
+  bank->flipDisable(0, false);
+  EXPECT_DOUBLE_EQ(bank->step({5, 0, 0})[0], 0.5);
+}
+
+TEST_F(PidBankTest, SettlesAfterTheSettleTime) {
+  bank->setSettleLimits(0, 1, 1, 50_ms);
+  bank->setTarget(0, 10);
+
+  // 10 ms steps, so the axis has been in range for more than 50 ms on the seventh step
+  for (int i = 0; i < 6; i++) {
+    bank->step({10, 0, 0});
+    EXPECT_FALSE(bank->isSettled(0));
+  }
+  bank->step({10, 0, 0});
+  EXPECT_TRUE(bank->isSettled(0));
+
+  bank->step({20, 0, 0});
+  EXPECT_FALSE(bank->isSettled(0));
+  EXPECT_FALSE(bank->isSettled());
+}
+
+TEST_F(PidBankTest, OutputLimitsAreClamped) {
+  auto view = bank->axis(2);
+  view.setOutputLimits(-0.5, 0.5);
+  bank->setGains(2, {1, 0, 0, 0});
+  bank->setTarget(2, 100);
+  EXPECT_DOUBLE_EQ(bank->step({0, 0, 0})[2], 0.5);
+  EXPECT_DOUBLE_EQ(view.getMaxOutput(), 0.5);
+  EXPECT_DOUBLE_EQ(view.getMinOutput(), -0.5);
+}
+
+TEST_F(PidBankTest, GetGainsReturnsTheSetGains) {
+  bank->setGains(0, {0.1, 0.2, 0.3, 0.4});
+  EXPECT_EQ(bank->getGains(0), (IterativePosPIDController::Gains{0.1, 0.2, 0.3, 0.4}));
+
+  // The gains are per second, so they don't change with the sample time
+  bank->setSampleTime(20_ms);
+  const auto gains = bank->getGains(0);
+  EXPECT_DOUBLE_EQ(gains.kI, 0.2);
+  EXPECT_DOUBLE_EQ(gains.kD, 0.3);
+  EXPECT_EQ(bank->axis(0).getSampleTime(), 20_ms);
+}
+
+TEST_F(PidBankTest, OutOfRangeAxisThrows) {
+  EXPECT_THROW(bank->axis(3), std::invalid_argument);
+  EXPECT_THROW(bank->setTarget(3, 0), std::invalid_argument);
+}
+
+TEST(PidBankFloatTest, MatchesIterativePosPIDController) {
+  PidBank<4, float> bank(createConstantTimeUtil(10_ms));
+  const IterativePosPIDController::Gains gains{0.01, 0.001, 0.0001, 0};
+  IterativePosPIDController pid(gains, createConstantTimeUtil(10_ms));
+  bank.setGains(0, gains);
+  bank.setTarget(0, 500);
+  pid.setTarget(500);
+
+  float reading = 0;
+  for (int step = 0; step < 200; step++) {
+    const float output = bank.step({reading, 0, 0, 0})[0];
+    EXPECT_NEAR(output, pid.step(reading), 1e-4) << "step " << step;
+    reading += output * 20;
+  }
+}
+
+TEST(PidBankFloatTest, AxisViewReadsAndWritesDoubles) {
+  PidBank<4, float> bank(createConstantTimeUtil(10_ms));
+  auto view = bank.axis(2);
+
+  bank.setGains(2, {0.1, 0, 0, 0});
+  view.setTarget(10);
+  EXPECT_FLOAT_EQ(bank.getTarget(2), 10);
+  EXPECT_NEAR(view.step(4), 0.6, 1e-6);
+  EXPECT_NEAR(view.getError(), 6, 1e-6);
+}
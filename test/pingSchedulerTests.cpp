@@ -0,0 +1,108 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#include "okapi/api/device/pingScheduler.hpp"
+#include "okapi/api/util/mathUtil.hpp"
+#include "test/tests/api/implMocks.hpp"
+#include <gtest/gtest.h>
+
+using namespace okapi;
+
+class MockPingSensor : public AbstractPingSensor {
+  public:
+  double controllerGet() override {
+    reads++;
+    return pinging ? reading : OKAPI_PROS_ERR;
+  }
+
+  std::int32_t startPinging() override {
+    pinging = true;
+    starts++;
+    return 1;
+  }
+
+  std::int32_t stopPinging() override {
+    pinging = false;
+    return 1;
+  }
+
+  double reading{0};
+  bool pinging{true};
+  int reads{0};
+  int starts{0};
+};
+
+class PingSchedulerTest : public ::testing::Test {
+  protected:
+  std::shared_ptr<MockPingSensor> sensor1 = std::make_shared<MockPingSensor>();
+  std::shared_ptr<MockPingSensor> sensor2 = std::make_shared<MockPingSensor>();
+  std::shared_ptr<MockPingSensor> sensor3 = std::make_shared<MockPingSensor>();
+  PingScheduler scheduler{createTimeUtil()};
+};
+
+TEST_F(PingSchedulerTest, AddedSensorsAreStopped) {
+  scheduler.addSensor(sensor1);
+  EXPECT_FALSE(sensor1->pinging);
+  EXPECT_EQ(scheduler.get(0), OKAPI_PROS_ERR);
+}
+
+TEST_F(PingSchedulerTest, OnlyOneSensorPingsAtATime) {
+  scheduler.addSensor(sensor1);
+  scheduler.addSensor(sensor2);
+  scheduler.addSensor(sensor3);
+
+  scheduler.step();
+  EXPECT_TRUE(sensor1->pinging);
+  EXPECT_FALSE(sensor2->pinging);
+  EXPECT_FALSE(sensor3->pinging);
+
+  scheduler.step();
+  EXPECT_FALSE(sensor1->pinging);
+  EXPECT_TRUE(sensor2->pinging);
+  EXPECT_FALSE(sensor3->pinging);
+
+  scheduler.step();
+  scheduler.step();
+  EXPECT_TRUE(sensor1->pinging);
+  EXPECT_FALSE(sensor2->pinging);
+  EXPECT_FALSE(sensor3->pinging);
+}
+
+TEST_F(PingSchedulerTest, ReadsEachSensorAtTheEndOfItsTurn) {
+  scheduler.addSensor(sensor1);
+  scheduler.addSensor(sensor2);
+  sensor1->reading = 10;
+  sensor2->reading = 20;
+
+  scheduler.step();
+  EXPECT_EQ(sensor1->reads, 0);
+
+  scheduler.step();
+  EXPECT_EQ(sensor1->reads, 1);
+  EXPECT_EQ(scheduler.get(0), 10);
+  EXPECT_EQ(scheduler.get(1), OKAPI_PROS_ERR);
+
+  scheduler.step();
+  EXPECT_EQ(sensor2->reads, 1);
+  EXPECT_EQ(scheduler.get(1), 20);
+
+  // The cache keeps the last reading while the sensor waits for its turn
+  sensor1->reading = 15;
+  EXPECT_EQ(scheduler.get(0), 10);
+}
+
+TEST_F(PingSchedulerTest, ASingleSensorIsNeverStopped) {
+  scheduler.addSensor(sensor1);
+  sensor1->reading = 10;
+
+  for (int i = 0; i < 5; i++) {
+    scheduler.step();
+  }
+
+  EXPECT_TRUE(sensor1->pinging);
+  EXPECT_EQ(sensor1->starts, 1);
+  EXPECT_EQ(sensor1->reads, 4);
+  EXPECT_EQ(scheduler.get(0), 10);
+}
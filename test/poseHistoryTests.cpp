@@ -0,0 +1,105 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#include "okapi/api/odometry/poseHistory.hpp"
+#include <atomic>
+#include <gtest/gtest.h>
+#include <thread>
+
+using namespace okapi;
+
+TEST(PoseHistoryTest, EmptyHistoryHasNoState) {
+  PoseHistory history;
+  OdomState state;
+  QTime time;
+  EXPECT_FALSE(history.getStateAt(0_ms, state));
+  EXPECT_FALSE(history.getLatest(time, state));
+  EXPECT_EQ(history.getCapacity(), PoseHistory::defaultCapacity);
+}
+
+TEST(PoseHistoryTest, InterpolatesBetweenPoses) {
+  PoseHistory history;
+  history.record(10_ms, {0_m, 0_m, 0_deg});
+  history.record(20_ms, {1_m, 2_m, 10_deg});
+
+  OdomState state;
+  EXPECT_TRUE(history.getStateAt(15_ms, state));
+  EXPECT_NEAR(state.x.convert(meter), 0.5, 1e-9);
+  EXPECT_NEAR(state.y.convert(meter), 1, 1e-9);
+  EXPECT_NEAR(state.theta.convert(degree), 5, 1e-9);
+
+  EXPECT_TRUE(history.getStateAt(20_ms, state));
+  EXPECT_NEAR(state.x.convert(meter), 1, 1e-9);
+}
+
+TEST(PoseHistoryTest, TimesOutsideTheHistoryAreClamped) {
+  PoseHistory history;
+  history.record(10_ms, {1_m, 0_m, 0_deg});
+  history.record(20_ms, {2_m, 0_m, 0_deg});
+
+  OdomState state;
+  EXPECT_TRUE(history.getStateAt(0_ms, state));
+  EXPECT_EQ(state, (OdomState{1_m, 0_m, 0_deg}));
+  EXPECT_TRUE(history.getStateAt(30_ms, state));
+  EXPECT_EQ(state, (OdomState{2_m, 0_m, 0_deg}));
+}
+
+TEST(PoseHistoryTest, GetLatest) {
+  PoseHistory history;
+  history.record(10_ms, {1_m, 0_m, 0_deg});
+  history.record(20_ms, {2_m, 3_m, 4_deg});
+
+  OdomState state;
+  QTime time;
+  EXPECT_TRUE(history.getLatest(time, state));
+  EXPECT_EQ(time, 20_ms);
+  EXPECT_EQ(state, (OdomState{2_m, 3_m, 4_deg}));
+}
+
+TEST(PoseHistoryTest, FullHistoryOverwritesTheOldestPose) {
+  PoseHistory history(4);
+  for (int i = 0; i < 10; i++) {
+    history.record(i * 10_ms, {i * 1_m, 0_m, 0_deg});
+  }
+
+  // Only the poses from 60 ms to 90 ms are left
+  OdomState state;
+  EXPECT_TRUE(history.getStateAt(0_ms, state));
+  EXPECT_EQ(state.x, 6_m);
+  EXPECT_TRUE(history.getStateAt(75_ms, state));
+  EXPECT_NEAR(state.x.convert(meter), 7.5, 1e-9);
+}
+
+TEST(PoseHistoryTest, ConcurrentReadsAreNeverTorn) {
+  PoseHistory history(8);
+  std::atomic_bool done{false};
+
+  // Every pose has x = y = theta, so a read of a pose which was half overwritten would not
+  std::thread writer([&] {
+    for (int i = 0; i < 200000; i++) {
+      history.record(i * 1_ms, {i * 1_m, i * 1_m, i * 1_rad});
+    }
+    done = true;
+  });
+
+  int reads = 0;
+  while (!done || reads == 0) {
+    OdomState state;
+    QTime time;
+    if (history.getLatest(time, state)) {
+      EXPECT_EQ(state.x.convert(meter), state.y.convert(meter));
+      EXPECT_EQ(state.x.convert(meter), state.theta.convert(radian));
+      EXPECT_NEAR(state.x.convert(meter), time.convert(millisecond), 1e-6);
+      reads++;
+    }
+
+    if (history.getStateAt(time - 3_ms, state)) {
+      EXPECT_EQ(state.x.convert(meter), state.y.convert(meter));
+      EXPECT_EQ(state.x.convert(meter), state.theta.convert(radian));
+    }
+  }
+
+  writer.join();
+}
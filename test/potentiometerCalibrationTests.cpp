@@ -0,0 +1,45 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#include "okapi/api/device/rotarysensor/potentiometerCalibration.hpp"
+#include <gtest/gtest.h>
+#include <stdexcept>
+
+using namespace okapi;
+
+TEST(PotentiometerCalibrationTest, PointsAreHitExactly) {
+  const PotentiometerCalibration calibration({{3020, 60}, {310, -30}, {1850, 0}});
+  EXPECT_FLOAT_EQ(calibration(310), -30);
+  EXPECT_FLOAT_EQ(calibration(1850), 0);
+  EXPECT_FLOAT_EQ(calibration(3020), 60);
+}
+
+TEST(PotentiometerCalibrationTest, ReadingsBetweenPointsAreInterpolated) {
+  const PotentiometerCalibration calibration({{1000, 0}, {2000, 100}, {3000, 150}});
+  EXPECT_FLOAT_EQ(calibration(1500), 50);
+  EXPECT_FLOAT_EQ(calibration(2500), 125);
+}
+
+TEST(PotentiometerCalibrationTest, ReadingsPastTheEndsFollowTheNearestSegment) {
+  const PotentiometerCalibration calibration({{1000, 0}, {2000, 100}, {3000, 150}});
+  EXPECT_FLOAT_EQ(calibration(0), -100);
+  EXPECT_FLOAT_EQ(calibration(4000), 200);
+
+  // Readings the ADI can't give are clamped
+  EXPECT_FLOAT_EQ(calibration(-5), -100);
+  EXPECT_FLOAT_EQ(calibration(5000), calibration(PotentiometerCalibration::maxRaw));
+}
+
+TEST(PotentiometerCalibrationTest, DecreasingMappingsWork) {
+  const PotentiometerCalibration calibration({{0, 90}, {4095, -90}});
+  EXPECT_FLOAT_EQ(calibration(0), 90);
+  EXPECT_NEAR(calibration(2048), 0, 0.05);
+  EXPECT_FLOAT_EQ(calibration(4095), -90);
+}
+
+TEST(PotentiometerCalibrationTest, TooFewPointsThrow) {
+  EXPECT_THROW(PotentiometerCalibration({{100, 0}}), std::invalid_argument);
+  EXPECT_THROW(PotentiometerCalibration({{100, 0}, {100, 5}}), std::invalid_argument);
+}
@@ -0,0 +1,149 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#include "okapi/api/control/util/pathPool.hpp"
+#include "okapi/api/filter/biquadFilter.hpp"
+#include "okapi/api/util/logRecordQueue.hpp"
+#include "okapi/api/util/resourceUsage.hpp"
+#include <atomic>
+#include <cstring>
+#include <gtest/gtest.h>
+#include <thread>
+#include <utility>
+
+using namespace okapi;
+
+namespace {
+std::size_t heapBytes(const HeapSubsystem isubsystem) {
+  return ResourceUsage::getHeapUsage(isubsystem).bytes;
+}
+
+PathPool::Path makePath(const std::size_t isize) {
+  PathPool::Path path;
+  for (std::size_t i = 0; i < isize; i++) {
+    path.emplace_back(
+      squiggles::ControlVector(squiggles::Pose(0, 0, 0), 1, 0, 0), std::vector<double>{1, 1}, 0, 0);
+  }
+  return path;
+}
+
+const CrossplatformThreadStats *
+findTask(const std::array<CrossplatformThreadStats, CrossplatformThread::maxTrackedThreads> &istats,
+         const std::size_t icount,
+         const char *iname) {
+  for (std::size_t i = 0; i < icount; i++) {
+    if (std::strcmp(istats[i].name, iname) == 0) {
+      return &istats[i];
+    }
+  }
+  return nullptr;
+}
+} // namespace
+
+TEST(ResourceUsageTest, AttributionIsCountedWhileItLives) {
+  const std::size_t before = heapBytes(HeapSubsystem::filters);
+  {
+    HeapAttribution heap(HeapSubsystem::filters, 100);
+    EXPECT_EQ(heapBytes(HeapSubsystem::filters), before + 100);
+
+    heap.setBytes(40);
+    EXPECT_EQ(heapBytes(HeapSubsystem::filters), before + 40);
+  }
+  EXPECT_EQ(heapBytes(HeapSubsystem::filters), before);
+}
+
+TEST(ResourceUsageTest, CopiesCountAgainAndMovesTakeOver) {
+  const std::size_t before = heapBytes(HeapSubsystem::filters);
+  HeapAttribution heap(HeapSubsystem::filters, 100);
+
+  HeapAttribution copy(heap);
+  EXPECT_EQ(heapBytes(HeapSubsystem::filters), before + 200);
+
+  HeapAttribution moved(std::move(copy));
+  EXPECT_EQ(copy.getBytes(), 0u);
+  EXPECT_EQ(heapBytes(HeapSubsystem::filters), before + 200);
+
+  moved = heap;
+  EXPECT_EQ(heapBytes(HeapSubsystem::filters), before + 200);
+}
+
+TEST(ResourceUsageTest, PeakKeepsTheMostHeldUntilReset) {
+  ResourceUsage::resetPeaks();
+  const std::size_t before = heapBytes(HeapSubsystem::filters);
+  {
+    HeapAttribution heap(HeapSubsystem::filters, 1000);
+  }
+
+  EXPECT_EQ(ResourceUsage::getHeapUsage(HeapSubsystem::filters).peakBytes, before + 1000);
+  ResourceUsage::resetPeaks();
+  EXPECT_EQ(ResourceUsage::getHeapUsage(HeapSubsystem::filters).peakBytes, before);
+}
+
+TEST(ResourceUsageTest, LogRecordQueueIsCountedTowardLogging) {
+  const std::size_t before = heapBytes(HeapSubsystem::logging);
+  {
+    LogRecordQueue queue(8);
+    EXPECT_GE(heapBytes(HeapSubsystem::logging), before + 8 * sizeof(LogRecord));
+  }
+  EXPECT_EQ(heapBytes(HeapSubsystem::logging), before);
+}
+
+TEST(ResourceUsageTest, BiquadFilterIsCountedTowardFilters) {
+  const std::size_t before = heapBytes(HeapSubsystem::filters);
+  {
+    auto filter = BiquadFilter::lowPass(10_Hz, 100_Hz);
+    EXPECT_GT(heapBytes(HeapSubsystem::filters), before);
+  }
+  EXPECT_EQ(heapBytes(HeapSubsystem::filters), before);
+}
+
+TEST(ResourceUsageTest, PathPoolIsCountedTowardPaths) {
+  const std::size_t before = heapBytes(HeapSubsystem::paths);
+  {
+    auto pool = std::make_shared<PathPool>();
+    auto path = pool->store(makePath(10));
+    const std::size_t stored = PathPool::estimatePathBytes(*path);
+    EXPECT_EQ(heapBytes(HeapSubsystem::paths), before + stored);
+
+    // The buffer is kept by the pool, so it is still counted
+    path.reset();
+    EXPECT_EQ(heapBytes(HeapSubsystem::paths), before + stored);
+
+    pool->store(makePath(5));
+    EXPECT_EQ(heapBytes(HeapSubsystem::paths), before + pool->getStats().pooledBytes);
+  }
+  EXPECT_EQ(heapBytes(HeapSubsystem::paths), before);
+}
+
+TEST(ResourceUsageTest, ThreadsReportTheirStackUntilTheyAreDestroyed) {
+  std::atomic_bool stop{false};
+  std::array<CrossplatformThreadStats, CrossplatformThread::maxTrackedThreads> stats{};
+  {
+    CrossplatformThread thread(
+      [](void *iparams) {
+        auto *stopFlag = static_cast<std::atomic_bool *>(iparams);
+        while (!stopFlag->load()) {
+          std::this_thread::yield();
+        }
+      },
+      &stop,
+      "ResourceUsageTestTask",
+      TASK_PRIORITY_DEFAULT,
+      TASK_STACK_DEPTH_MIN);
+
+    const std::size_t count = ResourceUsage::getTaskStats(stats);
+    const auto *task = findTask(stats, count, "ResourceUsageTestTask");
+    ASSERT_NE(task, nullptr);
+    EXPECT_EQ(task->stackDepth, TASK_STACK_DEPTH_MIN);
+
+    // There is no stack high-water mark on the host
+    EXPECT_EQ(task->stackHighWaterMark, -1);
+
+    stop = true;
+  }
+
+  const std::size_t count = ResourceUsage::getTaskStats(stats);
+  EXPECT_EQ(findTask(stats, count, "ResourceUsageTestTask"), nullptr);
+}
@@ -0,0 +1,123 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#include "okapi/api/control/util/routineExecutor.hpp"
+#include "test/tests/api/virtualClock.hpp"
+#include <gtest/gtest.h>
+#include <string>
+
+using namespace okapi;
+
+class RoutineExecutorTest : public ::testing::Test {
+  protected:
+  struct MockSettling {
+    bool isSettled() const {
+      return settled;
+    }
+
+    bool settled{false};
+  };
+
+  VirtualClock clock;
+  RoutineExecutor executor{clock.createTimeUtil()};
+  std::string order;
+};
+
+TEST_F(RoutineExecutorTest, StepsWhichAreDoneRightAwayRunInOneStep) {
+  const auto id = executor.add(Routine()
+                                 .then([&]() { order += "a"; })
+                                 .then([&]() { order += "b"; })
+                                 .then([&]() { order += "c"; }));
+
+  EXPECT_FALSE(executor.isDone(id));
+  EXPECT_FALSE(executor.step());
+  EXPECT_EQ(order, "abc");
+  EXPECT_TRUE(executor.isDone(id));
+}
+
+TEST_F(RoutineExecutorTest, ASettleStepWaitsForTheController) {
+  const auto lift = std::make_shared<MockSettling>();
+  const auto id = executor.add(Routine()
+                                 .thenSettle([&]() { order += "start"; }, lift)
+                                 .then([&]() { order += " done"; }));
+
+  EXPECT_TRUE(executor.step());
+  EXPECT_TRUE(executor.step());
+  EXPECT_EQ(order, "start");
+
+  lift->settled = true;
+  EXPECT_FALSE(executor.step());
+  EXPECT_EQ(order, "start done");
+  EXPECT_TRUE(executor.isDone(id));
+}
+
+TEST_F(RoutineExecutorTest, ASettleStepGivesUpAfterItsTimeout) {
+  const auto lift = std::make_shared<MockSettling>();
+  executor.add(Routine().thenSettle([]() {}, lift, 100_ms).then([&]() { order += "done"; }));
+
+  executor.run(10_ms);
+  EXPECT_EQ(order, "done");
+  EXPECT_GE(clock.now().convert(millisecond), 100);
+  EXPECT_LE(clock.now().convert(millisecond), 110);
+}
+
+TEST_F(RoutineExecutorTest, RoutinesRunAtTheSameTime) {
+  const auto chassis = std::make_shared<MockSettling>();
+  const auto lift = std::make_shared<MockSettling>();
+  executor.add(Routine()
+                 .thenSettle([&]() { order += "drive "; }, chassis)
+                 .then([&]() { order += "drove "; }));
+  executor.add(Routine()
+                 .thenSettle([&]() { order += "lift "; }, lift)
+                 .then([&]() { order += "lifted "; }));
+
+  executor.step();
+  EXPECT_EQ(order, "drive lift ");
+  EXPECT_EQ(executor.getRunningCount(), 2u);
+
+  lift->settled = true;
+  executor.step();
+  EXPECT_EQ(order, "drive lift lifted ");
+  EXPECT_EQ(executor.getRunningCount(), 1u);
+
+  chassis->settled = true;
+  EXPECT_FALSE(executor.step());
+  EXPECT_EQ(order, "drive lift lifted drove ");
+}
+
+TEST_F(RoutineExecutorTest, DelaysWaitOnTheClock) {
+  executor.add(Routine().thenDelay(50_ms).then([&]() { order += "a"; }));
+  executor.add(Routine().thenDelay(20_ms).then([&]() { order += "b"; }));
+
+  executor.run(10_ms);
+  EXPECT_EQ(order, "ba");
+  EXPECT_EQ(clock.now().convert(millisecond), 50);
+}
+
+TEST_F(RoutineExecutorTest, ARoutineAddedFromAStepStartsOnTheNextStep) {
+  executor.add(Routine().then([&]() {
+    order += "outer ";
+    executor.add(Routine().then([&]() { order += "inner"; }));
+  }));
+
+  EXPECT_TRUE(executor.step());
+  EXPECT_EQ(order, "outer ");
+  EXPECT_FALSE(executor.step());
+  EXPECT_EQ(order, "outer inner");
+}
+
+TEST_F(RoutineExecutorTest, CancelledRoutinesStopRunning) {
+  const auto lift = std::make_shared<MockSettling>();
+  const auto id = executor.add(
+    Routine().thenSettle([]() {}, lift).then([&]() { order += "should not run"; }));
+
+  executor.step();
+  executor.cancel(id);
+  lift->settled = true;
+
+  EXPECT_TRUE(executor.isDone(id));
+  EXPECT_FALSE(executor.step());
+  EXPECT_EQ(order, "");
+}
@@ -0,0 +1,98 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#include "okapi/api/device/sensorSamplingService.hpp"
+#include "okapi/api/filter/medianFilter.hpp"
+#include "okapi/api/filter/passthroughFilter.hpp"
+#include "okapi/api/util/mathUtil.hpp"
+#include "test/tests/api/implMocks.hpp"
+#include <gtest/gtest.h>
+
+using namespace okapi;
+
+class SensorSamplingServiceTest : public ::testing::Test {
+  protected:
+  std::unique_ptr<SensorSamplingService> makeService(std::unique_ptr<Filter> ifilter) {
+    return std::make_unique<SensorSamplingService>(
+      [this] { return sample; }, std::move(ifilter), 10, createTimeUtil(), 10_ms);
+  }
+
+  SensorSample sample{0, 63};
+};
+
+TEST_F(SensorSamplingServiceTest, ReadsErrorBeforeTheFirstSample) {
+  auto service = makeService(std::make_unique<PassthroughFilter>());
+  EXPECT_EQ(service->get(), OKAPI_PROS_ERR);
+  EXPECT_EQ(service->getLastSampleTime(), 0_ms);
+}
+
+TEST_F(SensorSamplingServiceTest, PublishesTheLatestFilteredValue) {
+  auto service = makeService(std::make_unique<PassthroughFilter>());
+
+  sample.value = 120;
+  EXPECT_TRUE(service->step());
+  EXPECT_EQ(service->get(), 120);
+  EXPECT_EQ(service->controllerGet(), 120);
+}
+
+class SensorStepControlScheduler : public ControlScheduler {
+  public:
+  SensorStepControlScheduler() : ControlScheduler(createTimeUtil()) {
+  }
+
+  using ControlScheduler::stepDueLoops;
+};
+
+TEST_F(SensorSamplingServiceTest, ScheduledServiceSamplesFromTheScheduler) {
+  auto scheduler = std::make_shared<SensorStepControlScheduler>();
+  {
+    auto service = makeService(std::make_unique<PassthroughFilter>());
+    service->startScheduled(scheduler);
+    EXPECT_EQ(service->getThread(), nullptr);
+    EXPECT_EQ(scheduler->getLoopCount(), 1u);
+
+    sample.value = 42;
+    EXPECT_EQ(scheduler->stepDueLoops(0_ms), 10_ms);
+    EXPECT_EQ(service->get(), 42);
+  }
+  EXPECT_EQ(scheduler->getLoopCount(), 0u);
+}
+
+TEST_F(SensorSamplingServiceTest, DropsReadingsWithLowConfidence) {
+  auto service = makeService(std::make_unique<PassthroughFilter>());
+
+  sample.value = 120;
+  service->step();
+
+  sample = {500, 5};
+  EXPECT_FALSE(service->step());
+  EXPECT_EQ(service->get(), 120);
+  EXPECT_EQ(service->getRejectedCount(), 1u);
+}
+
+TEST_F(SensorSamplingServiceTest, DropsFailedReadings) {
+  auto service = makeService(std::make_unique<PassthroughFilter>());
+
+  sample.value = 120;
+  service->step();
+
+  sample.value = OKAPI_PROS_ERR;
+  EXPECT_FALSE(service->step());
+  sample.value = OKAPI_PROS_ERR_F;
+  EXPECT_FALSE(service->step());
+
+  EXPECT_EQ(service->get(), 120);
+  EXPECT_EQ(service->getRejectedCount(), 2u);
+}
+
+TEST_F(SensorSamplingServiceTest, MedianFilterRejectsAnOutlier) {
+  auto service = makeService(std::make_unique<MedianFilter<3>>());
+
+  for (double reading : {100.0, 101.0, 900.0, 102.0}) {
+    sample.value = reading;
+    service->step();
+    EXPECT_LT(service->get(), 200);
+  }
+}
@@ -0,0 +1,125 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#include "okapi/api/util/serialLink.hpp"
+#include "test/tests/api/implMocks.hpp"
+#include <gtest/gtest.h>
+#include <string>
+
+using namespace okapi;
+
+class SerialLinkTest : public ::testing::Test {
+  protected:
+  void SetUp() override {
+    auto [brainEnd, piEnd] = MockSerialPort::makeCable();
+    brainPort = brainEnd;
+    brain = std::make_unique<SerialLink>(brainEnd, createTimeUtil());
+    pi = std::make_unique<SerialLink>(piEnd, createTimeUtil());
+  }
+
+  std::shared_ptr<MockSerialPort> brainPort;
+  std::unique_ptr<SerialLink> brain;
+  std::unique_ptr<SerialLink> pi;
+};
+
+TEST_F(SerialLinkTest, Crc16MatchesTheCheckValue) {
+  const std::string data = "123456789";
+  EXPECT_EQ(SerialLink::crc16(reinterpret_cast<const std::uint8_t *>(data.data()), data.size()),
+            0x29B1);
+}
+
+TEST_F(SerialLinkTest, MessagesReachTheirHandler) {
+  std::vector<std::vector<std::uint8_t>> received;
+  pi->onMessage(7, [&](const std::uint8_t *ipayload, const std::size_t ilength) {
+    received.emplace_back(ipayload, ipayload + ilength);
+  });
+
+  const std::vector<std::uint8_t> payload{0, 1, 0, 0, 255, 0};
+  EXPECT_TRUE(brain->send(7, payload.data(), payload.size()));
+  EXPECT_TRUE(brain->send(8, payload.data(), payload.size()));
+  EXPECT_TRUE(brain->send(7, nullptr, 0));
+  pi->step();
+
+  ASSERT_EQ(received.size(), 2u);
+  EXPECT_EQ(received[0], payload);
+  EXPECT_TRUE(received[1].empty());
+  EXPECT_EQ(pi->getReceivedCount(), 3u);
+  EXPECT_EQ(pi->getCorruptCount(), 0u);
+}
+
+TEST_F(SerialLinkTest, MessagesLongerThanOneFrameAreNotSent) {
+  const std::vector<std::uint8_t> payload(SerialLink::maxPayloadSize + 1);
+  EXPECT_FALSE(brain->send(7, payload.data(), payload.size()));
+  EXPECT_TRUE(brainPort->tx->bytes.empty());
+}
+
+TEST_F(SerialLinkTest, CallGetsTheResponse) {
+  pi->onRequest(3, [](const std::uint8_t *ipayload, const std::size_t ilength) {
+    std::vector<std::uint8_t> response(ipayload, ipayload + ilength);
+    std::reverse(response.begin(), response.end());
+    return std::optional<std::vector<std::uint8_t>>(response);
+  });
+  pi->startThread();
+
+  const std::vector<std::uint8_t> request{1, 2, 0, 3};
+  const auto response = brain->call(3, request.data(), request.size(), 1_s);
+  ASSERT_TRUE(response.has_value());
+  EXPECT_EQ(*response, (std::vector<std::uint8_t>{3, 0, 2, 1}));
+}
+
+TEST_F(SerialLinkTest, LongRequestsAndResponsesAreSplitAcrossFrames) {
+  pi->onRequest(3, [](const std::uint8_t *ipayload, const std::size_t ilength) {
+    std::vector<std::uint8_t> response(ipayload, ipayload + ilength);
+    response.insert(response.end(), ipayload, ipayload + ilength);
+    return std::optional<std::vector<std::uint8_t>>(response);
+  });
+  pi->startThread();
+
+  std::vector<std::uint8_t> request(3 * SerialLink::maxPayloadSize + 17);
+  for (std::size_t i = 0; i < request.size(); i++) {
+    request[i] = static_cast<std::uint8_t>(i);
+  }
+
+  const auto response = brain->call(3, request.data(), request.size(), 1_s);
+  ASSERT_TRUE(response.has_value());
+  ASSERT_EQ(response->size(), 2 * request.size());
+  EXPECT_TRUE(std::equal(request.begin(), request.end(), response->begin()));
+  EXPECT_TRUE(std::equal(request.begin(), request.end(), response->begin() + request.size()));
+}
+
+TEST_F(SerialLinkTest, RequestsWithoutAHandlerFail) {
+  pi->onRequest(3, [](const std::uint8_t *, std::size_t) {
+    return std::optional<std::vector<std::uint8_t>>();
+  });
+  pi->startThread();
+
+  EXPECT_FALSE(brain->call(3, nullptr, 0, 1_s).has_value());
+  EXPECT_FALSE(brain->call(4, nullptr, 0, 1_s).has_value());
+}
+
+TEST_F(SerialLinkTest, CallTimesOutWithoutAResponse) {
+  // The other side never receives
+  EXPECT_FALSE(brain->call(3, nullptr, 0, 20_ms).has_value());
+}
+
+TEST_F(SerialLinkTest, CorruptFramesAreDroppedAndTheNextFrameIsReceived) {
+  int received = 0;
+  pi->onMessage(7, [&](const std::uint8_t *, std::size_t) { received++; });
+
+  const std::vector<std::uint8_t> payload{10, 20, 30};
+  brain->send(7, payload.data(), payload.size());
+  brainPort->tx->bytes[3] ^= 0x40;
+  brain->send(7, payload.data(), payload.size());
+
+  // A stray byte corrupts the frame it runs into
+  brainPort->tx->bytes.push_back(5);
+  pi->step();
+  brain->send(7, payload.data(), payload.size());
+  pi->step();
+
+  EXPECT_EQ(received, 1);
+  EXPECT_EQ(pi->getReceivedCount(), 1u);
+  EXPECT_EQ(pi->getCorruptCount(), 2u);
+}
@@ -0,0 +1,93 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#include "okapi/api/odometry/sharedOdomState.hpp"
+#include "okapi/api/odometry/twoEncoderOdometry.hpp"
+#include "test/tests/api/implMocks.hpp"
+#include <atomic>
+#include <gtest/gtest.h>
+#include <thread>
+
+using namespace okapi;
+
+TEST(SharedOdomStateTest, StartsAtZero) {
+  SharedOdomState state;
+  EXPECT_EQ(state.get(), (OdomState{0_m, 0_m, 0_deg}));
+
+  OdomState taken;
+  EXPECT_FALSE(state.take(taken));
+}
+
+TEST(SharedOdomStateTest, PublishedStateIsRead) {
+  SharedOdomState state;
+  state.publish({1_m, 2_m, 3_deg});
+  EXPECT_EQ(state.get(), (OdomState{1_m, 2_m, 3_deg}));
+  state.publish({4_m, 5_m, 6_deg});
+  EXPECT_EQ(state.get(), (OdomState{4_m, 5_m, 6_deg}));
+}
+
+TEST(SharedOdomStateTest, SetStateIsReadUntilItIsTaken) {
+  SharedOdomState state;
+  state.publish({1_m, 0_m, 0_deg});
+  state.set({2_m, 0_m, 0_deg});
+  EXPECT_EQ(state.get(), (OdomState{2_m, 0_m, 0_deg}));
+
+  // A step which publishes before taking the set state doesn't hide it
+  state.publish({3_m, 0_m, 0_deg});
+  EXPECT_EQ(state.get(), (OdomState{2_m, 0_m, 0_deg}));
+
+  OdomState taken;
+  EXPECT_TRUE(state.take(taken));
+  EXPECT_EQ(taken, (OdomState{2_m, 0_m, 0_deg}));
+  EXPECT_FALSE(state.take(taken));
+
+  state.publish({2.5_m, 0_m, 0_deg});
+  EXPECT_EQ(state.get(), (OdomState{2.5_m, 0_m, 0_deg}));
+}
+
+TEST(SharedOdomStateTest, NewestSetStateIsTaken) {
+  SharedOdomState state;
+  state.set({1_m, 0_m, 0_deg});
+  state.set({2_m, 0_m, 0_deg});
+
+  OdomState taken;
+  EXPECT_TRUE(state.take(taken));
+  EXPECT_EQ(taken, (OdomState{2_m, 0_m, 0_deg}));
+  EXPECT_FALSE(state.take(taken));
+}
+
+TEST(SharedOdomStateTest, ConcurrentReadsAreNeverTorn) {
+  SharedOdomState state;
+  std::atomic_bool done{false};
+
+  // Every published state has x = y = theta, so a state which was half overwritten would not
+  std::thread writer([&] {
+    for (int i = 0; i < 200000; i++) {
+      state.publish({i * 1_m, i * 1_m, i * 1_rad});
+    }
+    done = true;
+  });
+
+  while (!done) {
+    const OdomState read = state.get();
+    EXPECT_EQ(read.x.convert(meter), read.y.convert(meter));
+    EXPECT_EQ(read.x.convert(meter), read.theta.convert(radian));
+  }
+
+  writer.join();
+}
+
+TEST(SharedOdomStateTest, OdometrySetStateIsTakenByTheNextStep) {
+  auto model = std::make_shared<MockSkidSteerModel>();
+  TwoEncoderOdometry odom(
+    createConstantTimeUtil(10_ms), model, ChassisScales({{4_in, 10_in}, 360}));
+
+  odom.setState({1_m, 0_m, 0_deg});
+  assertOdomStateEquals(&odom, 1_m, 0_m, 0_deg);
+
+  model->setSensorVals(360, 360);
+  odom.step();
+  assertOdomStateEquals(&odom, 1_m + 1_pi * 4_in, 0_m, 0_deg);
+}
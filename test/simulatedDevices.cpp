@@ -0,0 +1,495 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#include "test/tests/api/simulatedDevices.hpp"
+#include "okapi/api/odometry/odomMath.hpp"
+#include "okapi/api/util/mathUtil.hpp"
+#include "test/tests/api/implMocks.hpp"
+#include <algorithm>
+#include <cmath>
+
+namespace okapi {
+namespace {
+constexpr double rpmToRadPerSec = 2 * pi / 60;
+constexpr double nominalVoltage = 12;   // V
+constexpr double stallCurrent = 2.5;    // A
+constexpr double positionGain = 2;      // rpm per degree of error
+constexpr double velocityGain = 0.05;   // V per rpm of error
+constexpr double velocityIGain = 2;     // V per rpm * s of error
+} // namespace
+
+SimWorld::SimWorld(const QTime isubstep) : substep(isubstep) {
+}
+
+void SimWorld::addDevice(std::shared_ptr<SimDevice> idevice) {
+  std::scoped_lock lock(mutex);
+  devices.push_back(std::move(idevice));
+}
+
+void SimWorld::advance(const QTime idt) {
+  std::scoped_lock lock(mutex);
+  QTime remaining = idt;
+  while (remaining > 0_ms) {
+    const QTime step = std::min(substep, remaining);
+    for (const auto &device : devices) {
+      device->simulate(step.convert(second));
+    }
+
+    time += step;
+    remaining -= step;
+  }
+}
+
+void SimWorld::advanceTo(const QTime itime) {
+  std::scoped_lock lock(mutex);
+  if (itime > time) {
+    advance(itime - time);
+  }
+}
+
+QTime SimWorld::now() const {
+  std::scoped_lock lock(mutex);
+  return time;
+}
+
+TimeUtil SimWorld::createTimeUtil() {
+  return TimeUtil(
+    Supplier<std::unique_ptr<AbstractTimer>>(
+      [this]() { return std::make_unique<SimTimer>(*this); }),
+    Supplier<std::unique_ptr<AbstractRate>>([this]() { return std::make_unique<SimRate>(*this); }),
+    Supplier<std::unique_ptr<SettledUtil>>([this]() {
+      return std::make_unique<SettledUtil>(std::make_unique<SimTimer>(*this), 50, 5, 250_ms);
+    }));
+}
+
+SimTimer::SimTimer(SimWorld &iworld) : AbstractTimer(iworld.now()), world(iworld) {
+}
+
+QTime SimTimer::millis() const {
+  return world.now();
+}
+
+SimRate::SimRate(SimWorld &iworld) : world(iworld) {
+}
+
+void SimRate::delay(const QFrequency ihz) {
+  delayUntil(1 / ihz);
+}
+
+void SimRate::delayUntil(const QTime itime) {
+  // Wake periodically from the first call, like the RTOS does
+  if (lastWake < 0_ms) {
+    lastWake = world.now();
+  }
+
+  lastWake += itime;
+  world.advanceTo(lastWake);
+}
+
+void SimRate::delayUntil(const uint32_t ims) {
+  delayUntil(ims * millisecond);
+}
+
+void SimRate::reset() {
+  lastWake = -1_ms;
+}
+
+SimMotorParams SimMotorParams::fromGearset(const AbstractMotor::gearset igearset) {
+  SimMotorParams params;
+  params.freeSpeed = toUnderlyingType(igearset);
+  // The torque of the motor is 2.1 N*m through the 100 rpm cartridge
+  params.stallTorque = 2.1 * 100 / params.freeSpeed;
+  return params;
+}
+
+SimEncoder::SimEncoder(SimMotor &imotor) : motor(imotor) {
+}
+
+double SimEncoder::get() const {
+  return motor.getPosition();
+}
+
+std::int32_t SimEncoder::reset() {
+  return motor.tarePosition();
+}
+
+double SimEncoder::controllerGet() {
+  return get();
+}
+
+double SimEncoder::getVelocity() const {
+  return motor.getActualVelocity() / 60 * gearsetToTPR(motor.getGearing());
+}
+
+bool SimEncoder::measuresVelocity() const {
+  return true;
+}
+
+SimMotor::SimMotor(const AbstractMotor::gearset igearset)
+  : SimMotor(igearset, SimMotorParams::fromGearset(igearset)) {
+}
+
+SimMotor::SimMotor(const AbstractMotor::gearset igearset, const SimMotorParams &iparams)
+  : params(iparams), gearset(igearset), encoder(std::make_shared<SimEncoder>(*this)) {
+}
+
+void SimMotor::simulate(const double idt) {
+  std::scoped_lock lock(mutex);
+
+  double voltage = 0;
+  switch (controlMode) {
+  case mode::voltage:
+    voltage = target / 1000;
+    break;
+  case mode::velocity:
+    voltage = velocityLoop(target, idt);
+    break;
+  case mode::position: {
+    const double error = (target - getPosition()) / positionPerRadian() * radianToDegree;
+    const double maxVelocity = profiledVelocity > 0 ? profiledVelocity : params.freeSpeed;
+    voltage =
+      velocityLoop(std::clamp(positionGain * error, -maxVelocity, maxVelocity), idt);
+    break;
+  }
+  }
+
+  const double maxVoltage = voltageLimit / 1000.0;
+  appliedVoltage = std::clamp(voltage, -maxVoltage, maxVoltage);
+
+  // The motor pushes against its load in the physical direction, which reversal flips
+  const double freeOmega = params.freeSpeed * rpmToRadPerSec;
+  const double maxTorque = params.stallTorque * currentLimit / (stallCurrent * 1000);
+  torque = std::clamp(params.stallTorque * (reversed * appliedVoltage / nominalVoltage -
+                                            omega / freeOmega),
+                      -maxTorque,
+                      maxTorque);
+
+  double netTorque = torque - params.damping * omega;
+  if (externalTorque) {
+    netTorque += externalTorque(angle, omega);
+  }
+
+  omega += netTorque / params.inertia * idt;
+  angle += omega * idt;
+}
+
+double SimMotor::velocityLoop(const double itargetRpm, const double idt) {
+  const double actualRpm = reversed * omega / rpmToRadPerSec;
+  const double error = itargetRpm - actualRpm;
+
+  // The integral makes up for friction, so the loop holds its target
+  velocityIntegral =
+    std::clamp(velocityIntegral + velocityIGain * error * idt, -nominalVoltage, nominalVoltage);
+  return nominalVoltage * itargetRpm / params.freeSpeed + velocityGain * error + velocityIntegral;
+}
+
+double SimMotor::positionPerRadian() const {
+  switch (encoderUnits) {
+  case AbstractMotor::encoderUnits::degrees:
+    return radianToDegree;
+  case AbstractMotor::encoderUnits::rotations:
+    return 1 / (2 * pi);
+  case AbstractMotor::encoderUnits::counts:
+  default:
+    return gearsetToTPR(gearset) / (2 * pi);
+  }
+}
+
+void SimMotor::setExternalTorque(std::function<double(double iangle, double iomega)> itorque) {
+  std::scoped_lock lock(mutex);
+  externalTorque = std::move(itorque);
+}
+
+double SimMotor::getAngle() const {
+  std::scoped_lock lock(mutex);
+  return angle;
+}
+
+double SimMotor::getOmega() const {
+  std::scoped_lock lock(mutex);
+  return omega;
+}
+
+SimMotorParams &SimMotor::getParams() {
+  return params;
+}
+
+void SimMotor::controllerSet(const double ivalue) {
+  moveVelocity(static_cast<std::int16_t>(ivalue * toUnderlyingType(gearset)));
+}
+
+std::int32_t SimMotor::moveAbsolute(const double iposition, const std::int32_t ivelocity) {
+  std::scoped_lock lock(mutex);
+  if (controlMode != mode::position) {
+    velocityIntegral = 0;
+  }
+  controlMode = mode::position;
+  target = iposition;
+  profiledVelocity = std::abs(ivelocity);
+  return 1;
+}
+
+std::int32_t SimMotor::moveRelative(const double iposition, const std::int32_t ivelocity) {
+  std::scoped_lock lock(mutex);
+  return moveAbsolute(getPosition() + iposition, ivelocity);
+}
+
+std::int32_t SimMotor::moveVelocity(const std::int16_t ivelocity) {
+  std::scoped_lock lock(mutex);
+  if (controlMode != mode::velocity) {
+    velocityIntegral = 0;
+  }
+  controlMode = mode::velocity;
+  target = ivelocity;
+  return 1;
+}
+
+std::int32_t SimMotor::moveVoltage(const std::int16_t ivoltage) {
+  std::scoped_lock lock(mutex);
+  controlMode = mode::voltage;
+  target = ivoltage;
+  return 1;
+}
+
+std::int32_t SimMotor::modifyProfiledVelocity(const std::int32_t ivelocity) {
+  std::scoped_lock lock(mutex);
+  profiledVelocity = std::abs(ivelocity);
+  return 1;
+}
+
+double SimMotor::getTargetPosition() {
+  std::scoped_lock lock(mutex);
+  return controlMode == mode::position ? target : 0;
+}
+
+double SimMotor::getPosition() {
+  std::scoped_lock lock(mutex);
+  return reversed * (angle - tareAngle) * positionPerRadian();
+}
+
+std::int32_t SimMotor::getTargetVelocity() {
+  std::scoped_lock lock(mutex);
+  return controlMode == mode::velocity ? static_cast<std::int32_t>(target) : 0;
+}
+
+double SimMotor::getActualVelocity() {
+  std::scoped_lock lock(mutex);
+  return reversed * omega / rpmToRadPerSec;
+}
+
+std::int32_t SimMotor::getCurrentDraw() {
+  std::scoped_lock lock(mutex);
+  return static_cast<std::int32_t>(std::abs(torque) / params.stallTorque * stallCurrent * 1000);
+}
+
+std::int32_t SimMotor::getDirection() {
+  return getActualVelocity() < 0 ? -1 : 1;
+}
+
+double SimMotor::getEfficiency() {
+  std::scoped_lock lock(mutex);
+  const double electricalPower = getPower();
+  if (electricalPower <= 0) {
+    return 0;
+  }
+
+  return std::clamp(torque * omega / electricalPower * 100, 0.0, 100.0);
+}
+
+std::int32_t SimMotor::isOverCurrent() {
+  return getCurrentDraw() >= currentLimit;
+}
+
+std::int32_t SimMotor::isOverTemp() {
+  return 0;
+}
+
+std::int32_t SimMotor::isStopped() {
+  return std::abs(getActualVelocity()) < 1;
+}
+
+std::int32_t SimMotor::getZeroPositionFlag() {
+  return std::abs(getPosition()) < 1;
+}
+
+uint32_t SimMotor::getFaults() {
+  return 0;
+}
+
+uint32_t SimMotor::getFlags() {
+  return 0;
+}
+
+std::int32_t SimMotor::getRawPosition(std::uint32_t *timestamp) {
+  std::scoped_lock lock(mutex);
+  if (timestamp) {
+    *timestamp = 0;
+  }
+
+  return static_cast<std::int32_t>(reversed * angle * gearsetToTPR(gearset) / (2 * pi));
+}
+
+double SimMotor::getPower() {
+  std::scoped_lock lock(mutex);
+  const double current = torque / params.stallTorque * stallCurrent;
+  return std::abs(appliedVoltage * current);
+}
+
+double SimMotor::getTemperature() {
+  return 25;
+}
+
+double SimMotor::getTorque() {
+  std::scoped_lock lock(mutex);
+  return reversed * torque;
+}
+
+std::int32_t SimMotor::getVoltage() {
+  std::scoped_lock lock(mutex);
+  return static_cast<std::int32_t>(appliedVoltage * 1000);
+}
+
+std::int32_t SimMotor::tarePosition() {
+  std::scoped_lock lock(mutex);
+  tareAngle = angle;
+  return 1;
+}
+
+std::int32_t SimMotor::setBrakeMode(const AbstractMotor::brakeMode imode) {
+  brakeMode = imode;
+  return 1;
+}
+
+AbstractMotor::brakeMode SimMotor::getBrakeMode() {
+  return brakeMode;
+}
+
+std::int32_t SimMotor::setCurrentLimit(const std::int32_t ilimit) {
+  std::scoped_lock lock(mutex);
+  currentLimit = ilimit;
+  return 1;
+}
+
+std::int32_t SimMotor::getCurrentLimit() {
+  return currentLimit;
+}
+
+std::int32_t SimMotor::setEncoderUnits(const AbstractMotor::encoderUnits iunits) {
+  std::scoped_lock lock(mutex);
+  encoderUnits = iunits;
+  return 1;
+}
+
+AbstractMotor::encoderUnits SimMotor::getEncoderUnits() {
+  return encoderUnits;
+}
+
+std::int32_t SimMotor::setGearing(const AbstractMotor::gearset igearset) {
+  std::scoped_lock lock(mutex);
+  const auto cartridge = SimMotorParams::fromGearset(igearset);
+  params.freeSpeed = cartridge.freeSpeed;
+  params.stallTorque = cartridge.stallTorque;
+  gearset = igearset;
+  return 1;
+}
+
+AbstractMotor::gearset SimMotor::getGearing() {
+  return gearset;
+}
+
+std::int32_t SimMotor::setReversed(const bool ireverse) {
+  std::scoped_lock lock(mutex);
+  reversed = ireverse ? -1 : 1;
+  return 1;
+}
+
+std::int32_t SimMotor::setVoltageLimit(const std::int32_t ilimit) {
+  std::scoped_lock lock(mutex);
+  voltageLimit = ilimit;
+  return 1;
+}
+
+std::shared_ptr<ContinuousRotarySensor> SimMotor::getEncoder() {
+  return encoder;
+}
+
+SimSkidSteerDrive::SimSkidSteerDrive(const AbstractMotor::gearset igearset,
+                                     const QLength iwheelDiameter,
+                                     const QLength iwheelTrack,
+                                     const QMass imass)
+  : wheelRadius(iwheelDiameter.convert(meter) / 2), wheelTrack(iwheelTrack.convert(meter)) {
+  auto params = SimMotorParams::fromGearset(igearset);
+  // Each side pushes half of the robot
+  params.inertia = std::max(params.inertia, imass.convert(kg) / 2 * wheelRadius * wheelRadius);
+
+  leftMotor = std::make_shared<SimMotor>(igearset, params);
+  rightMotor = std::make_shared<SimMotor>(igearset, params);
+
+  // The right side is mounted mirrored, so it is reversed like on a real robot
+  rightMotor->setReversed(true);
+}
+
+void SimSkidSteerDrive::simulate(const double idt) {
+  leftMotor->simulate(idt);
+  rightMotor->simulate(idt);
+
+  const double leftAngle = leftMotor->getAngle();
+  const double rightAngle = rightMotor->getAngle();
+
+  std::scoped_lock lock(mutex);
+  const double deltaL = (leftAngle - lastLeftAngle) * wheelRadius;
+  const double deltaR = -(rightAngle - lastRightAngle) * wheelRadius;
+  lastLeftAngle = leftAngle;
+  lastRightAngle = rightAngle;
+
+  const double deltaTheta = (deltaL - deltaR) / wheelTrack;
+  const double distance = (deltaL + deltaR) / 2;
+  const double midTheta = theta + deltaTheta / 2;
+  x += distance * std::cos(midTheta);
+  y += distance * std::sin(midTheta);
+  theta += deltaTheta;
+}
+
+std::shared_ptr<SimMotor> SimSkidSteerDrive::getLeftMotor() const {
+  return leftMotor;
+}
+
+std::shared_ptr<SimMotor> SimSkidSteerDrive::getRightMotor() const {
+  return rightMotor;
+}
+
+OdomState SimSkidSteerDrive::getPose() const {
+  std::scoped_lock lock(mutex);
+  return OdomState{x * meter, y * meter, theta * radian};
+}
+
+void SimSkidSteerDrive::setPose(const OdomState &ipose) {
+  std::scoped_lock lock(mutex);
+  x = ipose.x.convert(meter);
+  y = ipose.y.convert(meter);
+  theta = ipose.theta.convert(radian);
+}
+
+SimImu::SimImu(const std::shared_ptr<SimSkidSteerDrive> &idrive,
+               SimWorld &iworld,
+               const double idriftRate)
+  : drive(idrive), world(iworld), driftRate(idriftRate) {
+}
+
+double SimImu::get() const {
+  const double heading = drive->getPose().theta.convert(degree) +
+                         driftRate * world.now().convert(second) - offset;
+  return OdomMath::constrainAngle180(heading * degree).convert(degree);
+}
+
+std::int32_t SimImu::reset() {
+  offset = drive->getPose().theta.convert(degree) + driftRate * world.now().convert(second);
+  return 1;
+}
+
+double SimImu::controllerGet() {
+  return get();
+}
+} // namespace okapi
@@ -0,0 +1,184 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#include "okapi/api/chassis/controller/chassisControllerPid.hpp"
+#include "okapi/api/chassis/model/skidSteerModel.hpp"
+#include "okapi/api/util/mathUtil.hpp"
+#include "test/tests/api/simulatedDevices.hpp"
+#include <chrono>
+#include <gtest/gtest.h>
+#include <thread>
+
+using namespace okapi;
+
+TEST(SimWorldTest, RatesAdvanceTheClock) {
+  SimWorld world;
+  auto timeUtil = world.createTimeUtil();
+  auto timer = timeUtil.getTimer();
+  auto rate = timeUtil.getRate();
+
+  EXPECT_NEAR(timer->millis().convert(millisecond), 0, 1e-9);
+  rate->delayUntil(10_ms);
+  EXPECT_NEAR(timer->millis().convert(millisecond), 10, 1e-9);
+  rate->delayUntil(10_ms);
+  EXPECT_NEAR(timer->millis().convert(millisecond), 20, 1e-9);
+
+  world.advance(5_ms);
+  world.advanceTo(1_ms);
+  EXPECT_NEAR(world.now().convert(millisecond), 25, 1e-9);
+
+  // The rate wakes periodically, so it only makes up the rest of its period
+  rate->delayUntil(10_ms);
+  EXPECT_NEAR(world.now().convert(millisecond), 30, 1e-9);
+}
+
+TEST(SimMotorTest, ReachesFreeSpeedAtFullVoltage) {
+  SimWorld world;
+  auto motor = std::make_shared<SimMotor>(AbstractMotor::gearset::green);
+  world.addDevice(motor);
+
+  motor->moveVoltage(12000);
+  world.advance(1_s);
+
+  // Friction takes a little off of the free speed
+  EXPECT_NEAR(motor->getActualVelocity(), 200, 5);
+  EXPECT_LT(motor->getActualVelocity(), 200);
+  EXPECT_EQ(motor->getVoltage(), 12000);
+}
+
+TEST(SimMotorTest, VelocityLoopTracksTheTarget) {
+  SimWorld world;
+  auto motor = std::make_shared<SimMotor>(AbstractMotor::gearset::blue);
+  world.addDevice(motor);
+
+  motor->moveVelocity(-300);
+  world.advance(1_s);
+
+  EXPECT_NEAR(motor->getActualVelocity(), -300, 3);
+  EXPECT_EQ(motor->getTargetVelocity(), -300);
+}
+
+TEST(SimMotorTest, PositionLoopReachesTheTarget) {
+  SimWorld world;
+  auto motor = std::make_shared<SimMotor>(AbstractMotor::gearset::green);
+  world.addDevice(motor);
+
+  motor->moveAbsolute(imev5GreenTPR, 100);
+  world.advance(2_s);
+
+  EXPECT_NEAR(motor->getPosition(), imev5GreenTPR, 5);
+  EXPECT_NEAR(motor->getEncoder()->get(), imev5GreenTPR, 5);
+  EXPECT_NEAR(motor->getAngle(), 2 * pi, 0.05);
+}
+
+TEST(SimMotorTest, ReversalAndTare) {
+  SimWorld world;
+  auto motor = std::make_shared<SimMotor>(AbstractMotor::gearset::green);
+  world.addDevice(motor);
+  motor->setReversed(true);
+
+  motor->moveVelocity(100);
+  world.advance(500_ms);
+
+  EXPECT_GT(motor->getPosition(), 0);
+  EXPECT_LT(motor->getAngle(), 0);
+  EXPECT_GT(motor->getEncoder()->getVelocity(), 0);
+
+  motor->getEncoder()->reset();
+  EXPECT_EQ(motor->getPosition(), 0);
+}
+
+TEST(SimMotorTest, CurrentLimitLimitsTorque) {
+  SimWorld world;
+  auto motor = std::make_shared<SimMotor>(AbstractMotor::gearset::green);
+  world.addDevice(motor);
+  motor->setCurrentLimit(1250);
+
+  motor->moveVoltage(12000);
+  world.advance(1_ms);
+
+  EXPECT_NEAR(motor->getTorque(), motor->getParams().stallTorque / 2, 1e-6);
+  EXPECT_EQ(motor->getCurrentDraw(), 1250);
+}
+
+class SimSkidSteerDriveTest : public ::testing::Test {
+  protected:
+  void SetUp() override {
+    world.addDevice(drive);
+  }
+
+  SimWorld world;
+  std::shared_ptr<SimSkidSteerDrive> drive =
+    std::make_shared<SimSkidSteerDrive>(AbstractMotor::gearset::green, 4_in, 12_in, 7_kg);
+};
+
+TEST_F(SimSkidSteerDriveTest, DrivesStraight) {
+  drive->getLeftMotor()->moveVelocity(100);
+  drive->getRightMotor()->moveVelocity(100);
+  world.advance(2_s);
+
+  const auto pose = drive->getPose();
+  // Nearly two seconds at 100 rpm on a 4 inch wheel
+  EXPECT_NEAR(pose.x.convert(inch), 4 * pi * 100 / 60 * 2, 3);
+  EXPECT_NEAR(pose.y.convert(inch), 0, 1e-6);
+  EXPECT_NEAR(pose.theta.convert(degree), 0, 1e-6);
+  EXPECT_GT(drive->getRightMotor()->getPosition(), 0);
+}
+
+TEST_F(SimSkidSteerDriveTest, TurnsClockwiseWithTheLeftSideForward) {
+  SimImu imu(drive, world);
+
+  drive->getLeftMotor()->moveVelocity(50);
+  drive->getRightMotor()->moveVelocity(-50);
+  world.advance(500_ms);
+
+  const auto pose = drive->getPose();
+  EXPECT_GT(pose.theta.convert(degree), 10);
+  EXPECT_NEAR(pose.x.convert(inch), 0, 1e-6);
+  EXPECT_NEAR(imu.get(), pose.theta.convert(degree), 1e-6);
+
+  imu.reset();
+  EXPECT_NEAR(imu.get(), 0, 1e-6);
+}
+
+TEST_F(SimSkidSteerDriveTest, ImuDrifts) {
+  SimImu imu(drive, world, 0.5);
+  world.advance(2_s);
+  EXPECT_NEAR(imu.get(), 1, 1e-6);
+}
+
+TEST_F(SimSkidSteerDriveTest, ChassisControllerPIDDrivesADistance) {
+  auto timeUtil = world.createTimeUtil();
+  auto leftMotor = drive->getLeftMotor();
+  auto rightMotor = drive->getRightMotor();
+  auto model = std::make_shared<SkidSteerModel>(leftMotor,
+                                                rightMotor,
+                                                leftMotor->getEncoder(),
+                                                rightMotor->getEncoder(),
+                                                200,
+                                                v5MotorMaxVoltage);
+
+  ChassisControllerPID controller(
+    timeUtil,
+    model,
+    std::make_unique<IterativePosPIDController>(0.003, 0, 0.00007, 0, timeUtil),
+    std::make_unique<IterativePosPIDController>(0.003, 0, 0.00007, 0, timeUtil),
+    std::make_unique<IterativePosPIDController>(0.001, 0, 0, 0, timeUtil),
+    AbstractMotor::gearset::green,
+    ChassisScales({4_in, 12_in}, imev5GreenTPR));
+  controller.startThread();
+
+  // Only the controller's task advances the world, so the run is deterministic
+  controller.moveDistanceAsync(2_ft);
+  const auto start = std::chrono::steady_clock::now();
+  while (!controller.isSettled()) {
+    ASSERT_LT(std::chrono::steady_clock::now() - start, std::chrono::seconds(10));
+    std::this_thread::yield();
+  }
+
+  EXPECT_NEAR(drive->getPose().x.convert(inch), 24, 1);
+  EXPECT_NEAR(drive->getPose().theta.convert(degree), 0, 1);
+  EXPECT_LT(world.now(), 5_s);
+}
@@ -284,3 +284,90 @@ TEST_F(SkidSteerModelTest, SetMaxVelocityLessThan0) {
   model.setMaxVelocity(-1);
   EXPECT_EQ(model.getMaxVelocity(), 0);
 }
+
+TEST_F(SkidSteerModelTest, ApplyCommandsVoltage) {
+  model.applyCommands({WheelCommands::outputMode::voltage, {0.5, -0.25}});
+  assertLeftAndRightMotorsLastVoltage(6000, -3000);
+}
+
+TEST_F(SkidSteerModelTest, ApplyCommandsVelocityBoundsInput) {
+  model.applyCommands({WheelCommands::outputMode::velocity, {2, -0.5}});
+  assertLeftAndRightMotorsLastVelocity(127, -63);
+}
+
+TEST_F(SkidSteerModelTest, CheesyDriveFullForward) {
+  model.cheesyDrive(1, 0, false);
+
+  assertAllMotorsLastVelocity(0);
+  assertAllMotorsLastVoltage(12000);
+}
+
+TEST_F(SkidSteerModelTest, CheesyDriveDoesNotTurnWhenStoppedWithoutQuickTurn) {
+  for (int i = 0; i < 5; i++) {
+    model.cheesyDrive(0, 1, false);
+  }
+
+  assertAllMotorsLastVoltage(0);
+}
+
+TEST_F(SkidSteerModelTest, CheesyDriveQuickTurnTurnsInPlace) {
+  for (int i = 0; i < 5; i++) {
+    model.cheesyDrive(0, 1, true);
+  }
+
+  assertLeftAndRightMotorsLastVoltage(12000, -12000);
+}
+
+TEST_F(SkidSteerModelTest, CheesyDriveTurnsHarderRightAfterTheTurnStickMoves) {
+  model.cheesyDrive(0.5, 0.3, false);
+  const int firstTurn = leftMotor->lastVoltage - rightMotor->lastVoltage;
+
+  for (int i = 0; i < 10; i++) {
+    model.cheesyDrive(0.5, 0.3, false);
+  }
+  const int steadyTurn = leftMotor->lastVoltage - rightMotor->lastVoltage;
+
+  EXPECT_GT(steadyTurn, 0);
+  EXPECT_GT(firstTurn, steadyTurn);
+}
+
+TEST_F(SkidSteerModelTest, CheesyDriveQuickStopCountersTheSpinAfterAQuickTurn) {
+  for (int i = 0; i < 20; i++) {
+    model.cheesyDrive(0, 1, true);
+  }
+  model.cheesyDrive(0.5, 1, false);
+  const int turnWithQuickStop = leftMotor->lastVoltage - rightMotor->lastVoltage;
+
+  model.resetCheesyDrive();
+  for (int i = 0; i < 10; i++) {
+    model.cheesyDrive(0.5, 1, false);
+  }
+  const int turnWithoutQuickStop = leftMotor->lastVoltage - rightMotor->lastVoltage;
+
+  EXPECT_LT(turnWithQuickStop, turnWithoutQuickStop);
+}
+
+TEST_F(SkidSteerModelTest, CheesyDriveResetClearsTheQuickStop) {
+  for (int i = 0; i < 20; i++) {
+    model.cheesyDrive(0, 1, true);
+  }
+
+  model.resetCheesyDrive();
+  model.cheesyDrive(0.5, 0, false);
+
+  assertAllMotorsLastVoltage(6000);
+}
+
+TEST_F(SkidSteerModelTest, CheesyDriveThresholdIgnoresSmallInputs) {
+  model.cheesyDrive(0.05, 0.05, true, 0.1);
+
+  assertAllMotorsLastVoltage(0);
+}
+
+TEST_F(SkidSteerModelTest, CheesyDriveConfigCanBeChanged) {
+  SkidSteerModel::CheesyDriveConfig config;
+  config.sensitivity = 1;
+  model.setCheesyDriveConfig(config);
+
+  EXPECT_DOUBLE_EQ(model.getCheesyDriveConfig().sensitivity, 1);
+}
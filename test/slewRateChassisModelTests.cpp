@@ -0,0 +1,130 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#include "okapi/api/chassis/model/slewRateChassisModel.hpp"
+#include "test/tests/api/implMocks.hpp"
+#include <gtest/gtest.h>
+
+using namespace okapi;
+
+class SlewRateChassisModelTest : public ::testing::Test {
+  protected:
+  void SetUp() override {
+    inner = std::make_shared<MockSkidSteerModel>();
+    inner->setMaxVelocity(100);
+    inner->setMaxVoltage(10000);
+    model = std::make_unique<SlewRateChassisModel>(inner, 0.25, 0.5);
+  }
+
+  std::shared_ptr<MockSkidSteerModel> inner;
+  std::unique_ptr<SlewRateChassisModel> model;
+};
+
+TEST_F(SlewRateChassisModelTest, ConstructWithNullModelThrows) {
+  EXPECT_THROW(SlewRateChassisModel(nullptr, 0.1), std::invalid_argument);
+}
+
+TEST_F(SlewRateChassisModelTest, ConstructWithNonPositiveStepThrows) {
+  EXPECT_THROW(SlewRateChassisModel(inner, 0), std::invalid_argument);
+  EXPECT_THROW(SlewRateChassisModel(inner, 0.1, -0.1), std::invalid_argument);
+}
+
+TEST_F(SlewRateChassisModelTest, TankRampsUpByTheAccelerationStep) {
+  model->tank(1, 1);
+  EXPECT_EQ(inner->leftMtr->lastVoltage, 2500);
+  EXPECT_EQ(inner->rightMtr->lastVoltage, 2500);
+
+  model->tank(1, 1);
+  EXPECT_EQ(inner->leftMtr->lastVoltage, 5000);
+
+  model->tank(1, 1);
+  model->tank(1, 1);
+  model->tank(1, 1);
+  EXPECT_EQ(inner->leftMtr->lastVoltage, 10000);
+}
+
+TEST_F(SlewRateChassisModelTest, SetAccelStepChangesTheNextStep) {
+  model->tank(1, 1);
+  EXPECT_EQ(inner->leftMtr->lastVoltage, 2500);
+
+  model->setAccelStep(0.1);
+  EXPECT_DOUBLE_EQ(model->getAccelStep(), 0.1);
+  model->tank(1, 1);
+  EXPECT_EQ(inner->leftMtr->lastVoltage, 3500);
+
+  EXPECT_THROW(model->setAccelStep(0), std::invalid_argument);
+  EXPECT_DOUBLE_EQ(model->getAccelStep(), 0.1);
+}
+
+TEST_F(SlewRateChassisModelTest, SlowingDownUsesTheDecelerationStep) {
+  for (int i = 0; i < 4; i++) {
+    model->tank(1, 1);
+  }
+
+  model->tank(0, 0);
+  EXPECT_EQ(inner->leftMtr->lastVoltage, 5000);
+  model->tank(0, 0);
+  EXPECT_EQ(inner->leftMtr->lastVoltage, 0);
+}
+
+TEST_F(SlewRateChassisModelTest, ReversingStopsAtZeroFirst) {
+  model->tank(0.25, 0.25);
+  model->tank(-1, -1);
+  EXPECT_EQ(inner->leftMtr->lastVoltage, 0);
+
+  // Speeding up the other way uses the acceleration step
+  model->tank(-1, -1);
+  EXPECT_EQ(inner->leftMtr->lastVoltage, -2500);
+}
+
+TEST_F(SlewRateChassisModelTest, SidesAreLimitedSeparately) {
+  model->tank(1, 1);
+  model->tank(1, -1);
+  EXPECT_EQ(inner->leftMtr->lastVoltage, 5000);
+  EXPECT_EQ(inner->rightMtr->lastVoltage, 0);
+}
+
+TEST_F(SlewRateChassisModelTest, ArcadeMixesLikeSkidSteerModel) {
+  for (int i = 0; i < 4; i++) {
+    model->arcade(0.5, 0.5);
+  }
+
+  EXPECT_EQ(inner->leftMtr->lastVoltage, 5000);
+  EXPECT_EQ(inner->rightMtr->lastVoltage, 0);
+}
+
+TEST_F(SlewRateChassisModelTest, ForwardUsesVelocityMode) {
+  model->forward(1);
+  EXPECT_EQ(inner->leftMtr->lastVelocity, 25);
+  EXPECT_EQ(inner->rightMtr->lastVelocity, 25);
+}
+
+TEST_F(SlewRateChassisModelTest, StopIsNotLimited) {
+  model->forward(1);
+  model->forward(1);
+  model->stop();
+  EXPECT_EQ(inner->leftMtr->lastVelocity, 0);
+
+  // The ramp starts again from zero
+  model->forward(1);
+  EXPECT_EQ(inner->leftMtr->lastVelocity, 25);
+}
+
+TEST_F(SlewRateChassisModelTest, ApplyCommandsLimitsEachWheel) {
+  WheelCommands commands;
+  commands.mode = WheelCommands::outputMode::velocity;
+  commands.outputs = {1, -0.1};
+  model->applyCommands(commands);
+
+  EXPECT_EQ(inner->leftMtr->lastVelocity, 25);
+  EXPECT_EQ(inner->rightMtr->lastVelocity, -10);
+}
+
+TEST_F(SlewRateChassisModelTest, ForwardsConfigurationToTheModel) {
+  model->setMaxVelocity(42);
+  EXPECT_EQ(inner->getMaxVelocity(), 42);
+  EXPECT_EQ(model->getMaxVelocity(), 42);
+  EXPECT_EQ(model->getModel(), inner);
+}
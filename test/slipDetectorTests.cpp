@@ -0,0 +1,124 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#include "okapi/api/chassis/controller/slipDetector.hpp"
+#include "test/tests/api/implMocks.hpp"
+#include <gtest/gtest.h>
+
+using namespace okapi;
+
+class SlipDetectorTest : public ::testing::Test {
+  protected:
+  class SettableTimer : public AbstractTimer {
+    public:
+    explicit SettableTimer(const QTime &inow) : AbstractTimer(inow), now(inow) {
+    }
+
+    QTime millis() const override {
+      return now;
+    }
+
+    const QTime &now;
+  };
+
+  void SetUp() override {
+    model = std::make_shared<SkidSteerModel>(
+      leftMotor, rightMotor, leftTracking, rightTracking, 600, v5MotorMaxVoltage);
+    detector = std::make_unique<SlipDetector>(
+      model,
+      ChassisScales({4_in, 10_in}, 360),
+      AbstractMotor::GearsetRatioPair(AbstractMotor::gearset::green),
+      ChassisScales({4_in, 10_in}, 360),
+      createTimeUtil(Supplier<std::unique_ptr<AbstractTimer>>(
+        [this]() { return std::make_unique<SettableTimer>(now); })));
+    detector->step();
+  }
+
+  /**
+   * Moves the motors and the tracking wheels by some ticks over 10 ms, then steps the detector.
+   */
+  void drive(const int imotorTicks, const int itrackingTicks) {
+    now += 10_ms;
+    leftMotor->encoder->value += imotorTicks;
+    rightMotor->encoder->value += imotorTicks;
+    leftTracking->value += itrackingTicks;
+    rightTracking->value += itrackingTicks;
+    detector->step();
+  }
+
+  QTime now{1_ms};
+  std::shared_ptr<MockMotor> leftMotor = std::make_shared<MockMotor>();
+  std::shared_ptr<MockMotor> rightMotor = std::make_shared<MockMotor>();
+  std::shared_ptr<MockContinuousRotarySensor> leftTracking =
+    std::make_shared<MockContinuousRotarySensor>();
+  std::shared_ptr<MockContinuousRotarySensor> rightTracking =
+    std::make_shared<MockContinuousRotarySensor>();
+  std::shared_ptr<SkidSteerModel> model;
+  std::unique_ptr<SlipDetector> detector;
+};
+
+TEST_F(SlipDetectorTest, NoSlipWhenTheWheelsAgree) {
+  for (int i = 0; i < 20; i++) {
+    drive(10, 10);
+  }
+
+  EXPECT_FALSE(detector->isSlipping());
+  EXPECT_NEAR(detector->getLeftSlip().convert(mps), 0, 1e-9);
+  EXPECT_EQ(detector->getSlipCount(), 0u);
+}
+
+TEST_F(SlipDetectorTest, DetectsWheelsSpinningFasterThanTheGround) {
+  drive(20, 10);
+  EXPECT_TRUE(detector->isSlipping());
+  EXPECT_TRUE(detector->isLeftSlipping());
+  EXPECT_TRUE(detector->isRightSlipping());
+  EXPECT_GT(detector->getLeftSlip().convert(mps), 0);
+  EXPECT_EQ(detector->getSlipCount(), 1u);
+
+  // The slip stays flagged until the filtered slip falls below half of the slip speed
+  for (int i = 0; i < 20; i++) {
+    drive(20, 10);
+  }
+  drive(10, 10);
+  EXPECT_TRUE(detector->isSlipping());
+
+  for (int i = 0; i < 20; i++) {
+    drive(10, 10);
+  }
+  EXPECT_FALSE(detector->isSlipping());
+  EXPECT_EQ(detector->getSlipCount(), 1u);
+}
+
+TEST_F(SlipDetectorTest, DetectsWheelsSkidding) {
+  drive(0, 10);
+  EXPECT_TRUE(detector->isSlipping());
+  EXPECT_LT(detector->getRightSlip().convert(mps), 0);
+}
+
+TEST_F(SlipDetectorTest, LimitsAccelerationWhileSlipping) {
+  auto slewModel = std::make_shared<SlewRateChassisModel>(std::make_shared<MockSkidSteerModel>(),
+                                                          0.5);
+  detector->limitAcceleration(slewModel, 0.05);
+  EXPECT_DOUBLE_EQ(slewModel->getAccelStep(), 0.5);
+
+  drive(20, 10);
+  EXPECT_DOUBLE_EQ(slewModel->getAccelStep(), 0.05);
+
+  for (int i = 0; i < 20; i++) {
+    drive(10, 10);
+  }
+  EXPECT_DOUBLE_EQ(slewModel->getAccelStep(), 0.5);
+}
+
+TEST_F(SlipDetectorTest, StoppingTheLimitRestoresTheAcceleration) {
+  auto slewModel = std::make_shared<SlewRateChassisModel>(std::make_shared<MockSkidSteerModel>(),
+                                                          0.5);
+  detector->limitAcceleration(slewModel, 0.05);
+  drive(20, 10);
+  EXPECT_DOUBLE_EQ(slewModel->getAccelStep(), 0.05);
+
+  detector->limitAcceleration(nullptr, 0);
+  EXPECT_DOUBLE_EQ(slewModel->getAccelStep(), 0.5);
+}
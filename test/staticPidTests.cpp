@@ -0,0 +1,121 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#include "okapi/api/control/iterative/staticPid.hpp"
+#include "okapi/api/filter/emaFilter.hpp"
+#include "test/tests/api/implMocks.hpp"
+#include <gtest/gtest.h>
+
+using namespace okapi;
+
+template <typename Controller>
+static void expectMatchesIterativePosPID(Controller &icontroller,
+                                         IterativePosPIDController &ipid,
+                                         const double itarget) {
+  icontroller.setTarget(itarget);
+  ipid.setTarget(itarget);
+
+  double reading = 0;
+  for (int i = 0; i < 200; i++) {
+    const double output = icontroller.step(reading);
+    EXPECT_DOUBLE_EQ(output, ipid.step(reading)) << "step " << i;
+
+    // A crude plant so the error crosses zero
+    reading += output * 20;
+  }
+}
+
+TEST(StaticPIDTest, MatchesIterativePosPIDController) {
+  const IterativePosPIDController::Gains gains{0.01, 0, 0.0002, 0.1};
+  StaticPID<> controller(gains);
+  IterativePosPIDController pid(gains, createConstantTimeUtil(10_ms));
+  expectMatchesIterativePosPID(controller, pid, 500);
+}
+
+TEST(StaticPIDTest, MatchesIterativePosPIDControllerWithAFilter) {
+  const IterativePosPIDController::Gains gains{0.01, 0, 0.001, 0};
+  StaticPID<EmaFilter> controller(gains, 10_ms, EmaFilter(0.5));
+  IterativePosPIDController pid(
+    gains, createConstantTimeUtil(10_ms), std::make_unique<EmaFilter>(0.5));
+  expectMatchesIterativePosPID(controller, pid, -300);
+}
+
+TEST(StaticPIDTest, GetGainsReturnsTheSetGains) {
+  StaticPID<> controller({0.1, 0.2, 0.3, 0.4}, 20_ms);
+  EXPECT_EQ(controller.getGains(), (IterativePosPIDController::Gains{0.1, 0.2, 0.3, 0.4}));
+  EXPECT_EQ(controller.getSampleTime(), 20_ms);
+}
+
+TEST(StaticPIDTest, ResetOnCrossAntiWindupResetsTheIntegral) {
+  StaticPID<PassthroughFilter, ResetOnCrossAntiWindup> controller({0, 1, 0, 0});
+  controller.setTarget(10);
+  controller.step(0);
+  EXPECT_DOUBLE_EQ(controller.step(0), 0.2);
+
+  // The error crosses zero
+  EXPECT_DOUBLE_EQ(controller.step(20), 0);
+}
+
+TEST(StaticPIDTest, ClampAntiWindupKeepsTheIntegral) {
+  StaticPID<PassthroughFilter, ClampAntiWindup> controller({0, 1, 0, 0});
+  controller.setTarget(10);
+  controller.step(0);
+  controller.step(0);
+  EXPECT_DOUBLE_EQ(controller.step(20), 0.1);
+}
+
+TEST(StaticPIDTest, ClampAntiWindupLimitsTheIntegral) {
+  StaticPID<PassthroughFilter, ClampAntiWindup> controller({0, 1, 0, 0});
+  controller.setOutputLimits(10, -10);
+  controller.setIntegralLimits(0.5, -0.5);
+  controller.setTarget(10);
+  for (int i = 0; i < 10; i++) {
+    controller.step(0);
+  }
+  EXPECT_DOUBLE_EQ(controller.getOutput(), 0.5);
+}
+
+TEST(StaticPIDTest, ConditionalAntiWindupStopsIntegratingWhileSaturated) {
+  StaticPID<PassthroughFilter, ConditionalAntiWindup> controller({0.1, 0.1, 0, 0});
+  controller.setIntegralLimits(100, -100);
+  controller.setTarget(100);
+
+  // The first step integrates before the proportional term saturates the output
+  for (int i = 0; i < 10; i++) {
+    EXPECT_DOUBLE_EQ(controller.step(0), 1);
+  }
+
+  // Only the first step's integral is left once the error is gone. Clamping alone would leave 1.
+  controller.setTarget(0);
+  EXPECT_DOUBLE_EQ(controller.step(0), 0.1);
+}
+
+TEST(StaticPIDTest, TimerGatedTimingOnlyStepsAfterTheSampleTime) {
+  StaticPID<PassthroughFilter, ResetOnCrossAntiWindup, TimerGatedPidTiming> fast(
+    {0.1, 0, 0, 0},
+    10_ms,
+    PassthroughFilter(),
+    TimerGatedPidTiming(std::make_unique<ConstantMockTimer>(5_ms)));
+  fast.setTarget(1);
+  EXPECT_DOUBLE_EQ(fast.step(0), 0);
+
+  StaticPID<PassthroughFilter, ResetOnCrossAntiWindup, TimerGatedPidTiming> onTime(
+    {0.1, 0, 0, 0},
+    10_ms,
+    PassthroughFilter(),
+    TimerGatedPidTiming(std::make_unique<ConstantMockTimer>(10_ms)));
+  onTime.setTarget(1);
+  EXPECT_DOUBLE_EQ(onTime.step(0), 0.1);
+}
+
+TEST(StaticPIDTest, ResetClearsTheState) {
+  StaticPID<> controller({0.1, 0, 0, 0});
+  controller.setTarget(1);
+  controller.step(0);
+  controller.reset();
+  EXPECT_DOUBLE_EQ(controller.getOutput(), 0);
+  EXPECT_DOUBLE_EQ(controller.getError(), 0);
+  EXPECT_DOUBLE_EQ(controller.getTarget(), 1);
+}
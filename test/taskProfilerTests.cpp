@@ -0,0 +1,153 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#include "okapi/api/util/taskProfiler.hpp"
+#include <chrono>
+#include <cstring>
+#include <gtest/gtest.h>
+#include <thread>
+#include <vector>
+
+using namespace okapi;
+
+namespace {
+/**
+ * Sleeps for a fixed time on every delay and counts the calls.
+ */
+class SleepRate : public AbstractRate {
+  public:
+  explicit SleepRate(int *idelays = nullptr, int *iresets = nullptr)
+    : delays(idelays), resets(iresets) {
+  }
+
+  void delay(QFrequency) override {
+    delayUntil(0u);
+  }
+
+  void delayUntil(QTime) override {
+    delayUntil(0u);
+  }
+
+  void delayUntil(uint32_t) override {
+    std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    if (delays) {
+      (*delays)++;
+    }
+  }
+
+  void reset() override {
+    if (resets) {
+      (*resets)++;
+    }
+  }
+
+  int *delays;
+  int *resets;
+};
+
+void spinFor(const std::uint64_t imicros) {
+  const std::uint64_t end = CrossplatformClock::micros() + imicros;
+  while (CrossplatformClock::micros() < end) {
+  }
+}
+
+const TaskProfileStats *findProfile(const char *iname, TaskProfileStats &ostats) {
+  std::array<TaskProfileStats, TaskProfiler::maxProfiles> stats{};
+  const std::size_t count = TaskProfiler::getStats(stats);
+  for (std::size_t i = 0; i < count; i++) {
+    if (std::strcmp(stats[i].name, iname) == 0) {
+      ostats = stats[i];
+      return &ostats;
+    }
+  }
+  return nullptr;
+}
+} // namespace
+
+TEST(TaskProfilerTest, DelaysAreForwardedToTheRate) {
+  int delays = 0;
+  int resets = 0;
+  ProfiledRate rate(std::make_unique<SleepRate>(&delays, &resets), "ForwardingTask");
+
+  rate.delayUntil(10_ms);
+  rate.delayUntil(10u);
+  rate.delay(100_Hz);
+  rate.reset();
+
+  EXPECT_EQ(delays, 3);
+  EXPECT_EQ(resets, 1);
+}
+
+TEST(TaskProfilerTest, MeasuresTheLoopBodyAndTheSleep) {
+  ProfiledRate rate(std::make_unique<SleepRate>(), "MeasuredTask");
+
+  // The first delay has no loop body before it to measure
+  rate.delayUntil(10_ms);
+  for (int i = 0; i < 2; i++) {
+    spinFor(2000);
+    rate.delayUntil(10_ms);
+  }
+
+  TaskProfileStats stats;
+  ASSERT_NE(findProfile("MeasuredTask", stats), nullptr);
+  EXPECT_EQ(stats.loops, 2u);
+  EXPECT_GE(stats.busyMicros, 4000u);
+  EXPECT_GE(stats.maxBusyMicros, 2000u);
+  EXPECT_GE(stats.sleepMicros, 15000u);
+  EXPECT_GT(stats.getUtilization(), 0);
+  EXPECT_LT(stats.getUtilization(), 1);
+}
+
+TEST(TaskProfilerTest, ResetDoesNotCountTheGapAsBusy) {
+  ProfiledRate rate(std::make_unique<SleepRate>(), "ResetTask");
+
+  rate.delayUntil(10_ms);
+  rate.reset();
+  spinFor(1000);
+  rate.delayUntil(10_ms);
+
+  TaskProfileStats stats;
+  ASSERT_NE(findProfile("ResetTask", stats), nullptr);
+  EXPECT_EQ(stats.loops, 0u);
+  EXPECT_EQ(stats.busyMicros, 0u);
+}
+
+TEST(TaskProfilerTest, ResetStatsClearsTheMeasurements) {
+  ProfiledRate rate(std::make_unique<SleepRate>(), "ClearedTask");
+  rate.delayUntil(10_ms);
+  rate.delayUntil(10_ms);
+
+  TaskProfiler::resetStats();
+
+  TaskProfileStats stats;
+  ASSERT_NE(findProfile("ClearedTask", stats), nullptr);
+  EXPECT_EQ(stats.loops, 0u);
+  EXPECT_EQ(stats.sleepMicros, 0u);
+  EXPECT_EQ(stats.getUtilization(), 0);
+}
+
+TEST(TaskProfilerTest, ProfileIsRemovedWithTheRate) {
+  TaskProfileStats stats;
+  {
+    ProfiledRate rate(std::make_unique<SleepRate>(), "ShortLivedTask");
+    EXPECT_NE(findProfile("ShortLivedTask", stats), nullptr);
+  }
+  EXPECT_EQ(findProfile("ShortLivedTask", stats), nullptr);
+}
+
+TEST(TaskProfilerTest, RatesPastTheLimitStillDelay) {
+  int delays = 0;
+  std::vector<std::unique_ptr<ProfiledRate>> rates;
+  for (std::size_t i = 0; i <= TaskProfiler::maxProfiles; i++) {
+    rates.push_back(std::make_unique<ProfiledRate>(std::make_unique<SleepRate>(&delays), "Full"));
+  }
+
+  std::array<TaskProfileStats, TaskProfiler::maxProfiles> stats{};
+  EXPECT_EQ(TaskProfiler::getStats(stats), TaskProfiler::maxProfiles);
+
+  rates.back()->delayUntil(10_ms);
+  rates.back()->delayUntil(10_ms);
+  EXPECT_EQ(delays, 2);
+}
@@ -28,6 +28,17 @@ class MockThreeEncoderModel : public ThreeEncoderSkidSteerModel {
     return std::valarray<std::int32_t>{leftEnc, rightEnc, middleEnc};
   }
 
+  std::size_t getSensorVals(SensorValues &ovalues) const override {
+    ovalues = {leftEnc, rightEnc, middleEnc};
+    return 3;
+  }
+
+  std::size_t getSensorSamples(SensorValues &ovalues,
+                               SensorTimestamps &otimestamps) const override {
+    otimestamps.fill(0);
+    return getSensorVals(ovalues);
+  }
+
   void setSensorVals(std::int32_t left, std::int32_t right, std::int32_t middle) {
     leftEnc = left;
     rightEnc = right;
@@ -171,3 +182,28 @@ TEST_F(ThreeEncoderOdometryTest, TickDiffLessThanMax) {
   odom->step();
   assertOdomStateEquals(odom, 1_in, 2_in, 45_deg);
 }
+
+TEST(ThreeEncoderOdomIntegrationTest, ExponentialMapMatchesTheArc) {
+  auto arcModel = std::make_shared<MockThreeEncoderModel>();
+  auto expModel = std::make_shared<MockThreeEncoderModel>();
+  const ChassisScales scales({{4_in, 10_in, 5_in, 4_in}, 360});
+  ThreeEncoderOdometry arc(createConstantTimeUtil(10_ms), arcModel, scales);
+  ThreeEncoderOdometry exponentialMap(createConstantTimeUtil(10_ms), expModel, scales);
+  exponentialMap.setIntegration(OdomIntegration::EXPONENTIAL_MAP);
+
+  std::int32_t left = 0;
+  std::int32_t right = 0;
+  std::int32_t middle = 0;
+  for (int i = 0; i < 200; i++) {
+    left += 20 + (i % 7) * 5;
+    right += i % 40 < 20 ? 20 : -15 + (i % 3);
+    middle += i % 10 < 5 ? 10 : -3;
+    arcModel->setSensorVals(left, right, middle);
+    expModel->setSensorVals(left, right, middle);
+    arc.step();
+    exponentialMap.step();
+  }
+
+  const auto expected = arc.getState();
+  assertOdomStateEquals(&exponentialMap, expected.x, expected.y, expected.theta);
+}
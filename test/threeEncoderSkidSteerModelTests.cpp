@@ -64,6 +64,26 @@ TEST_F(ThreeEncoderSkidSteerModelTest, GetSensorValsIsCompatibleWithXDriveModel)
   EXPECT_EQ(xDriveModelVals[1], threeEncoderSkidSteerModelVals[1]);
 }
 
+TEST_F(ThreeEncoderSkidSteerModelTest, GetSensorValsIntoABufferMatchesGetSensorVals) {
+  leftSensor->value = 1;
+  rightSensor->value = 2;
+  middleSensor->value = 3;
+
+  ReadOnlyChassisModel::SensorValues values{};
+  ASSERT_EQ(model->getSensorVals(values), 3u);
+  EXPECT_EQ(values[0], 1);
+  EXPECT_EQ(values[1], 2);
+  EXPECT_EQ(values[2], 3);
+}
+
+TEST_F(ThreeEncoderSkidSteerModelTest, DefaultGetSensorValsIntoABufferCopiesGetSensorVals) {
+  MockReadOnlyChassisModel readOnlyModel;
+  ReadOnlyChassisModel::SensorValues values{1, 1, 1, 1};
+  ASSERT_EQ(readOnlyModel.ReadOnlyChassisModel::getSensorVals(values), 2u);
+  EXPECT_EQ(values[0], 0);
+  EXPECT_EQ(values[1], 0);
+}
+
 TEST_F(ThreeEncoderSkidSteerModelTest, Reset) {
   leftSensor->value = 1;
   rightSensor->value = 1;
@@ -75,3 +95,45 @@ TEST_F(ThreeEncoderSkidSteerModelTest, Reset) {
   EXPECT_EQ(rightSensor->get(), 0);
   EXPECT_EQ(middleSensor->get(), 0);
 }
+
+TEST_F(ThreeEncoderSkidSteerModelTest, SensorGroupReadsInsteadOfTheSensors) {
+  class CountingGroup : public RotarySensorGroup {
+    public:
+    using RotarySensorGroup::RotarySensorGroup;
+
+    std::size_t read(double *ovalues, std::uint32_t *otimestamps) const override {
+      reads++;
+      return RotarySensorGroup::read(ovalues, otimestamps);
+    }
+
+    mutable int reads{0};
+  };
+
+  // The readings of the group are taken as left, right, and middle in its order
+  auto group = std::make_shared<CountingGroup>(
+    std::vector<std::shared_ptr<ContinuousRotarySensor>>{middleSensor, leftSensor, rightSensor});
+  model->setSensorGroup(group);
+  leftSensor->value = 1;
+  rightSensor->value = 2;
+  middleSensor->value = 3;
+
+  ReadOnlyChassisModel::SensorValues values{};
+  ReadOnlyChassisModel::SensorTimestamps timestamps{};
+  ASSERT_EQ(model->getSensorSamples(values, timestamps), 3u);
+  EXPECT_EQ(values[0], 3);
+  EXPECT_EQ(values[1], 1);
+  EXPECT_EQ(values[2], 2);
+
+  const auto vals = model->getSensorVals();
+  EXPECT_EQ(vals[0], 3);
+  EXPECT_EQ(group->reads, 2);
+
+  model->setSensorGroup(nullptr);
+  EXPECT_EQ(model->getSensorVals()[0], 1);
+}
+
+TEST_F(ThreeEncoderSkidSteerModelTest, SensorGroupMustHaveThreeSensors) {
+  EXPECT_THROW(model->setSensorGroup(std::make_shared<RotarySensorGroup>(
+                 std::vector<std::shared_ptr<ContinuousRotarySensor>>{leftSensor, rightSensor})),
+               std::invalid_argument);
+}
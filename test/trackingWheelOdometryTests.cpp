@@ -0,0 +1,113 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#include "okapi/api/odometry/trackingWheelOdometry.hpp"
+#include "test/tests/api/implMocks.hpp"
+#include <gtest/gtest.h>
+
+using namespace okapi;
+
+class TrackingWheelOdometryTest : public ::testing::Test {
+  protected:
+  class SettableModel : public ReadOnlyChassisModel {
+    public:
+    std::valarray<std::int32_t> getSensorVals() const override {
+      return values;
+    }
+
+    std::valarray<std::int32_t> values{0, 0, 0, 0};
+  };
+
+  void SetUp() override {
+    model = std::make_shared<SettableModel>();
+  }
+
+  std::unique_ptr<TrackingWheelOdometry> makeOdometry(const std::vector<TrackingWheel> &iwheels) {
+    return std::make_unique<TrackingWheelOdometry>(
+      createConstantTimeUtil(10_ms),
+      model,
+      ChassisScales({{wheelDiam, wheelbaseWidth}, 360}),
+      iwheels);
+  }
+
+  QLength calculateDistanceTraveled(int ticks) {
+    return (ticks / 360.0) * 1_pi * wheelDiam;
+  }
+
+  QLength wheelDiam = 4_in;
+  QLength wheelbaseWidth = 10_in;
+
+  // A three encoder skid steer, with strafing wheels behind and in front of the center
+  TrackingWheel left{0_in, -5_in, 0_deg, wheelDiam, 360};
+  TrackingWheel right{0_in, 5_in, 0_deg, wheelDiam, 360};
+  TrackingWheel back{-5_in, 0_in, 90_deg, wheelDiam, 360};
+  TrackingWheel front{5_in, 0_in, 90_deg, wheelDiam, 360};
+
+  std::shared_ptr<SettableModel> model;
+};
+
+TEST_F(TrackingWheelOdometryTest, MoveForward) {
+  auto odom = makeOdometry({left, right, back});
+  model->values = {10, 10, 0, 0};
+  odom->step();
+  assertOdomStateEquals(odom.get(), calculateDistanceTraveled(10), 0_m, 0_deg);
+}
+
+TEST_F(TrackingWheelOdometryTest, TurnInPlace) {
+  auto odom = makeOdometry({left, right, back});
+  model->values = {10, -10, -10, 0};
+  odom->step();
+  assertOdomStateEquals(odom.get(), 0_m, 0_m, 4_deg);
+}
+
+TEST_F(TrackingWheelOdometryTest, Strafe) {
+  auto odom = makeOdometry({left, right, back});
+  model->values = {0, 0, 10, 0};
+  odom->step();
+  assertOdomStateEquals(odom.get(), 0_m, calculateDistanceTraveled(10), 0_deg);
+}
+
+TEST_F(TrackingWheelOdometryTest, AngledWheels) {
+  // Wheels at 45 degrees each see part of a forward movement
+  const TrackingWheel frontLeft{2_in, -5_in, -45_deg, wheelDiam, 360};
+  const TrackingWheel frontRight{2_in, 5_in, 45_deg, wheelDiam, 360};
+  auto odom = makeOdometry({frontLeft, frontRight, back});
+  model->values = {100, 100, 0, 0};
+  odom->step();
+  assertOdomStateEquals(odom.get(), calculateDistanceTraveled(100) * std::sqrt(2), 0_m, 0_deg);
+}
+
+TEST_F(TrackingWheelOdometryTest, WheelsMustSeeEveryMovement) {
+  EXPECT_THROW(makeOdometry({left, right}), std::invalid_argument);
+
+  // Parallel wheels can't see a strafe
+  const TrackingWheel middle{0_in, 0_in, 0_deg, wheelDiam, 360};
+  EXPECT_THROW(makeOdometry({left, right, middle}), std::invalid_argument);
+}
+
+TEST_F(TrackingWheelOdometryTest, DropsAWheelWhichLeavesTheGround) {
+  auto odom = makeOdometry({left, right, back, front});
+  model->values = {50, 50, 0, 0};
+  odom->step();
+  EXPECT_EQ(odom->getOutlierCount(), 0u);
+
+  // The left wheel stops turning while the robot keeps driving
+  model->values = {50, 100, 0, 0};
+  odom->step();
+  EXPECT_EQ(odom->getOutlierCount(), 1u);
+  assertOdomStateEquals(odom.get(), calculateDistanceTraveled(100), 0_m, 0_deg);
+}
+
+TEST_F(TrackingWheelOdometryTest, ExtraWheelsAverageOutNoise) {
+  auto odom = makeOdometry({left, right, back, front});
+
+  // The drive wheels see a small turn which the strafing wheels don't, so half of it is kept
+  model->values = {11, 9, 0, 0};
+  odom->step();
+  EXPECT_EQ(odom->getOutlierCount(), 0u);
+  EXPECT_NEAR(
+    odom->getState().x.convert(meter), calculateDistanceTraveled(10).convert(meter), 1e-4);
+  EXPECT_NEAR(odom->getState().theta.convert(degree), 0.2, 1e-4);
+}
@@ -122,3 +122,157 @@ TEST_F(OdometryTest, TickDiffLessThanMax) {
   odom->step();
   assertOdomStateEquals(odom, 1_in, 2_in, 45_deg);
 }
+
+class TimestampedMockSkidSteerModel : public MockSkidSteerModel {
+  public:
+  std::size_t getSensorSamples(SensorValues &ovalues,
+                               SensorTimestamps &otimestamps) const override {
+    ovalues = values;
+    otimestamps = timestamps;
+    return 2;
+  }
+
+  SensorValues values{};
+  SensorTimestamps timestamps{};
+};
+
+class DeltaTRecordingOdometry : public TwoEncoderOdometry {
+  public:
+  using TwoEncoderOdometry::TwoEncoderOdometry;
+
+  OdomState odomMathStep(const std::valarray<std::int32_t> &itickDiff,
+                         const QTime &ideltaT) override {
+    lastDeltaT = ideltaT;
+    return TwoEncoderOdometry::odomMathStep(itickDiff, ideltaT);
+  }
+
+  QTime lastDeltaT{0_ms};
+};
+
+TEST(TimestampedOdometryTest, CorrectsForSkewBetweenSensorReads) {
+  auto model = std::make_shared<TimestampedMockSkidSteerModel>();
+  DeltaTRecordingOdometry odom(
+    createConstantTimeUtil(10_ms), model, ChassisScales({{4_in, 10_in}, 360}));
+
+  model->timestamps = {1000, 1000};
+  odom.step();
+  EXPECT_EQ(odom.lastDeltaT, 10_ms);
+
+  // Both wheels move at 10 ticks/ms, but the right wheel was read 5 ms before the left wheel
+  model->values = {100, 50};
+  model->timestamps = {1010, 1005};
+  odom.step();
+  EXPECT_EQ(odom.lastDeltaT, 10_ms);
+
+  model->values = {300, 250};
+  model->timestamps = {1030, 1025};
+  odom.step();
+  EXPECT_EQ(odom.lastDeltaT, 20_ms);
+
+  // The first skewed step can't be corrected without a velocity, but after that the robot drives
+  // straight even though the skew changes
+  const auto theta = odom.getState().theta;
+  model->values = {500, 500};
+  model->timestamps = {1050, 1050};
+  odom.step();
+  EXPECT_NEAR(odom.getState().theta.convert(degree), theta.convert(degree), 1e-9);
+}
+
+TEST(TimestampedOdometryTest, SensorsWithoutTimestampsUseTheStepTime) {
+  auto model = std::make_shared<MockSkidSteerModel>();
+  DeltaTRecordingOdometry odom(
+    createConstantTimeUtil(10_ms), model, ChassisScales({{4_in, 10_in}, 360}));
+
+  model->setSensorVals(10, 10);
+  odom.step();
+  EXPECT_EQ(odom.lastDeltaT, 10_ms);
+  assertOdomStateEquals(&odom, (10 / 360.0) * 1_pi * 4_in, 0_m, 0_deg);
+}
+
+TEST(TimestampedOdometryTest, HistoryIsTimestampedWithTheSensors) {
+  auto model = std::make_shared<TimestampedMockSkidSteerModel>();
+  DeltaTRecordingOdometry odom(
+    createConstantTimeUtil(10_ms), model, ChassisScales({{4_in, 10_in}, 360}));
+
+  model->timestamps = {1000, 1000};
+  odom.step();
+
+  model->values = {360, 360};
+  model->timestamps = {1020, 1020};
+  odom.step();
+
+  // Halfway between the two steps, the robot was halfway along
+  const QLength distance = 1_pi * 4_in;
+  EXPECT_NEAR(odom.getStateAt(1010_ms).x.convert(meter), (distance / 2).convert(meter), 1e-9);
+  EXPECT_NEAR(odom.getStateAt(1010_ms, StateMode::CARTESIAN).y.convert(meter),
+              (distance / 2).convert(meter),
+              1e-9);
+  EXPECT_EQ(odom.getStateAt(900_ms), (OdomState{0_m, 0_m, 0_deg}));
+  EXPECT_EQ(odom.getStateAt(2000_ms), odom.getState());
+}
+
+TEST(TimestampedOdometryTest, GetStateAtWithoutHistoryGivesTheState) {
+  auto model = std::make_shared<MockSkidSteerModel>();
+  TwoEncoderOdometry odom(
+    createConstantTimeUtil(10_ms), model, ChassisScales({{4_in, 10_in}, 360}));
+
+  odom.setState({1_m, 2_m, 3_deg});
+  EXPECT_EQ(odom.getStateAt(0_ms), (OdomState{1_m, 2_m, 3_deg}));
+}
+
+TEST(TimestampedOdometryTest, PoseEstimateKeepsTheMotionSinceItWasMeasured) {
+  auto model = std::make_shared<TimestampedMockSkidSteerModel>();
+  DeltaTRecordingOdometry odom(
+    createConstantTimeUtil(10_ms), model, ChassisScales({{4_in, 10_in}, 360}));
+
+  model->timestamps = {1000, 1000};
+  odom.step();
+
+  model->values = {360, 360};
+  model->timestamps = {1020, 1020};
+  odom.step();
+
+  // The robot was at the origin when the estimate was measured and drove forward since
+  const QLength distance = 1_pi * 4_in;
+  odom.applyPoseEstimate({0_m, 0.5_m, 90_deg}, 1000_ms);
+  assertOdomStateEquals(&odom, 0_m, 0.5_m + distance, 90_deg);
+}
+
+TEST(TimestampedOdometryTest, PoseEstimateIsBlendedByItsWeight) {
+  auto model = std::make_shared<MockSkidSteerModel>();
+  TwoEncoderOdometry odom(
+    createConstantTimeUtil(10_ms), model, ChassisScales({{4_in, 10_in}, 360}));
+
+  odom.setState({1_m, 0_m, 0_deg});
+  odom.applyPoseEstimate({2_m, 1_m, -20_deg}, 0_ms, 0.5);
+  assertOdomStateEquals(&odom, 1.5_m, 0.5_m, -10_deg);
+
+  odom.applyPoseEstimate({5_m, 5_m, 90_deg}, 0_ms, 0);
+  assertOdomStateEquals(&odom, 1.5_m, 0.5_m, -10_deg);
+}
+
+TEST(OdomIntegrationTest, ExponentialMapMatchesTheArc) {
+  auto arcModel = std::make_shared<MockSkidSteerModel>();
+  auto expModel = std::make_shared<MockSkidSteerModel>();
+  const ChassisScales scales({{4_in, 10_in, 1_in}, 360});
+  TwoEncoderOdometry arc(createConstantTimeUtil(10_ms), arcModel, scales);
+  TwoEncoderOdometry exponentialMap(createConstantTimeUtil(10_ms), expModel, scales);
+  exponentialMap.setIntegration(OdomIntegration::EXPONENTIAL_MAP);
+  EXPECT_EQ(exponentialMap.getIntegration(), OdomIntegration::EXPONENTIAL_MAP);
+  EXPECT_EQ(arc.getIntegration(), OdomIntegration::ARC);
+
+  std::int32_t left = 0;
+  std::int32_t right = 0;
+  for (int i = 0; i < 200; i++) {
+    // Drive straight, swing, turn in place, and arc at high and low rates
+    left += 20 + (i % 7) * 5;
+    right += i % 40 < 20 ? 20 : -15 + (i % 3);
+    arcModel->setSensorVals(left, right);
+    expModel->setSensorVals(left, right);
+    arc.step();
+    exponentialMap.step();
+  }
+
+  const auto expected = arc.getState();
+  assertOdomStateEquals(&exponentialMap, expected.x, expected.y, expected.theta);
+}
@@ -26,6 +26,11 @@ TEST(UnitTests, TimeAssignmentAddition) {
   EXPECT_DOUBLE_EQ(start.convert(millisecond), (1_ms).convert(millisecond));
 }
 
+TEST(UnitTests, MicrosecondsConvertToMilliseconds) {
+  EXPECT_DOUBLE_EQ((1500_us).convert(millisecond), 1.5);
+  EXPECT_DOUBLE_EQ((2.5_ms).convert(microsecond), 2500);
+}
+
 TEST(UnitTests, AbsTest) {
   EXPECT_DOUBLE_EQ(QLength(-3.0).abs().getValue(), 3.0);
   EXPECT_DOUBLE_EQ((-3.0 * inch).abs().convert(meter), (3.0_in).convert(meter));
@@ -125,6 +130,23 @@ TEST(UnitTests, Atan2Test) {
   EXPECT_DOUBLE_EQ(atan2(-1_ft, 2_ft).convert(radian), -0.4636476090008061);
 }
 
+TEST(UnitTests, UnitCastMatchesConvert) {
+  EXPECT_DOUBLE_EQ(unit_cast<millisecond>(1500_us), (1500_us).convert(millisecond));
+  EXPECT_DOUBLE_EQ(unit_cast<inch>(1_ft), 12);
+  EXPECT_DOUBLE_EQ(unit_cast<degree>(1_pi * radian), 180);
+
+  // The SI units convert exactly
+  EXPECT_EQ(unit_cast<meter>(3.7_ft), (3.7_ft).convert(meter));
+  EXPECT_EQ(unit_cast<second>(12_ms), (12_ms).convert(second));
+}
+
+TEST(UnitTests, UnitCastIsAConstantExpression) {
+  static_assert(unitFactor<millimeter> == 1.0 / 0.001);
+  static_assert(unit_cast<meter>(2_m) == 2);
+  constexpr double ms = unit_cast<millisecond>(2_s);
+  EXPECT_DOUBLE_EQ(ms, 2000);
+}
+
 TEST(UnitTests, UnitShortNameTest) {
   EXPECT_STREQ(getShortUnitName(meter).c_str(), "m");
   EXPECT_STREQ(getShortUnitName(foot).c_str(), "ft");
@@ -3,8 +3,14 @@
  * License, v. 2.0. If a copy of the MPL was not distributed with this
  * file, You can obtain one at http://mozilla.org/MPL/2.0/.
  */
+#include "okapi/api/coreProsAPI.hpp"
 #include "okapi/api/util/mathUtil.hpp"
+#include "okapi/api/util/matrix.hpp"
+#include "okapi/api/util/supplier.hpp"
+#include "test/tests/api/implMocks.hpp"
+#include <chrono>
 #include <gtest/gtest.h>
+#include <thread>
 
 using namespace okapi;
 
@@ -54,3 +60,181 @@ TEST(TrueModTest, Tests) {
   EXPECT_EQ(modulus(-1800, 3600), 1800);
   EXPECT_EQ(modulus(1, -3), -2);
 }
+
+TEST(CrossplatformEventTest, WaitReturnsWhenNotified) {
+  CrossplatformEvent event;
+  const auto generation = event.getGeneration();
+
+  std::thread notifier([&]() {
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    event.notifyAll();
+  });
+
+  const auto start = std::chrono::steady_clock::now();
+  event.waitFor(generation, 5000);
+  const auto elapsed = std::chrono::steady_clock::now() - start;
+  notifier.join();
+
+  EXPECT_NE(event.getGeneration(), generation);
+  EXPECT_LT(elapsed, std::chrono::milliseconds(1000));
+}
+
+TEST(CrossplatformEventTest, NotificationBeforeWaitIsNotMissed) {
+  CrossplatformEvent event;
+  const auto generation = event.getGeneration();
+  event.notifyAll();
+
+  const auto start = std::chrono::steady_clock::now();
+  event.waitFor(generation, 5000);
+  EXPECT_LT(std::chrono::steady_clock::now() - start, std::chrono::milliseconds(1000));
+}
+
+TEST(CrossplatformEventTest, WaitTimesOutWithoutNotification) {
+  CrossplatformEvent event;
+  const auto generation = event.getGeneration();
+
+  event.waitFor(generation, 10);
+  EXPECT_EQ(event.getGeneration(), generation);
+}
+
+static void takeNotification(void *ivalue) {
+  *static_cast<std::uint32_t *>(ivalue) = CrossplatformThread::notifyTake(5000);
+}
+
+TEST(CrossplatformThreadTest, NotifyWakesNotifyTake) {
+  std::uint32_t value = 0;
+  const auto start = std::chrono::steady_clock::now();
+  {
+    CrossplatformThread thread(takeNotification, &value);
+    thread.notify();
+  }
+
+  EXPECT_EQ(value, CrossplatformThread::wakeNotification);
+  EXPECT_LT(std::chrono::steady_clock::now() - start, std::chrono::milliseconds(1000));
+}
+
+static void readName(void *iname) {
+  *static_cast<std::string *>(iname) = CrossplatformThread::getNameCString();
+}
+
+TEST(CrossplatformThreadTest, GetNameCStringIsCachedPerThread) {
+  const char *name = CrossplatformThread::getNameCString();
+  EXPECT_EQ(CrossplatformThread::getNameCString(), name);
+  EXPECT_EQ(CrossplatformThread::getName(), name);
+
+  std::string otherName;
+  {
+    CrossplatformThread thread(readName, &otherName);
+  }
+
+  EXPECT_FALSE(otherName.empty());
+  EXPECT_NE(otherName, name);
+}
+
+TEST(CrossplatformMutexTest, UncontendedLocksAreNotCounted) {
+  CrossplatformMutex mutex;
+  for (int i = 0; i < 10; i++) {
+    std::scoped_lock lock(mutex);
+  }
+
+  EXPECT_EQ(mutex.getContentionCount(), 0u);
+}
+
+TEST(CrossplatformMutexTest, TryLockFailsWhileTaken) {
+  CrossplatformMutex mutex;
+  ASSERT_TRUE(mutex.try_lock());
+
+  bool taken = true;
+  std::thread([&]() { taken = mutex.try_lock(); }).join();
+  EXPECT_FALSE(taken);
+
+  mutex.unlock();
+  EXPECT_EQ(mutex.getContentionCount(), 0u);
+}
+
+TEST(CrossplatformMutexTest, ContendedLocksAreCounted) {
+  CrossplatformMutex mutex;
+  mutex.lock();
+
+  std::atomic<bool> locked{false};
+  std::thread waiter([&]() {
+    std::scoped_lock lock(mutex);
+    locked = true;
+  });
+
+  std::this_thread::sleep_for(std::chrono::milliseconds(20));
+  EXPECT_FALSE(locked.load());
+  mutex.unlock();
+  waiter.join();
+
+  EXPECT_TRUE(locked.load());
+  EXPECT_EQ(mutex.getContentionCount(), 1u);
+
+  mutex.resetContentionCount();
+  EXPECT_EQ(mutex.getContentionCount(), 0u);
+}
+
+TEST(MatrixTest, DefaultIsZero) {
+  Matrix<2, 3> m;
+  for (std::size_t r = 0; r < 2; r++) {
+    for (std::size_t c = 0; c < 3; c++) {
+      EXPECT_EQ(m(r, c), 0);
+    }
+  }
+}
+
+TEST(MatrixTest, ValuesAreRowMajor) {
+  Matrix<2, 2> m{1, 2, 3, 4};
+  EXPECT_EQ(m(0, 1), 2);
+  EXPECT_EQ(m(1, 0), 3);
+  EXPECT_EQ(m.transpose(), (Matrix<2, 2>{1, 3, 2, 4}));
+}
+
+TEST(MatrixTest, Multiply) {
+  Matrix<2, 3> a{1, 2, 3, 4, 5, 6};
+  Matrix<3, 1> b{1, 0, -1};
+  EXPECT_EQ(a * b, (Matrix<2, 1>{-2, -2}));
+  EXPECT_EQ(2.0 * b, (Matrix<3, 1>{2, 0, -2}));
+  EXPECT_EQ(a + a, a * 2.0);
+  EXPECT_EQ(a - a, (Matrix<2, 3>()));
+}
+
+TEST(MatrixTest, Inverse) {
+  Matrix<3, 3> m{0, 2, 1, 1, 0, 0, 3, 1, 4};
+  Matrix<3, 3> inverse;
+  ASSERT_TRUE(m.inverse(inverse));
+
+  const auto identity = m * inverse;
+  for (std::size_t r = 0; r < 3; r++) {
+    for (std::size_t c = 0; c < 3; c++) {
+      EXPECT_NEAR(identity(r, c), r == c ? 1 : 0, 1e-12);
+    }
+  }
+}
+
+TEST(MatrixTest, SingularInverseFails) {
+  Matrix<2, 2> m{1, 2, 2, 4};
+  Matrix<2, 2> inverse{9, 9, 9, 9};
+  EXPECT_FALSE(m.inverse(inverse));
+  EXPECT_EQ(inverse, (Matrix<2, 2>{9, 9, 9, 9}));
+}
+
+TEST(SupplierTest, ConcreteSupplierCallsItsFunction) {
+  int calls = 0;
+  auto supplier = makeSupplier([&calls]() { return ++calls; });
+  static_assert(std::is_same<decltype(supplier.get()), int>::value);
+
+  EXPECT_EQ(supplier.get(), 1);
+  EXPECT_EQ(supplier.get(), 2);
+}
+
+TEST(SupplierTest, ConcreteSupplierConvertsToTheDefaultSupplier) {
+  const Supplier<std::unique_ptr<AbstractRate>> supplier =
+    Supplier<std::unique_ptr<AbstractRate>, MakeUniqueFunction<AbstractRate, MockRate>>(
+      MakeUniqueFunction<AbstractRate, MockRate>{});
+
+  auto first = supplier.get();
+  auto second = supplier.get();
+  EXPECT_NE(dynamic_cast<MockRate *>(first.get()), nullptr);
+  EXPECT_NE(first, second);
+}
@@ -0,0 +1,50 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#include "okapi/api/control/velocityControllerInput.hpp"
+#include "okapi/api/util/mathUtil.hpp"
+#include "test/tests/api/implMocks.hpp"
+#include <gtest/gtest.h>
+
+using namespace okapi;
+
+class MockVelocitySensor : public MockContinuousRotarySensor {
+  public:
+  double getVelocity() const override {
+    return velocity;
+  }
+
+  bool measuresVelocity() const override {
+    return true;
+  }
+
+  double velocity{0};
+};
+
+TEST(VelocityControllerInputTest, ReadsTheScaledVelocity) {
+  auto sensor = std::make_shared<MockVelocitySensor>();
+  VelocityControllerInput input(sensor, 0.5);
+
+  sensor->velocity = 120;
+  EXPECT_DOUBLE_EQ(input.controllerGet(), 60);
+
+  sensor->velocity = -30;
+  EXPECT_DOUBLE_EQ(input.controllerGet(), -15);
+}
+
+TEST(VelocityControllerInputTest, PassesErrorsThrough) {
+  auto sensor = std::make_shared<MockVelocitySensor>();
+  VelocityControllerInput input(sensor, 0.5);
+
+  sensor->velocity = OKAPI_PROS_ERR_F;
+  EXPECT_EQ(input.controllerGet(), OKAPI_PROS_ERR_F);
+}
+
+TEST(VelocityControllerInputTest, SensorsWhichDoNotMeasureVelocityAreRejected) {
+  auto sensor = std::make_shared<MockContinuousRotarySensor>();
+  EXPECT_FALSE(sensor->measuresVelocity());
+  EXPECT_EQ(sensor->getVelocity(), OKAPI_PROS_ERR_F);
+  EXPECT_THROW(VelocityControllerInput input(sensor), std::invalid_argument);
+}
@@ -0,0 +1,117 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#include "test/tests/api/virtualClock.hpp"
+#include "okapi/api/control/util/settledUtil.hpp"
+#include <cmath>
+
+namespace okapi {
+QTime VirtualClock::now() const {
+  std::scoped_lock lock(mutex);
+  return time * millisecond;
+}
+
+std::size_t VirtualClock::getTaskCount() const {
+  std::scoped_lock lock(mutex);
+  return taskJoins.size();
+}
+
+void VirtualClock::addListener(Listener ilistener) {
+  std::scoped_lock lock(mutex);
+  listeners.push_back(std::move(ilistener));
+}
+
+TimeUtil VirtualClock::createTimeUtil() {
+  return TimeUtil(
+    Supplier<std::unique_ptr<AbstractTimer>>(
+      [this]() { return std::make_unique<VirtualTimer>(*this); }),
+    Supplier<std::unique_ptr<AbstractRate>>(
+      [this]() { return std::make_unique<VirtualRate>(*this); }),
+    Supplier<std::unique_ptr<SettledUtil>>(
+      [this]() { return std::make_unique<SettledUtil>(std::make_unique<VirtualTimer>(*this)); }));
+}
+
+std::uint32_t VirtualClock::join() {
+  std::scoped_lock lock(mutex);
+  taskJoins[std::this_thread::get_id()]++;
+  return time;
+}
+
+void VirtualClock::leave(const std::thread::id itask) {
+  std::scoped_lock lock(mutex);
+  const auto joins = taskJoins.find(itask);
+  if (--joins->second == 0) {
+    taskJoins.erase(joins);
+  }
+
+  // The tasks left might have been waiting on this one
+  advanceIfIdle();
+}
+
+void VirtualClock::waitUntil(const std::uint32_t iwakeTime) {
+  std::unique_lock lock(mutex);
+  const auto entry = wakeTimes.insert(iwakeTime);
+  advanceIfIdle();
+  condition.wait(lock, [&]() { return time >= iwakeTime; });
+  wakeTimes.erase(entry);
+}
+
+void VirtualClock::advanceIfIdle() {
+  // A wake time which has passed belongs to a task which was woken but has not run yet
+  if (wakeTimes.size() < taskJoins.size() || wakeTimes.empty() || *wakeTimes.begin() <= time) {
+    return;
+  }
+
+  time = *wakeTimes.begin();
+  for (const auto &listener : listeners) {
+    listener(time * millisecond);
+  }
+  condition.notify_all();
+}
+
+VirtualTimer::VirtualTimer(const VirtualClock &iclock)
+  : AbstractTimer(iclock.now()), clock(iclock) {
+}
+
+QTime VirtualTimer::millis() const {
+  return clock.now();
+}
+
+VirtualRate::VirtualRate(VirtualClock &iclock) : clock(iclock) {
+}
+
+VirtualRate::~VirtualRate() {
+  if (joined) {
+    clock.leave(task);
+  }
+}
+
+void VirtualRate::delay(const QFrequency ihz) {
+  delayUntil(1 / ihz);
+}
+
+void VirtualRate::delayUntil(const QTime itime) {
+  delayUntil(static_cast<uint32_t>(std::lround(itime.convert(millisecond))));
+}
+
+void VirtualRate::delayUntil(const uint32_t ims) {
+  if (!joined) {
+    // First call
+    joined = true;
+    task = std::this_thread::get_id();
+    lastWake = clock.join();
+  }
+
+  lastWake += ims;
+  clock.waitUntil(lastWake);
+}
+
+void VirtualRate::reset() {
+  if (joined) {
+    joined = false;
+    clock.leave(task);
+  }
+}
+} // namespace okapi
@@ -0,0 +1,190 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#include "okapi/api/coreProsAPI.hpp"
+#include "test/tests/api/simulatedDevices.hpp"
+#include "test/tests/api/virtualClock.hpp"
+#include <chrono>
+#include <gtest/gtest.h>
+#include <thread>
+#include <vector>
+
+using namespace okapi;
+
+namespace {
+/**
+ * Records the time of every step of a periodic task.
+ */
+struct PeriodicTask {
+  PeriodicTask(VirtualClock &iclock, QTime iperiod, QTime iend)
+    : timeUtil(iclock.createTimeUtil()), period(iperiod), end(iend) {
+  }
+
+  void start() {
+    thread = std::make_unique<CrossplatformThread>(
+      [](void *context) { static_cast<PeriodicTask *>(context)->loop(); }, this);
+  }
+
+  void loop() {
+    auto timer = timeUtil.getTimer();
+    auto rate = timeUtil.getRate();
+    while (timer->millis() < end) {
+      times.push_back(timer->millis());
+      // Real time spent between waits must not move the clock
+      std::this_thread::sleep_for(std::chrono::microseconds(200));
+      rate->delayUntil(period);
+    }
+  }
+
+  TimeUtil timeUtil;
+  QTime period;
+  QTime end;
+  std::vector<QTime> times{};
+  std::unique_ptr<CrossplatformThread> thread;
+};
+} // namespace
+
+TEST(VirtualClockTest, StartsAtZero) {
+  VirtualClock clock;
+  EXPECT_EQ(clock.now(), 0_ms);
+  EXPECT_EQ(clock.getTaskCount(), 0u);
+  EXPECT_EQ(clock.createTimeUtil().getTimer()->millis(), 0_ms);
+}
+
+TEST(VirtualClockTest, OneTaskRunsFasterThanRealTime) {
+  VirtualClock clock;
+  auto rate = clock.createTimeUtil().getRate();
+
+  const auto start = std::chrono::steady_clock::now();
+  for (int i = 0; i < 1000; i++) {
+    rate->delayUntil(10_ms);
+  }
+
+  EXPECT_NEAR(clock.now().convert(second), 10, 1e-9);
+  EXPECT_EQ(clock.getTaskCount(), 1u);
+  EXPECT_LT(std::chrono::steady_clock::now() - start, std::chrono::seconds(1));
+}
+
+TEST(VirtualClockTest, RateIsPeriodic) {
+  VirtualClock clock;
+  auto timeUtil = clock.createTimeUtil();
+  auto rate = timeUtil.getRate();
+  auto timer = timeUtil.getTimer();
+
+  rate->delay(100_Hz);
+  EXPECT_EQ(timer->millis(), 10_ms);
+  rate->delayUntil(5);
+  EXPECT_EQ(timer->millis(), 15_ms);
+  EXPECT_EQ(timer->getDtFromStart(), 15_ms);
+}
+
+TEST(VirtualClockTest, ResetRateLeavesTheClock) {
+  VirtualClock clock;
+  auto rate = clock.createTimeUtil().getRate();
+
+  rate->delayUntil(10_ms);
+  EXPECT_EQ(clock.getTaskCount(), 1u);
+
+  rate->reset();
+  EXPECT_EQ(clock.getTaskCount(), 0u);
+
+  // The next period is timed from the next delay
+  rate->delayUntil(5_ms);
+  EXPECT_EQ(clock.now(), 15_ms);
+  EXPECT_EQ(clock.getTaskCount(), 1u);
+}
+
+TEST(VirtualClockTest, TaskWithSeveralRatesCountsOnce) {
+  VirtualClock clock;
+  auto hold = clock.createTimeUtil().getRate();
+  auto inner = clock.createTimeUtil().getRate();
+
+  // Joins without waiting
+  hold->delayUntil(0_ms);
+  EXPECT_EQ(clock.now(), 0_ms);
+  EXPECT_EQ(clock.getTaskCount(), 1u);
+
+  inner->delayUntil(10_ms);
+  EXPECT_EQ(clock.now(), 10_ms);
+  EXPECT_EQ(clock.getTaskCount(), 1u);
+
+  inner->reset();
+  EXPECT_EQ(clock.getTaskCount(), 1u);
+
+  hold->reset();
+  EXPECT_EQ(clock.getTaskCount(), 0u);
+}
+
+TEST(VirtualClockTest, TasksInterleaveDeterministically) {
+  VirtualClock clock;
+  PeriodicTask fast(clock, 10_ms, 100_ms);
+  PeriodicTask slow(clock, 25_ms, 100_ms);
+
+  // Hold the clock from this thread until both tasks are running
+  auto rate = clock.createTimeUtil().getRate();
+  rate->delayUntil(0_ms);
+  fast.start();
+  slow.start();
+  while (clock.getTaskCount() < 3) {
+    std::this_thread::yield();
+  }
+
+  rate.reset();
+  fast.thread.reset();
+  slow.thread.reset();
+
+  ASSERT_EQ(fast.times.size(), 10u);
+  for (std::size_t i = 0; i < fast.times.size(); i++) {
+    EXPECT_NEAR(fast.times[i].convert(millisecond), i * 10.0, 1e-9);
+  }
+  ASSERT_EQ(slow.times.size(), 4u);
+  for (std::size_t i = 0; i < slow.times.size(); i++) {
+    EXPECT_NEAR(slow.times[i].convert(millisecond), i * 25.0, 1e-9);
+  }
+  EXPECT_NEAR(clock.now().convert(millisecond), 100, 1e-9);
+  EXPECT_EQ(clock.getTaskCount(), 0u);
+}
+
+TEST(VirtualClockTest, TimeWaitsForARunningTask) {
+  VirtualClock clock;
+  auto rate = clock.createTimeUtil().getRate();
+  rate->delayUntil(10_ms);
+
+  CrossplatformThread other(
+    [](void *context) {
+      auto &sharedClock = *static_cast<VirtualClock *>(context);
+      auto otherRate = sharedClock.createTimeUtil().getRate();
+      otherRate->delayUntil(1_ms);
+      otherRate->delayUntil(1_ms);
+    },
+    &clock);
+
+  // This task joined and is not waiting, so the other task can't move the clock
+  while (clock.getTaskCount() < 2) {
+    std::this_thread::yield();
+  }
+  std::this_thread::sleep_for(std::chrono::milliseconds(5));
+  EXPECT_EQ(clock.now(), 10_ms);
+
+  rate->delayUntil(5_ms);
+  EXPECT_EQ(clock.now(), 15_ms);
+}
+
+TEST(VirtualClockTest, ListenersDriveASimWorld) {
+  VirtualClock clock;
+  SimWorld world;
+  auto motor = std::make_shared<SimMotor>(AbstractMotor::gearset::green);
+  world.addDevice(motor);
+  clock.addListener([&](const QTime inow) { world.advanceTo(inow); });
+
+  motor->moveVoltage(12000);
+  auto rate = clock.createTimeUtil().getRate();
+  for (int i = 0; i < 100; i++) {
+    rate->delayUntil(10_ms);
+  }
+
+  EXPECT_NEAR(world.now().convert(second), 1, 1e-9);
+  EXPECT_NEAR(motor->getActualVelocity(), 200, 5);
+}
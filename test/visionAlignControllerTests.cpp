@@ -0,0 +1,150 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#include "okapi/api/control/util/visionAlignController.hpp"
+#include "test/tests/api/implMocks.hpp"
+#include <cmath>
+#include <gtest/gtest.h>
+#include <vector>
+
+using namespace okapi;
+
+class HistoryOdometry : public Odometry {
+  public:
+  void setScales(const ChassisScales &) override {
+  }
+
+  void step() override {
+  }
+
+  OdomState getState(const StateMode &) const override {
+    return state;
+  }
+
+  void setState(const OdomState &istate, const StateMode &) override {
+    state = istate;
+  }
+
+  std::shared_ptr<ReadOnlyChassisModel> getModel() override {
+    return nullptr;
+  }
+
+  ChassisScales getScales() override {
+    return {{4_in, 10_in}, imev5GreenTPR};
+  }
+
+  void record(const QTime &itime, const OdomState &istate) {
+    history.record(itime, istate);
+    state = istate;
+  }
+
+  OdomState state{};
+};
+
+class VisionAlignControllerTest : public ::testing::Test {
+  protected:
+  class SettableTimer : public AbstractTimer {
+    public:
+    explicit SettableTimer(const QTime &inow) : AbstractTimer(inow), now(inow) {
+    }
+
+    QTime millis() const override {
+      return now;
+    }
+
+    const QTime &now;
+  };
+
+  void SetUp() override {
+    vision = std::make_shared<VisionSamplingService>(
+      [this](VisionObject *oobjects, std::size_t) -> std::int32_t {
+        std::copy(objects.begin(), objects.end(), oobjects);
+        return static_cast<std::int32_t>(objects.size());
+      },
+      createTimeUtil(Supplier<std::unique_ptr<AbstractTimer>>(
+        [this]() { return std::make_unique<SettableTimer>(now); })),
+      20_ms,
+      30_ms);
+    odometry = std::make_shared<HistoryOdometry>();
+    controller = std::make_unique<VisionAlignController>(
+      vision,
+      odometry,
+      1,
+      IterativePosPIDController::Gains{0.01, 0, 0, 0},
+      createConstantTimeUtil(10_ms));
+  }
+
+  /**
+   * @return The x coordinate of an object at the bearing, and the bearing it rounds to.
+   */
+  static std::pair<std::int16_t, QAngle> pixelsAt(const QAngle &ibearing) {
+    const double focalLength = VisionAlignController::defaultImageWidth / 2 /
+                               std::tan(VisionAlignController::defaultFieldOfView / 2 * M_PI / 180);
+    const auto x =
+      static_cast<std::int16_t>(std::round(focalLength * std::tan(ibearing.getValue())));
+    return {x, std::atan2(x, focalLength) * radian};
+  }
+
+  QTime now{0_ms};
+  std::vector<VisionObject> objects{};
+  std::shared_ptr<VisionSamplingService> vision;
+  std::shared_ptr<HistoryOdometry> odometry;
+  std::unique_ptr<VisionAlignController> controller;
+};
+
+TEST_F(VisionAlignControllerTest, DoesNothingUntilTheObjectIsSeen) {
+  EXPECT_EQ(controller->step(), 0);
+  EXPECT_FALSE(controller->hasTarget());
+  EXPECT_FALSE(controller->isSettled());
+
+  objects = {{2, 50, 0, 10, 10}};
+  vision->step();
+  EXPECT_EQ(controller->step(), 0);
+  EXPECT_FALSE(controller->hasTarget());
+}
+
+TEST_F(VisionAlignControllerTest, CorrectsForTheTurnSinceTheImageWasCaptured) {
+  // The image is captured at 70 ms, and the robot turns 10 degrees before it is read at 100 ms
+  odometry->record(70_ms, {0_m, 0_m, 0_deg});
+  odometry->record(100_ms, {0_m, 0_m, 10_deg});
+  now = 100_ms;
+
+  const auto [x, bearing] = pixelsAt(20_deg);
+  objects = {{1, x, 0, 10, 10}};
+  vision->step();
+
+  const double output = controller->step();
+  EXPECT_TRUE(controller->hasTarget());
+  EXPECT_NEAR(controller->getTargetHeading().convert(degree), bearing.convert(degree), 1e-9);
+  EXPECT_NEAR(controller->getError().convert(degree), bearing.convert(degree) - 10, 1e-9);
+  EXPECT_GT(output, 0);
+}
+
+TEST_F(VisionAlignControllerTest, FollowsTheOdometryBetweenFrames) {
+  odometry->record(0_ms, {0_m, 0_m, 0_deg});
+  objects = {{1, pixelsAt(-15_deg).first, 0, 10, 10}};
+  vision->step();
+  controller->step();
+  const QAngle heading = controller->getTargetHeading();
+
+  // No new frame, but the robot turned past the object
+  odometry->record(50_ms, {0_m, 0_m, -20_deg});
+  EXPECT_GT(controller->step(), 0);
+  EXPECT_EQ(controller->getTargetHeading(), heading);
+  EXPECT_NEAR(controller->getError().convert(degree), heading.convert(degree) + 20, 1e-9);
+}
+
+TEST_F(VisionAlignControllerTest, ResetForgetsTheObject) {
+  objects = {{1, 40, 0, 10, 10}};
+  vision->step();
+  controller->step();
+  ASSERT_TRUE(controller->hasTarget());
+
+  controller->reset();
+  EXPECT_FALSE(controller->hasTarget());
+
+  // The frame seen before the reset is not used again
+  EXPECT_EQ(controller->step(), 0);
+}
@@ -0,0 +1,100 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#include "okapi/api/device/visionSamplingService.hpp"
+#include "test/tests/api/implMocks.hpp"
+#include <gtest/gtest.h>
+#include <vector>
+
+using namespace okapi;
+
+class VisionSamplingServiceTest : public ::testing::Test {
+  protected:
+  class SettableTimer : public AbstractTimer {
+    public:
+    explicit SettableTimer(const QTime &inow) : AbstractTimer(inow), now(inow) {
+    }
+
+    QTime millis() const override {
+      return now;
+    }
+
+    const QTime &now;
+  };
+
+  std::unique_ptr<VisionSamplingService> makeService() {
+    return std::make_unique<VisionSamplingService>(
+      [this](VisionObject *oobjects, const std::size_t imaxCount) -> std::int32_t {
+        if (failReads) {
+          return OKAPI_PROS_ERR;
+        }
+
+        const std::size_t count = std::min(objects.size(), imaxCount);
+        std::copy(objects.begin(), objects.begin() + count, oobjects);
+        return static_cast<std::int32_t>(count);
+      },
+      createTimeUtil(Supplier<std::unique_ptr<AbstractTimer>>(
+        [this]() { return std::make_unique<SettableTimer>(now); })),
+      20_ms,
+      30_ms);
+  }
+
+  QTime now{100_ms};
+  bool failReads{false};
+  std::vector<VisionObject> objects{};
+};
+
+TEST_F(VisionSamplingServiceTest, EmptyBeforeTheFirstRead) {
+  auto service = makeService();
+  EXPECT_EQ(service->getFrameCount(), 0u);
+  EXPECT_EQ(service->getFrame().count, 0);
+  EXPECT_EQ(service->getFrame().findLargest(1), nullptr);
+}
+
+TEST_F(VisionSamplingServiceTest, PublishesObjectsAtTheCaptureTime) {
+  auto service = makeService();
+  objects = {{1, -120, 40, 60, 30}, {2, 15, -80, 20, 10}, {1, 150, 100, 5, 5}};
+
+  EXPECT_TRUE(service->step());
+  EXPECT_EQ(service->getFrameCount(), 1u);
+
+  const VisionFrame frame = service->getFrame();
+  EXPECT_EQ(frame.time, 70_ms);
+  ASSERT_EQ(frame.count, 3);
+  for (std::size_t i = 0; i < objects.size(); i++) {
+    EXPECT_EQ(frame.objects[i].signature, objects[i].signature);
+    EXPECT_EQ(frame.objects[i].x, objects[i].x);
+    EXPECT_EQ(frame.objects[i].y, objects[i].y);
+    EXPECT_EQ(frame.objects[i].width, objects[i].width);
+    EXPECT_EQ(frame.objects[i].height, objects[i].height);
+  }
+
+  // The sensor lists objects largest first
+  ASSERT_NE(frame.findLargest(1), nullptr);
+  EXPECT_EQ(frame.findLargest(1)->x, -120);
+  EXPECT_EQ(frame.findLargest(3), nullptr);
+}
+
+TEST_F(VisionSamplingServiceTest, KeepsAtMostMaxObjects) {
+  auto service = makeService();
+  objects.resize(VisionFrame::maxObjects + 4);
+
+  service->step();
+  EXPECT_EQ(service->getFrame().count, VisionFrame::maxObjects);
+}
+
+TEST_F(VisionSamplingServiceTest, FailedReadsKeepTheLastFrame) {
+  auto service = makeService();
+  objects = {{1, 10, 10, 10, 10}};
+  service->step();
+
+  failReads = true;
+  now = 200_ms;
+  EXPECT_FALSE(service->step());
+  EXPECT_EQ(service->getFailedCount(), 1u);
+  EXPECT_EQ(service->getFrameCount(), 1u);
+  EXPECT_EQ(service->getFrame().time, 70_ms);
+  EXPECT_EQ(service->getFrame().count, 1);
+}
@@ -0,0 +1,143 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#include "okapi/api/chassis/model/skidSteerModel.hpp"
+#include "okapi/api/chassis/model/voltageCompensator.hpp"
+#include "test/tests/api/implMocks.hpp"
+#include <gtest/gtest.h>
+
+using namespace okapi;
+
+class VoltageCompensatorTest : public ::testing::Test {
+  protected:
+  std::shared_ptr<VoltageCompensator> makeCompensator(const QTime &idt) const {
+    return std::make_shared<VoltageCompensator>(battery, std::make_unique<ConstantMockTimer>(idt));
+  }
+
+  std::shared_ptr<MockControllerInput> battery = std::make_shared<MockControllerInput>();
+};
+
+TEST_F(VoltageCompensatorTest, ScalesByTheNominalOverTheBatteryVoltage) {
+  battery->reading = 10000;
+  auto compensator = makeCompensator(10_ms);
+
+  EXPECT_DOUBLE_EQ(compensator->getScale(), 1.2);
+  EXPECT_DOUBLE_EQ(compensator->compensate(6000), 7200);
+  EXPECT_DOUBLE_EQ(compensator->getBatteryVoltage(), 10000);
+}
+
+TEST_F(VoltageCompensatorTest, ScalesDownOnAFullBattery) {
+  battery->reading = 12800;
+  auto compensator = makeCompensator(10_ms);
+
+  EXPECT_DOUBLE_EQ(compensator->compensate(12000), 12000 * 12000 / 12800.0);
+}
+
+TEST_F(VoltageCompensatorTest, CapsTheVoltageAtTheMotorMax) {
+  battery->reading = 10000;
+  auto compensator = makeCompensator(10_ms);
+
+  EXPECT_DOUBLE_EQ(compensator->compensate(12000), v5MotorMaxVoltage);
+}
+
+TEST_F(VoltageCompensatorTest, CapsTheScaleAtTheMaxScale) {
+  battery->reading = 2000;
+  auto compensator = makeCompensator(10_ms);
+
+  EXPECT_DOUBLE_EQ(compensator->getScale(), VoltageCompensator::defaultMaxScale);
+}
+
+TEST_F(VoltageCompensatorTest, CachesTheReadingWithinTheReadPeriod) {
+  battery->reading = 10000;
+  auto compensator = makeCompensator(10_ms);
+  EXPECT_DOUBLE_EQ(compensator->getScale(), 1.2);
+
+  battery->reading = 12000;
+  EXPECT_DOUBLE_EQ(compensator->getScale(), 1.2);
+}
+
+TEST_F(VoltageCompensatorTest, RereadsTheBatteryAfterTheReadPeriod) {
+  battery->reading = 10000;
+  auto compensator = makeCompensator(VoltageCompensator::defaultReadPeriod);
+  EXPECT_DOUBLE_EQ(compensator->getScale(), 1.2);
+
+  battery->reading = 12000;
+  EXPECT_DOUBLE_EQ(compensator->getScale(), 1);
+}
+
+TEST_F(VoltageCompensatorTest, IgnoresBadReadings) {
+  auto compensator = makeCompensator(VoltageCompensator::defaultReadPeriod);
+
+  battery->reading = OKAPI_PROS_ERR;
+  EXPECT_DOUBLE_EQ(compensator->getScale(), 1);
+  EXPECT_DOUBLE_EQ(compensator->getBatteryVoltage(), VoltageCompensator::defaultNominalVoltage);
+
+  battery->reading = 10000;
+  EXPECT_DOUBLE_EQ(compensator->getScale(), 1.2);
+
+  battery->reading = 0;
+  EXPECT_DOUBLE_EQ(compensator->getScale(), 1.2);
+
+  battery->reading = std::numeric_limits<double>::quiet_NaN();
+  EXPECT_DOUBLE_EQ(compensator->getScale(), 1.2);
+}
+
+TEST_F(VoltageCompensatorTest, ConstructorThrowsOnANullBattery) {
+  EXPECT_THROW(VoltageCompensator(nullptr, std::make_unique<ConstantMockTimer>(10_ms)),
+               std::invalid_argument);
+}
+
+TEST_F(VoltageCompensatorTest, ConstructorThrowsOnABadNominalVoltage) {
+  EXPECT_THROW(VoltageCompensator(battery, std::make_unique<ConstantMockTimer>(10_ms), 0),
+               std::invalid_argument);
+}
+
+TEST_F(VoltageCompensatorTest, ConstructorThrowsOnAMaxScaleBelowOne) {
+  EXPECT_THROW(VoltageCompensator(battery, std::make_unique<ConstantMockTimer>(10_ms), 12000, 0.5),
+               std::invalid_argument);
+}
+
+TEST_F(VoltageCompensatorTest, SkidSteerModelScalesItsVoltageOutputs) {
+  auto leftMotor = std::make_shared<MockMotor>();
+  auto rightMotor = std::make_shared<MockMotor>();
+  SkidSteerModel model(leftMotor,
+                       rightMotor,
+                       std::make_shared<MockContinuousRotarySensor>(),
+                       std::make_shared<MockContinuousRotarySensor>(),
+                       200,
+                       10000);
+  battery->reading = 10000;
+  model.setVoltageCompensator(makeCompensator(10_ms));
+
+  model.tank(0.5, -0.25);
+  EXPECT_EQ(leftMotor->lastVoltage, 6000);
+  EXPECT_EQ(rightMotor->lastVoltage, -3000);
+
+  model.driveVectorVoltage(1, 0);
+  EXPECT_EQ(leftMotor->lastVoltage, 12000);
+  EXPECT_EQ(rightMotor->lastVoltage, 12000);
+
+  model.setVoltageCompensator(nullptr);
+  model.arcade(0.5, 0);
+  EXPECT_EQ(leftMotor->lastVoltage, 5000);
+  EXPECT_EQ(rightMotor->lastVoltage, 5000);
+}
+
+TEST_F(VoltageCompensatorTest, SkidSteerModelDoesNotScaleItsVelocityOutputs) {
+  auto leftMotor = std::make_shared<MockMotor>();
+  auto rightMotor = std::make_shared<MockMotor>();
+  SkidSteerModel model(leftMotor,
+                       rightMotor,
+                       std::make_shared<MockContinuousRotarySensor>(),
+                       std::make_shared<MockContinuousRotarySensor>(),
+                       200,
+                       v5MotorMaxVoltage);
+  battery->reading = 10000;
+  model.setVoltageCompensator(makeCompensator(10_ms));
+
+  model.forward(0.5);
+  EXPECT_EQ(leftMotor->lastVelocity, 100);
+  EXPECT_EQ(rightMotor->lastVelocity, 100);
+}
@@ -0,0 +1,205 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+#include "okapi/api/odometry/twoEncoderOdometry.hpp"
+#include "okapi/api/odometry/wallCorrectedOdometry.hpp"
+#include "test/tests/api/implMocks.hpp"
+#include <gtest/gtest.h>
+#include <memory>
+
+using namespace okapi;
+
+TEST(FieldMapTest, RaycastHitsNearestWall) {
+  auto map = FieldMap::rectangle(-1_m, 2_m, -1_m, 1_m);
+  RaycastHit hit;
+  EXPECT_TRUE(map.raycast({0_m, 0_m}, 0_deg, hit));
+  EXPECT_NEAR(hit.distance.convert(meter), 2, 1e-9);
+  EXPECT_NEAR(hit.normalX, -1, 1e-9);
+  EXPECT_NEAR(hit.normalY, 0, 1e-9);
+  EXPECT_NEAR(hit.incidence.convert(degree), 0, 1e-6);
+
+  EXPECT_TRUE(map.raycast({0_m, 0_m}, 90_deg, hit));
+  EXPECT_NEAR(hit.distance.convert(meter), 1, 1e-9);
+  EXPECT_NEAR(hit.normalX, 0, 1e-9);
+  EXPECT_NEAR(hit.normalY, -1, 1e-9);
+}
+
+TEST(FieldMapTest, RaycastAtAnAngle) {
+  auto map = FieldMap::rectangle(-10_m, 1_m, -10_m, 10_m);
+  RaycastHit hit;
+  EXPECT_TRUE(map.raycast({0_m, 0_m}, 60_deg, hit));
+  EXPECT_NEAR(hit.distance.convert(meter), 2, 1e-9);
+  EXPECT_NEAR(hit.incidence.convert(degree), 60, 1e-6);
+}
+
+TEST(FieldMapTest, RaycastMissesWallBehind) {
+  FieldMap map(std::vector<FieldWall>{{{1_m, -1_m}, {1_m, 1_m}}});
+  RaycastHit hit;
+  EXPECT_FALSE(map.raycast({0_m, 0_m}, 180_deg, hit));
+  EXPECT_FALSE(map.raycast({0_m, 0_m}, 80_deg, hit));
+  EXPECT_TRUE(map.raycast({0_m, 0_m}, 0_deg, hit));
+}
+
+TEST(FieldMapTest, ZeroLengthWallThrows) {
+  FieldMap map;
+  EXPECT_THROW(map.addWall({{1_m, 1_m}, {1_m, 1_m}}), std::invalid_argument);
+  EXPECT_TRUE(map.getWalls().empty());
+}
+
+TEST(FieldMapTest, InvalidRectangleThrows) {
+  EXPECT_THROW(FieldMap::rectangle(1_m, 0_m, 0_m, 1_m), std::invalid_argument);
+}
+
+class WallCorrectedOdometryTest : public ::testing::Test {
+  protected:
+  void SetUp() override {
+    model = new MockSkidSteerModel();
+    distance = std::make_shared<MockControllerInput>();
+    encoderOdom = std::make_shared<TwoEncoderOdometry>(
+      createConstantTimeUtil(10_ms),
+      std::shared_ptr<MockSkidSteerModel>(model),
+      ChassisScales({{wheelDiam, wheelbaseWidth}, 360}));
+  }
+
+  std::unique_ptr<WallCorrectedOdometry> makeOdom(double igain) {
+    return std::make_unique<WallCorrectedOdometry>(
+      encoderOdom, FieldMap::rectangle(-10_m, 1_m, -10_m, 1_m), igain);
+  }
+
+  QLength calculateDistanceTraveled(int ticks) {
+    return (ticks / 360.0) * 1_pi * wheelDiam;
+  }
+
+  QLength wheelDiam = 4_in;
+  QLength wheelbaseWidth = 10_in;
+  MockSkidSteerModel *model;
+  std::shared_ptr<MockControllerInput> distance;
+  std::shared_ptr<TwoEncoderOdometry> encoderOdom;
+};
+
+TEST_F(WallCorrectedOdometryTest, NullOdometryThrows) {
+  EXPECT_THROW(WallCorrectedOdometry(nullptr, FieldMap()), std::invalid_argument);
+}
+
+TEST_F(WallCorrectedOdometryTest, InvalidGainThrows) {
+  EXPECT_THROW(WallCorrectedOdometry(encoderOdom, FieldMap(), 1.5), std::invalid_argument);
+  EXPECT_THROW(WallCorrectedOdometry(encoderOdom, FieldMap(), -0.1), std::invalid_argument);
+}
+
+TEST_F(WallCorrectedOdometryTest, NullSensorThrows) {
+  auto odom = makeOdom(1);
+  EXPECT_THROW(odom->addDistanceSensor(nullptr, {0_m, 0_m, 0_deg}), std::invalid_argument);
+}
+
+TEST_F(WallCorrectedOdometryTest, FollowsEncodersWithoutSensors) {
+  auto odom = makeOdom(1);
+  model->setSensorVals(10, 10);
+  odom->step();
+  assertOdomStateEquals(odom.get(), calculateDistanceTraveled(10), 0_m, 0_deg);
+
+  model->setSensorVals(20, 20);
+  odom->step();
+  assertOdomStateEquals(odom.get(), calculateDistanceTraveled(20), 0_m, 0_deg);
+}
+
+TEST_F(WallCorrectedOdometryTest, SnapsToTheWall) {
+  auto odom = makeOdom(1);
+  odom->addDistanceSensor(distance, {0.1_m, 0_m, 0_deg});
+
+  // The sensor is 10 cm in front of the center and sees the robot 2 cm closer to the wall
+  distance->reading = 880;
+  odom->step();
+
+  assertOdomStateEquals(odom.get(), 2_cm, 0_m, 0_deg);
+  EXPECT_EQ(odom->getCorrectionCount(), 1u);
+  assertOdomStateEquals(encoderOdom.get(), 0_m, 0_m, 0_deg);
+}
+
+TEST_F(WallCorrectedOdometryTest, FusesWithTheWall) {
+  auto odom = makeOdom(0.5);
+  odom->addDistanceSensor(distance, {0_m, 0_m, 0_deg});
+
+  distance->reading = 980;
+  odom->step();
+  assertOdomStateEquals(odom.get(), 1_cm, 0_m, 0_deg);
+
+  odom->step();
+  assertOdomStateEquals(odom.get(), 1.5_cm, 0_m, 0_deg);
+}
+
+TEST_F(WallCorrectedOdometryTest, SideSensorCorrectsY) {
+  auto odom = makeOdom(1);
+  odom->addDistanceSensor(distance, {0_m, 0_m, 90_deg});
+
+  // The sensor faces right, toward the wall at y = 1 m
+  distance->reading = 970;
+  odom->step();
+  assertOdomStateEquals(odom.get(), 0_m, 3_cm, 0_deg);
+}
+
+TEST_F(WallCorrectedOdometryTest, ReadingFarFromTheWallIsIgnored) {
+  auto odom = makeOdom(1);
+  odom->addDistanceSensor(distance, {0_m, 0_m, 0_deg});
+
+  // Another robot is in front of the sensor
+  distance->reading = 500;
+  odom->step();
+  assertOdomStateEquals(odom.get(), 0_m, 0_m, 0_deg);
+  EXPECT_EQ(odom->getCorrectionCount(), 0u);
+}
+
+TEST_F(WallCorrectedOdometryTest, OutOfRangeReadingIsIgnored) {
+  auto odom = makeOdom(1);
+  odom->addDistanceSensor(distance, {0_m, 0_m, 0_deg}, 0.5_m);
+
+  distance->reading = 980;
+  odom->step();
+  distance->reading = 0;
+  odom->step();
+  assertOdomStateEquals(odom.get(), 0_m, 0_m, 0_deg);
+  EXPECT_EQ(odom->getCorrectionCount(), 0u);
+}
+
+TEST_F(WallCorrectedOdometryTest, ShallowReadingIsIgnored) {
+  auto odom = makeOdom(1);
+  odom->addDistanceSensor(distance, {0_m, 0_m, 0_deg});
+  odom->setState({0_m, -5_m, 60_deg});
+
+  // The beam hits the wall at x = 1 m, 60 degrees from straight on, 2 m away
+  distance->reading = 1990;
+  odom->step();
+  assertOdomStateEquals(odom.get(), 0_m, -5_m, 60_deg);
+  EXPECT_EQ(odom->getCorrectionCount(), 0u);
+}
+
+TEST_F(WallCorrectedOdometryTest, AngledReadingCorrectsAlongTheNormal) {
+  auto odom = makeOdom(1);
+  odom->addDistanceSensor(distance, {0_m, 0_m, 0_deg});
+  odom->setState({0_m, -5_m, 20_deg});
+
+  // The beam is 1 cm short along the beam, which is 1 cm * cos(20 deg) across the wall
+  const QLength expected = 1_m / std::cos((20_deg).convert(radian));
+  distance->reading = (expected - 1_cm).convert(millimeter);
+  odom->step();
+  assertOdomStateEquals(odom.get(), 1_cm * std::cos((20_deg).convert(radian)), -5_m, 20_deg);
+}
+
+TEST_F(WallCorrectedOdometryTest, SetStateIsKeptByTheEncoderDelta) {
+  auto odom = makeOdom(1);
+  odom->setState({0.5_m, 0.2_m, 90_deg});
+  model->setSensorVals(10, 10);
+  odom->step();
+
+  // Driving forward at 90 degrees moves along y, whatever the encoder odometry's heading
+  assertOdomStateEquals(odom.get(), 0.5_m, 0.2_m + calculateDistanceTraveled(10), 90_deg);
+  assertOdomStateEquals(encoderOdom.get(), calculateDistanceTraveled(10), 0_m, 0_deg);
+}
+
+TEST_F(WallCorrectedOdometryTest, SetStateInCartesian) {
+  auto odom = makeOdom(1);
+  odom->setState({1_m, 2_m, 3_deg}, StateMode::CARTESIAN);
+  assertOdomStateEquals(odom.get(), 2_m, 1_m, 3_deg);
+  EXPECT_EQ(odom->getState(StateMode::CARTESIAN), (OdomState{1_m, 2_m, 3_deg}));
+}
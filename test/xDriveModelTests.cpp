@@ -544,6 +544,47 @@ TEST_F(XDriveModelTest, FieldOrientedXArcadeFull180Forward) {
   EXPECT_EQ(bottomRightMotor->lastVoltage, -12000);
 }
 
+TEST_F(XDriveModelTest, FieldOrientedXArcadeUsesTheCachedHeading) {
+  model.updateHeading(90_deg);
+  model.fieldOrientedXArcade(1, 0, 0);
+
+  EXPECT_EQ(model.getHeading(), 90_deg);
+  EXPECT_EQ(topLeftMotor->lastVoltage, -11999);
+  EXPECT_EQ(topRightMotor->lastVoltage, 12000);
+  EXPECT_EQ(bottomLeftMotor->lastVoltage, 12000);
+  EXPECT_EQ(bottomRightMotor->lastVoltage, -11999);
+}
+
+TEST_F(XDriveModelTest, FieldOrientedXArcadeWithoutAHeadingIsRobotOriented) {
+  model.fieldOrientedXArcade(1, 0, 0);
+
+  assertAllMotorsLastVoltage(12000);
+}
+
+TEST_F(XDriveModelTest, UpdateHeadingReadsTheHeadingSensorOnlyWhenCalled) {
+  auto imu = std::make_shared<MockImu>();
+  model.setHeadingSensor(imu);
+  imu->heading = 180;
+  model.updateHeading();
+
+  // The sensor moving does not change the cached heading until the next update
+  imu->heading = 0;
+  model.fieldOrientedXArcade(1, 0, 0);
+
+  EXPECT_EQ(model.getHeading(), 180_deg);
+  EXPECT_EQ(topLeftMotor->lastVoltage, -12000);
+  EXPECT_EQ(topRightMotor->lastVoltage, -11999);
+  EXPECT_EQ(bottomLeftMotor->lastVoltage, -11999);
+  EXPECT_EQ(bottomRightMotor->lastVoltage, -12000);
+}
+
+TEST_F(XDriveModelTest, UpdateHeadingWithoutASensorKeepsTheHeading) {
+  model.updateHeading(45_deg);
+  model.updateHeading();
+
+  EXPECT_EQ(model.getHeading(), 45_deg);
+}
+
 TEST_F(XDriveModelTest, SetMaxVelocity) {
   model.setMaxVelocity(2);
   model.forward(0.5);
@@ -615,3 +656,16 @@ TEST_F(XDriveModelTest, SetMaxVelocityLessThan0) {
   model.setMaxVelocity(-1);
   EXPECT_EQ(model.getMaxVelocity(), 0);
 }
+
+TEST_F(XDriveModelTest, ApplyCommandsVoltage) {
+  model.applyCommands({WheelCommands::outputMode::voltage, {0.5, -0.25, 0.25, -0.5}});
+  EXPECT_EQ(topLeftMotor->lastVoltage, 6000);
+  EXPECT_EQ(topRightMotor->lastVoltage, -3000);
+  EXPECT_EQ(bottomRightMotor->lastVoltage, 3000);
+  EXPECT_EQ(bottomLeftMotor->lastVoltage, -6000);
+}
+
+TEST_F(XDriveModelTest, ApplyCommandsVelocityBoundsInput) {
+  model.applyCommands({WheelCommands::outputMode::velocity, {2, -2, 2, -2}});
+  assertTLBRAndTRBLMotorsLastVelocity(127, -127);
+}
@@ -0,0 +1,358 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+/**
+ * Generates paths offline, in parallel, with the same configuration as
+ * `AsyncMotionProfileController`.
+ *
+ * Usage: pathCompiler <manifest> <output> [--track <meters>] [--format bin|library|header]
+ *                     [--encoding float|compact] [--jobs <n>]
+ *                     [--report <csv>] [--gearset red|green|blue] [--ratio <r>] [--wheel <meters>]
+ *
+ * Each non-empty line of the manifest which does not start with `#` describes one path:
+ *
+ *   <pathId> <maxVel> <maxAccel> <maxJerk> <x>,<y>,<theta> <x>,<y>,<theta> ...
+ *
+ * The limits are in m/s, m/s^2, and m/s^3, and the waypoints are in meters and degrees in the
+ * okapi::State::FRAME_TRANSFORMATION format.
+ *
+ * With `--format bin` (the default), `<output>` is a directory and each path is written to
+ * `<pathId>.bin` for `AsyncMotionProfileController::loadPath()`. With `--format library`,
+ * `<output>` is a directory and every path is written to one `paths.lib` file for
+ * `AsyncMotionProfileController::loadPathLibrary()`. With `--format header`, `<output>` is a header
+ * file with one `constexpr` `StaticProfilePoint` table per path for
+ * `AsyncMotionProfileController::registerStaticPath()`. `--encoding compact` writes binary paths
+ * and libraries in the compact version of `PathBinaryFormat`, which is about a quarter of the size.
+ *
+ * With `--report`, every path is also measured against its limits and the drive motors (see
+ * `PathAnalyzer`), and the measurements are written to a CSV file with one row per path, including
+ * the impossible ones. `--gearset` and `--ratio` (motor rotations per wheel rotation) describe the
+ * drive motors and default to a direct green cartridge, and `--wheel` is the wheel diameter, which
+ * defaults to 4 inches. Paths which ask for more than the limits or the motors allow are listed on
+ * stderr. A usage well under one means the path could be made faster.
+ */
+#include "okapi/api/control/util/pathAnalyzer.hpp"
+#include "okapi/api/control/util/pathBinaryFormat.hpp"
+#include "okapi/api/control/util/profileGenerator.hpp"
+#include <atomic>
+#include <cctype>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <optional>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace okapi;
+
+struct PathJob {
+  std::string pathId;
+  PathfinderLimits limits;
+  std::vector<PathfinderPoint> waypoints;
+  std::vector<squiggles::ProfilePoint> profile{};
+  std::string error{};
+  PathReport report{};
+};
+
+static std::optional<PathJob> parseManifestLine(const std::string &iline, const int ilineNumber) {
+  std::istringstream stream(iline);
+  PathJob job;
+  if (!(stream >> job.pathId >> job.limits.maxVel >> job.limits.maxAccel >> job.limits.maxJerk)) {
+    std::cerr << "manifest line " << ilineNumber << ": expected a path ID and three limits\n";
+    return std::nullopt;
+  }
+
+  std::string waypoint;
+  while (stream >> waypoint) {
+    double x, y, theta;
+    char comma1, comma2;
+    std::istringstream waypointStream(waypoint);
+    if (!(waypointStream >> x >> comma1 >> y >> comma2 >> theta) || comma1 != ',' ||
+        comma2 != ',') {
+      std::cerr << "manifest line " << ilineNumber << ": invalid waypoint " << waypoint << "\n";
+      return std::nullopt;
+    }
+    job.waypoints.push_back(PathfinderPoint{x * meter, y * meter, theta * degree});
+  }
+
+  if (job.waypoints.size() < 2) {
+    std::cerr << "manifest line " << ilineNumber << ": a path needs at least two waypoints\n";
+    return std::nullopt;
+  }
+
+  return job;
+}
+
+static std::string toIdentifier(const std::string &ipathId) {
+  std::string out;
+  for (const char c : ipathId) {
+    out += std::isalnum(static_cast<unsigned char>(c)) ? c : '_';
+  }
+
+  if (out.empty() || std::isdigit(static_cast<unsigned char>(out.front()))) {
+    out.insert(0, "path_");
+  }
+
+  return out;
+}
+
+static bool writeBinaryPaths(const std::vector<PathJob> &ijobs,
+                             const std::string &idirectory,
+                             const bool icompact) {
+  bool ok = true;
+  for (const auto &job : ijobs) {
+    const std::string filePath = idirectory + "/" + job.pathId + ".bin";
+    std::ofstream file(filePath, std::ofstream::out | std::ofstream::binary);
+    const bool written =
+      file.good() && (icompact ? PathBinaryFormat::serializeCompact(file, job.profile)
+                               : PathBinaryFormat::serialize(file, job.profile));
+    if (!written) {
+      std::cerr << "couldn't write " << filePath << "\n";
+      ok = false;
+    }
+  }
+  return ok;
+}
+
+static bool writePathLibrary(const std::vector<PathJob> &ijobs,
+                             const std::string &idirectory,
+                             const bool icompact) {
+  std::vector<std::pair<std::string, std::vector<squiggles::ProfilePoint>>> paths;
+  for (const auto &job : ijobs) {
+    paths.emplace_back(job.pathId, job.profile);
+  }
+
+  const std::string filePath = idirectory + "/" + PathBinaryFormat::libraryFileName;
+  std::ofstream file(filePath, std::ofstream::out | std::ofstream::binary);
+  if (!file.good() || !PathBinaryFormat::serializeLibrary(file, paths, icompact)) {
+    std::cerr << "couldn't write " << filePath << "\n";
+    return false;
+  }
+  return true;
+}
+
+static std::string toCsvField(const std::string &ivalue) {
+  if (ivalue.find_first_of(",\"\n") == std::string::npos) {
+    return ivalue;
+  }
+
+  std::string out = "\"";
+  for (const char c : ivalue) {
+    out += c == '"' ? "\"\"" : std::string(1, c);
+  }
+  return out + "\"";
+}
+
+static bool writeReport(const std::vector<PathJob> &ijobs, const std::string &ifilePath) {
+  std::ofstream file(ifilePath, std::ofstream::out);
+  if (!file.good()) {
+    std::cerr << "couldn't write " << ifilePath << "\n";
+    return false;
+  }
+
+  file << "path,status,points,duration_s,length_m,peak_velocity_mps,velocity_usage,"
+          "peak_acceleration_mps2,acceleration_usage,peak_wheel_velocity_mps,motor_speed_usage,"
+          "peak_curvature_per_m,error\n"
+       << std::setprecision(6);
+
+  for (const auto &job : ijobs) {
+    file << toCsvField(job.pathId) << ",";
+    if (!job.error.empty()) {
+      file << "impossible,,,,,,,,,,," << toCsvField(job.error) << "\n";
+      continue;
+    }
+
+    const auto &report = job.report;
+    file << (report.isFeasible() ? "ok" : "over") << "," << report.pointCount << ","
+         << report.duration << "," << report.length << "," << report.peakVelocity << ","
+         << report.velocityUsage << "," << report.peakAcceleration << ","
+         << report.accelerationUsage << "," << report.peakWheelVelocity << ","
+         << report.motorSpeedUsage << "," << report.peakCurvature << ",\n";
+  }
+
+  return file.good();
+}
+
+static bool writeHeader(const std::vector<PathJob> &ijobs, const std::string &ifilePath) {
+  std::ofstream file(ifilePath, std::ofstream::out);
+  if (!file.good()) {
+    std::cerr << "couldn't write " << ifilePath << "\n";
+    return false;
+  }
+
+  file << "// Generated by pathCompiler. Do not edit.\n"
+       << "#pragma once\n\n"
+       << "#include \"okapi/api/control/util/pathfinderUtil.hpp\"\n\n"
+       << std::setprecision(9);
+
+  for (const auto &job : ijobs) {
+    file << "static constexpr okapi::StaticProfilePoint " << toIdentifier(job.pathId) << "[] = {\n";
+    for (const auto &point : job.profile) {
+      file << "  {" << point.wheel_velocities[0] << ", " << point.wheel_velocities[1] << "},\n";
+    }
+    file << "};\n\n";
+  }
+
+  return file.good();
+}
+
+int main(int argc, char **argv) {
+  if (argc < 3) {
+    std::cerr << "usage: " << argv[0]
+              << " <manifest> <output> [--track <meters>] [--format bin|library|header]"
+                 " [--encoding float|compact] [--jobs <n>] [--report <csv>]"
+                 " [--gearset red|green|blue] [--ratio <r>] [--wheel <meters>]\n";
+    return 2;
+  }
+
+  const std::string manifestPath = argv[1];
+  const std::string outputPath = argv[2];
+  double track = 0.2667; // 10.5 inches
+  std::string format = "bin";
+  std::string encoding = "float";
+  unsigned int threadCount = std::max(1u, std::thread::hardware_concurrency());
+  std::string reportPath;
+  AbstractMotor::GearsetRatioPair pair(AbstractMotor::gearset::green);
+  double wheelDiameter = 0.1016; // 4 inches
+
+  for (int i = 3; i + 1 < argc; i += 2) {
+    const std::string option = argv[i];
+    if (option == "--track") {
+      track = std::stod(argv[i + 1]);
+    } else if (option == "--format") {
+      format = argv[i + 1];
+    } else if (option == "--encoding") {
+      encoding = argv[i + 1];
+    } else if (option == "--jobs") {
+      threadCount = std::max(1, std::stoi(argv[i + 1]));
+    } else if (option == "--report") {
+      reportPath = argv[i + 1];
+    } else if (option == "--gearset") {
+      const std::string gearset = argv[i + 1];
+      if (gearset == "red") {
+        pair.internalGearset = AbstractMotor::gearset::red;
+      } else if (gearset == "green") {
+        pair.internalGearset = AbstractMotor::gearset::green;
+      } else if (gearset == "blue") {
+        pair.internalGearset = AbstractMotor::gearset::blue;
+      } else {
+        std::cerr << "unknown gearset " << gearset << "\n";
+        return 2;
+      }
+    } else if (option == "--ratio") {
+      pair.ratio = std::stod(argv[i + 1]);
+    } else if (option == "--wheel") {
+      wheelDiameter = std::stod(argv[i + 1]);
+    } else {
+      std::cerr << "unknown option " << option << "\n";
+      return 2;
+    }
+  }
+
+  if (format != "bin" && format != "library" && format != "header") {
+    std::cerr << "unknown format " << format << "\n";
+    return 2;
+  }
+
+  if (encoding != "float" && encoding != "compact") {
+    std::cerr << "unknown encoding " << encoding << "\n";
+    return 2;
+  }
+
+  if (!(pair.ratio > 0) || !(wheelDiameter > 0)) {
+    std::cerr << "the ratio and wheel diameter must be positive\n";
+    return 2;
+  }
+
+  std::ifstream manifest(manifestPath);
+  if (!manifest.good()) {
+    std::cerr << "couldn't read " << manifestPath << "\n";
+    return 1;
+  }
+
+  std::vector<PathJob> jobs;
+  std::string line;
+  for (int lineNumber = 1; std::getline(manifest, line); ++lineNumber) {
+    const auto start = line.find_first_not_of(" \t\r");
+    if (start == std::string::npos || line[start] == '#') {
+      continue;
+    }
+
+    auto job = parseManifestLine(line, lineNumber);
+    if (!job) {
+      return 1;
+    }
+    jobs.push_back(std::move(job.value()));
+  }
+
+  // Each worker takes the next path until there are none left
+  std::atomic_size_t nextJob{0};
+  auto worker = [&]() {
+    for (std::size_t i = nextJob++; i < jobs.size(); i = nextJob++) {
+      try {
+        jobs[i].profile =
+          ProfileGenerator::generate(jobs[i].waypoints, jobs[i].limits, track * meter);
+        if (jobs[i].profile.empty()) {
+          jobs[i].error = "the generated path is empty";
+        } else if (!reportPath.empty()) {
+          jobs[i].report =
+            PathAnalyzer::analyze(jobs[i].profile, jobs[i].limits, pair, wheelDiameter * meter);
+        }
+      } catch (const std::exception &e) {
+        jobs[i].error = e.what();
+      }
+    }
+  };
+
+  std::vector<std::thread> threads;
+  for (unsigned int i = 0; i < std::min<std::size_t>(threadCount, jobs.size()); ++i) {
+    threads.emplace_back(worker);
+  }
+
+  for (auto &thread : threads) {
+    thread.join();
+  }
+
+  bool failed = false;
+  for (const auto &job : jobs) {
+    if (!job.error.empty()) {
+      std::cerr << "path " << job.pathId << " is impossible: " << job.error << "\n";
+      failed = true;
+    } else if (!reportPath.empty() && !job.report.isFeasible()) {
+      std::cerr << "path " << job.pathId << " asks for " << job.report.velocityUsage
+                << "x the max velocity, " << job.report.accelerationUsage
+                << "x the max acceleration, and " << job.report.motorSpeedUsage
+                << "x the wheel free speed\n";
+    }
+  }
+
+  // The report covers every path so impossible ones can be found in it too
+  if (!reportPath.empty() && !writeReport(jobs, reportPath)) {
+    return 1;
+  }
+
+  if (failed) {
+    return 1;
+  }
+
+  bool written;
+  if (format == "bin") {
+    written = writeBinaryPaths(jobs, outputPath, encoding == "compact");
+  } else if (format == "library") {
+    written = writePathLibrary(jobs, outputPath, encoding == "compact");
+  } else {
+    written = writeHeader(jobs, outputPath);
+  }
+
+  if (!written) {
+    return 1;
+  }
+
+  std::cout << "generated " << jobs.size() << " paths with " << threads.size() << " threads\n";
+  return 0;
+}
@@ -0,0 +1,121 @@
+/*
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ */
+
+/**
+ * Decodes a telemetry file written by `TelemetryLogger` into one CSV file per channel.
+ *
+ * Usage: telemetryDecoder <telemetry file> <output directory>
+ *
+ * Each channel is written to `<channel name>.csv` in the output directory. The first column is the
+ * time in milliseconds and the rest are the channel's fields.
+ */
+#include "okapi/api/util/telemetryFormat.hpp"
+#include <cctype>
+#include <cstdint>
+#include <fstream>
+#include <iostream>
+#include <limits>
+#include <map>
+#include <memory>
+#include <string>
+
+using namespace okapi;
+
+static std::string toFileName(const std::string &ichannelName) {
+  std::string out;
+  for (const char c : ichannelName) {
+    out += std::isalnum(static_cast<unsigned char>(c)) || c == '-' ? c : '_';
+  }
+  return out.empty() ? "channel" : out;
+}
+
+static std::string toCsvField(const std::string &ifield) {
+  if (ifield.find_first_of(",\"\n") == std::string::npos) {
+    return ifield;
+  }
+
+  std::string out = "\"";
+  for (const char c : ifield) {
+    out += c == '"' ? "\"\"" : std::string(1, c);
+  }
+  return out + "\"";
+}
+
+int main(int argc, char **argv) {
+  if (argc != 3) {
+    std::cerr << "usage: " << argv[0] << " <telemetry file> <output directory>\n";
+    return 2;
+  }
+
+  const std::string inputPath = argv[1];
+  const std::string outputPath = argv[2];
+
+  std::ifstream input(inputPath, std::ifstream::in | std::ifstream::binary);
+  if (!input.good()) {
+    std::cerr << "couldn't read " << inputPath << "\n";
+    return 1;
+  }
+
+  std::map<std::uint16_t, std::unique_ptr<std::ofstream>> files;
+  std::map<std::uint16_t, std::size_t> fieldCounts;
+  std::size_t sampleCount = 0;
+  std::size_t skippedCount = 0;
+  bool failed = false;
+
+  const bool complete = TelemetryFormat::decode(
+    input,
+    [&](const TelemetryFormat::Channel &ichannel) {
+      const std::string filePath = outputPath + "/" + toFileName(ichannel.name) + ".csv";
+      auto file = std::make_unique<std::ofstream>(filePath, std::ofstream::out);
+      if (!file->good()) {
+        std::cerr << "couldn't write " << filePath << "\n";
+        failed = true;
+        return;
+      }
+
+      *file << "time_ms";
+      for (const auto &fieldName : ichannel.fieldNames) {
+        *file << "," << toCsvField(fieldName);
+      }
+      *file << "\n";
+      file->precision(std::numeric_limits<float>::max_digits10);
+
+      files[ichannel.id] = std::move(file);
+      fieldCounts[ichannel.id] = ichannel.fieldNames.size();
+    },
+    [&](const TelemetryFormat::Sample &isample) {
+      const auto file = files.find(isample.channel);
+      if (file == files.end() || isample.values.size() != fieldCounts[isample.channel]) {
+        skippedCount++;
+        return;
+      }
+
+      *file->second << isample.time;
+      for (const double value : isample.values) {
+        *file->second << "," << value;
+      }
+      *file->second << "\n";
+      sampleCount++;
+    });
+
+  if (failed) {
+    return 1;
+  }
+
+  if (!complete) {
+    std::cerr << "warning: " << inputPath
+              << " is not a telemetry file or ends in the middle of a record; decoded the whole"
+                 " records before that\n";
+  }
+
+  if (skippedCount > 0) {
+    std::cerr << "warning: skipped " << skippedCount
+              << " samples which don't match a channel\n";
+  }
+
+  std::cout << "decoded " << sampleCount << " samples from " << files.size() << " channels\n";
+  return files.empty() && !complete ? 1 : 0;
+}
@@ -0,0 +1,148 @@
+#!/usr/bin/env python3
+#
+# This Source Code Form is subject to the terms of the Mozilla Public
+# License, v. 2.0. If a copy of the MPL was not distributed with this
+# file, You can obtain one at http://mozilla.org/MPL/2.0/.
+#
+"""Watches a TelemetryStream.
+
+Reads the stream from a serial port (which needs pyserial) or from a file, and prints each sample
+as a CSV row. With --plot, the signals are also plotted live (which needs matplotlib).
+
+Usage: telemetryViewer.py [--baud BAUD] [--plot] [--window SECONDS] <serial port or file>
+"""
+import argparse
+import collections
+import struct
+import sys
+
+DESCRIPTOR_PACKET_TYPE = 1
+SAMPLE_PACKET_TYPE = 2
+
+
+def cobs_decode(encoded):
+    """Decodes a COBS packet without its zero delimiter, or returns None if it is invalid."""
+    out = bytearray()
+    i = 0
+    while i < len(encoded):
+        code = encoded[i]
+        i += 1
+        if code == 0 or i + code - 1 > len(encoded):
+            return None
+        out += encoded[i:i + code - 1]
+        i += code - 1
+        if code != 0xFF and i < len(encoded):
+            out.append(0)
+    return bytes(out)
+
+
+def parse_packet(encoded):
+    """Returns (type, payload) for a valid packet, or None."""
+    packet = cobs_decode(encoded)
+    if not packet or len(packet) < 2 or sum(packet[:-1]) % 256 != packet[-1]:
+        return None
+    return packet[0], packet[1:-1]
+
+
+def parse_descriptor(payload):
+    names = []
+    count = payload[0]
+    i = 1
+    for _ in range(count):
+        length = payload[i]
+        names.append(payload[i + 1:i + 1 + length].decode("utf-8", "replace"))
+        i += 1 + length
+    return names
+
+
+def parse_sample(payload):
+    time, count = struct.unpack_from("<IB", payload)
+    return time, struct.unpack_from("<%df" % count, payload, 5)
+
+
+def open_stream(path, baud):
+    try:
+        import serial
+        return serial.Serial(path, baud, timeout=0.1)
+    except ImportError:
+        return open(path, "rb")
+    except (OSError, ValueError):
+        # Not a serial port, so read a recording of the stream
+        return open(path, "rb")
+
+
+def packets(stream):
+    """Yields every encoded packet in the stream, without its delimiter."""
+    buffer = bytearray()
+    while True:
+        chunk = stream.read(256)
+        if not chunk:
+            if not hasattr(stream, "in_waiting"):
+                return
+            continue
+        buffer += chunk
+        while True:
+            end = buffer.find(0)
+            if end < 0:
+                break
+            yield bytes(buffer[:end])
+            del buffer[:end + 1]
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Watches a TelemetryStream.")
+    parser.add_argument("path", help="the serial port or a file holding a recorded stream")
+    parser.add_argument("--baud", type=int, default=115200, help="the baud rate of the port")
+    parser.add_argument("--plot", action="store_true", help="plot the signals live")
+    parser.add_argument("--window", type=float, default=10, help="the plotted time in seconds")
+    args = parser.parse_args()
+
+    plot = None
+    if args.plot:
+        import matplotlib.pyplot as plt
+        plt.ion()
+        figure, axes = plt.subplots()
+        plot = (plt, figure, axes)
+
+    names = None
+    history = collections.deque()
+    bad_packets = 0
+    for encoded in packets(open_stream(args.path, args.baud)):
+        parsed = parse_packet(encoded)
+        if parsed is None:
+            # Lost bytes or other serial output; the next delimiter starts a new packet
+            bad_packets += 1
+            continue
+
+        packet_type, payload = parsed
+        if packet_type == DESCRIPTOR_PACKET_TYPE:
+            new_names = parse_descriptor(payload)
+            if new_names != names:
+                names = new_names
+                history.clear()
+                print("time_ms," + ",".join(names), flush=True)
+        elif packet_type == SAMPLE_PACKET_TYPE and names is not None:
+            time, values = parse_sample(payload)
+            if len(values) != len(names):
+                continue
+            print(str(time) + "," + ",".join("%g" % value for value in values), flush=True)
+
+            if plot:
+                history.append((time, values))
+                while history and time - history[0][0] > args.window * 1000:
+                    history.popleft()
+                plt, figure, axes = plot
+                axes.clear()
+                times = [sample[0] / 1000 for sample in history]
+                for i, name in enumerate(names):
+                    axes.plot(times, [sample[1][i] for sample in history], label=name)
+                axes.legend(loc="upper left")
+                axes.set_xlabel("time (s)")
+                plt.pause(0.001)
+
+    if bad_packets:
+        print("skipped %d bad packets" % bad_packets, file=sys.stderr)
+
+
+if __name__ == "__main__":
+    main()